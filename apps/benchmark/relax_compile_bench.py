@@ -0,0 +1,234 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark the compile time of a fixed set of Relax and TIR modules.
+
+Each module is compiled in a fresh process, so that the peak resident memory
+is the one of its compilation, with the number of threads pinned.  The wall
+time, the peak RSS and the self time of each pass from PassTimingInstrument
+are reported, and written as json with --output.
+"""
+import argparse
+import json
+import os
+import resource
+import subprocess
+import sys
+import time
+from collections import defaultdict
+
+MODELS = ["llm_decode", "resnet", "dynamic_mlp", "tir_matmul"]
+
+
+def build_llm_decode():
+    """A decoder of 4 layers over one token, attending to a cache of 512 tokens."""
+    from tvm.relax.frontend import nn  # pylint: disable=import-outside-toplevel
+
+    hidden, heads, context = 512, 8, 512
+    head_dim = hidden // heads
+
+    class Layer(nn.Module):
+        def __init__(self):
+            self.norm0 = nn.RMSNorm(hidden, axes=-1, bias=False)
+            self.qkv = nn.Linear(hidden, 3 * hidden, bias=False)
+            self.out = nn.Linear(hidden, hidden, bias=False)
+            self.norm1 = nn.RMSNorm(hidden, axes=-1, bias=False)
+            self.up = nn.Linear(hidden, 4 * hidden, bias=False)
+            self.down = nn.Linear(4 * hidden, hidden, bias=False)
+
+        def forward(self, x: nn.Tensor, k_cache: nn.Tensor, v_cache: nn.Tensor):
+            qkv = nn.op.reshape(self.qkv(self.norm0(x)), [1, 1, 3, heads, head_dim])
+            q, k, v = nn.op.split(qkv, 3, axis=2)
+            q = nn.op.permute_dims(nn.op.reshape(q, [1, 1, heads, head_dim]), [0, 2, 1, 3])
+            k = nn.op.concat([k_cache, nn.op.reshape(k, [1, 1, heads, head_dim])], dim=1)
+            v = nn.op.concat([v_cache, nn.op.reshape(v, [1, 1, heads, head_dim])], dim=1)
+            k = nn.op.permute_dims(k, [0, 2, 3, 1])
+            v = nn.op.permute_dims(v, [0, 2, 1, 3])
+            attn = nn.op.softmax(nn.op.matmul(q, k), axis=-1)
+            o = nn.op.permute_dims(nn.op.matmul(attn, v), [0, 2, 1, 3])
+            o = nn.op.reshape(o, [1, 1, hidden])
+            x = x + self.out(o)
+            return x + self.down(nn.op.silu(self.up(self.norm1(x))))
+
+    class Decoder(nn.Module):
+        def __init__(self):
+            self.layers = nn.ModuleList([Layer() for _ in range(4)])
+
+        def forward(self, x: nn.Tensor, k_cache: nn.Tensor, v_cache: nn.Tensor):
+            for layer in self.layers:
+                x = layer(x, k_cache, v_cache)
+            return x
+
+    x = nn.spec.Tensor([1, 1, hidden], "float32")
+    cache = nn.spec.Tensor([1, context, heads, head_dim], "float32")
+    mod, _ = Decoder().export_tvm(spec={"forward": {"x": x, "k_cache": cache, "v_cache": cache}})
+    return mod
+
+
+def build_resnet():
+    """A ResNet-style network of 8 residual blocks on 56x56 images."""
+    from tvm.relax.frontend import nn  # pylint: disable=import-outside-toplevel
+
+    class Block(nn.Module):
+        def __init__(self, channels):
+            self.conv0 = nn.Conv2D(channels, channels, 3, padding=1)
+            self.conv1 = nn.Conv2D(channels, channels, 3, padding=1)
+
+        def forward(self, x: nn.Tensor):
+            return nn.op.relu(x + self.conv1(nn.op.relu(self.conv0(x))))
+
+    class ResNet(nn.Module):
+        def __init__(self):
+            self.stem = nn.Conv2D(3, 64, 7, stride=2, padding=3)
+            self.blocks = nn.ModuleList([Block(64) for _ in range(8)])
+
+        def forward(self, x: nn.Tensor):
+            x = nn.op.relu(self.stem(x))
+            for block in self.blocks:
+                x = block(x)
+            return x
+
+    mod, _ = ResNet().export_tvm(
+        spec={"forward": {"x": nn.spec.Tensor([1, 3, 112, 112], "float32")}}
+    )
+    return mod
+
+
+def build_dynamic_mlp():
+    """An MLP of 6 layers over a symbolic number of tokens."""
+    from tvm.relax.frontend import nn  # pylint: disable=import-outside-toplevel
+
+    class MLP(nn.Module):
+        def __init__(self):
+            self.layers = nn.ModuleList([nn.Linear(1024, 1024) for _ in range(6)])
+
+        def forward(self, x: nn.Tensor):
+            for layer in self.layers:
+                x = nn.op.silu(layer(x))
+            return x
+
+    mod, _ = MLP().export_tvm(
+        spec={"forward": {"x": nn.spec.Tensor(["num_tokens", 1024], "float32")}}
+    )
+    return mod
+
+
+def build_tir_matmul():
+    """A tiled matmul PrimFunc, built through tvm.build."""
+    import tvm  # pylint: disable=import-outside-toplevel
+    from tvm import te  # pylint: disable=import-outside-toplevel
+
+    n = 1024
+    a = te.placeholder((n, n), name="A")
+    b = te.placeholder((n, n), name="B")
+    k = te.reduce_axis((0, n), name="k")
+    c = te.compute((n, n), lambda i, j: te.sum(a[i, k] * b[k, j], axis=k), name="C")
+    sch = tvm.tir.Schedule(te.create_prim_func([a, b, c]))
+    i, j, k = sch.get_loops(sch.get_block("C"))
+    i0, i1 = sch.split(i, [None, 32])
+    j0, j1 = sch.split(j, [None, 32])
+    sch.reorder(i0, j0, k, i1, j1)
+    sch.vectorize(j1)
+    sch.parallel(i0)
+    return tvm.IRModule({"main": sch.mod["main"].with_attr("global_symbol", "main")})
+
+
+def compile_model(name, target):
+    """Compile a model in this process, and return its measurements."""
+    import tvm  # pylint: disable=import-outside-toplevel
+    from tvm import relax  # pylint: disable=import-outside-toplevel
+    from tvm.ir.instrument import PassTimingInstrument  # pylint: disable=import-outside-toplevel
+
+    mod = globals()["build_" + name]()
+    timing_inst = PassTimingInstrument()
+    start = time.perf_counter()
+    with tvm.transform.PassContext(opt_level=3, instruments=[timing_inst]):
+        if name.startswith("tir_"):
+            tvm.build(mod, target=target)
+        else:
+            pipeline = tvm.transform.Sequential(
+                [relax.get_pipeline("zero"), relax.get_pipeline("default_build")]
+            )
+            relax.build(mod, target=target, pipeline=pipeline)
+        stacks = timing_inst.export_folded_stacks()
+    wall_time = time.perf_counter() - start
+
+    self_time_us = defaultdict(int)
+    for line in stacks.splitlines():
+        path, time_us = line.rsplit(" ", 1)
+        self_time_us[path.split(";")[-1]] += int(time_us)
+    return {
+        "model": name,
+        "wall_time_s": wall_time,
+        "peak_rss_mb": resource.getrusage(resource.RUSAGE_SELF).ru_maxrss / 1024,
+        "pass_self_time_ms": {
+            pass_name: time_us / 1000
+            for pass_name, time_us in sorted(self_time_us.items(), key=lambda kv: -kv[1])
+        },
+    }
+
+
+def run_in_subprocess(name, args):
+    """Compile a model in a fresh process with the number of threads pinned."""
+    env = dict(os.environ)
+    for var in ["TVM_NUM_THREADS", "OMP_NUM_THREADS", "MKL_NUM_THREADS"]:
+        env[var] = str(args.num_threads)
+    cmd = [sys.executable, __file__, "--child", name, "--target", args.target]
+    result = subprocess.run(cmd, env=env, check=True, stdout=subprocess.PIPE)
+    return json.loads(result.stdout.decode().splitlines()[-1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--models", nargs="+", choices=MODELS, default=MODELS)
+    parser.add_argument("--target", default="llvm")
+    parser.add_argument("--repeat", type=int, default=3, help="The compilations of each model.")
+    parser.add_argument("--num-threads", type=int, default=1)
+    parser.add_argument("--top", type=int, default=10, help="The passes printed per model.")
+    parser.add_argument("--output", help="The json file to write the results to.")
+    parser.add_argument("--child", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child:
+        print(json.dumps(compile_model(args.child, args.target)))
+        return
+
+    results = []
+    for name in args.models:
+        runs = [run_in_subprocess(name, args) for _ in range(args.repeat)]
+        # Report the run of median wall time, as a whole, to keep its pass breakdown consistent.
+        median = sorted(runs, key=lambda run: run["wall_time_s"])[len(runs) // 2]
+        median["wall_time_s_all"] = [run["wall_time_s"] for run in runs]
+        results.append(median)
+
+        print(
+            f"{name}: wall time {median['wall_time_s']:.2f} s, "
+            f"peak RSS {median['peak_rss_mb']:.0f} MB"
+        )
+        for pass_name, time_ms in list(median["pass_self_time_ms"].items())[: args.top]:
+            print(f"  {time_ms:10.1f} ms  {pass_name}")
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(
+                {"target": args.target, "num_threads": args.num_threads, "results": results},
+                f,
+                indent=2,
+            )
+
+
+if __name__ == "__main__":
+    main()
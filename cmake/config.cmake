@@ -54,14 +54,21 @@ set(USE_CUDA OFF)
 # - /path/to/nccl: use specific path to nccl
 set(USE_NCCL OFF)
 
+# Whether to enable UCX as the transport of Disco SocketSession, e.g. over RDMA:
+# - ON: enable UCX with cmake's auto search
+# - OFF: disable UCX
+# - /path/to/ucx: use specific path to ucx
+set(USE_UCX OFF)
+
 # Whether to enable MSCCL support:
 # - ON: enable MSCCL
 # - OFF: disable MSCCL
 set(USE_MSCCL OFF)
 
-# Whether to enable NVTX support (must have USE_CUDA enabled):
-# - ON: enable NCCL with cmake's auto search
-# - OFF: disable NCCL
+# Whether to enable NVTX support (must have USE_CUDA or USE_ROCM enabled, uses ROCTX on ROCm):
+# - ON: enable NVTX with cmake's auto search, the ranges are emitted when the
+#       environment variable TVM_NVTX_RANGES=1 is set
+# - OFF: disable NVTX
 set(USE_NVTX OFF)
 
 # Whether enable ROCM runtime
@@ -150,6 +157,9 @@ set(USE_PIPELINE_EXECUTOR OFF)
 # Whether to enable the profiler for the graph executor and vm
 set(USE_PROFILER ON)
 
+# Whether to build the native continuous batching engine and request batcher of the Relax VM
+set(USE_RELAX_SERVING_ENGINE ON)
+
 # Whether build with LLVM support
 # Requires LLVM version >= 4.0
 #
@@ -340,6 +350,11 @@ set(USE_PT_TVMDSOOP OFF)
 # Whether to use STL's std::unordered_map or TVM's POD compatible Map
 set(USE_FALLBACK_STL_MAP OFF)
 
+# Whether to allocate the objects of TVM (e.g. the IR nodes) from thread-local
+# size-class pools instead of new/delete. The pool statistics are available via
+# tvm.ir.instrument.ObjectAllocationInstrument.
+set(USE_POOLED_OBJECT_ALLOCATOR OFF)
+
 # Whether to enable Hexagon support
 set(USE_HEXAGON OFF)
 set(USE_HEXAGON_SDK /path/to/sdk)
@@ -412,6 +427,14 @@ set(BACKTRACE_ON_SEGFAULT OFF)
 # - /path/to/folder/containing/: Path to folder containing papi.pc.
 set(USE_PAPI OFF)
 
+# Whether to enable the CUPTI metric collector in profiling, which attributes the
+# time of the CUDA kernels, including the ones of CUDA graphs and libraries, to
+# the profiled calls. Requires USE_CUDA.
+# Possible values:
+# - ON: enable CUPTI support, found in the CUDA toolkit.
+# - OFF: disable CUPTI support.
+set(USE_CUPTI OFF)
+
 # Whether to use GoogleTest for C++ unit tests. When enabled, the generated
 # build file (e.g. Makefile) will have a target "cpptest".
 # Possible values:
@@ -424,6 +447,17 @@ set(USE_PAPI OFF)
 # predefined variables to specify the path to the GTest package if needed.
 set(USE_GTEST AUTO)
 
+# Whether to build the C++ runtime microbenchmarks with Google Benchmark. If
+# enabled, the build file will have the targets "tvm_runtime_bench" and
+# "tvm_runtime_bench_json", which writes the results to tvm_runtime_bench.json.
+# Possible values:
+# - ON: enable Google Benchmark. The package `benchmark` will be required for
+#   cmake to succeed.
+# - OFF: disable Google Benchmark.
+# - AUTO: cmake will attempt to find the benchmark package, and enable it if
+#   found.
+set(USE_GBENCHMARK AUTO)
+
 # Enable using CUTLASS as a BYOC backend
 # Need to have USE_CUDA=ON
 set(USE_CUTLASS OFF)
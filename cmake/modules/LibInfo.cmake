@@ -70,6 +70,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_CUBLAS="${USE_CUBLAS}"
     TVM_INFO_USE_CUDA="${USE_CUDA}"
     TVM_INFO_USE_NVTX="${USE_NVTX}"
+    TVM_INFO_USE_CUPTI="${USE_CUPTI}"
     TVM_INFO_USE_NCCL="${USE_NCCL}"
     TVM_INFO_USE_MSCCL="${USE_MSCCL}"
     TVM_INFO_USE_CUDNN="${USE_CUDNN}"
@@ -79,6 +80,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_AMX="${USE_AMX}"
     TVM_INFO_USE_DNNL="${USE_DNNL}"
     TVM_INFO_USE_FALLBACK_STL_MAP="${USE_FALLBACK_STL_MAP}"
+    TVM_INFO_USE_POOLED_OBJECT_ALLOCATOR="${USE_POOLED_OBJECT_ALLOCATOR}"
     TVM_INFO_USE_GRAPH_EXECUTOR_CUDA_GRAPH="${USE_GRAPH_EXECUTOR_CUDA_GRAPH}"
     TVM_INFO_USE_GRAPH_EXECUTOR="${USE_GRAPH_EXECUTOR}"
     TVM_INFO_USE_GTEST="${USE_GTEST}"
@@ -107,6 +109,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_PROFILER="${USE_PROFILER}"
     TVM_INFO_USE_PT_TVMDSOOP="${USE_PT_TVMDSOOP}"
     TVM_INFO_USE_RANDOM="${USE_RANDOM}"
+    TVM_INFO_USE_RELAX_SERVING_ENGINE="${USE_RELAX_SERVING_ENGINE}"
     TVM_INFO_USE_RELAY_DEBUG="${USE_RELAY_DEBUG}"
     TVM_INFO_TVM_DEBUG_WITH_ABI_CHANGE="${TVM_DEBUG_WITH_ABI_CHANGE}"
     TVM_INFO_TVM_LOG_BEFORE_THROW="${TVM_LOG_BEFORE_THROW}"
@@ -139,6 +142,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_MSC="${USE_MSC}"
     TVM_INFO_USE_CCACHE="${USE_CCACHE}"
     TVM_INFO_USE_NVSHMEM="${USE_NVSHMEM}"
+    TVM_INFO_USE_UCX="${USE_UCX}"
     TVM_INFO_USE_NNAPI_CODEGEN="${USE_NNAPI_CODEGEN}"
     TVM_INFO_USE_NNAPI_RUNTIME="${USE_NNAPI_RUNTIME}"
     TVM_INFO_BACKTRACE_ON_SEGFAULT="${BACKTRACE_ON_SEGFAULT}"
@@ -39,6 +39,11 @@ if(USE_ROCM)
     list(APPEND TVM_RUNTIME_LINKER_LIBS ${ROCM_HSA_LIBRARY})
   endif()
 
+  if(USE_NVTX)
+    message(STATUS "Build with ROCTX support")
+    list(APPEND TVM_RUNTIME_LINKER_LIBS ${ROCM_ROCTX_LIBRARY})
+  endif(USE_NVTX)
+
   if(USE_MIOPEN)
     message(STATUS "Build with MIOpen support")
     tvm_file_glob(GLOB MIOPEN_CONTRIB_SRCS src/runtime/contrib/miopen/*.cc)
@@ -0,0 +1,38 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+if(USE_CUPTI)
+  if(NOT USE_CUDA)
+    message(FATAL_ERROR "USE_CUPTI requires USE_CUDA")
+  endif()
+  find_path(CUPTI_INCLUDE_DIR cupti.h
+    PATHS ${CUDA_TOOLKIT_ROOT_DIR}
+    PATH_SUFFIXES extras/CUPTI/include include
+    NO_DEFAULT_PATH)
+  find_library(CUPTI_LIBRARY cupti
+    PATHS ${CUDA_TOOLKIT_ROOT_DIR}
+    PATH_SUFFIXES extras/CUPTI/lib64 extras/CUPTI/lib lib64 lib
+    NO_DEFAULT_PATH)
+  if(NOT CUPTI_INCLUDE_DIR OR NOT CUPTI_LIBRARY)
+    message(FATAL_ERROR "Cannot find CUPTI in the CUDA toolkit ${CUDA_TOOLKIT_ROOT_DIR}")
+  endif()
+  message(STATUS "Using CUPTI library ${CUPTI_LIBRARY}")
+  target_include_directories(tvm_runtime_objs PRIVATE ${CUPTI_INCLUDE_DIR})
+  target_link_libraries(tvm PRIVATE ${CUPTI_LIBRARY})
+  target_link_libraries(tvm_runtime PRIVATE ${CUPTI_LIBRARY})
+  target_sources(tvm_runtime_objs PRIVATE src/runtime/contrib/cupti/cupti.cc)
+endif()
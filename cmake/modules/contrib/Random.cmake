@@ -19,4 +19,11 @@ if(USE_RANDOM)
   message(STATUS "Build with contrib.random")
   tvm_file_glob(GLOB RANDOM_CONTRIB_SRC src/runtime/contrib/random/random.cc)
   list(APPEND RUNTIME_SRCS ${RANDOM_CONTRIB_SRC})
+  # The Philox kernels filling the tensors on the GPU.
+  if(USE_CUDA)
+    list(APPEND RUNTIME_SRCS src/runtime/contrib/random/philox_kernels.cu)
+  elseif(USE_ROCM AND ${CMAKE_CXX_COMPILER} MATCHES "hipcc$")
+    set_source_files_properties(src/runtime/contrib/random/philox_kernels.cu PROPERTIES LANGUAGE CXX)
+    list(APPEND RUNTIME_SRCS src/runtime/contrib/random/philox_kernels.cu)
+  endif()
 endif(USE_RANDOM)
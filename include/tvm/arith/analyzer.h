@@ -179,6 +179,8 @@ class ConstIntBoundAnalyzer {
   class Impl;
   /*! \brief Internal impl */
   Impl* impl_;
+  /*! \brief The analyzer notified when the known facts change. */
+  Analyzer* parent_{nullptr};
 };
 
 /*!
@@ -260,6 +262,8 @@ class ModularSetAnalyzer {
   class Impl;
   /*! \brief Internal impl */
   Impl* impl_;
+  /*! \brief The analyzer notified when the known facts change. */
+  Analyzer* parent_{nullptr};
 };
 
 /*!
@@ -405,6 +409,8 @@ class RewriteSimplifier {
   class Impl;
   /*! \brief Internal impl */
   Impl* impl_;
+  /*! \brief The analyzer notified when the known facts change. */
+  Analyzer* parent_{nullptr};
 };
 
 /*!
@@ -436,6 +442,8 @@ class CanonicalSimplifier {
   class Impl;
   /*! \brief Internal impl */
   Impl* impl_;
+  /*! \brief The analyzer notified when the known facts change. */
+  Analyzer* parent_{nullptr};
 };
 
 /*! \brief Structure for representing result of known
@@ -521,6 +529,8 @@ class TransitiveComparisonAnalyzer {
   class Impl;
   /*! \brief Internal impl */
   std::unique_ptr<Impl> impl_;
+  /*! \brief The analyzer notified when the known facts change. */
+  Analyzer* parent_{nullptr};
 };
 
 /*!
@@ -614,6 +624,8 @@ class IntSetAnalyzer {
   class Impl;
   /*! \brief Internal impl */
   Impl* impl_;
+  /*! \brief The analyzer notified when the known facts change. */
+  Analyzer* parent_{nullptr};
 };
 
 /*!
@@ -647,6 +659,7 @@ class TVM_DLL Analyzer {
   TransitiveComparisonAnalyzer transitive_comparisons;
   /*! \brief constructor */
   Analyzer();
+  TVM_DLL ~Analyzer();
   /*!
    * \brief Mark the value as non-negative value globally in analyzer.
    *
@@ -779,6 +792,30 @@ class TVM_DLL Analyzer {
    * \note Analyzer will call into sub-analyzers to get the result.
    */
   PrimExpr Simplify(const PrimExpr& expr, int steps = 2);
+  /*!
+   * \brief Notify the analyzer that the facts known by a sub-analyzer changed.
+   *  The results of Simplify and CanProve cached before are no longer used.
+   * \note The sub-analyzers call it from their Bind and Update functions.
+   */
+  void NotifyStateChange();
+  /*!
+   * \brief Get the statistics of the cached results of Simplify and CanProve.
+   * \return The number of "hits", "misses" and the "size" of the cache.
+   */
+  Map<String, Integer> GetCacheStats() const;
+
+ private:
+  friend class ConstraintContext;
+  class Cache;
+  /*! \brief The uncached implementation of CanProve. */
+  bool CanProveImpl(const PrimExpr& cond, ProofStrength strength);
+  /*! \brief The uncached implementation of Simplify. */
+  PrimExpr SimplifyImpl(const PrimExpr& expr, int steps);
+  /*!
+   * \brief The cached results of Simplify and CanProve, keyed by the expression
+   *  and the epoch of the known facts.
+   */
+  std::unique_ptr<Cache> cache_;
 };
 
 }  // namespace arith
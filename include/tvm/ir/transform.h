@@ -260,6 +260,19 @@ class PassContext : public ObjectRef {
    */
   TVM_DLL bool PassEnabled(const PassInfo& info) const;
 
+  /*!
+   * \brief Run a task for each index in [0, num_tasks) under this pass context.
+   *
+   *  The tasks run on up to "ir.num_pass_threads" threads (all the cores when negative),
+   *  and in order on the calling thread by default. Each worker thread sees this context
+   *  as the current one. If tasks fail, the error of the task with the smallest index
+   *  is rethrown once all the tasks are finished.
+   *
+   * \param num_tasks The number of tasks.
+   * \param ftask The task, called with the task index. It must be thread safe.
+   */
+  TVM_DLL void ParallelFor(int num_tasks, const std::function<void(int)>& ftask) const;
+
   /*!
    * \brief Register a valid configuration option and its ValueType for validation.
    *
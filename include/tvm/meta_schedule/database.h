@@ -123,6 +123,8 @@ class TuningRecordNode : public runtime::Object {
   Optional<Target> target;
   /*! \brief The argument information. */
   Optional<Array<ArgInfo>> args_info;
+  /*! \brief The hardware counters collected along with the running time, if any. */
+  Optional<Map<String, FloatImm>> metrics;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("trace", &trace);
@@ -130,6 +132,7 @@ class TuningRecordNode : public runtime::Object {
     v->Visit("run_secs", &run_secs);
     v->Visit("target", &target);
     v->Visit("args_info", &args_info);
+    v->Visit("metrics", &metrics);
   }
 
   static constexpr const char* _type_key = "meta_schedule.TuningRecord";
@@ -164,10 +167,12 @@ class TuningRecord : public runtime::ObjectRef {
    \param run_secs The running time of the tuning record.
    \param target The target of the tuning record.
    \param args_info The argument information of the tuning record.
+   \param metrics The hardware counters of the tuning record.
   */
   TVM_DLL explicit TuningRecord(tir::Trace trace, Workload workload,
                                 Optional<Array<FloatImm>> run_secs, Optional<Target> target,
-                                Optional<Array<ArgInfo>> args_info);
+                                Optional<Array<ArgInfo>> args_info,
+                                Optional<Map<String, FloatImm>> metrics = NullOpt);
   /*!
    * \brief Create a tuning record from a json object.
    * \param json_obj The json object.
@@ -480,9 +485,28 @@ class Database : public runtime::ObjectRef {
    * \param path_tuning_record The path to the database table.
    * \param allow_missing Whether to create new file when the given path is not found.
    * \param mod_eq_name A string to specify the module equality testing and hashing method.
+   * \param concurrent Whether the files are shared with writers in other processes. Writes are
+   *  then serialized by file locks, reads tail the records of the other writers, and duplicate
+   *  records of the same workload, trace and target are dropped.
    */
   TVM_DLL static Database JSONDatabase(String path_workload, String path_tuning_record,
-                                       bool allow_missing, String mod_eq_name = "structural");
+                                       bool allow_missing, String mod_eq_name = "structural",
+                                       bool concurrent = false);
+  /*!
+   * \brief Create a database that uses the JSON files of JSONDatabase with an on-disk index,
+   *  decoding tuning records only when their workload is queried.
+   * \param path_workload The path to the workload table.
+   * \param path_tuning_record The path to the database table, the index is stored next to it.
+   * \param allow_missing Whether to create new file when the given path is not found.
+   * \param top_k_per_workload The max number of records retained per workload, 0 retains all.
+   * \param compact_threshold The number of dropped records after which the record file is
+   *  rewritten without them, 0 never rewrites it.
+   * \param mod_eq_name A string to specify the module equality testing and hashing method.
+   */
+  TVM_DLL static Database IndexedJSONDatabase(String path_workload, String path_tuning_record,
+                                              bool allow_missing, int64_t top_k_per_workload,
+                                              int64_t compact_threshold,
+                                              String mod_eq_name = "structural");
   /*!
    * \brief A database composed of multiple databases, allowing users to guide IR rewriting using
    * combined knowledge of those databases. To each query, it returns the best record among all the
@@ -96,8 +96,13 @@ class Mutator : public runtime::ObjectRef {
    * \return The string of the mutator.
    */
   using FAsString = runtime::TypedPackedFunc<String()>;
-  /*! \brief Create a Mutator that mutates the decision of instruction Sample-Perfect-Tile */
-  TVM_DLL static Mutator MutateTileSize();
+  /*!
+   * \brief Create a Mutator that mutates the decision of instruction Sample-Perfect-Tile
+   * \param prune_by_footprint Whether to reject tile sizes whose analytic shared memory
+   * footprint exceeds the target's `max_shared_memory_per_block` before they are built.
+   * \return The created mutator.
+   */
+  TVM_DLL static Mutator MutateTileSize(bool prune_by_footprint = false);
   /*!
    * \brief Create a Mutator that mutates the parallel extent
    * \param max_jobs_per_core The maximum number of parallel jobs per core.
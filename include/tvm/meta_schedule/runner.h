@@ -40,11 +40,14 @@ class RunnerInputNode : public runtime::Object {
   String device_type;
   /*! \brief The argument information. */
   Array<ArgInfo> args_info;
+  /*! \brief The best known running time of the workload in seconds, if any. */
+  Optional<FloatImm> best_run_secs;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("artifact_path", &artifact_path);
     v->Visit("device_type", &device_type);
     v->Visit("args_info", &args_info);
+    v->Visit("best_run_secs", &best_run_secs);
   }
 
   static constexpr const char* _type_key = "meta_schedule.RunnerInput";
@@ -62,8 +65,10 @@ class RunnerInput : public runtime::ObjectRef {
    * \param artifact_path The path to the built artifact.
    * \param device_type The type of device.
    * \param args_info The argument information.
+   * \param best_run_secs The best known running time of the workload, for adaptive evaluation.
    */
-  TVM_DLL explicit RunnerInput(String artifact_path, String device_type, Array<ArgInfo> args_info);
+  TVM_DLL explicit RunnerInput(String artifact_path, String device_type, Array<ArgInfo> args_info,
+                               Optional<FloatImm> best_run_secs = NullOpt);
   TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(RunnerInput, runtime::ObjectRef, RunnerInputNode);
 };
 
@@ -74,10 +79,13 @@ class RunnerResultNode : public runtime::Object {
   Optional<Array<FloatImm>> run_secs;
   /*! \brief The error message, if any. */
   Optional<String> error_msg;
+  /*! \brief The hardware counters collected by the runner, if any. */
+  Optional<Map<String, FloatImm>> metrics;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("run_secs", &run_secs);
     v->Visit("error_msg", &error_msg);
+    v->Visit("metrics", &metrics);
   }
 
   static constexpr const char* _type_key = "meta_schedule.RunnerResult";
@@ -94,8 +102,10 @@ class RunnerResult : public runtime::ObjectRef {
    * \brief Constructor
    * \brief The run time in seconds.
    * \brief The error message, if any.
+   * \brief The hardware counters, if any.
    */
-  TVM_DLL explicit RunnerResult(Optional<Array<FloatImm>> run_secs, Optional<String> error_msg);
+  TVM_DLL explicit RunnerResult(Optional<Array<FloatImm>> run_secs, Optional<String> error_msg,
+                                Optional<Map<String, FloatImm>> metrics = NullOpt);
   TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(RunnerResult, runtime::ObjectRef, RunnerResultNode);
 };
 
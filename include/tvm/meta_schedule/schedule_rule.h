@@ -242,6 +242,21 @@ class ScheduleRule : public runtime::ObjectRef {
    * \return The schedule rule created
    */
   TVM_DLL static ScheduleRule CrossThreadReduction(Array<runtime::Int> thread_extents);
+  /*!
+   * \brief Create a schedule rule which splits the reduction of the GPU reductions with a small
+   * output and a long reduction, e.g. the matmuls with a few rows, into partitions computed by
+   * different thread blocks. The partial sums of the partitions go to a workspace, which a second
+   * pass reduces into the output.
+   * \param split_factors Candidates of the number of partitions of the reduction.
+   * \param thread_extents Candidates of thread axis extent of the partial sums.
+   * \param min_reduction_extent The minimum cumulative extent of the reduction loops to split.
+   * \param max_spatial_extent The maximum cumulative extent of the spatial loops of the blocks
+   * to split.
+   * \return The schedule rule created
+   */
+  TVM_DLL static ScheduleRule SplitK(Array<runtime::Int> split_factors,
+                                     Array<runtime::Int> thread_extents,
+                                     int64_t min_reduction_extent, int64_t max_spatial_extent);
   /*!
    * \brief A rule that randomly select a compute-at location for a free block
    * \return The schedule rule created
@@ -290,7 +305,7 @@ class ScheduleRule : public runtime::ObjectRef {
 
   /*! \brief Create default schedule rules for LLVM */
   TVM_DLL static Array<ScheduleRule, void> DefaultLLVM();
-  /*! \brief Create default schedule rules for x86 (AVX512 and VNNI) */
+  /*! \brief Create default schedule rules for x86 (AVX512, VNNI and AMX) */
   TVM_DLL static Array<ScheduleRule, void> DefaultX86(const String& type);
   /*! \brief Create default schedule rules for CUDA */
   TVM_DLL static Array<ScheduleRule, void> DefaultCUDA();
@@ -31,12 +31,16 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/support/random_engine.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace tvm {
 namespace meta_schedule {
 
+/*! \brief The cache of measured modules of a task, defined in task_scheduler.cc. */
+class MeasureCache;
+
 class TaskRecordNode : public runtime::Object {
  public:
   /*! \brief The tune context of the task. */
@@ -59,6 +63,10 @@ class TaskRecordNode : public runtime::Object {
   Optional<Array<BuilderResult>> builder_results = NullOpt;
   /*! \brief Packed functions to fetch the runner results asynchronously. */
   Optional<Array<RunnerFuture>> runner_futures = NullOpt;
+  /*! \brief The number of candidates served from the measure cache instead of measured. */
+  int cache_hit_count = 0;
+  /*! \brief The run seconds of the modules already measured for the task. */
+  std::shared_ptr<MeasureCache> measure_cache = nullptr;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("ctx", &ctx);
@@ -71,6 +79,8 @@ class TaskRecordNode : public runtime::Object {
     v->Visit("measure_candidates", &measure_candidates);
     v->Visit("builder_results", &builder_results);
     v->Visit("runner_futures", &runner_futures);
+    v->Visit("cache_hit_count", &cache_hit_count);
+    // `measure_cache` is not visited
   }
 
   static constexpr const char* _type_key = "meta_schedule.TaskRecord";
@@ -139,6 +149,11 @@ class TaskSchedulerNode : public runtime::Object {
   Optional<CostModel> cost_model_;
   /*! \brief The number of remaining tasks to be tuned. */
   int remaining_tasks_;
+  /*!
+   * \brief Whether to build the candidates of a task in the background, while the candidates
+   *  of the next task are generated and the previous ones run.
+   */
+  bool pipelined = false;
 
   /*! \brief The default destructor. */
   virtual ~TaskSchedulerNode() = default;
@@ -150,6 +165,7 @@ class TaskSchedulerNode : public runtime::Object {
     v->Visit("database_", &database_);
     v->Visit("cost_model_", &cost_model_);
     v->Visit("remaining_tasks_", &remaining_tasks_);
+    v->Visit("pipelined", &pipelined);
   }
 
   /*!
@@ -264,19 +280,22 @@ class TaskScheduler : public runtime::ObjectRef {
   /*!
    * \brief Create a task scheduler that fetches tasks in a round-robin fashion.
    * \param logger The tuning task's logging function.
+   * \param pipelined Whether to overlap building with generating and running candidates.
    * \return The task scheduler created.
    */
-  TVM_DLL static TaskScheduler RoundRobin(PackedFunc logger);
+  TVM_DLL static TaskScheduler RoundRobin(PackedFunc logger, bool pipelined = false);
   /*!
    * \brief Create a task scheduler that fetches tasks in a gradient based fashion.
    * \param logger The tuning task's logging function.
    * \param alpha The parameter alpha to control gradient computation.
    * \param window_size The parameter to control backward window size.
    * \param seed The random seed.
+   * \param pipelined Whether to overlap building with generating and running candidates.
    * \return The task scheduler created.
    */
   TVM_DLL static TaskScheduler GradientBased(PackedFunc logger, double alpha, int window_size,
-                                             support::LinearCongruentialEngine::TRandState seed);
+                                             support::LinearCongruentialEngine::TRandState seed,
+                                             bool pipelined = false);
   /*!
    * \brief Create a task scheduler with customized methods on the python-side.
    * \param logger The tuning task's logging function.
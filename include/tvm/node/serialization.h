@@ -47,5 +47,22 @@ TVM_DLL std::string SaveJSON(const runtime::ObjectRef& node);
  */
 TVM_DLL runtime::ObjectRef LoadJSON(std::string json_str);
 
+/*!
+ * \brief save the node as well as all the node it depends on in the compact binary format.
+ *  The field keys and type keys are interned and the tensors are stored as raw bytes,
+ *  which is smaller and faster to load than the json format.
+ *
+ * \return The binary blob.
+ */
+TVM_DLL std::string SaveBinary(const runtime::ObjectRef& node);
+
+/*!
+ * \brief Load tvm Node object from the blob created by SaveBinary.
+ * \param blob The binary blob to load from.
+ *
+ * \return The loaded node.
+ */
+TVM_DLL runtime::ObjectRef LoadBinary(const std::string& blob);
+
 }  // namespace tvm
 #endif  // TVM_NODE_SERIALIZATION_H_
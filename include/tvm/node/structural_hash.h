@@ -249,12 +249,53 @@ class SHashHandlerDefault : public SHashReducer::Handler {
    * \param map_free_vars Whether or not to remap variables if possible.
    */
   virtual void DispatchSHash(const ObjectRef& object, bool map_free_vars);
+  /*!
+   * \brief The domain of this handler in StructuralHashCacheScope.
+   *
+   *  Handlers producing different hash values must use different domains, so a handler
+   *  which overrides DispatchSHash must override this as well, or return -1 to not use
+   *  the cache.
+   *
+   * \return The domain, in [0, kNumHashCacheDomains), or -1.
+   */
+  virtual int HashCacheDomain() const { return 0; }
+
+ public:
+  /*! \brief The number of handler domains in StructuralHashCacheScope. */
+  static constexpr int kNumHashCacheDomains = 2;
 
  private:
   class Impl;
   Impl* impl;
 };
 
+/*!
+ * \brief A scope in which the structural hashes computed on the current thread are cached.
+ *
+ *  The hash of each hashed object is kept, as well as the hash of each subtree without
+ *  free variables or graph nodes, which does not depend on where it appears. Passes which
+ *  hash the same subtrees repeatedly then hash each node once.
+ *
+ *  The cache holds a reference to the objects, so CopyOnWrite copies them instead of
+ *  mutating them in place, and a cached hash stays valid during the scope. Nested scopes
+ *  share the cache of the outermost one.
+ *
+ * \code
+ *   {
+ *     StructuralHashCacheScope scope;
+ *     uint64_t h0 = StructuralHash()(mod);
+ *     uint64_t h1 = StructuralHash()(mod);  // cached
+ *   }
+ * \endcode
+ */
+class StructuralHashCacheScope {
+ public:
+  TVM_DLL StructuralHashCacheScope();
+  TVM_DLL ~StructuralHashCacheScope();
+  StructuralHashCacheScope(const StructuralHashCacheScope&) = delete;
+  StructuralHashCacheScope& operator=(const StructuralHashCacheScope&) = delete;
+};
+
 class SEqualReducer;
 struct NDArrayContainerTrait {
   static constexpr const std::nullptr_t VisitAttrs = nullptr;
@@ -570,6 +570,22 @@ TVM_DLL bool ContainsImpureCall(const Expr& expr,
  */
 TVM_DLL bool WellFormed(Variant<IRModule, Function> obj, bool check_struct_info = true);
 
+/*!
+ * \brief Create an incremental well-formed checker, for the modules of a pass pipeline.
+ *
+ * The checker caches the relax functions found well formed, keyed by their identity, so that a
+ * module derived from a checked one only has the functions added or changed since re-checked.
+ * The cache is dropped when a GlobalVar of the previous module is removed or changes signature,
+ * since the checks of a function depend on the GlobalVars it calls.
+ *
+ * \param check_struct_info Whether the struct info is checked, as in WellFormed.
+ * \return A function checking if an IRModule is well formed.
+ * \note The vars shared between a re-checked function and an unchanged one are not detected, so a
+ * full check with WellFormed is still recommended at the end of the pipeline.
+ */
+TVM_DLL runtime::TypedPackedFunc<bool(IRModule)> IncrementalWellFormed(
+    bool check_struct_info = true);
+
 /*!
  * \brief Using the layout transforms on the outputs, suggest layout transformation on the blocks
  * and buffers for the PrimFunc.
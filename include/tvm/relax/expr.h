@@ -1059,6 +1059,31 @@ constexpr const char* kForcePure = "relax.force_pure";
  * arguments are assumed to be weights that are fixed across invocations.
  */
 constexpr const char* kNumInput = "num_input";
+
+/*!
+ * \brief The exclusive group of a function for memory planning.
+ * The functions of the same group are never running at the same time, e.g. the prefill and the
+ * decode function of a language model, so that their activation memory can be shared.
+ */
+constexpr const char* kMemoryPlanExclusiveGroup = "relax.memory_plan_exclusive_group";
+/*!
+ * \brief The indices of the parameters a function streams from host memory.
+ * The caller passes these weights as host tensors, preferably in pinned memory, and they are
+ * copied to the device ahead of their first use.
+ */
+constexpr const char* kStreamedParams = "relax.streamed_params";
+/*!
+ * \brief The indices of the parameters a function takes ownership of.
+ * The caller gives up the storage of these tensors, which the function may overwrite, e.g. to
+ * compute its outputs in-place.  The donated tensors must not alias any other argument.
+ */
+constexpr const char* kDonatedParams = "relax.donated_params";
+/*!
+ * \brief The parameters a function keeps resident in the L2 cache while they are used.
+ * A map from the name of a tensor parameter to the fraction of its accesses to be persisting in
+ * the L2 cache, consumed by the PersistL2Params pass.
+ */
+constexpr const char* kL2PersistingParams = "relax.l2_persisting_params";
 }  // namespace attr
 
 /*! \brief The extern function, which can represent packed function. */
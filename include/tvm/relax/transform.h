@@ -253,6 +253,22 @@ TVM_DLL Pass LegalizeOps(Optional<Map<String, PackedFunc>> cmap, bool enable_war
  */
 TVM_DLL Pass RealizeVDevice();
 
+/*!
+ * \brief Place the operators without a VDevice on the CPU or the GPU VDevice of the module by
+ * their estimated cost, and copy the tensors they read from the other device with to_vdevice,
+ * as early as possible so that the copies overlap with the computation.
+ *
+ * \param cpu_gflops The throughput of the CPU, in GFLOP/s.
+ * \param gpu_gflops The throughput of the GPU, in GFLOP/s.
+ * \param launch_us The overhead of a kernel launch or of a copy across the devices, in us.
+ * \param transfer_gbps The bandwidth of the copies across the devices, in GB/s.
+ * \return The Pass.
+ *
+ * \note Should be applied after RealizeVDevice and before LegalizeOps.
+ */
+TVM_DLL Pass PlaceVDeviceByCost(double cpu_gflops, double gpu_gflops, double launch_us,
+                                double transfer_gbps);
+
 /*!
  * \brief Attach layout free buffers to the tir::PrimFunc.
  *
@@ -499,6 +515,20 @@ class PatternCheckContext : public ObjectRef {
 TVM_DLL Pass Gradient(String func_name, Optional<Array<Var>> require_grads = NullOpt,
                       int target_index = 0);
 
+/*!
+ * \brief Choose the activations kept for the backward pass, and annotate the others with
+ * start_checkpoint and end_checkpoint, so that Gradient recomputes them in the backward pass.
+ *
+ * \param strategy "sqrt" keeps every ceil(sqrt(n))-th activation. "budget" keeps the activations
+ * that are the most expensive to recompute, estimated by EstimateTIRFlops, within the budget.
+ * \param memory_budget The number of bytes the kept activations may take, including the outputs
+ * of the dataflow blocks. Only used by the "budget" strategy.
+ * \return The Pass.
+ *
+ * \note Should be applied before Gradient. Functions with user annotated checkpoints are skipped.
+ */
+TVM_DLL Pass AnnotateCheckpoints(String strategy = "sqrt", int64_t memory_budget = -1);
+
 /*!
  * \brief Apply pattern matching to each function in the given module, and group matched
  * expressions into a new function. The end result is similar to FuseOps, but fusion is driven
@@ -596,6 +626,26 @@ TVM_DLL Pass AlterOpImpl(const Map<String, tir::PrimFunc>& op_impl_map,
  */
 TVM_DLL Pass ConvertLayout(Map<String, Array<String>> desired_layouts);
 
+/*!
+ * \brief Layout conversion pass that converts only the regions of a dataflow block where the
+ *  desired layouts pay off.
+ *
+ * A region is a set of ops with desired layouts connected by ops the layout propagates through.
+ * Each region keeps the initial layout when that lowers the estimated time of the block: the
+ * kernels of the ops, faster by layout_speedup in the desired layouts, plus the layout
+ * transforms inserted at the boundaries of the converted regions. The transforms of constants
+ * are not counted, as FoldConstant folds them.
+ *
+ * \param desired_layouts The desired layouts of the ops, as in ConvertLayout.
+ * \param layout_speedup The speedup of the ops with desired layouts when converted.
+ * \param gflops The throughput of the kernels, in GFLOPS.
+ * \param transform_gbps The bandwidth of the layout transforms, in GB/s.
+ * \return The Pass.
+ * \note Operates only on dataflow blocks. ConvertToDataflow may need to be called first.
+ */
+TVM_DLL Pass ConvertLayoutByCost(Map<String, Array<String>> desired_layouts,
+                                 double layout_speedup, double gflops, double transform_gbps);
+
 /*!
  * \brief A pass that converts consecutive dataflow operations
  *   inside binding blocks into dataflow blocks.
@@ -629,6 +679,8 @@ TVM_DLL Pass DeadCodeElimination(Array<runtime::String> entry_functions = {});
  * Supported operators will be replaced by calls to `call_tir_inplace` that invoke in-place
  * PrimFunc implementations of those operators (which are based on the legalizations of those
  * operators).
+ * The parameters listed in the "relax.donated_params" attribute of a function may be overwritten
+ * as well, in the dataflow block containing all their uses.
  * \note ConvertToDataflow may need to be called first to provide dataflow blocks.
  * \return The pass.
  */
@@ -640,12 +692,15 @@ TVM_DLL Pass DataflowUseInplaceCalls();
  * \param out_dtype The output data type of gemm/conv, which is the data type of the accumulator.
  * \param fp16_input_names The names of function parameters whose dtype should become fp16. The
  * function signature would change accordingly.
+ * \param fp8_matmul Whether to compute the matmuls with a transposed 2-D rhs in float8 e4m3,
+ * with per-tensor scales, in the form offloaded to the FP8 matmul of cuBLASLt.
  * \return The Pass.
  *
  * \note Mainly operates within dataflow blocks. ConvertToDataflow may need to be called first.
  */
 TVM_DLL Pass ToMixedPrecision(const DataType& out_dtype,
-                              Optional<Array<String>> fp16_input_names = NullOpt);
+                              Optional<Array<String>> fp16_input_names = NullOpt,
+                              bool fp8_matmul = false);
 
 /*!
  * \brief Rewrite a Relax module for executing with CUDA graph. This pass identifies
@@ -654,6 +709,50 @@ TVM_DLL Pass ToMixedPrecision(const DataType& out_dtype,
  */
 TVM_DLL Pass RewriteCUDAGraph();
 
+/*!
+ * \brief Stream the weights of a function from host memory to the device.
+ *
+ * The weights are assigned to a bounded ring of device buffers. The copy of each weight is
+ * issued on a separate copy stream ahead of its first use, and the compute stream waits on an
+ * event of the copy instead of blocking on it.
+ *
+ * \param lookahead The number of weights, in the order of their first use, by which the copies
+ * run ahead of the computation.
+ * \param num_slots The number of device buffers of the ring.
+ * \return The Pass.
+ *
+ * \note Operates on functions without dataflow blocks, and is expected to run after
+ * CallTIRRewrite in the VM lowering pipeline.
+ */
+TVM_DLL Pass StreamParams(int lookahead, int num_slots);
+
+/*!
+ * \brief Keep the parameters annotated by a function resident in the L2 cache while they are used.
+ *
+ * An access policy window is set on the stream for each parameter named by the
+ * `relax.l2_persisting_params` attribute before its first use, and cleared after its last use.
+ * The windows of captured CUDA graphs are set on their kernel nodes.
+ *
+ * \return The Pass.
+ *
+ * \note Operates on functions without dataflow blocks, and is expected to run after
+ * CallTIRRewrite in the VM lowering pipeline.
+ */
+TVM_DLL Pass PersistL2Params();
+
+/*!
+ * \brief Overlap the collectives of Disco with the computation that does not depend on them.
+ *
+ * The legalized allreduce and allgather, and the ring exchange of the ring attention, in dataflow
+ * blocks are replaced by their asynchronous variants, which run on a separate communication stream. The bindings after a collective that
+ * do not depend on it are moved ahead of the wait of the compute stream on the collective.
+ *
+ * \return The Pass.
+ *
+ * \note Should be applied after LegalizeOps and before ToNonDataflow.
+ */
+TVM_DLL Pass OverlapCollectives();
+
 /*!
  * \brief The pass is designed for few shot tuning for static shape PrimFuncs. It examines all the
  *  blocks within the PrimFunc and conducts loop fusion, splitting, and other transformations based
@@ -387,6 +387,30 @@ TVM_DLL int TVMFuncFree(TVMFunctionHandle func);
 TVM_DLL int TVMFuncCall(TVMFunctionHandle func, TVMValue* arg_values, int* type_codes, int num_args,
                         TVMValue* ret_val, int* ret_type_code);
 
+/*!
+ * \brief Call a sequence of Packed Functions in one API call.
+ *
+ *  The arguments of all the calls are concatenated in arg_values and type_codes,
+ *  num_args[i] of them belonging to the i-th call. The calls run in order, and
+ *  stop at the first one that fails.
+ *
+ * \param num_calls Number of calls.
+ * \param funcs The function handles, one per call.
+ * \param arg_values The arguments of all the calls.
+ * \param type_codes The type codes of the arguments of all the calls.
+ * \param num_args Number of arguments of each call.
+ * \param ret_vals The return values, one per call.
+ * \param ret_type_codes The type codes of the return values, one per call.
+ * \param num_finished The number of calls which finished, whose return values are set.
+ *
+ * \return 0 when success, nonzero when failure happens
+ * \note Strings are returned as String objects, as the returned values must stay
+ *  valid until all the calls are finished. Bytes can not be returned.
+ */
+TVM_DLL int TVMFuncCallBatch(int num_calls, TVMFunctionHandle* funcs, TVMValue* arg_values,
+                             int* type_codes, int* num_args, TVMValue* ret_vals,
+                             int* ret_type_codes, int* num_finished);
+
 /*!
  * \brief Set the return value of TVMPackedCFunc.
  *
@@ -493,6 +517,17 @@ TVM_DLL int TVMFuncListGlobalNames(int* out_size, const char*** out_array);
  */
 TVM_DLL int TVMFuncRemoveGlobal(const char* name);
 
+/*!
+ * \brief Get the version of the global function registry.
+ *
+ *  The version changes whenever a global function is registered or removed,
+ *  so that the front-end can cache the functions it looked up.
+ *
+ * \param out The version.
+ * \return 0 when success, nonzero when failure happens
+ */
+TVM_DLL int TVMFuncGetGlobalVersion(uint64_t* out);
+
 // Array related apis for quick proptyping
 /*!
  * \brief Allocate a nd-array's memory,
@@ -0,0 +1,44 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \brief Kernel timings for profiling via the CUPTI activity API.
+ */
+#ifndef TVM_RUNTIME_CONTRIB_CUPTI_H_
+#define TVM_RUNTIME_CONTRIB_CUPTI_H_
+
+#include <tvm/runtime/profiling.h>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+/*! \brief Construct a metric collector that reports the device time and the
+ * number of the kernels launched by each call, from the activity records of
+ * the CUDA Profiling Tools Interface (CUPTI).
+ *
+ * The kernels are attributed through the CUDA launch APIs, so the kernels of
+ * external libraries (cuBLAS, CUTLASS, ...) and of CUDA graph replays count
+ * towards the call that launched them.
+ */
+TVM_DLL MetricCollector CreateCUPTIMetricCollector();
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CONTRIB_CUPTI_H_
@@ -141,6 +141,34 @@ class TVM_DLL DeviceAPI {
    * \param ptr The data space.
    */
   virtual void FreeDataSpace(Device dev, void* ptr) = 0;
+  /*!
+   * \brief Allocate a data space on device, ordered on a stream.
+   *
+   *  The data space can be used by the work submitted to the stream after the call,
+   *  and by the other streams once they are synchronized with it. Unlike AllocDataSpace,
+   *  it does not synchronize the device, and can be captured in a device graph.
+   *  The default implementation falls back to AllocDataSpace.
+   *
+   * \param dev The device device to perform operation.
+   * \param nbytes The number of bytes in memory.
+   * \param alignment The alignment of the memory.
+   * \param type_hint The type of elements.
+   * \param stream The stream to order the allocation on.
+   * \return The allocated device pointer.
+   */
+  virtual void* AllocDataSpaceAsync(Device dev, size_t nbytes, size_t alignment,
+                                    DLDataType type_hint, TVMStreamHandle stream);
+  /*!
+   * \brief Free a data space on device, ordered on a stream.
+   *
+   *  The data space is freed once the work submitted to the stream before the call is
+   *  finished. The default implementation falls back to FreeDataSpace.
+   *
+   * \param dev The device device to perform operation.
+   * \param ptr The data space, allocated by AllocDataSpaceAsync.
+   * \param stream The stream to order the release on.
+   */
+  virtual void FreeDataSpaceAsync(Device dev, void* ptr, TVMStreamHandle stream);
   /*!
    * \brief copy data from one place to another
    * \note This API is designed to support special memory with shape dependent layout.
@@ -86,6 +86,63 @@ TVM_DLL void AllReduce(NDArray send, ReduceKind reduce_kind, bool in_group, NDAr
  * \param recv The array receives the outcome of allgather
  */
 TVM_DLL void AllGather(NDArray send, bool in_group, NDArray recv);
+/*!
+ * \brief Launch an allreduce operation on the communication stream, after the work issued so far
+ * on the compute stream. The result may only be read after WaitCollective.
+ * \param send The array send to perform allreduce on
+ * \param reduce_kind The kind of reduction operation (e.g. sum, avg, min, max)
+ * \param in_group Whether the allreduce operation performs globally or in group as default.
+ * \param recv The array receives the outcome of allreduce
+ */
+TVM_DLL void AllReduceAsync(NDArray send, ReduceKind reduce_kind, bool in_group, NDArray recv);
+/*!
+ * \brief Launch an allgather operation on the communication stream, after the work issued so far
+ * on the compute stream. The result may only be read after WaitCollective.
+ * \param send The array send to perform allgather on
+ * \param in_group Whether the allgather operation performs globally or in group as default.
+ * \param recv The array receives the outcome of allgather
+ */
+TVM_DLL void AllGatherAsync(NDArray send, bool in_group, NDArray recv);
+/*!
+ * \brief Send a buffer to the next worker in the group, and receive the one of the previous
+ * worker, where the last worker is followed by the first one.
+ * \param send The sending buffer.
+ * \param recv The receiving buffer, of the same size.
+ */
+TVM_DLL void RingExchange(NDArray send, NDArray recv);
+/*!
+ * \brief Launch a ring exchange on the communication stream, after the work issued so far on the
+ * compute stream. The result may only be read after WaitCollective.
+ * \param send The sending buffer.
+ * \param recv The receiving buffer, of the same size.
+ */
+TVM_DLL void RingExchangeAsync(NDArray send, NDArray recv);
+/*!
+ * \brief Perform an alltoall operation, in which the buffer is split evenly into one chunk per
+ * worker, and chunk `i` is sent to worker `i`, which places it at chunk `j` of its result for the
+ * sender `j`.
+ * \param send The array send to perform alltoall on
+ * \param in_group Whether the alltoall operation performs globally or in group as default.
+ * \param recv The array receives the outcome of alltoall, of the same size
+ */
+TVM_DLL void AllToAll(NDArray send, bool in_group, NDArray recv);
+/*!
+ * \brief Perform an alltoall operation with a variable number of rows, i.e. slices along the
+ * first axis, for each worker. The chunks are packed in the order of the workers.
+ * \param send The array send to perform alltoallv on
+ * \param send_counts The number of rows sent to each worker
+ * \param recv_counts The number of rows received from each worker
+ * \param in_group Whether the alltoallv operation performs globally or in group as default.
+ * \param recv The array receives the outcome of alltoallv
+ */
+TVM_DLL void AllToAllV(NDArray send, ShapeTuple send_counts, ShapeTuple recv_counts, bool in_group,
+                       NDArray recv);
+/*!
+ * \brief Make the compute stream wait for the asynchronous collective writing to an array.
+ * No-op if no such collective is pending.
+ * \param recv The output array of the collective
+ */
+TVM_DLL void WaitCollective(NDArray recv);
 /*!
  * \brief Perform a broadcast operation from worker-0
  * \param send The buffer to be broadcasted
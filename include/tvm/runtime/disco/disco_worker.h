@@ -33,6 +33,33 @@
 namespace tvm {
 namespace runtime {
 
+/*! \brief The statistics of the commands run by a worker, to find the slow workers with. */
+struct DiscoWorkerStats {
+  /*! \brief The number of buckets in the latency histogram. */
+  static constexpr int kNumLatencyBuckets = 24;
+  /*! \brief The number of commands run. */
+  int64_t num_commands = 0;
+  /*! \brief The total time spent on running the commands, in nanoseconds. */
+  int64_t busy_nanos = 0;
+  /*!
+   * \brief The number of commands taking [2^(i-1), 2^i) microseconds in bucket i, where the
+   * first bucket counts those under a microsecond, and the last one is open-ended.
+   */
+  int64_t latency_histogram[kNumLatencyBuckets] = {};
+
+  /*! \brief Record a command taking the given nanoseconds. */
+  void Record(int64_t nanos) {
+    num_commands += 1;
+    busy_nanos += nanos;
+    int bucket = 0;
+    for (int64_t micros = nanos / 1000; micros > 0 && bucket + 1 < kNumLatencyBuckets;
+         micros >>= 1) {
+      ++bucket;
+    }
+    latency_histogram[bucket] += 1;
+  }
+};
+
 /*!
  * \brief A worker in Disco. It takes a channel to communication with the controler.
  * The worker can be run in a separate thread or process as long as the channel supports
@@ -93,6 +120,8 @@ class DiscoWorker {
   DiscoChannel* channel;
   /*! \brief The registers in the worker */
   std::vector<TVMRetValue> register_file;
+  /*! \brief The statistics of the commands the worker has run */
+  DiscoWorkerStats stats;
 
   struct Impl;
   friend struct DiscoWorker::Impl;
@@ -96,6 +96,8 @@ enum class DiscoAction : int32_t {
   kCopyToWorker0 = 6,
   kDebugGetFromRemote = 7,
   kDebugSetRegister = 8,
+  kDefineCommandGraph = 9,
+  kReplayCommandGraph = 10,
 };
 
 /*! \brief Converts the enum class `DiscoAction` to string */
@@ -119,6 +121,10 @@ inline std::string DiscoAction2String(DiscoAction action) {
       return "kDebugGetFromRemote";
     case DiscoAction::kDebugSetRegister:
       return "kDebugSetRegister";
+    case DiscoAction::kDefineCommandGraph:
+      return "kDefineCommandGraph";
+    case DiscoAction::kReplayCommandGraph:
+      return "kReplayCommandGraph";
   }
   LOG(FATAL) << "ValueError: Unknown DiscoAction: " << static_cast<int>(action);
 }
@@ -229,6 +235,25 @@ class SessionObj : public Object {
    * \param device_ids The device ids of the workers.
    */
   TVM_DLL virtual void InitCCL(String ccl, IntTuple device_ids) = 0;
+  /*!
+   * \brief Start recording a command graph. Until EndCommandGraph, the PackedFunc calls are
+   * recorded instead of being sent to the workers, and their return values are only filled in
+   * when the graph is replayed.
+   * \note Only CallPacked can be recorded. GetGlobalFunc and the deallocation of registers
+   * still take effect immediately, while copying and synchronizing with workers are not allowed.
+   */
+  TVM_DLL virtual void BeginCommandGraph() = 0;
+  /*!
+   * \brief Stop recording, and send the recorded calls to the workers as a command graph.
+   * \return The command graph on the workers.
+   */
+  TVM_DLL virtual DRef EndCommandGraph() = 0;
+  /*!
+   * \brief Run all the calls of a command graph on the workers, in the order they are recorded.
+   * The calls read and write the same registers in every replay.
+   * \param graph The command graph.
+   */
+  TVM_DLL virtual void ReplayCommandGraph(const DRef& graph) = 0;
   /*!
    * \brief Get the value of a register from a remote worker.
    * \param reg_id The id of the register to be fetched.
@@ -47,7 +47,8 @@ inline ObjectPtr<T> make_object(Args&&... args);
 //
 // Possible future allocator optimizations:
 // - Arena allocator that gives ownership of memory to arena (deleter_= nullptr)
-// - Thread-local object pools: one pool per size and alignment requirement.
+// - Thread-local object pools: one pool per size and alignment requirement,
+//   see PooledObjAllocator.
 // - Can specialize by type of object to give the specific allocator to each object.
 
 /*!
@@ -191,15 +192,121 @@ class SimpleObjAllocator : public ObjAllocatorBase<SimpleObjAllocator> {
   };
 };
 
+namespace detail {
+/*! \brief The alignment of the blocks of the object pool. */
+constexpr size_t kObjectPoolAlignment = 16;
+/*!
+ * \brief Allocate a block from the object pool.
+ *
+ *  Blocks up to a few hundred bytes come from thread-local free lists of their size class,
+ *  larger blocks from the global operator new.
+ *
+ * \param size The size of the block in bytes.
+ * \return The block, aligned to kObjectPoolAlignment.
+ */
+TVM_DLL void* ObjectPoolAlloc(size_t size);
+/*!
+ * \brief Return a block to the object pool, from any thread.
+ * \param ptr The block returned by ObjectPoolAlloc.
+ * \param size The size passed to ObjectPoolAlloc.
+ */
+TVM_DLL void ObjectPoolFree(void* ptr, size_t size);
+}  // namespace detail
+
+// Allocator that recycles the memory of objects in size-class pools.
+class PooledObjAllocator : public ObjAllocatorBase<PooledObjAllocator> {
+ public:
+  template <typename T>
+  class Handler {
+   public:
+    static_assert(alignof(T) <= detail::kObjectPoolAlignment, "object alignment constraint");
+
+    template <typename... Args>
+    static T* New(PooledObjAllocator*, Args&&... args) {
+      void* data = detail::ObjectPoolAlloc(sizeof(T));
+      try {
+        new (data) T(std::forward<Args>(args)...);
+      } catch (...) {
+        detail::ObjectPoolFree(data, sizeof(T));
+        throw;
+      }
+      return static_cast<T*>(data);
+    }
+
+    static Object::FDeleter Deleter() { return Deleter_; }
+
+   private:
+    static void Deleter_(Object* objptr) {
+      T* tptr = static_cast<T*>(objptr);
+      tptr->T::~T();
+      detail::ObjectPoolFree(tptr, sizeof(T));
+    }
+  };
+
+  // Array handler that keeps the size of the block in a header before the array.
+  template <typename ArrayType, typename ElemType>
+  class ArrayHandler {
+   public:
+    static_assert(alignof(ArrayType) <= detail::kObjectPoolAlignment &&
+                      alignof(ArrayType) % alignof(ElemType) == 0 &&
+                      sizeof(ArrayType) % alignof(ElemType) == 0,
+                  "element alignment constraint");
+
+    template <typename... Args>
+    static ArrayType* New(PooledObjAllocator*, size_t num_elems, Args&&... args) {
+      size_t size = kHeaderSize + sizeof(ArrayType) + num_elems * sizeof(ElemType);
+      char* data = static_cast<char*>(detail::ObjectPoolAlloc(size));
+      *reinterpret_cast<size_t*>(data) = size;
+      try {
+        new (data + kHeaderSize) ArrayType(std::forward<Args>(args)...);
+      } catch (...) {
+        detail::ObjectPoolFree(data, size);
+        throw;
+      }
+      return reinterpret_cast<ArrayType*>(data + kHeaderSize);
+    }
+
+    static Object::FDeleter Deleter() { return Deleter_; }
+
+   private:
+    static constexpr size_t kHeaderSize = detail::kObjectPoolAlignment;
+
+    static void Deleter_(Object* objptr) {
+      ArrayType* tptr = static_cast<ArrayType*>(objptr);
+      tptr->ArrayType::~ArrayType();
+      char* data = reinterpret_cast<char*>(tptr) - kHeaderSize;
+      detail::ObjectPoolFree(data, *reinterpret_cast<size_t*>(data));
+    }
+  };
+};
+
+// The objects carry their own deleter, so the objects of the pooled and the simple
+// allocators can be mixed freely. TVM_USE_POOLED_OBJECT_ALLOCATOR is set by the
+// USE_POOLED_OBJECT_ALLOCATOR build option for the code of TVM itself.
+#ifndef TVM_USE_POOLED_OBJECT_ALLOCATOR
+#define TVM_USE_POOLED_OBJECT_ALLOCATOR 0
+#endif
+
 template <typename T, typename... Args>
 inline ObjectPtr<T> make_object(Args&&... args) {
-  return SimpleObjAllocator().make_object<T>(std::forward<Args>(args)...);
+  if constexpr (TVM_USE_POOLED_OBJECT_ALLOCATOR &&
+                alignof(T) <= detail::kObjectPoolAlignment) {
+    return PooledObjAllocator().make_object<T>(std::forward<Args>(args)...);
+  } else {
+    return SimpleObjAllocator().make_object<T>(std::forward<Args>(args)...);
+  }
 }
 
 template <typename ArrayType, typename ElemType, typename... Args>
 inline ObjectPtr<ArrayType> make_inplace_array_object(size_t num_elems, Args&&... args) {
-  return SimpleObjAllocator().make_inplace_array<ArrayType, ElemType>(num_elems,
-                                                                      std::forward<Args>(args)...);
+  if constexpr (TVM_USE_POOLED_OBJECT_ALLOCATOR &&
+                alignof(ArrayType) <= detail::kObjectPoolAlignment) {
+    return PooledObjAllocator().make_inplace_array<ArrayType, ElemType>(
+        num_elems, std::forward<Args>(args)...);
+  } else {
+    return SimpleObjAllocator().make_inplace_array<ArrayType, ElemType>(
+        num_elems, std::forward<Args>(args)...);
+  }
 }
 
 }  // namespace runtime
@@ -25,9 +25,12 @@
 #define TVM_RUNTIME_MEMORY_MEMORY_MANAGER_H_
 
 #include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/container/map.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/object.h>
 
+#include <array>
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -42,6 +45,9 @@ namespace memory {
 enum AllocatorType {
   kNaive = 1,
   kPooled,
+  kBucketed,
+  /*! \brief Allocate and free on the current stream of the device, without synchronizing it. */
+  kStreamOrdered,
 };
 
 struct Buffer {
@@ -55,6 +61,44 @@ struct Buffer {
   AllocatorType alloc_type;
 };
 
+/*! \brief Counters of the per-thread buffer caches in front of an allocator. */
+struct ThreadCacheCounters {
+  /*! \brief The allocations served by the calling thread's cache. */
+  uint64_t hits{0};
+  /*! \brief The cacheable allocations that fell through to the shared pool. */
+  uint64_t misses{0};
+  /*! \brief The batched flushes from a thread cache to the shared pool. */
+  uint64_t flushes{0};
+};
+
+/*! \brief A snapshot of the statistics of an allocator. */
+struct AllocatorStats {
+  /*! \brief The number of buckets in the request size histogram. */
+  static constexpr int kNumSizeBuckets = 64;
+  /*! \brief The bytes currently held from the device, in use or cached. */
+  size_t reserved_bytes{0};
+  /*! \brief The peak of reserved_bytes. */
+  size_t peak_reserved_bytes{0};
+  /*! \brief The bytes of the buffers handed out and not yet freed. */
+  size_t in_use_bytes{0};
+  /*! \brief The peak of in_use_bytes. */
+  size_t peak_in_use_bytes{0};
+  /*! \brief The bytes held from the device but not in use. */
+  size_t cached_bytes{0};
+  /*! \brief The number of Alloc and Free calls. */
+  uint64_t alloc_count{0};
+  uint64_t free_count{0};
+  /*! \brief The number of allocations and frees that reached the device API. */
+  uint64_t device_alloc_count{0};
+  uint64_t device_free_count{0};
+  /*! \brief The number of times a failed device allocation was retried after releasing memory. */
+  uint64_t oom_retry_count{0};
+  /*! \brief Bucket i counts the requests of [2^i, 2^(i+1)) bytes, zero bytes land in bucket 0. */
+  std::vector<uint64_t> size_histogram;
+  /*! \brief The counters of the per-thread caches. */
+  ThreadCacheCounters thread_cache;
+};
+
 class Allocator {
  public:
   explicit Allocator(AllocatorType type) : type_(type) {}
@@ -98,13 +142,68 @@ class Allocator {
    *  \return The amount of memory currently allocated.
    */
   TVM_DLL virtual size_t UsedMemory() const = 0;
+  /*! \brief The counters of the per-thread caches, all zero if the allocator has none. */
+  TVM_DLL virtual ThreadCacheCounters GetThreadCacheCounters() const;
+  /*! \brief Take a snapshot of the allocator statistics. */
+  TVM_DLL AllocatorStats GetStats() const;
 
  protected:
   /*! \brief Check if the given memory scope is allowed to allocate by the allocator. */
   TVM_DLL virtual bool AllowMemoryScope(const std::string& mem_scope) const;
+  /*!
+   * \brief Record a buffer handed out to the user.
+   * \param nbytes The requested number of bytes.
+   * \param buffer_size The size of the returned buffer.
+   */
+  void RecordAlloc(size_t nbytes, size_t buffer_size) {
+    alloc_count_.fetch_add(1, std::memory_order_relaxed);
+    size_histogram_[SizeBucket(nbytes)].fetch_add(1, std::memory_order_relaxed);
+    size_t in_use = in_use_bytes_.fetch_add(buffer_size, std::memory_order_relaxed) + buffer_size;
+    UpdatePeak(&peak_in_use_bytes_, in_use);
+  }
+  /*! \brief Record a buffer returned by the user. */
+  void RecordFree(size_t buffer_size) {
+    free_count_.fetch_add(1, std::memory_order_relaxed);
+    in_use_bytes_.fetch_sub(buffer_size, std::memory_order_relaxed);
+  }
+  /*! \brief Record an allocation from the device API. */
+  void RecordDeviceAlloc(size_t nbytes) {
+    device_alloc_count_.fetch_add(1, std::memory_order_relaxed);
+    size_t reserved = reserved_bytes_.fetch_add(nbytes, std::memory_order_relaxed) + nbytes;
+    UpdatePeak(&peak_reserved_bytes_, reserved);
+  }
+  /*! \brief Record a release to the device API. */
+  void RecordDeviceFree(size_t nbytes) {
+    device_free_count_.fetch_add(1, std::memory_order_relaxed);
+    reserved_bytes_.fetch_sub(nbytes, std::memory_order_relaxed);
+  }
+  /*! \brief Record a device allocation retried after releasing the cached memory. */
+  void RecordOOMRetry() { oom_retry_count_.fetch_add(1, std::memory_order_relaxed); }
 
  private:
+  static int SizeBucket(size_t nbytes) {
+    int bucket = 0;
+    while (nbytes >>= 1) ++bucket;
+    return bucket;
+  }
+
+  static void UpdatePeak(std::atomic<size_t>* peak, size_t value) {
+    size_t prev = peak->load(std::memory_order_relaxed);
+    while (prev < value && !peak->compare_exchange_weak(prev, value, std::memory_order_relaxed)) {
+    }
+  }
+
   AllocatorType type_;
+  std::atomic<size_t> reserved_bytes_{0};
+  std::atomic<size_t> peak_reserved_bytes_{0};
+  std::atomic<size_t> in_use_bytes_{0};
+  std::atomic<size_t> peak_in_use_bytes_{0};
+  std::atomic<uint64_t> alloc_count_{0};
+  std::atomic<uint64_t> free_count_{0};
+  std::atomic<uint64_t> device_alloc_count_{0};
+  std::atomic<uint64_t> device_free_count_{0};
+  std::atomic<uint64_t> oom_retry_count_{0};
+  std::array<std::atomic<uint64_t>, AllocatorStats::kNumSizeBuckets> size_histogram_{};
 };
 
 class MemoryManager {
@@ -124,6 +223,20 @@ class MemoryManager {
    * \return The memory allocator.
    */
   TVM_DLL static Allocator* GetAllocator(Device dev, AllocatorType type);
+  /*!
+   * \brief Get the thread cache counters of an allocator.
+   * \param dev The TVM device
+   * \param type The allocator type
+   * \return The counters, all zero if the allocator has not been created yet.
+   */
+  TVM_DLL static ThreadCacheCounters GetThreadCacheCounters(Device dev, AllocatorType type);
+  /*!
+   * \brief Get the statistics of an allocator.
+   * \param dev The TVM device
+   * \param type The allocator type
+   * \return The statistics, all zero if the allocator has not been created yet.
+   */
+  TVM_DLL static AllocatorStats GetStats(Device dev, AllocatorType type);
   /*! \brief Clear the allocators. */
   static void Clear();
 
@@ -136,6 +249,13 @@ class MemoryManager {
       allocators_;
 };
 
+/*!
+ * \brief Convert allocator statistics to a map of named counters.
+ * \param stats The statistics.
+ * \return The map, where size_histogram is a ShapeTuple and the other entries are integers.
+ */
+TVM_DLL Map<String, ObjectRef> AllocatorStatsToMap(const AllocatorStats& stats);
+
 /*! \brief An object representing a storage allocation. */
 class StorageObj : public Object {
  public:
@@ -147,6 +267,25 @@ class StorageObj : public Object {
   /*! \brief Allocate an NDArray from a given piece of storage. */
   TVM_DLL NDArray AllocNDArray(int64_t offset, ShapeTuple shape, DLDataType dtype);
 
+  /*!
+   * \brief Record that the storage is written by the work enqueued on a stream.
+   * \param stream The stream of the write.
+   */
+  void RecordWrite(TVMStreamHandle stream) {
+    has_pending_write_ = true;
+    last_writer_stream_ = stream;
+  }
+
+  /*!
+   * \brief Make a stream wait for the last recorded write of the storage.
+   * \param stream The stream which is going to access the storage.
+   * \return Whether a wait is issued. No wait is needed when no write was recorded,
+   *  or when the last write was on the same stream.
+   * \note The record is not synchronized, the callers of one storage are expected to
+   *  run on the same host thread.
+   */
+  TVM_DLL bool WaitForLastWrite(TVMStreamHandle stream);
+
   /*! \brief The deleter for an NDArray when allocated from underlying storage. */
   static void Deleter(Object* ptr);
 
@@ -159,6 +298,12 @@ class StorageObj : public Object {
   static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
   static constexpr const char* _type_key = "vm.Storage";
   TVM_DECLARE_FINAL_OBJECT_INFO(StorageObj, Object);
+
+ private:
+  /*! \brief Whether a write of the storage was recorded. */
+  bool has_pending_write_ = false;
+  /*! \brief The stream of the last recorded write, where nullptr is the default stream. */
+  TVMStreamHandle last_writer_stream_ = nullptr;
 };
 
 /*! \brief reference to storage. */
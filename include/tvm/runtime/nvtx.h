@@ -22,24 +22,58 @@
 #include <tvm/runtime/c_runtime_api.h>
 
 #include <string>
+#include <type_traits>
+#include <utility>
 namespace tvm {
 namespace runtime {
 
 /*!
- * \brief A class to create a NVTX range. No-op if TVM is not built against NVTX.
+ * \brief Whether the NVTX ranges are emitted.
+ *
+ * The ranges are emitted when TVM is built against NVTX (or ROCTX on ROCm) and the environment
+ * variable TVM_NVTX_RANGES is set to a non-zero value when the runtime is loaded.
+ */
+TVM_DLL bool NVTXRangesEnabled();
+
+/*!
+ * \brief A class to create a NVTX range. No-op if TVM is not built against NVTX or ROCTX, or if
+ * the ranges are not enabled.
  */
 class NVTXScopedRange {
  public:
   /*! \brief Enter an NVTX scoped range */
-  TVM_DLL explicit NVTXScopedRange(const char* name);
+  explicit NVTXScopedRange(const char* name) : active_(IsEnabled()) {
+    if (active_) Push(name);
+  }
   /*! \brief Enter an NVTX scoped range */
   explicit NVTXScopedRange(const std::string& name) : NVTXScopedRange(name.c_str()) {}
+  /*!
+   * \brief Enter an NVTX scoped range, whose name is only computed if the ranges are enabled.
+   * \param f_name The function returning the name of the range.
+   */
+  template <typename FName,
+            typename = std::enable_if_t<std::is_invocable_r_v<std::string, FName>>>
+  explicit NVTXScopedRange(FName&& f_name) : active_(IsEnabled()) {
+    if (active_) Push(std::string(std::forward<FName>(f_name)()).c_str());
+  }
   /*! \brief Exist an NVTX scoped range */
-  TVM_DLL ~NVTXScopedRange();
+  ~NVTXScopedRange() {
+    if (active_) Pop();
+  }
   NVTXScopedRange(const NVTXScopedRange& other) = delete;
   NVTXScopedRange(NVTXScopedRange&& other) = delete;
   NVTXScopedRange& operator=(const NVTXScopedRange& other) = delete;
   NVTXScopedRange& operator=(NVTXScopedRange&& other) = delete;
+
+ private:
+  static bool IsEnabled() {
+    static const bool enabled = NVTXRangesEnabled();
+    return enabled;
+  }
+  TVM_DLL static void Push(const char* name);
+  TVM_DLL static void Pop();
+
+  bool active_;
 };
 
 #ifdef _MSC_VER
@@ -31,6 +31,7 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <mutex>
 #include <stack>
 #include <string>
 #include <unordered_map>
@@ -313,6 +314,13 @@ class MetricCollectorNode : public Object {
    * one of DurationNode, PercentNode, CountNode, or StringObj.
    */
   virtual Map<String, ObjectRef> Stop(ObjectRef obj) = 0;
+  /*! \brief Finish the metrics returned by `Stop`, once all the calls are done.
+   *
+   * Collectors whose measurements are delivered asynchronously, e.g. by the
+   * device, may return metric objects from `Stop` and fill them in here. It
+   * is called before the metrics are read.
+   */
+  virtual void Flush() {}
 
   virtual ~MetricCollectorNode() {}
 
@@ -425,6 +433,77 @@ class Profiler {
   std::unordered_map<String, ObjectRef> configuration_;
 };
 
+/*! \brief Always-on statistics of the calls made in sampled invocations.
+ *
+ * Unlike Profiler, which synchronizes the devices around each call and keeps
+ * a record of every call, the statistics are meant to stay enabled in
+ * production. Only the calls on devices whose timer does not synchronize the
+ * device are measured, and the timers are only read once later invocations
+ * have been made, when their events are long done. The durations are
+ * aggregated into a fixed-size histogram per function.
+ *
+ * Example usage:
+ * \code{.cpp}
+ * if (SampledCallStats::HasAsyncTimer(dev)) {
+ *   Timer t = Timer::Start(dev);
+ *   my_gpu_kernel();
+ *   t->Stop();
+ *   SampledCallStats::Global()->Record("my_gpu_kernel", t);
+ * }
+ * \endcode
+ */
+class SampledCallStats {
+ public:
+  /*! \brief The number of buckets of the histograms. Bucket i counts the
+   * durations in [2^i, 2^(i+1)) nanoseconds, and the last one all the longer
+   * durations.
+   */
+  static constexpr int kNumBuckets = 32;
+  /*! \brief The maximum number of timers waiting to be read, beyond which
+   * the calls are dropped.
+   */
+  static constexpr size_t kMaxPendingTimers = 1 << 14;
+
+  struct Histogram {
+    int64_t count{0};
+    int64_t total_nanos{0};
+    int64_t max_nanos{0};
+    int64_t buckets[kNumBuckets] = {};
+  };
+
+  /*! \brief The statistics of the process. */
+  TVM_DLL static SampledCallStats* Global();
+
+  /*! \brief Whether the timer of a device does not synchronize it. */
+  TVM_DLL static bool HasAsyncTimer(Device dev);
+
+  /*! \brief Record a call, whose timer is read later.
+   * \param name The name of the function called.
+   * \param timer The stopped timer of the call.
+   */
+  TVM_DLL void Record(String name, Timer timer);
+
+  /*! \brief Read the pending timers into the histograms. */
+  TVM_DLL void Resolve();
+
+  /*! \brief Read the pending timers, and return the histograms as json.
+   *
+   * The json maps the name of each function to its "count", "total_ns",
+   * "max_ns" and "buckets".  "dropped" counts the calls that were not
+   * recorded.
+   */
+  TVM_DLL String AsJSON();
+
+  /*! \brief Forget the pending timers and the histograms. */
+  TVM_DLL void Reset();
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::pair<String, Timer>> pending_;
+  std::unordered_map<std::string, Histogram> histograms_;
+  int64_t dropped_{0};
+};
+
 /* \brief A duration in time. */
 class DurationNode : public Object {
  public:
@@ -589,6 +668,33 @@ PackedFunc WrapTimeEvaluator(PackedFunc f, Device dev, int number, int repeat, i
                              int repeats_to_cooldown, int cache_flush_bytes = 0,
                              PackedFunc f_preproc = nullptr);
 
+/*!
+ * \brief Wrap several functions taking the same arguments into one timer function, which
+ *  measures all of them on the same arguments with the settings of WrapTimeEvaluator.
+ *
+ *  The functions are interleaved within each repeat, starting from a different function in
+ *  each repeat, so that a drift of the device over the measurement affects all of them alike.
+ *
+ * \param fs The functions to be measured.
+ * \param dev The device.
+ * \param number The number of times to run each function for taking average.
+ * \param repeat The number of times to repeat the measurement.
+ * \param min_repeat_ms The minimum duration of one `repeat` of a function in milliseconds.
+ * \param limit_zero_time_iterations The maximum number of repeats when
+ *        measured time is equal to 0.
+ * \param cooldown_interval_ms The cooldown interval in milliseconds between the number of repeats
+ *        defined by `repeats_to_cooldown`.
+ * \param repeats_to_cooldown The number of repeats before the cooldown is activated.
+ * \param cache_flush_bytes The number of bytes to flush from cache before each measurement.
+ * \param f_preproc The function to be executed before each repeat.
+ * \return f_timer A timer function, returning `repeat` costs of each function, in the order of
+ *         the functions.
+ */
+PackedFunc WrapBatchTimeEvaluator(std::vector<PackedFunc> fs, Device dev, int number, int repeat,
+                                  int min_repeat_ms, int limit_zero_time_iterations,
+                                  int cooldown_interval_ms, int repeats_to_cooldown,
+                                  int cache_flush_bytes = 0, PackedFunc f_preproc = nullptr);
+
 }  // namespace profiling
 }  // namespace runtime
 }  // namespace tvm
@@ -359,6 +359,14 @@ class Registry {
    * \return The names
    */
   TVM_DLL static std::vector<String> ListNames();
+  /*!
+   * \brief Get the version of the registry, which changes whenever a function is
+   *  registered or removed.
+   * \return The version.
+   * \note It allows the callers to cache the functions they looked up, and only look
+   *  them up again once the version changes.
+   */
+  TVM_DLL static uint64_t Version();
 
   // Internal class.
   struct Manager;
@@ -28,6 +28,7 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -38,7 +39,9 @@
 // NOTE: this file only changes if we change relax vm format
 // for example if relax vm format do not change in 0.15, this should remain as 0.14
 // if it changes in 0.16, we will change it to 0.16
-#define RELAX_VM_VERSION "0.14"
+#define RELAX_VM_VERSION "0.19"
+// The oldest relax vm format that can still be loaded.
+#define RELAX_VM_MIN_LOADABLE_VERSION "0.14"
 
 namespace tvm {
 namespace runtime {
@@ -147,6 +150,8 @@ class Executable : public runtime::ModuleNode {
    * \brief Load Executable from the file.
    * \param file_name The path of the file that load the executable from.
    * \return The loaded executable, in the form of a `runtime::Module`.
+   * \note Where supported, the file is memory mapped and the NDArray constants
+   *  alias the mapped pages instead of being copied to the heap.
    */
   static Module LoadFromFile(const String& file_name);
 
@@ -182,7 +187,7 @@ class Executable : public runtime::ModuleNode {
    * \brief Save the constant pool.
    * \param strm The input stream.
    */
-  void SaveConstantSection(dmlc::Stream* strm);
+  void SaveConstantSection(dmlc::SeekStream* strm);
   /*!
    * \brief Save the instructions.
    * \param strm The input stream.
@@ -201,8 +206,22 @@ class Executable : public runtime::ModuleNode {
   /*!
    * \brief Load the constant pool.
    * \param strm The input stream.
+   * \param mapped_data The memory the stream reads from if it is a mapped file, or nullptr.
+   *  When given, the aligned NDArray constants alias the memory instead of being copied.
+   * \param mapped_data_holder The shared owner keeping `mapped_data` alive.
+   */
+  void LoadConstantSection(dmlc::SeekStream* strm, const char* mapped_data = nullptr,
+                           std::shared_ptr<void> mapped_data_holder = nullptr);
+  /*!
+   * \brief Load Executable from the serialized data in memory.
+   * \param data The serialized data, the content of a `SaveToBinary` string.
+   * \param size The size of the serialized data.
+   * \param mapped_data_holder The shared owner of the data if it is a mapped file, or nullptr
+   *  if the data must be copied.
+   * \return The loaded executable, in the form of a `runtime::Module`.
    */
-  void LoadConstantSection(dmlc::Stream* strm);
+  static Module LoadFromMemory(const char* data, size_t size,
+                               std::shared_ptr<void> mapped_data_holder);
   /*!
    * \brief Load the instructions.
    * \param strm The input stream.
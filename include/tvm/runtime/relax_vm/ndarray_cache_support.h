@@ -48,6 +48,16 @@ struct NDArrayCacheMetadata {
       TVM_DLL NDArray Load(Device device, const std::string* raw_data,
                            Optional<NDArray>* staging_buffer = nullptr) const;
 
+      /*!
+       * \brief Load the parameter from the raw data of its file, e.g. a memory mapping of it.
+       * \param device The device to load the parameter onto.
+       * \param raw_data The start of the raw data of the file.
+       * \param staging_buffer The buffer to be used to avoid extra OpenCL copies. Pass in a nullptr
+       * in other cases
+       */
+      TVM_DLL NDArray LoadFromBytes(Device device, const char* raw_data,
+                                    Optional<NDArray>* staging_buffer = nullptr) const;
+
       /*! \brief Name of the parameter */
       std::string name;
       /*! \brief Shape of the parameter */
@@ -60,6 +70,11 @@ struct NDArrayCacheMetadata {
       int64_t nbytes;
       /*! \brief Offset from the raw stream */
       int64_t byte_offset;
+      /*!
+       * \brief The hex digest of the SHA-256 of the stored bytes, or empty if the cache was
+       *  written without it. Parameters with the same hash, format, dtype and shape are shared.
+       */
+      std::string hash;
     };
 
     /*! \brief Load a FileRecord into memory */
@@ -68,6 +83,24 @@ struct NDArrayCacheMetadata {
                                 std::string* raw_data_buffer,    //
                                 Optional<NDArray>* staging_buffer = nullptr) const;
 
+    /*!
+     * \brief Read the raw bytes of the shard file and validate its size.
+     * \param path_prefix The directory that contains the shard file.
+     * \param raw_data_buffer The buffer to read the file into.
+     * \note This function does not touch any device and can be called from a
+     * background thread to prefetch the next shard.
+     */
+    TVM_DLL void LoadRawData(const std::string& path_prefix, std::string* raw_data_buffer) const;
+
+    /*!
+     * \brief Create the parameters of the shard from its raw bytes.
+     * \param device The device to load the parameters onto.
+     * \param raw_data The raw bytes read by `LoadRawData`.
+     * \param staging_buffer The buffer to be used to avoid extra OpenCL copies.
+     */
+    TVM_DLL Array<NDArray> LoadFromRawData(Device device, const std::string* raw_data,
+                                           Optional<NDArray>* staging_buffer = nullptr) const;
+
     /*! \brief Relative path to the bin file */
     std::string data_path;
     /*! \brief Format of the file */
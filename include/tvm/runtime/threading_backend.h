@@ -149,6 +149,41 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
  */
 TVM_DLL int32_t NumThreads();
 
+/*! \brief How the thread pool distributes the tasks of a parallel launch. */
+enum class TaskSchedule : int {
+  /*! \brief One task per worker, each pushed to the queue of its worker. */
+  kStatic = 0,
+  /*!
+   * \brief Several tasks per worker, kept in a range per worker. A worker that
+   *  runs out of tasks steals half of the remaining range of another worker.
+   *
+   * Parallel barriers are not supported, as the tasks of a launch may not
+   * all run concurrently.
+   */
+  kWorkStealing = 1,
+  /*!
+   * \brief One pool shared by all threads of the process. Launches issued
+   *  concurrently by several threads are served round-robin, and a launch
+   *  issued inside a parallel task is spread onto the idle workers instead
+   *  of running serially.
+   *
+   * Parallel barriers are not supported, as the tasks of a launch may not
+   * all run concurrently.
+   */
+  kShared = 2,
+};
+
+/*!
+ * \brief Set the task schedule used by the thread pools of all threads.
+ * \param schedule The task schedule.
+ *
+ * Note that this does nothing when openmp is used.
+ */
+TVM_DLL void SetTaskSchedule(TaskSchedule schedule);
+
+/*! \return The task schedule used by the thread pools. */
+TVM_DLL TaskSchedule GetTaskSchedule();
+
 }  // namespace threading
 
 /*!
@@ -69,6 +69,7 @@ enum class Opcode {
   ReshapeTensor = 18U,
   DeviceCopy = 19U,
   KillRegister = 20U,
+  AllocInvokePacked = 21U,
 };
 
 /*! \brief A single virtual machine instruction.
@@ -226,6 +227,20 @@ struct Instruction {
       /*! \brief The index of the destination deviceto copy to. */
       Index dst_device_index;
     } device_copy;
+    struct /* AllocInvokePacked Operands */ {
+      /*! \brief The index into the packed function table. */
+      Index packed_index;
+      /*! \brief The arity of the packed function. */
+      Index arity;
+      /*! \brief The number of outputs produced by the packed function. */
+      Index output_size;
+      /*! \brief The arguments to pass to the packed function. */
+      RegName* packed_args;
+      /*! \brief The number of outputs allocated before the call. */
+      Index num_allocs;
+      /*! \brief The AllocTensor instructions allocating the outputs, run before the call. */
+      Instruction* allocs;
+    } alloc_invoke_packed;
   };
 
   /*!
@@ -399,6 +414,18 @@ struct Instruction {
                                 RegName dst);
 
   static Instruction KillRegister(RegName dst);
+  /*!
+   * \brief Construct an invoke packed instruction which allocates some of its outputs first.
+   * \param packed_index The index of the packed function.
+   * \param arity The arity of the function.
+   * \param output_size The number of outputs of the packed function.
+   * \param args The argument registers.
+   * \param allocs The AllocTensor instructions of the outputs to allocate.
+   * \return The alloc invoke packed instruction.
+   */
+  static Instruction AllocInvokePacked(Index packed_index, Index arity, Index output_size,
+                                       const std::vector<RegName>& args,
+                                       const std::vector<Instruction>& allocs);
 
   Instruction();
   Instruction(const Instruction& instr);
@@ -24,6 +24,7 @@
 #include <tvm/script/printer/doc.h>
 #include <tvm/script/printer/ir_docsifier_functor.h>
 
+#include <ostream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -253,6 +254,22 @@ class IRDocsifier : public ObjectRef {
   TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(IRDocsifier, ObjectRef, IRDocsifierNode);
 };
 
+/*!
+ * \brief Print an IRModule into TVMScript one function at a time.
+ *
+ * Each function is converted to Doc and printed on its own, so that the Doc tree of the whole
+ * module is never built, and the functions may be printed in parallel. The text is the same as
+ * the one of `TVMScriptPrinter::Script`, which is used instead when the module has metadata,
+ * or when the config asks for line numbers, underlines or annotations.
+ *
+ * \param mod The module to print.
+ * \param cfg The configuration of the printer.
+ * \param os The stream to write the script into.
+ * \param num_threads The number of threads printing the functions.
+ */
+TVM_DLL void IRModuleToScript(const IRModule& mod, const PrinterConfig& cfg, std::ostream& os,
+                              int num_threads = 1);
+
 //////////////////////// Implementation ////////////////////////
 
 inline void FrameNode::EnterWithScope() {
@@ -446,7 +446,9 @@ constexpr const char* kRelayToTIR = "RelayToTIR";
           .add_attr_option<Array<String>>("libs")                 \
           .add_attr_option<Target>("host")                        \
           .add_attr_option<runtime::Int>("from_device")           \
-          .add_attr_option<runtime::Int>("target_device_type")
+          .add_attr_option<runtime::Int>("target_device_type")    \
+          .add_attr_option<runtime::Int>("peak_gflops")           \
+          .add_attr_option<runtime::Int>("peak_bandwidth_gbps")
 
 }  // namespace tvm
 
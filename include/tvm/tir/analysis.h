@@ -354,6 +354,20 @@ TVM_DLL bool VerifyWellFormed(const PrimFunc& func, bool assert_mode = true);
  */
 TVM_DLL bool VerifyWellFormed(const IRModule& mod, bool assert_mode = true);
 
+/*!
+ * \brief Create an incremental verifier of the well-formedness of TIR, for the modules of a pass
+ * pipeline.
+ *
+ * The verifier keeps the PrimFuncs of the last module found well-formed, so that the next module
+ * only has the PrimFuncs added or changed since, as told by their identity, verified.
+ *
+ * \param assert_mode The indicator if it raises an error when a function is not well-formed.
+ * \return A function verifying if the TIR in an IRModule is well-formed.
+ * \note A variable defined both in a changed PrimFunc and in an unchanged one is not detected.
+ */
+TVM_DLL runtime::TypedPackedFunc<bool(IRModule)> IncrementalVerifyWellFormed(
+    bool assert_mode = true);
+
 /*!
  * \brief Find the entry function of the given IRModule, i.e, functions marked by
  * `tir::attr::kIsEntryFunc`, whose name is `main` or being the only PrimeFunc.
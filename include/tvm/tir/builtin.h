@@ -673,6 +673,21 @@ TVM_DLL const Op& ptx_cp_async();
  */
 TVM_DLL const Op& ptx_cp_async_bulk();
 
+/*!
+ * \brief tvm intrinsics for ptx async copy of a tile of a tensor from global to shared memory
+ *  using the TMA unit, cp.async.bulk.tensor
+ *
+ * void ptx_cp_async_bulk_tensor(Var shared_ptr,
+ *                               Expr shared_offset,
+ *                               Var tensor_map,
+ *                               int barrier_id,
+ *                               Expr coord_0, ..., Expr coord_{N-1});
+ *
+ * The tensor map points to the CUtensorMap of the tensor in global memory, and the coordinates
+ * of the tile are given from the outermost dimension of the tensor to the innermost one.
+ */
+TVM_DLL const Op& ptx_cp_async_bulk_tensor();
+
 /*!
  * \brief tvm intrinsics for ptx async copy commit and wait.
  *
@@ -719,10 +734,61 @@ TVM_DLL const Op& ptx_arrive_barrier_expect_tx();
  * \brief tvm intrinsics for ptx barrier wait using mbarrier.try_wait
  *
  * ptx_wait_barrier(int barrier_id)
+ * ptx_wait_barrier(int barrier_id, Expr phase)
  *
+ * The phase parity to wait for is 0 when it is not given.
  */
 TVM_DLL const Op& ptx_wait_barrier();
 
+/*!
+ * \brief tvm intrinsic for the matrix descriptor of a wgmma operand in shared memory
+ *
+ * uint64 ptx_wgmma_encode_desc(Var shared_ptr,
+ *                              Expr shared_offset,
+ *                              int leading_byte_offset,
+ *                              int stride_byte_offset,
+ *                              int swizzle_bytes);
+ *
+ * swizzle_bytes is 0 for no swizzle, or 32, 64 and 128 for the swizzle modes of the TMA copy
+ * which wrote the operand.
+ */
+TVM_DLL const Op& ptx_wgmma_encode_desc();
+
+/*!
+ * \brief tvm intrinsic for ptx warpgroup level async tensor core MMA, wgmma.mma_async, with
+ *  both multiplicands in shared memory.
+ *
+ * void ptx_wgmma(StringImm shape, StringImm A_layout, StringImm B_layout,
+ *                StringImm A_dtype, StringImm B_dtype, StringImm C_dtype,
+ *                Expr desc_a, Expr desc_b,
+ *                Var accumulator, Expr c_index,
+ *                Expr scale_out);
+ *
+ * The accumulator is the register fragment of the thread, which is read when scale_out is
+ * non-zero and overwritten otherwise.
+ */
+TVM_DLL const Op& ptx_wgmma();
+
+/*!
+ * \brief tvm intrinsics for ordering the register accesses of the accumulators before wgmma,
+ *  and for committing and waiting on the groups of wgmma operations.
+ *
+ * void ptx_wgmma_fence();
+ * void ptx_wgmma_commit_group();
+ * void ptx_wgmma_wait_group(int num);
+ */
+TVM_DLL const Op& ptx_wgmma_fence();
+TVM_DLL const Op& ptx_wgmma_commit_group();
+TVM_DLL const Op& ptx_wgmma_wait_group();
+
+/*!
+ * \brief tvm intrinsic to change the number of registers per thread of a warp, used to move
+ *  registers from the producer warps to the consumer warps of a warp specialized kernel.
+ *
+ * void ptx_setmaxnreg(bool is_inc, int reg_count);
+ */
+TVM_DLL const Op& ptx_setmaxnreg();
+
 /*!
  * \brief tvm intrinsics to create N barriers
  *
@@ -853,6 +919,21 @@ TVM_DLL const Op& texture2d_load();
  */
 TVM_DLL const Op& dma_copy();
 
+/*!
+ * \brief Initiate non-blocking DMA copies of a sequence of tiles
+ *
+ * dma_copy_tiles(queue_id, dst, src, tile_size, num_tiles, dst_stride, src_stride, bypass_cache)
+ *
+ * Copies `tile_size` bytes from `src + i * src_stride` to
+ * `dst + i * dst_stride` for each `i` in `[0, num_tiles)`.  The
+ * copies are launched at once, as a chain of DMA descriptors.
+ *
+ * If a `dma_start_group()` call is active, the copies will be added
+ * to the current group.  Otherwise, they will be tracked together as
+ * a single group.
+ */
+TVM_DLL const Op& dma_copy_tiles();
+
 /*!
  * \brief Wait until the number of DMA groups in flight is less than
  * or equal to some maximum
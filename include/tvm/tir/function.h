@@ -359,6 +359,23 @@ constexpr const char* kIsHostFunc = "tir.is_host_func";
  */
 constexpr const char* kIsScheduled = "tir.is_scheduled";
 
+/*!
+ * \brief The shape buckets the function is specialized for by SpecializeShapeBuckets.
+ *
+ * Each bucket is a conjunction of conditions on the symbolic shape variables.
+ *
+ * Type: Array<PrimExpr>
+ */
+constexpr const char* kShapeBuckets = "tir.shape_buckets";
+
+/*!
+ * \brief Allow LowerIntrin to replace the float32 transcendental functions with their fast
+ * polynomial approximations, e.g. exp, tanh and erf on llvm targets.
+ *
+ * Type: Integer
+ */
+constexpr const char* kFastMath = "tir.fast_math";
+
 }  // namespace attr
 }  // namespace tir
 }  // namespace tvm
@@ -688,6 +688,23 @@ TVM_DLL PrimExpr q_multiply_shift(PrimExpr x, PrimExpr y, PrimExpr q, PrimExpr s
  */
 TVM_DLL PrimExpr fast_erf_float_expr(PrimExpr arg, int bits);
 
+/*!
+ * \brief Fast_exp_float expression, a polynomial approximation from Cephes
+ *
+ * \param arg The input expression, of float32 elements.
+ * \return The constructed expression.
+ */
+TVM_DLL PrimExpr fast_exp_float_expr(PrimExpr arg);
+
+/*!
+ * \brief Fast_tanh_float expression from Eigen
+ *
+ * \param arg The input expression.
+ * \param bits The number of bits in the type.
+ * \return The constructed expression.
+ */
+TVM_DLL PrimExpr fast_tanh_float_expr(PrimExpr arg, int bits);
+
 // Intrinsic operators
 #define TVM_DECLARE_INTRIN_UNARY(OpName)                                \
   inline PrimExpr OpName(PrimExpr x, Span span = Span()) {              \
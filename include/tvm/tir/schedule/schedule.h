@@ -909,6 +909,18 @@ class Schedule : public runtime::ObjectRef {
   TVM_DLL static Schedule Traced(IRModule mod, support::LinearCongruentialEngine::TRandState seed,
                                  int debug_mask, ScheduleErrorRenderLevel error_render_level,
                                  bool enable_check = true);
+  /*!
+   * \brief Construct a traced concrete TensorIR schedule from an existing schedule state
+   * \param state The schedule state to be scheduled, which is owned by the schedule afterwards
+   * \param seed The seed value for schedule's random state
+   * \param error_render_level The level of error rendering
+   * \return The concrete schedule created
+   * \note Together with ScheduleStateNode::Copy, it creates schedules of the same module
+   * without analyzing the IR again.
+   */
+  TVM_DLL static Schedule Traced(ScheduleState state,
+                                 support::LinearCongruentialEngine::TRandState seed,
+                                 ScheduleErrorRenderLevel error_render_level);
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(Schedule, runtime::ObjectRef, ScheduleNode);
 };
 
@@ -83,6 +83,8 @@ enum ScheduleDebugMask : uint32_t {
   kVerifyCachedFlags = 2,
 };
 
+class ScheduleState;
+
 /*!
  * \brief The state of scheduling, which exposes a `Replace` method as
  * the primary interface for all the scheduling primitives to manipulate the TensorIR.
@@ -153,6 +155,13 @@ class ScheduleStateNode : public Object {
    * `region_cover` and `stage_pipeline`
    */
   TVM_DLL void DebugVerify() const;
+  /*!
+   * \brief Create a copy of the state, which shares the IR but has its own srefs and
+   * dependencies, so that it can be scheduled independently.
+   * \return The copied state
+   * \note It is much cheaper than creating a new state of the same module, which analyzes the IR.
+   */
+  TVM_DLL ScheduleState Copy() const;
 
   static constexpr const char* _type_key = "tir.ScheduleState";
   TVM_DECLARE_FINAL_OBJECT_INFO(ScheduleStateNode, Object);
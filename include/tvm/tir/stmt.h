@@ -1428,6 +1428,13 @@ constexpr const char* reduce_scope = "reduce_scope";
 constexpr const char* pragma_auto_unroll_max_step = "pragma_auto_unroll_max_step";
 /*! \brief Pragma: unroll explicit */
 constexpr const char* pragma_unroll_explicit = "pragma_unroll_explicit";
+/*! \brief Pragma: unroll the loop partially by the factor, with a remainder loop */
+constexpr const char* pragma_unroll_factor = "pragma_unroll_factor";
+/*!
+ * \brief Pragma: unroll the loop partially by the factor and jam the copies into its inner loop.
+ *  The caller asserts that the two loops can be interchanged.
+ */
+constexpr const char* pragma_unroll_and_jam = "pragma_unroll_and_jam";
 /*! \brief Mark region is guarded by the pragma extension */
 constexpr const char* pragma_scope_prefix = "pragma_";
 /*! \brief Import C source or file into the final code gen module */
@@ -1575,6 +1582,12 @@ constexpr const char* software_pipeline_order = "software_pipeline_order";
  */
 constexpr const char* software_pipeline_async_stages = "software_pipeline_async_stages";
 
+/*! \brief Mark the number of iterations ahead of which the pipeline prefetches global memory
+ * \note Used for CPU schedules, where the loads are not asynchronous. Every statement of the
+ *       pipeline reading global memory prefetches the region it reads that many iterations later.
+ */
+constexpr const char* software_pipeline_prefetch_distance = "software_pipeline_prefetch_distance";
+
 /*! \brief Mark the buffers which is const access and can be transformed layout. */
 constexpr const char* layout_free_buffers = "layout_free_buffers";
 
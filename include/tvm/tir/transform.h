@@ -220,10 +220,28 @@ TVM_DLL Pass InstrumentBoundCheckers();
  *
  *       where n == len(api_args), k == num_packed_args
  *
+ *  When the PassContext option "tir.emit_trusted_entry" is set, a trusted entry of the
+ *  same signature and symbol suffixed by kTrustedEntrySuffix is emitted next to each
+ *  function. It skips the checks of the arguments, and is meant for the callers that
+ *  validated the arguments already, e.g. the Relax VM and AOT executors.
+ *
  * \return The pass.
  */
 TVM_DLL Pass MakePackedAPI();
 
+/*! \brief The suffix of the symbol of the trusted entry emitted by MakePackedAPI. */
+constexpr const char* kTrustedEntrySuffix = "_trusted";
+
+/*!
+ * \brief The symbol of the trusted entry of a function, for the callers that validated its
+ *  arguments.
+ *
+ * \param func The function to be called.
+ * \return The symbol of the trusted entry, or NullOpt if MakePackedAPI does not emit one under
+ *  the current PassContext.
+ */
+TVM_DLL Optional<String> TrustedEntrySymbol(const PrimFunc& func);
+
 /*!
  * \brief Transform the high-level PrimFunc to a C signature that can be used
  *   to call the operator directly.
@@ -573,6 +591,16 @@ TVM_DLL Pass LowerOpaqueBlock();
  */
 TVM_DLL Pass FlattenBuffer();
 
+/*!
+ * \brief Multi-version the functions annotated with tir::attr::kShapeBuckets.
+ *
+ * The body is specialized for each bucket, and a runtime dispatch picks the first bucket
+ * matching the symbolic shapes, falling back to the generic body.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass SpecializeShapeBuckets();
+
 /*
  * \brief Flatten the multi-dimensional read/write
  *  to two dimensional texture Load/Store and realize
@@ -830,9 +858,13 @@ TVM_DLL Pass InstrumentProfileIntrinsics();
  * \note The primary objective of this pass is not to optimize performance, but rather to
  *  generate a valid GPU kernel for unscheduled or symbolic shape PrimFuncs. The pass is
  *  currently only working for CUDA targets.
+ * \param heuristic Whether to first schedule the PrimFuncs with the rule-based heuristics for the
+ *  common kernels, i.e. elementwise ops, transposes, reductions, GEMVs and matmuls, which give
+ *  reasonable performance without tuning. The functions no rule applies to, e.g. those with
+ *  symbolic shapes the rules cannot tile, fall back to the default thread bindings.
  * \return The Pass.
  */
-TVM_DLL Pass DefaultGPUSchedule();
+TVM_DLL Pass DefaultGPUSchedule(bool heuristic = false);
 
 /*!
  * \brief This pass analyzes primfunc & eliminates branch introdued due to layout specific padding.
@@ -80,42 +80,8 @@ TOPI_DECLARE_UNARY_OP(isinf);
  * https://github.com/eigenteam/eigen-git-mirror/blob/master/Eigen/src/Core/MathFunctionsImpl.h#L26
  */
 inline Tensor fast_tanh_float(const Tensor& in, std::string name, std::string tag) {
-  // Clamp the inputs to the range [-9, 9] since anything outside
-  // this range is +/-1.0f in single-precision.
-  auto x = maximum(make_const(in->dtype, -9.0), minimum(make_const(in->dtype, 9.0), in));
-
-  // The monomial coefficients of the numerator polynomial (odd).
-  auto alpha_1 = make_const(in->dtype, 4.89352455891786e-03);
-  auto alpha_3 = make_const(in->dtype, 6.37261928875436e-04);
-  auto alpha_5 = make_const(in->dtype, 1.48572235717979e-05);
-  auto alpha_7 = make_const(in->dtype, 5.12229709037114e-08);
-  auto alpha_9 = make_const(in->dtype, -8.60467152213735e-11);
-  auto alpha_11 = make_const(in->dtype, 2.00018790482477e-13);
-  auto alpha_13 = make_const(in->dtype, -2.76076847742355e-16);
-
-  // The monomial coefficients of the denominator polynomial (even).
-  auto beta_0 = make_const(in->dtype, 4.89352518554385e-03);
-  auto beta_2 = make_const(in->dtype, 2.26843463243900e-03);
-  auto beta_4 = make_const(in->dtype, 1.18534705686654e-04);
-  auto beta_6 = make_const(in->dtype, 1.19825839466702e-06);
-
   return compute(
-      x->shape,
-      [&](const Array<Var>& i) {
-        auto x2 = x(i) * x(i);
-        auto p = x2 * alpha_13 + alpha_11;
-        p = x2 * p + alpha_9;
-        p = x2 * p + alpha_7;
-        p = x2 * p + alpha_5;
-        p = x2 * p + alpha_3;
-        p = x2 * p + alpha_1;
-        p = x(i) * p;
-
-        auto q = x2 * beta_6 + beta_4;
-        q = x2 * q + beta_2;
-        q = x2 * q + beta_0;
-        return p / q;
-      },
+      in->shape, [&](const Array<Var>& i) { return fast_tanh_float_expr(in(i), in->dtype.bits()); },
       name, tag);
 }
 
@@ -398,37 +364,8 @@ inline Tensor full_like(const Tensor& x, const PrimExpr fill_value,
  * y = exp(f) = 1 + 2 * P(x**2)/(Q(x**2) - P(x**2))
  */
 inline Tensor fast_exp_float32(const Tensor& _x, std::string name, std::string tag) {
-  auto x_hi = make_const(DataType::Float(32), 88.3762626647950f);
-  auto x_lo = make_const(DataType::Float(32), -88.3762626647949f);
-  auto log2e = make_const(DataType::Float(32), 1.44269504088896341f);
-  auto ln2 = make_const(DataType::Float(32), 0.6931471805599453f);
-  PrimExpr p[6] = {make_const(DataType::Float(32), 1.9875691500E-4f),
-                   make_const(DataType::Float(32), 1.3981999507E-3f),
-                   make_const(DataType::Float(32), 8.3334519073E-3f),
-                   make_const(DataType::Float(32), 4.1665795894E-2f),
-                   make_const(DataType::Float(32), 1.6666665459E-1f),
-                   make_const(DataType::Float(32), 5.0000001201E-1f)};
-  auto one = make_const(DataType::Float(32), 1.0f);
-  auto one_half = make_const(DataType::Float(32), 0.5f);
-  auto b = make_const(DataType::Float(32), 127.0f);
-
   return compute(
-      _x->shape,
-      [&](const Array<Var>& i) {
-        // clamp x
-        auto x = ::tvm::max(::tvm::min(_x(i), x_hi), x_lo);
-        // integer part
-        auto n = ::tvm::floor(x * log2e + one_half);
-        // fractional part
-        auto f = x - n * ln2;
-        auto y =
-            (((((p[0] * f + p[1]) * f + p[2]) * f + p[3]) * f + p[4]) * f + p[5]) * f * f + f + one;
-        // Return 2^m * exp(r).
-        auto ef =
-            tvm::reinterpret(DataType::Float(32), ::tvm::cast(DataType::Int(32), n + b) << 23);
-        return ::tvm::max(ef * y, _x(i));  // NOLINT(*)
-      },
-      name, tag);
+      _x->shape, [&](const Array<Var>& i) { return fast_exp_float_expr(_x(i)); }, name, tag);
 }
 
 /*!
@@ -75,6 +75,86 @@ inline tvm::te::Tensor dense(const tvm::te::Tensor& data, const tvm::te::Tensor&
   return matmul;
 }
 
+/*!
+ * \brief Creates an operation that calculates data * dequantize(weight)^T + bias, with the weight
+ * quantized to 4 or 8 bits by groups of input channels.
+ *
+ * The weight is dequantized as (q - zero_point) * scale within the reduction, so that it is read
+ * from memory in its quantized form, rather than materialized in out_dtype by a separate
+ * dequantize op.
+ *
+ * \param data Tensor with shape [batch, in_dim]
+ * \param weight For 8 bits, int8 tensor with shape [out_dim, in_dim].  For 4 bits, uint8 tensor
+ * with shape [out_dim, in_dim / 2], packing the values of the input channels 2k and 2k + 1 in the
+ * low and the high nibble of its column k
+ * \param scale Tensor with shape [out_dim, ceil(in_dim / group_size)]
+ * \param zero_point Tensor with the shape of scale. Optional; to omit, pass Tensor(), the zero
+ * point then being 8 for the unsigned 4 bit values and 0 for the signed 8 bit values
+ * \param bias Tensor with shape [out_dim]. Optional; to omit bias, pass Tensor()
+ * \param bits The bits of the quantized values, 4 or 8
+ * \param group_size The number of input channels sharing a scale and a zero point
+ * \param out_dtype Output data type, in which the weight is dequantized.
+ *
+ * \return Tensor with shape [batch, out_dim]
+ */
+inline tvm::te::Tensor weight_only_dense(const tvm::te::Tensor& data,
+                                         const tvm::te::Tensor& weight,
+                                         const tvm::te::Tensor& scale,
+                                         const tvm::te::Tensor& zero_point,
+                                         const tvm::te::Tensor& bias, int bits, int group_size,
+                                         const DataType& out_dtype) {
+  ICHECK_EQ(data->shape.size(), 2) << "weight_only_dense requires 2-D data";
+  ICHECK_EQ(weight->shape.size(), 2) << "weight_only_dense requires 2-D weight";
+  ICHECK_EQ(scale->shape.size(), 2) << "weight_only_dense requires 2-D scale";
+  ICHECK(bits == 4 || bits == 8) << "weight_only_dense requires 4 or 8 bits, but got " << bits;
+  ICHECK_GT(group_size, 0) << "weight_only_dense requires a positive group size";
+  if (bits == 8) {
+    ICHECK(weight->dtype == DataType::Int(8))
+        << "weight_only_dense requires int8 weight for 8 bits";
+  } else {
+    ICHECK(weight->dtype == DataType::UInt(8))
+        << "weight_only_dense requires uint8 weight for 4 bits";
+  }
+  if (bias.defined()) {
+    ICHECK_EQ(bias->shape.size(), 1) << "weight_only_dense requires 1-D bias";
+  }
+
+  auto batch = data->shape[0];
+  auto in_dim = data->shape[1];
+  auto out_dim = weight->shape[0];
+
+  auto dequantize = [&](const PrimExpr& j, const PrimExpr& k) {
+    PrimExpr q;
+    if (bits == 8) {
+      q = tvm::cast(out_dtype, weight(j, k));
+    } else {
+      PrimExpr packed = tvm::cast(DataType::Int(32), weight(j, indexdiv(k, 2)));
+      q = tvm::cast(out_dtype, (packed >> (indexmod(k, 2) * 4)) & 15);
+    }
+    PrimExpr group = indexdiv(k, group_size);
+    PrimExpr zero = zero_point.defined() ? tvm::cast(out_dtype, zero_point(j, group))
+                                         : make_const(out_dtype, bits == 4 ? 8 : 0);
+    return (q - zero) * tvm::cast(out_dtype, scale(j, group));
+  };
+
+  auto k = tvm::te::reduce_axis(Range(0, in_dim), "k");
+  auto matmul = tvm::te::compute(
+      {batch, out_dim},
+      [&](Var i, Var j) {
+        return tvm::sum(tvm::cast(out_dtype, data(i, k)) * dequantize(j, k->var), {k});
+      },
+      "tensor", "weight_only_dense");
+
+  if (bias.defined()) {
+    matmul = tvm::te::compute(
+        {batch, out_dim},
+        [&](Var i, Var j) { return matmul(i, j) + tvm::cast(out_dtype, bias(j)); }, "tensor",
+        kBroadcast);
+  }
+
+  return matmul;
+}
+
 }  // namespace nn
 }  // namespace topi
 }  // namespace tvm
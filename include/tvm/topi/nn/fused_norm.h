@@ -0,0 +1,238 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \brief Normalizations fused with the residual add before them and the quantization after them
+ * \file nn/fused_norm.h
+ */
+#ifndef TVM_TOPI_NN_FUSED_NORM_H_
+#define TVM_TOPI_NN_FUSED_NORM_H_
+
+#include <tvm/te/operation.h>
+#include <tvm/topi/reduction.h>
+#include <tvm/topi/tags.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace tvm {
+namespace topi {
+namespace nn {
+
+using namespace tvm::te;
+
+namespace detail {
+
+/*! \brief Split the indices of an element into the reduced and the kept ones. */
+inline void SplitNormIndices(const Array<Var>& indices, const std::vector<int>& real_axis,
+                             Array<PrimExpr>* reduce_indices, Array<PrimExpr>* non_reduce_indices) {
+  for (int i = 0, n = static_cast<int>(indices.size()); i < n; ++i) {
+    if (std::find(real_axis.begin(), real_axis.end(), i) != real_axis.end()) {
+      reduce_indices->push_back(indices[i]);
+    } else {
+      non_reduce_indices->push_back(indices[i]);
+    }
+  }
+}
+
+/*! \brief The indices of the element of a row visited by the reduce axes. */
+inline Array<PrimExpr> MakeRowIndices(const Array<Var>& indices, const std::vector<int>& real_axis,
+                                      const Array<IterVar>& reduce_axes, size_t ndim) {
+  Array<PrimExpr> eval_range;
+  int arg_counter = 0;
+  int red_counter = 0;
+  for (size_t i = 0; i < ndim; ++i) {
+    if (std::find(real_axis.begin(), real_axis.end(), i) != real_axis.end()) {
+      eval_range.push_back(reduce_axes[red_counter++]);
+    } else {
+      eval_range.push_back(indices[arg_counter++]);
+    }
+  }
+  return eval_range;
+}
+
+/*!
+ * \brief Cast the normalized value y to out_dtype, quantizing it symmetrically with quant_scale
+ * when quant_scale is positive.
+ */
+inline PrimExpr QuantizeNormOutput(PrimExpr y, double quant_scale, DataType out_dtype) {
+  if (quant_scale <= 0) {
+    return tvm::cast(out_dtype, y);
+  }
+  PrimExpr q = tvm::round(y * make_const(y.dtype(), 1.0 / quant_scale));
+  q = tvm::max(tvm::min(q, tvm::cast(y.dtype(), max_value(out_dtype))),
+               tvm::cast(y.dtype(), min_value(out_dtype)));
+  return tvm::cast(out_dtype, q);
+}
+
+/*! \brief The residual sum, which is also an output of the fused norms. */
+inline Tensor ResidualAdd(const Tensor& data, const Tensor& residual, const std::string& name) {
+  ICHECK(data->dtype == residual->dtype)
+      << "ValueError: data and residual must have the same type, but got " << data->dtype
+      << " and " << residual->dtype;
+  ICHECK_EQ(data->shape.size(), residual->shape.size())
+      << "ValueError: data and residual must have the same shape";
+  return tvm::te::compute(
+      data->shape, [&](const Array<Var>& indices) { return data(indices) + residual(indices); },
+      name + "_residual", kElementWise);
+}
+
+}  // namespace detail
+
+/*!
+ * \brief Root mean square normalization of data + residual, fused with the scale by weight and the
+ * quantization of the result.
+ *
+ * The residual sum is read once for the sum of squares and once for the normalization, with the
+ * statistics accumulated in float32, so that the add, the norm and the quantize do not round trip
+ * through memory between them.
+ *
+ * \param data N-D tensor with shape [d_0, d_1, ..., d_{N-1}]
+ * \param residual N-D tensor with the shape of data
+ * \param weight K-D tensor with shape [r_0, r_1, ..., r_{K-1}] where K == len(axis) and
+ *               d_{axis_k} == r_k
+ * \param axis The axis to normalize over.
+ * \param epsilon The epsilon value to avoid division by zero.
+ * \param quant_scale The scale of the symmetric quantization of the output, which is not quantized
+ *                    when it is not positive.
+ * \param quant_dtype The type of the quantized output.
+ * \param name The name of the operation.
+ * \param tag The tag to mark the operation.
+ * \return The normalized tensor, with the type of data or quant_dtype, and the residual sum.
+ */
+inline Array<Tensor> add_rms_norm(const Tensor& data, const Tensor& residual, const Tensor& weight,
+                                  const Array<Integer>& axis, double epsilon,
+                                  double quant_scale = 0, DataType quant_dtype = DataType::Int(8),
+                                  std::string name = "T_add_rms_norm",
+                                  std::string tag = kInjective) {
+  ICHECK(data->dtype == weight->dtype) << "add_rms_norm: data and weight must have the same type";
+  auto ndim = data->shape.size();
+  ICHECK_NE(ndim, 0) << "Cannot reduce a 0 dim Tensor";
+  auto real_axis = GetRealAxis(static_cast<int>(ndim), axis);
+  auto reduce_axes = MakeReduceAxes(real_axis, data);
+  auto target_shape =
+      MakeReduceTargetShape(real_axis, data, /*keepdims=*/false, /*atleast1d=*/true);
+  auto residual_sum = detail::ResidualAdd(data, residual, name);
+
+  auto square_sum = tvm::te::compute(
+      target_shape,
+      [&](const Array<Var>& indices) {
+        auto x = Cast(DataType::Float(32),
+                      residual_sum(detail::MakeRowIndices(indices, real_axis, reduce_axes, ndim)));
+        return tvm::sum(x * x, reduce_axes);
+      },
+      name + "_red_temp", kCommReduce);
+
+  auto reduce_extent = make_const(DataType::Float(32), 1);
+  for (int i : real_axis) {
+    reduce_extent *= Cast(DataType::Float(32), data->shape[i]);
+  }
+  DataType out_dtype = quant_scale > 0 ? quant_dtype : data->dtype;
+  auto out = tvm::te::compute(
+      data->shape,
+      [&](const Array<Var>& indices) {
+        Array<PrimExpr> reduce_indices, non_reduce_indices;
+        detail::SplitNormIndices(indices, real_axis, &reduce_indices, &non_reduce_indices);
+        auto rsqrt = tvm::rsqrt(square_sum(non_reduce_indices) / reduce_extent +
+                                make_const(DataType::Float(32), epsilon));
+        auto y = Cast(DataType::Float(32), residual_sum(indices)) * rsqrt *
+                 Cast(DataType::Float(32), weight(reduce_indices));
+        return detail::QuantizeNormOutput(y, quant_scale, out_dtype);
+      },
+      name, tag);
+  return {out, residual_sum};
+}
+
+/*!
+ * \brief Layer normalization of data + residual, fused with the scale by gamma, the shift by beta
+ * and the quantization of the result.
+ *
+ * The mean and the variance are accumulated in float32 in one pass with the Welford algorithm,
+ * which does not lose the precision of the variance to the cancellation of E[x^2] - E[x]^2.
+ *
+ * \param data N-D tensor with shape [d_0, d_1, ..., d_{N-1}]
+ * \param residual N-D tensor with the shape of data
+ * \param gamma K-D tensor with shape [r_0, r_1, ..., r_{K-1}] where K == len(axis) and
+ *              d_{axis_k} == r_k
+ * \param beta Optional, K-D tensor with the shape of gamma
+ * \param axis The axis to normalize over.
+ * \param epsilon The epsilon value to avoid division by zero.
+ * \param quant_scale The scale of the symmetric quantization of the output, which is not quantized
+ *                    when it is not positive.
+ * \param quant_dtype The type of the quantized output.
+ * \param name The name of the operation.
+ * \param tag The tag to mark the operation.
+ * \return The normalized tensor, with the type of data or quant_dtype, and the residual sum.
+ */
+inline Array<Tensor> add_layer_norm(const Tensor& data, const Tensor& residual,
+                                    const Tensor& gamma, const Tensor& beta,
+                                    const Array<Integer>& axis, double epsilon,
+                                    double quant_scale = 0,
+                                    DataType quant_dtype = DataType::Int(8),
+                                    std::string name = "T_add_layer_norm",
+                                    std::string tag = kInjective) {
+  ICHECK(data->dtype == gamma->dtype && (!beta.defined() || data->dtype == beta->dtype))
+      << "add_layer_norm: data, gamma and beta must have the same type";
+  auto ndim = data->shape.size();
+  ICHECK_NE(ndim, 0) << "Cannot reduce a 0 dim Tensor";
+  auto real_axis = GetRealAxis(static_cast<int>(ndim), axis);
+  auto reduce_axes = MakeReduceAxes(real_axis, data);
+  auto target_shape =
+      MakeReduceTargetShape(real_axis, data, /*keepdims=*/false, /*atleast1d=*/true);
+  auto residual_sum = detail::ResidualAdd(data, residual, name);
+
+  auto func = MakeWelfordReducer();
+  auto stats = tvm::te::compute(
+      target_shape,
+      [&](const Array<Var>& indices) {
+        auto x = Cast(DataType::Float(32),
+                      residual_sum(detail::MakeRowIndices(indices, real_axis, reduce_axes, ndim)));
+        return func({x, make_const(DataType::Float(32), 0), make_const(DataType::Float(32), 1)},
+                    reduce_axes, nullptr);
+      },
+      name + "_red_temp", kCommReduce);
+  auto mean = stats[0];
+  auto m2 = stats[1];
+  auto count = stats[2];
+
+  DataType out_dtype = quant_scale > 0 ? quant_dtype : data->dtype;
+  auto out = tvm::te::compute(
+      data->shape,
+      [&](const Array<Var>& indices) {
+        Array<PrimExpr> reduce_indices, non_reduce_indices;
+        detail::SplitNormIndices(indices, real_axis, &reduce_indices, &non_reduce_indices);
+        auto var = m2(non_reduce_indices) / count(non_reduce_indices);
+        auto y = (Cast(DataType::Float(32), residual_sum(indices)) - mean(non_reduce_indices)) *
+                 tvm::rsqrt(var + make_const(DataType::Float(32), epsilon)) *
+                 Cast(DataType::Float(32), gamma(reduce_indices));
+        if (beta.defined()) {
+          y = y + Cast(DataType::Float(32), beta(reduce_indices));
+        }
+        return detail::QuantizeNormOutput(y, quant_scale, out_dtype);
+      },
+      name, tag);
+  return {out, residual_sum};
+}
+
+}  // namespace nn
+}  // namespace topi
+}  // namespace tvm
+
+#endif  // TVM_TOPI_NN_FUSED_NORM_H_
@@ -604,6 +604,36 @@ inline FCommReduce MakeTupleSumReducer() {
   return MakeCommReducer(fcombine, fidentity, "tuple_sum");
 }
 
+/*!
+ * \brief Create a reducer computing the mean and the sum of the squared deviations from the mean
+ * in one pass with the Welford algorithm.
+ *
+ * The reduced values are the tuples (mean, m2, count), with the element x fed as (x, 0, 1).  The
+ * partial results are merged with the parallel form of the algorithm, so that the reduction can be
+ * split across threads.
+ */
+inline FCommReduce MakeWelfordReducer() {
+  auto fcombine = [](Array<Var> lhs, Array<Var> rhs) {
+    ICHECK_EQ(lhs.size(), 3);
+    ICHECK_EQ(rhs.size(), 3);
+    PrimExpr count = lhs[2] + rhs[2];
+    PrimExpr delta = rhs[0] - lhs[0];
+    // The count is 0 only when merging two identities, whose deltas are 0.
+    PrimExpr inv_count = 1 / tvm::max(count, tvm::tir::make_const(count.dtype(), 1));
+    PrimExpr mean = lhs[0] + delta * rhs[2] * inv_count;
+    PrimExpr m2 = lhs[1] + rhs[1] + delta * delta * lhs[2] * rhs[2] * inv_count;
+    return Array<PrimExpr>{mean, m2, count};
+  };
+  auto fidentity = [](std::vector<DataType> types) {
+    Array<PrimExpr> result;
+    for (size_t i = 0; i < types.size(); ++i) {
+      result.push_back(tvm::tir::make_const(types[i], 0));
+    }
+    return result;
+  };
+  return MakeCommReducer(fcombine, fidentity, "welford");
+}
+
 }  // namespace topi
 }  // namespace tvm
 #endif  // TVM_TOPI_REDUCTION_H_
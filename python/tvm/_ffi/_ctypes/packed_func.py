@@ -289,6 +289,42 @@ def _handle_return_func(x):
     return _CLASS_PACKED_FUNC(handle, False)
 
 
+def _call_batch(calls):
+    """Call a sequence of (func, args) pairs in one FFI call"""
+    num_calls = len(calls)
+    if num_calls == 0:
+        return []
+    funcs = (PackedFuncHandle * num_calls)()
+    num_args = (ctypes.c_int * num_calls)()
+    all_args = []
+    for i, (func, args) in enumerate(calls):
+        funcs[i] = func.handle.value
+        num_args[i] = len(args)
+        all_args.extend(args)
+    temp_args = []
+    values, tcodes, _ = _make_tvm_args(all_args, temp_args)
+    ret_vals = (TVMValue * num_calls)()
+    ret_tcodes = (ctypes.c_int * num_calls)()
+    num_finished = ctypes.c_int()
+    ret_code = _LIB.TVMFuncCallBatch(
+        ctypes.c_int(num_calls),
+        funcs,
+        values,
+        tcodes,
+        num_args,
+        ret_vals,
+        ret_tcodes,
+        ctypes.byref(num_finished),
+    )
+    # Take the ownership of the values returned before any failure.
+    results = [RETURN_SWITCH[ret_tcodes[i]](ret_vals[i]) for i in range(num_finished.value)]
+    if ret_code != 0:
+        raise_last_ffi_error()
+    _ = temp_args
+    _ = all_args
+    return results
+
+
 def _get_global_func(name, allow_missing=False):
     handle = PackedFuncHandle()
     check_call(_LIB.TVMFuncGetGlobal(c_str(name), ctypes.byref(handle)))
@@ -126,6 +126,14 @@ cdef extern from "tvm/runtime/c_runtime_api.h":
                     int num_args,
                     TVMValue* ret_val,
                     int* ret_type_code) nogil
+    int TVMFuncCallBatch(int num_calls,
+                         TVMPackedFuncHandle* funcs,
+                         TVMValue* arg_values,
+                         int* type_codes,
+                         int* num_args,
+                         TVMValue* ret_vals,
+                         int* ret_type_codes,
+                         int* num_finished) nogil
     int TVMFuncFree(TVMPackedFuncHandle func)
     int TVMCFuncSetReturn(TVMRetValueHandle ret,
                           TVMValue* value,
@@ -340,6 +340,51 @@ cdef class PackedFuncBase:
         return make_ret(ret_val, ret_tcode)
 
 
+def _call_batch(list calls):
+    """Call a sequence of (func, args) pairs in one FFI call"""
+    cdef int num_calls = len(calls)
+    cdef int num_finished = 0
+    cdef int total_args = 0
+    cdef int c_api_ret_code
+    cdef int i
+    cdef int k = 0
+    cdef vector[TVMPackedFuncHandle] funcs
+    cdef vector[int] num_args
+    cdef vector[TVMValue] values
+    cdef vector[int] tcodes
+    cdef vector[TVMValue] ret_vals
+    cdef vector[int] ret_tcodes
+    if num_calls == 0:
+        return []
+    for _, args in calls:
+        total_args += len(args)
+    funcs.resize(num_calls)
+    num_args.resize(num_calls)
+    ret_vals.resize(num_calls)
+    ret_tcodes.resize(num_calls)
+    values.resize(max(total_args, 1))
+    tcodes.resize(max(total_args, 1))
+    temp_args = []
+    for i in range(num_calls):
+        func, args = calls[i]
+        funcs[i] = (<PackedFuncBase>func).chandle
+        num_args[i] = len(args)
+        for arg in args:
+            make_arg(arg, &values[k], &tcodes[k], temp_args)
+            k += 1
+
+    with nogil:
+        c_api_ret_code = TVMFuncCallBatch(num_calls, &funcs[0], &values[0], &tcodes[0],
+                                          &num_args[0], &ret_vals[0], &ret_tcodes[0],
+                                          &num_finished)
+    # Take the ownership of the values returned before any failure.
+    results = []
+    for i in range(num_finished):
+        results.append(make_ret(ret_vals[i], ret_tcodes[i]))
+    CHECK_CALL(c_api_ret_code)
+    return results
+
+
 def _get_global_func(name, allow_missing):
     cdef TVMPackedFuncHandle chandle
     CHECK_CALL(TVMFuncGetGlobal(c_str(name), &chandle))
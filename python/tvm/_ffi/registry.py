@@ -230,8 +230,28 @@ def get_global_func(name, allow_missing=False):
     -------
     func : PackedFunc
         The function to be returned, None if function is missing.
+
+    Note
+    ----
+    The functions found are cached until a global function is registered or removed,
+    so that hot loops looking up the same function only pay for a version check.
     """
-    return _get_global_func(name, allow_missing)
+    version = ctypes.c_uint64()
+    check_call(_LIB.TVMFuncGetGlobalVersion(ctypes.byref(version)))
+    if version.value != _GLOBAL_FUNC_CACHE_VERSION[0]:
+        _GLOBAL_FUNC_CACHE.clear()
+        _GLOBAL_FUNC_CACHE_VERSION[0] = version.value
+    func = _GLOBAL_FUNC_CACHE.get(name, None)
+    if func is None:
+        func = _get_global_func(name, allow_missing)
+        if func is not None:
+            _GLOBAL_FUNC_CACHE[name] = func
+    return func
+
+
+# The functions found by get_global_func, and the registry version they were found at.
+_GLOBAL_FUNC_CACHE = {}
+_GLOBAL_FUNC_CACHE_VERSION = [None]
 
 
 def list_global_func_names():
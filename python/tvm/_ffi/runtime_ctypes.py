@@ -604,6 +604,37 @@ class Device(ctypes.Structure):
         """
         check_call(_LIB.TVMSetStream(self.device_type, self.device_id, stream))
 
+    def current_raw_stream(self):
+        """Return the stream the work of TVM is currently submitted to at the device.
+
+        Returns
+        -------
+        stream : int
+            The address of the stream, 0 for the default stream.
+        """
+        # pylint: disable=import-outside-toplevel
+        import tvm.runtime._ffi_api
+
+        return tvm.runtime._ffi_api.GetCurrentStream(self.device_type, self.device_id)
+
+    def wait_raw_stream(self, src, dst):
+        """Make the work submitted to stream dst from now on wait for the work submitted
+        to stream src so far, with an event which does not block the host.
+
+        Parameters
+        ----------
+        src : int
+            The address of the stream to wait for.
+
+        dst : int
+            The address of the stream which waits.
+        """
+        check_call(
+            _LIB.TVMStreamStreamSynchronize(
+                self.device_type, self.device_id, ctypes.c_void_p(src), ctypes.c_void_p(dst)
+            )
+        )
+
     def sync(self, stream=None):
         """Synchronize until jobs finished at the context.
 
@@ -115,6 +115,7 @@ class Analyzer:
         self._rewrite_simplify = _mod("rewrite_simplify")
         self._get_rewrite_simplify_stats = _mod("get_rewrite_simplify_stats")
         self._reset_rewrite_simplify_stats = _mod("reset_rewrite_simplify_stats")
+        self._get_cache_stats = _mod("get_cache_stats")
         self._canonical_simplify = _mod("canonical_simplify")
         self._int_set = _mod("int_set")
         self._enter_constraint_context = _mod("enter_constraint_context")
@@ -195,6 +196,12 @@ class Analyzer:
     def reset_rewrite_simplify_stats(self):
         self._reset_rewrite_simplify_stats()
 
+    @property
+    def cache_stats(self):
+        """The number of "hits", "misses" and the "size" of the cached
+        results of simplify and can_prove."""
+        return self._get_cache_stats()
+
     def canonical_simplify(self, expr):
         """Simplify expression via canonicalization.
 
@@ -110,6 +110,10 @@ class XGBModel(PythonBasedModel):
     adaptive_training: bool = False
         Whether to use adaptive training, which reduces the training frequency when there are
         too many logs.
+    incremental_training: bool = False
+        Whether to continue boosting from the previous model on every update instead of training
+        a new model from scratch. It is much cheaper in the later rounds of a long tuning, at the
+        cost of a larger model.
     """
 
     def __init__(
@@ -119,6 +123,7 @@ class XGBModel(PythonBasedModel):
         seed=None,
         model_file=None,
         adaptive_training=False,
+        incremental_training=False,
     ):
         global xgb
         try:
@@ -151,6 +156,7 @@ class XGBModel(PythonBasedModel):
         self.verbose_eval = verbose_eval
         self.model_file = model_file
         self.adaptive_training = adaptive_training
+        self.incremental_training = incremental_training
 
         super().__init__()
 
@@ -162,7 +168,8 @@ class XGBModel(PythonBasedModel):
 
     def update(self, inputs, results):
         """Update the cost model according to new measurement results (training data).
-        XGBoost does not support incremental training, so we re-train a new model every time.
+        A new model is trained on all the data every time, unless `incremental_training` is set,
+        in which case the boosting continues from the previous model.
         Parameters
         ----------
         inputs : List[MeasureInput]
@@ -201,11 +208,17 @@ class XGBModel(PythonBasedModel):
         )
 
         # train xgb model
+        prev_bst = None
+        if self.incremental_training and self.bst is not None:
+            prev_bst = self.bst
+            # The best score on the previous data does not apply to the new data.
+            prev_bst.set_attr(best_score=None, best_iteration=None, best_msg=None)
         self.bst = xgb.train(
             self.xgb_params,
             dtrain,
             num_boost_round=10000,
             obj=pack_sum_square_error,
+            xgb_model=prev_bst,
             callbacks=[
                 CustomCallback(
                     stopping_rounds=50,
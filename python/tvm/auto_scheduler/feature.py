@@ -252,6 +252,15 @@ def get_per_store_feature_names(max_n_bufs: Optional[int] = None) -> List[str]:
     return _ffi_api.GetPerStoreFeatureNames(max_n_bufs or DEFAULT_MAX_N_BUFS)
 
 
+def clear_per_store_feature_cache():
+    """Clear the cache of the features extracted from the states.
+
+    The features are cached by the search task and the transform steps of a state, so that the
+    states predicted in many rounds of a search are only lowered once.
+    """
+    _ffi_api.ClearPerStoreFeatureCache()
+
+
 def features_from_primfunc(
     func: PrimFunc,
     cache_line_bytes: int = 64,
@@ -52,3 +52,21 @@ def matmul(lhs, rhs, transa=False, transb=False, n=0, m=0, dtype=None):
         dtype=dtype,
         name="C",
     )
+
+
+def autotune(top_n=8, path=""):
+    """Choose the algorithm of each new cuBLASLt matmul by benchmarking.
+
+    The first call of each matmul, by its shapes, types, transposes and epilogue, benchmarks
+    the first `top_n` algorithms of the heuristic of cuBLASLt, and keeps the fastest one for
+    the later calls.  The matmuls called before autotuning is enabled keep their algorithm.
+
+    Parameters
+    ----------
+    top_n : int
+        The number of algorithms to benchmark, or 0 to disable autotuning.
+    path : str
+        The file the chosen algorithms are appended to.  The algorithms already in it are
+        loaded, and reused without benchmarking on the same GPU and cuBLASLt version.
+    """
+    tvm.get_global_func("tvm.contrib.cublaslt.autotune")(top_n, path)
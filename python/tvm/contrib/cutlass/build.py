@@ -826,20 +826,36 @@ class CutlassRelaxFunctionAnnotator(relax.PyExprMutator):
         find_first_valid = self.options.get("find_first_valid", True)
         use_multiprocessing = self.options.get("use_multiprocessing", True)
 
-        op_name, op_def, _ = self.gemm_profiler.profile(
-            op_type,
-            MM,
-            NN,
-            KK,
-            out_dtype,
-            lhs_dtype,
-            rhs_dtype,
-            use_3xtf32,
-            batched=is_batched,
-            find_first_valid=find_first_valid,
-            use_multiprocessing=use_multiprocessing,
-            layout_b=layout_b,
-        )
+        def profile(m):
+            return self.gemm_profiler.profile(
+                op_type,
+                m,
+                NN,
+                KK,
+                out_dtype,
+                lhs_dtype,
+                rhs_dtype,
+                use_3xtf32,
+                batched=is_batched,
+                find_first_valid=find_first_valid,
+                use_multiprocessing=use_multiprocessing,
+                layout_b=layout_b,
+            )
+
+        m_buckets = sorted(self.options.get("dynamic_m_buckets", []))
+        bucket_attrs = {}
+        if m_buckets and not isinstance(MM, (int, tvm.tir.IntImm)) and isinstance(NN, int):
+            # Select a kernel for each bucket of M, by profiling with its upper bound.  The
+            # generated code dispatches on the value of M at runtime.
+            bucket_ops = [profile(m)[:2] for m in m_buckets]
+            op_name, op_def = bucket_ops[-1]
+            bucket_attrs = {
+                "cutlass_m_buckets": m_buckets,
+                "cutlass_bucket_op_names": [name for name, _ in bucket_ops],
+                "cutlass_bucket_op_defs": [opdef for _, opdef in bucket_ops],
+            }
+        else:
+            op_name, op_def, _ = profile(MM)
 
         return f.with_attrs(
             {
@@ -860,6 +876,7 @@ class CutlassRelaxFunctionAnnotator(relax.PyExprMutator):
                 "cutlass_op_name": op_name,
                 "cutlass_op_def": op_def,
                 **batch_attrs,
+                **bucket_attrs,
             }
         )
 
@@ -994,7 +1011,13 @@ class CutlassRelaxFunctionAnnotator(relax.PyExprMutator):
 
 @register_func("contrib.cutlass.tune_relax_function")
 def profile_relax_function(functions, options):
-    """Tune and annotate CUTLASS composite functions with shape, dtype and generated templates."""
+    """Tune and annotate CUTLASS composite functions with shape, dtype and generated templates.
+
+    Besides the options of the profilers, e.g. "sm" and "find_first_valid", "dynamic_m_buckets"
+    is a list of upper bounds of M, e.g. [16, 64, 256, 1024, 4096].  A matmul whose M is dynamic
+    gets a kernel profiled for each bound, and picks at runtime the one of the smallest bound
+    that M fits in, or the one of the largest bound.
+    """
     tmp_dir = options.get("tmp_dir", "./tmp")
     sm = options.get("sm", 80)
     conv2d_profiler = CutlassConv2DProfiler(sm, _get_cutlass_path(), tmp_dir)
@@ -412,6 +412,31 @@ def instantiate_gemm_template(attrs):
     return substitute_template(template, attrs)
 
 
+def instantiate_gemm_dispatch_template(attrs, m_buckets, op_names, op_defs):
+    """Return CUTLASS host code for a GEMM with a dynamic M, which runs the kernel selected for
+    the smallest bucket of M that the value of M at runtime fits in, or for the largest bucket.
+    """
+    branches = []
+    for bound, op_name, op_def in zip(m_buckets, op_names, op_defs):
+        if branches and branches[-1][1] == op_name:
+            # Merge the adjacent buckets of the same kernel.
+            branches[-1] = (bound, op_name, op_def)
+        else:
+            branches.append((bound, op_name, op_def))
+
+    code = "  int64_t dispatch_m = ${M};\n"
+    for i, (bound, op_name, op_def) in enumerate(branches):
+        body = instantiate_gemm_template(
+            dict(attrs, cutlass_op_name=op_name, cutlass_op_def=op_def)
+        )
+        if i == len(branches) - 1:
+            cond = "" if i == 0 else "else "
+        else:
+            cond = ("" if i == 0 else "else ") + f"if (dispatch_m <= {int(bound)}) "
+        code += "  " + cond + "{\n" + body + "\n  }\n"
+    return substitute_template(code, attrs)
+
+
 def emit_fp16A_intB_matmul(attrs):
     """Return CUTLASS host code for fp16 A and int4 or int8 B GEMM."""
     if attrs["group_size"] > 0:
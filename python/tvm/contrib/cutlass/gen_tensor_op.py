@@ -35,7 +35,11 @@ from .attention_operation import (
     instantiate_flash_attention_var_len_template,
 )
 from .conv2d_operation import instantiate_conv2d_template
-from .gemm_operation import instantiate_gemm_template, emit_fp16A_intB_matmul
+from .gemm_operation import (
+    emit_fp16A_intB_matmul,
+    instantiate_gemm_dispatch_template,
+    instantiate_gemm_template,
+)
 from .layer_norm_operation import instantiate_layer_norm_template
 from .rms_norm_operation import instantiate_rms_norm_template
 from .library import (
@@ -653,7 +657,15 @@ def instantiate_template(func_name, annotations, func_args):
         if "residual" in func_name:
             headers.append("cutlass/gemm/device/gemm_universal_with_broadcast.h")
 
-        code = instantiate_gemm_template(attrs)
+        if "cutlass_m_buckets" in annotations:
+            code = instantiate_gemm_dispatch_template(
+                attrs,
+                annotations["cutlass_m_buckets"],
+                [str(name) for name in annotations["cutlass_bucket_op_names"]],
+                [str(opdef) for opdef in annotations["cutlass_bucket_op_defs"]],
+            )
+        else:
+            code = instantiate_gemm_template(attrs)
         return CodegenResult(code, headers)
 
     elif "conv2d" in func_name:
@@ -24,7 +24,7 @@ from tvm._ffi.base import py_str
 from tvm._ffi.libinfo import find_lib_path
 
 
-def create_tvmjs_wasm(output, objects, options=None, cc="emcc", libs=None):
+def create_tvmjs_wasm(output, objects, options=None, cc="emcc", libs=None, threads=False):
     """Create wasm that is supposed to run with the tvmjs.
 
     Parameters
@@ -43,6 +43,11 @@ def create_tvmjs_wasm(output, objects, options=None, cc="emcc", libs=None):
 
     libs : list
         List of user-defined library files (e.g. .bc files) to add into the wasm.
+
+    threads : bool
+        Whether to link with wasm threads, so that the parallel loops run on a pool of Web
+        Workers. The objects are built for the target tag "wasm/simd128-threads", and the
+        runtime with `make TVM_WASM_THREADS=1`.
     """
     cmd = [cc]
     cmd += ["-O3"]
@@ -61,6 +66,9 @@ def create_tvmjs_wasm(output, objects, options=None, cc="emcc", libs=None):
     cmd += ["-s", "STANDALONE_WASM=1"]
     cmd += ["-s", "ALLOW_MEMORY_GROWTH=1"]
     cmd += ["-s", "TOTAL_MEMORY=160MB"]
+    if threads:
+        cmd += ["-pthread"]
+        cmd += ["-s", "PTHREAD_POOL_SIZE=navigator.hardwareConcurrency"]
 
     objects = [objects] if isinstance(objects, str) else objects
 
@@ -66,6 +66,38 @@ def create(graph_json_str, libmod, device):
     return GraphModule(fcreate(graph_json_str, libmod, *device_type_id))
 
 
+def create_pool(graph_json_str, libmod, device, num_contexts):
+    """Create a pool of activation contexts of a graph, serving concurrent requests with one set
+    of parameters.
+
+    Parameters
+    ----------
+    graph_json_str : str
+        The graph to be deployed in json format output by json graph.
+
+    libmod : tvm.runtime.Module
+        The module of the corresponding function
+
+    device : Device or list of Device
+        The device to deploy the module, which has to be local.
+
+    num_contexts : int
+        The number of contexts, i.e. the number of requests running concurrently.
+
+    Returns
+    -------
+    pool : GraphModulePool
+        The pool serving the requests.
+    """
+    assert isinstance(graph_json_str, string_types)
+
+    dev, num_rpc_dev, device_type_id = get_device(libmod, device)
+    if num_rpc_dev > 0:
+        raise ValueError("The pool of graph executor contexts does not support rpc devices.")
+    fcreate = tvm._ffi.get_global_func("tvm.graph_executor_pool.create")
+    return GraphModulePool(fcreate(graph_json_str, libmod, num_contexts, *device_type_id))
+
+
 def get_device(libmod, device):
     """Parse and validate all the device(s).
 
@@ -263,6 +295,22 @@ class GraphModule(object):
             self.set_input(**input_dict)
         self._run()
 
+    def set_inter_op_parallelism(self, num_inter_op_threads, num_intra_op_threads=0):
+        """Run the independent nodes of the graph concurrently, e.g. the branches of an
+        Inception block, in the order of their dependencies.
+
+        Parameters
+        ----------
+        num_inter_op_threads : int
+            The number of threads running the nodes, where 1 runs them one by one.
+
+        num_intra_op_threads : int
+            The number of threads each of them parallelizes an operator with, where 0 keeps
+            the default of the runtime. The product of the two is usually at most the number
+            of cores.
+        """
+        self.module["set_inter_op_parallelism"](num_inter_op_threads, num_intra_op_threads)
+
     def get_num_outputs(self):
         """Get the number of outputs from the graph
 
@@ -512,3 +560,96 @@ class GraphModule(object):
             cooldown_interval_ms=cooldown_interval_ms,
             repeats_to_cooldown=repeats_to_cooldown,
         )()
+
+
+class GraphModulePool(object):
+    """A pool of activation contexts of a graph, which share the parameters and the compiled
+    functions, and serve the requests of many threads.
+
+    Parameters
+    ----------
+    module : tvm.runtime.Module
+        The internal tvm module that holds the pool.
+
+    Examples
+    --------
+
+    .. code-block:: python
+
+        pool = graph_executor.create_pool(lib.get_graph_json(), lib.get_lib(), dev, 4)
+        pool.load_params(tvm.runtime.save_param_dict(lib.get_params()))
+        # in any thread
+        outputs = pool.run(x=data)
+    """
+
+    def __init__(self, module):
+        self.module = module
+        self._load_params = module["load_params"]
+        self._run = module["run"]
+        self._run_batched = module["run_batched"]
+        self._set_max_batch_delay = module["set_max_batch_delay"]
+        self._get_num_contexts = module["get_num_contexts"]
+
+    @property
+    def num_contexts(self):
+        """The number of contexts, i.e. the number of requests running concurrently."""
+        return self._get_num_contexts()
+
+    def load_params(self, params_bytes):
+        """Load parameters from serialized byte array of parameter dict, shared by all the
+        contexts.
+
+        Parameters
+        ----------
+        params_bytes : bytearray
+            The serialized parameter dict.
+        """
+        self._load_params(bytearray(params_bytes))
+
+    def run(self, **input_dict):
+        """Run a request on a free context.
+
+        Parameters
+        ----------
+        input_dict: dict of str to NDArray
+            The inputs of the request.
+
+        Returns
+        -------
+        outputs : List[NDArray]
+            The outputs of the request.
+        """
+        return list(self._run(_as_ndarray_map(input_dict)))
+
+    def run_batched(self, **input_dict):
+        """Run a single-sample request in a micro-batch with the other pending ones, when the
+        graph is compiled with a batch size on the first axis of its inputs and outputs.
+
+        Parameters
+        ----------
+        input_dict: dict of str to NDArray
+            The inputs of the request, whose first axis has size 1.
+
+        Returns
+        -------
+        outputs : List[NDArray]
+            The outputs of the request, whose first axis has size 1.
+        """
+        return list(self._run_batched(_as_ndarray_map(input_dict)))
+
+    def set_max_batch_delay(self, delay_us):
+        """Set the time the first request of a micro-batch waits for the batch to be full.
+
+        Parameters
+        ----------
+        delay_us : int
+            The maximum delay in microseconds.
+        """
+        self._set_max_batch_delay(delay_us)
+
+
+def _as_ndarray_map(input_dict):
+    return {
+        k: v if isinstance(v, tvm.runtime.NDArray) else tvm.nd.array(np.asarray(v))
+        for k, v in input_dict.items()
+    }
@@ -18,3 +18,4 @@
 
 from .tools import *
 from .transform import *
+from .vtcm_staging import stage_to_vtcm
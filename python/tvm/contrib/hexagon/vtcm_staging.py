@@ -0,0 +1,142 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Automatic double-buffered VTCM staging of TIR blocks"""
+from typing import List, Optional
+
+import tvm
+from tvm import tir
+from tvm.target import Target
+from tvm.topi.hexagon.utils import get_vtcm_allocation_sizes
+
+VTCM_SCOPE = "global.vtcm"
+
+
+def _get_vtcm_capacity(vtcm_capacity: Optional[int]) -> int:
+    if vtcm_capacity is not None:
+        return vtcm_capacity
+    target = Target.current(allow_none=True)
+    if target is not None and target.kind.name == "hexagon" and target.vtcm_capacity > 0:
+        return target.vtcm_capacity
+    config = tvm.transform.PassContext.current().config
+    if "tir.vtcm_capacity" in config and int(config["tir.vtcm_capacity"]) > 0:
+        return int(config["tir.vtcm_capacity"])
+    raise ValueError(
+        "The VTCM capacity is unknown, pass vtcm_capacity or set the vtcm-capacity of the "
+        "hexagon target"
+    )
+
+
+def _stage_at(
+    sch: tir.Schedule, block: tir.schedule.BlockRV, depth: int, num_stages: int, stage_output: bool
+) -> Optional[tir.schedule.LoopRV]:
+    """Stage the global buffers of the block at the loop of the given depth and pipeline it."""
+    staged: List[tir.Buffer] = []
+    num_copies = 0
+    reads = list(sch.get(block).reads)
+    for index, region in enumerate(reads):
+        buffer = region.buffer
+        if buffer.scope() != "global" or any(buffer.same_as(b) for b in staged):
+            continue
+        staged.append(buffer)
+        cache = sch.cache_read(block, index, VTCM_SCOPE)
+        sch.compute_at(cache, sch.get_loops(block)[depth])
+        num_copies += 1
+    if num_copies == 0:
+        return None
+    if stage_output:
+        cache = sch.cache_write(block, 0, VTCM_SCOPE)
+        sch.reverse_compute_at(cache, sch.get_loops(block)[depth])
+
+    loop = sch.get_loops(block)[depth]
+    body = sch.get(loop).body
+    if isinstance(body, tir.BlockRealize):
+        body = body.block.body
+    num_children = len(body.seq) if isinstance(body, tir.SeqStmt) else 1
+    if num_children != num_copies + 1 + int(stage_output):
+        return None
+    # The copies run num_stages - 1 iterations ahead of the compute, which multi-buffers them.
+    stages = [0] * num_copies + [num_stages - 1]
+    async_stages = [0]
+    if stage_output:
+        stages.append(num_stages)
+        async_stages.append(num_stages)
+    sch.annotate(loop, "software_pipeline_stage", stages)
+    sch.annotate(loop, "software_pipeline_order", list(range(len(stages))))
+    sch.annotate(loop, "software_pipeline_async_stages", async_stages)
+    return loop
+
+
+def stage_to_vtcm(
+    sch: tir.Schedule,
+    block: tir.schedule.BlockRV,
+    *,
+    vtcm_capacity: Optional[int] = None,
+    num_stages: int = 2,
+    stage_output: bool = False,
+) -> Optional[tir.schedule.LoopRV]:
+    """Stage the global buffers of a block into VTCM with multi-buffered async DMA.
+
+    The global inputs, and optionally the output, of the block are cached in VTCM at one of its
+    loops, and the loop is annotated for InjectSoftwarePipeline such that the copies of the next
+    iterations are issued as async stages while the current one is computed. With
+    ``tir.use_async_copy`` enabled, LowerAsyncDMA lowers these copies to DMA descriptors.
+
+    The outermost loop whose VTCM footprint after compaction and multi-buffering fits the
+    capacity is chosen, as larger tiles amortize the DMA setup. The footprint is computed with
+    the same passes as ``tir.transform.VerifyVTCMLimit``.
+
+    Parameters
+    ----------
+    sch : tir.Schedule
+        The schedule, modified in place if a loop is staged.
+    block : tir.schedule.BlockRV
+        The block whose buffers are staged.
+    vtcm_capacity : Optional[int]
+        The VTCM budget in bytes. Defaults to the vtcm-capacity of the current hexagon target,
+        or the ``tir.vtcm_capacity`` pass config.
+    num_stages : int
+        The number of pipeline stages, 2 for double buffering.
+    stage_output : bool
+        Whether the output of the block is also written through VTCM.
+
+    Returns
+    -------
+    loop : Optional[tir.schedule.LoopRV]
+        The pipelined loop, or None if no loop can be staged within the capacity.
+    """
+    if num_stages < 2:
+        raise ValueError(f"num_stages must be at least 2, but got {num_stages}")
+    capacity = _get_vtcm_capacity(vtcm_capacity)
+    loops = sch.get_loops(block)
+    for depth, loop in enumerate(loops):
+        extent = sch.get(loop).extent
+        if sch.get(loop).kind != tir.ForKind.SERIAL or (
+            isinstance(extent, tir.IntImm) and extent.value == 1
+        ):
+            continue
+        trial = sch.copy()
+        try:
+            staged = _stage_at(trial, block, depth, num_stages, stage_output)
+        except tir.ScheduleError:
+            continue
+        if staged is None:
+            continue
+        sizes = get_vtcm_allocation_sizes(trial.mod, compacted=True)
+        if max(sizes.values(), default=0) > capacity:
+            continue
+        return _stage_at(sch, block, depth, num_stages, stage_output)
+    return None
@@ -418,6 +418,7 @@ class PipelineConfig(object):
             self.dev = None
             self.export_cc = None
             self.cpu_affinity = ""
+            self.forward_slots = 4
             self.idx = None
             self.mod = mod
             self.input_params = InferType()(mod)["main"].params
@@ -594,6 +595,7 @@ class PipelineConfig(object):
 
             mconf["mod_idx"] = module.idx
             mconf["cpu_affinity"] = module.cpu_affinity
+            mconf["forward_slots"] = module.forward_slots
             mconf["output"] = output_conf
 
             module_connection[mod] = {
@@ -80,6 +80,7 @@ class NDArrayCacheShardingManager:
         prefix: str,
         shard_cap_nbytes: int,
         initial_shard_records: Optional[Mapping[str, Any]] = None,
+        alignment: int = 64,
     ):
         self.cache_dir = cache_dir
         self.prefix = prefix
@@ -87,6 +88,7 @@ class NDArrayCacheShardingManager:
         self.curr_data = bytearray()
         self.shard_records = []
         self.shard_cap_nbytes = shard_cap_nbytes
+        self.alignment = alignment
         self.counter = 0
         self.name_to_record: Mapping[str, Tuple[int, Mapping[str, Any]]] = {}
         self.updated_shards: Set[int] = set()
@@ -127,6 +129,8 @@ class NDArrayCacheShardingManager:
             "dtype": dtype,
             "format": encode_format,
             "nbytes": len(data),
+            # lets the runtime share identical parameters without reading them
+            "hash": hashlib.sha256(data).hexdigest(),
         }
         if name in self.name_to_record:
             if not allow_update:
@@ -136,13 +140,18 @@ class NDArrayCacheShardingManager:
 
         self.name_to_record[name] = (self.counter, rec)
 
-        if self.pending_nbytes + len(data) >= self.shard_cap_nbytes:
+        # pad each record to an aligned offset so that it can be used
+        # directly from a memory mapped shard file
+        padding = -self.pending_nbytes % self.alignment
+        if self.pending_nbytes + padding + len(data) >= self.shard_cap_nbytes:
             if len(data) * 2 >= self.shard_cap_nbytes:
                 # out of band data
                 rec["byteOffset"] = 0
                 self._commit_internal(data, [rec])
                 return
             self.commit()
+            padding = 0
+        self.curr_data += bytes(padding)
         rec["byteOffset"] = self.pending_nbytes
         self.curr_records.append(rec)
         self.curr_data += data
@@ -158,6 +167,7 @@ class NDArrayCacheShardingManager:
         with open(full_path, "r+b") as outfile:
             outfile.seek(old_rec["byteOffset"])
             outfile.write(data)
+        old_rec["hash"] = rec["hash"]
         self.name_to_record[name] = (idx, rec)
         self.updated_shards.add(idx)
 
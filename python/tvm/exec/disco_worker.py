@@ -99,8 +99,8 @@ def _make_callback(device: tvm.runtime.Device) -> Callable[[str, int], NDArray]:
 
 def main():
     """Main worker function"""
-    if len(sys.argv) != 6:
-        print("Usage: <worker_id> <num_workers> <num_groups> <read_fd> <write_fd>")
+    if len(sys.argv) not in [6, 7]:
+        print("Usage: <worker_id> <num_workers> <num_groups> <read_fd> <write_fd> [<shm_fd>]")
         return
     worker_id = int(sys.argv[1])
     num_workers = int(sys.argv[2])
@@ -115,7 +115,10 @@ def main():
         writer = int(sys.argv[5])
 
     worker_func = get_global_func("runtime.disco.WorkerProcess")
-    worker_func(worker_id, num_workers, num_groups, reader, writer)
+    if len(sys.argv) == 7:
+        worker_func(worker_id, num_workers, num_groups, reader, writer, int(sys.argv[6]))
+    else:
+        worker_func(worker_id, num_workers, num_groups, reader, writer)
 
 
 if __name__ == "__main__":
@@ -20,7 +20,9 @@ import logging
 import argparse
 import os
 import glob
+import time
 from tvm.rpc.proxy import Proxy
+from tvm.rpc.socket_proxy import SocketProxy
 
 
 def find_example_resource():
@@ -72,6 +74,16 @@ def main(args):
     else:
         tracker_addr = None
 
+    if args.native:
+        if tracker_addr or args.example_rpc:
+            raise ValueError("The native proxy does not support --tracker or --example-rpc")
+        prox = SocketProxy(
+            args.host, port=args.port, port_end=args.port_end, num_threads=args.num_threads
+        )
+        logging.info("RPCProxy: native proxy bind to %s:%d", args.host, prox.port)
+        while True:
+            time.sleep(3600)
+
     if args.example_rpc:
         index, js_files = find_example_resource()
         prox = Proxy(
@@ -106,6 +118,14 @@ if __name__ == "__main__":
         "--example-rpc", type=bool, default=False, help="Whether to switch on example rpc mode"
     )
     parser.add_argument("--tracker", type=str, default="", help="Report to RPC tracker")
+    parser.add_argument(
+        "--native",
+        action="store_true",
+        help="Serve the TCP connections with the event driven C++ proxy, without websocket",
+    )
+    parser.add_argument(
+        "--num-threads", type=int, default=2, help="The number of threads of the native proxy"
+    )
     args = parser.parse_args()
     logging.basicConfig(level=logging.INFO)
     main(args)
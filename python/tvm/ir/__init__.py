@@ -27,8 +27,11 @@ from .base import (
     SourceName,
     Span,
     SequentialSpan,
+    StructuralHashCache,
     assert_structural_equal,
+    load_binary,
     load_json,
+    save_binary,
     save_json,
     structural_equal,
     structural_hash,
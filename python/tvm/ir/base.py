@@ -146,6 +146,42 @@ def save_json(node) -> str:
     return _ffi_node_api.SaveJSON(node)
 
 
+def load_binary(blob) -> Object:
+    """Load tvm object from the blob created by save_binary.
+
+    Parameters
+    ----------
+    blob : bytes
+        The binary blob
+
+    Returns
+    -------
+    node : Object
+        The loaded tvm node.
+    """
+    return _ffi_node_api.LoadBinary(bytearray(blob))
+
+
+def save_binary(node) -> bytes:
+    """Save tvm object in the compact binary format.
+
+    The binary format is smaller and faster to load than the json format,
+    and stores the constant tensors as raw bytes. Unlike the json format,
+    it is not meant to be read across different versions of TVM.
+
+    Parameters
+    ----------
+    node : Object
+        A TVM object to be saved.
+
+    Returns
+    -------
+    blob : bytes
+        Saved binary blob.
+    """
+    return _ffi_node_api.SaveBinary(node)
+
+
 def structural_equal(lhs, rhs, map_free_vars=False):
     """Check structural equality of lhs and rhs.
 
@@ -298,6 +334,31 @@ def structural_hash(node, map_free_vars=False):
     return _ffi_node_api.StructuralHash(node, map_free_vars)  # type: ignore # pylint: disable=no-member
 
 
+class StructuralHashCache:
+    """A scope in which the structural hashes computed on the current thread are cached.
+
+    The hash of each hashed node is kept, as well as the hash of each subtree without
+    free variables or graph nodes, so repeated hashing of the same subtrees within the
+    scope visits each node once. The cache keeps the nodes alive until the scope exits.
+
+    Examples
+    --------
+
+    .. code-block:: python
+
+        with tvm.ir.StructuralHashCache():
+            h0 = tvm.ir.structural_hash(mod)
+            h1 = tvm.ir.structural_hash(mod)  # cached
+    """
+
+    def __enter__(self):
+        _ffi_node_api.StructuralHashCacheEnterScope()  # type: ignore # pylint: disable=no-member
+        return self
+
+    def __exit__(self, ptype, value, trace):
+        _ffi_node_api.StructuralHashCacheExitScope()  # type: ignore # pylint: disable=no-member
+
+
 def deprecated(
     method_name: str,
     new_method_name: str,
@@ -229,10 +229,22 @@ def pass_instrument(pi_cls=None):
 
 @tvm._ffi.register_object("instrument.PassInstrument")
 class PassTimingInstrument(tvm.runtime.Object):
-    """A wrapper to create a passes time instrument that implemented in C++"""
+    """A wrapper to create a passes time instrument that implemented in C++
 
-    def __init__(self):
-        self.__init_handle_by_constructor__(_ffi_instrument_api.MakePassTimingInstrument)
+    Besides the time, the instrument records the change of the resident and the
+    peak resident memory of the process during each pass.
+
+    Parameters
+    ----------
+    count_ir_nodes : bool
+        Whether to count the IR nodes of the module before and after each pass.
+        The counting walks the whole module, which slows down the compilation.
+    """
+
+    def __init__(self, count_ir_nodes=False):
+        self.__init_handle_by_constructor__(
+            _ffi_instrument_api.MakePassTimingInstrument, count_ir_nodes
+        )
 
     @staticmethod
     def render():
@@ -256,6 +268,55 @@ class PassTimingInstrument(tvm.runtime.Object):
         """
         return _ffi_instrument_api.RenderTimePassProfiles()
 
+    @staticmethod
+    def export_chrome_trace(path=None):
+        """Export the profiles in the Chrome trace event format.
+
+        The nested passes are nested events, and the memory and IR node
+        counts are in the args of each event. The result can be loaded by
+        chrome://tracing or https://ui.perfetto.dev. Like render, it must be
+        called before exiting the PassContext.
+
+        Parameters
+        ----------
+        path : Optional[str]
+            The file to write the trace to.
+
+        Returns
+        -------
+        trace : str
+            The trace in json.
+        """
+        trace = _ffi_instrument_api.ExportPassProfilesChromeTrace()
+        if path is not None:
+            with open(path, "w") as f:
+                f.write(trace)
+        return trace
+
+    @staticmethod
+    def export_folded_stacks(path=None):
+        """Export the self time of the passes in microseconds as folded stacks.
+
+        Each line is the semicolon separated pass stack followed by the time,
+        which can be turned into a flamegraph by flamegraph.pl or speedscope.
+        Like render, it must be called before exiting the PassContext.
+
+        Parameters
+        ----------
+        path : Optional[str]
+            The file to write the stacks to.
+
+        Returns
+        -------
+        stacks : str
+            The folded stacks.
+        """
+        stacks = _ffi_instrument_api.ExportPassProfilesFoldedStacks()
+        if path is not None:
+            with open(path, "w") as f:
+                f.write(stacks)
+        return stacks
+
 
 @pass_instrument
 class PassPrintingInstrument:
@@ -291,3 +352,50 @@ class PrintBeforeAll:
     def run_before_pass(self, mod, info):
         print(f"Before Running Pass: {info}")
         print(mod)
+
+
+@pass_instrument
+class ObjectAllocationInstrument:
+    """Count the objects allocated and retained by each pass.
+
+    The counts come from the pooled object allocator, so they are only
+    collected when TVM is built with USE_POOLED_OBJECT_ALLOCATOR.
+    A pass nested in another pass is also counted by the outer pass.
+
+    Examples
+    --------
+
+    .. code-block:: python
+
+        alloc_inst = ObjectAllocationInstrument()
+        with tvm.transform.PassContext(instruments=[alloc_inst]):
+            mod = tvm.tir.transform.Simplify()(mod)
+        print(alloc_inst.render())
+    """
+
+    def __init__(self):
+        self._stack = []
+        self.profiles = []
+
+    def run_before_pass(self, mod, info):
+        self._stack.append(tvm.runtime._ffi_api.ObjectPoolStats())
+
+    def run_after_pass(self, mod, info):
+        num_allocated, num_freed, _ = tvm.runtime._ffi_api.ObjectPoolStats()
+        prev_allocated, prev_freed, _ = self._stack.pop()
+        allocated = num_allocated - prev_allocated
+        retained = allocated - (num_freed - prev_freed)
+        self.profiles.append((info.name, len(self._stack), allocated, retained))
+
+    def render(self):
+        """Render the allocated and retained objects of each pass, in the order they finished.
+
+        Returns
+        -------
+        string : string
+            The rendered profiles.
+        """
+        lines = []
+        for name, depth, allocated, retained in self.profiles:
+            lines.append(f"{'  ' * depth}{name}: allocated={allocated} retained={retained}")
+        return "\n".join(lines)
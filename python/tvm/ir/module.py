@@ -18,12 +18,13 @@
 
 from __future__ import annotations
 
-from typing import Dict, Union
+from typing import Dict, Optional, Union
 
 import tvm._ffi
 from tvm._ffi.base import string_types
 from tvm.runtime import Scriptable
 from tvm.runtime.object import Object
+from tvm.runtime.script_printer import PrinterConfig
 
 from . import _ffi_api
 from . import expr as _expr
@@ -423,3 +424,36 @@ class IRModule(Node, Scriptable):
         from tvm.relay import astext  # pylint: disable=import-outside-toplevel
 
         return astext(self, show_meta_data, annotate)
+
+    def write_script(self, path: Optional[str] = None, *, num_threads: int = 1, **kwargs):
+        """Print the module into TVMScript one function at a time.
+
+        The text is the same as the one of :py:meth:`script`, but the functions are printed
+        on their own, possibly in parallel, without building the Doc tree of the whole module,
+        which is faster and lighter on very large modules.
+
+        Parameters
+        ----------
+        path : Optional[str]
+            The file to write the script into. The script is returned if it is None.
+
+        num_threads : int
+            The number of threads printing the functions.
+
+        kwargs
+            The options of the printer, as given to :py:meth:`script`.
+
+        Returns
+        -------
+        script : Optional[str]
+            The TVMScript of the module, if path is None.
+        """
+        config = PrinterConfig(**kwargs)
+        if path is None:
+            return tvm._ffi.get_global_func("script.printer.IRModuleToScript")(
+                self, config, num_threads
+            )
+        tvm._ffi.get_global_func("script.printer.IRModuleToScriptFile")(
+            self, config, path, num_threads
+        )
+        return None
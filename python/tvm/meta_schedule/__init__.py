@@ -51,5 +51,6 @@ from .space_generator import SpaceGenerator
 from .task_scheduler import TaskScheduler
 from .tir_integration import tune_tir
 from .tune import tune_tasks
+from .tune_distributed import DevicePool, tune_distributed
 from .tune_context import TuneContext
 from .utils import derived_object
@@ -19,4 +19,5 @@ The tvm.meta_schedule.cost_model package.
 """
 from .cost_model import CostModel, PyCostModel
 from .random_model import RandomModel
+from .warm_start import ranking_accuracy, warm_start
 from .xgb_model import XGBModel
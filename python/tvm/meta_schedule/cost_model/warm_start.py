@@ -0,0 +1,152 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Warm-starting cost models from the tuning records of other workloads."""
+from typing import TYPE_CHECKING, Dict, Iterable, List, Optional, Tuple, Union
+
+import numpy as np  # type: ignore
+
+from ...target import Target
+from ..runner import RunnerResult
+from ..search_strategy import MeasureCandidate
+from ..tune_context import TuneContext
+from ..utils import shash2hex
+
+if TYPE_CHECKING:
+    from ..database import Database, TuningRecord
+    from .cost_model import CostModel
+
+# Keep in sync with SortTuningRecordByMeanRunSecs::kMaxMeanTime, the running time of failed runs
+_MAX_MEAN_TIME = 1e10
+
+
+def _group_records(
+    databases: Iterable["Database"],
+    max_records_per_workload: Optional[int],
+) -> List[List["TuningRecord"]]:
+    groups: Dict[str, List["TuningRecord"]] = {}
+    for database in databases:
+        for record in database.get_all_tuning_records():
+            if record.run_secs is None or len(record.run_secs) == 0:
+                continue
+            mean = float(np.mean([float(x) for x in record.run_secs]))
+            if mean >= _MAX_MEAN_TIME:
+                continue
+            groups.setdefault(shash2hex(record.workload.mod), []).append(record)
+    result = []
+    for records in groups.values():
+        records.sort(key=lambda r: float(np.mean([float(x) for x in r.run_secs])))
+        if max_records_per_workload is not None:
+            records = records[:max_records_per_workload]
+        result.append(records)
+    return result
+
+
+def _as_batch(
+    records: List["TuningRecord"],
+    target: Union[Target, str, None],
+) -> Tuple[TuneContext, List[MeasureCandidate], List[RunnerResult]]:
+    if target is None:
+        target = records[0].target
+    context = TuneContext(mod=records[0].workload.mod, target=target, task_name="warm_start")
+    candidates = [record.as_measure_candidate() for record in records]
+    results = [RunnerResult(run_secs=record.run_secs, error_msg=None) for record in records]
+    return context, candidates, results
+
+
+def warm_start(
+    cost_model: "CostModel",
+    databases: Union["Database", Iterable["Database"]],
+    *,
+    target: Union[Target, str, None] = None,
+    max_records_per_workload: Optional[int] = None,
+) -> int:
+    """Train a cost model on the tuning records of previously tuned workloads.
+
+    The records are fed workload by workload through `CostModel.update`, so the features are
+    extracted exactly as during tuning, e.g. by `PerStoreFeature` for `XGBModel`. As the
+    pretrained data counts towards the warm-up samples of `XGBModel`, the evolutionary search
+    ranks its very first population with the pretrained model instead of random scores.
+
+    Parameters
+    ----------
+    cost_model : CostModel
+        The cost model to be trained.
+    databases : Union[Database, Iterable[Database]]
+        The databases holding the tuning records of other workloads or targets.
+    target : Union[Target, str, None]
+        The target of the tuning contexts. Defaults to the target of the records.
+    max_records_per_workload : Optional[int]
+        Only use the fastest records of each workload. Defaults to all of them.
+
+    Returns
+    -------
+    num_records : int
+        The number of records the cost model is trained on.
+    """
+    if not isinstance(databases, (list, tuple)):
+        databases = [databases]
+    num_records = 0
+    for records in _group_records(databases, max_records_per_workload):
+        context, candidates, results = _as_batch(records, target)
+        cost_model.update(context, candidates, results)
+        num_records += len(records)
+    return num_records
+
+
+def ranking_accuracy(
+    cost_model: "CostModel",
+    databases: Union["Database", Iterable["Database"]],
+    *,
+    target: Union[Target, str, None] = None,
+) -> float:
+    """Evaluate how well a cost model ranks the measured records of each workload.
+
+    Parameters
+    ----------
+    cost_model : CostModel
+        The cost model to be evaluated.
+    databases : Union[Database, Iterable[Database]]
+        The databases holding the held-out tuning records.
+    target : Union[Target, str, None]
+        The target of the tuning contexts. Defaults to the target of the records.
+
+    Returns
+    -------
+    accuracy : float
+        The fraction of record pairs within the same workload whose predicted order matches the
+        measured order, or NaN if there is no such pair.
+    """
+    if not isinstance(databases, (list, tuple)):
+        databases = [databases]
+    num_pairs = 0
+    num_concordant = 0
+    for records in _group_records(databases, None):
+        if len(records) < 2:
+            continue
+        context, candidates, _ = _as_batch(records, target)
+        predicted = np.array(cost_model.predict(context, candidates), dtype="float64")
+        run_secs = np.array(
+            [np.mean([float(x) for x in record.run_secs]) for record in records], dtype="float64"
+        )
+        measured_faster = run_secs[:, None] < run_secs[None, :]
+        predicted_faster = predicted[:, None] > predicted[None, :]
+        comparable = np.triu(run_secs[:, None] != run_secs[None, :], k=1)
+        num_pairs += int(comparable.sum())
+        num_concordant += int((comparable & (measured_faster == predicted_faster)).sum())
+    if num_pairs == 0:
+        return float("nan")
+    return num_concordant / num_pairs
@@ -15,7 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 """TuningRecord database"""
-from typing import Any, Callable, List, Optional, Union
+from typing import Any, Callable, Dict, List, Optional, Union
 
 # isort: off
 from typing_extensions import Literal
@@ -26,6 +26,7 @@ from tvm._ffi import register_object
 from tvm.ir.module import IRModule
 from tvm.runtime import Object
 from tvm.target import Target
+from tvm.tir import FloatImm
 from tvm.tir.schedule import Schedule, Trace
 
 from .. import _ffi_api
@@ -95,6 +96,8 @@ class TuningRecord(Object):
         The target of the tuning record.
     args_info : Optional[List[ArgInfo]]
         The argument information of the tuning record.
+    metrics : Optional[Dict[str, float]]
+        The hardware counters collected along with the run time, if any.
     """
 
     trace: Trace
@@ -102,6 +105,7 @@ class TuningRecord(Object):
     run_secs: Optional[List[float]]
     target: Optional[Target]
     args_info: Optional[List[ArgInfo]]
+    metrics: Optional[Dict[str, float]]
 
     def __init__(  # type: ignore # pylint: disable=too-many-arguments
         self,
@@ -110,7 +114,10 @@ class TuningRecord(Object):
         run_secs: Optional[List[float]] = None,
         target: Optional[Target] = None,
         args_info: Optional[List[ArgInfo]] = None,
+        metrics: Optional[Dict[str, float]] = None,
     ) -> None:
+        if metrics is not None:
+            metrics = {name: FloatImm("float64", float(value)) for name, value in metrics.items()}
         self.__init_handle_by_constructor__(
             _ffi_api.TuningRecord,  # type: ignore # pylint: disable=no-member
             trace,
@@ -118,6 +125,7 @@ class TuningRecord(Object):
             run_secs,
             target,
             args_info,
+            metrics,
         )
 
     def as_measure_candidate(self) -> Any:
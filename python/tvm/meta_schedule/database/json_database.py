@@ -44,10 +44,13 @@ class JSONDatabase(Database):
                             given module. The "ignore-ndarray" varint is used for the extracted
                             blocks or in case no anchor block is found.
                             For the definition of the anchor block, see tir/analysis/analysis.py.
+    concurrent : bool
+        Whether the files are shared with writers in other processes.
     """
 
     path_workload: str
     path_tuning_record: str
+    concurrent: bool
 
     def __init__(
         self,
@@ -57,6 +60,7 @@ class JSONDatabase(Database):
         work_dir: Optional[str] = None,
         allow_missing: bool = True,
         module_equality: str = "structural",
+        concurrent: bool = False,
     ) -> None:
         """Constructor.
 
@@ -73,6 +77,11 @@ class JSONDatabase(Database):
             and `path_workload`.
         allow_missing : bool
             Whether to create new file when the given path is not found.
+        concurrent : bool
+            Whether the files are shared with writers in other processes, e.g. the jobs of a
+            tuning farm on NFS. Writes are then serialized by advisory file locks, queries pick
+            up the records appended by the other writers, and a record with the same workload,
+            trace and target as an existing one is dropped instead of committed again.
         """
         if work_dir is not None:
             if path_workload is None:
@@ -89,4 +98,9 @@ class JSONDatabase(Database):
             path_tuning_record,
             allow_missing,
             module_equality,
+            concurrent,
         )
+
+    def refresh(self) -> None:
+        """Read the workloads and records appended by other writers, in concurrent mode."""
+        _ffi_api.JSONDatabaseRefresh(self)  # type: ignore # pylint: disable=no-member
@@ -23,9 +23,18 @@ from .mutator import Mutator
 
 @register_object("meta_schedule.MutateTileSize")
 class MutateTileSize(Mutator):
-    """Mutator that mutates the decision of instruction Sample-Perfect-Tile"""
+    """Mutator that mutates the decision of instruction Sample-Perfect-Tile
 
-    def __init__(self) -> None:
+    Parameters
+    ----------
+    prune_by_footprint : bool
+        Whether to reject tile sizes whose analytic shared memory footprint exceeds the
+        target's `max_shared_memory_per_block`, instead of leaving them to the postprocessors
+        and the builder.
+    """
+
+    def __init__(self, prune_by_footprint: bool = False) -> None:
         self.__init_handle_by_constructor__(
             _ffi_api.MutatorMutateTileSize,  # type: ignore # pylint: disable=no-member
+            prune_by_footprint,
         )
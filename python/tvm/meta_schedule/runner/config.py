@@ -17,7 +17,7 @@
 """Configurations for measurements in the runner"""
 import os
 from threading import Thread
-from typing import NamedTuple, Optional, Union
+from typing import Any, NamedTuple, Optional, Union
 
 from tvm import rpc
 
@@ -41,6 +41,19 @@ class EvaluatorConfig(NamedTuple):
         increase the number of runs to the given time (in ms) to reduce the measurement error.
     enable_cpu_cache_flush: bool
         Whether to flush the cache on CPU.
+    early_stop_ratio: Optional[float]
+        Enables the adaptive evaluation. A candidate stops being measured once the lower
+        confidence bound of its running time exceeds `early_stop_ratio` times the best known
+        running time of the workload. Candidates are first timed by a single run, so the
+        obviously slow ones skip the `min_repeat_ms` repeats altogether.
+    max_repeat: Optional[int]
+        In adaptive evaluation, candidates whose mean running time is within `close_ratio` of
+        the best known one are repeated up to `max_repeat` times instead of `repeat`.
+    close_ratio: float
+        The ratio to the best known running time under which a candidate gets extra repeats.
+    best_run_secs: Optional[float]
+        The best known running time of the workload. It is filled by the runners from
+        `RunnerInput.best_run_secs` for each candidate.
 
     Note
     ----
@@ -52,6 +65,10 @@ class EvaluatorConfig(NamedTuple):
     repeat: int = 1
     min_repeat_ms: int = 100
     enable_cpu_cache_flush: bool = False
+    early_stop_ratio: Optional[float] = None
+    max_repeat: Optional[int] = None
+    close_ratio: float = 1.1
+    best_run_secs: Optional[float] = None
 
     @staticmethod
     def _normalized(config: Optional["EvaluatorConfig"]) -> "EvaluatorConfig":
@@ -62,9 +79,19 @@ class EvaluatorConfig(NamedTuple):
             repeat=config.repeat,
             min_repeat_ms=config.min_repeat_ms,
             enable_cpu_cache_flush=config.enable_cpu_cache_flush,
+            early_stop_ratio=config.early_stop_ratio,
+            max_repeat=config.max_repeat,
+            close_ratio=config.close_ratio,
+            best_run_secs=config.best_run_secs,
         )
         return config
 
+    def _for_input(self, runner_input: Any) -> "EvaluatorConfig":
+        best_run_secs = runner_input.best_run_secs
+        if self.early_stop_ratio is None or best_run_secs is None:
+            return self
+        return self._replace(best_run_secs=float(best_run_secs.value))
+
 
 class RPCConfig(NamedTuple):
     """RPC configuration
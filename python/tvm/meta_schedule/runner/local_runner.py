@@ -17,7 +17,7 @@
 """Local Runner"""
 import logging
 from contextlib import contextmanager
-from typing import Callable, List, Optional, Union
+from typing import Callable, Dict, List, Optional, Tuple, Union
 import subprocess
 
 import tvm
@@ -33,6 +33,7 @@ from .utils import (
     T_ARG_INFO_JSON_OBJ_LIST,
     T_ARGUMENT_LIST,
     alloc_argument_common,
+    collect_hardware_metrics_common,
     run_evaluator_common,
 )
 
@@ -72,6 +73,8 @@ class LocalRunnerFuture(PyRunnerFuture):
         The optional result as a list of float.
     error_message: Optional[str]
         The optional error message.
+    metrics: Optional[Dict[str, float]]
+        The optional hardware counters.
 
     Note
     ----
@@ -81,9 +84,13 @@ class LocalRunnerFuture(PyRunnerFuture):
 
     res: Optional[List[float]]
     error_message: Optional[str]
+    metrics: Optional[Dict[str, float]]
 
     def __init__(
-        self, res: Optional[List[float]] = None, error_message: Optional[str] = None
+        self,
+        res: Optional[List[float]] = None,
+        error_message: Optional[str] = None,
+        metrics: Optional[Dict[str, float]] = None,
     ) -> None:
         """Constructor
 
@@ -93,11 +100,14 @@ class LocalRunnerFuture(PyRunnerFuture):
             The result of this LocalRunnerFuture
         error_message: Optional[str]
             The stringfied error message of any exception during execution
+        metrics: Optional[Dict[str, float]]
+            The hardware counters collected along with the result
 
         """
         super().__init__()
         self.res = res
         self.error_message = error_message
+        self.metrics = metrics
 
         # sanity check upon the creation of LocalRunnerFuture object
         if (res is None and error_message is None) or (
@@ -112,7 +122,7 @@ class LocalRunnerFuture(PyRunnerFuture):
         return True
 
     def result(self) -> RunnerResult:
-        return RunnerResult(self.res, self.error_message)
+        return RunnerResult(self.res, self.error_message, self.metrics)
 
 
 def _worker_func(
@@ -124,7 +134,8 @@ def _worker_func(
     artifact_path: str,
     device_type: str,
     args_info: T_ARG_INFO_JSON_OBJ_LIST,
-) -> List[float]:
+    hardware_metrics: Optional[List[str]] = None,
+) -> Tuple[List[float], Optional[Dict[str, float]]]:
     f_alloc_argument: T_ALLOC_ARGUMENT = get_global_func_with_default_on_worker(
         _f_alloc_argument, default_alloc_argument
     )
@@ -162,7 +173,17 @@ def _worker_func(
                 evaluator_config,
                 repeated_args,
             )
-    return costs
+        # Step 4: Collect hardware counters
+        metrics: Optional[Dict[str, float]] = None
+        if hardware_metrics:
+            with Profiler.timeit("LocalRunner/collect_hardware_metrics"):
+                metrics = collect_hardware_metrics_common(
+                    rt_mod,
+                    device,
+                    hardware_metrics,
+                    repeated_args[0],
+                )
+    return costs, metrics
 
 
 @derived_object
@@ -183,6 +204,8 @@ class LocalRunner(PyRunner):
         The function name to run the evaluator or the function itself.
     f_cleanup: Optional[str, Callable]
         The function name to cleanup the session or the function itself.
+    hardware_metrics: Optional[List[str]]
+        The PAPI events to collect for each candidate, stored along with the run time.
     pool: PopenPoolExecutor
         The popen pool executor.
 
@@ -230,6 +253,7 @@ class LocalRunner(PyRunner):
     f_alloc_argument: Union[T_ALLOC_ARGUMENT, str, None]
     f_run_evaluator: Union[T_RUN_EVALUATOR, str, None]
     f_cleanup: Union[T_CLEANUP, str, None]
+    hardware_metrics: Optional[List[str]]
 
     pool: PopenPoolExecutor
 
@@ -243,6 +267,7 @@ class LocalRunner(PyRunner):
         f_run_evaluator: Union[T_RUN_EVALUATOR, str, None] = None,
         f_cleanup: Union[T_CLEANUP, str, None] = None,
         initializer: Optional[Callable[[], None]] = None,
+        hardware_metrics: Optional[List[str]] = None,
     ) -> None:
         """Constructor
 
@@ -264,6 +289,9 @@ class LocalRunner(PyRunner):
             The function name to cleanup the session or the function itself.
         initializer: Optional[Callable[[], None]]
             The initializer function.
+        hardware_metrics: Optional[List[str]]
+            The PAPI events to collect for each candidate, e.g. ["PAPI_L2_TCM"]. TVM must be
+            built with USE_PAPI=ON. Requires an extra run of each candidate.
         """
         super().__init__()
         self.timeout_sec = timeout_sec
@@ -273,6 +301,7 @@ class LocalRunner(PyRunner):
         self.f_alloc_argument = f_alloc_argument
         self.f_run_evaluator = f_run_evaluator
         self.f_cleanup = f_cleanup
+        self.hardware_metrics = list(hardware_metrics) if hardware_metrics else None
 
         err_path = subprocess.DEVNULL
         if logger.root.level <= logging.DEBUG:
@@ -290,19 +319,23 @@ class LocalRunner(PyRunner):
     def run(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
         results: List[RunnerFuture] = []
         for runner_input in runner_inputs:
+            evaluator_config = self.evaluator_config._for_input(runner_input)
             future = self.pool.submit(
                 _worker_func,
                 self.f_alloc_argument,
                 self.f_run_evaluator,
                 self.f_cleanup,
-                self.evaluator_config,
+                evaluator_config,
                 self.alloc_repeat,
                 str(runner_input.artifact_path),
                 str(runner_input.device_type),
                 tuple(arg_info.as_json() for arg_info in runner_input.args_info),
+                self.hardware_metrics,
             )
+            metrics: Optional[Dict[str, float]] = None
             try:
-                result: List[float] = future.result()
+                result: List[float]
+                result, metrics = future.result()
                 error_message: str = None
             except TimeoutError:
                 result = None
@@ -310,7 +343,11 @@ class LocalRunner(PyRunner):
             except Exception as exception:  # pylint: disable=broad-except
                 result = None
                 error_message = "LocalRunner: An exception occurred\n" + str(exception)
-            local_future = LocalRunnerFuture(res=result, error_message=error_message)
+            local_future = LocalRunnerFuture(
+                res=result,
+                error_message=error_message,
+                metrics=metrics,
+            )
             results.append(local_future)  # type: ignore
         return results
 
@@ -319,16 +356,22 @@ class LocalRunner(PyRunner):
             f_alloc_argument,
             f_run_evaluator,
             f_cleanup,
+            hardware_metrics,
         ) -> None:
             get_global_func_with_default_on_worker(name=f_alloc_argument, default=None)
             get_global_func_with_default_on_worker(name=f_run_evaluator, default=None)
             get_global_func_with_default_on_worker(name=f_cleanup, default=None)
+            if hardware_metrics:
+                get_global_func_with_default_on_worker(
+                    name="runtime.profiling.PAPIMetricCollector", default=None
+                )
 
         value = self.pool.submit(
             _check,
             self.f_alloc_argument,
             self.f_run_evaluator,
             self.f_cleanup,
+            self.hardware_metrics,
         )
         value.result()
 
@@ -18,7 +18,7 @@
 import concurrent.futures
 import os.path as osp
 from contextlib import contextmanager
-from typing import Callable, List, Optional, Union
+from typing import Callable, Dict, List, Optional, Union
 
 from tvm.contrib.popen_pool import PopenPoolExecutor
 from tvm.rpc import RPCSession
@@ -36,12 +36,15 @@ from .runner import PyRunner, PyRunnerFuture, RunnerFuture, RunnerInput, RunnerR
 from .utils import (
     T_ARG_INFO_JSON_OBJ_LIST,
     T_ARGUMENT_LIST,
+    alloc_argument_cached,
     alloc_argument_common,
     run_evaluator_common,
 )
 
 logger = get_logger(__name__)  # pylint: disable=invalid-name
 
+# The sessions kept open by each popen worker when the arguments are cached on the server
+_CACHED_SESSIONS: Dict[RPCConfig, RPCSession] = {}
 
 T_CREATE_SESSION = Callable[  # pylint: disable=invalid-name
     [RPCConfig],  # The RPC configuration
@@ -155,6 +158,8 @@ class RPCRunner(PyRunner):
         The function name to run the evaluator or the function itself.
     f_cleanup: Optional[str, Callable]
         The function name to cleanup the session or the function itself.
+    cache_args: bool
+        Whether to keep the argument tensors on the RPC server across trials.
     pool: PopenPoolExecutor
         The popen pool executor.
 
@@ -229,6 +234,7 @@ class RPCRunner(PyRunner):
     f_alloc_argument: Union[T_ALLOC_ARGUMENT, str, None]
     f_run_evaluator: Union[T_RUN_EVALUATOR, str, None]
     f_cleanup: Union[T_CLEANUP, str, None]
+    cache_args: bool
 
     pool: PopenPoolExecutor
 
@@ -245,6 +251,7 @@ class RPCRunner(PyRunner):
         f_cleanup: Union[T_CLEANUP, str, None] = None,
         max_workers: Optional[int] = None,
         initializer: Optional[Callable[[], None]] = None,
+        cache_args: bool = False,
     ) -> None:
         """Constructor
 
@@ -272,6 +279,11 @@ class RPCRunner(PyRunner):
             The maximum number of connections. Defaults to 1.
         initializer: Optional[Callable[[], None]]
             The initializer function.
+        cache_args: bool
+            Whether to keep the argument tensors on the RPC server across trials. Each worker then
+            holds its session open, and the trials with the same argument shapes reuse the device
+            tensors allocated by the earlier ones instead of allocating and filling new ones.
+            Only applies when `f_alloc_argument` is not given.
         """
         super().__init__()
         self.rpc_config = RPCConfig._normalized(rpc_config)
@@ -283,6 +295,7 @@ class RPCRunner(PyRunner):
         self.f_alloc_argument = f_alloc_argument
         self.f_run_evaluator = f_run_evaluator
         self.f_cleanup = f_cleanup
+        self.cache_args = cache_args
         if max_workers is None:
             max_workers = 1
         logger.info("RPCRunner: max_workers = %d", max_workers)
@@ -295,6 +308,7 @@ class RPCRunner(PyRunner):
     def run(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
         results: List[RunnerFuture] = []
         for runner_input in runner_inputs:
+            evaluator_config = self.evaluator_config._for_input(runner_input)
             future = RPCRunnerFuture(
                 future=self.pool.submit(
                     _worker_func,
@@ -304,11 +318,12 @@ class RPCRunner(PyRunner):
                     self.f_run_evaluator,
                     self.f_cleanup,
                     self.rpc_config,
-                    self.evaluator_config,
+                    evaluator_config,
                     self.alloc_repeat,
                     str(runner_input.artifact_path),
                     str(runner_input.device_type),
                     tuple(arg_info.as_json() for arg_info in runner_input.args_info),
+                    self.cache_args,
                 ),
                 timeout_sec=self.rpc_config.session_timeout_sec,
             )
@@ -352,6 +367,7 @@ def _worker_func(
     artifact_path: str,
     device_type: str,
     args_info: T_ARG_INFO_JSON_OBJ_LIST,
+    cache_args: bool = False,
 ) -> List[float]:
     # Step 0. Get the registered functions
     f_create_session: T_CREATE_SESSION = get_global_func_with_default_on_worker(
@@ -361,12 +377,14 @@ def _worker_func(
         _f_upload_module, default_upload_module
     )
     f_alloc_argument: T_ALLOC_ARGUMENT = get_global_func_with_default_on_worker(
-        _f_alloc_argument, default_alloc_argument
+        _f_alloc_argument, default_alloc_argument_cached if cache_args else default_alloc_argument
     )
     f_run_evaluator: T_RUN_EVALUATOR = get_global_func_with_default_on_worker(
         _f_run_evaluator, default_run_evaluator
     )
-    f_cleanup: T_CLEANUP = get_global_func_with_default_on_worker(_f_cleanup, default_cleanup)
+    f_cleanup: T_CLEANUP = get_global_func_with_default_on_worker(
+        _f_cleanup, default_cleanup_cached if cache_args else default_cleanup
+    )
     # Managed resources
     session: Optional[RPCSession] = None
     remote_path: Optional[str] = None
@@ -375,6 +393,11 @@ def _worker_func(
     def resource_handler():
         try:
             yield
+        except Exception:  # pylint: disable=broad-except
+            # The session may be broken, so the next trial reconnects
+            if cache_args:
+                _CACHED_SESSIONS.pop(rpc_config, None)
+            raise
         finally:
             # Final step. Always clean up
             with Profiler.timeit("RPCRunner/cleanup"):
@@ -383,7 +406,10 @@ def _worker_func(
     with resource_handler():
         # Step 1. Create session
         with Profiler.timeit("RPCRunner/create_session"):
-            session = f_create_session(rpc_config)
+            if cache_args:
+                session = _get_cached_session(f_create_session, rpc_config)
+            else:
+                session = f_create_session(rpc_config)
             device = session.device(dev_type=device_type, dev_id=0)
         # Step 2. Upload the module
         with Profiler.timeit("RPCRunner/upload_module"):
@@ -410,6 +436,20 @@ def _worker_func(
     return costs
 
 
+def _get_cached_session(f_create_session: T_CREATE_SESSION, rpc_config: RPCConfig) -> RPCSession:
+    session = _CACHED_SESSIONS.get(rpc_config, None)
+    if session is not None:
+        try:
+            # The server closes the session once its timeout expires
+            session.get_function("tvm.rpc.server.arg_cache_get_or_alloc")
+            return session
+        except Exception:  # pylint: disable=broad-except
+            _CACHED_SESSIONS.pop(rpc_config, None)
+    session = f_create_session(rpc_config)
+    _CACHED_SESSIONS[rpc_config] = session
+    return session
+
+
 def default_create_session(rpc_config: RPCConfig) -> RPCSession:
     """Default function to create the session
 
@@ -485,6 +525,38 @@ def default_alloc_argument(
     return alloc_argument_common(f_random_fill, device, args_info, alloc_repeat)
 
 
+def default_alloc_argument_cached(
+    session: RPCSession,
+    device: Device,
+    args_info: T_ARG_INFO_JSON_OBJ_LIST,
+    alloc_repeat: int,
+) -> List[T_ARGUMENT_LIST]:
+    """Default function to allocate the arguments through the cache on the RPC server
+
+    Parameters
+    ----------
+    session: RPCSession
+        The session to allocate the arguments
+    device: Device
+        The device to allocate the arguments
+    args_info: T_ARG_INFO_JSON_OBJ_LIST
+        The arguments info
+    alloc_repeat: int
+        The number of times to repeat the allocation
+
+    Returns
+    -------
+    repeated_args: List[Args]
+        The allocation args
+    """
+    f_get_or_alloc = get_global_func_on_rpc_session(
+        session,
+        "tvm.rpc.server.arg_cache_get_or_alloc",
+        "Please make sure the RPC server is built with the argument cache.",
+    )
+    return alloc_argument_cached(f_get_or_alloc, device, args_info, alloc_repeat)
+
+
 def default_run_evaluator(
     session: RPCSession,  # pylint: disable=unused-argument
     rt_mod: Module,
@@ -532,3 +604,21 @@ def default_cleanup(
         session.remove(remote_path)
         session.remove(remote_path + ".so")
         session.remove("")
+
+
+def default_cleanup_cached(
+    session: Optional[RPCSession],
+    remote_path: Optional[str],
+) -> None:
+    """Default function to clean up the artifact of a trial while keeping the session alive
+
+    Parameters
+    ----------
+    session: RPCSession
+        The session to clean up
+    remote_path: str
+        The remote path to clean up
+    """
+    if session is not None and remote_path is not None:
+        session.remove(remote_path)
+        session.remove(remote_path + ".so")
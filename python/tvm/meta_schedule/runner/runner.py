@@ -15,7 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 """Runners"""
-from typing import Callable, List, Optional, Union
+from typing import Callable, Dict, List, Optional, Union
 
 # isort: off
 from typing_extensions import Literal
@@ -24,6 +24,7 @@ from typing_extensions import Literal
 
 from tvm._ffi import register_object
 from tvm.runtime import Object
+from tvm.tir import FloatImm
 
 from .. import _ffi_api
 from ..arg_info import ArgInfo
@@ -41,17 +42,21 @@ class RunnerInput(Object):
         The device type.
     args_info : List[ArgInfo]
         The argument information.
+    best_run_secs : Optional[float]
+        The best known running time of the workload in seconds, if any.
     """
 
     artifact_path: str
     device_type: str
     args_info: List[ArgInfo]
+    best_run_secs: Optional[float]
 
     def __init__(
         self,
         artifact_path: str,
         device_type: str,
         args_info: List[ArgInfo],
+        best_run_secs: Optional[float] = None,
     ) -> None:
         """Constructor
 
@@ -63,12 +68,18 @@ class RunnerInput(Object):
             The device type.
         args_info : List[ArgInfo]
             The argument information.
+        best_run_secs : Optional[float]
+            The best known running time of the workload in seconds, used by the adaptive
+            evaluation of `EvaluatorConfig`.
         """
+        if best_run_secs is not None:
+            best_run_secs = FloatImm("float64", float(best_run_secs))
         self.__init_handle_by_constructor__(
             _ffi_api.RunnerInput,  # type: ignore # pylint: disable=no-member
             artifact_path,
             device_type,
             args_info,
+            best_run_secs,
         )
 
 
@@ -82,15 +93,19 @@ class RunnerResult(Object):
         The run time in seconds.
     error_msg : Optional[str]
         The error message, if any.
+    metrics : Optional[Dict[str, float]]
+        The hardware counters collected along with the run time, if any.
     """
 
     run_secs: Optional[List[float]]
     error_msg: Optional[str]
+    metrics: Optional[Dict[str, float]]
 
     def __init__(
         self,
         run_secs: Optional[List[float]],
         error_msg: Optional[str],
+        metrics: Optional[Dict[str, float]] = None,
     ) -> None:
         """Constructor
 
@@ -100,11 +115,16 @@ class RunnerResult(Object):
             The run time in seconds.
         error_msg : Optional[str]
             The error message, if any.
+        metrics : Optional[Dict[str, float]]
+            The hardware counters collected along with the run time, if any.
         """
+        if metrics is not None:
+            metrics = {name: FloatImm("float64", float(value)) for name, value in metrics.items()}
         self.__init_handle_by_constructor__(
             _ffi_api.RunnerResult,  # type: ignore # pylint: disable=no-member
             run_secs,
             error_msg,
+            metrics,
         )
 
 
@@ -77,6 +77,54 @@ def alloc_argument_common(
     return repeated_args
 
 
+def alloc_argument_cached(
+    f_get_or_alloc: Callable,
+    device: Device,
+    args_info: T_ARG_INFO_JSON_OBJ_LIST,
+    alloc_repeat: int,
+) -> List[T_ARGUMENT_LIST]:
+    """Allocate the arguments through a cache that keeps the tensors alive across trials
+
+    Parameters
+    ----------
+    f_get_or_alloc: Callable
+        The callable function that returns the cached tensor of a key, or allocates and randomly
+        fills a new one, called as `f_get_or_alloc(key, device, dtype, *shape)`
+    device: Device
+        The device to allocate the arguments
+    args_info: T_ARG_INFO_JSON_OBJ_LIST
+        The arguments info
+    alloc_repeat: int
+        The number of times to repeat the allocation
+
+    Returns
+    -------
+    repeated_args: List[T_ARGUMENT_LIST]
+        The allocation args
+    """
+
+    def alloc_fail(*arg_info) -> None:
+        raise NotImplementedError(arg_info)
+
+    repeated_args: List[T_ARGUMENT_LIST] = []
+    for repeat in range(alloc_repeat):
+        args: T_ARGUMENT_LIST = []
+        # Arguments with the same spec in one call must still be distinct tensors
+        occurrences: Dict[str, int] = {}
+        arg_info: T_ARG_INFO_JSON_OBJ
+        for arg_info in args_info:
+            if arg_info[0] != "TENSOR":
+                alloc_fail(*arg_info)
+            _, dtype, shape = arg_info
+            spec = f"{dtype}[{','.join(str(dim) for dim in shape)}]"
+            index = occurrences.get(spec, 0)
+            occurrences[spec] = index + 1
+            key = f"meta_schedule/{spec}/{index}/{repeat}"
+            args.append(f_get_or_alloc(key, device, str(dtype), *[int(dim) for dim in shape]))
+        repeated_args.append(args)
+    return repeated_args
+
+
 def run_evaluator_common(
     rt_mod: Module,
     device: Device,
@@ -101,6 +149,8 @@ def run_evaluator_common(
     costs: List[float]
         The evaluator results
     """
+    if evaluator_config.early_stop_ratio is not None and evaluator_config.best_run_secs:
+        return _run_evaluator_adaptive(rt_mod, device, evaluator_config, repeated_args)
     evaluator = rt_mod.time_evaluator(
         func_name=rt_mod.entry_name,
         dev=device,
@@ -118,3 +168,98 @@ def run_evaluator_common(
         repeated_costs.append(profile_result.results)
     costs = [float(cost) for cost in itertools.chain.from_iterable(repeated_costs)]
     return costs
+
+
+def collect_hardware_metrics_common(
+    rt_mod: Module,
+    device: Device,
+    metric_names: List[str],
+    args: T_ARGUMENT_LIST,
+) -> Dict[str, float]:
+    """Common function to collect the hardware counters of the entry function with PAPI
+
+    Parameters
+    ----------
+    rt_mod: Module
+        The runtime module
+    device: Device
+        The device to run the function
+    metric_names: List[str]
+        The PAPI events to collect, as listed by `papi_native_avail`. GPU counters are
+        available through the PAPI CUDA component, e.g. "cuda:::dram__bytes_read.sum:device=0".
+    args: T_ARGUMENT_LIST
+        The arguments
+
+    Returns
+    -------
+    metrics: Dict[str, float]
+        The collected counters
+    """
+    # pylint: disable=import-outside-toplevel
+    from ...runtime import profiling
+
+    # pylint: enable=import-outside-toplevel
+    if not hasattr(profiling, "PAPIMetricCollector"):
+        raise ValueError("Collecting hardware metrics requires TVM to be built with USE_PAPI=ON")
+    collector = profiling.PAPIMetricCollector({device: list(metric_names)})
+    report = profiling.profile_function(rt_mod, device, [collector])(*args)
+    metrics: Dict[str, float] = {}
+    for name, value in report.items():
+        for field in ["value", "ratio", "percent", "microseconds"]:
+            if hasattr(value, field):
+                metrics[str(name)] = float(getattr(value, field))
+                break
+    return metrics
+
+
+def _run_evaluator_adaptive(
+    rt_mod: Module,
+    device: Device,
+    evaluator_config: EvaluatorConfig,
+    repeated_args: List[T_ARGUMENT_LIST],
+) -> List[float]:
+    """Time a candidate repeat by repeat, stopping as soon as it is clearly slower than the best
+    known candidate, and repeating more when it is close to the best.
+    """
+    f_preproc = "cache_flush_cpu_non_first_arg" if evaluator_config.enable_cpu_cache_flush else ""
+    threshold = evaluator_config.early_stop_ratio * evaluator_config.best_run_secs
+    num_repeats = evaluator_config.repeat * len(repeated_args)
+    max_repeats = max(evaluator_config.max_repeat or 0, evaluator_config.repeat)
+    max_repeats *= len(repeated_args)
+    # Step 1. A single run tells apart the candidates that are way off
+    pilot = rt_mod.time_evaluator(
+        func_name=rt_mod.entry_name,
+        dev=device,
+        number=1,
+        repeat=1,
+        min_repeat_ms=0,
+        f_preproc=f_preproc,
+    )
+    device.sync()
+    pilot_cost = float(pilot(*repeated_args[0]).results[0])
+    if pilot_cost > threshold:
+        return [pilot_cost]
+    # Step 2. Regular repeats, each checked against the threshold
+    evaluator = rt_mod.time_evaluator(
+        func_name=rt_mod.entry_name,
+        dev=device,
+        number=evaluator_config.number,
+        repeat=1,
+        min_repeat_ms=evaluator_config.min_repeat_ms,
+        f_preproc=f_preproc,
+    )
+    costs: List[float] = []
+    while len(costs) < max_repeats:
+        args = repeated_args[len(costs) % len(repeated_args)]
+        device.sync()
+        costs.append(float(evaluator(*args).results[0]))
+        mean = sum(costs) / len(costs)
+        std = (sum((x - mean) ** 2 for x in costs) / len(costs)) ** 0.5
+        # A 95% lower confidence bound of the mean running time
+        if mean - 1.96 * std / len(costs) ** 0.5 > threshold:
+            break
+        if len(costs) >= num_repeats and (
+            mean > evaluator_config.close_ratio * evaluator_config.best_run_secs
+        ):
+            break
+    return costs
@@ -34,3 +34,4 @@ from .multi_level_tiling import (
 from .parallel_vectorize_unroll import ParallelizeVectorizeUnroll
 from .random_compute_location import RandomComputeLocation
 from .schedule_rule import PyScheduleRule, ScheduleRule
+from .split_k import SplitK
@@ -0,0 +1,59 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Rules which split the long reductions of the GPU reductions with a small output"""
+from typing import List
+
+from tvm._ffi import register_object
+
+from .. import _ffi_api
+from .schedule_rule import ScheduleRule
+
+
+@register_object("meta_schedule.SplitK")
+class SplitK(ScheduleRule):
+    """A schedule rule which splits the reduction of the GPU reductions with a small output and
+    a long reduction, e.g. the matmuls with a few rows at decode time, into partitions computed
+    by different thread blocks. The partial sums of the partitions go to a global workspace of
+    shape ``[num_splits, *output_shape]``, which a second pass reduces into the output. The
+    unsplit reduction stays in the design space.
+
+    Parameters
+    ----------
+    split_factors: List[int]
+        Candidates of the number of partitions of the reduction.
+    thread_extents: List[int]
+        Candidates of thread axis extent of the partial sums.
+    min_reduction_extent: int
+        The minimum cumulative extent of the reduction loops to split.
+    max_spatial_extent: int
+        The maximum cumulative extent of the spatial loops of the blocks to split.
+    """
+
+    def __init__(
+        self,
+        split_factors: List[int] = (2, 4, 8, 16, 32),
+        thread_extents: List[int] = (32, 64, 128, 256),
+        min_reduction_extent: int = 1024,
+        max_spatial_extent: int = 131072,
+    ) -> None:
+        self.__init_handle_by_constructor__(
+            _ffi_api.ScheduleRuleSplitK,  # type: ignore # pylint: disable=no-member
+            list(split_factors),
+            list(thread_extents),
+            min_reduction_extent,
+            max_spatial_extent,
+        )
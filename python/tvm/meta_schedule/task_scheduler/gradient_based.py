@@ -34,6 +34,7 @@ class GradientBased(TaskScheduler):
         alpha: float = 0.2,
         window_size: int = 3,
         seed: int = -1,
+        pipelined: bool = False,
     ) -> None:
         """Constructor.
 
@@ -45,6 +46,9 @@ class GradientBased(TaskScheduler):
             The parameter to control backward window size in gradient computation.
         seed : int = -1
             The random seed.
+        pipelined : bool = False
+            Whether to build the candidates of a task in the background, while the candidates
+            of the next task are generated and the previous ones run.
         """
         self.__init_handle_by_constructor__(
             _ffi_api.TaskSchedulerGradientBased,  # type: ignore # pylint: disable=no-member
@@ -52,4 +56,5 @@ class GradientBased(TaskScheduler):
             alpha,
             window_size,
             seed,
+            pipelined,
         )
@@ -28,9 +28,17 @@ logger = get_logger(__name__)  # pylint: disable=invalid-name
 class RoundRobin(TaskScheduler):
     """Round Robin Task Scheduler"""
 
-    def __init__(self) -> None:
-        """Constructor."""
+    def __init__(self, *, pipelined: bool = False) -> None:
+        """Constructor.
+
+        Parameters
+        ----------
+        pipelined : bool = False
+            Whether to build the candidates of a task in the background, while the candidates
+            of the next task are generated and the previous ones run.
+        """
         self.__init_handle_by_constructor__(
             _ffi_api.TaskSchedulerRoundRobin,  # type: ignore # pylint: disable=no-member
             get_logging_func(logger),
+            pipelined,
         )
@@ -51,6 +51,7 @@ class TaskRecord(Object):
     measure_candidates: List[MeasureCandidate]
     builder_results: List[BuilderResult]
     runner_results: List[RunnerResult]
+    cache_hit_count: int
 
 
 @register_object("meta_schedule.TaskScheduler")
@@ -62,6 +63,7 @@ class TaskScheduler(Object):
     database_: Optional[Database]
     cost_model_: Optional[CostModel]
     remaining_tasks_: int
+    pipelined: bool
 
     TaskSchedulerType = Union["TaskScheduler", Literal["gradient", "round-robin"]]
 
@@ -0,0 +1,384 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Tuning across several pools of measurement devices, e.g. one RPC tracker per device class."""
+import os
+import re
+import threading
+import time
+from typing import Dict, List, Optional
+
+from tvm.ir import IRModule
+from tvm.tir.schedule import Schedule
+
+from .builder import Builder
+from .cost_model import CostModel
+from .database import Database, JSONDatabase, PyDatabase, TuningRecord, UnionDatabase, Workload
+from .logging import get_logger
+from .runner import PyRunner, PyRunnerFuture, Runner, RunnerFuture, RunnerInput, RunnerResult
+from .tune import tune_tasks
+from .tune_context import TuneContext
+from .utils import derived_object
+
+logger = get_logger(__name__)  # pylint: disable=invalid-name
+
+
+class DevicePool:
+    """A pool of measurement devices of the same class, e.g. the devices behind one RPC tracker.
+
+    Parameters
+    ----------
+    name : str
+        The name of the pool, used in the logs.
+    target : Union[Target, str]
+        The target of the devices. A pool only tunes the tasks of the same target.
+    runner : Runner.RunnerType
+        The runner measuring on the devices, e.g. an RPCRunner connected to the tracker.
+    builder : Builder.BuilderType
+        The builder of the pool.
+    cost_model : CostModel.CostModelType
+        The cost model of the pool, kept across the rounds of the pool.
+    """
+
+    def __init__(
+        self,
+        name: str,
+        target,
+        runner: Runner.RunnerType,
+        builder: Builder.BuilderType = "local",
+        cost_model: CostModel.CostModelType = "xgb",
+    ) -> None:
+        self.name = name
+        self.target = str(target)
+        self.runner = runner
+        self.builder = builder
+        self.cost_model = cost_model
+        self.online = True
+        self.num_failures = 0
+        self.num_trials = 0
+        self.measure_secs = 0.0
+
+    @property
+    def throughput(self) -> Optional[float]:
+        """The observed number of trials measured per second, None before the first round."""
+        if self.num_trials == 0 or self.measure_secs <= 0.0:
+            return None
+        return self.num_trials / self.measure_secs
+
+
+@derived_object
+class _LockedDatabase(PyDatabase):
+    """Serializes the accesses of the pools of one device class to their shared database."""
+
+    def __init__(self, database: Database, lock: threading.Lock) -> None:
+        super().__init__()
+        self.database = database
+        self.lock = lock
+
+    def has_workload(self, mod: IRModule) -> bool:
+        with self.lock:
+            return self.database.has_workload(mod)
+
+    def commit_workload(self, mod: IRModule) -> Workload:
+        with self.lock:
+            return self.database.commit_workload(mod)
+
+    def commit_tuning_record(self, record: TuningRecord) -> None:
+        with self.lock:
+            self.database.commit_tuning_record(record)
+
+    def get_top_k(self, workload: Workload, top_k: int) -> List[TuningRecord]:
+        with self.lock:
+            return self.database.get_top_k(workload, top_k)
+
+    def get_all_tuning_records(self) -> List[TuningRecord]:
+        with self.lock:
+            return self.database.get_all_tuning_records()
+
+    def query_tuning_record(
+        self, mod: IRModule, target, workload_name: Optional[str] = None
+    ) -> Optional[TuningRecord]:
+        with self.lock:
+            return self.database.query_tuning_record(mod, target, workload_name)
+
+    def query_schedule(
+        self, mod: IRModule, target, workload_name: Optional[str] = None
+    ) -> Optional[Schedule]:
+        with self.lock:
+            return self.database.query_schedule(mod, target, workload_name)
+
+    def query_ir_module(
+        self, mod: IRModule, target, workload_name: Optional[str] = None
+    ) -> Optional[IRModule]:
+        with self.lock:
+            return self.database.query_ir_module(mod, target, workload_name)
+
+    def __len__(self) -> int:
+        with self.lock:
+            return len(self.database)
+
+
+@derived_object
+class _MonitoredRunnerFuture(PyRunnerFuture):
+    def __init__(self, future: RunnerFuture, monitor: "_MonitoredRunner") -> None:
+        super().__init__()
+        self.future = future
+        self.monitor = monitor
+
+    def done(self) -> bool:
+        return self.future.done()
+
+    def result(self) -> RunnerResult:
+        result = self.future.result()
+        self.monitor.num_results += 1
+        if result.error_msg is not None:
+            self.monitor.num_errors += 1
+        return result
+
+
+@derived_object
+class _MonitoredRunner(PyRunner):
+    """Counts the failed measurements of a pool to detect devices dropping out."""
+
+    def __init__(self, runner: Runner) -> None:
+        super().__init__()
+        self.runner = runner
+        self.num_results = 0
+        self.num_errors = 0
+
+    def run(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
+        return [_MonitoredRunnerFuture(f, self) for f in self.runner.run(runner_inputs)]
+
+
+class _DeviceClass:
+    """The tasks, the remaining trials and the shared database of one target."""
+
+    def __init__(
+        self,
+        target: str,
+        tasks: List[TuneContext],
+        task_weights: List[float],
+        max_trials: int,
+        work_dir: str,
+        module_equality: str,
+    ) -> None:
+        self.target = target
+        self.tasks = tasks
+        self.task_weights = task_weights
+        self.remaining = max_trials
+        self.in_flight = 0
+        self.cond = threading.Condition()
+        self.work_dir = work_dir
+        os.makedirs(work_dir, exist_ok=True)
+        self.database = JSONDatabase(
+            work_dir=work_dir, module_equality=module_equality, concurrent=True
+        )
+        self.db_lock = threading.Lock()
+
+    def acquire(self, num_trials: int) -> int:
+        """Take up to num_trials trials, waiting for the other pools to finish or fail first."""
+        with self.cond:
+            while self.remaining == 0 and self.in_flight > 0:
+                self.cond.wait()
+            num_trials = min(num_trials, self.remaining)
+            self.remaining -= num_trials
+            self.in_flight += num_trials
+            return num_trials
+
+    def finish(self, num_trials: int, succeeded: bool) -> None:
+        """Finish the trials of a round, handing them back if the round failed."""
+        with self.cond:
+            self.in_flight -= num_trials
+            if not succeeded:
+                self.remaining += num_trials
+            self.cond.notify_all()
+
+
+def _round_trials(
+    pool: DevicePool,
+    num_trials_per_iter: int,
+    round_secs: float,
+) -> int:
+    throughput = pool.throughput
+    if throughput is None:
+        return num_trials_per_iter
+    # Faster pools take larger rounds, so that every pool reports back about every round_secs.
+    num_iters = max(int(throughput * round_secs) // num_trials_per_iter, 1)
+    return num_iters * num_trials_per_iter
+
+
+def _tune_pool(
+    pool: DevicePool,
+    device_class: _DeviceClass,
+    *,
+    num_trials_per_iter: int,
+    round_secs: float,
+    max_failures: int,
+    module_equality: str,
+) -> None:
+    num_cores = device_class.tasks[0].num_threads
+    if not isinstance(pool.builder, Builder):
+        pool.builder = Builder.create(pool.builder, max_workers=num_cores)
+    if not isinstance(pool.runner, Runner):
+        pool.runner = Runner.create(pool.runner, max_workers=num_cores)
+    if not isinstance(pool.cost_model, CostModel):
+        pool.cost_model = CostModel.create(
+            pool.cost_model, num_tuning_cores=num_cores, tree_method="auto"
+        )
+    runner = _MonitoredRunner(pool.runner)
+    database = _LockedDatabase(device_class.database, device_class.db_lock)
+    while pool.online:
+        num_trials = device_class.acquire(_round_trials(pool, num_trials_per_iter, round_secs))
+        if num_trials == 0:
+            return
+        num_results, num_errors = runner.num_results, runner.num_errors
+        tic = time.time()
+        try:
+            tune_tasks(
+                tasks=[task.clone() for task in device_class.tasks],
+                task_weights=device_class.task_weights,
+                work_dir=device_class.work_dir,
+                max_trials_global=num_trials,
+                num_trials_per_iter=num_trials_per_iter,
+                builder=pool.builder,
+                runner=runner,
+                database=database,
+                cost_model=pool.cost_model,
+                module_equality=module_equality,
+            )
+        except Exception as error:  # pylint: disable=broad-except
+            logger.warning("Device pool %s failed: %s", pool.name, error)
+            pool.num_failures += 1
+            device_class.finish(num_trials, succeeded=False)
+        else:
+            num_results = runner.num_results - num_results
+            num_errors = runner.num_errors - num_errors
+            if num_results > 0 and num_errors == num_results:
+                # All measurements failed, most likely the devices are unreachable. The trials
+                # are handed back to the other pools of the same device class.
+                logger.warning("Device pool %s failed all %d measurements", pool.name, num_errors)
+                pool.num_failures += 1
+                device_class.finish(num_trials, succeeded=False)
+            else:
+                device_class.finish(num_trials, succeeded=True)
+                pool.num_failures = 0
+                pool.num_trials += num_results - num_errors
+                pool.measure_secs += time.time() - tic
+        if pool.num_failures >= max_failures:
+            logger.warning("Device pool %s is taken offline", pool.name)
+            pool.online = False
+
+
+def tune_distributed(
+    *,
+    tasks: List[TuneContext],
+    task_weights: List[float],
+    pools: List[DevicePool],
+    work_dir: str,
+    max_trials_per_target: int,
+    num_trials_per_iter: int = 64,
+    round_secs: float = 600.0,
+    max_failures: int = 2,
+    module_equality: str = "structural",
+) -> Database:
+    """Tune tasks of several targets on several pools of measurement devices concurrently.
+
+    The tasks are grouped by target and every group is tuned by all the pools of the same target.
+    The pools repeatedly take a round of trials from the budget of their target and share one
+    database per target, so that every round continues from the best records of all the pools.
+    The size of a round is balanced by the observed measurement throughput of the pool. A pool
+    whose rounds keep raising or failing all measurements is taken offline, and its trials are
+    handed back to the other pools.
+
+    Parameters
+    ----------
+    tasks : List[TuneContext]
+        The list of tasks to tune, of one or more targets.
+    task_weights : List[float]
+        The weight of each task.
+    pools : List[DevicePool]
+        The device pools. Every target of the tasks must have at least one pool.
+    work_dir : str
+        The working directory.
+    max_trials_per_target : int
+        The maximum number of trials to run for the tasks of each target.
+    num_trials_per_iter : int
+        The number of trials to run per iteration.
+    round_secs : float
+        The approximate duration of a round of a pool once its throughput is known.
+    max_failures : int
+        The number of consecutive failed rounds after which a pool is taken offline.
+    module_equality : Optional[str]
+        A string to specify the module equality testing and hashing method.
+
+    Returns
+    -------
+    database : Database
+        The union of the databases of all the targets.
+    """
+    if len(tasks) == 0:
+        raise ValueError("No tasks to tune.")
+    if len(tasks) != len(task_weights):
+        raise ValueError(
+            f"Length of tasks ({len(tasks)}) and task_weights ({len(task_weights)}) do not match."
+        )
+    grouped: Dict[str, List[int]] = {}
+    for i, task in enumerate(tasks):
+        grouped.setdefault(str(task.target), []).append(i)
+    device_classes: Dict[str, _DeviceClass] = {}
+    for target, indices in grouped.items():
+        if not any(pool.target == target for pool in pools):
+            raise ValueError(f"No device pool for target: {target}")
+        device_classes[target] = _DeviceClass(
+            target,
+            [tasks[i] for i in indices],
+            [task_weights[i] for i in indices],
+            max_trials_per_target,
+            os.path.join(work_dir, re.sub(r"[^\w\-]+", "_", target).strip("_")),
+            module_equality,
+        )
+
+    threads = []
+    for pool in pools:
+        if pool.target not in device_classes:
+            continue
+        thread = threading.Thread(
+            target=_tune_pool,
+            name=f"tune_distributed:{pool.name}",
+            args=(pool, device_classes[pool.target]),
+            kwargs={
+                "num_trials_per_iter": num_trials_per_iter,
+                "round_secs": round_secs,
+                "max_failures": max_failures,
+                "module_equality": module_equality,
+            },
+        )
+        thread.start()
+        threads.append(thread)
+    for thread in threads:
+        thread.join()
+
+    for device_class in device_classes.values():
+        if device_class.remaining > 0:
+            logger.warning(
+                "All device pools of target %s are offline, %d trials are not run",
+                device_class.target,
+                device_class.remaining,
+            )
+    for pool in pools:
+        if pool.throughput is not None:
+            logger.info("Device pool %s: %.2f trials/s", pool.name, pool.throughput)
+    return UnionDatabase(*[device_class.database for device_class in device_classes.values()])
@@ -114,5 +114,7 @@ from . import utils
 
 # VM
 from .vm_build import build, Executable
+from .aot_build import build_aot
+from .vm_jit import PrimFuncSpecializer, TracingVirtualMachine
 
 from .binding_rewrite import DataflowBlockRewrite
@@ -34,6 +34,7 @@ from .analysis import (
     get_static_type,
     get_var2val,
     has_reshape_pattern,
+    incremental_well_formed,
     name_to_binding,
     post_order_visit,
     remove_all_unused,
@@ -487,6 +487,33 @@ def well_formed(obj: Union[IRModule, Function], check_struct_info: bool = True)
     return _ffi_api.well_formed(obj, check_struct_info)  # type: ignore
 
 
+def incremental_well_formed(check_struct_info: bool = True) -> Callable[[IRModule], bool]:
+    """Create an incremental well-formed checker for the modules of a pass pipeline.
+
+    The checker caches the relax functions found well formed, so that each module only has
+    the functions added or changed since the last check re-checked. The cache is dropped
+    when a GlobalVar of the previous module is removed or changes signature.
+
+    Parameters
+    ----------
+    check_struct_info : bool
+        A boolean flag indicating if the property "every Expr must
+        have defined structure info" will be checked.
+
+    Returns
+    -------
+    check: Callable[[tvm.IRModule], bool]
+        The function checking if a module is well formed.
+
+    Note
+    ----
+    The vars shared between a re-checked function and an unchanged one are not detected,
+    so a full check with :py:func:`well_formed` is still recommended at the end of the
+    pipeline.
+    """
+    return _ffi_api.IncrementalWellFormed(check_struct_info)  # type: ignore
+
+
 def _get_prim_func_default_dtype(func: PrimFunc):
     """Detect default index dtype from function buffer map"""
     for _, v in func.buffer_map.items():
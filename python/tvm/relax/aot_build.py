@@ -0,0 +1,99 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Ahead-of-time build logics, which compile Relax functions to host code without the VM"""
+from typing import Optional, Union
+
+import tvm
+from tvm import relax
+
+from . import _ffi_api
+from .vm_build import _autodetect_system_lib_req
+
+
+def build_aot(
+    mod: tvm.IRModule,
+    target: Optional[Union[str, tvm.target.Target]] = None,
+    pipeline: Union[None, str, tvm.transform.Pass] = "aot_build",
+    *,
+    system_lib: Optional[bool] = None,
+) -> tvm.runtime.Module:
+    """
+    Build an IRModule ahead of time to a library which runs without the VM.
+
+    Each Relax function becomes a function of the library with the same name, which takes the
+    parameters of the Relax function followed by the tensors to write the outputs to, in the
+    order they are returned. Its intermediate tensors live in one arena of static size, the
+    kernels are called directly by symbol and the constants are embedded in the code, so that
+    the library suits microcontroller-class and latency-critical targets.
+
+    The functions must have static shapes and run on the host. The parameters to bind as
+    constants can be bound before, e.g. with relax.transform.BindParams.
+
+    Parameters
+    ----------
+    mod: IRModule
+        The input IRModule to be built.
+
+    target : Optional[Union[str, tvm.target.Target]]
+        A host target, such as "llvm" or "c".
+
+    pipeline : str = "aot_build"
+        The compilation pipeline to use, which has to leave the memory planned by
+        StaticPlanBlockMemory and LowerAllocTensor without the VM specific lowering.
+
+    system_lib: Optional[bool]
+        Whether to build system lib that is being packed statically and
+        auto registers generated functions to the system.
+        By default auto detects based on the target.
+
+    Returns
+    -------
+    lib: tvm.runtime.Module
+        The library of the functions.
+
+    Example
+    -------
+
+    .. code-block:: python
+
+        lib = relax.build_aot(mod, "llvm")
+        out = tvm.nd.empty((3, 4), "float32")
+        lib["main"](x, y, out)
+    """
+    if isinstance(target, str):
+        target = tvm.target.Target(target)
+
+    if pipeline is not None:
+        if isinstance(pipeline, str):
+            pipeline = relax.get_pipeline(pipeline)
+        if target is None:
+            mod = pipeline(mod)
+        else:
+            with target:
+                mod = pipeline(mod)
+
+    attrs = dict(mod.attrs) if mod.attrs else {}
+    ext_libs = attrs.get("external_mods", [])
+    mod = _ffi_api.AOTTIRCodeGen(mod)  # type: ignore
+    lib = tvm.build(
+        mod,
+        target=target,
+        runtime=_autodetect_system_lib_req(target, system_lib),
+    )
+    for ext_mod in ext_libs:
+        lib.import_module(ext_mod)
+    return lib
@@ -21,7 +21,7 @@ from functools import reduce
 from operator import mul
 from typing import Dict
 
-from tvm import DataType, dlight, relax, topi
+from tvm import DataType, dlight, relax, tir, topi
 from tvm.contrib.thrust import can_use_thrust
 from tvm.ir import GlobalVar, Op
 from tvm.ir.module import IRModule
@@ -31,6 +31,12 @@ from tvm.target import Target
 
 from .utils import BackendDispatcher
 
+# The types supported by tvm.contrib.thrust.radix_topk.
+RADIX_TOPK_DTYPES = ("float16", "float32", "float64", "int32", "int64")
+# The topk is dispatched to the radix select when the axis is at least this many times longer
+# than k, below which sorting the whole axis costs about the same.
+RADIX_TOPK_MIN_RATIO = 8
+
 
 @expr_functor.mutator
 class SortScanDispatcher(BackendDispatcher):
@@ -108,7 +114,9 @@ class SortScanDispatcher(BackendDispatcher):
             tgt = self._get_target(call.struct_info)
             te_func = topi.topk
             kwargs = {}
-            if can_use_thrust(tgt, "tvm.contrib.thrust.sort"):
+            if self.can_use_radix_topk(call, tgt):
+                te_func = topi.cuda.radix_topk_thrust
+            elif can_use_thrust(tgt, "tvm.contrib.thrust.sort"):
                 te_func = topi.cuda.topk_thrust
                 kwargs["workspace"] = self.allocate_workspace(call)
             elif self.is_gpu_target(tgt):
@@ -195,6 +203,28 @@ class SortScanDispatcher(BackendDispatcher):
             return tir_call
         return super().visit_call_(call)
 
+    def can_use_radix_topk(self, call: relax.Call, tgt: Target) -> bool:
+        """
+        Whether the topk is selected by a radix select instead of a full thrust sort, which is
+        when k is static and small compared to the static length of the axis.
+        """
+        if not can_use_thrust(tgt, "tvm.contrib.thrust.radix_topk"):
+            return False
+        data_sinfo = call.args[0].struct_info
+        if not isinstance(data_sinfo.shape, relax.ShapeExpr):
+            return False
+        if data_sinfo.dtype not in RADIX_TOPK_DTYPES:
+            return False
+        if call.attrs.dtype not in ("int32", "int64"):
+            return False
+        axis_len = data_sinfo.shape[int(call.attrs.axis)]
+        k = int(call.attrs.k)
+        return (
+            isinstance(axis_len, tir.IntImm)
+            and 0 < k <= topi.cuda.sort.RADIX_TOPK_MAX_K
+            and k * RADIX_TOPK_MIN_RATIO <= axis_len.value
+        )
+
     def estimate_thrust_workspace_size(self, call: relax.Call) -> int:
         """
         Estimate the workspace size for thrust sort/argsort/topk/cumsum
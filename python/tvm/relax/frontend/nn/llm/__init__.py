@@ -16,7 +16,7 @@
 # under the License.
 """LLM support for PyTorch-like API to build IRModules."""
 
-from . import kv_cache, position_embedding
+from . import kv_cache, moe, position_embedding
 from .position_embedding import llama_rope
 from .tree_attn import tree_attn
 from .kv_cache import PagedKVCache
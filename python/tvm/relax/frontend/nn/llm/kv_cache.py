@@ -20,12 +20,12 @@
 # pylint: disable=too-many-statements,too-many-lines,too-many-arguments,invalid-name
 import enum
 import math
-from typing import Any, Dict, Tuple
+from typing import Any, Dict, Optional, Tuple
 
 from tvm import relax as rx
 from tvm import tir
 from tvm.relax.frontend.nn import Object, Tensor
-from tvm.runtime import DataType
+from tvm.runtime import DataType, DataTypeCode
 from tvm.script import tir as T
 from tvm.target import Target
 
@@ -301,6 +301,8 @@ class TIRPagedKVCache(PagedKVCache):  # pylint: disable=too-few-public-methods
         dtype: str,
         target: Target,
         name: str = "paged_kv_cache",
+        kv_dtype: Optional[str] = None,
+        kv_scales: Tuple[float, float] = (1.0, 1.0),
     ) -> None:
         """Create a paged KV cache object with TIR kernels.
 
@@ -347,7 +349,17 @@ class TIRPagedKVCache(PagedKVCache):  # pylint: disable=too-few-public-methods
             Whether to enable disaggregation in the KV cache.
         target : Target
             The target to build the model to.
+        kv_dtype : Optional[str]
+            The storage data type of the KV cache pages, e.g. "int8" or "e4m3_float8".
+            K/V data are quantized when appended and dequantized when loaded by the
+            attention kernels. Defaults to `dtype`, i.e. no quantization.
+        kv_scales : Tuple[float, float]
+            The static per-tensor scales of K and V for the quantized pages.
+            A stored value `x_q` represents `x_q * scale`.
         """
+        if kv_dtype is not None and kv_dtype != dtype and enable_disaggregation:
+            raise ValueError("Disaggregation does not support quantized KV cache pages.")
+        page_dtype = kv_dtype or dtype
 
         bb = rx.BlockBuilder.current()
         args = [
@@ -370,24 +382,26 @@ class TIRPagedKVCache(PagedKVCache):  # pylint: disable=too-few-public-methods
             rx.op.zeros((), dtype),
             # pylint: disable=line-too-long
             # fmt: off
-            bb.add_func(_kv_cache_transpose_append(num_key_value_heads, head_dim, dtype), "kv_cache_transpose_append"),
-            bb.add_func(_attention_prefill(num_key_value_heads, num_attention_heads, head_dim, dtype, False, rope_scaling, target), "tir_attention_prefill"),
-            bb.add_func(_attention_decode(num_key_value_heads, num_attention_heads, head_dim, dtype, False, rope_scaling, target), "tir_attention_decode"),
-            bb.add_func(_attention_prefill(num_key_value_heads, num_attention_heads, head_dim, dtype, True, rope_scaling, target), "tir_attention_prefill_sliding_window"),
-            bb.add_func(_attention_decode(num_key_value_heads, num_attention_heads, head_dim, dtype, True, rope_scaling, target), "tir_attention_decode_sliding_window"),
+            bb.add_func(_kv_cache_transpose_append(num_key_value_heads, head_dim, dtype, page_dtype, kv_scales), "kv_cache_transpose_append"),
+            bb.add_func(_attention_prefill(num_key_value_heads, num_attention_heads, head_dim, dtype, False, rope_scaling, target, page_dtype, kv_scales), "tir_attention_prefill"),
+            bb.add_func(_attention_decode(num_key_value_heads, num_attention_heads, head_dim, dtype, False, rope_scaling, target, page_dtype, kv_scales), "tir_attention_decode"),
+            bb.add_func(_attention_prefill(num_key_value_heads, num_attention_heads, head_dim, dtype, True, rope_scaling, target, page_dtype, kv_scales), "tir_attention_prefill_sliding_window"),
+            bb.add_func(_attention_decode(num_key_value_heads, num_attention_heads, head_dim, dtype, True, rope_scaling, target, page_dtype, kv_scales), "tir_attention_decode_sliding_window"),
             bb.add_func(_attention_prefill_ragged(num_key_value_heads, num_attention_heads, head_dim, dtype, rope_scaling, target), "tir_attention_prefill_ragged"),
             bb.add_func(_merge_state_inplace(num_attention_heads, head_dim, dtype, target), "tir_attention_merge_state"),
             bb.add_func(llama_rope_with_position_map(rope_theta, rope_scale, head_dim, num_attention_heads, num_key_value_heads, dtype, rope_scaling, rotary_dim), "tir_split_rotary"),
-            bb.add_func(_copy_single_page(num_key_value_heads, page_size, head_dim, dtype, target), "kv_cache_copy_single_page"),
-            bb.add_func(_kv_cache_debug_get_kv(num_hidden_layers, num_key_value_heads, head_dim, dtype), "kv_cache_debug_get_kv"),
-            bb.add_func(_compact_kv_copy(num_key_value_heads, head_dim, dtype, target), "kv_cache_compact_kv_copy"),
+            bb.add_func(_copy_single_page(num_key_value_heads, page_size, head_dim, page_dtype, target), "kv_cache_copy_single_page"),
+            bb.add_func(_kv_cache_debug_get_kv(num_hidden_layers, num_key_value_heads, head_dim, dtype, page_dtype, kv_scales), "kv_cache_debug_get_kv"),
+            bb.add_func(_compact_kv_copy(num_key_value_heads, head_dim, page_dtype, target), "kv_cache_compact_kv_copy"),
             bb.add_func(tree_attn(num_key_value_heads, num_attention_heads, head_dim, dtype, rope_scaling, target), "tir_attention_prefill_with_tree_mask"),
-            bb.add_func(tree_attn_with_paged_kv_cache(num_key_value_heads, num_attention_heads, head_dim, dtype, rope_scaling, target), "tir_attention_prefill_with_tree_mask_with_paged_kv_cache"),
+            bb.add_func(tree_attn_with_paged_kv_cache(num_key_value_heads, num_attention_heads, head_dim, dtype, rope_scaling, target, page_dtype, kv_scales), "tir_attention_prefill_with_tree_mask_with_paged_kv_cache"),
             rope_ext_factors,
             rx.PrimValue(enable_disaggregation),
             # fmt: on
             # pylint: enable=line-too-long
         ]
+        if page_dtype != dtype:
+            args.append(rx.op.zeros((), page_dtype))
         super().__init__(
             _expr=rx.call_pure_packed(
                 "vm.builtin.paged_attention_kv_cache_create_reduced",
@@ -402,8 +416,17 @@ class TIRPagedKVCache(PagedKVCache):  # pylint: disable=too-few-public-methods
 # pylint: disable=too-many-locals
 
 
-def _kv_cache_transpose_append(num_key_value_heads, head_dim, dtype):
-    """Return the TIR function that appends new k/v data to PagedKVCache."""
+def _kv_cache_transpose_append(
+    num_key_value_heads,
+    head_dim,
+    dtype,
+    kv_dtype: Optional[str] = None,
+    kv_scales: Tuple[float, float] = (1.0, 1.0),
+):
+    """Return the TIR function that appends new k/v data to PagedKVCache.
+    The k/v data is quantized on append when the page storage dtype `kv_dtype` is given."""
+    kv_dtype = kv_dtype or dtype
+    k_scale, v_scale = kv_scales
 
     # pylint: disable=line-too-long
     # fmt: off
@@ -419,7 +442,7 @@ def _kv_cache_transpose_append(num_key_value_heads, head_dim, dtype):
         num_pages = T.int64()
         pages_elem_offset = T.int64()
         position_map_elem_offset = T.int32()
-        pages = T.match_buffer(var_pages, (num_pages, 2, num_key_value_heads, 16, head_dim), dtype, elem_offset=pages_elem_offset)
+        pages = T.match_buffer(var_pages, (num_pages, 2, num_key_value_heads, 16, head_dim), kv_dtype, elem_offset=pages_elem_offset)
         k_data = T.match_buffer(var_k_data, (ntoken, num_key_value_heads, head_dim), dtype)
         v_data = T.match_buffer(var_v_data, (ntoken, num_key_value_heads, head_dim), dtype)
         position_map = T.match_buffer(
@@ -432,21 +455,30 @@ def _kv_cache_transpose_append(num_key_value_heads, head_dim, dtype):
                     T.reads(position_map[vgpos], k_data[vgpos, vh, vf])
                     T.writes(pages[position_map[vgpos] // 16, 0, vh, position_map[vgpos] % 16, vf])
                     position: T.int32 = position_map[vgpos]  # type: ignore
-                    pages[T.floordiv(position, 16), 0, vh, T.floormod(position, 16), vf] = k_data[vgpos, vh, vf]
+                    pages[T.floordiv(position, 16), 0, vh, T.floormod(position, 16), vf] = _quantize_kv(k_data[vgpos, vh, vf], kv_dtype, k_scale)
                 with T.block("v_transpose_append"):
                     vgpos, vh, vf = T.axis.remap("SSS", [global_pos, h, f])
                     T.reads(position_map[vgpos], v_data[vgpos, vh, vf])
                     T.writes(pages[position_map[vgpos] // 16, 1, vh, position_map[vgpos] % 16, vf])
                     position: T.int32 = position_map[vgpos] # type: ignore[name-defined,no-redef]
-                    pages[T.floordiv(position, 16), 1, vh, T.floormod(position, 16), vf] = v_data[vgpos, vh, vf]
+                    pages[T.floordiv(position, 16), 1, vh, T.floormod(position, 16), vf] = _quantize_kv(v_data[vgpos, vh, vf], kv_dtype, v_scale)
     # fmt: on
     # pylint: enable=line-too-long
 
     return tir_kv_cache_transpose_append
 
 
-def _kv_cache_debug_get_kv(num_hidden_layers, num_key_value_heads, head_dim, dtype):
+def _kv_cache_debug_get_kv(
+    num_hidden_layers,
+    num_key_value_heads,
+    head_dim,
+    dtype,
+    kv_dtype: Optional[str] = None,
+    kv_scales: Tuple[float, float] = (1.0, 1.0),
+):
     """Return the TIR function that fetches the k/v data on given positions and layer."""
+    kv_dtype = kv_dtype or dtype
+    k_scale, v_scale = kv_scales
 
     # pylint: disable=line-too-long
     # fmt: off
@@ -464,7 +496,7 @@ def _kv_cache_debug_get_kv(num_hidden_layers, num_key_value_heads, head_dim, dty
         num_pages = T.int64()
         pages_elem_offset = T.int64()
         position_map_elem_offset = T.int64()
-        pages = T.match_buffer(var_pages, (num_pages, 2, num_key_value_heads, page_size, head_dim), dtype,elem_offset=pages_elem_offset)
+        pages = T.match_buffer(var_pages, (num_pages, 2, num_key_value_heads, page_size, head_dim), kv_dtype, elem_offset=pages_elem_offset)
         position_map = T.match_buffer(
             var_position_map, (seqlen,), "int32", elem_offset=position_map_elem_offset
         )
@@ -476,8 +508,8 @@ def _kv_cache_debug_get_kv(num_hidden_layers, num_key_value_heads, head_dim, dty
                 T.reads(position_map[vp], pages[position_map[vp] // page_size, 0:2, vh, position_map[vp] % page_size, vd])
                 T.writes(k_data[layer_id, vp, vh, vd], v_data[layer_id, vp, vh, vd])
                 position: T.int32 = position_map[vp] # type: ignore[name-defined]
-                k_data[layer_id, vp, vh, vd] = pages[T.floordiv(position, page_size), 0, vh, T.floormod(position, page_size), vd]
-                v_data[layer_id, vp, vh, vd] = pages[T.floordiv(position, page_size), 1, vh, T.floormod(position, page_size), vd]
+                k_data[layer_id, vp, vh, vd] = _dequantize_kv(pages[T.floordiv(position, page_size), 0, vh, T.floormod(position, page_size), vd], dtype, k_scale)
+                v_data[layer_id, vp, vh, vd] = _dequantize_kv(pages[T.floordiv(position, page_size), 1, vh, T.floormod(position, page_size), vd], dtype, v_scale)
     # fmt: on
     # pylint: enable=line-too-long
 
@@ -510,6 +542,30 @@ def _rope(
     return expr
 
 
+def _quantize_kv(value: tir.PrimExpr, kv_dtype: str, kv_scale: float):
+    """Convert the K/V value to the page storage dtype, dividing it by the scale.
+    Values out of the range of the storage dtype are saturated."""
+    if value.dtype == kv_dtype and kv_scale == 1.0:
+        return value
+    scaled = value.astype("float32") * tir.const(1.0 / kv_scale, "float32")
+    if DataType(kv_dtype).type_code == DataTypeCode.INT:
+        bound = float(2 ** (DataType(kv_dtype).bits - 1) - 1)
+        scaled = tir.round(scaled)
+    elif DataType(kv_dtype).type_code == DataTypeCode.E4M3Float:
+        bound = 448.0
+    else:
+        return scaled.astype(kv_dtype)
+    scaled = tir.Max(tir.Min(scaled, tir.const(bound, "float32")), tir.const(-bound, "float32"))
+    return scaled.astype(kv_dtype)
+
+
+def _dequantize_kv(value: tir.PrimExpr, dtype: str, kv_scale: float):
+    """Convert the K/V value loaded from pages back to the model dtype."""
+    if value.dtype == dtype and kv_scale == 1.0:
+        return value
+    return (value.astype("float32") * tir.const(kv_scale, "float32")).astype(dtype)
+
+
 def _var(dtype):
     return T.alloc_buffer((1,), dtype, scope="local")
 
@@ -554,8 +610,18 @@ def _get_seq_offset(pos, seq_id, length_info, sliding_window):
 
 
 def _attention_prefill(
-    h_kv, h_q, d, dtype, sliding_window: bool, rope_scaling: Dict[str, Any], target: Target
+    h_kv,
+    h_q,
+    d,
+    dtype,
+    sliding_window: bool,
+    rope_scaling: Dict[str, Any],
+    target: Target,
+    kv_dtype: Optional[str] = None,
+    kv_scales: Tuple[float, float] = (1.0, 1.0),
 ):
+    kv_dtype = kv_dtype or dtype
+    k_scale, v_scale = kv_scales
     NUM_BLKS = 16
     LOAD_VEC = 8 // ((DataType(dtype).bits + 7) // 8)  # 8 bytes
     group_size = h_q // h_kv
@@ -614,7 +680,7 @@ def _attention_prefill(
 
         q = T.match_buffer(var_q, (total_len, h_q, d), dtype)
         q_indptr = T.match_buffer(var_q_indptr, (batch_size + 1,), "int32", elem_offset=q_indptr_elem_offset)
-        pages = T.match_buffer(var_pages, (max_num_pages, 2, h_kv, 16, d), dtype, elem_offset=pages_elem_offset)
+        pages = T.match_buffer(var_pages, (max_num_pages, 2, h_kv, 16, d), kv_dtype, elem_offset=pages_elem_offset)
         page_indptr = T.match_buffer(var_page_indptr, (batch_size + 1,), "int32", elem_offset=page_indptr_elem_offset)
         page_values = T.match_buffer(var_page_values, (nnz_pages,), "int32", elem_offset=page_values_elem_offset)
         k_rope_pos_offset = T.match_buffer(var_k_rope_pos_offset, (batch_size,), "int32", elem_offset=k_rope_pos_offset_elem_offset)
@@ -737,8 +803,8 @@ def _attention_prefill(
                                                     page_offset: T.int32(is_size_var=True) = T.floormod(seq_offset, 16)  # type: ignore
                                                     K_smem[i, j] = T.if_then_else(
                                                         rotary_mode == 1,
-                                                        _rope(pages, k_rope_pos_offset[b_idx] + cur_L, d, rope_theta, rope_scale, (page_no, 0, by, page_offset, j), dtype, rope_scaling),
-                                                        pages[page_no, 0, by, page_offset, j]
+                                                        _dequantize_kv(_rope(pages, k_rope_pos_offset[b_idx] + cur_L, d, rope_theta, rope_scale, (page_no, 0, by, page_offset, j), dtype, rope_scaling), dtype, k_scale),
+                                                        _dequantize_kv(pages[page_no, 0, by, page_offset, j], dtype, k_scale)
                                                     )
                                                 else:
                                                     K_smem[i, j] = 0.0
@@ -753,7 +819,7 @@ def _attention_prefill(
                                                     seq_offset: T.int32(is_size_var=True) = _get_seq_offset(cur_L, b_idx, length_info, sliding_window)  # type: ignore
                                                     page_no: T.int32(is_size_var=True) = page_values[cur_page_indptr_begin + T.floordiv(seq_offset, 16)]  # type: ignore
                                                     page_offset: T.int32(is_size_var=True) = T.floormod(seq_offset, 16)  # type: ignore
-                                                    V_smem[i, j] = pages[page_no, 1, by, page_offset, j]
+                                                    V_smem[i, j] = _dequantize_kv(pages[page_no, 1, by, page_offset, j], dtype, v_scale)
                                                 else:
                                                     V_smem[i, j] = 0.0
                                         T.tvm_storage_sync("shared")
@@ -928,7 +994,11 @@ def _attention_decode(
     sliding_window: bool,
     rope_scaling: Dict[str, Any],
     target: Target,
+    kv_dtype: Optional[str] = None,
+    kv_scales: Tuple[float, float] = (1.0, 1.0),
 ):
+    kv_dtype = kv_dtype or qkv_dtype
+    k_scale, v_scale = kv_scales
     qkv_dtype_bytes = 2
     H_qo = num_qo_heads
     H_kv = num_kv_heads
@@ -995,7 +1065,7 @@ def _attention_decode(
 
         Q = T.match_buffer(Q_handle, (B, H_qo, D), qkv_dtype)
         pages = T.match_buffer(
-            pages_handle, (max_num_pages, 2, H_kv, 16, D), qkv_dtype, elem_offset=pages_elem_offset
+            pages_handle, (max_num_pages, 2, H_kv, 16, D), kv_dtype, elem_offset=pages_elem_offset
         )
         page_table_indptr = T.match_buffer(page_table_indptr_handle, (B + 1,), "int32", elem_offset=page_indptr_elem_offset)
         page_table_values = T.match_buffer(page_table_values_handle, (nnz_pages,), "int32", elem_offset=page_values_elem_offset)
@@ -1085,10 +1155,10 @@ def _attention_decode(
                                                 for vec in T.vectorized(VEC_SIZE):
                                                     K_smem[tile_start_s + j, tx * VEC_SIZE + vec] = T.if_then_else(
                                                         rotary_mode == 1,
-                                                        _rope(pages, k_rope_pos_offset[batch_idx] + row_g, head_dim, rope_theta, rope_scale, (page_no, 0, by, page_offset, tx * VEC_SIZE + vec), qkv_dtype, rope_scaling),
-                                                        pages[page_no, 0, by, page_offset, tx * VEC_SIZE + vec]
+                                                        _dequantize_kv(_rope(pages, k_rope_pos_offset[batch_idx] + row_g, head_dim, rope_theta, rope_scale, (page_no, 0, by, page_offset, tx * VEC_SIZE + vec), qkv_dtype, rope_scaling), qkv_dtype, k_scale),
+                                                        _dequantize_kv(pages[page_no, 0, by, page_offset, tx * VEC_SIZE + vec], qkv_dtype, k_scale)
                                                     )
-                                                    V_smem[tile_start_s + j, tx * VEC_SIZE + vec] = pages[page_no, 1, by, page_offset, tx * VEC_SIZE + vec]
+                                                    V_smem[tile_start_s + j, tx * VEC_SIZE + vec] = _dequantize_kv(pages[page_no, 1, by, page_offset, tx * VEC_SIZE + vec], qkv_dtype, v_scale)
                                             else:
                                                 for vec in T.vectorized(VEC_SIZE):
                                                     K_smem[tile_start_s + j, tx * VEC_SIZE + vec] = 0.0
@@ -0,0 +1,312 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+
+"""Operators for the expert-parallel dispatch and combine of mixture-of-experts.
+
+The experts are sharded over the workers, so that worker `i` holds the experts
+`[i * num_local_experts, (i + 1) * num_local_experts)`.  Every expert takes at most
+`capacity` tokens from each worker, which keeps all the shapes static:
+
+    slots = moe_dispatch_slots(expert_indices, num_experts, capacity)
+    x = moe_dispatch(x, expert_indices, slots, num_experts, capacity)  # (E, C, H)
+    x = moe_exchange_dispatch(x, num_workers)                          # (E_l, W * C, H)
+    y = moe_expert_gemm(x, weight)                                     # (E_l, W * C, N)
+    y = moe_exchange_combine(y, num_workers)                           # (E, C, N)
+    y = moe_combine(y, expert_indices, expert_weights, slots)          # (T, N)
+
+The tokens beyond the capacity of an expert are dropped for that expert, and contribute
+nothing to the output.
+"""
+
+from tvm import te, tir
+from tvm.script import tir as T
+
+from .. import op
+from ..core import Tensor
+
+# mypy: disable-error-code="attr-defined,valid-type,no-redef"
+# pylint: disable=too-many-arguments,too-many-locals
+
+_CUTLASS_WORKSPACE_BYTES = 4 * 1024 * 1024
+
+
+def moe_dispatch_slots(expert_indices: Tensor, num_experts: int, capacity: int) -> Tensor:
+    """Assign each (token, choice) the slot in the buffer of its expert.
+
+    The slots are taken by the first choices of all the tokens before the second ones, and
+    by the tokens in order within the same choice, so that a token is only dropped for its
+    primary expert after the other choices of the experts are dropped.
+
+    Parameters
+    ----------
+    expert_indices : Tensor
+        The experts chosen by each token, of shape (num_tokens, top_k) and dtype int32.
+
+    num_experts : int
+        The total number of experts.
+
+    capacity : int
+        The number of tokens each expert takes from this worker.
+
+    Returns
+    -------
+    slots : Tensor
+        The slot of each (token, choice) in the buffer of its expert, or -1 if dropped,
+        of shape (num_tokens, top_k) and dtype int32.
+    """
+    num_tokens, top_k = expert_indices.shape
+    # Flattened with the choices as the major axis, giving the first choices priority.
+    flat_indices = op.reshape(op.permute_dims(expert_indices, [1, 0]), [top_k * num_tokens])
+    one_hot = op.tensor_expr_op(
+        lambda indices: te.compute(
+            (indices.shape[0], num_experts),
+            lambda i, e: (indices[i] == e).astype("int32"),
+            name="one_hot",
+        ),
+        "moe_one_hot",
+        [flat_indices],
+    )
+    positions = op.cumsum(one_hot, axis=0, exclusive=True)
+
+    def _slots(positions: te.Tensor, indices: te.Tensor):
+        num_tokens = indices.shape[0]
+        return te.compute(
+            indices.shape,
+            lambda t, k: tir.Select(
+                positions[k * num_tokens + t, indices[t, k]] < capacity,
+                positions[k * num_tokens + t, indices[t, k]],
+                tir.IntImm("int32", -1),
+            ),
+            name="slots",
+        )
+
+    return op.tensor_expr_op(_slots, "moe_dispatch_slots", [positions, expert_indices])
+
+
+def _scatter_tokens(num_experts: int, capacity: int, top_k: int):
+    @T.prim_func(private=True)
+    def scatter_tokens(var_indices: T.handle, var_slots: T.handle, var_tokens: T.handle):
+        T.func_attr({"tir.noalias": T.bool(True)})
+        num_tokens = T.int64()
+        indices = T.match_buffer(var_indices, (num_tokens, top_k), "int32")
+        slots = T.match_buffer(var_slots, (num_tokens, top_k), "int32")
+        tokens = T.match_buffer(var_tokens, (num_experts, capacity), "int32")
+        for e, c in T.grid(num_experts, capacity):
+            with T.block("init"):
+                ve, vc = T.axis.remap("SS", [e, c])
+                tokens[ve, vc] = -1
+        # The slots of an expert are distinct, so the tokens never write to the same place.
+        for t, k in T.grid(num_tokens, top_k):
+            with T.block("scatter"):
+                vt, vk = T.axis.remap("SS", [t, k])
+                if slots[vt, vk] >= 0:
+                    tokens[indices[vt, vk], slots[vt, vk]] = T.Cast("int32", vt)
+
+    return scatter_tokens
+
+
+def moe_dispatch(
+    x: Tensor, expert_indices: Tensor, slots: Tensor, num_experts: int, capacity: int
+) -> Tensor:
+    """Permute the tokens into the buffers of their experts.
+
+    Parameters
+    ----------
+    x : Tensor
+        The tokens, of shape (num_tokens, hidden_size).
+
+    expert_indices : Tensor
+        The experts chosen by each token, of shape (num_tokens, top_k) and dtype int32.
+
+    slots : Tensor
+        The slots given by `moe_dispatch_slots`.
+
+    num_experts : int
+        The total number of experts.
+
+    capacity : int
+        The number of tokens each expert takes from this worker.
+
+    Returns
+    -------
+    dispatched : Tensor
+        The buffers of the experts, of shape (num_experts, capacity, hidden_size), where the
+        empty slots are zeros.
+    """
+    top_k = expert_indices.shape[1]
+    tokens = op.tensor_ir_op(
+        _scatter_tokens(num_experts, capacity, top_k),
+        "moe_scatter_tokens",
+        [expert_indices, slots],
+        out=Tensor.placeholder((num_experts, capacity), "int32"),
+    )
+
+    def _gather(x: te.Tensor, tokens: te.Tensor):
+        return te.compute(
+            (num_experts, capacity, x.shape[1]),
+            lambda e, c, h: tir.if_then_else(
+                tokens[e, c] >= 0, x[tokens[e, c], h], tir.const(0, x.dtype)
+            ),
+            name="dispatch",
+        )
+
+    return op.tensor_expr_op(_gather, "moe_dispatch", [x, tokens])
+
+
+def moe_exchange_dispatch(dispatched: Tensor, num_workers: int) -> Tensor:
+    """Send the buffers of the experts to the workers holding them.
+
+    Parameters
+    ----------
+    dispatched : Tensor
+        The buffers of all the experts, of shape (num_experts, capacity, hidden_size).
+
+    num_workers : int
+        The number of workers in the group the experts are sharded over.
+
+    Returns
+    -------
+    received : Tensor
+        The tokens of every worker for the local experts, of shape
+        (num_local_experts, num_workers * capacity, hidden_size).
+    """
+    num_experts, capacity, hidden_size = dispatched.shape
+    num_local_experts = num_experts // num_workers
+    received = op.ccl_alltoall(dispatched, num_workers)
+    received = op.reshape(received, [num_workers, num_local_experts, capacity, hidden_size])
+    received = op.permute_dims(received, [1, 0, 2, 3])
+    return op.reshape(received, [num_local_experts, num_workers * capacity, hidden_size])
+
+
+def moe_exchange_combine(results: Tensor, num_workers: int) -> Tensor:
+    """Send the results of the local experts back to the workers the tokens come from,
+    which is the inverse of `moe_exchange_dispatch`.
+
+    Parameters
+    ----------
+    results : Tensor
+        The results of the local experts, of shape
+        (num_local_experts, num_workers * capacity, hidden_size).
+
+    num_workers : int
+        The number of workers in the group the experts are sharded over.
+
+    Returns
+    -------
+    combined : Tensor
+        The results of all the experts for the tokens of this worker, of shape
+        (num_experts, capacity, hidden_size).
+    """
+    num_local_experts, num_rows, hidden_size = results.shape
+    capacity = num_rows // num_workers
+    results = op.reshape(results, [num_local_experts, num_workers, capacity, hidden_size])
+    results = op.permute_dims(results, [1, 0, 2, 3])
+    results = op.reshape(results, [num_workers * num_local_experts, capacity, hidden_size])
+    return op.ccl_alltoall(results, num_workers)
+
+
+def moe_expert_gemm(x: Tensor, weight: Tensor, use_cutlass: bool = False) -> Tensor:
+    """Run the local experts on their tokens, i.e. `x[e] @ weight[e].T` for every expert.
+
+    Parameters
+    ----------
+    x : Tensor
+        The tokens of the local experts, of shape (num_local_experts, num_rows, in_features).
+
+    weight : Tensor
+        The weights of the local experts, of shape
+        (num_local_experts, out_features, in_features).
+
+    use_cutlass : bool
+        Whether to use the grouped GEMM of CUTLASS, which requires fp16 and SM90.
+
+    Returns
+    -------
+    result : Tensor
+        The result, of shape (num_local_experts, num_rows, out_features).
+    """
+    num_local_experts, num_rows, in_features = x.shape
+    out_features = weight.shape[1]
+    if not use_cutlass:
+        return op.matmul(x, op.permute_dims(weight, [0, 2, 1]))
+
+    # Every expert has the same number of rows as the capacity is fixed.
+    indptr = op.tensor_expr_op(
+        lambda x: te.compute(
+            (num_local_experts,),
+            lambda e: ((e + 1) * x.shape[1]).astype("int64"),
+            name="indptr",
+        ),
+        "moe_expert_indptr",
+        [x],
+    )
+    workspace = op.empty((_CUTLASS_WORKSPACE_BYTES,), "uint8")
+    result = op.extern(
+        "cutlass.group_gemm_fp16_sm90",
+        [op.reshape(x, [num_local_experts * num_rows, in_features]), weight, indptr, workspace],
+        out=Tensor.placeholder((num_local_experts * num_rows, out_features), x.dtype),
+    )
+    return op.reshape(result, [num_local_experts, num_rows, out_features])
+
+
+def moe_combine(
+    results: Tensor, expert_indices: Tensor, expert_weights: Tensor, slots: Tensor
+) -> Tensor:
+    """Reduce the results of the experts chosen by each token, weighted by the router.
+
+    Parameters
+    ----------
+    results : Tensor
+        The results of all the experts, of shape (num_experts, capacity, hidden_size).
+
+    expert_indices : Tensor
+        The experts chosen by each token, of shape (num_tokens, top_k) and dtype int32.
+
+    expert_weights : Tensor
+        The weights of the chosen experts, of shape (num_tokens, top_k).
+
+    slots : Tensor
+        The slots given by `moe_dispatch_slots`.
+
+    Returns
+    -------
+    result : Tensor
+        The combined tokens, of shape (num_tokens, hidden_size).
+    """
+
+    def _combine(results: te.Tensor, indices: te.Tensor, weights: te.Tensor, slots: te.Tensor):
+        num_tokens, top_k = indices.shape
+        k = te.reduce_axis((0, top_k), name="k")
+        accum = te.compute(
+            (num_tokens, results.shape[2]),
+            lambda t, h: te.sum(
+                tir.if_then_else(
+                    slots[t, k] >= 0,
+                    weights[t, k].astype("float32")
+                    * results[indices[t, k], slots[t, k], h].astype("float32"),
+                    tir.const(0, "float32"),
+                ),
+                axis=k,
+            ),
+            name="combine_accum",
+        )
+        return te.compute(accum.shape, lambda t, h: accum[t, h].astype(results.dtype), "combine")
+
+    return op.tensor_expr_op(
+        _combine, "moe_combine", [results, expert_indices, expert_weights, slots]
+    )
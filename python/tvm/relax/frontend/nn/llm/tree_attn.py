@@ -19,7 +19,7 @@
 """Operators for tree attention."""
 
 import math
-from typing import Any, Dict, Tuple
+from typing import Any, Dict, Optional, Tuple
 
 from tvm import tir
 from tvm.runtime import DataType
@@ -438,7 +438,14 @@ def tree_attn(
 
 
 def tree_attn_with_paged_kv_cache(
-    h_kv, h_q, d, dtype, rope_scaling: Dict[str, Any], target: Target
+    h_kv,
+    h_q,
+    d,
+    dtype,
+    rope_scaling: Dict[str, Any],
+    target: Target,
+    kv_dtype: Optional[str] = None,
+    kv_scales: Tuple[float, float] = (1.0, 1.0),
 ):
     """Generate tree attention kernel for batched tree attention with paged key-value cache.
 
@@ -454,6 +461,10 @@ def tree_attn_with_paged_kv_cache(
         Data type.
     target : Target
         The target device.
+    kv_dtype : Optional[str]
+        The storage data type of the pages. Defaults to `dtype`.
+    kv_scales : Tuple[float, float]
+        The dequantization scales of K and V when the pages are quantized.
 
     Returns
     -------
@@ -463,11 +474,15 @@ def tree_attn_with_paged_kv_cache(
     # pylint: disable=import-outside-toplevel
     from .kv_cache import (
         _declare_length_info,
+        _dequantize_kv,
         _get_kv_chunk_len,
         _get_seq_offset,
         check_thread_limits,
     )
 
+    kv_dtype = kv_dtype or dtype
+    k_scale, v_scale = kv_scales
+
     # pylint: disable=invalid-name, line-too-long
     NUM_BLKS = 16
     LOAD_VEC = 8 // ((DataType(dtype).bits + 7) // 8)  # 8 bytes
@@ -530,7 +545,7 @@ def tree_attn_with_paged_kv_cache(
         q_indptr = T.match_buffer(
             var_q_indptr, (batch_size + 1,), "int32", elem_offset=q_indptr_elem_offset
         )
-        pages = T.match_buffer(var_pages, (max_num_pages, 2, h_kv, 16, d), dtype)
+        pages = T.match_buffer(var_pages, (max_num_pages, 2, h_kv, 16, d), kv_dtype)
         page_indptr = T.match_buffer(
             var_page_indptr, (batch_size + 1,), "int32", elem_offset=page_indptr_elem_offset
         )
@@ -703,9 +718,9 @@ def tree_attn_with_paged_kv_cache(
                                                     seq_offset: T.int32(is_size_var=True) = _get_seq_offset(cur_L, b_idx, length_info, sliding_window)  # type: ignore
                                                     page_no: T.int32(is_size_var=True) = page_values[cur_page_indptr_begin + T.floordiv(seq_offset, 16)]  # type: ignore
                                                     page_offset: T.int32(is_size_var=True) = T.floormod(seq_offset, 16)  # type: ignore
-                                                    K_smem[i, j] = pages[
-                                                        page_no, 0, by, page_offset, j
-                                                    ]
+                                                    K_smem[i, j] = _dequantize_kv(
+                                                        pages[page_no, 0, by, page_offset, j], dtype, k_scale
+                                                    )
                                                 else:
                                                     K_smem[i, j] = 0.0
 
@@ -720,9 +735,9 @@ def tree_attn_with_paged_kv_cache(
                                                     seq_offset: T.int32(is_size_var=True) = _get_seq_offset(cur_L, b_idx, length_info, sliding_window)  # type: ignore
                                                     page_no: T.int32(is_size_var=True) = page_values[cur_page_indptr_begin + T.floordiv(seq_offset, 16)]  # type: ignore
                                                     page_offset: T.int32(is_size_var=True) = T.floormod(seq_offset, 16)  # type: ignore
-                                                    V_smem[i, j] = pages[
-                                                        page_no, 1, by, page_offset, j
-                                                    ]
+                                                    V_smem[i, j] = _dequantize_kv(
+                                                        pages[page_no, 1, by, page_offset, j], dtype, v_scale
+                                                    )
                                                 else:
                                                     V_smem[i, j] = 0.0
                                         T.tvm_storage_sync("shared")
@@ -1741,6 +1741,31 @@ def ccl_allgather(x: Tensor, num_workers: int, name="ccl_allgather"):
     return wrap_nested(_op.ccl.allgather(x._expr, num_workers), name)
 
 
+def ccl_alltoall(x: Tensor, num_workers: int, in_group: bool = True, name="ccl_alltoall"):
+    """CCL AllToAll operator, which exchanges chunk `i` of the first axis with worker `i`.
+
+    Parameters
+    ----------
+    x : Tensor
+      The input tensor, whose first axis is divisible by the number of workers.
+
+    num_workers : int
+      Number of workers.
+
+    in_group : bool
+      Whether the alltoall operation performs globally or in group as default.
+
+    name : str
+        Name hint for this operation.
+
+    Returns
+    -------
+    result : Tensor
+      The result tensor of alltoall.
+    """
+    return wrap_nested(_op.ccl.alltoall(x._expr, num_workers, in_group), name)
+
+
 def ccl_broadcast_from_worker0(x: Tensor, name="broadcast_from_worker"):
     """Broadcast data from worker-0 to all other workers.
 
@@ -36,12 +36,27 @@ class WellFormedInstrument:
         If True (default), perform a well-formed check before running
         a transform.  If False, only perform the well-formed check
         after running a transform.
+
+    incremental: bool
+
+        If True, only re-check the functions a pass changed, as told by
+        their identity, instead of the whole module. The vars shared
+        between a changed function and an unchanged one are then not
+        detected.
     """
 
-    def __init__(self, check_struct_info: bool = True, validate_before_transform: bool = True):
+    def __init__(
+        self,
+        check_struct_info: bool = True,
+        validate_before_transform: bool = True,
+        incremental: bool = False,
+    ):
         self.skip_pass_name = ["Normalize", "NormalizeGlobalVar", "ResolveGlobals"]
         self.check_struct_info = check_struct_info
         self.validate_before_transform = validate_before_transform
+        self._checker = (
+            relax.analysis.incremental_well_formed(check_struct_info) if incremental else None
+        )
 
     def run_before_pass(self, mod, pass_info):
         if self.validate_before_transform:
@@ -52,7 +67,10 @@ class WellFormedInstrument:
 
     def _check(self, mod, pass_name, name_prefix):
         if pass_name not in self.skip_pass_name:
-            is_well_formed = relax.analysis.well_formed(mod, self.check_struct_info)
+            if self._checker is not None:
+                is_well_formed = self._checker(mod)
+            else:
+                is_well_formed = relax.analysis.well_formed(mod, self.check_struct_info)
             if not is_well_formed:
                 mod.show(name=f"{name_prefix}{pass_name}")
             assert is_well_formed
@@ -83,7 +83,7 @@ from .create import (
 )
 from .datatype import astype, wrap_param
 from .index import dynamic_strided_slice, strided_slice, take
-from .linear_algebra import einsum, linear, matmul
+from .linear_algebra import bsr_matmul, einsum, linear, matmul, structured_sparse_matmul
 from .manipulate import (
     broadcast_to,
     collapse_sum_like,
@@ -15,4 +15,4 @@
 # specific language governing permissions and limitations
 # under the License.
 """CCL related operators."""
-from .ccl import allgather, allreduce, broadcast_from_worker0, scatter_from_worker0
+from .ccl import allgather, allreduce, alltoall, broadcast_from_worker0, scatter_from_worker0
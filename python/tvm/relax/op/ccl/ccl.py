@@ -70,6 +70,30 @@ def allgather(x, num_workers: int, in_group: bool = True):  # pylint: disable=in
     return _ffi_api.allgather(x, num_workers, in_group)  # type: ignore # pylint: disable=no-member
 
 
+def alltoall(x, num_workers: int, in_group: bool = True):  # pylint: disable=invalid-name
+    """AllToAll operator, which splits the first axis of the input evenly into one chunk per
+    worker, sends chunk `i` to worker `i`, and places the chunk received from worker `j` at
+    chunk `j` of the result.
+
+    Parameters
+    ----------
+    x : relax.Expr
+      The input tensor.
+
+    num_worker : int
+      The number of workers to exchange data with.
+
+    in_group : bool
+      Whether the alltoall operation performs globally or in group as default.
+
+    Returns
+    -------
+    result : relax.Expr
+      The result of alltoall, of the same shape as the input.
+    """
+    return _ffi_api.alltoall(x, num_workers, in_group)  # type: ignore # pylint: disable=no-member
+
+
 def broadcast_from_worker0(x: Expr) -> Expr:
     """Broadcast data from worker-0 to all other workers.
 
@@ -21,4 +21,5 @@ from .distributed import (
     redistribute,
     call_tir_local_view,
     redistribute_replica_to_shard,
+    ring_attention,
 )
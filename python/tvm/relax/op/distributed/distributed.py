@@ -21,6 +21,7 @@ from typing import Union, List, Tuple, Optional
 
 from tvm.relax.distributed.struct_info import DeviceMesh, Placement
 from tvm.ir import PrimExpr
+from tvm.tir import FloatImm
 from tvm.relax.utils import args_converter
 from tvm.relax.distributed import DTensorStructInfo
 from ...expr import Tuple as RxTuple
@@ -136,3 +137,45 @@ def redistribute_replica_to_shard(input: Expr, num_workers: int, axis: int) -> E
       Sliced Tensor kept by each device.
     """
     return _ffi_api.redistribute_replica_to_shard(input, num_workers, axis)
+
+
+def ring_attention(
+    query: Expr,
+    key: Expr,
+    value: Expr,
+    scale: Optional[FloatImm] = None,
+    causal_mask: Optional[str] = None,
+    window_size: Optional[int] = None,
+) -> Expr:
+    """Attention whose key and value are sharded along the sequence, which is computed blockwise
+    while the blocks go around the workers in a ring. It is produced by PropagateSharding from
+    relax.nn.attention, and expanded by LowerDistIR.
+
+    Parameters
+    ----------
+    query : relax.Expr
+      The query, of shape (batch_size, seq_len, num_heads, head_dim).
+
+    key : relax.Expr
+      The key, of shape (batch_size, seq_len_kv, num_heads_kv, head_dim).
+
+    value : relax.Expr
+      The value, of shape (batch_size, seq_len_kv, num_heads_kv, head_dim_v).
+
+    scale : Optional[FloatImm]
+      The scale applied before the softmax, which is 1 / sqrt(head_dim) by default.
+
+    causal_mask : Optional[str]
+      The type of the causal mask, which is not supported yet.
+
+    window_size : Optional[int]
+      The size of the sliding window, which is not supported yet.
+
+    Returns
+    -------
+    result : relax.Expr
+      The result, of shape (batch_size, seq_len, num_heads, head_dim_v).
+    """
+    return _ffi_api.ring_attention(  # type: ignore
+        query, key, value, scale, causal_mask, window_size
+    )
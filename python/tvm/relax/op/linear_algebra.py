@@ -90,6 +90,55 @@ def linear(
     return x + bias if bias is not None else x
 
 
+def bsr_matmul(x: Expr, data: Expr, indices: Expr, indptr: Expr) -> Expr:
+    """Multiply a dense tensor by the transpose of a sparse weight W in the block compressed
+    sparse row (BSR) format, i.e. x @ W^T.
+
+    Parameters
+    ----------
+    x : relax.Expr
+        The dense input of shape (m, k).
+
+    data : relax.Expr
+        The nonzero blocks of W, of shape (nnz_blocks, block_rows, block_cols).
+
+    indices : relax.Expr
+        The block column of each nonzero block, of shape (nnz_blocks,).
+
+    indptr : relax.Expr
+        The offset of the blocks of each block row in data, of shape (n / block_rows + 1,).
+
+    Returns
+    -------
+    result : relax.Expr
+        The computed result, of shape (m, n).
+    """
+    return _ffi_api.bsr_matmul(x, data, indices, indptr)  # type: ignore
+
+
+def structured_sparse_matmul(x: Expr, values: Expr, indices: Expr) -> Expr:
+    """Multiply a dense tensor by the transpose of a 2:4 structured sparse weight W, in which
+    each group of 4 consecutive elements of a row has at most 2 nonzero elements.
+
+    Parameters
+    ----------
+    x : relax.Expr
+        The dense input of shape (..., k).
+
+    values : relax.Expr
+        The 2 kept elements of each group of W, of shape (n, k / 2).
+
+    indices : relax.Expr
+        The position of each kept element in its group of 4, of shape (n, k / 2).
+
+    Returns
+    -------
+    result : relax.Expr
+        The computed result, of shape (..., n).
+    """
+    return _ffi_api.structured_sparse_matmul(x, values, indices)  # type: ignore
+
+
 def einsum(operands, subscripts):
     """Evaluates the Einstein summation convention on data
 
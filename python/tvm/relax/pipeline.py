@@ -105,6 +105,31 @@ def default_build_pipeline():
     return _pipeline
 
 
+def aot_build_pipeline():
+    """The compilation pipeline used in relax.build_aot, which stops before the VM lowering"""
+
+    @tvm.transform.module_pass(opt_level=0)
+    def _pipeline(mod: tvm.ir.IRModule, _ctx: tvm.transform.PassContext) -> tvm.ir.IRModule:
+        seq = tvm.transform.Sequential(
+            [
+                backend.DispatchSampling(),
+                backend.DispatchSortScan(),
+                transform.LegalizeOps(),
+                transform.RewriteDataflowReshape(),
+                transform.ToNonDataflow(),
+                transform.RemovePurityChecking(),
+                transform.CallTIRRewrite(),
+                transform.StaticPlanBlockMemory(),
+                transform.LowerAllocTensor(),
+                transform.AttachGlobalSymbol(),
+            ],
+        )
+        mod = seq(mod)
+        return mod
+
+    return _pipeline
+
+
 def static_shape_tuning_pipeline(
     total_trials: int,
     target: Union[str, tvm.target.Target],
@@ -194,6 +219,7 @@ def static_shape_tuning_pipeline(
 PIPELINE_MAP = {
     "zero": zero_pipeline,
     "default_build": default_build_pipeline,
+    "aot_build": aot_build_pipeline,
     "static_shape_tuning": static_shape_tuning_pipeline,
 }
 
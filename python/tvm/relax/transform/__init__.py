@@ -20,6 +20,7 @@ from .transform import (
     AdjustMatmulOrder,
     AllocateWorkspace,
     AlterOpImpl,
+    AnnotateCheckpoints,
     AnnotateTIROpPattern,
     AttachAttrLayoutFreeBuffers,
     AttachGlobalSymbol,
@@ -31,6 +32,7 @@ from .transform import (
     CombineParallelMatmul,
     ComputePrimValue,
     ConvertLayout,
+    ConvertLayoutByCost,
     ConvertToDataflow,
     DataflowBlockPass,
     DataflowUseInplaceCalls,
@@ -56,6 +58,7 @@ from .transform import (
     LegalizeOps,
     LiftTransformParams,
     LowerAllocTensor,
+    LowerBatchedLoRAMatmul,
     LowerRuntimeBuiltin,
     MergeCompositeFunctions,
     MetaScheduleApplyDatabase,
@@ -63,7 +66,10 @@ from .transform import (
     MetaScheduleTuneTIR,
     Normalize,
     NormalizeGlobalVar,
+    OverlapCollectives,
     PatternCheckContext,
+    PersistL2Params,
+    PlaceVDeviceByCost,
     RealizeVDevice,
     RemovePurityChecking,
     RemoveUnusedOutputs,
@@ -76,6 +82,7 @@ from .transform import (
     SplitCallTIRByPattern,
     SplitLayoutRewritePreproc,
     StaticPlanBlockMemory,
+    StreamParams,
     ToMixedPrecision,
     ToNonDataflow,
     TopologicalSort,
@@ -95,6 +102,7 @@ from .lazy_transform_params import LazyTransformParams
 from .lower_gpu_ipc_alloc_storage import LowerGPUIPCAllocStorage
 from .optimize_layout_transform import OptimizeLayoutTransform
 from .remove_redundant_reshape import RemoveRedundantReshape
+from .sparsify_matmul import SparsifyMatmul
 
 # Import to register the legalization functions.
 from . import legalize_ops, tuning_api
@@ -71,6 +71,15 @@ def _allgather(_bb: BlockBuilder, call: Call) -> Expr:
     )
 
 
+@register_legalize("relax.ccl.alltoall")
+def _alltoall(_bb: BlockBuilder, call: Call) -> Expr:
+    return call_dps_packed(
+        "runtime.disco.alltoall",
+        [call.args[0], call.attrs.in_group],
+        out_sinfo=call.args[0].struct_info,
+    )
+
+
 @register_legalize("relax.ccl.broadcast_from_worker0")
 def _broadcast_from_worker0(_bb: BlockBuilder, call: Call) -> Expr:
     return call_dps_packed(
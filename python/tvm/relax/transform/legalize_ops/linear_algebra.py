@@ -100,6 +100,64 @@ def _matmul(bb: BlockBuilder, call: Call) -> Expr:
     return bb.call_te(te_matmul, call.args[0], call.args[1], primfunc_name_hint="matmul")
 
 
+@register_legalize("relax.bsr_matmul")
+def _bsr_matmul(bb: BlockBuilder, call: Call) -> Expr:
+    # The number of blocks of a row depends on indptr, so the kernel is written as an extern
+    # op instead of te.compute, whose reductions need a static extent.
+    def te_bsr_matmul(
+        x: te.Tensor, data: te.Tensor, indices: te.Tensor, indptr: te.Tensor
+    ) -> te.Tensor:
+        m = x.shape[0]
+        _, block_rows, block_cols = data.shape
+        num_block_rows = indptr.shape[0] - 1
+
+        def gen_ir(ins, outs):
+            ib = tir.ir_builder.create()
+            x_ptr, data_ptr, indices_ptr, indptr_ptr = [ib.buffer_ptr(buf) for buf in ins]
+            out_ptr = ib.buffer_ptr(outs[0])
+            with ib.for_range(0, m, name="i") as i:
+                with ib.for_range(0, num_block_rows, name="nb") as nb:
+                    with ib.for_range(0, block_rows, name="r") as r:
+                        acc = ib.allocate(x.dtype, (1,), name="acc", scope="local")
+                        acc[0] = tir.const(0, x.dtype)
+                        with ib.for_range(indptr_ptr[nb], indptr_ptr[nb + 1], name="e") as e:
+                            with ib.for_range(0, block_cols, name="c") as c:
+                                col = indices_ptr[e] * block_cols + c
+                                acc[0] += data_ptr[e, r, c] * x_ptr[i, col]
+                        out_ptr[i, nb * block_rows + r] = acc[0]
+            return ib.get()
+
+        return te.extern(
+            [(m, num_block_rows * block_rows)],
+            [x, data, indices, indptr],
+            gen_ir,
+            dtype=x.dtype,
+            name="bsr_matmul",
+        )
+
+    return bb.call_te(te_bsr_matmul, *call.args, primfunc_name_hint="bsr_matmul")
+
+
+@register_legalize("relax.structured_sparse_matmul")
+def _structured_sparse_matmul(bb: BlockBuilder, call: Call) -> Expr:
+    def te_structured_sparse_matmul(
+        x: te.Tensor, values: te.Tensor, indices: te.Tensor
+    ) -> te.Tensor:
+        n, half_k = values.shape
+        k = te.reduce_axis((0, half_k), name="k")
+
+        def compute(*idx):
+            # The kept elements of each group of 4 are at k // 2 * 4 + position.
+            col = k // 2 * 4 + indices[idx[-1], k].astype(k.var.dtype)
+            return te.sum(x(*idx[:-1], col) * values[idx[-1], k], axis=k)
+
+        return te.compute([*x.shape[:-1], n], compute, name="structured_sparse_matmul")
+
+    return bb.call_te(
+        te_structured_sparse_matmul, *call.args, primfunc_name_hint="structured_sparse_matmul"
+    )
+
+
 @register_legalize("relax.einsum")
 def _einsum(bb: BlockBuilder, call: Call) -> Expr:
     t = call.args[0]
@@ -20,6 +20,7 @@ import logging
 import math
 from typing import Optional
 
+from tvm import target as tgt
 from tvm import te, tir, topi
 
 from ...block_builder import BlockBuilder
@@ -646,11 +647,154 @@ def _te_attention(
     return topi.transpose(o, [0, 2, 1, 3])
 
 
+def _te_flash_attention_cpu(
+    q: te.Tensor,
+    k: te.Tensor,
+    v: te.Tensor,
+    scale: Optional[tir.FloatImm],
+    causal_mask: Optional[str],
+    block_q: int = 16,
+    block_kv: int = 64,
+) -> te.Tensor:
+    """Attention with a tiled online softmax, for CPU targets.
+
+    Each task of the parallel loop computes a block of queries of one head, over the keys and
+    values block by block, keeping the running max, sum and output of its rows.  The scores are
+    never materialized beyond a block_q x block_kv tile, and are accumulated in float32.
+    """
+    batch_size, seq_len, num_head, head_dim = q.shape
+    _, seq_len_kv, num_head_kv, head_dim_v = v.shape
+    if scale is None:
+        scale = 1.0 / tir.sqrt(tir.Cast("float32", head_dim))
+    else:
+        scale = tir.Cast("float32", scale)
+    if causal_mask is None:
+        offset = None
+    elif causal_mask == "TopLeft":
+        offset = tir.IntImm("int32", 0)
+    elif causal_mask == "BottomRight":
+        offset = tir.abs(seq_len - seq_len_kv).astype("int32")
+    else:
+        raise NotImplementedError()
+
+    def gen_ir(q_ptr, k_ptr, v_ptr, out_ptr):
+        # pylint: disable=invalid-name
+        ib = tir.ir_builder.create()
+        Q = ib.buffer_ptr(q_ptr)
+        K = ib.buffer_ptr(k_ptr)
+        V = ib.buffer_ptr(v_ptr)
+        out = ib.buffer_ptr(out_ptr)
+        neg_inf = tir.min_value("float32")
+        num_q_blocks = tir.indexdiv(seq_len + block_q - 1, block_q)
+        num_kv_blocks = tir.indexdiv(seq_len_kv + block_kv - 1, block_kv)
+
+        with ib.for_range(0, batch_size * num_head * num_q_blocks, "task", kind="parallel") as task:
+            b = task // (num_head * num_q_blocks)
+            h = task // num_q_blocks % num_head
+            h_kv = h // (num_head // num_head_kv)
+            q_start = task % num_q_blocks * block_q
+
+            def q_index(qi, d, dim):
+                return ((b * seq_len + qi) * num_head + h) * dim + d
+
+            def kv_index(kj, d, dim):
+                return ((b * seq_len_kv + kj) * num_head_kv + h_kv) * dim + d
+
+            acc = ib.allocate("float32", (block_q * head_dim_v,), name="acc", scope="local")
+            row_max = ib.allocate("float32", (block_q,), name="row_max", scope="local")
+            row_sum = ib.allocate("float32", (block_q,), name="row_sum", scope="local")
+            scores = ib.allocate("float32", (block_q * block_kv,), name="scores", scope="local")
+            new_max = ib.allocate("float32", (1,), name="new_max", scope="local")
+            dot = ib.allocate("float32", (1,), name="dot", scope="local")
+
+            with ib.for_range(0, block_q, "i") as i:
+                row_max[i] = neg_inf
+                row_sum[i] = tir.const(0, "float32")
+                with ib.for_range(0, head_dim_v, "d") as d:
+                    acc[i * head_dim_v + d] = tir.const(0, "float32")
+
+            with ib.for_range(0, num_kv_blocks, "kv_block") as kv_block:
+                kv_start = kv_block * block_kv
+                # The scores of the tile, with neg_inf for the masked or out of range ones.
+                with ib.for_range(0, block_q, "i") as i:
+                    with ib.for_range(0, block_kv, "j") as j:
+                        qi = q_start + i
+                        kj = kv_start + j
+                        valid = tir.all(qi < seq_len, kj < seq_len_kv)
+                        if offset is not None:
+                            valid = tir.all(valid, kj <= qi + offset)
+                        scores[i * block_kv + j] = neg_inf
+                        with ib.if_scope(valid):
+                            dot[0] = tir.const(0, "float32")
+                            with ib.for_range(0, head_dim, "d") as d:
+                                q_val = tir.Cast("float32", Q[q_index(qi, d, head_dim)])
+                                k_val = tir.Cast("float32", K[kv_index(kj, d, head_dim)])
+                                dot[0] += q_val * k_val
+                            scores[i * block_kv + j] = dot[0] * scale
+
+                # Rescale the running sums to the new max, and accumulate the tile.
+                with ib.for_range(0, block_q, "i") as i:
+                    new_max[0] = row_max[i]
+                    with ib.for_range(0, block_kv, "j") as j:
+                        new_max[0] = tir.max(new_max[0], scores[i * block_kv + j])
+                    correction = tir.exp(row_max[i] - new_max[0])
+                    row_sum[i] = row_sum[i] * correction
+                    with ib.for_range(0, head_dim_v, "d") as d:
+                        acc[i * head_dim_v + d] = acc[i * head_dim_v + d] * correction
+                    with ib.for_range(0, block_kv, "j") as j:
+                        with ib.if_scope(scores[i * block_kv + j] > neg_inf):
+                            p = ib.let("p", tir.exp(scores[i * block_kv + j] - new_max[0]))
+                            row_sum[i] += p
+                            kj = kv_start + j
+                            with ib.for_range(0, head_dim_v, "d") as d:
+                                acc[i * head_dim_v + d] += p * tir.Cast(
+                                    "float32", V[kv_index(kj, d, head_dim_v)]
+                                )
+                    row_max[i] = new_max[0]
+
+            with ib.for_range(0, block_q, "i") as i:
+                qi = q_start + i
+                with ib.if_scope(qi < seq_len):
+                    with ib.for_range(0, head_dim_v, "d") as d:
+                        out[q_index(qi, d, head_dim_v)] = tir.Cast(
+                            out_ptr.dtype,
+                            tir.if_then_else(
+                                row_sum[i] > 0,
+                                acc[i * head_dim_v + d] / row_sum[i],
+                                tir.const(0, "float32"),
+                            ),
+                        )
+        return ib.get()
+
+    shape = [batch_size, seq_len, num_head, head_dim_v]
+    return te.extern(
+        [shape],
+        [q, k, v],
+        lambda ins, outs: gen_ir(ins[0], ins[1], ins[2], outs[0]),
+        dtype=q.dtype,
+        out_buffers=[tir.decl_buffer(shape, q.dtype, "out_buf")],
+        name="flash_attention_cpu",
+        tag="flash_attention_cpu",
+    )
+
+
 @register_legalize("relax.nn.attention")
 def _nn_attention(bb: BlockBuilder, call: Call) -> Expr:
     assert (
         call.attrs.window_size is None
     ), "Legalization for sliding-window attention is not supported yet."
+    target = tgt.Target.current(allow_none=True)
+    if target is not None and target.kind.name == "llvm":
+        # On CPU, avoid materializing the scores of all the queries and keys.
+        return bb.call_te(
+            _te_flash_attention_cpu,
+            call.args[0],
+            call.args[1],
+            call.args[2],
+            call.attrs.scale,
+            call.attrs.causal_mask,
+            primfunc_name_hint="attention",
+        )
     return bb.call_te(
         _te_attention,
         call.args[0],
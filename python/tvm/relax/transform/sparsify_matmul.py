@@ -0,0 +1,172 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=invalid-name
+"""A compiler pass that rewrites the matmuls of pruned weights into sparse matmuls."""
+from typing import List, Optional, Set, Tuple
+
+import numpy as np
+
+import tvm
+from tvm import IRModule, relax
+from tvm.relax.expr_functor import PyExprMutator, mutator
+
+
+@tvm.transform.module_pass(opt_level=0, name="SparsifyMatmul")
+class SparsifyMatmul:  # pylint: disable=too-few-public-methods
+    """Rewrite x @ W^T, as emitted for linear layers, into a sparse matmul of a pruned W.
+
+    With structure "2:4", each weight W among the parameters of the functions is pruned to
+    the 2 elements of largest magnitude of each group of 4 consecutive elements of a row, and
+    the matmul is rewritten into `relax.structured_sparse_matmul`. The compression is computed
+    by Relax ops on the weight, so that LiftTransformParams moves it into the transform_params
+    function, and the weights are compressed once when the parameters are transformed.
+
+    With structure "bsr", each weight W bound to a constant, e.g. by BindParams, whose blocks
+    of `block_size` are nonzero with a density of at most `max_density`, is converted into the
+    block compressed sparse row format at compile time, and the matmul is rewritten into
+    `relax.bsr_matmul`.
+
+    Parameters
+    ----------
+    structure : str
+        The sparse structure of the weights, "2:4" or "bsr".
+
+    weight_names : Optional[List[str]]
+        The names of the parameters to be pruned to 2:4, all the 2-D weights of the
+        matmuls if not given.
+
+    block_size : Tuple[int, int]
+        The shape of the blocks of the BSR weights.
+
+    max_density : float
+        The maximum density of the nonzero blocks of a weight converted into BSR.
+    """
+
+    def __init__(
+        self,
+        structure: str = "2:4",
+        weight_names: Optional[List[str]] = None,
+        block_size: Tuple[int, int] = (16, 1),
+        max_density: float = 0.5,
+    ):
+        if structure not in ("2:4", "bsr"):
+            raise ValueError(f'Unsupported sparse structure "{structure}", expected "2:4" or "bsr"')
+        self.structure = structure
+        self.weight_names = None if weight_names is None else set(weight_names)
+        self.block_size = tuple(block_size)
+        self.max_density = max_density
+
+    def transform_module(self, mod: IRModule, _ctx: tvm.transform.PassContext) -> IRModule:
+        """IRModule-level transformation"""
+        rewriter = _SparseMatmulRewriter(mod, self)
+        for g_var, func in mod.functions_items():
+            if isinstance(func, relax.Function):
+                rewriter.params = set(func.params)
+                func = rewriter.visit_expr(func)
+                func = relax.analysis.remove_all_unused(func)
+                rewriter.builder_.update_func(g_var, func)
+        return rewriter.builder_.get()
+
+
+# pylint: disable=missing-docstring
+
+
+@mutator
+class _SparseMatmulRewriter(PyExprMutator):  # pylint: disable=abstract-method
+    def __init__(self, mod: IRModule, config: SparsifyMatmul):
+        super().__init__(mod)
+        self.config = config
+        self.params: Set[relax.Var] = set()
+
+    def _get_transposed_weight(self, rhs: relax.Expr) -> Optional[relax.Expr]:
+        if not isinstance(rhs, relax.Var):
+            return None
+        value = self.builder_.lookup_binding(rhs)
+        if not (
+            isinstance(value, relax.Call)
+            and value.op == tvm.ir.Op.get("relax.permute_dims")
+            and value.args[0].struct_info.ndim == 2
+            and (value.attrs.axes is None or [int(axis) for axis in value.attrs.axes] == [1, 0])
+        ):
+            return None
+        weight = value.args[0]
+        shape = weight.struct_info.shape
+        if shape is None or not all(isinstance(dim, tvm.tir.IntImm) for dim in shape):
+            return None
+        return weight
+
+    def _compress_2_4(self, weight: relax.Expr) -> Optional[Tuple[relax.Expr, relax.Expr]]:
+        if weight not in self.params:
+            return None
+        names = self.config.weight_names
+        if names is not None and weight.name_hint not in names:
+            return None
+        n, k = [int(dim) for dim in weight.struct_info.shape]
+        if k % 4 != 0:
+            return None
+        bb = self.builder_
+        groups = bb.emit(relax.op.reshape(weight, (n, k // 4, 4)))
+        kept = bb.emit(relax.op.topk(relax.op.abs(groups), k=2, axis=-1, ret_type="indices"))
+        kept = bb.emit(relax.op.sort(kept, axis=-1))
+        values = bb.emit(relax.op.gather_elements(groups, kept, axis=2))
+        values = bb.emit(relax.op.reshape(values, (n, k // 2)))
+        # The positions in the groups of 4 fit in a byte.
+        indices = bb.emit(relax.op.reshape(relax.op.astype(kept, "uint8"), (n, k // 2)))
+        return values, indices
+
+    def _compress_bsr(self, weight: relax.Expr) -> Optional[Tuple[relax.Expr, ...]]:
+        if not isinstance(weight, relax.Constant):
+            return None
+        w = weight.data.numpy()
+        n, k = w.shape
+        block_rows, block_cols = self.config.block_size
+        if n % block_rows != 0 or k % block_cols != 0:
+            return None
+        blocks = w.reshape(n // block_rows, block_rows, k // block_cols, block_cols)
+        blocks = blocks.transpose(0, 2, 1, 3)
+        nonzero = np.any(blocks != 0, axis=(2, 3))
+        if nonzero.mean() > self.config.max_density:
+            return None
+        indptr = np.concatenate([[0], np.cumsum(nonzero.sum(axis=1))]).astype("int32")
+        indices = np.nonzero(nonzero)[1].astype("int32")
+        data = np.ascontiguousarray(blocks[nonzero])
+        return tuple(relax.const(array) for array in (data, indices, indptr))
+
+    def visit_call_(self, call: relax.Call) -> relax.Expr:  # pylint: disable=arguments-renamed
+        call = self.builder_.normalize(super().visit_call_(call))
+        if call.op != tvm.ir.Op.get("relax.matmul"):
+            return call
+        x, rhs = call.args
+        weight = self._get_transposed_weight(rhs)
+        if weight is None:
+            return call
+        if self.config.structure == "2:4":
+            compressed = self._compress_2_4(weight)
+            if compressed is None:
+                return call
+            out = relax.op.structured_sparse_matmul(x, *compressed)
+        else:
+            if x.struct_info.ndim != 2:
+                return call
+            compressed = self._compress_bsr(weight)
+            if compressed is None:
+                return call
+            out = relax.op.bsr_matmul(x, *compressed)
+        out_dtype = call.struct_info.dtype
+        if out_dtype != x.struct_info.dtype:
+            out = relax.op.astype(self.builder_.emit(out), out_dtype)
+        return out
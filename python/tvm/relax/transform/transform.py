@@ -225,6 +225,43 @@ def Gradient(
     return _ffi_api.Gradient(func_name, require_grads, target_index)  # type: ignore
 
 
+def AnnotateCheckpoints(
+    strategy: str = "sqrt", memory_budget: Optional[int] = None
+) -> tvm.ir.transform.Pass:
+    """Choose the activations kept for the backward pass, and annotate the others with
+    `R.grad.start_checkpoint` and `R.grad.end_checkpoint`, so that `Gradient` recomputes them in
+    the backward pass instead of keeping them alive.
+
+    The candidates are the tensors of static shape computed by operators within dataflow blocks,
+    except the outputs of the blocks, which are always kept. Functions that already contain
+    checkpoint annotations are left unchanged.
+
+    The kept activations are the ones `StaticPlanBlockMemory` cannot reuse before the backward
+    pass, while the recomputed ones are only alive during the forward pass and right before their
+    use in the backward pass.
+
+    Parameters
+    ----------
+    strategy : str
+        "sqrt" keeps every ceil(sqrt(n))-th candidate of the n candidates of a block.
+        "budget" keeps the candidates that are the most expensive to recompute, by the FLOPs that
+        `tvm.tir.analysis.estimate_tir_flops` estimates for their legalized operators, such that
+        the kept activations fit into `memory_budget`.
+
+    memory_budget : Optional[int]
+        The number of bytes the kept activations of a dataflow block may take, including the
+        outputs of the block. Required by the "budget" strategy.
+
+    Returns
+    -------
+    ret : tvm.ir.transform.Pass
+        The registered pass.
+    """
+    if memory_budget is None:
+        memory_budget = -1
+    return _ffi_api.AnnotateCheckpoints(strategy, memory_budget)  # type: ignore
+
+
 def ToNonDataflow() -> tvm.ir.transform.Pass:
     """Transform all dataflow structure to non-dataflow version.
 
@@ -285,6 +322,12 @@ def DataflowUseInplaceCalls() -> tvm.ir.transform.Pass:
     in-place PrimFunc implementations of those operators (which are based on the legalizations of
     those operators).
 
+    The arguments are not overwritten, unless the function donates them: the parameters whose
+    indices are listed in the "relax.donated_params" function attribute are given up by the
+    caller, so that when all uses of a donated parameter lie in one dataflow block, the operators
+    of the block may compute their outputs in its storage. This avoids allocating fresh outputs
+    for the updates of large inputs, e.g. the KV cache of a decode step.
+
     Note: ConvertToDataflow may need to be called first to provide dataflow blocks.
 
     Returns
@@ -531,6 +574,28 @@ def StaticPlanBlockMemory() -> tvm.ir.transform.Pass:
     signature will have upper bound 1024. And we will use 1024 as its value
     during memory planning.
 
+    With the pass config :code:`"relax.memory_plan_arena": True`, the statically
+    sized tensors of each binding block are placed into one arena storage per
+    device at non-overlapping offsets instead of reusing whole storages. The
+    planned arena size and the peak size of the simultaneously live tensors are
+    recorded in the function attributes "relax.memory_plan_arena_bytes" and
+    "relax.memory_plan_live_bytes".
+
+    When the typical values of a TIR variable are much smaller than its upper
+    bound, the function can be annotated with
+    :code:`R.func_attr({"tir_var_upper_bound_buckets": {"n": [128, 1024]}})`.
+    It is then split into one copy per bucket, named with the suffix
+    "_bucket<i>" and planned with the bucket bound as the upper bound of "n",
+    while the original function dispatches at runtime to the smallest bucket
+    holding the actual value of "n".
+
+    Functions that never run at the same time, e.g. the prefill and the decode
+    function of a language model, can be annotated with the same
+    :code:`R.func_attr({"relax.memory_plan_exclusive_group": "llm"})`. They
+    are always planned with arenas, and the arenas of all functions in a group
+    are padded to the same sizes, so that the pooled allocator serves them from
+    one shared workspace.
+
     Returns
     -------
     ret : tvm.ir.transform.Pass
@@ -561,6 +626,11 @@ def LowerAllocTensor() -> tvm.ir.transform.Pass:
 def KillAfterLastUse() -> tvm.ir.transform.Pass:
     """Drop all tensor/storage objects after last use
 
+    The objects are killed after the binding which uses them last, including the
+    dynamically sized allocations, such that they return to the allocator while the
+    function runs. An object last used in a branch of an If is killed after the If,
+    and an object which is never used is killed right after its binding.
+
     Returns
     -------
     ret : tvm.ir.transform.Pass
@@ -794,6 +864,14 @@ def FuseOps(fuse_opt_level=-1) -> tvm.ir.transform.Pass:
 
     Note: ConvertToDataflow may need to be called first to provide dataflow blocks.
 
+    With the pass config :code:`"relax.FuseOps.cost_model": True`, each fusion allowed by the op
+    patterns is additionally scored: the memory traffic saved by not materializing the
+    intermediate tensor is weighed against the recomputation of the producer for every access of
+    its consumers, using the bandwidth (GB/s) and throughput (GFLOP/s) given by
+    "relax.FuseOps.memory_bandwidth" and "relax.FuseOps.compute_throughput". Afterwards, the
+    independent groups of injective ops reading the same tensor are fused horizontally. The
+    decisions are recorded in the module attribute "relax.FuseOps.decisions".
+
     Parameters
     ----------
     fuse_opt_level : int
@@ -975,7 +1053,10 @@ def AttachAttrLayoutFreeBuffers() -> tvm.ir.transform.Pass:
 
     This pass is used to attach layout free buffers to the tir::PrimFunc according to
     the function usage in the relax function. Currently, the layout free buffers are the model
-    weights and relax constants.
+    weights, relax constants, and the values computed only from them within dataflow blocks,
+    e.g. a transposed weight. As `LiftTransformParams` lifts these values into the
+    `transform_params` function as well, the layout rewrite a tuned kernel asks for is
+    propagated back to the weights and precomputed.
 
     Note that we recommend applying CanonicalizeBindings before this pass.
 
@@ -1181,6 +1262,54 @@ def RealizeVDevice() -> tvm.ir.transform.Pass:
     return _ffi_api.RealizeVDevice()  # type: ignore
 
 
+def PlaceVDeviceByCost(
+    cpu_gflops: float = 100.0,
+    gpu_gflops: float = 10000.0,
+    launch_us: float = 5.0,
+    transfer_gbps: float = 10.0,
+) -> tvm.ir.transform.Pass:
+    """Place the operators on the CPU or the GPU by their estimated cost.
+
+    The module has to declare a CPU and a GPU in its "vdevice" global infos. The tensors
+    without a VDevice are taken to be on the first of them. Each operator whose output has
+    no VDevice is placed, in program order, on the device minimizing its compute time plus
+    the time of copying the inputs it reads from the other device. The compute time is
+    estimated from the shapes, and a launch overhead is added on the GPU, so that the small
+    operators stay on the CPU and the large ones go to the GPU.
+
+    A tensor needed on the other device is copied once per binding block with
+    R.to_vdevice, right after its binding, so that the copy overlaps with the computation
+    before its first use. The other calls, e.g. of kernels or of Relax functions, read their
+    inputs on the device of their outputs, and the returned tensors stay on the device of the
+    function's return annotation.
+
+    This pass should run after RealizeVDevice, which places the explicitly annotated
+    tensors, and before LegalizeOps.
+
+    Parameters
+    ----------
+    cpu_gflops : float
+        The throughput of the CPU, in GFLOP/s.
+
+    gpu_gflops : float
+        The throughput of the GPU, in GFLOP/s.
+
+    launch_us : float
+        The overhead of a kernel launch or of a copy across the devices, in microseconds.
+
+    transfer_gbps : float
+        The bandwidth of the copies across the devices, in GB/s.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass
+    """
+    return _ffi_api.PlaceVDeviceByCost(  # type: ignore
+        cpu_gflops, gpu_gflops, launch_us, transfer_gbps
+    )
+
+
 def MetaScheduleApplyDatabase(
     work_dir: Optional[str] = None, dyn_mod = None, enable_warning: bool = False
 ) -> tvm.ir.transform.Pass:
@@ -1380,6 +1509,44 @@ def ConvertLayout(desired_layouts: Dict[str, List[str]]) -> tvm.ir.transform.Pas
     return _ffi_api.ConvertLayout(desired_layouts)  # type: ignore
 
 
+def ConvertLayoutByCost(
+    desired_layouts: Dict[str, List[str]],
+    layout_speedup: float = 1.5,
+    gflops: float = 100.0,
+    transform_gbps: float = 10.0,
+) -> tvm.ir.transform.Pass:
+    """Layout conversion pass that converts only the regions where the desired layouts pay off.
+
+    A region is a set of ops with desired layouts, e.g. the conv2d of a CNN backbone, connected
+    by the ops the layout propagates through. Unlike :py:func:`ConvertLayout`, which converts
+    every region, a region keeps the initial layout when that lowers the estimated time of the
+    kernels plus the layout transforms inserted at its boundaries, e.g. with the matmuls of a
+    transformer. The transforms of constants are not counted, as FoldConstant folds them.
+
+    Parameters
+    ----------
+    desired_layouts : Dict[str, List[str]]
+        The desired layouts of the ops, as in :py:func:`ConvertLayout`.
+
+    layout_speedup : float
+        The speedup of the ops with desired layouts when converted.
+
+    gflops : float
+        The throughput of the kernels, in GFLOPS.
+
+    transform_gbps : float
+        The bandwidth of the layout transforms, in GB/s.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The registered pass for layout conversion.
+    """
+    return _ffi_api.ConvertLayoutByCost(  # type: ignore
+        desired_layouts, layout_speedup, gflops, transform_gbps
+    )
+
+
 def DeadCodeElimination(entry_functions: Optional[List[str]] = None) -> tvm.ir.transform.Pass:
     """Remove dead code in the IRModule.
     Currently it removes:
@@ -1411,7 +1578,7 @@ def DeadCodeElimination(entry_functions: Optional[List[str]] = None) -> tvm.ir.t
 
 
 def ToMixedPrecision(
-    out_dtype="float32", fp16_input_names: Optional[List[str]] = None
+    out_dtype="float32", fp16_input_names: Optional[List[str]] = None, fp8_matmul: bool = False
 ) -> tvm.ir.transform.Pass:
     """Automatic mixed precision pass. Currently the pass assumes the input module to be fp32
     only, and will automatically cast fp32 to fp16 for certain ops.
@@ -1425,13 +1592,18 @@ def ToMixedPrecision(
     fp16_input_names : List[str]
         The names of function parameters whose dtype should become fp16. The  function signature
         would change accordingly.
+    fp8_matmul : bool
+        Whether to compute the matmuls whose rhs is a transposed 2-D tensor, as in linear layers,
+        in float8 e4m3. Each operand is quantized with a per-tensor scale computed from its
+        absolute maximum, and the result is rescaled in fp32, in the form offloaded to the FP8
+        matmul of cuBLASLt by ``partition_for_cublas``.
 
     Returns
     -------
     ret : tvm.transform.Pass
         The registered pass for mixed precision.
     """
-    return _ffi_api.ToMixedPrecision(out_dtype, fp16_input_names)  # type: ignore
+    return _ffi_api.ToMixedPrecision(out_dtype, fp16_input_names, fp8_matmul)  # type: ignore
 
 
 def SplitCallTIRByPattern(patterns: List[PrimFunc], fcodegen: Callable) -> tvm.ir.transform.Pass:
@@ -1553,6 +1725,36 @@ def ReorderTakeAfterMatmul():
     return _ffi_api.ReorderTakeAfterMatmul()  # type: ignore
 
 
+def LowerBatchedLoRAMatmul(segment_gemm_func: Optional[str] = None):
+    """Lower `matmul(x, take(weights, indices, axis=0))` to a single gathered matmul.
+
+    In batched LoRA, each sequence of the batch selects its adapter out of a
+    stacked weight table.  With `x` of shape `[batch, seq_len, in]`, `weights`
+    of shape `[table_size, in, out]` and `indices` of shape `[batch]`, the
+    gathered weights are never materialized.  Instead, a single kernel reads
+    `weights[indices[i]]` while computing the i-th sequence.  Weight tables of
+    shape `[table_size, out, in]`, used through
+    `permute_dims(take(weights, indices, axis=0), [0, 2, 1])`, are matched as
+    well.
+
+    Parameters
+    ----------
+    segment_gemm_func : Optional[str]
+        The name of a packed function computing the segmented GEMM with the
+        signature `(x, weights, indices, workspace, out)`, such as
+        `"cutlass.segment_gemm_fp16_sm90"`.  It is used for float16 weight
+        tables of shape `[table_size, out, in]`.  Otherwise, and by default,
+        the matmul is lowered to a TIR PrimFunc.
+
+    Returns
+    -------
+    ret : tvm.transform.Pass
+        The corresponding pass.
+    """
+
+    return _ffi_api.LowerBatchedLoRAMatmul(segment_gemm_func)  # type: ignore
+
+
 def CombineParallelMatmul(check=None):
     """Combine multiple matmul operators sharing the same LHS matrix into one,
     followed by slicing. When all matmul branches in a tree have the same set of fused ops,
@@ -1581,6 +1783,11 @@ def RewriteCUDAGraph() -> tvm.ir.transform.Pass:
     """Rewrite a Relax module for executing with CUDA graph. This pass identifies the regions that
     can be executed with CUDA graph and lifts them into new functions for runtime graph capturing.
 
+    The static storage allocations of all functions are merged into one allocation function,
+    assuming the functions never run concurrently. When functions are annotated with
+    "relax.memory_plan_exclusive_group", storages are only shared within the same group, and the
+    functions without the attribute share storages with each other.
+
     Returns
     -------
     ret: tvm.ir.transform.Pass
@@ -1589,6 +1796,95 @@ def RewriteCUDAGraph() -> tvm.ir.transform.Pass:
     return _ffi_api.RewriteCUDAGraph()  # type: ignore
 
 
+def StreamParams(lookahead: int = 2, num_slots: int = 4) -> tvm.ir.transform.Pass:
+    """Stream the weights of a function from host memory to the device.
+
+    For models that do not fit into device memory, the weights (the arguments
+    after the first `func.attrs["num_input"]` arguments) are passed as host
+    tensors and copied into a bounded ring of `num_slots` device buffers.  The
+    copy of each weight is issued on a separate copy stream `lookahead`
+    weights ahead of its first use, in the order of the first uses, and the
+    computation waits on an event of the copy instead of blocking on it.  A
+    slot is reused once the last use of its previous weight has been issued.
+
+    The indices of the streamed weights are recorded in the function
+    attribute "relax.streamed_params".  The weights that are returned, have a
+    dynamic shape, or cannot get a free slot before their first use are left
+    as device tensors.  The host tensors should be in pinned memory for the
+    copies to overlap with the computation.
+
+    This pass operates on functions without dataflow blocks, and is expected
+    to run after `CallTIRRewrite` in the VM lowering pipeline.  The runtime
+    builtins are only available for CUDA.
+
+    Parameters
+    ----------
+    lookahead : int
+        The number of weights by which the copies run ahead of the computation.
+
+    num_slots : int
+        The number of device buffers of the ring, each as large as the largest
+        streamed weight.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+        The registered pass for streaming the weights.
+    """
+    return _ffi_api.StreamParams(lookahead, num_slots)  # type: ignore
+
+
+def PersistL2Params() -> tvm.ir.transform.Pass:
+    """Keep hot parameters of a function resident in the L2 cache while they are used.
+
+    The function attribute "relax.l2_persisting_params" maps the names of
+    tensor parameters, e.g. an embedding table, to the fraction of their
+    accesses to be persisting in the L2 cache.  Right before the first use of
+    each of them, an access policy window is set on the stream, and it is
+    cleared right after the last use.  A stream has a single window, so a
+    parameter used while the window of an earlier one is still set is skipped
+    with a warning.  The attribute is removed from the function.
+
+    The windows require devices of compute capability 8.0 and above, and the
+    runtime builtins do nothing on the other CUDA devices.  The windows set
+    while a CUDA graph is captured, or set around it, are set on the kernel
+    nodes of the graph.
+
+    This pass operates on functions without dataflow blocks, and is expected
+    to run after `CallTIRRewrite` in the VM lowering pipeline.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+        The registered pass for keeping the parameters in the L2 cache.
+    """
+    return _ffi_api.PersistL2Params()  # type: ignore
+
+
+def OverlapCollectives() -> tvm.ir.transform.Pass:
+    """Overlap the collectives of Disco with the computation independent of them.
+
+    The legalized `runtime.disco.allreduce` and `runtime.disco.allgather`, and
+    the `runtime.disco.ring_exchange` of the ring attention, in dataflow blocks
+    are replaced by their asynchronous variants, which run on
+    a separate communication stream, and a `runtime.disco.wait_collective` of
+    the compute stream on them.  The bindings after a collective that do not
+    depend on it are moved between the collective and its wait, so that their
+    kernels run while the collective is in flight.  A collective is left
+    unchanged if no such bindings exist.
+
+    This pass is expected to run after `LegalizeOps` and before
+    `ToNonDataflow`.  The asynchronous collectives are only available for
+    NCCL and RCCL.
+
+    Returns
+    -------
+    ret: tvm.ir.transform.Pass
+        The registered pass for overlapping the collectives.
+    """
+    return _ffi_api.OverlapCollectives()  # type: ignore
+
+
 def AllocateWorkspace() -> tvm.ir.transform.Pass:
     """Allocate a workspace, represented by a tensor of size big enough for all external
     functions that require a temporary storage, and append it to the arguments of external
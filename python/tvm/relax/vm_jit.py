@@ -0,0 +1,276 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Shape-specializing JIT of the hot functions of a Relax VM"""
+from typing import Any, Callable, Dict, List, Optional, Tuple, Union
+
+import tvm
+from tvm import relax
+from tvm import tir
+from tvm.ir.module import IRModule
+from tvm.runtime import Device, NDArray, PackedFunc, ShapeTuple
+from tvm.runtime.container import ADT
+from tvm.runtime.relax_vm import VirtualMachine
+
+from .struct_info import ShapeStructInfo, StructInfo, TensorStructInfo, TupleStructInfo
+from .vm_build import build
+
+
+def _shape_signature(arg: Any) -> Optional[Tuple]:
+    """The shape signature of an argument, None if it cannot be guarded on."""
+    if isinstance(arg, NDArray):
+        return ("t", tuple(arg.shape), arg.dtype)
+    if isinstance(arg, ShapeTuple):
+        return ("s", tuple(arg))
+    if isinstance(arg, (list, tuple, ADT)):
+        fields = tuple(_shape_signature(field) for field in arg)
+        return None if any(field is None for field in fields) else ("u", fields)
+    if isinstance(arg, (bool, int, float, str)):
+        return ("p", type(arg).__name__)
+    return None
+
+
+def _bind_values(sinfo: StructInfo, sig: Tuple, binding: Dict[tvm.tir.Var, int]) -> bool:
+    """Bind the symbolic vars of sinfo to the values of sig, False if they conflict."""
+    values = None
+    if isinstance(sinfo, TensorStructInfo) and sig[0] == "t" and sinfo.shape is not None:
+        shape = sinfo.shape
+        values = shape.values if isinstance(shape, relax.ShapeExpr) else None
+        observed = sig[1]
+    elif isinstance(sinfo, ShapeStructInfo) and sig[0] == "s":
+        values = sinfo.values
+        observed = sig[1]
+    elif isinstance(sinfo, TupleStructInfo) and sig[0] == "u":
+        if len(sinfo.fields) != len(sig[1]):
+            return False
+        return all(_bind_values(f, s, binding) for f, s in zip(sinfo.fields, sig[1]))
+    if values is None:
+        return True
+    if len(values) != len(observed):
+        return False
+    for expr, value in zip(values, observed):
+        if isinstance(expr, tvm.tir.Var):
+            if binding.setdefault(expr, value) != value:
+                return False
+    return True
+
+
+class TracingVirtualMachine:
+    """A Relax VM that compiles its hot functions for the shapes they are called with.
+
+    The functions are interpreted by a VM built from the input module, which counts the
+    calls of each function with each shape signature, i.e. the shapes and the dtypes of its
+    tensor arguments and the values of its shape arguments. When a signature becomes hot,
+    the symbolic shape vars of the function are bound to the values of the signature and
+    the specialized module is compiled in the "compiled" exec mode, which lowers the
+    instructions of the function, with the shape computations folded, into a native host
+    function. Later calls with the signature invoke it, and calls with other signatures
+    fall back to the interpreter.
+
+    Parameters
+    ----------
+    mod : IRModule
+        The input module, as given to :py:func:`tvm.relax.build`.
+
+    target : Union[str, tvm.target.Target]
+        The target to build the module for.
+
+    device : Union[Device, List[Device]]
+        The device to run the module on.
+
+    hot_threshold : int
+        The number of calls with a signature after which the function is specialized for it.
+
+    max_specializations : int
+        The maximum number of signatures a function is specialized for.
+
+    params : Optional[Dict[str, list]]
+        The parameters bound to the module when building it.
+
+    memory_cfg : Optional[Union[str, Dict[Device, str]]]
+        The memory allocator config of the VMs, see :py:class:`VirtualMachine`.
+    """
+
+    def __init__(
+        self,
+        mod: IRModule,
+        target: Union[str, tvm.target.Target],
+        device: Device,
+        hot_threshold: int = 16,
+        max_specializations: int = 8,
+        params: Optional[Dict[str, list]] = None,
+        memory_cfg: Optional[Union[str, Dict[Device, str]]] = None,
+    ) -> None:
+        self.mod = mod
+        self.target = tvm.target.Target(target) if isinstance(target, str) else target
+        self.device = device
+        self.hot_threshold = hot_threshold
+        self.max_specializations = max_specializations
+        self.params = params
+        self.memory_cfg = memory_cfg
+        self.vm = VirtualMachine(build(mod, self.target, params=params), device, memory_cfg)
+        self._call_counts: Dict[Tuple[str, Tuple], int] = {}
+        self._specialized: Dict[str, Dict[Tuple, Callable]] = {}
+        self._dispatchers: Dict[str, Callable] = {}
+
+    def __getitem__(self, func_name: str) -> Callable:
+        if func_name not in self._dispatchers:
+            self._dispatchers[func_name] = self._make_dispatcher(func_name)
+        return self._dispatchers[func_name]
+
+    def num_specializations(self, func_name: str) -> int:
+        """The number of signatures the function is compiled for."""
+        return len(self._specialized.get(func_name, {}))
+
+    def _make_dispatcher(self, func_name: str) -> Callable:
+        interpreted = self.vm[func_name]
+        specialized = self._specialized.setdefault(func_name, {})
+
+        def dispatch(*args):
+            sig = _shape_signature(args)
+            func = specialized.get(sig)
+            if func is not None:
+                return func(*args)
+            if sig is not None and len(specialized) < self.max_specializations:
+                count = self._call_counts.get((func_name, sig), 0) + 1
+                self._call_counts[(func_name, sig)] = count
+                if count >= self.hot_threshold:
+                    # A signature the function cannot be specialized for stays interpreted.
+                    func = self._specialize(func_name, sig) or interpreted
+                    specialized[sig] = func
+                    return func(*args)
+            return interpreted(*args)
+
+        return dispatch
+
+    def _specialize(self, func_name: str, sig: Tuple) -> Optional[Callable]:
+        """Compile the function with its symbolic shape vars bound to the values of sig."""
+        func = self.mod[func_name]
+        if not isinstance(func, relax.Function) or len(func.params) != len(sig[1]):
+            return None
+        binding: Dict[tvm.tir.Var, int] = {}
+        for param, arg_sig in zip(func.params, sig[1]):
+            if not _bind_values(param.struct_info, arg_sig, binding):
+                return None
+        mod = relax.transform.BindSymbolicVars(binding, func_name)(self.mod)
+        mod = relax.transform.DeadCodeElimination([func_name])(mod)
+        ex = build(mod, self.target, params=self.params, exec_mode="compiled")
+        return VirtualMachine(ex, self.device, self.memory_cfg)[func_name]
+
+
+class PrimFuncSpecializer:
+    """The specialize hook of a VM, compiling its TIR functions for the shapes of a call.
+
+    The symbolic shape vars of the PrimFunc are bound to the shapes of the tensor arguments
+    and to the values of the integer arguments of the call, keeping the params of the
+    function so that the variant is called like the generic one. The variant is scheduled
+    with the record of the database for its workload if there is one, or with the default
+    GPU schedule on GPU targets, and compiled on its own.
+
+    Parameters
+    ----------
+    mod : IRModule
+        The module holding the PrimFuncs of the VM, before they are scheduled when
+        `database` is given.
+
+    target : Union[str, tvm.target.Target]
+        The target the VM is built for.
+
+    database : Optional[tvm.meta_schedule.Database]
+        The database holding the tuned schedules of the static shape workloads.
+
+    Example
+    -------
+
+    .. code-block:: python
+
+        vm = relax.VirtualMachine(relax.build(mod, target), dev)
+        vm.set_specialize_hook(relax.PrimFuncSpecializer(mod, target, database), threshold=8)
+    """
+
+    def __init__(
+        self,
+        mod: IRModule,
+        target: Union[str, tvm.target.Target],
+        database: Optional["tvm.meta_schedule.Database"] = None,
+    ) -> None:
+        self.mod = mod
+        self.target = tvm.target.Target(target) if isinstance(target, str) else target
+        self.database = database
+
+    def specialize(
+        self, func: tir.PrimFunc, tensor_shapes: List[ShapeTuple], scalars: ShapeTuple
+    ) -> Optional[tir.PrimFunc]:
+        """Bind the symbolic shape vars of the PrimFunc to the shapes of a call."""
+        handles = [param for param in func.params if param in func.buffer_map]
+        scalar_params = [param for param in func.params if param not in func.buffer_map]
+        if len(handles) != len(tensor_shapes) or len(scalar_params) != len(scalars):
+            return None
+        param_map = {}
+        for handle, shape in zip(handles, tensor_shapes):
+            buf = func.buffer_map[handle]
+            if len(buf.shape) != len(shape):
+                return None
+            if all(not isinstance(dim, tir.Var) for dim in buf.shape):
+                continue
+            param_map[handle] = tir.decl_buffer(
+                [
+                    tir.IntImm(dim.dtype, value) if isinstance(dim, tir.Var) else dim
+                    for dim, value in zip(buf.shape, shape)
+                ],
+                buf.dtype,
+                buf.name,
+                data=buf.data,
+                strides=buf.strides,
+                elem_offset=buf.elem_offset,
+                scope=buf.scope(),
+                data_alignment=buf.data_alignment,
+                offset_factor=buf.offset_factor,
+                axis_separators=buf.axis_separators,
+            )
+        for param, value in zip(scalar_params, scalars):
+            param_map[param] = tir.IntImm(param.dtype, value)
+        specialized = func.specialize(param_map)
+        # The bound scalar params are unused now, but kept for the calling convention.
+        return tir.PrimFunc(
+            func.params,
+            specialized.body,
+            specialized.ret_type,
+            specialized.buffer_map,
+            specialized.attrs,
+        )
+
+    def __call__(
+        self, name: str, tensor_shapes: List[ShapeTuple], scalars: ShapeTuple
+    ) -> Optional[PackedFunc]:
+        try:
+            func = self.mod[name]
+        except (KeyError, ValueError, tvm.TVMError):
+            return None
+        if not isinstance(func, tir.PrimFunc):
+            return None
+        func = self.specialize(func, tensor_shapes, scalars)
+        if func is None:
+            return None
+        mod = IRModule({name: func.with_attr("global_symbol", name)})
+        if self.database is not None:
+            sch = self.database.query_schedule(mod, self.target, workload_name=name)
+            if sch is not None:
+                mod = sch.mod
+        with self.target:
+            if "gpu" in self.target.keys:
+                mod = tir.transform.DefaultGPUSchedule()(mod)
+            return tvm.build(mod, target=self.target)[name]
@@ -414,6 +414,14 @@ def get():
     return _backend._TECompilerGlobal()
 
 
+def clear_process_cache():
+    """Clear the lowered functions shared by the builds of the process.
+
+    The cache is enabled with the "relay.backend.te_compiler_process_cache" pass config option.
+    """
+    _backend._TECompilerClearProcessCache()
+
+
 def lower_to_primfunc(relay_func, target):
     """Lower Relay Function to TIR PrimFunc.
 
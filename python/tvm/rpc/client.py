@@ -72,6 +72,20 @@ class RPCSession(object):
         """
         return self._sess.get_function(name)
 
+    def set_multiplex(self, enable=True):
+        """Set whether the calls taking a device or a tensor are multiplexed over the connection.
+
+        The remote runs the multiplexed calls of each device in order on a thread of the device,
+        so the calls on different devices issued from several threads run concurrently.
+        Remotes which do not support it keep running the calls one at a time.
+
+        Parameters
+        ----------
+        enable : bool
+            Whether to multiplex the calls.
+        """
+        _ffi_api.SessionSetMultiplex(self._sess, enable)
+
     def device(self, dev_type, dev_id=0):
         """Construct a remote device.
 
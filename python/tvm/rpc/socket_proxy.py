@@ -0,0 +1,67 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Event driven RPC proxy implemented in C++.
+
+It pairs the clients and the servers connecting with the same key,
+like :py:class:`tvm.rpc.proxy.Proxy`, but serves all the connections
+from a few native threads waiting on epoll and forwards the bytes
+with splice, so it does not need a process or a Python thread per
+connection. Websocket servers and tracker registration are only
+supported by the Python proxy.
+"""
+from . import _ffi_api
+
+
+class SocketProxy(object):
+    """Start the native RPC proxy in the current process.
+
+    Parameters
+    ----------
+    host : str
+        The host url of the proxy.
+
+    port : int
+        The TCP port to be bind to
+
+    port_end : int, optional
+        The end TCP port to search
+
+    num_threads : int, optional
+        The number of threads serving the connections.
+
+    timeout : float, optional
+        Timeout in seconds of a connection waiting for its match.
+    """
+
+    def __init__(self, host="0.0.0.0", port=9091, port_end=9199, num_threads=2, timeout=600):
+        self.host = host
+        self._mod = _ffi_api.SocketProxy(host, port, port_end, num_threads, float(timeout))
+        self.port = self._mod["port"]()
+        self._stop = self._mod["stop"]
+
+    def terminate(self):
+        """Stop the proxy and close all of its connections."""
+        if self._mod is not None:
+            self._stop()
+            self._stop = None
+            self._mod = None
+
+    def __del__(self):
+        try:
+            self.terminate()
+        except ImportError:
+            pass
@@ -17,6 +17,8 @@
 
 # pylint: disable=invalid-name,unnecessary-comprehension
 """ Testing functions for the RPC server."""
+import time
+
 import numpy as np
 import tvm
 
@@ -42,6 +44,12 @@ def _strcat(x, y):
     return x + y
 
 
+@tvm.register_func("rpc.test.sleep_on_device")
+def _sleep_on_device(dev, seconds):
+    time.sleep(seconds)
+    return dev.device_id
+
+
 @tvm.register_func("rpc.test.remote_array_func")
 def _remote_array_func(y):
     x = np.ones((3, 4))
@@ -27,6 +27,7 @@ from .module import Module, num_threads
 from .profiling import Report
 
 # function exposures
+from .packed_func import call_batch
 from .ndarray import device, cpu, cuda, gpu, opencl, cl, vulkan, metal, mtl
 from .ndarray import vpi, rocm, ext_dev
 from .module import load_module, enabled, system_lib, load_static_library
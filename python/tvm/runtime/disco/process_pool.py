@@ -24,6 +24,10 @@ from tvm._ffi import register_func
 from tvm.runtime import ShapeTuple
 
 
+# The size of the memory file of a shared memory channel, holding one ring per direction.
+SHM_CHANNEL_NBYTES = 2 * (4 << 20)
+
+
 class DiscoPopenWorker:
     """A subprocess worker via Popen.
 
@@ -46,6 +50,10 @@ class DiscoPopenWorker:
 
     stderr: Union[None, int, IO[Any]]
         The standard error streams handler specified for the popen process.
+
+    shm_nbytes: int
+        The size of the memory file shared with the worker, or 0 to send the
+        messages over the pipes. Only supported on Linux.
     """
 
     def __init__(  # pylint: disable=too-many-arguments
@@ -56,6 +64,7 @@ class DiscoPopenWorker:
         entrypoint: str = "tvm.exec.disco_worker",
         stdout=None,
         stderr=None,
+        shm_nbytes: int = 0,
     ):
         self.worker_id = worker_id
         self.num_workers = num_workers
@@ -64,6 +73,8 @@ class DiscoPopenWorker:
         self._proc = None
         self._stdout = stdout
         self._stderr = stderr
+        self._shm_nbytes = shm_nbytes
+        self.shm_fd = None
 
     def __del__(self):
         try:
@@ -141,9 +152,16 @@ class DiscoPopenWorker:
             )
         else:
             cmd += [str(worker_read), str(worker_write)]
+            pass_fds = (worker_read, worker_write)
+            if self._shm_nbytes > 0:
+                # The memory file is zero-initialized, and both processes map it.
+                self.shm_fd = os.memfd_create(f"tvm_disco_worker_{self.worker_id}")
+                os.ftruncate(self.shm_fd, self._shm_nbytes)
+                cmd += [str(self.shm_fd)]
+                pass_fds += (self.shm_fd,)
             self._proc = subprocess.Popen(  # pylint: disable=consider-using-with
                 cmd,
-                pass_fds=(worker_read, worker_write),
+                pass_fds=pass_fds,
                 stdout=self._stdout,
                 stderr=self._stderr,
             )
@@ -191,3 +209,27 @@ def _create_process_pool(num_workers: int, num_groups: int, entrypoint: str):
         return None
 
     return result_func
+
+
+@register_func("runtime.disco.create_shared_memory_process_pool")
+def _create_shared_memory_process_pool(num_workers: int, num_groups: int, entrypoint: str):
+    """Create a process pool where the workers' are [1, num_workers), each of which
+    communicates with the controller over a shared memory channel."""
+    if not sys.platform.startswith("linux"):
+        raise ValueError("The shared memory channel of ProcessSession is only supported on Linux")
+    pool = [
+        DiscoPopenWorker(i, num_workers, num_groups, entrypoint, shm_nbytes=SHM_CHANNEL_NBYTES)
+        for i in range(1, num_workers)
+    ]
+
+    def result_func(worker_id: int):
+        nonlocal pool
+        if worker_id != 0:
+            worker = pool[worker_id - 1]
+            read_fd, write_fd = worker.start()
+            # The controller takes over the memory file, and closes it once mapped.
+            return ShapeTuple([read_fd, write_fd, worker.shm_fd])
+        del pool
+        return None
+
+    return result_func
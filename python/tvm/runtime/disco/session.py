@@ -21,7 +21,7 @@ with the distributed runtime.
 import logging
 import os
 import pickle
-from typing import Any, Callable, Optional, Sequence, Union
+from typing import Any, Callable, List, Optional, Sequence, Union
 
 import numpy as np
 
@@ -226,6 +226,39 @@ class Session(Object):
         """
         return _ffi_api.SessionCallPacked(self, 0, 0, func, *args)  # type: ignore # pylint: disable=no-member
 
+    def begin_command_graph(self) -> None:
+        """Start recording a command graph. Until `end_command_graph`, the calls of PackedFuncs
+        are recorded instead of being sent to the workers. The DRefs they return only hold values
+        after the graph is replayed.
+
+        Notes
+        -----
+        Getting global functions takes effect immediately while recording, but copying from and
+        to worker-0 and synchronizing with workers are not allowed.
+        """
+        _ffi_api.SessionBeginCommandGraph(self)  # type: ignore # pylint: disable=no-member
+
+    def end_command_graph(self) -> DRef:
+        """Stop recording, and send the recorded calls to the workers as a command graph.
+
+        Returns
+        -------
+        graph : DRef
+            The command graph on the workers.
+        """
+        return _ffi_api.SessionEndCommandGraph(self)  # type: ignore # pylint: disable=no-member
+
+    def replay_command_graph(self, graph: DRef) -> None:
+        """Run all the calls of a command graph on the workers with a single broadcast. The
+        calls read and write the same DRefs as they are recorded with.
+
+        Parameters
+        ----------
+        graph : DRef
+            The command graph returned by `end_command_graph`.
+        """
+        _ffi_api.SessionReplayCommandGraph(self, graph)  # type: ignore # pylint: disable=no-member
+
     def _sync_worker(self, worker_id: int) -> None:
         """Synchronize the controller with a worker, and it will wait until the worker finishes
         executing all the existing instructions. This function is usually used for worker-0, because
@@ -244,6 +277,69 @@ class Session(Object):
         executing all the existing instructions."""
         return self._sync_worker(0)
 
+    def worker_stats(self, straggler_factor: float = 2.0) -> list:
+        """Synchronize with every worker, and collect the timing of the commands on each of them.
+        As it syncs with all the workers, it should only be used for debugging and profiling.
+
+        Parameters
+        ----------
+        straggler_factor : float
+            A worker is reported as a straggler if it has been busy for more than this many times
+            the median of all the workers.
+
+        Returns
+        -------
+        stats : List[Dict[str, Any]]
+            The stats of each worker, including the number of commands sent to it but not synced
+            before this call, the number of commands it has run and the nanoseconds it has been
+            busy on them, a histogram of the latency of the commands, whose bucket `i` counts the
+            commands taking less than `2**i` microseconds, the nanoseconds the controller waited
+            for it to catch up, and whether it is a straggler.
+        """
+        num_workers = self.num_workers
+        sync_info = list(_ffi_api.SessionGetWorkerSyncInfo(self))  # type: ignore # pylint: disable=no-member
+        in_flight = sync_info[0::5]
+        histograms = self._get_cached_method("runtime.disco.worker_stats")()
+        for worker_id in range(num_workers):
+            self._sync_worker(worker_id)
+        sync_info = list(_ffi_api.SessionGetWorkerSyncInfo(self))  # type: ignore # pylint: disable=no-member
+        stats = []
+        for worker_id in range(num_workers):
+            info = sync_info[worker_id * 5 : worker_id * 5 + 5]
+            stats.append(
+                {
+                    "num_commands_in_flight": in_flight[worker_id],
+                    "num_commands": info[1],
+                    "busy_nanos": info[2],
+                    "latency_histogram": list(histograms.debug_get_from_remote(worker_id))[2:],
+                    "sync_nanos": info[4],
+                }
+            )
+        busy = sorted(worker["busy_nanos"] for worker in stats)
+        median = busy[len(busy) // 2]
+        for worker_id, worker in enumerate(stats):
+            worker["straggler"] = median > 0 and worker["busy_nanos"] > straggler_factor * median
+            if worker["straggler"]:
+                logging.warning(
+                    "Disco worker %d has been busy for %d ns, over %.1fx the median of %d ns",
+                    worker_id,
+                    worker["busy_nanos"],
+                    straggler_factor,
+                    median,
+                )
+        return stats
+
+    def set_sync_watchdog(self, timeout_ms: int) -> None:
+        """Warn periodically when a worker does not reply to a sync within the given time, which
+        tells a worker that is stuck or much slower than the others.
+
+        Parameters
+        ----------
+        timeout_ms : int
+            The time in milliseconds, or 0 to disable the warning.
+        """
+        _ffi_api.SessionSetSyncWatchdog(self, timeout_ms)  # type: ignore # pylint: disable=no-member
+
     def copy_from_worker_0(self, host_array: NDArray, remote_array: DRef) -> None:
         """Copy an NDArray from worker-0 to the controller-side NDArray.
 
@@ -325,8 +421,25 @@ class Session(Object):
         """
         assert ccl in ("nccl", "rccl"), f"Unsupported CCL backend: {ccl}"
         _ffi_api.SessionInitCCL(self, ccl, ShapeTuple(device_ids))  # type: ignore # pylint: disable=no-member
+        self._tune_custom_allreduce()
         self._clear_ipc_memory_pool()
 
+    def bind_workers_to_numa_nodes(self) -> List[int]:
+        """Pin each worker to the CPUs of the NUMA node nearest to its device, from the PCIe
+        topology, and prefer the memory of the node for its allocations, so that the host staging
+        buffers of its transfers are local to the node. It applies to the thread of the worker,
+        or to the process of the worker in a ProcessSession, and should be called after
+        `init_ccl`, which sets the devices of the workers.
+
+        Returns
+        -------
+        nodes : List[int]
+            The NUMA node of each worker, -1 if it is unknown, e.g. on hosts of a single node,
+            in which case the worker is left as is.
+        """
+        nodes = self._get_cached_method("runtime.disco.bind_worker_to_numa_node")()
+        return [int(nodes.debug_get_from_remote(i)) for i in range(self.num_workers)]
+
     def broadcast(
         self, src: Union[np.ndarray, NDArray], dst: Optional[DRef] = None, in_group: bool = True
     ) -> DRef:
@@ -515,6 +628,86 @@ class Session(Object):
         func = self._get_cached_method("runtime.disco.allgather")
         func(src, in_group, dst)
 
+    def alltoall(
+        self,
+        src: DRef,
+        dst: DRef,
+        in_group: bool = True,
+    ) -> DRef:
+        """Perform an alltoall operation on an array, which sends chunk `i` of the first axis
+        to worker `i`, and places the chunk received from worker `j` at chunk `j` of `dst`.
+
+        Parameters
+        ----------
+        src : DRef
+            The array to be sent.
+
+        dst : DRef
+            The array to be received to, of the same size.
+
+        in_group : bool
+            Whether the alltoall operation performs globally or in group as default.
+        """
+        func = self._get_cached_method("runtime.disco.alltoall")
+        func(src, in_group, dst)
+
+    def run_pipeline(
+        self,
+        chunks: Sequence[DRef],
+        inputs: Sequence[DRef],
+        activation_shape: Sequence[int],
+        activation_dtype: str,
+        profile: bool = False,
+    ) -> DRef:
+        """Run micro-batches through the pipeline formed by the worker groups, where each group is
+        a stage, and sends its activations to the next group.
+
+        Parameters
+        ----------
+        chunks : Sequence[DRef]
+            The functions of the stage of each worker, each mapping an activation to the next one.
+            With more than one chunk, chunk `v` of group `g` is the virtual stage
+            `v * num_groups + g`, and the micro-batches are scheduled in an interleaved way, which
+            requires the number of micro-batches to be a multiple of the number of groups.
+
+        inputs : Sequence[DRef]
+            The input micro-batches, which are only used by the first group.
+
+        activation_shape : Sequence[int]
+            The shape of the activations passed between the stages.
+
+        activation_dtype : str
+            The data type of the activations passed between the stages.
+
+        profile : bool
+            Whether to time each chunk on each micro-batch.
+
+        Returns
+        -------
+        result : DRef
+            An array of two elements on each worker. The first one is the array of the outputs of
+            the micro-batches, which is only non-empty on the last group. The second one is the
+            elapsed nanoseconds of chunk `v` on micro-batch `m` at index
+            `v * num_micro_batches + m`, which is empty unless profiling.
+        """
+        num_micro_batches = len(inputs)
+        inputs = self._get_cached_method("runtime.Array")(*inputs)
+        func = self._get_cached_method("runtime.disco.run_pipeline")
+        return func(
+            num_micro_batches,
+            inputs,
+            ShapeTuple(activation_shape),
+            activation_dtype,
+            profile,
+            *chunks,
+        )
+
+    def _tune_custom_allreduce(self):
+        # Choose the AllReduce strategy of each message size, when the custom AllReduce exists.
+        name = "runtime.disco.cuda_ipc.tune_custom_allreduce"
+        if get_global_func(name, allow_missing=True) is not None:
+            self.call_packed(self.get_global_func(name))
+
     def _clear_ipc_memory_pool(self):
         # Clear the IPC memory allocator when the allocator exists.
         name = "runtime.disco.cuda_ipc.cuda_ipc_memory_allocator_clear"
@@ -537,16 +730,44 @@ class ThreadedSession(Session):
 
 @register_object("runtime.disco.ProcessSession")
 class ProcessSession(Session):
-    """A Disco session backed by pipe-based multi-processing."""
+    """A Disco session backed by pipe-based multi-processing.
+
+    Parameters
+    ----------
+    num_workers : int
+        The number of workers.
+
+    num_groups : int
+        The number of worker groups.
+
+    entrypoint : str
+        The module the worker processes run.
+
+    channel : str
+        How the controller talks to the workers. "pipe" sends the messages over pipes,
+        "shm" over a single-producer single-consumer ring in shared memory per worker and
+        direction, with a futex to sleep on, saving the system calls and copies of the pipes
+        on every broadcast. "shm" is only supported on Linux.
+    """
 
     def __init__(
-        self, num_workers: int, num_groups: int = 1, entrypoint: str = "tvm.exec.disco_worker"
+        self,
+        num_workers: int,
+        num_groups: int = 1,
+        entrypoint: str = "tvm.exec.disco_worker",
+        channel: str = "pipe",
     ) -> None:
+        if channel == "pipe":
+            process_pool_creator = "runtime.disco.create_process_pool"
+        elif channel == "shm":
+            process_pool_creator = "runtime.disco.create_shared_memory_process_pool"
+        else:
+            raise ValueError(f'The channel should be "pipe" or "shm", but got "{channel}"')
         self.__init_handle_by_constructor__(
             _ffi_api.SessionProcess,  # type: ignore # pylint: disable=no-member
             num_workers,
             num_groups,
-            "runtime.disco.create_process_pool",
+            process_pool_creator,
             entrypoint,
         )
         self._configure_structlog()
@@ -582,10 +803,39 @@ def _create_socket_session_local_workers(num_workers) -> Session:
 
 @register_object("runtime.disco.SocketSession")
 class SocketSession(Session):
-    """A Disco session backed by socket-based multi-node communication."""
+    """A Disco session backed by socket-based multi-node communication.
+
+    Parameters
+    ----------
+    num_nodes : int
+        The number of nodes, including the one of the controller.
+
+    num_workers_per_node : int
+        The number of workers on each node.
+
+    num_groups : int
+        The number of worker groups.
+
+    host : str
+        The address the controller listens on for the remote nodes.
+
+    port : int
+        The port the controller listens on for the remote nodes.
+
+    transport : str
+        How the controller talks to the remote nodes after they connect. "tcp" keeps using
+        the TCP connections. "ucx" uses UCX over them, e.g. over RDMA, which requires TVM to
+        be built with USE_UCX on all the nodes.
+    """
 
     def __init__(
-        self, num_nodes: int, num_workers_per_node: int, num_groups: int, host: str, port: int
+        self,
+        num_nodes: int,
+        num_workers_per_node: int,
+        num_groups: int,
+        host: str,
+        port: int,
+        transport: str = "tcp",
     ) -> None:
         self.__init_handle_by_constructor__(
             _ffi_api.SocketSession,  # type: ignore # pylint: disable=no-member
@@ -594,6 +844,7 @@ class SocketSession(Session):
             num_groups,
             host,
             port,
+            transport,
         )
 
 
@@ -16,6 +16,8 @@
 # under the License.
 """A Python wrapper for the Module-based Model Runtime Interface for Ahead-of-Time compilation."""
 
+import ctypes
+
 import numpy as np
 
 
@@ -68,6 +70,7 @@ class AotModule(object):
         self._get_input_index = module["get_input_index"]
         self._get_num_inputs = module["get_num_inputs"]
         self._get_input_name = module["get_input_name"]
+        self._set_stream = module["set_stream"]
 
     def set_input(self, key=None, value=None, **params):
         """Set inputs to the module via kwargs
@@ -182,6 +185,22 @@ class AotModule(object):
 
         return self._get_output(index)
 
+    def set_stream(self, index, stream):
+        """Bind a device stream to a stream index of the entrypoint.
+
+        Operators are assigned to stream indices at compile time with the
+        "num-streams" option of the AOT executor.
+
+        Parameters
+        ----------
+        index : int
+            The stream index.
+
+        stream : int
+            The raw stream handle, e.g. a cudaStream_t as an integer.
+        """
+        self._set_stream(index, ctypes.c_void_p(stream))
+
     def get_input_name(self, index: int) -> str:
         """Return the name of input with index `index`"""
         return self._get_input_name(index)
@@ -294,6 +294,28 @@ class Module(object):
         """Remove all imports of the module."""
         _ffi_api.ModuleClearImports(self)
 
+    def warm_up_const_loaders(self, num_threads=0, progress_callback=None):
+        """Initialize the external modules, e.g. the BYOC ones, of the const-loader modules
+        imported by this module with their constants, concurrently, instead of at their
+        first calls.
+
+        Parameters
+        ----------
+        num_threads : int
+            The number of threads, or the maximum concurrency when not positive. Use 1 when
+            the initializations of different external modules are not thread-safe.
+
+        progress_callback : Optional[Callable[[str, int, int], None]]
+            Called with the symbol, the number of initialized symbols and the total number of
+            symbols of a const-loader module after each initialization.
+
+        Returns
+        -------
+        num_symbols : int
+            The total number of initialized symbols.
+        """
+        return _ffi_api.ConstLoaderModuleWarmUp(self, num_threads, progress_callback)
+
     def save(self, file_name, fmt=""):
         """Save the module to file.
 
@@ -411,6 +433,102 @@ class Module(object):
         except NameError:
             raise NameError("time_evaluator is only supported when RPC is enabled")
 
+    def batch_time_evaluator(
+        self,
+        func_names,
+        dev,
+        number=10,
+        repeat=1,
+        min_repeat_ms=0,
+        limit_zero_time_iterations=100,
+        cooldown_interval_ms=0,
+        repeats_to_cooldown=1,
+        cache_flush_bytes=0,
+        f_preproc="",
+    ):
+        """Get an evaluator that measures time cost of several functions taking the same arguments.
+
+        The functions are measured on the same arguments in one call, which is one round trip
+        on a remote module. They are interleaved within each repeat, starting from a different
+        function in each repeat, so that a drift of the device (e.g. thermal throttling)
+        affects all of them alike.
+
+        Parameters
+        ----------
+        func_names: List[str]
+            The names of the functions in the module.
+
+        dev: Device
+            The device we should run the functions on.
+
+        number: int
+            The number of times to run each function for taking average.
+
+        repeat: int, optional
+            The number of times to repeat the measurement.
+
+        min_repeat_ms: int, optional
+            The minimum duration of one `repeat` of a function in milliseconds.
+
+        limit_zero_time_iterations: int, optional
+            The maximum number of repeats when measured time is equal to 0.
+
+        cooldown_interval_ms: int, optional
+            The cooldown interval in milliseconds between the number of repeats defined by
+            `repeats_to_cooldown`.
+
+        repeats_to_cooldown: int, optional
+            The number of repeats before the cooldown is activated.
+
+        cache_flush_bytes: int, optional
+            The number of bytes to flush from the cache before each measurement.
+
+        f_preproc: str, optional
+            The preprocess function name we want to execute before each repeat.
+
+        Returns
+        -------
+        ftimer : function
+            The function that takes same argument as the functions and returns a list of
+            BenchmarkResult, one for each function in the order of `func_names`.
+
+        See Also
+        --------
+        time_evaluator
+        """
+        for name in func_names:
+            if "," in name:
+                raise ValueError(f"Function name {name} cannot contain a comma")
+        try:
+            feval = _ffi_api.RPCBatchTimeEvaluator(
+                self,
+                ",".join(func_names),
+                dev.device_type,
+                dev.device_id,
+                number,
+                repeat,
+                min_repeat_ms,
+                limit_zero_time_iterations,
+                cooldown_interval_ms,
+                repeats_to_cooldown,
+                cache_flush_bytes,
+                f_preproc,
+            )
+
+            def evaluator(*args):
+                """Internal wrapped evaluator."""
+                blob = feval(*args)
+                fmt = "@" + ("d" * (repeat * len(func_names)))
+                results = struct.unpack(fmt, blob)
+                return [
+                    BenchmarkResult(results[i * repeat : (i + 1) * repeat])
+                    for i in range(len(func_names))
+                ]
+
+            return evaluator
+        except NameError:
+            raise NameError("batch_time_evaluator is only supported when RPC is enabled")
+
     def _collect_from_import_tree(self, filter_func):
         """Helper function to collect modules from the tree matching a filter_func, then return it.
 
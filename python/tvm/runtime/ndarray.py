@@ -84,7 +84,7 @@ class NDArray(NDArrayBase):
         """Device of this array"""
         return self.handle.contents.device
 
-    def __dlpack__(self, stream=None):  # pylint: disable=unused-argument
+    def __dlpack__(self, stream=None):
         """Export the array for consumption by from_dlpack() as a DLPack capsule.
 
         Parameters
@@ -93,12 +93,20 @@ class NDArray(NDArrayBase):
             A Python integer representing a pointer to a stream.
             Stream is provided by the consumer to the producer to instruct the producer
             to ensure that operations can safely be performed on the array.
+            The work submitted to the stream afterwards waits for the work TVM has submitted
+            to its current stream of the device, without blocking the host. -1 skips it.
 
         Returns
         -------
         capsule : PyCapsule
             A DLPack capsule for the array, containing a DLPackManagedTensor.
         """
+        device = self.device
+        consumer_stream = _stream_from_dlpack(device, stream)
+        if consumer_stream is not None:
+            producer_stream = device.current_raw_stream()
+            if producer_stream != consumer_stream:
+                device.wait_raw_stream(producer_stream, consumer_stream)
         return self.to_dlpack()
 
     def __dlpack_device__(self):
@@ -432,12 +440,36 @@ def empty(shape, dtype="float32", device=device(Device.kDLCPU, 0), mem_scope=Non
     return arr
 
 
+def _stream_from_dlpack(device, stream):
+    """Convert the stream argument of __dlpack__ to the address of a stream of TVM.
+
+    Returns None when the array needs no synchronization.
+    """
+    if device.device_type not in (Device.kDLCUDA, Device.kDLROCM) or stream == -1:
+        return None
+    # None and 1 stand for the legacy default stream of CUDA, which is stream 0 in TVM.
+    if stream is None or (device.device_type == Device.kDLCUDA and stream == 1):
+        return 0
+    return stream
+
+
+def _stream_to_dlpack(device, stream):
+    """Convert the address of a stream of TVM to the stream argument of __dlpack__."""
+    if device.device_type == Device.kDLCUDA and stream == 0:
+        return 1
+    return stream
+
+
 def from_dlpack(dltensor):
     """Produces an array from an object with __dlpack__ method or a DLPack tensor w/o memory copy.
     Retreives the underlying DLPack tensor's pointer to create an array from the
     data. Removes the original DLPack tensor's destructor as now the array is
     responsible for destruction.
 
+    For a tensor on a CUDA or ROCm device, TVM passes its current stream of the device to
+    __dlpack__, so that the producer orders its pending work on the tensor before the work TVM
+    submits to the stream, without blocking the host.
+
     Parameters
     ----------
     dltensor : object with __dlpack__ attribute or a DLPack capsule
@@ -452,7 +484,15 @@ def from_dlpack(dltensor):
         return _from_dlpack(dltensor)
 
     if hasattr(dltensor, "__dlpack__"):
-        dlpack_caps = dltensor.__dlpack__()
+        stream = None
+        if hasattr(dltensor, "__dlpack_device__"):
+            device = Device(*dltensor.__dlpack_device__())
+            if device.device_type in (Device.kDLCUDA, Device.kDLROCM):
+                stream = _stream_to_dlpack(device, device.current_raw_stream())
+        if stream is None:
+            dlpack_caps = dltensor.__dlpack__()
+        else:
+            dlpack_caps = dltensor.__dlpack__(stream=stream)
         return _from_dlpack(dlpack_caps)
     raise AttributeError("Required attribute __dlpack__ not found")
 
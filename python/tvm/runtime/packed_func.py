@@ -26,14 +26,14 @@ try:
         raise ImportError()
     from tvm._ffi._cy3.core import _set_class_packed_func, _set_class_module
     from tvm._ffi._cy3.core import PackedFuncBase
-    from tvm._ffi._cy3.core import convert_to_tvm_func
+    from tvm._ffi._cy3.core import convert_to_tvm_func, _call_batch
 except (RuntimeError, ImportError) as error:
     # pylint: disable=wrong-import-position
     if _FFI_MODE == "cython":
         raise error
     from tvm._ffi._ctypes.packed_func import _set_class_packed_func, _set_class_module
     from tvm._ffi._ctypes.packed_func import PackedFuncBase
-    from tvm._ffi._ctypes.packed_func import convert_to_tvm_func
+    from tvm._ffi._ctypes.packed_func import convert_to_tvm_func, _call_batch
 
 
 PackedFuncHandle = ctypes.c_void_p
@@ -62,4 +62,28 @@ class PackedFunc(PackedFuncBase):
     """
 
 
+def call_batch(calls):
+    """Call a sequence of functions with a single crossing of the FFI boundary.
+
+    It amortizes the cost of the FFI call in host loops issuing many small calls,
+    e.g. the builtins driving a VM per generated token.
+
+    Parameters
+    ----------
+    calls : List[Tuple[PackedFunc, Sequence]]
+        The functions to call in order, each with its positional arguments.
+
+    Returns
+    -------
+    results : List
+        The return value of each call.
+
+    Note
+    ----
+    The calls stop at the first failure, whose error is raised. Strings are returned
+    as :py:class:`tvm.runtime.String`, and functions returning bytes are not supported.
+    """
+    return _call_batch([(func, tuple(args)) for func, args in calls])
+
+
 _set_class_packed_func(PackedFunc)
@@ -31,7 +31,7 @@ def _to_ndarray(params):
     return transformed
 
 
-def save_param_dict(params):
+def save_param_dict(params, alignment=0):
     """Save parameter dictionary to binary bytes.
 
     The result binary bytes can be loaded by the
@@ -42,6 +42,11 @@ def save_param_dict(params):
     params : dict of str to NDArray
         The parameter dictionary.
 
+    alignment : int
+        The alignment of the data of each parameter, e.g. 4096 to align them to pages.
+        The parameters saved with an alignment are also checked with CRC32 checksums
+        when loaded. When it is 0, the data are saved unaligned and without checksums.
+
     Returns
     -------
     param_bytes: bytearray
@@ -59,10 +64,10 @@ def save_param_dict(params):
        # Pass in byte array to module to directly set parameters
        tvm.runtime.load_param_dict(param_bytes)
     """
-    return _ffi_api.SaveParams(_to_ndarray(params))
+    return _ffi_api.SaveParams(_to_ndarray(params), alignment)
 
 
-def save_param_dict_to_file(params, path):
+def save_param_dict_to_file(params, path, alignment=0):
     """Save parameter dictionary to file.
 
     Parameters
@@ -72,8 +77,11 @@ def save_param_dict_to_file(params, path):
 
     path: str
         The path to the parameter file.
+
+    alignment : int
+        The alignment of the data of each parameter, see :py:func:`save_param_dict`.
     """
-    return _ffi_api.SaveParamsToFile(_to_ndarray(params), path)
+    return _ffi_api.SaveParamsToFile(_to_ndarray(params), path, alignment)
 
 
 def load_param_dict(param_bytes):
@@ -16,6 +16,7 @@
 # under the License.
 """Registration of profiling objects in python."""
 
+import json
 from typing import Dict, Sequence, Optional
 from ... import _ffi
 from . import _ffi_api
@@ -270,6 +271,30 @@ def profile_function(mod, dev, collectors, func_name=None, warmup_iters=10):
     )
 
 
+def sampled_call_stats() -> Dict:
+    """Get the statistics of the calls made in the sampled invocations of the
+    Relax VMs of this process, see
+    :py:meth:`tvm.runtime.relax_vm.VirtualMachine.set_sample_interval`.
+
+    Meant to be polled by a metrics exporter.  Bucket `i` of the histogram of a
+    function counts the calls that took from `2**i` to `2**(i + 1)`
+    nanoseconds, and the last bucket all the longer calls.
+
+    Returns
+    -------
+    stats: Dict
+        Maps "functions" to the "count", "total_ns", "max_ns" and "buckets"
+        of the calls to each function, and "dropped" to the number of calls
+        that were not recorded, as the timers were not read in time.
+    """
+    return json.loads(_ffi_api.SampledCallStats())
+
+
+def reset_sampled_call_stats():
+    """Reset the statistics returned by :py:func:`sampled_call_stats`."""
+    _ffi_api.ResetSampledCallStats()
+
+
 # We only enable this class when TVM is build with PAPI support
 if _ffi.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=True) is not None:
 
@@ -292,3 +317,22 @@ if _ffi.get_global_func("runtime.profiling.PAPIMetricCollector", allow_missing=T
             for dev, names in metric_names.items():
                 wrapped[DeviceWrapper(dev)] = names
             self.__init_handle_by_constructor__(_ffi_api.PAPIMetricCollector, wrapped)
+
+
+# We only enable this class when TVM is build with CUPTI support
+if _ffi.get_global_func("runtime.profiling.CUPTIMetricCollector", allow_missing=True) is not None:
+
+    @_ffi.register_object("runtime.profiling.CUPTIMetricCollector")
+    class CUPTIMetricCollector(MetricCollector):
+        """Collects the device time and the number of the kernels of each call
+        from the activity records of the CUDA Profiling Tools Interface (CUPTI).
+
+        Unlike the per-call timer, the kernels are attributed through the CUDA
+        launch APIs, so the kernels of external libraries such as cuBLAS and of
+        CUDA graph replays count towards the call that launched them. The
+        records are read once profiling stops, so the calls are not synchronized
+        one by one.
+        """
+
+        def __init__(self):
+            self.__init_handle_by_constructor__(_ffi_api.CUPTIMetricCollector)
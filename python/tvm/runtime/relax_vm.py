@@ -16,6 +16,7 @@
 # under the License.
 # pylint: disable=invalid-name, redefined-builtin, no-else-return, consider-using-dict-items
 """The Relax virtual machine."""
+import json
 from enum import IntEnum
 from typing import Any, Callable, Dict, List, Optional, Tuple, Union
 
@@ -36,11 +37,175 @@ class VMInstrumentReturnKind(IntEnum):
     SKIP_RUN = 1
 
 
+class MemoryTimeline:
+    """The allocations made by a VM between
+    :py:meth:`VirtualMachine.start_memory_timeline` and
+    :py:meth:`VirtualMachine.stop_memory_timeline`.
+
+    Attributes
+    ----------
+    events : List[Dict]
+        The allocations in the order they were made, each with the "function"
+        and the "instr" index of the instruction in it that allocated, the
+        "device", "nbytes", "scope", and "alloc_ns" and "free_ns" since the
+        recording started, where "free_ns" is -1 if it was still live when the
+        recording stopped.  The allocations of constant size also have the
+        "token" of the memory planner they were allocated for, their index
+        among the constant-size allocations of their function.
+
+    static_allocs : List[Dict]
+        The constant-size allocations of the functions of the executable, as
+        planned by StaticPlanBlockMemory, each with its "function", "instr",
+        "token" and "nbytes".
+    """
+
+    def __init__(self, timeline_json: str):
+        timeline = json.loads(timeline_json)
+        self.static_allocs = timeline["static_allocs"]
+        tokens = {
+            (alloc["function"], alloc["instr"]): alloc["token"] for alloc in self.static_allocs
+        }
+        self.events = timeline["events"]
+        for event in self.events:
+            event["token"] = tokens.get((event["function"], event["instr"]), -1)
+
+    @staticmethod
+    def _peak_of(events: List[Dict]) -> Tuple[int, int]:
+        """The peak of the live bytes of the events, and when it was reached."""
+        # Sweep the allocations and frees in time, the frees first on ties.
+        changes = sorted(
+            [(event["alloc_ns"], 1, event["nbytes"]) for event in events]
+            + [(event["free_ns"], 0, -event["nbytes"]) for event in events if event["free_ns"] >= 0]
+        )
+        live_bytes, peak_bytes, peak_ns = 0, 0, 0
+        for time_ns, _, delta in changes:
+            live_bytes += delta
+            if live_bytes > peak_bytes:
+                peak_bytes, peak_ns = live_bytes, time_ns
+        return peak_bytes, peak_ns
+
+    def peak(self) -> Dict[str, Tuple[int, List[Dict]]]:
+        """Get the peak of the live bytes of each device.
+
+        Returns
+        -------
+        peak : Dict[str, Tuple[int, List[Dict]]]
+            Maps each device to its peak live bytes, and the events live at
+            the peak, largest first.
+        """
+        result = {}
+        for device in sorted({event["device"] for event in self.events}):
+            events = [event for event in self.events if event["device"] == device]
+            peak_bytes, peak_ns = self._peak_of(events)
+            live = [
+                event
+                for event in events
+                if event["alloc_ns"] <= peak_ns and not 0 <= event["free_ns"] <= peak_ns
+            ]
+            result[device] = (peak_bytes, sorted(live, key=lambda event: -event["nbytes"]))
+        return result
+
+    def compare_with_plan(self) -> List[Dict]:
+        """Cross-check the allocations of each function with the plan.
+
+        Returns
+        -------
+        comparison : List[Dict]
+            For each function that allocated, its "planned_bytes", the total of
+            its constant-size allocations, its "static_peak_bytes", the peak of
+            the live bytes of these allocations, and its "dynamic_peak_bytes",
+            the peak of the live bytes of its other allocations.
+        """
+        planned: Dict[str, int] = {}
+        for alloc in self.static_allocs:
+            planned[alloc["function"]] = planned.get(alloc["function"], 0) + alloc["nbytes"]
+
+        result = []
+        for func in sorted({event["function"] for event in self.events}):
+            events = [event for event in self.events if event["function"] == func]
+            result.append(
+                {
+                    "function": func,
+                    "planned_bytes": planned.get(func, 0),
+                    "static_peak_bytes": self._peak_of([e for e in events if e["token"] >= 0])[0],
+                    "dynamic_peak_bytes": self._peak_of([e for e in events if e["token"] < 0])[0],
+                }
+            )
+        return result
+
+    def table(self, top: int = 10) -> str:
+        """Format the peak of each device with its largest live allocations, and the
+        comparison with the plan."""
+        lines = []
+        for device, (peak_bytes, live) in self.peak().items():
+            lines.append(f"{device}: peak {peak_bytes} bytes live, in {len(live)} allocations")
+            for event in live[:top]:
+                site = f"{event['function'] or '<host>'}[{event['instr']}]"
+                token = f"token {event['token']}" if event["token"] >= 0 else "dynamic"
+                lines.append(f"  {event['nbytes']:>14} bytes  {site}  {token}  {event['scope']}")
+        for row in self.compare_with_plan():
+            lines.append(
+                f"{row['function'] or '<host>'}: planned {row['planned_bytes']} bytes, "
+                f"static peak {row['static_peak_bytes']} bytes, "
+                f"dynamic peak {row['dynamic_peak_bytes']} bytes"
+            )
+        return "\n".join(lines)
+
+    def to_chrome_trace(self) -> str:
+        """Convert the timeline to the Chrome trace event format, with the live bytes of
+        each device as a counter and each allocation as a slice of its lifetime.
+
+        Returns
+        -------
+        trace : str
+            The trace as json, to be loaded in chrome://tracing or Perfetto.
+        """
+        end_ns = max(
+            [max(event["alloc_ns"], event["free_ns"]) for event in self.events], default=0
+        )
+        devices = sorted({event["device"] for event in self.events})
+        trace = []
+        for pid, device in enumerate(devices):
+            trace.append({"name": "process_name", "ph": "M", "pid": pid, "args": {"name": device}})
+            changes = []
+            for event in self.events:
+                if event["device"] != device:
+                    continue
+                free_ns = event["free_ns"] if event["free_ns"] >= 0 else end_ns
+                changes += [(event["alloc_ns"], event["nbytes"]), (free_ns, -event["nbytes"])]
+                trace.append(
+                    {
+                        "name": f"{event['function'] or '<host>'}[{event['instr']}]",
+                        "ph": "X",
+                        "ts": event["alloc_ns"] / 1e3,
+                        "dur": (free_ns - event["alloc_ns"]) / 1e3,
+                        "pid": pid,
+                        "tid": 1,
+                        "args": event,
+                    }
+                )
+            live_bytes = 0
+            for time_ns, delta in sorted(changes, key=lambda change: (change[0], change[1])):
+                live_bytes += delta
+                trace.append(
+                    {
+                        "name": "live bytes",
+                        "ph": "C",
+                        "ts": time_ns / 1e3,
+                        "pid": pid,
+                        "args": {"bytes": live_bytes},
+                    }
+                )
+        return json.dumps({"traceEvents": trace, "displayTimeUnit": "ns"})
+
+
 class VirtualMachine(object):
     """Relax VM runtime."""
 
     NAIVE_ALLOCATOR = 1
     POOLED_ALLOCATOR = 2
+    BUCKETED_ALLOCATOR = 3
+    STREAM_ORDERED_ALLOCATOR = 4
 
     def __init__(
         self,
@@ -62,8 +227,8 @@ class VirtualMachine(object):
 
         memory_cfg : Optional[Union[str, Dict[Device, str]]]
             Config the type of memory allocator. The allocator type can be ["naive",
-            "pooled"]. If memory_cfg is None, all devices will use pooled allocator
-            by default. If memory_cfg is string, all devices will use the specified
+            "pooled", "bucketed", "stream_ordered"]. If memory_cfg is None, all devices will use
+            pooled allocator by default. If memory_cfg is string, all devices will use the specified
             allocator type. If memory_cfg is a dict, each device uses the allocator
             type specified in the dict, or pooled allocator if not specified in the
             dict.
@@ -84,7 +249,12 @@ class VirtualMachine(object):
                 raise ValueError("Expect the rt_mod to be an runtime.Module")
 
         load_exec = "vm_profiler_load_executable" if profile else "vm_load_executable"
-        self.module = rt_mod[load_exec]()
+        self._bind_module(rt_mod[load_exec]())
+        self._setup_device(device, memory_cfg)
+
+    def _bind_module(self, module: tvm.runtime.Module) -> None:
+        """Cache the functions of the underlying VM module."""
+        self.module = module
         self._invoke_closure = self.module["invoke_closure"]
         self._save_function = self.module["save_function"]
         self._set_input = self.module["set_input"]
@@ -94,7 +264,6 @@ class VirtualMachine(object):
         self._get_function_arity = self.module["get_function_arity"]
         self._get_function_param_name = self.module["get_function_param_name"]
         self._set_instrument = self.module["set_instrument"]
-        self._setup_device(device, memory_cfg)
 
     def _setup_device(self, dev: Device, memory_cfg: Union[str, Dict[Device, str]]) -> None:
         """init devices and allocators."""
@@ -115,9 +284,13 @@ class VirtualMachine(object):
         if memory_cfg is None:
             memory_cfg = {}
         elif isinstance(memory_cfg, str):
-            assert memory_cfg in ["naive", "pooled"]
+            assert memory_cfg in ["naive", "pooled", "bucketed", "stream_ordered"]
             if memory_cfg == "naive":
                 default_alloc_type = VirtualMachine.NAIVE_ALLOCATOR
+            elif memory_cfg == "bucketed":
+                default_alloc_type = VirtualMachine.BUCKETED_ALLOCATOR
+            elif memory_cfg == "stream_ordered":
+                default_alloc_type = VirtualMachine.STREAM_ORDERED_ALLOCATOR
             memory_cfg = {}
         elif not isinstance(memory_cfg, dict):
             raise TypeError(
@@ -135,6 +308,76 @@ class VirtualMachine(object):
     def __getitem__(self, key: str) -> PackedFunc:
         return self.module[key]
 
+    def create_execution_context(self) -> "VirtualMachine":
+        """Create an execution context of the VM.
+
+        The context shares the loaded executable, the constants and the allocators
+        with this VM, and owns its call frames and a stream on each device. Invocations
+        on different contexts can run concurrently from different threads, or be
+        launched with :py:meth:`invoke_async`.
+
+        Returns
+        -------
+        ctx : VirtualMachine
+            The execution context, which can be used like the VM itself.
+        """
+        ctx = VirtualMachine.__new__(VirtualMachine)
+        ctx._bind_module(self.module["create_execution_context"]())
+        return ctx
+
+    def set_external_stream(self, device: Device, stream: Optional[int]) -> None:
+        """Run the invocations in the stream order of an external stream of a device,
+        e.g. the current stream of PyTorch, in place of synchronizing with the host.
+
+        The VM runs on the external stream itself, an execution context waits for the work
+        submitted to it before each invocation and makes it wait for the outputs after,
+        with events which do not block the host. The inputs produced and the outputs
+        consumed on the stream need no synchronization, e.g. in
+        ``tvm.nd.from_dlpack(torch_tensor)`` or ``torch.from_dlpack(output)`` when
+        the streams are current.
+
+        Parameters
+        ----------
+        device : tvm.runtime.Device
+            A device the VM is initialized on.
+
+        stream : Optional[int]
+            The address of the stream, in the convention of the stream argument of
+            ``__dlpack__``, or None to run on the current stream of TVM again.
+        """
+        if stream is None:
+            stream = -1
+        elif device.device_type == Device.kDLCUDA and stream == 1:
+            # The legacy default stream of CUDA.
+            stream = 0
+        device_type = device.device_type % RPC_SESS_MASK
+        self.module["set_external_stream"](device_type, device.device_id, stream)
+
+    def invoke_async(self, func_name: str, *args: Any) -> Callable[[], Any]:
+        """Invoke a function on a background thread.
+
+        Invocations on the same VM or context are serialized, use one context per
+        concurrent request to overlap them.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function.
+
+        args : list[tvm.runtime.NDArray] or list[np.ndarray]
+            The arguments to the function.
+
+        Returns
+        -------
+        wait : Callable[[], Any]
+            A function that blocks until the invocation finishes and returns its result.
+            The device work of the invocation is complete when it returns.
+        """
+        cargs: List[Any] = []
+        for arg in args:
+            self._convert(arg, cargs)
+        return self.module["invoke_async"](func_name, *cargs)
+
     def invoke_closure(self, closure: Object, *args: Any) -> Object:
         """Invoke a closure.
 
@@ -334,7 +577,7 @@ class VirtualMachine(object):
 
         return get_output_rec(func_name)
 
-    def set_instrument(self, instrument: tvm.runtime.PackedFunc) -> None:
+    def set_instrument(self, instrument: Union[tvm.runtime.PackedFunc, str], *args) -> None:
         """Set an instrumentation function.
 
         If instrument is present, the function will be called
@@ -365,14 +608,82 @@ class VirtualMachine(object):
 
         Parameters
         ----------
-        instrument: tvm.runtime.PackedFunc
-            A instrumentation function that get invoked every VM call instr.
+        instrument: Union[tvm.runtime.PackedFunc, str]
+            A instrumentation function that get invoked every VM call instr,
+            or the name of a global function that creates the instrument,
+            e.g. "vm.builtin.memory_manager.stats_instrument".
+
+        args:
+            The arguments passed to the instrument factory.
 
         See Also
         --------
         VMInstrumentReturnKind: the possible return values in VM.
         """
-        self._set_instrument(instrument)
+        self._set_instrument(instrument, *args)
+
+    def start_memory_timeline(self) -> None:
+        """Start recording the allocations made through the allocators of the VM,
+        with their call site and when they are freed."""
+        self.module["start_memory_timeline"]()
+
+    def stop_memory_timeline(self) -> MemoryTimeline:
+        """Stop recording the allocations.
+
+        Returns
+        -------
+        timeline : MemoryTimeline
+            The allocations made since :py:meth:`start_memory_timeline`.
+        """
+        return MemoryTimeline(self.module["stop_memory_timeline"]())
+
+    def set_sample_interval(self, interval: int) -> None:
+        """Time the calls of one in every `interval` invocations.
+
+        The calls of the sampled invocations are timed without synchronizing
+        the devices, and aggregated into a histogram per function.  Use
+        :py:func:`tvm.runtime.profiling.sampled_call_stats` to read them.
+
+        Parameters
+        ----------
+        interval: int
+            Sample one in this many invocations, or none if 0.
+        """
+        self.module["set_sample_interval"](interval)
+
+    def set_trusted_inputs(self, trusted: bool) -> None:
+        """Skip the struct info checks of the params at the entry of the functions.
+
+        The shape computations at the entry of a function are restored from a
+        cache when the params have the shapes of the previous call, so the checks
+        only run when the shapes change. Trusting the inputs skips them then too.
+
+        Parameters
+        ----------
+        trusted: bool
+            Whether the inputs are trusted to match the struct info of the params.
+        """
+        self.module["set_trusted_inputs"](trusted)
+
+    def set_specialize_hook(self, hook: Optional[Callable[..., Any]], threshold: int = 8) -> None:
+        """Compile variants of the TIR functions specialized to the shapes they are called with.
+
+        Once a TIR function, called directly or through ``vm.builtin.call_tir_dyn``, is called
+        `threshold` times with the same argument shapes, `hook` is invoked on a background
+        thread with the name of the function, the shapes of its tensor arguments and the
+        values of its integer arguments. It returns the specialized function, or None to keep
+        the generic one, and the calls with these shapes invoke the variant once it is ready.
+        See :py:class:`tvm.relax.PrimFuncSpecializer`.
+
+        Parameters
+        ----------
+        hook: Optional[Callable[[str, List[ShapeTuple], ShapeTuple], Optional[PackedFunc]]]
+            The hook compiling the variants, or None to stop specializing.
+
+        threshold: int
+            The number of calls with the same shapes before specializing.
+        """
+        self.module["set_specialize_hook"](hook, threshold)
 
     def time_evaluator(
         self,
@@ -342,8 +342,8 @@ class VirtualMachine(object):
 
     memory_cfg : str or Dict[tvm.runtime.Device, str], optional
         Config the type of memory allocator. The allocator type can be ["naive",
-        "pooled"]. If memory_cfg is None, all devices will use pooled allocator
-        by default. If memory_cfg is string, all devices will use the specified
+        "pooled", "bucketed", "stream_ordered"]. If memory_cfg is None, all devices will use
+        pooled allocator by default. If memory_cfg is string, all devices will use the specified
         allocator type. If memory_cfg is a dict, each device uses the allocator
         type specified in the dict, or pooled allocator if not specified in the
         dict.
@@ -351,6 +351,8 @@ class VirtualMachine(object):
 
     NAIVE_ALLOCATOR = 1
     POOLED_ALLOCATOR = 2
+    BUCKETED_ALLOCATOR = 3
+    STREAM_ORDERED_ALLOCATOR = 4
 
     def __init__(self, exe, device, memory_cfg=None):
         """
@@ -418,9 +420,13 @@ class VirtualMachine(object):
         if memory_cfg is None:
             memory_cfg = {}
         elif isinstance(memory_cfg, str):
-            assert memory_cfg in ["naive", "pooled"]
+            assert memory_cfg in ["naive", "pooled", "bucketed", "stream_ordered"]
             if memory_cfg == "naive":
                 default_alloc_type = VirtualMachine.NAIVE_ALLOCATOR
+            elif memory_cfg == "bucketed":
+                default_alloc_type = VirtualMachine.BUCKETED_ALLOCATOR
+            elif memory_cfg == "stream_ordered":
+                default_alloc_type = VirtualMachine.STREAM_ORDERED_ALLOCATOR
             memory_cfg = {}
         elif not isinstance(memory_cfg, dict):
             raise TypeError(
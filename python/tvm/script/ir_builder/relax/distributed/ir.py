@@ -34,6 +34,7 @@ from tvm.relax.op.distributed import (
     annotate_sharding as _annotate_sharding,
     call_tir_local_view,
     redistribute_replica_to_shard,
+    ring_attention,
 )
 from tvm.relax.distributed import DeviceMesh, Placement
 from . import _ffi_api
@@ -58,6 +58,7 @@ from tvm.relax.op import (
     bitwise_or,
     bitwise_xor,
     broadcast_to,
+    bsr_matmul,
     builtin,
     call_builtin_with_ctx,
     call_dps_packed,
@@ -159,6 +160,7 @@ from tvm.relax.op import (
     squeeze,
     std,
     strided_slice,
+    structured_sparse_matmul,
     subtract,
     sum,
     take,
@@ -723,6 +725,7 @@ __all__ = [
     "bitwise_or",
     "bitwise_xor",
     "broadcast_to",
+    "bsr_matmul",
     "builtin",
     "call_inplace_packed",
     "call_packed",
@@ -852,6 +855,7 @@ __all__ = [
     "stop_lift_params",
     "str",
     "strided_slice",
+    "structured_sparse_matmul",
     "dynamic_strided_slice",
     "subtract",
     "take",
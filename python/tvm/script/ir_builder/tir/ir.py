@@ -1893,6 +1893,11 @@ ptx_init_barrier_thread_count = _op_wrapper(_tir_op.ptx_init_barrier_thread_coun
 ptx_arrive_barrier = _op_wrapper(_tir_op.ptx_arrive_barrier)
 ptx_arrive_barrier_expect_tx = _op_wrapper(_tir_op.ptx_arrive_barrier_expect_tx)
 ptx_wait_barrier = _op_wrapper(_tir_op.ptx_wait_barrier)
+ptx_wgmma_encode_desc = _op_wrapper(_tir_op.ptx_wgmma_encode_desc)
+ptx_wgmma_fence = _op_wrapper(_tir_op.ptx_wgmma_fence)
+ptx_wgmma_commit_group = _op_wrapper(_tir_op.ptx_wgmma_commit_group)
+ptx_wgmma_wait_group = _op_wrapper(_tir_op.ptx_wgmma_wait_group)
+ptx_setmaxnreg = _op_wrapper(_tir_op.ptx_setmaxnreg)
 make_filled_simdgroup_matrix = _op_wrapper(_tir_op.make_filled_simdgroup_matrix)
 simdgroup_load = _op_wrapper(_tir_op.simdgroup_load)
 simdgroup_store = _op_wrapper(_tir_op.simdgroup_store)
@@ -1932,6 +1937,8 @@ ptx_mma_sp = _dtype_forward(_tir_op.ptx_mma_sp)
 ptx_ldmatrix = _dtype_forward(_tir_op.ptx_ldmatrix)
 ptx_cp_async = _dtype_forward(_tir_op.ptx_cp_async)
 ptx_cp_async_bulk = _dtype_forward(_tir_op.ptx_cp_async_bulk)
+ptx_cp_async_bulk_tensor = _dtype_forward(_tir_op.ptx_cp_async_bulk_tensor)
+ptx_wgmma = _dtype_forward(_tir_op.ptx_wgmma)
 mma_store = _dtype_forward(_tir_op.mma_store)
 mma_fill = _dtype_forward(_tir_op.mma_fill)
 vectorlow = _dtype_forward(_tir_op.vectorlow)
@@ -2180,6 +2187,7 @@ __all__ = [
     "ptx_ldmatrix",
     "ptx_cp_async",
     "ptx_cp_async_bulk",
+    "ptx_cp_async_bulk_tensor",
     "ptx_wait_group",
     "ptx_commit_group",
     "ptx_cp_async_barrier",
@@ -2187,6 +2195,12 @@ __all__ = [
     "ptx_arrive_barrier",
     "ptx_arrive_barrier_expect_tx",
     "ptx_wait_barrier",
+    "ptx_wgmma_encode_desc",
+    "ptx_wgmma",
+    "ptx_wgmma_fence",
+    "ptx_wgmma_commit_group",
+    "ptx_wgmma_wait_group",
+    "ptx_setmaxnreg",
     "make_filled_simdgroup_matrix",
     "simdgroup_load",
     "simdgroup_store",
@@ -32,6 +32,7 @@ from tvm.script.ir_builder.relax.distributed import (
     redistribute,
     redistribute_replica_to_shard,
     call_tir_local_view,
+    ring_attention,
 )
 from .entry import StructInfoProxy, TensorProxy
 
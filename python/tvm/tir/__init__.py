@@ -65,6 +65,7 @@ from .op import (
     ptx_ldmatrix,
     ptx_cp_async,
     ptx_cp_async_bulk,
+    ptx_cp_async_bulk_tensor,
     ptx_commit_group,
     ptx_wait_group,
     ptx_cp_async_barrier,
@@ -72,6 +73,12 @@ from .op import (
     ptx_arrive_barrier,
     ptx_arrive_barrier_expect_tx,
     ptx_wait_barrier,
+    ptx_wgmma_encode_desc,
+    ptx_wgmma,
+    ptx_wgmma_fence,
+    ptx_wgmma_commit_group,
+    ptx_wgmma_wait_group,
+    ptx_setmaxnreg,
     create_barriers,
 )
 from .op import (
@@ -101,6 +108,7 @@ from .generic import add, subtract, multiply
 
 from .schedule import StmtSRef, BlockScope, ScheduleState, Schedule, ScheduleError
 from .block_dependence_info import BlockDependenceInfo
+from .shape_profile import ShapeProfile
 
 from . import schedule
 from . import ir_builder
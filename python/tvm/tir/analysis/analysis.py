@@ -16,7 +16,7 @@
 # under the License.
 """Wrapping existing analysis utils."""
 # pylint: disable=invalid-name
-from typing import Dict, List, Optional, Union
+from typing import Callable, Dict, List, Optional, Union
 
 import tvm
 from tvm import Object
@@ -369,6 +369,27 @@ def verify_well_formed(obj: Union[PrimFunc, IRModule], assert_mode: bool = True)
     return _ffi_api.VerifyWellFormed(obj, assert_mode)  # type: ignore # pylint: disable=no-member
 
 
+def incremental_verify_well_formed(assert_mode: bool = True) -> Callable[[IRModule], bool]:
+    """Create an incremental well-formedness verifier for the modules of a pass pipeline.
+
+    The verifier keeps the PrimFuncs of the last module found well-formed, so that each
+    module only has the PrimFuncs added or changed since verified. A variable defined both
+    in a changed PrimFunc and in an unchanged one is not detected.
+
+    Parameters
+    ----------
+    assert_mode: bool
+        The indicator if it raises an error when a function is not well-formed.
+
+    Returns
+    -------
+    verify: Callable[[tvm.ir.IRModule], bool]
+        The function verifying if the TIR in a module is well-formed.
+    """
+    func = _ffi_api.IncrementalVerifyWellFormed  # type: ignore # pylint: disable=no-member
+    return func(assert_mode)
+
+
 def OOBChecker():
     """Detect out of bounds memory access in arrays.
 
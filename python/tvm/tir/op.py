@@ -1426,6 +1426,49 @@ def ptx_cp_async_bulk(
     )
 
 
+def ptx_cp_async_bulk_tensor(dtype, shared_ptr, shared_offset, tensor_map, barrier_id, *coords):
+    """TVM intrinsic for ptx async copy of a tile of a tensor from global to shared memory
+    using the TMA unit, cp.async.bulk.tensor
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#data-movement-and-conversion-instructions-cp-async-bulk-tensor
+
+    Parameters
+    ----------
+    dtype : str
+       The data type of the result.
+
+    shared_ptr : Var
+        The shared memory pointer variable.
+
+    shared_offset : Expr
+        The offset of shared memory pointer.
+
+    tensor_map : Var
+        The pointer to the CUtensorMap of the tensor, as encoded by
+        ``runtime.cuda.encode_tensor_map_tiled``.
+
+    barrier_id : int
+        The ID of the barrier shared memory pointer.
+
+    coords : List[Expr]
+        The coordinates of the tile in elements, from the outermost dimension of the
+        tensor to the innermost one.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        dtype,
+        "tir.ptx_cp_async_bulk_tensor",
+        shared_ptr,
+        shared_offset,
+        tensor_map,
+        barrier_id,
+        *coords,
+    )
+
+
 def ptx_commit_group():
     """TVM intrinsic for ptx async copy commit
     https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#data-movement-and-conversion-instructions-cp-async-commit-group
@@ -1531,7 +1574,7 @@ def ptx_arrive_barrier_expect_tx(barrier_id, byte_count):
     return call_intrin("", "tir.ptx_arrive_barrier_expect_tx", barrier_id, byte_count)
 
 
-def ptx_wait_barrier(barrier_id):
+def ptx_wait_barrier(barrier_id, phase=None):
     """TVM intrinsic for ptx barrier wait using mbarrier.try_wait
     https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#parallel-synchronization-and-communication-instructions-mbarrier-test-wait-mbarrier-try-wait
 
@@ -1540,12 +1583,198 @@ def ptx_wait_barrier(barrier_id):
     barrier_id : int
         The ID of the barrier shared memory pointer.
 
+    phase : Optional[Expr]
+        The parity of the phase to wait for, 0 when not given. The parity flips each
+        time the barrier completes, e.g. at each stage of a pipeline reusing it.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    if phase is None:
+        return call_intrin("", "tir.ptx_wait_barrier", barrier_id)
+    return call_intrin("", "tir.ptx_wait_barrier", barrier_id, phase)
+
+
+def ptx_wgmma_encode_desc(
+    shared_ptr, shared_offset, leading_byte_offset, stride_byte_offset, swizzle_bytes
+):
+    """TVM intrinsic for the matrix descriptor of a wgmma operand in shared memory
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-shared-memory-layout-matrix-descriptor
+
+    Parameters
+    ----------
+    shared_ptr : Var
+        The shared memory pointer variable.
+
+    shared_offset : Expr
+        The offset of shared memory pointer.
+
+    leading_byte_offset : Expr
+        The byte offset between the core matrices along the leading dimension.
+
+    stride_byte_offset : Expr
+        The byte offset between the core matrices along the strided dimension.
+
+    swizzle_bytes : int
+        0 for no swizzle, or 32, 64 and 128 for the swizzle modes of the TMA copy
+        which wrote the operand.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        "uint64",
+        "tir.ptx_wgmma_encode_desc",
+        shared_ptr,
+        shared_offset,
+        leading_byte_offset,
+        stride_byte_offset,
+        swizzle_bytes,
+    )
+
+
+def ptx_wgmma(
+    dtype,
+    shape,
+    A_layout,
+    B_layout,
+    A_dtype,
+    B_dtype,
+    C_dtype,
+    desc_a,
+    desc_b,
+    accumulator,
+    c_index,
+    scale_out,
+):
+    """TVM intrinsic for ptx warpgroup level async tensor core MMA, wgmma.mma_async, with both
+    multiplicands in shared memory
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-mma-async
+
+    Parameters
+    ----------
+    dtype : str
+        The data type of the result.
+
+    shape : str
+        The shape of mma fragment, m64nNkK.
+
+    A_layout : Literal["row", "col"]
+        The layout of multiplicand A, row for K-major.
+
+    B_layout : Literal["row", "col"]
+        The layout of multiplicand B, col for K-major.
+
+    A_dtype : str
+        The data type of multiplicand A.
+
+    B_dtype : str
+        The data type of multiplicand B.
+
+    C_dtype : str
+        The data type of the accumulators.
+
+    desc_a : Expr
+        The matrix descriptor of A, see :py:func:`ptx_wgmma_encode_desc`.
+
+    desc_b : Expr
+        The matrix descriptor of B.
+
+    accumulator : Var
+        The accumulator fragment C variable of the thread.
+
+    c_index : Expr
+        The index of accumulator fragment C.
+
+    scale_out : Expr
+        Whether the product is added to the accumulators, rather than overwriting them.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin(
+        dtype,
+        "tir.ptx_wgmma",
+        shape,
+        A_layout,
+        B_layout,
+        A_dtype,
+        B_dtype,
+        C_dtype,
+        desc_a,
+        desc_b,
+        accumulator,
+        c_index,
+        scale_out,
+    )
+
+
+def ptx_wgmma_fence():
+    """TVM intrinsic for ordering the accesses of the accumulators before wgmma
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-fence
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_wgmma_fence")
+
+
+def ptx_wgmma_commit_group():
+    """TVM intrinsic for committing the pending wgmma operations into a group
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-commit-group
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_wgmma_commit_group")
+
+
+def ptx_wgmma_wait_group(num):
+    """TVM intrinsic for waiting on the groups of wgmma operations
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#asynchronous-warpgroup-level-matrix-instructions-wgmma-wait-group
+
+    Parameters
+    ----------
+    num : int
+        The number of the most recent wgmma groups which may still be pending.
+
+    Returns
+    -------
+    call : PrimExpr
+        The call expression.
+    """
+    return call_intrin("", "tir.ptx_wgmma_wait_group", num)
+
+
+def ptx_setmaxnreg(is_inc, reg_count):
+    """TVM intrinsic changing the number of registers per thread of a warp, to move registers
+    from the producer warps to the consumer warps of a warp specialized kernel
+    https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#miscellaneous-instructions-setmaxnreg
+
+    Parameters
+    ----------
+    is_inc : bool
+        Whether the register count is increased, rather than decreased, to reg_count.
+
+    reg_count : int
+        The number of registers per thread, a multiple of 8 in [24, 256].
+
     Returns
     -------
     call : PrimExpr
         The call expression.
     """
-    return call_intrin("", "tir.ptx_wait_barrier", barrier_id)
+    return call_intrin("", "tir.ptx_setmaxnreg", is_inc, reg_count)
 
 
 def create_barriers(barrier_count):
@@ -0,0 +1,218 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Runtime shape profiles for specializing PrimFuncs with symbolic shapes."""
+import collections
+import json
+from typing import Dict, List, Sequence, Tuple
+
+from tvm.ir import IRModule
+
+from . import op as _op
+from .expr import EQ, IntImm, Var
+from .function import PrimFunc
+
+# A bucket maps the name of a shape variable to ("eq", value) or ("mod", factor).
+Bucket = Dict[str, Tuple[str, int]]
+
+
+class ShapeProfile:
+    """Counts the runtime values of the symbolic shapes of PrimFuncs.
+
+    The recorded shapes are turned into shape buckets, the ``"tir.shape_buckets"`` attribute
+    that the ``SpecializeShapeBuckets`` pass of the default lowering pipeline multi-versions the
+    functions for. The most frequent shapes are specialized to static shapes, and the largest
+    factors dividing enough of the shapes remove the tail predicates of tiled loops.
+    """
+
+    def __init__(self):
+        self._counts: Dict[str, collections.Counter] = {}
+
+    def record(self, func_name: str, shape: Dict[str, int], count: int = 1) -> None:
+        """Record a call of a function.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function in its IRModule.
+        shape : Dict[str, int]
+            The values of the symbolic shape variables, by variable name.
+        count : int
+            The number of calls with this shape.
+        """
+        key = tuple(sorted((name, int(value)) for name, value in shape.items()))
+        self._counts.setdefault(func_name, collections.Counter())[key] += count
+
+    def record_args(self, func_name: str, func: PrimFunc, args: Sequence) -> None:
+        """Record a call of a function from its arguments.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function in its IRModule.
+        func : PrimFunc
+            The function, whose buffer map binds the symbolic shapes.
+        args : Sequence
+            The arguments of the call, NDArrays for the buffers and ints for scalar parameters.
+        """
+        shape = {}
+        for param, arg in zip(func.params, args):
+            if param in func.buffer_map:
+                for dim, extent in zip(func.buffer_map[param].shape, arg.shape):
+                    if isinstance(dim, Var):
+                        shape[dim.name] = int(extent)
+            elif "int" in param.dtype and isinstance(arg, int):
+                shape[param.name] = arg
+        if shape:
+            self.record(func_name, shape)
+
+    def buckets(
+        self,
+        func_name: str,
+        *,
+        max_exact: int = 2,
+        min_coverage: float = 0.1,
+        factors: Sequence[int] = (128, 64, 32, 16, 8),
+    ) -> List[Bucket]:
+        """Derive the shape buckets of a function, most specific first.
+
+        Parameters
+        ----------
+        func_name : str
+            The name of the function in its IRModule.
+        max_exact : int
+            The maximum number of static shapes to specialize for.
+        min_coverage : float
+            The minimum fraction of the recorded calls a bucket has to match.
+        factors : Sequence[int]
+            The candidate factors of the divisibility bucket.
+
+        Returns
+        -------
+        buckets : List[Bucket]
+            Each bucket maps a variable name to ("eq", value) or ("mod", factor).
+        """
+        counts = self._counts.get(func_name)
+        if not counts:
+            return []
+        total = sum(counts.values())
+        shapes = [(dict(key), count) for key, count in counts.items()]
+
+        result: List[Bucket] = []
+        for key, count in counts.most_common(max_exact):
+            if count / total < min_coverage:
+                break
+            result.append({name: ("eq", value) for name, value in key})
+
+        # The calls that are not served by the static shapes.
+        residual = [
+            (shape, count)
+            for shape, count in shapes
+            if not any(_matches_bucket(shape, bucket) for bucket in result)
+        ]
+
+        def coverage(bucket: Bucket) -> float:
+            return sum(count for shape, count in residual if _matches_bucket(shape, bucket)) / total
+
+        # Greedily add the largest factor of each variable while the bucket stays common.
+        divisible: Bucket = {}
+        for name in sorted({name for shape, _ in residual for name in shape}):
+            for factor in sorted(factors, reverse=True):
+                candidate = dict(divisible, **{name: ("mod", int(factor))})
+                if coverage(candidate) >= min_coverage:
+                    divisible = candidate
+                    break
+        if divisible:
+            result.append(divisible)
+        return result
+
+    def annotate(self, mod: IRModule, **kwargs) -> IRModule:
+        """Annotate the functions of a module with their shape buckets.
+
+        Parameters
+        ----------
+        mod : IRModule
+            The module to be annotated.
+        kwargs
+            The options of `buckets`.
+
+        Returns
+        -------
+        mod : IRModule
+            The module whose profiled functions carry the ``"tir.shape_buckets"`` attribute.
+        """
+        functions = {}
+        for gvar, func in mod.functions_items():
+            if isinstance(func, PrimFunc):
+                buckets = self.buckets(gvar.name_hint, **kwargs)
+                if buckets:
+                    func = func.with_attr("tir.shape_buckets", _make_conditions(func, buckets))
+            functions[gvar] = func
+        return IRModule(functions, attrs=mod.attrs)
+
+    def save(self, path: str) -> None:
+        """Save the profile to a JSON file."""
+        data = {
+            func_name: [[dict(key), count] for key, count in counts.items()]
+            for func_name, counts in self._counts.items()
+        }
+        with open(path, "w") as file:
+            json.dump(data, file)
+
+    @staticmethod
+    def load(path: str) -> "ShapeProfile":
+        """Load a profile from a JSON file."""
+        profile = ShapeProfile()
+        with open(path, "r") as file:
+            for func_name, records in json.load(file).items():
+                for shape, count in records:
+                    profile.record(func_name, shape, count)
+        return profile
+
+
+def _matches_bucket(shape: Dict[str, int], bucket: Bucket) -> bool:
+    for name, (kind, constant) in bucket.items():
+        value = shape.get(name)
+        if value is None:
+            return False
+        if kind == "eq" and value != constant:
+            return False
+        if kind == "mod" and value % constant != 0:
+            return False
+    return True
+
+
+def _make_conditions(func: PrimFunc, buckets: List[Bucket]) -> list:
+    shape_vars = {}
+    for param in func.params:
+        if param in func.buffer_map:
+            for dim in func.buffer_map[param].shape:
+                if isinstance(dim, Var):
+                    shape_vars[dim.name] = dim
+        elif "int" in param.dtype:
+            shape_vars[param.name] = param
+    conditions = []
+    for bucket in buckets:
+        conds = []
+        for name, (kind, constant) in sorted(bucket.items()):
+            var = shape_vars[name]
+            value = IntImm(var.dtype, constant)
+            if kind == "eq":
+                conds.append(EQ(var, value))
+            else:
+                conds.append(EQ(_op.floormod(var, value), IntImm(var.dtype, 0)))
+        conditions.append(_op.all(*conds))
+    return conditions
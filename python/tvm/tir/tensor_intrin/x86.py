@@ -16,6 +16,7 @@
 # under the License.
 # pylint: disable=invalid-name,missing-function-docstring
 """Intrinsics for x86 tensorization."""
+from tvm import DataType
 from tvm.script import tir as T
 from .. import TensorIntrin
 
@@ -112,3 +113,120 @@ AVX512_DOT_16x4_INTRIN = "dot_16x4_avx512"
 TensorIntrin.register(
     AVX512_DOT_16x4_INTRIN, dot_product_16x4_u8i8i32_desc, dot_product_16x4_u8i8i32_avx512
 )
+
+
+def get_amx_dot_intrin(in_dtype):
+    """Create a 16x16 AMX tile matmul, C[16, 16] += A[16, K] * B[K, 16].
+
+    The reduction extent K covers the 64 bytes of a tile row, i.e. K = 64 for uint8 x int8 ->
+    int32 (tdpbusd) and K = 32 for bfloat16 x bfloat16 -> float32 (tdpbf16ps). Like the VNNI
+    intrinsics above, B is expected in the packed layout [K // lanes, 16, lanes], where lanes
+    is the number of input elements per 32-bit word.
+
+    The implementation configures the tile registers itself (8 tiles of 16 rows by 64 bytes)
+    before loading C, A and B into tmm0, tmm1 and tmm2, so it can be used in any thread without
+    a prior call to `runtime.amx_tileconfig`. The process still needs the permission granted
+    by `runtime.amx_init` to use the AMX tile data.
+    """
+    if in_dtype == "uint8":
+        a_dtype, b_dtype, out_dtype, instr = "uint8", "int8", "int32", "llvm.x86.tdpbusd"
+    elif in_dtype == "bfloat16":
+        a_dtype, b_dtype, out_dtype, instr = "bfloat16", "bfloat16", "float32", "llvm.x86.tdpbf16ps"
+    else:
+        raise ValueError(f"AMX does not support input dtype {in_dtype}")
+    in_bytes = DataType(in_dtype).bits // 8
+    out_bytes = DataType(out_dtype).bits // 8
+    lanes = 4 // in_bytes
+    K = 64 // in_bytes
+
+    @T.prim_func
+    def amx_dot_desc(a: T.handle, b: T.handle, c: T.handle) -> None:
+        A = T.match_buffer(a, (16, K), a_dtype, offset_factor=1)
+        B = T.match_buffer(b, (K // lanes, 16, lanes), b_dtype, offset_factor=1)
+        C = T.match_buffer(c, (16, 16), out_dtype, offset_factor=1)
+        with T.block("root"):
+            T.reads(C[0:16, 0:16], A[0:16, 0:K], B[0:K // lanes, 0:16, 0:lanes])
+            T.writes(C[0:16, 0:16])
+            for i, j, k_o, k_i in T.grid(16, 16, K // lanes, lanes):
+                with T.block("update"):
+                    vi, vj, vko, vki = T.axis.remap("SSRR", [i, j, k_o, k_i])
+                    C[vi, vj] = C[vi, vj] + T.cast(A[vi, vko * lanes + vki], out_dtype) * T.cast(
+                        B[vko, vj, vki], out_dtype
+                    )
+
+    @T.prim_func
+    def amx_dot_impl(a: T.handle, b: T.handle, c: T.handle) -> None:
+        A = T.match_buffer(a, (16, K), a_dtype, offset_factor=1, strides=[T.int32(), 1])
+        B = T.match_buffer(
+            b, (K // lanes, 16, lanes), b_dtype, offset_factor=1, strides=[T.int32(), lanes, 1]
+        )
+        C = T.match_buffer(c, (16, 16), out_dtype, offset_factor=1, strides=[T.int32(), 1])
+        with T.block("root"):
+            T.reads(C[0:16, 0:16], A[0:16, 0:K], B[0:K // lanes, 0:16, 0:lanes])
+            T.writes(C[0:16, 0:16])
+            # The 64-byte tile configuration read by ldtilecfg: palette 1, then the bytes per
+            # row of each tile at offset 16 and the number of rows of each tile at offset 48.
+            cfg = T.decl_buffer((64,), "uint8", scope="local")
+            for i in T.serial(64):
+                cfg[i] = T.uint8(0)
+            cfg[0] = T.uint8(1)
+            for t in T.serial(8):
+                cfg[16 + t * 2] = T.uint8(64)
+                cfg[48 + t] = T.uint8(16)
+            T.evaluate(
+                T.call_llvm_intrin("int32", "llvm.x86.ldtilecfg", T.uint32(1), cfg.access_ptr("r"))
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    "int32",
+                    "llvm.x86.tileloadd64",
+                    T.uint32(3),
+                    T.uint8(0),
+                    C.access_ptr("r"),
+                    T.cast(C.strides[0] * out_bytes, "int64"),
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    "int32",
+                    "llvm.x86.tileloadd64",
+                    T.uint32(3),
+                    T.uint8(1),
+                    A.access_ptr("r"),
+                    T.cast(A.strides[0] * in_bytes, "int64"),
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    "int32",
+                    "llvm.x86.tileloadd64",
+                    T.uint32(3),
+                    T.uint8(2),
+                    B.access_ptr("r"),
+                    T.cast(B.strides[0] * in_bytes, "int64"),
+                )
+            )
+            T.evaluate(
+                T.call_llvm_intrin("int32", instr, T.uint32(3), T.uint8(0), T.uint8(1), T.uint8(2))
+            )
+            T.evaluate(
+                T.call_llvm_intrin(
+                    "int32",
+                    "llvm.x86.tilestored64",
+                    T.uint32(3),
+                    T.uint8(0),
+                    C.access_ptr("w"),
+                    T.cast(C.strides[0] * out_bytes, "int64"),
+                )
+            )
+
+    return amx_dot_desc, amx_dot_impl
+
+
+AMX_DOT_16x16x64_U8I8I32_INTRIN = "dot_16x16x64_u8i8i32_amx"
+
+TensorIntrin.register(AMX_DOT_16x16x64_U8I8I32_INTRIN, *get_amx_dot_intrin("uint8"))
+
+AMX_DOT_16x16x32_BF16BF16F32_INTRIN = "dot_16x16x32_bf16bf16f32_amx"
+
+TensorIntrin.register(AMX_DOT_16x16x32_BF16BF16F32_INTRIN, *get_amx_dot_intrin("bfloat16"))
@@ -967,6 +967,21 @@ def FlattenBuffer():
     return _ffi_api.FlattenBuffer()  # type: ignore
 
 
+def SpecializeShapeBuckets():
+    """Multi-version the functions annotated with the "tir.shape_buckets" attribute.
+
+    Each bucket is a conjunction of ``n == c``, ``n % c == 0`` and bounds on the symbolic
+    shape variables. The body is specialized for each bucket, and a runtime dispatch picks the
+    first bucket matching the shapes, falling back to the generic body.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.SpecializeShapeBuckets()  # type: ignore
+
+
 def TransformMmaBufferLayout():
     """Transform mma buffer layout
 
@@ -1183,7 +1198,7 @@ def InstallDebugSpans():
     return _ffi_api.InstallDebugSpans()  # type: ignore
 
 
-def DefaultGPUSchedule():
+def DefaultGPUSchedule(heuristic: bool = False):
     """The pass sets default thread bindings for PrimFuncs, including symbolic shape functions,
     allowing their build and execution on GPU devices. It examines all the blocks within the
     PrimFunc and conducts loop fusion, splitting, and reordering operation based on the loop
@@ -1194,11 +1209,22 @@ def DefaultGPUSchedule():
     a valid GPU kernel for unscheduled or symbolic shape PrimFuncs. The pass is currently only
     working for CUDA targets.
 
+    With `heuristic`, the PrimFuncs are first scheduled by rules in the spirit of dlight:
+    elementwise ops are vectorized, transposes are staged through shared memory, reductions
+    and GEMVs reduce across the threads of a block, and matmuls, including the products of
+    attention, are tiled through shared memory. The functions no rule applies to fall back
+    to the default thread bindings.
+
+    Parameters
+    ----------
+    heuristic : bool
+        Whether to schedule the PrimFuncs with the heuristic rules first.
+
     Returns
     -------
     ret: tvm.transform.Pass
     """
-    return _ffi_api.DefaultGPUSchedule()  # type: ignore
+    return _ffi_api.DefaultGPUSchedule(heuristic)  # type: ignore
 
 
 def UseAssumeToReduceBranches():
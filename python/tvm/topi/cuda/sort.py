@@ -1082,6 +1082,86 @@ def topk_thrust(
 
     return out
 
+# The largest k of tvm.contrib.thrust.radix_topk, whose candidates are kept in shared memory.
+RADIX_TOPK_MAX_K = 1024
+
+
+def radix_topk_thrust(data, k=1, axis=-1, ret_type="both", is_ascend=False, dtype="int64"):
+    """Get the top k elements in an input tensor along the given axis, by a radix select.
+
+    Unlike :py:func:`topk_thrust`, the axis is not fully sorted: the k-th element of each segment
+    is found by a radix select, and only the top k elements are sorted.  All the segments are
+    processed by one kernel launch, with one thread block per segment.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        The input tensor.
+
+    k : int
+        Number of top elements to select, at most RADIX_TOPK_MAX_K and the length of the axis.
+
+    axis : int, optional
+        Axis long which to sort the input tensor.
+
+    ret_type: str, optional
+        The return type [both, values, indices].
+        "both": return both top k data and indices.
+        "values": return top k data only.
+        "indices": return top k indices only.
+
+    is_ascend : boolean, optional
+        Whether to select the smallest elements in ascending order instead.
+
+    dtype : string, optional
+        The data type of the indices output, int32 or int64.
+
+    Returns
+    -------
+    out : tvm.te.Tensor or List[tvm.te.Tensor]
+        The computed result.
+    """
+    assert ret_type in ["both", "values", "indices"]
+    if isinstance(k, tvm.tir.IntImm):
+        k = k.value
+    assert isinstance(k, int) and 0 < k <= RADIX_TOPK_MAX_K, "radix_topk requires a static k"
+    ndim = len(data.shape)
+    axis = ndim + axis if axis < 0 else axis
+
+    if axis != ndim - 1:
+        # Prepare for selecting along axis -1.
+        axes = swap(list(range(ndim)), axis)
+        data = transpose(data, axes)
+
+    out_shape = list(data.shape[:-1]) + [k]
+    data_buf = tvm.tir.decl_buffer(data.shape, data.dtype, "data_buf", data_alignment=8)
+    out_bufs = [
+        tvm.tir.decl_buffer(out_shape, data.dtype, "value_buf", data_alignment=8),
+        tvm.tir.decl_buffer(out_shape, dtype, "indices_buf", data_alignment=8),
+    ]
+    out = te.extern(
+        [out_shape, out_shape],
+        [data],
+        lambda ins, outs: tvm.tir.call_packed(
+            "tvm.contrib.thrust.radix_topk", ins[0], outs[0], outs[1], k, 1 if is_ascend else 0
+        ),
+        in_buffers=[data_buf],
+        out_buffers=out_bufs,
+        name="radix_topk_gpu",
+        tag="topk_gpu",
+    )
+
+    if axis != ndim - 1:
+        axes = swap(list(range(ndim)), axis)
+        out = [transpose(o, axes) for o in out]
+
+    if ret_type == "values":
+        out = out[0]
+    elif ret_type == "indices":
+        out = out[1]
+
+    return out
+
 
 def schedule_topk(outs):
     """Schedule for argsort operator.
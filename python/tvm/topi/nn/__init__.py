@@ -42,6 +42,7 @@ from .instance_norm import instance_norm
 from .layer_norm import layer_norm
 from .group_norm import group_norm
 from .rms_norm import rms_norm
+from .fused_norm import add_rms_norm, add_layer_norm
 from .local_response_norm import *
 from .bitserial_conv2d import *
 from .bitserial_dense import *
@@ -19,7 +19,7 @@
 import tvm
 from tvm import auto_scheduler, te
 
-from .. import tag, add
+from .. import cpp, tag, add
 
 
 def matmul(
@@ -243,6 +243,55 @@ def dense(
     )
 
 
+def weight_only_dense(
+    data, weight, scale, zero_point=None, bias=None, bits=4, group_size=128, out_dtype=None
+):
+    """Dense with the weight quantized to 4 or 8 bits by groups of input channels.
+
+    The weight is dequantized as `(q - zero_point) * scale` within the reduction, so that it is
+    read from memory in its quantized form.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        2-D with shape [batch, in_dim]
+
+    weight : tvm.te.Tensor
+        For 8 bits, int8 2-D with shape [out_dim, in_dim]. For 4 bits, uint8 2-D with shape
+        [out_dim, in_dim // 2], packing the input channels 2k and 2k + 1 in the low and the high
+        nibble of its column k.
+
+    scale : tvm.te.Tensor
+        2-D with shape [out_dim, ceil(in_dim / group_size)]
+
+    zero_point : Optional[tvm.te.Tensor]
+        2-D with the shape of scale. Defaults to 8 for the unsigned 4 bit values, and to 0 for the
+        signed 8 bit values.
+
+    bias : Optional[tvm.te.Tensor]
+        1-D with shape [out_dim]
+
+    bits : int
+        The bits of the quantized values, 4 or 8.
+
+    group_size : int
+        The number of input channels sharing a scale and a zero point.
+
+    out_dtype : Optional[str]
+        The output type, in which the weight is dequantized. Defaults to the type of data.
+
+    Returns
+    -------
+    output : tvm.te.Tensor
+        2-D with shape [batch, out_dim]
+    """
+    if out_dtype is None:
+        out_dtype = data.dtype
+    return cpp.nn.weight_only_dense(
+        data, weight, scale, zero_point, bias, bits, group_size, out_dtype
+    )
+
+
 @tvm.target.generic_func
 def dense_legalize(attrs, inputs, types):
     """Legalizes dense op.
@@ -0,0 +1,104 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Normalizations fused with the residual add before them and the quantization after them."""
+from .. import cpp
+
+
+def add_rms_norm(data, residual, weight, axis, epsilon=1e-5, quant_scale=None, quant_dtype="int8"):
+    """Root mean square normalization of `data + residual`, scaled by weight and optionally
+    quantized, in one kernel.
+
+    The statistics are accumulated in float32, and the residual sum is also returned so that it
+    can feed the residual connection of the next layer.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        N-D with shape (d_0, d_1, ..., d_{N-1})
+
+    residual : tvm.te.Tensor
+        N-D with the shape of data
+
+    weight: tvm.te.Tensor
+        K-D with shape (r_0, r_1, ..., r_{K-1}) where K == len(axis) and d_{axis_k} == r_k
+
+    axis : list of int
+        Axis over the normalization applied
+
+    epsilon : float
+        The epsilon value to avoid division by zero.
+
+    quant_scale : Optional[float]
+        The scale of the symmetric quantization of the output, which is not quantized when None.
+
+    quant_dtype : str
+        The type of the quantized output.
+
+    Returns
+    -------
+    result : Tuple[tvm.te.Tensor, tvm.te.Tensor]
+        The normalized tensor, with the type of data or quant_dtype, and the residual sum.
+    """
+    return cpp.nn.add_rms_norm(
+        data, residual, weight, axis, epsilon, quant_scale or 0.0, quant_dtype
+    )
+
+
+def add_layer_norm(
+    data, residual, gamma, beta, axis, epsilon=1e-5, quant_scale=None, quant_dtype="int8"
+):
+    """Layer normalization of `data + residual`, scaled by gamma, shifted by beta and optionally
+    quantized, in one kernel.
+
+    The mean and the variance are computed in float32 in a single Welford pass over the row, and
+    the residual sum is also returned so that it can feed the residual connection of the next
+    layer.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        N-D with shape (d_0, d_1, ..., d_{N-1})
+
+    residual : tvm.te.Tensor
+        N-D with the shape of data
+
+    gamma: tvm.te.Tensor
+        K-D with shape (r_0, r_1, ..., r_{K-1}) where K == len(axis) and d_{axis_k} == r_k
+
+    beta: Optional[tvm.te.Tensor]
+        K-D with the shape of gamma
+
+    axis : list of int
+        Axis over the normalization applied
+
+    epsilon : float
+        The epsilon value to avoid division by zero.
+
+    quant_scale : Optional[float]
+        The scale of the symmetric quantization of the output, which is not quantized when None.
+
+    quant_dtype : str
+        The type of the quantized output.
+
+    Returns
+    -------
+    result : Tuple[tvm.te.Tensor, tvm.te.Tensor]
+        The normalized tensor, with the type of data or quant_dtype, and the residual sum.
+    """
+    return cpp.nn.add_layer_norm(
+        data, residual, gamma, beta, axis, epsilon, quant_scale or 0.0, quant_dtype
+    )
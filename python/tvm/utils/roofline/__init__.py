@@ -29,6 +29,7 @@ from ...runtime import Device, num_threads, profiler_vm, profiling
 from ...script import tir as T
 from ...target import Target
 from . import cuda, registry, x86
+from .relax import relax_roofline_from_existing, to_chrome_trace
 
 
 def _create_args(mod: IRModule, dev: Device, func_name: str = "main", remote=None):
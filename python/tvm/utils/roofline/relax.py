@@ -0,0 +1,254 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Roofline statistics of the kernels in a Relax VM profiling report"""
+import json
+import re
+from typing import Dict, List, Optional, Tuple, Union
+
+from ... import IRModule, tir
+from ...runtime import DataType, profiling
+from ...target import Target
+
+_SHAPE_PATTERN = re.compile(r"(\w+)\[([0-9, ]*)\]")
+
+
+def _parse_argument_shapes(shapes: str) -> List[Tuple[str, List[int]]]:
+    """Parse the "Argument Shapes" column, e.g. "float32[1, 64], float32[64, 64]"."""
+    return [
+        (dtype, [int(dim) for dim in dims.split(",") if dim.strip()])
+        for dtype, dims in _SHAPE_PATTERN.findall(shapes)
+    ]
+
+
+def _moved_bytes(shapes: List[Tuple[str, List[int]]]) -> int:
+    """The bytes of the arguments, assuming each of them is read or written once."""
+    total = 0
+    for dtype, shape in shapes:
+        dtype = DataType(dtype)
+        numel = 1
+        for dim in shape:
+            numel *= dim
+        total += numel * ((dtype.bits * dtype.lanes + 7) // 8)
+    return total
+
+
+def _estimate_flops(prim: tir.PrimFunc, shapes: List[Tuple[str, List[int]]]) -> Optional[float]:
+    """Estimate the FLOPs of a kernel, with its symbolic shapes bound to the argument shapes."""
+    buffer_params = [param for param in prim.params if param in prim.buffer_map]
+    if len(buffer_params) != len(shapes):
+        return None
+    param_map = {}
+    for param, (dtype, shape) in zip(buffer_params, shapes):
+        buffer = prim.buffer_map[param]
+        if len(buffer.shape) != len(shape):
+            return None
+        param_map[param] = tir.decl_buffer(shape, dtype, buffer.name)
+    try:
+        specialized = prim.specialize(param_map)
+        return float(tir.analysis.estimate_tir_flops(IRModule({"main": specialized})))
+    except Exception:  # pylint: disable=broad-except
+        return None
+
+
+def _get_peak(target: Optional[Target], name: str, value: Optional[float]) -> Optional[float]:
+    if value is not None:
+        return float(value)
+    if target is not None and name in target.attrs:
+        return float(target.attrs[name])
+    return None
+
+
+def relax_roofline_from_existing(
+    report: profiling.Report,
+    mod: IRModule,
+    target: Optional[Union[str, Target]] = None,
+    peak_gflops: Optional[float] = None,
+    peak_bandwidth_gbps: Optional[float] = None,
+) -> profiling.Report:
+    """Add roofline statistics to the kernels of a Relax VM profiling report.
+
+    Each call of the report to a PrimFunc of `mod` gets:
+      - Estimated FLOPs: from :py:func:`tvm.tir.analysis.estimate_tir_flops`, after binding
+        the symbolic shapes of the PrimFunc to the argument shapes of the call.
+      - Moved Bytes: the bytes of the arguments of the call, assuming that each of them
+        is read or written exactly once.
+      - Arithmetic Intensity: FLOPs per moved byte.
+      - GFLOP/s and GB/s: the achieved rates over the duration of the call.
+
+    When the peaks of the device are known, each call also gets:
+      - Bound: "compute" if the arithmetic intensity is above the ridge point
+        `peak_gflops / peak_bandwidth_gbps`, and "memory" otherwise.
+      - Percent of Peak: the percent of the peak of its bound that the call achieved.
+
+    Example
+    -------
+
+    .. code-block:: python
+
+        mod = relax.get_pipeline("zero")(mod)
+        ex = relax.build(mod, target, pipeline=relax.get_pipeline("default_build"))
+        vm = relax.VirtualMachine(ex, dev, profile=True)
+        report = vm.profile("main", *inputs)
+        report = relax_roofline_from_existing(report, mod, target)
+        print(report)
+
+    Parameters
+    ----------
+    report : profiling.Report
+        The report from :py:meth:`tvm.relax.VirtualMachine.profile`.
+    mod : IRModule
+        The module that was built, whose PrimFuncs have the names of the kernels at runtime.
+    target : Optional[Union[str, Target]]
+        The target the report was generated with.  The peaks of the device are read from its
+        `peak_gflops` and `peak_bandwidth_gbps` attributes, e.g.
+        `cuda -arch=sm_80 -peak_gflops=19500 -peak_bandwidth_gbps=1555`.
+    peak_gflops : Optional[float]
+        The peak GFLOP/s of the device, overriding the one of `target`.
+    peak_bandwidth_gbps : Optional[float]
+        The peak memory bandwidth of the device in GB/s, overriding the one of `target`.
+
+    Returns
+    -------
+    profiling.Report
+        The report with the roofline statistics of the kernels.
+    """
+    if isinstance(target, str):
+        target = Target(target)
+    peak_gflops = _get_peak(target, "peak_gflops", peak_gflops)
+    peak_bandwidth_gbps = _get_peak(target, "peak_bandwidth_gbps", peak_bandwidth_gbps)
+
+    prim_funcs: Dict[str, tir.PrimFunc] = {}
+    for gvar, func in mod.functions.items():
+        if isinstance(func, tir.PrimFunc):
+            prim_funcs[gvar.name_hint] = func
+            if func.attrs is not None and "global_symbol" in func.attrs:
+                prim_funcs[str(func.attrs["global_symbol"])] = func
+
+    new_configuration = dict(report.configuration.items())
+    if peak_gflops is not None:
+        new_configuration["Peak GFLOP/s"] = profiling.Ratio(peak_gflops)
+    if peak_bandwidth_gbps is not None:
+        new_configuration["Peak GB/s"] = profiling.Ratio(peak_bandwidth_gbps)
+
+    # Cache the estimates, as the same kernels are called with the same shapes over and over.
+    flops_cache: Dict[Tuple[str, str], Optional[float]] = {}
+    new_calls = []
+    for call in report.calls:
+        name = str(call["Name"])
+        if name not in prim_funcs or "Argument Shapes" not in call:
+            new_calls.append(call)
+            continue
+        shape_str = str(call["Argument Shapes"])
+        shapes = _parse_argument_shapes(shape_str)
+        if (name, shape_str) not in flops_cache:
+            flops_cache[(name, shape_str)] = _estimate_flops(prim_funcs[name], shapes)
+        flops = flops_cache[(name, shape_str)]
+        moved_bytes = _moved_bytes(shapes)
+        runtime = call["Duration (us)"].microseconds * 1e-6
+        if flops is None or moved_bytes == 0 or runtime <= 0:
+            new_calls.append(call)
+            continue
+
+        call = dict(call)
+        arith_inten = flops / moved_bytes
+        gflops = flops / runtime * 1e-9
+        gbps = moved_bytes / runtime * 1e-9
+        call["Estimated FLOPs"] = profiling.Count(int(flops))
+        call["Moved Bytes"] = profiling.Count(moved_bytes)
+        call["Arithmetic Intensity"] = profiling.Ratio(arith_inten)
+        call["GFLOP/s"] = profiling.Ratio(gflops)
+        call["GB/s"] = profiling.Ratio(gbps)
+        if peak_gflops is not None and peak_bandwidth_gbps is not None:
+            compute_bound = arith_inten > peak_gflops / peak_bandwidth_gbps
+            call["Bound"] = "compute" if compute_bound else "memory"
+            # We use ratio here because the percentages should be averaged instead of summed.
+            call["Percent of Peak"] = profiling.Ratio(
+                gflops / peak_gflops * 100.0
+                if compute_bound
+                else gbps / peak_bandwidth_gbps * 100.0
+            )
+        new_calls.append(call)
+    return profiling.Report(new_calls, report.device_metrics, new_configuration)
+
+
+def _metric_to_json(value):
+    if isinstance(value, profiling.Count):
+        return value.value
+    if isinstance(value, profiling.Duration):
+        return value.microseconds
+    if isinstance(value, profiling.Percent):
+        return value.percent
+    if isinstance(value, profiling.Ratio):
+        return value.ratio
+    return str(value)
+
+
+def to_chrome_trace(report: profiling.Report) -> str:
+    """Convert a profiling report to the Chrome trace event format.
+
+    The report does not record when the calls started, so the calls of each device are laid
+    out back to back in the order they were made.  The trace shows the share of each kernel in
+    the total time, not the idle time between kernels.  Each event carries the metrics of its
+    call, e.g. the roofline statistics from :py:func:`relax_roofline_from_existing`.
+
+    Parameters
+    ----------
+    report : profiling.Report
+        The profiling report.
+
+    Returns
+    -------
+    str
+        The trace as json, to be loaded in chrome://tracing or Perfetto.
+    """
+    events = []
+    device_ids: Dict[str, int] = {}
+    device_clocks: Dict[str, float] = {}
+    for call in report.calls:
+        if "Duration (us)" not in call:
+            continue
+        device = str(call["Device"]) if "Device" in call else "unknown"
+        if device not in device_ids:
+            device_ids[device] = len(device_ids)
+            device_clocks[device] = 0.0
+            events.append(
+                {
+                    "name": "process_name",
+                    "ph": "M",
+                    "pid": device_ids[device],
+                    "args": {"name": device},
+                }
+            )
+        duration = call["Duration (us)"].microseconds
+        events.append(
+            {
+                "name": str(call["Name"]),
+                "cat": str(call["Bound"]) if "Bound" in call else "call",
+                "ph": "X",
+                "ts": device_clocks[device],
+                "dur": duration,
+                "pid": device_ids[device],
+                "tid": 0,
+                "args": {
+                    key: _metric_to_json(value)
+                    for key, value in call.items()
+                    if key not in ("Name", "Device", "Duration (us)")
+                },
+            }
+        )
+        device_clocks[device] += duration
+    return json.dumps({"traceEvents": events, "displayTimeUnit": "ns"})
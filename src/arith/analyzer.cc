@@ -21,10 +21,18 @@
  * \file tvm/arith/analyzer.cc
  */
 #include <tvm/arith/analyzer.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../support/utils.h"
 #include "./scalable_expression.h"
 #include "const_fold.h"
 #include "product_normal_form.h"
@@ -32,12 +40,164 @@
 namespace tvm {
 namespace arith {
 
+/*!
+ * \brief Whether the expression only consists of arithmetics of variables and constants.
+ *  The structural equality of such expressions implies that they are the same value,
+ *  while e.g. two loads of different buffers may be structurally equal.
+ */
+static bool IsPureArithExpr(const PrimExpr& expr) {
+  bool pure = true;
+  tir::PostOrderVisit(expr, [&pure](const ObjectRef& node) {
+    pure = pure && (node->IsInstance<VarNode>() || node->IsInstance<IntImmNode>() ||
+                    node->IsInstance<FloatImmNode>() || node->IsInstance<tir::AddNode>() ||
+                    node->IsInstance<tir::SubNode>() || node->IsInstance<tir::MulNode>() ||
+                    node->IsInstance<tir::DivNode>() || node->IsInstance<tir::ModNode>() ||
+                    node->IsInstance<tir::FloorDivNode>() ||
+                    node->IsInstance<tir::FloorModNode>() || node->IsInstance<tir::MinNode>() ||
+                    node->IsInstance<tir::MaxNode>() || node->IsInstance<tir::EQNode>() ||
+                    node->IsInstance<tir::NENode>() || node->IsInstance<tir::LTNode>() ||
+                    node->IsInstance<tir::LENode>() || node->IsInstance<tir::GTNode>() ||
+                    node->IsInstance<tir::GENode>() || node->IsInstance<tir::AndNode>() ||
+                    node->IsInstance<tir::OrNode>() || node->IsInstance<tir::NotNode>() ||
+                    node->IsInstance<tir::CastNode>() || node->IsInstance<tir::SelectNode>() ||
+                    node->IsInstance<tir::RampNode>() || node->IsInstance<tir::BroadcastNode>());
+  });
+  return pure;
+}
+
+/*!
+ * \brief The cached results of Simplify and CanProve.
+ *
+ *  The known facts of the analyzer are identified by an epoch. A change of the
+ *  facts, e.g. a Bind, moves to a new epoch. Entering a constraint from an epoch
+ *  always moves to the same epoch, and exiting it moves back, unless the facts
+ *  were changed in the scope. The results are keyed by the expression and the
+ *  epoch they were computed in. Arithmetic expressions are compared structurally,
+ *  the others by identity.
+ */
+class Analyzer::Cache {
+ public:
+  /*! \brief The maximum number of results, the cache is cleared when it is full. */
+  static constexpr size_t kCapacity = 4096;
+  /*! \brief The kind of the key of a constraint, Simplify uses the steps as the kind. */
+  static constexpr int kConstraintKind = -1;
+  /*! \brief The kind of the key of CanProve. */
+  static int CanProveKind(ProofStrength strength) { return -2 - static_cast<int>(strength); }
+
+  struct Key {
+    PrimExpr expr;
+    uint64_t epoch;
+    int kind;
+    bool structural;
+    size_t hash;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const { return key.hash; }
+  };
+
+  struct KeyEqual {
+    bool operator()(const Key& lhs, const Key& rhs) const {
+      if (lhs.epoch != rhs.epoch || lhs.kind != rhs.kind || lhs.structural != rhs.structural) {
+        return false;
+      }
+      return lhs.structural ? StructuralEqual()(lhs.expr, rhs.expr) : lhs.expr.same_as(rhs.expr);
+    }
+  };
+
+  Key MakeKey(const PrimExpr& expr, int kind) const {
+    bool structural = IsPureArithExpr(expr);
+    size_t hash = structural ? StructuralHash()(expr) : ObjectPtrHash()(expr);
+    hash = support::HashCombine(support::HashCombine(hash, epoch_), kind);
+    return Key{expr, epoch_, kind, structural, hash};
+  }
+
+  /*!
+   * \brief Find the result of a key.
+   * \return The result, nullptr if not found. A null result means the expression itself.
+   */
+  const ObjectRef* Find(const Key& key) {
+    auto it = results_.find(key);
+    if (it == results_.end()) {
+      ++num_misses_;
+      return nullptr;
+    }
+    ++num_hits_;
+    return &it->second;
+  }
+
+  void Insert(const Key& key, ObjectRef result) {
+    if (results_.size() >= kCapacity) {
+      results_.clear();
+      constraint_epochs_.clear();
+    }
+    results_[key] = result.same_as(key.expr) ? ObjectRef() : std::move(result);
+  }
+
+  void OnStateChange() {
+    ++num_state_changes_;
+    epoch_ = next_epoch_++;
+  }
+
+  void EnterConstraint(const PrimExpr& constraint) {
+    scopes_.emplace_back(epoch_, num_state_changes_);
+    Key key = MakeKey(constraint, kConstraintKind);
+    auto it = constraint_epochs_.find(key);
+    if (it != constraint_epochs_.end()) {
+      epoch_ = it->second;
+    } else {
+      epoch_ = next_epoch_++;
+      constraint_epochs_[key] = epoch_;
+    }
+  }
+
+  void ExitConstraint() {
+    ICHECK(!scopes_.empty());
+    auto [epoch, num_state_changes] = scopes_.back();
+    scopes_.pop_back();
+    epoch_ = num_state_changes == num_state_changes_ ? epoch : next_epoch_++;
+  }
+
+  Map<String, Integer> GetStats() const {
+    auto make_int = [](int64_t value) { return Integer(IntImm(DataType::Int(64), value)); };
+    return {{"hits", make_int(num_hits_)},
+            {"misses", make_int(num_misses_)},
+            {"size", make_int(results_.size())}};
+  }
+
+ private:
+  std::unordered_map<Key, ObjectRef, KeyHash, KeyEqual> results_;
+  /*! \brief The epoch entered with a constraint from another epoch. */
+  std::unordered_map<Key, uint64_t, KeyHash, KeyEqual> constraint_epochs_;
+  /*! \brief The epoch and the number of state changes when entering the constraints. */
+  std::vector<std::pair<uint64_t, uint64_t>> scopes_;
+  uint64_t epoch_{0};
+  uint64_t next_epoch_{1};
+  uint64_t num_state_changes_{0};
+  int64_t num_hits_{0};
+  int64_t num_misses_{0};
+};
+
 Analyzer::Analyzer()
     : const_int_bound(this),
       modular_set(this),
       rewrite_simplify(this),
       canonical_simplify(this),
-      int_set(this) {}
+      int_set(this),
+      cache_(std::make_unique<Cache>()) {
+  const_int_bound.parent_ = this;
+  modular_set.parent_ = this;
+  rewrite_simplify.parent_ = this;
+  canonical_simplify.parent_ = this;
+  int_set.parent_ = this;
+  transitive_comparisons.parent_ = this;
+}
+
+Analyzer::~Analyzer() {}
+
+void Analyzer::NotifyStateChange() { cache_->OnStateChange(); }
+
+Map<String, Integer> Analyzer::GetCacheStats() const { return cache_->GetStats(); }
 
 void Analyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
   PrimExpr new_expr = expr;
@@ -123,6 +283,7 @@ void Analyzer::Bind(const Map<Var, Range>& variables, bool allow_override) {
 
 void ConstraintContext::EnterWithScope() {
   ICHECK(recovery_functions_.size() == 0);
+  analyzer_->cache_->EnterConstraint(constraint_);
   // entering the scope.
   recovery_functions_.push_back(analyzer_->const_int_bound.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->modular_set.EnterConstraint(constraint_));
@@ -139,6 +300,7 @@ void ConstraintContext::ExitWithScope() {
     }
     recovery_functions_.pop_back();
   }
+  analyzer_->cache_->ExitConstraint();
 }
 
 bool Analyzer::CanProveGreaterEqual(const PrimExpr& expr, int64_t lower_bound) {
@@ -192,6 +354,19 @@ bool Analyzer::CanProve(const PrimExpr& expr, ProofStrength strength) {
   if (const auto* ptr = expr.as<IntImmNode>()) {
     return ptr->value != 0;
   }
+  Cache::Key key = cache_->MakeKey(expr, Cache::CanProveKind(strength));
+  if (const ObjectRef* cached = cache_->Find(key)) {
+    return Downcast<Bool>(*cached)->value;
+  }
+  bool result = CanProveImpl(expr, strength);
+  // The proof of vscale expressions depends on the current target.
+  if (!ContainsVscaleCall(expr)) {
+    cache_->Insert(key, Bool(result));
+  }
+  return result;
+}
+
+bool Analyzer::CanProveImpl(const PrimExpr& expr, ProofStrength strength) {
   PrimExpr simplified = Simplify(expr);
   const int64_t* as_int = tir::as_const_int(simplified);
   if (as_int && *as_int) return true;
@@ -248,6 +423,22 @@ bool Analyzer::CanProve(const PrimExpr& expr, ProofStrength strength) {
 }
 
 PrimExpr Analyzer::Simplify(const PrimExpr& expr, int steps) {
+  if (expr.as<IntImmNode>()) {
+    return expr;
+  }
+  Cache::Key key = cache_->MakeKey(expr, steps);
+  if (const ObjectRef* cached = cache_->Find(key)) {
+    // Keep the identity of the input when it is already simplified.
+    return cached->defined() ? Downcast<PrimExpr>(*cached) : expr;
+  }
+  PrimExpr res = SimplifyImpl(expr, steps);
+  if (!ContainsVscaleCall(expr)) {
+    cache_->Insert(key, res);
+  }
+  return res;
+}
+
+PrimExpr Analyzer::SimplifyImpl(const PrimExpr& expr, int steps) {
   PrimExpr res = expr;
 
   // Always starts with a canonical simplification, as some structural property
@@ -303,6 +494,8 @@ TVM_REGISTER_GLOBAL("arith.CreateAnalyzer").set_body([](TVMArgs args, TVMRetValu
     } else if (name == "reset_rewrite_simplify_stats") {
       return PackedFunc(
           [self](TVMArgs args, TVMRetValue* ret) { self->rewrite_simplify.ResetStatsCounters(); });
+    } else if (name == "get_cache_stats") {
+      return PackedFunc([self](TVMArgs args, TVMRetValue* ret) { *ret = self->GetCacheStats(); });
     } else if (name == "canonical_simplify") {
       return PackedFunc(
           [self](TVMArgs args, TVMRetValue* ret) { *ret = self->canonical_simplify(args[0]); });
@@ -1443,6 +1443,7 @@ PrimExpr CanonicalSimplifier::operator()(const PrimExpr& expr) {
 
 void CanonicalSimplifier::Update(const Var& var, const PrimExpr& info, bool override) {
   impl_->Update(var, info, override);
+  if (parent_) parent_->NotifyStateChange();
 }
 
 CanonicalSimplifier::CanonicalSimplifier(Analyzer* parent) : impl_(new Impl(parent)) {}
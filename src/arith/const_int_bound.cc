@@ -786,10 +786,12 @@ ConstIntBound ConstIntBoundAnalyzer::operator()(const PrimExpr& expr, BoundMapTy
 
 void ConstIntBoundAnalyzer::Update(const Var& var, const ConstIntBound& info, bool allow_override) {
   impl_->Update(var, info, allow_override);
+  if (parent_) parent_->NotifyStateChange();
 }
 
 void ConstIntBoundAnalyzer::Bind(const Var& var, const Range& range, bool allow_override) {
   impl_->Bind(var, range, allow_override);
+  if (parent_) parent_->NotifyStateChange();
 }
 
 std::function<void()> ConstIntBoundAnalyzer::EnterConstraint(const PrimExpr& constraint) {
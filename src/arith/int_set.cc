@@ -620,10 +620,12 @@ IntSet IntSetAnalyzer::operator()(const PrimExpr& expr) { return impl_->Eval(exp
 
 void IntSetAnalyzer::Update(const Var& var, const IntSet& info, bool allow_override) {
   impl_->Update(var, info, allow_override);
+  if (parent_) parent_->NotifyStateChange();
 }
 
 void IntSetAnalyzer::Bind(const Var& var, const Range& range, bool allow_override) {
   impl_->Bind(var, range, allow_override);
+  if (parent_) parent_->NotifyStateChange();
 }
 
 void IntSetAnalyzer::Impl::Update(const Var& var, const IntSet& info, bool can_override) {
@@ -214,6 +214,8 @@ class IterMapRewriter : public ExprMutator {
     update_iterator_padding_ = true;
     auto res = Rewrite(expr);
     update_iterator_padding_ = false;
+    // The padding of the marks may have changed the rewriting of any expression.
+    mutate_memo_.clear();
     return res;
   }
 
@@ -327,8 +329,19 @@ class IterMapRewriter : public ExprMutator {
     return expr;
   }
 
-  // Normal mutation without normalization.
-  PrimExpr DirectMutate(const PrimExpr& expr) { return ExprMutator::VisitExpr(expr); }
+  // Normal mutation without normalization, memoized for the subexpressions shared by the
+  // indices, e.g. the fused iterator in [fused // 4, fused % 4]. The memo is bypassed while
+  // the padding is updated, as the result then depends on the earlier splits.
+  PrimExpr DirectMutate(const PrimExpr& expr) {
+    if (update_iterator_padding_ || expr->IsInstance<VarNode>() || expr->IsInstance<IntImmNode>()) {
+      return ExprMutator::VisitExpr(expr);
+    }
+    auto it = mutate_memo_.find(expr);
+    if (it != mutate_memo_.end()) return it->second;
+    PrimExpr res = ExprMutator::VisitExpr(expr);
+    mutate_memo_.emplace(expr, res);
+    return res;
+  }
 
   PrimExpr VisitExpr_(const VarNode* op) final;
   PrimExpr VisitExpr_(const AddNode* op) final;
@@ -521,6 +534,12 @@ class IterMapRewriter : public ExprMutator {
   std::unordered_map<IterSumExpr, IterSumExpr, IterSumHash, IterSumEqual> flattened_map_;
   // The flattened forms of constrained iters
   std::vector<IterSumExpr> constrained_iters_flattened_;
+  // The memo of TryFuseIters for the sums of the indices, from the sum to fuse to the fused sum.
+  // Fusing the same sum again finds the mark in sum_fuse_map_ and gives the same result, so only
+  // the update of the marks by the constraints invalidates it.
+  std::unordered_map<IterSumExpr, Optional<IterSumExpr>, IterSumHash, IterSumEqual> fuse_memo_;
+  // The memo of DirectMutate, invalidated with fuse_memo_ and by the padding updates.
+  std::unordered_map<PrimExpr, PrimExpr, ObjectPtrHash, ObjectPtrEqual> mutate_memo_;
 
   /*!
    * \brief Look for a split in splits that is not used such that its lower_factor is smallest.
@@ -669,6 +688,9 @@ class IterMapRewriter : public ExprMutator {
                                          Optional<PrimExpr> predicate_induced_max) {
     // normalize to zero base
     PrimExpr base = expr->base;
+    // The constraint updates the marks in sum_fuse_map_.
+    fuse_memo_.clear();
+    mutate_memo_.clear();
     if (!is_zero(base)) {
       expr.CopyOnWrite()->base = 0;
       if (predicate_induced_min.defined())
@@ -1088,6 +1110,17 @@ class IterMapRewriter : public ExprMutator {
    */
   Optional<IterSumExpr> TryFuseIters(IterSumExpr expr, IterMapLevel check_level,
                                      bool allow_early_skip) {
+    // Only the sums of the indices are memoized, the constraints being fused once each.
+    if (!allow_early_skip) return TryFuseItersImpl(expr, check_level, allow_early_skip);
+    auto it = fuse_memo_.find(expr);
+    if (it != fuse_memo_.end()) return it->second;
+    Optional<IterSumExpr> res = TryFuseItersImpl(expr, check_level, allow_early_skip);
+    fuse_memo_.emplace(expr, res);
+    return res;
+  }
+
+  Optional<IterSumExpr> TryFuseItersImpl(IterSumExpr expr, IterMapLevel check_level,
+                                         bool allow_early_skip) {
     if (auto opt = TryCombineSplitFromSameSource(expr)) {
       expr = opt.value();
       if (expr->args.size() <= 1 && allow_early_skip) {
@@ -1418,6 +1451,74 @@ bool MatchBoundConstraints(PrimExpr pred, Map<Var, Range>* input_iters,
   return true;
 }
 
+/*!
+ * \brief Find a subexpression of the indices that is not affine in the input iterators, which
+ *  IterMapRewriter would fail to rewrite only after rewriting the rest of the indices.
+ *
+ *  The iterators may only occur under the additions, the subtractions, the multiplications
+ *  by a non-iterator and the floordiv and floormod by a non-iterator of index type.
+ */
+class NonAffineExprFinder {
+ public:
+  static Optional<PrimExpr> Find(const Array<PrimExpr>& indices,
+                                 const Map<Var, Range>& input_iters) {
+    NonAffineExprFinder finder;
+    for (const auto& kv : input_iters) {
+      finder.iters_.insert(kv.first.get());
+    }
+    for (const PrimExpr& index : indices) {
+      finder.UsesIter(index);
+      if (finder.non_affine_) break;
+    }
+    return finder.non_affine_;
+  }
+
+ private:
+  // Whether an expression uses the iterators, recording the first non-affine use.
+  bool UsesIter(const PrimExpr& expr) {
+    if (non_affine_) return true;
+    if (auto var = expr.as<VarNode>()) return iters_.count(var);
+    if (expr->IsInstance<IntImmNode>()) return false;
+    auto it = memo_.find(expr.get());
+    if (it != memo_.end()) return it->second;
+
+    bool uses_iter;
+    bool affine = true;
+    if (!IsIndexType(expr.dtype())) {
+      uses_iter = UsesVar(expr, [this](const VarNode* var) { return iters_.count(var); });
+      affine = !uses_iter;
+    } else if (auto op = expr.as<AddNode>()) {
+      uses_iter = UsesIter(op->a) | UsesIter(op->b);
+    } else if (auto op = expr.as<SubNode>()) {
+      uses_iter = UsesIter(op->a) | UsesIter(op->b);
+    } else if (auto op = expr.as<MulNode>()) {
+      bool a = UsesIter(op->a), b = UsesIter(op->b);
+      uses_iter = a || b;
+      affine = !(a && b);
+    } else if (auto op = expr.as<FloorDivNode>()) {
+      bool a = UsesIter(op->a), b = UsesIter(op->b);
+      uses_iter = a || b;
+      affine = !b;
+    } else if (auto op = expr.as<FloorModNode>()) {
+      bool a = UsesIter(op->a), b = UsesIter(op->b);
+      uses_iter = a || b;
+      affine = !b;
+    } else {
+      uses_iter = UsesVar(expr, [this](const VarNode* var) { return iters_.count(var); });
+      affine = !uses_iter;
+    }
+    if (!affine && !non_affine_) {
+      non_affine_ = expr;
+    }
+    memo_[expr.get()] = uses_iter;
+    return uses_iter;
+  }
+
+  std::unordered_set<const VarNode*> iters_;
+  std::unordered_map<const Object*, bool> memo_;
+  Optional<PrimExpr> non_affine_;
+};
+
 bool IterRangeSanityCheck(const Map<Var, Range>& iter_ranges) {
   std::unordered_set<Var> iters;
   for (const auto& it : iter_ranges) iters.insert(it.first);
@@ -1440,6 +1541,13 @@ IterMapResult DetectIterMap(const Array<PrimExpr>& indices, const Map<Var, Range
     result->errors.push_back("Invalid iterators.  Iterators may not be expressions of each other.");
     return result;
   }
+  if (auto non_affine = NonAffineExprFinder::Find(indices, input_iters)) {
+    std::ostringstream os;
+    os << "Cannot represent as an IterMap: " << non_affine.value()
+       << " is not affine in the iterators";
+    result->errors.push_back(os.str());
+    return result;
+  }
   Map<Var, Range> constrained_input_iters = input_iters;
   std::vector<IterConstraint> constraints;
   if (!is_one(predicate) &&
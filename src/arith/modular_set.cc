@@ -385,6 +385,7 @@ ModularSet ModularSetAnalyzer::operator()(const PrimExpr& expr) {
 
 void ModularSetAnalyzer::Update(const Var& var, const ModularSet& info, bool allow_override) {
   impl_->Update(var, info, allow_override);
+  if (parent_) parent_->NotifyStateChange();
 }
 
 std::function<void()> ModularSetAnalyzer::EnterConstraint(const PrimExpr& constraint) {
@@ -2406,6 +2406,7 @@ PrimExpr RewriteSimplifier::operator()(const PrimExpr& expr) {
 
 void RewriteSimplifier::Update(const Var& var, const PrimExpr& info, bool allow_override) {
   impl_->Update(var, info, allow_override);
+  if (parent_) parent_->NotifyStateChange();
 }
 
 std::function<void()> RewriteSimplifier::EnterConstraint(const PrimExpr& constraint) {
@@ -2414,6 +2415,7 @@ std::function<void()> RewriteSimplifier::EnterConstraint(const PrimExpr& constra
 
 void RewriteSimplifier::SetEnabledExtensions(Extension flags) {
   impl_->SetEnabledExtensions(flags);
+  if (parent_) parent_->NotifyStateChange();
 }
 RewriteSimplifier::Extension RewriteSimplifier::GetEnabledExtensions() const {
   return impl_->GetEnabledExtensions();
@@ -2425,6 +2427,7 @@ void RewriteSimplifier::ResetStatsCounters() { impl_->ResetStatsCounters(); }
 
 void RewriteSimplifier::SetMaximumRewriteSteps(int64_t maximum) {
   impl_->SetMaximumRewriteSteps(maximum);
+  if (parent_) parent_->NotifyStateChange();
 }
 
 RewriteSimplifier::RewriteSimplifier(Analyzer* parent) : impl_(new Impl(parent)) {}
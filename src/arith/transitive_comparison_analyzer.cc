@@ -535,9 +535,11 @@ CompareResult TransitiveComparisonAnalyzer::TryCompare(const PrimExpr& lhs, cons
 
 void TransitiveComparisonAnalyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
   impl_->Bind(var, expr, allow_override);
+  if (parent_) parent_->NotifyStateChange();
 }
 void TransitiveComparisonAnalyzer::Bind(const Var& var, const Range& range, bool allow_override) {
   impl_->Bind(var, range, allow_override);
+  if (parent_) parent_->NotifyStateChange();
 }
 
 std::function<void()> TransitiveComparisonAnalyzer::EnterConstraint(const PrimExpr& constraint) {
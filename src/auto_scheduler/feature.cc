@@ -40,7 +40,11 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <deque>
+#include <mutex>
 #include <numeric>
+#include <sstream>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -1360,8 +1364,104 @@ void GetPerStoreFeatureName(int max_n_bufs, std::vector<std::string>* ret) {
   // section total : 3
 }
 
-void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, int max_n_bufs,
-                                   std::vector<float>* feature, std::atomic<int>* error_ct) {
+/*!
+ * \brief A bounded cache of the extracted features. The search policies predict the
+ * same states over and over across the rounds of the evolutionary search, and most
+ * of the extraction time goes to the lowering, so the features are cached by the
+ * task and the transform steps of the state, which together determine the lowering.
+ * The task is keyed by its printed compute DAG rather than its workload key, which
+ * does not have to be unique.
+ */
+class PerStoreFeatureCache {
+ public:
+  static PerStoreFeatureCache* Global() {
+    static PerStoreFeatureCache* inst = new PerStoreFeatureCache();
+    return inst;
+  }
+
+  /*! \brief Get the part of the key shared by the states of a task. */
+  static std::string GetTaskKey(const SearchTask& task, int max_n_bufs) {
+    std::ostringstream os;
+    const HardwareParams& hw = task->hardware_params;
+    os << task->compute_dag.PrintDAG() << ';' << task->target->str() << ';' << hw->num_cores
+       << ',' << hw->vector_unit_bytes << ',' << hw->cache_line_bytes << ','
+       << hw->max_shared_memory_per_block << ',' << hw->max_local_memory_per_block << ','
+       << hw->max_threads_per_block << ',' << hw->max_vthread_extent << ';' << max_n_bufs << ';';
+    return os.str();
+  }
+
+  /*! \brief Get the key of a state of the task with the given task key. */
+  static std::string GetKey(const std::string& task_key, const State& state,
+                            bool disable_vectorize, bool instrument_bound_checkers) {
+    std::ostringstream os;
+    os << task_key << disable_vectorize << instrument_bound_checkers << ';';
+    dmlc::JSONWriter writer(&os);
+    writer.BeginArray(false);
+    for (const auto& step : state->transform_steps) {
+      writer.WriteArraySeperator();
+      writer.BeginArray(false);
+      step->WriteToRecord(&writer);
+      writer.EndArray();
+    }
+    writer.EndArray();
+    return os.str();
+  }
+
+  bool Lookup(const std::string& key, std::vector<float>* feature) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = features_.find(key);
+    if (it == features_.end()) {
+      return false;
+    }
+    *feature = it->second;
+    return true;
+  }
+
+  void Insert(const std::string& key, const std::vector<float>& feature) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!features_.emplace(key, feature).second) {
+      return;
+    }
+    keys_.push_back(key);
+    // Evict the oldest entries, as the population of a search moves on with the rounds.
+    while (keys_.size() > kMaxNumEntries) {
+      features_.erase(keys_.front());
+      keys_.pop_front();
+    }
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    features_.clear();
+    keys_.clear();
+  }
+
+ private:
+  static constexpr size_t kMaxNumEntries = 1 << 16;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::vector<float>> features_;
+  /*! \brief The keys in insertion order. */
+  std::deque<std::string> keys_;
+};
+
+void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const std::string& task_key,
+                                   const State& state, int max_n_bufs, std::vector<float>* feature,
+                                   std::atomic<int>* error_ct) {
+  auto pass_ctx = tvm::transform::PassContext::Current();
+  bool disable_vectorize = pass_ctx->GetConfig<Bool>("tir.disable_vectorize", Bool(false)).value();
+  bool instrument_bound_checkers =
+      pass_ctx->GetConfig<Bool>("tir.instrument_bound_checkers", Bool(false)).value();
+  std::string cache_key =
+      PerStoreFeatureCache::GetKey(task_key, state, disable_vectorize, instrument_bound_checkers);
+  if (PerStoreFeatureCache::Global()->Lookup(cache_key, feature)) {
+    // The states failing the lowering are cached with empty features.
+    if (feature->empty()) {
+      (*error_ct)++;
+    }
+    return;
+  }
+
   auto [sch, tensors] = task->compute_dag.ApplySteps(state->transform_steps);
 
   // When inlining, replace const matrices with const values.
@@ -1372,16 +1472,10 @@ void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, i
 
   try {
     const std::string& name = "main";
-    auto pass_ctx = tvm::transform::PassContext::Current();
 
     auto mod = ScheduleToModule(sch, Array<ObjectRef>{tensors.begin(), tensors.end()}, name,
                                 std::unordered_map<te::Tensor, te::Buffer>(), GlobalVarSupply());
 
-    bool disable_vectorize =
-        pass_ctx->GetConfig<Bool>("tir.disable_vectorize", Bool(false)).value();
-    bool instrument_bound_checkers =
-        pass_ctx->GetConfig<Bool>("tir.instrument_bound_checkers", Bool(false)).value();
-
     if (IsGPUTask(task)) {
       auto pass_list = Array<tvm::transform::Pass>();
       // Phase 0
@@ -1418,6 +1512,7 @@ void GetPerStoreFeaturesWorkerFunc(const SearchTask& task, const State& state, i
   } catch (Error& e) {
     (*error_ct)++;
   }
+  PerStoreFeatureCache::Global()->Insert(cache_key, *feature);
 }
 
 void GetPerStoreFeaturesFromStates(const Array<State>& states, const SearchTask& task,
@@ -1427,10 +1522,11 @@ void GetPerStoreFeaturesFromStates(const Array<State>& states, const SearchTask&
   features->assign(states.size(), std::vector<float>());
 
   std::atomic<int> error_ct(0);
+  std::string task_key = PerStoreFeatureCache::GetTaskKey(task, max_n_bufs);
 
   support::parallel_for(skip_first_n_feature_extraction, states.size(),
-                        [&task, &states, &max_n_bufs, &features, &error_ct](int i) {
-                          GetPerStoreFeaturesWorkerFunc(task, states[i], max_n_bufs,
+                        [&task, &task_key, &states, &max_n_bufs, &features, &error_ct](int i) {
+                          GetPerStoreFeaturesWorkerFunc(task, task_key, states[i], max_n_bufs,
                                                         &(*features)[i], &error_ct);
                         });
 }
@@ -1442,11 +1538,23 @@ void GetPerStoreFeaturesFromStates(const Array<State>& states, const std::vector
   features->assign(states.size(), std::vector<float>());
 
   std::atomic<int> error_ct(0);
+  // The states of a task share the task object, so its key is only printed once.
+  std::unordered_map<const SearchTaskNode*, std::string> task_key_map;
+  std::vector<const std::string*> task_keys(states.size(), nullptr);
+  for (size_t i = skip_first_n_feature_extraction; i < states.size(); ++i) {
+    auto it = task_key_map.find(tasks[i].get());
+    if (it == task_key_map.end()) {
+      it = task_key_map
+               .emplace(tasks[i].get(), PerStoreFeatureCache::GetTaskKey(tasks[i], max_n_bufs))
+               .first;
+    }
+    task_keys[i] = &it->second;
+  }
 
   support::parallel_for(skip_first_n_feature_extraction, states.size(),
-                        [&tasks, &states, &max_n_bufs, &features, &error_ct](int i) {
-                          GetPerStoreFeaturesWorkerFunc(tasks[i], states[i], max_n_bufs,
-                                                        &(*features)[i], &error_ct);
+                        [&tasks, &task_keys, &states, &max_n_bufs, &features, &error_ct](int i) {
+                          GetPerStoreFeaturesWorkerFunc(tasks[i], *task_keys[i], states[i],
+                                                        max_n_bufs, &(*features)[i], &error_ct);
                         });
 }
 
@@ -1741,6 +1849,10 @@ TVM_REGISTER_GLOBAL("auto_scheduler.GetPerStoreFeatureNames")
       *ret = arr;
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.ClearPerStoreFeatureCache").set_body_typed([]() {
+  PerStoreFeatureCache::Global()->Clear();
+});
+
 TVM_REGISTER_GLOBAL("auto_scheduler.FeaturesFromPrimFunc")
     .set_body_typed([](const PrimFunc& func, int cache_line_size, int max_n_bufs, bool log_scale) {
       std::vector<float> vec;
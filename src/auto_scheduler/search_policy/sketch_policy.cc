@@ -30,11 +30,14 @@
 #include <tvm/support/parallel_for.h>
 
 #include <algorithm>
+#include <cctype>
 #include <iomanip>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <set>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -311,8 +314,143 @@ Array<State> SketchPolicyNode::SearchOneRound(int num_random_states, Array<State
   return EvolutionarySearch(init_population, num_measure_per_iter_ * 2);
 }
 
+/*!
+ * \brief The transform steps of the sketches generated for each sketch signature, shared by
+ * the policies of all tasks. The tasks of the layers of a model often only differ in shapes,
+ * and the sketches of one of them are replayed on the others instead of being derived again.
+ */
+class SketchTemplateCache {
+ public:
+  static SketchTemplateCache* Global() {
+    static SketchTemplateCache* inst = new SketchTemplateCache();
+    return inst;
+  }
+
+  bool Lookup(const std::string& signature, std::vector<Array<Step>>* templates) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = templates_.find(signature);
+    if (it == templates_.end()) {
+      return false;
+    }
+    *templates = it->second;
+    return true;
+  }
+
+  void Insert(const std::string& signature, std::vector<Array<Step>> templates) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    templates_.emplace(signature, std::move(templates));
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::vector<Array<Step>>> templates_;
+};
+
+/*!
+ * \brief Get the shape-agnostic signature of the sketches of a policy, or an empty string if its
+ * sketches cannot be shared. The signature contains the DAG with the numbers erased, the rules,
+ * and everything the rules decide on: the access analysis of the stages, and the comparisons
+ * between the loop lengths of the stages and the hardware parameters.
+ */
+static std::string GetSketchSignature(const SketchPolicyNode& policy) {
+  const SearchTask& task = policy.search_task;
+  const HardwareParams& hw = task->hardware_params;
+  std::ostringstream os;
+  for (const SketchGenerationRule* rule : policy.sketch_rules) {
+    if (dynamic_cast<const RuleCustomSketch*>(rule) != nullptr) {
+      // The custom rules may decide on anything.
+      return "";
+    }
+    os << rule->GetRuleName() << ',';
+  }
+  os << ';' << task->target->str() << ';' << policy.params << ';';
+  for (char c : std::string(task->compute_dag.PrintDAG())) {
+    if (!std::isdigit(static_cast<unsigned char>(c))) {
+      os << c;
+    }
+  }
+  const auto& analyzer = task->compute_dag->access_analyzer;
+  for (const Stage& stage : task->compute_dag->init_state->stages) {
+    os << ';' << analyzer.IsSimpleAccess(stage->op) << analyzer.IsStrictlyInlineable(stage->op)
+       << analyzer.NeedsMultiLevelTiling(stage->op) << analyzer.IsOutput(stage->op);
+    if (stage->op->IsInstance<te::ComputeOpNode>()) {
+      auto [cum_space_len, cum_reduce_len] = GetCumulativeSpaceAndReductionLength(stage);
+      os << (cum_space_len > cum_reduce_len) << (cum_space_len > hw->num_cores * 16)
+         << (cum_space_len > hw->max_threads_per_block) << (cum_reduce_len > 1)
+         << (cum_reduce_len > hw->num_cores) << (cum_reduce_len > hw->warp_size);
+    }
+  }
+  return os.str();
+}
+
+/*!
+ * \brief Replay the transform steps of cached sketches on the initial state of a task. The split
+ * steps are rebuilt with the loop extents of the task.
+ * \return Whether all the sketches are replayed.
+ */
+static bool InstantiateSketchTemplates(const SearchTask& task,
+                                       const std::vector<Array<Step>>& templates,
+                                       Array<State>* out_states) {
+  const ComputeDAG& dag = task->compute_dag;
+  try {
+    for (const Array<Step>& steps : templates) {
+      State state = dag->init_state;
+      for (Step step : steps) {
+        if (auto ps = step.as<SplitStepNode>()) {
+          const Iterator& it = state->stages[ps->stage_id]->iters[ps->iter_id];
+          step = SplitStep(ps->stage_id, ps->iter_id,
+                           it->range.defined() ? it->range->extent : PrimExpr(), ps->lengths,
+                           ps->inner_to_outer);
+        }
+        state.CopyOnWrite()->transform_steps.push_back(step);
+        StepApplyToState(step, &state, dag);
+      }
+      out_states->push_back(std::move(state));
+    }
+  } catch (const Error& e) {
+    out_states->clear();
+    return false;
+  }
+  return true;
+}
+
+/*! \brief Undefine the split factors of the rfactor steps of the sketches. */
+static Array<State> ReplaceRfactorSplitFactors(Array<State> out_states) {
+  // Hack for rfactor: Replace the split factor for rfactor to the undefined Expr(),
+  // so later we can sample random value for the split factor.
+  // Why don't we use Expr() when doing the split for rfactor at the first time?
+  // Because during ApplySteps, a rfactor with undefined Expr() will crash TVM.
+  // So rfactor with undefined Expr() will conflict with cache_write, cache_read, rfactor
+  // in other stages
+  for (size_t i = 0; i < out_states.size(); ++i) {
+    auto state = out_states[i];
+    auto pstate = state.CopyOnWrite();
+    for (size_t step_id = 0; step_id < pstate->transform_steps.size(); ++step_id) {
+      if (pstate->transform_steps[step_id]->IsInstance<RfactorStepNode>()) {
+        ICHECK_GE(step_id, 1);
+        int split_step_id = static_cast<int>(step_id - 1);
+        auto step = pstate->transform_steps[split_step_id].as<SplitStepNode>();
+        ICHECK(step != nullptr);
+        pstate->transform_steps.Set(
+            split_step_id, SplitStep(step->stage_id, step->iter_id, step->extent, {NullOpt},
+                                     step->inner_to_outer));
+      }
+    }
+    out_states.Set(i, std::move(state));
+  }
+  return out_states;
+}
+
 Array<State> SketchPolicyNode::GenerateSketches() {
   const State& init_state = search_task->compute_dag->init_state;
+  std::string signature = GetSketchSignature(*this);
+  std::vector<Array<Step>> templates;
+  Array<State> out_states;
+  if (!signature.empty() && SketchTemplateCache::Global()->Lookup(signature, &templates) &&
+      InstantiateSketchTemplates(search_task, templates, &out_states)) {
+    StdCout(verbose) << "Replay cached sketches\t\t#s: " << out_states.size() << std::endl;
+    return ReplaceRfactorSplitFactors(std::move(out_states));
+  }
 
   // Two ping pong buffers to avoid copy
   Array<State> states_buf1{init_state}, states_buf2;
@@ -324,7 +462,6 @@ Array<State> SketchPolicyNode::GenerateSketches() {
   cur_stage_id_map[init_state] = static_cast<int>(init_state->stages.size()) - 1;
 
   // Derivation rule based enumeration
-  Array<State> out_states;
   while (!pnow->empty()) {
     pnext->clear();
     for (const State& state : *pnow) {
@@ -354,31 +491,15 @@ Array<State> SketchPolicyNode::GenerateSketches() {
     std::swap(pnow, pnext);
   }
 
-  // Hack for rfactor: Replace the split factor for rfactor to the undefined Expr(),
-  // so later we can sample random value for the split factor.
-  // Why don't we use Expr() when doing the split for rfactor at the first time?
-  // Because during ApplySteps, a rfactor with undefined Expr() will crash TVM.
-  // So rfactor with undefined Expr() will conflict with cache_write, cache_read, rfactor
-  // in other stages
-  for (size_t i = 0; i < out_states.size(); ++i) {
-    auto state = out_states[i];
-    auto pstate = state.CopyOnWrite();
-    for (size_t step_id = 0; step_id < pstate->transform_steps.size(); ++step_id) {
-      if (pstate->transform_steps[step_id]->IsInstance<RfactorStepNode>()) {
-        ICHECK_GE(step_id, 1);
-        int split_step_id = static_cast<int>(step_id - 1);
-        auto step = pstate->transform_steps[split_step_id].as<SplitStepNode>();
-        ICHECK(step != nullptr);
-        pstate->transform_steps.Set(
-            split_step_id, SplitStep(step->stage_id, step->iter_id, step->extent, {NullOpt},
-                                     step->inner_to_outer));
-      }
+  if (!signature.empty()) {
+    templates.clear();
+    for (const State& state : out_states) {
+      templates.push_back(state->transform_steps);
     }
-    out_states.Set(i, std::move(state));
+    SketchTemplateCache::Global()->Insert(signature, std::move(templates));
   }
-
   StdCout(verbose) << "Generate Sketches\t\t#s: " << out_states.size() << std::endl;
-  return out_states;
+  return ReplaceRfactorSplitFactors(std::move(out_states));
 }
 
 Array<State> SketchPolicyNode::SampleInitPopulation(const Array<State>& sketches) {
@@ -24,10 +24,22 @@
 #include <dmlc/thread_local.h>
 #include <tvm/ir/instrument.h>
 #include <tvm/ir/transform.h>
+#include <tvm/node/reflection.h>
 #include <tvm/node/repr_printer.h>
 #include <tvm/runtime/registry.h>
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <stack>
+#include <unordered_set>
+#include <vector>
 
 namespace tvm {
 namespace instrument {
@@ -199,6 +211,81 @@ TVM_STATIC_IR_FUNCTOR(ReprPrinter, vtable)
       p->stream << node->name;
     });
 
+/*!
+ * \brief Get the memory usage of the process.
+ * \param rss The resident memory in bytes.
+ * \param peak_rss The peak resident memory in bytes.
+ * \note Both are 0 on the platforms not supported.
+ */
+void GetMemoryUsage(int64_t* rss, int64_t* peak_rss) {
+  *rss = 0;
+  *peak_rss = 0;
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+    *peak_rss = usage.ru_maxrss;
+#else
+    *peak_rss = static_cast<int64_t>(usage.ru_maxrss) * 1024;
+#endif
+  }
+#endif
+#if defined(__linux__)
+  std::ifstream statm("/proc/self/statm");
+  int64_t size = 0, resident = 0;
+  if (statm >> size >> resident) {
+    *rss = resident * getpagesize();
+  }
+#endif
+}
+
+/*! \brief Count the distinct IR nodes reachable from a module. */
+class IRNodeCounter : public AttrVisitor {
+ public:
+  static int64_t Count(const IRModule& mod) {
+    IRNodeCounter counter;
+    counter.Push(mod.get());
+    while (!counter.stack_.empty()) {
+      const Object* node = counter.stack_.back();
+      counter.stack_.pop_back();
+      if (const auto* array = node->as<ArrayNode>()) {
+        for (const ObjectRef& elem : *array) {
+          counter.Push(elem.get());
+        }
+      } else if (const auto* map = node->as<MapNode>()) {
+        for (const auto& kv : *map) {
+          counter.Push(kv.first.get());
+          counter.Push(kv.second.get());
+        }
+      } else {
+        ReflectionVTable::Global()->VisitAttrs(const_cast<Object*>(node), &counter);
+      }
+    }
+    return counter.visited_.size();
+  }
+
+  void Visit(const char* key, double* value) final {}
+  void Visit(const char* key, int64_t* value) final {}
+  void Visit(const char* key, uint64_t* value) final {}
+  void Visit(const char* key, int* value) final {}
+  void Visit(const char* key, bool* value) final {}
+  void Visit(const char* key, std::string* value) final {}
+  void Visit(const char* key, void** value) final {}
+  void Visit(const char* key, DataType* value) final {}
+  void Visit(const char* key, runtime::NDArray* value) final {}
+  void Visit(const char* key, ObjectRef* value) final { Push(value->get()); }
+
+ private:
+  void Push(const Object* node) {
+    if (node != nullptr && visited_.insert(node).second) {
+      stack_.push_back(node);
+    }
+  }
+
+  std::unordered_set<const Object*> visited_;
+  std::vector<const Object*> stack_;
+};
+
 /*! \brief PassProfile stores profiling information for a given pass and its sub-passes. */
 struct PassProfile {
   // TODO(@altanh): expose PassProfile through TVM Object API
@@ -214,6 +301,12 @@ struct PassProfile {
   Time end;
   /*! \brief The total duration of the pass, i.e. end - start. */
   Duration duration;
+  /*! \brief The resident memory in bytes when the pass was entered and completed. */
+  int64_t start_rss{0}, end_rss{0};
+  /*! \brief The peak resident memory in bytes when the pass was entered and completed. */
+  int64_t start_peak_rss{0}, end_peak_rss{0};
+  /*! \brief The number of IR nodes before and after the pass, -1 if not counted. */
+  int64_t start_ir_nodes{-1}, end_ir_nodes{-1};
   /*! \brief PassProfiles for all sub-passes invoked during the execution of the pass. */
   std::vector<PassProfile> children;
 
@@ -223,9 +316,9 @@ struct PassProfile {
   /*! \brief Gets the PassProfile of the currently executing pass. */
   static PassProfile* Current();
   /*! \brief Pushes a new PassProfile with the given pass name. */
-  static void EnterPass(String name);
+  static void EnterPass(String name, const IRModule& mod, bool count_ir_nodes = false);
   /*! \brief Pops the current PassProfile. */
-  static void ExitPass();
+  static void ExitPass(const IRModule& mod, bool count_ir_nodes = false);
 };
 
 struct PassProfileThreadLocalEntry {
@@ -240,16 +333,27 @@ struct PassProfileThreadLocalEntry {
 /*! \brief Thread local store to hold the pass profiling data. */
 typedef dmlc::ThreadLocalStore<PassProfileThreadLocalEntry> PassProfileThreadLocalStore;
 
-void PassProfile::EnterPass(String name) {
+void PassProfile::EnterPass(String name, const IRModule& mod, bool count_ir_nodes) {
   PassProfile* cur = PassProfile::Current();
   cur->children.emplace_back(name);
-  PassProfileThreadLocalStore::Get()->profile_stack.push(&cur->children.back());
+  PassProfile* profile = &cur->children.back();
+  if (count_ir_nodes) {
+    profile->start_ir_nodes = IRNodeCounter::Count(mod);
+  }
+  GetMemoryUsage(&profile->start_rss, &profile->start_peak_rss);
+  // Take the time last, not to count the profiling itself.
+  profile->start = PassProfile::Clock::now();
+  PassProfileThreadLocalStore::Get()->profile_stack.push(profile);
 }
 
-void PassProfile::ExitPass() {
+void PassProfile::ExitPass(const IRModule& mod, bool count_ir_nodes) {
   PassProfile* cur = PassProfile::Current();
   ICHECK_NE(cur->name, "root") << "mismatched enter/exit for pass profiling";
   cur->end = PassProfile::Clock::now();
+  GetMemoryUsage(&cur->end_rss, &cur->end_peak_rss);
+  if (count_ir_nodes) {
+    cur->end_ir_nodes = IRNodeCounter::Count(mod);
+  }
   cur->duration = std::chrono::duration_cast<PassProfile::Duration>(cur->end - cur->start);
   PassProfileThreadLocalStore::Get()->profile_stack.pop();
 }
@@ -315,16 +419,101 @@ String RenderPassProfiles() {
   return os.str();
 }
 
-TVM_REGISTER_GLOBAL("instrument.RenderTimePassProfiles").set_body_typed(RenderPassProfiles);
+/*! \brief Get the finished top level pass profiles of this thread. */
+const std::vector<PassProfile>& FinishedPassProfiles() {
+  PassProfileThreadLocalEntry* entry = PassProfileThreadLocalStore::Get();
+  CHECK(entry->profile_stack.empty()) << "cannot export pass profile while still in a pass!";
+  return entry->root.children;
+}
+
+/*!
+ * \brief Export the pass profiles in the Chrome trace event format, which can be loaded
+ *  by chrome://tracing or Perfetto. The memory and IR size are in the args of the events.
+ */
+String ExportPassProfilesChromeTrace() {
+  const std::vector<PassProfile>& profiles = FinishedPassProfiles();
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3);
+  os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  if (profiles.empty()) {
+    os << "]}";
+    return os.str();
+  }
+  PassProfile::Time origin = profiles.front().start;
+  bool first = true;
+  std::vector<const PassProfile*> stack;
+  for (auto it = profiles.rbegin(); it != profiles.rend(); ++it) {
+    stack.push_back(&*it);
+  }
+  while (!stack.empty()) {
+    const PassProfile* profile = stack.back();
+    stack.pop_back();
+    for (auto it = profile->children.rbegin(); it != profile->children.rend(); ++it) {
+      stack.push_back(&*it);
+    }
+    PassProfile::Duration ts = profile->start - origin;
+    std::string name = profile->name;
+    os << (first ? "" : ",") << "\n  {\"name\": " << std::quoted(name)
+       << ", \"cat\": \"pass\", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, \"ts\": " << ts.count()
+       << ", \"dur\": " << profile->duration.count() << ", \"args\": {"
+       << "\"rss_delta_bytes\": " << profile->end_rss - profile->start_rss
+       << ", \"peak_rss_delta_bytes\": " << profile->end_peak_rss - profile->start_peak_rss
+       << ", \"peak_rss_bytes\": " << profile->end_peak_rss;
+    if (profile->start_ir_nodes >= 0) {
+      os << ", \"ir_nodes_before\": " << profile->start_ir_nodes
+         << ", \"ir_nodes_after\": " << profile->end_ir_nodes;
+    }
+    os << "}}";
+    first = false;
+  }
+  os << "\n]}";
+  return os.str();
+}
 
-TVM_REGISTER_GLOBAL("instrument.MakePassTimingInstrument").set_body_typed([]() {
-  auto run_before_pass = [](const IRModule&, const transform::PassInfo& pass_info) {
-    PassProfile::EnterPass(pass_info->name);
+/*!
+ * \brief Export the self time of the passes in microseconds in the folded stack format,
+ *  one "outer;inner time" line per pass, as consumed by flamegraph.pl and speedscope.
+ */
+String ExportPassProfilesFoldedStacks() {
+  const std::vector<PassProfile>& profiles = FinishedPassProfiles();
+  std::ostringstream os;
+  // (stack of the parent, pass)
+  std::vector<std::pair<std::string, const PassProfile*>> stack;
+  for (auto it = profiles.rbegin(); it != profiles.rend(); ++it) {
+    stack.emplace_back("", &*it);
+  }
+  while (!stack.empty()) {
+    auto [parent, profile] = stack.back();
+    stack.pop_back();
+    std::string name = profile->name;
+    std::string path = parent.empty() ? name : parent + ";" + name;
+    PassProfile::Duration self_duration = profile->duration;
+    for (auto it = profile->children.rbegin(); it != profile->children.rend(); ++it) {
+      self_duration -= it->duration;
+      stack.emplace_back(path, &*it);
+    }
+    os << path << " " << std::max<int64_t>(static_cast<int64_t>(self_duration.count()), 0)
+       << "\n";
+  }
+  return os.str();
+}
+
+TVM_REGISTER_GLOBAL("instrument.RenderTimePassProfiles").set_body_typed(RenderPassProfiles);
+TVM_REGISTER_GLOBAL("instrument.ExportPassProfilesChromeTrace")
+    .set_body_typed(ExportPassProfilesChromeTrace);
+TVM_REGISTER_GLOBAL("instrument.ExportPassProfilesFoldedStacks")
+    .set_body_typed(ExportPassProfilesFoldedStacks);
+
+TVM_REGISTER_GLOBAL("instrument.MakePassTimingInstrument").set_body_typed([](bool count_ir_nodes) {
+  auto run_before_pass = [count_ir_nodes](const IRModule& mod,
+                                          const transform::PassInfo& pass_info) {
+    PassProfile::EnterPass(pass_info->name, mod, count_ir_nodes);
     return true;
   };
 
-  auto run_after_pass = [](const IRModule&, const transform::PassInfo& pass_info) {
-    PassProfile::ExitPass();
+  auto run_after_pass = [count_ir_nodes](const IRModule& mod,
+                                         const transform::PassInfo& pass_info) {
+    PassProfile::ExitPass(mod, count_ir_nodes);
   };
 
   auto exit_pass_ctx = []() { PassProfileThreadLocalStore::Get()->root.children.clear(); };
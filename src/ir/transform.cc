@@ -29,8 +29,12 @@
 #include <tvm/relax/tuning_api.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
+#include <tvm/support/parallel_for.h>
 
+#include <algorithm>
 #include <chrono>
+#include <exception>
 #include <iomanip>
 #include <stack>
 #include <unordered_set>
@@ -46,6 +50,7 @@ using tvm::runtime::TVMArgs;
 using tvm::runtime::TVMRetValue;
 
 TVM_REGISTER_PASS_CONFIG_OPTION("testing.immutable_module", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("ir.num_pass_threads", Integer);
 
 struct PassContextThreadLocalEntry {
   /*! \brief The default pass context. */
@@ -85,6 +90,45 @@ PassContext PassContext::Current() {
   }
 }
 
+void PassContext::ParallelFor(int num_tasks, const std::function<void(int)>& ftask) const {
+  // Set on the threads running the tasks, the nested calls run serially.
+  static thread_local bool in_parallel_for = false;
+  int num_threads = 1;
+  if (!in_parallel_for) {
+    Integer config = operator->()->GetConfig<Integer>("ir.num_pass_threads", Integer(1)).value();
+    num_threads = static_cast<int>(config->value);
+    if (num_threads < 0) {
+      num_threads = runtime::threading::MaxConcurrency();
+    }
+    num_threads = std::min(num_threads, num_tasks);
+  }
+  if (num_threads <= 1) {
+    for (int i = 0; i < num_tasks; ++i) {
+      ftask(i);
+    }
+    return;
+  }
+  std::vector<std::exception_ptr> errors(num_tasks);
+  support::parallel_for_dynamic(0, num_tasks, num_threads, [&](int thread_id, int task_id) {
+    // The worker threads see this context as the current one, without calling the
+    // instruments again, which were entered by the calling thread.
+    PassContextThreadLocalEntry* entry = RelayPassContextThreadLocalStore::Get();
+    bool entered = entry->context_stack.empty() || !entry->context_stack.top().same_as(*this);
+    if (entered) entry->context_stack.push(*this);
+    in_parallel_for = true;
+    try {
+      ftask(task_id);
+    } catch (...) {
+      errors[task_id] = std::current_exception();
+    }
+    in_parallel_for = false;
+    if (entered) entry->context_stack.pop();
+  });
+  for (const std::exception_ptr& error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
 // linearly scan the pass array to match pass_name
 bool PassArrayContains(const Array<runtime::String>& pass_array, const std::string& pass_name) {
   for (auto x : pass_array) {
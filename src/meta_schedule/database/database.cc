@@ -72,13 +72,15 @@ Workload Workload::FromJSON(const ObjectRef& json_obj) {
 /******** TuningRecord ********/
 
 TuningRecord::TuningRecord(tir::Trace trace, Workload workload, Optional<Array<FloatImm>> run_secs,
-                           Optional<Target> target, Optional<Array<ArgInfo>> args_info) {
+                           Optional<Target> target, Optional<Array<ArgInfo>> args_info,
+                           Optional<Map<String, FloatImm>> metrics) {
   ObjectPtr<TuningRecordNode> n = make_object<TuningRecordNode>();
   n->trace = trace;
   n->workload = workload;
   n->run_secs = run_secs;
   n->target = target;
   n->args_info = args_info;
+  n->metrics = metrics;
   this->data_ = n;
 }
 
@@ -107,10 +109,15 @@ ObjectRef TuningRecordNode::AsJSON() const {
   if (target.defined()) {
     json_target = target.value()->Export();
   }
-  return Array<ObjectRef>{trace->AsJSON(false),  //
-                          run_secs,              //
-                          json_target,           //
-                          json_args_info};
+  Array<ObjectRef> json{trace->AsJSON(false),  //
+                        run_secs,              //
+                        json_target,           //
+                        json_args_info};
+  // The metrics are appended only when present to keep the JSON format of existing logs
+  if (metrics.defined()) {
+    json.push_back(metrics.value());
+  }
+  return json;
 }
 
 bool TuningRecordNode::IsValid() const {
@@ -133,9 +140,10 @@ TuningRecord TuningRecord::FromJSON(const ObjectRef& json_obj, const Workload& w
   Optional<Array<FloatImm>> run_secs{nullptr};
   Optional<Target> target{nullptr};
   Optional<Array<ArgInfo>> args_info{nullptr};
+  Optional<Map<String, FloatImm>> metrics{nullptr};
   try {
     const ArrayNode* json_array = json_obj.as<ArrayNode>();
-    CHECK(json_array && json_array->size() == 4);
+    CHECK(json_array && (json_array->size() == 4 || json_array->size() == 5));
     // Load json[1] => run_secs
     if (json_array->at(1).defined()) {
       run_secs = AsFloatArray(json_array->at(1));
@@ -154,6 +162,18 @@ TuningRecord TuningRecord::FromJSON(const ObjectRef& json_obj, const Workload& w
       }
       args_info = info;
     }
+    // Load json[4] => metrics
+    if (json_array->size() == 5 && json_array->at(4).defined()) {
+      Map<String, FloatImm> loaded;
+      for (const auto& kv : Downcast<Map<String, ObjectRef>>(json_array->at(4))) {
+        if (const auto* int_imm = kv.second.as<IntImmNode>()) {
+          loaded.Set(kv.first, FloatImm(DataType::Float(64), int_imm->value));
+        } else {
+          loaded.Set(kv.first, Downcast<FloatImm>(kv.second));
+        }
+      }
+      metrics = loaded;
+    }
     // Load json[0] => trace
     {
       const ObjectRef& json_trace = json_array->at(0);
@@ -167,7 +187,7 @@ TuningRecord TuningRecord::FromJSON(const ObjectRef& json_obj, const Workload& w
     LOG(FATAL) << "ValueError: Unable to parse the JSON object: " << json_obj
                << "\nThe error is: " << e.what();
   }
-  return TuningRecord(trace, workload, run_secs, target, args_info);
+  return TuningRecord(trace, workload, run_secs, target, args_info, metrics);
 }
 
 /******** Database ********/
@@ -290,8 +310,9 @@ TVM_REGISTER_GLOBAL("meta_schedule.WorkloadAsJSON")
 TVM_REGISTER_GLOBAL("meta_schedule.WorkloadFromJSON").set_body_typed(&Workload::FromJSON);
 TVM_REGISTER_GLOBAL("meta_schedule.TuningRecord")
     .set_body_typed([](tir::Trace trace, Workload workload, Optional<Array<FloatImm>> run_secs,
-                       Optional<Target> target, Optional<Array<ArgInfo>> args_info) {
-      return TuningRecord(trace, workload, run_secs, target, args_info);
+                       Optional<Target> target, Optional<Array<ArgInfo>> args_info,
+                       Optional<Map<String, FloatImm>> metrics) {
+      return TuningRecord(trace, workload, run_secs, target, args_info, metrics);
     });
 TVM_REGISTER_GLOBAL("meta_schedule.TuningRecordAsMeasureCandidate")
     .set_body_method<TuningRecord>(&TuningRecordNode::AsMeasureCandidate);
@@ -0,0 +1,500 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../../runtime/file_utils.h"
+#include "../module_equality.h"
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+std::vector<ObjectRef> JSONFileReadLines(const String& path, int num_threads, bool allow_missing);
+void JSONFileAppendLine(const String& path, const std::string& line);
+
+/*! \brief A tuning record in the index, decoded from the record file on first use. */
+struct IndexedRecordEntry {
+  /*! \brief The mean run seconds, by which the records of a workload are ranked. */
+  double mean_run_secs;
+  /*! \brief The byte offset of the line of the record in the record file. */
+  uint64_t offset;
+  /*! \brief The byte length of the line, excluding the newline. */
+  uint64_t length;
+  /*! \brief The decoded record, undefined until it is queried. */
+  Optional<TuningRecord> record;
+};
+
+/*! \brief The on-disk layout of an index entry. */
+struct IndexFileEntry {
+  int64_t workload_index;
+  uint64_t offset;
+  uint64_t length;
+  double mean_run_secs;
+};
+
+/*!
+ * \brief A database that stores tuning records in the same files as JSONDatabase, with a binary
+ *  index of the retained records per workload next to the record file.
+ *
+ * Opening the database only reads the index and the part of the record file appended after the
+ * index was written. Records are kept mapped and decoded when a query touches their workload.
+ * At most `top_k_per_workload` records are retained per workload, and the record file is
+ * rewritten without the dropped records once `compact_threshold` of them accumulated.
+ */
+class IndexedJSONDatabaseNode : public DatabaseNode {
+ public:
+  explicit IndexedJSONDatabaseNode(String mod_eq_name = "structural")
+      : DatabaseNode(mod_eq_name),
+        workloads2idx_(/*bucket_count*/ 0, WorkloadHash(), WorkloadEqual(GetModuleEquality())) {}
+
+  ~IndexedJSONDatabaseNode() {
+    if (index_dirty_) {
+      WriteIndex();
+    }
+  }
+
+  /*! \brief The path to the workload table */
+  String path_workload;
+  /*! \brief The path to the tuning record table */
+  String path_tuning_record;
+  /*! \brief The max number of records retained per workload, 0 retains all records. */
+  int64_t top_k_per_workload;
+  /*! \brief The number of dropped records that triggers a compaction, 0 disables it. */
+  int64_t compact_threshold;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("path_workload", &path_workload);
+    v->Visit("path_tuning_record", &path_tuning_record);
+    v->Visit("top_k_per_workload", &top_k_per_workload);
+    v->Visit("compact_threshold", &compact_threshold);
+    // `workloads2idx_` is not visited
+    // `records_` is not visited
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.IndexedJSONDatabase";
+  TVM_DECLARE_FINAL_OBJECT_INFO(IndexedJSONDatabaseNode, DatabaseNode);
+
+ public:
+  bool HasWorkload(const IRModule& mod) {
+    return workloads2idx_.find(Workload(mod, GetModuleEquality().Hash(mod))) !=
+           workloads2idx_.end();
+  }
+
+  Workload CommitWorkload(const IRModule& mod) {
+    auto [it, inserted] =
+        this->workloads2idx_.emplace(Workload(mod, GetModuleEquality().Hash(mod)), -1);
+    if (inserted) {
+      it->second = static_cast<int>(this->workloads_.size());
+      this->workloads_.push_back(it->first);
+      this->records_.emplace_back();
+      JSONFileAppendLine(this->path_workload, JSONDumps(it->first->AsJSON()));
+    }
+    return it->first;
+  }
+
+  void CommitTuningRecord(const TuningRecord& record) {
+    int64_t workload_index = this->workloads2idx_.at(record->workload);
+    std::string line = JSONDumps(Array<ObjectRef>{
+        /*workload_index=*/Integer(workload_index),
+        /*tuning_record=*/record->AsJSON()  //
+    });
+    IndexedRecordEntry entry;
+    entry.mean_run_secs = SortTuningRecordByMeanRunSecs::Mean(record->run_secs.value_or({}));
+    entry.offset = record_file_size_;
+    entry.length = line.size();
+    entry.record = record;
+    record_stream_ << line << '\n';
+    record_stream_.flush();
+    CHECK(record_stream_.good()) << "ValueError: Cannot write to the file: " << path_tuning_record;
+    record_file_size_ += line.size() + 1;
+    AddEntry(workload_index, std::move(entry));
+    MaybeCompact();
+  }
+
+  Array<TuningRecord> GetTopK(const Workload& workload, int top_k) {
+    CHECK_GE(top_k, 0) << "ValueError: top_k must be non-negative";
+    if (top_k == 0) {
+      return {};
+    }
+    auto it = workloads2idx_.find(workload);
+    if (it == workloads2idx_.end()) {
+      return {};
+    }
+    Array<TuningRecord> results;
+    results.reserve(top_k);
+    for (IndexedRecordEntry& entry : records_[it->second]) {
+      TuningRecord record = Decode(it->second, &entry);
+      if (!record->IsValid()) {
+        continue;
+      }
+      results.push_back(record);
+      if (results.size() == static_cast<size_t>(top_k)) {
+        break;
+      }
+    }
+    return results;
+  }
+
+  Array<TuningRecord> GetAllTuningRecords() {
+    std::vector<std::pair<double, TuningRecord>> records;
+    records.reserve(Size());
+    for (size_t i = 0; i < records_.size(); ++i) {
+      for (IndexedRecordEntry& entry : records_[i]) {
+        records.emplace_back(entry.mean_run_secs, Decode(i, &entry));
+      }
+    }
+    std::stable_sort(records.begin(), records.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    Array<TuningRecord> results;
+    results.reserve(records.size());
+    for (const auto& kv : records) {
+      results.push_back(kv.second);
+    }
+    return results;
+  }
+
+  int64_t Size() { return num_records_; }
+
+  /*!
+   * \brief Rewrite the record file with only the retained records, and rewrite the index.
+   */
+  void Compact() {
+    std::string compact_path = std::string(path_tuning_record) + ".compact";
+    {
+      std::ofstream os(compact_path, std::ofstream::binary | std::ofstream::trunc);
+      CHECK(os.good()) << "ValueError: Cannot create new file: " << compact_path;
+      uint64_t offset = 0;
+      for (size_t i = 0; i < records_.size(); ++i) {
+        for (IndexedRecordEntry& entry : records_[i]) {
+          std::string line;
+          if (entry.offset + entry.length <= data_size_) {
+            line.assign(data_ + entry.offset, entry.length);
+          } else {
+            // Committed after the record file was mapped, the record is always decoded.
+            line = JSONDumps(Array<ObjectRef>{Integer(static_cast<int>(i)),
+                                               entry.record.value()->AsJSON()});
+          }
+          os << line << '\n';
+          entry.offset = offset;
+          entry.length = line.size();
+          offset += line.size() + 1;
+        }
+      }
+      CHECK(os.good()) << "ValueError: Cannot write to the file: " << compact_path;
+    }
+    record_stream_.close();
+    mapping_.reset();
+    std::remove(path_tuning_record.c_str());
+    CHECK_EQ(std::rename(compact_path.c_str(), path_tuning_record.c_str()), 0)
+        << "ValueError: Cannot replace " << path_tuning_record << " with " << compact_path;
+    MapRecordFile();
+    VLOG(1) << "Compacted " << path_tuning_record << ", dropped " << num_stale_ << " records";
+    num_stale_ = 0;
+    WriteIndex();
+    OpenRecordStream();
+  }
+
+  /*!
+   * \brief Load the workloads, the index and the records not covered by the index.
+   * \param allow_missing Whether to create new files when the given paths are not found.
+   */
+  void Load(bool allow_missing) {
+    int num_threads = std::thread::hardware_concurrency();
+    std::vector<ObjectRef> json_objs = JSONFileReadLines(path_workload, num_threads, allow_missing);
+    workloads_.reserve(json_objs.size());
+    workloads2idx_.reserve(json_objs.size());
+    for (size_t i = 0; i < json_objs.size(); ++i) {
+      Workload workload = Workload::FromJSON(json_objs[i]);
+      auto recalc_hash = GetModuleEquality().Hash(workload->mod);
+      if (recalc_hash != workload->shash) {
+        ObjectPtr<WorkloadNode> wkl = make_object<WorkloadNode>(*workload.get());
+        wkl->shash = recalc_hash;
+        workload = Workload(wkl);
+      }
+      workloads2idx_.emplace(workload, i);
+      workloads_.push_back(workload);
+    }
+    records_.resize(workloads_.size());
+    {
+      std::ifstream is(path_tuning_record);
+      if (!is.good()) {
+        CHECK(allow_missing) << "ValueError: File doesn't exist: " << path_tuning_record;
+        std::ofstream os(path_tuning_record);
+        CHECK(os.good()) << "ValueError: Cannot create new file: " << path_tuning_record;
+      }
+    }
+    MapRecordFile();
+    ScanRecords(ReadIndex(), num_threads);
+    if (index_dirty_) {
+      WriteIndex();
+    }
+    OpenRecordStream();
+    MaybeCompact();
+  }
+
+ private:
+  static constexpr uint64_t kIndexMagic = 0x31584449534D5654;  // "TVMSIDX1"
+
+  std::string IndexPath() const { return std::string(path_tuning_record) + ".index"; }
+
+  /*! \brief Map the record file, or read it if mapping is not supported. */
+  void MapRecordFile() {
+    char* data = nullptr;
+    size_t size = 0;
+    file_buffer_.clear();
+    mapping_ = runtime::MapBinaryFile(path_tuning_record, &data, &size);
+    if (mapping_ == nullptr) {
+      std::ifstream is(path_tuning_record, std::ifstream::binary);
+      CHECK(is.good()) << "ValueError: File doesn't exist: " << path_tuning_record;
+      file_buffer_.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+      data = file_buffer_.data();
+      size = file_buffer_.size();
+    }
+    data_ = data;
+    data_size_ = size;
+    record_file_size_ = size;
+  }
+
+  void OpenRecordStream() {
+    record_stream_.open(path_tuning_record, std::ofstream::binary | std::ofstream::app);
+    CHECK(record_stream_.good()) << "ValueError: Cannot open the file to write: "
+                                 << path_tuning_record;
+    // Terminate a line left incomplete by an interrupted writer.
+    if (record_file_size_ > 0 && data_[record_file_size_ - 1] != '\n') {
+      record_stream_ << '\n';
+      record_stream_.flush();
+      ++record_file_size_;
+    }
+  }
+
+  /*!
+   * \brief Read the index file into the retained records.
+   * \return The number of bytes of the record file covered by the index, 0 if the index is
+   *  missing or does not match the record file.
+   */
+  uint64_t ReadIndex() {
+    std::ifstream is(IndexPath(), std::ifstream::binary);
+    if (!is.good()) {
+      return 0;
+    }
+    // The magic, the bytes of the record file covered, the number of dropped records and the
+    // number of entries.
+    uint64_t header[4];
+    if (!is.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != kIndexMagic ||
+        header[1] > data_size_ || (header[1] > 0 && data_[header[1] - 1] != '\n') ||
+        header[3] > header[1]) {
+      LOG(WARNING) << "The index " << IndexPath() << " does not match " << path_tuning_record
+                   << ", rebuilding it";
+      return 0;
+    }
+    std::vector<IndexFileEntry> entries(header[3]);
+    if (!is.read(reinterpret_cast<char*>(entries.data()),
+                 entries.size() * sizeof(IndexFileEntry))) {
+      LOG(WARNING) << "The index " << IndexPath() << " is truncated, rebuilding it";
+      return 0;
+    }
+    for (const IndexFileEntry& entry : entries) {
+      if (entry.workload_index < 0 ||
+          entry.workload_index >= static_cast<int64_t>(workloads_.size()) ||
+          entry.offset + entry.length > header[1]) {
+        LOG(WARNING) << "The index " << IndexPath() << " does not match " << path_workload
+                     << ", rebuilding it";
+        return 0;
+      }
+    }
+    for (const IndexFileEntry& entry : entries) {
+      AddEntry(entry.workload_index,
+               IndexedRecordEntry{entry.mean_run_secs, entry.offset, entry.length, NullOpt});
+    }
+    num_stale_ += header[2];
+    index_dirty_ = false;
+    return header[1];
+  }
+
+  /*! \brief Write the retained records to the index file. */
+  void WriteIndex() {
+    std::vector<IndexFileEntry> entries;
+    entries.reserve(num_records_);
+    for (size_t i = 0; i < records_.size(); ++i) {
+      for (const IndexedRecordEntry& entry : records_[i]) {
+        entries.push_back(IndexFileEntry{static_cast<int64_t>(i), entry.offset, entry.length,
+                                         entry.mean_run_secs});
+      }
+    }
+    uint64_t header[4] = {kIndexMagic, record_file_size_, static_cast<uint64_t>(num_stale_),
+                          static_cast<uint64_t>(entries.size())};
+    std::string tmp_path = IndexPath() + ".tmp";
+    {
+      std::ofstream os(tmp_path, std::ofstream::binary | std::ofstream::trunc);
+      os.write(reinterpret_cast<const char*>(header), sizeof(header));
+      os.write(reinterpret_cast<const char*>(entries.data()),
+               entries.size() * sizeof(IndexFileEntry));
+      if (!os.good()) {
+        LOG(WARNING) << "Cannot write the index " << tmp_path;
+        return;
+      }
+    }
+    std::remove(IndexPath().c_str());
+    if (std::rename(tmp_path.c_str(), IndexPath().c_str()) != 0) {
+      LOG(WARNING) << "Cannot replace the index " << IndexPath();
+      return;
+    }
+    index_dirty_ = false;
+  }
+
+  /*!
+   * \brief Index the records of the record file from the given offset on.
+   * \param begin The byte offset of the first record not covered by the index.
+   * \param num_threads The number of threads used to parse the records.
+   */
+  void ScanRecords(uint64_t begin, int num_threads) {
+    std::vector<std::pair<uint64_t, uint64_t>> lines;
+    for (uint64_t pos = begin; pos < data_size_;) {
+      const void* newline = std::memchr(data_ + pos, '\n', data_size_ - pos);
+      uint64_t end = newline ? static_cast<const char*>(newline) - data_ : data_size_;
+      if (end > pos) {
+        lines.emplace_back(pos, end - pos);
+      }
+      pos = end + 1;
+    }
+    if (lines.empty()) {
+      return;
+    }
+    std::vector<int64_t> workload_indices(lines.size());
+    std::vector<double> mean_run_secs(lines.size());
+    support::parallel_for_dynamic(
+        0, lines.size(), num_threads, [&](int thread_id, int task_id) {
+          const auto& [offset, length] = lines[task_id];
+          ObjectRef json_obj = JSONLoads(std::string(data_ + offset, length));
+          const ArrayNode* arr = json_obj.as<ArrayNode>();
+          CHECK(arr && arr->size() == 2)
+              << "ValueError: Unable to parse TuningRecord at byte " << offset << " of file "
+              << path_tuning_record;
+          int64_t workload_index = Downcast<runtime::Int>(arr->at(0));
+          CHECK(workload_index >= 0 && static_cast<size_t>(workload_index) < workloads_.size())
+              << "ValueError: Invalid workload index " << workload_index << " at byte " << offset
+              << " of file " << path_tuning_record;
+          const ArrayNode* json_record = arr->at(1).as<ArrayNode>();
+          CHECK(json_record && (json_record->size() == 4 || json_record->size() == 5))
+              << "ValueError: Unable to parse TuningRecord at byte " << offset << " of file "
+              << path_tuning_record;
+          workload_indices[task_id] = workload_index;
+          mean_run_secs[task_id] =
+              json_record->at(1).defined()
+                  ? SortTuningRecordByMeanRunSecs::Mean(AsFloatArray(json_record->at(1)))
+                  : SortTuningRecordByMeanRunSecs::kMaxMeanTime;
+        });
+    for (size_t i = 0; i < lines.size(); ++i) {
+      AddEntry(workload_indices[i],
+               IndexedRecordEntry{mean_run_secs[i], lines[i].first, lines[i].second, NullOpt});
+    }
+    VLOG(1) << "Indexed " << lines.size() << " records of " << path_tuning_record;
+  }
+
+  /*! \brief Insert a record into the ranking of its workload, dropping the worst if full. */
+  void AddEntry(int64_t workload_index, IndexedRecordEntry entry) {
+    std::vector<IndexedRecordEntry>& entries = records_[workload_index];
+    // Equal records keep their commit order, as in JSONDatabase.
+    auto it = std::upper_bound(
+        entries.begin(), entries.end(), entry.mean_run_secs,
+        [](double value, const IndexedRecordEntry& e) { return value < e.mean_run_secs; });
+    entries.insert(it, std::move(entry));
+    ++num_records_;
+    if (top_k_per_workload > 0 && static_cast<int64_t>(entries.size()) > top_k_per_workload) {
+      entries.pop_back();
+      --num_records_;
+      ++num_stale_;
+    }
+    index_dirty_ = true;
+  }
+
+  void MaybeCompact() {
+    if (compact_threshold > 0 && num_stale_ >= compact_threshold) {
+      Compact();
+    }
+  }
+
+  TuningRecord Decode(int64_t workload_index, IndexedRecordEntry* entry) {
+    if (!entry->record.defined()) {
+      ICHECK_LE(entry->offset + entry->length, data_size_);
+      ObjectRef json_obj = JSONLoads(std::string(data_ + entry->offset, entry->length));
+      entry->record = TuningRecord::FromJSON(Downcast<Array<ObjectRef>>(json_obj)[1],
+                                             workloads_[workload_index]);
+    }
+    return entry->record.value();
+  }
+
+  /*! \brief All the workloads in the database */
+  std::unordered_map<Workload, int, WorkloadHash, WorkloadEqual> workloads2idx_;
+  /*! \brief The workloads, indexed as in the workload file */
+  std::vector<Workload> workloads_;
+  /*! \brief The retained records of each workload, ranked by mean run seconds */
+  std::vector<std::vector<IndexedRecordEntry>> records_;
+  /*! \brief The number of retained records */
+  int64_t num_records_{0};
+  /*! \brief The number of records dropped from the index but still in the record file */
+  int64_t num_stale_{0};
+  /*! \brief Whether the index file is behind the retained records */
+  bool index_dirty_{false};
+  /*! \brief The mapping of the record file, or nullptr when it was read into file_buffer_ */
+  std::shared_ptr<void> mapping_;
+  std::string file_buffer_;
+  /*! \brief The record file contents when it was mapped */
+  const char* data_{nullptr};
+  size_t data_size_{0};
+  /*! \brief The current size of the record file, including the records appended since */
+  uint64_t record_file_size_{0};
+  std::ofstream record_stream_;
+};
+
+Database Database::IndexedJSONDatabase(String path_workload, String path_tuning_record,
+                                       bool allow_missing, int64_t top_k_per_workload,
+                                       int64_t compact_threshold, String mod_eq_name) {
+  CHECK_GE(top_k_per_workload, 0) << "ValueError: top_k_per_workload must be non-negative";
+  CHECK_GE(compact_threshold, 0) << "ValueError: compact_threshold must be non-negative";
+  ObjectPtr<IndexedJSONDatabaseNode> n = make_object<IndexedJSONDatabaseNode>(mod_eq_name);
+  n->path_workload = path_workload;
+  n->path_tuning_record = path_tuning_record;
+  n->top_k_per_workload = top_k_per_workload;
+  n->compact_threshold = compact_threshold;
+  n->Load(allow_missing);
+  return Database(n);
+}
+
+TVM_REGISTER_NODE_TYPE(IndexedJSONDatabaseNode);
+TVM_REGISTER_GLOBAL("meta_schedule.DatabaseIndexedJSONDatabase")
+    .set_body_typed(Database::IndexedJSONDatabase);
+TVM_REGISTER_GLOBAL("meta_schedule.IndexedJSONDatabaseCompact")
+    .set_body_typed([](Database db) {
+      auto* node = const_cast<IndexedJSONDatabaseNode*>(db.as<IndexedJSONDatabaseNode>());
+      ICHECK(node != nullptr) << "TypeError: Expect an IndexedJSONDatabase, but got "
+                              << db->GetTypeKey();
+      node->Compact();
+    });
+
+}  // namespace meta_schedule
+}  // namespace tvm
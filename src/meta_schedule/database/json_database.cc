@@ -16,9 +16,21 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <fstream>
+#include <iterator>
+#include <memory>
 #include <set>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 #include "../module_equality.h"
 #include "../utils.h"
@@ -65,6 +77,113 @@ void JSONFileAppendLine(const String& path, const std::string& line) {
   os << line << std::endl;
 }
 
+/*!
+ * \brief A JSON lines file shared by concurrent writers of several processes.
+ *
+ * Writers append whole lines under an advisory lock of the file, which is also honored over NFS.
+ * Readers consume complete lines only, so they may tail the file while it is being written.
+ */
+class SharedJSONFile {
+ public:
+  explicit SharedJSONFile(std::string path) : path_(std::move(path)) {
+#if !defined(_WIN32)
+    fd_ = open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+    CHECK_GE(fd_, 0) << "ValueError: Cannot open the file to write: " << path_;
+#endif
+  }
+
+  ~SharedJSONFile() {
+#if !defined(_WIN32)
+    close(fd_);
+#endif
+  }
+
+  /*! \brief RAII guard of the exclusive lock of the file. */
+  class Lock {
+   public:
+    explicit Lock(SharedJSONFile* file) : file_(file) { file_->SetLock(true); }
+    ~Lock() { file_->SetLock(false); }
+
+   private:
+    SharedJSONFile* file_;
+  };
+
+  /*! \return The complete lines appended since the last call. */
+  std::vector<std::string> ReadNewLines() {
+    std::vector<std::string> lines;
+    std::ifstream is(path_, std::ifstream::binary);
+    if (!is.good()) {
+      return lines;
+    }
+    is.seekg(offset_);
+    std::string data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    size_t end = data.rfind('\n');
+    if (end == std::string::npos) {
+      return lines;
+    }
+    for (size_t pos = 0; pos < end;) {
+      size_t newline = data.find('\n', pos);
+      if (newline > pos) {
+        lines.emplace_back(data, pos, newline - pos);
+      }
+      pos = newline + 1;
+    }
+    offset_ += end + 1;
+    return lines;
+  }
+
+  /*!
+   * \brief Append a line, the caller holds the lock and has read all the lines before.
+   * \param line The line to append.
+   */
+  void AppendLine(const std::string& line) {
+#if !defined(_WIN32)
+    off_t size = lseek(fd_, 0, SEEK_END);
+    CHECK_GE(size, 0) << "ValueError: Cannot seek the file: " << path_;
+    std::string data;
+    if (size > 0) {
+      // A writer interrupted in the middle of a line left it unterminated, skip it.
+      char last = '\n';
+      CHECK_EQ(pread(fd_, &last, 1, size - 1), 1) << "ValueError: Cannot read the file: " << path_;
+      if (last != '\n') {
+        data.push_back('\n');
+      }
+    }
+    data += line;
+    data.push_back('\n');
+    for (size_t written = 0; written < data.size();) {
+      ssize_t n = write(fd_, data.data() + written, data.size() - written);
+      CHECK_GT(n, 0) << "ValueError: Cannot write to the file: " << path_;
+      written += n;
+    }
+    offset_ = static_cast<uint64_t>(size) + data.size();
+#else
+    JSONFileAppendLine(path_, line);
+#endif
+  }
+
+ private:
+  void SetLock(bool lock) {
+#if !defined(_WIN32)
+    struct flock fl;
+    fl.l_type = lock ? F_WRLCK : F_UNLCK;
+    fl.l_whence = SEEK_SET;
+    fl.l_start = 0;
+    fl.l_len = 0;
+    while (fcntl(fd_, lock ? F_SETLKW : F_SETLK, &fl) != 0) {
+      CHECK_EQ(errno, EINTR) << "ValueError: Cannot lock the file: " << path_;
+    }
+#endif
+  }
+
+  std::string path_;
+  /*! \brief The number of bytes read so far */
+  uint64_t offset_{0};
+#if !defined(_WIN32)
+  int fd_{-1};
+#endif
+};
+
 /*! \brief The default database implementation, which mimics two database tables with two files. */
 class JSONDatabaseNode : public DatabaseNode {
  public:
@@ -80,10 +199,17 @@ class JSONDatabaseNode : public DatabaseNode {
   std::unordered_map<Workload, int, WorkloadHash, WorkloadEqual> workloads2idx_;
   /*! \brief All the tuning records in the database */
   std::multiset<TuningRecord, SortTuningRecordByMeanRunSecs> tuning_records_;
+  /*!
+   * \brief Whether the files are shared with writers in other processes. Writes are then
+   *  serialized by file locks, reads pick up the records appended by the others, and records
+   *  with the same workload, trace and target as an existing one are dropped.
+   */
+  bool concurrent{false};
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("path_workload", &path_workload);
     v->Visit("path_tuning_record", &path_tuning_record);
+    v->Visit("concurrent", &concurrent);
     // `workloads2idx_` is not visited
     // `tuning_records_` is not visited
   }
@@ -93,11 +219,28 @@ class JSONDatabaseNode : public DatabaseNode {
 
  public:
   bool HasWorkload(const IRModule& mod) {
+    Refresh();
     return workloads2idx_.find(Workload(mod, GetModuleEquality().Hash(mod))) !=
            workloads2idx_.end();
   }
 
   Workload CommitWorkload(const IRModule& mod) {
+    if (concurrent) {
+      Workload workload(mod, GetModuleEquality().Hash(mod));
+      if (auto it = workloads2idx_.find(workload); it != workloads2idx_.end()) {
+        return it->first;
+      }
+      SharedJSONFile::Lock lock(workload_file_.get());
+      // Another process may have committed it since.
+      IngestWorkloads(workload_file_->ReadNewLines());
+      auto [it, inserted] = workloads2idx_.emplace(workload, static_cast<int>(workloads_.size()));
+      if (inserted) {
+        workloads_.push_back(workload);
+        workload_indices_.push_back(it->second);
+        workload_file_->AppendLine(JSONDumps(workload->AsJSON()));
+      }
+      return it->first;
+    }
     // Try to insert `mod` into `workloads_`
     auto [it, inserted] =
         this->workloads2idx_.emplace(Workload(mod, GetModuleEquality().Hash(mod)), -1);
@@ -111,6 +254,21 @@ class JSONDatabaseNode : public DatabaseNode {
   }
 
   void CommitTuningRecord(const TuningRecord& record) {
+    if (concurrent) {
+      int workload_index = workloads2idx_.at(record->workload);
+      SharedJSONFile::Lock lock(record_file_.get());
+      IngestWorkloads(workload_file_->ReadNewLines());
+      IngestRecords(record_file_->ReadNewLines());
+      if (!record_keys_.insert(RecordKey(workload_index, record)).second) {
+        return;
+      }
+      tuning_records_.insert(record);
+      record_file_->AppendLine(JSONDumps(Array<ObjectRef>{
+          /*workload_index=*/Integer(workload_index),
+          /*tuning_record=*/record->AsJSON()  //
+      }));
+      return;
+    }
     this->tuning_records_.insert(record);
     JSONFileAppendLine(this->path_tuning_record,
                        JSONDumps(Array<ObjectRef>{
@@ -124,6 +282,7 @@ class JSONDatabaseNode : public DatabaseNode {
     if (top_k == 0) {
       return {};
     }
+    Refresh();
     Array<TuningRecord> results;
     results.reserve(top_k);
     for (const TuningRecord& record : this->tuning_records_) {
@@ -143,6 +302,7 @@ class JSONDatabaseNode : public DatabaseNode {
   }
 
   Array<TuningRecord> GetAllTuningRecords() {
+    Refresh();
     Array<TuningRecord> results;
     results.reserve(Size());
     for (const TuningRecord& record : this->tuning_records_) {
@@ -151,13 +311,108 @@ class JSONDatabaseNode : public DatabaseNode {
     return results;
   }
 
-  int64_t Size() { return tuning_records_.size(); }
+  int64_t Size() {
+    Refresh();
+    return tuning_records_.size();
+  }
+
+  /*! \brief Read the workloads and records appended by other processes, in concurrent mode. */
+  void Refresh() {
+    if (concurrent) {
+      IngestWorkloads(workload_file_->ReadNewLines());
+      IngestRecords(record_file_->ReadNewLines());
+    }
+  }
+
+  /*! \brief Open the shared files and read their contents, in concurrent mode. */
+  void OpenShared(bool allow_missing) {
+    for (const String& path : {path_workload, path_tuning_record}) {
+      std::ifstream is(path);
+      CHECK(is.good() || allow_missing) << "ValueError: File doesn't exist: " << path;
+    }
+    workload_file_ = std::make_unique<SharedJSONFile>(path_workload);
+    record_file_ = std::make_unique<SharedJSONFile>(path_tuning_record);
+    Refresh();
+  }
+
+ private:
+  /*! \brief The key identifying records measuring the same candidate. */
+  static size_t RecordKey(int workload_index, const TuningRecord& record) {
+    std::string key = std::to_string(workload_index) + JSONDumps(record->trace->AsJSON(false));
+    if (record->target.defined()) {
+      key += record->target.value()->str();
+    }
+    return std::hash<std::string>()(key);
+  }
+
+  void IngestWorkloads(const std::vector<std::string>& lines) {
+    for (const std::string& line : lines) {
+      Workload workload = Workload::FromJSON(JSONLoads(line));
+      auto recalc_hash = GetModuleEquality().Hash(workload->mod);
+      if (recalc_hash != workload->shash) {
+        ObjectPtr<WorkloadNode> wkl = make_object<WorkloadNode>(*workload.get());
+        wkl->shash = recalc_hash;
+        workload = Workload(wkl);
+      }
+      // Two processes may have committed the same workload before seeing each other's.
+      auto it = workloads2idx_.emplace(workload, static_cast<int>(workloads_.size())).first;
+      workloads_.push_back(it->first);
+      workload_indices_.push_back(it->second);
+    }
+  }
+
+  void IngestRecords(const std::vector<std::string>& lines) {
+    int n = lines.size();
+    if (n == 0) {
+      return;
+    }
+    std::vector<TuningRecord> records(n, TuningRecord{nullptr});
+    std::vector<int> workload_indices(n, -1);
+    support::parallel_for_dynamic(
+        0, n, std::thread::hardware_concurrency(), [&](int thread_id, int task_id) {
+          try {
+            ObjectRef json_obj = JSONLoads(lines[task_id]);
+            const ArrayNode* arr = json_obj.as<ArrayNode>();
+            CHECK(arr && arr->size() == 2);
+            int64_t workload_index = Downcast<runtime::Int>(arr->at(0));
+            CHECK(workload_index >= 0 && static_cast<size_t>(workload_index) < workloads_.size());
+            records[task_id] = TuningRecord::FromJSON(arr->at(1), workloads_[workload_index]);
+            workload_indices[task_id] = workload_indices_[workload_index];
+          } catch (std::runtime_error& e) {
+            // Left by a writer interrupted in the middle of a line.
+            LOG(WARNING) << "Skipping a malformed TuningRecord in " << path_tuning_record << ":\n"
+                         << e.what();
+          }
+        });
+    for (int i = 0; i < n; ++i) {
+      if (records[i].defined() &&
+          record_keys_.insert(RecordKey(workload_indices[i], records[i])).second) {
+        tuning_records_.insert(records[i]);
+      }
+    }
+  }
+
+  /*! \brief The workloads in the order of the workload file, in concurrent mode */
+  std::vector<Workload> workloads_;
+  /*! \brief The index in `workloads2idx_` of each workload in `workloads_` */
+  std::vector<int> workload_indices_;
+  /*! \brief The keys of all the tuning records, in concurrent mode */
+  std::unordered_set<size_t> record_keys_;
+  std::unique_ptr<SharedJSONFile> workload_file_;
+  std::unique_ptr<SharedJSONFile> record_file_;
 };
 
 Database Database::JSONDatabase(String path_workload, String path_tuning_record, bool allow_missing,
-                                String mod_eq_name) {
+                                String mod_eq_name, bool concurrent) {
   int num_threads = std::thread::hardware_concurrency();
   ObjectPtr<JSONDatabaseNode> n = make_object<JSONDatabaseNode>(mod_eq_name);
+  if (concurrent) {
+    n->path_workload = path_workload;
+    n->path_tuning_record = path_tuning_record;
+    n->concurrent = true;
+    n->OpenShared(allow_missing);
+    return Database(n);
+  }
   // Load `n->workloads2idx_` from `path_workload`
   std::vector<Workload> workloads;
   {
@@ -216,6 +471,11 @@ Database Database::JSONDatabase(String path_workload, String path_tuning_record,
 
 TVM_REGISTER_NODE_TYPE(JSONDatabaseNode);
 TVM_REGISTER_GLOBAL("meta_schedule.DatabaseJSONDatabase").set_body_typed(Database::JSONDatabase);
+TVM_REGISTER_GLOBAL("meta_schedule.JSONDatabaseRefresh").set_body_typed([](Database db) {
+  auto* node = const_cast<JSONDatabaseNode*>(db.as<JSONDatabaseNode>());
+  ICHECK(node != nullptr) << "TypeError: Expect a JSONDatabase, but got " << db->GetTypeKey();
+  node->Refresh();
+});
 
 }  // namespace meta_schedule
 }  // namespace tvm
@@ -20,6 +20,7 @@
 
 #include <cmath>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <string>
 #include <unordered_map>
@@ -1250,23 +1251,94 @@ struct Feature {
 struct Feature {
   const BufferNode* buffer = nullptr;
   int buffer_order = -1;
-  std::unique_ptr<group1::Feature> group1 = nullptr;
-  std::unique_ptr<group2::Feature> group2 = nullptr;
-  std::unique_ptr<group3::Feature> group3 = nullptr;
-  std::unique_ptr<group4::Feature> group4 = nullptr;
-  std::unique_ptr<group5::Feature> group5 = nullptr;
+  std::shared_ptr<const group1::Feature> group1 = nullptr;
+  std::shared_ptr<const group2::Feature> group2 = nullptr;
+  std::shared_ptr<const group3::Feature> group3 = nullptr;
+  std::shared_ptr<const group4::Feature> group4 = nullptr;
+  std::shared_ptr<const group5::Feature> group5 = nullptr;
   std::shared_ptr<group6::Feature> group6 = nullptr;
 
   bool operator<(const Feature& other) const { return buffer_order < other.buffer_order; }
 };
 
+/*!
+ * \brief The features of a root-level loop nest, one event per buffer store or allocation
+ * in the order the collector visits them.
+ */
+struct LoopNestFeatures {
+  struct Event {
+    bool is_alloc = false;
+    std::shared_ptr<const group1::Feature> group1 = nullptr;
+    std::shared_ptr<const group2::Feature> group2 = nullptr;
+    std::shared_ptr<const group3::Feature> group3 = nullptr;
+    std::shared_ptr<const group4::Feature> group4 = nullptr;
+    std::shared_ptr<const group5::Feature> group5 = nullptr;
+  };
+  std::vector<Event> events;
+};
+
+/*!
+ * \brief A bounded cache from root-level loop nests to their features.
+ *
+ * A root-level loop nest has no loop above it, so its features only depend on the loop nest
+ * itself. Mutators usually change the tiling of a single block, so the loop nests of the other
+ * blocks hit the cache. The loop nests are compared structurally with free buffers mapped,
+ * so that loop nests from different candidates can match.
+ * \note The cache is not thread-safe, each thread owns one.
+ */
+class LoopNestFeatureCache {
+ public:
+  /*! \brief The cache is cleared once it holds this many loop nests */
+  static constexpr size_t kMaxEntries = 1024;
+
+  static uint64_t Hash(const For& loop) {
+    return SHashHandlerDefault().Hash(loop, /*map_free_vars=*/true);
+  }
+
+  std::shared_ptr<const LoopNestFeatures> Find(const For& loop, uint64_t hash,
+                                               bool is_gpu) const {
+    auto it = table_.find(hash);
+    if (it == table_.end()) {
+      return nullptr;
+    }
+    for (const Entry& entry : it->second) {
+      if (entry.is_gpu == is_gpu &&
+          SEqualHandlerDefault(false, nullptr, false).Equal(entry.loop, loop, true)) {
+        return entry.features;
+      }
+    }
+    return nullptr;
+  }
+
+  void Insert(For loop, uint64_t hash, bool is_gpu, LoopNestFeatures features) {
+    if (size_ >= kMaxEntries) {
+      table_.clear();
+      size_ = 0;
+    }
+    table_[hash].push_back(
+        Entry{std::move(loop), is_gpu, std::make_shared<LoopNestFeatures>(std::move(features))});
+    ++size_;
+  }
+
+ private:
+  struct Entry {
+    For loop;
+    bool is_gpu;
+    std::shared_ptr<const LoopNestFeatures> features;
+  };
+
+  std::unordered_map<uint64_t, std::vector<Entry>> table_;
+  size_t size_ = 0;
+};
+
 /*! \brief The main feature extractor */
 class PerStoreFeatureCollector : private StmtVisitor {
  public:
   static std::vector<Feature> Collect(bool is_gpu, int64_t cache_line_bytes,
                                       int64_t arith_intensity_curve_num_samples,
-                                      const IRModule& mod) {
-    PerStoreFeatureCollector collector(is_gpu, cache_line_bytes, arith_intensity_curve_num_samples);
+                                      const IRModule& mod, LoopNestFeatureCache* cache = nullptr) {
+    PerStoreFeatureCollector collector(is_gpu, cache_line_bytes, arith_intensity_curve_num_samples,
+                                       cache);
     for (const auto& kv : mod->functions) {
       if (const PrimFuncNode* func = kv.second.as<PrimFuncNode>()) {
         collector(func->body);
@@ -1285,7 +1357,7 @@ class PerStoreFeatureCollector : private StmtVisitor {
         ICHECK(feature.group3);
         ICHECK(feature.group5);
         if (feature.group4 == nullptr) {
-          feature.group4 = std::make_unique<group4::Feature>();
+          feature.group4 = std::make_shared<group4::Feature>();
         }
         result.push_back(std::move(feature));
       }
@@ -1295,31 +1367,98 @@ class PerStoreFeatureCollector : private StmtVisitor {
   }
 
  private:
+  /*! \brief Collect the buffers of the stores and allocations in the collector's visiting order */
+  class BufferEventCollector : private StmtVisitor {
+   public:
+    static std::vector<const BufferNode*> Collect(const Stmt& stmt) {
+      BufferEventCollector collector;
+      collector(stmt);
+      return std::move(collector.buffers_);
+    }
+
+   private:
+    void VisitStmt_(const BufferStoreNode* store) final {
+      if (!IsConstantStore(store)) {
+        buffers_.push_back(store->buffer.get());
+      }
+    }
+
+    void VisitStmt_(const BlockNode* block) final {
+      StmtVisitor::VisitStmt_(block);
+      for (const Buffer& buffer : block->alloc_buffers) {
+        buffers_.push_back(buffer.get());
+      }
+    }
+
+    std::vector<const BufferNode*> buffers_;
+  };
+
+  static bool IsConstantStore(const BufferStoreNode* store) {
+    return store->value->IsInstance<IntImmNode>() || store->value->IsInstance<FloatImmNode>();
+  }
+
   void VisitStmt_(const ForNode* loop) final {
+    if (cache_ != nullptr && loop_nest_.loops.empty()) {
+      VisitRootLoopNest(GetRef<For>(loop));
+    } else {
+      VisitLoop(loop);
+    }
+  }
+
+  void VisitLoop(const ForNode* loop) {
     int64_t auto_unroll;
     ForVec* for_vec = loop_nest_.Push(loop, &auto_unroll);
     StmtVisitor::VisitStmt_(loop);
     loop_nest_.Pop(loop, for_vec, auto_unroll);
   }
 
-  void VisitStmt_(const BufferStoreNode* store) final {
-    if (store->value->IsInstance<IntImmNode>() || store->value->IsInstance<FloatImmNode>()) {
+  void VisitRootLoopNest(const For& loop) {
+    uint64_t hash = LoopNestFeatureCache::Hash(loop);
+    if (std::shared_ptr<const LoopNestFeatures> cached = cache_->Find(loop, hash, is_gpu_)) {
+      std::vector<const BufferNode*> buffers = BufferEventCollector::Collect(loop);
+      ICHECK_EQ(buffers.size(), cached->events.size());
+      for (size_t i = 0; i < buffers.size(); ++i) {
+        const LoopNestFeatures::Event& event = cached->events[i];
+        if (event.is_alloc) {
+          buffer_features_[buffers[i]].group4 = event.group4;
+        } else {
+          Feature& feature = GetStoreFeature(buffers[i]);
+          feature.group1 = event.group1;
+          feature.group2 = event.group2;
+          feature.group3 = event.group3;
+          feature.group5 = event.group5;
+        }
+      }
       return;
     }
-    const BufferNode* buffer = store->buffer.get();
-    Feature& feature = buffer_features_[buffer];
-    if (feature.buffer == nullptr) {
-      feature.buffer = buffer;
-      feature.buffer_order = buffer_features_.size();
+    LoopNestFeatures features;
+    recording_ = &features;
+    VisitLoop(loop.get());
+    recording_ = nullptr;
+    cache_->Insert(loop, hash, is_gpu_, std::move(features));
+  }
+
+  void VisitStmt_(const BufferStoreNode* store) final {
+    if (IsConstantStore(store)) {
+      return;
     }
-    feature.group1 = std::make_unique<group1::Feature>(store, loop_nest_, is_gpu_);
+    Feature& feature = GetStoreFeature(store->buffer.get());
+    feature.group1 = std::make_shared<group1::Feature>(store, loop_nest_, is_gpu_);
     feature.group2 =
-        std::make_unique<group2::Feature>(store, loop_nest_, cache_line_bytes_, &for_touched_bytes_,
+        std::make_shared<group2::Feature>(store, loop_nest_, cache_line_bytes_, &for_touched_bytes_,
                                           &buffer_touched_under_loop_, &analyzer_);
     feature.group3 =
-        std::make_unique<group3::Feature>(arith_intensity_curve_num_samples_, loop_nest_,
+        std::make_shared<group3::Feature>(arith_intensity_curve_num_samples_, loop_nest_,
                                           for_touched_bytes_, feature.group1->arith_ops);
-    feature.group5 = std::make_unique<group5::Feature>(loop_nest_);
+    feature.group5 = std::make_shared<group5::Feature>(loop_nest_);
+    if (recording_ != nullptr) {
+      LoopNestFeatures::Event event;
+      event.group1 = feature.group1;
+      event.group2 = feature.group2;
+      event.group3 = feature.group3;
+      event.group5 = feature.group5;
+      recording_->events.push_back(std::move(event));
+    }
   }
 
   void VisitStmt_(const BlockNode* block) final {
@@ -1331,18 +1470,39 @@ class PerStoreFeatureCollector : private StmtVisitor {
 
   void HandleBufferAlloc(const Buffer& buffer) {
     Feature& feature = buffer_features_[buffer.get()];
-    feature.group4 = std::make_unique<group4::Feature>(loop_nest_, buffer, &analyzer_);
+    feature.group4 = std::make_shared<group4::Feature>(loop_nest_, buffer, &analyzer_);
+    if (recording_ != nullptr) {
+      LoopNestFeatures::Event event;
+      event.is_alloc = true;
+      event.group4 = feature.group4;
+      recording_->events.push_back(std::move(event));
+    }
+  }
+
+  Feature& GetStoreFeature(const BufferNode* buffer) {
+    Feature& feature = buffer_features_[buffer];
+    if (feature.buffer == nullptr) {
+      feature.buffer = buffer;
+      feature.buffer_order = buffer_features_.size();
+    }
+    return feature;
   }
 
   explicit PerStoreFeatureCollector(bool is_gpu, int64_t cache_line_bytes,
-                                    int64_t arith_intensity_curve_num_samples)
+                                    int64_t arith_intensity_curve_num_samples,
+                                    LoopNestFeatureCache* cache)
       : is_gpu_(is_gpu),
         cache_line_bytes_(cache_line_bytes),
-        arith_intensity_curve_num_samples_(arith_intensity_curve_num_samples) {}
+        arith_intensity_curve_num_samples_(arith_intensity_curve_num_samples),
+        cache_(cache) {}
 
   bool is_gpu_;
   int64_t cache_line_bytes_;
   int64_t arith_intensity_curve_num_samples_;
+  /*! \brief The cache of root-level loop nests, nullptr if caching is disabled */
+  LoopNestFeatureCache* cache_;
+  /*! \brief The features of the root-level loop nest being recorded into the cache */
+  LoopNestFeatures* recording_ = nullptr;
   arith::Analyzer analyzer_;
   LoopNest loop_nest_ = {};
   IntVec for_touched_bytes_ = {};
@@ -1371,11 +1531,12 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
     v->Visit("feature_vector_length", &feature_vector_length);
   }
 
-  void ExtractSingle(IRModule mod, bool is_gpu, std::vector<std::vector<double>>* results) {
+  void ExtractSingle(IRModule mod, bool is_gpu, tir::LoopNestFeatureCache* cache,
+                     std::vector<std::vector<double>>* results) {
     static transform::Sequential passes = tir::transform::PassListForPerStoreFeature();
     mod = passes(std::move(mod));
     std::vector<tir::Feature> features = tir::PerStoreFeatureCollector::Collect(
-        is_gpu, this->cache_line_bytes, this->arith_intensity_curve_num_samples, mod);
+        is_gpu, this->cache_line_bytes, this->arith_intensity_curve_num_samples, mod, cache);
     int n_features = features.size();
     results->resize(n_features);
     for (int i = 0; i < n_features; ++i) {
@@ -1399,10 +1560,18 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
     if (extract_workload) {
       feature_group6 = std::make_unique<tir::group6::Feature>(tune_context->mod.value());
     }
-    auto f = [this, is_gpu, &feature_group6, &candidates, &results](int, int task_id) -> void {
+    // Concurrent calls would share the per-thread caches
+    std::lock_guard<std::mutex> lock(mutex_);
+    int num_threads = std::max(tune_context->num_threads, 1);
+    while (static_cast<int>(loop_nest_caches_.size()) < num_threads) {
+      loop_nest_caches_.push_back(std::make_unique<tir::LoopNestFeatureCache>());
+    }
+    auto f = [this, is_gpu, &feature_group6, &candidates, &results](int thread_id,
+                                                                    int task_id) -> void {
       const auto& candidate = candidates[task_id];
       std::vector<std::vector<double>> features;
-      ExtractSingle(DeepCopyIRModule(candidate->sch->mod()), is_gpu, &features);
+      ExtractSingle(DeepCopyIRModule(candidate->sch->mod()), is_gpu,
+                    loop_nest_caches_[thread_id].get(), &features);
       if (extract_workload) {
         for (auto& feature : features) {
           feature_group6->Export(&feature);
@@ -1410,10 +1579,15 @@ class PerStoreFeatureNode : public FeatureExtractorNode {
       }
       results[task_id] = tir::utils::AsNDArray(features, this->feature_vector_length);
     };
-    support::parallel_for_dynamic(0, candidates.size(), tune_context->num_threads, f);
+    support::parallel_for_dynamic(0, candidates.size(), num_threads, f);
     return results;
   }
 
+  /*! \brief The features of root-level loop nests seen before, one bounded cache per thread */
+  std::vector<std::unique_ptr<tir::LoopNestFeatureCache>> loop_nest_caches_;
+  /*! \brief The mutex guarding the caches */
+  std::mutex mutex_;
+
   static constexpr const char* _type_key = "meta_schedule.PerStoreFeature";
   TVM_DECLARE_FINAL_OBJECT_INFO(PerStoreFeatureNode, FeatureExtractorNode);
 };
@@ -51,7 +51,8 @@ class AddToDatabaseNode : public MeasureCallbackNode {
           /*workload=*/workload,
           /*run_secs=*/run_secs,
           /*target=*/target,
-          /*args_info=*/candidate->args_info));
+          /*args_info=*/candidate->args_info,
+          /*metrics=*/result->metrics));
     }
   }
 
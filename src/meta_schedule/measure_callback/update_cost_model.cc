@@ -16,11 +16,42 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <iomanip>
+#include <vector>
+
 #include "../utils.h"
 
 namespace tvm {
 namespace meta_schedule {
 
+/*!
+ * \brief The fraction of candidate pairs the cost model orders the same way as the measurement.
+ * \param predicted The predicted normalized scores, the larger the better.
+ * \param run_secs The measured mean running time, the smaller the better.
+ * \return The pairwise ranking accuracy, or -1 if there is no comparable pair.
+ */
+double PairwiseRankingAccuracy(const std::vector<double>& predicted,
+                               const std::vector<double>& run_secs) {
+  ICHECK_EQ(predicted.size(), run_secs.size());
+  int64_t num_pairs = 0;
+  int64_t num_concordant = 0;
+  int n = run_secs.size();
+  for (int i = 0; i < n; ++i) {
+    for (int j = i + 1; j < n; ++j) {
+      if (run_secs[i] == run_secs[j]) {
+        continue;
+      }
+      ++num_pairs;
+      bool measured_faster = run_secs[i] < run_secs[j];
+      bool predicted_faster = predicted[i] > predicted[j];
+      if (measured_faster == predicted_faster) {
+        ++num_concordant;
+      }
+    }
+  }
+  return num_pairs == 0 ? -1.0 : static_cast<double>(num_concordant) / num_pairs;
+}
+
 class UpdateCostModelNode : public MeasureCallbackNode {
  public:
   void Apply(const TaskScheduler& task_scheduler, int task_id,
@@ -50,9 +81,37 @@ class UpdateCostModelNode : public MeasureCallbackNode {
         pruned_runner_result.push_back(runner_results[i]);
       }
     }
+    LogRankingAccuracy(cost_model, task->ctx, pruned_candidate, pruned_runner_result);
     cost_model->Update(task->ctx, pruned_candidate, pruned_runner_result);
   }
 
+  /*!
+   * \brief Log how well the cost model, before seeing the batch, ranks the measured candidates.
+   * \note It tells whether a preloaded cost model is good enough to trust its top picks.
+   */
+  static void LogRankingAccuracy(const CostModel& cost_model, const TuneContext& ctx,
+                                 const Array<MeasureCandidate>& candidates,
+                                 const Array<RunnerResult>& runner_results) {
+    Array<MeasureCandidate> measured;
+    std::vector<double> run_secs;
+    for (int i = 0, n = candidates.size(); i < n; ++i) {
+      if (!runner_results[i]->error_msg.defined()) {
+        measured.push_back(candidates[i]);
+        run_secs.push_back(
+            SortTuningRecordByMeanRunSecs::Mean(runner_results[i]->run_secs.value()));
+      }
+    }
+    if (measured.size() < 2) {
+      return;
+    }
+    double accuracy = PairwiseRankingAccuracy(cost_model->Predict(ctx, measured), run_secs);
+    if (accuracy >= 0) {
+      TVM_PY_LOG(INFO, ctx->logger) << "Cost model pairwise ranking accuracy on "
+                                    << measured.size() << " measured candidates: " << std::fixed
+                                    << std::setprecision(4) << accuracy;
+    }
+  }
+
   static constexpr const char* _type_key = "meta_schedule.UpdateCostModel";
   TVM_DECLARE_FINAL_OBJECT_INFO(UpdateCostModelNode, MeasureCallbackNode);
 };
@@ -16,6 +16,8 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <algorithm>
+#include <limits>
 #include <mutex>
 #include <unordered_map>
 
@@ -51,16 +53,162 @@ int64_t Product(const std::vector<int64_t>& array) {
   return result;
 }
 
+/*!
+ * \brief An analytic model of the shared memory each kernel of a scheduled module needs.
+ *
+ * The region a block accesses on a shared buffer is relaxed over the loops below the lowest
+ * common ancestor of all the accesses to the buffer, i.e. the loops its compacted allocation
+ * spans, while the loops above are fixed. Buffers whose footprint is not a constant are
+ * skipped, so the estimate is a lower bound of what the lowered kernel allocates.
+ */
+class SharedMemoryFootprint : private tir::StmtVisitor {
+ public:
+  /*! \return The largest shared memory footprint over the kernels in bytes */
+  static int64_t Estimate(const IRModule& mod) {
+    int64_t result = 0;
+    for (const auto& kv : mod->functions) {
+      if (const auto* func = kv.second.as<tir::PrimFuncNode>()) {
+        SharedMemoryFootprint self;
+        self(func->body);
+        result = std::max(result, self.MaxKernelBytes());
+      }
+    }
+    return result;
+  }
+
+ private:
+  struct Access {
+    std::vector<const tir::ForNode*> loops;
+    Map<tir::Var, PrimExpr> binding;
+    Array<Range> region;
+  };
+
+  void VisitStmt_(const tir::ForNode* loop) final {
+    loops_.push_back(loop);
+    tir::StmtVisitor::VisitStmt_(loop);
+    loops_.pop_back();
+  }
+
+  void VisitStmt_(const tir::BlockRealizeNode* realize) final {
+    const tir::BlockNode* block = realize->block.get();
+    for (const tir::Buffer& buffer : block->alloc_buffers) {
+      if (runtime::StorageScope::Create(buffer.scope()).rank == runtime::StorageRank::kShared) {
+        shared_buffers_.push_back(buffer.get());
+      }
+    }
+    Map<tir::Var, PrimExpr> binding;
+    for (int i = 0, n = block->iter_vars.size(); i < n; ++i) {
+      binding.Set(block->iter_vars[i]->var, realize->iter_values[i]);
+    }
+    for (const Array<tir::BufferRegion>& regions : {block->reads, block->writes}) {
+      for (const tir::BufferRegion& region : regions) {
+        accesses_[region->buffer.get()].push_back(Access{loops_, binding, region->region});
+      }
+    }
+    tir::StmtVisitor::VisitStmt_(realize);
+  }
+
+  int64_t MaxKernelBytes() {
+    // The kernel of a buffer is identified by the outermost loop around its accesses
+    std::unordered_map<const tir::ForNode*, int64_t> kernel_bytes;
+    for (const tir::BufferNode* buffer : shared_buffers_) {
+      auto it = accesses_.find(buffer);
+      if (it == accesses_.end()) {
+        continue;
+      }
+      const std::vector<Access>& accesses = it->second;
+      const tir::ForNode* kernel = accesses[0].loops.empty() ? nullptr : accesses[0].loops[0];
+      int64_t bytes = BufferBytes(buffer, accesses);
+      if (bytes > 0) {
+        kernel_bytes[kernel] += bytes;
+      }
+    }
+    int64_t result = 0;
+    for (const auto& kv : kernel_bytes) {
+      result = std::max(result, kv.second);
+    }
+    return result;
+  }
+
+  int64_t BufferBytes(const tir::BufferNode* buffer, const std::vector<Access>& accesses) {
+    size_t lca = accesses[0].loops.size();
+    for (const Access& access : accesses) {
+      size_t i = 0;
+      while (i < lca && i < access.loops.size() && access.loops[i] == accesses[0].loops[i]) {
+        ++i;
+      }
+      lca = i;
+    }
+    int ndim = buffer->shape.size();
+    std::vector<int64_t> min_index(ndim, std::numeric_limits<int64_t>::max());
+    std::vector<int64_t> max_index(ndim, std::numeric_limits<int64_t>::min());
+    for (const Access& access : accesses) {
+      if (static_cast<int>(access.region.size()) != ndim) {
+        return -1;
+      }
+      Map<tir::Var, arith::IntSet> dom;
+      for (size_t i = 0; i < access.loops.size(); ++i) {
+        const tir::ForNode* loop = access.loops[i];
+        dom.Set(loop->loop_var, i < lca ? arith::IntSet::SinglePoint(loop->min)
+                                        : arith::IntSet::FromMinExtent(loop->min, loop->extent));
+      }
+      for (int d = 0; d < ndim; ++d) {
+        const Range& range = access.region[d];
+        arith::IntSet set = arith::EvalSet(
+            Range::FromMinExtent(tir::Substitute(range->min, access.binding),
+                                 tir::Substitute(range->extent, access.binding)),
+            dom);
+        const auto* lo = analyzer_.Simplify(set.min()).as<IntImmNode>();
+        const auto* hi = analyzer_.Simplify(set.max()).as<IntImmNode>();
+        if (lo == nullptr || hi == nullptr) {
+          return -1;
+        }
+        min_index[d] = std::min(min_index[d], lo->value);
+        max_index[d] = std::max(max_index[d], hi->value);
+      }
+    }
+    int64_t numel = 1;
+    for (int d = 0; d < ndim; ++d) {
+      numel *= max_index[d] - min_index[d] + 1;
+    }
+    return numel * buffer->dtype.bytes() * buffer->dtype.lanes();
+  }
+
+  arith::Analyzer analyzer_;
+  std::vector<const tir::ForNode*> loops_;
+  std::vector<const tir::BufferNode*> shared_buffers_;
+  std::unordered_map<const tir::BufferNode*, std::vector<Access>> accesses_;
+};
+
 /*! \brief A mutator that mutates the tile size */
 class MutateTileSizeNode : public MutatorNode {
  public:
-  void VisitAttrs(tvm::AttrVisitor* v) {}
+  /*! \brief The number of proposals tried before giving up on a footprint-pruned mutation */
+  static constexpr int kMaxFootprintTrials = 16;
+
+  /*! \brief Whether to reject tile sizes whose shared memory footprint exceeds the target's */
+  bool prune_by_footprint = false;
+  /*! \brief The shared memory limit of the target in bytes, -1 if pruning is disabled */
+  int64_t max_shared_memory_bytes_ = -1;
+  /*! \brief The workload the traces apply to */
+  Optional<IRModule> mod_{NullOpt};
+
+  void VisitAttrs(tvm::AttrVisitor* v) { v->Visit("prune_by_footprint", &prune_by_footprint); }
   static constexpr const char* _type_key = "meta_schedule.MutateTileSize";
   TVM_DECLARE_FINAL_OBJECT_INFO(MutateTileSizeNode, MutatorNode);
 
  public:
   // Inherit from `MutatorNode`
-  void InitializeWithTuneContext(const TuneContext& context) final {}
+  void InitializeWithTuneContext(const TuneContext& context) final {
+    max_shared_memory_bytes_ = -1;
+    if (prune_by_footprint && context->target.defined() && context->mod.defined()) {
+      max_shared_memory_bytes_ = context->target.value()
+                                     ->GetAttr<Integer>("max_shared_memory_per_block")
+                                     .value_or(Integer(-1))
+                                     ->value;
+      mod_ = context->mod;
+    }
+  }
   // Inherit from `MutatorNode`
   Optional<Trace> Apply(const Trace& trace, TRandState* rand_state) final;
   // Inherit from `MutatorNode`
@@ -68,6 +216,20 @@ class MutateTileSizeNode : public MutatorNode {
     ObjectPtr<MutateTileSizeNode> n = make_object<MutateTileSizeNode>(*this);
     return Mutator(n);
   }
+
+ private:
+  /*! \brief Whether the shared memory footprint of the trace fits into the target */
+  bool FitsSharedMemory(const Trace& trace) const {
+    try {
+      tir::Schedule sch = tir::Schedule::Traced(mod_.value(), /*seed=*/-1, /*debug_mask=*/0,
+                                                tir::ScheduleErrorRenderLevel::kNone);
+      trace->ApplyToSchedule(sch, /*remove_postproc=*/true);
+      return SharedMemoryFootprint::Estimate(sch->mod()) <= max_shared_memory_bytes_;
+    } catch (const std::exception& e) {
+      // The trace cannot be replayed, and would be rejected after the mutation anyway
+      return false;
+    }
+  }
 };
 
 /*!
@@ -257,8 +419,18 @@ Optional<Trace> MutateTileSizeNode::Apply(const Trace& trace, TRandState* rand_s
   }
   int n = tir::SampleInt(rand_state, 0, size_a + size_b);
   if (n < size_a) {
-    return MutateSampleTileSize(trace, sample_perfect_tile_insts[n], sample_perfect_tile_tiles[n],
-                                rand_state);
+    if (max_shared_memory_bytes_ < 0) {
+      return MutateSampleTileSize(trace, sample_perfect_tile_insts[n],
+                                  sample_perfect_tile_tiles[n], rand_state);
+    }
+    for (int i = 0; i < kMaxFootprintTrials; ++i) {
+      Optional<Trace> result = MutateSampleTileSize(trace, sample_perfect_tile_insts[n],
+                                                    sample_perfect_tile_tiles[n], rand_state);
+      if (!result.defined() || FitsSharedMemory(result.value())) {
+        return result;
+      }
+    }
+    return NullOpt;
   } else {
     n -= size_a;
     return MutateSampleVectorize(trace, sample_vectorize_insts[n], sample_vectorize_decisions[n],
@@ -266,7 +438,11 @@ Optional<Trace> MutateTileSizeNode::Apply(const Trace& trace, TRandState* rand_s
   }
 }
 
-Mutator Mutator::MutateTileSize() { return Mutator(make_object<MutateTileSizeNode>()); }
+Mutator Mutator::MutateTileSize(bool prune_by_footprint) {
+  ObjectPtr<MutateTileSizeNode> n = make_object<MutateTileSizeNode>();
+  n->prune_by_footprint = prune_by_footprint;
+  return Mutator(n);
+}
 
 TVM_REGISTER_NODE_TYPE(MutateTileSizeNode);
 TVM_REGISTER_GLOBAL("meta_schedule.MutatorMutateTileSize").set_body_typed(Mutator::MutateTileSize);
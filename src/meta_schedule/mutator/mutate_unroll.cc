@@ -22,8 +22,8 @@ namespace tvm {
 namespace tir {
 
 /*!
- * \brief Check if an instruction is annotate with
- * `meta_schedule_unroll_explicit` or `meta_schedule_unroll_implicit`
+ * \brief Check if an instruction is annotate with `meta_schedule_unroll_explicit`,
+ * `meta_schedule_unroll_implicit`, `pragma_unroll_factor` or `pragma_unroll_and_jam`
  * \param inst The instruction to be checked
  * \return Whether the instruction is annotated
  */
@@ -35,7 +35,8 @@ bool IsAnnotateWithUnroll(const Instruction& inst) {
   ICHECK_EQ(inst->attrs.size(), 1);
   String ann_key = Downcast<String>(inst->attrs[0]);
   return ann_key == attr::meta_schedule_unroll_explicit ||
-         ann_key == attr::meta_schedule_unroll_implicit;
+         ann_key == attr::meta_schedule_unroll_implicit || ann_key == attr::pragma_unroll_factor ||
+         ann_key == attr::pragma_unroll_and_jam;
 }
 
 }  // namespace tir
@@ -99,7 +100,11 @@ bool FindUnrollDecision(const Trace& trace, TRandState* rand_state,
       const PrimExprNode* var_rv = TVM_TYPE_AS(inst->outputs[0], PrimExprNode);
       sample_insts[var_rv] = inst.get();
     } else if (IsAnnotateWithUnroll(inst)) {
-      ann_insts.push_back(inst.get());
+      // The unroll factors of loops are only tunable when they are sampled.
+      const auto* var_rv = inst->inputs[1].as<PrimExprNode>();
+      if (var_rv != nullptr && sample_insts.count(var_rv)) {
+        ann_insts.push_back(inst.get());
+      }
     }
   }
   int n_ann_insts = ann_insts.size();
@@ -107,9 +112,7 @@ bool FindUnrollDecision(const Trace& trace, TRandState* rand_state,
     return false;
   }
   const InstructionNode* ann_inst = ann_insts[tir::SampleInt(rand_state, 0, n_ann_insts)];
-  ICHECK_EQ(ann_inst->inputs.size(), 2);
   const auto* var_rv = TVM_TYPE_AS(ann_inst->inputs[1], PrimExprNode);
-  ICHECK(sample_insts.count(var_rv));
   const InstructionNode* sample_inst = sample_insts.at(var_rv);
   ICHECK_EQ(sample_inst->attrs.size(), 2);
   candidate->inst = GetRef<Instruction>(sample_inst);
@@ -21,18 +21,22 @@
 namespace tvm {
 namespace meta_schedule {
 
-RunnerInput::RunnerInput(String artifact_path, String device_type, Array<ArgInfo> args_info) {
+RunnerInput::RunnerInput(String artifact_path, String device_type, Array<ArgInfo> args_info,
+                         Optional<FloatImm> best_run_secs) {
   ObjectPtr<RunnerInputNode> n = make_object<RunnerInputNode>();
   n->artifact_path = artifact_path;
   n->device_type = device_type;
   n->args_info = args_info;
+  n->best_run_secs = best_run_secs;
   this->data_ = n;
 }
 
-RunnerResult::RunnerResult(Optional<Array<FloatImm>> run_secs, Optional<String> error_msg) {
+RunnerResult::RunnerResult(Optional<Array<FloatImm>> run_secs, Optional<String> error_msg,
+                           Optional<Map<String, FloatImm>> metrics) {
   ObjectPtr<RunnerResultNode> n = make_object<RunnerResultNode>();
   n->run_secs = run_secs;
   n->error_msg = error_msg;
+  n->metrics = metrics;
   this->data_ = n;
 }
 
@@ -57,13 +61,14 @@ TVM_REGISTER_NODE_TYPE(RunnerFutureNode);
 TVM_REGISTER_OBJECT_TYPE(RunnerNode);
 TVM_REGISTER_NODE_TYPE(PyRunnerNode);
 TVM_REGISTER_GLOBAL("meta_schedule.RunnerInput")
-    .set_body_typed([](String artifact_path, String device_type,
-                       Array<ArgInfo> args_info) -> RunnerInput {
-      return RunnerInput(artifact_path, device_type, args_info);
+    .set_body_typed([](String artifact_path, String device_type, Array<ArgInfo> args_info,
+                       Optional<FloatImm> best_run_secs) -> RunnerInput {
+      return RunnerInput(artifact_path, device_type, args_info, best_run_secs);
     });
 TVM_REGISTER_GLOBAL("meta_schedule.RunnerResult")
-    .set_body_typed([](Array<FloatImm> run_secs, Optional<String> error_msg) -> RunnerResult {
-      return RunnerResult(run_secs, error_msg);
+    .set_body_typed([](Array<FloatImm> run_secs, Optional<String> error_msg,
+                       Optional<Map<String, FloatImm>> metrics) -> RunnerResult {
+      return RunnerResult(run_secs, error_msg, metrics);
     });
 TVM_REGISTER_GLOBAL("meta_schedule.RunnerFuture")
     .set_body_typed([](RunnerFuture::FDone f_done, RunnerFuture::FResult f_result) -> RunnerFuture {
@@ -86,11 +86,29 @@ Array<ScheduleRule> ScheduleRule::DefaultLLVM() {
 }
 
 Array<ScheduleRule> ScheduleRule::DefaultX86(const String& type) {
-  static const Map<String, String> intrins = {{"vnni", "dot_16x4_vnni"},
-                                              {"avx512", "dot_16x4_avx512"}};
-  return {
-      ScheduleRule::ApplyCustomRule(),
-      ScheduleRule::InlineConstantScalars(),
+  // AMX tiles are tried first, the VNNI dot product still covers the workloads whose shapes or
+  // layouts do not fit a 16x16 tile.
+  static const Map<String, Array<String>> intrins = {
+      {"vnni", Array<String>{"dot_16x4_vnni"}},
+      {"avx512", Array<String>{"dot_16x4_avx512"}},
+      {"amx", Array<String>{"dot_16x16x64_u8i8i32_amx", "dot_16x16x32_bf16bf16f32_amx",
+                            "dot_16x4_vnni"}}};
+  Array<ScheduleRule> intrin_rules;
+  for (const String& intrin_name : intrins.at(type)) {
+    intrin_rules.push_back(ScheduleRule::MultiLevelTilingWithIntrin(
+        /*intrin_name=*/intrin_name,
+        /*structure=*/"SSRSRS",
+        /*tile_binds=*/NullOpt,
+        /*max_innermost_factor=*/Integer(64),
+        /*vector_load_lens=*/NullOpt,
+        /*reuse_read=*/NullOpt,
+        /*reuse_write=*/
+        Map<String, ObjectRef>{{"req", String("may")},
+                               {"levels", Array<Integer>{1, 2}},
+                               {"scope", String("global")}}));
+  }
+  return Array<ScheduleRule>::Agregate(
+      ScheduleRule::ApplyCustomRule(), ScheduleRule::InlineConstantScalars(),
       ScheduleRule::AutoInline(
           /*into_producer=*/false,
           /*into_consumer=*/true,
@@ -102,17 +120,7 @@ Array<ScheduleRule> ScheduleRule::DefaultX86(const String& type) {
       ScheduleRule::AddRFactor(
           /*max_jobs_per_core=*/16,
           /*max_innermost_factor=*/Integer(64)),
-      ScheduleRule::MultiLevelTilingWithIntrin(
-          /*intrin_name=*/intrins[type],
-          /*structure=*/"SSRSRS",
-          /*tile_binds=*/NullOpt,
-          /*max_innermost_factor=*/Integer(64),
-          /*vector_load_lens=*/NullOpt,
-          /*reuse_read=*/NullOpt,
-          /*reuse_write=*/
-          Map<String, ObjectRef>{{"req", String("may")},
-                                 {"levels", Array<Integer>{1, 2}},
-                                 {"scope", String("global")}}),
+      intrin_rules,
       ScheduleRule::MultiLevelTiling(
           /*structure=*/"SSRSRS",
           /*tile_binds=*/NullOpt,
@@ -128,8 +136,7 @@ Array<ScheduleRule> ScheduleRule::DefaultX86(const String& type) {
           /*max_vectorize_extent=*/64,
           /*unroll_max_steps=*/Array<runtime::Int>{0, 16, 64, 512},
           /*unroll_explicit=*/true),
-      ScheduleRule::RandomComputeLocation(),
-  };
+      ScheduleRule::RandomComputeLocation());
 }
 
 Array<ScheduleRule> ScheduleRule::DefaultCUDA() {
@@ -0,0 +1,173 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "../utils.h"
+
+namespace tvm {
+namespace meta_schedule {
+
+class SplitKNode : public ScheduleRuleNode {
+ public:
+  // Inherited from ScheduleRuleNode
+  void InitializeWithTuneContext(const TuneContext& context) final {
+    ICHECK(context->target.defined());
+    Target target = context->target.value();
+    Optional<Integer> opt_max_threads_per_block = target->GetAttr<Integer>("max_threads_per_block");
+    if (!opt_max_threads_per_block.defined()) {
+      TVM_PY_LOG(WARNING, context->logger)
+          << "Target does not have attribute \"max_threads_per_block\", therefore the "
+             "rule SplitK will not be applied";
+    }
+    max_threads_per_block = opt_max_threads_per_block.value_or(Integer(-1))->value;
+  }
+
+  // Inherited from ScheduleRuleNode
+  Array<tir::Schedule> Apply(const tir::Schedule& sch, const tir::BlockRV& block_rv) final {
+    // Step 0. Check the conditions of this rule.
+    if (max_threads_per_block == -1) {
+      return {sch};
+    }
+    const tir::StmtSRef& block_sref = sch->GetSRef(block_rv);
+    if (!IsSkinnyReduction(sch->state(), block_sref)) {
+      return {sch};
+    }
+
+    // Step 1. Make a copy of the original schedule. The new copy is used for scheduling.
+    tir::Schedule tmp_sch = sch->Copy();
+    tmp_sch->Seed(sch->ForkSeed());
+    try {
+      // Step 2. Fuse the reduction loops and split them into the K partitions.
+      size_t num_spatial_loops;
+      tir::LoopRV fused_reduce_loop;
+      ReorderAndFuseReductionLoops(tmp_sch, block_rv, &fused_reduce_loop, &num_spatial_loops);
+      if (num_spatial_loops == 0) {
+        return {sch};
+      }
+      int n_split = static_cast<int>(split_factors.size());
+      tir::ExprRV num_splits =
+          tmp_sch->SampleCategorical(split_factors, Array<runtime::Float>(n_split, 1.0 / n_split));
+      Array<tir::LoopRV> split_k = tmp_sch->Split(fused_reduce_loop, {num_splits, NullOpt});
+
+      // Step 3. Compute the partial sums of the partitions into a workspace of shape
+      // [num_splits, *output_shape]. The original block becomes the second pass, which reduces
+      // the partial sums.
+      tir::BlockRV block_rf = tmp_sch->RFactor(split_k[0], /*factor_axis=*/0);
+
+      // Step 4. Bind the spatial loops of the partial sums to blockIdx.x and threadIdx.x, and the
+      // partitions to blockIdx.y, accumulating in a register.
+      Array<tir::LoopRV> loops = tmp_sch->GetLoops(block_rf);
+      ICHECK_EQ(loops.size(), num_spatial_loops + 2);
+      tir::LoopRV fused_spatial =
+          tmp_sch->Fuse({loops.begin(), loops.begin() + num_spatial_loops});
+      int n_thread = static_cast<int>(thread_extents.size());
+      tir::ExprRV thread_extent = tmp_sch->SampleCategorical(
+          thread_extents, Array<runtime::Float>(n_thread, 1.0 / n_thread));
+      Array<tir::LoopRV> spatial = tmp_sch->Split(fused_spatial, {NullOpt, thread_extent});
+      tir::LoopRV partition = loops[num_spatial_loops];
+      tmp_sch->Reorder({spatial[0], partition, spatial[1]});
+      tmp_sch->Bind(spatial[0], "blockIdx.x");
+      tmp_sch->Bind(partition, "blockIdx.y");
+      tmp_sch->Bind(spatial[1], "threadIdx.x");
+      tir::BlockRV write_back = tmp_sch->CacheWrite(block_rf, 0, "local");
+      tmp_sch->ReverseComputeAt(write_back, spatial[1], /*preserve_unit_loops=*/true);
+    } catch (const tvm::runtime::Error& e) {
+      return {sch};
+    }
+    return {tmp_sch, sch};
+  }
+
+  // Inherited from ScheduleRuleNode
+  ScheduleRule Clone() const final {
+    ObjectPtr<SplitKNode> n = make_object<SplitKNode>(*this);
+    return ScheduleRule(n);
+  }
+
+ private:
+  /*!
+   * \brief Check whether the block is a reduction too long for its output, i.e. the output is too
+   * small to occupy the device with the K loop inside each thread.
+   * \param self The schedule state
+   * \param block_sref The block to be checked
+   * \return A boolean indicating whether the block should be split along K
+   */
+  bool IsSkinnyReduction(const tir::ScheduleState& self, const tir::StmtSRef& block_sref) {
+    const tir::BlockNode* block = TVM_SREF_TO_BLOCK(block_sref);
+    if (block->writes.size() != 1) {
+      return false;
+    }
+    const tir::StmtSRef& scope_sref = tir::GetScopeRoot(self, block_sref,
+                                                        /*require_stage_pipeline=*/false);
+    if (!tir::IsReductionBlock(self, block_sref, scope_sref) ||
+        !tir::IsTrivialBinding(self, block_sref) || tir::HasBeenMultiLevelTiled(block_sref)) {
+      return false;
+    }
+    auto [cum_space_len, cum_reduce_len] =
+        tir::GetCumulativeSpaceAndReductionLength(self, block_sref);
+    return cum_space_len != -1 && cum_reduce_len >= min_reduction_extent &&
+           cum_space_len <= max_spatial_extent;
+  }
+
+ public:
+  /*! \brief Candidates of the number of partitions of the reduction loops. */
+  Array<runtime::Int> split_factors;
+  /*! \brief Candidates of thread axis extent of the partial sums. */
+  Array<runtime::Int> thread_extents;
+  /*! \brief The minimum cumulative extent of the reduction loops to split. */
+  int64_t min_reduction_extent;
+  /*! \brief The maximum cumulative extent of the spatial loops of the blocks to split. */
+  int64_t max_spatial_extent;
+  /*! \brief The maximum number of threads allowed in a thread block */
+  int max_threads_per_block;
+
+  void VisitAttrs(tvm::AttrVisitor* v) {
+    v->Visit("split_factors", &split_factors);
+    v->Visit("thread_extents", &thread_extents);
+    v->Visit("min_reduction_extent", &min_reduction_extent);
+    v->Visit("max_spatial_extent", &max_spatial_extent);
+    v->Visit("max_threads_per_block", &max_threads_per_block);
+  }
+
+  static constexpr const char* _type_key = "meta_schedule.SplitK";
+  TVM_DECLARE_FINAL_OBJECT_INFO(SplitKNode, ScheduleRuleNode);
+};
+
+ScheduleRule ScheduleRule::SplitK(Array<runtime::Int> split_factors,
+                                  Array<runtime::Int> thread_extents, int64_t min_reduction_extent,
+                                  int64_t max_spatial_extent) {
+  CHECK(!split_factors.empty() && !thread_extents.empty())
+      << "ValueError: The candidates of split factor and thread extent must not be empty";
+  for (const auto& factor : split_factors) {
+    CHECK(factor->value > 1) << "ValueError: The candidates of split factor must be larger than 1";
+  }
+  for (const auto& extent : thread_extents) {
+    CHECK(extent->value > 0) << "ValueError: The candidates of thread extent must be positive";
+  }
+  ObjectPtr<SplitKNode> n = make_object<SplitKNode>();
+  n->split_factors = std::move(split_factors);
+  n->thread_extents = std::move(thread_extents);
+  n->min_reduction_extent = min_reduction_extent;
+  n->max_spatial_extent = max_spatial_extent;
+  n->max_threads_per_block = -1;
+  return ScheduleRule(n);
+}
+
+TVM_REGISTER_NODE_TYPE(SplitKNode);
+TVM_REGISTER_GLOBAL("meta_schedule.ScheduleRuleSplitK").set_body_typed(ScheduleRule::SplitK);
+
+}  // namespace meta_schedule
+}  // namespace tvm
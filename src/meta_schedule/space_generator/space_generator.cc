@@ -28,6 +28,11 @@ String GetRuleKindFromTarget(const Target& target) {
         runtime::Registry::Get("target.target_has_feature");
     ICHECK(target_has_feature_fn_ptr != nullptr)
         << "The `target.target_has_feature` func is not in tvm registry.";
+    bool have_amx = (*target_has_feature_fn_ptr)("amx-int8", target) &&
+                    (*target_has_feature_fn_ptr)("amx-bf16", target);
+    if (have_amx) {
+      return "amx";
+    }
     bool have_avx512vnni = (*target_has_feature_fn_ptr)("avx512vnni", target);
     bool have_avxvnni = (*target_has_feature_fn_ptr)("avxvnni", target);
     if (have_avx512vnni || have_avxvnni) {
@@ -113,6 +118,10 @@ void SpaceGeneratorNode::InitializeWithTuneContext(const TuneContext& context) {
       default_sch_rules = ScheduleRule::DefaultX86("vnni");
       default_postprocs = Postproc::DefaultCPUTensorization();
       default_mutator_probs = Mutator::DefaultLLVM();
+    } else if (kind == "amx") {
+      default_sch_rules = ScheduleRule::DefaultX86("amx");
+      default_postprocs = Postproc::DefaultCPUTensorization();
+      default_mutator_probs = Mutator::DefaultLLVM();
     } else if (kind == "avx512") {
       default_sch_rules = ScheduleRule::DefaultX86("avx512");
       default_postprocs = Postproc::DefaultCPUTensorization();
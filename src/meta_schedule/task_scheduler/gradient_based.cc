@@ -135,9 +135,11 @@ class GradientBasedNode final : public TaskSchedulerNode {
 };
 
 TaskScheduler TaskScheduler::GradientBased(PackedFunc logger, double alpha, int window_size,
-                                           support::LinearCongruentialEngine::TRandState seed) {
+                                           support::LinearCongruentialEngine::TRandState seed,
+                                           bool pipelined) {
   ObjectPtr<GradientBasedNode> n = make_object<GradientBasedNode>();
   n->logger = logger;
+  n->pipelined = pipelined;
   n->alpha = alpha;
   n->window_size = window_size;
   n->rand_state = support::LinearCongruentialEngine::NormalizeSeed(seed);
@@ -55,9 +55,10 @@ class RoundRobinNode final : public TaskSchedulerNode {
   }
 };
 
-TaskScheduler TaskScheduler::RoundRobin(PackedFunc logger) {
+TaskScheduler TaskScheduler::RoundRobin(PackedFunc logger, bool pipelined) {
   ObjectPtr<RoundRobinNode> n = make_object<RoundRobinNode>();
   n->logger = logger;
+  n->pipelined = pipelined;
   n->task_id = -1;
   return TaskScheduler(n);
 }
@@ -16,14 +16,75 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <future>
+
+#include "../module_equality.h"
 #include "../utils.h"
 
 namespace tvm {
 namespace meta_schedule {
 
+/*!
+ * \brief The run seconds of the modules measured for a task, keyed by structural equality of the
+ *  post-processed module. Different traces often lower to the same module, which then only needs
+ *  to be measured once.
+ */
+class MeasureCache {
+ public:
+  MeasureCache()
+      : mod_eq_(ModuleEquality::Create("structural")),
+        tab_(/*bucket_count*/ 0, ModuleHash(*mod_eq_), ModuleEqual(*mod_eq_)) {}
+
+  /*! \return The run seconds measured for the module, or NullOpt if it was not measured. */
+  Optional<Array<FloatImm>> Lookup(const IRModule& mod) const {
+    auto it = tab_.find(mod);
+    if (it == tab_.end()) {
+      return NullOpt;
+    }
+    return it->second;
+  }
+
+  void Add(const IRModule& mod, const Array<FloatImm>& run_secs) { tab_.emplace(mod, run_secs); }
+
+  /*! \brief The cached results of the batch in flight, NullOpt for the candidates measured. */
+  std::vector<Optional<RunnerResult>> hits;
+
+ private:
+  std::unique_ptr<ModuleEquality> mod_eq_;
+  std::unordered_map<IRModule, Array<FloatImm>, ModuleHash, ModuleEqual> tab_;
+};
+
+/*! \brief The max number of database records of a task replayed to seed its measure cache. */
+constexpr int kNumMeasureCacheSeedRecords = 256;
+
+/*!
+ * \brief Seed the measure cache of a task with the best records of its workload in the database.
+ */
+void SeedMeasureCache(TaskRecordNode* self, const Database& database) {
+  auto _ = Profiler::TimedScope("SeedMeasureCache");
+  IRModule mod = self->ctx->mod.value();
+  if (!database->HasWorkload(mod)) {
+    return;
+  }
+  String target = self->ctx->target.value()->str();
+  for (const TuningRecord& record :
+       database->GetTopK(database->CommitWorkload(mod), kNumMeasureCacheSeedRecords)) {
+    if (!record->run_secs.defined() || !record->target.defined() ||
+        record->target.value()->str() != target) {
+      continue;
+    }
+    tir::Schedule sch =
+        tir::Schedule::Traced(record->workload->mod, /*seed=*/-1, /*debug_mask=*/0,
+                              /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
+    record->trace->ApplyToSchedule(sch, /*remove_postproc=*/false);
+    self->measure_cache->Add(sch->mod(), record->run_secs.value());
+  }
+}
+
 TaskRecord::TaskRecord(TuneContext ctx, double task_weight) {
   ObjectPtr<TaskRecordNode> n = runtime::make_object<TaskRecordNode>();
   n->ctx = ctx;
+  n->measure_cache = std::make_shared<MeasureCache>();
   n->task_weight = task_weight;
   n->flop = 1.0;
   auto _ = Profiler::TimedScope("InitializeTask");
@@ -38,16 +99,52 @@ TaskRecord::TaskRecord(TuneContext ctx, double task_weight) {
   this->data_ = std::move(n);
 }
 
-void SendToBuilder(TaskRecordNode* self, const Builder& builder) {
-  auto _ = Profiler::TimedScope("SendToBuilder");
+/*!
+ * \brief Make the builder inputs of the candidates not found in the measure cache.
+ * \return The builder inputs, in the order of the candidates.
+ */
+Array<BuilderInput> MakeBuilderInputs(TaskRecordNode* self) {
   Array<MeasureCandidate> candidates = self->measure_candidates.value();
   Target target = self->ctx->target.value();
+  std::vector<Optional<RunnerResult>>& hits = self->measure_cache->hits;
+  hits.assign(candidates.size(), NullOpt);
   Array<BuilderInput> inputs;
   inputs.reserve(candidates.size());
-  for (const MeasureCandidate& candidate : candidates) {
-    inputs.push_back(BuilderInput(candidate->sch->mod(), target));
+  for (int i = 0, n = candidates.size(); i < n; ++i) {
+    IRModule mod = candidates[i]->sch->mod();
+    if (Optional<Array<FloatImm>> run_secs = self->measure_cache->Lookup(mod)) {
+      hits[i] = RunnerResult(run_secs, NullOpt);
+      ++self->cache_hit_count;
+    } else {
+      inputs.push_back(BuilderInput(mod, target));
+    }
+  }
+  return inputs;
+}
+
+/*!
+ * \brief Merge the builder results of the candidates built with placeholders of the cached ones.
+ * \return The builder results, one for each candidate.
+ */
+Array<BuilderResult> MergeBuilderResults(TaskRecordNode* self, Array<BuilderResult> built) {
+  const std::vector<Optional<RunnerResult>>& hits = self->measure_cache->hits;
+  if (built.size() == hits.size()) {
+    return built;
+  }
+  Array<BuilderResult> results;
+  results.reserve(hits.size());
+  for (int i = 0, j = 0, n = hits.size(); i < n; ++i) {
+    // Without an artifact and an error, cached candidates are neither run nor cleaned up.
+    results.push_back(hits[i].defined() ? BuilderResult(NullOpt, NullOpt) : built[j++]);
   }
-  self->builder_results = builder->Build(inputs);
+  return results;
+}
+
+void SendToBuilder(TaskRecordNode* self, const Builder& builder) {
+  auto _ = Profiler::TimedScope("SendToBuilder");
+  Array<BuilderInput> inputs = MakeBuilderInputs(self);
+  self->builder_results =
+      MergeBuilderResults(self, inputs.empty() ? Array<BuilderResult>() : builder->Build(inputs));
 }
 
 void SendToRunner(TaskRecordNode* self, const Runner& runner) {
@@ -55,24 +152,35 @@ void SendToRunner(TaskRecordNode* self, const Runner& runner) {
   Array<MeasureCandidate> candidates = self->measure_candidates.value();
   Array<BuilderResult> builder_results = self->builder_results.value();
   Target target = self->ctx->target.value();
+  const std::vector<Optional<RunnerResult>>& hits = self->measure_cache->hits;
   ICHECK_EQ(candidates.size(), builder_results.size());
+  ICHECK_EQ(candidates.size(), hits.size());
   int n = candidates.size();
-  int n_build_errors = 0;
+  int n_skipped = 0;
+  // Failed trials are recorded as 1e9 ms and never become the best
+  Optional<FloatImm> best_run_secs = NullOpt;
+  if (!self->latency_ms.empty()) {
+    double best_ms = *std::min_element(self->latency_ms.begin(), self->latency_ms.end());
+    if (best_ms < 1e9) {
+      best_run_secs = FloatImm(DataType::Float(64), best_ms / 1000.0);
+    }
+  }
   Array<RunnerInput> inputs;
   inputs.reserve(n);
   for (int i = 0; i < n; ++i) {
     const MeasureCandidate& candidate = candidates[i];
     const BuilderResult& builder_result = builder_results[i];
-    if (builder_result->error_msg.defined()) {
-      ++n_build_errors;
+    if (builder_result->error_msg.defined() || hits[i].defined()) {
+      ++n_skipped;
       continue;
     }
     inputs.push_back(RunnerInput(/*artifact_path=*/builder_result->artifact_path.value(),
                                  /*device_type=*/target->kind->name,
-                                 /*args_info=*/candidate->args_info));
+                                 /*args_info=*/candidate->args_info,
+                                 /*best_run_secs=*/best_run_secs));
   }
-  Array<RunnerFuture> futures = runner->Run(inputs);
-  if (n_build_errors == 0) {
+  Array<RunnerFuture> futures = inputs.empty() ? Array<RunnerFuture>() : runner->Run(inputs);
+  if (n_skipped == 0) {
     self->runner_futures = futures;
     return;
   }
@@ -80,7 +188,11 @@ void SendToRunner(TaskRecordNode* self, const Runner& runner) {
   results.reserve(n);
   for (int i = 0, j = 0; i < n; ++i) {
     const BuilderResult& builder_result = builder_results[i];
-    if (builder_result->error_msg.defined()) {
+    if (hits[i].defined()) {
+      results.push_back(RunnerFuture(
+          /*f_done=*/[]() -> bool { return true; },
+          /*f_result=*/[result = hits[i].value()]() -> RunnerResult { return result; }));
+    } else if (builder_result->error_msg.defined()) {
       results.push_back(RunnerFuture(
           /*f_done=*/[]() -> bool { return true; },
           /*f_result=*/
@@ -138,6 +250,72 @@ void TaskCleanUp(TaskRecordNode* self, int task_id, const Array<RunnerResult>& r
   self->measure_candidates = NullOpt;
   self->builder_results = NullOpt;
   self->runner_futures = NullOpt;
+  self->measure_cache->hits.clear();
+}
+
+/*! \brief The batch of candidates of a task being built in the background. */
+struct PendingBuild {
+  int task_id = -1;
+  std::future<Array<BuilderResult>> builder_results;
+};
+
+/*! \brief Wait for the pending build and send its candidates to the runner. */
+void FinishPendingBuild(TaskSchedulerNode* self, PendingBuild* pending, const Runner& runner) {
+  if (pending->task_id == -1) {
+    return;
+  }
+  TaskRecordNode* task = self->tasks_[pending->task_id].get();
+  {
+    auto _ = Profiler::TimedScope("JoinBuilder");
+    task->builder_results = MergeBuilderResults(task, pending->builder_results.get());
+  }
+  pending->task_id = -1;
+  TVM_PY_LOG(INFO, self->logger) << "Sending " << task->measure_candidates.value().size()
+                                 << " sample(s) to runner";
+  SendToRunner(task, runner);
+}
+
+/*!
+ * \brief The tuning loop of the pipelined mode. While the candidates of a task are built in the
+ *  background, the candidates of the next task are generated and the earlier ones keep running.
+ */
+void TunePipelined(TaskSchedulerNode* self, int max_trials_global, int max_trials_per_task,
+                  const Builder& builder, const Runner& runner) {
+  int num_trials_already = 0;
+  PendingBuild pending;
+  for (int task_id;
+       num_trials_already < max_trials_global && (task_id = self->NextTaskId()) != -1;) {
+    TVM_PY_LOG(INFO, self->logger)
+        << "TaskScheduler picks Task #" << task_id << ": " << self->tasks_[task_id]->ctx->task_name;
+    TaskRecordNode* task = self->tasks_[task_id].get();
+    ICHECK(!task->is_terminated);
+    if (task_id == pending.task_id) {
+      // The search strategy needs the results of the batch in flight to generate the next one.
+      FinishPendingBuild(self, &pending, runner);
+      self->JoinRunningTask(task_id);
+    }
+    ICHECK(!task->runner_futures.defined());
+    if (static_cast<int>(task->latency_ms.size()) >= max_trials_per_task) {
+      self->TerminateTask(task_id);
+      continue;
+    }
+    if (Optional<Array<MeasureCandidate>> candidates = task->measure_candidates =
+            task->ctx->search_strategy.value()->GenerateMeasureCandidates()) {
+      int num_candidates = candidates.value().size();
+      Array<BuilderInput> inputs = MakeBuilderInputs(task);
+      // The candidates served from the measure cache do not count against the budget.
+      num_trials_already += inputs.size();
+      FinishPendingBuild(self, &pending, runner);
+      TVM_PY_LOG(INFO, self->logger) << "Sending " << num_candidates << " sample(s) to builder";
+      pending.task_id = task_id;
+      pending.builder_results = std::async(std::launch::async, [builder, inputs]() {
+        return inputs.empty() ? Array<BuilderResult>() : builder->Build(inputs);
+      });
+    } else {
+      self->TerminateTask(task_id);
+    }
+  }
+  FinishPendingBuild(self, &pending, runner);
 }
 
 void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weights,
@@ -159,6 +337,9 @@ void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weigh
     TVM_PY_LOG(INFO, this->logger) << "Initializing Task #" << i << ": " << ctx->task_name;
     TVM_PY_LOG(INFO, ctx->logger) << "Initializing Task #" << i << ": " << ctx->task_name;
     this->tasks_.push_back(TaskRecord(ctx, weight));
+    if (database.defined()) {
+      SeedMeasureCache(this->tasks_.back().get(), database.value());
+    }
     Array<tir::Schedule> design_spaces =
         ctx->space_generator.value()->GenerateDesignSpace(ctx->mod.value());
     TVM_PY_LOG(INFO, ctx->logger) << "Total " << design_spaces.size()
@@ -175,27 +356,33 @@ void TaskSchedulerNode::Tune(Array<TuneContext> ctxs, Array<FloatImm> task_weigh
                                             database, cost_model);
   }
 
-  int num_trials_already = 0;
-  for (int task_id; num_trials_already < max_trials_global && (task_id = NextTaskId()) != -1;) {
-    TVM_PY_LOG(INFO, this->logger)
-        << "TaskScheduler picks Task #" << task_id << ": " << tasks_[task_id]->ctx->task_name;
-    TaskRecordNode* task = tasks_[task_id].get();
-    ICHECK(!task->is_terminated);
-    ICHECK(!task->runner_futures.defined());
-    if (static_cast<int>(task->latency_ms.size()) >= max_trials_per_task) {
-      TerminateTask(task_id);
-      continue;
-    }
-    if (Optional<Array<MeasureCandidate>> candidates = task->measure_candidates =
-            task->ctx->search_strategy.value()->GenerateMeasureCandidates()) {
-      int num_candidates = candidates.value().size();
-      num_trials_already += num_candidates;
-      TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to builder";
-      SendToBuilder(task, builder);
-      TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to runner";
-      SendToRunner(task, runner);
-    } else {
-      TerminateTask(task_id);
+  if (this->pipelined) {
+    TunePipelined(this, max_trials_global, max_trials_per_task, builder, runner);
+  } else {
+    int num_trials_already = 0;
+    for (int task_id; num_trials_already < max_trials_global && (task_id = NextTaskId()) != -1;) {
+      TVM_PY_LOG(INFO, this->logger)
+          << "TaskScheduler picks Task #" << task_id << ": " << tasks_[task_id]->ctx->task_name;
+      TaskRecordNode* task = tasks_[task_id].get();
+      ICHECK(!task->is_terminated);
+      ICHECK(!task->runner_futures.defined());
+      if (static_cast<int>(task->latency_ms.size()) >= max_trials_per_task) {
+        TerminateTask(task_id);
+        continue;
+      }
+      if (Optional<Array<MeasureCandidate>> candidates = task->measure_candidates =
+              task->ctx->search_strategy.value()->GenerateMeasureCandidates()) {
+        int num_candidates = candidates.value().size();
+        TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to builder";
+        int num_cache_hits = task->cache_hit_count;
+        SendToBuilder(task, builder);
+        // The candidates served from the measure cache do not count against the budget.
+        num_trials_already += num_candidates - (task->cache_hit_count - num_cache_hits);
+        TVM_PY_LOG(INFO, this->logger) << "Sending " << num_candidates << " sample(s) to runner";
+        SendToRunner(task, runner);
+      } else {
+        TerminateTask(task_id);
+      }
     }
   }
   for (int task_id = 0; task_id < n_tasks; ++task_id) {
@@ -223,6 +410,13 @@ Array<RunnerResult> TaskSchedulerNode::JoinRunningTask(int task_id) {
     }
   }
   ICHECK(task->measure_candidates.defined());
+  for (int i = 0, n = results.size(); i < n; ++i) {
+    const RunnerResult& result = results[i];
+    if (!result->error_msg.defined() && result->run_secs.defined()) {
+      task->measure_cache->Add(task->measure_candidates.value()[i]->sch->mod(),
+                               result->run_secs.value());
+    }
+  }
   task->ctx->search_strategy.value()->NotifyRunnerResults(task->measure_candidates.value(),
                                                           results);
   ICHECK(task->builder_results.defined());
@@ -43,6 +43,7 @@
 #include <tvm/tir/transform.h>
 
 #include <algorithm>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -325,9 +326,8 @@ struct ThreadedTraceApply {
   Optional<tir::Schedule> Apply(const IRModule& mod, const tir::Trace& trace,
                                 TRandState* rand_state) {
     tir::Schedule sch =
-        tir::Schedule::Traced(mod,
+        tir::Schedule::Traced(GetBaseState(mod)->Copy(),
                               /*rand_state=*/ForkSeed(rand_state),
-                              /*debug_mode=*/0,
                               /*error_render_level=*/tir::ScheduleErrorRenderLevel::kNone);
 
     trace->ApplyToSchedule(sch, /*remove_postproc=*/true);
@@ -358,6 +358,18 @@ struct ThreadedTraceApply {
   }
 
  private:
+  /*!
+   * \brief Get the schedule state of the IRModule, which is analyzed once and copied by
+   * every replay of the same IRModule.
+   */
+  tir::ScheduleState GetBaseState(const IRModule& mod) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!base_state_.defined() || !base_state_->mod.same_as(mod)) {
+      base_state_ = tir::ScheduleState(mod, /*debug_mask=*/0);
+    }
+    return base_state_;
+  }
+
   /*! \brief A helper data structure that stores the fail count for each postprocessor. */
   struct Item {
     /*! \brief The postprocessor. */
@@ -370,6 +382,10 @@ struct ThreadedTraceApply {
   int n_;
   /*! \brief The pointer to the list of postprocessor items. */
   Item* items_;
+  /*! \brief The mutex guarding `base_state_`. */
+  std::mutex mutex_;
+  /*! \brief The schedule state of the IRModule most recently applied to. */
+  tir::ScheduleState base_state_;
 };
 
 /*!
@@ -31,6 +31,7 @@ class SHashReducer;
 class SHashHandlerIgnoreNDArray : public SHashHandlerDefault {
  protected:
   void DispatchSHash(const ObjectRef& object, bool map_free_vars) override;
+  int HashCacheDomain() const override { return 1; }
 };
 
 /*!
@@ -32,9 +32,14 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "../runtime/object_internal.h"
 #include "../support/base64.h"
@@ -468,6 +473,47 @@ class JSONAttrSetter : public AttrVisitor {
   }
 };
 
+/*!
+ * \brief Sort the nodes so that each node comes after the nodes it depends on.
+ * \param nodes The nodes, with the dependencies in their data and fields.
+ * \return The order of the nodes.
+ */
+template <typename NodeType>
+std::vector<size_t> TopoSortNodes(const std::vector<NodeType>& nodes) {
+  size_t n_nodes = nodes.size();
+  std::vector<size_t> topo_order;
+  std::vector<size_t> in_degree(n_nodes, 0);
+  for (const NodeType& jnode : nodes) {
+    for (size_t i : jnode.data) {
+      ++in_degree[i];
+    }
+    for (size_t i : jnode.fields) {
+      ++in_degree[i];
+    }
+  }
+  for (size_t i = 0; i < n_nodes; ++i) {
+    if (in_degree[i] == 0) {
+      topo_order.push_back(i);
+    }
+  }
+  for (size_t p = 0; p < topo_order.size(); ++p) {
+    const NodeType& jnode = nodes[topo_order[p]];
+    for (size_t i : jnode.data) {
+      if (--in_degree[i] == 0) {
+        topo_order.push_back(i);
+      }
+    }
+    for (size_t i : jnode.fields) {
+      if (--in_degree[i] == 0) {
+        topo_order.push_back(i);
+      }
+    }
+  }
+  ICHECK_EQ(topo_order.size(), n_nodes) << "Cyclic reference detected in the serialized nodes";
+  std::reverse(std::begin(topo_order), std::end(topo_order));
+  return topo_order;
+}
+
 // json graph structure to store node
 struct JSONGraph {
   // the root of the graph
@@ -527,40 +573,7 @@ struct JSONGraph {
     return g;
   }
 
-  std::vector<size_t> TopoSort() const {
-    size_t n_nodes = nodes.size();
-    std::vector<size_t> topo_order;
-    std::vector<size_t> in_degree(n_nodes, 0);
-    for (const JSONNode& jnode : nodes) {
-      for (size_t i : jnode.data) {
-        ++in_degree[i];
-      }
-      for (size_t i : jnode.fields) {
-        ++in_degree[i];
-      }
-    }
-    for (size_t i = 0; i < n_nodes; ++i) {
-      if (in_degree[i] == 0) {
-        topo_order.push_back(i);
-      }
-    }
-    for (size_t p = 0; p < topo_order.size(); ++p) {
-      const JSONNode& jnode = nodes[topo_order[p]];
-      for (size_t i : jnode.data) {
-        if (--in_degree[i] == 0) {
-          topo_order.push_back(i);
-        }
-      }
-      for (size_t i : jnode.fields) {
-        if (--in_degree[i] == 0) {
-          topo_order.push_back(i);
-        }
-      }
-    }
-    ICHECK_EQ(topo_order.size(), n_nodes) << "Cyclic reference detected in JSON file";
-    std::reverse(std::begin(topo_order), std::end(topo_order));
-    return topo_order;
-  }
+  std::vector<size_t> TopoSort() const { return TopoSortNodes(nodes); }
 };
 
 std::string SaveJSON(const ObjectRef& n) {
@@ -622,6 +635,556 @@ ObjectRef LoadJSON(std::string json_str) {
   return ObjectRef(nodes.at(jgraph.root));
 }
 
+// Binary format
+//
+// A compact alternative of the JSON graph, with the same node graph.
+//
+//   magic, version, tvm_version
+//   type key table, field key table: the interned strings
+//   nodes: type key id (0 for None), then by kind
+//     - kFields: (field key id, tag, value)*, terminated by the field key id 0
+//     - kRepr: the repr bytes
+//     - kArray/kMap: the indices of the elements, kStrMap: the keys and the values
+//   root: the index of the root node
+//   tensors: dtype, shape, offset and size of the data in the blob section
+//   blob section: the data of the tensors, each aligned to kBinaryTensorAlignment, so that
+//   a memory mapped file can be used in place.
+//
+// The integers are varint encoded, the signed ones in zigzag, doubles are raw bytes.
+constexpr uint64_t kNodeBinaryMagic = 0x54564d4e4f444542ULL;
+constexpr uint64_t kNodeBinaryVersion = 1;
+constexpr size_t kBinaryTensorAlignment = 64;
+
+enum class BinaryNodeKind : uint8_t { kFields = 0, kRepr = 1, kArray = 2, kStrMap = 3, kMap = 4 };
+
+enum class BinaryFieldTag : uint8_t {
+  kInt = 0,
+  kUInt = 1,
+  kDouble = 2,
+  kString = 3,
+  kDataType = 4,
+  kNode = 5,
+  kTensor = 6,
+};
+
+class BinaryWriter {
+ public:
+  explicit BinaryWriter(std::string* out) : out_(out) {}
+
+  void WriteVarUInt(uint64_t value) {
+    while (value >= 0x80) {
+      out_->push_back(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    out_->push_back(static_cast<char>(value));
+  }
+  void WriteVarInt(int64_t value) {
+    WriteVarUInt((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+  }
+  void WriteBytes(const void* data, size_t size) {
+    out_->append(static_cast<const char*>(data), size);
+  }
+  void WriteString(const std::string& value) {
+    WriteVarUInt(value.size());
+    WriteBytes(value.data(), value.size());
+  }
+  template <typename T>
+  void WritePOD(const T& value) {
+    WriteBytes(&value, sizeof(T));
+  }
+
+ private:
+  std::string* out_;
+};
+
+class BinaryReader {
+ public:
+  BinaryReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  uint64_t ReadVarUInt() {
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+      ICHECK(pos_ < size_ && shift < 64) << "Invalid binary IR format";
+      uint8_t byte = static_cast<uint8_t>(data_[pos_++]);
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) return value;
+    }
+  }
+  int64_t ReadVarInt() {
+    uint64_t value = ReadVarUInt();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+  const char* ReadBytes(size_t size) {
+    ICHECK_LE(size, size_ - pos_) << "Invalid binary IR format";
+    const char* ptr = data_ + pos_;
+    pos_ += size;
+    return ptr;
+  }
+  std::string ReadString() {
+    size_t size = ReadVarUInt();
+    return std::string(ReadBytes(size), size);
+  }
+  template <typename T>
+  T ReadPOD() {
+    T value;
+    std::memcpy(&value, ReadBytes(sizeof(T)), sizeof(T));
+    return value;
+  }
+  size_t pos() const { return pos_; }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t pos_{0};
+};
+
+inline uint64_t PackDataType(const DataType& dtype) {
+  DLDataType t = dtype;
+  return static_cast<uint64_t>(t.code) | (static_cast<uint64_t>(t.bits) << 8) |
+         (static_cast<uint64_t>(t.lanes) << 16);
+}
+
+inline DataType UnpackDataType(uint64_t value) {
+  DLDataType t;
+  t.code = static_cast<uint8_t>(value & 0xff);
+  t.bits = static_cast<uint8_t>((value >> 8) & 0xff);
+  t.lanes = static_cast<uint16_t>((value >> 16) & 0xffff);
+  return DataType(t);
+}
+
+/*! \brief Interned strings, with ids starting from 1. */
+class StringTable {
+ public:
+  uint64_t Intern(const std::string& value) {
+    auto it = ids_.find(value);
+    if (it != ids_.end()) return it->second;
+    strings_.push_back(value);
+    return ids_[value] = strings_.size();
+  }
+  const std::vector<std::string>& strings() const { return strings_; }
+
+ private:
+  std::unordered_map<std::string, uint64_t> ids_;
+  std::vector<std::string> strings_;
+};
+
+// Helper class to write the fields of a node, using the existing index.
+class BinaryAttrGetter : public AttrVisitor {
+ public:
+  const std::unordered_map<Object*, size_t>* node_index_;
+  const std::unordered_map<DLTensor*, size_t>* tensor_index_;
+  StringTable* field_keys_;
+  BinaryWriter* writer_;
+
+  void Visit(const char* key, double* value) final {
+    WriteKey(key, BinaryFieldTag::kDouble);
+    writer_->WritePOD(*value);
+  }
+  void Visit(const char* key, int64_t* value) final {
+    WriteKey(key, BinaryFieldTag::kInt);
+    writer_->WriteVarInt(*value);
+  }
+  void Visit(const char* key, uint64_t* value) final {
+    WriteKey(key, BinaryFieldTag::kUInt);
+    writer_->WriteVarUInt(*value);
+  }
+  void Visit(const char* key, int* value) final {
+    WriteKey(key, BinaryFieldTag::kInt);
+    writer_->WriteVarInt(*value);
+  }
+  void Visit(const char* key, bool* value) final {
+    WriteKey(key, BinaryFieldTag::kInt);
+    writer_->WriteVarInt(*value);
+  }
+  void Visit(const char* key, std::string* value) final {
+    WriteKey(key, BinaryFieldTag::kString);
+    writer_->WriteString(*value);
+  }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to serialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final {
+    WriteKey(key, BinaryFieldTag::kDataType);
+    writer_->WriteVarUInt(PackDataType(*value));
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    WriteKey(key, BinaryFieldTag::kTensor);
+    writer_->WriteVarUInt(tensor_index_->at(const_cast<DLTensor*>((*value).operator->())));
+  }
+  void Visit(const char* key, ObjectRef* value) final {
+    WriteKey(key, BinaryFieldTag::kNode);
+    writer_->WriteVarUInt(node_index_->at(const_cast<Object*>(value->get())));
+  }
+
+ private:
+  void WriteKey(const char* key, BinaryFieldTag tag) {
+    writer_->WriteVarUInt(field_keys_->Intern(key));
+    writer_->WritePOD(static_cast<uint8_t>(tag));
+  }
+};
+
+/*! \brief A field of a node loaded from the binary format. */
+struct BinaryField {
+  const std::string* key;
+  BinaryFieldTag tag;
+  union {
+    int64_t i;
+    uint64_t u;
+    double d;
+  } value;
+  std::string str;
+};
+
+/*! \brief A node loaded from the binary format. */
+struct BinaryNode {
+  std::string type_key;
+  std::string repr_bytes;
+  BinaryNodeKind kind{BinaryNodeKind::kFields};
+  std::vector<BinaryField> attrs;
+  std::vector<std::string> keys;
+  /*! \brief The elements of an array or map. */
+  std::vector<size_t> data;
+  /*! \brief The nodes referred by the fields. */
+  std::vector<size_t> fields;
+};
+
+// Helper class to set the attributes of a node from a binary node.
+class BinaryAttrSetter : public AttrVisitor {
+ public:
+  const std::vector<ObjectPtr<Object>>* node_list_;
+  const std::vector<runtime::NDArray>* tensor_list_;
+  BinaryNode* bnode_;
+
+  void Visit(const char* key, double* value) final {
+    *value = Find(key, BinaryFieldTag::kDouble).value.d;
+  }
+  void Visit(const char* key, int64_t* value) final {
+    *value = Find(key, BinaryFieldTag::kInt).value.i;
+  }
+  void Visit(const char* key, uint64_t* value) final {
+    *value = Find(key, BinaryFieldTag::kUInt).value.u;
+  }
+  void Visit(const char* key, int* value) final {
+    *value = static_cast<int>(Find(key, BinaryFieldTag::kInt).value.i);
+  }
+  void Visit(const char* key, bool* value) final {
+    *value = Find(key, BinaryFieldTag::kInt).value.i != 0;
+  }
+  void Visit(const char* key, std::string* value) final {
+    *value = Find(key, BinaryFieldTag::kString).str;
+  }
+  void Visit(const char* key, void** value) final {
+    LOG(FATAL) << "not allowed to deserialize a pointer";
+  }
+  void Visit(const char* key, DataType* value) final {
+    *value = UnpackDataType(Find(key, BinaryFieldTag::kDataType).value.u);
+  }
+  void Visit(const char* key, runtime::NDArray* value) final {
+    *value = tensor_list_->at(Find(key, BinaryFieldTag::kTensor).value.u);
+  }
+  void Visit(const char* key, ObjectRef* value) final {
+    *value = ObjectRef(node_list_->at(Find(key, BinaryFieldTag::kNode).value.u));
+  }
+
+  void Set(ObjectPtr<Object>* node, BinaryNode* bnode) {
+    if (node->get() == nullptr || bnode->kind == BinaryNodeKind::kRepr) return;
+    if (bnode->kind == BinaryNodeKind::kArray) {
+      std::vector<ObjectRef> container;
+      container.reserve(bnode->data.size());
+      for (size_t index : bnode->data) {
+        container.push_back(ObjectRef(node_list_->at(index)));
+      }
+      Array<ObjectRef> array(container);
+      *node = runtime::ObjectInternal::MoveObjectPtr(&array);
+      return;
+    }
+    if (bnode->kind == BinaryNodeKind::kMap || bnode->kind == BinaryNodeKind::kStrMap) {
+      std::unordered_map<ObjectRef, ObjectRef, ObjectHash, ObjectEqual> container;
+      if (bnode->kind == BinaryNodeKind::kMap) {
+        for (size_t i = 0; i < bnode->data.size(); i += 2) {
+          container[ObjectRef(node_list_->at(bnode->data[i]))] =
+              ObjectRef(node_list_->at(bnode->data[i + 1]));
+        }
+      } else {
+        for (size_t i = 0; i < bnode->data.size(); ++i) {
+          container[String(bnode->keys[i])] = ObjectRef(node_list_->at(bnode->data[i]));
+        }
+      }
+      Map<ObjectRef, ObjectRef> map(container);
+      *node = runtime::ObjectInternal::MoveObjectPtr(&map);
+      return;
+    }
+    bnode_ = bnode;
+    cursor_ = 0;
+    ReflectionVTable::Global()->VisitAttrs(node->get(), this);
+  }
+
+ private:
+  // The fields are usually visited in the order they were written.
+  const BinaryField& Find(const char* key, BinaryFieldTag tag) {
+    const std::vector<BinaryField>& attrs = bnode_->attrs;
+    for (size_t n = 0; n < attrs.size(); ++n) {
+      size_t i = (cursor_ + n) % attrs.size();
+      if (*attrs[i].key == key) {
+        ICHECK(attrs[i].tag == tag) << "Wrong value format for field " << key;
+        cursor_ = i + 1;
+        return attrs[i];
+      }
+    }
+    LOG(FATAL) << "BinaryReader: cannot find field " << key << " of " << bnode_->type_key;
+    throw;
+  }
+
+  size_t cursor_{0};
+};
+
+inline size_t AlignBinaryOffset(size_t offset) {
+  return (offset + kBinaryTensorAlignment - 1) / kBinaryTensorAlignment * kBinaryTensorAlignment;
+}
+
+std::string SaveBinary(const ObjectRef& n) {
+  ICHECK(DMLC_IO_NO_ENDIAN_SWAP) << "The binary IR format is only supported on little endian";
+  ReflectionVTable* reflection = ReflectionVTable::Global();
+  NodeIndexer indexer;
+  indexer.MakeIndex(const_cast<Object*>(n.get()));
+
+  StringTable type_keys, field_keys;
+  std::string body;
+  BinaryWriter body_writer(&body);
+  BinaryAttrGetter getter;
+  getter.node_index_ = &indexer.node_index_;
+  getter.tensor_index_ = &indexer.tensor_index_;
+  getter.field_keys_ = &field_keys;
+  getter.writer_ = &body_writer;
+  std::string repr_bytes;
+  for (Object* node : indexer.node_list_) {
+    if (node == nullptr) {
+      body_writer.WriteVarUInt(0);
+      continue;
+    }
+    body_writer.WriteVarUInt(type_keys.Intern(node->GetTypeKey()));
+    repr_bytes.clear();
+    if (reflection->GetReprBytes(node, &repr_bytes)) {
+      body_writer.WritePOD(static_cast<uint8_t>(BinaryNodeKind::kRepr));
+      body_writer.WriteString(repr_bytes);
+    } else if (node->IsInstance<ArrayNode>()) {
+      ArrayNode* array = static_cast<ArrayNode*>(node);
+      body_writer.WritePOD(static_cast<uint8_t>(BinaryNodeKind::kArray));
+      body_writer.WriteVarUInt(array->size());
+      for (const ObjectRef& elem : *array) {
+        body_writer.WriteVarUInt(indexer.node_index_.at(const_cast<Object*>(elem.get())));
+      }
+    } else if (node->IsInstance<MapNode>()) {
+      MapNode* map = static_cast<MapNode*>(node);
+      bool is_str_map = std::all_of(map->begin(), map->end(), [](const auto& v) {
+        return v.first->template IsInstance<StringObj>();
+      });
+      body_writer.WritePOD(
+          static_cast<uint8_t>(is_str_map ? BinaryNodeKind::kStrMap : BinaryNodeKind::kMap));
+      body_writer.WriteVarUInt(map->size());
+      for (const auto& kv : *map) {
+        if (is_str_map) {
+          body_writer.WriteString(Downcast<String>(kv.first));
+        } else {
+          body_writer.WriteVarUInt(indexer.node_index_.at(const_cast<Object*>(kv.first.get())));
+        }
+        body_writer.WriteVarUInt(indexer.node_index_.at(const_cast<Object*>(kv.second.get())));
+      }
+    } else {
+      body_writer.WritePOD(static_cast<uint8_t>(BinaryNodeKind::kFields));
+      reflection->VisitAttrs(node, &getter);
+      body_writer.WriteVarUInt(0);
+    }
+  }
+
+  std::string blob;
+  BinaryWriter writer(&blob);
+  writer.WritePOD(kNodeBinaryMagic);
+  writer.WriteVarUInt(kNodeBinaryVersion);
+  writer.WriteString(TVM_VERSION);
+  for (const StringTable* table : {&type_keys, &field_keys}) {
+    writer.WriteVarUInt(table->strings().size());
+    for (const std::string& key : table->strings()) {
+      writer.WriteString(key);
+    }
+  }
+  writer.WriteVarUInt(indexer.node_list_.size());
+  writer.WriteBytes(body.data(), body.size());
+  writer.WriteVarUInt(indexer.node_index_.at(const_cast<Object*>(n.get())));
+
+  // The tensor table, then the data of the tensors in the aligned blob section.
+  std::vector<size_t> data_sizes;
+  size_t data_offset = 0;
+  writer.WriteVarUInt(indexer.tensor_list_.size());
+  for (DLTensor* tensor : indexer.tensor_list_) {
+    size_t data_size = runtime::GetDataSize(*tensor);
+    writer.WriteVarUInt(PackDataType(DataType(tensor->dtype)));
+    writer.WriteVarUInt(tensor->ndim);
+    for (int i = 0; i < tensor->ndim; ++i) {
+      writer.WriteVarInt(tensor->shape[i]);
+    }
+    data_offset = AlignBinaryOffset(data_offset);
+    writer.WriteVarUInt(data_offset);
+    writer.WriteVarUInt(data_size);
+    data_sizes.push_back(data_size);
+    data_offset += data_size;
+  }
+  size_t blob_begin = AlignBinaryOffset(blob.size());
+  blob.resize(blob_begin + data_offset, '\0');
+  data_offset = 0;
+  for (size_t i = 0; i < indexer.tensor_list_.size(); ++i) {
+    data_offset = AlignBinaryOffset(data_offset);
+    ICHECK_EQ(TVMArrayCopyToBytes(indexer.tensor_list_[i], &blob[blob_begin + data_offset],
+                                  data_sizes[i]),
+              0)
+        << TVMGetLastError();
+    data_offset += data_sizes[i];
+  }
+  return blob;
+}
+
+ObjectRef LoadBinary(const std::string& blob) {
+  ICHECK(DMLC_IO_NO_ENDIAN_SWAP) << "The binary IR format is only supported on little endian";
+  ReflectionVTable* reflection = ReflectionVTable::Global();
+  BinaryReader reader(blob.data(), blob.size());
+  ICHECK(blob.size() >= sizeof(uint64_t) && reader.ReadPOD<uint64_t>() == kNodeBinaryMagic)
+      << "Invalid binary IR format";
+  uint64_t version = reader.ReadVarUInt();
+  ICHECK_LE(version, kNodeBinaryVersion) << "The binary IR format version " << version
+                                         << " is newer than the supported version "
+                                         << kNodeBinaryVersion;
+  reader.ReadString();
+  std::vector<std::string> type_keys, field_keys;
+  for (std::vector<std::string>* table : {&type_keys, &field_keys}) {
+    table->resize(reader.ReadVarUInt());
+    for (std::string& key : *table) {
+      key = reader.ReadString();
+    }
+  }
+  auto read_index = [&reader](size_t n_nodes) {
+    uint64_t index = reader.ReadVarUInt();
+    ICHECK_LT(index, n_nodes) << "Invalid binary IR format";
+    return static_cast<size_t>(index);
+  };
+
+  size_t n_nodes = reader.ReadVarUInt();
+  std::vector<BinaryNode> bnodes(n_nodes);
+  for (BinaryNode& bnode : bnodes) {
+    uint64_t type_id = reader.ReadVarUInt();
+    if (type_id == 0) continue;
+    ICHECK_LE(type_id, type_keys.size()) << "Invalid binary IR format";
+    bnode.type_key = type_keys[type_id - 1];
+    bnode.kind = static_cast<BinaryNodeKind>(reader.ReadPOD<uint8_t>());
+    switch (bnode.kind) {
+      case BinaryNodeKind::kRepr: {
+        bnode.repr_bytes = reader.ReadString();
+        break;
+      }
+      case BinaryNodeKind::kArray: {
+        bnode.data.resize(reader.ReadVarUInt());
+        for (size_t& index : bnode.data) index = read_index(n_nodes);
+        break;
+      }
+      case BinaryNodeKind::kStrMap:
+      case BinaryNodeKind::kMap: {
+        size_t size = reader.ReadVarUInt();
+        for (size_t i = 0; i < size; ++i) {
+          if (bnode.kind == BinaryNodeKind::kStrMap) {
+            bnode.keys.push_back(reader.ReadString());
+          } else {
+            bnode.data.push_back(read_index(n_nodes));
+          }
+          bnode.data.push_back(read_index(n_nodes));
+        }
+        break;
+      }
+      case BinaryNodeKind::kFields: {
+        while (uint64_t key_id = reader.ReadVarUInt()) {
+          ICHECK_LE(key_id, field_keys.size()) << "Invalid binary IR format";
+          BinaryField field;
+          field.key = &field_keys[key_id - 1];
+          field.tag = static_cast<BinaryFieldTag>(reader.ReadPOD<uint8_t>());
+          switch (field.tag) {
+            case BinaryFieldTag::kInt:
+              field.value.i = reader.ReadVarInt();
+              break;
+            case BinaryFieldTag::kDouble:
+              field.value.d = reader.ReadPOD<double>();
+              break;
+            case BinaryFieldTag::kString:
+              field.str = reader.ReadString();
+              break;
+            case BinaryFieldTag::kNode:
+              field.value.u = read_index(n_nodes);
+              bnode.fields.push_back(field.value.u);
+              break;
+            case BinaryFieldTag::kUInt:
+            case BinaryFieldTag::kDataType:
+            case BinaryFieldTag::kTensor:
+              field.value.u = reader.ReadVarUInt();
+              break;
+            default:
+              LOG(FATAL) << "Invalid binary IR format";
+          }
+          bnode.attrs.emplace_back(std::move(field));
+        }
+        break;
+      }
+      default:
+        LOG(FATAL) << "Invalid binary IR format";
+    }
+  }
+  size_t root = read_index(n_nodes);
+
+  std::vector<runtime::NDArray> tensors(reader.ReadVarUInt());
+  std::vector<std::pair<size_t, size_t>> data_ranges;
+  for (runtime::NDArray& tensor : tensors) {
+    DataType dtype = UnpackDataType(reader.ReadVarUInt());
+    std::vector<int64_t> shape(reader.ReadVarUInt());
+    for (int64_t& dim : shape) dim = reader.ReadVarInt();
+    tensor = runtime::NDArray::Empty(shape, dtype, Device{kDLCPU, 0});
+    size_t offset = reader.ReadVarUInt();
+    size_t size = reader.ReadVarUInt();
+    ICHECK_EQ(size, runtime::GetDataSize(*tensor.operator->())) << "Invalid binary IR format";
+    data_ranges.emplace_back(offset, size);
+  }
+  size_t blob_begin = AlignBinaryOffset(reader.pos());
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    size_t offset = data_ranges[i].first, size = data_ranges[i].second;
+    ICHECK(blob_begin <= blob.size() && offset <= blob.size() - blob_begin &&
+           size <= blob.size() - blob_begin - offset)
+        << "Invalid binary IR format";
+    tensors[i].CopyFromBytes(blob.data() + blob_begin + offset, size);
+  }
+
+  // Create all objects, then set their fields in the order of the dependencies.
+  std::vector<ObjectPtr<Object>> nodes(n_nodes, nullptr);
+  for (size_t i = 0; i < n_nodes; ++i) {
+    if (bnodes[i].type_key.length() != 0) {
+      nodes[i] = reflection->CreateInitObject(bnodes[i].type_key, bnodes[i].repr_bytes);
+    }
+  }
+  BinaryAttrSetter setter;
+  setter.node_list_ = &nodes;
+  setter.tensor_list_ = &tensors;
+  for (size_t i : TopoSortNodes(bnodes)) {
+    setter.Set(&nodes[i], &bnodes[i]);
+  }
+  return ObjectRef(nodes.at(root));
+}
+
+TVM_REGISTER_GLOBAL("node.SaveBinary").set_body([](TVMArgs args, TVMRetValue* rv) {
+  std::string blob = SaveBinary(args[0]);
+  TVMByteArray arr;
+  arr.data = blob.data();
+  arr.size = blob.length();
+  *rv = arr;
+});
+
+TVM_REGISTER_GLOBAL("node.LoadBinary").set_body_typed([](std::string blob) {
+  return LoadBinary(blob);
+});
+
 TVM_REGISTER_GLOBAL("node.SaveJSON").set_body_typed(SaveJSON);
 
 TVM_REGISTER_GLOBAL("node.LoadJSON").set_body_typed(LoadJSON);
@@ -31,6 +31,7 @@
 #include <tvm/target/codegen.h>
 
 #include <algorithm>
+#include <memory>
 #include <unordered_map>
 
 #include "../support/base64.h"
@@ -57,6 +58,57 @@ void ReflectionVTable::SHashReduce(const Object* self, SHashReducer reducer) con
 // In particular, when we traverse unordered_map, we should first sort
 // the entries by keys(or hash of keys) before traversing.
 
+/*! \brief The hashes cached in a StructuralHashCacheScope. */
+class StructuralHashCache {
+ public:
+  using HashMap = std::unordered_map<ObjectRef, uint64_t, ObjectPtrHash, ObjectPtrEqual>;
+  static constexpr int kNumDomains = SHashHandlerDefault::kNumHashCacheDomains;
+
+  /*! \brief The hashes of the subtrees without free vars or graph nodes, by domain. */
+  HashMap closed[kNumDomains];
+  /*! \brief The hashes of the hashed roots, by domain and map_free_vars. */
+  HashMap roots[kNumDomains][2];
+
+  /*! \return The cache of the current thread, or nullptr outside of a scope. */
+  static StructuralHashCache* Current() { return Entry()->cache.get(); }
+
+  static void EnterScope() {
+    ThreadEntry* entry = Entry();
+    if (entry->depth++ == 0) {
+      entry->cache = std::make_unique<StructuralHashCache>();
+    }
+  }
+
+  static void ExitScope() {
+    ThreadEntry* entry = Entry();
+    ICHECK_GT(entry->depth, 0) << "StructuralHashCacheScope exits without entering";
+    if (--entry->depth == 0) {
+      entry->cache.reset();
+    }
+  }
+
+ private:
+  struct ThreadEntry {
+    int depth{0};
+    std::unique_ptr<StructuralHashCache> cache;
+  };
+
+  static ThreadEntry* Entry() {
+    static thread_local ThreadEntry inst;
+    return &inst;
+  }
+};
+
+StructuralHashCacheScope::StructuralHashCacheScope() { StructuralHashCache::EnterScope(); }
+
+StructuralHashCacheScope::~StructuralHashCacheScope() { StructuralHashCache::ExitScope(); }
+
+TVM_REGISTER_GLOBAL("node.StructuralHashCacheEnterScope")
+    .set_body_typed(StructuralHashCache::EnterScope);
+
+TVM_REGISTER_GLOBAL("node.StructuralHashCacheExitScope")
+    .set_body_typed(StructuralHashCache::ExitScope);
+
 class SHashHandlerDefault::Impl {
  public:
   explicit Impl(SHashHandlerDefault* parent) : parent_(parent) {}
@@ -79,10 +131,24 @@ class SHashHandlerDefault::Impl {
     bool graph_node_hash{false};
     /*! \brief whether to map the free variables. */
     bool map_free_vars;
+    /*!
+     * \brief Whether the hash does not depend on the context, i.e. the subtree has no free
+     *  vars or graph nodes. Only such hashes are shared between roots by the cache.
+     */
+    bool closed{true};
 
     Task() = default;
-    explicit Task(ObjectRef object, uint64_t reduced_hash, bool map_free_vars)
-        : object(object), reduced_hash(reduced_hash), map_free_vars(map_free_vars) {}
+    explicit Task(ObjectRef object, uint64_t reduced_hash, bool map_free_vars, bool closed = true)
+        : object(object),
+          reduced_hash(reduced_hash),
+          map_free_vars(map_free_vars),
+          closed(closed) {}
+  };
+
+  /*! \brief A memoized hash value. */
+  struct MemoEntry {
+    uint64_t hash;
+    bool closed;
   };
 
   void MarkGraphNode() {
@@ -94,7 +160,9 @@ class SHashHandlerDefault::Impl {
   bool LookupHashedValue(const ObjectRef& key, uint64_t* hash_value) {
     auto it = hash_memo_.find(key);
     if (it != hash_memo_.end()) {
-      hash_value[0] = it->second;
+      hash_value[0] = it->second.hash;
+      // The caller mixes the value in the current node, without telling whether it is closed.
+      if (!task_stack_.empty()) task_stack_.back().closed = false;
       return true;
     }
     return false;
@@ -109,11 +177,11 @@ class SHashHandlerDefault::Impl {
     if (map_free_vars) {
       // use counter value.
       uint64_t value = std::hash<uint64_t>()(free_var_counter_++);
-      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), value, false));
+      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), value, false, false));
     } else {
       // use pointer hash
       uint64_t value = std::hash<const runtime::Object*>()(var);
-      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), value, false));
+      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), value, false, false));
     }
   }
 
@@ -125,9 +193,9 @@ class SHashHandlerDefault::Impl {
       pending_tasks_.emplace_back(Task(ObjectRef(nullptr), 0, false));
       return;
     }
-    auto it = hash_memo_.find(object);
-    if (it != hash_memo_.end()) {
-      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), it->second, false));
+    MemoEntry memo;
+    if (FindMemo(object, &memo)) {
+      pending_tasks_.emplace_back(Task(ObjectRef(nullptr), memo.hash, false, memo.closed));
     } else {
       // Push a pending task with initial value.
       pending_tasks_.emplace_back(Task(object, object->GetTypeKeyHash(), map_free_vars));
@@ -139,6 +207,19 @@ class SHashHandlerDefault::Impl {
     ICHECK_EQ(pending_tasks_.size(), 0U);
     ICHECK_EQ(result_stack_.size(), 0U);
 
+    int domain = parent_->HashCacheDomain();
+    cache_ = nullptr;
+    if (domain >= 0) {
+      ICHECK_LT(domain, StructuralHashCache::kNumDomains);
+      cache_domain_ = domain;
+      cache_ = StructuralHashCache::Current();
+    }
+    if (cache_ != nullptr && object.defined()) {
+      auto& roots = cache_->roots[cache_domain_][map_free_vars];
+      auto it = roots.find(object);
+      if (it != roots.end()) return it->second;
+    }
+
     this->SHashReduce(object, map_free_vars);
     ICHECK_EQ(pending_tasks_.size(), 1U);
     ICHECK(allow_push_to_stack_);
@@ -150,6 +231,10 @@ class SHashHandlerDefault::Impl {
     ICHECK_EQ(result_stack_.size(), 1U);
     uint64_t ret = result_stack_.back();
     result_stack_.pop_back();
+    result_closed_.pop_back();
+    if (cache_ != nullptr && object.defined()) {
+      cache_->roots[cache_domain_][map_free_vars][object] = ret;
+    }
     return ret;
   }
 
@@ -159,28 +244,55 @@ class SHashHandlerDefault::Impl {
   }
 
  protected:
+  /*!
+   * \brief Find the hash of an object computed before, in this run or in the cache.
+   * \param object The object.
+   * \param memo The found hash.
+   * \return Whether the hash is found.
+   */
+  bool FindMemo(const ObjectRef& object, MemoEntry* memo) {
+    auto it = hash_memo_.find(object);
+    if (it != hash_memo_.end()) {
+      *memo = it->second;
+      return true;
+    }
+    if (cache_ != nullptr) {
+      auto& closed = cache_->closed[cache_domain_];
+      auto cit = closed.find(object);
+      if (cit != closed.end()) {
+        *memo = MemoEntry{cit->second, true};
+        return true;
+      }
+    }
+    return false;
+  }
   /*!
    * \brief Pop the top entry of the task stack and push the hash into the result stack.
    */
   void PopTaskStack() {
     const auto& entry = task_stack_.back();
     result_stack_.push_back(entry.reduced_hash);
+    result_closed_.push_back(entry.closed);
     task_stack_.pop_back();
   }
   /*!
    * \brief Compute the reduced hash value for the task.
    * \param task The indicated task.
+   * \param closed Set to whether all the children are closed.
    */
-  uint64_t ReduceHash(const Task& task) {
+  uint64_t ReduceHash(const Task& task, bool* closed) {
     uint64_t stack_begin = task.result_stack_index;
     ICHECK_LE(stack_begin, result_stack_.size());
 
     // combine in the reverse order of the stack.
     uint64_t reduced_hash = task.reduced_hash;
+    *closed = true;
     for (uint32_t i = result_stack_.size(); i != stack_begin; --i) {
       reduced_hash = support::HashCombine(reduced_hash, result_stack_[i - 1]);
+      *closed = *closed && result_closed_[i - 1];
     }
     result_stack_.resize(stack_begin);
+    result_closed_.resize(stack_begin);
     return reduced_hash;
   }
   // run the tasks.
@@ -190,21 +302,28 @@ class SHashHandlerDefault::Impl {
       auto& entry = task_stack_.back();
       if (entry.children_expanded) {
         // reduce hash
-        entry.reduced_hash = ReduceHash(entry);
+        bool children_closed;
+        entry.reduced_hash = ReduceHash(entry, &children_closed);
+        entry.closed = entry.closed && children_closed;
         // When all the children has expanded and visited.
         // entry.reduced_hash contains the reduced hash result.
         auto it = hash_memo_.find(entry.object);
         if (it != hash_memo_.end()) {
           // use the pre-computed hash for the object.
-          entry.reduced_hash = it->second;
+          entry.reduced_hash = it->second.hash;
+          entry.closed = it->second.closed;
         } else {
           // Append the graph node counter to the hash
           // so that we can distinguish DAG from trees.
           if (entry.graph_node_hash) {
             entry.reduced_hash = support::HashCombine(entry.reduced_hash,
                                                       std::hash<uint64_t>()(graph_node_counter_++));
+            entry.closed = false;
+          }
+          hash_memo_[entry.object] = MemoEntry{entry.reduced_hash, entry.closed};
+          if (entry.closed && cache_ != nullptr) {
+            cache_->closed[cache_domain_][entry.object] = entry.reduced_hash;
           }
-          hash_memo_[entry.object] = entry.reduced_hash;
         }
         // send value to parent.
         this->PopTaskStack();
@@ -213,9 +332,10 @@ class SHashHandlerDefault::Impl {
         this->PopTaskStack();
       } else {
         // check if there are already hash for object.
-        auto it = hash_memo_.find(entry.object);
-        if (it != hash_memo_.end()) {
-          entry.reduced_hash = it->second;
+        MemoEntry memo;
+        if (FindMemo(entry.object, &memo)) {
+          entry.reduced_hash = memo.hash;
+          entry.closed = memo.closed;
           this->PopTaskStack();
         } else {
           // NOTE: important to modify entry before visit.
@@ -253,10 +373,15 @@ class SHashHandlerDefault::Impl {
   std::vector<Task> task_stack_;
   // Internal stack to store the result popped from the task stack.
   std::vector<uint64_t> result_stack_;
+  // Whether each result of the result stack is closed.
+  std::vector<bool> result_closed_;
   // reflection vtable
   ReflectionVTable* vtable_ = ReflectionVTable::Global();
   // map from lhs to rhs
-  std::unordered_map<ObjectRef, uint64_t, ObjectPtrHash, ObjectPtrEqual> hash_memo_;
+  std::unordered_map<ObjectRef, MemoEntry, ObjectPtrHash, ObjectPtrEqual> hash_memo_;
+  // The cache of the enclosing StructuralHashCacheScope, and the domain of the handler.
+  StructuralHashCache* cache_{nullptr};
+  int cache_domain_{0};
 };
 
 SHashHandlerDefault::SHashHandlerDefault() { impl = new Impl(this); }
@@ -72,6 +72,8 @@
 #include <tvm/relax/utils.h>
 #include <tvm/tir/expr_functor.h>
 
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace tvm {
@@ -93,9 +95,7 @@ class WellFormedChecker : public relax::ExprVisitor,
       for (const auto& it : mod->functions) {
         // visit relax.Function
         if (auto* n = it.second.as<FunctionNode>()) {
-          Function func = GetRef<Function>(n);
-          well_formed_checker.CheckGlobalVarAndGsymbolConsistency(it.first, func);
-          well_formed_checker.VisitExpr(func);
+          well_formed_checker.CheckFunction(it.first, GetRef<Function>(n));
         }
       }
     } else if (const auto* func = obj.as<FunctionNode>()) {
@@ -107,6 +107,18 @@ class WellFormedChecker : public relax::ExprVisitor,
     return well_formed_checker.well_formed_;
   }
 
+  /*!
+   * \brief Check the given relax functions of a module, in the context of the module.
+   * \note The vars shared between a checked function and an unchecked one are not detected.
+   */
+  static bool Check(const IRModule& mod, const Array<GlobalVar>& gvars, bool check_struct_info) {
+    WellFormedChecker well_formed_checker = WellFormedChecker(mod, check_struct_info);
+    for (const GlobalVar& gvar : gvars) {
+      well_formed_checker.CheckFunction(gvar, Downcast<Function>(mod->Lookup(gvar)));
+    }
+    return well_formed_checker.well_formed_;
+  }
+
  private:
   WellFormedChecker(Optional<IRModule> mod, bool check_struct_info)
       : mod_(std::move(mod)), check_struct_info_(check_struct_info), cur_visited_func_(nullptr) {}
@@ -146,6 +158,11 @@ class WellFormedChecker : public relax::ExprVisitor,
     }
   }
 
+  void CheckFunction(const GlobalVar& var, const Function& func) {
+    CheckGlobalVarAndGsymbolConsistency(var, func);
+    VisitExpr(func);
+  }
+
   void VisitExpr(const Expr& expr) final {
     if (!expr.as<OpNode>() && !expr->checked_type_.defined()) {
       Malformed(Diagnostic::Error(expr) << "The checked_type_ of Expr " << expr << " is nullptr.");
@@ -648,5 +665,57 @@ bool WellFormed(Variant<IRModule, Function> obj, bool check_struct_info) {
 
 TVM_REGISTER_GLOBAL(("relax.analysis.well_formed")).set_body_typed(WellFormed);
 
+runtime::TypedPackedFunc<bool(IRModule)> IncrementalWellFormed(bool check_struct_info) {
+  struct Cache {
+    // The relax functions found well formed, with the GlobalVars they were bound to.
+    std::unordered_map<Function, GlobalVar, ObjectPtrHash, ObjectPtrEqual> checked_funcs;
+    // The struct info of the GlobalVars of the module at the last check.
+    std::unordered_map<GlobalVar, ObjectRef, ObjectPtrHash, ObjectPtrEqual> gvar_struct_info;
+  };
+  auto cache = std::make_shared<Cache>();
+  return [cache, check_struct_info](IRModule mod) -> bool {
+    // The checks of a function depend on the GlobalVars it calls, so the results are dropped
+    // when a GlobalVar of the previous module is removed or gets a new signature.
+    bool gvars_changed = false;
+    for (const auto& [gvar, struct_info] : cache->gvar_struct_info) {
+      if (!mod->ContainGlobalVar(gvar->name_hint) ||
+          !mod->GetGlobalVar(gvar->name_hint).same_as(gvar) ||
+          !gvar->struct_info_.same_as(struct_info)) {
+        gvars_changed = true;
+        break;
+      }
+    }
+    if (gvars_changed) {
+      cache->checked_funcs.clear();
+    }
+    cache->gvar_struct_info.clear();
+    Array<GlobalVar> changed;
+    for (const auto& [gvar, base_func] : mod->functions) {
+      cache->gvar_struct_info[gvar] = gvar->struct_info_;
+      if (auto func = base_func.as<Function>()) {
+        auto it = cache->checked_funcs.find(func.value());
+        if (it == cache->checked_funcs.end() || !it->second.same_as(gvar)) {
+          changed.push_back(gvar);
+        }
+      }
+    }
+    if (!WellFormedChecker::Check(mod, changed, check_struct_info)) {
+      return false;
+    }
+    // Keep only the functions of this module, so the cache does not grow with the pipeline.
+    std::unordered_map<Function, GlobalVar, ObjectPtrHash, ObjectPtrEqual> checked_funcs;
+    for (const auto& [gvar, base_func] : mod->functions) {
+      if (auto func = base_func.as<Function>()) {
+        checked_funcs[func.value()] = gvar;
+      }
+    }
+    cache->checked_funcs = std::move(checked_funcs);
+    return true;
+  };
+}
+
+TVM_REGISTER_GLOBAL(("relax.analysis.IncrementalWellFormed"))
+    .set_body_typed(IncrementalWellFormed);
+
 }  // namespace relax
 }  // namespace tvm
@@ -0,0 +1,453 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/backend/aot/codegen_aot_tir.cc
+ * \brief A codegen to lower Relax functions ahead of time into TIR host functions, which run
+ *        without the VM.
+ *
+ * Each Relax function becomes a PrimFunc of the same symbol that takes the parameters followed by
+ * the outputs in destination-passing style. The tensors planned by StaticPlanBlockMemory live in
+ * a single arena of static size, the PrimFuncs are called directly by symbol and the constants
+ * are embedded in the function.
+ */
+#include <tvm/ir/module.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/expr.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+namespace aot {
+
+/*! \brief The value of a Relax variable in the generated TIR. */
+struct AOTValue {
+  enum class Kind : int { kNone, kTensor, kPrim, kTuple, kStorage };
+  Kind kind = Kind::kNone;
+  /*! \brief The DLTensor handle of a tensor passed in or out, undefined for the others. */
+  PrimExpr handle;
+  /*! \brief The data pointer of a tensor or of an output storage, the value of a PrimValue. */
+  PrimExpr data;
+  /*! \brief The shape and the dtype of a tensor. */
+  Array<PrimExpr> shape;
+  DataType dtype;
+  /*! \brief The offset of a storage in the arena, -1 for the storage of an output. */
+  int64_t arena_offset = -1;
+  /*! \brief The fields of a tuple. */
+  std::vector<AOTValue> fields;
+};
+
+/*!
+ * \brief A class to generate the AOT TIR function of a Relax function.
+ *
+ * \note The function must have static shapes and run on the host, as after StaticPlanBlockMemory
+ *       and LowerAllocTensor, without the VM specific lowering of the later passes.
+ */
+class CodeGenAOTTIR {
+ public:
+  explicit CodeGenAOTTIR(IRModule ctx_mod) : ctx_mod_(ctx_mod) {}
+
+  static IRModule Run(IRModule mod) {
+    IRModule res_mod = mod;
+    res_mod.CopyOnWrite();
+
+    CodeGenAOTTIR codegen(mod);
+    for (const auto& [gvar, base_func] : mod->functions) {
+      if (auto func = base_func.as<Function>()) {
+        tir::PrimFunc prim_func = codegen.Codegen(func.value());
+        res_mod->Remove(gvar);
+        res_mod->Add(GlobalVar(gvar->name_hint), prim_func);
+      }
+    }
+    return res_mod;
+  }
+
+ private:
+  static IntImm ConstInt64(int64_t value) { return IntImm(DataType::Int(64), value); }
+
+  static IntImm ConstInt32(int64_t value) { return IntImm(DataType::Int(32), value); }
+
+  /*! \brief The static shape of a tensor, as required by the static arena. */
+  static Array<PrimExpr> StaticShape(const Optional<Expr>& shape, const ObjectRef& context) {
+    const auto* shape_expr = shape.as<ShapeExprNode>();
+    CHECK(shape_expr != nullptr) << "ValueError: The AOT codegen requires static shapes, but "
+                                 << context << " has an unknown shape";
+    for (const PrimExpr& dim : shape_expr->values) {
+      CHECK(dim->IsInstance<IntImmNode>()) << "ValueError: The AOT codegen requires static "
+                                              "shapes, but "
+                                           << context << " has shape " << shape_expr->values;
+    }
+    return shape_expr->values;
+  }
+
+  static int64_t StaticInt(const Expr& expr, const ObjectRef& context) {
+    const auto* prim_value = expr.as<PrimValueNode>();
+    const auto* value = prim_value ? prim_value->value.as<IntImmNode>() : nullptr;
+    CHECK(value != nullptr) << "ValueError: The AOT codegen requires static sizes, but " << context
+                            << " has " << expr;
+    return value->value;
+  }
+
+  tir::PrimFunc Codegen(const Function& func) {
+    Optional<String> gsymbol = func->GetAttr<String>(tvm::attr::kGlobalSymbol);
+    ICHECK(gsymbol.defined()) << "there should be no local functions in Relax AOT codegen phase. "
+                                 "Did you forget to apply LambdaLift or AttachGlobalSymbol Pass?";
+    // initialize the state
+    stmts_.clear();
+    var_map_.clear();
+    bindings_.clear();
+    output_storages_.clear();
+    arena_offsets_.clear();
+    constants_.clear();
+
+    Array<tir::Var> params;
+    Map<tir::Var, tir::Buffer> buffer_map;
+    for (const Var& param : func->params) {
+      AOTValue value;
+      if (const auto* tensor_sinfo = GetStructInfoAs<TensorStructInfoNode>(param)) {
+        tir::Var handle(param->name_hint(), DataType::Handle());
+        tir::Buffer buffer = tir::decl_buffer(StaticShape(tensor_sinfo->shape, param),
+                                              tensor_sinfo->dtype, param->name_hint());
+        params.push_back(handle);
+        buffer_map.Set(handle, buffer);
+        value = TensorValue(buffer->data, buffer->shape, buffer->dtype);
+        value.handle = handle;
+      } else if (const auto* prim_sinfo = GetStructInfoAs<PrimStructInfoNode>(param)) {
+        tir::Var var(param->name_hint(), prim_sinfo->dtype);
+        params.push_back(var);
+        value.kind = AOTValue::Kind::kPrim;
+        value.data = var;
+      } else {
+        LOG(FATAL) << "ValueError: The AOT codegen only takes tensor and PrimValue parameters, "
+                   << "but parameter " << param << " of " << gsymbol << " has struct info "
+                   << GetStructInfo(param);
+      }
+      var_map_[param] = value;
+    }
+
+    const auto* seq = func->body.as<SeqExprNode>();
+    ICHECK(seq != nullptr) << "The body of " << gsymbol << " is expected to be normalized";
+    for (const BindingBlock& block : seq->blocks) {
+      for (const Binding& binding : block->bindings) {
+        if (const auto* var_binding = binding.as<VarBindingNode>()) {
+          bindings_[binding->var] = var_binding->value;
+        } else {
+          bindings_[binding->var] = Downcast<MatchCast>(binding)->value;
+        }
+      }
+    }
+
+    // The outputs are written to the buffers passed by the caller, in place of their storages.
+    std::vector<Var> outputs;
+    CollectOutputs(seq->body, &outputs);
+    for (const Var& output : outputs) {
+      const auto* tensor_sinfo = GetStructInfoAs<TensorStructInfoNode>(output);
+      ICHECK(tensor_sinfo != nullptr);
+      tir::Var handle("out" + std::to_string(params.size() - func->params.size()),
+                      DataType::Handle());
+      tir::Buffer buffer = tir::decl_buffer(StaticShape(tensor_sinfo->shape, output),
+                                            tensor_sinfo->dtype, handle->name_hint);
+      params.push_back(handle);
+      buffer_map.Set(handle, buffer);
+      Var storage = Downcast<Var>(Downcast<Call>(bindings_.at(output))->args[0]);
+      CHECK(!output_storages_.count(storage))
+          << "ValueError: The outputs of " << gsymbol << " share storage " << storage;
+      output_storages_[storage] = {handle, buffer};
+    }
+
+    int64_t arena_size = PlanArena(seq->blocks);
+    arena_ = tir::decl_buffer({ConstInt64(std::max<int64_t>(arena_size, 1))}, DataType::UInt(8),
+                              "aot_arena", "global");
+
+    for (const BindingBlock& block : seq->blocks) {
+      for (const Binding& binding : block->bindings) {
+        var_map_[binding->var] = VisitBinding(binding);
+      }
+    }
+
+    tir::Stmt body = stmts_.size() == 1 ? stmts_[0] : tir::SeqStmt(stmts_);
+    if (arena_size != 0) {
+      body = tir::Allocate(arena_->data, arena_->dtype, arena_->shape, tir::const_true(),
+                           tir::DeclBuffer(arena_, body));
+    }
+    for (auto it = constants_.rbegin(); it != constants_.rend(); ++it) {
+      const auto& [constant, data] = *it;
+      body = tir::AllocateConst(data, constant->data.DataType(),
+                                StaticShape(GetStructInfoAs<TensorStructInfoNode>(constant)->shape,
+                                            constant),
+                                constant->data, body);
+    }
+    // The device of the tensors created for the calls.
+    ObjectRef node = String("default");
+    body = tir::AttrStmt(node, tir::attr::device_type, ConstInt32(kDLCPU), body);
+    body = tir::AttrStmt(node, tir::attr::device_id, ConstInt32(0), body);
+
+    tir::PrimFunc prim_func(params, body, VoidType(), buffer_map);
+    prim_func = WithAttr(prim_func, tvm::attr::kGlobalSymbol, gsymbol.value());
+    return prim_func;
+  }
+
+  /*! \brief Collect the variables of the tensors a function returns, in order. */
+  void CollectOutputs(const Expr& expr, std::vector<Var>* outputs) {
+    if (const auto* tuple = expr.as<TupleNode>()) {
+      for (const Expr& field : tuple->fields) {
+        CollectOutputs(field, outputs);
+      }
+      return;
+    }
+    const auto* var = expr.as<VarNode>();
+    CHECK(var != nullptr) << "ValueError: The AOT codegen cannot return " << expr;
+    auto it = bindings_.find(GetRef<Var>(var));
+    if (it != bindings_.end()) {
+      if (it->second->IsInstance<TupleNode>() || it->second->IsInstance<VarNode>()) {
+        CollectOutputs(it->second, outputs);
+        return;
+      }
+      const auto* call = it->second.as<CallNode>();
+      if (call != nullptr && call->op.same_as(alloc_tensor_op_)) {
+        outputs->push_back(GetRef<Var>(var));
+        return;
+      }
+    }
+    LOG(FATAL) << "ValueError: The AOT codegen writes the outputs to the buffers of the caller, "
+               << "so an output has to be allocated by the function, but " << GetRef<Var>(var)
+               << " is not";
+  }
+
+  /*! \brief Assign the storages which are not outputs to the arena, return its size. */
+  int64_t PlanArena(const Array<BindingBlock>& blocks) {
+    int64_t arena_size = 0;
+    for (const BindingBlock& block : blocks) {
+      for (const Binding& binding : block->bindings) {
+        const auto* call = bindings_.at(binding->var).as<CallNode>();
+        if (call == nullptr || !call->op.same_as(alloc_storage_op_)) continue;
+        ICHECK_EQ(call->args.size(), 4);
+        CHECK_EQ(StaticInt(call->args[1], binding->var), 0)
+            << "ValueError: The AOT codegen only runs on the host device, but storage "
+            << binding->var << " is allocated on device " << call->args[1];
+        CHECK(Downcast<StringImm>(call->args[2])->value == "global")
+            << "ValueError: The AOT codegen only allocates global storage, but storage "
+            << binding->var << " is in scope " << call->args[2];
+        if (output_storages_.count(binding->var)) continue;
+        Array<PrimExpr> size = StaticShape(call->args[0], binding->var);
+        ICHECK_EQ(size.size(), 1);
+        arena_offsets_[binding->var] = arena_size;
+        int64_t nbytes = Downcast<IntImm>(size[0])->value;
+        arena_size += (nbytes + runtime::kAllocAlignment - 1) / runtime::kAllocAlignment *
+                      runtime::kAllocAlignment;
+      }
+    }
+    return arena_size;
+  }
+
+  AOTValue VisitBinding(const Binding& binding) {
+    const Expr& value = bindings_.at(binding->var);
+    const auto* call = value.as<CallNode>();
+    if (call == nullptr) return GetValue(value);
+
+    if (call->op.same_as(alloc_storage_op_)) {
+      AOTValue storage;
+      storage.kind = AOTValue::Kind::kStorage;
+      auto it = output_storages_.find(binding->var);
+      if (it != output_storages_.end()) {
+        storage.handle = it->second.first;
+        storage.data = it->second.second->data;
+      } else {
+        storage.arena_offset = arena_offsets_.at(binding->var);
+      }
+      return storage;
+    }
+    if (call->op.same_as(alloc_tensor_op_)) {
+      ICHECK_EQ(call->args.size(), 4);
+      AOTValue storage = GetValue(call->args[0]);
+      ICHECK(storage.kind == AOTValue::Kind::kStorage);
+      int64_t offset = StaticInt(call->args[1], binding->var);
+      DataType dtype = Downcast<DataTypeImm>(call->args[3])->value;
+      Array<PrimExpr> shape = StaticShape(call->args[2], binding->var);
+      if (storage.arena_offset < 0) {
+        CHECK_EQ(offset, 0) << "ValueError: Output " << binding->var
+                            << " has to start at its storage";
+        AOTValue tensor = TensorValue(storage.data, shape, dtype);
+        tensor.handle = storage.handle;
+        return tensor;
+      }
+      tir::BufferLoad byte(arena_, {ConstInt64(storage.arena_offset + offset)});
+      PrimExpr data = tir::Call(DataType::Handle(), tir::builtin::address_of(), {byte});
+      return TensorValue(data, shape, dtype);
+    }
+    if (call->op.same_as(kill_storage_op_) || call->op.same_as(kill_tensor_op_)) {
+      // The arena is released as a whole on return.
+      return AOTValue();
+    }
+    if (call->op.same_as(reshape_op_)) {
+      AOTValue tensor = GetValue(call->args[0]);
+      ICHECK(tensor.kind == AOTValue::Kind::kTensor);
+      return TensorValue(tensor.data, StaticShape(call->args[1], binding->var), tensor.dtype);
+    }
+
+    Array<PrimExpr> args;
+    for (const Expr& arg : call->args) {
+      args.push_back(ArgExpr(GetValue(arg), arg));
+    }
+    if (const auto* gvar = call->op.as<GlobalVarNode>()) {
+      auto prim_func = ctx_mod_->Lookup(GetRef<GlobalVar>(gvar)).as<tir::PrimFunc>();
+      CHECK(prim_func.defined()) << "ValueError: The AOT codegen only calls PrimFuncs, but "
+                                 << binding->var << " calls " << gvar->name_hint;
+      Optional<String> symbol = prim_func.value()->GetAttr<String>(tvm::attr::kGlobalSymbol);
+      ICHECK(symbol.defined()) << "All functions must have global symbol at this phase";
+      // the arguments are checked at the entry of the generated function
+      symbol = tir::transform::TrustedEntrySymbol(prim_func.value()).value_or(symbol.value());
+      // call the PrimFunc of the same module by its symbol, without name based lookup
+      Array<PrimExpr> all_args = {tir::StringImm(symbol.value())};
+      all_args.insert(all_args.end(), args.begin(), args.end());
+      // push an empty handle to be compatible with current cpacked convention
+      all_args.push_back(tir::make_zero(DataType::Handle()));
+      EmitCall(tir::builtin::tvm_call_cpacked(), all_args);
+    } else if (const auto* extern_func = call->op.as<ExternFuncNode>()) {
+      Array<PrimExpr> all_args = {tir::StringImm(extern_func->global_symbol)};
+      all_args.insert(all_args.end(), args.begin(), args.end());
+      EmitCall(tir::builtin::tvm_call_packed(), all_args);
+    } else {
+      LOG(FATAL) << "ValueError: The AOT codegen does not support " << call->op << " in "
+                 << binding->var << ", the module is expected to be lowered to calls of "
+                 << "PrimFuncs and external functions";
+    }
+    CHECK(!GetStructInfoAs<TensorStructInfoNode>(binding->var))
+        << "ValueError: The AOT codegen only calls functions in destination-passing style, but "
+        << binding->var << " is returned by the call";
+    return AOTValue();
+  }
+
+  AOTValue GetValue(const Expr& expr) {
+    if (const auto* var = expr.as<VarNode>()) {
+      auto it = var_map_.find(GetRef<Var>(var));
+      ICHECK(it != var_map_.end()) << "Undefined variable " << GetRef<Var>(var);
+      return it->second;
+    }
+    if (const auto* prim_value = expr.as<PrimValueNode>()) {
+      AOTValue value;
+      value.kind = AOTValue::Kind::kPrim;
+      value.data = prim_value->value;
+      return value;
+    }
+    if (const auto* constant = expr.as<ConstantNode>()) {
+      tir::Var data("constant" + std::to_string(constants_.size()),
+                    PointerType(PrimType(constant->data.DataType()), "global"));
+      constants_.emplace_back(GetRef<Constant>(constant), data);
+      const auto* tensor_sinfo = GetStructInfoAs<TensorStructInfoNode>(expr);
+      return TensorValue(data, StaticShape(tensor_sinfo->shape, expr), constant->data.DataType());
+    }
+    if (const auto* tuple = expr.as<TupleNode>()) {
+      AOTValue value;
+      value.kind = AOTValue::Kind::kTuple;
+      for (const Expr& field : tuple->fields) {
+        value.fields.push_back(GetValue(field));
+      }
+      return value;
+    }
+    if (const auto* get_item = expr.as<TupleGetItemNode>()) {
+      AOTValue tuple = GetValue(get_item->tuple);
+      ICHECK(tuple.kind == AOTValue::Kind::kTuple);
+      return tuple.fields.at(get_item->index);
+    }
+    LOG(FATAL) << "ValueError: The AOT codegen does not support " << expr->GetTypeKey() << " "
+               << expr;
+  }
+
+  /*! \brief The argument of a call, the DLTensor of a tensor or the value of a PrimValue. */
+  PrimExpr ArgExpr(const AOTValue& value, const Expr& arg) {
+    if (value.kind == AOTValue::Kind::kPrim) return value.data;
+    CHECK(value.kind == AOTValue::Kind::kTensor)
+        << "ValueError: The AOT codegen only passes tensors and PrimValues to the calls, but got "
+        << arg;
+    if (value.handle.defined()) return value.handle;
+    // The DLTensor lives on the stack of the call.
+    Array<PrimExpr> shape;
+    for (const PrimExpr& dim : value.shape) {
+      shape.push_back(cast(DataType::Int(64), dim));
+    }
+    PrimExpr stack_shape =
+        tir::Call(DataType::Handle(), tir::builtin::tvm_stack_make_shape(), shape);
+    return tir::Call(DataType::Handle(), tir::builtin::tvm_stack_make_array(),
+                     {value.data, stack_shape, tir::make_zero(DataType::Handle()),
+                      ConstInt32(value.shape.size()), tir::make_zero(value.dtype), ConstInt64(0)});
+  }
+
+  static AOTValue TensorValue(PrimExpr data, Array<PrimExpr> shape, DataType dtype) {
+    AOTValue value;
+    value.kind = AOTValue::Kind::kTensor;
+    value.data = std::move(data);
+    value.shape = std::move(shape);
+    value.dtype = dtype;
+    return value;
+  }
+
+  void EmitCall(const Op& op, const Array<PrimExpr>& args) {
+    stmts_.push_back(tir::Evaluate(tir::Call(DataType::Int(32), op, args)));
+  }
+
+  /*! \brief the context module. */
+  IRModule ctx_mod_;
+  /*! \brief The statements of the function. */
+  std::vector<tir::Stmt> stmts_;
+  /*! \brief The values of the variables. */
+  std::unordered_map<Var, AOTValue> var_map_;
+  /*! \brief The bound value of the variables. */
+  std::unordered_map<Var, Expr> bindings_;
+  /*! \brief The storages of the outputs, and the handle and the buffer of their output. */
+  std::unordered_map<Var, std::pair<tir::Var, tir::Buffer>> output_storages_;
+  /*! \brief The offsets of the other storages in the arena. */
+  std::unordered_map<Var, int64_t> arena_offsets_;
+  /*! \brief The arena of the intermediate tensors. */
+  tir::Buffer arena_;
+  /*! \brief The constants, and their data in the function. */
+  std::vector<std::pair<Constant, tir::Var>> constants_;
+  /*! \brief Cache ops that need to be frequently used later to reduce lookup overhead. */
+  const Op& alloc_storage_op_ = Op::Get("relax.memory.alloc_storage");
+  const Op& alloc_tensor_op_ = Op::Get("relax.memory.alloc_tensor");
+  const Op& kill_storage_op_ = Op::Get("relax.memory.kill_storage");
+  const Op& kill_tensor_op_ = Op::Get("relax.memory.kill_tensor");
+  const Op& reshape_op_ = Op::Get("relax.reshape");
+};
+
+/*!
+ * \brief Lower all relax.Function in mod to AOT TIR functions of the same symbol.
+ *
+ * \param mod Input module.
+ * \return The module of the TIR functions.
+ */
+IRModule AOTTIRCodeGen(IRModule mod) { return CodeGenAOTTIR::Run(mod); }
+
+TVM_REGISTER_GLOBAL("relax.AOTTIRCodeGen").set_body_typed(AOTTIRCodeGen);
+
+}  // namespace aot
+}  // namespace relax
+}  // namespace tvm
@@ -28,6 +28,7 @@
 #include <tvm/runtime/relax_vm/bytecode.h>
 #include <tvm/target/target.h>
 #include <tvm/tir/function.h>
+#include <tvm/tir/transform.h>
 
 #include <string>
 #include <unordered_map>
@@ -287,6 +288,10 @@ class CodeGenVM : public ExprFunctor<Instruction::Arg(const Expr&)> {
       } else if (func.as<FunctionNode>()) {
         symbol = gvar->name_hint;
         kind = VMFuncInfo::FuncKind::kVMFunc;
+      } else if (auto prim_func = func.as<tir::PrimFunc>()) {
+        // The VM checks the arguments at the entry of the Relax function, and allocates the
+        // intermediate tensors itself, so the PrimFunc is called without checks when possible.
+        symbol = tir::transform::TrustedEntrySymbol(prim_func.value());
       }
     }
     // GlobalVar can be reference to a Relax function or a TIR primfunc
@@ -32,6 +32,7 @@
 #include <tvm/tir/expr.h>
 #include <tvm/tir/function.h>
 #include <tvm/tir/stmt.h>
+#include <tvm/tir/transform.h>
 
 #include <cctype>
 #include <string>
@@ -128,6 +129,7 @@ class CodeGenVMTIR : public ExprFunctor<Optional<PrimExpr>(const Expr&)> {
                        int64_t dst_anylist_slot = -1) {
     Optional<String> gsymbol = prim_func->GetAttr<String>(tvm::attr::kGlobalSymbol);
     ICHECK(gsymbol.defined()) << "All functions must have global symbol at this phase";
+    gsymbol = tir::transform::TrustedEntrySymbol(prim_func).value_or(gsymbol.value());
     Array<PrimExpr> all_args;
     // negative index indicate return value can be discarded, emit call_packed
     if (dst_anylist_slot >= 0) {
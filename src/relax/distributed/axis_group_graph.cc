@@ -304,6 +304,42 @@ void BuildAxisGraphPermuteDims(const Var& output_var, const Call& call,
                                distributed::AxisGroupGraph::EdgeType::kDescend);
   }
 }
+void BuildAxisGraphAttention(const Var& output_var, const Call& call,
+                             distributed::AxisGroupGraph* axis_group_graph) {
+  // query: (b, s_q, n, d), key: (b, s_kv, n_kv, d), value: (b, s_kv, n_kv, d_v),
+  // output: (b, s_q, n, d_v)
+  Expr query = call->args[0];
+  Expr key = call->args[1];
+  Expr value = call->args[2];
+  const auto* q_shape = GetTensorStructInfo(query)->shape.as<ShapeExprNode>();
+  const auto* k_shape = GetTensorStructInfo(key)->shape.as<ShapeExprNode>();
+  ICHECK(q_shape && k_shape);
+  for (const Expr& input : {query, key, value}) {
+    axis_group_graph->JoinAxis({input.get(), 0}, {output_var.get(), 0},
+                               distributed::AxisGroupGraph::EdgeType::kDescend);
+  }
+  axis_group_graph->JoinAxis({query.get(), 1}, {output_var.get(), 1},
+                             distributed::AxisGroupGraph::EdgeType::kDescend);
+  axis_group_graph->JoinAxis({query.get(), 2}, {output_var.get(), 2},
+                             distributed::AxisGroupGraph::EdgeType::kDescend);
+  // The heads of key and value are only joined when not grouped.
+  arith::Analyzer analyzer;
+  if (analyzer.CanProveEqual(q_shape->values[2], k_shape->values[2])) {
+    axis_group_graph->JoinAxis({key.get(), 2}, {output_var.get(), 2},
+                               distributed::AxisGroupGraph::EdgeType::kDescend);
+    axis_group_graph->JoinAxis({value.get(), 2}, {output_var.get(), 2},
+                               distributed::AxisGroupGraph::EdgeType::kDescend);
+  }
+  axis_group_graph->JoinAxis({value.get(), 3}, {output_var.get(), 3},
+                             distributed::AxisGroupGraph::EdgeType::kDescend);
+  // The sequence of key and value, and the head dimension of query and key, are reduced.
+  // Sharding the former makes a ring attention, see relax.dist.ring_attention.
+  axis_group_graph->JoinAxis({key.get(), 1}, {value.get(), 1},
+                             distributed::AxisGroupGraph::EdgeType::kSimbling);
+  axis_group_graph->JoinAxis({query.get(), 3}, {key.get(), 3},
+                             distributed::AxisGroupGraph::EdgeType::kSimbling);
+}
+
 void BuildAxisGraphReshape(const Var& output_var, const Call& call,
                            distributed::AxisGroupGraph* axis_group_graph) {
   Expr input_tensor = call->args[0];
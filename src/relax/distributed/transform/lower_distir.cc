@@ -23,17 +23,28 @@
  *  This pass assumes all the TensorIR functions are in local view,
  *  so the pass only handles sharding relax tensor shape and
  *  inserting necessary broadcast and scatter for inputs.
+ *  It also expands the ring attention, whose keys and values are
+ *  sharded along the sequence, into the blockwise computation.
  */
 
 #include <tvm/relax/attrs/ccl.h>
+#include <tvm/relax/attrs/nn.h>
 #include <tvm/relax/distributed/axis_group_graph.h>
 #include <tvm/relax/distributed/transform.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/tir/stmt_functor.h>
 
 #include "../../../tir/schedule/transform.h"
+#include <cmath>
+
 #include "../../op/ccl/ccl.h"
+#include "../../op/tensor/binary.h"
+#include "../../op/tensor/datatype.h"
+#include "../../op/tensor/linear_algebra.h"
 #include "../../op/tensor/manipulate.h"
+#include "../../op/tensor/statistical.h"
+#include "../../op/tensor/unary.h"
+#include "../../transform/utils.h"
 #include "utils.h"
 
 namespace tvm {
@@ -245,7 +256,109 @@ class DistIRSharder : public ExprMutator {
     return GetRef<Call>(call);
   }
 
+  /*!
+   * \brief Expand a ring attention of n workers into n steps, each of which attends to the
+   * block of keys and values of one worker. The blocks are passed to the next worker in the
+   * ring in the meantime, and the partial results are merged by their softmax statistics.
+   *
+   * All of it is in the local view, in which each worker holds its own block at first.
+   */
+  Expr EmitRingAttention(const CallNode* call) {
+    const auto* attrs = call->attrs.as<AttentionAttrs>();
+    ICHECK(attrs);
+    int num_blocks = 0;
+    for (int i = 1; i <= 2; i++) {
+      const auto* sinfo = GetStructInfoAs<DTensorStructInfoNode>(call->args[i]);
+      ICHECK(sinfo);
+      // FIXME: this only works for 1d device mesh, like the scatter of inputs.
+      ICHECK(sinfo->device_mesh->shape.size() == 1);
+      PlacementSpec spec = sinfo->placement->dim_specs[0];
+      CHECK(spec->kind == PlacementSpecKind::kSharding && spec->axis == 1)
+          << "ValueError: Ring attention expects the key and value to be sharded along the "
+          << "sequence, but got " << sinfo->placement;
+      num_blocks = sinfo->device_mesh->shape[0];
+    }
+    Expr query = this->VisitExpr(call->args[0]);
+    Expr key = this->VisitExpr(call->args[1]);
+    Expr value = this->VisitExpr(call->args[2]);
+    const auto* q_sinfo = GetStructInfoAs<TensorStructInfoNode>(query);
+    const auto* k_sinfo = GetStructInfoAs<TensorStructInfoNode>(key);
+    ICHECK(q_sinfo && k_sinfo);
+    const auto* q_shape = q_sinfo->shape.as<ShapeExprNode>();
+    const auto* k_shape = k_sinfo->shape.as<ShapeExprNode>();
+    ICHECK(q_shape && k_shape);
+    const auto* num_heads = q_shape->values[2].as<IntImmNode>();
+    const auto* num_kv_heads = k_shape->values[2].as<IntImmNode>();
+    const auto* head_dim = q_shape->values[3].as<IntImmNode>();
+    CHECK(num_heads && num_kv_heads && head_dim)
+        << "ValueError: Ring attention requires static numbers of heads and head dimension";
+    double scale = attrs->scale.defined() ? attrs->scale.value()->value
+                                          : 1.0 / std::sqrt(static_cast<double>(head_dim->value));
+
+    static const Op& call_dps_packed_op = Op::Get("relax.call_dps_packed");
+    DataType dtype = q_sinfo->dtype;
+    DataType accum_dtype = DataType::Float(32);
+    auto cast = [&](Expr x, DataType target) {
+      return GetStructInfoAs<TensorStructInfoNode>(x)->dtype == target
+                 ? x
+                 : builder_->Emit(astype(x, target));
+    };
+    auto ring_exchange = [&](Expr x) {
+      return builder_->Emit(Call(call_dps_packed_op,
+                                 {ExternFunc("runtime.disco.ring_exchange"), Tuple({x})}, {},
+                                 {GetStructInfo(x)}));
+    };
+
+    // (b, s, n, d) -> (b, n, s, d)
+    Expr q = builder_->Emit(permute_dims(query, Array<Integer>{0, 2, 1, 3}));
+    Expr max_score, sum_exp, output;
+    for (int step = 0; step < num_blocks; step++) {
+      // Start passing the current block on before computing with it.
+      Expr next_key, next_value;
+      if (step + 1 < num_blocks) {
+        next_key = ring_exchange(key);
+        next_value = ring_exchange(value);
+      }
+      Expr k = key, v = value;
+      if (num_heads->value != num_kv_heads->value) {
+        k = builder_->Emit(repeat(k, num_heads->value / num_kv_heads->value, Integer(2)));
+        v = builder_->Emit(repeat(v, num_heads->value / num_kv_heads->value, Integer(2)));
+      }
+      k = builder_->Emit(permute_dims(k, Array<Integer>{0, 2, 3, 1}));
+      v = builder_->Emit(permute_dims(v, Array<Integer>{0, 2, 1, 3}));
+      Expr score = cast(builder_->Emit(matmul(q, k, DataType::Void())), accum_dtype);
+      score = builder_->Emit(multiply(score, MakeConstantScalar(scale, accum_dtype)));
+      Expr block_max = builder_->Emit(relax::max(score, Array<Integer>{-1}, true));
+      Expr prob = builder_->Emit(relax::exp(builder_->Emit(subtract(score, block_max))));
+      Expr block_sum = builder_->Emit(relax::sum(prob, Array<Integer>{-1}, true));
+      Expr block_output = builder_->Emit(matmul(cast(prob, dtype), v, accum_dtype));
+      if (step == 0) {
+        max_score = block_max;
+        sum_exp = block_sum;
+        output = block_output;
+      } else {
+        Expr new_max = builder_->Emit(maximum(max_score, block_max));
+        Expr old_scale = builder_->Emit(relax::exp(builder_->Emit(subtract(max_score, new_max))));
+        Expr new_scale = builder_->Emit(relax::exp(builder_->Emit(subtract(block_max, new_max))));
+        output = builder_->Emit(add(builder_->Emit(multiply(output, old_scale)),
+                                    builder_->Emit(multiply(block_output, new_scale))));
+        sum_exp = builder_->Emit(add(builder_->Emit(multiply(sum_exp, old_scale)),
+                                     builder_->Emit(multiply(block_sum, new_scale))));
+        max_score = new_max;
+      }
+      key = next_key;
+      value = next_value;
+    }
+    output = cast(builder_->Emit(divide(output, sum_exp)), dtype);
+    return permute_dims(output, Array<Integer>{0, 2, 1, 3});
+  }
+
   void VisitBinding_(const VarBindingNode* binding, const CallNode* val) {
+    static const Op& ring_attention_op = Op::Get("relax.dist.ring_attention");
+    if (val->op.same_as(ring_attention_op)) {
+      ReEmitBinding(binding, builder_->Normalize(EmitRingAttention(val)));
+      return;
+    }
     Call new_call =
         Downcast<Call>(this->VisitExpr(HandleSpecialCaseinDTensorLowering(val, binding->var)));
     ReEmitBinding(binding, builder_->Normalize(new_call));
@@ -112,6 +112,14 @@ void CollectAxisGraphReshape(const VarBindingNode* binding, const CallNode* call
   }
 }
 
+void CollectAxisGraphAttention(const VarBindingNode* binding, const CallNode* call,
+                               AxisGroupGraph* axis_group_graph) {
+  static const Op& attention_op = Op::Get("relax.nn.attention");
+  if (call->op.same_as(attention_op)) {
+    BuildAxisGraphAttention(binding->var, GetRef<Call>(call), axis_group_graph);
+  }
+}
+
 void CollectAxisGraphForDeviceMesh(const VarBindingNode* binding, const CallNode* call,
                                    AxisGroupGraph* axis_group_graph) {
   Array<Expr> tensor_list;
@@ -155,6 +163,7 @@ class AxisGroupGraphBuilder : public ExprVisitor {
     CollectAxisGraphMatmul(binding, val, axis_group_graph_);
     CollectAxisGraphPermuteDims(binding, val, axis_group_graph_);
     CollectAxisGraphReshape(binding, val, axis_group_graph_);
+    CollectAxisGraphAttention(binding, val, axis_group_graph_);
     static const Op& call_tir_op = Op::Get("relax.call_tir");
     if (val->op.same_as(call_tir_op)) {
       if (Optional<tir::PrimFunc> func = MatchPrimFunc(mod_, val->args[0])) {
@@ -459,6 +468,11 @@ class DistributedIRBuilder : public ExprMutator {
     } else {
       n->args = args;
     }
+    static const Op& attention_op = Op::Get("relax.nn.attention");
+    if (new_call->op.same_as(attention_op) && IsShardedOnAxis(args[1], 1)) {
+      // Each worker only holds a block of the keys and values, which go around the ring.
+      n->op = Op::Get("relax.dist.ring_attention");
+    }
 
     if (const auto* extern_func = new_call->op.as<ExternFuncNode>()) {
       if (extern_func->global_symbol == "vm.builtin.attention_kv_cache_append") {
@@ -470,6 +484,15 @@ class DistributedIRBuilder : public ExprMutator {
     return Call(n);
   }
 
+  bool IsShardedOnAxis(const Expr& tensor, int axis) {
+    const auto* sinfo = GetStructInfoAs<DTensorStructInfoNode>(tensor);
+    if (sinfo == nullptr) return false;
+    for (const PlacementSpec& spec : sinfo->placement->dim_specs) {
+      if (spec->kind == PlacementSpecKind::kSharding && spec->axis == axis) return true;
+    }
+    return false;
+  }
+
   Expr RemoveAnnotateSharding(Call call) {
     static const Op& annotate_sharding_op = Op::Get("relax.dist.annotate_sharding");
     if (call->op.same_as(annotate_sharding_op)) {
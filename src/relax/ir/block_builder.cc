@@ -562,7 +562,7 @@ class Normalizer : public BlockBuilderImpl, private ExprFunctor<Expr(const Expr&
       }
     }
     // skip visit expr's cache, normalize arg
-    Expr post = ExprFunctor::VisitExpr(arg);
+    Expr post = VisitExprUnlessNormalized(arg);
 
     if (!IsLeafOrTuple(arg)) {
       ICHECK(!block_stack_.empty()) << "Cannot normalize non-leaf without a scope";
@@ -614,7 +614,7 @@ class Normalizer : public BlockBuilderImpl, private ExprFunctor<Expr(const Expr&
         return it->second;
       }
     }
-    return ExprFunctor::VisitExpr(expr);
+    return VisitExprUnlessNormalized(expr);
   }
 
   Expr VisitExpr_(const TupleNode* op) final {
@@ -1036,6 +1036,28 @@ class Normalizer : public BlockBuilderImpl, private ExprFunctor<Expr(const Expr&
 
   /*! \brief Whether the FNormalize function should be applied */
   bool apply_f_normalize_{true};
+
+  /*!
+   * \brief The non-leaf expressions this builder has normalized.
+   *
+   * ExprMutator normalizes each expression after mutating it, so the
+   * enclosing expressions, e.g. the SeqExpr of a function body, would
+   * normalize the same bindings again at every level of nesting.  The
+   * normalization of these expressions is skipped.  Holding references
+   * keeps CopyOnWrite from mutating the recorded nodes in place.
+   */
+  std::unordered_set<Expr, ObjectPtrHash, ObjectPtrEqual> normalized_;
+
+  Expr VisitExprUnlessNormalized(const Expr& expr) {
+    if (normalized_.count(expr)) {
+      return expr;
+    }
+    Expr post = ExprFunctor::VisitExpr(expr);
+    if (post.as<TupleNode>() || !IsLeafOrTuple(post)) {
+      normalized_.insert(post);
+    }
+    return post;
+  }
 };
 
 BlockBuilder BlockBuilder::Create(Optional<IRModule> mod) {
@@ -88,6 +88,50 @@ TVM_REGISTER_OP("relax.ccl.allgather")
     .set_attr<FRelaxInferLayout>("FRelaxInferLayout", InferLayoutUnaryEwise)
     .set_attr<Bool>("FPurity", Bool(true));
 
+/* relax.ccl.alltoall */
+Expr alltoall(Expr x, int num_workers, bool in_group) {
+  ObjectPtr<AllGatherAttrs> attrs = make_object<AllGatherAttrs>();
+  attrs->num_workers = std::move(num_workers);
+  attrs->in_group = std::move(in_group);
+
+  static const Op& op = Op::Get("relax.ccl.alltoall");
+  return Call(op, {std::move(x)}, Attrs{attrs}, {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.ccl.alltoall").set_body_typed(alltoall);
+
+StructInfo InferStructInfoAllToAll(const Call& call, const BlockBuilder& ctx) {
+  TensorStructInfo input_sinfo = GetUnaryInputTensorStructInfo(call, ctx);
+
+  const auto* attrs = call->attrs.as<AllGatherAttrs>();
+  int num_workers = attrs->num_workers;
+
+  auto input_shape = input_sinfo->GetShape();
+  if (!input_shape.defined()) {
+    return input_sinfo;
+  }
+  if (input_shape.value().empty()) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << "Alltoall expects the input to have at least one dimension, so that its "
+                     << "first axis can be split among the workers");
+  }
+  arith::Analyzer* analyzer = ctx->GetAnalyzer();
+  PrimExpr num_rows = input_shape.value()[0];
+  if (analyzer->CanProve(floormod(num_rows, PrimExpr(num_workers)) != 0)) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << "Alltoall expects the size of the first axis of the input to be divisible "
+                     << "by the number of workers. However, the first axis has size " << num_rows
+                     << " while num_workers is " << num_workers);
+  }
+  return input_sinfo;
+}
+
+TVM_REGISTER_OP("relax.ccl.alltoall")
+    .set_num_inputs(1)
+    .add_argument("x", "Tensor", "Input to which alltoall will be applied.")
+    .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoAllToAll)
+    .set_attr<Bool>("FPurity", Bool(true));
+
 /* relax.ccl.broadcast_from_worker0 */
 Expr broadcast_from_worker0(Expr x) {
   static const Op& op = Op::Get("relax.ccl.broadcast_from_worker0");
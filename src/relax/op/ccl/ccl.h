@@ -38,6 +38,9 @@ Expr allreduce(Expr data, String op_type, bool in_group);
 /*! \brief AllGather. */
 Expr allgather(Expr data, int num_workers, bool in_group);
 
+/*! \brief AllToAll, where chunk `i` of the first axis is exchanged with worker `i`. */
+Expr alltoall(Expr data, int num_workers, bool in_group);
+
 /*! \brief Broadcast data from worker-0 to all other workers. */
 Expr broadcast_from_worker0(Expr data);
 
@@ -25,6 +25,7 @@
 #include "distributed.h"
 
 #include <tvm/relax/attrs/ccl.h>
+#include <tvm/relax/attrs/nn.h>
 #include <tvm/topi/einsum.h>
 
 #include <algorithm>
@@ -32,6 +33,7 @@
 #include <vector>
 
 #include "../ccl/ccl.h"
+#include "nn.h"
 
 namespace tvm {
 namespace relax {
@@ -219,5 +221,38 @@ TVM_REGISTER_OP("relax.dist.redistribute_replica_to_shard")
     .set_attr<FInferStructInfo>("dist.FInferStructInfo", InferDistStructInfoRtoS)
     .set_attr<Bool>("FPurity", Bool(true));
 
+/* relax.dist.ring_attention */
+
+Expr ring_attention(Expr query, Expr key, Expr value, Optional<FloatImm> scale,
+                    Optional<String> causal_mask, Optional<IntImm> window_size) {
+  ObjectPtr<AttentionAttrs> attrs = make_object<AttentionAttrs>();
+  attrs->scale = scale;
+  attrs->causal_mask = causal_mask;
+  attrs->window_size = window_size;
+  static const Op& op = Op::Get("relax.dist.ring_attention");
+  return Call(op, {std::move(query), std::move(key), std::move(value)}, Attrs(attrs), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.dist.ring_attention").set_body_typed(ring_attention);
+
+StructInfo InferDistStructInfoRingAttention(const Call& call, const BlockBuilder& ctx) {
+  const auto* attrs = call->attrs.as<AttentionAttrs>();
+  if (attrs->causal_mask.defined() || attrs->window_size.defined()) {
+    ctx->ReportFatal(Diagnostic::Error(call) << "Ring attention does not support masks yet, "
+                                             << "and requires the full keys and values");
+  }
+  return distributed::InferDistStructInfoAttention(call, ctx);
+}
+
+// It only exists in the distributed IR, and is expanded by LowerDistIR.
+TVM_REGISTER_OP("relax.dist.ring_attention")
+    .set_num_inputs(3)
+    .add_argument("query", "Tensor", "The input queries tensor.")
+    .add_argument("key", "Tensor", "The input keys tensor, sharded along the sequence.")
+    .add_argument("value", "Tensor", "The input values tensor, sharded along the sequence.")
+    .set_attrs_type<AttentionAttrs>()
+    .set_attr<FInferStructInfo>("dist.FInferStructInfo", InferDistStructInfoRingAttention)
+    .set_attr<Bool>("FPurity", Bool(true));
+
 }  // namespace relax
 }  // namespace tvm
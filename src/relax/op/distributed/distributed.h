@@ -63,6 +63,20 @@ Expr redistribute(Expr input, distributed::DeviceMesh device_mesh,
  * \return The result.
  */
 Expr redistribute_replica_to_shard(Expr input, int num_workers, int axis);
+
+/*!
+ * \brief Attention whose keys and values are sharded along the sequence, and hence computed
+ *  blockwise while the blocks are rotated among the workers.
+ * \param query The query, of shape (batch_size, seq_len, num_heads, head_dim).
+ * \param key The key, of shape (batch_size, seq_len_kv, num_heads_kv, head_dim).
+ * \param value The value, of shape (batch_size, seq_len_kv, num_heads_kv, head_dim_v).
+ * \param scale The scale applied before the softmax, which is 1 / sqrt(head_dim) by default.
+ * \param causal_mask The type of the causal mask, which is not supported yet.
+ * \param window_size The size of the sliding window, which is not supported yet.
+ * \return The result, of shape (batch_size, seq_len, num_heads, head_dim_v).
+ */
+Expr ring_attention(Expr query, Expr key, Expr value, Optional<FloatImm> scale,
+                    Optional<String> causal_mask, Optional<IntImm> window_size);
 }  // namespace relax
 }  // namespace tvm
 
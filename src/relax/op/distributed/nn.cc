@@ -46,6 +46,30 @@ StructInfo InferDistStructInfoSoftmax(const Call& call, const BlockBuilder& ctx)
 TVM_REGISTER_OP("relax.nn.softmax")
     .set_attr<FInferStructInfo>("dist.FInferStructInfo", InferDistStructInfoSoftmax);
 
+StructInfo InferDistStructInfoAttention(const Call& call, const BlockBuilder& ctx) {
+  Array<distributed::DTensorStructInfo> input_dtensor_sinfos = GetInputDTensorStructInfo(call, ctx);
+  if (input_dtensor_sinfos.size() != 3) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << "Distributed attention expects the query, key and value, but got "
+                     << input_dtensor_sinfos.size() << " inputs");
+  }
+  TensorStructInfo q_sinfo = input_dtensor_sinfos[0]->tensor_sinfo;
+  TensorStructInfo v_sinfo = input_dtensor_sinfos[2]->tensor_sinfo;
+  const auto* q_shape = q_sinfo->shape.as<ShapeExprNode>();
+  const auto* v_shape = v_sinfo->shape.as<ShapeExprNode>();
+  if (q_sinfo->ndim != 4 || v_sinfo->ndim != 4 || q_shape == nullptr || v_shape == nullptr) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << "Input of distributed attention must be 4-dimensional with known shape");
+  }
+  Array<PrimExpr> output_shape = q_shape->values;
+  output_shape.Set(3, v_shape->values[3]);
+  TensorStructInfo output_sinfo(ShapeExpr(output_shape), q_sinfo->dtype, q_sinfo->vdevice);
+  return InferShardingSpec(call, ctx, output_sinfo, distributed::BuildAxisGraphAttention);
+}
+
+TVM_REGISTER_OP("relax.nn.attention")
+    .set_attr<FInferStructInfo>("dist.FInferStructInfo", InferDistStructInfoAttention);
+
 /* relax.nn.relu */
 RELAX_REGISTER_UNARY_ARITH_DIST_INFER_STRUCT_INFO(nn.relu, /*require_float_dtype=*/false);
 
@@ -33,6 +33,8 @@ namespace distributed {
 
 StructInfo InferDistStructInfoSoftmax(const Call& call, const BlockBuilder& ctx);
 
+StructInfo InferDistStructInfoAttention(const Call& call, const BlockBuilder& ctx);
+
 }  // namespace distributed
 }  // namespace relax
 }  // namespace tvm
@@ -251,5 +251,117 @@ TVM_REGISTER_OP("relax.einsum")
     .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoEinsum)
     .set_attr<Bool>("FPurity", Bool(true));
 
+/* relax.bsr_matmul */
+Expr bsr_matmul(Expr x, Expr data, Expr indices, Expr indptr) {
+  static const Op& op = Op::Get("relax.bsr_matmul");
+  return Call(op, {std::move(x), std::move(data), std::move(indices), std::move(indptr)}, Attrs(),
+              {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.bsr_matmul").set_body_typed(bsr_matmul);
+
+/*! \brief Report an error if the tensor has a known ndim other than the expected one. */
+void CheckSparseOperandNdim(const Call& call, const BlockBuilder& ctx,
+                            const TensorStructInfo& sinfo, int ndim, const char* name) {
+  if (!sinfo->IsUnknownNdim() && sinfo->ndim != ndim) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << call->op << " requires " << name << " to be a " << ndim
+                     << "-D tensor. However, it has struct info " << sinfo);
+  }
+}
+
+/*! \brief Report an error if the tensor has a known dtype which is not an integer type. */
+void CheckSparseIndexDtype(const Call& call, const BlockBuilder& ctx,
+                           const TensorStructInfo& sinfo, const char* name) {
+  if (!sinfo->IsUnknownDtype() && !sinfo->dtype.is_int() && !sinfo->dtype.is_uint()) {
+    ctx->ReportFatal(Diagnostic::Error(call) << call->op << " requires " << name
+                                             << " to be an integer tensor. However, it has dtype "
+                                             << sinfo->dtype);
+  }
+}
+
+StructInfo InferStructInfoBSRMatmul(const Call& call, const BlockBuilder& ctx) {
+  Array<TensorStructInfo> input_sinfo = GetInputTensorStructInfo(call, ctx);
+  TensorStructInfo x_sinfo = input_sinfo[0];
+  TensorStructInfo data_sinfo = input_sinfo[1];
+  TensorStructInfo indices_sinfo = input_sinfo[2];
+  TensorStructInfo indptr_sinfo = input_sinfo[3];
+  CheckSparseOperandNdim(call, ctx, x_sinfo, 2, "the dense input");
+  CheckSparseOperandNdim(call, ctx, data_sinfo, 3, "the data of the weight");
+  CheckSparseOperandNdim(call, ctx, indices_sinfo, 1, "the indices of the weight");
+  CheckSparseOperandNdim(call, ctx, indptr_sinfo, 1, "the indptr of the weight");
+  CheckSparseIndexDtype(call, ctx, indices_sinfo, "the indices of the weight");
+  CheckSparseIndexDtype(call, ctx, indptr_sinfo, "the indptr of the weight");
+
+  Optional<VDevice> vdev = x_sinfo->vdevice;
+  const auto* x_shape = x_sinfo->shape.as<ShapeExprNode>();
+  const auto* data_shape = data_sinfo->shape.as<ShapeExprNode>();
+  const auto* indptr_shape = indptr_sinfo->shape.as<ShapeExprNode>();
+  if (x_shape == nullptr || data_shape == nullptr || indptr_shape == nullptr) {
+    return TensorStructInfo(x_sinfo->dtype, /*ndim=*/2, vdev);
+  }
+  arith::Analyzer* analyzer = ctx->GetAnalyzer();
+  PrimExpr n = analyzer->Simplify((indptr_shape->values[0] - 1) * data_shape->values[1]);
+  return TensorStructInfo(ShapeExpr({x_shape->values[0], n}), x_sinfo->dtype, vdev);
+}
+
+TVM_REGISTER_OP("relax.bsr_matmul")
+    .set_num_inputs(4)
+    .add_argument("x", "Tensor", "The dense input tensor.")
+    .add_argument("data", "Tensor", "The nonzero blocks of the sparse weight.")
+    .add_argument("indices", "Tensor", "The block column of each nonzero block.")
+    .add_argument("indptr", "Tensor", "The offset of the blocks of each block row.")
+    .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoBSRMatmul)
+    .set_attr<Bool>("FPurity", Bool(true));
+
+/* relax.structured_sparse_matmul */
+Expr structured_sparse_matmul(Expr x, Expr values, Expr indices) {
+  static const Op& op = Op::Get("relax.structured_sparse_matmul");
+  return Call(op, {std::move(x), std::move(values), std::move(indices)}, Attrs(), {});
+}
+
+TVM_REGISTER_GLOBAL("relax.op.structured_sparse_matmul").set_body_typed(structured_sparse_matmul);
+
+StructInfo InferStructInfoStructuredSparseMatmul(const Call& call, const BlockBuilder& ctx) {
+  Array<TensorStructInfo> input_sinfo = GetInputTensorStructInfo(call, ctx);
+  TensorStructInfo x_sinfo = input_sinfo[0];
+  TensorStructInfo values_sinfo = input_sinfo[1];
+  TensorStructInfo indices_sinfo = input_sinfo[2];
+  CheckSparseOperandNdim(call, ctx, values_sinfo, 2, "the values of the weight");
+  CheckSparseOperandNdim(call, ctx, indices_sinfo, 2, "the indices of the weight");
+  CheckSparseIndexDtype(call, ctx, indices_sinfo, "the indices of the weight");
+  if (x_sinfo->ndim == 0) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << call->op << " requires the dense input to have at least one dimension. "
+                     << "However, it is a scalar");
+  }
+
+  Optional<VDevice> vdev = x_sinfo->vdevice;
+  const auto* x_shape = x_sinfo->shape.as<ShapeExprNode>();
+  const auto* values_shape = values_sinfo->shape.as<ShapeExprNode>();
+  if (x_shape == nullptr || values_shape == nullptr) {
+    return TensorStructInfo(x_sinfo->dtype, x_sinfo->ndim, vdev);
+  }
+  arith::Analyzer* analyzer = ctx->GetAnalyzer();
+  PrimExpr reduction_length = x_shape->values.back();
+  if (analyzer->CanProve(reduction_length != values_shape->values[1] * 2)) {
+    ctx->ReportFatal(Diagnostic::Error(call)
+                     << call->op << " requires the values of the weight to keep half of the "
+                     << "reduction length of " << reduction_length
+                     << ". However, they have shape " << values_sinfo->shape);
+  }
+  Array<PrimExpr> output_shape{x_shape->values.begin(), x_shape->values.end() - 1};
+  output_shape.push_back(values_shape->values[0]);
+  return TensorStructInfo(ShapeExpr(output_shape), x_sinfo->dtype, vdev);
+}
+
+TVM_REGISTER_OP("relax.structured_sparse_matmul")
+    .set_num_inputs(3)
+    .add_argument("x", "Tensor", "The dense input tensor.")
+    .add_argument("values", "Tensor", "The kept elements of the sparse weight.")
+    .add_argument("indices", "Tensor", "The position of each kept element in its group.")
+    .set_attr<FInferStructInfo>("FInferStructInfo", InferStructInfoStructuredSparseMatmul)
+    .set_attr<Bool>("FPurity", Bool(true));
+
 }  // namespace relax
 }  // namespace tvm
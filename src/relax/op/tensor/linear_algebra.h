@@ -51,6 +51,27 @@ Expr matmul(Expr x1, Expr x2, DataType out_dtype);
  */
 Expr einsum(Expr operands, String subscripts);
 
+/*!
+ * \brief Multiply a dense tensor by the transpose of a sparse weight in the block compressed
+ * sparse row (BSR) format, i.e. x @ W^T.
+ * \param x The dense input of shape (m, k).
+ * \param data The nonzero blocks of W, of shape (nnz_blocks, block_rows, block_cols).
+ * \param indices The block column of each nonzero block, of shape (nnz_blocks,).
+ * \param indptr The offset of the blocks of each block row in data, of shape (n / block_rows + 1,).
+ * \return The computed result, of shape (m, n).
+ */
+Expr bsr_matmul(Expr x, Expr data, Expr indices, Expr indptr);
+
+/*!
+ * \brief Multiply a dense tensor by the transpose of a 2:4 structured sparse weight, in which
+ * each group of 4 consecutive elements of a row has at most 2 nonzero elements.
+ * \param x The dense input of shape (..., k).
+ * \param values The 2 kept elements of each group of W, of shape (n, k / 2).
+ * \param indices The position of each kept element in its group, of shape (n, k / 2).
+ * \return The computed result, of shape (..., n).
+ */
+Expr structured_sparse_matmul(Expr x, Expr values, Expr indices);
+
 }  // namespace relax
 }  // namespace tvm
 
@@ -0,0 +1,293 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/annotate_checkpoints.cc
+ * \brief Choose the activations kept for the backward pass, and annotate the
+ *  others with start_checkpoint/end_checkpoint so that Gradient recomputes them.
+ *
+ * The candidates are the tensors of static shape computed by operators in a
+ * dataflow block, except the outputs of the block.  Two strategies choose the
+ * kept activations among them:
+ *
+ *   - "sqrt" keeps every ceil(sqrt(n))-th candidate, so that both the kept
+ *     activations and the ones recomputed at once are O(sqrt(n)).
+ *   - "budget" keeps the activations that are the most expensive to recompute,
+ *     estimated with EstimateTIRFlops on their legalized operator, such that
+ *     their total size fits into the memory budget.  This is solved as a
+ *     knapsack problem by dynamic programming.
+ *
+ * The bindings computing the other candidates are recomputed by Gradient.
+ * To express that, they read the kept activations and the parameters through
+ * start_checkpoint, and the kept activations read them through end_checkpoint.
+ */
+
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+#include <tvm/tir/analysis.h>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+namespace {
+
+/*! \brief The number of units the memory budget is divided into by the knapsack. */
+constexpr int64_t kBudgetUnits = 1024;
+
+std::optional<int64_t> GetStaticNumBytes(const StructInfo& sinfo) {
+  const auto* tensor_sinfo = sinfo.as<TensorStructInfoNode>();
+  if (!tensor_sinfo || tensor_sinfo->IsUnknownDtype()) return std::nullopt;
+  const auto* shape = tensor_sinfo->shape.as<ShapeExprNode>();
+  if (!shape) return std::nullopt;
+  int64_t nbytes = (tensor_sinfo->dtype.bits() * tensor_sinfo->dtype.lanes() + 7) / 8;
+  for (const PrimExpr& dim : shape->values) {
+    const auto* int_imm = dim.as<IntImmNode>();
+    if (!int_imm) return std::nullopt;
+    nbytes *= int_imm->value;
+  }
+  return nbytes;
+}
+
+/*!
+ * \brief Estimate the FLOPs of recomputing an operator call, by legalizing it on its own.
+ * Falls back to the number of output elements when the operator cannot be legalized.
+ */
+double EstimateRecomputeFlops(const Call& call, int64_t nbytes) {
+  const auto* out_sinfo = GetStructInfoAs<TensorStructInfoNode>(call);
+  double fallback = static_cast<double>(nbytes) / std::max(out_sinfo->dtype.bytes(), 1);
+  try {
+    Array<Var> params;
+    Map<Var, Expr> remap;
+    for (const Var& var : FreeVars(call)) {
+      Var param(var->name_hint(), GetStructInfo(var));
+      params.push_back(param);
+      remap.Set(var, param);
+    }
+    Var out("out", GetStructInfo(call));
+    Function func(params, SeqExpr({BindingBlock({VarBinding(out, Bind(call, remap))})}, out),
+                  GetStructInfo(call));
+    IRModule mod({{GlobalVar("main"), func}});
+    mod = transform::LegalizeOps(NullOpt)(mod);
+    double flops = tir::EstimateTIRFlops(mod);
+    return flops > 0 ? flops : fallback;
+  } catch (const std::exception&) {
+    return fallback;
+  }
+}
+
+struct Candidate {
+  size_t binding_index;
+  int64_t nbytes;
+  double flops;
+};
+
+/*! \brief Keep every ceil(sqrt(n))-th candidate. */
+std::vector<bool> SelectBySqrt(const std::vector<Candidate>& candidates) {
+  size_t n = candidates.size();
+  size_t stride = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(n))));
+  std::vector<bool> kept(n, false);
+  for (size_t i = 0; i < n; ++i) {
+    kept[i] = (i + 1) % stride == 0;
+  }
+  return kept;
+}
+
+/*! \brief Keep the candidates of the most FLOPs whose total size fits into the budget. */
+std::vector<bool> SelectByBudget(const std::vector<Candidate>& candidates, int64_t budget) {
+  size_t n = candidates.size();
+  std::vector<bool> kept(n, false);
+  if (budget <= 0) return kept;
+  int64_t unit = std::max<int64_t>((budget + kBudgetUnits - 1) / kBudgetUnits, 1);
+  int64_t capacity = budget / unit;
+  // best[i][c] is the largest FLOPs kept among the first i candidates within c units.
+  std::vector<std::vector<double>> best(n + 1, std::vector<double>(capacity + 1, 0.0));
+  std::vector<int64_t> weight(n);
+  for (size_t i = 0; i < n; ++i) {
+    weight[i] = (candidates[i].nbytes + unit - 1) / unit;
+    for (int64_t c = 0; c <= capacity; ++c) {
+      best[i + 1][c] = best[i][c];
+      if (weight[i] <= c) {
+        best[i + 1][c] = std::max(best[i + 1][c], best[i][c - weight[i]] + candidates[i].flops);
+      }
+    }
+  }
+  for (int64_t i = static_cast<int64_t>(n), c = capacity; i > 0; --i) {
+    if (best[i][c] != best[i - 1][c]) {
+      kept[i - 1] = true;
+      c -= weight[i - 1];
+    }
+  }
+  return kept;
+}
+
+class CheckpointAnnotator {
+ public:
+  CheckpointAnnotator(String strategy, int64_t memory_budget)
+      : strategy_(strategy), memory_budget_(memory_budget) {}
+
+  Function Run(Function func) {
+    static const Op& s_cp = Op::Get("relax.grad.start_checkpoint");
+    static const Op& e_cp = Op::Get("relax.grad.end_checkpoint");
+    bool annotated = false;
+    PostOrderVisit(func->body, [&](const Expr& expr) {
+      if (const auto* call = expr.as<CallNode>()) {
+        annotated |= call->op.same_as(s_cp) || call->op.same_as(e_cp);
+      }
+    });
+    // Respect the checkpoints annotated by the user.
+    if (annotated) return func;
+
+    params_.clear();
+    for (const Var& param : func->params) {
+      params_.insert(param.get());
+    }
+    auto seq = Downcast<SeqExpr>(func->body);
+    Array<BindingBlock> new_blocks;
+    bool changed = false;
+    for (const BindingBlock& block : seq->blocks) {
+      if (const auto* dataflow = block.as<DataflowBlockNode>()) {
+        auto new_block = Annotate(GetRef<DataflowBlock>(dataflow));
+        changed |= !new_block.same_as(block);
+        new_blocks.push_back(new_block);
+      } else {
+        new_blocks.push_back(block);
+      }
+    }
+    if (!changed) return func;
+    auto new_func = func;
+    new_func.CopyOnWrite()->body = SeqExpr(new_blocks, seq->body);
+    return new_func;
+  }
+
+ private:
+  BindingBlock Annotate(const DataflowBlock& block) {
+    std::vector<Candidate> candidates;
+    int64_t mandatory_bytes = 0;
+    for (size_t i = 0; i < block->bindings.size(); ++i) {
+      const Binding& binding = block->bindings[i];
+      auto nbytes = GetStaticNumBytes(GetStructInfo(binding->var));
+      const auto* var_binding = binding.as<VarBindingNode>();
+      const auto* call = var_binding ? var_binding->value.as<CallNode>() : nullptr;
+      if (call && call->op->IsInstance<OpNode>() && nbytes &&
+          binding->var->IsInstance<DataflowVarNode>()) {
+        candidates.push_back({i, nbytes.value(), 0.0});
+      } else if (nbytes) {
+        mandatory_bytes += nbytes.value();
+      }
+    }
+    if (candidates.empty()) return block;
+
+    std::vector<bool> kept;
+    if (strategy_ == "sqrt") {
+      kept = SelectBySqrt(candidates);
+    } else {
+      for (Candidate& candidate : candidates) {
+        const auto* var_binding = block->bindings[candidate.binding_index].as<VarBindingNode>();
+        candidate.flops =
+            EstimateRecomputeFlops(Downcast<Call>(var_binding->value), candidate.nbytes);
+      }
+      if (mandatory_bytes > memory_budget_) {
+        LOG(WARNING) << "The activations that cannot be recomputed take " << mandatory_bytes
+                     << " bytes, exceeding the memory budget of " << memory_budget_ << " bytes";
+      }
+      kept = SelectByBudget(candidates, memory_budget_ - mandatory_bytes);
+    }
+
+    std::unordered_set<const VarNode*> recomputed;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      if (!kept[i]) {
+        recomputed.insert(block->bindings[candidates[i].binding_index]->var.get());
+      }
+    }
+    if (recomputed.empty()) return block;
+
+    static const Op& s_cp = Op::Get("relax.grad.start_checkpoint");
+    static const Op& e_cp = Op::Get("relax.grad.end_checkpoint");
+    std::unordered_map<const VarNode*, Var> start_vars, end_vars;
+    Array<Binding> new_bindings;
+    // Read the variable through the checkpoint annotation, emitted before its first such use.
+    auto annotated = [&](const Var& var, const Op& op, const char* suffix,
+                         std::unordered_map<const VarNode*, Var>* cache) -> Var {
+      auto it = cache->find(var.get());
+      if (it != cache->end()) return it->second;
+      DataflowVar new_var(var->name_hint() + suffix, GetStructInfo(var));
+      new_bindings.push_back(VarBinding(new_var, Call(op, {var}, Attrs(), {})));
+      cache->emplace(var.get(), new_var);
+      return new_var;
+    };
+
+    for (const Binding& binding : block->bindings) {
+      bool is_recomputed = recomputed.count(binding->var.get());
+      Map<Var, Expr> remap;
+      for (const Var& var : FreeVars(GetBoundValue(binding))) {
+        bool is_kept = params_.count(var.get()) || !recomputed.count(var.get());
+        if (is_recomputed && is_kept && var->struct_info_.as<TensorStructInfoNode>()) {
+          remap.Set(var, annotated(var, s_cp, "_scp", &start_vars));
+        } else if (!is_recomputed && recomputed.count(var.get())) {
+          remap.Set(var, annotated(var, e_cp, "_ecp", &end_vars));
+        }
+      }
+      Expr value = Bind(GetBoundValue(binding), remap);
+      if (const auto* match_cast = binding.as<MatchCastNode>()) {
+        new_bindings.push_back(MatchCast(match_cast->var, value, match_cast->struct_info));
+      } else {
+        new_bindings.push_back(VarBinding(binding->var, value));
+      }
+    }
+    return DataflowBlock(new_bindings);
+  }
+
+  String strategy_;
+  int64_t memory_budget_;
+  std::unordered_set<const VarNode*> params_;
+};
+
+}  // namespace
+
+namespace transform {
+
+Pass AnnotateCheckpoints(String strategy, int64_t memory_budget) {
+  CHECK(strategy == "sqrt" || strategy == "budget")
+      << "ValueError: The strategy of AnnotateCheckpoints should be \"sqrt\" or \"budget\", "
+      << "but got " << strategy;
+  CHECK(strategy != "budget" || memory_budget >= 0)
+      << "ValueError: The \"budget\" strategy requires a non-negative memory budget";
+  auto pass_func = [=](Function func, IRModule, PassContext) -> Function {
+    return CheckpointAnnotator(strategy, memory_budget).Run(func);
+  };
+  return CreateFunctionPass(/*pass_function=*/pass_func,
+                            /*opt_level=*/0,
+                            /*pass_name=*/"AnnotateCheckpoints",
+                            /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.AnnotateCheckpoints").set_body_typed(AnnotateCheckpoints);
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
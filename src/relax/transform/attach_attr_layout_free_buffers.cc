@@ -21,10 +21,13 @@
  * \brief Attach layout_free_buffers for layout-free buffers.
  */
 
+#include <tvm/relax/analysis.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/transform.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
+
 namespace tvm {
 namespace relax {
 
@@ -45,6 +48,8 @@ class AttrAttacher : public ExprMutator {
  private:
   explicit AttrAttacher(IRModule mod) : ExprMutator(mod), mod_(mod) {}
 
+  using ExprMutator::VisitBinding_;
+  using ExprMutator::VisitBindingBlock_;
   using ExprMutator::VisitExpr_;
   Expr VisitExpr_(const FunctionNode* op) final {
     if (auto opt_num_input = op->attrs.GetAttr<Integer>(attr::kNumInput)) {
@@ -57,6 +62,29 @@ class AttrAttacher : public ExprMutator {
     return ExprMutator::VisitExpr_(op);
   }
 
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    in_dataflow_block_ = true;
+    BindingBlock ret = ExprMutator::VisitBindingBlock_(block);
+    in_dataflow_block_ = false;
+    return ret;
+  }
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    ExprMutator::VisitBinding_(binding);
+    // A value computed only from the weights and constants is lifted by LiftTransformParams
+    // as well, e.g. a transposed weight, so that its layout is free as well.
+    if (!in_dataflow_block_) return;
+    Array<Var> free_vars = FreeVars(binding->value);
+    bool weight_derived =
+        !free_vars.empty() && std::all_of(free_vars.begin(), free_vars.end(), [&](const Var& var) {
+          return layout_free_exprs_.count(var.get()) != 0;
+        });
+    if (weight_derived) {
+      layout_free_exprs_.insert(binding->var.get());
+      layout_free_exprs_.insert(VisitExpr(binding->var).get());
+    }
+  }
+
   Expr VisitExpr_(const ConstantNode* op) final {
     layout_free_exprs_.insert(op);
     return ExprMutator::VisitExpr_(op);
@@ -95,6 +123,7 @@ class AttrAttacher : public ExprMutator {
  private:
   IRModule mod_;
   std::unordered_set<const ExprNode*> layout_free_exprs_;
+  bool in_dataflow_block_ = false;
 };
 namespace transform {
 
@@ -26,6 +26,11 @@
 #include <tvm/relax/op_attr_types.h>
 #include <tvm/relax/transform.h>
 
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include "../op/tensor/manipulate.h"
 #include "infer_layout_utils.h"
 #include "utils.h"
@@ -35,6 +40,29 @@ namespace relax {
 
 using tir::Layout;
 
+namespace {
+
+/*! \brief The number of elements of a tensor, 0 if unknown. Symbolic dimensions count as 1. */
+double NumElements(const StructInfo& sinfo) {
+  const auto* tensor = sinfo.as<TensorStructInfoNode>();
+  const auto* shape =
+      tensor && tensor->shape.defined() ? tensor->shape.as<ShapeExprNode>() : nullptr;
+  if (!shape) return 0;
+  double num_elements = 1;
+  for (const PrimExpr& dim : shape->values) {
+    if (const auto* int_dim = dim.as<IntImmNode>()) num_elements *= int_dim->value;
+  }
+  return num_elements;
+}
+
+/*! \brief The number of bytes of a tensor, 0 if unknown. Symbolic dimensions count as 1. */
+double NumBytes(const TensorStructInfoNode* tensor) {
+  if (tensor->IsUnknownDtype()) return 0;
+  return NumElements(GetRef<StructInfo>(tensor)) * tensor->dtype.bytes();
+}
+
+}  // namespace
+
 /*!
  * \brief Main logic to convert the layout of conv2d. Other ops
  * can adapt to such layout conversion following conv2d accordingly.
@@ -71,11 +99,21 @@ using tir::Layout;
  *
  * Note that currently the layout conversion of conv2d only support axis swapping, such as NCHW to
  * NWHC. Packed layout such as NCHW to NCHW4c is not supported now.
+ *
+ * The calls in frozen_calls are not converted, and keep the initial layout like the ops without
+ * layout inference.
  */
 class LayoutConvertMutator : public ExprMutator {
  public:
-  explicit LayoutConvertMutator(const Map<String, Array<String>>& desired_layouts)
-      : desired_layouts_(desired_layouts) {}
+  explicit LayoutConvertMutator(const Map<String, Array<String>>& desired_layouts,
+                                std::unordered_set<const CallNode*> frozen_calls = {})
+      : desired_layouts_(desired_layouts), frozen_calls_(std::move(frozen_calls)) {}
+
+  /*!
+   * \brief The bytes of the tensors converted by the layout transforms of the rewriting, except
+   *  the constants, whose transforms are folded at compile time.
+   */
+  double transform_bytes() const { return transform_bytes_; }
 
  private:
   Array<Integer> LayoutToIntegers(const Layout& layout) {
@@ -99,6 +137,9 @@ class LayoutConvertMutator : public ExprMutator {
       ICHECK(tensor != nullptr) << "Expect a tensor, but got: " << expr;
       Layout axes = TransposeLike(InitialLayoutDecision(tensor->ndim)->layout,
                                   from.LeafValue()->layout, to.LeafValue()->layout);
+      if (!expr->IsInstance<ConstantNode>()) {
+        transform_bytes_ += NumBytes(tensor);
+      }
       return permute_dims(expr, LayoutToIntegers(axes));
     };
     return TransformTupleLeaf<LayoutDecision>(
@@ -166,7 +207,7 @@ class LayoutConvertMutator : public ExprMutator {
                                                  const Map<String, Array<String>>& desired_layouts,
                                                  const VarLayoutMap& var_layout_map) {
     const OpNode* op_node = call_node->op.as<OpNode>();
-    if (op_node == nullptr) return NullOpt;
+    if (op_node == nullptr || frozen_calls_.count(call_node)) return NullOpt;
     Op op = Downcast<Op>(GetRef<Op>(op_node));
     const auto attr_map = Op::GetAttrMap<FRelaxInferLayout>("FRelaxInferLayout");
     if (attr_map.count(op) && !HasUnknownDimTensor(call_node->args)) {
@@ -298,6 +339,8 @@ class LayoutConvertMutator : public ExprMutator {
 
   std::unordered_map<Var, NLayout> var_layout_map_;
   Map<String, Array<String>> desired_layouts_;
+  std::unordered_set<const CallNode*> frozen_calls_;
+  double transform_bytes_ = 0;
 };  // namespace relax
 
 DataflowBlock ConvertLayoutPass(const DataflowBlock& df_block,
@@ -306,6 +349,154 @@ DataflowBlock ConvertLayoutPass(const DataflowBlock& df_block,
   return Downcast<DataflowBlock>(mutator.VisitBindingBlock(df_block));
 }
 
+/*!
+ * \brief Choose the regions of a dataflow block converted to the desired layouts.
+ *
+ * A region is a set of calls with desired layouts (e.g. the conv2d of a CNN backbone) connected
+ * by the ops the layout propagates through. The calls of a region are converted or kept in the
+ * initial layout together. Starting from converting every region, like ConvertLayout, a region
+ * is kept in the initial layout when it lowers the estimated time of the block: the time of the
+ * kernels of the calls, faster by layout_speedup when converted, plus the time of the layout
+ * transforms the rewriting inserts, e.g. at the boundaries with the matmuls of a transformer.
+ */
+class LayoutCostPlanner {
+ public:
+  LayoutCostPlanner(DataflowBlock block, Map<String, Array<String>> desired_layouts,
+                    double layout_speedup, double gflops, double transform_gbps)
+      : block_(std::move(block)),
+        desired_layouts_(std::move(desired_layouts)),
+        layout_speedup_(layout_speedup),
+        gflops_(gflops),
+        transform_gbps_(transform_gbps) {}
+
+  /*! \return The calls kept in the initial layout. */
+  std::unordered_set<const CallNode*> Plan() {
+    std::vector<std::vector<const CallNode*>> regions = CollectRegions();
+    std::unordered_set<const CallNode*> frozen;
+    double best_cost = Cost(frozen);
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (const std::vector<const CallNode*>& region : regions) {
+        bool is_frozen = frozen.count(region[0]);
+        std::unordered_set<const CallNode*> candidate = frozen;
+        for (const CallNode* call : region) {
+          if (is_frozen) {
+            candidate.erase(call);
+          } else {
+            candidate.insert(call);
+          }
+        }
+        double cost = Cost(candidate);
+        if (cost < best_cost) {
+          best_cost = cost;
+          frozen = std::move(candidate);
+          changed = true;
+        }
+      }
+    }
+    return frozen;
+  }
+
+ private:
+  /*! \brief Group the calls with desired layouts by the dataflow the layout propagates along. */
+  std::vector<std::vector<const CallNode*>> CollectRegions() {
+    const auto attr_map = Op::GetAttrMap<FRelaxInferLayout>("FRelaxInferLayout");
+    std::vector<const CallNode*> calls;
+    std::unordered_map<const CallNode*, const VarNode*> call_var;
+    for (const Binding& binding : block_->bindings) {
+      const auto* var_binding = binding.as<VarBindingNode>();
+      if (!var_binding) continue;
+      const VarNode* var = binding->var.get();
+      Find(var);
+      Array<Expr> operands;
+      if (const auto* call = var_binding->value.as<CallNode>()) {
+        const auto* op = call->op.as<OpNode>();
+        if (!op || !attr_map.count(GetRef<Op>(op))) continue;
+        if (desired_layouts_.count(op->name)) {
+          calls.push_back(call);
+          call_var[call] = var;
+        }
+        operands = call->args;
+      } else if (const auto* tuple = var_binding->value.as<TupleNode>()) {
+        // The fields of the outputs are converted to the initial layout separately.
+        if (!binding->var->IsInstance<DataflowVarNode>()) continue;
+        operands = tuple->fields;
+      } else if (const auto* get_item = var_binding->value.as<TupleGetItemNode>()) {
+        operands = {get_item->tuple};
+      }
+      for (const Expr& operand : operands) {
+        PostOrderVisit(operand, [&](const Expr& expr) {
+          if (const auto* operand_var = expr.as<VarNode>()) {
+            Union(var, operand_var);
+          }
+        });
+      }
+    }
+    std::unordered_map<const VarNode*, size_t> region_index;
+    std::vector<std::vector<const CallNode*>> regions;
+    for (const CallNode* call : calls) {
+      const VarNode* root = Find(call_var[call]);
+      auto it = region_index.emplace(root, regions.size()).first;
+      if (it->second == regions.size()) regions.emplace_back();
+      regions[it->second].push_back(call);
+    }
+    return regions;
+  }
+
+  const VarNode* Find(const VarNode* var) {
+    auto it = parent_.emplace(var, var).first;
+    if (it->second != var) it->second = Find(it->second);
+    return it->second;
+  }
+
+  void Union(const VarNode* a, const VarNode* b) { parent_[Find(a)] = Find(b); }
+
+  /*! \brief The estimated time of the kernels and the layout transforms, in seconds. */
+  double Cost(const std::unordered_set<const CallNode*>& frozen) {
+    LayoutConvertMutator mutator(desired_layouts_, frozen);
+    mutator.VisitBindingBlock(block_);
+    // A layout transform reads and writes its tensor once.
+    double cost = 2 * mutator.transform_bytes() / (transform_gbps_ * 1e9);
+    for (const Binding& binding : block_->bindings) {
+      const auto* var_binding = binding.as<VarBindingNode>();
+      const auto* call = var_binding ? var_binding->value.as<CallNode>() : nullptr;
+      const auto* op = call ? call->op.as<OpNode>() : nullptr;
+      if (!op || !desired_layouts_.count(op->name)) continue;
+      double flops = EstimateFlops(GetRef<Call>(call), GetStructInfo(binding->var));
+      double time = flops / (gflops_ * 1e9);
+      cost += frozen.count(call) ? time : time / layout_speedup_;
+    }
+    return cost;
+  }
+
+  /*!
+   * \brief The floating-point operations of a call: twice the multiply-adds of a convolution,
+   *  one per output element of the others.
+   */
+  static double EstimateFlops(const Call& call, const StructInfo& out_sinfo) {
+    double outputs = NumElements(out_sinfo);
+    if (Downcast<Op>(call->op)->name.rfind("relax.nn.conv", 0) == 0 && call->args.size() >= 2) {
+      // The multiply-adds of an output element are those of one output channel of the weight,
+      // the first axis of the initial kernel layout.
+      const auto* weight = GetStructInfoAs<TensorStructInfoNode>(call->args[1]);
+      const auto* shape = weight ? weight->shape.as<ShapeExprNode>() : nullptr;
+      const auto* out_channels =
+          shape && !shape->values.empty() ? shape->values[0].as<IntImmNode>() : nullptr;
+      if (out_channels && out_channels->value > 0) {
+        return 2 * outputs * NumElements(GetRef<StructInfo>(weight)) / out_channels->value;
+      }
+    }
+    return outputs;
+  }
+
+  DataflowBlock block_;
+  Map<String, Array<String>> desired_layouts_;
+  double layout_speedup_;
+  double gflops_;
+  double transform_gbps_;
+  std::unordered_map<const VarNode*, const VarNode*> parent_;
+};
+
 namespace transform {
 
 Pass ConvertLayout(Map<String, Array<String>> desired_layouts) {
@@ -318,6 +509,26 @@ Pass ConvertLayout(Map<String, Array<String>> desired_layouts) {
 
 TVM_REGISTER_GLOBAL("relax.transform.ConvertLayout").set_body_typed(ConvertLayout);
 
+Pass ConvertLayoutByCost(Map<String, Array<String>> desired_layouts, double layout_speedup,
+                         double gflops, double transform_gbps) {
+  CHECK_GT(layout_speedup, 0) << "ValueError: The layout speedup must be positive, but got "
+                              << layout_speedup;
+  CHECK_GT(gflops, 0) << "ValueError: The GFLOPS must be positive, but got " << gflops;
+  CHECK_GT(transform_gbps, 0) << "ValueError: The transform bandwidth must be positive, but got "
+                              << transform_gbps;
+  runtime::TypedPackedFunc<DataflowBlock(DataflowBlock, IRModule, PassContext)> pass_func =
+      [=](DataflowBlock df_block, IRModule m, PassContext pc) {
+        std::unordered_set<const CallNode*> frozen_calls =
+            LayoutCostPlanner(df_block, desired_layouts, layout_speedup, gflops, transform_gbps)
+                .Plan();
+        LayoutConvertMutator mutator(desired_layouts, std::move(frozen_calls));
+        return Downcast<DataflowBlock>(mutator.VisitBindingBlock(df_block));
+      };
+  return CreateDataflowBlockPass(pass_func, 0, "ConvertLayoutByCost", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.ConvertLayoutByCost").set_body_typed(ConvertLayoutByCost);
+
 }  // namespace transform
 }  // namespace relax
 }  // namespace tvm
@@ -41,7 +41,10 @@ namespace relax {
 // pairs of indices (the liveness interval, from the starting index to the end index).
 // A starting index of -1 means the var is defined before the block starts and an end index
 // of block->bindings.size() (one past the last index) means it is live after the block ends.
-std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock& block) {
+// The non-dataflow vars in local_vars are known not to be used after the block, e.g. the donated
+// parameters of the function whose uses all lie in the block.
+std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(
+    const DataflowBlock& block, const std::unordered_set<Var>& local_vars = {}) {
   std::unordered_map<Var, std::pair<int, int>> ret;
   for (int i = block->bindings.size() - 1; i >= 0; i--) {
     Binding b = block->bindings[i];
@@ -66,7 +69,7 @@ std::unordered_map<Var, std::pair<int, int>> AnalyzeLiveness(const DataflowBlock
       int range_end = i;
       // if the var is not a dataflow var, then it is live
       // after the block (we are not checking later blocks)
-      if (!var.as<DataflowVarNode>()) {
+      if (!var.as<DataflowVarNode>() && !local_vars.count(var)) {
         range_end = block->bindings.size();
       }
       if (!ret.count(var)) {
@@ -557,13 +560,14 @@ class InplaceOpportunity : public ObjectRef {
 //    matches the size of the result.
 // 2. A list of bindings where at least one argument meets the in-place conditions
 //    and *exactly* matches the shape of the result.
+// The non-dataflow vars in local_vars are not used after the block, see AnalyzeLiveness.
 // For both lists, each element is a list of ints of the following format:
 //   The first element is the index of the *binding* in the block.
 //   All remaining elements are the indices of *eligible arguments* in that call.
 std::pair<std::vector<InplaceOpportunity>, std::vector<InplaceOpportunity>>
 FindInplaceOpportunities(const DataflowBlock& block, const Array<Var>& inputs,
-                         const BlockBuilder& ctx) {
-  auto live_ranges = AnalyzeLiveness(block);
+                         const BlockBuilder& ctx, const std::unordered_set<Var>& local_vars = {}) {
+  auto live_ranges = AnalyzeLiveness(block, local_vars);
   AliasAnalyzer analyzer;
   auto alias_info = analyzer.Analyze(block, inputs);
   auto alias_sets = alias_info.first;
@@ -771,6 +775,25 @@ tir::Stmt RemapBuffers(const tir::Stmt& stmt, const Map<tir::Buffer, tir::Buffer
   return ret;
 }
 
+// Count the occurrences of the given vars, in nested functions and control flow as well.
+class VarUseCounter : public ExprVisitor {
+ public:
+  explicit VarUseCounter(const std::unordered_set<Var>& vars) : vars_(vars) {}
+
+  std::unordered_map<Var, int> counts;
+
+  using ExprVisitor::VisitExpr_;
+  void VisitExpr_(const VarNode* op) override {
+    auto var = GetRef<Var>(op);
+    if (vars_.count(var)) {
+      counts[var]++;
+    }
+  }
+
+ private:
+  const std::unordered_set<Var>& vars_;
+};
+
 class ModuleInplaceTransformer : public ExprMutator {
  public:
   explicit ModuleInplaceTransformer(const IRModule& mod) : mod_(mod) {
@@ -798,22 +821,65 @@ class ModuleInplaceTransformer : public ExprMutator {
 
   Expr VisitExpr_(const FunctionNode* op) override {
     auto old_func_params = func_params;
+    auto old_donated_uses = donated_uses;
     func_params = op->params;
+    donated_uses = CountDonatedUses(GetRef<Function>(op));
     auto ret = ExprMutator::VisitExpr_(op);
     func_params = old_func_params;
+    donated_uses = old_donated_uses;
     return ret;
   }
 
+  // Count the uses of the donated tensor parameters in the whole function.
+  std::unordered_map<Var, int> CountDonatedUses(const Function& func) {
+    std::unordered_set<Var> donated;
+    if (auto indices = func->GetAttr<Array<Integer>>(attr::kDonatedParams)) {
+      for (const Integer& index : indices.value()) {
+        CHECK(index->value >= 0 && index->value < static_cast<int64_t>(func->params.size()))
+            << "ValueError: The donated parameter index " << index << " is out of range for a "
+            << "function of " << func->params.size() << " parameters";
+        Var param = func->params[index->value];
+        if (GetStructInfoAs<TensorStructInfoNode>(param)) {
+          donated.insert(param);
+        }
+      }
+    }
+    if (donated.empty()) return {};
+    VarUseCounter counter(donated);
+    counter.VisitExpr(func->body);
+    return counter.counts;
+  }
+
   // the only case we will override: we will visit all binding blocks
   // and replace any valid calls in them
   BindingBlock VisitBindingBlock_(const DataflowBlockNode* op) override {
     auto block = GetRef<DataflowBlock>(op);
     auto old_idxs = inplace_idxs;
 
+    // A donated parameter whose uses all lie in this block is dead after the block, even across
+    // control flow, so it is treated as a non-aliased value local to the block. Other than
+    // these, we can't make any assumptions about the input values.
+    Array<Var> inputs;
+    std::unordered_set<Var> local_vars;
+    if (!donated_uses.empty()) {
+      std::unordered_set<Var> donated;
+      for (auto kv : donated_uses) {
+        donated.insert(kv.first);
+      }
+      VarUseCounter counter(donated);
+      for (const Binding& binding : block->bindings) {
+        counter.VisitBinding(binding);
+      }
+      for (auto kv : counter.counts) {
+        if (kv.second == donated_uses.at(kv.first)) {
+          inputs.push_back(kv.first);
+          local_vars.insert(kv.first);
+        }
+      }
+    }
+
     // For now, only handle exact match cases.
-    // Note: Not passing any input values for now, as we can't make any assumptions
-    // about them.
-    auto matches_found = FindInplaceOpportunities(block, {}, builder_);
+    auto matches_found = FindInplaceOpportunities(block, inputs, builder_, local_vars);
     Map<Binding, Array<Integer>> new_idxs;
     for (auto match : matches_found.second) {
       new_idxs.Set(block->bindings[match->binding_idx.IntValue()], match->arg_idxs);
@@ -953,6 +1019,8 @@ class ModuleInplaceTransformer : public ExprMutator {
   // The current function's params will be treated as non-aliased
   // (we are assuming good behavior on the user's part).
   Array<Var> func_params;
+  // The number of uses of the current function's donated parameters.
+  std::unordered_map<Var, int> donated_uses;
   // map of eligible bindings to indices of arguments that can be used as the in-place target
   Map<Binding, Array<Integer>> inplace_idxs;
 };
@@ -33,12 +33,19 @@
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/struct_info.h>
 #include <tvm/relax/transform.h>
+#include <tvm/target/target.h>
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/expr_functor.h>
 #include <tvm/tir/function.h>
+#include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
+#include <map>
 #include <optional>
+#include <sstream>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 #include "../../relay/analysis/graph_partitioner.h"
 #include "../../support/arena.h"
@@ -86,6 +93,11 @@ namespace relax {
       will still run correctly.
   - CommitFuse: mark all the nodes between source and post-dominator as the same group.
   - We use an Union-Find data structure to manage the groups.
+
+  With the pass config `relax.FuseOps.cost_model` enabled, each legal fusion is additionally
+  scored by FusionCostModel, and the independent groups reading the same tensor are fused
+  horizontally afterwards. The decisions are attached to the module as the attribute
+  `relax.FuseOps.decisions`.
 */
 
 using relay::GraphPartitioner;
@@ -94,8 +106,16 @@ using relay::OpPatternKind;
 using support::LinkNode;
 
 constexpr uint32_t kMaxFusedOps = 256;
+/*! \brief The default memory bandwidth (GB/s) and compute throughput (GFLOP/s) of FuseOps. */
+constexpr int kMemoryBandwidth = 1000;
+constexpr int kComputeThroughput = 20000;
+constexpr int kCPUMemoryBandwidth = 100;
+constexpr int kCPUComputeThroughput = 2000;
 
 TVM_REGISTER_PASS_CONFIG_OPTION("relax.FuseOps.max_depth", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.FuseOps.cost_model", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.FuseOps.memory_bandwidth", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.FuseOps.compute_throughput", Integer);
 
 class GraphCreator : public ExprVisitor {
  public:
@@ -1033,19 +1053,335 @@ class OperatorFusor : public ExprMutator {
   bool lift_constants_{true};
 };
 
-IRModule FuseOps(IRModule mod, int opt_level, size_t max_fuse_depth) {
+/*!
+ * \brief The cost model deciding whether a fusion is profitable.
+ * \details Fusing a producer into its consumers saves writing the intermediate tensor and reading
+ * it back. But once the producer is inlined, it is recomputed for every access of the consumers,
+ * e.g. an elementwise producer of a matmul operand is recomputed for every output column. A
+ * fusion is accepted if the saved memory traffic at the memory bandwidth takes no less time than
+ * the extra computation at the compute throughput.
+ *
+ * Besides, independent groups of injective ops reading the same tensor are fused horizontally,
+ * so that the tensor is only read once.
+ */
+class FusionCostModel : private ExprVisitor {
+ public:
+  using Group = GraphPartitioner::Group;
+
+  /*!
+   * \param mod The IRModule to be fused.
+   * \param memory_bandwidth The memory bandwidth of the target in GB/s.
+   * \param compute_throughput The compute throughput of the target in GFLOP/s.
+   */
+  FusionCostModel(IRModule mod, int64_t memory_bandwidth, int64_t compute_throughput)
+      : mod_(std::move(mod)),
+        memory_bandwidth_(static_cast<double>(memory_bandwidth) * 1e9),
+        compute_throughput_(static_cast<double>(compute_throughput) * 1e9) {
+    CHECK_GT(memory_bandwidth, 0) << "ValueError: The memory bandwidth should be positive, but got "
+                                  << memory_bandwidth;
+    CHECK_GT(compute_throughput, 0)
+        << "ValueError: The compute throughput should be positive, but got " << compute_throughput;
+    for (const auto& [gv, base_func] : mod_->functions) {
+      const auto* func = base_func.as<FunctionNode>();
+      if (func == nullptr || func->HasNonzeroAttr(attr::kPrimitive) ||
+          func->GetAttr<String>(attr::kCodegen).defined()) {
+        continue;
+      }
+      VisitExpr(GetRef<Function>(func));
+    }
+  }
+
+  /*!
+   * \brief Check whether fusing a node into its post-dominator is profitable.
+   * \param src The node to be fused.
+   * \param sink The post-dominator of the node.
+   * \return Whether the fusion is accepted.
+   */
+  bool CheckFuse(const IndexedForwardGraph::Node* src, const IndexedForwardGraph::Node* sink) {
+    auto key = std::make_pair(src, sink);
+    if (auto it = decision_cache_.find(key); it != decision_cache_.end()) {
+      return it->second;
+    }
+    Array<Expr> args;
+    Optional<tir::PrimFunc> func = GetCallTIRFunc(src->ref, &args);
+    std::optional<std::pair<int64_t, int64_t>> size = GetStaticTensorSize(src->ref);
+    if (!func.defined() || !size.has_value()) {
+      // Tuples, tuple items and dynamically shaped tensors are fused as without the cost model.
+      decision_cache_[key] = true;
+      return true;
+    }
+    auto [num_elements, num_bytes] = size.value();
+    double producer_flops = EstimateFlops(func.value());
+    // The intermediate tensor is written once and read by each consumer.
+    double saved_bytes = static_cast<double>(num_bytes);
+    double recompute_flops = 0;
+    for (auto* link = src->outputs.head; link != nullptr; link = link->next) {
+      saved_bytes += static_cast<double>(num_bytes);
+      double num_loads = CountLoads(link->value.node->ref, src->ref);
+      double reuse = num_loads / static_cast<double>(std::max<int64_t>(num_elements, 1));
+      if (reuse > 1) {
+        recompute_flops += producer_flops * (reuse - 1);
+      }
+    }
+    bool accept = saved_bytes / memory_bandwidth_ >= recompute_flops / compute_throughput_;
+    std::ostringstream os;
+    os << (accept ? "fuse " : "reject ") << NodeName(src) << " into " << NodeName(sink)
+       << ": saved_bytes=" << saved_bytes << ", recompute_flops=" << recompute_flops;
+    decisions.push_back(os.str());
+    decision_cache_[key] = accept;
+    return accept;
+  }
+
+  /*!
+   * \brief Fuse the independent groups of injective ops that read the same tensor.
+   * \param graph The indexed-forward graph.
+   * \param groups The groups after the vertical fusion, updated in place.
+   * \param max_fuse_depth The maximum number of ops in a group.
+   */
+  void FuseHorizontally(const IndexedForwardGraph& graph, const std::vector<Group*>& groups,
+                        size_t max_fuse_depth) {
+    for (const IndexedForwardGraph::Node* input : graph.post_dfs_order) {
+      std::vector<Group*> candidates;
+      for (auto* link = input->outputs.head; link != nullptr; link = link->next) {
+        const IndexedForwardGraph::Node* consumer = link->value.node;
+        Group* group = groups[consumer->index]->FindRoot();
+        if (!GetCallTIRFunc(consumer->ref, nullptr).defined() ||
+            group->pattern > relay::kInjective || HasExternRef(graph, groups, group) ||
+            std::find(candidates.begin(), candidates.end(), group) != candidates.end()) {
+          continue;
+        }
+        candidates.push_back(group);
+      }
+      // The edges are pushed to the front, visit the consumers in the order of definition.
+      std::reverse(candidates.begin(), candidates.end());
+      for (size_t i = 0; i < candidates.size(); ++i) {
+        Group* target = candidates[i]->FindRoot();
+        for (size_t j = i + 1; j < candidates.size(); ++j) {
+          Group* group = candidates[j]->FindRoot();
+          if (group == target || target->num_nodes + group->num_nodes > max_fuse_depth ||
+              var2block_[target->root_ref] != var2block_[group->root_ref] ||
+              var2block_[target->root_ref] == nullptr ||
+              Reachable(graph, groups, target, group) || Reachable(graph, groups, group, target)) {
+            continue;
+          }
+          group->parent = target;
+          target->num_nodes += group->num_nodes;
+          target->pattern = std::max(target->pattern, group->pattern);
+          std::optional<std::pair<int64_t, int64_t>> size = GetStaticTensorSize(input->ref);
+          std::ostringstream os;
+          os << "horizontally fuse " << NodeName(graph.node_map.at(group->root_ref)) << " into "
+             << NodeName(graph.node_map.at(target->root_ref)) << " on " << NodeName(input)
+             << ": saved_bytes=" << (size.has_value() ? size->second : 0);
+          decisions.push_back(os.str());
+        }
+      }
+    }
+  }
+
+  /*! \brief The fusion decisions in the order they are made. */
+  Array<String> decisions;
+
+ private:
+  using ExprVisitor::VisitBinding_;
+  using ExprVisitor::VisitBindingBlock_;
+
+  void VisitBindingBlock_(const DataflowBlockNode* block) final {
+    cur_block_ = block;
+    ExprVisitor::VisitBindingBlock_(block);
+    cur_block_ = nullptr;
+  }
+
+  void VisitBinding_(const VarBindingNode* binding) final {
+    var2value_[binding->var.get()] = binding->value;
+    var2block_[binding->var.get()] = cur_block_;
+    ExprVisitor::VisitBinding_(binding);
+  }
+
+  /*!
+   * \brief Get the PrimFunc called by the binding of a variable via call_tir.
+   * \param ref The bound variable.
+   * \param args If not nullptr, set to the arguments of the PrimFunc.
+   */
+  Optional<tir::PrimFunc> GetCallTIRFunc(const Object* ref, Array<Expr>* args) {
+    static const Op& call_tir_op = Op::Get("relax.call_tir");
+    static const Op& call_tir_inplace_op = Op::Get("relax.call_tir_inplace");
+    auto it = var2value_.find(ref);
+    if (it == var2value_.end()) {
+      return NullOpt;
+    }
+    const auto* call = it->second.as<CallNode>();
+    if (call == nullptr ||
+        !(call->op.same_as(call_tir_op) || call->op.same_as(call_tir_inplace_op))) {
+      return NullOpt;
+    }
+    auto func = mod_->Lookup(Downcast<GlobalVar>(call->args[0])).as<tir::PrimFunc>();
+    if (func.defined() && args != nullptr) {
+      *args = Downcast<Tuple>(call->args[1])->fields;
+    }
+    return func;
+  }
+
+  /*! \brief Get the number of elements and bytes of a statically shaped tensor variable. */
+  static std::optional<std::pair<int64_t, int64_t>> GetStaticTensorSize(const Object* ref) {
+    const auto* var = ref->IsInstance<VarNode>() ? static_cast<const VarNode*>(ref) : nullptr;
+    const auto* sinfo = var ? var->struct_info_.as<TensorStructInfoNode>() : nullptr;
+    if (sinfo == nullptr || sinfo->dtype.is_void()) return std::nullopt;
+    const auto* shape = sinfo->shape.as<ShapeExprNode>();
+    if (shape == nullptr) return std::nullopt;
+    int64_t num_elements = 1;
+    for (const PrimExpr& dim : shape->values) {
+      const auto* int_dim = dim.as<IntImmNode>();
+      if (int_dim == nullptr) return std::nullopt;
+      num_elements *= int_dim->value;
+    }
+    return std::make_pair(num_elements, num_elements * sinfo->dtype.bytes() * sinfo->dtype.lanes());
+  }
+
+  /*! \brief Count the total number of loads of a variable by the PrimFunc of a consumer. */
+  double CountLoads(const Object* consumer_ref, const Object* var) {
+    Array<Expr> args;
+    Optional<tir::PrimFunc> opt_func = GetCallTIRFunc(consumer_ref, &args);
+    if (!opt_func.defined()) return 0;
+    tir::PrimFunc func = opt_func.value();
+    double num_loads = 0;
+    for (int i = 0; i < static_cast<int>(args.size()); ++i) {
+      if (args[i].get() != var || i >= static_cast<int>(func->params.size())) continue;
+      if (Optional<tir::Buffer> buffer = func->buffer_map.Get(func->params[i])) {
+        num_loads += LoadCounter::Count(func->body, buffer.value()->data.get());
+      }
+    }
+    return num_loads;
+  }
+
+  /*! \brief Count the loads of a buffer, weighted by the extents of the enclosing loops. */
+  class LoadCounter : public tir::StmtExprVisitor {
+   public:
+    static double Count(const tir::Stmt& body, const tir::VarNode* data) {
+      LoadCounter counter(data);
+      counter(body);
+      return counter.num_loads_;
+    }
+
+   private:
+    explicit LoadCounter(const tir::VarNode* data) : data_(data) {}
+
+    void VisitStmt_(const tir::ForNode* loop) final {
+      const auto* extent = loop->extent.as<IntImmNode>();
+      double scale = scale_;
+      scale_ *= extent != nullptr ? static_cast<double>(extent->value) : 1.0;
+      tir::StmtExprVisitor::VisitStmt_(loop);
+      scale_ = scale;
+    }
+
+    void VisitExpr_(const tir::BufferLoadNode* load) final {
+      if (load->buffer->data.get() == data_) {
+        num_loads_ += scale_;
+      }
+      tir::StmtExprVisitor::VisitExpr_(load);
+    }
+
+    const tir::VarNode* data_;
+    double scale_{1.0};
+    double num_loads_{0};
+  };
+
+  double EstimateFlops(const tir::PrimFunc& func) {
+    auto [it, inserted] = func2flops_.insert({func.get(), 0.0});
+    if (inserted) {
+      it->second = tir::EstimateTIRFlops(func->body);
+    }
+    return it->second;
+  }
+
+  /*! \brief Whether any node of the group is referenced outside of its dataflow block. */
+  static bool HasExternRef(const IndexedForwardGraph& graph, const std::vector<Group*>& groups,
+                           Group* group) {
+    for (size_t nid = 0; nid < groups.size(); ++nid) {
+      if (graph.post_dfs_order[nid]->extern_ref && groups[nid]->FindRoot() == group) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /*! \brief Whether any node of the group dst is reachable from the nodes of the group src. */
+  static bool Reachable(const IndexedForwardGraph& graph, const std::vector<Group*>& groups,
+                        Group* src, Group* dst) {
+    std::vector<const IndexedForwardGraph::Node*> stack;
+    std::unordered_set<const IndexedForwardGraph::Node*> visited;
+    for (size_t nid = 0; nid < groups.size(); ++nid) {
+      if (groups[nid]->FindRoot() == src) {
+        stack.push_back(graph.post_dfs_order[nid]);
+      }
+    }
+    while (!stack.empty()) {
+      const IndexedForwardGraph::Node* node = stack.back();
+      stack.pop_back();
+      for (auto* link = node->outputs.head; link != nullptr; link = link->next) {
+        const IndexedForwardGraph::Node* next = link->value.node;
+        if (groups[next->index]->FindRoot() == dst) return true;
+        if (visited.insert(next).second) stack.push_back(next);
+      }
+    }
+    return false;
+  }
+
+  static String NodeName(const IndexedForwardGraph::Node* node) {
+    if (node->ref->IsInstance<VarNode>()) {
+      return static_cast<const VarNode*>(node->ref)->name_hint();
+    }
+    return "constant";
+  }
+
+  /*! \brief The IRModule to be fused. */
+  IRModule mod_;
+  /*! \brief The memory bandwidth in bytes per second. */
+  double memory_bandwidth_;
+  /*! \brief The compute throughput in FLOPs per second. */
+  double compute_throughput_;
+  /*! \brief The mapping from each bound variable to its value and its dataflow block. */
+  std::unordered_map<const Object*, Expr> var2value_;
+  std::unordered_map<const Object*, const DataflowBlockNode*> var2block_;
+  /*! \brief The dataflow block being visited. */
+  const DataflowBlockNode* cur_block_{nullptr};
+  /*! \brief The estimated FLOPs of each PrimFunc. */
+  std::unordered_map<const tir::PrimFuncNode*, double> func2flops_;
+  /*! \brief The decisions made so far, as CheckFuse may be asked again in a later phase. */
+  std::map<std::pair<const IndexedForwardGraph::Node*, const IndexedForwardGraph::Node*>, bool>
+      decision_cache_;
+};
+
+IRModule FuseOps(IRModule mod, int opt_level, size_t max_fuse_depth, bool use_cost_model,
+                 int64_t memory_bandwidth, int64_t compute_throughput) {
   support::Arena arena;
 
   // Step 1. Create the indexed-forward graph according to the input IRModule.
   IndexedForwardGraph graph = GraphCreator::Create(mod, &arena);
 
-  // Step 2. Partition the graph by applying the fusion algorithm.
+  // Step 2. Partition the graph by applying the fusion algorithm, with the fusions scored by the
+  // cost model if it is enabled.
+  std::optional<FusionCostModel> cost_model;
+  GraphPartitioner::FCheckFuse fcheck_fuse = nullptr;
+  if (use_cost_model) {
+    cost_model.emplace(mod, memory_bandwidth, compute_throughput);
+    fcheck_fuse = [&cost_model](IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink) {
+      return cost_model->CheckFuse(src, sink);
+    };
+  }
   std::vector<GraphPartitioner::Group*> groups =
-      GraphPartitioner(&arena, opt_level, max_fuse_depth, /*max_function_args=*/0).Partition(graph);
+      GraphPartitioner(&arena, opt_level, max_fuse_depth, /*max_function_args=*/0, fcheck_fuse)
+          .Partition(graph);
+  if (cost_model.has_value() && opt_level > 0) {
+    cost_model->FuseHorizontally(graph, groups, max_fuse_depth);
+  }
 
   // Step 3. Transform the IRModule by fusing the operators in accordance with the graph partition
   // results.
-  return OperatorFusor(mod, graph, groups, /*lift_constants*/ true).Transform();
+  IRModule result = OperatorFusor(mod, graph, groups, /*lift_constants*/ true).Transform();
+  if (cost_model.has_value()) {
+    result = WithAttr(std::move(result), "relax.FuseOps.decisions", cost_model->decisions);
+  }
+  return result;
 }
 
 IRModule MakeGroupedFunctions(
@@ -1054,6 +1390,49 @@ IRModule MakeGroupedFunctions(
   return OperatorFusor(mod, partition, lift_constants).Transform(entry_function_names);
 }
 
+/*!
+ * \brief Collect the operators of the calls a pattern can match at its root, which index the
+ * bindings the pattern has to be tried on.
+ * \return The operators, or std::nullopt if the pattern can match a call of any callee.
+ */
+std::optional<std::unordered_set<const OpNode*>> RootOpsOfPattern(const DFPattern& pattern) {
+  if (const auto* call = pattern.as<CallPatternNode>()) {
+    const auto* op_pattern = call->op.as<ExprPatternNode>();
+    const auto* op = op_pattern ? op_pattern->expr.as<OpNode>() : nullptr;
+    if (op == nullptr) return std::nullopt;
+    std::unordered_set<const OpNode*> ops{op};
+    // The matcher associates multiply and divide, a pattern rooted at one can match the other.
+    static const Op& multiply_op = Op::Get("relax.multiply");
+    static const Op& divide_op = Op::Get("relax.divide");
+    if (op == multiply_op.get() || op == divide_op.get()) {
+      ops.insert(multiply_op.get());
+      ops.insert(divide_op.get());
+    }
+    return ops;
+  } else if (const auto* or_pattern = pattern.as<OrPatternNode>()) {
+    auto left = RootOpsOfPattern(or_pattern->left);
+    auto right = RootOpsOfPattern(or_pattern->right);
+    if (!left || !right) return std::nullopt;
+    left->insert(right->begin(), right->end());
+    return left;
+  } else if (const auto* and_pattern = pattern.as<AndPatternNode>()) {
+    // Both sides have to match, so either of them bounds the operators.
+    auto left = RootOpsOfPattern(and_pattern->left);
+    return left ? left : RootOpsOfPattern(and_pattern->right);
+  } else if (const auto* attr_pattern = pattern.as<AttrPatternNode>()) {
+    return RootOpsOfPattern(attr_pattern->pattern);
+  } else if (const auto* dtype_pattern = pattern.as<DataTypePatternNode>()) {
+    return RootOpsOfPattern(dtype_pattern->pattern);
+  } else if (const auto* shape_pattern = pattern.as<ShapePatternNode>()) {
+    return RootOpsOfPattern(shape_pattern->pattern);
+  } else if (const auto* sinfo_pattern = pattern.as<StructInfoPatternNode>()) {
+    return RootOpsOfPattern(sinfo_pattern->pattern);
+  } else if (const auto* type_pattern = pattern.as<TypePatternNode>()) {
+    return RootOpsOfPattern(type_pattern->pattern);
+  }
+  return std::nullopt;
+}
+
 /*! \brief Create a "partitioning", a map from interior / leaf expr to its representative group,
  * based on the provided pattern. The result can be passed to OperatorFusor above to fuse operations
  * in a group and create a grouped function.
@@ -1084,7 +1463,8 @@ class PatternBasedPartitioner : ExprVisitor {
         annotation_pat_(annotation_patterns),
         check_(check),
         arena_(arena),
-        attrs_getter_(attrs_getter) {}
+        attrs_getter_(attrs_getter),
+        root_ops_(RootOpsOfPattern(pattern)) {}
 
   void VisitBindingBlock_(const DataflowBlockNode* block) final {
     current_block_use_def_ = DataflowBlockUseDef(GetRef<DataflowBlock>(block));
@@ -1108,6 +1488,12 @@ class PatternBasedPartitioner : ExprVisitor {
 
   void VisitBinding_(const VarBindingNode* binding, const CallNode* call) final {
     VisitVarDef(binding->var);
+    if (root_ops_) {
+      // Skip the calls of other operators without running the matcher, which dominates the
+      // partitioning of large graphs otherwise.
+      const auto* op = call->op.as<OpNode>();
+      if (op == nullptr || !root_ops_->count(op)) return;
+    }
     if (auto matches_opt = ExtractMatchedExpr(pat_, GetRef<Call>(call), bindings_)) {
       const auto& context = CreatePatternCheckContext(call, matches_opt.value());
       if (check_ != nullptr && !check_(context)) {
@@ -1232,6 +1618,8 @@ class PatternBasedPartitioner : ExprVisitor {
   FCheckMatch check_;
   support::Arena* arena_;
   FAttrsGetter attrs_getter_;
+  /*! \brief The operators of the calls the pattern can match, std::nullopt for any. */
+  std::optional<std::unordered_set<const OpNode*>> root_ops_;
   Map<Var, Expr> bindings_;
   Map<Expr, Var> value_to_bound_var_;
   Map<Var, Array<Var>> current_block_use_def_;
@@ -1380,6 +1768,12 @@ IRModule FuseOpsByPattern(const tvm::Array<transform::FusionPattern>& patterns,
         group_map.insert({key, value});
       }
     }
+    // Rewriting the module is as costly as partitioning it, skip it when the pattern matched
+    // nothing.
+    bool matched = std::any_of(group_map.begin(), group_map.end(), [](const auto& kv) {
+      return kv.second->FindRoot()->attrs.count(attr::kComposite);
+    });
+    if (!matched) continue;
     mod = MakeGroupedFunctions(mod, group_map, /*lift_constants*/ !bind_constants,
                                entry_function_names);
   }
@@ -1430,7 +1824,20 @@ Pass FuseOps(int fuse_opt_level) {
       [=](IRModule m, PassContext pc) {
         int opt_level = fuse_opt_level == -1 ? pc->opt_level : fuse_opt_level;
         auto max_fuse_depth = pc->GetConfig("relax.FuseOps.max_depth", Integer(kMaxFusedOps));
-        return relax::FuseOps(m, opt_level, max_fuse_depth.value().IntValue());
+        bool use_cost_model =
+            pc->GetConfig<Bool>("relax.FuseOps.cost_model").value_or(Bool(false))->value;
+        // The defaults roughly match a discrete GPU, or a server CPU if the target is a CPU.
+        Target target = Target::Current(/*allow_not_defined=*/true);
+        bool is_cpu = target.defined() && target->GetTargetDeviceType() == kDLCPU;
+        auto memory_bandwidth =
+            pc->GetConfig("relax.FuseOps.memory_bandwidth",
+                          Integer(is_cpu ? kCPUMemoryBandwidth : kMemoryBandwidth));
+        auto compute_throughput =
+            pc->GetConfig("relax.FuseOps.compute_throughput",
+                          Integer(is_cpu ? kCPUComputeThroughput : kComputeThroughput));
+        return relax::FuseOps(m, opt_level, max_fuse_depth.value().IntValue(), use_cost_model,
+                              memory_bandwidth.value().IntValue(),
+                              compute_throughput.value().IntValue());
       };
   return CreateModulePass(/*pass_function=*/pass_func,  //
                           /*opt_level=*/0,              //
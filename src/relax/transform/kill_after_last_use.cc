@@ -104,8 +104,14 @@ class CollectLastUsage : public ExprVisitor {
 
     Result output;
     for (const auto* var : visitor.binding_order_) {
-      if (auto it = visitor.last_usage_of_.find(var); it != visitor.last_usage_of_.end()) {
-        const auto* last_usage_point = it->second;
+      auto it = visitor.last_usage_of_.find(var);
+      // A tensor or storage which is never used, e.g. the unused output of
+      // a packed function, is killed right after its own binding, as it
+      // would otherwise live until its register is overwritten.
+      bool is_unused = it == visitor.last_usage_of_.end();
+      if (!is_unused || var->struct_info_.as<TensorStructInfoNode>() ||
+          visitor.storage_objects_.count(var)) {
+        const auto* last_usage_point = is_unused ? var : it->second;
         bool is_output = last_usage_point == nullptr;
         bool already_killed = visitor.killed_objects_.count(var);
 
@@ -135,7 +141,21 @@ class CollectLastUsage : public ExprVisitor {
     return output;
   }
 
+  void VisitExpr_(const SeqExprNode* op) override {
+    ++seq_depth_;
+    ExprVisitor::VisitExpr_(op);
+    --seq_depth_;
+  }
+
   void VisitBinding(const Binding& binding) override {
+    if (seq_depth_ > 1) {
+      // The bindings of a nested sequence, such as a branch of an If, are
+      // killed within the sequence itself.  The usages in it count as
+      // usages by the enclosing binding, such that a variable last used in
+      // a branch is killed after the If.
+      ExprVisitor::VisitBinding(binding);
+      return;
+    }
     auto cache = current_binding_;
     current_binding_ = binding->var.get();
     binding_order_.push_back(current_binding_);
@@ -185,6 +205,9 @@ class CollectLastUsage : public ExprVisitor {
   // being visited.
   const VarNode* current_binding_{nullptr};
 
+  // The number of sequences enclosing the expression being visited.
+  int seq_depth_{0};
+
   // Order of bindings, to ensure consistent order of destruction, in
   // case a Binding is the last usage for more than one variable.
   std::vector<const VarNode*> binding_order_;
@@ -219,9 +242,12 @@ class KillInserter : public ExprMutator {
   }
 
   Expr VisitExpr_(const SeqExprNode* op) override {
+    // A nested sequence, such as a branch of an If, has its own last
+    // usages, and the enclosing sequence resumes with its own afterwards.
+    auto cache = std::move(last_usage_);
     last_usage_ = CollectLastUsage::Collect(GetRef<Expr>(op));
     auto mutated = ExprMutator::VisitExpr_(op);
-    last_usage_.clear();
+    last_usage_ = std::move(cache);
     return mutated;
   }
 
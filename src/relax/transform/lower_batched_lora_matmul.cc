@@ -0,0 +1,244 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/relax/transform/lower_batched_lora_matmul.cc
+ * \brief Lower `matmul(x, take(weights, indices, axis=0))` to a single
+ *  gathered matmul kernel.
+ *
+ * In batched LoRA, every sequence of the batch selects its own adapter
+ * out of a stacked weight table.  Instead of materializing the gathered
+ * weights of shape [batch, in, out], the matmul is lowered to one kernel
+ * that reads `weights[indices[i]]` while computing the i-th sequence,
+ * either a TIR PrimFunc or a segmented GEMM from an external library.
+ */
+
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/attrs/index.h>
+#include <tvm/relax/attrs/manipulate.h>
+#include <tvm/relax/expr.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+#include <tvm/te/operation.h>
+#include <tvm/topi/tags.h>
+
+#include <optional>
+#include <string>
+
+#include "../../te/operation/create_primfunc.h"
+#include "../op/op_common.h"
+#include "../op/tensor/datatype.h"
+
+namespace tvm {
+namespace relax {
+
+namespace {
+
+/*! \brief The workspace passed to segmented GEMM kernels, as used by the CUTLASS group GEMM. */
+constexpr int64_t kSegmentGemmWorkspaceBytes = 4096 * 1024;
+
+/*! \brief A matmul whose weights are gathered per sequence out of a weight table. */
+struct BatchedLoRAMatmul {
+  /*! \brief The activations, of shape [batch, seq_len, in]. */
+  Expr x;
+  /*! \brief The weight table, of shape [table_size, in, out], or [table_size, out, in]. */
+  Expr weights;
+  /*! \brief The row of the weight table used by each sequence, of shape [batch]. */
+  Expr indices;
+  /*! \brief Whether the weight table is stored as [table_size, out, in]. */
+  bool transposed;
+};
+
+class BatchedLoRAMatmulLowerer : public ExprMutator {
+ public:
+  BatchedLoRAMatmulLowerer(IRModule mod, Optional<String> segment_gemm_func)
+      : ExprMutator(mod), mod_(mod), segment_gemm_func_(segment_gemm_func) {}
+
+  IRModule Run() {
+    for (const auto& gv : mod_->GetGlobalVars()) {
+      const auto& func = mod_->Lookup(gv);
+      if (const auto* relax_func = func.as<FunctionNode>()) {
+        if (relax_func->GetAttr<String>(attr::kCodegen).defined()) continue;
+        auto updated = Downcast<Function>(VisitExpr(func));
+        if (!updated.same_as(func)) {
+          builder_->UpdateFunction(gv, Downcast<Function>(RemoveAllUnused(updated)));
+        }
+      }
+    }
+    return builder_->GetContextIRModule();
+  }
+
+ private:
+  using ExprMutator::VisitExpr_;
+
+  Expr VisitExpr_(const CallNode* op) final {
+    auto call = Downcast<Call>(ExprMutator::VisitExpr_(op));
+    static const Op& matmul_op = Op::Get("relax.matmul");
+    if (!call->op.same_as(matmul_op)) return call;
+
+    const auto* out_sinfo = op->struct_info_.as<TensorStructInfoNode>();
+    if (!out_sinfo || out_sinfo->ndim != 3 || out_sinfo->IsUnknownDtype()) return call;
+
+    auto match = MatchBatchedLoRA(call);
+    if (!match) return call;
+
+    TensorStructInfo ret_sinfo = GetRef<TensorStructInfo>(out_sinfo);
+    if (segment_gemm_func_.defined() && match->transposed &&
+        out_sinfo->dtype == DataType::Float(16) &&
+        GetStructInfoAs<TensorStructInfoNode>(match->x)->dtype == DataType::Float(16) &&
+        GetStructInfoAs<TensorStructInfoNode>(match->weights)->dtype == DataType::Float(16)) {
+      return LowerToSegmentGemm(match.value(), ret_sinfo);
+    }
+    return LowerToPrimFunc(match.value(), ret_sinfo);
+  }
+
+  Expr LookupBoundValue(Expr expr) {
+    if (auto var = expr.as<Var>()) {
+      if (auto bound = LookupBinding(var.value())) {
+        return bound.value();
+      }
+    }
+    return expr;
+  }
+
+  std::optional<BatchedLoRAMatmul> MatchBatchedLoRA(const Call& matmul_call) {
+    static const Op& take_op = Op::Get("relax.take");
+    static const Op& permute_dims_op = Op::Get("relax.permute_dims");
+
+    bool transposed = false;
+    Expr rhs = LookupBoundValue(matmul_call->args[1]);
+    if (const auto* permute = rhs.as<CallNode>(); permute && permute->op.same_as(permute_dims_op)) {
+      const auto* attrs = permute->attrs.as<PermuteDimsAttrs>();
+      if (!attrs->axes.defined()) return std::nullopt;
+      auto axes = attrs->axes.value();
+      if (axes.size() != 3 || axes[0]->value != 0 || axes[1]->value != 2 || axes[2]->value != 1) {
+        return std::nullopt;
+      }
+      transposed = true;
+      rhs = LookupBoundValue(permute->args[0]);
+    }
+
+    const auto* take_call = rhs.as<CallNode>();
+    if (!take_call || !take_call->op.same_as(take_op)) return std::nullopt;
+    const auto* take_attrs = take_call->attrs.as<TakeAttrs>();
+    if (!take_attrs->axis.defined() || take_attrs->axis.value()->value != 0) return std::nullopt;
+
+    BatchedLoRAMatmul match{matmul_call->args[0], take_call->args[0], take_call->args[1],
+                            transposed};
+    const auto* x_sinfo = GetStructInfoAs<TensorStructInfoNode>(match.x);
+    const auto* weights_sinfo = GetStructInfoAs<TensorStructInfoNode>(match.weights);
+    const auto* indices_sinfo = GetStructInfoAs<TensorStructInfoNode>(match.indices);
+    if (!x_sinfo || !weights_sinfo || !indices_sinfo) return std::nullopt;
+    if (x_sinfo->ndim != 3 || weights_sinfo->ndim != 3 || indices_sinfo->ndim != 1) {
+      return std::nullopt;
+    }
+    if (!x_sinfo->GetShape().defined() || !weights_sinfo->GetShape().defined() ||
+        x_sinfo->IsUnknownDtype() || weights_sinfo->IsUnknownDtype() ||
+        !indices_sinfo->dtype.is_int()) {
+      return std::nullopt;
+    }
+    return match;
+  }
+
+  Expr LowerToPrimFunc(const BatchedLoRAMatmul& match, const TensorStructInfo& ret_sinfo) {
+    const auto* x_sinfo = GetStructInfoAs<TensorStructInfoNode>(match.x);
+    const auto* weights_sinfo = GetStructInfoAs<TensorStructInfoNode>(match.weights);
+    const auto* indices_sinfo = GetStructInfoAs<TensorStructInfoNode>(match.indices);
+    Array<PrimExpr> x_shape = x_sinfo->GetShape().value();
+    Array<PrimExpr> weights_shape = weights_sinfo->GetShape().value();
+
+    // Replace the symbolic dimensions by fresh variables, so that the
+    // kernel can be shared by all calls of the same static shapes.
+    auto fresh_dim = [](const PrimExpr& dim, const std::string& name) -> PrimExpr {
+      if (dim->IsInstance<IntImmNode>()) return dim;
+      return tir::Var(name, dim->dtype);
+    };
+    PrimExpr batch = fresh_dim(x_shape[0], "batch");
+    PrimExpr seq_len = fresh_dim(x_shape[1], "seq_len");
+    PrimExpr in_features = x_shape[2]->IsInstance<IntImmNode>()
+                               ? x_shape[2]
+                               : fresh_dim(weights_shape[match.transposed ? 2 : 1], "in_features");
+    PrimExpr table_size = fresh_dim(weights_shape[0], "table_size");
+    PrimExpr out_features = fresh_dim(weights_shape[match.transposed ? 1 : 2], "out_features");
+
+    te::Tensor x = te::placeholder({batch, seq_len, in_features}, x_sinfo->dtype, "x");
+    te::Tensor weights = te::placeholder(
+        match.transposed ? Array<PrimExpr>{table_size, out_features, in_features}
+                         : Array<PrimExpr>{table_size, in_features, out_features},
+        weights_sinfo->dtype, "weights");
+    te::Tensor indices = te::placeholder({batch}, indices_sinfo->dtype, "indices");
+
+    DataType out_dtype = ret_sinfo->dtype;
+    tir::IterVar k = te::reduce_axis(Range(IntImm(in_features->dtype, 0), in_features), "k");
+    te::Tensor out = te::compute(
+        {batch, seq_len, out_features},
+        [&](const Array<tir::Var>& i) {
+          PrimExpr row = tvm::cast(table_size->dtype, indices(i[0]));
+          PrimExpr w = match.transposed ? weights(row, i[2], k->var) : weights(row, k->var, i[2]);
+          return tvm::sum(tvm::cast(out_dtype, x(i[0], i[1], k->var)) * tvm::cast(out_dtype, w),
+                          {k});
+        },
+        "matmul", topi::kMatMul);
+
+    PrimFunc func =
+        WithoutAttr(CreatePrimFunc({x, weights, indices, out}), tvm::attr::kGlobalSymbol);
+    GlobalVar gv = builder_->AddFunction(func, "batched_lora_matmul");
+    return Call(call_tir_op_, {gv, Tuple({match.x, match.weights, match.indices})}, {},
+                {ret_sinfo});
+  }
+
+  Expr LowerToSegmentGemm(const BatchedLoRAMatmul& match, const TensorStructInfo& ret_sinfo) {
+    Expr indices = match.indices;
+    if (GetStructInfoAs<TensorStructInfoNode>(indices)->dtype != DataType::Int(64)) {
+      indices = astype(indices, DataType::Int(64));
+    }
+    Expr workspace =
+        MakeAllocTensor(ShapeExpr({IntImm(DataType::Int(64), kSegmentGemmWorkspaceBytes)}),
+                        DataTypeImm(DataType::UInt(8)), PrimValue::Int64(0));
+    return Call(call_dps_packed_op_,
+                {ExternFunc(segment_gemm_func_.value()),
+                 Tuple({match.x, match.weights, indices, workspace})},
+                {}, {ret_sinfo});
+  }
+
+  IRModule mod_;
+  /*! \brief The packed function of the segmented GEMM, if it should be used. */
+  Optional<String> segment_gemm_func_;
+
+  const Op& call_tir_op_ = Op::Get("relax.call_tir");
+  const Op& call_dps_packed_op_ = Op::Get("relax.call_dps_packed");
+};
+
+}  // namespace
+
+namespace transform {
+Pass LowerBatchedLoRAMatmul(Optional<String> segment_gemm_func) {
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule mod,
+                                                                            PassContext pc) {
+    return BatchedLoRAMatmulLowerer(mod, segment_gemm_func).Run();
+  };
+  return CreateModulePass(pass_func, 1, "LowerBatchedLoRAMatmul", {});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.LowerBatchedLoRAMatmul")
+    .set_body_typed(LowerBatchedLoRAMatmul);
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
@@ -24,8 +24,15 @@
 #include <tvm/meta_schedule/database.h>
 #include <tvm/relax/transform.h>
 #include <tvm/relax/tuning_api.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
 #include "../src/meta_schedule/module_equality.h"
 #include "../src/meta_schedule/trace_apply.h"
 
@@ -100,6 +107,20 @@ class MetaScheduleTuner {
   const runtime::PackedFunc* normalize_mod_func_;
 };
 
+/*!
+ * \brief The scheduling of a distinct PrimFunc, shared by the PrimFuncs structurally equal to it.
+ */
+struct ScheduleJob {
+  /*! \brief The module the trace is applied to. */
+  IRModule mod;
+  /*! \brief The tuning record of the module. */
+  meta_schedule::TuningRecord record;
+  /*! \brief Whether the trace is applied through the anchor block of the module. */
+  bool use_anchor;
+  /*! \brief The scheduled PrimFunc. */
+  tir::PrimFunc scheduled{nullptr};
+};
+
 Pass MetaScheduleApplyDatabase(Optional<String> work_dir, Optional<IRModule> dyn_mod, bool enable_warning = false) {
   using tvm::meta_schedule::Database;
   Target target = Target::Current(false);
@@ -121,8 +142,22 @@ Pass MetaScheduleApplyDatabase(Optional<String> work_dir, Optional<IRModule> dyn
       database = meta_schedule::Database::JSONDatabase(path_workload, path_tuning_record, true);
     }
 
-    Map<GlobalVar, BaseFunc> result;
     auto mod_eq_structural = meta_schedule::ModuleEquality::Create("ignore-ndarray");
+    meta_schedule::ModuleHash mod_hash(*mod_eq_structural);
+    meta_schedule::ModuleEqual mod_equal(*mod_eq_structural);
+    // The PrimFuncs equal after normalization, e.g. the kernels of the layers of a model, share
+    // the database query and the application of the trace.
+    std::unordered_map<IRModule, Optional<meta_schedule::TuningRecord>, meta_schedule::ModuleHash,
+                       meta_schedule::ModuleEqual>
+        records(0, mod_hash, mod_equal);
+    std::unordered_map<IRModule, std::vector<int>, meta_schedule::ModuleHash,
+                       meta_schedule::ModuleEqual>
+        jobs_by_mod(0, mod_hash, mod_equal);
+    std::vector<ScheduleJob> jobs;
+    // The scheduled functions, with their job and the function whose attributes they keep.
+    std::vector<std::tuple<GlobalVar, int, tir::PrimFunc>> scheduled_funcs;
+
+    Map<GlobalVar, BaseFunc> result;
     for (const auto& iter : mod->functions) {
       GlobalVar gv = iter.first;
       BaseFunc base_func = iter.second;
@@ -130,50 +165,39 @@ Pass MetaScheduleApplyDatabase(Optional<String> work_dir, Optional<IRModule> dyn
         tir::PrimFunc prim_func = GetRef<tir::PrimFunc>(prim_func_node);
 
         IRModule tir_mod = (*normalize_mod_func_)(prim_func);
-        if (Optional<meta_schedule::TuningRecord> opt_record =
-                database->QueryTuningRecord(tir_mod, target, gv->name_hint)) {
+        auto it_record = records.find(tir_mod);
+        if (it_record == records.end()) {
+          it_record =
+              records.emplace(tir_mod, database->QueryTuningRecord(tir_mod, target, gv->name_hint))
+                  .first;
+        }
+        if (Optional<meta_schedule::TuningRecord> opt_record = it_record->second) {
           meta_schedule::TuningRecord record = opt_record.value();
-          tir::Schedule sch{nullptr};
-          if (!mod_eq_structural->Equal(tir_mod, record->workload->mod)) {
-            // When the database lookup succeeds while structural equality check fails,
-            // it implies that the anchor block based equality has been used during tuning.
-            // The trace in the record cannot directly be applied to this query module.
-            sch = tir::Schedule::Traced(
-                tir_mod, /*seed=*/-1, /*debug_mask=*/0,
-                /*error_render_level=*/tir::ScheduleErrorRenderLevel::kDetail);
-            meta_schedule::ScheduleUsingAnchorTrace(sch, record->trace, target);
-          } else {
-            if(dyn_mod.defined()) {
-              IRModule tmp = dyn_mod.value();
-              base_func = tmp->functions[tmp->global_var_map_[gv->name_hint]];
-              if (const auto* prim_func_node = base_func.as<tir::PrimFuncNode>()) {
-                prim_func = GetRef<tir::PrimFunc>(prim_func_node);
-                tir_mod = (*normalize_mod_func_)(prim_func);
-              }
-              sch = tir::Schedule::Traced(
-                tir_mod, /*seed=*/-1, /*debug_mask=*/0,
-                /*error_render_level=*/tir::ScheduleErrorRenderLevel::kDetail);
+          // When the database lookup succeeds while structural equality check fails,
+          // it implies that the anchor block based equality has been used during tuning.
+          // The trace in the record cannot directly be applied to this query module.
+          bool use_anchor = !mod_eq_structural->Equal(tir_mod, record->workload->mod);
+          IRModule apply_mod = use_anchor ? tir_mod : record->workload->mod;
+          if (!use_anchor && dyn_mod.defined()) {
+            IRModule tmp = dyn_mod.value();
+            base_func = tmp->functions[tmp->global_var_map_[gv->name_hint]];
+            if (const auto* prim_func_node = base_func.as<tir::PrimFuncNode>()) {
+              prim_func = GetRef<tir::PrimFunc>(prim_func_node);
+              tir_mod = (*normalize_mod_func_)(prim_func);
             }
-            else {
-              sch = tir::Schedule::Traced(
-                record->workload->mod, /*seed=*/-1, /*debug_mask=*/0,
-                /*error_render_level=*/tir::ScheduleErrorRenderLevel::kDetail);
-            }
-            record->trace->ApplyToSchedule(sch, /*remove_postproc=*/false);
+            apply_mod = tir_mod;
           }
-          IRModule new_mod = sch->mod();
-          ICHECK_EQ(new_mod->functions.size(), 1);
-          BaseFunc new_base_func = (*new_mod->functions.begin()).second;
-          ICHECK(new_base_func->IsInstance<tir::PrimFuncNode>());
-          tir::PrimFunc tuned_prim_func = Downcast<tir::PrimFunc>(new_base_func);
-          // maintain the original attributes
-          tir::PrimFunc new_prim_func = tir::PrimFunc(/*params=*/tuned_prim_func->params,
-                                                      /*body=*/tuned_prim_func->body,
-                                                      /*ret_type=*/tuned_prim_func->ret_type,
-                                                      /*buffer_map=*/tuned_prim_func->buffer_map,
-                                                      /*attrs=*/prim_func->attrs);
-          new_prim_func = WithAttr(std::move(new_prim_func), tir::attr::kIsScheduled, Bool(true));
-          result.Set(gv, new_prim_func);
+          std::vector<int>& candidates = jobs_by_mod[apply_mod];
+          auto it_job = std::find_if(candidates.begin(), candidates.end(), [&](int job) {
+            return jobs[job].use_anchor == use_anchor &&
+                   jobs[job].record->trace.same_as(record->trace);
+          });
+          int job = it_job != candidates.end() ? *it_job : static_cast<int>(jobs.size());
+          if (job == static_cast<int>(jobs.size())) {
+            jobs.push_back(ScheduleJob{apply_mod, record, use_anchor});
+            candidates.push_back(job);
+          }
+          scheduled_funcs.emplace_back(gv, job, prim_func);
           continue;
         } else if (enable_warning) {
           LOG(WARNING) << "Tuning record is not found for primfunc: " << gv->name_hint;
@@ -185,6 +209,38 @@ Pass MetaScheduleApplyDatabase(Optional<String> work_dir, Optional<IRModule> dyn
       }
       result.Set(gv, base_func);
     }
+
+    // Replay the traces of the distinct functions in parallel.
+    support::parallel_for_dynamic(
+        0, jobs.size(), std::max(1U, std::thread::hardware_concurrency()),
+        [&](int thread_id, int task_id) {
+          ScheduleJob& job = jobs[task_id];
+          tir::Schedule sch = tir::Schedule::Traced(
+              job.mod, /*seed=*/-1, /*debug_mask=*/0,
+              /*error_render_level=*/tir::ScheduleErrorRenderLevel::kDetail);
+          if (job.use_anchor) {
+            meta_schedule::ScheduleUsingAnchorTrace(sch, job.record->trace, target);
+          } else {
+            job.record->trace->ApplyToSchedule(sch, /*remove_postproc=*/false);
+          }
+          IRModule new_mod = sch->mod();
+          ICHECK_EQ(new_mod->functions.size(), 1);
+          BaseFunc new_base_func = (*new_mod->functions.begin()).second;
+          ICHECK(new_base_func->IsInstance<tir::PrimFuncNode>());
+          job.scheduled = Downcast<tir::PrimFunc>(new_base_func);
+        });
+
+    for (const auto& [gv, job, prim_func] : scheduled_funcs) {
+      const tir::PrimFunc& tuned_prim_func = jobs[job].scheduled;
+      // maintain the original attributes
+      tir::PrimFunc new_prim_func = tir::PrimFunc(/*params=*/tuned_prim_func->params,
+                                                  /*body=*/tuned_prim_func->body,
+                                                  /*ret_type=*/tuned_prim_func->ret_type,
+                                                  /*buffer_map=*/tuned_prim_func->buffer_map,
+                                                  /*attrs=*/prim_func->attrs);
+      new_prim_func = WithAttr(std::move(new_prim_func), tir::attr::kIsScheduled, Bool(true));
+      result.Set(gv, new_prim_func);
+    }
     if(dyn_mod.defined()) {
         mod = dyn_mod.value();
     }
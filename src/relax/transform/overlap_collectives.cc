@@ -0,0 +1,159 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/overlap_collectives.cc
+ * \brief Overlap the collectives of Disco with the computation independent of them.
+ *
+ * A legalized collective
+ *
+ *     y = R.call_dps_packed("runtime.disco.allreduce", (x, kind, in_group), out_sinfo)
+ *
+ * is replaced by its asynchronous variant, which runs on the communication
+ * stream, and a wait of the compute stream on it:
+ *
+ *     y_async = R.call_dps_packed("runtime.disco.allreduce_async", (x, kind, in_group), out_sinfo)
+ *     ... the bindings after y independent of it ...
+ *     y = R.call_pure_packed("runtime.disco.wait_collective", y_async, x, sinfo_args=out_sinfo)
+ *     ... the bindings after y depending on it ...
+ *
+ * The wait reads the input of the collective as well, so that the memory
+ * planning does not reuse it while the collective may still read it.
+ */
+
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/transform.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+namespace {
+
+/*! \brief The asynchronous variants of the collectives. */
+const std::unordered_map<std::string, std::string>& AsyncCollectives() {
+  static const std::unordered_map<std::string, std::string> collectives = {
+      {"runtime.disco.allreduce", "runtime.disco.allreduce_async"},
+      {"runtime.disco.allgather", "runtime.disco.allgather_async"},
+      {"runtime.disco.ring_exchange", "runtime.disco.ring_exchange_async"},
+  };
+  return collectives;
+}
+
+class CollectiveOverlapper : public ExprMutator {
+ public:
+  static Function Run(const Function& func) {
+    return Downcast<Function>(CollectiveOverlapper().VisitExpr(func));
+  }
+
+ private:
+  using ExprMutator::VisitBindingBlock_;
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    auto visited = Downcast<DataflowBlock>(ExprMutator::VisitBindingBlock_(block));
+    std::vector<Binding> bindings(visited->bindings.begin(), visited->bindings.end());
+    bool changed = false;
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      changed |= Schedule(&bindings, i);
+    }
+    if (!changed) return visited;
+    return DataflowBlock(bindings);
+  }
+
+  /*!
+   * \brief Make the collective bound at the index asynchronous, and move the bindings after it
+   * independent of it ahead of its wait. The collective is kept if none are independent.
+   * \return Whether the bindings are changed.
+   */
+  bool Schedule(std::vector<Binding>* bindings, size_t index) {
+    static const Op& call_dps_packed_op = Op::Get("relax.call_dps_packed");
+    static const Op& call_pure_packed_op = Op::Get("relax.call_pure_packed");
+    const auto* binding = (*bindings)[index].as<VarBindingNode>();
+    const auto* call = binding ? binding->value.as<CallNode>() : nullptr;
+    if (!call || !call->op.same_as(call_dps_packed_op)) return false;
+    const auto* callee = call->args[0].as<ExternFuncNode>();
+    if (!callee) return false;
+    auto it = AsyncCollectives().find(callee->global_symbol);
+    if (it == AsyncCollectives().end()) return false;
+
+    std::unordered_set<const VarNode*> dependent_vars = {binding->var.get()};
+    std::vector<Binding> independent, dependent;
+    // A match_cast may define symbolic variables used by the struct info of later bindings,
+    // which is not tracked here, so nothing after a dependent match_cast is moved.
+    bool after_dependent_match_cast = false;
+    for (size_t j = index + 1; j < bindings->size(); ++j) {
+      const Binding& later = (*bindings)[j];
+      bool is_dependent = after_dependent_match_cast;
+      for (const Var& var : FreeVars(GetBoundValue(later))) {
+        is_dependent |= dependent_vars.count(var.get()) > 0;
+      }
+      if (is_dependent) {
+        dependent_vars.insert(later->var.get());
+        dependent.push_back(later);
+        after_dependent_match_cast |= later->IsInstance<MatchCastNode>();
+      } else {
+        independent.push_back(later);
+      }
+    }
+    if (independent.empty()) return false;
+
+    Var var = binding->var;
+    StructInfo sinfo = GetStructInfo(var);
+    Expr send = Downcast<Tuple>(call->args[1])->fields[0];
+    DataflowVar async_var(var->name_hint() + "_async", sinfo);
+    Expr async_call = builder_->Normalize(
+        Call(call_dps_packed_op, {ExternFunc(it->second), call->args[1]}, {}, call->sinfo_args));
+    Expr wait = builder_->Normalize(
+        Call(call_pure_packed_op, {ExternFunc("runtime.disco.wait_collective"), async_var, send},
+             {}, {sinfo}));
+
+    bindings->resize(index);
+    bindings->push_back(VarBinding(async_var, async_call));
+    bindings->insert(bindings->end(), independent.begin(), independent.end());
+    bindings->push_back(VarBinding(var, wait));
+    bindings->insert(bindings->end(), dependent.begin(), dependent.end());
+    return true;
+  }
+};
+
+}  // namespace
+
+namespace transform {
+
+Pass OverlapCollectives() {
+  auto pass_func = [=](Function func, IRModule, PassContext) -> Function {
+    return CollectiveOverlapper::Run(func);
+  };
+  return CreateFunctionPass(/*pass_function=*/pass_func,
+                            /*opt_level=*/0,
+                            /*pass_name=*/"OverlapCollectives",
+                            /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.OverlapCollectives").set_body_typed(OverlapCollectives);
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
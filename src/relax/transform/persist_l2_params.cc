@@ -0,0 +1,216 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/persist_l2_params.cc
+ * \brief Keep the parameters annotated by a function resident in the L2 cache while they are used.
+ *
+ * The parameters named by the `relax.l2_persisting_params` attribute of a function are ordered by
+ * their first use.  Around the uses of each of them:
+ *
+ *   - vm.builtin.cuda.set_l2_persisting_window marks the accesses to the parameter as persisting
+ *     in the L2 cache, right before its first use.
+ *   - vm.builtin.cuda.reset_l2_persisting_window clears the window, right after its last use.
+ *
+ * A stream has a single access policy window, so the windows must not overlap.  A parameter used
+ * while the window of an earlier one is still set is left as is.
+ */
+
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+namespace {
+
+double GetHitRatio(const String& name, const ObjectRef& value) {
+  if (const auto* float_imm = value.as<FloatImmNode>()) {
+    return float_imm->value;
+  } else if (const auto* boxed = value.as<runtime::BoxNode<double>>()) {
+    return boxed->value;
+  } else if (const auto* int_imm = value.as<IntImmNode>()) {
+    return static_cast<double>(int_imm->value);
+  } else if (const auto* boxed = value.as<runtime::BoxNode<int64_t>>()) {
+    return static_cast<double>(boxed->value);
+  }
+  LOG(FATAL) << "TypeError: The hit ratio of parameter " << name << " in "
+             << attr::kL2PersistingParams << " must be a float, but got " << value;
+  return 0;
+}
+
+/*! \brief The window of one parameter. */
+struct PersistedParam {
+  Var param;
+  double hit_ratio;
+  /*! \brief The bindings of the first and the last use of the parameter. */
+  int64_t first_use;
+  int64_t last_use;
+};
+
+class L2ParamPersister {
+ public:
+  Function Run(Function func) {
+    auto opt_params = func->GetAttr<Map<String, ObjectRef>>(attr::kL2PersistingParams);
+    if (!opt_params) return func;
+    Map<String, ObjectRef> annotated = opt_params.value();
+    auto seq = Downcast<SeqExpr>(func->body);
+
+    std::unordered_map<const VarNode*, double> hit_ratios;
+    for (const auto& [name, value] : annotated) {
+      auto it = std::find_if(func->params.begin(), func->params.end(),
+                             [&](const Var& param) { return param->name_hint() == name; });
+      CHECK(it != func->params.end())
+          << "ValueError: " << attr::kL2PersistingParams << " names the parameter " << name
+          << ", which is not a parameter of the function";
+      CHECK((*it)->struct_info_.as<TensorStructInfoNode>())
+          << "ValueError: The L2 persisting parameter " << name << " must be a tensor, but has "
+          << (*it)->struct_info_;
+      double hit_ratio = GetHitRatio(name, value);
+      CHECK(hit_ratio > 0 && hit_ratio <= 1)
+          << "ValueError: The hit ratio of parameter " << name << " must be in (0, 1], but got "
+          << hit_ratio;
+      hit_ratios[(*it).get()] = hit_ratio;
+    }
+
+    // Collect the uses of the parameters in binding order.
+    std::unordered_map<const VarNode*, PersistedParam> uses;
+    int64_t binding_index = 0;
+    for (const BindingBlock& block : seq->blocks) {
+      CHECK(!block->IsInstance<DataflowBlockNode>())
+          << "ValueError: PersistL2Params requires functions without dataflow blocks, "
+          << "please apply ToNonDataflow first";
+      for (const Binding& binding : block->bindings) {
+        Expr value = GetBoundValue(binding);
+        for (const Var& var : FreeVars(value)) {
+          auto it = hit_ratios.find(var.get());
+          if (it == hit_ratios.end()) continue;
+          auto use_it =
+              uses.try_emplace(var.get(),
+                               PersistedParam{var, it->second, binding_index, binding_index})
+                  .first;
+          use_it->second.last_use = binding_index;
+        }
+        ++binding_index;
+      }
+    }
+
+    std::vector<PersistedParam> ordered;
+    for (const auto& [var, use] : uses) {
+      ordered.push_back(use);
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first_use < rhs.first_use;
+    });
+    std::vector<PersistedParam> persisted;
+    for (const PersistedParam& param : ordered) {
+      if (!persisted.empty() && param.first_use <= persisted.back().last_use) {
+        LOG(WARNING) << "The L2 persisting window of parameter " << param.param->name_hint()
+                     << " overlaps with the window of parameter "
+                     << persisted.back().param->name_hint() << ", and is skipped";
+        continue;
+      }
+      persisted.push_back(param);
+    }
+    return Rewrite(func, seq, persisted);
+  }
+
+ private:
+  Function Rewrite(const Function& func, const SeqExpr& seq,
+                   const std::vector<PersistedParam>& persisted) {
+    static const Op& call_builtin_with_ctx_op = Op::Get("relax.call_builtin_with_ctx");
+    static const ExternFunc builtin_set("vm.builtin.cuda.set_l2_persisting_window");
+    static const ExternFunc builtin_reset("vm.builtin.cuda.reset_l2_persisting_window");
+
+    std::unordered_map<int64_t, std::vector<const PersistedParam*>> set_at, reset_at;
+    for (const PersistedParam& param : persisted) {
+      set_at[param.first_use].push_back(&param);
+      reset_at[param.last_use].push_back(&param);
+    }
+
+    Map<Var, Expr> remap;
+    Array<BindingBlock> new_blocks;
+    int64_t binding_index = 0;
+    for (const BindingBlock& block : seq->blocks) {
+      Array<Binding> new_bindings;
+      for (const Binding& binding : block->bindings) {
+        for (const PersistedParam* param : set_at[binding_index]) {
+          StructInfo sinfo = GetStructInfo(param->param);
+          Var var(param->param->name_hint() + "_persisting", sinfo);
+          PrimValue hit_ratio(FloatImm(DataType::Float(64), param->hit_ratio));
+          new_bindings.push_back(VarBinding(
+              var, Call(call_builtin_with_ctx_op, {builtin_set, Tuple({param->param, hit_ratio})},
+                        Attrs(), {sinfo})));
+          remap.Set(param->param, var);
+        }
+
+        Expr value = Bind(GetBoundValue(binding), remap);
+        if (const auto* match_cast = binding.as<MatchCastNode>()) {
+          new_bindings.push_back(MatchCast(match_cast->var, value, match_cast->struct_info));
+        } else {
+          new_bindings.push_back(VarBinding(binding->var, value));
+        }
+
+        for (const PersistedParam* param : reset_at[binding_index]) {
+          new_bindings.push_back(VarBinding(
+              Var("_void", TupleStructInfo(Array<StructInfo>{})),
+              Call(call_builtin_with_ctx_op, {builtin_reset, Tuple({param->param})}, Attrs(),
+                   {TupleStructInfo(Array<StructInfo>{})})));
+        }
+        ++binding_index;
+      }
+      new_blocks.push_back(BindingBlock(new_bindings));
+    }
+
+    auto new_func = GetRef<Function>(func.get());
+    new_func.CopyOnWrite()->body = SeqExpr(new_blocks, Bind(seq->body, remap));
+    new_func = WithoutAttr(std::move(new_func), attr::kL2PersistingParams);
+    if (!persisted.empty() && new_func->is_pure) {
+      // The builtins have side effects on the streams of the device.
+      new_func = WithAttr(new_func, attr::kForcePure, Bool(true));
+    }
+    return new_func;
+  }
+};
+
+}  // namespace
+
+namespace transform {
+
+Pass PersistL2Params() {
+  auto pass_func = [=](Function func, IRModule, PassContext) -> Function {
+    return L2ParamPersister().Run(func);
+  };
+  return CreateFunctionPass(/*pass_function=*/pass_func,
+                            /*opt_level=*/0,
+                            /*pass_name=*/"PersistL2Params",
+                            /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.PersistL2Params").set_body_typed(PersistL2Params);
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
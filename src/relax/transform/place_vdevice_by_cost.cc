@@ -0,0 +1,519 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/place_vdevice_by_cost.cc
+ * \brief Place the operators on the CPU or the GPU by their estimated cost.
+ *
+ * The bindings are placed greedily in program order. An operator costs
+ *
+ *     cost(device) = compute(device) + sum of transfer(arg) over the args not on the device
+ *
+ * where compute(CPU) = flops / cpu_gflops, compute(GPU) = launch_us + flops / gpu_gflops and
+ * transfer(arg) = launch_us + bytes / transfer_gbps, so that the small operators stay on the
+ * CPU unless their inputs are on the GPU, and the large ones go to the GPU.
+ *
+ * A tensor needed on the other device is copied once per binding block with R.to_vdevice,
+ * right after its binding or at the beginning of the block for the tensors defined before it,
+ * so that the copy is issued as early as possible and overlaps with the computation between
+ * the copy and its first use:
+ *
+ *     lv0 = R.matmul(x, w)             # on the GPU
+ *     lv0_copy = R.to_vdevice(lv0, cpu)
+ *     lv1 = R.nn.relu(lv0)             # on the GPU
+ *     ...
+ *     lv5 = R.argmax(lv0_copy)         # on the CPU
+ */
+
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/attrs/op.h>
+#include <tvm/relax/expr_functor.h>
+#include <tvm/relax/struct_info.h>
+#include <tvm/relax/transform.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+namespace {
+
+constexpr int kCPU = 0;
+constexpr int kGPU = 1;
+/*! \brief The placement of the tensors on a VDevice other than the CPU and the GPU. */
+constexpr int kOther = -1;
+
+/*! \brief The flops assumed for an operator with dynamic shapes, which is deemed large. */
+constexpr double kUnknownFlops = 1e12;
+/*! \brief The bytes assumed for a tensor with a dynamic shape. */
+constexpr double kUnknownBytes = 1e9;
+
+struct PlacementCostModel {
+  double cpu_gflops;
+  double gpu_gflops;
+  double launch_us;
+  double transfer_gbps;
+
+  /*! \return The time of an operator on a device, in microseconds. */
+  double Compute(double flops, int device) const {
+    return device == kCPU ? flops / (cpu_gflops * 1e3) : launch_us + flops / (gpu_gflops * 1e3);
+  }
+
+  /*! \return The time of the copy of a tensor across the devices, in microseconds. */
+  double Transfer(double bytes) const { return launch_us + bytes / (transfer_gbps * 1e3); }
+};
+
+/*! \return The number of elements of a tensor, or NullOpt when its shape is not static. */
+Optional<Integer> NumElements(const StructInfo& sinfo) {
+  auto tinfo = sinfo.as<TensorStructInfoNode>();
+  if (!tinfo || !tinfo->shape.defined()) return NullOpt;
+  auto shape = tinfo->shape.as<ShapeExprNode>();
+  if (!shape) return NullOpt;
+  int64_t num_elements = 1;
+  for (const PrimExpr& dim : shape->values) {
+    auto int_dim = dim.as<IntImmNode>();
+    if (!int_dim) return NullOpt;
+    num_elements *= int_dim->value;
+  }
+  return Integer(num_elements);
+}
+
+double NumBytes(const StructInfo& sinfo) {
+  auto tinfo = sinfo.as<TensorStructInfoNode>();
+  auto num_elements = NumElements(sinfo);
+  if (!tinfo || tinfo->IsUnknownDtype() || !num_elements) return kUnknownBytes;
+  return static_cast<double>(num_elements.value()->value) * tinfo->dtype.bytes();
+}
+
+/*! \brief The tensors an operator reads, including the fields of its tuple arguments. */
+std::vector<Expr> TensorArgs(const Call& call) {
+  std::vector<Expr> args;
+  for (const Expr& arg : call->args) {
+    if (auto tuple = arg.as<TupleNode>()) {
+      for (const Expr& field : tuple->fields) {
+        if (field->struct_info_.as<TensorStructInfoNode>()) args.push_back(field);
+      }
+    } else if (arg->struct_info_.as<TensorStructInfoNode>()) {
+      args.push_back(arg);
+    }
+  }
+  return args;
+}
+
+/*!
+ * \brief Estimate the floating-point operations of an operator: twice the multiply-adds of
+ *  the matmuls and convolutions, and one per element read or written for the others.
+ */
+double EstimateFlops(const Call& call, const StructInfo& out_sinfo) {
+  static const Op& matmul_op = Op::Get("relax.matmul");
+  auto num_outputs = NumElements(out_sinfo);
+  if (!num_outputs) return kUnknownFlops;
+  double outputs = static_cast<double>(num_outputs.value()->value);
+
+  std::string op_name = Downcast<Op>(call->op)->name;
+  if (call->op.same_as(matmul_op)) {
+    auto lhs = call->args[0]->struct_info_.as<TensorStructInfoNode>();
+    auto shape = lhs ? lhs->shape.as<ShapeExprNode>() : nullptr;
+    if (!shape || shape->values.empty()) return kUnknownFlops;
+    auto reduction = shape->values.back().as<IntImmNode>();
+    if (!reduction) return kUnknownFlops;
+    return 2 * outputs * static_cast<double>(reduction->value);
+  }
+  if (op_name.rfind("relax.nn.conv", 0) == 0 && call->args.size() >= 2) {
+    // The multiply-adds of an output element are those of one output channel of the weight.
+    auto weight = call->args[1]->struct_info_.as<TensorStructInfoNode>();
+    auto num_weights = NumElements(call->args[1]->struct_info_);
+    auto shape = weight && weight->shape.defined() ? weight->shape.as<ShapeExprNode>() : nullptr;
+    if (!num_weights || !shape || shape->values.empty()) return kUnknownFlops;
+    int64_t out_channels = Downcast<IntImm>(shape->values[0])->value;
+    return 2 * outputs * static_cast<double>(num_weights.value()->value) /
+           static_cast<double>(std::max<int64_t>(out_channels, 1));
+  }
+  double elements = outputs;
+  for (const Expr& arg : TensorArgs(call)) {
+    auto num_inputs = NumElements(arg->struct_info_);
+    if (!num_inputs) return kUnknownFlops;
+    elements += static_cast<double>(num_inputs.value()->value);
+  }
+  return elements;
+}
+
+/*! \brief Whether an operator computes a tensor on the device of its inputs. */
+bool IsPlaceable(const Call& call) {
+  auto op = call->op.as<OpNode>();
+  if (!op) return false;
+  static const std::vector<std::string> excluded_prefixes = {
+      "relax.call_",       "relax.memory.", "relax.vm.",          "relax.builtin.",
+      "relax.ccl.",        "relax.dist.",   "relax.distributed.", "relax.to_vdevice",
+      "relax.hint_on_device"};
+  for (const std::string& prefix : excluded_prefixes) {
+    if (op->name.rfind(prefix, 0) == 0) return false;
+  }
+  return op->name.rfind("relax.", 0) == 0;
+}
+
+/*! \brief The placement of the bindings of a function, and the copies it needs. */
+struct PlacementPlan {
+  /*! \brief The device of each placed binding. */
+  std::unordered_map<const VarBindingNode*, int> placement;
+  /*! \brief The device of the operands of the bindings reading tensors from the other device. */
+  std::unordered_map<const VarBindingNode*, int> operand_device;
+  /*! \brief The device of each tensor. */
+  std::unordered_map<const VarNode*, int> device_of;
+  /*! \brief The tensors to copy to their other device, by block, in the order of their uses. */
+  std::unordered_map<const BindingBlockNode*, std::vector<Var>> copies;
+};
+
+class PlacementPlanner : public ExprVisitor {
+ public:
+  PlacementPlanner(VDevice cpu, VDevice gpu, int default_device, PlacementCostModel cost)
+      : cpu_(cpu), gpu_(gpu), default_device_(default_device), cost_(cost) {}
+
+  PlacementPlan Run(const Function& func) {
+    VisitExpr(func);
+    return std::move(plan_);
+  }
+
+ private:
+  using ExprVisitor::VisitBinding_;
+
+  void VisitExpr_(const FunctionNode* func) final {
+    for (const Var& param : func->params) {
+      plan_.device_of[param.get()] = DeviceOf(GetStructInfo(param));
+    }
+    // The returned tensors stay on the device the function is annotated to return them on.
+    if (auto seq = func->body.as<SeqExprNode>()) {
+      for (const BindingBlock& block : seq->blocks) {
+        for (const Binding& binding : block->bindings) {
+          bound_values_[binding->var.get()] = GetBoundValue(binding);
+        }
+      }
+      PinReturned(seq->body, func->ret_struct_info);
+    }
+    ExprVisitor::VisitExpr_(func);
+  }
+
+  void PinReturned(const Expr& expr, const StructInfo& sinfo) {
+    auto var = expr.as<VarNode>();
+    if (var && sinfo.as<TensorStructInfoNode>()) {
+      pinned_[var] = DeviceOf(sinfo);
+    } else if (var && bound_values_.count(var)) {
+      PinReturned(bound_values_.at(var), sinfo);
+    } else if (auto tuple = expr.as<TupleNode>()) {
+      auto tuple_sinfo = sinfo.as<TupleStructInfoNode>();
+      for (size_t i = 0; i < tuple->fields.size(); ++i) {
+        if (tuple_sinfo && i < tuple_sinfo->fields.size()) {
+          PinReturned(tuple->fields[i], tuple_sinfo->fields[i]);
+        }
+      }
+    }
+  }
+
+  void VisitBindingBlock(const BindingBlock& block) final {
+    const BindingBlockNode* prev_block = current_block_;
+    std::unordered_set<const VarNode*> prev_copied = std::move(copied_);
+    current_block_ = block.get();
+    copied_.clear();
+    ExprVisitor::VisitBindingBlock(block);
+    current_block_ = prev_block;
+    copied_ = std::move(prev_copied);
+  }
+
+  void VisitBinding(const Binding& binding) final {
+    ExprVisitor::VisitBinding(binding);
+    const VarNode* var = binding->var.get();
+    if (plan_.device_of.count(var)) return;
+    Expr value = GetBoundValue(binding);
+    if (auto bound = value.as<VarNode>(); bound && plan_.device_of.count(bound)) {
+      plan_.device_of[var] = plan_.device_of.at(bound);
+    } else {
+      plan_.device_of[var] = DeviceOf(GetStructInfo(binding->var));
+    }
+  }
+
+  void VisitBinding_(const VarBindingNode* binding, const CallNode* call_node) final {
+    ExprVisitor::VisitBinding_(binding, call_node);
+    Call call = GetRef<Call>(call_node);
+    if (call->op.same_as(to_vdevice_op_) || call->op.same_as(hint_on_device_op_)) return;
+    std::vector<Expr> args = TensorArgs(call);
+    for (const Expr& arg : args) {
+      if (auto var = arg.as<VarNode>(); var && Device(var) == kOther) return;
+    }
+
+    StructInfo sinfo = GetStructInfo(binding->var);
+    auto tinfo = sinfo.as<TensorStructInfoNode>();
+    int device;
+    if (tinfo && !tinfo->vdevice.defined() && IsPlaceable(call)) {
+      if (!std::all_of(args.begin(), args.end(), [](const Expr& arg) {
+            return arg->IsInstance<VarNode>() || arg->IsInstance<ConstantNode>();
+          })) {
+        return;
+      }
+      device = Place(binding, call, args);
+      if (device == kOther) return;
+      plan_.placement[binding] = device;
+      plan_.device_of[binding->var.get()] = device;
+    } else if (ContainsTensor(sinfo)) {
+      // The other operators, e.g. the calls of the kernels or of the other functions, run on
+      // the device of their outputs, or the default device.
+      device = DeviceOf(sinfo);
+      if (device == kOther) return;
+    } else {
+      return;
+    }
+
+    bool moved = false;
+    for (const Expr& arg : args) {
+      auto var = arg.as<VarNode>();
+      if (var && Device(var) != device) {
+        moved = true;
+        if (copied_.insert(var).second) {
+          plan_.copies[current_block_].push_back(GetRef<Var>(var));
+        }
+      }
+    }
+    if (moved) {
+      plan_.operand_device[binding] = device;
+    }
+  }
+
+  /*! \return The device of the lowest cost for an operator, or the required one if pinned. */
+  int Place(const VarBindingNode* binding, const Call& call, const std::vector<Expr>& args) {
+    if (auto it = pinned_.find(binding->var.get()); it != pinned_.end()) {
+      return it->second;
+    }
+    double flops = EstimateFlops(call, GetStructInfo(binding->var));
+    double cost[2];
+    for (int dev : {kCPU, kGPU}) {
+      cost[dev] = cost_.Compute(flops, dev);
+      for (const Expr& arg : args) {
+        // The constants are materialized on the device using them.
+        auto var = arg.as<VarNode>();
+        if (var && Device(var) != dev && !copied_.count(var)) {
+          cost[dev] += cost_.Transfer(NumBytes(GetStructInfo(arg)));
+        }
+      }
+    }
+    return cost[kCPU] < cost[kGPU] ? kCPU : kGPU;
+  }
+
+  static bool ContainsTensor(const StructInfo& sinfo) {
+    if (sinfo.as<TensorStructInfoNode>()) return true;
+    if (auto tuple = sinfo.as<TupleStructInfoNode>()) {
+      return std::any_of(tuple->fields.begin(), tuple->fields.end(), ContainsTensor);
+    }
+    return false;
+  }
+
+  int Device(const VarNode* var) const {
+    auto it = plan_.device_of.find(var);
+    return it != plan_.device_of.end() ? it->second : DeviceOf(GetStructInfo(GetRef<Var>(var)));
+  }
+
+  int DeviceOf(const StructInfo& sinfo) const {
+    auto tinfo = sinfo.as<TensorStructInfoNode>();
+    if (!tinfo || !tinfo->vdevice.defined()) return default_device_;
+    VDevice vdevice = tinfo->vdevice.value();
+    if (StructuralEqual()(vdevice, cpu_)) return kCPU;
+    if (StructuralEqual()(vdevice, gpu_)) return kGPU;
+    return kOther;
+  }
+
+  VDevice cpu_;
+  VDevice gpu_;
+  int default_device_;
+  PlacementCostModel cost_;
+  PlacementPlan plan_;
+  /*! \brief The values bound to the variables of the function, to find its returned tensors. */
+  std::unordered_map<const VarNode*, Expr> bound_values_;
+  /*! \brief The device required for the returned tensors. */
+  std::unordered_map<const VarNode*, int> pinned_;
+  const BindingBlockNode* current_block_ = nullptr;
+  /*! \brief The tensors copied to their other device in the current block. */
+  std::unordered_set<const VarNode*> copied_;
+  const Op& to_vdevice_op_ = Op::Get("relax.to_vdevice");
+  const Op& hint_on_device_op_ = Op::Get("relax.hint_on_device");
+};
+
+class PlacementRewriter : public ExprMutator {
+ public:
+  PlacementRewriter(VDevice cpu, VDevice gpu, PlacementPlan plan)
+      : vdevices_{cpu, gpu}, plan_(std::move(plan)) {}
+
+  Function Rewrite(const Function& func) { return Downcast<Function>(VisitExpr(func)); }
+
+ private:
+  using ExprMutator::VisitBinding_;
+  using ExprMutator::VisitBindingBlock_;
+
+  BindingBlock VisitBindingBlock_(const BindingBlockNode* block) final {
+    builder_->BeginBindingBlock();
+    VisitBindings(block);
+    return builder_->EndBlock();
+  }
+
+  BindingBlock VisitBindingBlock_(const DataflowBlockNode* block) final {
+    builder_->BeginDataflowBlock();
+    VisitBindings(block);
+    return builder_->EndBlock();
+  }
+
+  void VisitBindings(const BindingBlockNode* block) {
+    std::unordered_map<const VarNode*, Var> prev_copies = std::move(copies_);
+    copies_.clear();
+    auto it = plan_.copies.find(block);
+    std::unordered_set<const VarNode*> to_copy;
+    if (it != plan_.copies.end()) {
+      std::unordered_set<const VarNode*> defined;
+      for (const Binding& binding : block->bindings) {
+        defined.insert(binding->var.get());
+      }
+      for (const Var& var : it->second) {
+        to_copy.insert(var.get());
+        if (!defined.count(var.get())) EmitCopy(var);
+      }
+    }
+    for (const Binding& binding : block->bindings) {
+      VisitBinding(binding);
+      if (to_copy.count(binding->var.get())) EmitCopy(binding->var);
+    }
+    copies_ = std::move(prev_copies);
+  }
+
+  void EmitCopy(const Var& var) {
+    ObjectPtr<ToVDeviceAttrs> attrs = make_object<ToVDeviceAttrs>();
+    attrs->dst_vdevice = vdevices_[1 - plan_.device_of.at(var.get())];
+    copies_[var.get()] = builder_->Emit(Call(to_vdevice_op_, {VisitExpr(var)}, Attrs(attrs), {}),
+                                        var->name_hint() + "_copy");
+  }
+
+  void VisitBinding_(const VarBindingNode* binding, const CallNode* call) final {
+    auto it_placement = plan_.placement.find(binding);
+    auto it_operands = plan_.operand_device.find(binding);
+    if (it_placement == plan_.placement.end() && it_operands == plan_.operand_device.end()) {
+      ExprMutator::VisitBinding_(binding, call);
+      return;
+    }
+
+    Call new_call = Downcast<Call>(VisitExpr(GetRef<Call>(call)));
+    if (it_operands != plan_.operand_device.end()) {
+      int device = it_operands->second;
+      auto on_device = [&](const Expr& arg) -> Expr {
+        auto var = arg.as<VarNode>();
+        if (var && plan_.device_of.at(var) != device) return copies_.at(var);
+        return VisitExpr(arg);
+      };
+      Array<Expr> args = call->args.Map([&](const Expr& arg) -> Expr {
+        if (auto tuple = arg.as<TupleNode>()) {
+          return Tuple(tuple->fields.Map(on_device), tuple->span);
+        }
+        return on_device(arg);
+      });
+      new_call = Call(new_call->op, args, new_call->attrs, new_call->sinfo_args, new_call->span);
+    }
+    Expr value = builder_->Normalize(new_call);
+    if (it_placement == plan_.placement.end()) {
+      ReEmitBinding(binding, value);
+      return;
+    }
+
+    int device = it_placement->second;
+    auto tinfo = Downcast<TensorStructInfo>(GetStructInfo(value));
+    TensorStructInfo sinfo =
+        tinfo->shape.defined()
+            ? TensorStructInfo(tinfo->shape.value(), tinfo->dtype, vdevices_[device], tinfo->span)
+            : TensorStructInfo(tinfo->dtype, tinfo->ndim, vdevices_[device], tinfo->span);
+    Var new_var = binding->var->IsInstance<DataflowVarNode>()
+                      ? DataflowVar(binding->var->vid, sinfo, binding->var->span)
+                      : Var(binding->var->vid, sinfo, binding->var->span);
+    builder_->EmitNormalized(VarBinding(new_var, value));
+    var_remap_[binding->var->vid] = new_var;
+  }
+
+  VDevice vdevices_[2];
+  PlacementPlan plan_;
+  /*! \brief The copies to the other device emitted in the current block. */
+  std::unordered_map<const VarNode*, Var> copies_;
+  const Op& to_vdevice_op_ = Op::Get("relax.to_vdevice");
+};
+
+}  // namespace
+
+namespace transform {
+
+Pass PlaceVDeviceByCost(double cpu_gflops, double gpu_gflops, double launch_us,
+                        double transfer_gbps) {
+  CHECK_GT(cpu_gflops, 0) << "ValueError: cpu_gflops must be positive";
+  CHECK_GT(gpu_gflops, 0) << "ValueError: gpu_gflops must be positive";
+  CHECK_GT(transfer_gbps, 0) << "ValueError: transfer_gbps must be positive";
+  PlacementCostModel cost{cpu_gflops, gpu_gflops, launch_us, transfer_gbps};
+
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule mod,
+                                                                            PassContext pc) {
+    auto opt_vdevices = mod->global_infos.Get("vdevice");
+    if (!opt_vdevices) return mod;
+    Optional<VDevice> cpu, gpu;
+    int default_device = kOther;
+    for (const GlobalInfo& info : opt_vdevices.value()) {
+      auto vdevice = info.as<VDevice>();
+      if (!vdevice || !vdevice.value()->target.defined()) continue;
+      bool is_cpu = vdevice.value()->target->GetTargetDeviceType() == kDLCPU;
+      if (is_cpu && !cpu) {
+        cpu = vdevice;
+        if (default_device == kOther) default_device = kCPU;
+      } else if (!is_cpu && !gpu) {
+        gpu = vdevice;
+        if (default_device == kOther) default_device = kGPU;
+      }
+    }
+    if (!cpu || !gpu) return mod;
+
+    IRModule updates;
+    for (const auto& [gvar, base_func] : mod->functions) {
+      auto func = base_func.as<Function>();
+      if (!func || func.value()->GetAttr<String>(attr::kCodegen) ||
+          func.value()->GetAttr<Integer>(attr::kPrimitive)) {
+        continue;
+      }
+      PlacementPlan plan =
+          PlacementPlanner(cpu.value(), gpu.value(), default_device, cost).Run(func.value());
+      if (plan.placement.empty()) continue;
+      updates->Add(gvar, PlacementRewriter(cpu.value(), gpu.value(), std::move(plan))
+                             .Rewrite(func.value()));
+    }
+    if (updates->functions.size()) {
+      mod.CopyOnWrite()->Update(updates);
+    }
+    return mod;
+  };
+  return CreateModulePass(/*pass_function=*/pass_func,
+                          /*opt_level=*/0,
+                          /*pass_name=*/"PlaceVDeviceByCost",
+                          /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.PlaceVDeviceByCost").set_body_typed(PlaceVDeviceByCost);
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
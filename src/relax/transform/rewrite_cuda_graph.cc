@@ -89,6 +89,8 @@ struct LiftedFunctionRewritePlan {
   std::vector<const VarNode*> inputs;
   // The tir vars in the original function that are propagated to the lifted function
   Optional<ShapeExpr> propogated_tir_vars = NullOpt;
+  // The exclusive group of the original function for memory planning, only for allocation
+  String exclusive_group = "";
 };
 
 /*! \brief Builder of the lifted function for cuda graph capturing or allocations */
@@ -293,8 +295,10 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
     std::vector<LiftedFunctionRewritePlan*> alloc_plans, capture_plans;
     alloc_plans.reserve(alloc_storages_.size());
     capture_plans.reserve(captured_regions_.size());
-    std::transform(alloc_storages_.begin(), alloc_storages_.end(), std::back_inserter(alloc_plans),
-                   [&](FuncBuilder* region) { return region_to_plan(region, /*is_alloc=*/true); });
+    for (size_t i = 0; i < alloc_storages_.size(); ++i) {
+      alloc_plans.push_back(region_to_plan(alloc_storages_[i], /*is_alloc=*/true));
+      alloc_plans.back()->exclusive_group = alloc_storage_groups_[i];
+    }
     std::transform(captured_regions_.begin(), captured_regions_.end(),
                    std::back_inserter(capture_plans),
                    [&](FuncBuilder* region) { return region_to_plan(region, /*is_alloc=*/false); });
@@ -334,6 +338,8 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
     ExprVisitor::VisitExpr_(func);
     if (current_function_scope_.alloc_storage_builder->outputs_.size()) {
       alloc_storages_.emplace_back(current_function_scope_.alloc_storage_builder);
+      alloc_storage_groups_.push_back(
+          func->GetAttr<String>(attr::kMemoryPlanExclusiveGroup).value_or(""));
     }
     current_function_scope_.alloc_storage_builder = nullptr;
   }
@@ -623,6 +629,8 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
   std::vector<FuncBuilder*> captured_regions_;
   // The regions for allocation.
   std::vector<FuncBuilder*> alloc_storages_;
+  // The exclusive group of the function of each region for allocation.
+  std::vector<String> alloc_storage_groups_;
   // The binding variables that are not allowed to be captured.
   std::unordered_set<const VarNode*> disabled_storage_vars_;
   // The arena.
@@ -639,6 +647,9 @@ class CUDAGraphRewritePlanner : public ExprVisitor {
  * functions to a single function that allocates the sufficiently large storage to be shared among
  * all the functions.
  *
+ * Only the functions of the same exclusive group (`relax.memory_plan_exclusive_group`) share
+ * storages. The functions without the attribute form the default group.
+ *
  * \param alloc_plans The allocation plans of the functions to be merged.
  * \return The new allocation function that merges the storage allocations.
  */
@@ -655,12 +666,13 @@ Function MergeAllocationPlans(const std::vector<LiftedFunctionRewritePlan*>& all
 
     bool operator<(const StorageRecord& other) const { return size < other.size; }
   };
-  // Using an (ordered) map to make sure the result is deterministic
-  std::map<String, std::vector<std::vector<StorageRecord>>> storage_records;
+  // Using an (ordered) map keyed by the exclusive group and the storage scope to make sure the
+  // result is deterministic
+  std::map<std::pair<String, String>, std::vector<std::vector<StorageRecord>>> storage_records;
   static const auto& mem_alloc_storage_op = Op::Get("relax.memory.alloc_storage");
 
-  // Collect the storage records for each storage scope. Storage records are stored separately
-  // for each original function.
+  // Collect the storage records for each exclusive group and storage scope. Storage records are
+  // stored separately for each original function.
   for (int plan_id = 0; plan_id < static_cast<int>(alloc_plans.size()); ++plan_id) {
     LiftedFunctionRewritePlan* plan = alloc_plans[plan_id];
     ICHECK(plan->is_alloc);
@@ -675,7 +687,8 @@ Function MergeAllocationPlans(const std::vector<LiftedFunctionRewritePlan*>& all
           Downcast<IntImm>(Downcast<PrimValue>(alloc_storage->args[1])->value)->value;
       ICHECK_EQ(virtual_device_id, 0);
       String storage_scope = Downcast<StringImm>(alloc_storage->args[2])->value;
-      auto [it, _] = storage_records.try_emplace(storage_scope, alloc_plans.size());
+      auto [it, _] = storage_records.try_emplace(
+          std::make_pair(plan->exclusive_group, storage_scope), alloc_plans.size());
       it->second[plan_id].emplace_back(StorageRecord{size, binding, plan});
     }
   }
@@ -686,8 +699,8 @@ Function MergeAllocationPlans(const std::vector<LiftedFunctionRewritePlan*>& all
   // among all the functions.
   // This assumes that multiple functions will not run concurrently.
   std::vector<const VarBindingNode*> merged_allocs;
-  // Merge the storage records within each storage scope.
-  for (auto& [storage_scope, curr_scope_records] : storage_records) {
+  // Merge the storage records within each exclusive group and storage scope.
+  for (auto& [group_and_scope, curr_scope_records] : storage_records) {
     // The number of storages needed for the current storage scope, which is the maximum number of
     // storage records among all the functions.
     int num_storages = 0;
@@ -64,21 +64,54 @@
  * It means the maximum value of variable that names "n" in the function
  * signature will have upper bound 1024. And we will use 1024 as its value
  * during memory planning.
+ *
+ * With the pass config `relax.memory_plan_arena` enabled, the statically sized
+ * tokens in the global scope are not reused as a whole. Instead, all of them
+ * inside a binding block are placed into a single arena per device, where each
+ * tensor gets a byte offset that does not overlap any tensor live at the same
+ * time (best-fit offset assignment in decreasing order of size). The arena
+ * size and the liveness lower bound of the peak memory are reported as the
+ * function attributes `relax.memory_plan_arena_bytes` and
+ * `relax.memory_plan_live_bytes`.
+ *
+ * For dynamic shapes whose typical values are much smaller than the upper
+ * bound, a function can be annotated with `tir_var_upper_bound_buckets`, e.g.
+ *   `R.func_attr({"tir_var_upper_bound_buckets": {"n": [128, 1024]}})`.
+ * The function is then split into one copy per bucket, each planned with the
+ * bucket bound as the upper bound of the variable, and the original function
+ * dispatches to the smallest bucket that holds the runtime value.
+ *
+ * Functions that never run at the same time, such as the prefill and the
+ * decode function of a language model, can be annotated with the same
+ * `relax.memory_plan_exclusive_group`, e.g.
+ *   `R.func_attr({"relax.memory_plan_exclusive_group": "llm"})`.
+ * Such functions are always planned with arenas, and the arenas of all
+ * functions in a group are padded to the same sizes, so that the pooled
+ * allocator of the runtime serves them from one shared workspace.
  */
 #include <tvm/arith/analyzer.h>
 #include <tvm/relax/analysis.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/nested_msg.h>
 #include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/tir/stmt_functor.h>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <map>
 #include <set>
 #include <vector>
 
+#include "../../runtime/texture.h"
+
 namespace tvm {
 namespace relax {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relax.memory_plan_arena", Bool);
+
 /*!
  * \brief A representation of a block of reusable memory required at runtime.
  * \details Only the tensors whose memory can be "possibly reused" will have
@@ -106,6 +139,11 @@ class StorageTokenNode : public Object {
   std::string storage_scope;
   /*! \brief The storage id, reserved for debug and demo use. */
   int storage_id{-1};
+  /*! \brief The 2d extent of a token in a texture scope, or -1 for the other tokens. */
+  runtime::Texture2DShape<int64_t> texture_shape{-1, -1, -1};
+
+  /*! \brief Whether the token is a statically shaped texture. */
+  bool is_texture() const { return texture_shape.width >= 0; }
 
   /*! \brief Get the constant number of bytes that this token requires, or -1 if the number of bytes
    * is symbolic */
@@ -132,11 +170,13 @@ class StorageToken : public ObjectRef {
     // Compute the tensor size from the shape.
     int64_t const_coeff = dtype.bytes() * dtype.lanes();
     PrimExpr size = tir::make_const(DataType::Int(64), 1);
+    bool is_static = true;
     for (const PrimExpr& dim_len : shape) {
       if (const IntImmNode* const_dim_len = dim_len.as<IntImmNode>()) {
         const_coeff *= const_dim_len->value;
       } else {
         size *= dim_len;
+        is_static = false;
       }
     }
     size = tir::make_const(DataType::Int(64), const_coeff) * size;
@@ -144,6 +184,15 @@ class StorageToken : public ObjectRef {
     ObjectPtr<StorageTokenNode> n = make_object<StorageTokenNode>();
     n->bytes = size;
     n->dtype = dtype;
+    if (runtime::IsTextureStorage(storage_scope) && shape.size() > 2 && is_static) {
+      struct Shape {
+        const Array<PrimExpr>& shape;
+        int64_t operator[](size_t i) const { return *tir::as_const_int(shape[i]); }
+      };
+      size_t axis = runtime::DefaultTextureLayoutSeparator(shape.size(), storage_scope);
+      n->texture_shape =
+          runtime::ApplyTexture2DFlattening<int64_t>(Shape{shape}, shape.size(), axis);
+    }
     n->storage_scope = std::move(storage_scope);
     data_ = std::move(n);
   }
@@ -286,6 +335,105 @@ class TokenAllocator1D {
   std::vector<StorageToken> full_pool_;
 };
 
+/*!
+ * \brief Memory manager for 2d memory (textures).
+ * \details An image can only be reused by a tensor of the same scope and dtype whose 2d extent
+ * fits into it, possibly after growing the image. Among the available images, the one that
+ * needs the least growth is picked, and then the one that wastes the least area. Same as for
+ * the texture pool of the runtime, images whose sides differ by more than a factor of
+ * `max_ratio_` from the request are not reused.
+ */
+class TokenAllocator2D {
+ public:
+  /*!
+   * \brief Request a storage token from the available token pool for a
+   * given texture prototype, or report no appropriate available token in the pool.
+   * \param prototype The requesting prototype storage token.
+   * \return The request result token. Return NullOpt if there is no
+   * appropriate available token in the pool.
+   */
+  Optional<StorageToken> RequestReuse(StorageToken prototype) {
+    ICHECK_EQ(prototype->storage_id, -1) << "The token is expected not to be allocated before.";
+    ICHECK(prototype->is_texture());
+    if (prototype->ref_counter == 0) {
+      return NullOpt;
+    }
+
+    std::vector<StorageToken>& pool =
+        available_pool_[{prototype->storage_scope, prototype->dtype}];
+    const runtime::Texture2DShape<int64_t>& shape = prototype->texture_shape;
+    auto best = pool.end();
+    int64_t min_added_area = std::numeric_limits<int64_t>::max();
+    int64_t min_wasted_area = std::numeric_limits<int64_t>::max();
+    for (auto it = pool.begin(); it != pool.end(); ++it) {
+      const runtime::Texture2DShape<int64_t>& cached = (*it)->texture_shape;
+      if (cached.channel != shape.channel) {
+        continue;
+      }
+      if (shape.width / cached.width > max_ratio_ || cached.width / shape.width > max_ratio_ ||
+          shape.height / cached.height > max_ratio_ || cached.height / shape.height > max_ratio_) {
+        continue;
+      }
+      int64_t new_area = std::max(cached.width, shape.width) * std::max(cached.height, shape.height);
+      int64_t added_area = new_area - cached.width * cached.height;
+      int64_t wasted_area = new_area - shape.width * shape.height;
+      if (added_area < min_added_area ||
+          (added_area == min_added_area && wasted_area < min_wasted_area)) {
+        min_added_area = added_area;
+        min_wasted_area = wasted_area;
+        best = it;
+      }
+    }
+    // Growing an image is only worthwhile when it adds less than a new image would take.
+    if (best == pool.end() || min_added_area > shape.width * shape.height) {
+      return NullOpt;
+    }
+    StorageToken available_token = *best;
+    pool.erase(best);
+    ICHECK_EQ(available_token->ref_counter, 0)
+        << "Available tokens are expected to have 0 reference.";
+    runtime::Texture2DShape<int64_t>& cached = available_token->texture_shape;
+    cached.width = std::max(cached.width, shape.width);
+    cached.height = std::max(cached.height, shape.height);
+    available_token->bytes = tir::make_const(
+        DataType::Int(64), cached.width * cached.height * cached.channel *
+                               available_token->dtype.bytes() * available_token->dtype.lanes());
+    available_token->ref_counter = prototype->ref_counter;
+    return available_token;
+  }
+
+  /*!
+   * \brief Allocate a storage token for the input prototype token.
+   * \param prototype The prototype token.
+   * \param storage_id The id of this token.
+   */
+  StorageToken Alloc(StorageToken prototype, int storage_id) {
+    ICHECK_EQ(prototype->storage_id, -1) << "The token is expected not to be allocated before.";
+    prototype->storage_id = storage_id;
+    return prototype;
+  }
+
+  /*!
+   * \brief Release the input token, putting it into the available pool.
+   * \param token The token to be released.
+   */
+  void Release(StorageToken token) {
+    ICHECK_GE(token->storage_id, 0)
+        << "The token to be released is expected to be allocated before";
+    ICHECK_EQ(token->ref_counter, 0) << "The token to be released is expected to have 0 reference.";
+    available_pool_[{token->storage_scope, token->dtype}].push_back(token);
+  }
+
+  /*! \brief Clear the allocator. */
+  void Clear() { available_pool_.clear(); }
+
+ private:
+  /*! \brief The largest ratio between the sides of a reused image and the request. */
+  const int64_t max_ratio_{5};
+  /*! \brief The pool of available storage tokens for each storage scope and dtype. */
+  std::map<std::pair<std::string, DataType>, std::vector<StorageToken>> available_pool_;
+};
+
 /*! \brief Check if the input op is a memory op that may return the same buffer. */
 bool IsInplaceMemoryOp(const Expr& op) {
   static const Op& reshape_op = Op::Get("relax.reshape");
@@ -294,6 +442,15 @@ bool IsInplaceMemoryOp(const Expr& op) {
   return op.same_as(reshape_op) || op.same_as(view_op) || op.same_as(ensure_zero_offset_op);
 }
 
+/*!
+ * \brief Check if the input op waits for an asynchronous collective. It returns its first
+ * argument, while the collective may be reading the other arguments until then.
+ */
+bool IsCollectiveWait(const Expr& op) {
+  const auto* extern_func = op.as<ExternFuncNode>();
+  return extern_func && extern_func->global_symbol == "runtime.disco.wait_collective";
+}
+
 /*! \brief The base class for the storage allocation visitor. */
 class StorageAllocatorBaseVisitor : public ExprVisitor {
  protected:
@@ -516,6 +673,15 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
       // Reuse the input's token for builtin reshape.
       SetTokens(call, GetTokens(call->args[0]));
       return;
+    } else if (IsCollectiveWait(call->op)) {
+      // Reuse the token of the collective's output, and keep its inputs alive until the wait.
+      ICHECK(!block_stack_.empty());
+      for (size_t i = 1; i < call->args.size(); ++i) {
+        Tokens tokens = GetTokensWithAllocSiteCheck(call->args[i], block_stack_.back());
+        ForEachLeaf(tokens, [](StorageToken token) { token->ref_counter += 1; });
+      }
+      SetTokens(call, GetTokens(call->args[0]));
+      return;
     }
 
     // - Increase the reference counters of the arguments when the callee is
@@ -605,6 +771,11 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
     // Create and set token.
     StringImm storage_scope = Downcast<StringImm>(call->args[3]);
     StorageToken token(upper_bounded_shape, sinfo->dtype, storage_scope->value);
+    if (runtime::IsTextureStorage(storage_scope->value) && !token->is_texture()) {
+      // Textures are planned by their 2d extent, which is only known for static shapes.
+      SetTokens(call, Tokens());
+      return Tokens();
+    }
 
     Tokens tokens(token);
     SetTokens(call, tokens);
@@ -684,6 +855,21 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
   std::unordered_map<const StorageTokenNode*, std::vector<const ExprNode*>> token2exprs_;
 };
 
+/*! \brief A statically sized token to be placed in an arena, with its live interval. */
+struct ArenaToken {
+  const StorageTokenNode* token;
+  /*! \brief The binding block where the token is allocated. */
+  const BindingBlockNode* block;
+  /*! \brief The runtime device index of the token. */
+  int64_t device_index;
+  /*! \brief The function where the token is allocated, and its exclusive group if any. */
+  const FunctionNode* func;
+  Optional<String> exclusive_group;
+  /*! \brief The binding index of the allocation and of the last use of the token. */
+  int start;
+  int end;
+};
+
 /*!
  * \brief The visitor class for storage token allocation planning.
  * \details
@@ -701,8 +887,8 @@ class StorageAllocatorInit : public StorageAllocatorBaseVisitor {
 class StorageAllocator : public StorageAllocatorBaseVisitor {
  public:
   explicit StorageAllocator(std::unordered_map<const ExprNode*, Tokens> token_map,
-                            arith::Analyzer* analyzer)
-      : allocator_(analyzer) {
+                            arith::Analyzer* analyzer, bool plan_arena)
+      : allocator_(analyzer), plan_arena_(plan_arena) {
     this->token_map_ = std::move(token_map);
   }
 
@@ -714,6 +900,9 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
       }
       // Clear the allocator to make the planning of different functions independent.
       allocator_.Clear();
+      texture_allocator_.Clear();
+      cur_func_ = func;
+      cur_exclusive_group_ = func->GetAttr<String>(attr::kMemoryPlanExclusiveGroup);
       this->VisitExpr_(func);
     }
   }
@@ -725,6 +914,8 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
   std::unordered_map<const ExprNode*, StorageToken> alloc_tensor2token;
   /*! \brief The mapping from each binding block to the storage tokens that are create inside. */
   std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>> block2tokens;
+  /*! \brief The tokens to be placed in arenas, in the order of allocation. */
+  std::vector<ArenaToken> arena_tokens;
 
  private:
   using ExprVisitor::VisitBinding_;
@@ -741,6 +932,7 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
 
   void VisitBinding_(const VarBindingNode* binding, const CallNode* call) final {
     static const Op& alloc_tensor_op = Op::Get("relax.builtin.alloc_tensor");
+    ++n_binding_;
     if (call->op == alloc_tensor_op) {
       auto it = token_map_.find(call);
       ICHECK(it != token_map_.end());
@@ -751,7 +943,21 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
         return;
       }
       ICHECK(it->second.IsLeaf());
-      StorageToken new_token = this->RequestReuseOrAlloc(it->second.LeafValue());
+      StorageToken prototype = it->second.LeafValue();
+      StorageToken new_token{nullptr};
+      const auto* device_index = Downcast<PrimValue>(call->args[2])->value.as<IntImmNode>();
+      bool plan_arena = plan_arena_ || cur_exclusive_group_.defined();
+      if (plan_arena && prototype->const_bytes() >= 0 && prototype->storage_scope == "global" &&
+          device_index != nullptr) {
+        // The token gets its own storage, which is later placed into the arena at an offset.
+        new_token = allocator_.Alloc(prototype, this->n_storage_++);
+        ICHECK(!block_stack_.empty());
+        token2arena_index_[new_token.get()] = arena_tokens.size();
+        arena_tokens.push_back({new_token.get(), block_stack_.back(), device_index->value,
+                                cur_func_, cur_exclusive_group_, n_binding_, n_binding_});
+      } else {
+        new_token = this->RequestReuseOrAlloc(prototype);
+      }
 
       // Record that this alloc_tensor is using the token.
       alloc_tensor2token.insert({call, new_token});
@@ -776,6 +982,20 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
         ICHECK(token_map_[call].IsNull());
       }
       return;
+    } else if (IsCollectiveWait(call->op)) {
+      Tokens tokens = GetTokens(call->args[0]);
+      if (tokens.IsLeaf()) {
+        token2cur_tensor_[tokens.LeafValue().get()].push_back(binding->var);
+      }
+      SetTokens(call, tokens);
+      for (size_t i = 1; i < call->args.size(); ++i) {
+        ForEachLeaf(GetTokens(call->args[i]), [this](StorageToken token) {
+          ICHECK_GT(token->ref_counter, 0);
+          token->ref_counter -= 1;
+          this->CheckForRelease(token);
+        });
+      }
+      return;
     }
 
     // Decrease the reference counter by one for each token that the arguments use.
@@ -793,6 +1013,11 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
 
   /*! \brief Request a storage reuse, or allocate storage if no appropriate storage is reusable. */
   StorageToken RequestReuseOrAlloc(StorageToken prototype) {
+    if (prototype->is_texture()) {
+      Optional<StorageToken> token = texture_allocator_.RequestReuse(prototype);
+      return token.defined() ? token.value()
+                             : texture_allocator_.Alloc(prototype, this->n_storage_++);
+    }
     Optional<StorageToken> token = allocator_.RequestReuse(prototype);
     if (!token.defined()) {
       return allocator_.Alloc(prototype, this->n_storage_++);
@@ -811,7 +1036,14 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
     ICHECK_GE(token->ref_counter, 0);
 
     if (token->ref_counter == 0) {
-      allocator_.Release(token);
+      if (auto it_arena = token2arena_index_.find(token.get());
+          it_arena != token2arena_index_.end()) {
+        arena_tokens[it_arena->second].end = n_binding_;
+      } else if (token->is_texture()) {
+        texture_allocator_.Release(token);
+      } else {
+        allocator_.Release(token);
+      }
       auto it = token2cur_tensor_.find(token.get());
       ICHECK(it != token2cur_tensor_.end());
       token2cur_tensor_.erase(it);
@@ -820,12 +1052,156 @@ class StorageAllocator : public StorageAllocatorBaseVisitor {
 
   /*! \brief Number of allocated storages. */
   int n_storage_{0};
+  /*! \brief Number of visited bindings, used as the timestamp of token liveness. */
+  int n_binding_{0};
   /*! \brief The 1D memory allocator. */
   TokenAllocator1D allocator_;
+  /*! \brief The 2D memory allocator, for the tokens in texture scopes. */
+  TokenAllocator2D texture_allocator_;
+  /*! \brief Whether to place the statically sized tokens into arenas. */
+  bool plan_arena_;
+  /*! \brief The function being planned, and its exclusive group if any. */
+  const FunctionNode* cur_func_{nullptr};
+  Optional<String> cur_exclusive_group_;
+  /*! \brief The mapping from each arena token to its index in `arena_tokens`. */
+  std::unordered_map<const StorageTokenNode*, size_t> token2arena_index_;
   /*! \brief The mapping from each token to the tensors that are currently using it. */
   std::unordered_map<const StorageTokenNode*, std::vector<Var>> token2cur_tensor_;
 };
 
+/*! \brief The offsets of the tokens placed into arenas, and the size of each arena. */
+struct ArenaPlan {
+  struct Arena {
+    /*! \brief The number of bytes of the arena. */
+    int64_t bytes{0};
+    /*! \brief The peak total size of the tensors that are live at the same time. */
+    int64_t live_bytes{0};
+  };
+  std::vector<Arena> arenas;
+  /*! \brief The mapping from each token to its arena index and its byte offset in the arena. */
+  std::unordered_map<const StorageTokenNode*, std::pair<int, int64_t>> token2offset;
+};
+
+/*!
+ * \brief Assign an offset to each arena token, so that tokens with overlapping live intervals
+ * do not overlap in memory.
+ * \details The tokens of each binding block and device share one arena. They are placed in
+ * decreasing order of size, each one into the smallest gap between the already placed tokens
+ * with overlapping live interval that can hold it, or after all of them if no gap fits.
+ * Afterwards, the arenas of the functions in the same exclusive group are matched per device
+ * in decreasing order of size, and each arena is padded to the largest one it is matched with.
+ * \param tokens The arena tokens, in the order of allocation.
+ * \return The arena plan.
+ */
+ArenaPlan PlanArenaOffsets(const std::vector<ArenaToken>& tokens) {
+  auto align = [](int64_t bytes) {
+    return (bytes + runtime::kAllocAlignment - 1) / runtime::kAllocAlignment *
+           runtime::kAllocAlignment;
+  };
+  // Group the tokens by binding block and device, in the order of their first allocation.
+  std::map<std::pair<const BindingBlockNode*, int64_t>, int> group_ids;
+  std::vector<std::vector<const ArenaToken*>> groups;
+  for (const ArenaToken& token : tokens) {
+    auto [it, inserted] = group_ids.insert({{token.block, token.device_index}, groups.size()});
+    if (inserted) {
+      groups.emplace_back();
+    }
+    groups[it->second].push_back(&token);
+  }
+
+  ArenaPlan plan;
+  for (std::vector<const ArenaToken*>& group : groups) {
+    int arena_id = plan.arenas.size();
+    ArenaPlan::Arena arena;
+    std::stable_sort(group.begin(), group.end(), [](const ArenaToken* a, const ArenaToken* b) {
+      return a->token->const_bytes() > b->token->const_bytes();
+    });
+    // The placed tokens with their offsets.
+    std::vector<std::pair<const ArenaToken*, int64_t>> placed;
+    for (const ArenaToken* token : group) {
+      int64_t size = align(token->token->const_bytes());
+      std::vector<std::pair<int64_t, int64_t>> conflicts;
+      for (const auto& [other, offset] : placed) {
+        if (token->start <= other->end && other->start <= token->end) {
+          conflicts.emplace_back(offset, offset + align(other->token->const_bytes()));
+        }
+      }
+      std::sort(conflicts.begin(), conflicts.end());
+      int64_t best_offset = -1;
+      int64_t best_gap = std::numeric_limits<int64_t>::max();
+      int64_t gap_begin = 0;
+      for (const auto& [begin, end] : conflicts) {
+        int64_t gap = begin - gap_begin;
+        if (gap >= size && gap < best_gap) {
+          best_gap = gap;
+          best_offset = gap_begin;
+        }
+        gap_begin = std::max(gap_begin, end);
+      }
+      if (best_offset == -1) {
+        best_offset = gap_begin;
+      }
+      placed.emplace_back(token, best_offset);
+      plan.token2offset[token->token] = {arena_id, best_offset};
+      arena.bytes = std::max(arena.bytes, best_offset + size);
+    }
+    // The liveness lower bound is the peak of the total live size over all timestamps, where
+    // the total size only changes at the start of a live interval.
+    for (const ArenaToken* token : group) {
+      int64_t live_bytes = 0;
+      for (const ArenaToken* other : group) {
+        if (other->start <= token->start && token->start <= other->end) {
+          live_bytes += other->token->const_bytes();
+        }
+      }
+      arena.live_bytes = std::max(arena.live_bytes, live_bytes);
+    }
+    plan.arenas.push_back(arena);
+  }
+
+  // Collect the arenas of each exclusive group and device, separately for each function.
+  std::map<std::pair<String, int64_t>, std::vector<std::vector<int>>> exclusive_arenas;
+  std::map<std::pair<String, int64_t>, std::unordered_map<const FunctionNode*, int>> func_ids;
+  for (int arena_id = 0; arena_id < static_cast<int>(groups.size()); ++arena_id) {
+    const ArenaToken* token = groups[arena_id].front();
+    if (!token->exclusive_group.defined()) {
+      continue;
+    }
+    std::pair<String, int64_t> key{token->exclusive_group.value(), token->device_index};
+    std::vector<std::vector<int>>& arenas_of_funcs = exclusive_arenas[key];
+    auto [it, inserted] = func_ids[key].insert({token->func, arenas_of_funcs.size()});
+    if (inserted) {
+      arenas_of_funcs.emplace_back();
+    }
+    arenas_of_funcs[it->second].push_back(arena_id);
+  }
+  // The functions of a group never run at the same time. Padding the i-th largest arena of each
+  // function to the same size lets every function reuse the cached arenas of the others.
+  for (auto& [key, arenas_of_funcs] : exclusive_arenas) {
+    size_t num_arenas = 0;
+    for (std::vector<int>& arena_ids : arenas_of_funcs) {
+      std::stable_sort(arena_ids.begin(), arena_ids.end(), [&plan](int a, int b) {
+        return plan.arenas[a].bytes > plan.arenas[b].bytes;
+      });
+      num_arenas = std::max(num_arenas, arena_ids.size());
+    }
+    for (size_t i = 0; i < num_arenas; ++i) {
+      int64_t bytes = 0;
+      for (const std::vector<int>& arena_ids : arenas_of_funcs) {
+        if (i < arena_ids.size()) {
+          bytes = std::max(bytes, plan.arenas[arena_ids[i]].bytes);
+        }
+      }
+      for (const std::vector<int>& arena_ids : arenas_of_funcs) {
+        if (i < arena_ids.size()) {
+          plan.arenas[arena_ids[i]].bytes = bytes;
+        }
+      }
+    }
+  }
+  return plan;
+}
+
 /*!
  * \brief The rewriter class based on the token allocation planning.
  * \details
@@ -837,10 +1213,12 @@ class StorageAllocationRewriter : public ExprMutator {
   explicit StorageAllocationRewriter(
       IRModule mod, std::unordered_map<const ExprNode*, StorageToken> alloc_tensor2token,
       std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>>
-          block2tokens)
+          block2tokens,
+      ArenaPlan arena_plan)
       : ExprMutator(std::move(mod)),
         alloc_tensor2token_(std::move(alloc_tensor2token)),
-        block2tokens_(std::move(block2tokens)) {}
+        block2tokens_(std::move(block2tokens)),
+        arena_plan_(std::move(arena_plan)) {}
 
   IRModule Rewrite() {
     const IRModule& mod = builder_->GetContextIRModule();
@@ -856,10 +1234,23 @@ class StorageAllocationRewriter : public ExprMutator {
         SetTIRVarUpperBound(GetRef<Function>(func_), &ana_, &dom_map_);
       }
       token2storage_var_.clear();
+      arena2storage_var_.clear();
       Function func = Downcast<Function>(this->VisitExpr_(func_));
       if (plan_dynamic_output_) {
         func = WithoutAttr(func, plan_dyn_attr_);
       }
+      if (!arena2storage_var_.empty()) {
+        int64_t arena_bytes = 0;
+        int64_t live_bytes = 0;
+        for (const auto& [arena_id, storage_var] : arena2storage_var_) {
+          arena_bytes += arena_plan_.arenas[arena_id].bytes;
+          live_bytes += arena_plan_.arenas[arena_id].live_bytes;
+        }
+        func = WithAttr(func, "relax.memory_plan_arena_bytes",
+                        IntImm(DataType::Int(64), arena_bytes));
+        func = WithAttr(func, "relax.memory_plan_live_bytes",
+                        IntImm(DataType::Int(64), live_bytes));
+      }
       builder_->UpdateFunction(gv, func);
     }
     return builder_->GetContextIRModule();
@@ -881,13 +1272,42 @@ class StorageAllocationRewriter : public ExprMutator {
       ICHECK_NOTNULL(sinfo->shape.as<ShapeExprNode>());
       PrimValue runtime_device_index = Downcast<PrimValue>(call->args[2]);
 
+      StorageToken token = it->second;
+      if (auto it_arena = arena_plan_.token2offset.find(token.get());
+          it_arena != arena_plan_.token2offset.end()) {
+        // The token is placed into an arena. Create the arena storage when it is used for the
+        // first time, and allocate the tensor at the planned offset.
+        auto [arena_id, offset] = it_arena->second;
+        Var arena_var{nullptr};
+        auto it_arena_var = arena2storage_var_.find(arena_id);
+        if (it_arena_var == arena2storage_var_.end()) {
+          Call alloc_storage(
+              mem_alloc_storage,
+              {ShapeExpr({IntImm(DataType::Int(64), arena_plan_.arenas[arena_id].bytes)}),
+               runtime_device_index, StringImm("global"), DataTypeImm(DataType::UInt(8))},
+              Attrs());
+          arena_var = builder_->Emit(alloc_storage, "arena");
+          arena2storage_var_[arena_id] = arena_var;
+        } else {
+          arena_var = it_arena_var->second;
+        }
+        return Call(mem_alloc_tensor,
+                    {arena_var, PrimValue::Int64(offset), sinfo->shape.value(),
+                     DataTypeImm(sinfo->dtype)},
+                    Attrs());
+      }
+
       // If the token is visited for the first time, create a storage variable using
       // `memory.alloc_storage` for it.
-      StorageToken token = it->second;
       Var storage_var{nullptr};
       auto it_token = token2storage_var_.find(token.get());
       if (it_token == token2storage_var_.end()) {
-        ShapeExpr size({token->bytes});
+        // Textures are allocated by their 2d shape (height, width, channel).
+        ShapeExpr size = token->is_texture()
+                             ? ShapeExpr({IntImm(DataType::Int(64), token->texture_shape.height),
+                                          IntImm(DataType::Int(64), token->texture_shape.width),
+                                          IntImm(DataType::Int(64), token->texture_shape.channel)})
+                             : ShapeExpr({token->bytes});
         PrimValue virtual_device_index = runtime_device_index;
         DataType dtype = token->dtype;
         Call alloc_storage(mem_alloc_storage,
@@ -917,7 +1337,8 @@ class StorageAllocationRewriter : public ExprMutator {
       const auto* shape = sinfo->shape.as<ShapeExprNode>();
       ICHECK_NOTNULL(shape);
       Array<PrimExpr> upper_bounded_shape = GetUpperBoundShape(shape->values, &ana_, dom_map_);
-      if (!IsStaticShape(shape->values)) {
+      if (!IsStaticShape(shape->values) &&
+          !runtime::IsTextureStorage(Downcast<StringImm>(call->args[3])->value)) {
         ICHECK(!sinfo->IsUnknownDtype());
         ICHECK_EQ(sinfo->dtype, Downcast<DataTypeImm>(call->args[1])->value);
         PrimExpr bytes = upper_bounded_shape[0];
@@ -956,29 +1377,129 @@ class StorageAllocationRewriter : public ExprMutator {
   std::unordered_map<const BindingBlockNode*, std::vector<const StorageTokenNode*>> block2tokens_;
   /*! \brief The mapping from each token to its corresponding storage var in each function. */
   std::unordered_map<const StorageTokenNode*, Var> token2storage_var_;
+  /*! \brief The offsets of the tokens placed into arenas. */
+  ArenaPlan arena_plan_;
+  /*! \brief The mapping from each arena to its storage var in each function. */
+  std::map<int, Var> arena2storage_var_;
 };
 
-IRModule StaticPlanBlockMemory(IRModule mod) {
+/*!
+ * \brief Split each function annotated with `tir_var_upper_bound_buckets` into one copy per
+ * combination of buckets, and turn the original function into a dispatcher that calls the copy
+ * matching the runtime values of the TIR variables.
+ * \details Each copy has its `tir_var_upper_bound` set to the bucket bound, so its storages are
+ * planned for the bucket size instead of the worst case. The last bucket of every variable
+ * keeps the original upper bound of the variable, if any.
+ * \param mod The IRModule to be planned.
+ * \return The IRModule with the annotated functions split.
+ */
+IRModule SplitUpperBoundBuckets(IRModule mod) {
+  constexpr static const char* kBucketsAttr = "tir_var_upper_bound_buckets";
+  BlockBuilder builder = BlockBuilder::Create(mod);
+  for (const auto& [gv, base_func] : mod->functions) {
+    const auto* func = base_func.as<FunctionNode>();
+    if (func == nullptr) {
+      continue;
+    }
+    Optional<Map<ObjectRef, ObjectRef>> buckets_attr =
+        func->GetAttr<Map<ObjectRef, ObjectRef>>(kBucketsAttr);
+    if (!buckets_attr.defined()) {
+      continue;
+    }
+    Map<ObjectRef, ObjectRef> upper_bound =
+        func->GetAttr<Map<ObjectRef, ObjectRef>>("tir_var_upper_bound")
+            .value_or(Map<ObjectRef, ObjectRef>());
+    // The TIR variables in the signature, with their ascending bucket bounds.
+    std::vector<std::pair<tir::Var, std::vector<int64_t>>> var_buckets;
+    Array<tir::Var> var_in_signature = TIRVarsInStructInfo(GetStructInfo(GetRef<Function>(func)));
+    for (const auto& [key, value] : buckets_attr.value()) {
+      const auto* name = key.as<StringObj>();
+      const auto* bounds = value.as<ArrayNode>();
+      CHECK(name != nullptr && bounds != nullptr)
+          << "ValueError: The attr `" << kBucketsAttr
+          << "` should map variable names to arrays of integers.";
+      auto it = std::find_if(var_in_signature.begin(), var_in_signature.end(),
+                             [&](const tir::Var& var) { return var->name_hint == name->data; });
+      CHECK(it != var_in_signature.end())
+          << "ValueError: The TIR variable " << name->data << " in attr `" << kBucketsAttr
+          << "` does not appear in the signature of function " << gv->name_hint;
+      std::vector<int64_t> sorted_bounds;
+      for (const ObjectRef& bound : *bounds) {
+        const auto* int_bound = bound.as<IntImmNode>();
+        CHECK(int_bound != nullptr && int_bound->value > 0)
+            << "ValueError: The bucket bounds in attr `" << kBucketsAttr
+            << "` should be positive integers, but " << bound << " is got.";
+        sorted_bounds.push_back(int_bound->value);
+      }
+      std::sort(sorted_bounds.begin(), sorted_bounds.end());
+      sorted_bounds.erase(std::unique(sorted_bounds.begin(), sorted_bounds.end()),
+                          sorted_bounds.end());
+      var_buckets.emplace_back(*it, std::move(sorted_bounds));
+    }
+
+    Function dispatcher = WithoutAttr(GetRef<Function>(func), kBucketsAttr);
+    int n_bucket = 0;
+    // Build the dispatch for the variables from `var_index` on, given the upper bounds of the
+    // variables before it. The fallback of each variable keeps its original upper bound.
+    std::function<Expr(size_t, Map<ObjectRef, ObjectRef>)> f_dispatch =
+        [&](size_t var_index, Map<ObjectRef, ObjectRef> bucket_upper_bound) -> Expr {
+      if (var_index == var_buckets.size()) {
+        Function bucket = WithoutAttr(CopyWithNewVars(dispatcher), tvm::attr::kGlobalSymbol);
+        bucket = WithAttr(bucket, "tir_var_upper_bound", bucket_upper_bound);
+        GlobalVar bucket_gv =
+            builder->AddFunction(Downcast<Function>(builder->Normalize(bucket)),
+                                 gv->name_hint + "_bucket" + std::to_string(n_bucket++));
+        return Call(bucket_gv, Array<Expr>(dispatcher->params.begin(), dispatcher->params.end()));
+      }
+      const auto& [var, bounds] = var_buckets[var_index];
+      std::vector<Expr> branches;
+      for (int64_t bound : bounds) {
+        Map<ObjectRef, ObjectRef> cur_upper_bound = bucket_upper_bound;
+        cur_upper_bound.Set(var->name_hint, IntImm(DataType::Int(64), bound));
+        branches.push_back(f_dispatch(var_index + 1, cur_upper_bound));
+      }
+      Expr dispatch = f_dispatch(var_index + 1, bucket_upper_bound);
+      for (int i = static_cast<int>(bounds.size()) - 1; i >= 0; --i) {
+        dispatch = If(PrimValue(var <= IntImm(var->dtype, bounds[i])), branches[i], dispatch);
+      }
+      return dispatch;
+    };
+    Expr body = f_dispatch(0, upper_bound);
+    dispatcher = Function(dispatcher->params, body, dispatcher->ret_struct_info,
+                          dispatcher->is_pure, dispatcher->attrs, dispatcher->span);
+    builder->UpdateFunction(gv, Downcast<Function>(builder->Normalize(dispatcher)));
+  }
+  return builder->GetContextIRModule();
+}
+
+IRModule StaticPlanBlockMemory(IRModule mod, bool plan_arena) {
   arith::Analyzer ana;
 
+  // Step 0. Split the functions planned with upper bound buckets.
+  mod = SplitUpperBoundBuckets(std::move(mod));
   // Step 1. Initialize.
   std::unordered_map<const ExprNode*, Tokens> token_map =
       StorageAllocatorInit::Initialize(mod, &ana);
   // Step 2. Collect the memory allocation info.
-  StorageAllocator allocator(std::move(token_map), &ana);
+  StorageAllocator allocator(std::move(token_map), &ana, plan_arena);
   allocator.Allocate(mod);
-  // Step 3. Rewrite the function.
+  // Step 3. Assign the offsets of the tokens placed into arenas.
+  ArenaPlan arena_plan = PlanArenaOffsets(allocator.arena_tokens);
+  // Step 4. Rewrite the function.
   StorageAllocationRewriter rewriter(std::move(mod),  //
                                      std::move(allocator.alloc_tensor2token),
-                                     std::move(allocator.block2tokens));
+                                     std::move(allocator.block2tokens), std::move(arena_plan));
   return rewriter.Rewrite();
 }
 
 namespace transform {
 
 Pass StaticPlanBlockMemory() {
-  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =
-      [=](IRModule m, PassContext pc) { return relax::StaticPlanBlockMemory(std::move(m)); };
+  runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func = [=](IRModule m,
+                                                                            PassContext pc) {
+    bool plan_arena = pc->GetConfig<Bool>("relax.memory_plan_arena").value_or(Bool(false))->value;
+    return relax::StaticPlanBlockMemory(std::move(m), plan_arena);
+  };
   return CreateModulePass(pass_func, /*opt_level=*/0, "StaticPlanBlockMemory", {});
 }
 
@@ -0,0 +1,272 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relax/transform/stream_params.cc
+ * \brief Stream the weights of a function from host memory ahead of their use.
+ *
+ * The weights (the parameters after `num_input`) are ordered by their
+ * first use.  The copy of the j-th weight is issued right before the
+ * first use of the (j - lookahead)-th weight, into one of `num_slots`
+ * device buffers:
+ *
+ *   - vm.builtin.weight_streaming.prefetch issues the copy on the copy
+ *     stream, after the previous occupant of the slot has been released.
+ *   - vm.builtin.weight_streaming.wait makes the compute stream wait for
+ *     the copy, right before the first use of the weight.
+ *   - vm.builtin.weight_streaming.release records that the computation
+ *     is done with the slot, right after the last use of the weight.
+ *
+ * A copy is postponed until a slot is free.  The weights that cannot be
+ * given a slot before their first use, as their slot would be held by a
+ * weight still in use, are left as device parameters.
+ */
+
+#include <tvm/relax/analysis.h>
+#include <tvm/relax/expr.h>
+#include <tvm/relax/transform.h>
+#include <tvm/relax/utils.h>
+
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace tvm {
+namespace relax {
+
+namespace {
+
+/*! \brief The alignment of the slots of the ring of device buffers. */
+constexpr int64_t kSlotAlignment = 256;
+
+std::optional<int64_t> GetStaticNumBytes(const StructInfo& sinfo) {
+  const auto* tensor_sinfo = sinfo.as<TensorStructInfoNode>();
+  if (!tensor_sinfo || tensor_sinfo->IsUnknownDtype()) return std::nullopt;
+  const auto* shape = tensor_sinfo->shape.as<ShapeExprNode>();
+  if (!shape) return std::nullopt;
+  int64_t nbytes = (tensor_sinfo->dtype.bits() * tensor_sinfo->dtype.lanes() + 7) / 8;
+  for (const PrimExpr& dim : shape->values) {
+    const auto* int_imm = dim.as<IntImmNode>();
+    if (!int_imm) return std::nullopt;
+    nbytes *= int_imm->value;
+  }
+  return nbytes;
+}
+
+/*! \brief The streaming plan of one weight. */
+struct StreamedParam {
+  Var param;
+  size_t param_index;
+  /*! \brief The bindings of the first and the last use of the weight. */
+  int64_t first_use;
+  int64_t last_use;
+  /*! \brief The binding before which the copy is issued. */
+  int64_t prefetch_at = 0;
+  int64_t slot = -1;
+};
+
+class ParamStreamer {
+ public:
+  ParamStreamer(int lookahead, int num_slots) : lookahead_(lookahead), num_slots_(num_slots) {}
+
+  Function Run(Function func) {
+    auto opt_num_input = func->GetAttr<Integer>(attr::kNumInput);
+    if (!opt_num_input) return func;
+    size_t num_input = opt_num_input.value()->value;
+    auto seq = Downcast<SeqExpr>(func->body);
+
+    // Collect the uses of the weights in binding order.
+    std::unordered_map<const VarNode*, size_t> weight_index;
+    for (size_t i = num_input; i < func->params.size(); ++i) {
+      weight_index[func->params[i].get()] = i;
+    }
+    std::unordered_map<const VarNode*, StreamedParam> uses;
+    int64_t binding_index = 0;
+    for (const BindingBlock& block : seq->blocks) {
+      CHECK(!block->IsInstance<DataflowBlockNode>())
+          << "ValueError: StreamParams requires functions without dataflow blocks, "
+          << "please apply ToNonDataflow first";
+      for (const Binding& binding : block->bindings) {
+        Expr value = GetBoundValue(binding);
+        for (const Var& var : FreeVars(value)) {
+          auto it = weight_index.find(var.get());
+          if (it == weight_index.end()) continue;
+          auto use_it =
+              uses.try_emplace(var.get(), StreamedParam{var, it->second, binding_index,
+                                                        binding_index})
+                  .first;
+          use_it->second.last_use = binding_index;
+        }
+        ++binding_index;
+      }
+    }
+    // The weights returned by the function must stay valid after it returns.
+    for (const Var& var : FreeVars(seq->body)) {
+      uses.erase(var.get());
+    }
+
+    std::vector<StreamedParam> ordered;
+    int64_t slot_nbytes = 0;
+    for (auto& [var, use] : uses) {
+      if (auto nbytes = GetStaticNumBytes(GetStructInfo(use.param))) {
+        int64_t aligned = (nbytes.value() + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+        slot_nbytes = std::max(slot_nbytes, aligned);
+        ordered.push_back(use);
+      }
+    }
+    if (ordered.empty()) return func;
+    std::sort(ordered.begin(), ordered.end(), [](const auto& lhs, const auto& rhs) {
+      return std::make_pair(lhs.first_use, lhs.param_index) <
+             std::make_pair(rhs.first_use, rhs.param_index);
+    });
+
+    // Assign the slots. A slot is free before a binding when the last use of its previous
+    // occupant is an earlier binding.
+    std::vector<int64_t> released_after(num_slots_, -1);
+    std::vector<StreamedParam> streamed;
+    for (size_t j = 0; j < ordered.size(); ++j) {
+      StreamedParam& param = ordered[j];
+      int64_t issue_at = 0;
+      if (j >= static_cast<size_t>(lookahead_)) {
+        issue_at = std::min(ordered[j - lookahead_].first_use, param.first_use);
+      }
+      auto slot_it = std::min_element(released_after.begin(), released_after.end());
+      int64_t prefetch_at = std::max(issue_at, *slot_it + 1);
+      if (prefetch_at > param.first_use) continue;
+      param.prefetch_at = prefetch_at;
+      param.slot = slot_it - released_after.begin();
+      *slot_it = param.last_use;
+      streamed.push_back(param);
+    }
+    if (streamed.empty()) return func;
+    return Rewrite(func, seq, streamed, slot_nbytes);
+  }
+
+ private:
+  Function Rewrite(const Function& func, const SeqExpr& seq,
+                   const std::vector<StreamedParam>& streamed, int64_t slot_nbytes) {
+    static const Op& call_builtin_with_ctx_op = Op::Get("relax.call_builtin_with_ctx");
+    static const ExternFunc builtin_prefetch("vm.builtin.weight_streaming.prefetch");
+    static const ExternFunc builtin_wait("vm.builtin.weight_streaming.wait");
+    static const ExternFunc builtin_release("vm.builtin.weight_streaming.release");
+
+    std::unordered_map<int64_t, std::vector<const StreamedParam*>> prefetch_at, wait_at,
+        release_at;
+    for (const StreamedParam& param : streamed) {
+      prefetch_at[param.prefetch_at].push_back(&param);
+      wait_at[param.first_use].push_back(&param);
+      release_at[param.last_use].push_back(&param);
+    }
+    auto slot_of = [](const StreamedParam* param) { return PrimValue::Int64(param->slot); };
+
+    Map<Var, Expr> remap;
+    std::unordered_map<const StreamedParam*, Var> prefetched;
+    Array<BindingBlock> new_blocks;
+    int64_t binding_index = 0;
+    for (const BindingBlock& block : seq->blocks) {
+      Array<Binding> new_bindings;
+      for (const Binding& binding : block->bindings) {
+        for (const StreamedParam* param : prefetch_at[binding_index]) {
+          StructInfo sinfo = GetStructInfo(param->param);
+          Var var(param->param->name_hint() + "_prefetch", sinfo);
+          new_bindings.push_back(VarBinding(
+              var, Call(call_builtin_with_ctx_op,
+                        {builtin_prefetch,
+                         Tuple({param->param, slot_of(param), PrimValue::Int64(num_slots_),
+                                PrimValue::Int64(slot_nbytes), PrimValue::Int64(0)})},
+                        Attrs(), {sinfo})));
+          prefetched[param] = var;
+        }
+        for (const StreamedParam* param : wait_at[binding_index]) {
+          StructInfo sinfo = GetStructInfo(param->param);
+          Var var(param->param->name_hint() + "_device", sinfo);
+          new_bindings.push_back(VarBinding(
+              var, Call(call_builtin_with_ctx_op,
+                        {builtin_wait, Tuple({prefetched.at(param), slot_of(param)})}, Attrs(),
+                        {sinfo})));
+          remap.Set(param->param, var);
+        }
+
+        Expr value = Bind(GetBoundValue(binding), remap);
+        if (const auto* match_cast = binding.as<MatchCastNode>()) {
+          new_bindings.push_back(MatchCast(match_cast->var, value, match_cast->struct_info));
+        } else {
+          new_bindings.push_back(VarBinding(binding->var, value));
+        }
+
+        for (const StreamedParam* param : release_at[binding_index]) {
+          new_bindings.push_back(VarBinding(
+              Var("_void", TupleStructInfo(Array<StructInfo>{})),
+              Call(call_builtin_with_ctx_op, {builtin_release, Tuple({slot_of(param)})}, Attrs(),
+                   {TupleStructInfo(Array<StructInfo>{})})));
+        }
+        ++binding_index;
+      }
+      new_blocks.push_back(BindingBlock(new_bindings));
+    }
+
+    std::vector<size_t> param_indices;
+    for (const StreamedParam& param : streamed) {
+      param_indices.push_back(param.param_index);
+    }
+    std::sort(param_indices.begin(), param_indices.end());
+    Array<Integer> streamed_indices;
+    for (size_t index : param_indices) {
+      streamed_indices.push_back(Integer(index));
+    }
+
+    auto new_func = GetRef<Function>(func.get());
+    new_func.CopyOnWrite()->body = SeqExpr(new_blocks, seq->body);
+    new_func = WithAttr(new_func, attr::kStreamedParams, streamed_indices);
+    if (new_func->is_pure) {
+      // The builtins have side effects on the streams of the device.
+      new_func = WithAttr(new_func, attr::kForcePure, Bool(true));
+    }
+    return new_func;
+  }
+
+  int lookahead_;
+  int num_slots_;
+};
+
+}  // namespace
+
+namespace transform {
+
+Pass StreamParams(int lookahead, int num_slots) {
+  CHECK_GE(lookahead, 0) << "ValueError: lookahead must be non-negative, but got " << lookahead;
+  CHECK_GE(num_slots, 1) << "ValueError: num_slots must be positive, but got " << num_slots;
+  auto pass_func = [=](Function func, IRModule, PassContext) -> Function {
+    if (!func->GetAttr<String>(tvm::attr::kGlobalSymbol).defined()) {
+      return func;
+    }
+    return ParamStreamer(lookahead, num_slots).Run(func);
+  };
+  return CreateFunctionPass(/*pass_function=*/pass_func,
+                            /*opt_level=*/0,
+                            /*pass_name=*/"StreamParams",
+                            /*required=*/{});
+}
+
+TVM_REGISTER_GLOBAL("relax.transform.StreamParams").set_body_typed(StreamParams);
+
+}  // namespace transform
+}  // namespace relax
+}  // namespace tvm
@@ -21,17 +21,24 @@
  * \brief Automatic mixed precision pass.
  */
 
+#include <tvm/relax/attrs/manipulate.h>
 #include <tvm/relax/expr_functor.h>
 #include <tvm/relax/op_attr_types.h>
 #include <tvm/relax/transform.h>
 
 #include <array>
 #include <cstdint>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
 
 #include "../op/nn/convolution.h"
+#include "../op/tensor/binary.h"
 #include "../op/tensor/datatype.h"
 #include "../op/tensor/linear_algebra.h"
+#include "../op/tensor/manipulate.h"
+#include "../op/tensor/statistical.h"
+#include "../op/tensor/unary.h"
 #include "infer_amp_utils.h"
 #include "utils.h"
 
@@ -113,6 +120,18 @@ int GetMixedPrecisionInfo(const CallNode* call_node) {
  *
  *   When we encounter the var afterwards, we will directly replace it with the parameter. This
  *   information is tracked by the const_map_.
+ *
+ * FP8 matmuls:
+ *   With fp8_matmul, a matmul whose rhs is the transpose of a 2-D tensor, as emitted for linear
+ *   layers, is computed in float8 e4m3 instead of fp16. Each operand is quantized with a
+ *   per-tensor scale computed from its absolute maximum, and the fp32 result of the matmul is
+ *   multiplied by the product of the two scales before being cast to fp16:
+ *
+ *     out = astype(matmul(x_fp8, permute_dims(w_fp8), "float32") * (x_scale * w_scale), fp16)
+ *
+ *   which is the pattern offloaded to the FP8 matmul of cuBLASLt by partition_for_cublas, with
+ *   the scales as its A_SCALE_POINTER and B_SCALE_POINTER. The other ops keep their policy, so
+ *   that reductions and normalizations stay in fp16 or fp32.
  */
 class DTypeDecisionCollector : public ExprVisitor {
  public:
@@ -273,10 +292,12 @@ class DTypeDecisionCollector : public ExprVisitor {
 class ToMixedPrecisionRewriter : public ExprMutator {
  public:
   explicit ToMixedPrecisionRewriter(const VarDTypeMap* only_fp16_map, DataType output_dtype,
-                                    const std::unordered_set<std::string>& fp16_input_names)
+                                    const std::unordered_set<std::string>& fp16_input_names,
+                                    bool fp8_matmul)
       : only_fp16_map_(only_fp16_map),
         output_dtype_(output_dtype),
-        fp16_input_names_(fp16_input_names) {}
+        fp16_input_names_(fp16_input_names),
+        fp8_matmul_(fp8_matmul) {}
 
  private:
   Var GetRemapped(const Var& var) {
@@ -427,6 +448,67 @@ class ToMixedPrecisionRewriter : public ExprMutator {
     }
   }
 
+  /*! \brief The operand of the 2-D transpose bound to the expr, if it is one */
+  Optional<Expr> GetTransposedOperand(const Expr& expr) {
+    const auto* var = expr.as<VarNode>();
+    if (var == nullptr) return NullOpt;
+    auto it = bound_values_.find(var);
+    if (it == bound_values_.end()) return NullOpt;
+    const auto* call = it->second.as<CallNode>();
+    if (call == nullptr || !call->op.same_as(permute_dims_op_)) return NullOpt;
+    const auto* sinfo = GetStructInfoAs<TensorStructInfoNode>(call->args[0]);
+    if (sinfo == nullptr || sinfo->ndim != 2) return NullOpt;
+    const auto* attrs = call->attrs.as<PermuteDimsAttrs>();
+    if (attrs->axes.defined() &&
+        !(attrs->axes.value()[0]->value == 1 && attrs->axes.value()[1]->value == 0)) {
+      return NullOpt;
+    }
+    return call->args[0];
+  }
+
+  /*!
+   * \brief Quantize a tensor to float8 e4m3, scaling it by its absolute maximum.
+   * \return The quantized tensor and its fp32 scale of shape (1,)
+   */
+  std::pair<Expr, Expr> QuantizeToFP8(const Expr& expr) {
+    constexpr double fp8_e4m3_max = 448;
+    Expr x = RewriteExpr(expr, NTypeFrom(expr, fp32_));
+    if (!x->IsInstance<VarNode>()) {
+      x = builder_->Emit(x);
+    }
+    Expr amax = builder_->Emit(max(builder_->Emit(abs(x)), NullOpt, false));
+    Expr scale = builder_->Emit(divide(amax, MakeConstantScalar(fp8_e4m3_max, fp32_)));
+    // An all-zero tensor would have a zero scale
+    scale = builder_->Emit(maximum(scale, MakeConstantScalar(1e-12, fp32_)));
+    scale = builder_->Emit(reshape(scale, Array<PrimExpr>{IntImm(DataType::Int(64), 1)}));
+    Expr scaled = builder_->Emit(divide(x, scale));
+    // The cast does not saturate, so the rounding of the division must not overflow it
+    Expr clipped = builder_->Emit(clip(scaled, PrimValue(FloatImm(fp32_, -fp8_e4m3_max)),
+                                       PrimValue(FloatImm(fp32_, fp8_e4m3_max))));
+    return {builder_->Emit(astype(clipped, fp8_)), scale};
+  }
+
+  /*!
+   * \brief Rewrite a matmul into its scaled FP8 form, if its rhs is a transposed 2-D tensor.
+   * \return The result of the matmul cast to out_dtype, or NullOpt if it is not rewritten
+   */
+  Optional<Expr> RewriteMatmulToFP8(const CallNode* call, DataType out_dtype) {
+    Optional<Expr> rhs = GetTransposedOperand(call->args[1]);
+    if (!rhs) return NullOpt;
+    Array<Expr> operands = RemapArgs({call->args[0], rhs.value()});
+    for (const Expr& operand : operands) {
+      const auto* sinfo = GetStructInfoAs<TensorStructInfoNode>(operand);
+      if (sinfo == nullptr || (sinfo->dtype != fp16_ && sinfo->dtype != fp32_)) return NullOpt;
+    }
+    auto [lhs_fp8, lhs_scale] = QuantizeToFP8(operands[0]);
+    auto [rhs_fp8, rhs_scale] = QuantizeToFP8(operands[1]);
+    Expr rhs_transposed = builder_->Emit(permute_dims(rhs_fp8, NullOpt));
+    Expr out = builder_->Emit(matmul(lhs_fp8, rhs_transposed, fp32_));
+    Expr scale = builder_->Emit(multiply(lhs_scale, rhs_scale));
+    out = builder_->Emit(multiply(out, scale));
+    return astype(out, out_dtype);
+  }
+
   Expr VisitVar_(const Var& var) {
     // We rewrite the remapped var to the original dtype
     auto it = var_remap_.find(var->vid);
@@ -446,6 +528,9 @@ class ToMixedPrecisionRewriter : public ExprMutator {
   Var VisitVarDef(const Var& var) { return GetRemapped(var); }
 
   void VisitBinding(const Binding& binding) {
+    if (const auto* var_binding = binding.as<VarBindingNode>()) {
+      bound_values_[var_binding->var.get()] = var_binding->value;
+    }
     ExprMutator::VisitBinding(binding);
     if (!builder_->CurrentBlockIsDataFlow()) return;
     CastIfFp16Only(binding->var);
@@ -477,6 +562,18 @@ class ToMixedPrecisionRewriter : public ExprMutator {
     // We first to remap the args to the current vars according to the var_remap_
     new_call.CopyOnWrite()->args = RemapArgs(new_call->args);
 
+    if (policy == kAlways && fp8_matmul_ && op.same_as(matmul_op_)) {
+      // Non-Dataflow var: store the tensor to the original dtype, otherwise to fp16. The cast
+      // ends the pattern of cuBLASLt even if it is to the dtype of the matmul.
+      DataType out_dtype = binding->var->IsInstance<DataflowVarNode>()
+                               ? fp16_
+                               : GetStructInfoAs<TensorStructInfoNode>(binding->var)->dtype;
+      if (Optional<Expr> new_value = RewriteMatmulToFP8(call_node, out_dtype)) {
+        ReEmitBinding(binding, builder_->Normalize(new_value.value()));
+        return;
+      }
+    }
+
     // Then we rewrite the args according to the policy
     std::optional<DataType> opt_new_dtype = std::nullopt;
 
@@ -593,30 +690,37 @@ class ToMixedPrecisionRewriter : public ExprMutator {
 
   DataType fp16_ = DataType(DataType::TypeCode::kFloat, 16, 1);
   DataType fp32_ = DataType(DataType::TypeCode::kFloat, 32, 1);
+  DataType fp8_ = DataType::NVFloat8E4M3();
   DataType output_dtype_;
   Array<Var> params_;
   std::unordered_set<std::string> fp16_input_names_;
+  bool fp8_matmul_;
+  // The values bound to the vars of the input function
+  std::unordered_map<const VarNode*, Expr> bound_values_;
 
   const Op& wrap_param_op = Op::Get("relax.wrap_param");
+  const Op& matmul_op_ = Op::Get("relax.matmul");
+  const Op& permute_dims_op_ = Op::Get("relax.permute_dims");
 };
 
 Expr ToMixedPrecision(const Function& f, const DataType& out_dtype,
-                      Optional<Array<String>> fp16_input_names) {
+                      Optional<Array<String>> fp16_input_names, bool fp8_matmul) {
   VarDTypeMap only_fp16_map = std::move(DTypeDecisionCollector::Collect(f, out_dtype));
   std::unordered_set<std::string> fp16_input_names_set;
   if (fp16_input_names) {
     fp16_input_names_set.insert(fp16_input_names.value().begin(), fp16_input_names.value().end());
   }
-  ToMixedPrecisionRewriter mutator(&only_fp16_map, out_dtype, fp16_input_names_set);
+  ToMixedPrecisionRewriter mutator(&only_fp16_map, out_dtype, fp16_input_names_set, fp8_matmul);
   return mutator(f);
 }
 
 namespace transform {
 
-Pass ToMixedPrecision(const DataType& out_dtype, Optional<Array<String>> fp16_input_names) {
+Pass ToMixedPrecision(const DataType& out_dtype, Optional<Array<String>> fp16_input_names,
+                      bool fp8_matmul) {
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function f, IRModule m, PassContext pc) {
-        return Downcast<Function>(ToMixedPrecision(f, out_dtype, fp16_input_names));
+        return Downcast<Function>(ToMixedPrecision(f, out_dtype, fp16_input_names, fp8_matmul));
       };
   return CreateFunctionPass(pass_func, 0, "ToMixedPrecision", {});
 }
@@ -366,6 +366,7 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
           auto* src = it->second;
           auto* snode = post_dom_tree.nodes[src->index]->parent->gnode;
           if (groups_[snode->index]->anchor_ref != nullptr) continue;
+          if (!CheckFuse(src, snode)) continue;
           CommitFuse(src, snode);
         }
       }
@@ -403,7 +404,8 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
         auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kInjective; };
         // dom_root_group can also be tuple, as in inception layers
         // CheckPath is needed to avoid fusing two intermediate tuples
-        if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+        if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+            CheckFuse(graph_node, dom_node->parent->gnode)) {
           CommitFuse(graph_node, dom_node->parent->gnode);
         }
       }
@@ -426,7 +428,8 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
         ICHECK(dom_node->parent->gnode != nullptr);
         // The fuse can be executed if all the intermediate ops are still broadcast.
         auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kBroadcast; };
-        if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+        if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+            CheckFuse(graph_node, dom_node->parent->gnode)) {
           CommitFuse(graph_node, dom_node->parent->gnode);
         }
       }
@@ -446,7 +449,8 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
                     kind == kOutEWiseFusable);
           }
         };
-        if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+        if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+            CheckFuse(graph_node, dom_node->parent->gnode)) {
           CommitFuse(graph_node, dom_node->parent->gnode);
         }
       }
@@ -456,7 +460,8 @@ void GraphPartitioner::RunFuse(const IndexedForwardGraph& graph,    //
       if (phase != 1) continue;
       // Check if all path are injective.
       auto fcond = [](OpPatternKind kind, bool is_sink) { return kind <= kInjective; };
-      if (CheckPath(graph_node, dom_node->parent->gnode, fcond)) {
+      if (CheckPath(graph_node, dom_node->parent->gnode, fcond) &&
+          CheckFuse(graph_node, dom_node->parent->gnode)) {
         CommitFuse(graph_node, dom_node->parent->gnode);
       }
     } else {
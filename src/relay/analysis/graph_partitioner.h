@@ -27,8 +27,10 @@
 
 #include <tvm/relay/op_attr_types.h>
 
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "../../support/arena.h"
@@ -162,12 +164,20 @@ class DominatorTree {
  */
 class GraphPartitioner {
  public:
+  /*!
+   * \brief The check whether fusing a node into its post-dominator is profitable.
+   * It is only consulted for the fusions that are legal according to the op patterns.
+   */
+  using FCheckFuse =
+      std::function<bool(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink)>;
+
   explicit GraphPartitioner(support::Arena* arena, int opt_level, size_t max_fuse_depth,
-                            size_t max_function_args)
+                            size_t max_function_args, FCheckFuse fcheck_fuse = nullptr)
       : arena_(arena),
         opt_level_(opt_level),
         max_fuse_depth_(max_fuse_depth),
-        max_function_args_(max_function_args) {}
+        max_function_args_(max_function_args),
+        fcheck_fuse_(std::move(fcheck_fuse)) {}
   /*!
    * \brief Group as a union find data structure.
    */
@@ -215,6 +225,8 @@ class GraphPartitioner {
   size_t max_fuse_depth_;
   /*! \brief The maximum number of arguments in one fused function */
   size_t max_function_args_;
+  /*! \brief The optional check whether a fusion is profitable. */
+  FCheckFuse fcheck_fuse_;
   /*! \brief The internal groups. */
   std::vector<Group*> groups_;
   /*! \brief internal field used for deduplication */
@@ -265,6 +277,14 @@ class GraphPartitioner {
    */
   void CommitFuse(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink);
 
+  /*!
+   * \brief Check whether the fusion of src into sink is profitable.
+   * \return True if there is no profitability check, or the check accepts the fusion.
+   */
+  bool CheckFuse(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink) {
+    return fcheck_fuse_ == nullptr || fcheck_fuse_(src, sink);
+  }
+
   size_t CountNodesUptoSink_(IndexedForwardGraph::Node* src, IndexedForwardGraph::Node* sink);
   // Count the number of additional arguments. In the case of dynamic shape,
   // generated function takes several additional arguments, such as the sizes of
@@ -41,7 +41,10 @@
 
 #include <algorithm>
 #include <list>
+#include <set>
 #include <string>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "../../target/source/codegen_source_base.h"
@@ -412,6 +415,107 @@ class AOTExecutorCodegen : public MixedModeVisitor {
     return tir::Call(DataType::Int(32), tir::builtin::tvm_check_return(), args);
   }
 
+  /*!
+   * \brief Emit a call to a stream hook of the AOT executor runtime.
+   * \param name The name of the hook.
+   * \param hook_args The stream indices passed to the hook.
+   */
+  tir::Stmt CallStreamHook(const std::string& name, const std::vector<int>& hook_args) {
+    Array<PrimExpr> args{tir::StringImm(name)};
+    for (int arg : hook_args) {
+      args.push_back(tir::make_const(DataType::Int(32), arg));
+    }
+    return tir::Evaluate(
+        AddCheckReturn(tir::Call(DataType::Int(32), tir::builtin::tvm_call_packed(), args)));
+  }
+
+  /*!
+   * \brief Assign an operator call to a stream, from the buffers it reads and writes.
+   *
+   * A call continues on the stream of the producer of one of its inputs when that producer is the
+   * last call on its stream, otherwise it starts on the least loaded stream. The call waits for
+   * the streams which last wrote its inputs, and for the streams which still use its outputs.
+   *
+   * \param inputs The buffers read by the call.
+   * \param outputs The buffers written by the call.
+   * \return The stream switch and the event waits to emit before the call.
+   */
+  Array<tir::Stmt> AssignStream(const std::vector<tir::Var>& inputs,
+                                const std::vector<tir::Var>& outputs) {
+    Array<tir::Stmt> stmts;
+    if (num_streams_ <= 1) {
+      return stmts;
+    }
+    int call_index = num_stream_calls_++;
+    int stream = -1;
+    for (const tir::Var& var : inputs) {
+      auto it = buffer_writer_.find(var.get());
+      if (it != buffer_writer_.end() && stream_last_call_[it->second.first] == it->second.second) {
+        stream = it->second.first;
+        break;
+      }
+    }
+    if (stream < 0) {
+      stream = std::distance(stream_load_.begin(),
+                             std::min_element(stream_load_.begin(), stream_load_.end()));
+    }
+    // Ordered so that the emitted waits do not depend on hashing.
+    std::set<int> wait_streams;
+    for (const tir::Var& var : inputs) {
+      auto it = buffer_writer_.find(var.get());
+      if (it != buffer_writer_.end()) {
+        wait_streams.insert(it->second.first);
+      }
+    }
+    for (const tir::Var& var : outputs) {
+      auto it = buffer_writer_.find(var.get());
+      if (it != buffer_writer_.end()) {
+        wait_streams.insert(it->second.first);
+      }
+      auto readers = buffer_readers_.find(var.get());
+      if (readers != buffer_readers_.end()) {
+        wait_streams.insert(readers->second.begin(), readers->second.end());
+      }
+    }
+    wait_streams.erase(stream);
+    for (int src : wait_streams) {
+      stmts.push_back(CallStreamHook("tvm.aot_executor.stream_wait", {src, stream}));
+    }
+    if (stream != current_stream_) {
+      stmts.push_back(CallStreamHook("tvm.aot_executor.set_stream", {stream}));
+      current_stream_ = stream;
+    }
+    for (const tir::Var& var : inputs) {
+      buffer_readers_[var.get()].insert(stream);
+    }
+    for (const tir::Var& var : outputs) {
+      buffer_writer_[var.get()] = {stream, call_index};
+      buffer_readers_.erase(var.get());
+    }
+    stream_last_call_[stream] = call_index;
+    stream_load_[stream]++;
+    return stmts;
+  }
+
+  /*!
+   * \brief Make the first stream wait for all the other streams and switch back to it, so that the
+   *  outputs are complete on the stream the caller synchronizes with.
+   */
+  void JoinStreams() {
+    if (num_streams_ <= 1) {
+      return;
+    }
+    for (int stream = 1; stream < num_streams_; ++stream) {
+      if (stream_load_[stream] != 0) {
+        stmts_.push_back(CallStreamHook("tvm.aot_executor.stream_wait", {stream, 0}));
+      }
+    }
+    if (current_stream_ != 0) {
+      stmts_.push_back(CallStreamHook("tvm.aot_executor.set_stream", {0}));
+      current_stream_ = 0;
+    }
+  }
+
   /*!
    * brief Create a function call
    * \param call_lowered_props The lowered function and the arguments to call it with
@@ -422,6 +526,7 @@ class AOTExecutorCodegen : public MixedModeVisitor {
     std::string func_name = call_lowered_props.lowered_func->name_hint;
     tvm::Array<PrimExpr> args{tvm::tir::StringImm(func_name)};
     std::vector<tir::Stmt> create_func_call_stmts;
+    std::vector<tir::Var> input_vars;
 
     // Pack the inputs
     for (const Expr& arg : call_lowered_props.arguments) {
@@ -436,6 +541,7 @@ class AOTExecutorCodegen : public MixedModeVisitor {
         args.push_back(tvm::tir::Cast(DataType::Handle(32, 1), param_handle));
       } else {
         auto sids = FindExpr(arg);
+        input_vars.insert(input_vars.end(), sids.begin(), sids.end());
         PushArgs(arg, sids, &args);
       }
     }
@@ -443,6 +549,7 @@ class AOTExecutorCodegen : public MixedModeVisitor {
     // Pack the return(s) value. A call node can produce multiple outputs
     auto result_expr_sid = PackSid(result_expr);
     PushArgs(result_expr, result_expr_sid, &args);
+    Array<tir::Stmt> stream_stmts = AssignStream(input_vars, result_expr_sid);
 
     GlobalVar global_var = call_lowered_props.lowered_func;
     bool has_c_device_api_context = device_contexts_.count(global_var) != 0;
@@ -520,7 +627,7 @@ class AOTExecutorCodegen : public MixedModeVisitor {
       }));
     }
 
-    tir::Stmt body = tir::SeqStmt::Flatten(func_call);
+    tir::Stmt body = tir::SeqStmt::Flatten(stream_stmts, func_call);
     stmts_.push_back(body);
   }
 
@@ -1076,6 +1183,20 @@ class AOTExecutorCodegen : public MixedModeVisitor {
   std::unordered_map<std::string, int> io_var_names_;
   /*! \brief A set of variables that are let bound. */
   std::unordered_set<Var, ObjectPtrHash, ObjectPtrEqual> let_bound_vars_;
+  /*! \brief The number of streams the operator calls are distributed over. */
+  int num_streams_ = 1;
+  /*! \brief The stream the next operator call is launched on. */
+  int current_stream_ = 0;
+  /*! \brief The number of operator calls assigned to a stream so far. */
+  int num_stream_calls_ = 0;
+  /*! \brief The number of operator calls assigned to each stream. */
+  std::vector<int> stream_load_;
+  /*! \brief The index of the last operator call assigned to each stream. */
+  std::vector<int> stream_last_call_;
+  /*! \brief The stream and the call index of the last writer of each buffer. */
+  std::unordered_map<const tir::VarNode*, std::pair<int, int>> buffer_writer_;
+  /*! \brief The streams which read each buffer since it was last written. */
+  std::unordered_map<const tir::VarNode*, std::unordered_set<int>> buffer_readers_;
 
  public:
   AOTExecutorCodegen(runtime::Module* mod, const Array<Target>& targets)
@@ -1091,6 +1212,12 @@ class AOTExecutorCodegen : public MixedModeVisitor {
     std::string interface_api =
         executor_config->GetAttr<String>("interface-api").value_or("packed");
     bool unpacked_api = executor_config->GetAttr<Bool>("unpacked-api").value_or(Bool(false));
+    num_streams_ = executor_config->GetAttr<Integer>("num-streams").value_or(1)->value;
+    CHECK_GE(num_streams_, 1) << "num-streams must be positive (got: " << num_streams_ << ")";
+    CHECK(num_streams_ == 1 || runtime_config->name == kTvmRuntimeCpp)
+        << "num-streams > 1 requires the c++ runtime";
+    stream_load_.assign(num_streams_, 0);
+    stream_last_call_.assign(num_streams_, -1);
 
     // Validate choice of unpacked_api and use_call_cpacked_
     if (runtime_config->name == kTvmRuntimeCrt) {
@@ -1220,6 +1347,7 @@ class AOTExecutorCodegen : public MixedModeVisitor {
       return arg_count;
     }();
     VisitExpr(lowered_main_func->body);
+    JoinStreams();
 
     // Create the runner function. Please note that the function is not legal yet
     // because the packed calls arguments are not wrapped in TVMValues. To make this happen we need
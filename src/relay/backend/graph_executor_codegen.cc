@@ -33,7 +33,9 @@
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/function.h>
 
+#include <limits>
 #include <list>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -42,6 +44,7 @@
 #include "../op/memory/device_copy.h"
 #include "../transforms/device_aware_visitors.h"
 #include "./te_compiler.h"
+#include "./token_allocator.h"
 #include "./utils.h"
 
 namespace tvm {
@@ -86,6 +89,9 @@ class GraphNodeRef {
 
   inline void Load(dmlc::JSONReader* reader) { LOG(FATAL) << "Not implemented."; }
 
+  int ident() const { return ident_; }
+  int index() const { return index_; }
+
  protected:
   int ident_;
   int index_{0};
@@ -569,6 +575,14 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
         global_only_scope = false;
       }
     }
+    std::vector<int64_t> storage_offsets, arena_device_types, arena_sizes;
+    bool use_arena = transform::PassContext::Current()
+                         ->GetConfig<Bool>("relay.backend.graph_memory_arena", Bool(false))
+                         .value();
+    if (use_arena && device_types.size() == storage_ids.size()) {
+      PlanArenas(node_row_ptr, storage_scopes, device_types, shapes, dltypes, &storage_ids,
+                 &storage_offsets, &arena_device_types, &arena_sizes);
+    }
     if (global_only_scope) {
       storage_scopes.clear();
     }
@@ -591,12 +605,151 @@ class GraphExecutorCodegen : public backend::MemoizedExprTranslator<std::vector<
     }
     attrs["dltype"].emplace_back(std::string("list_str"));
     attrs["dltype"].emplace_back(dltypes);
+    if (arena_sizes.size()) {
+      attrs["storage_offset"].emplace_back(std::string("list_int"));
+      attrs["storage_offset"].emplace_back(storage_offsets);
+      attrs["arena_device_index"].emplace_back(std::string("list_int"));
+      attrs["arena_device_index"].emplace_back(arena_device_types);
+      attrs["arena_size"].emplace_back(std::string("list_int"));
+      attrs["arena_size"].emplace_back(arena_sizes);
+    }
     writer->WriteObjectKeyValue("attrs", attrs);
     writer->WriteObjectKeyValue("node_row_ptr", node_row_ptr);
     writer->EndObject();
   }
 
  protected:
+  /*!
+   * \brief Pack the storages of the intermediate entries into one arena per device type.
+   *
+   * A storage reused by the memory plan holds a new value each time a node other than a nop
+   * writes it.  Each of these values gets a storage of its own, live from the node writing it to
+   * the last node reading it, in the order of the nodes, which is the order the executor runs
+   * them in.  The storages live at different times then share the memory of the arena.
+   *
+   * The inputs, the parameters and the outputs are left out, as they can be set or shared from
+   * outside, as are the storages with a memory scope or on a device whose pointers cannot be
+   * offset.
+   *
+   * \param node_row_ptr The first entry of each node.
+   * \param storage_scopes The storage scope of each entry.
+   * \param device_types The device type of each entry.
+   * \param shapes The shape of each entry.
+   * \param dltypes The data type of each entry.
+   * \param storage_ids The storage id of each entry, which is updated.
+   * \param storage_offsets The offset of each storage in its arena, -1 if not in an arena.
+   * \param arena_device_types The device type of each arena.
+   * \param arena_sizes The size in bytes of each arena.
+   */
+  void PlanArenas(const std::vector<size_t>& node_row_ptr,
+                  const std::vector<std::string>& storage_scopes,
+                  const std::vector<size_t>& device_types, const ShapeVector& shapes,
+                  const std::vector<std::string>& dltypes, std::vector<size_t>* storage_ids,
+                  std::vector<int64_t>* storage_offsets, std::vector<int64_t>* arena_device_types,
+                  std::vector<int64_t>* arena_sizes) {
+    auto f_entry_id = [&](const GraphNodeRef& ref) {
+      return node_row_ptr[ref.ident()] + ref.index();
+    };
+    size_t num_storages = 0;
+    for (size_t sid : *storage_ids) {
+      num_storages = std::max(num_storages, sid + 1);
+    }
+    std::vector<bool> splittable(num_storages, true);
+    for (size_t nid = 0; nid < nodes_.size(); ++nid) {
+      for (size_t eid = node_row_ptr[nid]; eid < node_row_ptr[nid + 1]; ++eid) {
+        size_t device_type = device_types[eid];
+        const std::string& scope = storage_scopes.empty() ? "" : storage_scopes[eid];
+        // The views into an arena offset its data pointer.
+        bool offsettable = device_type == kDLCPU || device_type == kDLCUDA ||
+                           device_type == kDLCUDAHost || device_type == kDLCUDAManaged ||
+                           device_type == kDLROCM;
+        if (nodes_[nid]->Type() == kGraphInputNode || !offsettable ||
+            !(scope.empty() || scope == "global")) {
+          splittable[(*storage_ids)[eid]] = false;
+        }
+      }
+    }
+
+    // Give each value written to a splittable storage a storage of its own.  A nop writes its
+    // output in the storage of its input, which keeps the value.
+    std::vector<size_t> new_ids(storage_ids->size());
+    std::vector<bool> written(num_storages, false);
+    size_t num_new_storages = num_storages;
+    for (size_t nid = 0; nid < nodes_.size(); ++nid) {
+      std::unordered_map<size_t, size_t> input_ids;
+      if (nodes_[nid]->Type() == kGraphOpNode) {
+        for (const GraphNodeRef& input : static_cast<GraphOpNode*>(nodes_[nid].get())->inputs_) {
+          input_ids[(*storage_ids)[f_entry_id(input)]] = new_ids[f_entry_id(input)];
+        }
+      }
+      for (size_t eid = node_row_ptr[nid]; eid < node_row_ptr[nid + 1]; ++eid) {
+        size_t sid = (*storage_ids)[eid];
+        auto it = input_ids.find(sid);
+        if (!splittable[sid]) {
+          new_ids[eid] = sid;
+        } else if (it != input_ids.end()) {
+          new_ids[eid] = it->second;
+        } else if (!written[sid]) {
+          new_ids[eid] = sid;
+          written[sid] = true;
+        } else {
+          new_ids[eid] = num_new_storages++;
+        }
+      }
+    }
+
+    std::vector<ArenaBlock> blocks(num_new_storages);
+    std::vector<bool> packable(num_new_storages, false);
+    std::vector<int64_t> storage_devices(num_new_storages, -1);
+    for (size_t sid = 0; sid < num_new_storages; ++sid) {
+      blocks[sid] = {static_cast<int64_t>(sid), 0, std::numeric_limits<int64_t>::max(), -1};
+    }
+    auto f_use = [&](size_t eid, int64_t nid) {
+      ArenaBlock& block = blocks[new_ids[eid]];
+      block.start = std::min(block.start, nid);
+      block.end = std::max(block.end, nid);
+    };
+    for (size_t nid = 0; nid < nodes_.size(); ++nid) {
+      if (nodes_[nid]->Type() == kGraphOpNode) {
+        for (const GraphNodeRef& input : static_cast<GraphOpNode*>(nodes_[nid].get())->inputs_) {
+          f_use(f_entry_id(input), nid);
+        }
+      }
+      for (size_t eid = node_row_ptr[nid]; eid < node_row_ptr[nid + 1]; ++eid) {
+        size_t sid = new_ids[eid];
+        f_use(eid, nid);
+        DLDataType dtype = runtime::String2DLDataType(dltypes[eid]);
+        size_t size = (dtype.bits * dtype.lanes + 7) / 8;
+        for (int64_t dim : shapes[eid]) {
+          size *= static_cast<size_t>(dim);
+        }
+        blocks[sid].size = std::max(blocks[sid].size, size);
+        storage_devices[sid] = device_types[eid];
+        packable[sid] = splittable[(*storage_ids)[eid]];
+      }
+    }
+    for (const GraphNodeRef& head : heads_) {
+      packable[new_ids[f_entry_id(head)]] = false;
+    }
+
+    storage_offsets->assign(num_new_storages, -1);
+    std::map<int64_t, std::vector<ArenaBlock>> arenas;
+    for (size_t sid = 0; sid < num_new_storages; ++sid) {
+      if (packable[sid] && blocks[sid].size > 0) {
+        arenas[storage_devices[sid]].push_back(blocks[sid]);
+      }
+    }
+    for (auto& kv : arenas) {
+      size_t arena_size = PackBlocksIntoArena(&kv.second, runtime::kAllocAlignment);
+      for (const ArenaBlock& block : kv.second) {
+        (*storage_offsets)[block.storage_id] = static_cast<int64_t>(block.offset);
+      }
+      arena_device_types->push_back(kv.first);
+      arena_sizes->push_back(static_cast<int64_t>(arena_size));
+    }
+    *storage_ids = std::move(new_ids);
+  }
+
   /*! \brief nodes */
   std::vector<GraphObjectPtr> nodes_;
   /*! \brief output of graph */
@@ -703,6 +856,8 @@ runtime::Module CreateGraphCodegenMod() {
 TVM_REGISTER_GLOBAL("relay.build_module._GraphExecutorCodegen")
     .set_body([](TVMArgs args, TVMRetValue* rv) { *rv = CreateGraphCodegenMod(); });
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.graph_memory_arena", Bool);
+
 }  // namespace backend
 }  // namespace relay
 }  // namespace tvm
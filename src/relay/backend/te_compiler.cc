@@ -93,6 +93,8 @@
 #include <tvm/ir/attrs.h>
 #include <tvm/ir/function.h>
 #include <tvm/ir/name_supply.h>
+#include <tvm/meta_schedule/database.h>
+#include <tvm/node/structural_equal.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/annotation.h>
 #include <tvm/relay/attrs/call.h>
@@ -102,14 +104,19 @@
 #include <tvm/relay/op.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/te/schedule.h>
 #include <tvm/te/schedule_pass.h>
 #include <tvm/tir/transform.h>
 #include <tvm/topi/tags.h>
 
+#include <algorithm>
 #include <functional>
 #include <limits>
 #include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -133,6 +140,95 @@ using namespace tvm::relay::transform;
 
 TVM_REGISTER_OBJECT_TYPE(TECompilerNode);
 
+/*!
+ * \brief A cache of the lowered primitive functions shared by all the builds of the process.
+ *
+ * Enabled by the "relay.backend.te_compiler_process_cache" pass config option. The functions
+ * are lowered under their candidate names, and renamed for each module they are used in. The
+ * options of the pass context change the lowering, so they are part of the key. The tuning
+ * records applied from Python (e.g. AutoTVM dispatch contexts) are not, which is why the cache
+ * is opt-in, and it is bypassed when auto_scheduler or MetaSchedule is in use.
+ */
+class LoweredFuncProcessCache {
+ public:
+  static LoweredFuncProcessCache* Global() {
+    static LoweredFuncProcessCache* inst = new LoweredFuncProcessCache();
+    return inst;
+  }
+
+  /*! \brief Whether the cache is enabled in the current pass context. */
+  static bool Enabled() {
+    transform::PassContext ctx = transform::PassContext::Current();
+    return ctx->GetConfig<Bool>("relay.backend.te_compiler_process_cache", Bool(false)).value() &&
+           !backend::IsAutoSchedulerEnabled() && !meta_schedule::Database::Current().defined();
+  }
+
+  Optional<CachedFunc> Get(const CCacheKey& key) {
+    std::string context = ContextKey();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cache_.find(context);
+    if (it == cache_.end()) return NullOpt;
+    auto func_it = it->second.find(key);
+    if (func_it == it->second.end()) return NullOpt;
+    return func_it->second;
+  }
+
+  void Set(const CCacheKey& key, const CachedFunc& cached_func) {
+    // The constant tensors of a function are keyed by the constants of the source function it was
+    // lowered from, so it cannot be shared with the structurally equal functions.
+    if (cached_func->funcs->functions.size() != 1 || !cached_func->constant_tensors.empty()) {
+      return;
+    }
+    std::string context = ContextKey();
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_[context].emplace(key, cached_func);
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+  }
+
+ private:
+  static std::string ContextKey() {
+    transform::PassContext ctx = transform::PassContext::Current();
+    std::ostringstream os;
+    os << ctx->opt_level << ctx->required_pass << ctx->disabled_pass << ctx->config;
+    return os.str();
+  }
+
+  /*!
+   * \brief Compares the keys by the memory scopes of their virtual devices, which is the part of
+   * them used by the lowering, as the virtual devices are only unique within a compilation.
+   */
+  struct KeyEqual {
+    bool operator()(const CCacheKey& lhs, const CCacheKey& rhs) const {
+      return lhs->Hash() == rhs->Hash() && lhs->target->str() == rhs->target->str() &&
+             lhs->virtual_device->memory_scope == rhs->virtual_device->memory_scope &&
+             tvm::StructuralEqual()(lhs->source_func, rhs->source_func);
+    }
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string,
+                     std::unordered_map<CCacheKey, CachedFunc, std::hash<CCacheKey>, KeyEqual>>
+      cache_;
+};
+
+/*!
+ * \brief Returns \p cached_func bound to \p prim_fn_var, which renames its PrimFunc.
+ */
+CachedFunc WithPrimFnVar(const CachedFunc& cached_func, const GlobalVar& prim_fn_var) {
+  ICHECK_EQ(cached_func->funcs->functions.size(), 1);
+  prim_fn_var->checked_type_ = cached_func->prim_fn_var->checked_type_;
+  auto func = Downcast<tir::PrimFunc>(cached_func->funcs->Lookup(cached_func->prim_fn_var));
+  auto n = make_object<CachedFuncNode>(*cached_func.get());
+  n->prim_fn_var = prim_fn_var;
+  n->funcs = IRModule(Map<GlobalVar, BaseFunc>({}));
+  n->funcs->Add(prim_fn_var, WithAttr(func, tvm::attr::kGlobalSymbol, prim_fn_var->name_hint));
+  return CachedFunc(n);
+}
+
 class TECompilerImpl : public TECompilerNode {
  public:
   explicit TECompilerImpl(Optional<IRModule> opt_mod, Optional<String> opt_mod_name)
@@ -172,6 +268,72 @@ class TECompilerImpl : public TECompilerNode {
     return LowerShapeFuncInternal(key)->cached_func;
   }
 
+  void LowerAll(const std::vector<CCacheKey>& keys, int num_threads) final {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool use_process_cache = LoweredFuncProcessCache::Enabled();
+    // The TE compute and the schedules come from the op strategies, and the names of the functions
+    // must not depend on the threads, so the functions are created serially in the order of the
+    // keys. The lowering of their schedules to TIR is what runs in parallel.
+    std::vector<CCacheKey> lowered_keys;
+    std::vector<CCacheValue> values;
+    std::vector<bool> from_process_cache;
+    for (const CCacheKey& key : keys) {
+      if (cache_.count(key) || key->source_func->GetAttr<String>(attr::kCompiler).defined()) {
+        continue;
+      }
+      // The uses are counted when the functions are looked up by Lower.
+      CCacheValue value(make_object<CCacheValueNode>());
+      cache_[key] = value;
+      lowered_keys.push_back(key);
+      values.push_back(value);
+      Optional<CachedFunc> cached_func;
+      if (use_process_cache) {
+        cached_func = LoweredFuncProcessCache::Global()->Get(key);
+      }
+      from_process_cache.push_back(cached_func.defined());
+      if (cached_func) {
+        value->cached_func = cached_func.value();
+      } else {
+        With<Target> target_scope(key->target);
+        value->cached_func =
+            PrimFuncFor(key->source_func, key->target,
+                        use_process_cache ? GlobalVarSupply() : global_var_supply_,
+                        constant_name_supply_);
+      }
+    }
+
+    // The pass context is thread local. Its instruments are not thread safe, so they are left out.
+    transform::PassContext current = transform::PassContext::Current();
+    transform::PassContext worker_ctx = transform::PassContext::Create();
+    worker_ctx->opt_level = current->opt_level;
+    worker_ctx->required_pass = current->required_pass;
+    worker_ctx->disabled_pass = current->disabled_pass;
+    worker_ctx->config = current->config;
+    support::parallel_for_dynamic(
+        0, static_cast<int>(values.size()), num_threads, [&](int thread_id, int task_id) {
+          if (from_process_cache[task_id]) return;
+          const CCacheKey& key = lowered_keys[task_id];
+          const CachedFunc& cached_func = values[task_id]->cached_func;
+          With<transform::PassContext> ctx_scope(worker_ctx);
+          With<Target> target_scope(key->target);
+          GlobalVarSupply global_var_supply(
+              NameSupply(), {{cached_func->prim_fn_var->name_hint, cached_func->prim_fn_var}});
+          LowerCachedFunc(key, cached_func, global_var_supply);
+        });
+
+    if (use_process_cache) {
+      for (size_t i = 0; i < values.size(); ++i) {
+        CachedFunc cached_func = values[i]->cached_func;
+        if (!from_process_cache[i]) {
+          LoweredFuncProcessCache::Global()->Set(lowered_keys[i], cached_func);
+        }
+        String candidate_name = cached_func->prim_fn_var->name_hint;
+        values[i]->cached_func =
+            WithPrimFnVar(cached_func, global_var_supply_->FreshGlobal(candidate_name));
+      }
+    }
+  }
+
   IRModule GetLoweredFunctions() {
     VLOG(1) << "GetLoweredFunctions";
     IRModule mod;
@@ -390,25 +552,44 @@ class TECompilerImpl : public TECompilerNode {
     With<Target> target_scope(key->target);
 
     ICHECK(!value->cached_func.defined());
-    value->cached_func =
-        PrimFuncFor(key->source_func, key->target, global_var_supply, constant_name_supply_);
+    if (LoweredFuncProcessCache::Enabled()) {
+      value->cached_func = LowerWithProcessCache(key, global_var_supply);
+    } else {
+      value->cached_func =
+          PrimFuncFor(key->source_func, key->target, global_var_supply, constant_name_supply_);
+      LowerCachedFunc(key, value->cached_func, global_var_supply);
+    }
+    VLOG(1) << "lowered to name:" << std::endl
+            << PrettyPrint(value->cached_func->prim_fn_var) << std::endl
+            << "with definitions:" << std::endl
+            << PrettyPrint(value->cached_func->funcs);
+
+    return value;
+  }
 
-    if (value->cached_func->prim_func.defined()) {
+  /*!
+   * \brief Lower the schedule or the PrimFunc of \p cached_func to TIR, into its funcs.
+   *
+   * \p global_var_supply must give the prim_fn_var of \p cached_func for its name.
+   */
+  void LowerCachedFunc(const CCacheKey& key, const CachedFunc& cached_func,
+                       GlobalVarSupply global_var_supply) {
+    if (cached_func->prim_func.defined()) {
       VLOG(1) << "Lowering PrimFunc";
-      IRModule lowered = tvm::LowerPrimFunc(value->cached_func->prim_func.value(),
-                                            value->cached_func->prim_fn_var->name_hint, false);
+      IRModule lowered = tvm::LowerPrimFunc(cached_func->prim_func.value(),
+                                            cached_func->prim_fn_var->name_hint, false);
       ICHECK_EQ(lowered->functions.size(), 1);
       for (const auto& kv : lowered->functions) {
-        value->cached_func->funcs->Add(value->cached_func->prim_fn_var, kv.second);
+        cached_func->funcs->Add(cached_func->prim_fn_var, kv.second);
       }
     } else {
       // NOTE: array will copy on write.
-      Array<te::Tensor> all_args = Array<te::Tensor>(value->cached_func->inputs);
-      for (te::Tensor arg : value->cached_func->outputs) {
+      Array<te::Tensor> all_args = Array<te::Tensor>(cached_func->inputs);
+      for (te::Tensor arg : cached_func->outputs) {
         all_args.push_back(arg);
       }
       Array<runtime::NDArray> all_consts;
-      for (auto kv : value->cached_func->constant_tensors) {
+      for (auto kv : cached_func->constant_tensors) {
         all_args.push_back(kv.second);
         all_consts.push_back(kv.first->data);
       }
@@ -420,7 +601,7 @@ class TECompilerImpl : public TECompilerNode {
       for (Var param : key->source_func->params) {
         if (!param->virtual_device()->memory_scope.empty()) {
           for (const auto& ttype : FlattenTupleType(param->checked_type())) {
-            te::Tensor x_ref = value->cached_func->inputs[i];
+            te::Tensor x_ref = cached_func->inputs[i];
             // verification if we have synced params and tensors
             ICHECK(ttype->dtype == x_ref->dtype && ttype->shape.size() == x_ref->shape.size())
                 << "function parameter does not correspond to prepared tensor";
@@ -434,16 +615,16 @@ class TECompilerImpl : public TECompilerNode {
       if (key->virtual_device != VirtualDevice::FullyUnconstrained() &&
           !key->virtual_device->memory_scope.empty() &&
           key->virtual_device->memory_scope != "global") {
-        ICHECK(value->cached_func->outputs.size() == 1)
+        ICHECK(cached_func->outputs.size() == 1)
             << "Expect only one output for defined memory scope";
-        te::Tensor x_ref = value->cached_func->outputs[0];
+        te::Tensor x_ref = cached_func->outputs[0];
         binds[x_ref] =
             tir::BufferWithOffsetAlignment(x_ref->shape, x_ref->dtype, x_ref->op->name, -1, 0,
                                            false, key->virtual_device->memory_scope);
       }
-      auto func_name = value->cached_func->prim_fn_var->name_hint;
+      auto func_name = cached_func->prim_fn_var->name_hint;
       VLOG(1) << "scheduling";
-      IRModule scheduled_module = tvm::LowerSchedule(value->cached_func->schedule, all_args,
+      IRModule scheduled_module = tvm::LowerSchedule(cached_func->schedule, all_args,
                                                      func_name, binds, global_var_supply);
       scheduled_module->Update(tir::transform::BindParams(all_consts)(scheduled_module));
       for (const auto& kv : scheduled_module->functions) {
@@ -455,17 +636,30 @@ class TECompilerImpl : public TECompilerNode {
         if (hash) {
           func = WithAttrs(Downcast<tir::PrimFunc>(func), {{String("hash"), hash.value()}});
         }
-        value->cached_func->funcs->Add(global_var, func);
+        cached_func->funcs->Add(global_var, func);
       }
-      ICHECK(value->cached_func->funcs->Lookup(value->cached_func->prim_fn_var)
-                 .as<tir::PrimFuncNode>());
+      ICHECK(cached_func->funcs->Lookup(cached_func->prim_fn_var).as<tir::PrimFuncNode>());
     }
-    VLOG(1) << "lowered to name:" << std::endl
-            << PrettyPrint(value->cached_func->prim_fn_var) << std::endl
-            << "with definitions:" << std::endl
-            << PrettyPrint(value->cached_func->funcs);
+  }
 
-    return value;
+  /*!
+   * \brief Lower through the process-wide cache: the function is lowered under its candidate name
+   * and shared, then renamed with a fresh name of \p global_var_supply.
+   */
+  CachedFunc LowerWithProcessCache(const CCacheKey& key, GlobalVarSupply global_var_supply) {
+    Optional<CachedFunc> cached_func = LoweredFuncProcessCache::Global()->Get(key);
+    if (cached_func) {
+      VLOG(1) << "reusing from the process cache:" << std::endl
+              << PrettyPrint(cached_func.value()->prim_fn_var);
+    } else {
+      GlobalVarSupply candidate_supply;
+      cached_func =
+          PrimFuncFor(key->source_func, key->target, candidate_supply, constant_name_supply_);
+      LowerCachedFunc(key, cached_func.value(), candidate_supply);
+      LoweredFuncProcessCache::Global()->Set(key, cached_func.value());
+    }
+    String candidate_name = cached_func.value()->prim_fn_var->name_hint;
+    return WithPrimFnVar(cached_func.value(), global_var_supply->FreshGlobal(candidate_name));
   }
 
   // implement lowered shape func
@@ -551,6 +745,8 @@ TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_auto_scheduler", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_meta_schedule", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_meta_schedule_dispatch", Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.tir_converter", String);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.te_compiler_num_threads", Integer);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.te_compiler_process_cache", Bool);
 
 TVM_REGISTER_GLOBAL("relay.backend._TECompilerGlobal").set_body_typed([]() {
   return TECompiler::Global();
@@ -570,6 +766,10 @@ TVM_REGISTER_GLOBAL("relay.backend._TECompilerClear").set_body_typed([](TECompil
   self->Clear();
 });
 
+TVM_REGISTER_GLOBAL("relay.backend._TECompilerClearProcessCache").set_body_typed([]() {
+  LoweredFuncProcessCache::Global()->Clear();
+});
+
 TVM_REGISTER_GLOBAL("relay.backend._TECompilerLower")
     .set_body_typed([](TECompiler self, CCacheKey key, const String mod_name) {
       return self->Lower(key, mod_name);
@@ -586,6 +786,62 @@ TVM_REGISTER_GLOBAL("relay.backend._TECompilerListItems").set_body_typed([](TECo
 
 using AnalysisRemapping = std::unordered_map<Expr, Expr, ObjectHash, ObjectEqual>;
 
+/*!
+ * \brief Returns the primitive function associated with \p expr, or nullptr if none.
+ * \param module The module of the global functions.
+ * \param primitive_functions The in-scope let-bound variables known to be bound to primitives.
+ */
+BaseFunc ResolveToPrimitive(const IRModule& module,
+                            const std::unordered_map<const VarNode*, BaseFunc>& primitive_functions,
+                            const Expr& expr) {
+  // Cache ops that need to be frequently used later to reduce lookup overhead.
+  static const Op& debug_op = Op::Get("debug");
+  // NOTE: We can't assume expr->checked_type_ is defined, so can't early exit for first-order
+  // expressions.
+  if (const auto* global_var_node = expr.as<GlobalVarNode>()) {
+    if (!module->ContainGlobalVar(global_var_node->name_hint)) {
+      // TODO(mbs): extern function cleanup
+      // Assume the function is extern and thus no longer in the IRModule.
+      return {};
+    } else {
+      BaseFunc base_func = module->Lookup(GetRef<GlobalVar>(global_var_node));
+      return ResolveToPrimitive(module, primitive_functions, base_func);
+    }
+  } else if (auto prim_func = expr.as<tir::PrimFunc>()) {
+    return prim_func.value();
+  } else if (const auto* var_node = expr.as<VarNode>()) {
+    auto itr = primitive_functions.find(var_node);
+    if (itr == primitive_functions.end()) {
+      // Not bound to a primitive function.
+      return {};
+    } else {
+      return itr->second;
+    }
+  } else if (const auto* function_node = expr.as<FunctionNode>()) {
+    if (function_node->HasNonzeroAttr(attr::kExtern)) {
+      // We have a regular call to an 'extern' function. The call itself needs to be rewritten
+      // to call_lowered form, and any required dynamic shape functions generated and
+      // cross-linked.
+      return GetRef<Function>(function_node);
+    } else if (function_node->HasNonzeroAttr(attr::kPrimitive)) {
+      if (const auto* call_node = function_node->body.as<CallNode>()) {
+        if (call_node->op == debug_op) {
+          // Debug 'primitives' are not lowered.
+          return {};
+        }
+      }
+      // We have a regular call to a 'primitive' function (possibly with a 'Compiler' attribute).
+      // We need to lower and rewrite the call.
+      return GetRef<Function>(function_node);
+    } else {
+      // Not marked as primitive during partitioning or TVM fusion.
+      return {};
+    }
+  } else {
+    return {};
+  }
+}
+
 /*!
  * \brief Rewrites call expressions to Relay Functions marked as "primitive"
  * to calls to the corresponding TIR PrimFunc for the appropriate target.
@@ -632,57 +888,13 @@ class LowerTensorExprMutator : public DeviceAwareExprMutator {
         module_(std::move(module)),
         process_fn_(std::move(process_fn)),
         config_(std::move(config)),
-        compiler_(std::move(compiler)),
-        debug_op_(Op::Get("debug")) {}
+        compiler_(std::move(compiler)) {}
 
   /*!
    *  \brief Returns the primitive function associated with \p expr, or nullptr if none.
    */
   BaseFunc ResolveToPrimitive(const Expr& expr) {
-    // NOTE: We can't assume expr->checked_type_ is defined, so can't early exit for first-order
-    // expressions.
-    if (const auto* global_var_node = expr.as<GlobalVarNode>()) {
-      if (!module_->ContainGlobalVar(global_var_node->name_hint)) {
-        // TODO(mbs): extern function cleanup
-        // Assume the function is extern and thus no longer in the IRModule.
-        return {};
-      } else {
-        BaseFunc base_func = module_->Lookup(GetRef<GlobalVar>(global_var_node));
-        return ResolveToPrimitive(base_func);
-      }
-    } else if (auto prim_func = expr.as<tir::PrimFunc>()) {
-      return prim_func.value();
-    } else if (const auto* var_node = expr.as<VarNode>()) {
-      auto itr = primitive_functions_.find(var_node);
-      if (itr == primitive_functions_.end()) {
-        // Not bound to a primitive function.
-        return {};
-      } else {
-        return itr->second;
-      }
-    } else if (const auto* function_node = expr.as<FunctionNode>()) {
-      if (function_node->HasNonzeroAttr(attr::kExtern)) {
-        // We have a regular call to an 'extern' function. The call itself needs to be rewritten
-        // to call_lowered form, and any required dynamic shape functions generated and
-        // cross-linked.
-        return GetRef<Function>(function_node);
-      } else if (function_node->HasNonzeroAttr(attr::kPrimitive)) {
-        if (const auto* call_node = function_node->body.as<CallNode>()) {
-          if (call_node->op == debug_op_) {
-            // Debug 'primitives' are not lowered.
-            return {};
-          }
-        }
-        // We have a regular call to a 'primitive' function (possibly with a 'Compiler' attribute).
-        // We need to lower and rewrite the call.
-        return GetRef<Function>(function_node);
-      } else {
-        // Not marked as primitive during partitioning or TVM fusion.
-        return {};
-      }
-    } else {
-      return {};
-    }
+    return tec::ResolveToPrimitive(module_, primitive_functions_, expr);
   }
 
   /*!
@@ -946,8 +1158,72 @@ class LowerTensorExprMutator : public DeviceAwareExprMutator {
   // lowered for multiple device types, each which will be assigned a fresh var.
   std::unordered_map<const VarNode*, BaseFunc> primitive_functions_;
   TECompiler compiler_;
-  // Cache ops that need to be frequently used later to reduce lookup overhead.
-  const Op& debug_op_;
+};
+
+/*!
+ * \brief Collects the keys of the primitive functions which LowerTensorExprMutator lowers with
+ * the TE compiler, in the order it lowers them.
+ */
+class PrimitiveCallCollector : public DeviceAwareExprVisitor {
+ public:
+  explicit PrimitiveCallCollector(IRModule module)
+      : DeviceAwareExprVisitor(module), module_(std::move(module)) {}
+
+  /*! \brief Returns the keys of the primitive functions called by the functions of the module. */
+  std::vector<CCacheKey> Collect() {
+    for (const auto& kv : module_->functions) {
+      if (const auto* function_node = kv.second.as<FunctionNode>()) {
+        if (!function_node->GetAttr<String>(attr::kCompiler).defined()) {
+          VisitExpr(GetRef<Function>(function_node));
+        }
+      }
+    }
+    return std::move(keys_);
+  }
+
+  void PreVisitLetBinding_(const Var& var, const Expr& value) final {
+    DeviceAwareExprVisitor::PreVisitLetBinding_(var, value);
+    BaseFunc prim_func = ResolveToPrimitive(module_, primitive_functions_, value);
+    if (prim_func.defined()) {
+      primitive_functions_.emplace(var.get(), prim_func);
+    }
+  }
+
+  void PostVisitLet_(const LetNode* let_node) final {
+    primitive_functions_.erase(let_node->var.get());
+  }
+
+  void DeviceAwareVisitExpr_(const FunctionNode* function_node) final {
+    if (!function_node->HasNonzeroAttr(attr::kPrimitive) &&
+        !function_node->HasNonzeroAttr(attr::kExtern)) {
+      DeviceAwareExprVisitor::DeviceAwareVisitExpr_(function_node);
+    }
+  }
+
+  void DeviceAwareVisitExpr_(const CallNode* call_node) final {
+    for (const auto& arg : call_node->args) {
+      VisitExpr(arg);
+    }
+    VisitExpr(call_node->op);
+
+    // Only the primitives lowered by the TE compiler, see cases 1 and 2 of the mutator. The
+    // external functions are left to LowerExternalFunctions.
+    BaseFunc primitive_func = ResolveToPrimitive(module_, primitive_functions_, call_node->op);
+    const auto* function_node = primitive_func.as<FunctionNode>();
+    if (function_node == nullptr || function_node->HasNonzeroAttr(attr::kExtern) ||
+        function_node->GetAttr<String>(attr::kCompiler).defined() ||
+        GetDeviceCopyProps(function_node->body).body.defined()) {
+      return;
+    }
+    VirtualDevice virtual_device = GetVirtualDevice(GetRef<Call>(call_node));
+    if (virtual_device->IsFullyUnconstrained()) return;
+    keys_.emplace_back(GetRef<Function>(function_node), virtual_device->target, virtual_device);
+  }
+
+ private:
+  IRModule module_;
+  std::unordered_map<const VarNode*, BaseFunc> primitive_functions_;
+  std::vector<CCacheKey> keys_;
 };
 
 Pass LowerTensorExpr(TECompiler compiler, ProcessFn process_fn, CompilationConfig config) {
@@ -1187,6 +1463,18 @@ IRModule LowerTE(const IRModule& module, const String& module_name, ProcessFn pr
                  CompilationConfig config) {
   TECompiler compiler(module, module_name);
 
+  // Lower the primitive functions up front when their lowering to TIR may run in parallel.
+  int num_threads = transform::PassContext::Current()
+                        ->GetConfig<Integer>("relay.backend.te_compiler_num_threads", Integer(1))
+                        .value()
+                        ->value;
+  if (num_threads <= 0) {
+    num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  if (num_threads > 1) {
+    compiler->LowerAll(PrimitiveCallCollector(module).Collect(), num_threads);
+  }
+
   // TODO(mbs): This is all unnecessarily convoluted. Better would be to accumulate the rewritten
   // module as we go (including rewritten Functions, lowered primitives, and runtime modules
   // generated by external toolchains), and use a pair of maps over vars and global vars
@@ -48,6 +48,7 @@
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "../transforms/infer_layout_utils.h"
 #include "../transforms/pass_utils.h"
@@ -98,6 +99,13 @@ class TECompilerNode : public Object {
    * \return The result.
    */
   virtual CachedFunc LowerShapeFunc(const CCacheKey& key) = 0;
+  /*!
+   * \brief Lower the functions of \p keys ahead of their lookup by \p Lower, with the lowering
+   * of their schedules to TIR spread over \p num_threads threads.
+   * \param keys The keys to the functions, in the order they are looked up.
+   * \param num_threads The number of threads.
+   */
+  virtual void LowerAll(const std::vector<CCacheKey>& keys, int num_threads) = 0;
   /*!
    * \brief Lower the external function using external codegen tools.
    * \return The runtime modules for each needed external codegen tool.
@@ -197,5 +197,41 @@ runtime::Texture2DShape<int64_t> TokenAllocator2D::GetSize2D(StorageToken* proto
   return runtime::ApplyTexture2DFlattening<int64_t>(Shape{ttype->shape}, ttype->shape.size(), axis);
 }
 
+size_t PackBlocksIntoArena(std::vector<ArenaBlock>* blocks, size_t alignment) {
+  ICHECK_GT(alignment, 0);
+  std::vector<ArenaBlock*> order;
+  for (ArenaBlock& block : *blocks) {
+    order.push_back(&block);
+  }
+  std::sort(order.begin(), order.end(), [](const ArenaBlock* lhs, const ArenaBlock* rhs) {
+    if (lhs->size != rhs->size) return lhs->size > rhs->size;
+    return lhs->storage_id < rhs->storage_id;
+  });
+  size_t arena_size = 0;
+  std::vector<const ArenaBlock*> placed;
+  for (ArenaBlock* block : order) {
+    // The placed blocks live at a same step as this one, by offset.
+    std::vector<const ArenaBlock*> conflicts;
+    for (const ArenaBlock* other : placed) {
+      if (other->start <= block->end && block->start <= other->end) {
+        conflicts.push_back(other);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end(), [](const ArenaBlock* lhs, const ArenaBlock* rhs) {
+      return lhs->offset < rhs->offset;
+    });
+    size_t offset = 0;
+    for (const ArenaBlock* other : conflicts) {
+      if (offset + block->size <= other->offset) break;
+      size_t other_end = other->offset + other->size;
+      offset = std::max(offset, TokenAllocator1D::DivRoundUp(other_end, alignment) * alignment);
+    }
+    block->offset = offset;
+    arena_size = std::max(arena_size, offset + block->size);
+    placed.push_back(block);
+  }
+  return arena_size;
+}
+
 }  // namespace relay
 }  // namespace tvm
@@ -155,6 +155,31 @@ class TokenAllocator2D {
   std::unordered_set<int64_t> free_list_;
 };
 
+/*! \brief A block of memory live over a range of the execution, to be packed into an arena. */
+struct ArenaBlock {
+  /*! \brief The storage id of the block */
+  int64_t storage_id;
+  /*! \brief number of bytes */
+  size_t size;
+  /*! \brief The first and the last step the block is live at, inclusive. */
+  int64_t start;
+  int64_t end;
+  /*! \brief The offset of the block in the arena, set by PackBlocksIntoArena. */
+  size_t offset{0};
+};
+
+/*!
+ * \brief Assign the blocks offsets into one arena, such that the blocks live at the same step
+ * do not overlap.
+ *
+ * The blocks are placed from the largest to the smallest, each at the lowest aligned offset
+ * free over its whole live range.
+ * \param blocks The blocks, whose offsets are set.
+ * \param alignment The alignment of the offsets.
+ * \return The size of the arena.
+ */
+size_t PackBlocksIntoArena(std::vector<ArenaBlock>* blocks, size_t alignment);
+
 }  // namespace relay
 }  // namespace tvm
 
@@ -0,0 +1,383 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/backend/vm/bytecode_optimizer.cc
+ * \brief Optimizations of the bytecode of the VM functions.
+ *
+ *   - A Move between registers each written once is removed, and the reads of its destination
+ *     read its source instead.
+ *   - The AllocTensor instructions of the outputs of an InvokePacked are fused with it into an
+ *     AllocInvokePacked instruction, which saves a dispatch for each of them.
+ *   - The registers are reallocated by their live ranges, so that a register no longer used is
+ *     reused by the values defined after it.
+ *
+ * The compiler only emits forward jumps, so a value is live at most between its first and its
+ * last appearance in the instructions.  Functions with a backward jump are left as they are.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "compiler.h"
+
+namespace tvm {
+namespace relay {
+namespace vm {
+
+namespace {
+
+/*!
+ * \brief Call f(reg, is_def) on each register of an instruction.  A KillRegister counts as a
+ * definition of the register it kills.
+ */
+template <typename F>
+void ForEachRegister(Instruction* instr, F f) {
+  switch (instr->op) {
+    case Opcode::Move:
+      f(&instr->from, false);
+      f(&instr->dst, true);
+      return;
+    case Opcode::Ret:
+      f(&instr->result, false);
+      return;
+    case Opcode::Invoke:
+      for (Index i = 0; i < instr->num_args; ++i) {
+        f(&instr->invoke_args_registers[i], false);
+      }
+      f(&instr->dst, true);
+      return;
+    case Opcode::InvokeClosure:
+      f(&instr->closure, false);
+      for (Index i = 0; i < instr->num_closure_args; ++i) {
+        f(&instr->closure_args[i], false);
+      }
+      f(&instr->dst, true);
+      return;
+    case Opcode::InvokePacked:
+      for (Index i = 0; i < instr->arity; ++i) {
+        f(&instr->packed_args[i], false);
+      }
+      return;
+    case Opcode::AllocInvokePacked:
+      for (Index i = 0; i < instr->alloc_invoke_packed.num_allocs; ++i) {
+        ForEachRegister(&instr->alloc_invoke_packed.allocs[i], f);
+      }
+      for (Index i = 0; i < instr->alloc_invoke_packed.arity; ++i) {
+        f(&instr->alloc_invoke_packed.packed_args[i], false);
+      }
+      return;
+    case Opcode::AllocTensor:
+      f(&instr->alloc_tensor.storage, false);
+      f(&instr->alloc_tensor.offset, false);
+      f(&instr->dst, true);
+      return;
+    case Opcode::AllocTensorReg:
+      f(&instr->alloc_tensor_reg.storage, false);
+      f(&instr->alloc_tensor_reg.offset, false);
+      f(&instr->alloc_tensor_reg.shape_register, false);
+      f(&instr->dst, true);
+      return;
+    case Opcode::AllocADT:
+      for (Index i = 0; i < instr->num_fields; ++i) {
+        f(&instr->datatype_fields[i], false);
+      }
+      f(&instr->dst, true);
+      return;
+    case Opcode::AllocClosure:
+      for (Index i = 0; i < instr->num_freevar; ++i) {
+        f(&instr->free_vars[i], false);
+      }
+      f(&instr->dst, true);
+      return;
+    case Opcode::GetField:
+      f(&instr->object, false);
+      f(&instr->dst, true);
+      return;
+    case Opcode::GetTag:
+      f(&instr->get_tag.object, false);
+      f(&instr->dst, true);
+      return;
+    case Opcode::If:
+      f(&instr->if_op.test, false);
+      f(&instr->if_op.target, false);
+      return;
+    case Opcode::LoadConst:
+    case Opcode::LoadConsti:
+      f(&instr->dst, true);
+      return;
+    case Opcode::AllocStorage:
+      if (instr->alloc_storage.ndim == 0) {
+        f(&instr->alloc_storage.allocation_size, false);
+      }
+      f(&instr->dst, true);
+      return;
+    case Opcode::ShapeOf:
+      f(&instr->shape_of.tensor, false);
+      f(&instr->dst, true);
+      return;
+    case Opcode::ReshapeTensor:
+      f(&instr->reshape_tensor.tensor, false);
+      f(&instr->reshape_tensor.newshape, false);
+      f(&instr->dst, true);
+      return;
+    case Opcode::DeviceCopy:
+      f(&instr->device_copy.src, false);
+      f(&instr->dst, true);
+      return;
+    case Opcode::KillRegister:
+      f(&instr->dst, true);
+      return;
+    case Opcode::Goto:
+    case Opcode::Fatal:
+      return;
+  }
+  LOG(FATAL) << "Invalid opcode " << static_cast<int>(instr->op);
+}
+
+/*! \brief The offsets of the jumps of an instruction, relative to it. */
+std::vector<Index> JumpOffsets(const Instruction& instr) {
+  if (instr.op == Opcode::If) {
+    return {instr.if_op.true_offset, instr.if_op.false_offset};
+  } else if (instr.op == Opcode::Goto) {
+    return {instr.pc_offset};
+  }
+  return {};
+}
+
+class BytecodeOptimizer {
+ public:
+  explicit BytecodeOptimizer(VMFunction* func) : func_(func), code_(func->instructions) {}
+
+  void Run() {
+    for (size_t pc = 0; pc < code_.size(); ++pc) {
+      for (Index offset : JumpOffsets(code_[pc])) {
+        if (offset <= 0) {
+          VLOG(1) << "Not optimizing the bytecode of " << func_->name << ", which jumps backward";
+          return;
+        }
+        jump_targets_.insert(pc + offset);
+      }
+    }
+    removed_.assign(code_.size(), false);
+    CountDefinitions();
+    PropagateMoves();
+    ProtectOutputs();
+    FuseAllocations();
+    Compact();
+    AllocateRegisters();
+    func_->instructions = std::move(code_);
+  }
+
+ private:
+  void CountDefinitions() {
+    num_defs_.assign(func_->register_file_size, 0);
+    for (size_t i = 0; i < func_->params.size(); ++i) {
+      num_defs_[i] = 1;
+    }
+    for (Instruction& instr : code_) {
+      ForEachRegister(&instr, [&](RegName* reg, bool is_def) {
+        if (is_def) ++num_defs_[*reg];
+      });
+    }
+  }
+
+  /*! \brief Remove the moves between registers each written once. */
+  void PropagateMoves() {
+    std::vector<RegName> rename(func_->register_file_size);
+    for (size_t reg = 0; reg < rename.size(); ++reg) {
+      rename[reg] = reg;
+    }
+    for (size_t pc = 0; pc < code_.size(); ++pc) {
+      Instruction& instr = code_[pc];
+      ForEachRegister(&instr, [&](RegName* reg, bool is_def) {
+        if (!is_def) *reg = rename[*reg];
+      });
+      if (instr.op != Opcode::Move) continue;
+      if (instr.from == instr.dst ||
+          (num_defs_[instr.from] == 1 && num_defs_[instr.dst] == 1)) {
+        rename[instr.dst] = instr.from;
+        removed_[pc] = true;
+      }
+    }
+  }
+
+  /*!
+   * \brief Keep the registers of the outputs apart, as the VM finds the tensors to write to the
+   * outputs set from outside by their registers.
+   */
+  void ProtectOutputs() {
+    protected_.assign(func_->register_file_size, false);
+    auto ret = std::find_if(code_.begin(), code_.end(),
+                            [](const Instruction& instr) { return instr.op == Opcode::Ret; });
+    if (ret == code_.end()) return;
+    RegName result = ret->result;
+    protected_[result] = true;
+    for (size_t pc = 0; pc < code_.size(); ++pc) {
+      if (removed_[pc]) continue;
+      bool defines_result = false;
+      ForEachRegister(&code_[pc], [&](RegName* reg, bool is_def) {
+        defines_result |= is_def && *reg == result;
+      });
+      if (!defines_result) continue;
+      ForEachRegister(&code_[pc], [&](RegName* reg, bool is_def) { protected_[*reg] = true; });
+      break;
+    }
+  }
+
+  /*! \brief Fuse the allocations of the outputs of an InvokePacked into it. */
+  void FuseAllocations() {
+    for (size_t pc = 0; pc < code_.size(); ++pc) {
+      const Instruction& invoke = code_[pc];
+      if (removed_[pc] || invoke.op != Opcode::InvokePacked) continue;
+      std::unordered_set<RegName> outputs(invoke.packed_args + invoke.arity - invoke.output_size,
+                                          invoke.packed_args + invoke.arity);
+      // The registers appearing in, and defined by, the instructions the allocations move past.
+      std::unordered_set<RegName> touched, defined;
+      std::vector<size_t> fused;
+      for (size_t k = pc; k-- > 0;) {
+        if (jump_targets_.count(k + 1)) break;
+        if (removed_[k]) continue;
+        Instruction& prev = code_[k];
+        if (prev.op == Opcode::If || prev.op == Opcode::Goto || prev.op == Opcode::Ret ||
+            prev.op == Opcode::Fatal) {
+          break;
+        }
+        if (prev.op == Opcode::AllocTensor && outputs.count(prev.dst) && !protected_[prev.dst] &&
+            num_defs_[prev.dst] == 1 && !touched.count(prev.dst) &&
+            !defined.count(prev.alloc_tensor.storage) && !defined.count(prev.alloc_tensor.offset)) {
+          fused.push_back(k);
+          continue;
+        }
+        ForEachRegister(&prev, [&](RegName* reg, bool is_def) {
+          touched.insert(*reg);
+          if (is_def) defined.insert(*reg);
+        });
+      }
+      if (fused.empty()) continue;
+      std::vector<Instruction> allocs;
+      for (auto it = fused.rbegin(); it != fused.rend(); ++it) {
+        allocs.push_back(code_[*it]);
+        removed_[*it] = true;
+      }
+      std::vector<RegName> args(invoke.packed_args, invoke.packed_args + invoke.arity);
+      fused_.emplace(pc, Instruction::AllocInvokePacked(invoke.packed_index, invoke.arity,
+                                                        invoke.output_size, args, allocs));
+    }
+  }
+
+  /*! \brief Drop the removed instructions, and retarget the jumps over them. */
+  void Compact() {
+    // A jump to a removed instruction goes to the next instruction kept.
+    std::vector<Index> new_pc(code_.size() + 1);
+    new_pc[code_.size()] = code_.size() - std::count(removed_.begin(), removed_.end(), true);
+    for (size_t pc = code_.size(); pc-- > 0;) {
+      new_pc[pc] = removed_[pc] ? new_pc[pc + 1] : new_pc[pc + 1] - 1;
+    }
+    std::vector<Instruction> code;
+    for (size_t pc = 0; pc < code_.size(); ++pc) {
+      if (removed_[pc]) continue;
+      auto it = fused_.find(pc);
+      Instruction instr = it != fused_.end() ? it->second : code_[pc];
+      Index from = new_pc[pc];
+      if (instr.op == Opcode::If) {
+        instr.if_op.true_offset = new_pc[pc + instr.if_op.true_offset] - from;
+        instr.if_op.false_offset = new_pc[pc + instr.if_op.false_offset] - from;
+      } else if (instr.op == Opcode::Goto) {
+        instr.pc_offset = new_pc[pc + instr.pc_offset] - from;
+      }
+      code.push_back(instr);
+    }
+    code_ = std::move(code);
+  }
+
+  /*! \brief Reallocate the registers by the live ranges of their values. */
+  void AllocateRegisters() {
+    Index num_regs = func_->register_file_size;
+    Index num_params = func_->params.size();
+    std::vector<Index> first(num_regs, std::numeric_limits<Index>::max()), last(num_regs, -1);
+    for (Index reg = 0; reg < num_params; ++reg) {
+      first[reg] = last[reg] = -1;
+    }
+    for (size_t pc = 0; pc < code_.size(); ++pc) {
+      ForEachRegister(&code_[pc], [&](RegName* reg, bool is_def) {
+        first[*reg] = std::min<Index>(first[*reg], pc);
+        last[*reg] = std::max<Index>(last[*reg], pc);
+      });
+    }
+    std::vector<RegName> order;
+    for (Index reg = 0; reg < num_regs; ++reg) {
+      if (first[reg] <= last[reg]) order.push_back(reg);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](RegName lhs, RegName rhs) { return first[lhs] < first[rhs]; });
+
+    // The parameters keep their registers, where the VM writes the arguments.
+    std::vector<RegName> new_reg(num_regs, -1);
+    Index num_new_regs = num_params;
+    std::set<RegName> free_regs;
+    using Live = std::pair<Index, RegName>;
+    std::priority_queue<Live, std::vector<Live>, std::greater<Live>> live;
+    for (RegName reg : order) {
+      while (!live.empty() && live.top().first < first[reg]) {
+        free_regs.insert(live.top().second);
+        live.pop();
+      }
+      if (reg < num_params) {
+        new_reg[reg] = reg;
+      } else if (protected_[reg] || free_regs.empty()) {
+        new_reg[reg] = num_new_regs++;
+      } else {
+        new_reg[reg] = *free_regs.begin();
+        free_regs.erase(free_regs.begin());
+      }
+      // The registers of the outputs are never reused.
+      if (!protected_[reg]) live.emplace(last[reg], new_reg[reg]);
+    }
+    for (Instruction& instr : code_) {
+      ForEachRegister(&instr, [&](RegName* reg, bool is_def) { *reg = new_reg[*reg]; });
+    }
+    VLOG(1) << "The registers of " << func_->name << " went from " << num_regs << " to "
+            << num_new_regs;
+    func_->register_file_size = num_new_regs;
+  }
+
+  VMFunction* func_;
+  std::vector<Instruction> code_;
+  std::unordered_set<size_t> jump_targets_;
+  std::vector<bool> removed_;
+  std::vector<int> num_defs_;
+  std::vector<bool> protected_;
+  /*! \brief The AllocInvokePacked instructions replacing the InvokePacked instructions. */
+  std::unordered_map<size_t, Instruction> fused_;
+};
+
+}  // namespace
+
+void OptimizeBytecode(VMFunction* func) { BytecodeOptimizer(func).Run(); }
+
+}  // namespace vm
+}  // namespace relay
+}  // namespace tvm
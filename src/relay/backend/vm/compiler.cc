@@ -320,6 +320,7 @@ class VMFunctionCompiler : DeviceAwareExprFunctor<void(const Expr& n)> {
         last_register_ = instr.dst;
         break;
       case Opcode::InvokePacked:
+      case Opcode::AllocInvokePacked:
       case Opcode::If:
       case Opcode::Ret:
       case Opcode::Goto:
@@ -914,6 +915,9 @@ void VMCompiler::LowerImpl(IRModule mod) {
   // the global state.
   exec_->functions.resize(num_functions);
 
+  bool optimize_bytecode =
+      PassContext::Current()->GetConfig<Bool>("relay.backend.vm_optimize_bytecode", Bool(false))
+          .value();
   for (const auto& pair : context_.module->functions) {
     auto gvar = pair.first;
     if (auto opt = pair.second.as<Function>()) {
@@ -925,6 +929,9 @@ void VMCompiler::LowerImpl(IRModule mod) {
 
       VMFunctionCompiler func_compiler(&context_, config_->host_virtual_device);
       auto vm_func = func_compiler.Compile(gvar, func);
+      if (optimize_bytecode) {
+        OptimizeBytecode(&vm_func);
+      }
 
       size_t func_index = context_.global_map.at(gvar);
       ICHECK(func_index < exec_->functions.size());
@@ -1216,6 +1223,8 @@ runtime::Module CreateVMCompiler() {
 
 TVM_REGISTER_GLOBAL("relay._vm._VMCompiler").set_body_typed(CreateVMCompiler);
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.vm_optimize_bytecode", Bool);
+
 }  // namespace vm
 }  // namespace relay
 }  // namespace tvm
@@ -172,6 +172,15 @@ class VMCompiler : public runtime::ModuleNode {
   std::unordered_map<std::string, runtime::NDArray> params_;
 };
 
+/*!
+ * \brief Optimize the bytecode of a VM function: remove the redundant moves, fuse the
+ * allocations of the outputs of the packed calls into them, and reuse the registers of the
+ * values no longer live.
+ *
+ * \param func The function to optimize in place.
+ */
+void OptimizeBytecode(VMFunction* func);
+
 }  // namespace vm
 }  // namespace relay
 }  // namespace tvm
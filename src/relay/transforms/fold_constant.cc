@@ -20,6 +20,8 @@
 /*!
  * \file constant_folding.cc
  */
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/annotation.h>
 #include <tvm/relay/attrs/transform.h>
@@ -32,6 +34,11 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/object.h>
 
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 #include "../op/memory/on_device.h"
 #include "./pattern_utils.h"
 
@@ -63,13 +70,74 @@ bool IsComplexConstant(const Expr& expr) {
   }
 }
 
+/*!
+ * \brief Returns \p expr without the "on_device" annotations wrapping it or the fields of its
+ * tuples, for an expression which \p IsComplexConstant.
+ */
+Expr StripOnDevice(const Expr& expr) {
+  if (const auto* tuple_node = AsIgnoringOnDevice<TupleNode>(expr)) {
+    Array<Expr> fields;
+    for (const Expr& field : tuple_node->fields) {
+      fields.push_back(StripOnDevice(field));
+    }
+    return Tuple(fields);
+  }
+  return IgnoreOnDevice(expr);
+}
+
+/*! \brief Returns the type of \p expr, a constant or a tuple of constants. */
+Type ConstantType(const Expr& expr) {
+  if (const auto* tuple_node = expr.as<TupleNode>()) {
+    Array<Type> fields;
+    for (const Expr& field : tuple_node->fields) {
+      fields.push_back(ConstantType(field));
+    }
+    return TupleType(fields);
+  }
+  return Downcast<Constant>(expr)->tensor_type();
+}
+
+/*!
+ * \brief The kernels built to fold the calls to primitive operators, by the operator, its
+ * attributes and the types of its arguments.
+ *
+ * Folding the constants of a quantized model calls the same few operators on many weights of the
+ * same shapes, so each kernel is built once and then applied to the arguments of each call.
+ */
+class FoldingKernelCache {
+ public:
+  using Kernel = TypedPackedFunc<ObjectRef(Array<Expr>)>;
+
+  /*!
+   * \brief Returns the kernel evaluating \p func on \p device, building it for \p target on
+   * first use.
+   */
+  Kernel Get(const Function& func, Device device, const Target& target) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = kernels_.find(func);
+      if (it != kernels_.end()) {
+        return it->second;
+      }
+    }
+    Kernel kernel = EvalFunction(IRModule(), func, device, target);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return kernels_.emplace(func, kernel).first->second;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<Function, Kernel, StructuralHash, StructuralEqual> kernels_;
+};
+
 // TODO(tvm-team) consider combine dead-code with constant folder.
 // or make a more powerful partial evaluator.
 class ConstantFolder : public MixedModeMutator {
  public:
-  explicit ConstantFolder(IRModule module, bool fold_qnn)
+  ConstantFolder(IRModule module, bool fold_qnn, FoldingKernelCache* kernel_cache)
       : module_(std::move(module)),
         fold_qnn_(fold_qnn),
+        kernel_cache_(kernel_cache),
         device_copy_op_(Op::Get("device_copy")),
         shape_of_op_(Op::Get("shape_of")),
         vm_shape_of_op_(Op::Get("vm.shape_of")),
@@ -260,6 +328,11 @@ class ConstantFolder : public MixedModeMutator {
     // needed for both execution and creation(due to JIT)
     With<transform::PassContext> fresh_build_ctx(transform::PassContext::Create());
 
+    if (Optional<Expr> opt_result = EvaluateWithKernel(expr)) {
+      VLOG(1) << "Evaluated to constant:" << std::endl << PrettyPrint(opt_result.value());
+      return opt_result.value();
+    }
+
     Map<String, ObjectRef> dict = (module_->attrs.defined())
                                       ? Map<String, ObjectRef>(module_->attrs.CopyOnWrite()->dict)
                                       : Map<String, ObjectRef>();
@@ -273,6 +346,34 @@ class ConstantFolder : public MixedModeMutator {
     return result;
   }
 
+  /*!
+   * \brief Returns the result of \p expr if it is a call to a primitive operator, by applying
+   * the cached kernel of the operator to the arguments of the call. Returns null otherwise, or if
+   * the result type of the operator depends on the values of its arguments.
+   */
+  Optional<Expr> EvaluateWithKernel(const Expr& expr) {
+    const auto* call_node = expr.as<CallNode>();
+    if (call_node == nullptr || !call_node->op->IsInstance<OpNode>()) {
+      return {};
+    }
+    static auto shape_data_dependent = Op::GetAttrMap<TShapeDataDependent>("TShapeDataDependent");
+    if (shape_data_dependent.count(Downcast<Op>(call_node->op))) {
+      return {};
+    }
+    Array<Var> params;
+    Array<Expr> args;
+    for (const Expr& arg : call_node->args) {
+      Expr value = StripOnDevice(arg);
+      params.push_back(Var("p" + std::to_string(params.size()), ConstantType(value)));
+      args.push_back(value);
+    }
+    Call body(call_node->op, Array<Expr>(params.begin(), params.end()), call_node->attrs,
+              call_node->type_args);
+    Function func(params, body, Type(), {});
+    FoldingKernelCache::Kernel kernel = kernel_cache_->Get(func, eval_cpu_dev_, eval_cpu_target_);
+    return ObjectToExpr(kernel(args));
+  }
+
   /*!
    * \brief Returns constant shape result of \p call if it of form \p shape_of(e) and \p e has
    * a non-dynamic tensor shape. Returns null otherwise.
@@ -395,6 +496,9 @@ class ConstantFolder : public MixedModeMutator {
   // Whether to fold constants for QNN operations.
   bool fold_qnn_;
 
+  // The kernels built to evaluate the calls to primitive operators.
+  FoldingKernelCache* kernel_cache_;
+
   // The kDLCPU device assumed to be available to the compiler. Used only when evaluating
   // sub-expressions.
   Device eval_cpu_dev_{kDLCPU, /*device_id=*/0};
@@ -420,7 +524,8 @@ TVM_REGISTER_GLOBAL("relay.analysis.check_constant").set_body_typed(IsComplexCon
 Expr FoldConstantExpr(const Expr& expr, const IRModule& mod, bool fold_qnn) {
   VLOG_CONTEXT << "FoldConstantExpr";
   VLOG(1) << "folding:" << std::endl << PrettyPrint(expr);
-  Expr result = ConstantFolder(mod, fold_qnn).VisitExpr(expr);
+  FoldingKernelCache kernel_cache;
+  Expr result = ConstantFolder(mod, fold_qnn, &kernel_cache).VisitExpr(expr);
   VLOG(1) << "folded to:" << std::endl << PrettyPrint(result);
   return result;
 }
@@ -436,9 +541,12 @@ TVM_REGISTER_GLOBAL("relay._transform.FoldConstantExpr")
     });
 
 Pass FoldConstant(bool fold_qnn) {
+  // The kernels are shared by the functions the pass folds, and by the modules it is applied to.
+  auto kernel_cache = std::make_shared<FoldingKernelCache>();
   runtime::TypedPackedFunc<Function(Function, IRModule, PassContext)> pass_func =
       [=](Function f, IRModule m, PassContext /* pc */) {
-        return Downcast<Function>(FoldConstantExpr(f, m, fold_qnn));
+        VLOG_CONTEXT << "FoldConstant";
+        return Downcast<Function>(ConstantFolder(m, fold_qnn, kernel_cache.get()).VisitExpr(f));
       };
   return CreateFunctionPass(pass_func, 2, "FoldConstant", {});
 }
@@ -27,6 +27,8 @@
 
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/data_type.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/registry.h>
 #include <tvm/runtime/name_transforms.h>
 
 #include <limits>
@@ -37,6 +39,9 @@
 namespace tvm {
 namespace runtime {
 
+/*! \brief The executor whose entrypoint is running on the current thread. */
+static thread_local AotExecutor* current_aot_executor = nullptr;
+
 AotExecutor::AotExecutor(tvm::runtime::Module module, const std::vector<Device>& devs)
     : module_{module}, devices_{devs} {
   auto fmetadata = module->GetFunction("get_metadata");
@@ -50,9 +55,10 @@ AotExecutor::AotExecutor(tvm::runtime::Module module, const std::vector<Device>&
       << "At this time, AOTExecutor supports only execution on kDLCPU 0";
   // TODO(tvm-team): Temporary hack since Hexagon is defined different than kDLCPU.
   bool is_valid_device =
-      (devices_[0].device_type == kDLHexagon) || (devices_[0].device_type == kDLCPU);
-  CHECK(is_valid_device)
-      << "At this time, AOTExecutor supports only execution on kDLCPU 0 or kDLHexagon 0";
+      (devices_[0].device_type == kDLHexagon) || (devices_[0].device_type == kDLCPU) ||
+      (devices_[0].device_type == kDLCUDA) || (devices_[0].device_type == kDLROCM);
+  CHECK(is_valid_device) << "At this time, AOTExecutor supports only execution on kDLCPU 0, "
+                            "kDLHexagon 0, kDLCUDA 0 or kDLROCM 0";
 
   for (auto input : metadata_->inputs()) {
     // TODO(areusch): Encode device information in Metadata.
@@ -155,6 +161,14 @@ PackedFunc AotExecutor::GetFunction(const String& name, const ObjectPtr<Object>&
       CHECK(String::CanConvertFrom(args[0])) << "Input key is not a string";
       *rv = this->GetInputIndex(tvm::runtime::SanitizeName(args[0].operator String()));
     });
+  } else if (name == "set_stream") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetStream(args[0], args[1].operator void*());
+    });
+  } else if (name == "get_stream") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = static_cast<void*>(this->GetStream(args[0]));
+    });
   } else if (name == "get_input_name") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->GetInputName(args[0]); });
@@ -180,7 +194,14 @@ void AotExecutor::Run() {
 
   TVMArgs args{call_values.get(), call_type_codes.get(), num_args};
   TVMRetValue rv;
+  // The stream hooks emitted by a multi-stream entrypoint dispatch to this executor.
+  AotExecutor* prev_executor = current_aot_executor;
+  current_aot_executor = this;
+  if (!streams_.empty()) {
+    SwitchStream(0);
+  }
   pf.CallPacked(args, &rv);
+  current_aot_executor = prev_executor;
 }
 
 int AotExecutor::GetInputIndex(const std::string& name) {
@@ -228,5 +249,66 @@ NDArray AotExecutor::GetOutput(int index) const { return args_[metadata_->num_in
 
 void AotExecutor::CopyOutputTo(int index, DLTensor* data_out) { GetOutput(index).CopyTo(data_out); }
 
+AotExecutor::~AotExecutor() {
+  for (size_t i = 0; i < streams_.size(); ++i) {
+    if (owned_streams_[i]) {
+      DeviceAPI::Get(devices_[0])->FreeStream(devices_[0], streams_[i]);
+    }
+  }
+}
+
+void AotExecutor::SetStream(int index, TVMStreamHandle stream) {
+  ICHECK_GE(index, 0) << "Invalid stream index " << index;
+  if (static_cast<size_t>(index) >= streams_.size()) {
+    streams_.resize(index + 1, nullptr);
+    owned_streams_.resize(index + 1, false);
+  }
+  if (owned_streams_[index]) {
+    DeviceAPI::Get(devices_[0])->FreeStream(devices_[0], streams_[index]);
+  }
+  streams_[index] = stream;
+  owned_streams_[index] = false;
+}
+
+TVMStreamHandle AotExecutor::GetStream(int index) {
+  ICHECK_GE(index, 0) << "Invalid stream index " << index;
+  if (static_cast<size_t>(index) >= streams_.size()) {
+    size_t old_size = streams_.size();
+    streams_.resize(index + 1, nullptr);
+    owned_streams_.resize(index + 1, false);
+    for (size_t i = old_size; i < streams_.size(); ++i) {
+      // Stream 0 is the current stream of the device unless it is bound with SetStream.
+      if (i == 0) {
+        streams_[i] = DeviceAPI::Get(devices_[0])->GetCurrentStream(devices_[0]);
+      } else {
+        streams_[i] = DeviceAPI::Get(devices_[0])->CreateStream(devices_[0]);
+        owned_streams_[i] = true;
+      }
+    }
+  }
+  return streams_[index];
+}
+
+void AotExecutor::SwitchStream(int index) {
+  DeviceAPI::Get(devices_[0])->SetStream(devices_[0], GetStream(index));
+}
+
+void AotExecutor::StreamWait(int src_index, int dst_index) {
+  DeviceAPI::Get(devices_[0])
+      ->SyncStreamFromTo(devices_[0], GetStream(src_index), GetStream(dst_index));
+}
+
+TVM_REGISTER_GLOBAL("tvm.aot_executor.set_stream").set_body_typed([](int index) {
+  ICHECK(current_aot_executor != nullptr) << "set_stream must be called from an AOT entrypoint";
+  current_aot_executor->SwitchStream(index);
+  return 0;
+});
+
+TVM_REGISTER_GLOBAL("tvm.aot_executor.stream_wait").set_body_typed([](int src, int dst) {
+  ICHECK(current_aot_executor != nullptr) << "stream_wait must be called from an AOT entrypoint";
+  current_aot_executor->StreamWait(src, dst);
+  return 0;
+});
+
 }  // namespace runtime
 }  // namespace tvm
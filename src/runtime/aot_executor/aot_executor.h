@@ -65,6 +65,8 @@ class TVM_DLL AotExecutor : public ModuleNode {
    */
   AotExecutor(tvm::runtime::Module module, const std::vector<Device>& devs);
 
+  ~AotExecutor();
+
   /*!
    * \brief Get the input index given the name of input.
    * \param name The name of the input.
@@ -137,6 +139,32 @@ class TVM_DLL AotExecutor : public ModuleNode {
    */
   void CopyOutputTo(int index, DLTensor* data_out);
 
+  /*!
+   * \brief Bind a stream to a stream index used by the generated code. Operators are assigned to
+   *  stream indices at compile time with the "num-streams" executor option.
+   * \param index The stream index.
+   * \param stream The stream handle. Stream 0 defaults to the current stream of the device, the
+   *  other streams are created by the executor when they are not bound.
+   */
+  void SetStream(int index, TVMStreamHandle stream);
+  /*!
+   * \brief Get the stream bound to a stream index, creating it when needed.
+   * \param index The stream index.
+   * \return The stream handle.
+   */
+  TVMStreamHandle GetStream(int index);
+  /*!
+   * \brief Make the device launch the following operators on a stream.
+   * \param index The stream index.
+   */
+  void SwitchStream(int index);
+  /*!
+   * \brief Make a stream wait for the work enqueued so far on another stream.
+   * \param src_index The index of the stream to wait for.
+   * \param dst_index The index of the waiting stream.
+   */
+  void StreamWait(int src_index, int dst_index);
+
  private:
   /*! \brief Metadata provided to the runtime from the compiler. */
   metadata::Metadata metadata_;
@@ -149,6 +177,12 @@ class TVM_DLL AotExecutor : public ModuleNode {
 
   /*! \brief Holds one NDArray per function argument in the same order. */
   std::vector<NDArray> args_;
+
+  /*! \brief The streams used by the generated code, indexed by the stream index. */
+  std::vector<TVMStreamHandle> streams_;
+
+  /*! \brief Whether each stream was created by, and must be freed by, this executor. */
+  std::vector<bool> owned_streams_;
 };
 
 }  // namespace runtime
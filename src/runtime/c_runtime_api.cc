@@ -187,6 +187,15 @@ void* DeviceAPI::AllocDataSpace(Device dev, int ndim, const int64_t* shape, DLDa
   return nullptr;
 }
 
+void* DeviceAPI::AllocDataSpaceAsync(Device dev, size_t nbytes, size_t alignment,
+                                     DLDataType type_hint, TVMStreamHandle stream) {
+  return AllocDataSpace(dev, nbytes, alignment, type_hint);
+}
+
+void DeviceAPI::FreeDataSpaceAsync(Device dev, void* ptr, TVMStreamHandle stream) {
+  FreeDataSpace(dev, ptr);
+}
+
 void DeviceAPI::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHandle stream) {
   // by default, we can always redirect to the flat memory copy operation.
   size_t nbytes = GetDataSize(*from);
@@ -595,6 +604,29 @@ int TVMFuncCall(TVMFunctionHandle func, TVMValue* args, int* arg_type_codes, int
   API_END();
 }
 
+int TVMFuncCallBatch(int num_calls, TVMFunctionHandle* funcs, TVMValue* arg_values,
+                     int* type_codes, int* num_args, TVMValue* ret_vals, int* ret_type_codes,
+                     int* num_finished) {
+  *num_finished = 0;
+  API_BEGIN();
+  int arg_offset = 0;
+  for (int i = 0; i < num_calls; ++i) {
+    TVMRetValue rv;
+    (static_cast<const PackedFuncObj*>(funcs[i]))
+        ->CallPacked(TVMArgs(arg_values + arg_offset, type_codes + arg_offset, num_args[i]), &rv);
+    arg_offset += num_args[i];
+    // The thread-local return string can only hold the result of one call.
+    ICHECK_NE(rv.type_code(), kTVMBytes)
+        << "TVMFuncCallBatch does not support bytes return values, call #" << i << " returns bytes";
+    if (rv.type_code() == kTVMStr || rv.type_code() == kTVMDataType) {
+      rv = String(rv.operator std::string());
+    }
+    rv.MoveToCHost(ret_vals + i, ret_type_codes + i);
+    *num_finished = i + 1;
+  }
+  API_END();
+}
+
 int TVMCFuncSetReturn(TVMRetValueHandle ret, TVMValue* value, int* type_code, int num_ret) {
   API_BEGIN();
   ICHECK_EQ(num_ret, 1);
@@ -755,3 +787,8 @@ TVM_REGISTER_GLOBAL("runtime.GetDeviceAttr").set_body([](TVMArgs args, TVMRetVal
 });
 
 TVM_REGISTER_GLOBAL("runtime.TVMSetStream").set_body_typed(TVMSetStream);
+
+TVM_REGISTER_GLOBAL("runtime.GetCurrentStream").set_body_typed([](int device_type, int device_id) {
+  DLDevice dev{static_cast<DLDeviceType>(device_type), device_id};
+  return reinterpret_cast<int64_t>(DeviceAPIManager::Get(dev)->GetCurrentStream(dev));
+});
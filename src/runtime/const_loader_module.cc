@@ -28,14 +28,25 @@
  * codegen and runtimes.
  */
 #include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/optional.h>
 #include <tvm/runtime/container/string.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
+#include "const_loader_module.h"
 #include "meta_data.h"
 
 namespace tvm {
@@ -63,18 +74,25 @@ class ConstLoaderModuleNode : public ModuleNode {
             << "ConstLoaderModuleNode is missing entry for constant '" << var << "' for function '"
             << kv.first << "'";
       }
-      initialized_[kv.first] = false;
+      init_once_[kv.first] = std::make_unique<std::once_flag>();
     }
   }
 
   PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) final {
     VLOG(1) << "ConstLoaderModuleNode::GetFunction(" << name << ")";
-    // Initialize and memoize the module.
+    // Initialize and memoize the module, unless warm_up_submodules already did.
     // Usually, we have some warmup runs. The module initialization should be
     // done at this stage. Therefore, runtime overhead is not a concern.
-    if (initialized_.count(name) && !initialized_.at(name)) {
-      this->InitSubModule(name);
-      initialized_[name] = true;
+    if (init_once_.count(name)) {
+      this->InitSubModuleOnce(name);
+    }
+
+    if (name == "warm_up_submodules") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        int num_threads = args.size() > 0 ? args[0].operator int() : 0;
+        PackedFunc fprogress = args.size() > 1 ? args[1].operator PackedFunc() : PackedFunc();
+        *rv = this->WarmUp(num_threads, fprogress);
+      });
     }
 
     if (name == "get_const_var_ndarray") {
@@ -106,21 +124,87 @@ class ConstLoaderModuleNode : public ModuleNode {
   /*!
    * \brief Get the list of constants that is required by the given module.
    * \param symbol The symbol that is being queried.
-   * \return The list of needed NDArray.
+   * \return The list of needed NDArray, which share their data with the module.
    */
-  Array<NDArray> GetRequiredConstants(const std::string& symbol) {
-    Array<NDArray> ret;
-    ICHECK_GT(const_vars_by_symbol_.count(symbol), 0U)
+  Array<NDArray> GetRequiredConstants(const std::string& symbol) const {
+    auto it = const_vars_by_symbol_.find(symbol);
+    ICHECK(it != const_vars_by_symbol_.end())
         << "No constants known for function '" << symbol << "'";
-    std::vector<std::string> vars = const_vars_by_symbol_[symbol];
-    for (const auto& var : vars) {
-      ICHECK_GT(const_var_ndarray_.count(var), 0U)
+    Array<NDArray> ret;
+    ret.reserve(it->second.size());
+    for (const auto& var : it->second) {
+      auto it_ndarray = const_var_ndarray_.find(var);
+      ICHECK(it_ndarray != const_var_ndarray_.end())
           << "No such constant variable '" << var << "' for function '" << symbol << "'";
-      ret.push_back(const_var_ndarray_[var]);
+      ret.push_back(it_ndarray->second);
     }
     return ret;
   }
 
+  /*!
+   * \brief Initialize the module of a symbol unless it is initialized, thread-safe.
+   *  The callers of a symbol being initialized wait for its initialization, and a
+   *  failed initialization is retried by the next caller.
+   * \param symbol The symbol of the module.
+   */
+  void InitSubModuleOnce(const std::string& symbol) {
+    std::call_once(*init_once_.at(symbol), [this, &symbol]() { this->InitSubModule(symbol); });
+  }
+
+  /*!
+   * \brief Initialize the modules of all the symbols concurrently, so that their
+   *  first calls do not pay for it. The initialization functions of different
+   *  symbols have to be safe to run concurrently, otherwise num_threads should be 1.
+   * \param num_threads The number of threads, or the maximum concurrency when not positive.
+   * \param fprogress Called, when defined, with the symbol, the number of initialized
+   *  symbols and the total number of symbols after each initialization. The calls
+   *  are serialized, though made from the worker threads.
+   * \return The total number of symbols.
+   */
+  int WarmUp(int num_threads, PackedFunc fprogress) {
+    std::vector<std::string> symbols;
+    for (const auto& kv : init_once_) {
+      symbols.push_back(kv.first);
+    }
+    int num_symbols = static_cast<int>(symbols.size());
+    if (num_threads <= 0) {
+      num_threads = threading::MaxConcurrency();
+    }
+    num_threads = std::max(1, std::min(num_threads, num_symbols));
+
+    std::atomic<int> next{0};
+    std::mutex mutex;
+    int num_done = 0;
+    std::exception_ptr error;
+    auto worker = [&]() {
+      for (int i = next++; i < num_symbols; i = next++) {
+        try {
+          this->InitSubModuleOnce(symbols[i]);
+          std::lock_guard<std::mutex> lock(mutex);
+          ++num_done;
+          if (fprogress != nullptr) {
+            fprogress(symbols[i], num_done, num_symbols);
+          }
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!error) error = std::current_exception();
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 1; i < num_threads; ++i) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return num_symbols;
+  }
+
   /*!
    * \brief Initialize each imported module.
    * \param symobl The symbol used for initializing a module. It is also used
@@ -232,10 +316,10 @@ class ConstLoaderModuleNode : public ModuleNode {
 
  private:
   /*!
-   * \brief Record if a module is initialized. It is needed by imported
-   * modules using execution engine.
+   * \brief Record if a module is initialized, by symbol. It is needed by imported
+   * modules using execution engine. The map itself is not modified after construction.
    */
-  std::unordered_map<std::string, bool> initialized_;
+  std::unordered_map<std::string, std::unique_ptr<std::once_flag>> init_once_;
   /*! \brief Variable name to NDArray mapping. */
   std::unordered_map<std::string, NDArray> const_var_ndarray_;
   /*! \brief Symbol name to required constant variables mapping. */
@@ -249,6 +333,28 @@ Module ConstLoaderModuleCreate(
   return Module(n);
 }
 
+int ConstLoaderModuleWarmUp(Module mod, int num_threads, Optional<PackedFunc> fprogress) {
+  std::vector<Module> stack{mod};
+  std::unordered_set<const ModuleNode*> visited{mod.operator->()};
+  int num_symbols = 0;
+  while (!stack.empty()) {
+    Module current = stack.back();
+    stack.pop_back();
+    if (std::string(current->type_key()) == "const_loader") {
+      num_symbols += static_cast<ConstLoaderModuleNode*>(current.operator->())
+                         ->WarmUp(num_threads, fprogress.value_or(PackedFunc()));
+    }
+    for (const Module& imported : current->imports()) {
+      if (visited.insert(imported.operator->()).second) {
+        stack.push_back(imported);
+      }
+    }
+  }
+  return num_symbols;
+}
+
+TVM_REGISTER_GLOBAL("runtime.ConstLoaderModuleWarmUp").set_body_typed(ConstLoaderModuleWarmUp);
+
 TVM_REGISTER_GLOBAL("runtime.module.loadbinary_metadata")
     .set_body_typed(ConstLoaderModuleNode::LoadFromBinary);
 TVM_REGISTER_GLOBAL("runtime.module.loadbinary_const_loader")
@@ -25,7 +25,9 @@
 #ifndef TVM_RUNTIME_CONST_LOADER_MODULE_H_
 #define TVM_RUNTIME_CONST_LOADER_MODULE_H_
 
+#include <tvm/runtime/container/optional.h>
 #include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
 
 #include <string>
 #include <unordered_map>
@@ -47,6 +49,19 @@ Module ConstLoaderModuleCreate(
     const std::unordered_map<std::string, NDArray>& const_var_ndarray,
     const std::unordered_map<std::string, std::vector<std::string>>& const_vars_by_symbol);
 
+/*!
+ * \brief Initialize the imported modules of all the ConstLoader modules in the import tree
+ * of a module with their constants, concurrently, instead of at their first calls.
+ *
+ * \param mod The root of the import tree, e.g. a loaded library.
+ * \param num_threads The number of threads, or the maximum concurrency when not positive.
+ * \param fprogress Called with the symbol, the number of initialized symbols and the total
+ * number of symbols of a ConstLoader module after each initialization.
+ *
+ * \return The total number of symbols.
+ */
+int ConstLoaderModuleWarmUp(Module mod, int num_threads, Optional<PackedFunc> fprogress);
+
 }  // namespace runtime
 }  // namespace tvm
 
@@ -24,7 +24,17 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/registry.h>
 
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "../../3rdparty/compiler-rt/builtin_fp16.h"
+#include "../../cuda/cuda_common.h"
 #include "../cblas/gemm_common.h"
 #include "cublas_utils.h"
 
@@ -135,6 +145,212 @@ int roundoff(int v, int d) { return (v + d - 1) / d * d; }
 
 #if CUDART_VERSION >= 10010
 
+/*!
+ * \brief The algorithms of the cuBLASLt matmuls chosen by benchmarking, shared by the threads.
+ *
+ * Autotuning is disabled by default, and then the algorithm of a matmul is the first one of the
+ * heuristic of cuBLASLt.  When it is enabled, the first call of each new matmul benchmarks the
+ * first `top_n` algorithms of the heuristic, and keeps the fastest.  The choices are appended to a
+ * file, and loaded from it when autotuning is enabled again, e.g. by a later process.
+ */
+class CublasLtAutotuner {
+ public:
+  static CublasLtAutotuner* Global() {
+    static CublasLtAutotuner* inst = new CublasLtAutotuner();
+    return inst;
+  }
+
+  /*! \brief Enable benchmarking the first \p top_n algorithms, or disable it if 0. */
+  void Enable(int top_n, const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    top_n_ = top_n;
+    path_ = path;
+    if (path_.empty()) return;
+    std::ifstream fin(path_);
+    std::string key;
+    while (fin >> key) {
+      cublasLtMatmulAlgo_t algo;
+      for (uint64_t& word : algo.data) {
+        fin >> std::hex >> word >> std::dec;
+      }
+      if (!fin) break;
+      algos_[key] = algo;
+    }
+  }
+
+  int top_n() const { return top_n_; }
+
+  /*! \brief Get the algorithm chosen for \p key, returns whether there is one. */
+  bool Lookup(const std::string& key, cublasLtMatmulAlgo_t* algo) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = algos_.find(key);
+    if (it == algos_.end()) return false;
+    *algo = it->second;
+    return true;
+  }
+
+  void Record(const std::string& key, const cublasLtMatmulAlgo_t& algo) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    algos_[key] = algo;
+    if (path_.empty()) return;
+    std::ofstream fout(path_, std::ios::app);
+    fout << key;
+    for (uint64_t word : algo.data) {
+      fout << " " << std::hex << word << std::dec;
+    }
+    fout << "\n";
+  }
+
+ private:
+  std::mutex mutex_;
+  std::atomic<int> top_n_{0};
+  std::string path_;
+  std::unordered_map<std::string, cublasLtMatmulAlgo_t> algos_;
+};
+
+/*!
+ * \brief Benchmark the first algorithms of the heuristic for a matmul, and return the fastest.
+ * The result of the matmul is overwritten by each run.
+ */
+cublasLtMatmulAlgo_t AutotuneCublasLt(cublasLtHandle_t hdl, cudaStream_t stream,
+                                      const CublasLtMatmulPlan& plan,
+                                      const cublasLtMatmulHeuristicResult_t* results,
+                                      int num_results, const void* alpha, const void* A_data,
+                                      const void* B_data, const void* beta, void* C_data,
+                                      void* workspace_ptr, size_t workspace_size) {
+  constexpr int kRepeat = 10;
+  cudaEvent_t start, stop;
+  CUDA_CALL(cudaEventCreate(&start));
+  CUDA_CALL(cudaEventCreate(&stop));
+  int best = 0;
+  float best_ms = std::numeric_limits<float>::max();
+  for (int i = 0; i < num_results; ++i) {
+    auto run = [&]() {
+      return cublasLtMatmul(hdl, plan.op_desc, alpha, B_data, plan.A_desc, A_data, plan.B_desc,
+                            beta, C_data, plan.C_desc, C_data, plan.C_desc, &results[i].algo,
+                            workspace_ptr, workspace_size, stream);
+    };
+    // Warm up, and skip the algorithms which fail to launch.
+    if (results[i].state != CUBLAS_STATUS_SUCCESS || run() != CUBLAS_STATUS_SUCCESS) continue;
+    CUDA_CALL(cudaEventRecord(start, stream));
+    for (int r = 0; r < kRepeat; ++r) {
+      CHECK_CUBLAS_ERROR(run());
+    }
+    CUDA_CALL(cudaEventRecord(stop, stream));
+    CUDA_CALL(cudaEventSynchronize(stop));
+    float ms = 0;
+    CUDA_CALL(cudaEventElapsedTime(&ms, start, stop));
+    if (ms < best_ms) {
+      best_ms = ms;
+      best = i;
+    }
+  }
+  CUDA_CALL(cudaEventDestroy(start));
+  CUDA_CALL(cudaEventDestroy(stop));
+  return results[best].algo;
+}
+
+TVM_REGISTER_GLOBAL("tvm.contrib.cublaslt.autotune").set_body_typed([](int top_n, String path) {
+  CHECK_GE(top_n, 0) << "ValueError: The number of algorithms to benchmark must be non-negative";
+  CublasLtAutotuner::Global()->Enable(top_n, path);
+});
+
+/*!
+ * \brief Build the descriptors of a matmul.  The pointers to the bias and the scales are set by
+ * each call, the rest of the descriptors only depends on the key.
+ */
+std::unique_ptr<CublasLtMatmulPlan> CreateCublasLtPlan(const CublasLtMatmulKey& key,
+                                                       cudaDataType_t scale_type) {
+  auto plan = std::make_unique<CublasLtMatmulPlan>();
+  cublasOperation_t op_transa = CUBLASBooleanToTranspose(key.transa);
+  cublasOperation_t op_transb = CUBLASBooleanToTranspose(key.transb);
+
+  CHECK_CUBLAS_ERROR(cublasLtMatmulDescCreate(&plan->op_desc, key.compute_type, scale_type));
+  CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(plan->op_desc, CUBLASLT_MATMUL_DESC_TRANSA,
+                                                    &op_transb, sizeof(op_transb)));
+  CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(plan->op_desc, CUBLASLT_MATMUL_DESC_TRANSB,
+                                                    &op_transa, sizeof(op_transa)));
+  if (key.epilogue != CUBLASLT_EPILOGUE_DEFAULT) {
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(plan->op_desc, CUBLASLT_MATMUL_DESC_EPILOGUE,
+                                                      &key.epilogue, sizeof(key.epilogue)));
+  }
+
+  int64_t M = key.M, N = key.N, K = key.K;
+  bool transa = key.transa, transb = key.transb;
+  int64_t lda = transb ? K : M;
+  int64_t ldb = transa ? N : K;
+  int64_t ldc = M;
+
+  CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&plan->A_desc, key.ab_type, !transb ? M : K,
+                                                !transb ? K : M, lda));
+  CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&plan->B_desc, key.ab_type, !transa ? K : N,
+                                                !transa ? N : K, ldb));
+  CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&plan->C_desc, key.c_type, M, N, ldc));
+
+  if (key.batched) {
+    auto set_batch = [](cublasLtMatrixLayout_t mat_desc, int batch_count, int64_t batch_stride) {
+      CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutSetAttribute(
+          mat_desc, CUBLASLT_MATRIX_LAYOUT_BATCH_COUNT, &batch_count, sizeof(batch_count)));
+      CHECK_CUBLAS_ERROR(
+          cublasLtMatrixLayoutSetAttribute(mat_desc, CUBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET,
+                                           &batch_stride, sizeof(batch_stride)));
+    };
+    set_batch(plan->A_desc, key.batch_count_a, M * K);
+    set_batch(plan->B_desc, key.batch_count_b, K * N);
+    set_batch(plan->C_desc, key.batch_count_c, M * N);
+  }
+  return plan;
+}
+
+/*! \brief Choose the algorithm of a matmul, whose descriptors are set for the current call. */
+cublasLtMatmulAlgo_t ChooseCublasLtAlgo(cublasLtHandle_t hdl, cudaStream_t stream,
+                                        cublasLtMatmulPreference_t matmul_pref_desc,
+                                        const CublasLtMatmulKey& key,
+                                        const CublasLtMatmulPlan& plan, const void* alpha,
+                                        const void* A_data, const void* B_data, const void* beta,
+                                        void* C_data, void* workspace_ptr) {
+  // The algorithm chosen by an earlier autotuning of the same matmul.
+  std::string algo_key;
+  CublasLtAutotuner* autotuner = CublasLtAutotuner::Global();
+  if (autotuner->top_n() > 0) {
+    int major = 0, minor = 0, version = cublasLtGetVersion();
+    CUDA_CALL(cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, key.device_id));
+    CUDA_CALL(cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, key.device_id));
+    algo_key = "sm" + std::to_string(major * 10 + minor) + ",v" + std::to_string(version) + "," +
+               key.ToString();
+    cublasLtMatmulAlgo_t algo;
+    if (autotuner->Lookup(algo_key, &algo)) {
+      return algo;
+    }
+  }
+
+  size_t workspace_size = key.workspace_size;
+  cublasLtMatmulPreferenceSetAttribute(matmul_pref_desc, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
+                                       &workspace_size, sizeof(size_t));
+
+  // Benchmarking is not possible while the stream is captured into a CUDA graph.
+  cudaStreamCaptureStatus capture_status = cudaStreamCaptureStatusNone;
+  CUDA_CALL(cudaStreamIsCapturing(stream, &capture_status));
+  bool autotune = !algo_key.empty() && capture_status == cudaStreamCaptureStatusNone;
+
+  std::vector<cublasLtMatmulHeuristicResult_t> results(autotune ? autotuner->top_n() : 1);
+  int returned_result = 0;
+  CHECK_CUBLAS_ERROR(cublasLtMatmulAlgoGetHeuristic(
+      hdl, plan.op_desc, plan.A_desc, plan.B_desc, plan.C_desc, plan.C_desc, matmul_pref_desc,
+      results.size(), results.data(), &returned_result));
+  if (returned_result == 0) {
+    CHECK_CUBLAS_ERROR(CUBLAS_STATUS_NOT_SUPPORTED);
+  }
+  if (!autotune) {
+    return results[0].algo;
+  }
+  cublasLtMatmulAlgo_t algo =
+      AutotuneCublasLt(hdl, stream, plan, results.data(), returned_result, alpha, A_data, B_data,
+                       beta, C_data, workspace_ptr, workspace_size);
+  autotuner->Record(algo_key, algo);
+  return algo;
+}
+
 void CallCublasLt(cublasLtHandle_t hdl, cudaStream_t stream,
                   cublasLtMatmulPreference_t matmul_pref_desc, const DLTensor* A, const DLTensor* B,
                   const DLTensor* bias, const DLTensor* scaleA, const DLTensor* scaleB,
@@ -179,37 +395,6 @@ void CallCublasLt(cublasLtHandle_t hdl, cudaStream_t stream,
     beta = &zero_i32;
   }
 
-  cublasLtMatmulDesc_t op_desc;
-  cublasOperation_t op_transa = CUBLASBooleanToTranspose(transa);
-  cublasOperation_t op_transb = CUBLASBooleanToTranspose(transb);
-
-  CHECK_CUBLAS_ERROR(cublasLtMatmulDescCreate(&op_desc, compute_type, scale_type));
-  CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_TRANSA,
-                                                    &op_transb, sizeof(op_transb)));
-  CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_TRANSB,
-                                                    &op_transa, sizeof(op_transa)));
-
-  if (bias != nullptr) {
-    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER,
-                                                      &bias->data, sizeof(float*)));
-  }
-
-  if (scaleA != nullptr) {
-    auto scaleA_data = static_cast<char*>(scaleA->data) + scaleA->byte_offset;
-    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_A_SCALE_POINTER,
-                                                      &scaleA_data, sizeof(float*)));
-  }
-  if (scaleB != nullptr) {
-    auto scaleB_data = static_cast<char*>(scaleB->data) + scaleB->byte_offset;
-    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_B_SCALE_POINTER,
-                                                      &scaleB_data, sizeof(float*)));
-  }
-
-  if (epilogue != CUBLASLT_EPILOGUE_DEFAULT) {
-    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_EPILOGUE,
-                                                      &epilogue, sizeof(epilogue)));
-  }
-
   int batch_offset_A = A->ndim - 2;
   int batch_offset_B = B->ndim - 2;
 
@@ -232,17 +417,22 @@ void CallCublasLt(cublasLtHandle_t hdl, cudaStream_t stream,
     use_batched_gemm = false;
   }
 
-  int lda = transb ? K : M;
-  int ldb = transa ? N : K;
-  int ldc = M;
-
-  cublasLtMatrixLayout_t A_desc, B_desc, C_desc;
-  CHECK_CUBLAS_ERROR(
-      cublasLtMatrixLayoutCreate(&A_desc, ab_type, !transb ? M : K, !transb ? K : M, lda));
-  CHECK_CUBLAS_ERROR(
-      cublasLtMatrixLayoutCreate(&B_desc, ab_type, !transa ? K : N, !transa ? N : K, ldb));
-  CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutCreate(&C_desc, c_type, M, N, ldc));
-
+  CublasLtMatmulKey key{};
+  key.device_id = C->device.device_id;
+  key.M = M;
+  key.N = N;
+  key.K = K;
+  key.ab_type = ab_type;
+  key.c_type = c_type;
+  key.compute_type = compute_type;
+  key.transa = transa;
+  key.transb = transb;
+  key.epilogue = epilogue;
+  key.has_bias = bias != nullptr;
+  key.has_scale_a = scaleA != nullptr;
+  key.has_scale_b = scaleB != nullptr;
+  key.batched = use_batched_gemm;
+  key.workspace_size = workspace_size;
   if (use_batched_gemm) {
     auto get_batch_count = [](int64_t* shape, int batch_offset) {
       int64_t count = 1;
@@ -251,54 +441,58 @@ void CallCublasLt(cublasLtHandle_t hdl, cudaStream_t stream,
       }
       return count;
     };
-    auto set_batch = [](cublasLtMatrixLayout_t mat_desc, int batch_count, int64_t batch_stride) {
-      CHECK_CUBLAS_ERROR(cublasLtMatrixLayoutSetAttribute(
-          mat_desc, CUBLASLT_MATRIX_LAYOUT_BATCH_COUNT, &batch_count, sizeof(batch_count)));
-      CHECK_CUBLAS_ERROR(
-          cublasLtMatrixLayoutSetAttribute(mat_desc, CUBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET,
-                                           &batch_stride, sizeof(batch_stride)));
-    };
-
-    int batch_count_A = get_batch_count(A->shape, batch_offset_A);
-    int batch_count_B = get_batch_count(B->shape, batch_offset_B);
-    int batch_count_C = get_batch_count(C->shape, C->ndim - 2);
-    int64_t batch_stride_A = M * K;
-    int64_t batch_stride_B = K * N;
-    int64_t batch_stride_C = M * N;
+    key.batch_count_a = get_batch_count(A->shape, batch_offset_A);
+    key.batch_count_b = get_batch_count(B->shape, batch_offset_B);
+    key.batch_count_c = get_batch_count(C->shape, C->ndim - 2);
 
     // cuBLASLt does not seem to support batched GEMM with one of matrices having
     // one batch (with batch_stride 0).
-    ICHECK_EQ(batch_count_A, batch_count_B);
-
-    set_batch(A_desc, batch_count_A, batch_stride_A);
-    set_batch(B_desc, batch_count_B, batch_stride_B);
-    set_batch(C_desc, batch_count_C, batch_stride_C);
+    ICHECK_EQ(key.batch_count_a, key.batch_count_b);
   }
 
   auto A_data = static_cast<char*>(A->data) + A->byte_offset;
   auto B_data = static_cast<char*>(B->data) + B->byte_offset;
   auto C_data = static_cast<char*>(C->data) + C->byte_offset;
 
-  cublasLtMatmulPreferenceSetAttribute(matmul_pref_desc, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
-                                       &workspace_size, sizeof(size_t));
+  // The descriptors and the algorithm are built on the first call of each matmul of the thread,
+  // and reused by the later ones.
+  CuBlasLtThreadEntry* entry = CuBlasLtThreadEntry::ThreadLocal();
+  auto it = entry->matmul_plans.find(key);
+  std::unique_ptr<CublasLtMatmulPlan> new_plan;
+  CublasLtMatmulPlan* plan;
+  if (it != entry->matmul_plans.end()) {
+    plan = it->second.get();
+  } else {
+    new_plan = CreateCublasLtPlan(key, scale_type);
+    plan = new_plan.get();
+  }
+  cublasLtMatmulDesc_t op_desc = plan->op_desc;
 
-  cublasLtMatmulHeuristicResult_t heuristic_result = {};
-  int returned_result = 0;
-  CHECK_CUBLAS_ERROR(cublasLtMatmulAlgoGetHeuristic(hdl, op_desc, A_desc, B_desc, C_desc, C_desc,
-                                                    matmul_pref_desc, 1, &heuristic_result,
-                                                    &returned_result));
-  if (returned_result == 0) {
-    CHECK_CUBLAS_ERROR(CUBLAS_STATUS_NOT_SUPPORTED);
+  if (bias != nullptr) {
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER,
+                                                      &bias->data, sizeof(float*)));
+  }
+
+  if (scaleA != nullptr) {
+    auto scaleA_data = static_cast<char*>(scaleA->data) + scaleA->byte_offset;
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_A_SCALE_POINTER,
+                                                      &scaleA_data, sizeof(float*)));
+  }
+  if (scaleB != nullptr) {
+    auto scaleB_data = static_cast<char*>(scaleB->data) + scaleB->byte_offset;
+    CHECK_CUBLAS_ERROR(cublasLtMatmulDescSetAttribute(op_desc, CUBLASLT_MATMUL_DESC_B_SCALE_POINTER,
+                                                      &scaleB_data, sizeof(float*)));
   }
 
-  CHECK_CUBLAS_ERROR(cublasLtMatmul(hdl, op_desc, alpha, B_data, A_desc, A_data, B_desc, beta,
-                                    C_data, C_desc, C_data, C_desc, &heuristic_result.algo,
-                                    workspace_ptr, workspace_size, stream));
+  if (new_plan != nullptr) {
+    plan->algo = ChooseCublasLtAlgo(hdl, stream, matmul_pref_desc, key, *plan, alpha, A_data,
+                                    B_data, beta, C_data, workspace_ptr);
+    entry->matmul_plans.emplace(key, std::move(new_plan));
+  }
 
-  cublasLtMatmulDescDestroy(op_desc);
-  cublasLtMatrixLayoutDestroy(A_desc);
-  cublasLtMatrixLayoutDestroy(B_desc);
-  cublasLtMatrixLayoutDestroy(C_desc);
+  CHECK_CUBLAS_ERROR(cublasLtMatmul(hdl, op_desc, alpha, B_data, plan->A_desc, A_data,
+                                    plan->B_desc, beta, C_data, plan->C_desc, C_data, plan->C_desc,
+                                    &plan->algo, workspace_ptr, workspace_size, stream));
 }
 
 inline void CallLtIgemm(TVMArgs args, TVMRetValue* ret, cublasLtHandle_t hdl, cudaStream_t stream) {
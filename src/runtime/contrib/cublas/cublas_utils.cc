@@ -25,6 +25,9 @@
 #include <dmlc/thread_local.h>
 #include <tvm/runtime/registry.h>
 
+#include <sstream>
+#include <tuple>
+
 #include "../../cuda/cuda_common.h"
 
 namespace tvm {
@@ -48,6 +51,42 @@ CuBlasThreadEntry* CuBlasThreadEntry::ThreadLocal() {
   return retval;
 }
 
+bool CublasLtMatmulKey::operator==(const CublasLtMatmulKey& other) const {
+  auto fields = [](const CublasLtMatmulKey& key) {
+    return std::tie(key.device_id, key.M, key.N, key.K, key.ab_type, key.c_type, key.compute_type,
+                    key.transa, key.transb, key.epilogue, key.has_bias, key.has_scale_a,
+                    key.has_scale_b, key.batched, key.batch_count_a, key.batch_count_b,
+                    key.batch_count_c, key.workspace_size);
+  };
+  return fields(*this) == fields(other);
+}
+
+std::string CublasLtMatmulKey::ToString() const {
+  std::ostringstream os;
+  os << M << "," << N << "," << K << "," << ab_type << "," << c_type << "," << compute_type << ","
+     << transa << "," << transb << "," << epilogue << "," << has_bias << "," << has_scale_a << ","
+     << has_scale_b << "," << batched << "," << batch_count_a << "," << batch_count_b << ","
+     << batch_count_c << "," << workspace_size;
+  return os.str();
+}
+
+size_t CublasLtMatmulKeyHash::operator()(const CublasLtMatmulKey& key) const {
+  size_t hash = 0;
+  for (int64_t value : {static_cast<int64_t>(key.device_id), key.M, key.N, key.K,
+                        static_cast<int64_t>(key.ab_type), static_cast<int64_t>(key.c_type),
+                        static_cast<int64_t>(key.epilogue), key.batch_count_a}) {
+    hash = hash * 31 + std::hash<int64_t>()(value);
+  }
+  return hash ^ (key.transa << 1) ^ (key.transb << 2) ^ (key.has_bias << 3);
+}
+
+CublasLtMatmulPlan::~CublasLtMatmulPlan() {
+  if (op_desc) cublasLtMatmulDescDestroy(op_desc);
+  if (A_desc) cublasLtMatrixLayoutDestroy(A_desc);
+  if (B_desc) cublasLtMatrixLayoutDestroy(B_desc);
+  if (C_desc) cublasLtMatrixLayoutDestroy(C_desc);
+}
+
 CuBlasLtThreadEntry::CuBlasLtThreadEntry() {
   CHECK_CUBLAS_ERROR(cublasLtCreate(&handle));
   CHECK_CUBLAS_ERROR(cublasLtMatmulPreferenceCreate(&matmul_pref_desc));
@@ -55,6 +94,7 @@ CuBlasLtThreadEntry::CuBlasLtThreadEntry() {
 }
 
 CuBlasLtThreadEntry::~CuBlasLtThreadEntry() {
+  matmul_plans.clear();
   if (handle) {
     cublasLtDestroy(handle);
     handle = nullptr;
@@ -34,7 +34,10 @@
 #if CUDART_VERSION >= 10010
 #include <cublasLt.h>
 #endif  // CUDART_VERSION >= 10010
+#include <memory>
 #include <optional>
+#include <string>
+#include <unordered_map>
 
 namespace tvm {
 namespace contrib {
@@ -78,6 +81,40 @@ struct CuBlasThreadEntry {
   static CuBlasThreadEntry* ThreadLocal();
 };  // CuBlasThreadEntry
 
+/*! \brief The shapes, types and options of a cuBLASLt matmul, which its descriptors depend on. */
+struct CublasLtMatmulKey {
+  int device_id;
+  int64_t M, N, K;
+  cudaDataType_t ab_type, c_type;
+  cublasComputeType_t compute_type;
+  bool transa, transb;
+  cublasLtEpilogue_t epilogue;
+  bool has_bias, has_scale_a, has_scale_b;
+  bool batched;
+  int64_t batch_count_a, batch_count_b, batch_count_c;
+  size_t workspace_size;
+
+  bool operator==(const CublasLtMatmulKey& other) const;
+  /*! \brief The key as text, without the device, to persist the algorithm chosen for it. */
+  std::string ToString() const;
+};
+
+struct CublasLtMatmulKeyHash {
+  size_t operator()(const CublasLtMatmulKey& key) const;
+};
+
+/*! \brief The descriptors and the algorithm of a cuBLASLt matmul, reused by its calls. */
+struct CublasLtMatmulPlan {
+  CublasLtMatmulPlan() = default;
+  CublasLtMatmulPlan(const CublasLtMatmulPlan&) = delete;
+  CublasLtMatmulPlan& operator=(const CublasLtMatmulPlan&) = delete;
+  ~CublasLtMatmulPlan();
+
+  cublasLtMatmulDesc_t op_desc{nullptr};
+  cublasLtMatrixLayout_t A_desc{nullptr}, B_desc{nullptr}, C_desc{nullptr};
+  cublasLtMatmulAlgo_t algo;
+};
+
 struct CuBlasLtThreadEntry {
   CuBlasLtThreadEntry();
   ~CuBlasLtThreadEntry();
@@ -88,6 +125,9 @@ struct CuBlasLtThreadEntry {
   // 32MB workspace as suggested by NVIDIA
   // https://docs.nvidia.com/cuda/cublas/index.html#cublassetworkspace.
   static constexpr const size_t workspace_size = 33554432;
+  // The plans of the matmuls called by this thread, built on their first call.
+  std::unordered_map<CublasLtMatmulKey, std::unique_ptr<CublasLtMatmulPlan>, CublasLtMatmulKeyHash>
+      matmul_plans;
 
   static CuBlasLtThreadEntry* ThreadLocal();
 };  // CuBlasLtThreadEntry
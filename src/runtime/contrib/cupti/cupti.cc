@@ -0,0 +1,234 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <cuda_runtime.h>
+#include <cupti.h>
+#include <tvm/runtime/contrib/cupti.h>
+#include <tvm/runtime/registry.h>
+
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace profiling {
+
+#define CUPTI_CALL(func)                                                     \
+  {                                                                          \
+    CUptiResult e = (func);                                                  \
+    if (e != CUPTI_SUCCESS) {                                                \
+      const char* msg;                                                       \
+      cuptiGetResultString(e, &msg);                                         \
+      LOG(FATAL) << "CUPTIError: in function " #func " " << e << " " << msg; \
+    }                                                                        \
+  }
+
+/*! \brief The activity buffers completed by CUPTI, waiting to be parsed. */
+class ActivityBuffers {
+ public:
+  static ActivityBuffers* Global() {
+    static ActivityBuffers* inst = new ActivityBuffers();
+    return inst;
+  }
+
+  static void CUPTIAPI BufferRequested(uint8_t** buffer, size_t* size, size_t* max_num_records) {
+    *buffer = static_cast<uint8_t*>(std::aligned_alloc(kAlignment, kBufferSize));
+    *size = kBufferSize;
+    *max_num_records = 0;
+  }
+
+  static void CUPTIAPI BufferCompleted(CUcontext ctx, uint32_t stream_id, uint8_t* buffer,
+                                       size_t size, size_t valid_size) {
+    ActivityBuffers* self = Global();
+    std::lock_guard<std::mutex> lock(self->mutex_);
+    self->completed_.emplace_back(buffer, valid_size);
+  }
+
+  /*! \brief Take the completed buffers, which the caller must free. */
+  std::vector<std::pair<uint8_t*, size_t>> Take() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::move(completed_);
+  }
+
+ private:
+  static constexpr size_t kAlignment = 8;
+  static constexpr size_t kBufferSize = 8 * 1024 * 1024;
+
+  std::mutex mutex_;
+  std::vector<std::pair<uint8_t*, size_t>> completed_;
+};
+
+/*! \brief The external correlation id of a call, and the one of its enclosing call. */
+struct CUPTICallNode : public Object {
+  uint64_t id;
+  uint64_t parent;
+
+  CUPTICallNode(uint64_t id, uint64_t parent) : id(id), parent(parent) {}
+
+  static constexpr const char* _type_key = "CUPTICallNode";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CUPTICallNode, Object);
+};
+
+/*! \brief The metrics of a call, filled in by `Flush`. */
+struct PendingCall {
+  uint64_t parent;
+  ObjectPtr<DurationNode> duration;
+  ObjectPtr<CountNode> kernels;
+};
+
+/*! \brief MetricCollectorNode reporting the kernels of each call from CUPTI activity records.
+ *
+ * Each call pushes an external correlation id, which CUPTI attaches to the
+ * CUDA API calls made until it is popped. The records are delivered
+ * asynchronously, so `Stop` returns zeroed metrics that `Flush` fills in once
+ * the devices are synchronized.
+ */
+struct CUPTIMetricCollectorNode final : public MetricCollectorNode {
+  static constexpr CUpti_ActivityKind kActivityKinds[] = {
+      CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL, CUPTI_ACTIVITY_KIND_EXTERNAL_CORRELATION,
+      CUPTI_ACTIVITY_KIND_RUNTIME, CUPTI_ACTIVITY_KIND_DRIVER};
+
+  void Init(Array<DeviceWrapper> devices) final {
+    for (const DeviceWrapper& dev : devices) {
+      if (dev->device.device_type == kDLCUDA) {
+        devices_.push_back(dev->device);
+      }
+    }
+    if (devices_.empty()) return;
+    CUPTI_CALL(cuptiActivityRegisterCallbacks(ActivityBuffers::BufferRequested,
+                                              ActivityBuffers::BufferCompleted));
+    for (CUpti_ActivityKind kind : kActivityKinds) {
+      CUPTI_CALL(cuptiActivityEnable(kind));
+    }
+    enabled_ = true;
+  }
+
+  ObjectRef Start(Device dev) final {
+    if (!enabled_ || dev.device_type != kDLCUDA) {
+      return ObjectRef(nullptr);
+    }
+    uint64_t parent = stack_.empty() ? 0 : stack_.back();
+    uint64_t id = ++next_id_;
+    stack_.push_back(id);
+    CUPTI_CALL(cuptiActivityPushExternalCorrelationId(CUPTI_EXTERNAL_CORRELATION_KIND_CUSTOM0, id));
+    return ObjectRef(make_object<CUPTICallNode>(id, parent));
+  }
+
+  Map<String, ObjectRef> Stop(ObjectRef obj) final {
+    const auto* call = obj.as<CUPTICallNode>();
+    if (call == nullptr) return {};
+    uint64_t popped;
+    CUPTI_CALL(
+        cuptiActivityPopExternalCorrelationId(CUPTI_EXTERNAL_CORRELATION_KIND_CUSTOM0, &popped));
+    ICHECK_EQ(popped, call->id) << "CUPTI calls must be stopped in the reverse order of starting";
+    stack_.pop_back();
+    PendingCall pending{call->parent, make_object<DurationNode>(0), make_object<CountNode>(0)};
+    pending_[call->id] = pending;
+    return {{"Kernel Duration (us)", ObjectRef(pending.duration)},
+            {"Kernels", ObjectRef(pending.kernels)}};
+  }
+
+  void Flush() final {
+    if (!enabled_ || pending_.empty()) return;
+    for (const Device& dev : devices_) {
+      cudaSetDevice(dev.device_id);
+      cudaDeviceSynchronize();
+    }
+    CUPTI_CALL(cuptiActivityFlushAll(CUPTI_ACTIVITY_FLAG_FLUSH_FORCED));
+
+    // The records of a kernel and of the correlation of its launch may come in any order.
+    std::unordered_map<uint32_t, uint64_t> external_ids;
+    std::vector<std::pair<uint32_t, uint64_t>> kernels;
+    for (auto [buffer, valid_size] : ActivityBuffers::Global()->Take()) {
+      CUpti_Activity* record = nullptr;
+      while (cuptiActivityGetNextRecord(buffer, valid_size, &record) == CUPTI_SUCCESS) {
+        if (record->kind == CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL) {
+          const auto* kernel = reinterpret_cast<const CUpti_ActivityKernel4*>(record);
+          kernels.emplace_back(kernel->correlationId, kernel->end - kernel->start);
+        } else if (record->kind == CUPTI_ACTIVITY_KIND_EXTERNAL_CORRELATION) {
+          const auto* corr = reinterpret_cast<const CUpti_ActivityExternalCorrelation*>(record);
+          if (corr->externalKind == CUPTI_EXTERNAL_CORRELATION_KIND_CUSTOM0) {
+            external_ids[corr->correlationId] = corr->externalId;
+          }
+        }
+      }
+      std::free(buffer);
+    }
+
+    for (const auto& [correlation_id, duration_ns] : kernels) {
+      auto it = external_ids.find(correlation_id);
+      if (it == external_ids.end()) continue;
+      // A kernel counts towards its call and all the enclosing ones, e.g. the "Total" call.
+      for (uint64_t id = it->second; id != 0;) {
+        auto pending_it = pending_.find(id);
+        if (pending_it == pending_.end()) break;
+        PendingCall& pending = pending_it->second;
+        pending.duration->microseconds += duration_ns / 1e3;
+        pending.kernels->value += 1;
+        id = pending.parent;
+      }
+    }
+    pending_.clear();
+  }
+
+  ~CUPTIMetricCollectorNode() final {
+    if (!enabled_) return;
+    for (CUpti_ActivityKind kind : kActivityKinds) {
+      cuptiActivityDisable(kind);
+    }
+    cuptiActivityFlushAll(0);
+    for (auto [buffer, valid_size] : ActivityBuffers::Global()->Take()) {
+      std::free(buffer);
+    }
+  }
+
+  std::vector<Device> devices_;
+  bool enabled_{false};
+  uint64_t next_id_{0};
+  /*! \brief The ids of the calls started and not stopped yet. */
+  std::vector<uint64_t> stack_;
+  /*! \brief The stopped calls, waiting for their activity records. */
+  std::unordered_map<uint64_t, PendingCall> pending_;
+
+  static constexpr const char* _type_key = "runtime.profiling.CUPTIMetricCollector";
+  TVM_DECLARE_FINAL_OBJECT_INFO(CUPTIMetricCollectorNode, MetricCollectorNode);
+};
+
+/*! \brief Wrapper for `CUPTIMetricCollectorNode`. */
+class CUPTIMetricCollector : public MetricCollector {
+ public:
+  CUPTIMetricCollector() { data_ = make_object<CUPTIMetricCollectorNode>(); }
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(CUPTIMetricCollector, MetricCollector,
+                                        CUPTIMetricCollectorNode);
+};
+
+MetricCollector CreateCUPTIMetricCollector() { return CUPTIMetricCollector(); }
+
+TVM_REGISTER_OBJECT_TYPE(CUPTICallNode);
+TVM_REGISTER_OBJECT_TYPE(CUPTIMetricCollectorNode);
+
+TVM_REGISTER_GLOBAL("runtime.profiling.CUPTIMetricCollector").set_body_typed([]() {
+  return CUPTIMetricCollector();
+});
+
+}  // namespace profiling
+}  // namespace runtime
+}  // namespace tvm
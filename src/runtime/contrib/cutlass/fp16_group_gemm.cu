@@ -61,9 +61,49 @@ void tvm_cutlass_group_gemm_sm90(NDArray x, NDArray weight, NDArray indptr, NDAr
                      static_cast<ElementC*>(out->data), stream);
 }
 
+/*!
+ * \brief Segmented GEMM for batched adapters, out[i] = x[i] @ weight[weight_indices[i]]^T.
+ * \param x The input of shape (num_seqs, seq_len, k), each sequence is one group of the GEMM.
+ * \param weight The stacked weights of shape (num_weights, n, k).
+ * \param weight_indices The index of the weight used by each sequence, of shape (num_seqs,).
+ * \param workspace The workspace for the device-side GEMM arguments.
+ * \param out The output of shape (num_seqs, seq_len, n).
+ */
+template <typename ElementA, typename ElementB, typename ElementC>
+void tvm_cutlass_segment_gemm_sm90(NDArray x, NDArray weight, NDArray weight_indices,
+                                   NDArray workspace, NDArray out) {
+  auto func = tvm::runtime::Registry::Get("runtime.get_cuda_stream");
+  ICHECK(func != nullptr);
+  CHECK_EQ(x->ndim, 3);
+  CHECK_EQ(weight->ndim, 3);
+  CHECK_EQ(weight_indices->ndim, 1);
+  CHECK_EQ(workspace->ndim, 1);
+  CHECK_EQ(out->ndim, 3);
+  int num_groups = x->shape[0];
+  int rows_per_group = x->shape[1];
+  int n = weight->shape[1];
+  int k = weight->shape[2];
+  CHECK_EQ(weight_indices->shape[0], num_groups);
+  // The arguments of all groups are prepared by one thread block.
+  CHECK_LE(num_groups, 1024) << "ValueError: At most 1024 sequences are supported, but got "
+                             << num_groups;
+  float alpha = 1.0f;
+  float beta = 0.0f;
+  cudaStream_t stream = static_cast<cudaStream_t>((*func)().operator void*());
+  cutlass_group_gemm(static_cast<ElementA*>(x->data), static_cast<ElementB*>(weight->data),
+                     /*indptr=*/nullptr, static_cast<uint8_t*>(workspace->data),
+                     workspace->shape[0], n, k, num_groups, alpha, beta,
+                     static_cast<ElementC*>(out->data), stream,
+                     static_cast<const int64_t*>(weight_indices->data), rows_per_group);
+}
+
 TVM_REGISTER_GLOBAL("cutlass.group_gemm_fp16_sm90")
     .set_body_typed(tvm_cutlass_group_gemm_sm90<cutlass::half_t, cutlass::half_t, cutlass::half_t>);
 
+TVM_REGISTER_GLOBAL("cutlass.segment_gemm_fp16_sm90")
+    .set_body_typed(
+        tvm_cutlass_segment_gemm_sm90<cutlass::half_t, cutlass::half_t, cutlass::half_t>);
+
 }  // namespace runtime
 }  // namespace tvm
 
@@ -154,15 +154,21 @@ __global__ void prepare_group_gemm_arguments(
     const ElementA** ptr_A, const ElementB** ptr_B, ElementC** ptr_D,
     typename ProblemShape::UnderlyingProblemShape* problem_sizes, StrideA* stride_A,
     StrideB* stride_B, StrideC* stride_D, const ElementA* x, const ElementB* weight, ElementC* out,
-    int64_t* indptr, int64_t n, int64_t k, int64_t num_groups) {
+    int64_t* indptr, int64_t n, int64_t k, int64_t num_groups, const int64_t* weight_indices,
+    int64_t rows_per_group) {
   int group_id = threadIdx.x;
   if (group_id >= num_groups) return;
-  int prev_rows = group_id == 0 ? 0 : indptr[group_id - 1];
+  // Without indptr, every group has rows_per_group rows. Without weight_indices, the i-th group
+  // uses the i-th weight.
+  int64_t prev_rows = indptr == nullptr ? group_id * rows_per_group
+                      : group_id == 0   ? 0
+                                        : indptr[group_id - 1];
+  int64_t rows = indptr == nullptr ? rows_per_group : indptr[group_id] - prev_rows;
+  int64_t weight_id = weight_indices == nullptr ? group_id : weight_indices[group_id];
   ptr_A[group_id] = x + prev_rows * k;
-  ptr_B[group_id] = weight + group_id * k * n;
+  ptr_B[group_id] = weight + weight_id * k * n;
   ptr_D[group_id] = out + prev_rows * n;
-  problem_sizes[group_id] = {static_cast<int>(indptr[group_id] - prev_rows), static_cast<int>(n),
-                             static_cast<int>(k)};
+  problem_sizes[group_id] = {static_cast<int>(rows), static_cast<int>(n), static_cast<int>(k)};
   stride_A[group_id] = cute::make_stride(k, Int<1>{}, int64_t{0});
   stride_B[group_id] = cute::make_stride(k, Int<1>{}, int64_t{0});
   stride_D[group_id] = cute::make_stride(n, Int<1>{}, int64_t{0});
@@ -173,7 +179,8 @@ void cutlass_group_gemm(ElementA* x, ElementB* weight, int64_t* indptr, uint8_t*
                         int64_t workspace_size, int64_t n, int64_t k, int64_t num_groups,
                         std::variant<float, const float*> alpha,
                         std::variant<float, const float*> beta, ElementC* out,
-                        cudaStream_t stream) {
+                        cudaStream_t stream, const int64_t* weight_indices = nullptr,
+                        int64_t rows_per_group = 0) {
   using Runner = CutlassGroupGemmRunner<ElementA, ElementB, ElementC>;
   using StrideA = typename Runner::StrideA;
   using StrideB = typename Runner::StrideB;
@@ -198,7 +205,8 @@ void cutlass_group_gemm(ElementA* x, ElementB* weight, int64_t* indptr, uint8_t*
   offset += aligned(sizeof(StrideC) * num_groups);
   prepare_group_gemm_arguments<<<1, num_groups, 0, stream>>>(ptr_A, ptr_B, ptr_D, problem_sizes,
                                                              stride_A, stride_B, stride_D, x,
-                                                             weight, out, indptr, n, k, num_groups);
+                                                             weight, out, indptr, n, k, num_groups,
+                                                             weight_indices, rows_per_group);
   offset = aligned(offset, 256);
   runner.run_group_gemm(ptr_A, ptr_B, const_cast<const ElementC**>(ptr_D), ptr_D, problem_sizes,
                         nullptr, stride_A, stride_B, stride_D, stride_D, workspace + offset,
@@ -408,10 +408,7 @@ class TensorRequisite {
       if (reinterpret_) {
         return {t_desc_, orig_const_data.get_engine(), orig_const_data.get_data_handle()};
       } else {
-        auto eng = orig_const_data.get_engine();
-        auto res = dnnl::memory{t_desc_, eng};
-        dnnl::reorder(orig_const_data, res).execute(dnnl::stream(eng), orig_const_data, res);
-        return res;
+        return ReorderConstData(orig_const_data, t_desc_);
       }
     }
     return {};
@@ -23,6 +23,15 @@
 
 #include "dnnl_utils.h"
 
+#include <tvm/runtime/registry.h>
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
 #include "tvm/runtime/logging.h"
 
 namespace tvm {
@@ -71,6 +80,99 @@ dnnl::memory::desc MakePlainDesc(const std::vector<int64_t>& shape, DLDataType d
   return {dnnl_shape, dnnl_dtype, dnnl_plain_strides};
 }
 
+namespace {
+
+/*! \brief The LRU cache of the reordered constant data. */
+class ConstReorderCache {
+ public:
+  static ConstReorderCache* Global() {
+    static ConstReorderCache* inst = new ConstReorderCache();
+    return inst;
+  }
+
+  dnnl::memory Reorder(const dnnl::memory& src, const dnnl::memory::desc& dst_desc) {
+    auto src_desc = src.get_desc();
+    std::string_view content(static_cast<const char*>(src.get_data_handle()), src_desc.get_size());
+    size_t hash = std::hash<std::string_view>()(content);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto range = index_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      const Entry& entry = *it->second;
+      if (entry.src_desc == src_desc && entry.dst.get_desc() == dst_desc) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return entry.dst;
+      }
+    }
+
+    auto eng = src.get_engine();
+    dnnl::memory dst{dst_desc, eng};
+    dnnl::stream stream(eng);
+    dnnl::reorder(src, dst).execute(stream, src, dst);
+    stream.wait();
+    if (dst_desc.get_size() > capacity_) {
+      return dst;
+    }
+    lru_.push_front(Entry{hash, src_desc, dst});
+    index_.emplace(hash, lru_.begin());
+    size_ += dst_desc.get_size();
+    Evict();
+    return dst;
+  }
+
+  void SetCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    Evict();
+  }
+
+ private:
+  struct Entry {
+    size_t hash;
+    dnnl::memory::desc src_desc;
+    dnnl::memory dst;
+  };
+
+  void Evict() {
+    while (size_ > capacity_) {
+      const Entry& entry = lru_.back();
+      auto range = index_.equal_range(entry.hash);
+      for (auto it = range.first; it != range.second; ++it) {
+        if (&*it->second == &entry) {
+          index_.erase(it);
+          break;
+        }
+      }
+      size_ -= entry.dst.get_desc().get_size();
+      lru_.pop_back();
+    }
+  }
+
+  std::mutex mutex_;
+  // 256MB by default, the weights of a mid-sized model in a couple of layouts.
+  size_t capacity_{size_t(256) << 20};
+  size_t size_{0};
+  std::list<Entry> lru_;
+  std::unordered_multimap<size_t, std::list<Entry>::iterator> index_;
+};
+
+}  // namespace
+
+dnnl::memory ReorderConstData(const dnnl::memory& src, const dnnl::memory::desc& dst_desc) {
+  return ConstReorderCache::Global()->Reorder(src, dst_desc);
+}
+
+TVM_REGISTER_GLOBAL("runtime.dnnl.set_weight_cache_capacity").set_body_typed([](int64_t nbytes) {
+  CHECK_GE(nbytes, 0) << "ValueError: The capacity of the weight cache must be non-negative";
+  ConstReorderCache::Global()->SetCapacity(nbytes);
+});
+
+TVM_REGISTER_GLOBAL("runtime.dnnl.set_primitive_cache_capacity").set_body_typed([](int capacity) {
+  // oneDNN keeps the primitives created by the process in its own LRU cache.
+  CHECK_GE(capacity, 0) << "ValueError: The capacity of the primitive cache must be non-negative";
+  dnnl::set_primitive_cache_capacity(capacity);
+});
+
 }  // namespace contrib
 }  // namespace runtime
 }  // namespace tvm
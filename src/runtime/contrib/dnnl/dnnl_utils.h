@@ -62,6 +62,21 @@ dnnl::memory::dims shape_dl2dnnl(const std::vector<int64_t>& shape);
  */
 dnnl::memory::desc MakePlainDesc(const std::vector<int64_t>& shape, DLDataType dltype);
 
+/*!
+ * \brief Reorder constant data, e.g. weights, to the layout requested by a primitive.
+ *
+ * The reordered copies are shared by all the runtimes of the process.  They are found by the
+ * content of the data and the source and destination layouts, so that the modules built with
+ * the same weights, e.g. for several batch sizes, keep a single copy per layout.  The least
+ * recently used copies are dropped from the cache above its capacity in bytes, while the runtimes
+ * using them keep them alive.
+ *
+ * \param src The constant data.
+ * \param dst_desc The requested layout.
+ * \return The reordered data.
+ */
+dnnl::memory ReorderConstData(const dnnl::memory& src, const dnnl::memory::desc& dst_desc);
+
 namespace utils {
 
 /*! \brief Pretty printer util for shape */
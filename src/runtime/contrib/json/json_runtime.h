@@ -27,8 +27,13 @@
 
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -91,6 +96,32 @@ class JSONRuntimeBase : public ModuleNode {
         // Execute the subgraph.
         this->Run();
       });
+    } else if (name == "set_input_zero_copy" || name == "set_output_zero_copy") {
+      // Bind a tensor to an input or an output once, for the later calls of "run".  The caller
+      // keeps the tensor alive while it is bound.
+      bool is_input = name == "set_input_zero_copy";
+      return PackedFunc([sptr_to_self, this, is_input](TVMArgs args, TVMRetValue* rv) {
+        ICHECK_EQ(args.size(), 2U);
+        int index = args[0];
+        size_t num_entries = is_input ? input_var_eid_.size() : outputs_.size();
+        ICHECK(index >= 0 && static_cast<size_t>(index) < num_entries)
+            << "IndexError: The " << (is_input ? "input" : "output") << " index " << index
+            << " is out of range for " << num_entries << " entries";
+        this->BindEntry(is_input ? input_var_eid_[index] : EntryID(outputs_[index]), args[1]);
+      });
+    } else if (name == "run") {
+      // Execute the subgraph on the tensors bound by set_input/output_zero_copy.
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        ICHECK(this->initialized_) << "The module has not been initialized";
+        for (uint32_t eid : input_var_eid_) {
+          ICHECK(data_entry_[eid] != nullptr) << "ValueError: An input of the subgraph is not set";
+        }
+        for (const auto& output : outputs_) {
+          ICHECK(data_entry_[EntryID(output)] != nullptr)
+              << "ValueError: An output of the subgraph is not set";
+        }
+        this->Run();
+      });
     } else if ("__init_" + this->symbol_name_ == name) {
       // The function to initialize constant tensors.
       return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
@@ -161,20 +192,124 @@ class JSONRuntimeBase : public ModuleNode {
     for (size_t i = 0; i < static_cast<size_t>(args.size()); i++) {
       auto eid = i < input_var_eid_.size() ? input_var_eid_[i]
                                            : EntryID(outputs_[i - input_var_eid_.size()]);
-      ICHECK(args[i].type_code() == kTVMNDArrayHandle || args[i].type_code() == kTVMDLTensorHandle)
-          << "Expect NDArray or DLTensor as inputs";
+      BindEntry(eid, args[i]);
+    }
+  }
 
-      const DLTensor* arg;
-      if (args[i].IsObjectRef<NDArray>()) {
-        NDArray arr = args[i];
-        arg = arr.operator->();
-      } else {
-        arg = args[i].operator DLTensor*();
+  /*!
+   * \brief Bind the DLTensor pointer of an argument to a data entry.
+   *
+   * \param eid The data entry.
+   * \param arg The NDArray or DLTensor.
+   */
+  void BindEntry(uint32_t eid, const TVMArgValue& arg) {
+    ICHECK(arg.type_code() == kTVMNDArrayHandle || arg.type_code() == kTVMDLTensorHandle)
+        << "Expect NDArray or DLTensor as inputs";
+
+    const DLTensor* tensor;
+    if (arg.IsObjectRef<NDArray>()) {
+      NDArray arr = arg;
+      tensor = arr.operator->();
+    } else {
+      tensor = arg.operator DLTensor*();
+    }
+
+    // Assign input/output the NDArray pointers to data entry so that we can directly
+    // read/write host buffers.
+    data_entry_[eid] = tensor;
+  }
+
+  /*!
+   * \brief Allocate the intermediate entries, i.e. the outputs of the kernel nodes which are not
+   * outputs of the graph, and bind them to their data entries.
+   *
+   * The entries whose lifetimes do not overlap share a buffer.  The lifetimes are counted in
+   * levels, so that the nodes of a level may run in parallel through RunNodes.  This is for the
+   * runtimes which execute the graph node by node on tensors of the device, the runtimes handing
+   * the whole graph to a library do not need it.
+   *
+   * \param dev The device to allocate on.
+   */
+  void SetupIntermediates(Device dev) {
+    // The level after which each entry is no longer read, the outputs of the graph excepted.
+    std::vector<int> last_use(NumEntries(), -1);
+    std::vector<bool> is_output(NumEntries(), false);
+    for (const auto& output : outputs_) {
+      is_output[EntryID(output)] = true;
+    }
+    for (size_t nid = 0; nid < nodes_.size(); ++nid) {
+      for (const auto& input : nodes_[nid].GetInputs()) {
+        uint32_t eid = EntryID(input);
+        last_use[eid] = std::max(last_use[eid], node_level_[nid]);
       }
+    }
+
+    // Best fit on the sizes of the free buffers, a buffer freed after a level is reused from the
+    // next one.
+    std::vector<size_t> storage_bytes;
+    std::vector<int> entry_storage(NumEntries(), -1);
+    std::vector<std::vector<uint32_t>> free_after(levels_.size());
+    std::multimap<size_t, int> free_storages;
+    for (size_t level = 0; level < levels_.size(); ++level) {
+      for (uint32_t nid : levels_[level]) {
+        const auto& node = nodes_[nid];
+        for (uint32_t i = 0; i < node.GetNumOutput(); ++i) {
+          uint32_t eid = EntryID(nid, i);
+          if (is_output[eid]) continue;
+          size_t nbytes = (node.GetOpDataType()[i].bits * node.GetOpDataType()[i].lanes + 7) / 8;
+          for (int64_t dim : node.GetOpShape()[i]) {
+            nbytes *= dim;
+          }
+          auto it = free_storages.lower_bound(nbytes);
+          if (it != free_storages.end()) {
+            entry_storage[eid] = it->second;
+            free_storages.erase(it);
+          } else {
+            entry_storage[eid] = storage_bytes.size();
+            storage_bytes.push_back(nbytes);
+          }
+          free_after[std::max<int>(level, last_use[eid])].push_back(eid);
+        }
+      }
+      for (uint32_t eid : free_after[level]) {
+        free_storages.emplace(storage_bytes[entry_storage[eid]], entry_storage[eid]);
+      }
+    }
 
-      // Assign input/output the NDArray pointers to data entry so that we can directly
-      // read/write host buffers.
-      data_entry_[eid] = arg;
+    intermediate_storages_.clear();
+    intermediate_entries_.clear();
+    for (size_t nbytes : storage_bytes) {
+      intermediate_storages_.push_back(
+          NDArray::Empty({static_cast<int64_t>(nbytes)}, DLDataType{kDLUInt, 8, 1}, dev));
+    }
+    for (size_t nid = 0; nid < nodes_.size(); ++nid) {
+      for (uint32_t i = 0; i < nodes_[nid].GetNumOutput(); ++i) {
+        uint32_t eid = EntryID(nid, i);
+        if (entry_storage[eid] < 0) continue;
+        NDArray view = intermediate_storages_[entry_storage[eid]].CreateView(
+            nodes_[nid].GetOpShape()[i], nodes_[nid].GetOpDataType()[i]);
+        data_entry_[eid] = view.operator->();
+        intermediate_entries_.push_back(view);
+      }
+    }
+  }
+
+  /*!
+   * \brief Run a function on every kernel node, level by level in topological order.
+   *
+   * \param fexec The function executing a node.
+   * \param parallel Whether to run the nodes of a level, which do not depend on each other, on
+   * the threads of the runtime.
+   */
+  void RunNodes(const std::function<void(uint32_t nid)>& fexec, bool parallel = false) {
+    for (const auto& level : levels_) {
+      if (parallel && level.size() > 1) {
+        parallel_for_with_threading_backend([&](int64_t i) { fexec(level[i]); }, 0, level.size());
+      } else {
+        for (uint32_t nid : level) {
+          fexec(nid);
+        }
+      }
     }
   }
 
@@ -215,6 +350,28 @@ class JSONRuntimeBase : public ModuleNode {
 
     // Reserve data entries.
     data_entry_.resize(NumEntries());
+    BuildLevels();
+  }
+
+  /*!
+   * \brief Group the kernel nodes into levels, a node being one level after the latest of its
+   * inputs, so that the nodes of a level do not depend on each other.
+   */
+  void BuildLevels() {
+    node_level_.assign(nodes_.size(), -1);
+    levels_.clear();
+    for (size_t nid = 0; nid < nodes_.size(); ++nid) {
+      if (nodes_[nid].GetOpType() != "kernel") continue;
+      int level = 0;
+      for (const auto& input : nodes_[nid].GetInputs()) {
+        level = std::max(level, node_level_[input.id_] + 1);
+      }
+      node_level_[nid] = level;
+      if (levels_.size() <= static_cast<size_t>(level)) {
+        levels_.resize(level + 1);
+      }
+      levels_[level].push_back(nid);
+    }
   }
 
   /*!
@@ -281,6 +438,13 @@ class JSONRuntimeBase : public ModuleNode {
   std::vector<uint32_t> input_var_eid_;
   /*! \brief input const node index. */
   std::vector<uint32_t> const_idx_;
+  /*! \brief The level of each kernel node, -1 for the other nodes. */
+  std::vector<int> node_level_;
+  /*! \brief The kernel nodes of each level. */
+  std::vector<std::vector<uint32_t>> levels_;
+  /*! \brief The buffers shared by the intermediate entries, and their views. */
+  std::vector<NDArray> intermediate_storages_;
+  std::vector<NDArray> intermediate_entries_;
   /*! \brief Indicate if the engine has been initialized. */
   bool initialized_{false};
   /*! \brief Initializer mutex*/
@@ -25,14 +25,17 @@
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
 #include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
 #include <ctime>
+#include <functional>
 #include <random>
 #include <thread>
 
 #include "../3rdparty/compiler-rt/builtin_fp16.h"
+#include "philox.h"
 
 namespace tvm {
 namespace contrib {
@@ -58,6 +61,7 @@ class RandomEngine {
   inline void Seed(unsigned seed) {
     rnd_engine_.seed(seed);
     this->rseed_ = static_cast<unsigned>(seed);
+    this->philox_offset_ = 0;
   }
 
   /*!
@@ -86,10 +90,11 @@ class RandomEngine {
     ICHECK(dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1);
 
     if (data->device.device_type == kDLCPU) {
-      std::uniform_real_distribution<float> uniform_dist(low, high);
-      std::generate_n(static_cast<float*>(data->data), size,
-                      [&]() { return uniform_dist(rnd_engine_); });
-    } else {
+      PhiloxFill(static_cast<float*>(data->data), size,
+                 [low, high](const uint32_t words[4], int k) {
+                   return low + (high - low) * philox::Uniform(words[k]);
+                 });
+    } else if (!DeviceFill(data, philox::Distribution::kUniform, low, high)) {
       LOG(FATAL) << "Do not support random.uniform on this device yet";
     }
   }
@@ -110,10 +115,11 @@ class RandomEngine {
     ICHECK(dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1);
 
     if (data->device.device_type == kDLCPU) {
-      std::normal_distribution<float> normal_dist(loc, scale);
-      std::generate_n(static_cast<float*>(data->data), size,
-                      [&]() { return normal_dist(rnd_engine_); });
-    } else {
+      PhiloxFill(static_cast<float*>(data->data), size,
+                 [loc, scale](const uint32_t words[4], int k) {
+                   return loc + scale * philox::Normal(words, k);
+                 });
+    } else if (!DeviceFill(data, philox::Distribution::kNormal, loc, scale)) {
       LOG(FATAL) << "Do not support random.normal on this device yet";
     }
   }
@@ -133,7 +139,7 @@ class RandomEngine {
   void RandomFillForMeasure(DLTensor* data) {
     if (data->device.device_type == kDLCPU) {
       FillDataForMeasure(data);
-    } else {
+    } else if (!DeviceFill(data, philox::Distribution::kMeasure, 0, 0)) {
       runtime::NDArray local = runtime::NDArray::Empty(
           std::vector<int64_t>{data->shape, data->shape + data->ndim}, data->dtype, {kDLCPU, 0});
       DLTensor* tensor = const_cast<DLTensor*>(local.operator->());
@@ -142,7 +148,68 @@ class RandomEngine {
     }
   }
 
+  /*!
+   * \return The function filling tensors on the device with Philox random numbers, nullptr if
+   *  the runtime is not built with one.
+   */
+  static const runtime::PackedFunc* GetDeviceFill(DLDeviceType device_type) {
+    if (device_type == kDLCUDA) {
+      static const runtime::PackedFunc* fcuda =
+          runtime::Registry::Get("tvm.contrib.random.philox_fill.cuda");
+      return fcuda;
+    } else if (device_type == kDLROCM) {
+      static const runtime::PackedFunc* frocm =
+          runtime::Registry::Get("tvm.contrib.random.philox_fill.rocm");
+      return frocm;
+    }
+    return nullptr;
+  }
+
  private:
+  /*!
+   * \brief Fills the tensor on its device with Philox random numbers of the distribution.
+   * \return Whether the device supports it.
+   */
+  bool DeviceFill(DLTensor* data, philox::Distribution dist, float a, float b) {
+    const runtime::PackedFunc* fill = GetDeviceFill(data->device.device_type);
+    if (fill == nullptr) return false;
+    (*fill)(data, static_cast<int>(dist), a, b, static_cast<int64_t>(rseed_),
+            static_cast<int64_t>(philox_offset_++));
+    return true;
+  }
+
+  /*!
+   * \brief Fills num elements in parallel, with value(words, i % 4) for element i where words
+   *  are the Philox block i / 4. The values do not depend on the number of threads.
+   */
+  template <typename T, typename FValue>
+  void PhiloxFill(T* data, int64_t num, FValue value) {
+    struct ParallelTask {
+      static int RunTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+        (*static_cast<std::function<void(int, int)>*>(cdata))(task_id, penv->num_task);
+        return 0;
+      }
+    };
+
+    uint64_t seed = rseed_;
+    uint64_t offset = philox_offset_++;
+    int64_t num_blocks = (num + 3) / 4;
+    std::function<void(int, int)> run = [&](int task_id, int num_tasks) {
+      int64_t blocks_per_task = (num_blocks + num_tasks - 1) / num_tasks;
+      int64_t begin = task_id * blocks_per_task;
+      int64_t end = std::min(begin + blocks_per_task, num_blocks);
+      uint32_t words[4];
+      for (int64_t block = begin; block < end; ++block) {
+        philox::Block(seed, offset, block, words);
+        for (int k = 0; k < 4 && block * 4 + k < num; ++k) {
+          data[block * 4 + k] = value(words, k);
+        }
+      }
+    };
+    int res = TVMBackendParallelLaunch(ParallelTask::RunTask, &run, 0);
+    ICHECK_EQ(res, 0) << "PhiloxFill: TVMBackendParallelLaunch failed";
+  }
+
   void FillDataImpl(void* data, int64_t st, int64_t ed, DLDataType dtype) {
     // Make the value be 1.0 - 10.0, not (0.0 - 1.0) so that we could satisfy
     // quantized dtype (uint8 / int8) data non-empty requirement
@@ -189,38 +256,33 @@ class RandomEngine {
   }
 
   void FillDataForMeasure(DLTensor* tensor) {
-    struct ParallelTask {
-      static int RunTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
-        ParallelTask* task = static_cast<ParallelTask*>(cdata);
-        task->Run(task_id, penv->num_task);
-        return 0;
-      }
-
-      void Run(int i, int num_tasks) {
-        int64_t chunk_size = size / num_tasks;
-        int64_t st = i * chunk_size;
-        int64_t ed = std::min(st + chunk_size, size);
-        self->FillDataImpl(data, st, ed, dtype);
-      }
-
-      RandomEngine* self;
-      void* data;
-      int64_t size;
-      DLDataType dtype;
-    };
-
-    ParallelTask task;
-    task.self = this;
-    task.data = tensor->data;
-    DLDataType dtype = task.dtype = tensor->dtype;
-    int64_t& size = task.size = 1;
+    int64_t size = 1;
     for (int i = 0; i < tensor->ndim; ++i) {
       size *= tensor->shape[i];
     }
-    if (dtype.bits == 1 || dtype.bits == 4 || dtype.bits == 8 || dtype.bits == 16 ||
-        dtype.bits == 32 || dtype.bits == 64) {
-      int res = TVMBackendParallelLaunch(ParallelTask::RunTask, &task, 0);
-      ICHECK_EQ(res, 0) << "RandomFillForMeasure: TVMBackendParallelLaunch failed";
+    DLDataType dtype = tensor->dtype;
+    auto measure_value = [](const uint32_t words[4], int k) {
+      return philox::MeasureValue(words[k]);
+    };
+    if (dtype.bits == 1) {
+      PhiloxFill(static_cast<bool*>(tensor->data), size, measure_value);
+    } else if (dtype.bits == 4) {
+      // For uint4/int4 we pack two values into a single byte.
+      PhiloxFill(static_cast<uint8_t*>(tensor->data), (size + 1) / 2,
+                 [](const uint32_t words[4], int k) {
+                   return philox::PackedInt4MeasureValue(words[k]);
+                 });
+    } else if (dtype.bits == 8) {
+      PhiloxFill(static_cast<uint8_t*>(tensor->data), size, measure_value);
+    } else if (dtype.bits == 16) {
+      PhiloxFill(static_cast<uint16_t*>(tensor->data), size, [](const uint32_t words[4], int k) {
+        return __truncXfYf2__<float, uint32_t, 23, uint16_t, uint16_t, 10>(
+            philox::MeasureValue(words[k]));
+      });
+    } else if (dtype.bits == 32) {
+      PhiloxFill(static_cast<float*>(tensor->data), size, measure_value);
+    } else if (dtype.bits == 64) {
+      PhiloxFill(static_cast<double*>(tensor->data), size, measure_value);
     } else {
       LOG(FATAL) << "Doesn't support dtype code " << dtype.code << " dtype bits " << dtype.bits;
     }
@@ -229,6 +291,8 @@ class RandomEngine {
  private:
   std::mt19937 rnd_engine_;
   unsigned rseed_;
+  /*! \brief The offset of the next Philox fill, so that successive fills differ. */
+  uint64_t philox_offset_ = 0;
 };
 
 }  // namespace contrib
@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file random/philox.h
+ * \brief Philox4x32-10 counter-based random numbers, shared by the host and the device fills.
+ *
+ * Element i of a fill of (seed, offset) takes word i % 4 of the Philox block i / 4, so the
+ * value of each element only depends on its index, whatever the threads computing it.
+ */
+#ifndef TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
+#define TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
+
+#include <math.h>
+#include <stdint.h>
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+#define TVM_PHILOX_FUNC __host__ __device__ inline
+#else
+#define TVM_PHILOX_FUNC inline
+#endif
+
+namespace tvm {
+namespace contrib {
+namespace philox {
+
+/*! \brief The distributions of the Philox fills. */
+enum class Distribution : int {
+  /*! \brief The inputs of measurements, see MeasureValue. */
+  kMeasure = 0,
+  /*! \brief Unif(a, b). */
+  kUniform = 1,
+  /*! \brief Normal(a, b**2). */
+  kNormal = 2,
+};
+
+/*! \brief Compute the four random words of a block of a fill of (seed, offset). */
+TVM_PHILOX_FUNC void Block(uint64_t seed, uint64_t offset, uint64_t block, uint32_t words[4]) {
+  uint32_t c0 = static_cast<uint32_t>(block), c1 = static_cast<uint32_t>(block >> 32);
+  uint32_t c2 = static_cast<uint32_t>(offset), c3 = static_cast<uint32_t>(offset >> 32);
+  uint32_t k0 = static_cast<uint32_t>(seed), k1 = static_cast<uint32_t>(seed >> 32);
+  for (int round = 0; round < 10; ++round) {
+    uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0;
+    uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+    uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+    uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+    c0 = hi1 ^ c1 ^ k0;
+    c1 = lo1;
+    c2 = hi0 ^ c3 ^ k1;
+    c3 = lo0;
+    k0 += 0x9E3779B9u;
+    k1 += 0xBB67AE85u;
+  }
+  words[0] = c0;
+  words[1] = c1;
+  words[2] = c2;
+  words[3] = c3;
+}
+
+/*! \return A float of [0, 1) from a random word. */
+TVM_PHILOX_FUNC float Uniform(uint32_t word) { return (word >> 8) * (1.0f / 16777216.0f); }
+
+/*! \return Element k of the Box-Muller transform of words[k & ~1] and words[k | 1]. */
+TVM_PHILOX_FUNC float Normal(const uint32_t words[4], int k) {
+  // Take the first uniform from (0, 1] for the log.
+  float u0 = ((words[k & ~1] >> 8) + 1) * (1.0f / 16777216.0f);
+  float u1 = Uniform(words[k | 1]);
+  float r = sqrtf(-2.0f * logf(u0));
+  float theta = 6.2831853071795864f * u1;
+  return (k & 1) ? r * sinf(theta) : r * cosf(theta);
+}
+
+/*!
+ * \return A value of [1, 10), so that the quantized dtypes (uint8 / int8) are nonzero too,
+ *  in float representation to work well on float / int types.
+ */
+TVM_PHILOX_FUNC float MeasureValue(uint32_t word) { return 1.0f + 9.0f * Uniform(word); }
+
+/*! \return A byte of two nonzero packed 4-bit values, from [17, 30). */
+TVM_PHILOX_FUNC uint8_t PackedInt4MeasureValue(uint32_t word) {
+  return static_cast<uint8_t>(17.0f + 13.0f * Uniform(word));
+}
+
+}  // namespace philox
+}  // namespace contrib
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_CONTRIB_RANDOM_PHILOX_H_
@@ -0,0 +1,155 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file random/philox_kernels.cu
+ * \brief Philox random fills on CUDA and ROCm devices, compiled by nvcc or by hipcc.
+ */
+#if defined(__HIPCC__)
+#include <hip/hip_fp16.h>
+#include <hip/hip_runtime.h>
+#define TVM_PHILOX_GPU_STREAM_T hipStream_t
+#define TVM_PHILOX_GPU_GET_LAST_ERROR hipGetLastError
+#define TVM_PHILOX_GPU_SUCCESS hipSuccess
+#define TVM_PHILOX_GPU_ERROR_STRING hipGetErrorString
+#else
+#include <cuda_fp16.h>
+#include <cuda_runtime.h>
+#define TVM_PHILOX_GPU_STREAM_T cudaStream_t
+#define TVM_PHILOX_GPU_GET_LAST_ERROR cudaGetLastError
+#define TVM_PHILOX_GPU_SUCCESS cudaSuccess
+#define TVM_PHILOX_GPU_ERROR_STRING cudaGetErrorString
+#endif
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/registry.h>
+
+#include "philox.h"
+
+namespace tvm {
+namespace contrib {
+namespace philox {
+
+using runtime::DeviceAPI;
+
+/*! \brief The value of element k of a Philox block, stored as T. */
+template <typename T>
+struct Value {
+  __device__ static T Get(Distribution dist, float a, float b, const uint32_t words[4], int k) {
+    if (dist == Distribution::kUniform) return a + (b - a) * Uniform(words[k]);
+    if (dist == Distribution::kNormal) return a + b * Normal(words, k);
+    return MeasureValue(words[k]);
+  }
+};
+
+/*! \brief The half precision values, stored as their bits. */
+template <>
+struct Value<uint16_t> {
+  __device__ static uint16_t Get(Distribution dist, float a, float b, const uint32_t words[4],
+                                 int k) {
+    return __half_as_ushort(__float2half(Value<float>::Get(dist, a, b, words, k)));
+  }
+};
+
+/*! \brief Each thread fills the four elements of a Philox block. */
+template <typename T>
+__global__ void PhiloxFillKernel(T* data, int64_t num, Distribution dist, float a, float b,
+                                 uint64_t seed, uint64_t offset) {
+  int64_t block = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  if (block * 4 >= num) return;
+  uint32_t words[4];
+  Block(seed, offset, block, words);
+  for (int k = 0; k < 4 && block * 4 + k < num; ++k) {
+    data[block * 4 + k] = Value<T>::Get(dist, a, b, words, k);
+  }
+}
+
+/*! \brief The packed int4 inputs of measurements, two per byte. */
+__global__ void PhiloxFillPackedInt4Kernel(uint8_t* data, int64_t num, uint64_t seed,
+                                           uint64_t offset) {
+  int64_t block = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  if (block * 4 >= num) return;
+  uint32_t words[4];
+  Block(seed, offset, block, words);
+  for (int k = 0; k < 4 && block * 4 + k < num; ++k) {
+    data[block * 4 + k] = PackedInt4MeasureValue(words[k]);
+  }
+}
+
+void PhiloxFill(DLTensor* tensor, int dist_code, double a, double b, int64_t seed,
+                int64_t offset) {
+  ICHECK(tensor->strides == nullptr);
+  Distribution dist = static_cast<Distribution>(dist_code);
+  DLDataType dtype = tensor->dtype;
+  int64_t num = 1;
+  for (int i = 0; i < tensor->ndim; ++i) {
+    num *= tensor->shape[i];
+  }
+  if (dist != Distribution::kMeasure) {
+    CHECK(dtype.code == kDLFloat && dtype.bits == 32 && dtype.lanes == 1)
+        << "ValueError: Only float32 tensors are sampled, but got " << dtype;
+  }
+  if (dtype.bits == 4) num = (num + 1) / 2;
+
+  DeviceAPI* api = DeviceAPI::Get(tensor->device);
+  api->SetDevice(tensor->device);
+  auto stream = static_cast<TVM_PHILOX_GPU_STREAM_T>(api->GetCurrentStream(tensor->device));
+  constexpr int kThreads = 256;
+  int64_t num_blocks = (num + 3) / 4;
+  int grid = static_cast<int>((num_blocks + kThreads - 1) / kThreads);
+  if (grid == 0) return;
+  void* data = static_cast<char*>(tensor->data) + tensor->byte_offset;
+  float fa = static_cast<float>(a), fb = static_cast<float>(b);
+  uint64_t useed = static_cast<uint64_t>(seed), uoffset = static_cast<uint64_t>(offset);
+  if (dtype.bits == 1) {
+    PhiloxFillKernel<bool><<<grid, kThreads, 0, stream>>>(static_cast<bool*>(data), num, dist, fa,
+                                                          fb, useed, uoffset);
+  } else if (dtype.bits == 4) {
+    PhiloxFillPackedInt4Kernel<<<grid, kThreads, 0, stream>>>(static_cast<uint8_t*>(data), num,
+                                                              useed, uoffset);
+  } else if (dtype.bits == 8) {
+    PhiloxFillKernel<uint8_t><<<grid, kThreads, 0, stream>>>(static_cast<uint8_t*>(data), num,
+                                                             dist, fa, fb, useed, uoffset);
+  } else if (dtype.bits == 16) {
+    PhiloxFillKernel<uint16_t><<<grid, kThreads, 0, stream>>>(static_cast<uint16_t*>(data), num,
+                                                              dist, fa, fb, useed, uoffset);
+  } else if (dtype.bits == 32) {
+    PhiloxFillKernel<float><<<grid, kThreads, 0, stream>>>(static_cast<float*>(data), num, dist,
+                                                           fa, fb, useed, uoffset);
+  } else if (dtype.bits == 64) {
+    PhiloxFillKernel<double><<<grid, kThreads, 0, stream>>>(static_cast<double*>(data), num, dist,
+                                                            fa, fb, useed, uoffset);
+  } else {
+    LOG(FATAL) << "Doesn't support dtype code " << dtype.code << " dtype bits " << dtype.bits;
+  }
+  auto err = TVM_PHILOX_GPU_GET_LAST_ERROR();
+  ICHECK(err == TVM_PHILOX_GPU_SUCCESS)
+      << "PhiloxFill: kernel launch failed: " << TVM_PHILOX_GPU_ERROR_STRING(err);
+}
+
+#if defined(__HIPCC__)
+TVM_REGISTER_GLOBAL("tvm.contrib.random.philox_fill.rocm").set_body_typed(PhiloxFill);
+#else
+TVM_REGISTER_GLOBAL("tvm.contrib.random.philox_fill.cuda").set_body_typed(PhiloxFill);
+#endif
+
+}  // namespace philox
+}  // namespace contrib
+}  // namespace tvm
@@ -69,6 +69,10 @@ RandomThreadLocalEntry* RandomThreadLocalEntry::ThreadLocal() {
   return RandomThreadLocalStore::Get();
 }
 
+TVM_REGISTER_GLOBAL("tvm.contrib.random.seed").set_body_typed([](int64_t seed) {
+  RandomThreadLocalEntry::ThreadLocal()->random_engine.Seed(static_cast<unsigned>(seed));
+});
+
 TVM_REGISTER_GLOBAL("tvm.contrib.random.randint").set_body([](TVMArgs args, TVMRetValue* ret) {
   RandomThreadLocalEntry* entry = RandomThreadLocalEntry::ThreadLocal();
   int64_t low = args[0];
@@ -128,7 +132,9 @@ TVM_REGISTER_GLOBAL("tvm.contrib.random.random_fill_for_measure")
     .set_body([](TVMArgs args, TVMRetValue* ret) -> void {
       static const PackedFunc* curand = Registry::Get("runtime.contrib.curand.RandomFill");
       DLTensor* out = args[0];
-      if (curand && out->device.device_type == DLDeviceType::kDLCUDA) {
+      // The Philox kernels of the device take precedence, which are reproducible.
+      if (curand && out->device.device_type == DLDeviceType::kDLCUDA &&
+          RandomEngine::GetDeviceFill(kDLCUDA) == nullptr) {
         if (out->dtype.code == DLDataTypeCode::kDLFloat) {
           (*curand)(out);
           return;
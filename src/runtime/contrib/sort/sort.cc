@@ -23,8 +23,12 @@
 
 #include <dlpack/dlpack.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
 #include "../../../../3rdparty/compiler-rt/builtin_fp16.h"
@@ -70,6 +74,87 @@ struct float16 {
   inline bool operator>=(const float16& rhs) const { return to_float() >= rhs.to_float(); }
 };
 
+/*!
+ * \brief Run the rows of a sort in parallel on the runtime thread pool.
+ * \param num_rows The number of independent rows.
+ * \param row_size The number of elements in each row.
+ * \param run_rows The function processing rows in [row_begin, row_end).
+ */
+template <typename F>
+void ParallelForRows(int64_t num_rows, int64_t row_size, const F& run_rows) {
+  // Only go parallel when there is enough work to amortize the thread pool launch.
+  constexpr int64_t kMinElementsPerTask = 1 << 16;
+  int64_t rows_per_task =
+      std::max<int64_t>(1, kMinElementsPerTask / std::max<int64_t>(row_size, 1));
+  int64_t num_tasks = (num_rows + rows_per_task - 1) / rows_per_task;
+  if (num_tasks <= 1) {
+    run_rows(0, num_rows);
+    return;
+  }
+  parallel_for_with_threading_backend(
+      [&](int64_t task) {
+        run_rows(task * rows_per_task, std::min(num_rows, (task + 1) * rows_per_task));
+      },
+      0, num_tasks);
+}
+
+/*! \brief Whether the keys of the type can be radix sorted. */
+template <typename DataType>
+constexpr bool kSupportsRadixSort =
+    std::is_same_v<DataType, float> || std::is_same_v<DataType, int32_t>;
+
+/*! \brief The min row size to radix sort, shorter rows use a comparison sort. */
+constexpr int64_t kRadixSortMinSize = 256;
+
+/*! \brief Map a key to an unsigned integer with the same order. */
+template <typename DataType>
+uint32_t RadixKey(DataType value);
+
+template <>
+inline uint32_t RadixKey<float>(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  // -0.0 and 0.0 compare equal and must keep their relative order.
+  if (bits == 0x80000000u) bits = 0;
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+template <>
+inline uint32_t RadixKey<int32_t>(int32_t value) {
+  return static_cast<uint32_t>(value) ^ 0x80000000u;
+}
+
+/*!
+ * \brief Stable LSD radix sort of packed (key << 32 | index) entries by their key.
+ * \param entries The entries to sort, in index order.
+ * \param scratch The scratch buffer of the same size.
+ */
+inline void RadixSortByKey(std::vector<uint64_t>* entries, std::vector<uint64_t>* scratch) {
+  size_t n = entries->size();
+  if (n == 0) return;
+  scratch->resize(n);
+  uint64_t* src = entries->data();
+  uint64_t* dst = scratch->data();
+  for (int shift = 32; shift < 64; shift += 8) {
+    size_t offsets[257] = {0};
+    for (size_t i = 0; i < n; ++i) {
+      ++offsets[((src[i] >> shift) & 0xFF) + 1];
+    }
+    // Skip the pass when all entries share the digit.
+    if (offsets[((src[0] >> shift) & 0xFF) + 1] == n) continue;
+    for (int b = 0; b < 256; ++b) {
+      offsets[b + 1] += offsets[b];
+    }
+    for (size_t i = 0; i < n; ++i) {
+      dst[offsets[(src[i] >> shift) & 0xFF]++] = src[i];
+    }
+    std::swap(src, dst);
+  }
+  if (src != entries->data()) {
+    std::swap(*entries, *scratch);
+  }
+}
+
 // Argsort implemented C library sort for nms.
 // Return indices of sorted tensor.
 // By default, the last axis will be used to sort.
@@ -158,7 +243,6 @@ void sort_impl(
     std::function<void(OutType*, size_t, const std::pair<int64_t, DataType>&)> epilogue) {
   auto data_ptr = static_cast<DataType*>(input->data);
   auto out_ptr = static_cast<OutType*>(output->data);
-  std::vector<std::pair<int64_t, DataType>> sorter;
 
   int axis_mul_before = 1;
   int axis_mul_after = 1;
@@ -169,12 +253,39 @@ void sort_impl(
       axis_mul_after *= input->shape[i];
     }
   }
-
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
+  int64_t axis_size = input->shape[axis];
+  bool use_radix_sort = kSupportsRadixSort<DataType> && axis_size >= kRadixSortMinSize &&
+                        axis_size <= std::numeric_limits<uint32_t>::max();
+
+  auto run_rows = [&](int64_t row_begin, int64_t row_end) {
+    // The scratch buffers of the task, reused across its rows.
+    std::vector<std::pair<int64_t, DataType>> sorter;
+    std::vector<uint64_t> entries;
+    std::vector<uint64_t> scratch;
+    for (int64_t row = row_begin; row < row_end; ++row) {
+      int64_t i = row / axis_mul_after;
+      int64_t j = row % axis_mul_after;
+      int64_t base_idx = i * axis_size * axis_mul_after + j;
+      if constexpr (kSupportsRadixSort<DataType>) {
+        if (use_radix_sort) {
+          // The index in the low bits keeps equal keys in their original order, in both
+          // directions, as the stable comparison sort does.
+          entries.resize(axis_size);
+          for (int64_t k = 0; k < axis_size; ++k) {
+            uint32_t key = RadixKey<DataType>(data_ptr[base_idx + k * axis_mul_after]);
+            entries[k] = (static_cast<uint64_t>(is_ascend ? key : ~key) << 32) | k;
+          }
+          RadixSortByKey(&entries, &scratch);
+          for (int64_t k = 0; k < axis_size; ++k) {
+            int64_t index = static_cast<int64_t>(entries[k] & 0xFFFFFFFFu);
+            epilogue(out_ptr, base_idx + k * axis_mul_after,
+                     std::make_pair(index, data_ptr[base_idx + index * axis_mul_after]));
+          }
+          continue;
+        }
+      }
       sorter.clear();
-      int64_t base_idx = i * input->shape[axis] * axis_mul_after + j;
-      for (int64_t k = 0; k < input->shape[axis]; ++k) {
+      for (int64_t k = 0; k < axis_size; ++k) {
         int64_t full_idx = base_idx + k * axis_mul_after;
         sorter.emplace_back(std::make_pair(k, data_ptr[full_idx]));
       }
@@ -183,11 +294,12 @@ void sort_impl(
       } else {
         std::stable_sort(sorter.begin(), sorter.end(), CompareDescend<DataType>);
       }
-      for (int64_t k = 0; k < input->shape[axis]; ++k) {
+      for (int64_t k = 0; k < axis_size; ++k) {
         epilogue(out_ptr, base_idx + k * axis_mul_after, sorter[k]);
       }
     }
-  }
+  };
+  ParallelForRows(static_cast<int64_t>(axis_mul_before) * axis_mul_after, axis_size, run_rows);
 }
 
 template <typename DataType, typename OutType>
@@ -346,6 +458,66 @@ TVM_REGISTER_GLOBAL("tvm.contrib.sort.sort").set_body([](TVMArgs args, TVMRetVal
   }
 });
 
+/*!
+ * \brief Select the top-k elements of one row with a running heap.
+ * \param row The first element of the row.
+ * \param stride The distance between consecutive elements of the row.
+ * \param n The number of elements in the row.
+ * \param k The number of elements to select.
+ * \param running_heap The buffer of the heap, holding the sorted result on return.
+ */
+template <typename DataType, bool is_ascend>
+void TopkRow(const DataType* row, int64_t stride, int64_t n, int k,
+             std::vector<std::pair<int64_t, DataType>>* running_heap) {
+  auto fcmp = is_ascend ? CompareAscend<DataType, true> : CompareDescend<DataType, true>;
+  running_heap->clear();
+
+  // Start by creating min/max heap with fixed-k elements
+  int64_t cur_axis_index = 0;
+  for (; cur_axis_index < k && cur_axis_index < n; cur_axis_index++) {
+    running_heap->emplace_back(std::make_pair(cur_axis_index, row[cur_axis_index * stride]));
+  }
+  std::make_heap(running_heap->begin(), running_heap->end(), fcmp);
+
+  // An element only enters the heap if it is strictly better than the top of the
+  // heap: on ties, the top always has the smaller index.
+  auto is_better = [](const DataType& value, const DataType& threshold) {
+    return is_ascend ? value < threshold : value > threshold;
+  };
+  auto push = [&](int64_t index) {
+    std::pair<int64_t, DataType> cur_val = {index, row[index * stride]};
+    if (!is_better(cur_val.second, (*running_heap)[0].second)) return;
+    running_heap->push_back(cur_val);
+    std::push_heap(running_heap->begin(), running_heap->end(), fcmp);
+    std::pop_heap(running_heap->begin(), running_heap->end(), fcmp);
+    running_heap->pop_back();
+  };
+
+  if (stride == 1 && !running_heap->empty()) {
+    // Most blocks of a long row have no element better than the current k-th one.
+    // Check a whole block against the threshold first, in a loop the compiler vectorizes.
+    constexpr int64_t kBlockSize = 16;
+    for (; cur_axis_index + kBlockSize <= n; cur_axis_index += kBlockSize) {
+      DataType threshold = (*running_heap)[0].second;
+      bool any_better = false;
+      for (int64_t b = 0; b < kBlockSize; ++b) {
+        any_better |= is_better(row[cur_axis_index + b], threshold);
+      }
+      if (!any_better) continue;
+      for (int64_t b = 0; b < kBlockSize; ++b) {
+        push(cur_axis_index + b);
+      }
+    }
+  }
+  // Iterate through all elements, adding to heap along the way
+  for (; cur_axis_index < n; cur_axis_index++) {
+    push(cur_axis_index);
+  }
+
+  // finally sort heap and deliver results
+  std::sort_heap(running_heap->begin(), running_heap->end(), fcmp);
+}
+
 template <typename DataType, typename IndicesType>
 void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, int axis,
           bool is_ascend) {
@@ -355,12 +527,6 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
   IndicesType* indices_ptr =
       (out_indices == nullptr) ? nullptr : static_cast<IndicesType*>(out_indices->data);
 
-  // Maintain a min/max containing the top-k elements
-  std::vector<std::pair<int64_t, DataType>> running_heap;
-
-  // Need +1 when inserting new element before maintaining heap invariant
-  running_heap.reserve(k + 1);
-
   int axis_mul_before = 1;
   int axis_mul_after = 1;
   for (int i = 0; i < input->ndim; ++i) {
@@ -373,51 +539,26 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
   if (k < 1) {
     k = input->shape[axis];
   }
-
-  for (int i = 0; i < axis_mul_before; ++i) {
-    for (int j = 0; j < axis_mul_after; ++j) {
-      running_heap.clear();
-      int64_t src_base_idx = i * input->shape[axis] * axis_mul_after + j;
+  int64_t axis_size = input->shape[axis];
+
+  // Rows are independent, each task keeps its own heap.
+  auto run_rows = [&](int64_t row_begin, int64_t row_end) {
+    // Maintain a min/max containing the top-k elements
+    std::vector<std::pair<int64_t, DataType>> running_heap;
+    // Need +1 when inserting new element before maintaining heap invariant
+    running_heap.reserve(std::min<int64_t>(k, axis_size) + 1);
+    for (int64_t row = row_begin; row < row_end; ++row) {
+      int64_t i = row / axis_mul_after;
+      int64_t j = row % axis_mul_after;
+      int64_t src_base_idx = i * axis_size * axis_mul_after + j;
       int64_t dst_base_idx = i * k * axis_mul_after + j;
-
-      // Start by creating min/max heap with fixed-k elements
-      int cur_axis_index = 0;
-      for (; cur_axis_index < k && cur_axis_index < input->shape[axis]; cur_axis_index++) {
-        int64_t full_idx = src_base_idx + cur_axis_index * axis_mul_after;
-        running_heap.emplace_back(std::make_pair(cur_axis_index, data_ptr[full_idx]));
-      }
-      if (!is_ascend) {
-        std::make_heap(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
-      } else {
-        std::make_heap(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
-      }
-
-      // Iterate through all elements, adding to heap along the way
-      for (; cur_axis_index < input->shape[axis]; cur_axis_index++) {
-        int64_t full_idx = src_base_idx + cur_axis_index * axis_mul_after;
-        std::pair<int64_t, DataType> cur_val = {cur_axis_index, data_ptr[full_idx]};
-
-        // Eq. to cur_val.second > running_heap.second
-        if (!is_ascend && CompareDescend<DataType, true>(cur_val, running_heap[0])) {
-          running_heap.push_back(cur_val);
-          std::push_heap(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
-          std::pop_heap(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
-          running_heap.pop_back();
-        } else if (is_ascend && CompareAscend<DataType, true>(cur_val, running_heap[0])) {
-          running_heap.push_back(cur_val);
-          std::push_heap(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
-          std::pop_heap(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
-          running_heap.pop_back();
-        }
-      }
-
-      // finally sort heap and deliver results
       if (is_ascend) {
-        std::stable_sort(running_heap.begin(), running_heap.end(), CompareAscend<DataType, true>);
+        TopkRow<DataType, true>(data_ptr + src_base_idx, axis_mul_after, axis_size, k,
+                                &running_heap);
       } else {
-        std::stable_sort(running_heap.begin(), running_heap.end(), CompareDescend<DataType, true>);
+        TopkRow<DataType, false>(data_ptr + src_base_idx, axis_mul_after, axis_size, k,
+                                 &running_heap);
       }
-
       for (uint32_t kk = 0; kk < running_heap.size(); ++kk) {
         if (indices_ptr != nullptr) {
           indices_ptr[dst_base_idx + kk * axis_mul_after] =
@@ -429,7 +570,9 @@ void topk(DLTensor* input, DLTensor* out_values, DLTensor* out_indices, int k, i
         }
       }
     }
-  }
+  };
+
+  ParallelForRows(static_cast<int64_t>(axis_mul_before) * axis_mul_after, axis_size, run_rows);
 }
 
 // Argsort implemented C library sort.
@@ -165,6 +165,17 @@ void TensorRTBuilder::AddLayer(int nid, const JSONGraphNode& node) {
   }
 }
 
+void TensorRTBuilder::SetBatchProfile(int min_batch, int opt_batch, int max_batch) {
+  ICHECK(0 < min_batch && min_batch <= opt_batch && opt_batch <= max_batch)
+      << "ValueError: The batch profile must satisfy 0 < min <= opt <= max, but got " << min_batch
+      << ", " << opt_batch << ", " << max_batch;
+  batch_profile_ = {min_batch, opt_batch, max_batch};
+  batch_size_ = max_batch;
+  if (use_implicit_batch_) {
+    builder_->setMaxBatchSize(batch_size_);
+  }
+}
+
 TensorRTEngineAndContext TensorRTBuilder::BuildEngine() {
   // Process graph to create INetworkDefinition.
 // Build engine.
@@ -187,6 +198,22 @@ TensorRTEngineAndContext TensorRTBuilder::BuildEngine() {
     auto profile = builder_->createOptimizationProfile();
     for (int i = 0; i < network_->getNbInputs(); ++i) {
       auto name = network_->getInput(i)->getName();
+      if (!batch_profile_.empty()) {
+        nvinfer1::Dims dims = network_->getInput(i)->getDimensions();
+        for (int j = 1; j < dims.nbDims; ++j) {
+          ICHECK_NE(dims.d[j], -1) << "ValueError: Only the batch dimension of input " << name
+                                   << " can be dynamic with a declared batch profile";
+        }
+        const nvinfer1::OptProfileSelector selectors[] = {nvinfer1::OptProfileSelector::kMIN,
+                                                          nvinfer1::OptProfileSelector::kOPT,
+                                                          nvinfer1::OptProfileSelector::kMAX};
+        bool dynamic_batch = dims.nbDims >= 1 && dims.d[0] == -1;
+        for (int k = 0; k < 3; ++k) {
+          if (dynamic_batch) dims.d[0] = batch_profile_[k];
+          profile->setDimensions(name, selectors[k], dims);
+        }
+        continue;
+      }
       const uint32_t entry_id = entry_id_map_[name];
       std::vector<int64_t> shape(data_entry_[entry_id]->shape,
                                  data_entry_[entry_id]->shape + data_entry_[entry_id]->ndim);
@@ -104,6 +104,17 @@ class TensorRTBuilder {
    */
   void AddOutput(const JSONGraphNodeEntry& entry, uint32_t entry_id);
 
+  /*!
+   * \brief Declare the range of batch sizes the engine serves, instead of the batch size given on
+   * construction.  In explicit batch mode, the dynamic batch dimensions of the inputs get the
+   * optimization profile min/opt/max, and the shapes of the inputs are taken from the network
+   * rather than from the data entries, so that the engine can be built before the first inference.
+   * \param min_batch The smallest batch size.
+   * \param opt_batch The batch size to optimize for.
+   * \param max_batch The largest batch size.
+   */
+  void SetBatchProfile(int min_batch, int opt_batch, int max_batch);
+
   /*!
    * \brief Takes network definition and "compiles" a TensorRT engine which can be used for
    * inference. This step is time confusing.
@@ -159,6 +170,9 @@ class TensorRTBuilder {
   /*! \brief Batch size to optimize for. */
   int batch_size_;
 
+  /*! \brief The declared min, opt and max batch sizes, empty if none. */
+  std::vector<int> batch_profile_;
+
   /*! \brief Input names. */
   std::vector<std::string> network_input_names_;
 
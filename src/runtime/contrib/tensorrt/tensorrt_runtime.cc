@@ -27,8 +27,13 @@
 #include <tvm/runtime/registry.h>
 
 #include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -37,6 +42,8 @@
 #include "../json/json_runtime.h"
 
 #ifdef TVM_GRAPH_EXECUTOR_TENSORRT
+#include <cuda_runtime_api.h>
+
 #include "NvInfer.h"
 #include "tensorrt_builder.h"
 #include "tensorrt_calibrator.h"
@@ -76,6 +83,17 @@ class TensorRTRuntime : public JSONRuntimeBase {
         use_fp16_(false) {
     const bool use_int8 = dmlc::GetEnv("TVM_TENSORRT_USE_INT8", false);
     multi_engine_mode_ = dmlc::GetEnv("TVM_TENSORRT_MULTI_ENGINE", false);
+    std::string batch_profile = dmlc::GetEnv("TVM_TENSORRT_BATCH_PROFILE", std::string(""));
+    if (!batch_profile.empty()) {
+      std::istringstream is(batch_profile);
+      for (std::string item; std::getline(is, item, ',');) {
+        batch_profile_.push_back(std::stoi(item));
+      }
+      ICHECK(batch_profile_.size() == 3 && 0 < batch_profile_[0] &&
+             batch_profile_[0] <= batch_profile_[1] && batch_profile_[1] <= batch_profile_[2])
+          << "ValueError: TVM_TENSORRT_BATCH_PROFILE must be \"min,opt,max\" with "
+          << "0 < min <= opt <= max, but got \"" << batch_profile << "\"";
+    }
     num_calibration_batches_remaining_ = dmlc::GetEnv("TENSORRT_NUM_CALI_INT8", 0);
     if (use_int8) {
       ICHECK(num_calibration_batches_remaining_ != 0)
@@ -113,7 +131,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
         << "The number of input constants must match the number of required.";
     LoadGlobalAttributes();
     SetupConstants(consts);
-    GetCachedEnginesFromDisk();
+    PrepareProfileEngine();
   }
 
   void LoadGlobalAttributes() {
@@ -140,6 +158,36 @@ class TensorRTRuntime : public JSONRuntimeBase {
   }
 
 #ifdef TVM_GRAPH_EXECUTOR_TENSORRT
+  /*!
+   * \brief With a declared batch profile, the engine of its max batch size serves all the batch
+   * sizes of the profile, so it is loaded from the disk cache, or built, before the first
+   * inference.  With TVM_TENSORRT_ASYNC_BUILD set, it is built in the background, and the first
+   * inference waits for it only if it is not ready yet.
+   */
+  void PrepareProfileEngine() {
+    const bool use_int8 = dmlc::GetEnv("TVM_TENSORRT_USE_INT8", false);
+    if (batch_profile_.empty() || use_int8) return;
+    int batch_size = batch_profile_[2];
+    max_batch_size_ = batch_size;
+    if (LoadEngineFromDisk(batch_size)) return;
+    if (dmlc::GetEnv("TVM_TENSORRT_ASYNC_BUILD", false)) {
+      pending_batch_size_ = batch_size;
+      pending_build_ = std::async(std::launch::async,
+                                  [this, batch_size]() { return BuildEngineFromJson(batch_size); });
+    } else {
+      trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] =
+          BuildEngineFromJson(batch_size);
+      CacheEngineToDisk(batch_size);
+    }
+  }
+
+  /*! \brief Wait for the engine built in the background, if any, and cache it. */
+  void WaitForPendingBuild() {
+    if (!pending_build_.valid()) return;
+    trt_engine_cache_[std::make_pair(symbol_name_, pending_batch_size_)] = pending_build_.get();
+    CacheEngineToDisk(pending_batch_size_);
+  }
+
   /*! \brief Destroy engines and contexts. */
   void DestroyEngines() {
     for (auto& it : trt_engine_cache_) {
@@ -155,6 +203,9 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
   ~TensorRTRuntime() override {
     VLOG(1) << "Destroying TensorRT runtime";
+    if (pending_build_.valid()) {
+      trt_engine_cache_[std::make_pair(symbol_name_, pending_batch_size_)] = pending_build_.get();
+    }
     DestroyEngines();
     VLOG(1) << "Destroyed TensorRT runtime";
   }
@@ -256,6 +307,16 @@ class TensorRTRuntime : public JSONRuntimeBase {
     return data_entry_[input_var_eid_[0]]->ndim == 0 ? 1 : data_entry_[input_var_eid_[0]]->shape[0];
   }
 
+  /*! \brief Get the batch size of the engine serving a batch size, the max batch size of the
+   * declared profile if it covers the batch size. */
+  int GetEngineBatchSize(int batch_size) const {
+    if (!batch_profile_.empty() && batch_profile_[0] <= batch_size &&
+        batch_size <= batch_profile_[2]) {
+      return batch_profile_[2];
+    }
+    return batch_size;
+  }
+
   /*! \brief Find an engine in the cache which we can reuse depending on the mode. If no compatible
    * engine exists, return false to indicate that a new one should be built. */
   bool FindCompatibleEngine(int batch_size, int* compatible_engine_batch_size) {
@@ -280,7 +341,8 @@ class TensorRTRuntime : public JSONRuntimeBase {
    * already built, do nothing.
    */
   TensorRTEngineAndContext& GetOrBuildEngine() {
-    int batch_size = GetBatchSize();
+    WaitForPendingBuild();
+    int batch_size = GetEngineBatchSize(GetBatchSize());
     int compatible_engine_batch_size = -1;
     bool find_engine_flag = FindCompatibleEngine(batch_size, &compatible_engine_batch_size);
     const bool use_int8 = (dmlc::GetEnv("TVM_TENSORRT_USE_INT8", 0) != 0);
@@ -297,17 +359,22 @@ class TensorRTRuntime : public JSONRuntimeBase {
       DestroyEngines();
       max_batch_size_ = batch_size;
     }
+    if (!use_int8 && LoadEngineFromDisk(batch_size)) {
+      return trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
+    }
     DLOG(INFO) << "Building new TensorRT engine for subgraph " << symbol_name_
                << " with batch size " << batch_size;
 
     // Build engine.
     if (calibrator_ != nullptr && num_calibration_batches_remaining_ == 0) {
       // Calibration complete and build int8 engine
-      BuildEngineFromJson(batch_size);
+      trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] =
+          BuildEngineFromJson(batch_size);
       calibrator_.reset(nullptr);
     } else {
       // Build new engine
-      BuildEngineFromJson(batch_size);
+      trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] =
+          BuildEngineFromJson(batch_size);
       TensorRTEngineAndContext& engine_and_context =
           trt_engine_cache_[std::make_pair(symbol_name_, batch_size)];
       if (use_int8) {
@@ -317,14 +384,18 @@ class TensorRTRuntime : public JSONRuntimeBase {
 
     VLOG(1) << "Finished building TensorRT engine for subgraph " << symbol_name_
             << " with batch size " << batch_size;
-    CacheEngineToDisk();
+    CacheEngineToDisk(batch_size);
     return trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
   }
 
-  void BuildEngineFromJson(int batch_size) {
+  /*! \brief Build an engine for a batch size, the one of the declared profile if it is its max. */
+  TensorRTEngineAndContext BuildEngineFromJson(int batch_size) {
     const bool use_fp16 = dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) || use_fp16_;
     TensorRTBuilder builder(&logger_, data_entry_, max_workspace_size_, use_implicit_batch_,
                             use_fp16, batch_size, calibrator_.get());
+    if (!batch_profile_.empty() && batch_size == batch_profile_[2]) {
+      builder.SetBatchProfile(batch_profile_[0], batch_profile_[1], batch_profile_[2]);
+    }
     for (size_t i = 0; i < input_nodes_.size(); ++i) {
       auto nid = input_nodes_[i];
       const auto& node = nodes_[nid];
@@ -350,18 +421,17 @@ class TensorRTRuntime : public JSONRuntimeBase {
       builder.AddOutput(outputs_[i], EntryID(outputs_[i]));
     }
 
-    TensorRTEngineAndContext engine_and_context = builder.BuildEngine();
-    trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = engine_and_context;
+    return builder.BuildEngine();
   }
 
-  /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will check that directory for
-   * already built TRT engines and load into trt_engine_cache_ so they don't
-   * have to be built at first inference.
+  /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will check that directory for an
+   * already built TRT engine of a batch size and load it into trt_engine_cache_, so that it
+   * does not have to be built at inference.
    */
-  bool GetCachedEnginesFromDisk() {
+  bool LoadEngineFromDisk(int batch_size) {
     std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
     if (cache_dir.empty()) return false;
-    std::string key = GetSubgraphKey();
+    std::string key = GetSubgraphKey(batch_size);
     std::string path = cache_dir + "/" + key + ".plan";
     // Check if engine is in the cache.
     std::ifstream infile(path, std::ios::binary);
@@ -375,6 +445,11 @@ class TensorRTRuntime : public JSONRuntimeBase {
     TensorRTEngineAndContext engine_and_context;
     engine_and_context.engine =
         runtime->deserializeCudaEngine(&serialized_engine[0], serialized_engine.size(), nullptr);
+    if (engine_and_context.engine == nullptr) {
+      LOG(WARNING) << "Failed to deserialize the cached TensorRT engine " << path
+                   << ", it will be rebuilt";
+      return false;
+    }
     engine_and_context.context = engine_and_context.engine->createExecutionContext();
     // Load metadata
     std::string meta_path = cache_dir + "/" + key + ".meta";
@@ -383,30 +458,30 @@ class TensorRTRuntime : public JSONRuntimeBase {
     std::istringstream is(serialized_meta);
     dmlc::JSONReader reader(&is);
     dmlc::JSONObjectReadHelper helper;
-    int batch_size;
+    int cached_batch_size;
     helper.DeclareField("inputs", &engine_and_context.inputs);
     helper.DeclareField("outputs", &engine_and_context.outputs);
-    helper.DeclareField("batch_size", &batch_size);
+    helper.DeclareField("batch_size", &cached_batch_size);
     helper.ReadAllFields(&reader);
+    ICHECK_EQ(cached_batch_size, batch_size);
     trt_engine_cache_[std::make_pair(symbol_name_, batch_size)] = engine_and_context;
-    max_batch_size_ = batch_size;
     LOG(INFO) << "finished loading engine and context ... ";
     return true;
   }
 
-  /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will save the engine to that
+  /*! \brief If TVM_TENSORRT_CACHE_DIR is set, will save the engine of a batch size to that
    * directory so it can be loaded later.
    */
-  void CacheEngineToDisk() {
-    int batch_size = GetBatchSize();
+  void CacheEngineToDisk(int batch_size) {
     std::string cache_dir = dmlc::GetEnv("TVM_TENSORRT_CACHE_DIR", std::string(""));
     if (cache_dir.empty()) return;
-    std::string key = GetSubgraphKey();
+    std::string key = GetSubgraphKey(batch_size);
     std::string path = cache_dir + "/" + key + ".plan";
     DLOG(INFO) << "Caching TensorRT engine to " << path;
+    const TensorRTEngineAndContext& engine_and_context =
+        trt_engine_cache_.at(std::make_pair(symbol_name_, batch_size));
     // Serialize engine to disk
-    nvinfer1::IHostMemory* serialized_engine =
-        trt_engine_cache_[std::make_pair(symbol_name_, batch_size)].engine->serialize();
+    nvinfer1::IHostMemory* serialized_engine = engine_and_context.engine->serialize();
     SaveBinaryToFile(path, std::string(static_cast<const char*>(serialized_engine->data()),
                                        serialized_engine->size()));
     serialized_engine->destroy();
@@ -414,21 +489,45 @@ class TensorRTRuntime : public JSONRuntimeBase {
     std::ostringstream os;
     dmlc::JSONWriter writer(&os);
     writer.BeginObject();
-    writer.WriteObjectKeyValue("inputs",
-                               trt_engine_cache_[std::make_pair(symbol_name_, batch_size)].inputs);
-    writer.WriteObjectKeyValue("outputs",
-                               trt_engine_cache_[std::make_pair(symbol_name_, batch_size)].outputs);
+    writer.WriteObjectKeyValue("inputs", engine_and_context.inputs);
+    writer.WriteObjectKeyValue("outputs", engine_and_context.outputs);
     writer.WriteObjectKeyValue("batch_size", batch_size);
     writer.EndObject();
     std::string meta_path = cache_dir + "/" + key + ".meta";
     SaveBinaryToFile(meta_path, os.str());
   }
 
-  std::string GetSubgraphKey() {
-    // Using this key will only allow a single model per TVM_TENSORRT_CACHE_DIR directory. We could
-    // instead use a hash of graph_json and all weights to allow many models in the same directory,
-    // but the cost of computing the hash is high.
-    return symbol_name_ + (dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) ? "_fp16" : "_fp32");
+  /*!
+   * \brief Get the key of the engine of a batch size in TVM_TENSORRT_CACHE_DIR.  The key hashes
+   * the graph and the constants of the subgraph, so that several models can share a directory,
+   * and names the TensorRT version, the GPU, the precision and the batch profile, so that the
+   * engines are not loaded where they were not built for.
+   */
+  std::string GetSubgraphKey(int batch_size) {
+    if (subgraph_hash_.empty()) {
+      size_t hash = std::hash<std::string>()(graph_json_);
+      for (uint32_t nid : const_idx_) {
+        const DLTensor* data = data_entry_[EntryID(nid, 0)];
+        std::string_view bytes(static_cast<const char*>(data->data), GetDataSize(*data));
+        hash ^= std::hash<std::string_view>()(bytes) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      }
+      std::ostringstream os;
+      os << std::hex << std::setw(16) << std::setfill('0') << hash;
+      subgraph_hash_ = os.str();
+    }
+    int device_id = 0;
+    cudaDeviceProp prop;
+    CUDA_CALL(cudaGetDevice(&device_id));
+    CUDA_CALL(cudaGetDeviceProperties(&prop, device_id));
+    std::ostringstream os;
+    os << symbol_name_ << "_" << subgraph_hash_ << "_trt" << NV_TENSORRT_MAJOR << "."
+       << NV_TENSORRT_MINOR << "." << NV_TENSORRT_PATCH << "_sm" << prop.major << prop.minor
+       << (dmlc::GetEnv("TVM_TENSORRT_USE_FP16", false) || use_fp16_ ? "_fp16" : "_fp32") << "_b"
+       << batch_size;
+    if (!batch_profile_.empty() && batch_size == batch_profile_[2]) {
+      os << "_min" << batch_profile_[0] << "_opt" << batch_profile_[1];
+    }
+    return os.str();
   }
 
   /*! \brief Retreive a GPU buffer for input or output or allocate if needed. */
@@ -468,6 +567,13 @@ class TensorRTRuntime : public JSONRuntimeBase {
   std::unordered_map<std::pair<std::string, int>, TensorRTEngineAndContext, PairHash>
       trt_engine_cache_;
 
+  /*! \brief The engine built in the background for the declared batch profile, if any. */
+  std::future<TensorRTEngineAndContext> pending_build_;
+  int pending_batch_size_{-1};
+
+  /*! \brief The hash of the graph and the constants, computed once. */
+  std::string subgraph_hash_;
+
   /*! \brief Calibrator for INT8 mode. */
   std::unique_ptr<TensorRTCalibrator> calibrator_;
 
@@ -491,9 +597,7 @@ class TensorRTRuntime : public JSONRuntimeBase {
                  << "Please build with USE_TENSORRT_RUNTIME.";
   }
 
-  bool GetCachedEnginesFromDisk() { return false; }
-
-  void CacheEngineToDisk() {}
+  void PrepareProfileEngine() {}
 #endif  // TVM_GRAPH_EXECUTOR_TENSORRT
 
   bool use_implicit_batch_;
@@ -514,6 +618,10 @@ class TensorRTRuntime : public JSONRuntimeBase {
    * and more time spent building engines. */
   bool multi_engine_mode_;
 
+  /*! \brief The min, opt and max batch sizes from TVM_TENSORRT_BATCH_PROFILE, empty if not set.
+   * A single engine, built for the max batch size, serves all the batch sizes of the profile. */
+  std::vector<int> batch_profile_;
+
   /*! \brief Use auto-conversion to fp16 */
   bool use_fp16_;
 };
@@ -35,7 +35,9 @@
 
 #include <algorithm>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "../../cuda/cuda_common.h"
@@ -251,6 +253,237 @@ TVM_REGISTER_GLOBAL("tvm.contrib.thrust.sort").set_body([](TVMArgs args, TVMRetV
                      workspace);
 });
 
+/*! \brief The threads of a block of the radix top-k, which selects from one segment. */
+constexpr int kRadixTopKThreads = 256;
+/*! \brief The largest k of the radix top-k, whose candidates are kept in shared memory. */
+constexpr int kRadixTopKMaxK = 1024;
+/*! \brief The bits of the key resolved by each pass of the radix select. */
+constexpr int kRadixTopKBits = 8;
+
+/*! \brief Map a value to an unsigned key with the same order. */
+template <typename T>
+struct RadixTopKKey;
+
+template <>
+struct RadixTopKKey<half> {
+  using Type = uint16_t;
+  __device__ static Type Encode(half v) {
+    Type u = __half_as_ushort(v);
+    return (u & 0x8000u) ? static_cast<Type>(~u) : static_cast<Type>(u | 0x8000u);
+  }
+};
+
+template <>
+struct RadixTopKKey<float> {
+  using Type = uint32_t;
+  __device__ static Type Encode(float v) {
+    Type u = __float_as_uint(v);
+    return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+  }
+};
+
+template <>
+struct RadixTopKKey<double> {
+  using Type = uint64_t;
+  __device__ static Type Encode(double v) {
+    Type u = static_cast<Type>(__double_as_longlong(v));
+    return (u & 0x8000000000000000ull) ? ~u : (u | 0x8000000000000000ull);
+  }
+};
+
+template <>
+struct RadixTopKKey<int32_t> {
+  using Type = uint32_t;
+  __device__ static Type Encode(int32_t v) { return static_cast<Type>(v) ^ 0x80000000u; }
+};
+
+template <>
+struct RadixTopKKey<int64_t> {
+  using Type = uint64_t;
+  __device__ static Type Encode(int64_t v) {
+    return static_cast<Type>(v) ^ 0x8000000000000000ull;
+  }
+};
+
+template <typename KeyType>
+__host__ __device__ size_t RadixTopKSharedBytes(int k) {
+  // The candidate keys, padded so that the candidate indices after them are aligned.
+  size_t key_bytes = (k * sizeof(KeyType) + sizeof(int64_t) - 1) / sizeof(int64_t);
+  return key_bytes * sizeof(int64_t) + k * sizeof(int);
+}
+
+/*!
+ * \brief Select the top k of each segment of n values, with one block per segment.
+ *
+ * The k-th largest key is found by a radix select over the digits of the keys from the most
+ * significant one, each pass building the histogram of the digit among the keys matching the
+ * digits already resolved.  The keys above it, and the first keys equal to it, are then gathered
+ * in the order of their indices, and ranked against each other to be written out in sorted order.
+ * The segment is read once per digit and once to gather, instead of being fully sorted.
+ */
+template <typename DataType, typename IndicesType>
+__global__ void RadixTopKKernel(const DataType* data, DataType* values_out,
+                                IndicesType* indices_out, int n, int k, bool is_ascend) {
+  using KeyType = typename RadixTopKKey<DataType>::Type;
+  constexpr int kKeyBits = sizeof(KeyType) * 8;
+  constexpr int kRadixSize = 1 << kRadixTopKBits;
+
+  __shared__ int hist[kRadixSize];
+  __shared__ int scan[kRadixTopKThreads];
+  __shared__ int selected_digit;
+  __shared__ int selected_remaining;
+  extern __shared__ int64_t candidates[];
+  KeyType* cand_keys = reinterpret_cast<KeyType*>(candidates);
+  int* cand_indices = reinterpret_cast<int*>(reinterpret_cast<char*>(candidates) +
+                                             RadixTopKSharedBytes<KeyType>(k) - k * sizeof(int));
+
+  const DataType* segment = data + static_cast<int64_t>(blockIdx.x) * n;
+  auto get_key = [&](int i) {
+    KeyType key = RadixTopKKey<DataType>::Encode(segment[i]);
+    return is_ascend ? static_cast<KeyType>(~key) : key;
+  };
+
+  // Find the k-th largest key, and how many of the keys equal to it are in the top k.
+  KeyType prefix = 0;
+  KeyType mask = 0;
+  int remaining = k;
+  for (int shift = kKeyBits - kRadixTopKBits; shift >= 0; shift -= kRadixTopKBits) {
+    for (int i = threadIdx.x; i < kRadixSize; i += blockDim.x) {
+      hist[i] = 0;
+    }
+    __syncthreads();
+    for (int i = threadIdx.x; i < n; i += blockDim.x) {
+      KeyType key = get_key(i);
+      if ((key & mask) == prefix) {
+        atomicAdd(&hist[(key >> shift) & (kRadixSize - 1)], 1);
+      }
+    }
+    __syncthreads();
+    if (threadIdx.x == 0) {
+      int count = 0;
+      int digit = kRadixSize - 1;
+      for (; digit > 0 && count + hist[digit] < remaining; --digit) {
+        count += hist[digit];
+      }
+      selected_digit = digit;
+      selected_remaining = remaining - count;
+    }
+    __syncthreads();
+    prefix |= static_cast<KeyType>(selected_digit) << shift;
+    mask |= static_cast<KeyType>(kRadixSize - 1) << shift;
+    remaining = selected_remaining;
+  }
+
+  // Gather the candidates in the order of their indices.  The counts of the keys above the
+  // threshold and equal to it are scanned together, in the low and the high 16 bits.
+  int num_greater = 0;
+  int num_equal = 0;
+  for (int base = 0; base < n && num_greater + min(num_equal, remaining) < k;
+       base += blockDim.x) {
+    int i = base + threadIdx.x;
+    KeyType key = 0;
+    int flags = 0;
+    if (i < n) {
+      key = get_key(i);
+      flags = key > prefix ? 1 : (key == prefix ? (1 << 16) : 0);
+    }
+    scan[threadIdx.x] = flags;
+    __syncthreads();
+    for (int offset = 1; offset < blockDim.x; offset <<= 1) {
+      int v = threadIdx.x >= offset ? scan[threadIdx.x - offset] : 0;
+      __syncthreads();
+      scan[threadIdx.x] += v;
+      __syncthreads();
+    }
+    int exclusive = scan[threadIdx.x] - flags;
+    int total = scan[blockDim.x - 1];
+    int greater_before = num_greater + (exclusive & 0xffff);
+    int equal_before = num_equal + (exclusive >> 16);
+    if ((flags & 0xffff) || (flags && equal_before < remaining)) {
+      int pos = greater_before + min(equal_before, remaining);
+      cand_keys[pos] = key;
+      cand_indices[pos] = i;
+    }
+    num_greater += total & 0xffff;
+    num_equal += total >> 16;
+    __syncthreads();
+  }
+
+  // Rank the candidates, with the ties in the order of their indices.
+  IndicesType* segment_indices_out = indices_out + static_cast<int64_t>(blockIdx.x) * k;
+  DataType* segment_values_out = values_out + static_cast<int64_t>(blockIdx.x) * k;
+  for (int c = threadIdx.x; c < k; c += blockDim.x) {
+    KeyType key = cand_keys[c];
+    int rank = 0;
+    for (int j = 0; j < k; ++j) {
+      KeyType other = cand_keys[j];
+      rank += (other > key || (other == key && j < c)) ? 1 : 0;
+    }
+    segment_values_out[rank] = segment[cand_indices[c]];
+    segment_indices_out[rank] = static_cast<IndicesType>(cand_indices[c]);
+  }
+}
+
+template <typename DataType, typename IndicesType>
+void radix_topk(DLTensor* input, DLTensor* values_out, DLTensor* indices_out, int k,
+                bool is_ascend) {
+  using KeyType = typename RadixTopKKey<DataType>::Type;
+  int64_t n = input->shape[input->ndim - 1];
+  int64_t num_segments = 1;
+  for (int i = 0; i < input->ndim - 1; ++i) {
+    num_segments *= input->shape[i];
+  }
+  ICHECK_LE(n, std::numeric_limits<int>::max()) << "radix_topk: the sorted axis is too long";
+  ICHECK_LE(num_segments, std::numeric_limits<int>::max()) << "radix_topk: too many segments";
+  ICHECK(k > 0 && k <= kRadixTopKMaxK && k <= n)
+      << "ValueError: radix_topk requires 0 < k <= min(" << kRadixTopKMaxK
+      << ", axis length), but got k = " << k << " for an axis of " << n;
+  if (num_segments == 0) return;
+  size_t shared_bytes = RadixTopKSharedBytes<KeyType>(k);
+  RadixTopKKernel<DataType, IndicesType>
+      <<<static_cast<int>(num_segments), kRadixTopKThreads, shared_bytes, GetCUDAStream()>>>(
+          static_cast<const DataType*>(input->data), static_cast<DataType*>(values_out->data),
+          static_cast<IndicesType*>(indices_out->data), static_cast<int>(n), k, is_ascend);
+  CUDA_CALL(cudaGetLastError());
+}
+
+template <typename DataType>
+void radix_topk_common(DLTensor* input, DLTensor* values_out, DLTensor* indices_out, int k,
+                       bool is_ascend, const std::string& out_dtype) {
+  if (out_dtype == "int32") {
+    radix_topk<DataType, int32_t>(input, values_out, indices_out, k, is_ascend);
+  } else if (out_dtype == "int64") {
+    radix_topk<DataType, int64_t>(input, values_out, indices_out, k, is_ascend);
+  } else {
+    LOG(FATAL) << "Unsupported output dtype: " << out_dtype;
+  }
+}
+
+TVM_REGISTER_GLOBAL("tvm.contrib.thrust.radix_topk").set_body([](TVMArgs args, TVMRetValue* ret) {
+  ICHECK_EQ(args.num_args, 5);
+  DLTensor* input = args[0];
+  DLTensor* values_out = args[1];
+  DLTensor* indices_out = args[2];
+  int k = args[3];
+  bool is_ascend = args[4];
+
+  auto data_dtype = DLDataType2String(input->dtype);
+  auto out_dtype = DLDataType2String(indices_out->dtype);
+  if (data_dtype == "float16") {
+    radix_topk_common<half>(input, values_out, indices_out, k, is_ascend, out_dtype);
+  } else if (data_dtype == "float32") {
+    radix_topk_common<float>(input, values_out, indices_out, k, is_ascend, out_dtype);
+  } else if (data_dtype == "float64") {
+    radix_topk_common<double>(input, values_out, indices_out, k, is_ascend, out_dtype);
+  } else if (data_dtype == "int32") {
+    radix_topk_common<int32_t>(input, values_out, indices_out, k, is_ascend, out_dtype);
+  } else if (data_dtype == "int64") {
+    radix_topk_common<int64_t>(input, values_out, indices_out, k, is_ascend, out_dtype);
+  } else {
+    LOG(FATAL) << "Unsupported input dtype: " << data_dtype;
+  }
+});
+
 template <typename KeyType, typename ValueType>
 void thrust_stable_sort_by_key(DLTensor* keys_in, DLTensor* values_in, DLTensor* keys_out,
                                DLTensor* values_out, bool for_scatter,
@@ -21,6 +21,8 @@
  * \file cpu_device_api.cc
  */
 #include <dmlc/thread_local.h>
+#include <tvm/runtime/container/boxed_primitive.h>
+#include <tvm/runtime/container/map.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/registry.h>
@@ -90,8 +92,9 @@ class CPUDeviceAPI final : public DeviceAPI {
   }
 };
 
+// The pool is thread local, so that it can bump the workspaces of each thread from an arena.
 struct CPUWorkspacePool : public WorkspacePool {
-  CPUWorkspacePool() : WorkspacePool(kDLCPU, CPUDeviceAPI::Global()) {}
+  CPUWorkspacePool() : WorkspacePool(kDLCPU, CPUDeviceAPI::Global(), /*use_arena=*/true) {}
 };
 
 void* CPUDeviceAPI::AllocWorkspace(Device dev, size_t size, DLDataType type_hint) {
@@ -102,6 +105,16 @@ void CPUDeviceAPI::FreeWorkspace(Device dev, void* data) {
   dmlc::ThreadLocalStore<CPUWorkspacePool>::Get()->FreeWorkspace(dev, data);
 }
 
+TVM_REGISTER_GLOBAL("runtime.cpu_workspace_stats").set_body_typed([]() {
+  const WorkspacePool::Stats& stats = dmlc::ThreadLocalStore<CPUWorkspacePool>::Get()->stats();
+  Map<String, ObjectRef> ret;
+  ret.Set("arena_allocs", Int(static_cast<int64_t>(stats.arena_allocs)));
+  ret.Set("pool_allocs", Int(static_cast<int64_t>(stats.pool_allocs)));
+  ret.Set("deferred_frees", Int(static_cast<int64_t>(stats.deferred_frees)));
+  ret.Set("arena_chunks", Int(static_cast<int64_t>(stats.arena_chunks)));
+  return ret;
+});
+
 TVM_REGISTER_GLOBAL("device_api.cpu").set_body([](TVMArgs args, TVMRetValue* rv) {
   DeviceAPI* ptr = CPUDeviceAPI::Global();
   *rv = static_cast<void*>(ptr);
@@ -25,10 +25,16 @@
 #include <cuda_runtime.h>
 #include <dmlc/thread_local.h>
 #include <tvm/runtime/device_api.h>
+#include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 
 #include <cstring>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "cuda_common.h"
 
@@ -148,23 +154,7 @@ class CUDADeviceAPI final : public DeviceAPI {
   }
 
   void FreeDataSpace(Device dev, void* ptr) final {
-    if (std::uncaught_exceptions() && cudaPeekAtLastError() == cudaErrorIllegalAddress) {
-      // For most CUDA calls, an error from an API call will be
-      // immediately reported, and raised as an exception.  However,
-      // errors raised from async kernel execution leave the CUDA
-      // driver in an inconsistent state.  These errors are "sticky",
-      // and are never cleared. (See [0] for more details.)
-      //
-      // If we are currently unwinding the stack due to a thrown
-      // exception, and the CUDA driver is in an unrecoverable error,
-      // do not attempt to free the CUDA allocations.  Performing any
-      // CUDA API call while in this state will throw an additional
-      // exception, causing a segfault.  In this case, it is better to
-      // allow the original error to continue propagating.
-      //
-      // [0] https://forums.developer.nvidia.com/t/cuda-errors-determine-sticky-ness/271625
-      return;
-    }
+    if (IsUnwindingFromStickyError()) return;
 
     if (dev.device_type == kDLCUDAHost) {
       VLOG(1) << "freeing host memory";
@@ -176,6 +166,51 @@ class CUDADeviceAPI final : public DeviceAPI {
     }
   }
 
+  void* AllocDataSpaceAsync(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint,
+                            TVMStreamHandle stream) final {
+#if CUDART_VERSION >= 11020
+    if (dev.device_type == kDLCUDA) {
+      ICHECK_EQ(256 % alignment, 0U) << "CUDA space is aligned at 256 bytes";
+      CUDA_CALL(cudaSetDevice(dev.device_id));
+      InitMemPool(dev.device_id);
+      void* ret;
+      CUDA_CALL(cudaMallocAsync(&ret, nbytes, static_cast<cudaStream_t>(stream)));
+      return ret;
+    }
+#endif
+    return AllocDataSpace(dev, nbytes, alignment, type_hint);
+  }
+
+  void FreeDataSpaceAsync(Device dev, void* ptr, TVMStreamHandle stream) final {
+#if CUDART_VERSION >= 11020
+    if (dev.device_type == kDLCUDA) {
+      if (IsUnwindingFromStickyError()) return;
+      CUDA_CALL(cudaSetDevice(dev.device_id));
+      CUDA_CALL(cudaFreeAsync(ptr, static_cast<cudaStream_t>(stream)));
+      return;
+    }
+#endif
+    FreeDataSpace(dev, ptr);
+  }
+
+  /*!
+   * \brief Set the bytes the memory pool of a device may keep at a stream synchronization,
+   *  instead of returning them to the driver.
+   * \param device_id The device.
+   * \param threshold The release threshold in bytes.
+   */
+  void SetMemPoolReleaseThreshold(int device_id, uint64_t threshold) {
+#if CUDART_VERSION >= 11020
+    std::lock_guard<std::mutex> lock(mem_pool_mutex_);
+    mem_pool_inited_.insert(device_id);
+    cudaMemPool_t pool;
+    CUDA_CALL(cudaDeviceGetDefaultMemPool(&pool, device_id));
+    CUDA_CALL(cudaMemPoolSetAttribute(pool, cudaMemPoolAttrReleaseThreshold, &threshold));
+#else
+    LOG(FATAL) << "Stream-ordered memory pools require CUDA 11.2 or later";
+#endif
+  }
+
  protected:
   void CopyDataFromTo(const void* from, size_t from_offset, void* to, size_t to_offset, size_t size,
                       Device dev_from, Device dev_to, DLDataType type_hint,
@@ -234,11 +269,13 @@ class CUDADeviceAPI final : public DeviceAPI {
     CUDA_CALL(cudaSetDevice(dev.device_id));
     cudaStream_t src_stream = static_cast<cudaStream_t>(event_src);
     cudaStream_t dst_stream = static_cast<cudaStream_t>(event_dst);
-    cudaEvent_t evt;
-    CUDA_CALL(cudaEventCreate(&evt));
+    if (src_stream == dst_stream) return;
+    // The wait captures the work recorded by the event at the time of the call,
+    // so the event can be reused right after it.
+    cudaEvent_t evt = AcquireEvent(dev.device_id);
     CUDA_CALL(cudaEventRecord(evt, src_stream));
     CUDA_CALL(cudaStreamWaitEvent(dst_stream, evt, 0));
-    CUDA_CALL(cudaEventDestroy(evt));
+    ReleaseEvent(dev.device_id, evt);
   }
 
   void StreamSync(Device dev, TVMStreamHandle stream) final {
@@ -272,10 +309,73 @@ class CUDADeviceAPI final : public DeviceAPI {
   }
 
  private:
+  /*!
+   * \brief Whether the stack is unwinding from an unrecoverable error of the device,
+   *  in which case the memory should not be freed.
+   */
+  static bool IsUnwindingFromStickyError() {
+    // For most CUDA calls, an error from an API call will be
+    // immediately reported, and raised as an exception.  However,
+    // errors raised from async kernel execution leave the CUDA
+    // driver in an inconsistent state.  These errors are "sticky",
+    // and are never cleared. (See [0] for more details.)
+    //
+    // If we are currently unwinding the stack due to a thrown
+    // exception, and the CUDA driver is in an unrecoverable error,
+    // do not attempt to free the CUDA allocations.  Performing any
+    // CUDA API call while in this state will throw an additional
+    // exception, causing a segfault.  In this case, it is better to
+    // allow the original error to continue propagating.
+    //
+    // [0] https://forums.developer.nvidia.com/t/cuda-errors-determine-sticky-ness/271625
+    return std::uncaught_exceptions() && cudaPeekAtLastError() == cudaErrorIllegalAddress;
+  }
+
+  /*!
+   * \brief Let the memory pool of a device keep the freed memory at the synchronizations,
+   *  unless a release threshold was set for it.
+   */
+  void InitMemPool(int device_id) {
+    {
+      std::lock_guard<std::mutex> lock(mem_pool_mutex_);
+      if (mem_pool_inited_.count(device_id)) return;
+    }
+    SetMemPoolReleaseThreshold(device_id, std::numeric_limits<uint64_t>::max());
+  }
+
+  /*! \brief Take an event of the device from the pool, or create one when the pool is empty. */
+  cudaEvent_t AcquireEvent(int device_id) {
+    {
+      std::lock_guard<std::mutex> lock(event_pool_mutex_);
+      std::vector<cudaEvent_t>& pool = event_pool_[device_id];
+      if (!pool.empty()) {
+        cudaEvent_t evt = pool.back();
+        pool.pop_back();
+        return evt;
+      }
+    }
+    cudaEvent_t evt;
+    CUDA_CALL(cudaEventCreateWithFlags(&evt, cudaEventDisableTiming));
+    return evt;
+  }
+
+  /*! \brief Return an event to the pool of the device. */
+  void ReleaseEvent(int device_id, cudaEvent_t evt) {
+    std::lock_guard<std::mutex> lock(event_pool_mutex_);
+    event_pool_[device_id].push_back(evt);
+  }
+
   static void GPUCopy(const void* from, void* to, size_t size, cudaMemcpyKind kind,
                       cudaStream_t stream) {
     CUDA_CALL(cudaMemcpyAsync(to, from, size, kind, stream));
   }
+
+  /*! \brief The devices whose memory pool is configured. */
+  std::unordered_set<int> mem_pool_inited_;
+  std::mutex mem_pool_mutex_;
+  /*! \brief The reusable events of each device, for the synchronization between streams. */
+  std::unordered_map<int, std::vector<cudaEvent_t>> event_pool_;
+  std::mutex event_pool_mutex_;
 };
 
 typedef dmlc::ThreadLocalStore<CUDAThreadEntry> CUDAThreadStore;
@@ -354,5 +454,93 @@ TVM_DLL int GetCudaDeviceCount() {
 
 TVM_REGISTER_GLOBAL("runtime.GetCudaDeviceCount").set_body_typed(GetCudaDeviceCount);
 
+TVM_REGISTER_GLOBAL("runtime.cuda.pci_bus_id").set_body_typed([](int device_id) -> String {
+  char bus_id[32];
+  CUDA_CALL(cudaDeviceGetPCIBusId(bus_id, sizeof(bus_id), device_id));
+  return String(bus_id);
+});
+
+TVM_REGISTER_GLOBAL("runtime.cuda.SetMemPoolReleaseThreshold")
+    .set_body_typed([](int device_id, int64_t threshold) {
+      CUDADeviceAPI::Global()->SetMemPoolReleaseThreshold(device_id, threshold);
+    });
+
+#if CUDA_VERSION >= 12000
+/*!
+ * \brief Encode the CUtensorMap of a tensor, tiled in boxes of box_shape, for the TMA copies of
+ *  cp.async.bulk.tensor. The tensor map is returned in a 128 bytes array on the device of the
+ *  tensor, which is passed to the kernels as a buffer.
+ */
+NDArray EncodeTensorMapTiled(NDArray tensor, ShapeTuple box_shape, int swizzle_bytes) {
+  int rank = tensor->ndim;
+  CHECK(rank >= 1 && rank <= 5) << "ValueError: TMA supports tensors of 1 to 5 dimensions, but got "
+                                << rank;
+  CHECK_EQ(static_cast<int>(box_shape.size()), rank)
+      << "ValueError: The box must have the rank of the tensor";
+  DataType dtype(tensor->dtype);
+  CUtensorMapDataType cu_dtype;
+  if (dtype == DataType::Float(16)) {
+    cu_dtype = CU_TENSOR_MAP_DATA_TYPE_FLOAT16;
+  } else if (dtype == DataType::BFloat(16)) {
+    cu_dtype = CU_TENSOR_MAP_DATA_TYPE_BFLOAT16;
+  } else if (dtype == DataType::Float(32)) {
+    cu_dtype = CU_TENSOR_MAP_DATA_TYPE_FLOAT32;
+  } else if (dtype == DataType::Float(64)) {
+    cu_dtype = CU_TENSOR_MAP_DATA_TYPE_FLOAT64;
+  } else if (dtype == DataType::Int(32)) {
+    cu_dtype = CU_TENSOR_MAP_DATA_TYPE_INT32;
+  } else if (dtype == DataType::UInt(32)) {
+    cu_dtype = CU_TENSOR_MAP_DATA_TYPE_UINT32;
+  } else if (dtype == DataType::Int(64)) {
+    cu_dtype = CU_TENSOR_MAP_DATA_TYPE_INT64;
+  } else if (dtype.bits() == 8) {
+    cu_dtype = CU_TENSOR_MAP_DATA_TYPE_UINT8;
+  } else if (dtype.bits() == 16) {
+    cu_dtype = CU_TENSOR_MAP_DATA_TYPE_UINT16;
+  } else {
+    LOG(FATAL) << "ValueError: TMA does not support tensors of type " << dtype;
+  }
+  CUtensorMapSwizzle swizzle;
+  if (swizzle_bytes == 0) {
+    swizzle = CU_TENSOR_MAP_SWIZZLE_NONE;
+  } else if (swizzle_bytes == 32) {
+    swizzle = CU_TENSOR_MAP_SWIZZLE_32B;
+  } else if (swizzle_bytes == 64) {
+    swizzle = CU_TENSOR_MAP_SWIZZLE_64B;
+  } else if (swizzle_bytes == 128) {
+    swizzle = CU_TENSOR_MAP_SWIZZLE_128B;
+  } else {
+    LOG(FATAL) << "ValueError: The swizzle must be 0, 32, 64 or 128 bytes, but got "
+               << swizzle_bytes;
+  }
+  // The dimensions of the tensor map start from the innermost one, and the stride of the
+  // innermost dimension is implicitly the element size.
+  std::vector<cuuint64_t> global_dim(rank), global_strides(rank);
+  std::vector<cuuint32_t> box_dim(rank), element_strides(rank, 1);
+  int64_t elem_bytes = (dtype.bits() * dtype.lanes() + 7) / 8;
+  int64_t contiguous_stride = 1;
+  for (int i = 0; i < rank; ++i) {
+    int axis = rank - 1 - i;
+    int64_t elem_stride = tensor->strides ? tensor->strides[axis] : contiguous_stride;
+    global_dim[i] = tensor->shape[axis];
+    global_strides[i] = elem_stride * elem_bytes;
+    box_dim[i] = box_shape[axis];
+    contiguous_stride *= tensor->shape[axis];
+  }
+  void* global_address = static_cast<char*>(tensor->data) + tensor->byte_offset;
+  CUtensorMap tensor_map;
+  CUDA_DRIVER_CALL(cuTensorMapEncodeTiled(
+      &tensor_map, cu_dtype, rank, global_address, global_dim.data(), global_strides.data() + 1,
+      box_dim.data(), element_strides.data(), CU_TENSOR_MAP_INTERLEAVE_NONE, swizzle,
+      CU_TENSOR_MAP_L2_PROMOTION_L2_128B, CU_TENSOR_MAP_FLOAT_OOB_FILL_NONE));
+  NDArray result = NDArray::Empty({static_cast<int64_t>(sizeof(CUtensorMap))},
+                                  DataType::UInt(8), tensor->device);
+  result.CopyFromBytes(&tensor_map, sizeof(CUtensorMap));
+  return result;
+}
+
+TVM_REGISTER_GLOBAL("runtime.cuda.encode_tensor_map_tiled").set_body_typed(EncodeTensorMapTiled);
+#endif
+
 }  // namespace runtime
 }  // namespace tvm
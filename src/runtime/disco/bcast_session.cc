@@ -22,7 +22,11 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 namespace tvm {
 namespace runtime {
@@ -36,6 +40,7 @@ struct BcastSessionObj::Internal {
     int type_codes[kNumArgs];
     PackArgs(values, type_codes, static_cast<int>(action), reg_id, std::forward<Args>(args)...);
     self->BroadcastPacked(TVMArgs(values, type_codes, kNumArgs));
+    self->num_commands_sent_ += 1;
   }
 
   static DRef MakeDRef(int reg_id, Session session) {
@@ -53,12 +58,14 @@ DRef BcastSessionObj::GetGlobalFunc(const std::string& name) {
 }
 
 void BcastSessionObj::CopyFromWorker0(const NDArray& host_array, const DRef& remote_array) {
+  CHECK(!recording_) << "ValueError: Cannot copy from worker-0 while recording a command graph";
   this->AppendHostNDArray(host_array);
   BcastSessionObj::Internal::BroadcastUnpacked(this, DiscoAction::kCopyFromWorker0,
                                                remote_array->reg_id);
 }
 
 void BcastSessionObj::CopyToWorker0(const NDArray& host_array, const DRef& remote_array) {
+  CHECK(!recording_) << "ValueError: Cannot copy to worker-0 while recording a command graph";
   this->AppendHostNDArray(host_array);
   BcastSessionObj::Internal::BroadcastUnpacked(this, DiscoAction::kCopyToWorker0,
                                                remote_array->reg_id);
@@ -76,13 +83,69 @@ void BcastSessionObj::InitCCL(String ccl, IntTuple device_ids) {
 }
 
 void BcastSessionObj::SyncWorker(int worker_id) {
+  CHECK(!recording_) << "ValueError: Cannot sync with a worker while recording a command graph";
+  auto start = std::chrono::steady_clock::now();
   BcastSessionObj::Internal::BroadcastUnpacked(this, DiscoAction::kSyncWorker, worker_id);
+  int64_t num_commands_sent = num_commands_sent_;
+
+  // The watchdog warns from another thread while this one is blocked on the reply.
+  std::mutex mutex;
+  std::condition_variable replied_cv;
+  bool replied = false;
+  std::thread watchdog;
+  if (sync_watchdog_ms_ > 0) {
+    watchdog = std::thread([&, timeout = std::chrono::milliseconds(sync_watchdog_ms_)]() {
+      std::unique_lock<std::mutex> lock(mutex);
+      for (int i = 1; !replied_cv.wait_for(lock, timeout, [&]() { return replied; }); ++i) {
+        LOG(WARNING) << "Worker " << worker_id << " has not replied to SyncWorker in "
+                     << i * timeout.count() << " ms";
+      }
+    });
+  }
   TVMArgs args = this->RecvReplyPacked(worker_id);
-  ICHECK_EQ(args.size(), 2);
+  if (watchdog.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      replied = true;
+    }
+    replied_cv.notify_one();
+    watchdog.join();
+  }
+
+  ICHECK_EQ(args.size(), 5);
   DiscoAction action = static_cast<DiscoAction>(args[0].operator int());
   int ret_worker_id = args[1];
   ICHECK(action == DiscoAction::kSyncWorker);
   ICHECK_EQ(ret_worker_id, worker_id);
+  if (static_cast<int64_t>(worker_sync_info_.size()) <= worker_id) {
+    worker_sync_info_.resize(worker_id + 1);
+  }
+  WorkerSyncInfo& info = worker_sync_info_[worker_id];
+  info.num_commands_sent = num_commands_sent;
+  info.num_commands_run = args[2];
+  info.busy_nanos = args[3];
+  info.timestamp_nanos = args[4];
+  info.round_trip_nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+}
+
+IntTuple BcastSessionObj::GetWorkerSyncInfo() {
+  int64_t num_workers = GetNumWorkers();
+  std::vector<int64_t> result;
+  result.reserve(num_workers * 5);
+  for (int64_t i = 0; i < num_workers; ++i) {
+    WorkerSyncInfo info;
+    if (i < static_cast<int64_t>(worker_sync_info_.size())) {
+      info = worker_sync_info_[i];
+    }
+    result.push_back(num_commands_sent_ - info.num_commands_sent);
+    result.push_back(info.num_commands_run);
+    result.push_back(info.busy_nanos);
+    result.push_back(info.timestamp_nanos);
+    result.push_back(info.round_trip_nanos);
+  }
+  return IntTuple(result);
 }
 
 DRef BcastSessionObj::CallWithPacked(const TVMArgs& args) {
@@ -90,9 +153,9 @@ DRef BcastSessionObj::CallWithPacked(const TVMArgs& args) {
   int* type_codes = const_cast<int*>(args.type_codes);
   int num_args = args.num_args;
   int reg_id = AllocateReg();
+  DRef func = args[2];
   {
     TVMArgsSetter setter(values, type_codes);
-    DRef func = args[2];
     setter(0, static_cast<int>(DiscoAction::kCallPacked));
     setter(1, reg_id);
     setter(2, func->reg_id);
@@ -115,13 +178,79 @@ DRef BcastSessionObj::CallWithPacked(const TVMArgs& args) {
       LOG(FATAL) << "CallWithPacked() does not support " << cnt << " argument(s):" << os.str();
     }
   }
+  DRef ret = BcastSessionObj::Internal::MakeDRef(reg_id, GetRef<Session>(this));
+  if (recording_) {
+    RecordedCall call{ret, func, {}};
+    for (int i = 3; i < num_args; ++i) {
+      CHECK_NE(type_codes[i], kTVMBytes) << "ValueError: Argument #" << i - 3
+                                         << " of bytes cannot be recorded into a command graph";
+      call.args.emplace_back();
+      call.args.back() = TVMArgValue(values[i], type_codes[i]);
+    }
+    recorded_calls_.push_back(std::move(call));
+    return ret;
+  }
   this->BroadcastPacked(TVMArgs(values, type_codes, num_args));
+  num_commands_sent_ += 1;
+  return ret;
+}
+
+void BcastSessionObj::BeginCommandGraph() {
+  CHECK(!recording_) << "ValueError: A command graph is already being recorded";
+  recording_ = true;
+}
+
+DRef BcastSessionObj::EndCommandGraph() {
+  CHECK(recording_) << "ValueError: No command graph is being recorded";
+  recording_ = false;
+  std::vector<RecordedCall> calls = std::move(recorded_calls_);
+  recorded_calls_.clear();
+  // The graph is sent as a flat packed sequence:
+  // [action, graph_reg_id, num_calls, (num_args, ret_reg_id, func_reg_id, args...)...]
+  int num_values = 3;
+  for (const RecordedCall& call : calls) {
+    num_values += 3 + static_cast<int>(call.args.size());
+  }
+  int reg_id = AllocateReg();
+  std::vector<TVMValue> values(num_values);
+  std::vector<int> type_codes(num_values);
+  TVMArgsSetter setter(values.data(), type_codes.data());
+  int k = 0;
+  setter(k++, static_cast<int>(DiscoAction::kDefineCommandGraph));
+  setter(k++, reg_id);
+  setter(k++, static_cast<int64_t>(calls.size()));
+  for (const RecordedCall& call : calls) {
+    setter(k++, static_cast<int64_t>(call.args.size()));
+    setter(k++, call.ret->reg_id);
+    setter(k++, call.func->reg_id);
+    for (const TVMRetValue& arg : call.args) {
+      setter(k++, arg);
+    }
+  }
+  this->BroadcastPacked(TVMArgs(values.data(), type_codes.data(), num_values));
+  num_commands_sent_ += 1;
+  command_graphs_[reg_id] = std::move(calls);
   return BcastSessionObj::Internal::MakeDRef(reg_id, GetRef<Session>(this));
 }
 
+void BcastSessionObj::ReplayCommandGraph(const DRef& graph) {
+  CHECK(!recording_) << "ValueError: Cannot replay a command graph while recording one";
+  CHECK(command_graphs_.count(graph->reg_id))
+      << "ValueError: Register " << graph->reg_id << " does not hold a command graph";
+  BcastSessionObj::Internal::BroadcastUnpacked(this, DiscoAction::kReplayCommandGraph,
+                                               graph->reg_id);
+}
+
 void BcastSessionObj::DeallocReg(int reg_id) {
   BcastSessionObj::Internal::BroadcastUnpacked(this, DiscoAction::kKillReg, reg_id);
   this->free_regs_.push_back(reg_id);
+  auto it = command_graphs_.find(reg_id);
+  if (it != command_graphs_.end()) {
+    // Release the registers of the graph only after the graph is erased, as releasing them
+    // deallocates registers recursively.
+    std::vector<RecordedCall> calls = std::move(it->second);
+    command_graphs_.erase(it);
+  }
 }
 
 int BcastSessionObj::AllocateReg() {
@@ -138,5 +267,21 @@ void BcastSessionObj::AppendHostNDArray(const NDArray& host_array) {
   worker_zero_data_.host_arrays.push(host_array);
 }
 
+/*! \brief Get the BcastSessionObj of a session, as the sync info is only kept by them. */
+BcastSessionObj* GetBcastSession(Session session) {
+  auto* bcast = dynamic_cast<BcastSessionObj*>(session.operator->());
+  CHECK(bcast != nullptr) << "ValueError: " << session->GetTypeKey()
+                          << " does not broadcast its commands to the workers";
+  return bcast;
+}
+
+TVM_REGISTER_GLOBAL("runtime.disco.SessionGetWorkerSyncInfo").set_body_typed([](Session session) {
+  return GetBcastSession(session)->GetWorkerSyncInfo();
+});
+TVM_REGISTER_GLOBAL("runtime.disco.SessionSetSyncWatchdog")
+    .set_body_typed([](Session session, int64_t timeout_ms) {
+      GetBcastSession(session)->SetSyncWatchdog(timeout_ms);
+    });
+
 }  // namespace runtime
 }  // namespace tvm
@@ -23,6 +23,7 @@
 #include <tvm/runtime/disco/session.h>
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace tvm {
@@ -42,9 +43,26 @@ class BcastSessionObj : public SessionObj {
   void SyncWorker(int worker_id) override;
   void Shutdown() override;
   void InitCCL(String ccl, IntTuple device_ids) override;
+  void BeginCommandGraph() override;
+  DRef EndCommandGraph() override;
+  void ReplayCommandGraph(const DRef& graph) override;
   TVMRetValue DebugGetFromRemote(int64_t reg_id, int worker_id) override = 0;
   void DebugSetRegister(int64_t reg_id, TVMArgValue value, int worker_id) override = 0;
 
+  /*!
+   * \brief Get what the controller knows about each worker from its last SyncWorker reply.
+   * \return For each worker in order, the number of commands sent since its last reply, the
+   * number of commands it had run, the nanoseconds it had spent on them, its wall clock time at
+   * the reply in nanoseconds since the epoch, and the round trip of the SyncWorker in nanoseconds.
+   * The last four are zeros for the workers never synced.
+   */
+  IntTuple GetWorkerSyncInfo();
+  /*!
+   * \brief Warn when a worker does not reply to SyncWorker within the given time.
+   * \param timeout_ms The time in milliseconds, or zero to disable the warning.
+   */
+  void SetSyncWatchdog(int64_t timeout_ms) { sync_watchdog_ms_ = timeout_ms; }
+
  protected:
   /*! \brief Deallocate a register id, kill it on all workers, and append it to `free_regs_`. */
   void DeallocReg(int reg_id) override;
@@ -91,6 +109,40 @@ class BcastSessionObj : public SessionObj {
   /*! \brief The regsiter ids that have been deallocated */
   std::vector<int64_t> free_regs_;
 
+  /*! \brief What a worker told in its last SyncWorker reply, see GetWorkerSyncInfo */
+  struct WorkerSyncInfo {
+    int64_t num_commands_sent = 0;
+    int64_t num_commands_run = 0;
+    int64_t busy_nanos = 0;
+    int64_t timestamp_nanos = 0;
+    int64_t round_trip_nanos = 0;
+  };
+  /*! \brief The number of commands broadcast to the workers */
+  int64_t num_commands_sent_ = 0;
+  /*! \brief The last SyncWorker reply of each worker */
+  std::vector<WorkerSyncInfo> worker_sync_info_;
+  /*! \brief The time to warn after when a worker does not reply to SyncWorker, or zero */
+  int64_t sync_watchdog_ms_ = 0;
+
+  /*! \brief A PackedFunc call recorded into a command graph */
+  struct RecordedCall {
+    /*! \brief The register the return value is written to */
+    DRef ret;
+    /*! \brief The function to be called */
+    DRef func;
+    /*! \brief The arguments, where DRefs refer to the registers at the time of replay */
+    std::vector<TVMRetValue> args;
+  };
+  /*! \brief Whether the PackedFunc calls are being recorded into a command graph */
+  bool recording_ = false;
+  /*! \brief The calls recorded since BeginCommandGraph */
+  std::vector<RecordedCall> recorded_calls_;
+  /*!
+   * \brief The calls of each command graph, indexed by its register id. They keep the registers
+   * the graph reads and writes from being reused as long as the graph is alive.
+   */
+  std::unordered_map<int64_t, std::vector<RecordedCall>> command_graphs_;
+
   struct Internal;
   friend struct Internal;
   friend class SocketSessionObj;
@@ -21,6 +21,7 @@
 #include <tvm/runtime/disco/builtin.h>
 #include <tvm/runtime/disco/disco_worker.h>
 #include <tvm/runtime/disco/session.h>
+#include <tvm/runtime/nvtx.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/relax_vm/vm.h>
@@ -80,36 +81,88 @@ const PackedFunc& GetCCLFunc(const char* name) {
 }
 
 void AllReduce(NDArray send, ReduceKind reduce_kind, bool in_group, NDArray recv) {
+  NVTXScopedRange scope("Disco: allreduce");
   GetCCLFunc("allreduce")(send, static_cast<int>(reduce_kind), in_group, recv);
 }
 
 void AllGather(NDArray send, bool in_group, NDArray recv) {
+  NVTXScopedRange scope("Disco: allgather");
   GetCCLFunc("allgather")(send, in_group, recv);
 }
 
+void AllReduceAsync(NDArray send, ReduceKind reduce_kind, bool in_group, NDArray recv) {
+  NVTXScopedRange scope("Disco: allreduce_async");
+  GetCCLFunc("allreduce_async")(send, static_cast<int>(reduce_kind), in_group, recv);
+}
+
+void AllGatherAsync(NDArray send, bool in_group, NDArray recv) {
+  NVTXScopedRange scope("Disco: allgather_async");
+  GetCCLFunc("allgather_async")(send, in_group, recv);
+}
+
+void RingExchange(NDArray send, NDArray recv) {
+  NVTXScopedRange scope("Disco: ring_exchange");
+  GetCCLFunc("ring_exchange")(send, recv);
+}
+
+void RingExchangeAsync(NDArray send, NDArray recv) {
+  NVTXScopedRange scope("Disco: ring_exchange_async");
+  GetCCLFunc("ring_exchange_async")(send, recv);
+}
+
+void AllToAll(NDArray send, bool in_group, NDArray recv) {
+  NVTXScopedRange scope("Disco: alltoall");
+  GetCCLFunc("alltoall")(send, in_group, recv);
+}
+
+void AllToAllV(NDArray send, ShapeTuple send_counts, ShapeTuple recv_counts, bool in_group,
+               NDArray recv) {
+  NVTXScopedRange scope("Disco: alltoallv");
+  GetCCLFunc("alltoallv")(send, send_counts, recv_counts, in_group, recv);
+}
+
+void WaitCollective(NDArray recv) {
+  NVTXScopedRange scope("Disco: wait_collective");
+  GetCCLFunc("wait_collective")(recv);
+}
+
 TVM_DLL void BroadcastFromWorker0(NDArray send, bool in_group, NDArray recv) {
+  NVTXScopedRange scope("Disco: broadcast_from_worker0");
   GetCCLFunc("broadcast_from_worker0")(send, in_group, recv);
 }
 
 TVM_DLL void ScatterFromWorker0(Optional<NDArray> send, bool in_group, NDArray recv) {
+  NVTXScopedRange scope("Disco: scatter_from_worker0");
   GetCCLFunc("scatter_from_worker0")(send, in_group, recv);
 }
 
 void GatherToWorker0(NDArray send, bool in_group, Optional<NDArray> recv) {
+  NVTXScopedRange scope("Disco: gather_to_worker0");
   GetCCLFunc("gather_to_worker0")(send, in_group, recv);
 }
 
-void RecvFromWorker0(NDArray buffer) { GetCCLFunc("recv_from_worker0")(buffer); }
+void RecvFromWorker0(NDArray buffer) {
+  NVTXScopedRange scope("Disco: recv_from_worker0");
+  GetCCLFunc("recv_from_worker0")(buffer);
+}
 
-void SendToNextGroup(NDArray buffer) { GetCCLFunc("send_to_next_group")(buffer); }
+void SendToNextGroup(NDArray buffer) {
+  NVTXScopedRange scope("Disco: send_to_next_group");
+  GetCCLFunc("send_to_next_group")(buffer);
+}
 
-void RecvFromPrevGroup(NDArray buffer) { GetCCLFunc("recv_from_prev_group")(buffer); }
+void RecvFromPrevGroup(NDArray buffer) {
+  NVTXScopedRange scope("Disco: recv_from_prev_group");
+  GetCCLFunc("recv_from_prev_group")(buffer);
+}
 
 void SendToWorker(NDArray buffer, int receiver_id) {
+  NVTXScopedRange scope("Disco: send_to_worker");
   GetCCLFunc("send_to_worker")(buffer, receiver_id);
 }
 
 void RecvFromWorker(NDArray buffer, int sender_id) {
+  NVTXScopedRange scope("Disco: recv_from_worker");
   GetCCLFunc("recv_from_worker")(buffer, sender_id);
 }
 
@@ -117,6 +170,7 @@ int WorkerId() { return DiscoWorker::ThreadLocal()->worker_id; }
 
 void SyncWorker() {
   if (DiscoWorker::ThreadLocal()->ccl != "") {
+    NVTXScopedRange scope("Disco: sync_worker");
     GetCCLFunc("sync_worker")();
   }
 }
@@ -144,6 +198,23 @@ TVM_REGISTER_GLOBAL("runtime.disco.allreduce")
       AllReduce(send, static_cast<ReduceKind>(kind), in_group, recv);
     });
 TVM_REGISTER_GLOBAL("runtime.disco.allgather").set_body_typed(AllGather);
+TVM_REGISTER_GLOBAL("runtime.disco.allreduce_async")
+    .set_body_typed([](NDArray send, ShapeTuple reduce_kind, bool in_group, NDArray recv) {
+      int kind = IntegerFromShapeTuple(reduce_kind);
+      CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
+      AllReduceAsync(send, static_cast<ReduceKind>(kind), in_group, recv);
+    });
+TVM_REGISTER_GLOBAL("runtime.disco.allgather_async").set_body_typed(AllGatherAsync);
+TVM_REGISTER_GLOBAL("runtime.disco.ring_exchange").set_body_typed(RingExchange);
+TVM_REGISTER_GLOBAL("runtime.disco.ring_exchange_async").set_body_typed(RingExchangeAsync);
+TVM_REGISTER_GLOBAL("runtime.disco.alltoall").set_body_typed(AllToAll);
+TVM_REGISTER_GLOBAL("runtime.disco.alltoallv").set_body_typed(AllToAllV);
+TVM_REGISTER_GLOBAL("runtime.disco.wait_collective")
+    .set_body_typed([](NDArray recv, NDArray send) -> NDArray {
+      // `send` is only taken to keep it alive in the memory plan until the collective is done.
+      WaitCollective(recv);
+      return recv;
+    });
 TVM_REGISTER_GLOBAL("runtime.disco.broadcast_from_worker0").set_body_typed(BroadcastFromWorker0);
 TVM_REGISTER_GLOBAL("runtime.disco.scatter_from_worker0").set_body_typed(ScatterFromWorker0);
 TVM_REGISTER_GLOBAL("runtime.disco.gather_to_worker0").set_body_typed(GatherToWorker0);
@@ -158,6 +229,13 @@ TVM_REGISTER_GLOBAL("runtime.disco.worker_id").set_body_typed([]() -> ShapeTuple
 TVM_REGISTER_GLOBAL("runtime.disco.worker_rank").set_body_typed([]() -> int64_t {
   return WorkerId();
 });
+TVM_REGISTER_GLOBAL("runtime.disco.worker_stats").set_body_typed([]() -> ShapeTuple {
+  const DiscoWorkerStats& stats = DiscoWorker::ThreadLocal()->stats;
+  std::vector<int64_t> result{stats.num_commands, stats.busy_nanos};
+  result.insert(result.end(), stats.latency_histogram,
+                stats.latency_histogram + DiscoWorkerStats::kNumLatencyBuckets);
+  return ShapeTuple(result);
+});
 TVM_REGISTER_GLOBAL("runtime.disco.device").set_body_typed([]() -> Device {
   return DiscoWorker::ThreadLocal()->default_device;
 });
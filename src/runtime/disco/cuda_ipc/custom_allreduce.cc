@@ -22,6 +22,10 @@
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
 #include "../../../../3rdparty/tensorrt_llm/custom_allreduce_kernels.h"
 #include "../nccl/nccl_context.h"
 
@@ -57,30 +61,17 @@ inline bool CanApplyTwoShotAllReduce(int64_t num_elements, DLDataType dtype, int
 }
 
 /*!
- * \brief Customized all-reduce kernel backed by CUDA IPC memory.
- * \param send The input tensor of all-reduce.
- * \param strategy The all-reduce strategy. See AllReduceStrategyType for detail.
- * \param recv The output tensor of all-reduce.
+ * \brief Run an all-reduce with the given strategy, which should not be AUTO.
+ * The input should be in CUDA IPC memory unless the strategy is RING.
  */
-void CustomAllReduce(DLTensor* send, int strategy, DLTensor* recv) {
-  int64_t num_elements = TensorSize(send);
+void LaunchAllReduce(void* send, void* recv, int64_t num_elements, DLDataType dtype,
+                     tensorrt_llm::AllReduceStrategyType strategy, deviceStream_t stream) {
   nccl::CCLThreadLocalContext* ctx = nccl::CCLThreadLocalContext::Get();
-  CHECK_EQ(ctx->worker->num_groups, 1)
-      << "Custom AllReduce for multiple group is not yet implemented.";
-
-  tensorrt_llm::AllReduceStrategyType strategy_ =
-      static_cast<tensorrt_llm::AllReduceStrategyType>(strategy);
-  if (strategy_ == tensorrt_llm::AllReduceStrategyType::AUTO) {
-    strategy_ = tensorrt_llm::SelectImplementation(
-        num_elements * ((send->dtype.bits * send->dtype.lanes + 7) / 8), ctx->worker->num_workers);
-  }
-
-  if (strategy_ == tensorrt_llm::AllReduceStrategyType::RING ||
-      !CanApplyCustomAllReduce(num_elements, send->dtype)) {
+  if (strategy == tensorrt_llm::AllReduceStrategyType::RING ||
+      !CanApplyCustomAllReduce(num_elements, dtype)) {
     // Dispatch to nccl AllReduce if the customized all-reduce cannot apply.
-    deviceStream_t stream = ctx->GetDefaultStream();
-    NCCL_CALL(ncclAllReduce(send->data, recv->data, num_elements,
-                            /*datatype=*/nccl::AsNCCLDataType(DataType(send->dtype)),
+    NCCL_CALL(ncclAllReduce(send, recv, num_elements,
+                            /*datatype=*/nccl::AsNCCLDataType(DataType(dtype)),
                             /*op=*/ncclSum, ctx->global_comm, stream));
     return;
   }
@@ -90,7 +81,7 @@ void CustomAllReduce(DLTensor* send, int strategy, DLTensor* recv) {
   params.ranks_per_node = ctx->worker->num_workers;
   params.rank = ctx->worker->worker_id;
   params.local_rank = ctx->worker->worker_id;
-  CUDAIPCMemory ipc_memory = CUDAIPCMemory::GetIPCMemoryFromDevicePtr(send->data);
+  CUDAIPCMemory ipc_memory = CUDAIPCMemory::GetIPCMemoryFromDevicePtr(send);
   params.barrier_flag = ipc_memory->barrier_flag++;
   for (int i = 0; i < ctx->worker->num_workers; ++i) {
     params.peer_comm_buffer_ptrs[i] = ipc_memory->remote_data[i];
@@ -102,16 +93,203 @@ void CustomAllReduce(DLTensor* send, int strategy, DLTensor* recv) {
     params.peer_barrier_ptrs_out[i] = reinterpret_cast<uint32_t*>(ipc_memory->barrier_out[i]);
   }
 
-  if (!CanApplyTwoShotAllReduce(num_elements, send->dtype, ctx->worker->num_workers)) {
+  if (!CanApplyTwoShotAllReduce(num_elements, dtype, ctx->worker->num_workers)) {
     // Two-shot all-reduce does not support this case.
     // So we fallback to the one-shot strategy.
-    strategy_ = tensorrt_llm::AllReduceStrategyType::ONESHOT;
+    strategy = tensorrt_llm::AllReduceStrategyType::ONESHOT;
   }
 
-  tensorrt_llm::customAllReduce(params, recv->data, num_elements, send->dtype, strategy_,
-                                ctx->GetDefaultStream());
+  tensorrt_llm::customAllReduce(params, recv, num_elements, dtype, strategy, stream);
 }
 
+/*!
+ * \brief The all-reduce strategies measured to be the fastest on the communicator of a worker,
+ * for messages of increasing sizes. Built by TuneCustomAllReduce.
+ */
+struct AllReduceTuningTable {
+  /*! \brief The communicator the table is built for. */
+  ncclComm_t comm = nullptr;
+  /*! \brief The probed message sizes in bytes, in increasing order. */
+  std::vector<size_t> message_bytes;
+  /*! \brief The fastest strategy for the messages up to each probed size. */
+  std::vector<tensorrt_llm::AllReduceStrategyType> strategies;
+
+  static AllReduceTuningTable* ThreadLocal() {
+    thread_local AllReduceTuningTable table;
+    return &table;
+  }
+
+  /*! \brief Look up the strategy of a message, if the table is built for the communicator. */
+  bool Lookup(ncclComm_t cur_comm, size_t nbytes,
+              tensorrt_llm::AllReduceStrategyType* strategy) const {
+    if (comm == nullptr || comm != cur_comm) return false;
+    auto it = std::lower_bound(message_bytes.begin(), message_bytes.end(), nbytes);
+    *strategy = it == message_bytes.end() ? tensorrt_llm::AllReduceStrategyType::RING
+                                          : strategies[it - message_bytes.begin()];
+    return true;
+  }
+};
+
+/*!
+ * \brief Customized all-reduce kernel backed by CUDA IPC memory.
+ * \param send The input tensor of all-reduce.
+ * \param strategy The all-reduce strategy. See AllReduceStrategyType for detail.
+ * \param recv The output tensor of all-reduce.
+ */
+void CustomAllReduce(DLTensor* send, int strategy, DLTensor* recv) {
+  int64_t num_elements = TensorSize(send);
+  nccl::CCLThreadLocalContext* ctx = nccl::CCLThreadLocalContext::Get();
+  CHECK_EQ(ctx->worker->num_groups, 1)
+      << "Custom AllReduce for multiple group is not yet implemented.";
+
+  tensorrt_llm::AllReduceStrategyType strategy_ =
+      static_cast<tensorrt_llm::AllReduceStrategyType>(strategy);
+  if (strategy_ == tensorrt_llm::AllReduceStrategyType::AUTO) {
+    size_t nbytes = num_elements * ((send->dtype.bits * send->dtype.lanes + 7) / 8);
+    if (!AllReduceTuningTable::ThreadLocal()->Lookup(ctx->global_comm, nbytes, &strategy_)) {
+      strategy_ = tensorrt_llm::SelectImplementation(nbytes, ctx->worker->num_workers);
+    }
+  }
+  LaunchAllReduce(send->data, recv->data, num_elements, send->dtype, strategy_,
+                  ctx->GetDefaultStream());
+}
+
+/*!
+ * \brief All-reduce a few host values across the workers, e.g. to agree on the measurements.
+ */
+std::vector<float> AllReduceHostValues(std::vector<float> values, ncclRedOp_t op) {
+  nccl::CCLThreadLocalContext* ctx = nccl::CCLThreadLocalContext::Get();
+  deviceStream_t stream = ctx->GetDefaultStream();
+  size_t nbytes = values.size() * sizeof(float);
+  void* buffer;
+  CUDA_CALL(cudaMalloc(&buffer, nbytes));
+  CUDA_CALL(cudaMemcpyAsync(buffer, values.data(), nbytes, cudaMemcpyHostToDevice, stream));
+  NCCL_CALL(
+      ncclAllReduce(buffer, buffer, values.size(), ncclFloat32, op, ctx->global_comm, stream));
+  CUDA_CALL(cudaMemcpyAsync(values.data(), buffer, nbytes, cudaMemcpyDeviceToHost, stream));
+  CUDA_CALL(cudaStreamSynchronize(stream));
+  CUDA_CALL(cudaFree(buffer));
+  return values;
+}
+
+/*! \brief Check if every worker can directly access the memory of every other worker. */
+bool AllPeersAccessible() {
+  nccl::CCLThreadLocalContext* ctx = nccl::CCLThreadLocalContext::Get();
+  int num_workers = ctx->worker->num_workers;
+  std::vector<float> device_ids(num_workers, 0.0f);
+  device_ids[ctx->worker->worker_id] = ctx->device_id;
+  device_ids = AllReduceHostValues(device_ids, ncclSum);
+  float accessible = 1.0f;
+  for (int i = 0; i < num_workers; ++i) {
+    int peer_device = static_cast<int>(device_ids[i]);
+    if (i == ctx->worker->worker_id || peer_device == ctx->device_id) continue;
+    int can_access = 0;
+    if (cudaDeviceCanAccessPeer(&can_access, ctx->device_id, peer_device) != cudaSuccess) {
+      // The peer device is not visible to this worker.
+      cudaGetLastError();
+      can_access = 0;
+    }
+    accessible = std::min(accessible, static_cast<float>(can_access));
+  }
+  return AllReduceHostValues({accessible}, ncclMin)[0] > 0.0f;
+}
+
+/*!
+ * \brief Build the tuning table of the current communicator, used by the AUTO strategy.
+ *
+ * The custom kernels are only considered when all the workers have peer access to each other,
+ * e.g. through NVLink or NVSwitch, or PCIe with peer-to-peer support. Otherwise NCCL is always
+ * used. The latency of one-shot, two-shot and NCCL are measured on messages of doubling sizes up
+ * to the workspace of the custom kernels, and the slowest worker decides each measurement, so
+ * that all workers build the same table.
+ *
+ * \note It is a collective operation, which should be called on all workers.
+ */
+void TuneCustomAllReduce() {
+  using tensorrt_llm::AllReduceStrategyType;
+  constexpr size_t kMinMessageBytes = 4096;
+  constexpr int kNumWarmups = 3;
+  constexpr int kNumRepeats = 20;
+  nccl::CCLThreadLocalContext* ctx = nccl::CCLThreadLocalContext::Get();
+  int num_workers = ctx->worker->num_workers;
+  if (ctx->worker->num_groups != 1 || num_workers == 1) {
+    // Custom AllReduce for multiple groups is not yet implemented.
+    return;
+  }
+  size_t max_message_bytes = tensorrt_llm::GetMaxRequiredWorkspaceSize(num_workers);
+
+  AllReduceTuningTable table;
+  table.comm = ctx->global_comm;
+  for (size_t nbytes = kMinMessageBytes; nbytes <= max_message_bytes; nbytes *= 2) {
+    table.message_bytes.push_back(nbytes);
+  }
+  if (!AllPeersAccessible()) {
+    LOG(INFO) << "The workers do not all have peer access to each other, "
+              << "and AllReduce always uses " TVM_DISCO_CCL_NAME;
+    table.strategies.assign(table.message_bytes.size(), AllReduceStrategyType::RING);
+    *AllReduceTuningTable::ThreadLocal() = std::move(table);
+    return;
+  }
+
+  const std::vector<AllReduceStrategyType> candidates = {
+      AllReduceStrategyType::RING, AllReduceStrategyType::ONESHOT, AllReduceStrategyType::TWOSHOT};
+  DLDataType dtype = DataType::Float(32);
+  Device device{DLDeviceType::kDLCUDA, ctx->device_id};
+  memory::Allocator* allocator = CUDAIPCMemory::GlobalAllocator();
+  memory::Buffer send = allocator->Alloc(
+      device, ShapeTuple({static_cast<int64_t>(max_message_bytes / sizeof(float))}), dtype,
+      /*mem_scope=*/"ipc_memory");
+  void* recv;
+  CUDA_CALL(cudaMalloc(&recv, max_message_bytes));
+  CUDA_CALL(cudaMemset(send.data, 0, max_message_bytes));
+  deviceStream_t stream = ctx->GetDefaultStream();
+  cudaEvent_t start, stop;
+  CUDA_CALL(cudaEventCreate(&start));
+  CUDA_CALL(cudaEventCreate(&stop));
+
+  std::vector<float> latencies;
+  for (size_t nbytes : table.message_bytes) {
+    int64_t num_elements = nbytes / sizeof(float);
+    for (AllReduceStrategyType strategy : candidates) {
+      for (int i = 0; i < kNumWarmups; ++i) {
+        LaunchAllReduce(send.data, recv, num_elements, dtype, strategy, stream);
+      }
+      CUDA_CALL(cudaEventRecord(start, stream));
+      for (int i = 0; i < kNumRepeats; ++i) {
+        LaunchAllReduce(send.data, recv, num_elements, dtype, strategy, stream);
+      }
+      CUDA_CALL(cudaEventRecord(stop, stream));
+      CUDA_CALL(cudaEventSynchronize(stop));
+      float elapsed_ms = 0;
+      CUDA_CALL(cudaEventElapsedTime(&elapsed_ms, start, stop));
+      latencies.push_back(elapsed_ms / kNumRepeats);
+    }
+  }
+  latencies = AllReduceHostValues(latencies, ncclMax);
+
+  std::ostringstream os;
+  for (size_t i = 0; i < table.message_bytes.size(); ++i) {
+    size_t best = 0;
+    for (size_t j = 1; j < candidates.size(); ++j) {
+      if (latencies[i * candidates.size() + j] < latencies[i * candidates.size() + best]) {
+        best = j;
+      }
+    }
+    table.strategies.push_back(candidates[best]);
+    os << " " << table.message_bytes[i] << ":" << static_cast<int>(candidates[best]);
+  }
+  DLOG(INFO) << "AllReduce strategies by message size:" << os.str();
+
+  CUDA_CALL(cudaEventDestroy(start));
+  CUDA_CALL(cudaEventDestroy(stop));
+  CUDA_CALL(cudaFree(recv));
+  allocator->Free(send);
+  *AllReduceTuningTable::ThreadLocal() = std::move(table);
+}
+
+TVM_REGISTER_GLOBAL("runtime.disco.cuda_ipc.tune_custom_allreduce")
+    .set_body_typed(TuneCustomAllReduce);
+
 TVM_REGISTER_GLOBAL("runtime.disco.cuda_ipc.custom_allreduce").set_body_typed(CustomAllReduce);
 
 }  // namespace cuda_ipc
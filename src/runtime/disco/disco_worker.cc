@@ -22,12 +22,40 @@
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 
+#include <chrono>
+#include <utility>
+#include <vector>
+
 #include "../../support/process_id.h"
 #include "./protocol.h"
 
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief A command graph on a worker, i.e. a sequence of PackedFunc calls decoded once and run
+ * locally on each replay.
+ */
+class DiscoCommandGraphObj : public Object {
+ public:
+  /*! \brief A PackedFunc call of the graph */
+  struct Command {
+    /*! \brief The register the return value is written to */
+    int64_t ret_reg_id;
+    /*! \brief The register holding the function to be called */
+    int64_t func_reg_id;
+    /*! \brief The arguments, where DRefs are looked up in the register file upon each call */
+    std::vector<TVMRetValue> args;
+  };
+  /*! \brief The calls in the order they are recorded */
+  std::vector<Command> commands;
+
+  static constexpr const char* _type_key = "runtime.disco.CommandGraph";
+  TVM_DECLARE_FINAL_OBJECT_INFO(DiscoCommandGraphObj, Object);
+};
+
+TVM_REGISTER_OBJECT_TYPE(DiscoCommandGraphObj);
+
 TVM_DLL DiscoWorker* DiscoWorker::ThreadLocal() {
   DiscoWorker* ret = ThreadLocalDiscoWorker::Get()->worker;
   CHECK(ret) << "ValueError: The current thread is not a DiscoWorker thread";
@@ -53,6 +81,7 @@ struct DiscoWorker::Impl {
       TVMArgs args = self->channel->Recv();
       DiscoAction action = static_cast<DiscoAction>(args[0].operator int());
       int64_t reg_id = args[1];
+      auto start = std::chrono::steady_clock::now();
       switch (action) {
         case DiscoAction::kShutDown: {
           Shutdown(self);
@@ -98,7 +127,19 @@ struct DiscoWorker::Impl {
           DebugSetRegister(self, reg_id, worker_id, value);
           break;
         }
+        case DiscoAction::kDefineCommandGraph: {
+          DefineCommandGraph(self, reg_id,
+                             TVMArgs(args.values + 2, args.type_codes + 2, args.num_args - 2));
+          break;
+        }
+        case DiscoAction::kReplayCommandGraph: {
+          ReplayCommandGraph(self, reg_id);
+          break;
+        }
       }
+      self->stats.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count());
     }
   }
 
@@ -138,10 +179,16 @@ struct DiscoWorker::Impl {
   static void SyncWorker(DiscoWorker* self, int worker_id) {
     if (worker_id == self->worker_id) {
       ::tvm::runtime::SyncWorker();
-      TVMValue values[2];
-      int type_codes[2];
-      PackArgs(values, type_codes, static_cast<int>(DiscoAction::kSyncWorker), worker_id);
-      self->channel->Reply(TVMArgs(values, type_codes, 2));
+      // Reply with the statistics of the commands before this one, and the wall clock time, to
+      // compare the workers with.
+      int64_t timestamp_nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::system_clock::now().time_since_epoch())
+                                    .count();
+      TVMValue values[5];
+      int type_codes[5];
+      PackArgs(values, type_codes, static_cast<int>(DiscoAction::kSyncWorker), worker_id,
+               self->stats.num_commands, self->stats.busy_nanos, timestamp_nanos);
+      self->channel->Reply(TVMArgs(values, type_codes, 5));
     }
   }
 
@@ -169,6 +216,48 @@ struct DiscoWorker::Impl {
     }
   }
 
+  static void DefineCommandGraph(DiscoWorker* self, int64_t reg_id, const TVMArgs& args) {
+    ObjectPtr<DiscoCommandGraphObj> graph = make_object<DiscoCommandGraphObj>();
+    int64_t num_commands = args[0];
+    int k = 1;
+    for (int64_t i = 0; i < num_commands; ++i) {
+      int64_t num_args = args[k];
+      DiscoCommandGraphObj::Command command;
+      command.ret_reg_id = args[k + 1];
+      command.func_reg_id = args[k + 2];
+      k += 3;
+      // The packed sequence is only valid until the next message, so the arguments are copied.
+      command.args.resize(num_args);
+      for (int64_t j = 0; j < num_args; ++j) {
+        command.args[j] = args[k++];
+      }
+      graph->commands.push_back(std::move(command));
+    }
+    ICHECK_EQ(k, args.num_args);
+    GetReg(self, reg_id) = ObjectRef(std::move(graph));
+  }
+
+  static void ReplayCommandGraph(DiscoWorker* self, int64_t reg_id) {
+    ObjectRef obj = GetReg(self, reg_id);
+    const auto* graph = obj.as<DiscoCommandGraphObj>();
+    CHECK(graph) << "ValueError: Register " << reg_id << " does not hold a command graph";
+    std::vector<TVMValue> values;
+    std::vector<int> type_codes;
+    for (const DiscoCommandGraphObj::Command& command : graph->commands) {
+      PackedFunc func = GetReg(self, command.func_reg_id);
+      CHECK(func.defined());
+      int num_args = static_cast<int>(command.args.size());
+      values.resize(num_args);
+      type_codes.resize(num_args);
+      TVMArgsSetter setter(values.data(), type_codes.data());
+      for (int i = 0; i < num_args; ++i) {
+        setter(i, command.args[i]);
+      }
+      CallPacked(self, command.ret_reg_id, func,
+                 TVMArgs(values.data(), type_codes.data(), num_args));
+    }
+  }
+
   static void CallPacked(DiscoWorker* self, int64_t ret_reg_id, PackedFunc func,
                          const TVMArgs& args) {
     TVMValue* values = const_cast<TVMValue*>(args.values);
@@ -18,11 +18,13 @@
  */
 #include <tvm/runtime/registry.h>
 
+#include <memory>
 #include <numeric>
 
 #include "../../../support/socket.h"
 #include "../bcast_session.h"
 #include "../message_queue.h"
+#include "./transport.h"
 
 namespace tvm {
 namespace runtime {
@@ -38,25 +40,39 @@ enum class DiscoSocketAction {
 class DiscoSocketChannel : public DiscoChannel {
  public:
   explicit DiscoSocketChannel(const TCPSocket& socket)
-      : socket_(socket), message_queue_(&socket_) {}
+      : socket_(socket), message_queue_(std::make_unique<DiscoStreamMessageQueue>(&socket_)) {}
 
   DiscoSocketChannel(DiscoSocketChannel&& other) = delete;
   DiscoSocketChannel(const DiscoSocketChannel& other) = delete;
-  void Send(const TVMArgs& args) { message_queue_.Send(args); }
-  TVMArgs Recv() { return message_queue_.Recv(); }
-  void Reply(const TVMArgs& args) { message_queue_.Send(args); }
-  TVMArgs RecvReply() { return message_queue_.Recv(); }
+  void Send(const TVMArgs& args) { message_queue_->Send(args); }
+  TVMArgs Recv() { return message_queue_->Recv(); }
+  void Reply(const TVMArgs& args) { message_queue_->Send(args); }
+  TVMArgs RecvReply() { return message_queue_->Recv(); }
+
+  /*!
+   * \brief Switch the messages from the TCP socket to the given transport, which both ends
+   * of the channel should do after the same message.
+   */
+  void UseTransport(const std::string& transport) {
+    if (transport == "tcp") return;
+    transport_ = DiscoTransport::Connect(transport, static_cast<int>(socket_.sockfd));
+    message_queue_ = std::make_unique<DiscoStreamMessageQueue>(transport_.operator->());
+  }
 
  private:
   TCPSocket socket_;
-  DiscoStreamMessageQueue message_queue_;
+  DiscoTransport transport_{nullptr};
+  std::unique_ptr<DiscoStreamMessageQueue> message_queue_;
 };
 
 class SocketSessionObj : public BcastSessionObj {
  public:
   explicit SocketSessionObj(int num_nodes, int num_workers_per_node, int num_groups,
-                            const String& host, int port)
+                            const String& host, int port, const String& transport)
       : num_nodes_(num_nodes), num_workers_per_node_(num_workers_per_node) {
+    CHECK(transport == "tcp" ||
+          Registry::Get("runtime.disco.transport." + transport + ".connect") != nullptr)
+        << "ValueError: The transport `" << transport << "` of SocketSession is not enabled";
     const PackedFunc* f_create_local_session =
         Registry::Get("runtime.disco.create_socket_session_local_workers");
     ICHECK(f_create_local_session != nullptr)
@@ -74,12 +90,13 @@ class SocketSessionObj : public BcastSessionObj {
     socket_.Listen();
     LOG(INFO) << "SocketSession controller listening on " << host << ":" << port;
 
-    TVMValue values[4];
-    int type_codes[4];
+    TVMValue values[5];
+    int type_codes[5];
     TVMArgsSetter setter(values, type_codes);
     setter(0, num_nodes);
     setter(1, num_workers_per_node);
     setter(2, num_groups);
+    setter(4, transport);
 
     for (int i = 0; i + 1 < num_nodes; ++i) {
       SockAddr addr;
@@ -91,8 +108,10 @@ class SocketSessionObj : public BcastSessionObj {
       //  - num_workers_per_node
       //  - num_groups
       //  - node_id
-      remote_channels_.back()->Send(TVMArgs(values, type_codes, 4));
-      LOG(INFO) << "Remote node " << addr.AsString() << " connected";
+      //  - transport
+      remote_channels_.back()->Send(TVMArgs(values, type_codes, 5));
+      remote_channels_.back()->UseTransport(transport);
+      LOG(INFO) << "Remote node " << addr.AsString() << " connected over " << transport;
     }
   }
 
@@ -196,11 +215,12 @@ class SocketSessionObj : public BcastSessionObj {
     for (auto& channel : remote_channels_) {
       channel->Send(TVMArgs(values, type_codes, 2));
     }
+    // The transports may still use the sockets when closing.
+    remote_channels_.clear();
     for (auto& socket : remote_sockets_) {
       socket.Close();
     }
     remote_sockets_.clear();
-    remote_channels_.clear();
     if (!socket_.IsClosed()) {
       socket_.Close();
     }
@@ -220,6 +240,7 @@ class SocketSessionObj : public BcastSessionObj {
 };
 
 TVM_REGISTER_OBJECT_TYPE(SocketSessionObj);
+TVM_REGISTER_OBJECT_TYPE(DiscoTransportObj);
 
 class RemoteSocketSession {
  public:
@@ -234,12 +255,14 @@ class RemoteSocketSession {
     }
     channel_ = std::make_unique<DiscoSocketChannel>(socket_);
     TVMArgs metadata = channel_->Recv();
-    ICHECK_EQ(metadata.size(), 4);
+    ICHECK_EQ(metadata.size(), 5);
     num_nodes_ = metadata[0].operator int();
     num_workers_per_node_ = metadata[1].operator int();
     num_groups_ = metadata[2].operator int();
     node_id_ = metadata[3].operator int();
+    std::string transport = metadata[4];
     CHECK_GE(num_local_workers, num_workers_per_node_);
+    channel_->UseTransport(transport);
     InitLocalSession();
   }
 
@@ -276,6 +299,7 @@ class RemoteSocketSession {
   }
 
   ~RemoteSocketSession() {
+    channel_.reset();
     socket_.Close();
     Socket::Finalize();
   }
@@ -311,8 +335,9 @@ TVM_REGISTER_GLOBAL("runtime.disco.RemoteSocketSession")
     .set_body_typed(RemoteSocketSessionEntryPoint);
 
 Session SocketSession(int num_nodes, int num_workers_per_node, int num_groups, const String& host,
-                      int port) {
-  auto n = make_object<SocketSessionObj>(num_nodes, num_workers_per_node, num_groups, host, port);
+                      int port, const String& transport) {
+  auto n = make_object<SocketSessionObj>(num_nodes, num_workers_per_node, num_groups, host, port,
+                                         transport);
   return Session(n);
 }
 
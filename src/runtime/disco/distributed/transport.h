@@ -0,0 +1,81 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file transport.h
+ * \brief The pluggable transports of the messages between the controller of a SocketSession
+ *  and its remote nodes.
+ *
+ * The controller and a remote node always connect over TCP first, and agree on the transport
+ * there.  A transport other than "tcp" is created by the global function
+ * `runtime.disco.transport.<name>.connect`, which takes the file descriptor of the connected
+ * TCP socket to exchange its addressing information over, and returns a DiscoTransport.
+ * The socket stays open and owned by the session, and is closed after the transport.
+ */
+#ifndef TVM_RUNTIME_DISCO_DISTRIBUTED_TRANSPORT_H_
+#define TVM_RUNTIME_DISCO_DISTRIBUTED_TRANSPORT_H_
+
+#include <dmlc/io.h>
+#include <tvm/runtime/object.h>
+#include <tvm/runtime/registry.h>
+
+#include <string>
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief A reliable, ordered byte stream to the other end of a SocketSession connection. */
+class DiscoTransportObj : public Object, public dmlc::Stream {
+ public:
+  /*! \brief Read exactly `size` bytes, returning less only if the other end is closed. */
+  virtual size_t Read(void* ptr, size_t size) = 0;
+  /*! \brief Write exactly `size` bytes. */
+  virtual size_t Write(const void* ptr, size_t size) = 0;
+
+  static constexpr const char* _type_key = "runtime.disco.Transport";
+  TVM_DECLARE_BASE_OBJECT_INFO(DiscoTransportObj, Object);
+};
+
+/*!
+ * \brief Managed reference to DiscoTransportObj.
+ * \sa DiscoTransportObj
+ */
+class DiscoTransport : public ObjectRef {
+ public:
+  /*!
+   * \brief Connect the transport of the given name over a connected TCP socket.
+   * \param name The name of the transport, other than "tcp".
+   * \param sockfd The file descriptor of the socket, which is not taken over.
+   */
+  static DiscoTransport Connect(const std::string& name, int sockfd) {
+    std::string pf_name = "runtime.disco.transport." + name + ".connect";
+    const PackedFunc* pf = Registry::Get(pf_name);
+    CHECK(pf != nullptr) << "ValueError: The transport `" << name << "` of SocketSession is not "
+                         << "enabled, because `" << pf_name << "` does not exist. "
+                         << "Please check if TVM is built with the library of the transport";
+    ObjectRef transport = (*pf)(sockfd);
+    return Downcast<DiscoTransport>(transport);
+  }
+
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(DiscoTransport, ObjectRef, DiscoTransportObj);
+};
+
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_DISCO_DISTRIBUTED_TRANSPORT_H_
@@ -0,0 +1,144 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file ucx_transport.cc
+ * \brief The UCX transport of SocketSession, which sends the messages over the stream API of
+ *  UCX, and hence over RDMA (e.g. InfiniBand or RoCE) when available.
+ *
+ * The two ends exchange the addresses of their UCX workers over the TCP socket, and each creates
+ * an endpoint to the other.  UCX chooses the transport, which can be restricted as usual by the
+ * UCX_TLS environment variable, and caches the memory registration of the message buffers.
+ */
+#include <ucp/api/ucp.h>
+
+#include <string>
+
+#include "../../../../support/socket.h"
+#include "../transport.h"
+
+namespace tvm {
+namespace runtime {
+
+#define UCX_CALL(cmd)                                                       \
+  do {                                                                      \
+    ucs_status_t status = (cmd);                                            \
+    CHECK_EQ(status, UCS_OK) << "UCX Error: " << ucs_status_string(status); \
+  } while (0)
+
+class UCXTransportObj : public DiscoTransportObj {
+ public:
+  explicit UCXTransportObj(int sockfd) {
+    ucp_config_t* config;
+    UCX_CALL(ucp_config_read(nullptr, nullptr, &config));
+    ucp_params_t params;
+    params.field_mask = UCP_PARAM_FIELD_FEATURES;
+    params.features = UCP_FEATURE_STREAM;
+    ucs_status_t status = ucp_init(&params, config, &context_);
+    ucp_config_release(config);
+    UCX_CALL(status);
+
+    ucp_worker_params_t worker_params;
+    worker_params.field_mask = UCP_WORKER_PARAM_FIELD_THREAD_MODE;
+    worker_params.thread_mode = UCS_THREAD_MODE_SINGLE;
+    UCX_CALL(ucp_worker_create(context_, &worker_params, &worker_));
+
+    // Exchange the worker addresses over the TCP socket, which both ends send first.
+    ucp_address_t* address;
+    size_t address_length;
+    UCX_CALL(ucp_worker_get_address(worker_, &address, &address_length));
+    support::TCPSocket socket(sockfd);
+    socket.SendBytes(std::string(reinterpret_cast<const char*>(address), address_length));
+    ucp_worker_release_address(worker_, address);
+    std::string remote_address = socket.RecvBytes();
+
+    ucp_ep_params_t ep_params;
+    ep_params.field_mask = UCP_EP_PARAM_FIELD_REMOTE_ADDRESS;
+    ep_params.address = reinterpret_cast<const ucp_address_t*>(remote_address.data());
+    UCX_CALL(ucp_ep_create(worker_, &ep_params, &ep_));
+  }
+
+  ~UCXTransportObj() {
+    ucp_request_param_t param;
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags = UCP_EP_CLOSE_FLAG_FORCE;
+    ucs_status_ptr_t request = ucp_ep_close_nbx(ep_, &param);
+    if (UCS_PTR_IS_PTR(request)) {
+      while (ucp_request_check_status(request) == UCS_INPROGRESS) {
+        ucp_worker_progress(worker_);
+      }
+      ucp_request_free(request);
+    }
+    ucp_worker_destroy(worker_);
+    ucp_cleanup(context_);
+  }
+
+  size_t Read(void* ptr, size_t size) final {
+    ucp_request_param_t param;
+    param.op_attr_mask = UCP_OP_ATTR_FIELD_FLAGS;
+    param.flags = UCP_STREAM_RECV_FLAG_WAITALL;
+    size_t nread = 0;
+    ucs_status_ptr_t request = ucp_stream_recv_nbx(ep_, ptr, size, &nread, &param);
+    if (request == nullptr) return nread;
+    // An error, e.g. the other end closing, ends the stream.
+    ucs_status_t status = Wait(request);
+    if (status == UCS_OK) {
+      UCX_CALL(ucp_stream_recv_request_test(request, &nread));
+    }
+    if (UCS_PTR_IS_PTR(request)) ucp_request_free(request);
+    return status == UCS_OK ? nread : 0;
+  }
+
+  size_t Write(const void* ptr, size_t size) final {
+    ucp_request_param_t param;
+    param.op_attr_mask = 0;
+    ucs_status_ptr_t request = ucp_stream_send_nbx(ep_, ptr, size, &param);
+    if (request != nullptr) {
+      UCX_CALL(Wait(request));
+      ucp_request_free(request);
+    }
+    return size;
+  }
+
+  static constexpr const char* _type_key = "runtime.disco.UCXTransport";
+  TVM_DECLARE_FINAL_OBJECT_INFO(UCXTransportObj, DiscoTransportObj);
+
+ private:
+  /*! \brief Progress the worker until the request completes, and return its status. */
+  ucs_status_t Wait(ucs_status_ptr_t request) {
+    if (UCS_PTR_IS_ERR(request)) return UCS_PTR_STATUS(request);
+    ucs_status_t status;
+    while ((status = ucp_request_check_status(request)) == UCS_INPROGRESS) {
+      ucp_worker_progress(worker_);
+    }
+    return status;
+  }
+
+  ucp_context_h context_;
+  ucp_worker_h worker_;
+  ucp_ep_h ep_;
+};
+
+TVM_REGISTER_OBJECT_TYPE(UCXTransportObj);
+
+TVM_REGISTER_GLOBAL("runtime.disco.transport.ucx.connect").set_body_typed([](int sockfd) {
+  return DiscoTransport(make_object<UCXTransportObj>(sockfd));
+});
+
+}  // namespace runtime
+}  // namespace tvm
@@ -28,6 +28,8 @@
 #include <tvm/runtime/relax_vm/ndarray_cache_support.h>
 
 #include <functional>
+#include <future>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <unordered_map>
@@ -126,6 +128,15 @@ class ShardLoaderObj : public Object {
   /*! \brief Load all the parameters */
   Array<NDArray> LoadAll() const;
 
+  /*!
+   * \brief Load the i-th parameter on every worker from the file directly, without the scatter
+   * or broadcast from worker 0.
+   */
+  NDArray LoadSharded(int weight_index) const;
+
+  /*! \brief Load all the parameters on every worker from the files directly */
+  Array<NDArray> LoadAllSharded() const;
+
   NDArray ApplyShardFunc(const ShardInfo::ShardFunc& shard_func, const NDArray& param) const;
 
   /*! \brief Load all the pre-sharded parameters */
@@ -159,8 +170,29 @@ class ShardLoaderObj : public Object {
   mutable const FileRecord* current_file_;
   /*! \brief The context of the current file to be loaded from */
   mutable std::string current_file_stream_;
+  /*! \brief The file being prefetched in the background */
+  mutable const FileRecord* next_file_ = nullptr;
+  /*! \brief The buffer the next file is prefetched into */
+  mutable std::string next_file_stream_;
+  /*! \brief The file mapped into memory by `LoadSharded` */
+  mutable const FileRecord* mapped_file_ = nullptr;
+  /*! \brief The start of the mapped file */
+  mutable char* mapped_data_ = nullptr;
+  /*! \brief The owner of the mapping of the file */
+  mutable std::shared_ptr<void> mapped_holder_;
+  /*! \brief The pending read of the next file, declared last so it is joined first */
+  mutable std::future<void> next_file_future_;
 
  private:
+  /*!
+   * \brief Make the given file the current one, and start prefetching the
+   * file that follows it in the metadata.
+   *
+   * Parameters are loaded in the order they are stored, so reading the next
+   * shard file overlaps with copying and sharding the current one.
+   */
+  void SwitchToFile(const FileRecord* file) const;
+
   /*! \brief Load the i-th parameter without post-processing
    *
    * This function should not be called externally, as it does not
@@ -239,6 +271,37 @@ std::string GetSiblingPath(const std::string& path, const std::string& filename)
   LOG(FATAL) << "ValueError: Cannot find the parent directory: " << path;
 }
 
+void ShardLoaderObj::SwitchToFile(const FileRecord* file) const {
+  if (file == current_file_) {
+    return;
+  }
+  bool prefetched = false;
+  if (next_file_future_.valid()) {
+    try {
+      next_file_future_.get();
+      prefetched = file == next_file_;
+    } catch (const dmlc::Error&) {
+      // A failed prefetch is reported when the file is read again below.
+    }
+  }
+  if (prefetched) {
+    std::swap(current_file_stream_, next_file_stream_);
+  } else {
+    std::string file_name = GetSiblingPath(this->metadata_.path, file->data_path);
+    LoadBinaryFromFile(file_name, &this->current_file_stream_);
+  }
+  current_file_ = file;
+  next_file_ = nullptr;
+  size_t file_index = file - metadata_.records.data();
+  if (file_index + 1 < metadata_.records.size()) {
+    next_file_ = &metadata_.records[file_index + 1];
+    std::string file_name = GetSiblingPath(this->metadata_.path, next_file_->data_path);
+    next_file_future_ = std::async(std::launch::async, [this, file_name]() {
+      LoadBinaryFromFile(file_name, &this->next_file_stream_);
+    });
+  }
+}
+
 NDArray ShardLoaderObj::LoadParamOnWorker0(int weight_index) const {
   DiscoWorker* worker = DiscoWorker::ThreadLocal();
   int worker_id = worker->worker_id;
@@ -249,11 +312,7 @@ NDArray ShardLoaderObj::LoadParamOnWorker0(int weight_index) const {
   const FileRecord* file = param_info.file;
 
   auto load = [this, param, device, file]() {
-    if (file != current_file_) {
-      current_file_ = file;
-      std::string file_name = GetSiblingPath(this->metadata_.path, file->data_path);
-      LoadBinaryFromFile(file_name, &this->current_file_stream_);
-    }
+    SwitchToFile(file);
     return param->Load(device, &this->current_file_stream_);
   };
 
@@ -296,11 +355,7 @@ NDArray ShardLoaderObj::LoadDirect(int weight_index) const {
   DiscoWorker* worker = DiscoWorker::ThreadLocal();
   Device device = worker->default_device;
 
-  if (file != current_file_) {
-    current_file_ = file;
-    std::string file_name = GetSiblingPath(this->metadata_.path, file->data_path);
-    LoadBinaryFromFile(file_name, &this->current_file_stream_);
-  }
+  SwitchToFile(file);
   return param->Load(device, &this->current_file_stream_);
 }
 
@@ -344,6 +399,66 @@ NDArray ShardLoaderObj::Load(int weight_index) const {
   }
 }
 
+NDArray ShardLoaderObj::LoadSharded(int weight_index) const {
+  DiscoWorker* worker = DiscoWorker::ThreadLocal();
+  int worker_id = worker->worker_id;
+  int num_shards = worker->num_workers;
+  Device device = worker->default_device;
+  const ParamInfo& param_info = param_info_.at(weight_index);
+  const FileRecord* file = param_info.file;
+
+  if (file != mapped_file_) {
+    // All workers map the same file, so the pages are read from disk once, and each worker only
+    // touches the bytes of the parameters it loads.
+    std::string file_name = GetSiblingPath(this->metadata_.path, file->data_path);
+    size_t size = 0;
+    mapped_holder_ = MapBinaryFile(file_name, &mapped_data_, &size);
+    CHECK(mapped_holder_ == nullptr || static_cast<int64_t>(size) == file->nbytes)
+        << "ValueError: Encountered an corrupted parameter shard. It means it is not downloaded "
+           "completely or downloading is interrupted. Please try to download again.";
+    mapped_file_ = mapped_holder_ != nullptr ? file : nullptr;
+  }
+  if (mapped_file_ == nullptr) {
+    // Memory mapping is not supported, and worker 0 reads the file for all.
+    return Load(weight_index);
+  }
+
+  NDArray w = param_info.param->LoadFromBytes(device, mapped_data_);
+  if (param_info.shard_info.funcs.empty()) {
+    return w;
+  }
+  for (const ShardInfo::ShardFunc& shard_func : param_info.shard_info.funcs) {
+    w = this->ApplyShardFunc(shard_func, w);
+  }
+  ShapeTuple shape = w.Shape();
+  ICHECK(shape.size() >= 1 && shape[0] == num_shards)
+      << "ValueError: The first dimension of the "
+      << "output shape must be equal to the "
+      << "number of shards, but got: " << shape << " and num_shards = " << num_shards;
+  ShapeTuple shard_shape(shape.begin() + 1, shape.end());
+  uint64_t shard_nbytes = GetDataSize(*w.operator->()) / num_shards;
+  NDArray shard = NDArray::Empty(shard_shape, w->dtype, device);
+  shard.CopyFrom(w.CreateView(shard_shape, w->dtype, worker_id * shard_nbytes));
+  return shard;
+}
+
+Array<NDArray> ShardLoaderObj::LoadAllSharded() const {
+  int n = static_cast<int>(param_info_.size());
+  Array<NDArray> shards;
+  shards.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    std::string param_name = "param_" + std::to_string(i);
+    ICHECK(this->param_name_to_index_.count(param_name));
+    int shard_id = this->param_name_to_index_.at(param_name);
+    shards.push_back(this->LoadSharded(shard_id));
+  }
+  // Release the mapping once everything is loaded.
+  mapped_file_ = nullptr;
+  mapped_data_ = nullptr;
+  mapped_holder_.reset();
+  return shards;
+}
+
 Array<NDArray> ShardLoaderObj::LoadAll() const {
   int n = static_cast<int>(param_info_.size());
   Array<NDArray> shards;
@@ -422,6 +537,22 @@ TVM_REGISTER_GLOBAL("runtime.disco.ShardLoaderLoadPresharded")
       return loader->LoadPresharded(IntegerFromShapeTuple(weight_index));
     });
 
+TVM_REGISTER_GLOBAL("runtime.disco.ShardLoaderLoadSharded")
+    .set_body_typed([](ObjectRef loader_obj, ShapeTuple weight_index) {
+      const auto* loader = loader_obj.as<ShardLoaderObj>();
+      CHECK(loader != nullptr) << "TypeError: Expected ShardLoaderObj, but gets: "
+                               << loader_obj->GetTypeKey();
+      return loader->LoadSharded(IntegerFromShapeTuple(weight_index));
+    });
+
+TVM_REGISTER_GLOBAL("runtime.disco.ShardLoaderLoadAllSharded")
+    .set_body_typed([](ObjectRef loader_obj) {
+      const auto* loader = loader_obj.as<ShardLoaderObj>();
+      CHECK(loader != nullptr) << "TypeError: Expected ShardLoaderObj, but gets: "
+                               << loader_obj->GetTypeKey();
+      return loader->LoadAllSharded();
+    });
+
 TVM_REGISTER_GLOBAL("runtime.disco.ShardLoaderLoadAll").set_body_typed([](ObjectRef loader_obj) {
   const auto* loader = loader_obj.as<ShardLoaderObj>();
   CHECK(loader != nullptr) << "TypeError: Expected ShardLoaderObj, but gets: "
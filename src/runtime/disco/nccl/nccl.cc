@@ -17,8 +17,10 @@
  * under the License.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <mutex>
+#include <numeric>
 #include <sstream>
 #include <vector>
 
@@ -117,11 +119,11 @@ void InitCCLPerWorker(IntTuple device_ids, std::string unique_id_bytes) {
   }
 }
 
-void AllReduce(NDArray send, ReduceKind reduce_kind, bool in_group, NDArray recv) {
+void AllReduceOnStream(NDArray send, ReduceKind reduce_kind, bool in_group, NDArray recv,
+                       deviceStream_t stream) {
   CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
   ShapeTuple shape = send.Shape();
   int64_t numel = shape->Product();
-  deviceStream_t stream = ctx->GetDefaultStream();
   DataType dtype = DataType(send->dtype);
   if (dtype == DataType::NVFloat8E4M3() || dtype == DataType::NVFloat8E5M2()) {
     LOG(FATAL) << "Float8 data type cannot be allreduced, as nccl does not support this data type.";
@@ -132,16 +134,167 @@ void AllReduce(NDArray send, ReduceKind reduce_kind, bool in_group, NDArray recv
                           in_group ? ctx->group_comm : ctx->global_comm, stream));
 }
 
-void AllGather(NDArray send, bool in_group, NDArray recv) {
+void AllReduce(NDArray send, ReduceKind reduce_kind, bool in_group, NDArray recv) {
+  AllReduceOnStream(send, reduce_kind, in_group, recv,
+                    CCLThreadLocalContext::Get()->GetDefaultStream());
+}
+
+void AllGatherOnStream(NDArray send, bool in_group, NDArray recv, deviceStream_t stream) {
   CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
   ShapeTuple shape = send.Shape();
   int64_t numel = shape->Product();
-  deviceStream_t stream = ctx->GetDefaultStream();
   NCCL_CALL(ncclAllGather(send->data, recv->data, numel,
                           /*datatype=*/AsNCCLDataType(DataType(send->dtype)),
                           in_group ? ctx->group_comm : ctx->global_comm, stream));
 }
 
+void AllGather(NDArray send, bool in_group, NDArray recv) {
+  AllGatherOnStream(send, in_group, recv, CCLThreadLocalContext::Get()->GetDefaultStream());
+}
+
+/*!
+ * \brief Launch a collective on the communication stream, after the work issued so far on the
+ * compute stream, and record it as pending until WaitCollective is called on its output.
+ */
+template <typename FLaunch>
+void LaunchAsync(NDArray send, NDArray recv, FLaunch launch) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  CHECK(!ctx->pending_collectives.count(recv->data))
+      << "ValueError: The output buffer is already used by a pending collective";
+  deviceStream_t comm_stream = ctx->GetCommStream();
+  EventRecord(ctx->inputs_ready, ctx->GetDefaultStream());
+  StreamWaitEvent(comm_stream, ctx->inputs_ready);
+  launch(comm_stream);
+  deviceEvent_t done = ctx->AcquireEvent();
+  EventRecord(done, comm_stream);
+  ctx->pending_collectives[recv->data] = PendingCollective{done, send, recv};
+}
+
+void AllReduceAsync(NDArray send, ReduceKind reduce_kind, bool in_group, NDArray recv) {
+  LaunchAsync(send, recv, [&](deviceStream_t stream) {
+    AllReduceOnStream(send, reduce_kind, in_group, recv, stream);
+  });
+}
+
+void AllGatherAsync(NDArray send, bool in_group, NDArray recv) {
+  LaunchAsync(send, recv,
+              [&](deviceStream_t stream) { AllGatherOnStream(send, in_group, recv, stream); });
+}
+
+void RingExchangeOnStream(NDArray send, NDArray recv, deviceStream_t stream) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  int worker_id = ctx->worker->worker_id;
+  int group_size = ctx->worker->num_workers / ctx->worker->num_groups;
+  int group_start = worker_id - worker_id % group_size;
+  int next_id = group_start + (worker_id - group_start + 1) % group_size;
+  int prev_id = group_start + (worker_id - group_start + group_size - 1) % group_size;
+  int64_t numel = send.Shape()->Product();
+  CHECK_EQ(numel, recv.Shape()->Product())
+      << "ValueError: The buffers of a ring exchange should have the same number of elements";
+  // Grouped, so that the workers in the ring do not deadlock on each other.
+  NCCL_CALL(ncclGroupStart());
+  NCCL_CALL(ncclSend(send->data, numel, AsNCCLDataType(DataType(send->dtype)), next_id,
+                     ctx->global_comm, stream));
+  NCCL_CALL(ncclRecv(recv->data, numel, AsNCCLDataType(DataType(recv->dtype)), prev_id,
+                     ctx->global_comm, stream));
+  NCCL_CALL(ncclGroupEnd());
+}
+
+void RingExchange(NDArray send, NDArray recv) {
+  RingExchangeOnStream(send, recv, CCLThreadLocalContext::Get()->GetDefaultStream());
+}
+
+void RingExchangeAsync(NDArray send, NDArray recv) {
+  LaunchAsync(send, recv, [&](deviceStream_t stream) { RingExchangeOnStream(send, recv, stream); });
+}
+
+void AllToAll(NDArray send, bool in_group, NDArray recv) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  int num_peers = in_group ? ctx->worker->num_workers / ctx->worker->num_groups
+                           : ctx->worker->num_workers;
+  int64_t numel = send.Shape()->Product();
+  CHECK_EQ(numel, recv.Shape()->Product())
+      << "ValueError: The buffers of an alltoall should have the same number of elements";
+  CHECK_EQ(numel % num_peers, 0) << "ValueError: The alltoall requires the number of elements to "
+                                 << "be divisible by the number of workers, but got numel = "
+                                 << numel << " and " << num_peers << " workers";
+  DataType dtype(send->dtype);
+  int64_t numel_per_shard = numel / num_peers;
+  int64_t bytes_per_shard = numel_per_shard * dtype.bytes();
+  ncclComm_t comm = in_group ? ctx->group_comm : ctx->global_comm;
+  deviceStream_t stream = ctx->GetDefaultStream();
+  const uint8_t* send_data = static_cast<const uint8_t*>(send->data);
+  uint8_t* recv_data = static_cast<uint8_t*>(recv->data);
+  NCCL_CALL(ncclGroupStart());
+  for (int i = 0; i < num_peers; ++i) {
+    NCCL_CALL(ncclSend(send_data + i * bytes_per_shard, numel_per_shard, AsNCCLDataType(dtype), i,
+                       comm, stream));
+    NCCL_CALL(ncclRecv(recv_data + i * bytes_per_shard, numel_per_shard, AsNCCLDataType(dtype), i,
+                       comm, stream));
+  }
+  NCCL_CALL(ncclGroupEnd());
+}
+
+void AllToAllV(NDArray send, ShapeTuple send_counts, ShapeTuple recv_counts, bool in_group,
+               NDArray recv) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  int num_peers = in_group ? ctx->worker->num_workers / ctx->worker->num_groups
+                           : ctx->worker->num_workers;
+  CHECK_EQ(send_counts.size(), num_peers)
+      << "ValueError: The alltoallv expects one send count per worker, but got "
+      << send_counts.size() << " counts and " << num_peers << " workers";
+  CHECK_EQ(recv_counts.size(), num_peers)
+      << "ValueError: The alltoallv expects one recv count per worker, but got "
+      << recv_counts.size() << " counts and " << num_peers << " workers";
+  CHECK_GE(send->ndim, 1) << "ValueError: The alltoallv does not support scalars";
+  CHECK_GE(recv->ndim, 1) << "ValueError: The alltoallv does not support scalars";
+  // The counts are in rows, i.e. slices along the first axis.
+  DataType dtype(send->dtype);
+  int64_t send_row_numel = send.Shape()->Product() / std::max<int64_t>(send->shape[0], 1);
+  int64_t recv_row_numel = recv.Shape()->Product() / std::max<int64_t>(recv->shape[0], 1);
+  CHECK_EQ(send_row_numel, recv_row_numel)
+      << "ValueError: The rows of the buffers of an alltoallv should have the same size";
+  int64_t total_send = std::accumulate(send_counts.begin(), send_counts.end(), int64_t(0));
+  int64_t total_recv = std::accumulate(recv_counts.begin(), recv_counts.end(), int64_t(0));
+  CHECK_LE(total_send, send->shape[0]) << "ValueError: The send counts sum to " << total_send
+                                       << " rows, more than the " << send->shape[0] << " rows "
+                                       << "of buffer `send`";
+  CHECK_LE(total_recv, recv->shape[0]) << "ValueError: The recv counts sum to " << total_recv
+                                       << " rows, more than the " << recv->shape[0] << " rows "
+                                       << "of buffer `recv`";
+  int64_t bytes_per_row = send_row_numel * dtype.bytes();
+  ncclComm_t comm = in_group ? ctx->group_comm : ctx->global_comm;
+  deviceStream_t stream = ctx->GetDefaultStream();
+  const uint8_t* send_data = static_cast<const uint8_t*>(send->data);
+  uint8_t* recv_data = static_cast<uint8_t*>(recv->data);
+  NCCL_CALL(ncclGroupStart());
+  for (int i = 0; i < num_peers; ++i) {
+    if (send_counts[i] > 0) {
+      NCCL_CALL(ncclSend(send_data, send_counts[i] * send_row_numel, AsNCCLDataType(dtype), i,
+                         comm, stream));
+    }
+    if (recv_counts[i] > 0) {
+      NCCL_CALL(ncclRecv(recv_data, recv_counts[i] * recv_row_numel, AsNCCLDataType(dtype), i,
+                         comm, stream));
+    }
+    send_data += send_counts[i] * bytes_per_row;
+    recv_data += recv_counts[i] * bytes_per_row;
+  }
+  NCCL_CALL(ncclGroupEnd());
+}
+
+void WaitCollective(NDArray recv) {
+  CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
+  auto it = ctx->pending_collectives.find(recv->data);
+  if (it == ctx->pending_collectives.end()) {
+    // The collective has been waited for, or completed by SyncWorker.
+    return;
+  }
+  StreamWaitEvent(ctx->GetDefaultStream(), it->second.done);
+  ctx->free_events.push_back(it->second.done);
+  ctx->pending_collectives.erase(it);
+}
+
 void BroadcastFromWorker0(Optional<NDArray> send, bool in_group, NDArray recv) {
   CCLThreadLocalContext* ctx = CCLThreadLocalContext::Get();
   int worker_id = ctx->worker->worker_id;
@@ -326,6 +479,10 @@ void SyncWorker() {
   ICHECK(ctx->worker != nullptr);
   deviceStream_t stream = ctx->GetDefaultStream();
   StreamSynchronize(stream);
+  if (ctx->comm_stream != nullptr) {
+    StreamSynchronize(ctx->comm_stream);
+    ctx->ClearPendingCollectives();
+  }
 }
 
 TVM_REGISTER_GLOBAL("runtime.disco.compiled_ccl").set_body_typed([]() -> String {
@@ -343,6 +500,23 @@ TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".allgather")
     .set_body_typed([](NDArray send, bool in_group, NDArray recv) {
       nccl::AllGather(send, in_group, recv);
     });
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".allreduce_async")
+    .set_body_typed([](NDArray send, int kind, bool in_group, NDArray recv) {
+      CHECK(0 <= kind && kind <= 4) << "ValueError: Unknown ReduceKind: " << kind;
+      nccl::AllReduceAsync(send, static_cast<ReduceKind>(kind), in_group, recv);
+    });
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".allgather_async")
+    .set_body_typed([](NDArray send, bool in_group, NDArray recv) {
+      nccl::AllGatherAsync(send, in_group, recv);
+    });
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".ring_exchange")
+    .set_body_typed(RingExchange);
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".ring_exchange_async")
+    .set_body_typed(RingExchangeAsync);
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".alltoall").set_body_typed(AllToAll);
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".alltoallv").set_body_typed(AllToAllV);
+TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".wait_collective")
+    .set_body_typed(WaitCollective);
 TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".broadcast_from_worker0")
     .set_body_typed(BroadcastFromWorker0);
 TVM_REGISTER_GLOBAL("runtime.disco." TVM_DISCO_CCL_NAME ".scatter_from_worker0")
@@ -26,6 +26,9 @@
 #include <tvm/runtime/disco/session.h>
 #include <tvm/runtime/registry.h>
 
+#include <unordered_map>
+#include <vector>
+
 #include "../../../support/process_id.h"
 #include "../utils.h"
 
@@ -61,11 +64,25 @@ namespace nccl {
 #define TVM_DISCO_CCL_NAME "nccl"
 
 using deviceStream_t = cudaStream_t;
+using deviceEvent_t = cudaEvent_t;
 const constexpr DLDeviceType TVM_DISCO_DEVICE_TYPE = DLDeviceType::kDLCUDA;
 inline void SetDevice(int device_id) { CUDA_CALL(cudaSetDevice(device_id)); }
 inline void StreamSynchronize(deviceStream_t stream) { CUDA_CALL(cudaStreamSynchronize(stream)); }
 inline void StreamCreate(deviceStream_t* stream) { CUDA_CALL(cudaStreamCreate(stream)); }
+inline void StreamCreateNonBlocking(deviceStream_t* stream) {
+  CUDA_CALL(cudaStreamCreateWithFlags(stream, cudaStreamNonBlocking));
+}
 inline void StreamDestroy(deviceStream_t stream) { CUDA_CALL(cudaStreamDestroy(stream)); }
+inline void EventCreate(deviceEvent_t* event) {
+  CUDA_CALL(cudaEventCreateWithFlags(event, cudaEventDisableTiming));
+}
+inline void EventRecord(deviceEvent_t event, deviceStream_t stream) {
+  CUDA_CALL(cudaEventRecord(event, stream));
+}
+inline void StreamWaitEvent(deviceStream_t stream, deviceEvent_t event) {
+  CUDA_CALL(cudaStreamWaitEvent(stream, event, 0));
+}
+inline void EventDestroy(deviceEvent_t event) { CUDA_CALL(cudaEventDestroy(event)); }
 
 #else
 
@@ -73,11 +90,25 @@ inline void StreamDestroy(deviceStream_t stream) { CUDA_CALL(cudaStreamDestroy(s
 #define TVM_DISCO_CCL_NAME "rccl"
 
 using deviceStream_t = hipStream_t;
+using deviceEvent_t = hipEvent_t;
 const constexpr DLDeviceType TVM_DISCO_DEVICE_TYPE = DLDeviceType::kDLROCM;
 inline void SetDevice(int device_id) { ROCM_CALL(hipSetDevice(device_id)); }
 inline void StreamSynchronize(deviceStream_t stream) { ROCM_CALL(hipStreamSynchronize(stream)); }
 inline void StreamCreate(deviceStream_t* stream) { ROCM_CALL(hipStreamCreate(stream)); }
+inline void StreamCreateNonBlocking(deviceStream_t* stream) {
+  ROCM_CALL(hipStreamCreateWithFlags(stream, hipStreamNonBlocking));
+}
 inline void StreamDestroy(deviceStream_t stream) { ROCM_CALL(hipStreamDestroy(stream)); }
+inline void EventCreate(deviceEvent_t* event) {
+  ROCM_CALL(hipEventCreateWithFlags(event, hipEventDisableTiming));
+}
+inline void EventRecord(deviceEvent_t event, deviceStream_t stream) {
+  ROCM_CALL(hipEventRecord(event, stream));
+}
+inline void StreamWaitEvent(deviceStream_t stream, deviceEvent_t event) {
+  ROCM_CALL(hipStreamWaitEvent(stream, event, 0));
+}
+inline void EventDestroy(deviceEvent_t event) { ROCM_CALL(hipEventDestroy(event)); }
 
 #endif
 
@@ -120,16 +151,71 @@ inline ncclDataType_t AsNCCLDataType(runtime::DataType dtype) {
   throw;
 }
 
+/*! \brief An asynchronous collective that the compute stream has not waited for yet. */
+struct PendingCollective {
+  /*! \brief The event recorded on the communication stream after the collective. */
+  deviceEvent_t done;
+  /*! \brief The buffers of the collective, kept alive until it is waited for. */
+  NDArray send;
+  NDArray recv;
+};
+
 struct CCLThreadLocalContext {
   DiscoWorker* worker = nullptr;
   int device_id;
   deviceStream_t default_stream = nullptr;
   ncclComm_t global_comm = nullptr;
   ncclComm_t group_comm = nullptr;
+  /*! \brief The stream of the asynchronous collectives, created upon first use. */
+  deviceStream_t comm_stream = nullptr;
+  /*! \brief The event the communication stream waits on for the inputs of a collective. */
+  deviceEvent_t inputs_ready = nullptr;
+  /*! \brief The pending asynchronous collectives, indexed by the data of their outputs. */
+  std::unordered_map<const void*, PendingCollective> pending_collectives;
+  /*! \brief The events of the collectives that have been waited for, free to reuse. */
+  std::vector<deviceEvent_t> free_events;
 
   ~CCLThreadLocalContext() { Clear(); }
 
+  deviceStream_t GetCommStream() {
+    if (comm_stream == nullptr) {
+      StreamCreateNonBlocking(&comm_stream);
+      EventCreate(&inputs_ready);
+    }
+    return comm_stream;
+  }
+
+  deviceEvent_t AcquireEvent() {
+    deviceEvent_t event;
+    if (free_events.empty()) {
+      EventCreate(&event);
+    } else {
+      event = free_events.back();
+      free_events.pop_back();
+    }
+    return event;
+  }
+
+  void ClearPendingCollectives() {
+    for (auto& kv : pending_collectives) {
+      free_events.push_back(kv.second.done);
+    }
+    pending_collectives.clear();
+  }
+
   void Clear() {
+    if (comm_stream) {
+      StreamSynchronize(comm_stream);
+      ClearPendingCollectives();
+      for (deviceEvent_t event : free_events) {
+        EventDestroy(event);
+      }
+      free_events.clear();
+      EventDestroy(inputs_ready);
+      inputs_ready = nullptr;
+      StreamDestroy(comm_stream);
+      comm_stream = nullptr;
+    }
     if (group_comm) {
       NCCL_CALL(ncclCommDestroy(group_comm));
       if (global_comm == group_comm) {
@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file numa.cc
+ * \brief Placement of the disco workers on the NUMA node nearest to their device.
+ */
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/disco/disco_worker.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief The NUMA node nearest to a device, from the PCIe topology of Linux.
+ * \return The node, or -1 if unknown, e.g. for the CPU or on hosts of a single node.
+ */
+int DeviceNUMANode(Device device) {
+  if (device.device_type == kDLCPU) return -1;
+  std::string name = DLDeviceType2Str(device.device_type);
+  const PackedFunc* f_pci_bus_id = Registry::Get("runtime." + name + ".pci_bus_id");
+  if (f_pci_bus_id == nullptr) return -1;
+  std::string bus_id = (*f_pci_bus_id)(device.device_id).operator String();
+  std::transform(bus_id.begin(), bus_id.end(), bus_id.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  std::ifstream fin("/sys/bus/pci/devices/" + bus_id + "/numa_node");
+  int node = -1;
+  if (!(fin >> node)) return -1;
+  return node;
+}
+
+/*! \brief The CPUs of a NUMA node, from its cpulist in Linux, e.g. "0-23,48-71". */
+std::vector<int64_t> NUMANodeCPUs(int node) {
+  std::ifstream fin("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+  std::string cpulist;
+  std::vector<int64_t> cpus;
+  if (!std::getline(fin, cpulist)) return cpus;
+  std::stringstream ss(cpulist);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) continue;
+    size_t dash = range.find('-');
+    int64_t begin = std::stoll(range.substr(0, dash));
+    int64_t end = dash == std::string::npos ? begin : std::stoll(range.substr(dash + 1));
+    for (int64_t cpu = begin; cpu <= end; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+/*!
+ * \brief Pin the current worker to the CPUs of the NUMA node nearest to its default device, and
+ * make the node preferred for the memory it allocates, e.g. the pinned host staging buffers of
+ * its transfers, which are then local to the node.
+ * \return The node, or -1 if unknown, in which case the worker is left as is.
+ */
+int BindWorkerToNUMANode() {
+  int node = DeviceNUMANode(DiscoWorker::ThreadLocal()->default_device);
+  if (node < 0) return -1;
+  std::vector<int64_t> cpus = NUMANodeCPUs(node);
+  if (cpus.empty()) return -1;
+  const PackedFunc* f_set_thread_affinity =
+      Registry::Get("tvm.runtime.threading.set_current_thread_affinity");
+  ICHECK_NOTNULL(f_set_thread_affinity);
+  (*f_set_thread_affinity)(IntTuple(cpus));
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+  // MPOL_PREFERRED of <linux/mempolicy.h>, which falls back to the other nodes when it is full.
+  constexpr int kMPolPreferred = 1;
+  constexpr int kBitsPerWord = 8 * sizeof(unsigned long);  // NOLINT(runtime/int)
+  std::vector<unsigned long> mask(node / kBitsPerWord + 1, 0);  // NOLINT(runtime/int)
+  mask[node / kBitsPerWord] |= 1UL << (node % kBitsPerWord);
+  if (syscall(SYS_set_mempolicy, kMPolPreferred, mask.data(), mask.size() * kBitsPerWord + 1) !=
+      0) {
+    LOG(WARNING) << "Failed to prefer the memory of NUMA node " << node << " for disco worker "
+                 << DiscoWorker::ThreadLocal()->worker_id;
+  }
+#endif
+  return node;
+}
+
+TVM_REGISTER_GLOBAL("runtime.disco.device_numa_node").set_body_typed(DeviceNUMANode);
+TVM_REGISTER_GLOBAL("runtime.disco.bind_worker_to_numa_node").set_body_typed(BindWorkerToNUMANode);
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,200 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file pipeline.cc
+ * \brief Pipeline-parallel execution of micro-batches over the worker groups of Disco.
+ *
+ * Each group is a pipeline stage, and the workers in a group run the same stage, e.g. as a
+ * tensor-parallel shard of it.  A stage may consist of several chunks, i.e. virtual stages, in
+ * which case chunk `v` of group `g` is the virtual stage `v * num_groups + g`, and the
+ * activations go from the last group back to the first one between the chunks.
+ *
+ * Every worker runs its own schedule of (chunk, micro-batch) steps, in which each step receives
+ * the activation from the previous stage, runs the chunk on it, and sends the result to the next
+ * stage.  With a single chunk the micro-batches are run in order, which fills the pipeline and
+ * keeps every stage busy afterwards.  With multiple chunks, the micro-batches are run in rounds
+ * of `num_groups`, and each round goes through all the chunks before the next round starts, which
+ * is the interleaved schedule and shrinks the bubble by the number of chunks.
+ */
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/disco/builtin.h>
+#include <tvm/runtime/disco/disco_worker.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/profiling.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+
+/*!
+ * \brief The (chunk, micro-batch) steps of a worker, in execution order.
+ * \param num_groups The number of worker groups, i.e. pipeline stages.
+ * \param num_chunks The number of chunks per stage.
+ * \param num_micro_batches The number of micro-batches.
+ */
+std::vector<std::pair<int, int>> PipelineSchedule(int num_groups, int num_chunks,
+                                                  int num_micro_batches) {
+  std::vector<std::pair<int, int>> steps;
+  steps.reserve(num_chunks * num_micro_batches);
+  if (num_chunks == 1) {
+    for (int m = 0; m < num_micro_batches; ++m) {
+      steps.emplace_back(0, m);
+    }
+    return steps;
+  }
+  for (int round = 0; round < num_micro_batches / num_groups; ++round) {
+    for (int v = 0; v < num_chunks; ++v) {
+      for (int i = 0; i < num_groups; ++i) {
+        steps.emplace_back(v, round * num_groups + i);
+      }
+    }
+  }
+  return steps;
+}
+
+/*!
+ * \brief Run micro-batches through the pipeline of worker groups.
+ * \param num_micro_batches The number of micro-batches.
+ * \param inputs The input micro-batches, only used by the first group.
+ * \param activation_shape The shape of the activations passed between the stages.
+ * \param activation_dtype The data type of the activations passed between the stages.
+ * \param profile Whether to time the chunks.
+ * \param chunks The chunks of the stage of this worker, each mapping an activation to the next.
+ * \return An array of the outputs of the micro-batches, which is only non-empty on the last
+ * group, and the elapsed nanoseconds of chunk `v` on micro-batch `m` at index
+ * `v * num_micro_batches + m`, which is empty unless profiling.
+ */
+Array<ObjectRef> RunPipeline(int num_micro_batches, Array<NDArray> inputs,
+                             ShapeTuple activation_shape, DataType activation_dtype, bool profile,
+                             std::vector<PackedFunc> chunks) {
+  DiscoWorker* worker = DiscoWorker::ThreadLocal();
+  int num_groups = worker->num_groups;
+  int group_size = worker->num_workers / num_groups;
+  int group_id = worker->worker_id / group_size;
+  int num_chunks = static_cast<int>(chunks.size());
+  bool is_first = group_id == 0;
+  bool is_last = group_id == num_groups - 1;
+  CHECK_GE(num_chunks, 1) << "ValueError: The pipeline requires at least one chunk per stage";
+  CHECK_GT(num_micro_batches, 0) << "ValueError: The pipeline requires at least one micro-batch";
+  CHECK(num_chunks == 1 || num_micro_batches % num_groups == 0)
+      << "ValueError: The interleaved schedule requires the number of micro-batches to be a "
+      << "multiple of the number of groups, but got " << num_micro_batches << " micro-batches "
+      << "and " << num_groups << " groups";
+  if (is_first) {
+    CHECK_EQ(static_cast<int>(inputs.size()), num_micro_batches)
+        << "ValueError: The first group expects " << num_micro_batches
+        << " input micro-batches, but got " << inputs.size();
+  }
+  // The worker of the same rank in the other end of the pipeline, between the chunks.
+  int wrap_peer = is_first ? worker->worker_id + (num_groups - 1) * group_size
+                           : worker->worker_id - (num_groups - 1) * group_size;
+
+  // Two buffers for each chunk, alternating between micro-batches, so that the activation of a
+  // micro-batch stays intact while the next one is received.
+  std::vector<std::vector<NDArray>> buffers(num_chunks);
+  for (int v = 0; v < num_chunks; ++v) {
+    if (is_first && (v == 0 || num_groups == 1)) continue;
+    for (int i = 0; i < 2; ++i) {
+      buffers[v].push_back(
+          DiscoEmptyNDArray(activation_shape, activation_dtype, worker->default_device));
+    }
+  }
+
+  Array<NDArray> outputs;
+  if (is_last) {
+    outputs = Array<NDArray>(num_micro_batches, NDArray());
+  }
+  std::vector<Timer> timers;
+  NDArray local_activation;
+  for (const auto& [v, m] : PipelineSchedule(num_groups, num_chunks, num_micro_batches)) {
+    NDArray activation;
+    if (is_first && v == 0) {
+      activation = inputs[m];
+    } else if (num_groups == 1) {
+      activation = local_activation;
+    } else {
+      activation = buffers[v][m % 2];
+      if (is_first) {
+        RecvFromWorker(activation, wrap_peer);
+      } else {
+        RecvFromPrevGroup(activation);
+      }
+    }
+
+    Timer timer;
+    if (profile) timer = Timer::Start(worker->default_device);
+    NDArray result = chunks[v](activation);
+    if (profile) {
+      timer->Stop();
+      timers.push_back(timer);
+    }
+
+    if (is_last && v == num_chunks - 1) {
+      outputs.Set(m, result);
+      continue;
+    }
+    ShapeTuple shape = result.Shape();
+    bool matched = result.DataType() == activation_dtype &&
+                   std::equal(shape.begin(), shape.end(), activation_shape.begin(),
+                              activation_shape.end());
+    CHECK(matched)
+        << "ValueError: Chunk " << v << " of group " << group_id << " should produce the "
+        << "activation of shape " << activation_shape << " and dtype " << activation_dtype
+        << ", but got shape " << shape << " and dtype " << result.DataType();
+    if (num_groups == 1) {
+      // The next chunk is on the same worker, which runs it in the next step.
+      local_activation = result;
+    } else if (is_last) {
+      SendToWorker(result, wrap_peer);
+    } else {
+      SendToNextGroup(result);
+    }
+  }
+
+  std::vector<int64_t> elapsed_nanos;
+  if (profile) {
+    elapsed_nanos.resize(num_chunks * num_micro_batches);
+    auto steps = PipelineSchedule(num_groups, num_chunks, num_micro_batches);
+    for (size_t i = 0; i < steps.size(); ++i) {
+      elapsed_nanos[steps[i].first * num_micro_batches + steps[i].second] =
+          timers[i]->SyncAndGetElapsedNanos();
+    }
+  }
+  return {outputs, ShapeTuple(elapsed_nanos)};
+}
+
+TVM_REGISTER_GLOBAL("runtime.disco.run_pipeline").set_body([](TVMArgs args, TVMRetValue* rv) {
+  CHECK_GE(args.size(), 6) << "ValueError: runtime.disco.run_pipeline expects the number of "
+                           << "micro-batches, the inputs, the activation shape and dtype, "
+                           << "whether to profile, and at least one chunk";
+  std::vector<PackedFunc> chunks;
+  for (int i = 5; i < args.size(); ++i) {
+    chunks.push_back(args[i]);
+  }
+  *rv = RunPipeline(args[0], args[1], args[2], args[3], args[4], std::move(chunks));
+});
+
+}  // namespace runtime
+}  // namespace tvm
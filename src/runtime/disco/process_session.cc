@@ -28,6 +28,7 @@
 #include <vector>
 
 #include "../../support/pipe.h"
+#include "../../support/shared_memory_ring.h"
 #include "../minrpc/rpc_reference.h"
 #include "./bcast_session.h"
 #include "./disco_worker_thread.h"
@@ -37,13 +38,24 @@
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief The channel between the controller and a worker process.
+ *
+ * The messages are sent over the pipes by default. When given a memory file, they are sent
+ * over shared memory rings instead, saving the system calls of the pipes, while the pipes
+ * are only used to detect the other process exiting.
+ */
 class DiscoProcessChannel final : public DiscoChannel {
  public:
-  DiscoProcessChannel(int64_t controler_to_worker_fd, int64_t worker_to_controler_fd)
+  DiscoProcessChannel(int64_t controler_to_worker_fd, int64_t worker_to_controler_fd,
+                      int64_t shm_fd = -1)
       : controller_to_worker_pipe_(controler_to_worker_fd),
         worker_to_controller_pipe_(worker_to_controler_fd),
-        controler_to_worker_(&controller_to_worker_pipe_),
-        worker_to_controler_(&worker_to_controller_pipe_) {}
+        shm_channel_(CreateSharedMemoryChannel(shm_fd, controler_to_worker_fd,
+                                               worker_to_controler_fd)),
+        controler_to_worker_(shm_channel_ ? shm_channel_->forward() : &controller_to_worker_pipe_),
+        worker_to_controler_(shm_channel_ ? shm_channel_->backward()
+                                          : &worker_to_controller_pipe_) {}
 
   DiscoProcessChannel(DiscoProcessChannel&& other) = delete;
   DiscoProcessChannel(const DiscoProcessChannel& other) = delete;
@@ -55,8 +67,19 @@ class DiscoProcessChannel final : public DiscoChannel {
 
   support::Pipe controller_to_worker_pipe_;
   support::Pipe worker_to_controller_pipe_;
+  std::unique_ptr<support::SharedMemoryChannel> shm_channel_;
   DiscoStreamMessageQueue controler_to_worker_;
   DiscoStreamMessageQueue worker_to_controler_;
+
+ private:
+  static std::unique_ptr<support::SharedMemoryChannel> CreateSharedMemoryChannel(
+      int64_t shm_fd, int64_t controler_to_worker_fd, int64_t worker_to_controler_fd) {
+    if (shm_fd < 0) {
+      return nullptr;
+    }
+    return std::make_unique<support::SharedMemoryChannel>(shm_fd, controler_to_worker_fd,
+                                                          worker_to_controler_fd);
+  }
 };
 
 class ProcessSessionObj final : public BcastSessionObj {
@@ -67,17 +90,23 @@ class ProcessSessionObj final : public BcastSessionObj {
             std::make_unique<DiscoWorkerThread>(0, num_workers, num_groups, &worker_zero_data_)) {
     std::vector<int64_t> read_fds;
     std::vector<int64_t> write_fds;
+    std::vector<int64_t> shm_fds;
     read_fds.reserve(num_workers - 1);
     write_fds.reserve(num_workers - 1);
+    shm_fds.reserve(num_workers - 1);
     for (int i = 1; i < num_workers; ++i) {
       IntTuple fds = process_pool(i);
-      CHECK_EQ(fds.size(), 2) << "ValueError: process_pool(" << i << ") should return a tuple of "
-                              << "size 2, but got a tuple of size " << fds.size() << ".";
+      // The optional third file descriptor is the memory file of a shared memory channel.
+      CHECK(fds.size() == 2 || fds.size() == 3)
+          << "ValueError: process_pool(" << i << ") should return a tuple of "
+          << "size 2 or 3, but got a tuple of size " << fds.size() << ".";
       read_fds.push_back(fds[0]);
       write_fds.push_back(fds[1]);
+      shm_fds.push_back(fds.size() == 3 ? fds[2] : -1);
     }
     for (int i = 0; i < num_workers - 1; ++i) {
-      workers_.emplace_back(std::make_unique<DiscoProcessChannel>(write_fds[i], read_fds[i]));
+      workers_.emplace_back(
+          std::make_unique<DiscoProcessChannel>(write_fds[i], read_fds[i], shm_fds[i]));
     }
   }
 
@@ -194,16 +223,24 @@ Session Session::ProcessSession(int num_workers, int num_group, String process_p
 }
 
 void WorkerProcess(int worker_id, int num_workers, int num_group, int64_t read_fd,
-                   int64_t write_fd) {
+                   int64_t write_fd, int64_t shm_fd) {
   CHECK_EQ(num_workers % num_group, 0)
       << "The number of workers should be divisible by the number of worker group.";
-  DiscoProcessChannel channel(read_fd, write_fd);
+  DiscoProcessChannel channel(read_fd, write_fd, shm_fd);
   DiscoWorker worker(worker_id, num_workers, num_group, nullptr, &channel);
   worker.MainLoop();
 }
 
 TVM_REGISTER_GLOBAL("runtime.disco.SessionProcess").set_body_typed(Session::ProcessSession);
-TVM_REGISTER_GLOBAL("runtime.disco.WorkerProcess").set_body_typed(WorkerProcess);
+TVM_REGISTER_GLOBAL("runtime.disco.WorkerProcess")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      // The memory file of the shared memory channel is optional.
+      CHECK(args.size() == 5 || args.size() == 6)
+          << "ValueError: runtime.disco.WorkerProcess expects 5 or 6 arguments, but got "
+          << args.size();
+      int64_t shm_fd = args.size() == 6 ? args[5].operator int64_t() : -1;
+      WorkerProcess(args[0], args[1], args[2], args[3], args[4], shm_fd);
+    });
 
 }  // namespace runtime
 }  // namespace tvm
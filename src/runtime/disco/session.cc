@@ -54,6 +54,12 @@ TVM_REGISTER_GLOBAL("runtime.disco.SessionCallPacked").set_body([](TVMArgs args,
   *rv = SessionObj::FFI::CallWithPacked(
       self, TVMArgs(args.values + 1, args.type_codes + 1, args.num_args - 1));
 });
+TVM_REGISTER_GLOBAL("runtime.disco.SessionBeginCommandGraph")
+    .set_body_method<Session>(&SessionObj::BeginCommandGraph);
+TVM_REGISTER_GLOBAL("runtime.disco.SessionEndCommandGraph")
+    .set_body_method<Session>(&SessionObj::EndCommandGraph);
+TVM_REGISTER_GLOBAL("runtime.disco.SessionReplayCommandGraph")
+    .set_body_method<Session>(&SessionObj::ReplayCommandGraph);
 TVM_REGISTER_GLOBAL("runtime.disco.SessionShutdown")
     .set_body_method<Session>(&SessionObj::Shutdown);
 
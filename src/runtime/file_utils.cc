@@ -25,11 +25,26 @@
 #include <dmlc/json.h>
 #include <dmlc/memory_io.h>
 #include <tvm/runtime/logging.h>
+#include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace tvm {
@@ -127,6 +142,52 @@ void LoadBinaryFromFile(const std::string& file_name, std::string* data) {
   fs.read(&(*data)[0], size);
 }
 
+std::shared_ptr<void> MapBinaryFile(const std::string& file_name, char** data, size_t* size) {
+#if !defined(_WIN32)
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) return nullptr;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return nullptr;
+  }
+  size_t file_size = static_cast<size_t>(st.st_size);
+  // Private writable mapping: kernels see the same content as a heap copy,
+  // and pages are only copied on write.
+  void* addr = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) return nullptr;
+  *data = static_cast<char*>(addr);
+  *size = file_size;
+  return std::shared_ptr<void>(addr, [file_size](void* p) { munmap(p, file_size); });
+#else
+  return nullptr;
+#endif
+}
+
+NDArray NDArrayFromMappedData(char* data, std::vector<int64_t> shape, DLDataType dtype,
+                              std::shared_ptr<void> holder) {
+  struct MappedDataContext {
+    std::vector<int64_t> shape;
+    std::shared_ptr<void> holder;
+  };
+  auto* ctx = new MappedDataContext{std::move(shape), std::move(holder)};
+  auto* managed = new DLManagedTensor();
+  managed->dl_tensor.data = data;
+  managed->dl_tensor.device = Device{kDLCPU, 0};
+  managed->dl_tensor.ndim = static_cast<int>(ctx->shape.size());
+  managed->dl_tensor.dtype = dtype;
+  managed->dl_tensor.shape = ctx->shape.data();
+  managed->dl_tensor.strides = nullptr;
+  managed->dl_tensor.byte_offset = 0;
+  managed->manager_ctx = ctx;
+  managed->deleter = [](DLManagedTensor* self) {
+    delete static_cast<MappedDataContext*>(self->manager_ctx);
+    delete self;
+  };
+  return NDArray::FromDLPack(managed);
+}
+
 void SaveBinaryToFile(const std::string& file_name, const std::string& data) {
   std::ofstream fs(file_name, std::ios::out | std::ios::binary);
   ICHECK(!fs.fail()) << "Cannot open " << file_name;
@@ -181,15 +242,249 @@ void CopyFile(const std::string& src_file_name, const std::string& dest_file_nam
                << " dest='" << dest_file_name << "'";
 }
 
+namespace {
+
+/*! \brief The CRC32 (IEEE 802.3) of the bytes, continuing from crc. */
+uint32_t CRC32(const void* data, size_t size, uint32_t crc = 0) {
+  static const std::array<uint32_t, 256> table = []() {
+    std::array<uint32_t, 256> table;
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1) ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+      }
+      table[i] = c;
+    }
+    return table;
+  }();
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i) {
+    crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+/*! \brief A stream reading from another one, which counts the bytes read. */
+class CountingReadStream : public dmlc::Stream {
+ public:
+  explicit CountingReadStream(dmlc::Stream* strm) : strm_(strm) {}
+
+  size_t Read(void* ptr, size_t size) final {
+    size_t nread = strm_->Read(ptr, size);
+    pos_ += nread;
+    return nread;
+  }
+
+  size_t Write(const void* ptr, size_t size) final {
+    LOG(FATAL) << "CountingReadStream is read-only";
+    return 0;
+  }
+
+  /*! \brief The number of bytes read. */
+  uint64_t Tell() const { return pos_; }
+
+ private:
+  dmlc::Stream* strm_;
+  uint64_t pos_{0};
+};
+
+/*! \brief The entry of a parameter in the header of the aligned format. */
+struct AlignedParamEntry {
+  DLDataType dtype;
+  std::vector<int64_t> shape;
+  uint64_t offset;
+  uint64_t nbytes;
+  uint32_t crc32;
+
+  void Save(dmlc::Stream* strm) const {
+    strm->Write(dtype);
+    strm->Write(shape);
+    strm->Write(offset);
+    strm->Write(nbytes);
+    strm->Write(crc32);
+  }
+
+  bool Load(dmlc::Stream* strm) {
+    return strm->Read(&dtype) && strm->Read(&shape) && strm->Read(&offset) &&
+           strm->Read(&nbytes) && strm->Read(&crc32);
+  }
+};
+
+/*! \brief Get the data of a tensor as contiguous little-endian bytes on CPU. */
+const void* GetTensorBytes(const DLTensor* tensor, size_t nbytes, std::vector<uint8_t>* buffer) {
+  if (DMLC_IO_NO_ENDIAN_SWAP && tensor->device.device_type == kDLCPU &&
+      tensor->strides == nullptr && tensor->byte_offset == 0) {
+    return tensor->data;
+  }
+  buffer->resize(nbytes);
+  ICHECK_EQ(TVMArrayCopyToBytes(const_cast<DLTensor*>(tensor), buffer->data(), nbytes), 0)
+      << TVMGetLastError();
+  if (!DMLC_IO_NO_ENDIAN_SWAP) {
+    size_t elem_bytes = (tensor->dtype.bits * tensor->dtype.lanes + 7) / 8;
+    dmlc::ByteSwap(buffer->data(), elem_bytes, nbytes / elem_bytes);
+  }
+  return buffer->data();
+}
+
+void SaveAlignedParams(dmlc::Stream* strm, const std::vector<std::string>& names,
+                       const std::vector<const DLTensor*>& arrays, size_t alignment) {
+  std::vector<AlignedParamEntry> entries(arrays.size());
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    const DLTensor* tensor = arrays[i];
+    entries[i].dtype = tensor->dtype;
+    entries[i].shape.assign(tensor->shape, tensor->shape + tensor->ndim);
+    entries[i].nbytes = GetDataSize(*tensor);
+  }
+  auto write_header = [&](dmlc::Stream* out) {
+    uint64_t header = kTVMNDArrayListAlignedMagic;
+    uint64_t header_alignment = alignment;
+    uint64_t sz = static_cast<uint64_t>(arrays.size());
+    out->Write(header);
+    out->Write(header_alignment);
+    out->Write(names);
+    out->Write(sz);
+    for (const AlignedParamEntry& entry : entries) {
+      entry.Save(out);
+    }
+  };
+  // The size of the header does not depend on the offsets, lay out the data after it.
+  std::string header_bytes;
+  dmlc::MemoryStringStream header_strm(&header_bytes);
+  write_header(&header_strm);
+  uint64_t offset = header_bytes.size();
+  std::vector<std::vector<uint8_t>> buffers(arrays.size());
+  std::vector<const void*> data(arrays.size());
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    offset = (offset + alignment - 1) / alignment * alignment;
+    entries[i].offset = offset;
+    data[i] = GetTensorBytes(arrays[i], entries[i].nbytes, &buffers[i]);
+    entries[i].crc32 = CRC32(data[i], entries[i].nbytes);
+    offset += entries[i].nbytes;
+  }
+  write_header(strm);
+  uint64_t pos = header_bytes.size();
+  std::vector<char> padding(alignment, 0);
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    strm->Write(padding.data(), entries[i].offset - pos);
+    strm->Write(data[i], entries[i].nbytes);
+    pos = entries[i].offset + entries[i].nbytes;
+  }
+}
+
+/*!
+ * \brief Read the parameters in the aligned format, whose header is read up to the
+ *  number of parameters.
+ *
+ *  The parameters are read and checked on a separate thread, which stays up to
+ *  kMaxPending parameters ahead of the visitor.
+ */
+void LoadAlignedParams(CountingReadStream* strm, const std::vector<std::string>& names,
+                       const std::function<void(const String&, const NDArray&)>& fvisit) {
+  constexpr size_t kMaxPending = 2;
+  std::vector<AlignedParamEntry> entries(names.size());
+  for (AlignedParamEntry& entry : entries) {
+    ICHECK(entry.Load(strm)) << "Invalid parameters file format";
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<NDArray> pending;
+  std::exception_ptr error = nullptr;
+  bool stop = false;
+
+  std::thread reader([&]() {
+    try {
+      uint64_t pos = strm->Tell();
+      std::vector<char> padding;
+      for (size_t i = 0; i < entries.size(); ++i) {
+        const AlignedParamEntry& entry = entries[i];
+        ICHECK_GE(entry.offset, pos) << "Invalid parameters file format";
+        padding.resize(entry.offset - pos);
+        ICHECK_EQ(strm->Read(padding.data(), padding.size()), padding.size())
+            << "Invalid parameters file format";
+        NDArray arr = NDArray::Empty(ShapeTuple(entry.shape), entry.dtype, {kDLCPU, 0});
+        ICHECK_EQ(GetDataSize(*arr.operator->()), entry.nbytes)
+            << "Invalid parameters file format";
+        ICHECK_EQ(strm->Read(arr->data, entry.nbytes), entry.nbytes)
+            << "Invalid parameters file format";
+        ICHECK_EQ(CRC32(arr->data, entry.nbytes), entry.crc32)
+            << "Checksum mismatch of parameter " << names[i];
+        if (!DMLC_IO_NO_ENDIAN_SWAP) {
+          size_t elem_bytes = (entry.dtype.bits * entry.dtype.lanes + 7) / 8;
+          dmlc::ByteSwap(arr->data, elem_bytes, entry.nbytes / elem_bytes);
+        }
+        pos = entry.offset + entry.nbytes;
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return stop || pending.size() < kMaxPending; });
+        if (stop) return;
+        pending.push_back(std::move(arr));
+        cv.notify_all();
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      error = std::current_exception();
+      cv.notify_all();
+    }
+  });
+
+  auto stop_reader = [&]() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+      cv.notify_all();
+    }
+    reader.join();
+  };
+
+  try {
+    for (size_t i = 0; i < entries.size(); ++i) {
+      NDArray arr;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return !pending.empty() || error != nullptr; });
+        if (pending.empty()) {
+          lock.unlock();
+          stop_reader();
+          std::rethrow_exception(error);
+        }
+        arr = std::move(pending.front());
+        pending.pop_front();
+        cv.notify_all();
+      }
+      fvisit(names[i], arr);
+    }
+  } catch (...) {
+    if (reader.joinable()) stop_reader();
+    throw;
+  }
+  reader.join();
+}
+
+}  // namespace
+
 Map<String, NDArray> LoadParams(const std::string& param_blob) {
   dmlc::MemoryStringStream strm(const_cast<std::string*>(&param_blob));
   return LoadParams(&strm);
 }
+
 Map<String, NDArray> LoadParams(dmlc::Stream* strm) {
   Map<String, NDArray> params;
+  LoadParams(strm, [&params](const String& name, const NDArray& value) {
+    // NDArray.load always load the array into CPU.
+    params.Set(name, value);
+  });
+  return params;
+}
+
+void LoadParams(dmlc::Stream* stream,
+                const std::function<void(const String& name, const NDArray& value)>& fvisit) {
+  CountingReadStream counting_strm(stream);
+  dmlc::Stream* strm = &counting_strm;
   uint64_t header, reserved;
   ICHECK(strm->Read(&header)) << "Invalid parameters file format";
-  ICHECK(header == kTVMNDArrayListMagic) << "Invalid parameters file format";
+  ICHECK(header == kTVMNDArrayListMagic || header == kTVMNDArrayListAlignedMagic)
+      << "Invalid parameters file format";
   ICHECK(strm->Read(&reserved)) << "Invalid parameters file format";
 
   std::vector<std::string> names;
@@ -198,16 +493,18 @@ Map<String, NDArray> LoadParams(dmlc::Stream* strm) {
   strm->Read(&sz);
   size_t size = static_cast<size_t>(sz);
   ICHECK(size == names.size()) << "Invalid parameters file format";
+  if (header == kTVMNDArrayListAlignedMagic) {
+    LoadAlignedParams(&counting_strm, names, fvisit);
+    return;
+  }
   for (size_t i = 0; i < size; ++i) {
-    // The data_entry is allocated on device, NDArray.load always load the array into CPU.
     NDArray temp;
     temp.Load(strm);
-    params.Set(names[i], temp);
+    fvisit(names[i], temp);
   }
-  return params;
 }
 
-void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params) {
+void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params, size_t alignment) {
   std::vector<std::string> names;
   std::vector<const DLTensor*> arrays;
   for (auto& p : params) {
@@ -215,6 +512,11 @@ void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params) {
     arrays.push_back(p.second.operator->());
   }
 
+  if (alignment != 0) {
+    SaveAlignedParams(strm, names, arrays, alignment);
+    return;
+  }
+
   uint64_t header = kTVMNDArrayListMagic, reserved = 0;
   strm->Write(header);
   strm->Write(reserved);
@@ -228,26 +530,27 @@ void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params) {
   }
 }
 
-std::string SaveParams(const Map<String, NDArray>& params) {
+std::string SaveParams(const Map<String, NDArray>& params, size_t alignment) {
   std::string bytes;
   dmlc::MemoryStringStream strm(&bytes);
   dmlc::Stream* fo = &strm;
-  SaveParams(fo, params);
+  SaveParams(fo, params, alignment);
   return bytes;
 }
 
-TVM_REGISTER_GLOBAL("runtime.SaveParams").set_body_typed([](const Map<String, NDArray>& params) {
-  std::string s = ::tvm::runtime::SaveParams(params);
-  // copy return array so it is owned by the ret value
-  TVMRetValue rv;
-  rv = TVMByteArray{s.data(), s.size()};
-  return rv;
-});
+TVM_REGISTER_GLOBAL("runtime.SaveParams")
+    .set_body_typed([](const Map<String, NDArray>& params, int64_t alignment) {
+      std::string s = ::tvm::runtime::SaveParams(params, alignment);
+      // copy return array so it is owned by the ret value
+      TVMRetValue rv;
+      rv = TVMByteArray{s.data(), s.size()};
+      return rv;
+    });
 
 TVM_REGISTER_GLOBAL("runtime.SaveParamsToFile")
-    .set_body_typed([](const Map<String, NDArray>& params, const String& path) {
+    .set_body_typed([](const Map<String, NDArray>& params, const String& path, int64_t alignment) {
       tvm::runtime::SimpleBinaryFileStream strm(path, "wb");
-      SaveParams(&strm, params);
+      SaveParams(&strm, params, alignment);
     });
 
 TVM_REGISTER_GLOBAL("runtime.LoadParams").set_body_typed([](const String& s) {
@@ -27,8 +27,11 @@
 #include <tvm/runtime/container/map.h>
 #include <tvm/runtime/container/string.h>
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "meta_data.h"
 
@@ -67,6 +70,31 @@ std::string GetFileBasename(const std::string& file_name);
  */
 void LoadBinaryFromFile(const std::string& file_name, std::string* data);
 
+/*!
+ * \brief Map a binary file into memory.
+ *
+ * The mapping is private and writable: pages are read lazily from the page
+ * cache, shared with other processes mapping the same file, and only copied
+ * when written to.
+ *
+ * \param file_name The name of the file.
+ * \param data The start of the mapping.
+ * \param size The size of the mapping.
+ * \return The shared owner of the mapping, or nullptr if the file cannot be mapped
+ *  or memory mapping is not supported on the platform.
+ */
+std::shared_ptr<void> MapBinaryFile(const std::string& file_name, char** data, size_t* size);
+
+/*!
+ * \brief Create a CPU NDArray that aliases the memory of a mapped file.
+ * \param data The data of the array.
+ * \param shape The shape of the array.
+ * \param dtype The data type of the array.
+ * \param holder The shared owner of the mapping, kept alive until the array is freed.
+ */
+NDArray NDArrayFromMappedData(char* data, std::vector<int64_t> shape, DLDataType dtype,
+                              std::shared_ptr<void> holder);
+
 /*!
  * \brief Load binary file into a in-memory buffer.
  * \param file_name The name of the file.
@@ -105,6 +133,15 @@ void CopyFile(const std::string& src_file_name, const std::string& dest_file_nam
 void RemoveFile(const std::string& file_name);
 
 constexpr uint64_t kTVMNDArrayListMagic = 0xF7E58D4F05049CB7;
+/*!
+ * \brief Magic number of the parameters whose data are aligned and checksummed.
+ *
+ *  The header has the same prefix as the one of kTVMNDArrayListMagic: the alignment
+ *  (in place of the reserved field), the names and the number of parameters. It is
+ *  followed by the dtype, shape, offset, size and CRC32 of each parameter, whose data
+ *  start at the given offsets, multiples of the alignment from the start of the header.
+ */
+constexpr uint64_t kTVMNDArrayListAlignedMagic = 0xF7E58D4F05049CB8;
 /*!
  * \brief Load parameters from a string.
  * \param param_blob Serialized string of parameters.
@@ -117,18 +154,34 @@ Map<String, NDArray> LoadParams(const std::string& param_blob);
  * \return Map of parameter name to parameter value.
  */
 Map<String, NDArray> LoadParams(dmlc::Stream* strm);
+/*!
+ * \brief Load parameters from a stream, one at a time.
+ *
+ *  The parameters saved with an alignment are read and checked on another thread,
+ *  so that the next ones are read while the previous ones are visited, e.g. uploaded
+ *  to a device.
+ *
+ * \param strm Stream to load parameters from.
+ * \param fvisit The function called with the name and value of each parameter, in order.
+ */
+void LoadParams(dmlc::Stream* strm,
+                const std::function<void(const String& name, const NDArray& value)>& fvisit);
 /*!
  * \brief Serialize parameters to a byte array.
  * \param params Parameters to save.
+ * \param alignment The alignment of the data of the parameters, which are also checksummed.
+ *  When it is 0, the data are written unaligned and without checksums.
  * \return String containing binary parameter data.
  */
-std::string SaveParams(const Map<String, NDArray>& params);
+std::string SaveParams(const Map<String, NDArray>& params, size_t alignment = 0);
 /*!
  * \brief Serialize parameters to a stream.
  * \param strm Stream to write to.
  * \param params Parameters to save.
+ * \param alignment The alignment of the data of the parameters, which are also checksummed.
+ *  When it is 0, the data are written unaligned and without checksums.
  */
-void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params);
+void SaveParams(dmlc::Stream* strm, const Map<String, NDArray>& params, size_t alignment = 0);
 
 /*!
  * \brief A dmlc stream which wraps standard file operations.
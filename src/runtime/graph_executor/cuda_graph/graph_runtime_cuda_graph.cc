@@ -21,8 +21,13 @@
  * \file graph_executor_cuda_graph.cc
  */
 
+#include <cuda.h>
 #include <tvm/runtime/registry.h>
 
+#include <cstring>
+#include <utility>
+#include <vector>
+
 #include "../../cuda/cuda_common.h"
 #include "../graph_executor.h"
 
@@ -38,16 +43,26 @@ namespace runtime {
  *  (1) Using CUDA stream capture API to capture a series of operations on
  *  CUDA stream, and automatically generates a graph (2) Building a graph
  *  using CUDA graph API manually. This implementation uses stream capture.
+ *
+ *  The inputs and outputs may be rebound by SetInputZeroCopy and SetOutputZeroCopy after the
+ *  capture.  The kernel parameters and the memcpy nodes holding their data pointers are then
+ *  patched in the instantiated graph before the launch, which requires CUDA 12.4 or above to
+ *  know the parameters of a kernel.  Otherwise, the graph is recaptured, and the instantiated
+ *  graph is updated from it by cudaGraphExecUpdate.
  */
 class GraphExecutorCudaGraph : public GraphExecutor {
  public:
+  ~GraphExecutorCudaGraph() { DestroyGraph(); }
+
   /*!
    * \brief Begin CUDA graph capture on stream, the stream enters capture mode.
    */
   void StartCapture() {
     const Device& dev = data_entry_[entry_id(0, 0)]->device;
 
-    TVMStreamCreate(dev.device_type, dev.device_id, &capture_stream_);
+    if (capture_stream_ == nullptr) {
+      TVMStreamCreate(dev.device_type, dev.device_id, &capture_stream_);
+    }
     TVMSetStream(dev.device_type, dev.device_id, capture_stream_);
 
     CUDA_CALL(cudaStreamBeginCapture(static_cast<cudaStream_t>(capture_stream_),
@@ -58,6 +73,8 @@ class GraphExecutorCudaGraph : public GraphExecutor {
    * \brief Launch the instantiated graph on stream
    */
   void RunCudaGraph() {
+    ICHECK(cuda_graph_exec_ != nullptr) << "The CUDA graph has to be captured before the launch";
+    UpdateIOBindings();
     cudaStream_t cuStream = static_cast<cudaStream_t>(capture_stream_);
     CUDA_CALL(cudaGraphLaunch(cuda_graph_exec_, cuStream));
     CUDA_CALL(cudaStreamSynchronize(cuStream));
@@ -68,15 +85,17 @@ class GraphExecutorCudaGraph : public GraphExecutor {
    * instantiated.
    */
   void EndCapture() {
-    cudaGraph_t graph;
-    CUDA_CALL(cudaStreamEndCapture(static_cast<cudaStream_t>(capture_stream_), &graph));
+    DestroyGraph();
+    CUDA_CALL(cudaStreamEndCapture(static_cast<cudaStream_t>(capture_stream_), &cuda_graph_));
 
     cudaGraphNode_t* nodes = NULL;
     size_t numNodes = 0;
-    CUDA_CALL(cudaGraphGetNodes(graph, nodes, &numNodes));
+    CUDA_CALL(cudaGraphGetNodes(cuda_graph_, nodes, &numNodes));
     LOG(INFO) << "Num of nodes in the cuda graph created using stream capture API = " << numNodes;
 
-    CUDA_CALL(cudaGraphInstantiate(&cuda_graph_exec_, graph, NULL, NULL, 0));
+    CUDA_CALL(cudaGraphInstantiate(&cuda_graph_exec_, cuda_graph_, NULL, NULL, 0));
+    bound_ptrs_ = CurrentIOPointers();
+    CollectIOBindings();
   }
 
   /*!
@@ -87,10 +106,180 @@ class GraphExecutorCudaGraph : public GraphExecutor {
   PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self);
 
  private:
+  /*! \brief A kernel node with parameters holding the data pointers of inputs or outputs. */
+  struct KernelNodeBinding {
+    CUgraphNode node;
+    CUDA_KERNEL_NODE_PARAMS params;
+    /*! \brief The values of all the parameters, and the pointers to them to launch with. */
+    std::vector<std::vector<char>> values;
+    std::vector<void*> args;
+    /*! \brief The (parameter, input or output) pairs bound to each other. */
+    std::vector<std::pair<size_t, size_t>> bindings;
+  };
+
+  /*! \brief A memcpy node copying from or to an input or output. */
+  struct MemcpyNodeBinding {
+    cudaGraphNode_t node;
+    cudaMemcpy3DParms params;
+    int src_slot = -1;
+    int dst_slot = -1;
+  };
+
+  void DestroyGraph() {
+    if (cuda_graph_exec_ != nullptr) CUDA_CALL(cudaGraphExecDestroy(cuda_graph_exec_));
+    if (cuda_graph_ != nullptr) CUDA_CALL(cudaGraphDestroy(cuda_graph_));
+    cuda_graph_exec_ = nullptr;
+    cuda_graph_ = nullptr;
+  }
+
+  /*!
+   * \brief The data pointers the kernels see for the inputs followed by the outputs, which the
+   * zero-copy setters update in the arguments of the kernels.
+   */
+  std::vector<void*> CurrentIOPointers() const {
+    std::vector<void*> ptrs;
+    auto f_add = [&](const std::vector<DLTensor*>& tensors, uint32_t eid) {
+      ptrs.push_back(tensors.empty() ? data_entry_[eid]->data : tensors.back()->data);
+    };
+    for (uint32_t nid : input_nodes_) {
+      uint32_t eid = entry_id(nid, 0);
+      f_add(input_dltensors_[eid], eid);
+    }
+    for (const NodeEntry& output : outputs_) {
+      uint32_t eid = entry_id(output);
+      f_add(output_dltensors_[eid], eid);
+    }
+    return ptrs;
+  }
+
+  int FindSlot(const void* ptr) const {
+    for (size_t i = 0; i < bound_ptrs_.size(); ++i) {
+      if (bound_ptrs_[i] == ptr) return static_cast<int>(i);
+    }
+    return -1;
+  }
+
+  /*!
+   * \brief Find the parameters of the kernel nodes and the memcpy nodes that are the data
+   * pointers of the inputs and outputs, to patch them when they are rebound.
+   */
+  void CollectIOBindings() {
+    kernel_bindings_.clear();
+    memcpy_bindings_.clear();
+    rebindable_ = false;
+#if CUDA_VERSION >= 12040
+    size_t num_nodes = 0;
+    CUDA_CALL(cudaGraphGetNodes(cuda_graph_, nullptr, &num_nodes));
+    std::vector<cudaGraphNode_t> nodes(num_nodes);
+    CUDA_CALL(cudaGraphGetNodes(cuda_graph_, nodes.data(), &num_nodes));
+    for (cudaGraphNode_t node : nodes) {
+      cudaGraphNodeType type;
+      CUDA_CALL(cudaGraphNodeGetType(node, &type));
+      if (type == cudaGraphNodeTypeKernel) {
+        KernelNodeBinding binding;
+        binding.node = node;
+        CUDA_DRIVER_CALL(cuGraphKernelNodeGetParams(node, &binding.params));
+        for (size_t i = 0;; ++i) {
+          size_t offset, size;
+          CUresult result = cuFuncGetParamInfo(binding.params.func, i, &offset, &size);
+          if (result == CUDA_ERROR_INVALID_VALUE) break;
+          // The parameters of the kernel are unknown, so the graph is recaptured instead.
+          if (result != CUDA_SUCCESS) return;
+          const char* value = static_cast<const char*>(binding.params.kernelParams[i]);
+          binding.values.emplace_back(value, value + size);
+          if (size == sizeof(void*)) {
+            void* ptr;
+            std::memcpy(&ptr, value, sizeof(void*));
+            int slot = FindSlot(ptr);
+            if (slot >= 0) binding.bindings.emplace_back(i, slot);
+          }
+        }
+        if (binding.bindings.empty()) continue;
+        for (std::vector<char>& value : binding.values) {
+          binding.args.push_back(value.data());
+        }
+        kernel_bindings_.push_back(std::move(binding));
+      } else if (type == cudaGraphNodeTypeMemcpy) {
+        MemcpyNodeBinding binding;
+        binding.node = node;
+        CUDA_CALL(cudaGraphMemcpyNodeGetParams(node, &binding.params));
+        binding.src_slot = FindSlot(binding.params.srcPtr.ptr);
+        binding.dst_slot = FindSlot(binding.params.dstPtr.ptr);
+        if (binding.src_slot >= 0 || binding.dst_slot >= 0) {
+          memcpy_bindings_.push_back(binding);
+        }
+      }
+    }
+    rebindable_ = true;
+#endif
+  }
+
+  /*! \brief Point the instantiated graph to the current inputs and outputs. */
+  void UpdateIOBindings() {
+    std::vector<void*> ptrs = CurrentIOPointers();
+    if (ptrs == bound_ptrs_) return;
+    if (!rebindable_) {
+      Recapture();
+      bound_ptrs_ = ptrs;
+      CollectIOBindings();
+      return;
+    }
+    for (KernelNodeBinding& binding : kernel_bindings_) {
+      for (const auto& [param, slot] : binding.bindings) {
+        std::memcpy(binding.values[param].data(), &ptrs[slot], sizeof(void*));
+      }
+      CUDA_KERNEL_NODE_PARAMS params = binding.params;
+      params.kernelParams = binding.args.data();
+      params.extra = nullptr;
+      CUDA_DRIVER_CALL(cuGraphExecKernelNodeSetParams(
+          reinterpret_cast<CUgraphExec>(cuda_graph_exec_), binding.node, &params));
+    }
+    for (MemcpyNodeBinding& binding : memcpy_bindings_) {
+      if (binding.src_slot >= 0) binding.params.srcPtr.ptr = ptrs[binding.src_slot];
+      if (binding.dst_slot >= 0) binding.params.dstPtr.ptr = ptrs[binding.dst_slot];
+      CUDA_CALL(cudaGraphExecMemcpyNodeSetParams(cuda_graph_exec_, binding.node, &binding.params));
+    }
+    bound_ptrs_ = ptrs;
+  }
+
+  /*! \brief Capture the graph again, and update the instantiated graph from it. */
+  void Recapture() {
+    cudaStream_t stream = static_cast<cudaStream_t>(capture_stream_);
+    CUDA_CALL(cudaStreamBeginCapture(stream, cudaStreamCaptureModeGlobal));
+    GraphExecutor::Run();
+    cudaGraph_t graph;
+    CUDA_CALL(cudaStreamEndCapture(stream, &graph));
+#if CUDART_VERSION >= 12000
+    cudaGraphExecUpdateResultInfo result_info;
+    bool updated = cudaGraphExecUpdate(cuda_graph_exec_, graph, &result_info) == cudaSuccess;
+#else
+    cudaGraphNode_t error_node;
+    cudaGraphExecUpdateResult result;
+    bool updated =
+        cudaGraphExecUpdate(cuda_graph_exec_, graph, &error_node, &result) == cudaSuccess;
+#endif
+    if (!updated) {
+      // The topology changed, e.g. by different kernels, so the graph is instantiated again.
+      (void)cudaGetLastError();
+      CUDA_CALL(cudaGraphExecDestroy(cuda_graph_exec_));
+      CUDA_CALL(cudaGraphInstantiate(&cuda_graph_exec_, graph, NULL, NULL, 0));
+    }
+    CUDA_CALL(cudaGraphDestroy(cuda_graph_));
+    cuda_graph_ = graph;
+  }
+
   /*! \brief The Cuda stream on which to capture a CUDA graph. */
-  TVMStreamHandle capture_stream_;
+  TVMStreamHandle capture_stream_ = nullptr;
+  /*! \brief The captured CUDA graph. */
+  cudaGraph_t cuda_graph_ = nullptr;
   /*! \brief The captured CUDA graph will be instantiated to this. */
-  cudaGraphExec_t cuda_graph_exec_;
+  cudaGraphExec_t cuda_graph_exec_ = nullptr;
+  /*! \brief The data pointers of the inputs and outputs the instantiated graph uses. */
+  std::vector<void*> bound_ptrs_;
+  /*! \brief Whether the nodes holding the inputs and outputs are patched, or recaptured. */
+  bool rebindable_ = false;
+  std::vector<KernelNodeBinding> kernel_bindings_;
+  std::vector<MemcpyNodeBinding> memcpy_bindings_;
 };
 
 PackedFunc GraphExecutorCudaGraph::GetFunction(const String& name,
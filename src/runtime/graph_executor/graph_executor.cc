@@ -27,16 +27,23 @@
 #include <tvm/runtime/data_type.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/nvtx.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/serializer.h>
+#include <tvm/runtime/threading_backend.h>
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -56,12 +63,133 @@ constexpr auto Is2DStorage = IsTextureStorage;
 }  // namespace details
 
 /*!
- * \brief Run all the operations one by one.
+ * \brief The threads running the nodes of a graph as soon as the nodes they depend on are done.
+ *
+ * Each thread has its own pool for the parallel loops inside the operators, which is limited to
+ * the given number of intra-op threads, so that the threads do not oversubscribe the cores.
+ */
+class GraphExecutor::InterOpPool {
+ public:
+  InterOpPool(int num_threads, int num_intra_op_threads) {
+    for (int i = 0; i < num_threads; ++i) {
+      threads_.emplace_back([this, num_intra_op_threads]() {
+        // The concurrency is thread-local, and sizes the pool of this thread when first used.
+        if (num_intra_op_threads > 0) threading::SetMaxConcurrency(num_intra_op_threads);
+        this->WorkerLoop();
+      });
+    }
+  }
+
+  ~InterOpPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      shutdown_ = true;
+    }
+    ready_cv_.notify_all();
+    for (std::thread& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  /*!
+   * \brief Run the operators, each only after its predecessors are done, and rethrow the first
+   *  error raised by them, after which no more operators are started.
+   */
+  void Run(const std::vector<std::function<void()>>& op_execs,
+           const std::vector<std::vector<uint32_t>>& successors,
+           const std::vector<uint32_t>& num_predecessors) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    op_execs_ = &op_execs;
+    successors_ = &successors;
+    num_pending_predecessors_ = num_predecessors;
+    error_ = nullptr;
+    for (uint32_t nid = 0; nid < op_execs.size(); ++nid) {
+      if (op_execs[nid] && num_predecessors[nid] == 0) ready_.push_back(nid);
+    }
+    ready_cv_.notify_all();
+    done_cv_.wait(lock, [this]() { return ready_.empty() && num_running_ == 0; });
+    op_execs_ = nullptr;
+    successors_ = nullptr;
+    if (error_) std::rethrow_exception(error_);
+  }
+
+ private:
+  void WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      ready_cv_.wait(lock, [this]() { return shutdown_ || !ready_.empty(); });
+      if (shutdown_) return;
+      uint32_t nid = ready_.front();
+      ready_.pop_front();
+      ++num_running_;
+      lock.unlock();
+      std::exception_ptr error = nullptr;
+      try {
+        (*op_execs_)[nid]();
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      --num_running_;
+      if (error && !error_) {
+        error_ = error;
+        ready_.clear();
+      }
+      if (!error_) {
+        for (uint32_t succ : (*successors_)[nid]) {
+          if (--num_pending_predecessors_[succ] == 0) ready_.push_back(succ);
+        }
+        if (ready_.size() > 1) ready_cv_.notify_all();
+      }
+      if (ready_.empty() && num_running_ == 0) done_cv_.notify_one();
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  /*! \brief Notified when a node gets ready, or the pool shuts down. */
+  std::condition_variable ready_cv_;
+  /*! \brief Notified when no node is ready or running, i.e. the run is done. */
+  std::condition_variable done_cv_;
+  std::deque<uint32_t> ready_;
+  int num_running_ = 0;
+  bool shutdown_ = false;
+  const std::vector<std::function<void()>>* op_execs_ = nullptr;
+  const std::vector<std::vector<uint32_t>>* successors_ = nullptr;
+  std::vector<uint32_t> num_pending_predecessors_;
+  std::exception_ptr error_ = nullptr;
+};
+
+GraphExecutor::~GraphExecutor() = default;
+
+/*!
+ * \brief Run all the operations one by one, or concurrently in dataflow order when
+ *  the inter-op parallelism is enabled.
  */
 void GraphExecutor::Run() {
+  if (inter_op_pool_ != nullptr) {
+    inter_op_pool_->Run(op_execs_, op_successors_, op_num_predecessors_);
+    return;
+  }
   // setup the array and requirements.
   for (size_t i = 0; i < op_execs_.size(); ++i) {
-    if (op_execs_[i]) op_execs_[i]();
+    if (op_execs_[i]) {
+      NVTXScopedRange scope([&]() { return nodes_[i].param.func_name; });
+      op_execs_[i]();
+    }
+  }
+}
+
+void GraphExecutor::SetInterOpParallelism(int num_inter_op_threads, int num_intra_op_threads) {
+  CHECK_GE(num_inter_op_threads, 1)
+      << "ValueError: The number of inter-op threads should be positive, but got "
+      << num_inter_op_threads;
+  CHECK_GE(num_intra_op_threads, 0)
+      << "ValueError: The number of intra-op threads should be non-negative, but got "
+      << num_intra_op_threads;
+  inter_op_pool_.reset();
+  if (num_inter_op_threads > 1) {
+    inter_op_pool_ = std::make_unique<InterOpPool>(num_inter_op_threads, num_intra_op_threads);
   }
 }
 
@@ -313,20 +441,21 @@ void GraphExecutor::LoadParams(const std::string& param_blob) {
 }
 
 void GraphExecutor::LoadParams(dmlc::Stream* strm) {
-  Map<String, NDArray> params = ::tvm::runtime::LoadParams(strm);
-  for (auto& p : params) {
-    param_names_.insert(p.first);
-    int in_idx = GetInputIndex(p.first);
-    if (in_idx < 0) continue;
+  // Copy each parameter as soon as it is loaded, while the next ones are still being read.
+  ::tvm::runtime::LoadParams(strm, [this](const String& name, const NDArray& value) {
+    param_names_.insert(name);
+    int in_idx = GetInputIndex(name);
+    if (in_idx < 0) return;
     uint32_t eid = this->entry_id(input_nodes_[in_idx], 0);
-    data_entry_[eid].CopyFrom(p.second);
-  }
+    data_entry_[eid].CopyFrom(value);
+  });
 }
 
 void GraphExecutor::ShareParams(const GraphExecutor& other, dmlc::Stream* strm) {
   uint64_t header, reserved;
   ICHECK(strm->Read(&header)) << "Invalid parameters file format";
-  ICHECK(header == kTVMNDArrayListMagic) << "Invalid parameters file format";
+  ICHECK(header == kTVMNDArrayListMagic || header == kTVMNDArrayListAlignedMagic)
+      << "Invalid parameters file format";
   ICHECK(strm->Read(&reserved)) << "Invalid parameters file format";
   std::vector<std::string> names;
   ICHECK(strm->Read(&names)) << "Invalid parameters file format";
@@ -348,6 +477,24 @@ void GraphExecutor::ShareParams(const GraphExecutor& other, dmlc::Stream* strm)
   this->SetupOpExecs();
 }
 
+void GraphExecutor::ShareParamStorage(const GraphExecutor& other) {
+  ICHECK_EQ(storage_pool_.size(), other.storage_pool_.size())
+      << "ValueError: The parameter storage can only be shared between executors of the same graph";
+  for (const std::string& name : other.param_names_) {
+    int in_idx = GetInputIndex(name);
+    if (in_idx < 0) continue;
+    param_names_.insert(name);
+    // The memory plan never reuses the storage of an input, which is only aliased by the views
+    // of the same data, e.g. the reshapes of it.
+    int sid = attrs_.storage_id[this->entry_id(input_nodes_[in_idx], 0)];
+    storage_pool_[sid] = other.storage_pool_[sid];
+    for (uint32_t eid : sid_to_eid_[sid]) {
+      data_entry_[eid] = other.data_entry_[eid];
+    }
+  }
+  this->SetupOpExecs();
+}
+
 void GraphExecutor::LinkedNDArrayDeleter(Object* container) {
   // container is the NDArray::Container which needs to get deleted.
   // The data member points to global const memory, so it does not need deleting.
@@ -457,16 +604,48 @@ void GraphExecutor::SetupStorage() {
     }
   }
 
-  // Allocate the space.
-  for (const auto& pit : pool_entry) {
-    // This for loop is very fast since there are usually only a couple of
+  // Allocate the arenas, which the storages packed by offset are views of.
+  auto f_device = [this](int device_type) {
+    // This is very fast since there are usually only a couple of
     // devices available on the same hardware.
-    const auto& cit = std::find_if(devices_.begin(), devices_.end(), [&pit](const Device& d) {
-      return pit.device_type == static_cast<int>(d.device_type);
+    const auto& cit = std::find_if(devices_.begin(), devices_.end(), [&](const Device& d) {
+      return device_type == static_cast<int>(d.device_type);
     });
-    Device dev = cit == devices_.end() ? devices_[0] : *cit;
+    return cit == devices_.end() ? devices_[0] : *cit;
+  };
+  ICHECK_EQ(attrs_.arena_device_index.size(), attrs_.arena_size.size());
+  arenas_.clear();
+  for (size_t i = 0; i < attrs_.arena_size.size(); ++i) {
+    Device dev = f_device(attrs_.arena_device_index[i]);
+    arenas_[attrs_.arena_device_index[i]] =
+        MemoryManager::GetOrCreateAllocator(dev, AllocatorType::kNaive)
+            ->Empty({(attrs_.arena_size[i] + 3) / 4}, DLDataType{kDLFloat, 32, 1}, dev);
+  }
+  ICHECK(attrs_.storage_offset.empty() || attrs_.storage_offset.size() == pool_entry.size())
+      << "ValueError: The graph has " << attrs_.storage_offset.size()
+      << " storage offsets, but " << pool_entry.size() << " storages";
+  auto f_offset = [this](size_t sid) -> int64_t {
+    return attrs_.storage_offset.empty() ? -1 : attrs_.storage_offset[sid];
+  };
+
+  // Allocate the space.
+  for (size_t sid = 0; sid < pool_entry.size(); ++sid) {
+    const PoolEntry& pit = pool_entry[sid];
+    Device dev = f_device(pit.device_type);
     if (pit.linked_param.defined()) {
       storage_pool_.push_back(pit.linked_param);
+    } else if (f_offset(sid) >= 0) {
+      auto it = arenas_.find(pit.device_type);
+      ICHECK(it != arenas_.end()) << "ValueError: Storage " << sid << " has an offset, but there "
+                                  << "is no arena on device type " << pit.device_type;
+      // The kernels expect a zero byte_offset, so the offset goes into the data pointer.
+      int64_t num_elems = (pit.shape[0] + 3) / 4;
+      CHECK_LE(f_offset(sid) + num_elems * 4, it->second.Shape()[0] * 4)
+          << "ValueError: Storage " << sid << " does not fit in its arena";
+      DLManagedTensor* view = it->second.ToDLPack();
+      view->dl_tensor.data = static_cast<char*>(view->dl_tensor.data) + f_offset(sid);
+      view->dl_tensor.shape = &num_elems;
+      storage_pool_.push_back(NDArray::FromDLPack(view));
     } else {
       std::vector<int64_t> shape = pit.shape;
       if (shape.size() == 1) {
@@ -481,6 +660,25 @@ void GraphExecutor::SetupStorage() {
     }
   }
 
+  // The storages packed into an arena overlap the storages live at other times.
+  storage_aliases_.assign(storage_pool_.size(), {});
+  std::vector<uint32_t> packed;
+  for (uint32_t sid = 0; sid < storage_pool_.size(); ++sid) {
+    storage_aliases_[sid].push_back(sid);
+    if (f_offset(sid) >= 0) packed.push_back(sid);
+  }
+  std::sort(packed.begin(), packed.end(),
+            [&](uint32_t lhs, uint32_t rhs) { return f_offset(lhs) < f_offset(rhs); });
+  for (size_t i = 0; i < packed.size(); ++i) {
+    uint32_t sid = packed[i];
+    int64_t end = f_offset(sid) + storage_pool_[sid].Shape()[0] * 4;
+    for (size_t j = i + 1; j < packed.size() && f_offset(packed[j]) < end; ++j) {
+      if (pool_entry[packed[j]].device_type != pool_entry[sid].device_type) continue;
+      storage_aliases_[sid].push_back(packed[j]);
+      storage_aliases_[packed[j]].push_back(sid);
+    }
+  }
+
   // Assign the pooled entries. A unified memory pool is used to simplifiy
   // memory assignment for each node entry. The allocated memory on each device
   // is mapped to this pool.
@@ -579,6 +777,48 @@ void GraphExecutor::SetupOpExecs() {
       }
     }
   }
+  this->SetupOpDependencies();
+}
+
+void GraphExecutor::SetupOpDependencies() {
+  uint32_t num_nodes = this->GetNumOfNodes();
+  // Besides the data dependencies, a node writing a storage has to wait for the nodes reading the
+  // entries previously planned in it or in a storage overlapping it, and for the nodes writing
+  // them previously.
+  std::vector<int> last_writer(storage_pool_.size(), -1);
+  std::vector<std::vector<uint32_t>> readers_since_write(storage_pool_.size());
+  std::vector<std::unordered_set<uint32_t>> predecessors(num_nodes);
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    if (!op_execs_[nid]) continue;
+    const auto& inode = nodes_[nid];
+    for (const auto& e : inode.inputs) {
+      int sid = attrs_.storage_id[this->entry_id(e)];
+      if (last_writer[sid] >= 0) predecessors[nid].insert(last_writer[sid]);
+      readers_since_write[sid].push_back(nid);
+    }
+    for (uint32_t index = 0; index < inode.param.num_outputs; ++index) {
+      int sid = attrs_.storage_id[this->entry_id(nid, index)];
+      for (uint32_t alias : storage_aliases_[sid]) {
+        if (last_writer[alias] >= 0) predecessors[nid].insert(last_writer[alias]);
+        for (uint32_t reader : readers_since_write[alias]) {
+          if (reader != nid) predecessors[nid].insert(reader);
+        }
+      }
+      readers_since_write[sid].clear();
+      last_writer[sid] = nid;
+    }
+  }
+  op_successors_.assign(num_nodes, {});
+  op_num_predecessors_.assign(num_nodes, 0);
+  for (uint32_t nid = 0; nid < num_nodes; ++nid) {
+    // The node ids are in topological order, so a node only depends on the nodes before it.
+    std::vector<uint32_t> sorted(predecessors[nid].begin(), predecessors[nid].end());
+    std::sort(sorted.begin(), sorted.end());
+    for (uint32_t pred : sorted) {
+      op_successors_[pred].push_back(nid);
+    }
+    op_num_predecessors_[nid] = static_cast<uint32_t>(sorted.size());
+  }
 }
 
 std::pair<std::function<void()>, std::shared_ptr<GraphExecutor::OpArgs>> GraphExecutor::CreateTVMOp(
@@ -700,6 +940,10 @@ PackedFunc GraphExecutor::GetFunction(const String& name, const ObjectPtr<Object
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumInputs(); });
   } else if (name == "run") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Run(); });
+  } else if (name == "set_inter_op_parallelism") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      this->SetInterOpParallelism(args[0], args.size() > 1 ? args[1].operator int() : 0);
+    });
   } else if (name == "run_from_inputs") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
@@ -93,6 +93,18 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   const char* type_key() const final { return "GraphExecutor"; }
   void Run();
 
+  ~GraphExecutor();
+
+  /*!
+   * \brief Run the independent nodes of the graph concurrently, in the order of their
+   *  dependencies, instead of one by one.
+   * \param num_inter_op_threads The number of threads running the nodes, where 1 restores the
+   *  sequential execution.
+   * \param num_intra_op_threads The number of threads each of them parallelizes an operator with,
+   *  where 0 keeps the default of the runtime.
+   */
+  void SetInterOpParallelism(int num_inter_op_threads, int num_intra_op_threads);
+
   /*! \brief Get the property of the runtime module .*/
   int GetPropertyMask() const final { return ModulePropertyMask::kRunnable; }
 
@@ -206,6 +218,13 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    */
   void ShareParams(const GraphExecutor& other, dmlc::Stream* strm);
 
+  /*!
+   * \brief Share the storage of the parameters loaded in a GraphExecutor of the same graph,
+   *  releasing the storage this executor allocated for them.
+   * \param other A GraphExecutor instance of the same graph, with |LoadParams| called.
+   */
+  void ShareParamStorage(const GraphExecutor& other);
+
   /*!
    * \brief Get total number of nodes.
    * \return Total number of nodes.
@@ -320,6 +339,10 @@ class TVM_DLL GraphExecutor : public ModuleNode {
     std::vector<std::string> dltype;
     std::vector<std::string> storage_scope;
     std::vector<std::vector<int64_t>> shape;
+    // The offset of each storage in the arena of its device, -1 if not in an arena.
+    std::vector<int64_t> storage_offset;
+    std::vector<int> arena_device_index;
+    std::vector<int64_t> arena_size;
     // The graph attribute fields.
     void Load(dmlc::JSONReader* reader) {
       reader->BeginObject();
@@ -370,6 +393,30 @@ class TVM_DLL GraphExecutor : public ModuleNode {
           ICHECK(reader->NextArrayItem());
           reader->Read(&device_index);
           ICHECK(!reader->NextArrayItem());
+        } else if (key == "storage_offset") {
+          reader->BeginArray();
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&type);
+          ICHECK_EQ(type, "list_int");
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&storage_offset);
+          ICHECK(!reader->NextArrayItem());
+        } else if (key == "arena_device_index") {
+          reader->BeginArray();
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&type);
+          ICHECK_EQ(type, "list_int");
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&arena_device_index);
+          ICHECK(!reader->NextArrayItem());
+        } else if (key == "arena_size") {
+          reader->BeginArray();
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&type);
+          ICHECK_EQ(type, "list_int");
+          ICHECK(reader->NextArrayItem());
+          reader->Read(&arena_size);
+          ICHECK(!reader->NextArrayItem());
         } else {
           reader->BeginArray();
           ICHECK(reader->NextArrayItem());
@@ -442,6 +489,12 @@ class TVM_DLL GraphExecutor : public ModuleNode {
    */
   std::pair<std::function<void()>, std::shared_ptr<OpArgs>> CreateTVMOp(
       const TVMOpParam& attrs, const std::vector<DLTensor*>& args);
+  /*!
+   * \brief Collect the dependencies between the nodes for the concurrent execution, including
+   *  those between the nodes sharing a storage in the memory plan, or overlapping storages in an
+   *  arena.
+   */
+  void SetupOpDependencies();
   // Get node entry index.
   uint32_t entry_id(uint32_t nid, uint32_t index) const { return node_row_ptr_[nid] + index; }
   // Get node entry index.
@@ -480,12 +533,23 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   std::vector<Device> devices_;
   /*! \brief Common storage pool for all devices. */
   std::vector<NDArray> storage_pool_;
+  /*! \brief The arena of each device type, which the storages with an offset are views of. */
+  std::unordered_map<int, NDArray> arenas_;
+  /*! \brief The storages overlapping each storage in its arena, including itself. */
+  std::vector<std::vector<uint32_t>> storage_aliases_;
   /*! \brief Data entry of each node. */
   std::vector<NDArray> data_entry_;
   /*! \brief Data alignment of each node. */
   std::vector<size_t> data_alignment_;
   /*! \brief Operator on each node. */
   std::vector<std::function<void()>> op_execs_;
+  /*! \brief The nodes that may only run after each node. */
+  std::vector<std::vector<uint32_t>> op_successors_;
+  /*! \brief The number of nodes each node may only run after. */
+  std::vector<uint32_t> op_num_predecessors_;
+  /*! \brief The threads running the nodes concurrently, or null to run them one by one. */
+  class InterOpPool;
+  std::unique_ptr<InterOpPool> inter_op_pool_;
   /*! \brief Linked parameter lookup function. */
   PackedFunc lookup_linked_param_;
   /*! \brief Module's _lookup_linked_param function, used by DefaultLookupLinkedParam. */
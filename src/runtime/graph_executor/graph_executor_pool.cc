@@ -0,0 +1,314 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file graph_executor_pool.cc
+ * \brief Serving concurrent requests with a pool of activation contexts of one graph.
+ *
+ * Every context is a GraphExecutor of the graph with its own activations, and all of them share
+ * the parameters loaded in the first one, as well as the compiled functions of the module.  A
+ * request takes a free context, runs on it, and copies the outputs out, so that at most the given
+ * number of requests run concurrently however many threads submit them.
+ *
+ * When the graph is compiled with a batch size B > 1 on the first axis of its inputs and
+ * outputs, the single-sample requests can be micro-batched as well.  The first pending request
+ * waits for up to B - 1 others, or the maximum delay, and runs all of them as one batch.
+ */
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/map.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "graph_executor.h"
+
+namespace tvm {
+namespace runtime {
+
+class GraphExecutorPool : public ModuleNode {
+ public:
+  GraphExecutorPool(const std::string& graph_json, const Module& module,
+                    const std::vector<Device>& devs, int num_contexts) {
+    CHECK_GE(num_contexts, 1) << "ValueError: The pool requires at least one context, but got "
+                              << num_contexts;
+    for (int i = 0; i < num_contexts; ++i) {
+      auto exec = make_object<GraphExecutor>();
+      exec->Init(graph_json, module, devs, PackedFunc());
+      contexts_.push_back(exec);
+    }
+    in_use_ = std::make_unique<std::atomic<bool>[]>(num_contexts);
+    for (int i = 0; i < num_contexts; ++i) {
+      in_use_[i].store(false);
+    }
+  }
+
+  const char* type_key() const final { return "GraphExecutorPool"; }
+
+  PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "load_params") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        this->LoadParams(args[0].operator std::string());
+      });
+    } else if (name == "run") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = this->Run(args[0]);
+      });
+    } else if (name == "run_batched") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = this->RunBatched(args[0]);
+      });
+    } else if (name == "set_max_batch_delay") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        int64_t delay_us = args[0];
+        CHECK_GE(delay_us, 0) << "ValueError: The maximum batch delay should be non-negative";
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        max_batch_delay_us_ = delay_us;
+      });
+    } else if (name == "get_num_contexts") {
+      return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+        *rv = static_cast<int>(contexts_.size());
+      });
+    }
+    return PackedFunc();
+  }
+
+ private:
+  /*! \brief A pending request of the micro-batching. */
+  struct Request {
+    Map<String, NDArray> inputs;
+    Array<NDArray> outputs;
+    std::exception_ptr error = nullptr;
+    bool done = false;
+  };
+
+  /*! \brief Load the parameters into the first context, and share them with the others. */
+  void LoadParams(const std::string& param_blob) {
+    // The contexts may not be in use while their parameters are replaced.
+    std::vector<int> acquired;
+    for (size_t i = 0; i < contexts_.size(); ++i) {
+      acquired.push_back(Acquire());
+    }
+    contexts_[0]->LoadParams(param_blob);
+    for (size_t i = 1; i < contexts_.size(); ++i) {
+      contexts_[i]->ShareParamStorage(*contexts_[0]);
+    }
+    for (int i : acquired) {
+      Release(i);
+    }
+  }
+
+  /*! \brief Take a free context, waiting for one if all of them are in use. */
+  int Acquire() {
+    int num_contexts = static_cast<int>(contexts_.size());
+    while (true) {
+      int start = next_context_.fetch_add(1, std::memory_order_relaxed) % num_contexts;
+      for (int k = 0; k < num_contexts; ++k) {
+        int i = (start + k) % num_contexts;
+        bool expected = false;
+        if (in_use_[i].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+          return i;
+        }
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  void Release(int i) { in_use_[i].store(false, std::memory_order_release); }
+
+  static int InputIndex(GraphExecutor* exec, const String& name) {
+    int in_idx = exec->GetInputIndex(name);
+    CHECK_GE(in_idx, 0) << "ValueError: " << name << " is not a valid input name";
+    return in_idx;
+  }
+
+  /*! \brief Run a request on a free context, and return a copy of its outputs. */
+  Array<NDArray> Run(const Map<String, NDArray>& inputs) {
+    int i = Acquire();
+    Array<NDArray> outputs;
+    try {
+      GraphExecutor* exec = contexts_[i].get();
+      for (const auto& [name, value] : inputs) {
+        exec->SetInput(InputIndex(exec, name), const_cast<DLTensor*>(value.operator->()));
+      }
+      exec->Run();
+      for (int j = 0; j < exec->NumOutputs(); ++j) {
+        NDArray out = exec->GetOutput(j);
+        NDArray copy = NDArray::Empty(out.Shape(), out.DataType(), out->device);
+        copy.CopyFrom(out);
+        outputs.push_back(copy);
+      }
+    } catch (...) {
+      Release(i);
+      throw;
+    }
+    Release(i);
+    return outputs;
+  }
+
+  /*! \brief The batch size of the graph, i.e. the size of the first axis of an input. */
+  int64_t BatchSize(const Map<String, NDArray>& inputs) const {
+    CHECK(!inputs.empty()) << "ValueError: A micro-batched request requires at least one input";
+    GraphExecutor* exec = contexts_[0].get();
+    ShapeTuple shape = exec->GetInput(InputIndex(exec, (*inputs.begin()).first)).Shape();
+    CHECK(!shape.empty()) << "ValueError: The inputs of the graph have no batch axis";
+    return shape[0];
+  }
+
+  /*!
+   * \brief Copy between the row of a batched array and a single-sample array.
+   * \param batched The batched array, of shape (B, ...).
+   * \param row The row of the batched array.
+   * \param sample The single-sample array, of shape (1, ...).
+   * \param to_batched Whether to copy the sample into the row, or the row into the sample.
+   */
+  static void CopyRow(const NDArray& batched, int64_t row, const NDArray& sample,
+                      bool to_batched) {
+    DLTensor view = *batched.operator->();
+    CHECK(view.ndim >= 1 && view.shape[0] > row)
+        << "ValueError: The batched array of shape " << batched.Shape() << " has no row " << row;
+    std::vector<int64_t> shape(view.shape, view.shape + view.ndim);
+    shape[0] = 1;
+    view.shape = shape.data();
+    view.strides = nullptr;
+    view.byte_offset += row * GetDataSize(view);
+    DLTensor* sample_tensor = const_cast<DLTensor*>(sample.operator->());
+    if (to_batched) {
+      NDArray::CopyFromTo(sample_tensor, &view);
+    } else {
+      NDArray::CopyFromTo(&view, sample_tensor);
+    }
+  }
+
+  /*! \brief Run a batch of single-sample requests on a free context as one batch. */
+  void RunBatch(const std::vector<Request*>& batch) {
+    int i = Acquire();
+    try {
+      GraphExecutor* exec = contexts_[i].get();
+      for (size_t row = 0; row < batch.size(); ++row) {
+        for (const auto& [name, value] : batch[row]->inputs) {
+          CopyRow(exec->GetInput(InputIndex(exec, name)), row, value, /*to_batched=*/true);
+        }
+      }
+      exec->Run();
+      for (size_t row = 0; row < batch.size(); ++row) {
+        for (int j = 0; j < exec->NumOutputs(); ++j) {
+          NDArray out = exec->GetOutput(j);
+          std::vector<int64_t> shape(out.Shape().begin(), out.Shape().end());
+          CHECK(!shape.empty()) << "ValueError: Output " << j << " has no batch axis";
+          shape[0] = 1;
+          NDArray sample = NDArray::Empty(ShapeTuple(shape), out.DataType(), out->device);
+          CopyRow(out, row, sample, /*to_batched=*/false);
+          batch[row]->outputs.push_back(sample);
+        }
+      }
+    } catch (...) {
+      Release(i);
+      throw;
+    }
+    Release(i);
+  }
+
+  /*!
+   * \brief Run a single-sample request in a micro-batch with the other pending ones.
+   *
+   * The first pending request leads the next batch: it waits until the batch is full or the
+   * maximum delay passes, takes the batch out of the queue, and runs it.  The other requests
+   * wait until they are done, or until they lead the next batch.
+   */
+  Array<NDArray> RunBatched(const Map<String, NDArray>& inputs) {
+    int64_t batch_size = BatchSize(inputs);
+    if (batch_size == 1) return Run(inputs);
+
+    Request request;
+    request.inputs = inputs;
+    std::unique_lock<std::mutex> lock(batch_mutex_);
+    pending_.push_back(&request);
+    batch_cv_.notify_all();
+    batch_cv_.wait(lock, [&]() { return request.done || pending_.front() == &request; });
+    if (!request.done) {
+      auto deadline =
+          std::chrono::steady_clock::now() + std::chrono::microseconds(max_batch_delay_us_);
+      batch_cv_.wait_until(lock, deadline, [&]() {
+        return static_cast<int64_t>(pending_.size()) >= batch_size;
+      });
+      std::vector<Request*> batch;
+      while (!pending_.empty() && static_cast<int64_t>(batch.size()) < batch_size) {
+        batch.push_back(pending_.front());
+        pending_.pop_front();
+      }
+      // The next pending request leads the next batch meanwhile.
+      batch_cv_.notify_all();
+      lock.unlock();
+      std::exception_ptr error = nullptr;
+      try {
+        RunBatch(batch);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      for (Request* r : batch) {
+        r->error = error;
+        r->done = true;
+      }
+      batch_cv_.notify_all();
+    }
+    lock.unlock();
+    if (request.error) std::rethrow_exception(request.error);
+    return request.outputs;
+  }
+
+  /*! \brief The contexts, where the first one owns the parameters. */
+  std::vector<ObjectPtr<GraphExecutor>> contexts_;
+  /*! \brief Whether each context is in use. */
+  std::unique_ptr<std::atomic<bool>[]> in_use_;
+  /*! \brief The context to start looking for a free one from, spreading the requests. */
+  std::atomic<int> next_context_{0};
+
+  std::mutex batch_mutex_;
+  std::condition_variable batch_cv_;
+  /*! \brief The requests waiting for a batch, where the first one leads it. */
+  std::deque<Request*> pending_;
+  /*! \brief The time the leader of a batch waits for it to be full. */
+  int64_t max_batch_delay_us_ = 1000;
+};
+
+TVM_REGISTER_GLOBAL("tvm.graph_executor_pool.create").set_body([](TVMArgs args, TVMRetValue* rv) {
+  ICHECK_GE(args.num_args, 5) << "The expected number of arguments for graph_executor_pool.create "
+                                 "is at least 5, but it has "
+                              << args.num_args;
+  std::string graph_json = args[0];
+  Module module = args[1];
+  int num_contexts = args[2];
+  const auto& devices = GetAllDevice(args, 3);
+  *rv = Module(make_object<GraphExecutorPool>(graph_json, module, devices, num_contexts));
+});
+
+}  // namespace runtime
+}  // namespace tvm
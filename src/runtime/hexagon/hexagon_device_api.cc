@@ -28,8 +28,11 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #include "../workspace_pool.h"
 #include "hexagon_common.h"
@@ -190,6 +193,155 @@ void HexagonDeviceAPI::CopyDataFromTo(const void* from, size_t from_offset, void
   memcpy(static_cast<char*>(to) + to_offset, static_cast<const char*>(from) + from_offset, size);
 }
 
+thread_local HexagonDeviceAPI::ParallelWorker* HexagonDeviceAPI::current_parallel_worker = nullptr;
+
+struct HexagonDeviceAPI::ParallelTask {
+  FTVMParallelLambda flambda;
+  void* cdata;
+  TVMParallelGroupEnv* penv;
+  int task_id;
+  ParallelWorker* worker;
+  int ret;
+  qurt_sem_t done;
+};
+
+void HexagonDeviceAPI::DispatchToThread(TVMStreamHandle thread, void (*f)(void*), void* args) {
+  bool success = ThreadManager()->Dispatch(thread, f, args);
+  while (!success) {
+    success = ThreadManager()->Dispatch(thread, f, args);
+  }
+}
+
+void HexagonDeviceAPI::InitParallelWorkers() {
+  if (!parallel_workers.empty()) {
+    return;
+  }
+  for (HardwareResourceType type : hw_resources) {
+    if (type == HVX_0 || type == HVX_1 || type == HVX_2 || type == HVX_3) {
+      ParallelWorker worker;
+      worker.thread = ThreadManager()->GetStreamHandleByResourceType(type);
+      if (parallel_vtcm_slice_bytes > 0) {
+        worker.vtcm_slice = VtcmPool()->Allocate(parallel_vtcm_slice_bytes);
+      }
+      parallel_workers.push_back(std::move(worker));
+    }
+  }
+  // The threads wait for Start before running anything dispatched to them.
+  ThreadManager()->Start();
+  for (ParallelWorker& worker : parallel_workers) {
+    DispatchToThread(
+        worker.thread,
+        [](void* w) { static_cast<ParallelWorker*>(w)->dma = std::make_unique<HexagonUserDMA>(); },
+        &worker);
+  }
+  ThreadManager()->WaitOnThreads();
+}
+
+void HexagonDeviceAPI::ReleaseParallelWorkers() {
+  if (parallel_workers.empty()) {
+    return;
+  }
+  for (ParallelWorker& worker : parallel_workers) {
+    DispatchToThread(
+        worker.thread, [](void* w) { static_cast<ParallelWorker*>(w)->dma.reset(); }, &worker);
+  }
+  ThreadManager()->WaitOnThreads();
+  for (ParallelWorker& worker : parallel_workers) {
+    if (worker.vtcm_slice != nullptr) {
+      VtcmPool()->Free(worker.vtcm_slice, parallel_vtcm_slice_bytes);
+    }
+  }
+  parallel_workers.clear();
+}
+
+void HexagonDeviceAPI::RunParallelTask(void* arg) {
+  ParallelTask* task = static_cast<ParallelTask*>(arg);
+  current_parallel_worker = task->worker;
+  task->ret = (*task->flambda)(task->task_id, task->penv, task->cdata);
+  current_parallel_worker = nullptr;
+  qurt_sem_up(&task->done);
+}
+
+bool HexagonDeviceAPI::ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task,
+                                      int sync_stride, int* ret) {
+  if (current_parallel_worker != nullptr) {
+    // The HVX threads are all busy with the enclosing launch, so a nested one runs serially.
+    std::atomic<int32_t> sync_counter{0};
+    TVMParallelGroupEnv env;
+    env.num_task = 1;
+    env.sync_handle = &sync_counter;
+    *ret = (*flambda)(0, &env, cdata);
+    return true;
+  }
+  if (runtime_threads == nullptr) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(parallel_mutex);
+  InitParallelWorkers();
+  int num_workers = static_cast<int>(parallel_workers.size());
+  num_task = num_task == 0 ? num_workers : std::min(num_task, num_workers);
+
+  std::unique_ptr<std::atomic<int>[]> sync_counter(new std::atomic<int>[num_task * sync_stride]);
+  for (int i = 0; i < num_task; ++i) {
+    sync_counter[i * sync_stride].store(0, std::memory_order_relaxed);
+  }
+  TVMParallelGroupEnv env;
+  env.num_task = num_task;
+  env.sync_handle = sync_counter.get();
+
+  std::vector<ParallelTask> tasks(num_task);
+  for (int i = 0; i < num_task; ++i) {
+    ParallelTask& task = tasks[i];
+    task.flambda = flambda;
+    task.cdata = cdata;
+    task.penv = &env;
+    task.task_id = i;
+    task.worker = &parallel_workers[i];
+    task.ret = 0;
+    qurt_sem_init_val(&task.done, 0);
+    DispatchToThread(task.worker->thread, RunParallelTask, &task);
+  }
+  *ret = 0;
+  for (ParallelTask& task : tasks) {
+    qurt_sem_down(&task.done);
+    qurt_sem_destroy(&task.done);
+    if (task.ret != 0) {
+      *ret = task.ret;
+    }
+  }
+  return true;
+}
+
+void* HexagonDeviceAPI::ParallelVtcmSlice(size_t* nbytes) {
+  if (current_parallel_worker == nullptr) {
+    *nbytes = 0;
+    return nullptr;
+  }
+  *nbytes = current_parallel_worker->vtcm_slice != nullptr ? parallel_vtcm_slice_bytes : 0;
+  return current_parallel_worker->vtcm_slice;
+}
+
+void HexagonDeviceAPI::SetParallelVtcmSliceBytes(size_t nbytes) {
+  std::lock_guard<std::mutex> lock(parallel_mutex);
+  for (ParallelWorker& worker : parallel_workers) {
+    if (worker.vtcm_slice != nullptr) {
+      VtcmPool()->Free(worker.vtcm_slice, parallel_vtcm_slice_bytes);
+      worker.vtcm_slice = nullptr;
+    }
+    if (nbytes > 0) {
+      worker.vtcm_slice = VtcmPool()->Allocate(nbytes);
+    }
+  }
+  parallel_vtcm_slice_bytes = nbytes;
+}
+
+// Called by TVMBackendParallelLaunch, which routes the parallel loops on Hexagon here.
+bool HexagonParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task, int sync_stride,
+                           int* ret) {
+  return HexagonDeviceAPI::Global()->ParallelLaunch(flambda, cdata, num_task, sync_stride, ret);
+}
+
 TVM_REGISTER_GLOBAL("device_api.hexagon.dma_copy_dltensor")
     .set_body([](TVMArgs args, TVMRetValue* rv) {
       DLTensor* dst = args[0];
@@ -225,6 +377,51 @@ TVM_REGISTER_GLOBAL("device_api.hexagon.dma_copy").set_body([](TVMArgs args, TVM
   *rv = static_cast<int32_t>(ret);
 });
 
+TVM_REGISTER_GLOBAL("device_api.hexagon.dma_copy_tiles")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      uint32_t queue_id = static_cast<int>(args[0]);
+      void* dst_ptr = args[1];
+      void* src_ptr = args[2];
+      char* dst = static_cast<char*>(dst_ptr);
+      char* src = static_cast<char*>(src_ptr);
+      uint32_t tile_size = static_cast<int>(args[3]);
+      int num_tiles = args[4];
+      int64_t dst_stride = args[5];
+      int64_t src_stride = args[6];
+      bool bypass_cache = args[7];
+      ICHECK(tile_size > 0);
+      ICHECK(num_tiles > 0);
+
+      HexagonUserDMA* user_dma = HexagonDeviceAPI::Global()->UserDMA();
+      // the tiles are waited for as one group, even when they take several chains
+      bool own_group = !user_dma->GroupStarted(queue_id);
+      if (own_group) {
+        user_dma->StartGroup(queue_id);
+      }
+      std::vector<void*> dsts, srcs;
+      std::vector<uint32_t> lengths;
+      for (int begin = 0; begin < num_tiles; begin += MAX_DMA_DESCRIPTORS) {
+        int end = std::min(begin + MAX_DMA_DESCRIPTORS, num_tiles);
+        dsts.clear();
+        srcs.clear();
+        lengths.assign(end - begin, tile_size);
+        for (int i = begin; i < end; ++i) {
+          dsts.push_back(dst + i * dst_stride);
+          srcs.push_back(src + i * src_stride);
+        }
+        int ret = DMA_RETRY;
+        do {
+          ret = user_dma->CopyChain(queue_id, end - begin, dsts.data(), srcs.data(),
+                                    lengths.data(), bypass_cache);
+        } while (ret == DMA_RETRY);
+        CHECK(ret == DMA_SUCCESS);
+      }
+      if (own_group) {
+        user_dma->EndGroup(queue_id);
+      }
+      *rv = static_cast<int32_t>(DMA_SUCCESS);
+    });
+
 TVM_REGISTER_GLOBAL("device_api.hexagon.dma_wait").set_body([](TVMArgs args, TVMRetValue* rv) {
   uint32_t queue_id = static_cast<int>(args[0]);
   int inflight = args[1];
@@ -246,6 +443,20 @@ TVM_REGISTER_GLOBAL("device_api.hexagon.dma_end_group").set_body([](TVMArgs args
   *rv = static_cast<int32_t>(0);
 });
 
+TVM_REGISTER_GLOBAL("device_api.hexagon.parallel_vtcm_slice")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      size_t nbytes = 0;
+      *rv = HexagonDeviceAPI::Global()->ParallelVtcmSlice(&nbytes);
+    });
+
+TVM_REGISTER_GLOBAL("device_api.hexagon.set_parallel_vtcm_slice_bytes")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      int64_t nbytes = args[0];
+      ICHECK_GE(nbytes, 0);
+      HexagonDeviceAPI::Global()->SetParallelVtcmSliceBytes(static_cast<size_t>(nbytes));
+      *rv = static_cast<int32_t>(0);
+    });
+
 TVM_REGISTER_GLOBAL("device_api.hexagon.alloc_nd").set_body([](TVMArgs args, TVMRetValue* rv) {
   int32_t device_type = args[0];
   int32_t device_id = args[1];
@@ -20,10 +20,12 @@
 #ifndef TVM_RUNTIME_HEXAGON_HEXAGON_DEVICE_API_H_
 #define TVM_RUNTIME_HEXAGON_HEXAGON_DEVICE_API_H_
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/device_api.h>
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -75,6 +77,8 @@ class HexagonDeviceAPI final : public DeviceAPI {
 
   //! \brief Ensures all runtime resources are freed
   void ReleaseResources() {
+    ReleaseParallelWorkers();
+
     CHECK(runtime_dma) << "runtime_dma was not created in AcquireResources";
     runtime_dma.reset();
 
@@ -153,7 +157,12 @@ class HexagonDeviceAPI final : public DeviceAPI {
     return runtime_threads.get();
   }
 
+  //! \brief The user DMA of the calling thread; the HVX threads running a parallel task each
+  //! have their own, since the DMA engine belongs to the hardware thread that issues `dmstart`.
   HexagonUserDMA* UserDMA() {
+    if (current_parallel_worker != nullptr) {
+      return current_parallel_worker->dma.get();
+    }
     CHECK(runtime_dma) << "runtime_dma has not been created";
     return runtime_dma.get();
   }
@@ -163,6 +172,36 @@ class HexagonDeviceAPI final : public DeviceAPI {
     return runtime_vtcm.get();
   }
 
+  /*!
+   * \brief Run a parallel lambda on the HVX threads of the thread manager.
+   *
+   * One task runs on each HVX thread, so num_task is capped by the number of HVX threads (and
+   * means all of them when it is 0). A launch nested in a parallel task runs serially on the
+   * calling thread.
+   *
+   * \param flambda The parallel lambda.
+   * \param cdata The closure data of the lambda.
+   * \param num_task The number of tasks to launch.
+   * \param sync_stride The stride between the barrier counters of two tasks.
+   * \param ret The return value of the launch, nonzero when any of the tasks failed.
+   * \return Whether the lambda was launched, false when the runtime resources are not acquired.
+   */
+  bool ParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task, int sync_stride,
+                      int* ret);
+
+  /*!
+   * \brief The VTCM scratch slice owned by the parallel task running on the calling thread.
+   * \param nbytes The size of the slice in bytes, 0 when there is none.
+   * \return The slice, nullptr when the calling thread does not run a parallel task.
+   */
+  void* ParallelVtcmSlice(size_t* nbytes);
+
+  /*!
+   * \brief Set the size of the VTCM scratch slice given to each HVX thread, 0 for no slice.
+   * \param nbytes The size of each slice in bytes.
+   */
+  void SetParallelVtcmSliceBytes(size_t nbytes);
+
  protected:
   //! Standard Device API interface to copy data from one storage to another.
   void CopyDataFromTo(const void* from, size_t from_offset, void* to, size_t to_offset, size_t size,
@@ -199,6 +238,42 @@ class HexagonDeviceAPI final : public DeviceAPI {
 
   //! \brief Hexagon power manager
   std::unique_ptr<HexagonPowerManager> runtime_power_manager;
+
+  //! \brief An HVX thread running parallel tasks, with the resources private to its tasks.
+  struct ParallelWorker {
+    //! \brief The thread of the thread manager.
+    TVMStreamHandle thread{nullptr};
+    //! \brief The VTCM scratch slice of the thread.
+    void* vtcm_slice{nullptr};
+    //! \brief The user DMA of the thread, created and destroyed on the thread itself.
+    std::unique_ptr<HexagonUserDMA> dma;
+  };
+
+  struct ParallelTask;
+
+  //! \brief Create the parallel workers on the HVX threads, on the first parallel launch.
+  void InitParallelWorkers();
+
+  //! \brief Free the parallel workers before the thread manager and the VTCM pool go away.
+  void ReleaseParallelWorkers();
+
+  //! \brief Dispatch f(args) on a thread of the thread manager, retrying while its pipe is full.
+  void DispatchToThread(TVMStreamHandle thread, void (*f)(void*), void* args);
+
+  //! \brief Run one task of a parallel launch, dispatched to the thread of its worker.
+  static void RunParallelTask(void* task);
+
+  //! \brief The parallel workers, one per HVX thread.
+  std::vector<ParallelWorker> parallel_workers;
+
+  //! \brief The size of the VTCM scratch slice of each parallel worker.
+  size_t parallel_vtcm_slice_bytes{0x20000};  // 128KB
+
+  //! \brief Serializes the parallel launches of different threads.
+  std::mutex parallel_mutex;
+
+  //! \brief The parallel worker whose task runs on the calling thread, if any.
+  static thread_local ParallelWorker* current_parallel_worker;
 };
 }  // namespace hexagon
 }  // namespace runtime
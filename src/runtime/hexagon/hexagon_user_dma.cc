@@ -32,33 +32,30 @@ unsigned int HexagonUserDMA::Init() {
   return status;
 }
 
-int HexagonUserDMA::Copy(uint32_t queue_id, void* dst, void* src, uint32_t length,
-                         bool bypass_cache) {
+bool HexagonUserDMA::IsValidCopy(void* dst, void* src, uint32_t length) {
   // length limited to 24 bits
   if (length > DESC_LENGTH_MASK) {
-    return DMA_FAILURE;
+    return false;
   }
 
   // source address limited to 32 bits
   uint64_t src64 = reinterpret_cast<uint64_t>(src);
   if (!src64 || src64 > DESC_SRC_MASK) {
-    return DMA_FAILURE;
+    return false;
   }
 
   // destination address limited to 32 bits
   uint64_t dst64 = reinterpret_cast<uint64_t>(dst);
   if (!dst64 || dst64 > DESC_DST_MASK) {
-    return DMA_FAILURE;
+    return false;
   }
+  return true;
+}
 
-  uint32_t src32 = static_cast<uint32_t>(src64);
-  uint32_t dst32 = static_cast<uint32_t>(dst64);
-
-  // get pointer to next descriptor
-  dma_desc_2d_t* dma_desc = descriptors_->Next(queue_id);
-  if (!dma_desc) {
-    return DMA_RETRY;
-  }
+void HexagonUserDMA::SetDescriptor(dma_desc_2d_t* dma_desc, void* dst, void* src,
+                                   uint32_t length, bool bypass_cache) {
+  uint32_t src32 = static_cast<uint32_t>(reinterpret_cast<uint64_t>(src));
+  uint32_t dst32 = static_cast<uint32_t>(reinterpret_cast<uint64_t>(dst));
 
   // populate descriptor fields
   dma_desc_set_state(dma_desc, DESC_STATE_READY);
@@ -89,18 +86,69 @@ int HexagonUserDMA::Copy(uint32_t queue_id, void* dst, void* src, uint32_t lengt
   dma_desc_set_done(dma_desc, DESC_DONE_INCOMPLETE);
   dma_desc_set_src(dma_desc, src32);
   dma_desc_set_dst(dma_desc, dst32);
+}
+
+int HexagonUserDMA::Copy(uint32_t queue_id, void* dst, void* src, uint32_t length,
+                         bool bypass_cache) {
+  return CopyChain(queue_id, 1, &dst, &src, &length, bypass_cache);
+}
+
+int HexagonUserDMA::CopyChain(uint32_t queue_id, uint32_t num_copies, void* const* dsts,
+                              void* const* srcs, const uint32_t* lengths, bool bypass_cache) {
+  if (num_copies == 0) {
+    return DMA_SUCCESS;
+  }
+  if (num_copies > MAX_DMA_DESCRIPTORS) {
+    return DMA_FAILURE;
+  }
+  for (uint32_t i = 0; i < num_copies; ++i) {
+    if (!IsValidCopy(dsts[i], srcs[i], lengths[i])) {
+      return DMA_FAILURE;
+    }
+  }
+
+  // the chain is initiated whole or not at all
+  if (descriptors_->Free() < num_copies) {
+    return DMA_RETRY;
+  }
+
+  // track the chain as a single group, unless it is part of a started group
+  bool own_group = !descriptors_->GroupStarted(queue_id);
+  if (own_group) {
+    descriptors_->StartGroup(queue_id);
+  }
+
+  // link the descriptors to each other before the DMA engine sees any of them
+  dma_desc_2d_t* head_dma_desc = nullptr;
+  dma_desc_2d_t* last_dma_desc = nullptr;
+  for (uint32_t i = 0; i < num_copies; ++i) {
+    dma_desc_2d_t* dma_desc = descriptors_->Next(queue_id);
+    ICHECK(dma_desc);
+    SetDescriptor(dma_desc, dsts[i], srcs[i], lengths[i], bypass_cache);
+    if (last_dma_desc) {
+      dma_desc_set_next(last_dma_desc,
+                        static_cast<unsigned int>(reinterpret_cast<uintptr_t>(dma_desc)));
+    } else {
+      head_dma_desc = dma_desc;
+    }
+    last_dma_desc = dma_desc;
+  }
+
+  if (own_group) {
+    descriptors_->EndGroup(queue_id);
+  }
 
   if (first_dma_) {
     // `dmstart` first descriptor
-    dmstart(dma_desc);
+    dmstart(head_dma_desc);
     first_dma_ = false;
   } else {
-    // `dmlink` descriptor to tail descriptor
-    dmlink(tail_dma_desc_, dma_desc);
+    // `dmlink` the head of the chain to tail descriptor
+    dmlink(tail_dma_desc_, head_dma_desc);
   }
 
   // update tail
-  tail_dma_desc_ = dma_desc;
+  tail_dma_desc_ = last_dma_desc;
   return DMA_SUCCESS;
 }
 
@@ -56,6 +56,21 @@ class HexagonUserDMA {
    */
   int Copy(uint32_t queue_id, void* dst, void* src, uint32_t length, bool bypass_cache);
 
+  /*!
+   * \brief Initiate a chain of DMAs, linked together and handed to the DMA engine at once
+   * \param queue_id The virtual DMA queue
+   * \param num_copies Number of copies in the chain, at most MAX_DMA_DESCRIPTORS
+   * \param dsts Destination address of each copy
+   * \param srcs Source address of each copy
+   * \param lengths Length in bytes of each copy
+   * \returns Status: DMA_SUCCESS, DMA_FAILURE, or DMA_RETRY if there are not enough free
+   * descriptors for the whole chain, in which case no copy is initiated
+   *
+   * The chain is tracked as a single group, or added to the current group if one is started.
+   */
+  int CopyChain(uint32_t queue_id, uint32_t num_copies, void* const* dsts, void* const* srcs,
+                const uint32_t* lengths, bool bypass_cache);
+
   /*!
    * \brief Wait until the number of DMAs in flight is less than or equal to some maximum
    * \param queue_id The virtual DMA queue
@@ -83,10 +98,23 @@ class HexagonUserDMA {
    */
   void EndGroup(uint32_t queue_id) { descriptors_->EndGroup(queue_id); }
 
+  /*!
+   * \brief Whether a group of DMA copies is started
+   * \param queue_id The virtual DMA queue
+   */
+  bool GroupStarted(uint32_t queue_id) const { return descriptors_->GroupStarted(queue_id); }
+
  private:
   //! \brief Initializes the Hexagon User DMA engine
   unsigned int Init();
 
+  //! \brief Checks whether a copy fits the limits of a DMA descriptor
+  static bool IsValidCopy(void* dst, void* src, uint32_t length);
+
+  //! \brief Populates the fields of a DMA descriptor for a copy
+  static void SetDescriptor(dma_desc_2d_t* dma_desc, void* dst, void* src, uint32_t length,
+                            bool bypass_cache);
+
   /*!
    * \brief Calculates and returns the number of DMAs in flight
    * \param queue_id The virtual DMA queue
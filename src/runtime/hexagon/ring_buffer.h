@@ -42,6 +42,9 @@ class RingBuffer {
     return id_next_ - id_oldest_;
   }
 
+  //! \brief Returns the number of Ts that can be added before the ring buffer is full
+  uint32_t Free() { return ring_buff_size_ - InFlight(); }
+
   //! \brief Returns pointer to next T; null if ring buffer is full
   T* Next() {
     if (InFlight() == ring_buff_size_) {
@@ -99,12 +102,19 @@ class QueuedRingBuffer : RingBuffer<T> {
   QueuedRingBuffer(uint32_t max_queues, uint32_t ring_buff_size, std::function<bool(T*)> in_flight)
       : RingBuffer<T>(ring_buff_size, in_flight), max_queues_(max_queues) {
     queue_descriptors_.resize(max_queues_);
+    queue_ids_.resize(ring_buff_size);
   }
 
-  //! \brief Returns pointer to next T; add the queue ID for tracking
+  using RingBuffer<T>::Free;
+
+  //! \brief Returns pointer to next T; add the queue ID for tracking; null if ring buffer is full
   T* Next(uint32_t queue_id) {
     CHECK_LT(queue_id, max_queues_);
-    queue_ids_.push_back(queue_id);
+    T* next = RingBuffer<T>::Next();
+    if (!next) {
+      return nullptr;
+    }
+    queue_ids_[num_issued_++ % queue_ids_.size()] = queue_id;
     queue_descriptor* d = &queue_descriptors_[queue_id];
     if (d->group_started) {
       // if we have a group started just update then pending count
@@ -114,7 +124,7 @@ class QueuedRingBuffer : RingBuffer<T> {
       d->groups.push(1);
       d->pending_total++;
     }
-    return RingBuffer<T>::Next();
+    return next;
   }
 
   //! \brief Returns the number of groups of Ts in flight for a given queue ID
@@ -125,9 +135,9 @@ class QueuedRingBuffer : RingBuffer<T> {
 
     uint32_t in_flight = 0;
     // look at the queue IDs for the RingBuffer entries in flight
-    for (size_t i = queue_ids_.size() - RingBuffer<T>::InFlight(); i < queue_ids_.size(); ++i) {
+    for (uint32_t id = num_issued_ - RingBuffer<T>::InFlight(); id != num_issued_; ++id) {
       // increment return value if in flight queue ID matches
-      if (queue_ids_[i] == queue_id) {
+      if (queue_ids_[id % queue_ids_.size()] == queue_id) {
         in_flight++;
       }
     }
@@ -142,6 +152,12 @@ class QueuedRingBuffer : RingBuffer<T> {
     return d->groups.size();
   }
 
+  //! \brief Returns whether a group of Ts is started for a given queue ID
+  bool GroupStarted(uint32_t queue_id) const {
+    CHECK_LT(queue_id, max_queues_);
+    return queue_descriptors_[queue_id].group_started;
+  }
+
   //! \brief Start a group of Ts, if not called the deafault group size is one
   void StartGroup(uint32_t queue_id) {
     CHECK_LT(queue_id, max_queues_);
@@ -180,7 +196,11 @@ class QueuedRingBuffer : RingBuffer<T> {
   };
 
   const int max_queues_;
+  //! \brief The queue IDs of the Ts, indexed by the order they were added modulo the size of the
+  //! ring buffer, so that only the Ts that may be in flight are tracked
   std::vector<int> queue_ids_;
+  //! \brief The number of Ts added to the ring buffer
+  uint32_t num_issued_ = 0;
   std::vector<queue_descriptor> queue_descriptors_;
 };
 
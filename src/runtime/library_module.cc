@@ -27,6 +27,7 @@
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/registry.h>
 
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -67,8 +68,61 @@ class LibraryModuleNode final : public ModuleNode {
   PackedFuncWrapper packed_func_wrapper_;
 };
 
-PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& sptr_to_self) {
-  return PackedFunc([faddr, sptr_to_self](TVMArgs args, TVMRetValue* rv) {
+/*!
+ * \brief A module in the module blob of a library, loaded on its first use.
+ *
+ *  The binary of the module stays in the memory of the library until then, so that
+ *  device modules whose functions are never called are never loaded.
+ */
+class LazyImportModuleNode final : public ModuleNode {
+ public:
+  LazyImportModuleNode(ObjectPtr<Library> lib, std::string type_key, const char* data,
+                       size_t size)
+      : lib_(lib), type_key_(std::move(type_key)), data_(data), size_(size) {}
+
+  const char* type_key() const final { return type_key_.c_str(); }
+
+  int GetPropertyMask() const final { return ModulePropertyMask::kBinarySerializable; }
+
+  PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) final {
+    // The imports of this module are queried by the caller, not by the loaded module.
+    return Load()->GetFunction(name, /*query_imports=*/false);
+  }
+
+  void SaveToBinary(dmlc::Stream* stream) final { stream->Write(data_, size_); }
+
+  String GetSource(const String& format) final { return Load()->GetSource(format); }
+
+  String GetFormat() final { return Load()->GetFormat(); }
+
+ private:
+  Module Load() {
+    std::call_once(load_flag_, [this]() {
+      dmlc::MemoryFixedSizeStream stream(const_cast<char*>(data_), size_);
+      module_ = LoadModuleFromBinary(type_key_, &stream);
+    });
+    return module_;
+  }
+
+  /*! \brief The library holding the binary. */
+  ObjectPtr<Library> lib_;
+  /*! \brief The type key of the module. */
+  std::string type_key_;
+  /*! \brief The binary of the module, as written by its SaveToBinary. */
+  const char* data_;
+  size_t size_;
+  /*! \brief The loaded module. */
+  Module module_;
+  std::once_flag load_flag_;
+};
+
+namespace {
+/*! \brief The callable of the PackedFuncs created by WrapPackedFunc. */
+struct BackendPackedCFuncCaller {
+  TVMBackendPackedCFunc faddr;
+  ObjectPtr<Object> sptr_to_self;
+
+  void operator()(TVMArgs args, TVMRetValue* rv) const {
     TVMValue ret_value;
     int ret_type_code = kTVMNullptr;
     auto arg_values = const_cast<TVMValue*>(args.values);
@@ -84,7 +138,30 @@ PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>&
     if (ret_type_code != kTVMNullptr) {
       *rv = TVMRetValue::MoveFromCHost(ret_value, ret_type_code);
     }
-  });
+  }
+};
+
+using BackendPackedCFuncObj = PackedFuncSubObj<BackendPackedCFuncCaller>;
+
+/*! \brief Helper to tell the PackedFuncObj created from BackendPackedCFuncCaller. */
+struct BackendPackedCFuncChecker : public PackedFuncObj {
+  static bool Check(const PackedFuncObj* obj) {
+    return obj->*(&BackendPackedCFuncChecker::f_call_packed_) ==
+           &Extractor<BackendPackedCFuncObj>::Call;
+  }
+};
+}  // namespace
+
+PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& sptr_to_self) {
+  return PackedFunc(BackendPackedCFuncCaller{faddr, sptr_to_self});
+}
+
+TVMBackendPackedCFunc GetBackendPackedCFunc(const PackedFunc& func) {
+  const auto* obj = static_cast<const PackedFuncObj*>(func.get());
+  if (obj == nullptr || !BackendPackedCFuncChecker::Check(obj)) {
+    return nullptr;
+  }
+  return static_cast<const BackendPackedCFuncObj*>(obj)->callable_.faddr;
 }
 
 void InitContextFunctions(std::function<void*(const char*)> fgetsymbol) {
@@ -168,6 +245,18 @@ void ProcessModuleBlob(const char* mblob, ObjectPtr<Library> lib,
     } else if (tkey == "_import_tree") {
       ICHECK(stream->Read(&import_tree_row_ptr));
       ICHECK(stream->Read(&import_tree_child_indices));
+    } else if (tkey == "_lazy") {
+      // "_lazy" is followed by the type key and the size-prefixed binary of a module
+      // to be loaded on its first use.
+      std::string mod_type_key;
+      uint64_t mod_nbytes;
+      ICHECK(stream->Read(&mod_type_key));
+      ICHECK(stream->Read(&mod_nbytes));
+      size_t offset = fs.Tell();
+      ICHECK_LE(offset + mod_nbytes, nbytes) << "Corrupted module blob";
+      modules.emplace_back(make_object<LazyImportModuleNode>(
+          lib, mod_type_key, mblob + sizeof(nbytes) + offset, mod_nbytes));
+      fs.Seek(offset + mod_nbytes);
     } else {
       auto m = LoadModuleFromBinary(tkey, stream);
       modules.emplace_back(m);
@@ -73,6 +73,16 @@ class Library : public Object {
  */
 PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& mptr);
 
+/*!
+ * \brief Get the TVMBackendPackedCFunc wrapped in a packed function by WrapPackedFunc.
+ * Callers can invoke the function address directly to skip the packed function call.
+ * The packed function must be kept alive as it holds the module of the function.
+ * \param func The packed function.
+ * \return The function address, or nullptr if the packed function is not created by
+ *  WrapPackedFunc.
+ */
+TVMBackendPackedCFunc GetBackendPackedCFunc(const PackedFunc& func);
+
 /*!
  * \brief Utility to initialize conext function symbols during startup
  * \param fgetsymbol A symbol lookup function.
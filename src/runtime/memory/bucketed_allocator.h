@@ -0,0 +1,286 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/memory/bucketed_allocator.h
+ * \brief A pooled allocator with geometric size classes, best-fit lookup
+ *  and splitting/coalescing of large device blocks.
+ *
+ * Differences to PooledAllocator:
+ *  - Requests are rounded to geometric size classes (kSizeClassesPerDoubling
+ *    classes per power of two) instead of plain page multiples.
+ *  - A free buffer can serve any request it covers as long as the wasted
+ *    fraction stays below max_waste_ratio (best-fit).
+ *  - On devices with a flat address space, large blocks are split to serve
+ *    smaller requests and adjacent free blocks are coalesced on free.
+ *  - On allocation failure only fully free segments are released before
+ *    retrying, the blocks carved out of live segments stay cached.
+ */
+#ifndef TVM_RUNTIME_MEMORY_BUCKETED_ALLOCATOR_H_
+#define TVM_RUNTIME_MEMORY_BUCKETED_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/memory/memory_manager.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace tvm {
+namespace runtime {
+namespace memory {
+
+class BucketedAllocator : public Allocator {
+ public:
+  static constexpr size_t kDefaultPageSize = 4096;
+  /*! \brief The number of size classes between two consecutive powers of two. */
+  static constexpr size_t kSizeClassesPerDoubling = 4;
+  /*! \brief The default upper bound of (block size - request size) / request size. */
+  static constexpr double kDefaultMaxWasteRatio = 0.25;
+  /*! \brief Requests no smaller than this may be carved out of larger free blocks. */
+  static constexpr size_t kDefaultSplitThreshold = 1 << 20;
+
+  explicit BucketedAllocator(size_t page_size = kDefaultPageSize,
+                             double max_waste_ratio = kDefaultMaxWasteRatio,
+                             size_t split_threshold = kDefaultSplitThreshold)
+      : Allocator(kBucketed),
+        page_size_(page_size),
+        max_waste_ratio_(max_waste_ratio),
+        split_threshold_(split_threshold),
+        used_memory_(0) {}
+
+  ~BucketedAllocator() { ReleaseAll(); }
+
+  Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) override {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    size_t size = RoundToSizeClass(nbytes);
+    if (Block* block = FindBestFit(dev, size, alignment)) {
+      RecordAlloc(nbytes, block->size);
+      return MakeBuffer(block);
+    }
+    Block* block = new Block();
+    block->device = dev;
+    block->size = size;
+    block->splittable = SupportsSplit(dev);
+    try {
+      block->data = DeviceAllocDataSpace(dev, size, alignment, type_hint);
+    } catch (InternalError& err) {
+      LOG(WARNING) << "BucketedAllocator got InternalError during allocation: " << err.message();
+      LOG(WARNING) << "Trying to release all unused segments and reallocate...";
+      ReleaseAll();
+      RecordOOMRetry();
+      try {
+        block->data = DeviceAllocDataSpace(dev, size, alignment, type_hint);
+      } catch (InternalError&) {
+        delete block;
+        throw;
+      }
+    }
+    used_memory_.fetch_add(size, std::memory_order_relaxed);
+    RecordDeviceAlloc(size);
+    RecordAlloc(nbytes, size);
+    VLOG(1) << "allocate " << size << " B, used memory " << used_memory_ << " B";
+    return MakeBuffer(block);
+  }
+
+  Buffer Alloc(Device dev, ShapeTuple shape, DLDataType type_hint,
+               const std::string& mem_scope) override {
+    if (AllowMemoryScope(mem_scope)) {
+      return Allocator::Alloc(dev, shape, type_hint, mem_scope);
+    }
+    LOG(FATAL) << "This alloc should be implemented";
+    return {};
+  }
+
+  void Free(const Buffer& buffer) override {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    auto it = allocated_blocks_.find(buffer.data);
+    ICHECK(it != allocated_blocks_.end())
+        << "BucketedAllocator cannot free buffer " << buffer.data << " it did not allocate";
+    Block* block = it->second;
+    allocated_blocks_.erase(it);
+    block->allocated = false;
+    RecordFree(block->size);
+    // Coalesce with the free neighbours inside the same device segment.
+    if (Block* next = block->next; next != nullptr && !next->allocated) {
+      free_blocks_.erase({next->size, next});
+      block->size += next->size;
+      block->next = next->next;
+      if (block->next != nullptr) block->next->prev = block;
+      delete next;
+    }
+    if (Block* prev = block->prev; prev != nullptr && !prev->allocated) {
+      free_blocks_.erase({prev->size, prev});
+      prev->size += block->size;
+      prev->next = block->next;
+      if (prev->next != nullptr) prev->next->prev = prev;
+      delete block;
+      block = prev;
+    }
+    free_blocks_.insert({block->size, block});
+    VLOG(1) << "reclaim buffer " << buffer.size;
+  }
+
+  void Clear() override { ReleaseAll(); }
+
+  size_t UsedMemory() const override { return used_memory_.load(std::memory_order_relaxed); }
+
+ protected:
+  /*! \brief A contiguous range of device memory, either a whole segment or part of it. */
+  struct Block {
+    Device device;
+    void* data{nullptr};
+    size_t size{0};
+    bool allocated{false};
+    /*! \brief Whether the segment lives in a flat address space and can be split. */
+    bool splittable{false};
+    /*! \brief The neighbouring blocks inside the same segment. */
+    Block* prev{nullptr};
+    Block* next{nullptr};
+  };
+
+  virtual void* DeviceAllocDataSpace(Device dev, size_t nbytes, size_t alignment,
+                                     DLDataType type_hint) {
+    return DeviceAPI::Get(dev)->AllocDataSpace(dev, nbytes, alignment, type_hint);
+  }
+
+  virtual void DeviceFreeDataSpace(Device dev, void* ptr) {
+    DeviceAPI::Get(dev)->FreeDataSpace(dev, ptr);
+  }
+
+  /*!
+   * \brief Release every segment that is entirely free.
+   *
+   * Free blocks that are part of a segment still in use stay cached, as
+   * the device API cannot return a part of an allocation.
+   */
+  virtual void ReleaseAll() {
+    std::lock_guard<std::recursive_mutex> lock(mu_);
+    for (auto it = free_blocks_.begin(); it != free_blocks_.end();) {
+      Block* block = it->second;
+      if (block->prev == nullptr && block->next == nullptr) {
+        DeviceFreeDataSpace(block->device, block->data);
+        used_memory_.fetch_sub(block->size, std::memory_order_relaxed);
+        RecordDeviceFree(block->size);
+        delete block;
+        it = free_blocks_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    VLOG(1) << "release all unused segments, used memory " << used_memory_ << " B";
+  }
+
+  /*! \brief Round the request up to its geometric size class. */
+  size_t RoundToSizeClass(size_t nbytes) const {
+    size_t size = std::max<size_t>((nbytes + page_size_ - 1) / page_size_, 1) * page_size_;
+    if (size <= page_size_ * kSizeClassesPerDoubling) return size;
+    size_t msb = 1;
+    while ((msb << 1) <= size) msb <<= 1;
+    size_t step = std::max<size_t>(msb / kSizeClassesPerDoubling / page_size_, 1) * page_size_;
+    return (size + step - 1) / step * step;
+  }
+
+  /*! \brief Whether pointers into allocations of the device can be offset. */
+  static bool SupportsSplit(Device dev) {
+    switch (static_cast<int>(dev.device_type)) {
+      case kDLCPU:
+      case kDLCUDA:
+      case kDLCUDAHost:
+      case kDLROCM:
+      case kDLROCMHost:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /*!
+   * \brief Look up the smallest cached block that can serve the request.
+   * \return The block marked as allocated, or nullptr if no block matches.
+   */
+  Block* FindBestFit(Device dev, size_t size, size_t alignment) {
+    size_t max_size = size + static_cast<size_t>(static_cast<double>(size) * max_waste_ratio_);
+    bool can_split = size >= split_threshold_ && alignment <= page_size_ &&
+                     page_size_ % std::max<size_t>(alignment, 1) == 0;
+    for (auto it = free_blocks_.lower_bound({size, nullptr}); it != free_blocks_.end(); ++it) {
+      Block* block = it->second;
+      if (block->device.device_type != dev.device_type ||
+          block->device.device_id != dev.device_id) {
+        continue;
+      }
+      if (block->size <= max_size) {
+        free_blocks_.erase(it);
+        block->allocated = true;
+        return block;
+      }
+      if (can_split && block->splittable) {
+        free_blocks_.erase(it);
+        Block* rest = new Block();
+        rest->device = block->device;
+        rest->data = static_cast<char*>(block->data) + size;
+        rest->size = block->size - size;
+        rest->splittable = true;
+        rest->prev = block;
+        rest->next = block->next;
+        if (rest->next != nullptr) rest->next->prev = rest;
+        block->next = rest;
+        block->size = size;
+        block->allocated = true;
+        free_blocks_.insert({rest->size, rest});
+        return block;
+      }
+      // Blocks are ordered by size, every later block wastes even more.
+      if (!can_split) break;
+    }
+    return nullptr;
+  }
+
+  Buffer MakeBuffer(Block* block) {
+    block->allocated = true;
+    allocated_blocks_[block->data] = block;
+    Buffer buf;
+    buf.device = block->device;
+    buf.data = block->data;
+    buf.size = block->size;
+    buf.alloc_type = kBucketed;
+    return buf;
+  }
+
+ protected:
+  size_t page_size_;
+  double max_waste_ratio_;
+  size_t split_threshold_;
+  std::atomic<size_t> used_memory_;
+  /*! \brief Free blocks ordered by (size, address) for best-fit lookup. */
+  std::set<std::pair<size_t, Block*>> free_blocks_;
+  /*! \brief The blocks handed out to users, indexed by data pointer. */
+  std::unordered_map<void*, Block*> allocated_blocks_;
+  std::recursive_mutex mu_;
+};
+
+}  // namespace memory
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_MEMORY_BUCKETED_ALLOCATOR_H_
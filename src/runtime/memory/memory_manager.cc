@@ -21,14 +21,19 @@
  * \file tvm/runtime/memory/memory_manager.cc
  * \brief Allocate and manage memory for the runtime.
  */
+#include <tvm/runtime/container/boxed_primitive.h>
+#include <tvm/runtime/container/map.h>
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/registry.h>
 
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "bucketed_allocator.h"
 #include "naive_allocator.h"
 #include "pooled_allocator.h"
+#include "stream_ordered_allocator.h"
 
 namespace tvm {
 namespace runtime {
@@ -66,6 +71,14 @@ void StorageObj::Deleter(Object* obj) {
   delete ptr;
 }
 
+bool StorageObj::WaitForLastWrite(TVMStreamHandle stream) {
+  if (!has_pending_write_ || last_writer_stream_ == stream) {
+    return false;
+  }
+  DeviceAPI::Get(buffer.device)->SyncStreamFromTo(buffer.device, last_writer_stream_, stream);
+  return true;
+}
+
 inline void VerifyDataType(DLDataType dtype) {
   ICHECK_GE(dtype.lanes, 1);
   if (dtype.code == kDLFloat) {
@@ -144,7 +157,18 @@ Allocator* MemoryManager::GetOrCreateAllocator(Device dev, AllocatorType type) {
       }
       case kPooled: {
         VLOG(1) << "New pooled allocator for " << dev;
-        alloc.reset(new PooledAllocator());
+        alloc.reset(new PooledAllocator(PooledAllocator::kDefaultPageSize,
+                                        PooledAllocator::kDefaultThreadCacheHighWaterMark));
+        break;
+      }
+      case kBucketed: {
+        VLOG(1) << "New bucketed allocator for " << dev;
+        alloc.reset(new BucketedAllocator());
+        break;
+      }
+      case kStreamOrdered: {
+        VLOG(1) << "New stream-ordered allocator for " << dev;
+        alloc.reset(new StreamOrderedAllocator());
         break;
       }
       default:
@@ -176,6 +200,28 @@ Allocator* MemoryManager::GetAllocator(Device dev, AllocatorType type) {
   return it->second.at(type).get();
 }
 
+ThreadCacheCounters MemoryManager::GetThreadCacheCounters(Device dev, AllocatorType type) {
+  MemoryManager* m = MemoryManager::Global();
+  std::lock_guard<std::mutex> lock(m->mu_);
+  auto it = m->allocators_.find(dev);
+  if (it == m->allocators_.end() || it->second.find(type) == it->second.end()) {
+    return ThreadCacheCounters();
+  }
+  return it->second.at(type)->GetThreadCacheCounters();
+}
+
+AllocatorStats MemoryManager::GetStats(Device dev, AllocatorType type) {
+  MemoryManager* m = MemoryManager::Global();
+  std::lock_guard<std::mutex> lock(m->mu_);
+  auto it = m->allocators_.find(dev);
+  if (it == m->allocators_.end() || it->second.find(type) == it->second.end()) {
+    AllocatorStats stats;
+    stats.size_histogram.resize(AllocatorStats::kNumSizeBuckets, 0);
+    return stats;
+  }
+  return it->second.at(type)->GetStats();
+}
+
 void MemoryManager::Clear() {
   MemoryManager* m = MemoryManager::Global();
   std::lock_guard<std::mutex> lock(m->mu_);
@@ -228,8 +274,80 @@ void Allocator::Clear() {
   // Pooled allocator will override this method.
 }
 
+ThreadCacheCounters Allocator::GetThreadCacheCounters() const { return ThreadCacheCounters(); }
+
+AllocatorStats Allocator::GetStats() const {
+  AllocatorStats stats;
+  stats.reserved_bytes = reserved_bytes_.load(std::memory_order_relaxed);
+  stats.peak_reserved_bytes = peak_reserved_bytes_.load(std::memory_order_relaxed);
+  stats.in_use_bytes = in_use_bytes_.load(std::memory_order_relaxed);
+  stats.peak_in_use_bytes = peak_in_use_bytes_.load(std::memory_order_relaxed);
+  // The counters are sampled independently, clamp the transient skew.
+  stats.cached_bytes =
+      stats.reserved_bytes > stats.in_use_bytes ? stats.reserved_bytes - stats.in_use_bytes : 0;
+  stats.alloc_count = alloc_count_.load(std::memory_order_relaxed);
+  stats.free_count = free_count_.load(std::memory_order_relaxed);
+  stats.device_alloc_count = device_alloc_count_.load(std::memory_order_relaxed);
+  stats.device_free_count = device_free_count_.load(std::memory_order_relaxed);
+  stats.oom_retry_count = oom_retry_count_.load(std::memory_order_relaxed);
+  stats.size_histogram.reserve(AllocatorStats::kNumSizeBuckets);
+  for (const auto& count : size_histogram_) {
+    stats.size_histogram.push_back(count.load(std::memory_order_relaxed));
+  }
+  stats.thread_cache = GetThreadCacheCounters();
+  return stats;
+}
+
+/*! \brief Convert the statistics to a map that can be passed through the FFI. */
+Map<String, ObjectRef> AllocatorStatsToMap(const AllocatorStats& stats) {
+  Map<String, ObjectRef> ret;
+  ret.Set("reserved_bytes", Int(static_cast<int64_t>(stats.reserved_bytes)));
+  ret.Set("peak_reserved_bytes", Int(static_cast<int64_t>(stats.peak_reserved_bytes)));
+  ret.Set("in_use_bytes", Int(static_cast<int64_t>(stats.in_use_bytes)));
+  ret.Set("peak_in_use_bytes", Int(static_cast<int64_t>(stats.peak_in_use_bytes)));
+  ret.Set("cached_bytes", Int(static_cast<int64_t>(stats.cached_bytes)));
+  ret.Set("alloc_count", Int(static_cast<int64_t>(stats.alloc_count)));
+  ret.Set("free_count", Int(static_cast<int64_t>(stats.free_count)));
+  ret.Set("device_alloc_count", Int(static_cast<int64_t>(stats.device_alloc_count)));
+  ret.Set("device_free_count", Int(static_cast<int64_t>(stats.device_free_count)));
+  ret.Set("oom_retry_count", Int(static_cast<int64_t>(stats.oom_retry_count)));
+  ret.Set("size_histogram", ShapeTuple(std::vector<int64_t>(stats.size_histogram.begin(),
+                                                            stats.size_histogram.end())));
+  ret.Set("thread_cache_hits", Int(static_cast<int64_t>(stats.thread_cache.hits)));
+  ret.Set("thread_cache_misses", Int(static_cast<int64_t>(stats.thread_cache.misses)));
+  ret.Set("thread_cache_flushes", Int(static_cast<int64_t>(stats.thread_cache.flushes)));
+  return ret;
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.storage_record_write")
+    .set_body_typed([](Storage storage, void* stream) { storage->RecordWrite(stream); });
+
+TVM_REGISTER_GLOBAL("vm.builtin.storage_wait_for_last_write")
+    .set_body_typed([](Storage storage, void* stream) {
+      return storage->WaitForLastWrite(stream);
+    });
+
 TVM_REGISTER_GLOBAL("vm.builtin.memory_manager.clear").set_body_typed(MemoryManager::Clear);
 
+TVM_REGISTER_GLOBAL("vm.builtin.memory_manager.thread_cache_counters")
+    .set_body_typed([](int device_type, int device_id, int alloc_type) {
+      Device dev{static_cast<DLDeviceType>(device_type), device_id};
+      ThreadCacheCounters counters =
+          MemoryManager::GetThreadCacheCounters(dev, static_cast<AllocatorType>(alloc_type));
+      Map<String, ObjectRef> ret;
+      ret.Set("hits", Int(static_cast<int64_t>(counters.hits)));
+      ret.Set("misses", Int(static_cast<int64_t>(counters.misses)));
+      ret.Set("flushes", Int(static_cast<int64_t>(counters.flushes)));
+      return ret;
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.memory_manager.stats")
+    .set_body_typed([](int device_type, int device_id, int alloc_type) {
+      Device dev{static_cast<DLDeviceType>(device_type), device_id};
+      return AllocatorStatsToMap(
+          MemoryManager::GetStats(dev, static_cast<AllocatorType>(alloc_type)));
+    });
+
 }  // namespace memory
 }  // namespace runtime
 }  // namespace tvm
@@ -44,6 +44,8 @@ class NaiveAllocator final : public Allocator {
     buf.alloc_type = kNaive;
     buf.data = DeviceAPI::Get(dev)->AllocDataSpace(dev, nbytes, alignment, type_hint);
     used_memory_.fetch_add(nbytes, std::memory_order_relaxed);
+    RecordDeviceAlloc(nbytes);
+    RecordAlloc(nbytes, nbytes);
     DLOG(INFO) << "allocate " << nbytes << " B, used memory " << used_memory_ << " B";
     return buf;
   }
@@ -69,6 +71,8 @@ class NaiveAllocator final : public Allocator {
     buf.data = DeviceAPI::Get(dev)->AllocDataSpace(dev, shape.size(), shape.data(), type_hint,
                                                    String(mem_scope));
     used_memory_.fetch_add(nbytes, std::memory_order_relaxed);
+    RecordDeviceAlloc(nbytes);
+    RecordAlloc(nbytes, nbytes);
     DLOG(INFO) << "allocate " << nbytes << " B, used memory " << used_memory_ << " B";
     buf.alloc_type = kNaive;
     return buf;
@@ -77,6 +81,8 @@ class NaiveAllocator final : public Allocator {
   void Free(const Buffer& buffer) override {
     DeviceAPI::Get(buffer.device)->FreeDataSpace(buffer.device, buffer.data);
     used_memory_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    RecordFree(buffer.size);
+    RecordDeviceFree(buffer.size);
     DLOG(INFO) << "free " << buffer.size << " B, used memory " << used_memory_ << " B";
   }
 
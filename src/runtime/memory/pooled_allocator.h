@@ -27,6 +27,7 @@
 #include <tvm/runtime/memory/memory_manager.h>
 
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -36,23 +37,60 @@ namespace tvm {
 namespace runtime {
 namespace memory {
 
+/*!
+ * \brief A pooled allocator which caches freed buffers by their page-rounded size.
+ *
+ * When a thread cache is enabled, small buffers freed by a thread are kept in
+ * a cache owned by that thread and served to its later allocations without
+ * taking the shared pool lock. A thread cache holding more than the high-water
+ * mark flushes half of its bytes back to the shared pool in one batch.
+ */
 class PooledAllocator : public Allocator {
  public:
   static constexpr size_t kDefaultPageSize = 4096;
+  /*! \brief Default bytes a thread cache may hold before it is flushed. */
+  static constexpr size_t kDefaultThreadCacheHighWaterMark = 16 << 20;
+  /*! \brief Buffers larger than this always go through the shared pool. */
+  static constexpr size_t kThreadCacheMaxBufferSize = 1 << 20;
 
-  explicit PooledAllocator(size_t page_size = kDefaultPageSize)
-      : Allocator(kPooled), page_size_(page_size), used_memory_(0) {}
+  /*!
+   * \param page_size The granularity the requests are rounded up to.
+   * \param thread_cache_high_water_mark The bytes a thread cache may hold,
+   *  zero disables the thread caches.
+   */
+  explicit PooledAllocator(size_t page_size = kDefaultPageSize,
+                           size_t thread_cache_high_water_mark = 0)
+      : Allocator(kPooled),
+        page_size_(page_size),
+        used_memory_(0),
+        thread_cache_high_water_mark_(thread_cache_high_water_mark),
+        thread_cache_id_(NextThreadCacheId()) {}
 
   ~PooledAllocator() { ReleaseAll(); }
 
   Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) override {
-    std::lock_guard<std::recursive_mutex> lock(mu_);
     size_t size = ((nbytes + page_size_ - 1) / page_size_) * page_size_;
+    if (UseThreadCache(size)) {
+      ThreadCache* cache = GetThreadCache();
+      std::lock_guard<std::mutex> lock(cache->mu);
+      auto it = cache->pool.find(size);
+      if (it != cache->pool.end() && !it->second.empty()) {
+        auto ret = it->second.back();
+        it->second.pop_back();
+        cache->cached_bytes -= size;
+        thread_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+        RecordAlloc(nbytes, size);
+        return ret;
+      }
+      thread_cache_misses_.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::lock_guard<std::recursive_mutex> lock(mu_);
     auto&& it = memory_pool_.find(size);
     if (it != memory_pool_.end() && !it->second.empty()) {
       auto&& pool = it->second;
       auto ret = pool.back();
       pool.pop_back();
+      RecordAlloc(nbytes, size);
       return ret;
     }
     Buffer buf;
@@ -65,10 +103,13 @@ class PooledAllocator : public Allocator {
       LOG(WARNING) << "PooledAllocator got InternalError during allocation: " << err.message();
       LOG(WARNING) << "Trying to release all unused memory and reallocate...";
       ReleaseAll();
+      RecordOOMRetry();
       buf.data = DeviceAllocDataSpace(dev, size, alignment, type_hint);
     }
 
     used_memory_.fetch_add(size, std::memory_order_relaxed);
+    RecordDeviceAlloc(size);
+    RecordAlloc(nbytes, size);
     VLOG(1) << "allocate " << size << " B, used memory " << used_memory_ << " B";
     return buf;
   }
@@ -83,6 +124,26 @@ class PooledAllocator : public Allocator {
   }
 
   void Free(const Buffer& buffer) override {
+    RecordFree(buffer.size);
+    if (UseThreadCache(buffer.size)) {
+      std::vector<Buffer> flushed;
+      ThreadCache* cache = GetThreadCache();
+      {
+        std::lock_guard<std::mutex> lock(cache->mu);
+        cache->pool[buffer.size].push_back(buffer);
+        cache->cached_bytes += buffer.size;
+        if (cache->cached_bytes <= thread_cache_high_water_mark_) return;
+        flushed = cache->TakeBatch(cache->cached_bytes / 2);
+      }
+      // Return the batch to the shared pool with a single lock acquisition.
+      std::lock_guard<std::recursive_mutex> lock(mu_);
+      for (const Buffer& buf : flushed) {
+        memory_pool_[buf.size].push_back(buf);
+      }
+      thread_cache_flushes_.fetch_add(1, std::memory_order_relaxed);
+      VLOG(1) << "flush " << flushed.size() << " buffers from thread cache";
+      return;
+    }
     std::lock_guard<std::recursive_mutex> lock(mu_);
     if (memory_pool_.find(buffer.size) == memory_pool_.end()) {
       memory_pool_.emplace(buffer.size, std::vector<Buffer>{});
@@ -95,7 +156,38 @@ class PooledAllocator : public Allocator {
 
   size_t UsedMemory() const override { return used_memory_.load(std::memory_order_relaxed); }
 
+  ThreadCacheCounters GetThreadCacheCounters() const override {
+    ThreadCacheCounters counters;
+    counters.hits = thread_cache_hits_.load(std::memory_order_relaxed);
+    counters.misses = thread_cache_misses_.load(std::memory_order_relaxed);
+    counters.flushes = thread_cache_flushes_.load(std::memory_order_relaxed);
+    return counters;
+  }
+
  protected:
+  /*! \brief The buffers cached by one thread. */
+  struct ThreadCache {
+    /*! \brief Only contended when the allocator drains all thread caches. */
+    std::mutex mu;
+    std::unordered_map<size_t, std::vector<Buffer>> pool;
+    size_t cached_bytes{0};
+
+    /*! \brief Remove at least the given number of bytes from the cache. */
+    std::vector<Buffer> TakeBatch(size_t nbytes) {
+      std::vector<Buffer> batch;
+      size_t taken = 0;
+      for (auto it = pool.begin(); it != pool.end() && taken < nbytes; ++it) {
+        while (!it->second.empty() && taken < nbytes) {
+          batch.push_back(it->second.back());
+          it->second.pop_back();
+          taken += batch.back().size;
+        }
+      }
+      cached_bytes -= taken;
+      return batch;
+    }
+  };
+
   virtual void* DeviceAllocDataSpace(Device dev, size_t nbytes, size_t alignment,
                                      DLDataType type_hint) {
     return DeviceAPI::Get(dev)->AllocDataSpace(dev, nbytes, alignment, type_hint);
@@ -107,10 +199,12 @@ class PooledAllocator : public Allocator {
 
   virtual void ReleaseAll() {
     std::lock_guard<std::recursive_mutex> lock(mu_);
+    DrainThreadCaches(/*drain_all=*/true);
     for (auto const& it : memory_pool_) {
       auto const& pool = it.second;
       for (auto const& buf : pool) {
         DeviceFreeDataSpace(buf.device, buf.data);
+        RecordDeviceFree(buf.size);
       }
     }
     memory_pool_.clear();
@@ -118,11 +212,66 @@ class PooledAllocator : public Allocator {
     VLOG(1) << "release all buffers";
   }
 
+  bool UseThreadCache(size_t size) const {
+    return thread_cache_high_water_mark_ != 0 && size <= kThreadCacheMaxBufferSize;
+  }
+
+  /*! \brief Get the cache of the calling thread, creating it on first use. */
+  ThreadCache* GetThreadCache() {
+    // Keyed by a never-reused id rather than `this`, so that a new allocator
+    // at a recycled address does not pick up a stale cache.
+    static thread_local std::unordered_map<uint64_t, std::shared_ptr<ThreadCache>> caches;
+    auto it = caches.find(thread_cache_id_);
+    if (it != caches.end()) return it->second.get();
+    auto cache = std::make_shared<ThreadCache>();
+    {
+      std::lock_guard<std::recursive_mutex> lock(mu_);
+      // A new thread is a good time to reclaim the caches of exited threads.
+      DrainThreadCaches(/*drain_all=*/false);
+      thread_caches_.push_back(cache);
+    }
+    caches.emplace(thread_cache_id_, cache);
+    return cache.get();
+  }
+
+  /*!
+   * \brief Move cached buffers back to the shared pool. Requires mu_ to be held.
+   * \param drain_all Whether to drain every cache, or only the caches of exited threads.
+   */
+  void DrainThreadCaches(bool drain_all) {
+    for (auto it = thread_caches_.begin(); it != thread_caches_.end();) {
+      // The registry holds the last reference once the owning thread exits.
+      bool orphan = it->use_count() == 1;
+      if (drain_all || orphan) {
+        std::lock_guard<std::mutex> cache_lock((*it)->mu);
+        for (auto& kv : (*it)->pool) {
+          auto& pool = memory_pool_[kv.first];
+          pool.insert(pool.end(), kv.second.begin(), kv.second.end());
+        }
+        (*it)->pool.clear();
+        (*it)->cached_bytes = 0;
+      }
+      it = orphan ? thread_caches_.erase(it) : it + 1;
+    }
+  }
+
+  static uint64_t NextThreadCacheId() {
+    static std::atomic<uint64_t> next_id{0};
+    return next_id.fetch_add(1, std::memory_order_relaxed);
+  }
+
  protected:
   size_t page_size_;
   std::atomic<size_t> used_memory_;
   std::unordered_map<size_t, std::vector<Buffer>> memory_pool_;
   std::recursive_mutex mu_;
+  size_t thread_cache_high_water_mark_;
+  uint64_t thread_cache_id_;
+  /*! \brief The caches of all threads that used this allocator, guarded by mu_. */
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches_;
+  std::atomic<uint64_t> thread_cache_hits_{0};
+  std::atomic<uint64_t> thread_cache_misses_{0};
+  std::atomic<uint64_t> thread_cache_flushes_{0};
 };
 
 }  // namespace memory
@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/memory/stream_ordered_allocator.h
+ */
+#ifndef TVM_RUNTIME_MEMORY_STREAM_ORDERED_ALLOCATOR_H_
+#define TVM_RUNTIME_MEMORY_STREAM_ORDERED_ALLOCATOR_H_
+
+#include <tvm/runtime/device_api.h>
+#include <tvm/runtime/memory/memory_manager.h>
+
+#include <atomic>
+#include <string>
+
+namespace tvm {
+namespace runtime {
+namespace memory {
+
+/*!
+ * \brief An allocator which allocates and frees on the current stream of the device.
+ *
+ *  The device API keeps the memory pool, e.g. cudaMallocAsync, so that neither a miss
+ *  nor a release synchronizes the device. A buffer is freed on the current stream of
+ *  the thread freeing it, which must be ordered after all the work using the buffer.
+ */
+class StreamOrderedAllocator final : public Allocator {
+ public:
+  StreamOrderedAllocator() : Allocator(kStreamOrdered) {}
+
+  Buffer Alloc(Device dev, size_t nbytes, size_t alignment, DLDataType type_hint) final {
+    DeviceAPI* api = DeviceAPI::Get(dev);
+    Buffer buf;
+    buf.device = dev;
+    buf.size = nbytes;
+    buf.alloc_type = kStreamOrdered;
+    buf.data =
+        api->AllocDataSpaceAsync(dev, nbytes, alignment, type_hint, api->GetCurrentStream(dev));
+    used_memory_.fetch_add(nbytes, std::memory_order_relaxed);
+    RecordDeviceAlloc(nbytes);
+    RecordAlloc(nbytes, nbytes);
+    return buf;
+  }
+
+  Buffer Alloc(Device dev, ShapeTuple shape, DLDataType type_hint,
+               const std::string& mem_scope) final {
+    ICHECK(AllowMemoryScope(mem_scope))
+        << "The stream-ordered allocator does not support the memory scope " << mem_scope;
+    return Allocator::Alloc(dev, shape, type_hint, mem_scope);
+  }
+
+  void Free(const Buffer& buffer) final {
+    DeviceAPI* api = DeviceAPI::Get(buffer.device);
+    api->FreeDataSpaceAsync(buffer.device, buffer.data, api->GetCurrentStream(buffer.device));
+    used_memory_.fetch_sub(buffer.size, std::memory_order_relaxed);
+    RecordFree(buffer.size);
+    RecordDeviceFree(buffer.size);
+  }
+
+  size_t UsedMemory() const final { return used_memory_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<size_t> used_memory_{0};
+};
+
+}  // namespace memory
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_MEMORY_STREAM_ORDERED_ALLOCATOR_H_
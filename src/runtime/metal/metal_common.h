@@ -28,6 +28,8 @@
 #import <Metal/MTLBuffer.h>
 #import <Metal/MTLCommandBuffer.h>
 #import <Metal/MTLCommandQueue.h>
+#import <Metal/MTLComputeCommandEncoder.h>
+#import <Metal/MTLComputePipeline.h>
 #import <Metal/MTLDevice.h>
 #import <Metal/MTLLibrary.h>
 #include <tvm/runtime/c_runtime_api.h>
@@ -104,25 +106,58 @@ class AutoReleasePoolWrapper {
 
 /*!
  * \brief Structure for error handling in queues
+ *
+ * \note When TVM_METAL_MAX_DISPATCHES_PER_COMMAND_BUFFER is set above 1, the
+ *  kernel launches are encoded into one pending compute encoder, whose
+ *  command buffer is committed once it holds that many dispatches, or before
+ *  any other command buffer of the stream (copies and StreamSync). The
+ *  dispatches of a serial compute encoder run in order, so the batching
+ *  does not change the semantics of the stream.
  */
 class Stream {
  public:
-  explicit Stream(id<MTLDevice> device) { queue_ = [device newCommandQueue]; }
-  ~Stream() { [queue_ release]; }
+  explicit Stream(id<MTLDevice> device);
+  ~Stream();
   id<MTLCommandBuffer> GetCommandBuffer(std::string label = "", bool attach_error_callback = true) {
     id<MTLCommandBuffer> cb = [queue_ commandBuffer];
     if (!label.empty()) {
       cb.label = [NSString stringWithUTF8String:label.c_str()];
     }
-    [cb addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
-      if (buffer.status == MTLCommandBufferStatusError) {
-        ICHECK(buffer.error != nil);
-        this->SetError(buffer.error.localizedDescription.UTF8String);
-      }
-    }];
+    if (attach_error_callback) {
+      [cb addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
+        if (buffer.status == MTLCommandBufferStatusError) {
+          ICHECK(buffer.error != nil);
+          this->SetError(buffer.error.localizedDescription.UTF8String);
+        }
+      }];
+    }
     return cb;
   }
 
+  /*! \brief Whether the kernel launches are batched into a pending command buffer. */
+  bool BatchDispatch() const { return max_dispatches_per_command_buffer_ > 1; }
+
+  /*!
+   * \brief Get the pending compute encoder, creating it and its command buffer if needed.
+   * \param kernel_name The name of the kernel to be encoded, used in the error message.
+   */
+  id<MTLComputeCommandEncoder> GetPendingComputeEncoder(const std::string& kernel_name);
+
+  /*! \brief Set the pipeline state of the pending encoder, if it is not already bound. */
+  void SetComputePipelineState(id<MTLComputePipelineState> state);
+
+  /*! \brief Bind a buffer to the pending encoder, if it is not already bound at the index. */
+  void SetBuffer(id<MTLBuffer> buffer, size_t index);
+
+  /*! \brief Set the bytes at an index of the pending encoder. */
+  void SetBytes(const void* bytes, size_t length, size_t index);
+
+  /*! \brief Record a dispatch of the pending encoder, flushing it once the batch is full. */
+  void CommitDispatch();
+
+  /*! \brief End the pending compute encoder and commit its command buffer, if any. */
+  void FlushCommandBuffer();
+
   void SetError(std::string error_description) {
     error_happened_ = true;
     error_description_ = std::move(error_description);
@@ -135,6 +170,17 @@ class Stream {
  private:
   // Queue
   id<MTLCommandQueue> queue_;
+  // The maximum number of dispatches of a pending command buffer.
+  int max_dispatches_per_command_buffer_{1};
+  // The pending command buffer and compute encoder, retained.
+  id<MTLCommandBuffer> pending_command_buffer_{nil};
+  id<MTLComputeCommandEncoder> pending_encoder_{nil};
+  // The number of dispatches in the pending encoder, and the last kernel.
+  int num_pending_dispatches_{0};
+  std::string last_pending_kernel_;
+  // The pipeline state and buffers bound to the pending encoder.
+  id<MTLComputePipelineState> bound_pipeline_state_{nil};
+  std::vector<id<MTLBuffer>> bound_buffers_;
   // Check if error happened in one previous run
   bool error_happened_{false};
   // error description
@@ -23,6 +23,11 @@
 #include <dmlc/thread_local.h>
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
 #include "metal_common.h"
 
 namespace tvm {
@@ -34,6 +39,88 @@ AutoReleasePoolWrapper& AutoReleasePoolWrapper::GetInstance() {
   return instance;
 }
 
+Stream::Stream(id<MTLDevice> device) {
+  queue_ = [device newCommandQueue];
+  if (const char* env = std::getenv("TVM_METAL_MAX_DISPATCHES_PER_COMMAND_BUFFER")) {
+    max_dispatches_per_command_buffer_ = std::max(std::atoi(env), 1);
+  }
+}
+
+Stream::~Stream() {
+  FlushCommandBuffer();
+  [queue_ release];
+}
+
+id<MTLComputeCommandEncoder> Stream::GetPendingComputeEncoder(const std::string& kernel_name) {
+  if (pending_encoder_ == nil) {
+    // The errors are reported with the kernel names when the buffer is flushed.
+    pending_command_buffer_ = [GetCommandBuffer(/*label=*/"TVMBatchedKernels",
+                                                /*attach_error_callback=*/false) retain];
+    pending_encoder_ = [[pending_command_buffer_ computeCommandEncoder] retain];
+    bound_pipeline_state_ = nil;
+    bound_buffers_.clear();
+  }
+  last_pending_kernel_ = kernel_name;
+  return pending_encoder_;
+}
+
+void Stream::SetComputePipelineState(id<MTLComputePipelineState> state) {
+  ICHECK(pending_encoder_ != nil);
+  if (bound_pipeline_state_ != state) {
+    [pending_encoder_ setComputePipelineState:state];
+    bound_pipeline_state_ = state;
+  }
+}
+
+void Stream::SetBuffer(id<MTLBuffer> buffer, size_t index) {
+  ICHECK(pending_encoder_ != nil);
+  if (bound_buffers_.size() <= index) {
+    bound_buffers_.resize(index + 1, nil);
+  }
+  if (bound_buffers_[index] != buffer) {
+    [pending_encoder_ setBuffer:buffer offset:0 atIndex:index];
+    bound_buffers_[index] = buffer;
+  }
+}
+
+void Stream::SetBytes(const void* bytes, size_t length, size_t index) {
+  ICHECK(pending_encoder_ != nil);
+  [pending_encoder_ setBytes:bytes length:length atIndex:index];
+  if (index < bound_buffers_.size()) {
+    bound_buffers_[index] = nil;
+  }
+}
+
+void Stream::CommitDispatch() {
+  if (++num_pending_dispatches_ >= max_dispatches_per_command_buffer_) {
+    FlushCommandBuffer();
+  }
+}
+
+void Stream::FlushCommandBuffer() {
+  if (pending_encoder_ == nil) return;
+  [pending_encoder_ endEncoding];
+  std::string last_kernel = last_pending_kernel_;
+  int num_dispatches = num_pending_dispatches_;
+  [pending_command_buffer_ addCompletedHandler:^(id<MTLCommandBuffer> buffer) {
+    if (buffer.status == MTLCommandBufferStatusError) {
+      ICHECK(buffer.error != nil);
+      std::ostringstream os;
+      os << "GPUError happens in a batch of " << num_dispatches << " kernels ending with "
+         << last_kernel << ": " << buffer.error.localizedDescription.UTF8String;
+      this->SetError(os.str());
+    }
+  }];
+  [pending_command_buffer_ commit];
+  [pending_encoder_ release];
+  [pending_command_buffer_ release];
+  pending_encoder_ = nil;
+  pending_command_buffer_ = nil;
+  bound_pipeline_state_ = nil;
+  bound_buffers_.clear();
+  num_pending_dispatches_ = 0;
+}
+
 MetalWorkspace* MetalWorkspace::Global() {
   // NOTE: explicitly use new to avoid exit-time destruction of global state
   // Global state will be recycled by OS as the process exits.
@@ -202,6 +289,11 @@ void MetalWorkspace::FreeDataSpace(Device dev, void* ptr) {
     // before set the purgeable state to empty
     // otherwise can cause issues sometimes
     this->StreamSync(dev, nullptr);
+    // The bindings cached by a pending encoder are keyed by the buffer address, which a
+    // later allocation may reuse, so the encoders of the current stream end here as well.
+    if (TVMStreamHandle stream = this->GetCurrentStream(dev)) {
+      static_cast<Stream*>(stream)->FlushCommandBuffer();
+    }
     // MTLBuffer PurgeableState should be set to empty before manual
     // release in order to prevent memory leak
     [(id<MTLBuffer>)ptr setPurgeableState:MTLPurgeableStateEmpty];
@@ -224,6 +316,8 @@ void MetalWorkspace::CopyDataFromTo(const void* from, size_t from_offset, void*
     Device dev = dev_from;
     if (dev_from.device_type == kDLCPU) dev = dev_to;
     Stream* s = this->CastStreamOrGetDefault(stream, dev.device_id);
+    // Keep the copy ordered after the batched kernel launches.
+    s->FlushCommandBuffer();
     if (s->HasErrorHappened()) {
       LOG(FATAL) << "GPUError: " << s->ErrorDescription();
     }
@@ -299,6 +393,7 @@ void MetalWorkspace::FreeStream(Device dev, TVMStreamHandle stream) {
 void MetalWorkspace::StreamSync(Device dev, TVMStreamHandle stream) {
   AUTORELEASEPOOL {
     Stream* s = CastStreamOrGetDefault(stream, dev.device_id);
+    s->FlushCommandBuffer();
     // commit an empty command buffer and wait until it completes.
     id<MTLCommandBuffer> cb = s->GetCommandBuffer(/*label=*/"TVMStreamSync");
     [cb commit];
@@ -205,6 +205,23 @@ class MetalWrappedFunc {
       int blockSize = wl.block_dim(0) * wl.block_dim(1) * wl.block_dim(2);
       auto maxTotalThreadsPerThreadgroup = scache_[device_id].maxTotalThreadsPerThreadgroup;
       CHECK_LE(blockSize, maxTotalThreadsPerThreadgroup);
+      MTLSize dimGrid = MTLSizeMake(wl.grid_dim(0), wl.grid_dim(1), wl.grid_dim(2));
+      MTLSize dimBlock = MTLSizeMake(wl.block_dim(0), wl.block_dim(1), wl.block_dim(2));
+      if (stream->BatchDispatch()) {
+        // Encode into the pending encoder of the stream, skipping the redundant bindings.
+        id<MTLComputeCommandEncoder> encoder = stream->GetPendingComputeEncoder(func_name_);
+        stream->SetComputePipelineState(scache_[device_id]);
+        for (size_t i = 0; i < num_buffer_args_; ++i) {
+          void* buf = args[static_cast<int>(i)];
+          stream->SetBuffer((id<MTLBuffer>)(buf), i);
+        }
+        if (num_pack_args_ != 0) {
+          stream->SetBytes(pack_args, num_pack_args_ * sizeof(ArgUnion64), num_buffer_args_);
+        }
+        [encoder dispatchThreadgroups:dimGrid threadsPerThreadgroup:dimBlock];
+        stream->CommitDispatch();
+        return;
+      }
       // attach error message directly in this functio
       id<MTLCommandBuffer> cb = stream->GetCommandBuffer(/*label=*/"TVMKernel:" + func_name_,
                                                          /*attach_error_callback=*/false);
@@ -220,8 +237,6 @@ class MetalWrappedFunc {
                   atIndex:num_buffer_args_];
       }
       // launch
-      MTLSize dimGrid = MTLSizeMake(wl.grid_dim(0), wl.grid_dim(1), wl.grid_dim(2));
-      MTLSize dimBlock = MTLSizeMake(wl.block_dim(0), wl.block_dim(1), wl.block_dim(2));
       [encoder dispatchThreadgroups:dimGrid threadsPerThreadgroup:dimBlock];
       [encoder endEncoding];
       // attach error message with function name
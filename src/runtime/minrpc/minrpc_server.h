@@ -600,7 +600,9 @@ class MinRPCServer {
     Read(&code);
     allow_clean_shutdown_ = false;
 
-    if (code >= RPCCode::kSyscallCodeStart) {
+    if (code == RPCCode::kBatch) {
+      HandleBatch();
+    } else if (code >= RPCCode::kSyscallCodeStart) {
       HandleSyscallFunc(code);
     } else {
       switch (code) {
@@ -732,6 +734,97 @@ class MinRPCServer {
     exec_handler_->SysCallFunc(code, values, tcodes, num_args);
   }
 
+  /*!
+   * \brief Run a batch of ops received in one packet, and send their results in one return.
+   *
+   *  The packet holds the number of ops as an int32, then for each op its RPCCode and:
+   *  - kCallFunc: the function handle and the packed arguments, as in a kCallFunc packet.
+   *  - kCopyToRemote: the tensor, the number of bytes and the bytes, as in a kCopyToRemote packet.
+   *  - a syscall code: the packed arguments, as in a syscall packet.
+   *  followed by the number of references as an int32, and the (argument index, op index) int32
+   *  pairs of the references. A reference replaces an argument with the handle returned by an
+   *  earlier op, e.g. the data allocated by kDevAllocData: the data of a tensor argument, or the
+   *  value of another argument. Index -1 refers to the function handle of kCallFunc, and index 0
+   *  to the tensor of kCopyToRemote.
+   *
+   *  The return holds two values per op, the type code of its return value and the value, which
+   *  are encoded as the return of kCallFunc. The ops after the first failing one are skipped, and
+   *  its error is returned instead.
+   */
+  void HandleBatch() {
+    int32_t num_ops;
+    Read(&num_ops);
+    MINRPC_CHECK(num_ops >= 0);
+    BatchOp* ops = ArenaAlloc<BatchOp>(num_ops);
+    // Receive the whole packet before running the ops, so that it is consumed when one fails.
+    for (int32_t i = 0; i < num_ops; ++i) {
+      BatchOp* op = &ops[i];
+      Read(&(op->code));
+      op->num_args = 0;
+      if (op->code == RPCCode::kCallFunc) {
+        Read(&(op->call_handle));
+        RecvPackedSeq(&(op->values), &(op->tcodes), &(op->num_args));
+      } else if (op->code == RPCCode::kCopyToRemote) {
+        op->arr = RPCReference::ReceiveDLTensor(this);
+        Read(&(op->num_bytes));
+        op->data = ArenaAlloc<uint8_t>(op->num_bytes);
+        ReadArray(op->data, op->num_bytes);
+      } else {
+        MINRPC_CHECK(op->code >= RPCCode::kSyscallCodeStart && op->code < RPCCode::kMuxCallFunc);
+        RecvPackedSeq(&(op->values), &(op->tcodes), &(op->num_args));
+      }
+      Read(&(op->num_refs));
+      MINRPC_CHECK(op->num_refs >= 0);
+      op->refs = ArenaAlloc<int32_t>(op->num_refs * 2);
+      ReadArray(op->refs, op->num_refs * 2);
+    }
+
+    TVMValue* ret_values = ArenaAlloc<TVMValue>(num_ops * 2);
+    int* ret_tcodes = ArenaAlloc<int>(num_ops * 2);
+    BatchReturns returns(this);
+    MinRPCExecute<TIOHandler> exec(io_, &returns);
+    for (int32_t i = 0; i < num_ops; ++i) {
+      BatchOp* op = &ops[i];
+      for (int32_t j = 0; j < op->num_refs; ++j) {
+        int32_t arg_index = op->refs[j * 2], op_index = op->refs[j * 2 + 1];
+        MINRPC_CHECK(op_index >= 0 && op_index < i);
+        void* handle = ret_values[op_index * 2 + 1].v_handle;
+        if (arg_index == -1) {
+          MINRPC_CHECK(op->code == RPCCode::kCallFunc);
+          op->call_handle = reinterpret_cast<uint64_t>(handle);
+        } else if (op->code == RPCCode::kCopyToRemote) {
+          MINRPC_CHECK(arg_index == 0);
+          op->arr->data = handle;
+        } else {
+          MINRPC_CHECK(arg_index >= 0 && arg_index < op->num_args);
+          if (op->tcodes[arg_index] == kTVMDLTensorHandle) {
+            static_cast<DLTensor*>(op->values[arg_index].v_handle)->data = handle;
+          } else {
+            op->values[arg_index].v_handle = handle;
+          }
+        }
+      }
+
+      returns.error = nullptr;
+      if (op->code == RPCCode::kCallFunc) {
+        exec.NormalCallFunc(op->call_handle, op->values, op->tcodes, op->num_args);
+      } else if (op->code == RPCCode::kCopyToRemote) {
+        BatchCopyToRemote(op->arr, op->num_bytes, op->data, &returns);
+      } else {
+        exec.SysCallFunc(op->code, op->values, op->tcodes, op->num_args);
+      }
+      if (returns.error != nullptr) {
+        exec_handler_->GetReturnInterface()->ReturnException(BatchError(i, returns.error));
+        return;
+      }
+      ret_tcodes[i * 2] = kDLInt;
+      ret_values[i * 2].v_int64 = returns.rv_tcode;
+      ret_tcodes[i * 2 + 1] = returns.tcode;
+      ret_values[i * 2 + 1] = returns.value;
+    }
+    exec_handler_->GetReturnInterface()->ReturnPackedSeq(ret_values, ret_tcodes, num_ops * 2);
+  }
+
   void ThrowError(RPCServerStatus code, RPCCode info = RPCCode::kNone) {
     io_->Exit(static_cast<int>(code));
   }
@@ -772,6 +865,131 @@ class MinRPCServer {
   }
 
  private:
+  /*! \brief An op of a batch. */
+  struct BatchOp {
+    RPCCode code;
+    uint64_t call_handle;
+    TVMValue* values;
+    int* tcodes;
+    int num_args;
+    DLTensor* arr;
+    uint64_t num_bytes;
+    uint8_t* data;
+    int32_t num_refs;
+    int32_t* refs;
+  };
+
+  /*! \brief Records the response to an op of a batch instead of sending it. */
+  class BatchReturns : public MinRPCReturnInterface {
+   public:
+    explicit BatchReturns(MinRPCServer* server) : server_(server) {}
+
+    void ReturnVoid() {
+      rv_tcode = kTVMNullptr;
+      tcode = kTVMNullptr;
+      value.v_handle = nullptr;
+    }
+
+    void ReturnHandle(void* handle) {
+      rv_tcode = kTVMOpaqueHandle;
+      tcode = kTVMOpaqueHandle;
+      value.v_handle = handle;
+    }
+
+    void ReturnException(const char* msg) { error = server_->ArenaCopy(msg, strlen(msg) + 1); }
+
+    void ReturnPackedSeq(const TVMValue* arg_values, const int* type_codes, int num_args) {
+      // The return of MinRPCExecute::NormalCallFunc, the type code of the return value followed
+      // by the value, the last of which is the handle of an NDArray.
+      rv_tcode = static_cast<int>(arg_values[0].v_int64);
+      tcode = type_codes[num_args - 1];
+      value = arg_values[num_args - 1];
+      // The string and the bytes are released by the next call, keep a copy of them.
+      if (tcode == kTVMStr) {
+        value.v_str = server_->ArenaCopy(value.v_str, strlen(value.v_str) + 1);
+      } else if (tcode == kTVMBytes) {
+        const TVMByteArray* bytes = static_cast<const TVMByteArray*>(value.v_handle);
+        TVMByteArray* copy = server_->template ArenaAlloc<TVMByteArray>(1);
+        copy->data = server_->ArenaCopy(bytes->data, bytes->size);
+        copy->size = bytes->size;
+        value.v_handle = copy;
+      }
+    }
+
+    void ReturnCopyFromRemote(uint8_t* data_ptr, uint64_t num_bytes) {
+      this->ThrowError(RPCServerStatus::kRPCCodeNotSupported, RPCCode::kCopyFromRemote);
+    }
+
+    void ReturnLastTVMError() { ReturnException(TVMGetLastError()); }
+
+    void ThrowError(RPCServerStatus code, RPCCode info = RPCCode::kNone) {
+      server_->ThrowError(code, info);
+    }
+
+    /*! \brief The encoded return of the op, as in the return of kCallFunc. */
+    int rv_tcode;
+    int tcode;
+    TVMValue value;
+    /*! \brief The error of the op, nullptr if it succeeds. */
+    const char* error = nullptr;
+
+   private:
+    MinRPCServer* server_;
+  };
+
+  void BatchCopyToRemote(DLTensor* arr, uint64_t num_bytes, uint8_t* data_ptr,
+                         MinRPCReturnInterface* returns) {
+    int call_ecode = 0;
+    if (arr->device.device_type == kDLCPU) {
+      memcpy(static_cast<uint8_t*>(arr->data) + arr->byte_offset, data_ptr, num_bytes);
+    } else {
+      DLTensor temp;
+      temp.data = data_ptr;
+      temp.device = DLDevice{kDLCPU, 0};
+      temp.ndim = arr->ndim;
+      temp.dtype = arr->dtype;
+      temp.shape = arr->shape;
+      temp.strides = nullptr;
+      temp.byte_offset = 0;
+      call_ecode = TVMDeviceCopyDataFromTo(&temp, arr, nullptr);
+      if (call_ecode == 0) {
+        call_ecode = TVMSynchronize(arr->device.device_type, arr->device.device_id, nullptr);
+      }
+    }
+    if (call_ecode == 0) {
+      returns->ReturnVoid();
+    } else {
+      returns->ReturnLastTVMError();
+    }
+  }
+
+  /*! \brief The error message of a batch, "RPC batch op <index>: <msg>". */
+  const char* BatchError(int32_t index, const char* msg) {
+    const char prefix[] = "RPC batch op ";
+    char digits[12];
+    int num_digits = 0;
+    do {
+      digits[num_digits++] = static_cast<char>('0' + index % 10);
+      index /= 10;
+    } while (index != 0);
+    size_t msg_len = strlen(msg);
+    char* error = ArenaAlloc<char>(sizeof(prefix) - 1 + num_digits + 2 + msg_len + 1);
+    char* p = error;
+    memcpy(p, prefix, sizeof(prefix) - 1);
+    p += sizeof(prefix) - 1;
+    while (num_digits != 0) *p++ = digits[--num_digits];
+    *p++ = ':';
+    *p++ = ' ';
+    memcpy(p, msg, msg_len + 1);
+    return error;
+  }
+
+  const char* ArenaCopy(const char* data, size_t size) {
+    char* copy = ArenaAlloc<char>(size);
+    memcpy(copy, data, size);
+    return copy;
+  }
+
   void RecvPackedSeq(TVMValue** out_values, int** out_tcodes, int* out_num_args) {
     RPCReference::RecvPackedSeq(out_values, out_tcodes, out_num_args, this);
   }
@@ -70,6 +70,13 @@ enum class RPCCode : int {
   kDevFreeStream,
   kDevSetStream,
   kDevGetCurrentStream,
+  // The following carry a request id and are only sent to peers that report
+  // tvm.rpc.server.SupportsMultiplex, the other codes keep their values.
+  kMuxCallFunc,
+  kMuxReturn,
+  // A sequence of calls, copies to the remote and syscalls run in one round trip,
+  // only served by MinRPCServer, see MinRPCServer::HandleBatch.
+  kBatch,
 };
 
 /*!
@@ -134,6 +141,12 @@ inline const char* RPCCodeToString(RPCCode code) {
       return "kCopyAmongRemote";
     case RPCCode::kDevAllocDataWithScope:
       return "kDevAllocDataWithScope";
+    case RPCCode::kMuxCallFunc:
+      return "kMuxCallFunc";
+    case RPCCode::kMuxReturn:
+      return "kMuxReturn";
+    case RPCCode::kBatch:
+      return "kBatch";
     default:
       return "";
   }
@@ -21,21 +21,41 @@
 #define TVM_NVTX_ENABLED 0
 #endif
 
+#ifndef TVM_ROCTX_ENABLED
+#define TVM_ROCTX_ENABLED 0
+#endif
+
 #if TVM_NVTX_ENABLED
 #include <nvtx3/nvToolsExt.h>
+#elif TVM_ROCTX_ENABLED
+#include <roctracer/roctx.h>
 #endif  // TVM_NVTX_ENABLED
 
 #include <tvm/runtime/nvtx.h>
 
+#include <cstdlib>
+
 namespace tvm {
 namespace runtime {
 
+bool NVTXRangesEnabled() {
+#if TVM_NVTX_ENABLED || TVM_ROCTX_ENABLED
+  const char* env = std::getenv("TVM_NVTX_RANGES");
+  return env != nullptr && std::string(env) != "" && std::string(env) != "0";
+#else
+  return false;
+#endif
+}
+
 #if TVM_NVTX_ENABLED
-NVTXScopedRange::NVTXScopedRange(const char* name) { nvtxRangePush(name); }
-NVTXScopedRange::~NVTXScopedRange() { nvtxRangePop(); }
+void NVTXScopedRange::Push(const char* name) { nvtxRangePush(name); }
+void NVTXScopedRange::Pop() { nvtxRangePop(); }
+#elif TVM_ROCTX_ENABLED
+void NVTXScopedRange::Push(const char* name) { roctxRangePush(name); }
+void NVTXScopedRange::Pop() { roctxRangePop(); }
 #else
-NVTXScopedRange::NVTXScopedRange(const char* name) {}
-NVTXScopedRange::~NVTXScopedRange() {}
+void NVTXScopedRange::Push(const char* name) {}
+void NVTXScopedRange::Pop() {}
 #endif  // TVM_NVTX_ENABLED
 
 }  // namespace runtime
@@ -0,0 +1,257 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file object_pool.cc
+ * \brief Size-class pool backing PooledObjAllocator.
+ *
+ *  Each thread keeps a free list per size class. A thread which frees more blocks than it
+ *  allocates (e.g. a worker dropping the IR built by another thread) hands them back to the
+ *  global free lists in batches, where other threads pick them up. The memory of the blocks
+ *  is retained by the pool for the lifetime of the process.
+ */
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/memory.h>
+#include <tvm/runtime/registry.h>
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <unordered_set>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace detail {
+
+namespace {
+
+constexpr size_t kMaxPooledSize = 512;
+constexpr size_t kNumSizeClasses = kMaxPooledSize / kObjectPoolAlignment;
+// The bytes of a chunk carved into blocks of one size class.
+constexpr size_t kChunkBytes = 64 << 10;
+// The number of blocks moved at once between a thread and the global free lists.
+constexpr size_t kBatchSize = 64;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct FreeList {
+  FreeBlock* head{nullptr};
+  size_t count{0};
+
+  void Push(void* ptr) {
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = head;
+    head = block;
+    ++count;
+  }
+
+  void* Pop() {
+    FreeBlock* block = head;
+    head = block->next;
+    --count;
+    return block;
+  }
+
+  /*! \brief Move up to n blocks from this list to the other. */
+  void MoveTo(FreeList* other, size_t n) {
+    for (; n != 0 && head != nullptr; --n) {
+      other->Push(Pop());
+    }
+  }
+};
+
+inline size_t SizeClassOf(size_t size) {
+  return (size + kObjectPoolAlignment - 1) / kObjectPoolAlignment - 1;
+}
+
+class ThreadCache;
+
+/*! \brief The free lists shared by all threads, and the statistics. */
+class GlobalPool {
+ public:
+  static GlobalPool* Global() {
+    // Intentionally leaked, the blocks may be freed during the static destruction.
+    static GlobalPool* inst = new GlobalPool();
+    return inst;
+  }
+
+  /*! \brief Move a batch of blocks of a size class to the list of a thread. */
+  void Refill(size_t size_class, FreeList* list) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FreeList& global = free_lists_[size_class];
+    if (global.count != 0) {
+      global.MoveTo(list, kBatchSize);
+      return;
+    }
+    size_t block_bytes = (size_class + 1) * kObjectPoolAlignment;
+    char* chunk = static_cast<char*>(::operator new(kChunkBytes));
+    retained_bytes_ += kChunkBytes;
+    for (size_t offset = 0; offset + block_bytes <= kChunkBytes; offset += block_bytes) {
+      list->Push(chunk + offset);
+    }
+  }
+
+  /*! \brief Take back the blocks of a size class from the list of a thread. */
+  void Release(size_t size_class, FreeList* list, size_t n) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    list->MoveTo(&free_lists_[size_class], n);
+  }
+
+  void Register(ThreadCache* cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    caches_.insert(cache);
+  }
+
+  void Unregister(ThreadCache* cache, uint64_t num_allocated, uint64_t num_freed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    caches_.erase(cache);
+    retired_allocated_ += num_allocated;
+    retired_freed_ += num_freed;
+  }
+
+  /*! \brief Count a block allocated or freed without a thread cache. */
+  void CountUncached(bool alloc) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    (alloc ? retired_allocated_ : retired_freed_) += 1;
+  }
+
+  /*! \brief The number of allocated and freed blocks, and the bytes retained by the pool. */
+  std::vector<int64_t> Stats();
+
+ private:
+  std::mutex mutex_;
+  FreeList free_lists_[kNumSizeClasses];
+  std::unordered_set<ThreadCache*> caches_;
+  uint64_t retired_allocated_{0};
+  uint64_t retired_freed_{0};
+  uint64_t retained_bytes_{0};
+};
+
+/*! \brief The free lists of one thread. */
+class ThreadCache {
+ public:
+  ThreadCache() { GlobalPool::Global()->Register(this); }
+
+  ~ThreadCache() {
+    GlobalPool* pool = GlobalPool::Global();
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      pool->Release(i, &free_lists_[i], free_lists_[i].count);
+    }
+    pool->Unregister(this, num_allocated_.load(std::memory_order_relaxed),
+                     num_freed_.load(std::memory_order_relaxed));
+    destroyed_ = true;
+  }
+
+  static ThreadCache* Get() {
+    if (destroyed_) return nullptr;
+    static thread_local ThreadCache inst;
+    return destroyed_ ? nullptr : &inst;
+  }
+
+  void* Alloc(size_t size_class) {
+    // Only the owner thread writes the counters, other threads read them for the stats.
+    num_allocated_.store(num_allocated_.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+    FreeList& list = free_lists_[size_class];
+    if (list.count == 0) {
+      GlobalPool::Global()->Refill(size_class, &list);
+    }
+    return list.Pop();
+  }
+
+  void Free(void* ptr, size_t size_class) {
+    num_freed_.store(num_freed_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    FreeList& list = free_lists_[size_class];
+    list.Push(ptr);
+    if (list.count > 2 * kBatchSize) {
+      GlobalPool::Global()->Release(size_class, &list, kBatchSize);
+    }
+  }
+
+  uint64_t num_allocated() const { return num_allocated_.load(std::memory_order_relaxed); }
+  uint64_t num_freed() const { return num_freed_.load(std::memory_order_relaxed); }
+
+ private:
+  FreeList free_lists_[kNumSizeClasses];
+  std::atomic<uint64_t> num_allocated_{0};
+  std::atomic<uint64_t> num_freed_{0};
+  // Set when the cache of this thread is gone, during the thread exit.
+  static thread_local bool destroyed_;
+};
+
+thread_local bool ThreadCache::destroyed_ = false;
+
+std::vector<int64_t> GlobalPool::Stats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t num_allocated = retired_allocated_;
+  uint64_t num_freed = retired_freed_;
+  for (ThreadCache* cache : caches_) {
+    num_allocated += cache->num_allocated();
+    num_freed += cache->num_freed();
+  }
+  return {static_cast<int64_t>(num_allocated), static_cast<int64_t>(num_freed),
+          static_cast<int64_t>(retained_bytes_)};
+}
+
+}  // namespace
+
+void* ObjectPoolAlloc(size_t size) {
+  if (size > kMaxPooledSize) {
+    return ::operator new(size);
+  }
+  size_t size_class = SizeClassOf(size);
+  if (ThreadCache* cache = ThreadCache::Get()) {
+    return cache->Alloc(size_class);
+  }
+  GlobalPool* pool = GlobalPool::Global();
+  FreeList list;
+  pool->Refill(size_class, &list);
+  void* ptr = list.Pop();
+  pool->Release(size_class, &list, list.count);
+  pool->CountUncached(true);
+  return ptr;
+}
+
+void ObjectPoolFree(void* ptr, size_t size) {
+  if (size > kMaxPooledSize) {
+    ::operator delete(ptr);
+    return;
+  }
+  size_t size_class = SizeClassOf(size);
+  if (ThreadCache* cache = ThreadCache::Get()) {
+    cache->Free(ptr, size_class);
+    return;
+  }
+  GlobalPool* pool = GlobalPool::Global();
+  FreeList list;
+  list.Push(ptr);
+  pool->Release(size_class, &list, 1);
+  pool->CountUncached(false);
+}
+
+}  // namespace detail
+
+TVM_REGISTER_GLOBAL("runtime.ObjectPoolStats").set_body_typed([]() {
+  return ShapeTuple(detail::GlobalPool::Global()->Stats());
+});
+
+}  // namespace runtime
+}  // namespace tvm
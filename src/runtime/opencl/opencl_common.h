@@ -294,6 +294,23 @@ class OpenCLWorkspace : public DeviceAPI {
 
     return prop & CL_QUEUE_PROFILING_ENABLE;
   }
+  // is current clCommandQueue executing the commands out of order
+  bool IsOutOfOrder(Device dev) {
+    cl_command_queue queue = GetQueue(dev);
+    cl_command_queue_properties prop;
+
+    OPENCL_CALL(clGetCommandQueueInfo(queue, CL_QUEUE_PROPERTIES,
+                                      sizeof(cl_command_queue_properties), &prop, nullptr));
+
+    return prop & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+  }
+  // Order the commands of an out-of-order queue around a command
+  // which does not track its dependencies, e.g. a copy.
+  void BarrierIfOutOfOrder(Device dev) {
+    if (IsOutOfOrder(dev)) {
+      OPENCL_CALL(clEnqueueBarrierWithWaitList(GetQueue(dev), 0, nullptr, nullptr));
+    }
+  }
   // Check if the device is present or not
   bool IsDeviceExists(unsigned int device_id) { return device_id < devices.size(); }
   // Enable queue profiling, recreate if required
@@ -303,6 +320,9 @@ class OpenCLWorkspace : public DeviceAPI {
       return;
     }
     cl_command_queue_properties prop = (enable) ? CL_QUEUE_PROFILING_ENABLE : 0;
+    if (cl::OpenCLWorkspace::Global()->IsOutOfOrder(dev)) {
+      prop |= CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+    }
     auto queue = cl::OpenCLWorkspace::Global()->GetQueue(dev);
     OPENCL_CALL(clFlush(queue));
     OPENCL_CALL(clFinish(queue));
@@ -417,6 +437,11 @@ struct BufferDescriptor {
   cl_mem buffer{nullptr};
   cl_uchar* host_ptr{nullptr};
   MemoryLayout layout{MemoryLayout::kBuffer1D};
+  /*!
+   * \brief The event of the last kernel accessing the buffer, on an
+   *  out-of-order queue, which the next kernel accessing it waits for.
+   */
+  cl_event last_event{nullptr};
 };
 }  // namespace cl
 
@@ -502,6 +527,8 @@ class OpenCLModuleNode : public OpenCLModuleNodeBase {
   std::string source_;
   // parsed kernel data
   std::unordered_map<std::string, std::string> parsed_kernels_;
+  // build the program for the device, with the build log in the error on failure
+  void BuildProgram(cl_program program, cl_device_id dev);
 };
 
 /*! \brief OpenCL timer node */
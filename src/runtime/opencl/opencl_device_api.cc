@@ -27,6 +27,7 @@
 
 #include <sstream>
 
+#include "../../support/utils.h"
 #include "opencl_common.h"
 
 #ifdef OPENCL_ENABLE_HOST_PTR
@@ -324,6 +325,9 @@ void OpenCLWorkspace::FreeDataSpace(Device dev, void* ptr) {
   OPENCL_CALL(clFinish(this->GetQueue(dev)));
 
   cl::BufferDescriptor* desc = static_cast<cl::BufferDescriptor*>(ptr);
+  if (desc->last_event) {
+    OPENCL_CALL(clReleaseEvent(desc->last_event));
+  }
   if (desc->host_ptr) {
     OPENCL_CALL(clEnqueueUnmapMemObject(this->GetQueue(dev), desc->buffer,
                                         reinterpret_cast<void*>(desc->host_ptr), 0, nullptr,
@@ -367,6 +371,8 @@ void OpenCLWorkspace::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHand
   if (IsOpenCLDevice(from->device) && IsOpenCLDevice(to->device)) {
     const auto* from_desc = static_cast<const cl::BufferDescriptor*>(from->data);
     auto* to_desc = static_cast<cl::BufferDescriptor*>(to->data);
+    // The copies do not track the kernels accessing the buffers.
+    BarrierIfOutOfOrder(to->device);
     if (to_desc->layout == cl::BufferDescriptor::MemoryLayout::kBuffer1D &&
         from_desc->layout == cl::BufferDescriptor::MemoryLayout::kBuffer1D) {
       OPENCL_CALL(clEnqueueCopyBuffer(this->GetQueue(to->device), from_desc->buffer,
@@ -391,8 +397,10 @@ void OpenCLWorkspace::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHand
                                      from_image_info.origin, to_image_info.origin,
                                      to_image_info.region, 0, nullptr, nullptr));
     }
+    BarrierIfOutOfOrder(to->device);
   } else if (IsOpenCLDevice(from->device) && to->device.device_type == kDLCPU) {
     const auto* from_desc = static_cast<const cl::BufferDescriptor*>(from->data);
+    BarrierIfOutOfOrder(from->device);
     switch (from_desc->layout) {
       case cl::BufferDescriptor::MemoryLayout::kBuffer1D:
         OPENCL_CALL(clEnqueueReadBuffer(
@@ -415,6 +423,7 @@ void OpenCLWorkspace::CopyDataFromTo(DLTensor* from, DLTensor* to, TVMStreamHand
     OPENCL_CALL(clFinish(this->GetQueue(from->device)));
   } else if (from->device.device_type == kDLCPU && IsOpenCLDevice(to->device)) {
     auto* to_desc = static_cast<cl::BufferDescriptor*>(to->data);
+    BarrierIfOutOfOrder(to->device);
     switch (to_desc->layout) {
       case cl::BufferDescriptor::MemoryLayout::kBuffer1D:
         OPENCL_CALL(clEnqueueWriteBuffer(
@@ -586,7 +595,17 @@ void OpenCLWorkspace::Init(const std::string& type_key, const std::string& devic
     for (size_t i = 0; i < devices.size(); ++i) {
       cl_device_id did = devices[i];
       device_to_platform[did] = platform;
-      this->queues.push_back(clCreateCommandQueue(this->contexts[platform], did, 0, &err_code));
+      // Let the kernels overlap on an out-of-order queue if requested, where
+      // the kernels wait for the previous kernels accessing the same buffers.
+      cl_command_queue_properties queue_props = 0;
+      if (support::BoolEnvironmentVar("TVM_OPENCL_OUT_OF_ORDER_QUEUE")) {
+        cl_command_queue_properties supported_props = 0;
+        OPENCL_CALL(clGetDeviceInfo(did, CL_DEVICE_QUEUE_PROPERTIES, sizeof(supported_props),
+                                    &supported_props, nullptr));
+        queue_props = supported_props & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+      }
+      this->queues.push_back(
+          clCreateCommandQueue(this->contexts[platform], did, queue_props, &err_code));
       OPENCL_CHECK_ERROR(err_code);
     }
     OPENCL_CHECK_ERROR(err_code);
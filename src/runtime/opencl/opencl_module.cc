@@ -25,6 +25,12 @@
 #include <dmlc/memory_io.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -35,6 +41,98 @@
 namespace tvm {
 namespace runtime {
 
+namespace cl {
+std::string GetDeviceInfo(cl_device_id pid, cl_device_info param_name);
+}  // namespace cl
+
+namespace {
+
+/*! \brief The magic number of the program binary files in the program cache. */
+constexpr uint64_t kOpenCLProgramCacheMagic = 0x43504C434D565401;
+
+/*!
+ * \brief The on-disk cache of the program binaries built from source, enabled
+ *  by setting TVM_OPENCL_PROGRAM_CACHE_DIR to an existing directory.
+ *
+ *  The entries are keyed by the device, the driver version and the source. The
+ *  key is stored in the entry and compared on lookup, so that a hash collision
+ *  or a driver update only causes a miss.
+ */
+class OpenCLProgramCache {
+ public:
+  OpenCLProgramCache(cl_device_id dev, const std::string& source) {
+    const char* dir = std::getenv("TVM_OPENCL_PROGRAM_CACHE_DIR");
+    if (dir == nullptr || *dir == '\0') return;
+    key_ = cl::GetDeviceInfo(dev, CL_DEVICE_NAME) + "\n" +
+           cl::GetDeviceInfo(dev, CL_DEVICE_VERSION) + "\n" +
+           cl::GetDeviceInfo(dev, CL_DRIVER_VERSION) + "\n" + source;
+    std::ostringstream os;
+    os << dir << "/" << std::hex << std::hash<std::string>()(key_) << ".clbin";
+    path_ = os.str();
+  }
+
+  bool enabled() const { return !path_.empty(); }
+
+  /*! \brief Load the program binary of the entry, return false on a miss. */
+  bool Load(std::vector<unsigned char>* binary) const {
+    if (!enabled()) return false;
+    std::ifstream fs(path_, std::ios::in | std::ios::binary);
+    if (fs.fail()) return false;
+    std::string data((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+    dmlc::MemoryStringStream reader(&data);
+    uint64_t magic;
+    std::string key;
+    if (!reader.Read(&magic) || magic != kOpenCLProgramCacheMagic || !reader.Read(&key) ||
+        key != key_ || !reader.Read(binary)) {
+      return false;
+    }
+    return !binary->empty();
+  }
+
+  /*! \brief Save the binary of a built program, ignoring the failures. */
+  void Save(cl_program program) const {
+    if (!enabled()) return;
+    size_t size = 0;
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t), &size, nullptr) !=
+            CL_SUCCESS ||
+        size == 0) {
+      return;
+    }
+    std::vector<unsigned char> binary(size);
+    unsigned char* ptr = binary.data();
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(unsigned char*), &ptr, nullptr) !=
+        CL_SUCCESS) {
+      return;
+    }
+    std::string data;
+    dmlc::MemoryStringStream writer(&data);
+    writer.Write(kOpenCLProgramCacheMagic);
+    writer.Write(key_);
+    writer.Write(binary);
+    // Write to a temporary file first, so that concurrent readers never see a partial entry.
+    std::string tmp_path = path_ + ".tmp" + std::to_string(reinterpret_cast<uintptr_t>(this));
+    {
+      std::ofstream fs(tmp_path, std::ios::out | std::ios::binary);
+      if (fs.fail()) return;
+      fs.write(data.data(), data.size());
+      if (fs.fail()) {
+        fs.close();
+        std::remove(tmp_path.c_str());
+        return;
+      }
+    }
+    if (std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+      std::remove(tmp_path.c_str());
+    }
+  }
+
+ private:
+  std::string key_;
+  std::string path_;
+};
+
+}  // namespace
+
 class OpenCLWrappedFunc {
  public:
   // initialize the OpenCL function.
@@ -78,16 +176,47 @@ class OpenCLWrappedFunc {
     for (cl_uint i = 0; i < work_dim; ++i) {
       wl.work_size[i] *= wl.work_size[i + 3];
     }
+    // On an out-of-order queue, wait for the last kernels accessing the buffer arguments.
+    bool out_of_order = w_->IsOutOfOrder(t->device);
+    std::vector<cl::BufferDescriptor*> buffer_args;
+    std::vector<cl_event> wait_events;
+    if (out_of_order) {
+      for (cl_uint i = 0; i < arg_size_.size(); ++i) {
+        if (args.type_codes[i] == DLDataTypeCode::kDLOpaqueHandle) {
+          auto* desc = static_cast<cl::BufferDescriptor*>(void_args[i]);
+          buffer_args.push_back(desc);
+          if (desc->last_event != nullptr &&
+              std::find(wait_events.begin(), wait_events.end(), desc->last_event) ==
+                  wait_events.end()) {
+            wait_events.push_back(desc->last_event);
+          }
+        }
+      }
+    }
     // launch kernel
-
-    if (w_->IsProfiling(t->device)) {
+    cl_event event = nullptr;
+    bool profiling = w_->IsProfiling(t->device);
+    if (profiling) {
       w_->GetEventQueue(t->device).resize(w_->GetEventQueue(t->device).size() + 1);
-      OPENCL_CALL(clEnqueueNDRangeKernel(queue, kernel, work_dim, nullptr, wl.work_size,
-                                         wl.work_size + 3, 0, nullptr,
-                                         &(w_->GetEventQueue(t->device).back())));
-    } else {
-      OPENCL_CALL(clEnqueueNDRangeKernel(queue, kernel, work_dim, nullptr, wl.work_size,
-                                         wl.work_size + 3, 0, nullptr, nullptr));
+    }
+    cl_event* out_event = profiling ? &(w_->GetEventQueue(t->device).back())
+                                    : (out_of_order ? &event : nullptr);
+    OPENCL_CALL(clEnqueueNDRangeKernel(queue, kernel, work_dim, nullptr, wl.work_size,
+                                       wl.work_size + 3, wait_events.size(),
+                                       wait_events.empty() ? nullptr : wait_events.data(),
+                                       out_event));
+    if (out_of_order) {
+      event = *out_event;
+      for (cl::BufferDescriptor* desc : buffer_args) {
+        if (desc->last_event != nullptr) {
+          OPENCL_CALL(clReleaseEvent(desc->last_event));
+        }
+        OPENCL_CALL(clRetainEvent(event));
+        desc->last_event = event;
+      }
+      if (!profiling) {
+        OPENCL_CALL(clReleaseEvent(event));
+      }
     }
   }
 
@@ -220,6 +349,20 @@ bool OpenCLModuleNode::IsProgramCreated(const std::string& func_name, int device
   return false;
 }
 
+void OpenCLModuleNode::BuildProgram(cl_program program, cl_device_id dev) {
+  cl_int err = clBuildProgram(program, 1, &dev, nullptr, nullptr, nullptr);
+  if (err != CL_SUCCESS) {
+    size_t len;
+    std::string log;
+    clGetProgramBuildInfo(program, dev, CL_PROGRAM_BUILD_LOG, 0, nullptr, &len);
+    log.resize(len);
+    clGetProgramBuildInfo(program, dev, CL_PROGRAM_BUILD_LOG, len, &log[0], nullptr);
+    LOG(FATAL) << "OpenCL build error for device=" << dev
+               << "\nError: " << cl::CLGetErrorString(err) << "\n"
+               << log;
+  }
+}
+
 cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThreadEntry* t,
                                           const std::string& func_name, const KTRefEntry& e) {
   std::lock_guard<std::mutex> lock(build_lock_);
@@ -229,12 +372,33 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
   if (!IsProgramCreated(func_name, device_id)) {
     // create program
     if (fmt_ == "cl") {
-      const char* s = parsed_kernels_[func_name].c_str();
-      size_t len = parsed_kernels_[func_name].length();
-      cl_int err;
-      programs_[func_name][device_id] =
-          clCreateProgramWithSource(w->contexts[platform], 1, &s, &len, &err);
-      OPENCL_CHECK_ERROR(err);
+      cl_device_id dev = w->devices[device_id];
+      OpenCLProgramCache cache(dev, parsed_kernels_[func_name]);
+      std::vector<unsigned char> binary;
+      if (cache.Load(&binary)) {
+        // A stale or corrupted entry falls back to the build from source.
+        const unsigned char* s = binary.data();
+        size_t len = binary.size();
+        cl_int err, binary_status;
+        cl_program program = clCreateProgramWithBinary(w->contexts[platform], 1, &dev, &len, &s,
+                                                       &binary_status, &err);
+        if (err == CL_SUCCESS && binary_status == CL_SUCCESS &&
+            clBuildProgram(program, 1, &dev, nullptr, nullptr, nullptr) == CL_SUCCESS) {
+          programs_[func_name][device_id] = program;
+        } else if (program != nullptr) {
+          OPENCL_CALL(clReleaseProgram(program));
+        }
+      }
+      if (programs_[func_name][device_id] == nullptr) {
+        const char* s = parsed_kernels_[func_name].c_str();
+        size_t len = parsed_kernels_[func_name].length();
+        cl_int err;
+        programs_[func_name][device_id] =
+            clCreateProgramWithSource(w->contexts[platform], 1, &s, &len, &err);
+        OPENCL_CHECK_ERROR(err);
+        BuildProgram(programs_[func_name][device_id], dev);
+        cache.Save(programs_[func_name][device_id]);
+      }
     } else if (fmt_ == "xclbin" || fmt_ == "awsxclbin" || fmt_ == "aocx") {
       const unsigned char* s = (const unsigned char*)data_.c_str();
       size_t len = data_.length();
@@ -243,25 +407,10 @@ cl_kernel OpenCLModuleNode::InstallKernel(cl::OpenCLWorkspace* w, cl::OpenCLThre
       programs_[func_name][device_id] =
           clCreateProgramWithBinary(w->contexts[platform], 1, &dev, &len, &s, nullptr, &err);
       OPENCL_CHECK_ERROR(err);
+      BuildProgram(programs_[func_name][device_id], w->devices[device_id]);
     } else {
       LOG(FATAL) << "Unknown OpenCL format " << fmt_;
     }
-    // build program
-    cl_int err;
-    cl_device_id dev = w->devices[device_id];
-    err = clBuildProgram(programs_[func_name][device_id], 1, &dev, nullptr, nullptr, nullptr);
-    if (err != CL_SUCCESS) {
-      size_t len;
-      std::string log;
-      clGetProgramBuildInfo(programs_[func_name][device_id], dev, CL_PROGRAM_BUILD_LOG, 0, nullptr,
-                            &len);
-      log.resize(len);
-      clGetProgramBuildInfo(programs_[func_name][device_id], dev, CL_PROGRAM_BUILD_LOG, len,
-                            &log[0], nullptr);
-      LOG(FATAL) << "OpenCL build error for device=" << dev
-                 << "\nError: " << cl::CLGetErrorString(err) << "\n"
-                 << log;
-    }
   }
   // build kernel
   cl_int err;
@@ -171,6 +171,10 @@ using f_clReleaseKernel = cl_int (*)(cl_kernel);
 using f_clSetKernelArg = cl_int (*)(cl_kernel, cl_uint, size_t, const void*);
 using f_clWaitForEvents = cl_int (*)(cl_uint, const cl_event*);
 using f_clCreateUserEvent = cl_event (*)(cl_context, cl_int*);
+using f_clRetainEvent = cl_int (*)(cl_event);
+using f_clReleaseEvent = cl_int (*)(cl_event);
+using f_clEnqueueBarrierWithWaitList = cl_int (*)(cl_command_queue, cl_uint, const cl_event*,
+                                                  cl_event*);
 using f_clGetEventProfilingInfo = cl_int (*)(cl_event, cl_profiling_info, size_t, void*, size_t*);
 using f_clFlush = cl_int (*)(cl_command_queue);
 using f_clFinish = cl_int (*)(cl_command_queue);
@@ -447,6 +451,38 @@ cl_event clCreateUserEvent(cl_context context, cl_int* errcode_ret) {
   }
 }
 
+cl_int clRetainEvent(cl_event event) {
+  auto& lib = LibOpenCLWrapper::getInstance();
+  auto func = (f_clRetainEvent)lib.getOpenCLFunction("clRetainEvent");
+  if (func) {
+    return func(event);
+  } else {
+    return CL_INVALID_PLATFORM;
+  }
+}
+
+cl_int clReleaseEvent(cl_event event) {
+  auto& lib = LibOpenCLWrapper::getInstance();
+  auto func = (f_clReleaseEvent)lib.getOpenCLFunction("clReleaseEvent");
+  if (func) {
+    return func(event);
+  } else {
+    return CL_INVALID_PLATFORM;
+  }
+}
+
+cl_int clEnqueueBarrierWithWaitList(cl_command_queue command_queue, cl_uint num_events_in_wait_list,
+                                    const cl_event* event_wait_list, cl_event* event) {
+  auto& lib = LibOpenCLWrapper::getInstance();
+  auto func =
+      (f_clEnqueueBarrierWithWaitList)lib.getOpenCLFunction("clEnqueueBarrierWithWaitList");
+  if (func) {
+    return func(command_queue, num_events_in_wait_list, event_wait_list, event);
+  } else {
+    return CL_INVALID_PLATFORM;
+  }
+}
+
 cl_int clGetEventProfilingInfo(cl_event event, cl_profiling_info param_name,
                                size_t param_value_size, void* param_value,
                                size_t* param_value_size_ret) {
@@ -21,6 +21,7 @@
  * \file texture_pool.h
  * \brief Texture pool utility.
  */
+#include <algorithm>
 #include <limits>
 #include <memory>
 
@@ -29,70 +30,77 @@
 namespace tvm {
 namespace runtime {
 
+namespace {
+
+/*!
+ * \brief Round a texture extent up to a multiple of 1/8 of the next power of two, so that
+ * requests of similar extents share the same image while wasting at most 1/8 of each side.
+ */
+size_t RoundTextureExtent(size_t extent) {
+  size_t pow2 = 1;
+  while (pow2 < extent) {
+    pow2 <<= 1;
+  }
+  size_t granularity = std::max<size_t>(pow2 / 8, 1);
+  return (extent + granularity - 1) / granularity * granularity;
+}
+
+}  // namespace
+
 void* Pool2D::Alloc(Device dev, DeviceAPI* device, size_t width, size_t height,
                     DLDataType type_hint) {
-  Entry e;
-  Entry new_mem;
   // Processed several experiments and found that when we are trying to fit
   // small texture to too big texture then it may lead to the performance
   // degradation.
   // Coefficient at 5 looks like robust variant for reusing textures.
-  const int64_t max_ratio = 5;
-  e.data = nullptr;
-  std::vector<Entry>::iterator best_mem;
-  if (free_list_.size() != 0) {
-    int64_t min_added_size_x = std::numeric_limits<int64_t>::max();
-    int64_t min_added_size_y = std::numeric_limits<int64_t>::max();
-    int64_t min_wasted_size_x = std::numeric_limits<int64_t>::max();
-    int64_t min_wasted_size_y = std::numeric_limits<int64_t>::max();
-    for (auto it = free_list_.begin(); it != free_list_.end(); ++it) {
-      if (it->type.code != type_hint.code) {
-        continue;
-      }
-      // avoid reusing too small and too big textures
-      if (width / it->x > max_ratio || it->x / width > max_ratio || height / it->y > max_ratio ||
-          it->y / height > max_ratio) {
-        continue;
-      }
-      int64_t new_width = std::max(it->x, width);
-      int64_t new_height = std::max(it->y, height);
-      int64_t added_size_x = new_width - it->x;
-      int64_t added_size_y = new_height - it->y;
-      int64_t wasted_size_x = new_width - width;
-      int64_t wasted_size_y = new_height - height;
-      // Minimize added size first and wasted size thereafter
-      if ((min_added_size_x > 0 && added_size_x < min_added_size_x) ||
-          (min_added_size_y > 0 && added_size_y < min_added_size_y) ||
-          (min_added_size_x == added_size_x && wasted_size_x < min_wasted_size_x) ||
-          (min_added_size_y == added_size_y && wasted_size_y < min_wasted_size_y)) {
-        min_added_size_x = added_size_x;
-        min_added_size_y = added_size_y;
-        min_wasted_size_x = wasted_size_x;
-        min_wasted_size_y = wasted_size_y;
-        best_mem = it;
-        new_mem.x = new_width;
-        new_mem.y = new_height;
-      }
-    }
+  const size_t max_ratio = 5;
+  width = RoundTextureExtent(width);
+  height = RoundTextureExtent(height);
 
-    if (min_added_size_x == 0 && min_added_size_y == 0) {
-      // use existing block
-      e = *best_mem;
-      free_list_.erase(best_mem);
-    } else if (static_cast<size_t>(min_added_size_x) <= width ||
-               static_cast<size_t>(min_added_size_y) <= height) {
-      // if added size is less or equal to
-      // what is needed by alloc, then grow entry
-      device->FreeDataSpace(dev, best_mem->data);
-      free_list_.erase(best_mem);
-      new_mem.type = type_hint;
-      std::vector<int64_t> shape{int64_t(new_mem.y), int64_t(new_mem.x), 4};
-      new_mem.data = device->AllocDataSpace(dev, shape.size(), shape.data(), new_mem.type,
-                                            Optional<String>("global.texture"));
-      e = new_mem;
+  // Best fit: minimize the area the image has to grow by first, and the wasted area thereafter.
+  auto best_mem = free_list_.end();
+  size_t min_added_area = std::numeric_limits<size_t>::max();
+  size_t min_wasted_area = std::numeric_limits<size_t>::max();
+  for (auto it = free_list_.begin(); it != free_list_.end(); ++it) {
+    if (it->type.code != type_hint.code || it->type.bits != type_hint.bits ||
+        it->type.lanes != type_hint.lanes) {
+      continue;
+    }
+    // avoid reusing too small and too big textures
+    if (width / it->x > max_ratio || it->x / width > max_ratio || height / it->y > max_ratio ||
+        it->y / height > max_ratio) {
+      continue;
+    }
+    size_t new_area = std::max(it->x, width) * std::max(it->y, height);
+    size_t added_area = new_area - it->x * it->y;
+    size_t wasted_area = new_area - width * height;
+    if (added_area < min_added_area ||
+        (added_area == min_added_area && wasted_area < min_wasted_area)) {
+      min_added_area = added_area;
+      min_wasted_area = wasted_area;
+      best_mem = it;
     }
   }
 
+  Entry e;
+  e.data = nullptr;
+  if (best_mem != free_list_.end() && min_added_area == 0) {
+    // use existing block
+    e = *best_mem;
+    free_list_.erase(best_mem);
+  } else if (best_mem != free_list_.end() && min_added_area <= width * height) {
+    // if added size is less or equal to
+    // what is needed by alloc, then grow entry
+    e.x = std::max(best_mem->x, width);
+    e.y = std::max(best_mem->y, height);
+    e.type = type_hint;
+    device->FreeDataSpace(dev, best_mem->data);
+    free_list_.erase(best_mem);
+    std::vector<int64_t> shape{int64_t(e.y), int64_t(e.x), 4};
+    e.data = device->AllocDataSpace(dev, shape.size(), shape.data(), e.type,
+                                    Optional<String>("global.texture"));
+  }
+
   if (e.data == nullptr) {
     // create new block
     std::vector<int64_t> shape{int64_t(height), int64_t(width), 4};
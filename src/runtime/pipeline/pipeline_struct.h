@@ -26,7 +26,7 @@
 #include <tvm/runtime/threading_backend.h>
 
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -40,6 +40,8 @@
 namespace tvm {
 namespace runtime {
 #define GLOBAL_MODULE_INDEX -1
+/*!\brief The default number of in-flight ring buffer slots of a forwarded runtime output.*/
+#define DEFAULT_FORWARD_SLOTS 4
 /*!
  *\brief The function is used to build the binding configuration for a runtime. The first
  * 'int' is the output index of the current runtime, the second 'int' is the index of child
@@ -121,12 +123,12 @@ struct ModuleIDHash {
 /*!\brief The data notification structure.*/
 class DataNotify {
  private:
-  /*!\brief The 'contitional variable' is used to wait for notification.*/
-  std::condition_variable notify_cv_;
-  /*!\brief The mutex is used to protect the 'conditional variable'.*/
-  std::mutex mutex_;
+  /*!\brief The number of polls spent spinning before the waiting thread starts to yield.*/
+  static constexpr int kSpinCount = 1024;
+  /*!\brief The number of yields before the waiting thread backs off with a short sleep.*/
+  static constexpr int kYieldCount = 4096;
   /*!\brief Whether a data is ready or not.*/
-  bool data_ready_ = false;
+  std::atomic<bool> data_ready_{false};
   /*!\brief Whether the thread should exit or not.*/
   std::atomic<bool> exit_state_{false};
   /*!\brief The 'ModuleInterfaceID' of an interface which sent this notification.*/
@@ -147,24 +149,27 @@ class DataNotify {
    */
   ModuleInterfaceID GetNotifySource(void) { return notification_source_; }
   /*!
-   *\brief Waiting for the notification.
+   *\brief Waiting for the notification. The waiting thread spins on the ready flag first, then
+   * yields, and finally backs off with short sleeps so that an idle stage does not keep a core
+   * busy.
    *\return Returning the value 'false' when the notification is in a 'exit' state, else
    * return true.
    */
   bool Wait(void) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    notify_cv_.wait(lock, [&] { return this->data_ready_; });
-    data_ready_ = false;
+    int polls = 0;
+    while (!data_ready_.exchange(false, std::memory_order_acq_rel)) {
+      if (GetExitState()) break;
+      if (++polls < kSpinCount) continue;
+      if (polls < kSpinCount + kYieldCount) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+    }
     return !GetExitState();
   }
   /*!brief Sending the notification in which the related data is ready.*/
-  void Notify(void) {
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      data_ready_ = true;
-    }
-    notify_cv_.notify_one();
-  }
+  void Notify(void) { data_ready_.store(true, std::memory_order_release); }
   /*!brief Sending the notification when the notification state changes into 'exit'.*/
   void ExitNotify(void) {
     exit_state_.store(true, std::memory_order_release);
@@ -176,7 +181,60 @@ class DataNotify {
    */
   bool GetExitState(void) { return exit_state_.load(std::memory_order_acquire); }
 };
-/*!\brief The container used to store the forwarding data of the pipeline.*/
+/*!
+ * \brief A ring buffer slot which stores one in-flight output of a backend runtime. The slot is
+ *  handed to the child runtimes by reference and can be reused once every child released it.
+ */
+struct ForwardSlot {
+  /*!\brief The storage which the runtime output is written into.*/
+  NDArray data;
+  /*!\brief The number of child runtimes which still hold a reference to this slot.*/
+  std::atomic<int> pending{0};
+  /*!\brief Releasing the reference held by one child runtime.*/
+  void Release() { pending.fetch_sub(1, std::memory_order_release); }
+};
+/*!\brief The ring buffer of the slots which are used to forward one runtime output.*/
+class ForwardRing {
+ public:
+  /*!
+   * \brief Constructing the ring buffer.
+   * \param like The tensor providing the shape, the data type and the device of the slots.
+   * \param num_slots The number of in-flight slots.
+   */
+  ForwardRing(const DLTensor* like, int num_slots) {
+    ICHECK_GT(num_slots, 0) << "The number of forwarding slots should be positive.";
+    std::vector<int64_t> shape(like->shape, like->shape + like->ndim);
+    for (int i = 0; i < num_slots; i++) {
+      auto slot = std::make_unique<ForwardSlot>();
+      slot->data = NDArray::Empty(shape, like->dtype, like->device);
+      slots_.push_back(std::move(slot));
+    }
+  }
+  /*!
+   * \brief Getting the next slot after all of its child runtimes released it.
+   * \param is_stop The function returns true when the pipeline is stopping.
+   * \return The next free slot, or a null pointer when the pipeline is stopping.
+   */
+  ForwardSlot* Acquire(std::function<bool()> is_stop) {
+    ForwardSlot* slot = slots_[next_].get();
+    while (slot->pending.load(std::memory_order_acquire) != 0) {
+      if (is_stop()) return nullptr;
+      std::this_thread::yield();
+    }
+    next_ = (next_ + 1) % slots_.size();
+    return slot;
+  }
+
+ private:
+  /*!\brief The slots of the ring buffer.*/
+  std::vector<std::unique_ptr<ForwardSlot>> slots_;
+  /*!\brief The index of the next slot to be used.*/
+  size_t next_ = 0;
+};
+/*!
+ * \brief The container used to store the forwarding data of the pipeline. The data is either a
+ *  deep copy owned by the container, or a reference to a 'ForwardSlot' of the parent runtime.
+ */
 class QueueData {
  public:
   explicit QueueData(DLTensor* data) {
@@ -186,10 +244,18 @@ class QueueData {
     data_ = data;
     SetAsDataOwner(false);
   }
+  explicit QueueData(ForwardSlot* slot) { ReferenceSlot(slot); }
   QueueData() { SetAsDataOwner(true); }
-  /*!\brief Doing a deep copy for the 'QueueData' structure.*/
+  /*!
+   * \brief Doing a deep copy for the 'QueueData' structure, or sharing the slot when the data
+   *  is a reference to a 'ForwardSlot'.
+   */
   QueueData& operator=(const QueueData& data) {
-    CreateCopyFrom(data.GetDLData());
+    if (data.GetSlot()) {
+      ReferenceSlot(data.GetSlot());
+    } else {
+      CreateCopyFrom(data.GetDLData());
+    }
     return *this;
   }
   QueueData& operator=(const NDArray& from) {
@@ -205,6 +271,12 @@ class QueueData {
     if (!from) {
       LOG(FATAL) << "the 'from' pointer is a null pointer!";
     }
+    // A container which referenced a slot becomes the owner of its own data again.
+    if (slot_) {
+      slot_ = nullptr;
+      data_ = nullptr;
+      SetAsDataOwner(true);
+    }
     size_t fromLen = tvm::runtime::GetDataSize(*from);
     size_t toLen = data_ ? tvm::runtime::GetDataSize(*data_) : 0;
     if (fromLen != toLen) {
@@ -225,6 +297,16 @@ class QueueData {
   }
   /*!\brief Return a pointer to the 'DLTensor' data.*/
   DLTensor* GetDLData() const { return data_; }
+  /*!\brief Return the referenced slot, or a null pointer when the data is a deep copy.*/
+  ForwardSlot* GetSlot() const { return slot_; }
+  /*!\brief Releasing the referenced slot back to the parent runtime.*/
+  void Release() {
+    if (slot_) {
+      slot_->Release();
+      slot_ = nullptr;
+      data_ = nullptr;
+    }
+  }
   ~QueueData() {
     if (IsDataOwner() && data_) {
       TVMArrayFree(data_);
@@ -235,12 +317,23 @@ class QueueData {
  private:
   /*!\brief Pointer to the forwarding data.*/
   DLTensor* data_ = nullptr;
+  /*!\brief The slot referenced by this container.*/
+  ForwardSlot* slot_ = nullptr;
   /*!\brief Whether this container is the owner of the 'data_'.*/
   bool is_data_owner_ = false;
   /*!\brief Set the current container as the owner of the 'data_'.*/
   void SetAsDataOwner(bool is_owner) { is_data_owner_ = is_owner; }
   /*!Check whether the current container is the owner of the 'data_'.*/
   bool IsDataOwner() const { return is_data_owner_; }
+  /*!\brief Referencing the data of a slot without copying it.*/
+  void ReferenceSlot(ForwardSlot* slot) {
+    if (IsDataOwner() && data_) {
+      TVMArrayFree(data_);
+    }
+    SetAsDataOwner(false);
+    slot_ = slot;
+    data_ = const_cast<DLTensor*>(slot->data.operator->());
+  }
 };
 /*!
  * \brief All binding information of an output interface.
@@ -325,6 +418,7 @@ class ConfigRuntime {
   ConfigRuntime& operator=(const ConfigRuntime& output) {
     output_binding_map_ = output.GetOutBindings();
     cpu_affinity_ = output.GetCPUAffinity();
+    forward_slots_ = output.GetForwardSlots();
     return *this;
   }
 
@@ -342,6 +436,13 @@ class ConfigRuntime {
    * \param Returning the cpu affinity in text form.
    */
   std::string GetCPUAffinity() const { return cpu_affinity_; }
+  /*!
+   * \brief Store the number of ring buffer slots used to forward each output.
+   * \param forward_slots The number of in-flight slots of each forwarded output.
+   */
+  void StoreForwardSlots(int forward_slots) { forward_slots_ = forward_slots; }
+  /*!\brief Getting the number of ring buffer slots used to forward each output.*/
+  int GetForwardSlots() const { return forward_slots_; }
   /*!
    * \brief Enumerating the output configuration.
    * \param parse_function The callback function is used to parse the binding configeration.
@@ -413,6 +514,8 @@ class ConfigRuntime {
   std::unordered_map<int, ConfigBindings> output_binding_map_;
   /*!\brief The cpu affinity setting for the tvm thread pool.*/
   std::string cpu_affinity_;
+  /*!\brief The number of in-flight ring buffer slots of each forwarded output.*/
+  int forward_slots_ = DEFAULT_FORWARD_SLOTS;
 };
 
 /*!
@@ -433,6 +536,14 @@ class ConfigPipelineExecution {
     auto config_runtime = config->second;
     return config_runtime.GetCPUAffinity();
   }
+  /*!\brief Get the number of ring buffer slots used to forward the outputs of a runtime.*/
+  int GetForwardSlots(int runtime_idx) {
+    auto config = config_.find(runtime_idx);
+    if (config == config_.end()) {
+      LOG(FATAL) << "Do not finding the runtime " << runtime_idx;
+    }
+    return config->second.GetForwardSlots();
+  }
   /*!
    * \brief Enumerating the binding configuration for a specified runtime.
    * \param parse_function The callback function is used to parse the binding configuration.
@@ -503,6 +614,7 @@ class ConfigPipelineExecution {
       ConfigRuntime output;
       std::string dev;
       std::string cpu_affinity;
+      int forward_slots = DEFAULT_FORWARD_SLOTS;
       while (reader->NextObjectItem(&key)) {
         if (key == "mod_idx") {
           reader->Read(&mod_idx);
@@ -512,6 +624,8 @@ class ConfigPipelineExecution {
           reader->Read(&output);
         } else if (key == "cpu_affinity") {
           reader->Read(&cpu_affinity);
+        } else if (key == "forward_slots") {
+          reader->Read(&forward_slots);
         } else {
           LOG(FATAL) << "do not support key " << key;
         }
@@ -521,6 +635,8 @@ class ConfigPipelineExecution {
       ICHECK(!output.Empty()) << "Invalid output binding result.";
       // Store the cpu affinity into the 'ConfigRuntime' structure.
       output.StoreCPUAffinity(cpu_affinity);
+      ICHECK(forward_slots > 0) << "Invalid forward_slots value " << forward_slots;
+      output.StoreForwardSlots(forward_slots);
       // Build the mapping of mod_idx and "ConfigRuntime".
       config_[mod_idx] = output;
     }
@@ -735,11 +851,13 @@ class BasicRuntime {
    * \param forward_queue_map The map includes the id and the queue.
    * \param child_runtime The child runtime.
    * \param child_input_index The child runtime index.
-   * \param data The data is used for forwarding.
+   * \param data The data is used for forwarding, either a 'DLTensor' which is copied into the
+   *  queue or a 'QueueData' referencing a slot of the parent runtime.
    */
+  template <typename DataType>
   bool ForwardData(const ForwardQueueMap* forward_queue_map,
                    std::shared_ptr<BasicRuntime> child_runtime, int child_input_index,
-                   const DLTensor* data) {
+                   const DataType& data) {
     auto child_runtime_index = child_runtime->GetModuleIndex();
     auto queue_id = GenerateQueueID(child_runtime_index, child_input_index, INPUT);
     if (forward_queue_map->find(queue_id) == forward_queue_map->end()) {
@@ -750,7 +868,7 @@ class BasicRuntime {
     auto forward_queue = forward_queue_map->at(queue_id);
     // If the queue is full, keep try until the push get success or the pipeline run into
     // a STOP state.
-    while (!forward_queue->Push<const DLTensor*>(data)) {
+    while (!forward_queue->Push<DataType>(data)) {
       if (PipelineIsStop()) {
         LOG(INFO) << "The forwarding process is stopped after the pipeline status is changed"
                   << " into stop.";
@@ -816,6 +934,14 @@ class BackendRuntime : public BasicRuntime {
    * input data and local tensor vairable.
    */
   std::unordered_map<DLTensor*, DLTensor*> input_tensor_local_copy_;
+  /*!\brief The number of in-flight ring buffer slots of each forwarded output.*/
+  int forward_slots_ = DEFAULT_FORWARD_SLOTS;
+  /*!\brief The ring buffers of the outputs which are forwarded to other backend runtimes.*/
+  std::unordered_map<int, std::unique_ptr<ForwardRing>> output_rings_;
+  /*!\brief The slots which the outputs of the current run are written into.*/
+  std::unordered_map<int, ForwardSlot*> output_slots_;
+  /*!\brief The slots of parent runtimes which are bound to the inputs of the current run.*/
+  std::vector<ForwardSlot*> input_slots_;
   /*!\brief The packed functions.*/
   tvm::runtime::PackedFunc set_input_;
   tvm::runtime::PackedFunc get_input_;
@@ -823,6 +949,8 @@ class BackendRuntime : public BasicRuntime {
   tvm::runtime::PackedFunc get_num_output_;
   tvm::runtime::PackedFunc get_num_inputs_;
   tvm::runtime::PackedFunc get_input_index_;
+  tvm::runtime::PackedFunc set_input_zero_copy_;
+  tvm::runtime::PackedFunc set_output_zero_copy_;
   tvm::runtime::PackedFunc run_;
   /*!\brief The worker thread is used to execute the runtimes in pipeline.*/
   void StartWorkThread() {
@@ -894,11 +1022,50 @@ class BackendRuntime : public BasicRuntime {
     }
     auto queue = input_queue_[input_index];
     QueueData data;
-    // TODO(huajsj): Doing the 'SetInput' inside the poll function to avoid one time data copy.
     if (!queue->Poll<QueueData>(&data)) {
       return false;
     }
-    SetInput(input_index, data.GetDLData());
+    ForwardSlot* slot = data.GetSlot();
+    if (slot && set_input_zero_copy_ != nullptr &&
+        IsSameDevice(slot->data, GetInput(input_index))) {
+      // Binding the slot of the parent runtime to the input without copying, the slot is
+      // released after the current run.
+      set_input_zero_copy_(input_index, slot->data);
+      input_slots_.push_back(slot);
+    } else {
+      SetInput(input_index, data.GetDLData());
+      data.Release();
+    }
+    return true;
+  }
+  /*!\brief Checking whether two tensors are on the same device.*/
+  static bool IsSameDevice(const NDArray& a, const NDArray& b) {
+    return a->device.device_type == b->device.device_type &&
+           a->device.device_id == b->device.device_id;
+  }
+  /*!\brief Releasing the slots of parent runtimes which are bound to the inputs.*/
+  void ReleaseInputSlots() {
+    for (auto slot : input_slots_) {
+      slot->Release();
+    }
+    input_slots_.clear();
+  }
+  /*!
+   * \brief Getting a free slot for each forwarded output and binding it as the output storage
+   *  of the next run.
+   * \return Returning false when the pipeline is stopped before a slot is released.
+   */
+  bool AcquireOutputSlots() {
+    for (auto& ring : output_rings_) {
+      ForwardSlot* slot = ring.second->Acquire([this]() { return this->PipelineIsStop(); });
+      if (!slot) {
+        return false;
+      }
+      if (set_output_zero_copy_ != nullptr) {
+        set_output_zero_copy_(ring.first, slot->data);
+      }
+      output_slots_[ring.first] = slot;
+    }
     return true;
   }
   /*!
@@ -912,14 +1079,42 @@ class BackendRuntime : public BasicRuntime {
       if (forward_queue_.find(output_idx) == forward_queue_.end()) {
         LOG(FATAL) << "Not find the forwarding queue map for output(" << output_idx << ")!";
       }
-      NDArray output = GetOutput(output_idx);
       auto forward_queue_map = forward_queue_[output_idx];
+      auto slot_iter = output_slots_.find(output_idx);
+      NDArray output;
+      if (slot_iter != output_slots_.end()) {
+        ForwardSlot* slot = slot_iter->second;
+        // When the backend can not write into the slot directly, copying the output into it.
+        if (set_output_zero_copy_ == nullptr) {
+          slot->data.CopyFrom(GetOutput(output_idx));
+        }
+        output = slot->data;
+        int num_backend_children = 0;
+        for (auto module_pair : child.second) {
+          if (module_pair.first->GetModuleIndex() != GLOBAL_MODULE_INDEX) {
+            num_backend_children++;
+          }
+        }
+        slot->pending.store(num_backend_children, std::memory_order_release);
+      } else {
+        output = GetOutput(output_idx);
+      }
+      const DLTensor* output_data = output.operator->();
       // Notifying the 'children runtime' that the forwarding data are ready.
       for (auto module_pair : child.second) {
         auto child_runtime = module_pair.first;
         auto child_input_index = module_pair.second;
-        auto output_data = const_cast<DLTensor*>(output.operator->());
-        if (!ForwardData(&forward_queue_map, child_runtime, child_input_index, output_data)) {
+        bool ret;
+        if (slot_iter != output_slots_.end() &&
+            child_runtime->GetModuleIndex() != GLOBAL_MODULE_INDEX) {
+          // The backend runtimes get a reference to the slot. The global runtime gets a copy,
+          // so that the pipeline keeps running when the outputs are not read immediately.
+          ret = ForwardData(&forward_queue_map, child_runtime, child_input_index,
+                            QueueData(slot_iter->second));
+        } else {
+          ret = ForwardData(&forward_queue_map, child_runtime, child_input_index, output_data);
+        }
+        if (!ret) {
           return false;
         }
       }
@@ -989,6 +1184,8 @@ class BackendRuntime : public BasicRuntime {
     set_input_ = module_.GetFunction("set_input");
     get_input_ = module_.GetFunction("get_input");
     get_output_ = module_.GetFunction("get_output");
+    set_input_zero_copy_ = module_.GetFunction("set_input_zero_copy");
+    set_output_zero_copy_ = module_.GetFunction("set_output_zero_copy");
     run_ = module_.GetFunction("run");
   }
   ~BackendRuntime() {
@@ -1012,6 +1209,7 @@ class BackendRuntime : public BasicRuntime {
                           std::shared_ptr<BasicRuntime> global_runtime) {
     // Getting the current BackendRuntime's cpu affinity setting.
     cpu_affinity_ = config.GetCPUAffinity(runtime_idx_);
+    forward_slots_ = config.GetForwardSlots(runtime_idx_);
     // Getting the 'binding configuration' for each child runtime.
     config.VisitRuntimeOutputConfig(
         [&](int output_idx, int child_idx, std::string child_input_name) {
@@ -1041,6 +1239,13 @@ class BackendRuntime : public BasicRuntime {
                   << " child.input:" << child_idx << "." << input_index;
           // Creating the pipeline forwarding queue.
           this->CreateForwardingQueue(output_idx, child_runtime, input_index);
+          // Creating the ring buffer used to hand the output over to the backend runtimes.
+          if (GLOBAL_MODULE_INDEX != child_idx &&
+              output_rings_.find(output_idx) == output_rings_.end()) {
+            NDArray output = GetOutput(output_idx);
+            output_rings_[output_idx] =
+                std::make_unique<ForwardRing>(output.operator->(), forward_slots_);
+          }
         },
         runtime_idx_);
 
@@ -1092,7 +1297,12 @@ class BackendRuntime : public BasicRuntime {
    * \return Returning false if the forwarding function failed. Otherwise, returning true.;
    */
   bool RunPipeline() {
+    if (!AcquireOutputSlots()) {
+      ReleaseInputSlots();
+      return false;
+    }
     Run();
+    ReleaseInputSlots();
     bool ret = ForwardingOutputDataToChildren();
     pipeline_execution_count_++;
     return ret;
@@ -177,6 +177,84 @@ void Profiler::Stop() {
   for (size_t i = 0; i < devs_.size(); i++) {
     StopCall();
   }
+  for (auto& collector : collectors_) {
+    collector->Flush();
+  }
+}
+
+SampledCallStats* SampledCallStats::Global() {
+  static SampledCallStats* inst = new SampledCallStats();
+  return inst;
+}
+
+bool SampledCallStats::HasAsyncTimer(Device dev) {
+  // The default timer, used for the devices without a timer, synchronizes the device.
+  return Registry::Get(std::string("profiling.timer.") + DLDeviceType2Str(dev.device_type)) !=
+         nullptr;
+}
+
+void SampledCallStats::Record(String name, Timer timer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pending_.size() >= kMaxPendingTimers) {
+    ++dropped_;
+    return;
+  }
+  pending_.emplace_back(std::move(name), std::move(timer));
+}
+
+void SampledCallStats::Resolve() {
+  std::vector<std::pair<String, Timer>> pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending.swap(pending_);
+  }
+  if (pending.empty()) return;
+  // Read the timers without the lock, as it may wait for the devices.
+  std::vector<int64_t> nanos;
+  nanos.reserve(pending.size());
+  for (const auto& [name, timer] : pending) {
+    nanos.push_back(timer->SyncAndGetElapsedNanos());
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < pending.size(); ++i) {
+    Histogram& hist = histograms_[pending[i].first];
+    int64_t t = std::max<int64_t>(nanos[i], 0);
+    int bucket = 0;
+    while (bucket < kNumBuckets - 1 && (int64_t{2} << bucket) <= t) {
+      ++bucket;
+    }
+    hist.count += 1;
+    hist.total_nanos += t;
+    hist.max_nanos = std::max(hist.max_nanos, t);
+    hist.buckets[bucket] += 1;
+  }
+}
+
+String SampledCallStats::AsJSON() {
+  Resolve();
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::ostringstream s;
+  s << "{\"dropped\":" << dropped_ << ",\"functions\":{";
+  bool first = true;
+  for (const auto& [name, hist] : histograms_) {
+    if (!first) s << ",";
+    first = false;
+    s << "\"" << name << "\":{\"count\":" << hist.count << ",\"total_ns\":" << hist.total_nanos
+      << ",\"max_ns\":" << hist.max_nanos << ",\"buckets\":[";
+    for (int i = 0; i < kNumBuckets; ++i) {
+      s << (i ? "," : "") << hist.buckets[i];
+    }
+    s << "]}";
+  }
+  s << "}}";
+  return s.str();
+}
+
+void SampledCallStats::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_.clear();
+  histograms_.clear();
+  dropped_ = 0;
 }
 
 std::vector<int64_t> ToShape(NDArray shape_tensor) {
@@ -794,6 +872,12 @@ TVM_REGISTER_GLOBAL("runtime.profiling.AsJSON").set_body_typed([](Report n) {
   return n->AsJSON();
 });
 TVM_REGISTER_GLOBAL("runtime.profiling.FromJSON").set_body_typed(Report::FromJSON);
+TVM_REGISTER_GLOBAL("runtime.profiling.SampledCallStats").set_body_typed([]() {
+  return SampledCallStats::Global()->AsJSON();
+});
+TVM_REGISTER_GLOBAL("runtime.profiling.ResetSampledCallStats").set_body_typed([]() {
+  SampledCallStats::Global()->Reset();
+});
 TVM_REGISTER_GLOBAL("runtime.profiling.DeviceWrapper").set_body_typed([](Device dev) {
   return DeviceWrapper(dev);
 });
@@ -832,6 +916,9 @@ PackedFunc ProfileFunction(Module mod, std::string func_name, int device_type, i
     for (auto& kv : collector_data) {
       results.push_back(kv.first->Stop(kv.second));
     }
+    for (auto& kv : collector_data) {
+      kv.first->Flush();
+    }
     Map<String, ObjectRef> combined_results;
     for (auto m : results) {
       for (auto p : m) {
@@ -859,6 +946,39 @@ TVM_REGISTER_GLOBAL("runtime.profiling.ProfileFunction")
       }
     });
 
+/*!
+ * \brief Measure one repeat of a function, adjusting number to meet min_repeat_ms.
+ * \return The average cost of one call in seconds.
+ */
+static double MeasureRepeat(const PackedFunc& pf, const TVMArgs& args, Device dev, int* number,
+                            int min_repeat_ms, int limit_zero_time_iterations,
+                            NDArray* cache_flush_arrs) {
+  TVMRetValue temp;
+  double duration_ms = 0.0;
+  int absolute_zero_times = 0;
+  do {
+    if (duration_ms > 0.0) {
+      const double golden_ratio = 1.618;
+      *number = static_cast<int>(
+          std::max((min_repeat_ms / (duration_ms / *number) + 1), *number * golden_ratio));
+    }
+    if (cache_flush_arrs[0].defined()) {
+      cache_flush_arrs[0].CopyFrom(cache_flush_arrs[1]);
+    }
+    DeviceAPI::Get(dev)->StreamSync(dev, nullptr);
+    // start timing
+    Timer t = Timer::Start(dev);
+    for (int j = 0; j < *number; ++j) {
+      pf.CallPacked(args, &temp);
+    }
+    t->Stop();
+    int64_t t_nanos = t->SyncAndGetElapsedNanos();
+    if (t_nanos == 0) absolute_zero_times++;
+    duration_ms = t_nanos / 1e6;
+  } while (duration_ms < min_repeat_ms && absolute_zero_times < limit_zero_time_iterations);
+  return duration_ms / 1e3 / *number;
+}
+
 PackedFunc WrapTimeEvaluator(PackedFunc pf, Device dev, int number, int repeat, int min_repeat_ms,
                              int limit_zero_time_iterations, int cooldown_interval_ms,
                              int repeats_to_cooldown, int cache_flush_bytes, PackedFunc f_preproc) {
@@ -869,60 +989,62 @@ PackedFunc WrapTimeEvaluator(PackedFunc pf, Device dev, int number, int repeat,
     ICHECK(get_micro_time_evaluator != nullptr) << "micro backend not enabled";
     return (*get_micro_time_evaluator)(pf, dev, number, repeat);
   }
+  return WrapBatchTimeEvaluator({pf}, dev, number, repeat, min_repeat_ms,
+                                limit_zero_time_iterations, cooldown_interval_ms,
+                                repeats_to_cooldown, cache_flush_bytes, f_preproc);
+}
+
+PackedFunc WrapBatchTimeEvaluator(std::vector<PackedFunc> pfs, Device dev, int number, int repeat,
+                                  int min_repeat_ms, int limit_zero_time_iterations,
+                                  int cooldown_interval_ms, int repeats_to_cooldown,
+                                  int cache_flush_bytes, PackedFunc f_preproc) {
+  ICHECK(!pfs.empty());
+  for (const PackedFunc& pf : pfs) {
+    ICHECK(pf != nullptr);
+  }
 
-  auto ftimer = [pf, dev, number, repeat, min_repeat_ms, limit_zero_time_iterations,
+  auto ftimer = [pfs, dev, number, repeat, min_repeat_ms, limit_zero_time_iterations,
                  cooldown_interval_ms, repeats_to_cooldown, cache_flush_bytes,
-                 f_preproc](TVMArgs args, TVMRetValue* rv) mutable {
+                 f_preproc](TVMArgs args, TVMRetValue* rv) {
     TVMRetValue temp;
-    std::ostringstream os;
+    size_t num_funcs = pfs.size();
     // skip first time call, to activate lazy compilation components.
-    pf.CallPacked(args, &temp);
+    for (const PackedFunc& pf : pfs) {
+      pf.CallPacked(args, &temp);
+    }
 
     // allocate two large arrays to flush L2 cache
-    NDArray arr1, arr2;
+    NDArray cache_flush_arrs[2];
     if (cache_flush_bytes > 0) {
-      arr1 = NDArray::Empty({cache_flush_bytes / 4}, {kDLInt, 32, 1}, dev);
-      arr2 = NDArray::Empty({cache_flush_bytes / 4}, {kDLInt, 32, 1}, dev);
+      cache_flush_arrs[0] = NDArray::Empty({cache_flush_bytes / 4}, {kDLInt, 32, 1}, dev);
+      cache_flush_arrs[1] = NDArray::Empty({cache_flush_bytes / 4}, {kDLInt, 32, 1}, dev);
     }
 
     DeviceAPI::Get(dev)->StreamSync(dev, nullptr);
 
+    // Each function keeps its own number, as min_repeat_ms adjusts it.
+    std::vector<int> numbers(num_funcs, number);
+    // speeds[k * repeat + i] is the cost of function k in repeat i.
+    std::vector<double> speeds(num_funcs * repeat);
     for (int i = 0; i < repeat; ++i) {
       if (f_preproc != nullptr) {
         f_preproc.CallPacked(args, &temp);
       }
-      double duration_ms = 0.0;
-      int absolute_zero_times = 0;
-      do {
-        if (duration_ms > 0.0) {
-          const double golden_ratio = 1.618;
-          number = static_cast<int>(
-              std::max((min_repeat_ms / (duration_ms / number) + 1), number * golden_ratio));
-        }
-        if (cache_flush_bytes > 0) {
-          arr1.CopyFrom(arr2);
-        }
-        DeviceAPI::Get(dev)->StreamSync(dev, nullptr);
-        // start timing
-        Timer t = Timer::Start(dev);
-        for (int j = 0; j < number; ++j) {
-          pf.CallPacked(args, &temp);
-        }
-        t->Stop();
-        int64_t t_nanos = t->SyncAndGetElapsedNanos();
-        if (t_nanos == 0) absolute_zero_times++;
-        duration_ms = t_nanos / 1e6;
-      } while (duration_ms < min_repeat_ms && absolute_zero_times < limit_zero_time_iterations);
-
-      double speed = duration_ms / 1e3 / number;
-      os.write(reinterpret_cast<char*>(&speed), sizeof(speed));
+      // Rotate the order of the functions in each repeat, so that a drift of the device
+      // (e.g. thermal throttling) spreads evenly over them.
+      for (size_t j = 0; j < num_funcs; ++j) {
+        size_t k = (i + j) % num_funcs;
+        speeds[k * repeat + i] = MeasureRepeat(pfs[k], args, dev, &numbers[k], min_repeat_ms,
+                                               limit_zero_time_iterations, cache_flush_arrs);
+      }
 
       if (cooldown_interval_ms > 0 && (i % repeats_to_cooldown) == 0) {
         std::this_thread::sleep_for(std::chrono::milliseconds(cooldown_interval_ms));
       }
     }
 
-    std::string blob = os.str();
+    std::string blob(reinterpret_cast<const char*>(speeds.data()),
+                     speeds.size() * sizeof(double));
     TVMByteArray arr;
     arr.size = blob.length();
     arr.data = blob.data();
@@ -27,6 +27,7 @@
 #include <tvm/runtime/registry.h>
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -45,6 +46,8 @@ struct Registry::Manager {
   std::unordered_map<String, Registry*> fmap;
   // mutex
   std::mutex mutex;
+  // bumped whenever a function is registered or removed.
+  std::atomic<uint64_t> version{0};
 
   Manager() {}
 
@@ -72,6 +75,7 @@ Registry& Registry::Register(const String& name, bool can_override) {  // NOLINT
   Registry* r = new Registry();
   r->name_ = name;
   m->fmap[name] = r;
+  m->version.fetch_add(1, std::memory_order_relaxed);
   return *r;
 }
 
@@ -81,6 +85,7 @@ bool Registry::Remove(const String& name) {
   auto it = m->fmap.find(name);
   if (it == m->fmap.end()) return false;
   m->fmap.erase(it);
+  m->version.fetch_add(1, std::memory_order_relaxed);
   return true;
 }
 
@@ -103,6 +108,10 @@ std::vector<String> Registry::ListNames() {
   return keys;
 }
 
+uint64_t Registry::Version() {
+  return Manager::Global()->version.load(std::memory_order_relaxed);
+}
+
 /*!
  * \brief Execution environment specific API registry.
  *
@@ -332,6 +341,12 @@ int TVMFuncRemoveGlobal(const char* name) {
   API_END();
 }
 
+int TVMFuncGetGlobalVersion(uint64_t* out) {
+  API_BEGIN();
+  *out = tvm::runtime::Registry::Version();
+  API_END();
+}
+
 int TVMBackendRegisterEnvCAPI(const char* name, void* ptr) {
   API_BEGIN();
   tvm::runtime::EnvCAPIRegistry::Global()->Register(name, ptr);
@@ -359,6 +359,33 @@ TVM_REGISTER_GLOBAL("vm.builtin.alloc_storage").set_body_typed(VMAllocStorage);
 
 TVM_REGISTER_GLOBAL("vm.builtin.alloc_tensor").set_body_method<Storage>(&StorageObj::AllocNDArray);
 
+/*!
+ * \brief Create a VM instrument that reports allocator statistics after every call.
+ *
+ * Pass the name of this function to VirtualMachine::_SetInstrument as a factory.
+ * \param device_type The device type of the allocator.
+ * \param device_id The device id of the allocator.
+ * \param alloc_type The allocator type.
+ * \param callback Invoked as callback(func_symbol, stats) after each call instruction.
+ * \return The instrument function.
+ */
+PackedFunc MemoryStatsInstrument(int device_type, int device_id, int alloc_type,
+                                 PackedFunc callback) {
+  Device dev{static_cast<DLDeviceType>(device_type), device_id};
+  auto type = static_cast<memory::AllocatorType>(alloc_type);
+  return PackedFunc([dev, type, callback](TVMArgs args, TVMRetValue* rv) {
+    bool before_run = args[2];
+    if (!before_run) {
+      String func_symbol = args[1];
+      callback(func_symbol, memory::AllocatorStatsToMap(memory::MemoryManager::GetStats(dev, type)));
+    }
+    *rv = static_cast<int>(VMInstrumentReturnKind::kNoOp);
+  });
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.memory_manager.stats_instrument")
+    .set_body_typed(MemoryStatsInstrument);
+
 //-------------------------------------------------
 //  Closure function handling, calling convention
 //-------------------------------------------------
@@ -421,7 +448,20 @@ TVM_REGISTER_GLOBAL("vm.builtin.null_value").set_body([](TVMArgs args, TVMRetVal
 TVM_REGISTER_GLOBAL("vm.builtin.to_device")
     .set_body_typed([](NDArray data, int dev_type, int dev_id) {
       Device dst_device = {(DLDeviceType)dev_type, dev_id};
-      return data.CopyTo(dst_device);
+      Device copy_device = data->device.device_type != kDLCPU ? data->device : dst_device;
+      if (copy_device.device_type == kDLCPU) {
+        return data.CopyTo(dst_device);
+      }
+      // Copy on the current stream, which orders the copy with the kernels around it. Only a
+      // copy to the host has to wait, and only for that stream.
+      DeviceAPI* api = DeviceAPI::Get(copy_device);
+      TVMStreamHandle stream = api->GetCurrentStream(copy_device);
+      NDArray ret = NDArray::Empty(data.Shape(), data->dtype, dst_device);
+      NDArray::CopyFromTo(data.operator->(), const_cast<DLTensor*>(ret.operator->()), stream);
+      if (dst_device.device_type == kDLCPU) {
+        api->StreamSync(copy_device, stream);
+      }
+      return ret;
     });
 
 /*!
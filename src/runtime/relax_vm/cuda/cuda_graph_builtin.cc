@@ -22,16 +22,28 @@
  * \brief The CUDA graph related builtin functions for Relax virtual machine.
  */
 
+#include <tvm/runtime/container/boxed_primitive.h>
+#include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/relax_vm/vm.h>
 
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <vector>
+
 #include "../../../support/utils.h"
 #include "../../cuda/cuda_common.h"
 namespace tvm {
 namespace runtime {
 namespace relax_vm {
 
+// Defined in l2_persisting_builtin.cc.
+void BeginCaptureL2PersistingWindows(cudaStream_t stream, cudaStream_t capture_stream);
+void ApplyCapturedL2PersistingWindows(cudaGraph_t graph);
+
 namespace {
 
 struct CUDAGraphCaptureKey {
@@ -96,6 +108,100 @@ struct CUDAGraphCapturedState {
   cudaGraphExec_t exec = nullptr;
 };
 
+/*! \brief The process-wide policy of the CUDA graph cache. */
+struct CUDAGraphCacheConfig {
+  /*! \brief The max number of graphs each VM keeps captured, 0 means unlimited. */
+  int64_t max_captured_graphs = 0;
+  /*!
+   * \brief The sorted values the symbolic variables are padded up to. When not empty, only the
+   * shapes whose every value is a bucket are captured, the other shapes run without CUDA graph.
+   */
+  std::vector<int64_t> shape_buckets;
+
+  static CUDAGraphCacheConfig Get() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return *Global();
+  }
+
+  static void Set(CUDAGraphCacheConfig config) {
+    std::sort(config.shape_buckets.begin(), config.shape_buckets.end());
+    std::lock_guard<std::mutex> lock(mutex_);
+    *Global() = std::move(config);
+  }
+
+  /*! \brief Round the value up to the smallest bucket that covers it. */
+  int64_t RoundToBucket(int64_t value) const {
+    auto it = std::lower_bound(shape_buckets.begin(), shape_buckets.end(), value);
+    return it == shape_buckets.end() ? value : *it;
+  }
+
+  /*! \brief Whether the graph of the given shape should be captured. */
+  bool IsCapturable(const ShapeTuple& shape_expr) const {
+    if (shape_buckets.empty()) return true;
+    return std::all_of(shape_expr.begin(), shape_expr.end(), [this](int64_t value) {
+      return std::binary_search(shape_buckets.begin(), shape_buckets.end(), value);
+    });
+  }
+
+ private:
+  static CUDAGraphCacheConfig* Global() {
+    static CUDAGraphCacheConfig inst;
+    return &inst;
+  }
+  static inline std::mutex mutex_;
+};
+
+/*! \brief The process-wide counters of the CUDA graph cache. */
+struct CUDAGraphCacheCounters {
+  std::atomic<int64_t> launches{0};
+  std::atomic<int64_t> captures{0};
+  std::atomic<int64_t> exec_updates{0};
+  std::atomic<int64_t> evictions{0};
+  std::atomic<int64_t> uncaptured_runs{0};
+  std::atomic<int64_t> captured_graphs{0};
+  std::atomic<int64_t> cached_alloc_bytes{0};
+
+  static CUDAGraphCacheCounters* Global() {
+    static CUDAGraphCacheCounters inst;
+    return &inst;
+  }
+};
+
+/*! \brief The number of bytes of the storage objects in the given (nested) tuple. */
+int64_t GetStorageBytes(const ObjectRef& obj) {
+  if (const auto* storage = obj.as<memory::StorageObj>()) {
+    return static_cast<int64_t>(storage->buffer.size);
+  }
+  int64_t nbytes = 0;
+  if (const auto* arr = obj.as<ArrayNode>()) {
+    for (const ObjectRef& elem : *arr) {
+      nbytes += GetStorageBytes(elem);
+    }
+  }
+  return nbytes;
+}
+
+/*!
+ * \brief Update the instantiated graph in place to the given graph.
+ * \return Whether the update succeeded. It fails when the topology of the graphs differ.
+ */
+bool UpdateGraphExec(cudaGraphExec_t exec, cudaGraph_t graph) {
+#if CUDART_VERSION >= 12000
+  cudaGraphExecUpdateResultInfo result_info;
+  cudaError_t err = cudaGraphExecUpdate(exec, graph, &result_info);
+#else
+  cudaGraphNode_t error_node;
+  cudaGraphExecUpdateResult result;
+  cudaError_t err = cudaGraphExecUpdate(exec, graph, &error_node, &result);
+#endif
+  if (err != cudaSuccess) {
+    // Reset the error state so that it does not leak into the next CUDA call.
+    cudaGetLastError();
+    return false;
+  }
+  return true;
+}
+
 class ScopedCUDAStream {
  public:
   ScopedCUDAStream() { CUDA_CALL(cudaStreamCreate(&stream_)); }
@@ -116,6 +222,7 @@ class CUDACaptureStream {
   explicit CUDACaptureStream(cudaGraph_t* graph)
       : prev_default_stream_(CUDAThreadEntry::ThreadLocal()->stream), output_graph_(graph) {
     CUDAThreadEntry::ThreadLocal()->stream = capture_stream_;
+    BeginCaptureL2PersistingWindows(prev_default_stream_, capture_stream_);
 
     CUDA_CALL(cudaStreamBeginCapture(capture_stream_, cudaStreamCaptureModeGlobal));
   }
@@ -150,11 +257,14 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
    */
   ObjectRef RunOrCapture(VirtualMachine* vm, const ObjectRef& capture_func, ObjectRef args,
                          int64_t entry_index, Optional<ShapeTuple> shape_expr) {
+    CUDAGraphCacheCounters* counters = CUDAGraphCacheCounters::Global();
     CUDAGraphCaptureKey entry_key{entry_index, shape_expr};
     if (auto it = capture_cache_.find(entry_key); it != capture_cache_.end()) {
       // Launch CUDA graph
-      const auto& [states, exec] = it->second;
+      lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+      const auto& [states, exec] = it->second.state;
       CUDA_CALL(cudaGraphLaunch(exec, CUDAThreadEntry::ThreadLocal()->stream));
+      counters->launches.fetch_add(1, std::memory_order_relaxed);
       return states;
     }
 
@@ -175,6 +285,13 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
     vm->InvokeClosurePacked(capture_func, TVMArgs(values.data(), tcodes.data(), nargs),
                             &capture_func_rv);
 
+    CUDAGraphCacheConfig config = CUDAGraphCacheConfig::Get();
+    if (!config.IsCapturable(entry_key.shape_expr)) {
+      // Shapes outside of the buckets would fill the cache with graphs that are rarely reused.
+      counters->uncaptured_runs.fetch_add(1, std::memory_order_relaxed);
+      return capture_func_rv;
+    }
+
     // Run the graph in capture mode
     cudaGraph_t graph;
 
@@ -183,15 +300,38 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
       vm->InvokeClosurePacked(capture_func, TVMArgs(values.data(), tcodes.data(), nargs),
                               &capture_func_rv);
     }
+    ApplyCapturedL2PersistingWindows(graph);
 
     CUDAGraphCapturedState entry;
     entry.states = capture_func_rv;
-    CUDA_CALL(cudaGraphInstantiate(&entry.exec, graph, NULL, NULL, 0));
+    if (config.max_captured_graphs > 0 &&
+        static_cast<int64_t>(capture_cache_.size()) >= config.max_captured_graphs) {
+      // Evict the least recently used graph. When it belongs to the same capture function, the
+      // kernels usually only differ in their arguments, and the instantiated graph can be updated
+      // in place, which is much cheaper than instantiating a new one.
+      auto victim = capture_cache_.find(lru_.back());
+      CUDAGraphCapturedState evicted = std::move(victim->second.state);
+      bool same_func = victim->first.index == entry_index;
+      capture_cache_.erase(victim);
+      lru_.pop_back();
+      counters->evictions.fetch_add(1, std::memory_order_relaxed);
+      counters->captured_graphs.fetch_sub(1, std::memory_order_relaxed);
+      if (same_func && UpdateGraphExec(evicted.exec, graph)) {
+        std::swap(entry.exec, evicted.exec);
+        counters->exec_updates.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    if (entry.exec == nullptr) {
+      CUDA_CALL(cudaGraphInstantiate(&entry.exec, graph, NULL, NULL, 0));
+    }
     CUDA_CALL(cudaGraphDestroy(graph));
+    counters->captures.fetch_add(1, std::memory_order_relaxed);
+    counters->captured_graphs.fetch_add(1, std::memory_order_relaxed);
 
     ObjectRef states = entry.states;
 
-    capture_cache_[entry_key] = std::move(entry);
+    lru_.push_front(entry_key);
+    capture_cache_.emplace(entry_key, CaptureCacheEntry{std::move(entry), lru_.begin()});
 
     return states;
   }
@@ -212,9 +352,19 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
     vm->InvokeClosurePacked(alloc_func, TVMArgs(nullptr, nullptr, 0), &alloc_func_rv);
     ObjectRef alloc_result = alloc_func_rv;
     alloc_cache_[entry_index] = alloc_result;
+    int64_t nbytes = GetStorageBytes(alloc_result);
+    cached_alloc_bytes_ += nbytes;
+    CUDAGraphCacheCounters::Global()->cached_alloc_bytes.fetch_add(nbytes,
+                                                                   std::memory_order_relaxed);
     return alloc_result;
   }
 
+  ~CUDAGraphExtensionNode() {
+    CUDAGraphCacheCounters* counters = CUDAGraphCacheCounters::Global();
+    counters->captured_graphs.fetch_sub(capture_cache_.size(), std::memory_order_relaxed);
+    counters->cached_alloc_bytes.fetch_sub(cached_alloc_bytes_, std::memory_order_relaxed);
+  }
+
   static constexpr const char* _type_key = "relax_vm.CUDAGraphExtension";
 
  private:
@@ -222,14 +372,23 @@ class CUDAGraphExtensionNode : public VMExtensionNode {
    * \brief The cache of captured cuda graphs. The key is a unique index for the capture function.
    * The value is the result of the capture.
    */
-  std::unordered_map<CUDAGraphCaptureKey, CUDAGraphCapturedState, CUDAGraphCaptureKeyHash,
+  struct CaptureCacheEntry {
+    CUDAGraphCapturedState state;
+    /*! \brief The position of the entry in the LRU list. */
+    std::list<CUDAGraphCaptureKey>::iterator lru_it;
+  };
+  std::unordered_map<CUDAGraphCaptureKey, CaptureCacheEntry, CUDAGraphCaptureKeyHash,
                      CUDAGraphCaptureKeyEqual>
       capture_cache_;
+  /*! \brief The keys of the captured graphs, from the most to the least recently used. */
+  std::list<CUDAGraphCaptureKey> lru_;
   /*!
    * \brief The cache of allocations. The key is a unique index for the allocation function.
    * The value is the cached allocations, which is a tuple of storages.
    */
   std::unordered_map<int64_t, ObjectRef> alloc_cache_;
+  /*! \brief The number of bytes held by the cached allocations. */
+  int64_t cached_alloc_bytes_ = 0;
 };
 
 /*! Managed reference to CUDAGraphExtensionNode */
@@ -267,6 +426,33 @@ TVM_REGISTER_GLOBAL("vm.builtin.cuda_graph.get_cached_alloc")
       *rv = extension->GetCachedAllocation(vm, alloc_func, entry_index);
     });
 
+TVM_REGISTER_GLOBAL("vm.builtin.cuda_graph.set_cache_config")
+    .set_body_typed([](int64_t max_captured_graphs, ShapeTuple shape_buckets) {
+      CHECK_GE(max_captured_graphs, 0) << "ValueError: max_captured_graphs must be non-negative";
+      CUDAGraphCacheConfig config;
+      config.max_captured_graphs = max_captured_graphs;
+      config.shape_buckets.assign(shape_buckets.begin(), shape_buckets.end());
+      CUDAGraphCacheConfig::Set(std::move(config));
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.cuda_graph.round_to_bucket").set_body_typed([](int64_t value) {
+  return CUDAGraphCacheConfig::Get().RoundToBucket(value);
+});
+
+TVM_REGISTER_GLOBAL("vm.builtin.cuda_graph.stats").set_body_typed([]() {
+  CUDAGraphCacheCounters* counters = CUDAGraphCacheCounters::Global();
+  Map<String, ObjectRef> ret;
+  ret.Set("launches", Int(counters->launches.load(std::memory_order_relaxed)));
+  ret.Set("captures", Int(counters->captures.load(std::memory_order_relaxed)));
+  ret.Set("exec_updates", Int(counters->exec_updates.load(std::memory_order_relaxed)));
+  ret.Set("evictions", Int(counters->evictions.load(std::memory_order_relaxed)));
+  ret.Set("uncaptured_runs", Int(counters->uncaptured_runs.load(std::memory_order_relaxed)));
+  ret.Set("captured_graphs", Int(counters->captured_graphs.load(std::memory_order_relaxed)));
+  ret.Set("cached_alloc_bytes",
+          Int(counters->cached_alloc_bytes.load(std::memory_order_relaxed)));
+  return ret;
+});
+
 }  // namespace relax_vm
 }  // namespace runtime
 }  // namespace tvm
@@ -0,0 +1,241 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/cuda/l2_persisting_builtin.cc
+ * \brief The builtin functions keeping hot tensors resident in the L2 cache for Relax virtual
+ * machine.
+ *
+ * On devices with compute capability 8.0 and above, a stream can carry an access policy window,
+ * a range of global memory whose accesses by the kernels of the stream are marked as persisting
+ * in the part of the L2 cache set aside for persisting accesses. On the other devices, the
+ * builtins do nothing.
+ */
+
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+#include "../../cuda/cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+namespace {
+
+/*!
+ * \brief The windows set while a stream is captured into a CUDA graph.
+ *
+ * The kernel nodes of a graph do not reliably inherit the attributes of the captured stream, so
+ * the window is set on the kernel nodes captured between the set and the reset of each window,
+ * once the capture is done.
+ */
+struct CapturedWindow {
+  cudaAccessPolicyWindow window;
+  /*! \brief The nodes of the graph when the window was set. */
+  std::unordered_set<cudaGraphNode_t> nodes_before;
+  /*! \brief The nodes of the graph when the window was reset, empty while it is still set. */
+  std::vector<cudaGraphNode_t> nodes_after;
+  bool closed = false;
+};
+
+struct L2PersistingState {
+  std::vector<CapturedWindow> captured_windows;
+  /*! \brief The persisting L2 set-aside of each device, as set by the builtins. */
+  std::vector<size_t> persisting_size;
+
+  static L2PersistingState* ThreadLocal() {
+    static thread_local L2PersistingState state;
+    return &state;
+  }
+};
+
+/*! \brief Get the graph the stream is being captured into, or nullptr. */
+cudaGraph_t GetCapturingGraph(cudaStream_t stream) {
+  cudaStreamCaptureStatus status;
+  cudaGraph_t graph = nullptr;
+  CUDA_CALL(cudaStreamGetCaptureInfo_v2(stream, &status, nullptr, &graph, nullptr, nullptr));
+  return status == cudaStreamCaptureStatusActive ? graph : nullptr;
+}
+
+std::vector<cudaGraphNode_t> GetGraphNodes(cudaGraph_t graph) {
+  size_t num_nodes = 0;
+  CUDA_CALL(cudaGraphGetNodes(graph, nullptr, &num_nodes));
+  std::vector<cudaGraphNode_t> nodes(num_nodes);
+  if (num_nodes != 0) {
+    CUDA_CALL(cudaGraphGetNodes(graph, nodes.data(), &num_nodes));
+  }
+  return nodes;
+}
+
+void CloseCapturedWindow(cudaStream_t stream) {
+  auto& windows = L2PersistingState::ThreadLocal()->captured_windows;
+  if (windows.empty() || windows.back().closed) return;
+  if (cudaGraph_t graph = GetCapturingGraph(stream)) {
+    windows.back().nodes_after = GetGraphNodes(graph);
+  }
+  windows.back().closed = true;
+}
+
+void SetStreamWindow(cudaStream_t stream, const cudaAccessPolicyWindow& window) {
+  cudaStreamAttrValue attr = {};
+  attr.accessPolicyWindow = window;
+  CUDA_CALL(cudaStreamSetAttribute(stream, cudaStreamAttributeAccessPolicyWindow, &attr));
+}
+
+}  // namespace
+
+/*!
+ * \brief Carry the window of a stream over to the stream replacing it during a capture.
+ * \param stream The stream replaced during the capture.
+ * \param capture_stream The stream to be captured, before the capture begins.
+ */
+void BeginCaptureL2PersistingWindows(cudaStream_t stream, cudaStream_t capture_stream) {
+  auto& windows = L2PersistingState::ThreadLocal()->captured_windows;
+  windows.clear();
+  cudaStreamAttrValue attr = {};
+  CUDA_CALL(cudaStreamGetAttribute(stream, cudaStreamAttributeAccessPolicyWindow, &attr));
+  if (attr.accessPolicyWindow.num_bytes == 0) return;
+  SetStreamWindow(capture_stream, attr.accessPolicyWindow);
+  // The window covers the kernels captured until it is reset or replaced.
+  CapturedWindow captured;
+  captured.window = attr.accessPolicyWindow;
+  windows.push_back(std::move(captured));
+}
+
+/*!
+ * \brief Set the window of the kernel nodes captured under the windows set during the capture of
+ * a graph, and forget the windows.
+ * \param graph The captured graph, before it is instantiated.
+ */
+void ApplyCapturedL2PersistingWindows(cudaGraph_t graph) {
+  auto& windows = L2PersistingState::ThreadLocal()->captured_windows;
+  for (CapturedWindow& captured : windows) {
+    std::vector<cudaGraphNode_t> nodes =
+        captured.closed ? std::move(captured.nodes_after) : GetGraphNodes(graph);
+    cudaKernelNodeAttrValue value = {};
+    value.accessPolicyWindow = captured.window;
+    for (cudaGraphNode_t node : nodes) {
+      if (captured.nodes_before.count(node)) continue;
+      cudaGraphNodeType type;
+      CUDA_CALL(cudaGraphNodeGetType(node, &type));
+      if (type == cudaGraphNodeTypeKernel) {
+        CUDA_CALL(cudaGraphKernelNodeSetAttribute(
+            node, cudaKernelNodeAttributeAccessPolicyWindow, &value));
+      }
+    }
+  }
+  windows.clear();
+}
+
+/*!
+ * \brief Mark the accesses to a tensor by the following kernels of the current stream as
+ * persisting in the L2 cache.
+ * \param data The tensor.
+ * \param hit_ratio The fraction of the window that is persisting. It is lowered when the tensor
+ * is larger than the persisting L2 set-aside, so that the persisting lines do not thrash.
+ * \return The tensor.
+ */
+NDArray SetL2PersistingWindow(NDArray data, double hit_ratio) {
+  CHECK_EQ(data->device.device_type, kDLCUDA)
+      << "ValueError: The L2 persisting window requires a CUDA tensor, but got a tensor on "
+      << data->device;
+  CHECK(hit_ratio > 0 && hit_ratio <= 1)
+      << "ValueError: The hit ratio must be in (0, 1], but got " << hit_ratio;
+  int device_id = data->device.device_id;
+  CUDA_CALL(cudaSetDevice(device_id));
+  int max_window_size = 0, max_persisting_size = 0;
+  CUDA_CALL(
+      cudaDeviceGetAttribute(&max_window_size, cudaDevAttrMaxAccessPolicyWindowSize, device_id));
+  CUDA_CALL(cudaDeviceGetAttribute(&max_persisting_size, cudaDevAttrMaxPersistingL2CacheSize,
+                                   device_id));
+  if (max_window_size == 0 || max_persisting_size == 0) return data;
+
+  size_t nbytes = std::min(GetDataSize(*data.operator->()), static_cast<size_t>(max_window_size));
+  L2PersistingState* state = L2PersistingState::ThreadLocal();
+  if (state->persisting_size.size() <= static_cast<size_t>(device_id)) {
+    state->persisting_size.resize(device_id + 1, 0);
+  }
+  size_t& persisting_size = state->persisting_size[device_id];
+  if (persisting_size < std::min(nbytes, static_cast<size_t>(max_persisting_size))) {
+    persisting_size = std::min(nbytes, static_cast<size_t>(max_persisting_size));
+    CUDA_CALL(cudaDeviceSetLimit(cudaLimitPersistingL2CacheSize, persisting_size));
+  }
+
+  cudaAccessPolicyWindow window = {};
+  window.base_ptr = static_cast<char*>(data->data) + data->byte_offset;
+  window.num_bytes = nbytes;
+  window.hitRatio = std::min(hit_ratio, static_cast<double>(persisting_size) / nbytes);
+  window.hitProp = cudaAccessPropertyPersisting;
+  window.missProp = cudaAccessPropertyStreaming;
+
+  cudaStream_t stream = CUDAThreadEntry::ThreadLocal()->stream;
+  SetStreamWindow(stream, window);
+  if (cudaGraph_t graph = GetCapturingGraph(stream)) {
+    CloseCapturedWindow(stream);
+    CapturedWindow captured;
+    captured.window = window;
+    std::vector<cudaGraphNode_t> nodes = GetGraphNodes(graph);
+    captured.nodes_before.insert(nodes.begin(), nodes.end());
+    state->captured_windows.push_back(std::move(captured));
+  }
+  return data;
+}
+
+/*!
+ * \brief Clear the window of the current stream.
+ * \param data The tensor the window was set for.
+ */
+void ResetL2PersistingWindow(NDArray data) {
+  CUDA_CALL(cudaSetDevice(data->device.device_id));
+  cudaStream_t stream = CUDAThreadEntry::ThreadLocal()->stream;
+  if (GetCapturingGraph(stream)) {
+    CloseCapturedWindow(stream);
+  }
+  cudaAccessPolicyWindow window = {};
+  window.num_bytes = 0;
+  window.hitRatio = 0;
+  window.hitProp = cudaAccessPropertyNormal;
+  window.missProp = cudaAccessPropertyNormal;
+  SetStreamWindow(stream, window);
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.cuda.set_l2_persisting_window")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.size(), 3);
+      NDArray data = args[1];
+      double hit_ratio = args[2];
+      *rv = SetL2PersistingWindow(data, hit_ratio);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.cuda.reset_l2_persisting_window")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.size(), 2);
+      NDArray data = args[1];
+      ResetL2PersistingWindow(data);
+    });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
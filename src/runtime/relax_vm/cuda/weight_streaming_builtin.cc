@@ -0,0 +1,194 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/cuda/weight_streaming_builtin.cc
+ * \brief The builtin functions streaming weights from host memory for Relax virtual machine.
+ */
+
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/vm.h>
+
+#include <vector>
+
+#include "../../cuda/cuda_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief The VM extension holding the ring of device buffers the weights are streamed into.
+ *
+ * The copies are issued on a non-blocking copy stream, so that they overlap with the kernels
+ * on the compute stream. Each slot of the ring has two events, one recorded on the copy stream
+ * when the copy into the slot is done, the other recorded on the compute stream when the
+ * computation is done with the slot. The host memory should be pinned, otherwise the copies
+ * are synchronous with respect to the host.
+ */
+class WeightStreamingExtensionNode : public VMExtensionNode {
+ public:
+  TVM_DECLARE_FINAL_OBJECT_INFO(WeightStreamingExtensionNode, VMExtensionNode);
+
+  /*!
+   * \brief Issue the copy of a weight into a slot of the ring.
+   * \param device The device of the ring.
+   * \param host The weight in host memory.
+   * \param slot The slot the weight is copied into.
+   * \param num_slots The number of slots of the ring.
+   * \param slot_nbytes The size of each slot.
+   * \return The weight in device memory, only valid to use after Wait.
+   */
+  NDArray Prefetch(Device device, NDArray host, int64_t slot, int64_t num_slots,
+                   int64_t slot_nbytes) {
+    CHECK(host->device.device_type == kDLCPU || host->device.device_type == kDLCUDAHost)
+        << "ValueError: The streamed weights must be in host memory, but got a weight on "
+        << host->device;
+    int64_t nbytes = static_cast<int64_t>(GetDataSize(*host.operator->()));
+    CHECK_LE(nbytes, slot_nbytes) << "ValueError: The weight of " << nbytes
+        << " bytes does not fit into the slots of " << slot_nbytes << " bytes";
+    EnsureRing(device, num_slots, slot_nbytes);
+    CHECK(slot >= 0 && slot < num_slots) << "ValueError: Slot " << slot << " is out of range";
+
+    CUDA_CALL(cudaSetDevice(device.device_id));
+    // Do not overwrite the slot while its previous occupant is still in use.
+    CUDA_CALL(cudaStreamWaitEvent(copy_stream_, released_[slot], 0));
+    NDArray view = slots_[slot].CreateView(host.Shape(), host->dtype);
+    NDArray::CopyFromTo(host.operator->(), const_cast<DLTensor*>(view.operator->()),
+                        copy_stream_);
+    CUDA_CALL(cudaEventRecord(ready_[slot], copy_stream_));
+    return view;
+  }
+
+  /*! \brief Make the compute stream wait for the copy into the slot. */
+  NDArray Wait(NDArray weight, int64_t slot) {
+    CUDA_CALL(cudaStreamWaitEvent(CUDAThreadEntry::ThreadLocal()->stream, ready_.at(slot), 0));
+    return weight;
+  }
+
+  /*! \brief Record that the computation reading the slot has been issued. */
+  void Release(int64_t slot) {
+    CUDA_CALL(cudaEventRecord(released_.at(slot), CUDAThreadEntry::ThreadLocal()->stream));
+  }
+
+  ~WeightStreamingExtensionNode() { DestroyRing(); }
+
+  static constexpr const char* _type_key = "relax_vm.WeightStreamingExtension";
+
+ private:
+  /*!
+   * \brief Allocate the ring if it does not match the requested one. The ring is only replaced
+   * when functions with different streaming plans run on the same VM.
+   */
+  void EnsureRing(Device device, int64_t num_slots, int64_t slot_nbytes) {
+    if (copy_stream_ != nullptr && device_.device_id == device.device_id &&
+        static_cast<int64_t>(slots_.size()) == num_slots && slot_nbytes_ == slot_nbytes) {
+      return;
+    }
+    DestroyRing();
+    device_ = device;
+    slot_nbytes_ = slot_nbytes;
+    CUDA_CALL(cudaSetDevice(device.device_id));
+    CUDA_CALL(cudaStreamCreateWithFlags(&copy_stream_, cudaStreamNonBlocking));
+    for (int64_t i = 0; i < num_slots; ++i) {
+      slots_.push_back(NDArray::Empty({slot_nbytes}, DataType::UInt(8), device));
+      cudaEvent_t ready, released;
+      CUDA_CALL(cudaEventCreateWithFlags(&ready, cudaEventDisableTiming));
+      CUDA_CALL(cudaEventCreateWithFlags(&released, cudaEventDisableTiming));
+      ready_.push_back(ready);
+      released_.push_back(released);
+    }
+  }
+
+  void DestroyRing() {
+    if (copy_stream_ == nullptr) return;
+    // The pending copies and kernels may still be using the slots.
+    cudaSetDevice(device_.device_id);
+    cudaDeviceSynchronize();
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      cudaEventDestroy(ready_[i]);
+      cudaEventDestroy(released_[i]);
+    }
+    cudaStreamDestroy(copy_stream_);
+    copy_stream_ = nullptr;
+    slots_.clear();
+    ready_.clear();
+    released_.clear();
+  }
+
+  Device device_;
+  int64_t slot_nbytes_ = 0;
+  cudaStream_t copy_stream_ = nullptr;
+  /*! \brief The device buffers of the ring. */
+  std::vector<NDArray> slots_;
+  /*! \brief The events recorded when the copies into the slots are done. */
+  std::vector<cudaEvent_t> ready_;
+  /*! \brief The events recorded when the computation is done with the slots. */
+  std::vector<cudaEvent_t> released_;
+};
+
+/*! Managed reference to WeightStreamingExtensionNode */
+class WeightStreamingExtension : public VMExtension {
+ public:
+  TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(WeightStreamingExtension, VMExtension,
+                                        WeightStreamingExtensionNode);
+  static WeightStreamingExtension Create() {
+    auto data_ = make_object<WeightStreamingExtensionNode>();
+    return WeightStreamingExtension(std::move(data_));
+  }
+};
+
+TVM_REGISTER_GLOBAL("vm.builtin.weight_streaming.prefetch")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.size(), 6);
+      VirtualMachine* vm = VirtualMachine::GetContextPtr(args[0]);
+      auto extension = vm->GetOrCreateExtension<WeightStreamingExtension>();
+      NDArray host = args[1];
+      int64_t slot = args[2];
+      int64_t num_slots = args[3];
+      int64_t slot_nbytes = args[4];
+      int64_t device_index = args[5];
+      ICHECK_LT(static_cast<size_t>(device_index), vm->devices.size());
+      *rv = extension->Prefetch(vm->devices[device_index], host, slot, num_slots, slot_nbytes);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.weight_streaming.wait")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.size(), 3);
+      VirtualMachine* vm = VirtualMachine::GetContextPtr(args[0]);
+      auto extension = vm->GetOrCreateExtension<WeightStreamingExtension>();
+      NDArray weight = args[1];
+      int64_t slot = args[2];
+      *rv = extension->Wait(weight, slot);
+    });
+
+TVM_REGISTER_GLOBAL("vm.builtin.weight_streaming.release")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      ICHECK_EQ(args.size(), 2);
+      VirtualMachine* vm = VirtualMachine::GetContextPtr(args[0]);
+      auto extension = vm->GetOrCreateExtension<WeightStreamingExtension>();
+      int64_t slot = args[1];
+      extension->Release(slot);
+    });
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -22,12 +22,17 @@
  */
 
 #include <dmlc/memory_io.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/relax_vm/executable.h>
 #include <tvm/runtime/relax_vm/vm.h>
 
+
+#include <cstring>
 #include <functional>
+#include <memory>
 #include <sstream>
+#include <utility>
 
 #include "../file_utils.h"
 
@@ -46,8 +51,20 @@ enum ConstantType : int {
   kString = 3,
   kInt = 4,
   kFloat = 5,
+  kNDArrayAligned = 6,
 };
 
+/*!
+ * \brief The alignment of the data of NDArray constants in the executable file,
+ * so that the constants can alias the pages when the file is memory mapped.
+ */
+constexpr uint64_t kConstantDataAlignment = 4096;
+/*!
+ * \brief The offset of the serialized executable in a file written by `SaveToFile`,
+ * i.e. the size of the length prefix of the serialized string.
+ */
+constexpr uint64_t kExecutableFileDataOffset = sizeof(uint64_t);
+
 #define STREAM_CHECK(val, section)                                          \
   ICHECK(val) << "Invalid VM file format in the " << section << " section." \
               << "\n";
@@ -170,7 +187,8 @@ void LoadHeader(dmlc::Stream* strm) {
   // Check version.
   std::string version;
   STREAM_CHECK(strm->Read(&version), "version");
-  STREAM_CHECK(version == RELAX_VM_VERSION, "version");
+  STREAM_CHECK(version == RELAX_VM_VERSION || version == RELAX_VM_MIN_LOADABLE_VERSION,
+               "version");
 }
 
 void Executable::SaveToBinary(dmlc::Stream* stream) {
@@ -204,7 +222,12 @@ void Executable::SaveToFile(const String& file_name, const String& format) {
 Module Executable::LoadFromBinary(void* stream) {
   std::string code;
   static_cast<dmlc::Stream*>(stream)->Read(&code);
-  dmlc::MemoryStringStream strm(&code);
+  return LoadFromMemory(code.data(), code.size(), nullptr);
+}
+
+Module Executable::LoadFromMemory(const char* data, size_t size,
+                                  std::shared_ptr<void> mapped_data_holder) {
+  dmlc::MemoryFixedSizeStream strm(const_cast<char*>(data), size);
 
   ObjectPtr<Executable> exec = make_object<Executable>();
 
@@ -215,7 +238,11 @@ Module Executable::LoadFromBinary(void* stream) {
   exec->LoadGlobalSection(&strm);
 
   // Constant section.
-  exec->LoadConstantSection(&strm);
+  if (mapped_data_holder != nullptr) {
+    exec->LoadConstantSection(&strm, data, std::move(mapped_data_holder));
+  } else {
+    exec->LoadConstantSection(&strm);
+  }
 
   // Code section.
   exec->LoadCodeSection(&strm);
@@ -227,6 +254,19 @@ TVM_REGISTER_GLOBAL("runtime.module.loadbinary_relax.Executable")
     .set_body_typed(Executable::LoadFromBinary);
 
 Module Executable::LoadFromFile(const String& file_name) {
+  char* mapped = nullptr;
+  size_t mapped_size = 0;
+  if (std::shared_ptr<void> holder = MapBinaryFile(file_name, &mapped, &mapped_size)) {
+    // The file holds the serialized string with its length prefix.
+    uint64_t code_size = 0;
+    if (mapped_size >= kExecutableFileDataOffset) {
+      std::memcpy(&code_size, mapped, sizeof(code_size));
+    }
+    if (DMLC_IO_NO_ENDIAN_SWAP && mapped_size >= kExecutableFileDataOffset &&
+        code_size <= mapped_size - kExecutableFileDataOffset) {
+      return LoadFromMemory(mapped + kExecutableFileDataOffset, code_size, std::move(holder));
+    }
+  }
   std::string data;
   runtime::LoadBinaryFromFile(file_name, &data);
   dmlc::MemoryStringStream reader(&data);
@@ -263,12 +303,32 @@ bool VMFuncInfo::Load(dmlc::Stream* strm) {
 
 void Executable::SaveGlobalSection(dmlc::Stream* strm) { strm->Write(func_table); }
 
-void Executable::SaveConstantSection(dmlc::Stream* strm) {
+void Executable::SaveConstantSection(dmlc::SeekStream* strm) {
   strm->Write(static_cast<uint64_t>(this->constants.size()));
   for (const auto& it : this->constants) {
     if (it.IsObjectRef<runtime::NDArray>()) {
-      strm->Write(ConstantType::kNDArray);
-      runtime::SaveDLTensor(strm, it.operator DLTensor*());
+      // Save the array data at an aligned offset of the file, so that loading from a
+      // mapped file can alias it. The layout of an aligned NDArray constant is
+      //   ndim, dtype, shape, data_byte_size, padding, <padding bytes>, data
+      runtime::NDArray array = it.operator runtime::NDArray();
+      if (!array.IsContiguous() || array->byte_offset != 0 ||
+          array->device.device_type != kDLCPU) {
+        array = array.CopyTo(Device{kDLCPU, 0});
+      }
+      strm->Write(ConstantType::kNDArrayAligned);
+      strm->Write(array->ndim);
+      strm->Write(array->dtype);
+      strm->WriteArray(array->shape, array->ndim);
+      uint64_t data_byte_size = runtime::GetDataSize(*array.operator->());
+      strm->Write(data_byte_size);
+      uint64_t data_pos = strm->Tell() + sizeof(uint64_t) + kExecutableFileDataOffset;
+      uint64_t padding = (kConstantDataAlignment - data_pos % kConstantDataAlignment) %
+                         kConstantDataAlignment;
+      strm->Write(padding);
+      std::vector<char> padding_bytes(padding, 0);
+      strm->Write(padding_bytes.data(), padding);
+      ICHECK(DMLC_IO_NO_ENDIAN_SWAP) << "Saving aligned constants requires little endian";
+      strm->Write(array->data, data_byte_size);
     } else if (it.IsObjectRef<ShapeTuple>()) {
       ShapeTuple shape = it.operator ShapeTuple();
       strm->Write(ConstantType::kShapeTuple);
@@ -314,7 +374,8 @@ void Executable::LoadGlobalSection(dmlc::Stream* strm) {
   }
 }
 
-void Executable::LoadConstantSection(dmlc::Stream* strm) {
+void Executable::LoadConstantSection(dmlc::SeekStream* strm, const char* mapped_data,
+                                     std::shared_ptr<void> mapped_data_holder) {
   uint64_t sz;
   // Load the number of constants.
   STREAM_CHECK(strm->Read(&sz, sizeof(sz)), "constant");
@@ -331,6 +392,32 @@ void Executable::LoadConstantSection(dmlc::Stream* strm) {
       TVMRetValue cell;
       cell = ndarray;
       this->constants.push_back(cell);
+    } else if (constant_type == ConstantType::kNDArrayAligned) {
+      int ndim;
+      uint64_t data_byte_size, padding;
+      STREAM_CHECK(strm->Read(&ndim), "constant");
+      STREAM_CHECK(strm->Read(&dtype), "constant");
+      std::vector<int64_t> shape(ndim);
+      if (ndim != 0) {
+        STREAM_CHECK(strm->ReadArray(shape.data(), ndim), "constant");
+      }
+      STREAM_CHECK(strm->Read(&data_byte_size), "constant");
+      STREAM_CHECK(strm->Read(&padding), "constant");
+      strm->Seek(strm->Tell() + padding);
+      const char* data_ptr = mapped_data != nullptr ? mapped_data + strm->Tell() : nullptr;
+      if (data_ptr != nullptr && reinterpret_cast<uintptr_t>(data_ptr) % kAllocAlignment == 0) {
+        ndarray = NDArrayFromMappedData(const_cast<char*>(data_ptr), std::move(shape), dtype,
+                                        mapped_data_holder);
+        strm->Seek(strm->Tell() + data_byte_size);
+      } else {
+        ndarray = NDArray::Empty(ShapeTuple(shape), dtype, Device{kDLCPU, 0});
+        STREAM_CHECK(runtime::GetDataSize(*ndarray.operator->()) == data_byte_size, "constant");
+        STREAM_CHECK(data_byte_size == 0 || strm->Read(ndarray->data, data_byte_size),
+                     "constant");
+      }
+      TVMRetValue cell;
+      cell = ndarray;
+      this->constants.push_back(cell);
     } else if (constant_type == ConstantType::kShapeTuple) {
       uint64_t size;
       strm->Read(&size);
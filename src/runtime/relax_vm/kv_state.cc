@@ -64,6 +64,25 @@ TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_enable_sliding_window_for_seq
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::EnableSlidingWindowForSeq);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_commit_accepted_token_tree_nodes")
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::CommitAcceptedTokenTreeNodes);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_commit_accepted_token_tree_nodes_deferred")
+    .set_body_method<AttentionKVCache>(
+        &AttentionKVCacheObj::CommitAcceptedTokenTreeNodesDeferred);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_add_sequence_with_prefix_cache")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::AddSequenceWithPrefixCache);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_insert_prefix_cache")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::InsertPrefixCache);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_offload_sequence")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::OffloadSequence);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_prefetch_sequence")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::PrefetchSequence);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_set_sequence_tenant")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::SetSequenceTenant);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_set_tenant_page_quota")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::SetTenantPageQuota);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_tenant_num_pages")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::GetTenantNumPages);
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_eviction_candidates")
+    .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::GetEvictionCandidates);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_empty")
     .set_body_method<AttentionKVCache>(&AttentionKVCacheObj::Empty);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_get_num_available_pages")
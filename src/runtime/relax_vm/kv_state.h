@@ -87,6 +87,9 @@ class KVStateObj : public Object {
    * forward. For instance, this method may send auxiliary KV cache
    * data structures to GPUs so that they can be operated
    * in the model forward function.
+   * A batch may mix decode sequences (append length 1) with prefill
+   * chunks. Placing the decode sequences first lets them run the decode
+   * kernel while the prefill chunks run the prefill kernel.
    * \param seq_ids The ids of the sequence to run in the incoming model forward.
    * \param append_lengths The sequence lengths to run forward for for each sequence.
    * \param token_tree_parent_ptr The parent idx array of the token trees. Its length
@@ -157,6 +160,100 @@ class AttentionKVCacheObj : public KVStateObj {
   virtual void CommitAcceptedTokenTreeNodes(const IntTuple& seq_ids,
                                             const IntTuple& leaf_indices) = 0;
 
+  /*!
+   * \brief Commit the accepted token tree nodes to KV cache, deferring the
+   * compaction of the KV data of each layer to the attention of the layer in
+   * the next forward. This saves the separate copy pass over the pages of all
+   * layers in speculative decoding, where a forward follows every commit.
+   * The pending copies are launched before any other operation reading or moving
+   * the KV data, and at the end of the next forward for the layers without attention.
+   * \param seq_ids The ids of the sequences to commit.
+   * \param leaf_indices The leaf token tree node index of each sequence.
+   */
+  virtual void CommitAcceptedTokenTreeNodesDeferred(const IntTuple& seq_ids,
+                                                    const IntTuple& leaf_indices) = 0;
+
+  /************** Prefix Cache **************/
+
+  /*!
+   * \brief Add a new sequence, reusing the K/V data of the longest prefix
+   * of the given token ids that is retained in the prefix cache.
+   * The sequence is added empty when no prefix matches.
+   * \param seq_id The id of the new sequence to be added.
+   * \param token_ids The token ids of the sequence, e.g., the prompt.
+   * \return The length of the reused prefix. Only the tokens after it need
+   * to be prefilled. The last token is never reused, so that its logits
+   * are still computed.
+   */
+  virtual int64_t AddSequenceWithPrefixCache(int64_t seq_id, const IntTuple& token_ids) = 0;
+
+  /*!
+   * \brief Retain the K/V data of the leading tokens of the given sequence in the
+   * prefix cache, so that later sequences starting with the same tokens can reuse it.
+   * The retained data stays alive after the sequence is removed, and is evicted
+   * in least-recently-used order when the KV cache runs out of pages.
+   * \param seq_id The sequence whose K/V data is to be retained.
+   * \param token_ids The token ids of the leading part of the sequence to retain.
+   */
+  virtual void InsertPrefixCache(int64_t seq_id, const IntTuple& token_ids) = 0;
+
+  /************** Host Offload **************/
+
+  /*!
+   * \brief Offload the K/V data of the given sequence to host memory and release its pages.
+   * The pages shared with other sequences stay in the cache. The data is brought
+   * back automatically when the sequence is used again, e.g., in BeginForward.
+   * This method should not be invoked between BeginForward and EndForward.
+   * \param seq_id The sequence whose K/V data is to be offloaded.
+   */
+  virtual void OffloadSequence(int64_t seq_id) = 0;
+
+  /*!
+   * \brief Bring back the offloaded K/V data of the given sequence to the cache.
+   * The copy is asynchronous, which makes it possible to overlap the copy with the
+   * forward of other sequences by invoking this method ahead of the BeginForward
+   * that uses the sequence. It is a no-op if the sequence is not offloaded.
+   * \param seq_id The sequence whose K/V data is to be brought back.
+   */
+  virtual void PrefetchSequence(int64_t seq_id) = 0;
+
+  /************** Tenant Quota **************/
+
+  /*!
+   * \brief Assign the given sequence to a tenant with a priority. The pages the
+   * sequence allocates from then on are charged to the tenant. Sequences belong
+   * to tenant 0 with priority 0 by default, and forked sequences inherit both.
+   * \param seq_id The sequence to assign.
+   * \param tenant_id The id of the tenant, which is non-negative.
+   * \param priority The priority of the sequence. Higher priority sequences are
+   * ranked later in the eviction candidates.
+   */
+  virtual void SetSequenceTenant(int64_t seq_id, int64_t tenant_id, int64_t priority) = 0;
+
+  /*!
+   * \brief Set the page quota of a tenant.
+   * A tenant cannot allocate pages beyond its hard limit: the BeginForward that
+   * would exceed it fails before any page is allocated. A tenant over its soft
+   * limit is only ranked first in the eviction candidates.
+   * \param tenant_id The id of the tenant.
+   * \param soft_limit The soft limit in pages, or -1 for no limit.
+   * \param hard_limit The hard limit in pages, or -1 for no limit.
+   */
+  virtual void SetTenantPageQuota(int64_t tenant_id, int64_t soft_limit, int64_t hard_limit) = 0;
+
+  /*! \brief Get the number of pages currently charged to the given tenant. */
+  virtual int64_t GetTenantNumPages(int64_t tenant_id) const = 0;
+
+  /*!
+   * \brief Rank the sequences to preempt under memory pressure, for the
+   * scheduler to remove or offload them. The sequences of tenants over their
+   * soft limit come first, then lower priority first, then least recently used
+   * first. Only the sequences that hold pages of their own are ranked.
+   * \param max_num The maximum number of candidates to return.
+   * \return The ids of the candidate sequences, in the order to preempt them.
+   */
+  virtual IntTuple GetEvictionCandidates(int64_t max_num) const = 0;
+
   /*! \brief Prepare for the disaggregation KV data receive for the specified sequence and length.*/
   virtual IntTuple DisaggPrepareRecv(int64_t seq_id, int length) = 0;
 
@@ -42,7 +42,9 @@
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/relax_vm/vm.h>
+#include <tvm/runtime/threading_backend.h>
 
+#include <algorithm>
 #include <cmath>
 
 namespace tvm {
@@ -76,6 +78,20 @@ class AttentionKVCacheLegacyObj : public Object {
    */
   int64_t window_attention_current_pos{0};
 
+  /*!
+   * \brief Whether the cache is a preallocated ring buffer, which is never reallocated.
+   *
+   * Its slots are laid out as in the windowed kv cache, with the sinks first, then the entries
+   * from window_attention_current_pos to the end, then the most recent ones from the sinks to
+   * window_attention_current_pos once the ring has wrapped around.
+   */
+  bool is_ring{false};
+
+  /*!
+   * \brief number of attention sinks at the beginning of a ring cache, which are never overridden.
+   */
+  int64_t num_ring_sinks{0};
+
   /*!
    * \brief View all current cached values as one array.
    * \param shape The cached values.
@@ -88,6 +104,30 @@ class AttentionKVCacheLegacyObj : public Object {
     return data.CreateView(shape, data->dtype);
   }
 
+  /*!
+   * \brief View the cached values as up to three contiguous arrays, in the order they were
+   * appended: the sinks, then the oldest entries, then the most recent ones of a wrapped ring.
+   */
+  Array<NDArray> ViewSegments() {
+    std::vector<int64_t> shape(data->shape, data->shape + data->ndim);
+    int64_t row_bytes = RowBytes();
+    auto view = [&](int64_t begin, int64_t end) {
+      shape[0] = end - begin;
+      return data.CreateView(shape, data->dtype, begin * row_bytes);
+    };
+    int64_t pos = window_attention_current_pos;
+    if (!is_ring || fill_count < data->shape[0] || pos == num_ring_sinks) {
+      return {view(0, fill_count)};
+    }
+    Array<NDArray> segments;
+    if (num_ring_sinks > 0) {
+      segments.push_back(view(0, num_ring_sinks));
+    }
+    segments.push_back(view(pos, fill_count));
+    segments.push_back(view(num_ring_sinks, pos));
+    return segments;
+  }
+
   /** Clear the cache */
   void Clear() {
     this->fill_count = 0;
@@ -97,6 +137,11 @@ class AttentionKVCacheLegacyObj : public Object {
   /** pop n entries */
   void PopN(size_t n) {
     ICHECK_LE(n, fill_count);
+    if (is_ring) {
+      CHECK(fill_count < data->shape[0] || window_attention_current_pos == num_ring_sinks)
+          << "Cannot pop the entries of a ring kv cache which wrapped around";
+      this->window_attention_current_pos = fill_count - n;
+    }
     this->fill_count -= n;
   }
 
@@ -111,6 +156,10 @@ class AttentionKVCacheLegacyObj : public Object {
     copy_dst.shape = value->shape;
     NDArray::CopyFromTo(value.operator->(), &copy_dst);
     this->fill_count = value->shape[0];
+    if (is_ring) {
+      this->window_attention_current_pos =
+          fill_count == data->shape[0] ? num_ring_sinks : fill_count;
+    }
   }
 
   /*!
@@ -122,6 +171,14 @@ class AttentionKVCacheLegacyObj : public Object {
   void WindowOverride(NDArray value, int64_t max_cache_size, int64_t num_attention_sinks = 0) {
     CHECK(data.DataType() == value.DataType()) << "dtype mismatch";
     CHECK_LE(value->shape[0], max_cache_size - num_attention_sinks) << "dim 0 of value too large";
+    if (is_ring) {
+      CHECK_EQ(max_cache_size, data->shape[0])
+          << "The max cache size must be the capacity of the ring kv cache";
+      CHECK_EQ(num_attention_sinks, num_ring_sinks)
+          << "The attention sinks must be the ones of the ring kv cache";
+      RingAppend(value);
+      return;
+    }
     // reallocate cache
     if (fill_count + value->shape[0] <= max_cache_size) {
       int64_t reserved_slots = data->shape[0];
@@ -196,6 +253,10 @@ class AttentionKVCacheLegacyObj : public Object {
    */
   void Append(NDArray value) {
     CHECK(data.DataType() == value.DataType()) << "dtype mismatch";
+    if (is_ring) {
+      RingAppend(value);
+      return;
+    }
     // reallocate cache
     int64_t reserved_slots = data->shape[0];
     while (fill_count + value->shape[0] > reserved_slots) {
@@ -225,6 +286,50 @@ class AttentionKVCacheLegacyObj : public Object {
     this->fill_count += value->shape[0];
   }
 
+  /*!
+   * \brief Append value to a ring cache, overriding its oldest entries after the sinks once full.
+   * \param value The value to be appended.
+   */
+  void RingAppend(NDArray value) {
+    int64_t capacity = data->shape[0];
+    CHECK_LE(value->shape[0], capacity - num_ring_sinks) << "dim 0 of value too large";
+    for (int i = 1; i < data->ndim; ++i) {
+      CHECK_EQ(value->shape[i], data->shape[i]) << "Dimension " << i << " mismatch";
+    }
+    ICHECK(data.IsContiguous());
+    ICHECK(value.IsContiguous());
+
+    std::vector<int64_t> shape(value->shape, value->shape + value->ndim);
+    int64_t row_bytes = RowBytes();
+    int64_t num_copied = 0;
+    while (num_copied < value->shape[0]) {
+      int64_t pos = window_attention_current_pos;
+      shape[0] = std::min(value->shape[0] - num_copied, capacity - pos);
+
+      DLTensor copy_dst = *(data.operator->());
+      copy_dst.byte_offset = pos * row_bytes;
+      copy_dst.shape = shape.data();
+      DLTensor copy_src = *(value.operator->());
+      copy_src.byte_offset += num_copied * row_bytes;
+      copy_src.shape = shape.data();
+      NDArray::CopyFromTo(&copy_src, &copy_dst);
+
+      num_copied += shape[0];
+      this->fill_count = std::max(fill_count, pos + shape[0]);
+      this->window_attention_current_pos =
+          pos + shape[0] == capacity ? num_ring_sinks : pos + shape[0];
+    }
+  }
+
+  /*! \brief The bytes of one entry of the cache. */
+  int64_t RowBytes() const {
+    int64_t row_bytes = (data->dtype.bits * data->dtype.lanes + 7) / 8;
+    for (int i = 1; i < data->ndim; ++i) {
+      row_bytes *= data->shape[i];
+    }
+    return row_bytes;
+  }
+
   static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
   static constexpr const char* _type_key = "relax.vm.AttentionKVCacheLegacy";
   TVM_DECLARE_FINAL_OBJECT_INFO(AttentionKVCacheLegacyObj, Object);
@@ -250,6 +355,36 @@ class AttentionKVCacheLegacy : public ObjectRef {
     return AttentionKVCacheLegacy(n);
   }
 
+  /*!
+   * \brief Create the attention kv cache as a ring buffer, allocated once at its full capacity.
+   * \param init_data The initial data.
+   * \param reserve_shape The shape of the cache, whose first dim is the max cache size.
+   * \param init_fill_count The initial fill count, or -1 for the size of init_data.
+   * \param num_attention_sinks The number of sinks, which are never overridden.
+   */
+  static AttentionKVCacheLegacy CreateRing(NDArray init_data, ShapeTuple reserve_shape,
+                                           int init_fill_count, int64_t num_attention_sinks) {
+    CHECK(num_attention_sinks >= 0 && num_attention_sinks < reserve_shape[0])
+        << "ValueError: the ring kv cache of " << reserve_shape[0] << " slots cannot have "
+        << num_attention_sinks << " attention sinks";
+    CHECK_LE(init_data->shape[0], reserve_shape[0])
+        << "ValueError: the initial data does not fit in the ring kv cache";
+    CHECK_LE(init_fill_count, reserve_shape[0])
+        << "ValueError: the initial fill count does not fit in the ring kv cache";
+    auto n = make_object<AttentionKVCacheLegacyObj>();
+    n->data = NDArray::Empty(reserve_shape, init_data->dtype, init_data->device);
+    n->is_ring = true;
+    n->num_ring_sinks = num_attention_sinks;
+    n->fill_count = init_data->shape[0];
+    n->Update(init_data);
+    if (init_fill_count >= 0) {
+      n->fill_count = init_fill_count;
+      n->window_attention_current_pos =
+          init_fill_count == reserve_shape[0] ? num_attention_sinks : init_fill_count;
+    }
+    return AttentionKVCacheLegacy(n);
+  }
+
   TVM_DEFINE_MUTABLE_OBJECT_REF_METHODS(AttentionKVCacheLegacy, ObjectRef,
                                         AttentionKVCacheLegacyObj);
 };
@@ -262,6 +397,9 @@ TVM_REGISTER_OBJECT_TYPE(AttentionKVCacheLegacyObj);
 TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_create")
     .set_body_typed(AttentionKVCacheLegacy::Create);
 
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_create_ring")
+    .set_body_typed(AttentionKVCacheLegacy::CreateRing);
+
 AttentionKVCacheLegacy AttentionKVCacheUpdate(AttentionKVCacheLegacy cache, NDArray value) {
   cache->Update(value);
   return cache;
@@ -319,6 +457,13 @@ TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_view")
       }
     });
 
+Array<NDArray> AttentionKVCacheViewSegments(AttentionKVCacheLegacy cache) {
+  return cache->ViewSegments();
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.attention_kv_cache_view_segments")
+    .set_body_typed(AttentionKVCacheViewSegments);
+
 void AttentionKVCacheArrayPopN(Array<AttentionKVCacheLegacy> caches, int64_t n) {
   for (AttentionKVCacheLegacy cache : caches) {
     cache->PopN(static_cast<size_t>(n));
@@ -533,6 +678,123 @@ NDArray MultinomialFromUniform(NDArray prob, NDArray uniform_sample) {
 
 TVM_REGISTER_GLOBAL("vm.builtin.multinomial_from_uniform").set_body_typed(MultinomialFromUniform);
 
+/*!
+ * \brief Sample one token for each row of the batched logits.
+ *
+ * Each row applies its own temperature, top-k and top-p. Only the candidates
+ * that can be within top-p are selected and sorted, instead of the whole
+ * vocabulary, and the rows are processed in parallel.
+ *
+ * \param logits The logits of shape (batch_size, vocab_size).
+ * \param temperature The temperature of each row, a row is sampled greedily when it is 0.
+ * \param top_p The top-p of each row, 1 to disable.
+ * \param top_k The top-k of each row, 0 or negative to disable.
+ * \param uniform_samples The uniform sample in [0, 1) of each row.
+ * \return The sampled token ids of shape (batch_size,) on CPU.
+ */
+NDArray BatchSampleFromLogits(NDArray logits, NDArray temperature, NDArray top_p, NDArray top_k,
+                              NDArray uniform_samples) {
+  auto to_cpu = [](NDArray arr, DataType dtype, const char* name) {
+    ICHECK(arr.IsContiguous());
+    CHECK(arr.DataType() == dtype) << "ValueError: " << name << " must be " << dtype;
+    return arr->device.device_type == kDLCPU ? arr : arr.CopyTo(DLDevice{kDLCPU, 0});
+  };
+  CHECK_EQ(logits->ndim, 2) << "ValueError: logits must be of shape (batch_size, vocab_size)";
+  logits = to_cpu(logits, DataType::Float(32), "logits");
+  temperature = to_cpu(temperature, DataType::Float(32), "temperature");
+  top_p = to_cpu(top_p, DataType::Float(32), "top_p");
+  top_k = to_cpu(top_k, DataType::Int(32), "top_k");
+  uniform_samples = to_cpu(uniform_samples, DataType::Float(32), "uniform_samples");
+  int64_t batch_size = logits->shape[0];
+  int64_t vocab_size = logits->shape[1];
+  for (const NDArray& arr : {temperature, top_p, top_k, uniform_samples}) {
+    CHECK_EQ(arr.Shape().Product(), batch_size)
+        << "ValueError: The sampling parameters must have one value per row";
+  }
+
+  const float* p_logits = static_cast<const float*>(logits->data);
+  const float* p_temperature = static_cast<const float*>(temperature->data);
+  const float* p_top_p = static_cast<const float*>(top_p->data);
+  const int32_t* p_top_k = static_cast<const int32_t*>(top_k->data);
+  const float* p_uniform = static_cast<const float*>(uniform_samples->data);
+  NDArray result = NDArray::Empty({batch_size}, DataType::Int(32), DLDevice{kDLCPU, 0});
+  int32_t* p_result = static_cast<int32_t*>(result->data);
+
+  auto fcmp = [](const std::pair<float, int>& lhs, const std::pair<float, int>& rhs) {
+    return lhs.first > rhs.first;
+  };
+  auto sample_row = [&](int64_t row) {
+    const float* row_logits = p_logits + row * vocab_size;
+    float max_value = row_logits[0];
+    int max_index = 0;
+    for (int64_t i = 1; i < vocab_size; ++i) {
+      if (row_logits[i] > max_value) {
+        max_value = row_logits[i];
+        max_index = static_cast<int>(i);
+      }
+    }
+    int64_t k = p_top_k[row] > 0 ? std::min<int64_t>(p_top_k[row], vocab_size) : vocab_size;
+    if (p_temperature[row] < 1e-6f || k == 1) {
+      p_result[row] = max_index;
+      return;
+    }
+
+    // Unnormalized probabilities, relative to the max of the row.
+    float logit_scale = 1.0f / p_temperature[row];
+    std::vector<float> prob(vocab_size);
+    double sum = 0.0;
+    for (int64_t i = 0; i < vocab_size; ++i) {
+      prob[i] = expf((row_logits[i] - max_value) * logit_scale);
+      sum += prob[i];
+    }
+    float row_top_p = std::min(p_top_p[row], 1.0f);
+    float top_p_mass = static_cast<float>(sum) * row_top_p;
+
+    std::vector<std::pair<float, int>> data;
+    auto select = [&](float cutoff) -> bool {
+      data.clear();
+      for (int64_t i = 0; i < vocab_size; ++i) {
+        if (prob[i] >= cutoff) data.emplace_back(prob[i], static_cast<int>(i));
+      }
+      if (static_cast<int64_t>(data.size()) > k) {
+        std::nth_element(data.begin(), data.begin() + k, data.end(), fcmp);
+        data.resize(k);
+      }
+      std::sort(data.begin(), data.end(), fcmp);
+      if (cutoff == 0.0f || static_cast<int64_t>(data.size()) == k) return true;
+      // The filtered candidates must cover the top-p mass, otherwise retry without filter.
+      float covered = 0.0f;
+      for (const auto& kv : data) covered += kv.first;
+      return covered >= top_p_mass;
+    };
+    // By pigeonhole principle at most 1024 / top_p elements pass the filter.
+    if (row_top_p >= 1.0f || !select(top_p_mass / 1024)) {
+      select(0.0f);
+    }
+
+    // Keep the smallest prefix that covers top-p, and sample from it.
+    float cum_sum = 0.0f;
+    size_t num_kept = 0;
+    while (num_kept < data.size() && (num_kept == 0 || cum_sum < top_p_mass)) {
+      cum_sum += data[num_kept++].first;
+    }
+    float target = p_uniform[row] * cum_sum;
+    float acc = 0.0f;
+    for (size_t i = 0; i < num_kept; ++i) {
+      acc += data[i].first;
+      if (target < acc) {
+        p_result[row] = data[i].second;
+        return;
+      }
+    }
+    p_result[row] = data[num_kept - 1].second;
+  };
+  parallel_for_with_threading_backend(sample_row, 0, batch_size);
+  return result;
+}
+
+TVM_REGISTER_GLOBAL("vm.builtin.batch_sample_from_logits").set_body_typed(BatchSampleFromLogits);
+
 // This is an inplace operation.
 void ApplyRepetitionPenalty(NDArray logits, NDArray token_ids, double penalty) {
   ICHECK(logits.IsContiguous());
@@ -0,0 +1,139 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/memory_timeline.cc
+ */
+#include "memory_timeline.h"
+
+#include <tvm/runtime/device_api.h>
+
+#include <sstream>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+namespace {
+
+/*! \brief An allocator forwarding to another one, and recording to a timeline. */
+class TimelineAllocator : public memory::Allocator {
+ public:
+  TimelineAllocator(memory::Allocator* inner, MemoryTimeline* timeline)
+      : Allocator(inner->type()), inner_(inner), timeline_(timeline) {}
+
+  memory::Buffer Alloc(Device dev, size_t nbytes, size_t alignment,
+                       DLDataType type_hint) final {
+    memory::Buffer buffer = inner_->Alloc(dev, nbytes, alignment, type_hint);
+    timeline_->RecordAlloc(buffer, nbytes, "");
+    return buffer;
+  }
+
+  memory::Buffer Alloc(Device dev, ShapeTuple shape, DLDataType type_hint,
+                       const std::string& mem_scope) final {
+    memory::Buffer buffer = inner_->Alloc(dev, shape, type_hint, mem_scope);
+    size_t nbytes = (type_hint.bits * type_hint.lanes + 7) / 8;
+    for (int64_t dim : shape) {
+      nbytes *= dim;
+    }
+    timeline_->RecordAlloc(buffer, nbytes, mem_scope);
+    return buffer;
+  }
+
+  void Free(const memory::Buffer& buffer) final {
+    timeline_->RecordFree(buffer);
+    inner_->Free(buffer);
+  }
+
+  void Clear() final { inner_->Clear(); }
+
+  size_t UsedMemory() const final { return inner_->UsedMemory(); }
+
+  memory::ThreadCacheCounters GetThreadCacheCounters() const final {
+    return inner_->GetThreadCacheCounters();
+  }
+
+ private:
+  memory::Allocator* inner_;
+  MemoryTimeline* timeline_;
+};
+
+}  // namespace
+
+void MemoryTimeline::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.clear();
+  live_.clear();
+  start_ = std::chrono::steady_clock::now();
+  recording_ = true;
+}
+
+std::string MemoryTimeline::Stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  recording_ = false;
+  live_.clear();
+  std::ostringstream os;
+  os << "[";
+  for (size_t i = 0; i < events_.size(); ++i) {
+    const Event& e = events_[i];
+    os << (i ? "," : "") << "{\"function\":\"" << e.func_name << "\",\"instr\":" << e.instr_index
+       << ",\"device\":\"" << e.device << "\",\"nbytes\":" << e.nbytes << ",\"scope\":\""
+       << e.mem_scope << "\",\"alloc_ns\":" << e.alloc_ns << ",\"free_ns\":" << e.free_ns << "}";
+  }
+  os << "]";
+  events_.clear();
+  return os.str();
+}
+
+memory::Allocator* MemoryTimeline::Wrap(memory::Allocator* allocator) {
+  std::unique_ptr<memory::Allocator>& wrapper = wrappers_[allocator];
+  if (wrapper == nullptr) {
+    wrapper = std::make_unique<TimelineAllocator>(allocator, this);
+  }
+  return wrapper.get();
+}
+
+void MemoryTimeline::RecordAlloc(const memory::Buffer& buffer, size_t nbytes,
+                                 const std::string& mem_scope) {
+  auto [func_name, instr_index] = call_site_();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!recording_) return;
+  live_[buffer.data] = events_.size();
+  events_.push_back(Event{std::move(func_name), instr_index, buffer.device, nbytes,
+                          mem_scope.empty() ? "global" : mem_scope, NowNanos()});
+}
+
+void MemoryTimeline::RecordFree(const memory::Buffer& buffer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!recording_) return;
+  auto it = live_.find(buffer.data);
+  if (it == live_.end()) return;
+  events_[it->second].free_ns = NowNanos();
+  live_.erase(it);
+}
+
+int64_t MemoryTimeline::NowNanos() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                              start_)
+      .count();
+}
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/memory_timeline.h
+ * \brief The timeline of the allocations made by a Relax virtual machine.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_MEMORY_TIMELINE_H_
+#define TVM_RUNTIME_RELAX_VM_MEMORY_TIMELINE_H_
+
+#include <tvm/runtime/memory/memory_manager.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+
+/*!
+ * \brief Records the allocations made through the allocators of a VM, with their call site, and
+ * when they are freed.
+ *
+ * The allocators of the VM are replaced by wrappers while the timeline is recording.  A storage
+ * keeps the allocator it was allocated from, so the wrappers live as long as the timeline, and
+ * the storages freed after the recording stopped are simply not recorded.
+ */
+class MemoryTimeline {
+ public:
+  /*! \brief An allocation. */
+  struct Event {
+    /*! \brief The VM function and the index of the instruction in it, or -1 outside of a call. */
+    std::string func_name;
+    int64_t instr_index;
+    Device device;
+    /*! \brief The requested bytes. */
+    size_t nbytes;
+    std::string mem_scope;
+    /*! \brief The nanoseconds since the recording started, free_ns is -1 while still live. */
+    int64_t alloc_ns;
+    int64_t free_ns{-1};
+  };
+
+  /*! \brief Get the function and the instruction index of the current instruction. */
+  using CallSiteFunc = std::function<std::pair<std::string, int64_t>()>;
+
+  explicit MemoryTimeline(CallSiteFunc call_site) : call_site_(std::move(call_site)) {}
+
+  /*! \brief Forget the events and start recording. */
+  void Start();
+
+  /*! \brief Stop recording, and return the events as json. */
+  std::string Stop();
+
+  /*! \brief Get the wrapper of an allocator, which records to the timeline. */
+  memory::Allocator* Wrap(memory::Allocator* allocator);
+
+  /*! \brief Record an allocation of nbytes, which the allocator may have rounded up. */
+  void RecordAlloc(const memory::Buffer& buffer, size_t nbytes, const std::string& mem_scope);
+  void RecordFree(const memory::Buffer& buffer);
+
+ private:
+  int64_t NowNanos() const;
+
+  CallSiteFunc call_site_;
+  std::mutex mutex_;
+  bool recording_{false};
+  std::chrono::steady_clock::time_point start_;
+  std::vector<Event> events_;
+  /*! \brief The live events, by the address of their buffer. */
+  std::unordered_map<const void*, size_t> live_;
+  std::unordered_map<memory::Allocator*, std::unique_ptr<memory::Allocator>> wrappers_;
+};
+
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_MEMORY_TIMELINE_H_
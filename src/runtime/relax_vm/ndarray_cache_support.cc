@@ -28,7 +28,9 @@
  * friendly in some of the environments.
  *
  * NDArray cache also provides a way to do system-wide
- * parameter sharing across multiple VMs.
+ * parameter sharing across multiple VMs. Parameters recorded
+ * with the same content hash are loaded once per device and
+ * shared by all the names, and thus all the models, that use them.
  *
  * There are likely other ways to load the parameters ndarray-ache.
  * We will keep the impact minimum by puting it as a private
@@ -39,11 +41,17 @@
 #define __STDC_FORMAT_MACROS
 #endif
 #include <picojson.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/runtime/relax_vm/ndarray_cache_support.h>
 
+#include <chrono>
+#include <future>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../../support/utils.h"
@@ -80,6 +88,9 @@ NDArrayCacheMetadata::FileRecord::ParamRecord JSONAsParamRecord(const picojson::
   result.format = GetValue<std::string>(json, "format");
   result.nbytes = GetValue<int64_t>(json, "nbytes");
   result.byte_offset = GetValue<int64_t>(json, "byteOffset");
+  if (json.count("hash")) {
+    result.hash = GetValue<std::string>(json, "hash");
+  }
   result.shape = ShapeTuple(std::move(shape));
   return result;
 }
@@ -165,38 +176,66 @@ void CopyNDArrayFromBytes(NDArray param, const void* data, size_t nbytes,
   TVMSynchronize(device.device_type, device.device_id, nullptr);
 }
 
-NDArray NDArrayCacheMetadata::FileRecord::ParamRecord::Load(
-    Device device, const std::string* raw_data, Optional<NDArray>* staging_buffer) const {
-  NDArray arr = NDArray::Empty(shape, dtype, device);
-  if (dtype == DataType::Float(32) && format == "f32-to-bf16") {
+/*!
+ * \brief Load a parameter from the raw bytes of its shard.
+ * \param rec The record of the parameter.
+ * \param device The device to load the parameter onto.
+ * \param raw_data The start of the raw bytes of the shard.
+ * \param staging_buffer The buffer to be used to avoid extra OpenCL copies.
+ */
+NDArray LoadParamFromBytes(const NDArrayCacheMetadata::FileRecord::ParamRecord& rec,
+                           Device device, const char* raw_data,
+                           Optional<NDArray>* staging_buffer) {
+  NDArray arr = NDArray::Empty(rec.shape, rec.dtype, device);
+  if (rec.dtype == DataType::Float(32) && rec.format == "f32-to-bf16") {
     // decode bf16 to f32
-    std::vector<uint16_t> buffer(nbytes / 2);
-    std::vector<uint32_t> decoded(nbytes / 2);
-    std::memcpy(buffer.data(), raw_data->data() + byte_offset, nbytes);
+    std::vector<uint16_t> buffer(rec.nbytes / 2);
+    std::vector<uint32_t> decoded(rec.nbytes / 2);
+    std::memcpy(buffer.data(), raw_data + rec.byte_offset, rec.nbytes);
     for (size_t i = 0; i < buffer.size(); ++i) {
       decoded[i] = static_cast<uint32_t>(buffer[i]) << 16;
     }
     CopyNDArrayFromBytes(arr, decoded.data(), decoded.size() * sizeof(uint32_t), staging_buffer);
   } else {
-    CopyNDArrayFromBytes(arr, raw_data->data() + byte_offset, nbytes, staging_buffer);
+    CopyNDArrayFromBytes(arr, raw_data + rec.byte_offset, rec.nbytes, staging_buffer);
   }
   return arr;
 }
 
+NDArray NDArrayCacheMetadata::FileRecord::ParamRecord::Load(
+    Device device, const std::string* raw_data, Optional<NDArray>* staging_buffer) const {
+  return LoadParamFromBytes(*this, device, raw_data->data(), staging_buffer);
+}
+
+NDArray NDArrayCacheMetadata::FileRecord::ParamRecord::LoadFromBytes(
+    Device device, const char* raw_data, Optional<NDArray>* staging_buffer) const {
+  return LoadParamFromBytes(*this, device, raw_data, staging_buffer);
+}
+
 TVM_DLL Array<NDArray> NDArrayCacheMetadata::FileRecord::Load(
     Device device,
     const std::string& path_prefix,  //
     std::string* raw_data_buffer,    //
     Optional<NDArray>* staging_buffer) const {
+  this->LoadRawData(path_prefix, raw_data_buffer);
+  return this->LoadFromRawData(device, raw_data_buffer, staging_buffer);
+}
+
+void NDArrayCacheMetadata::FileRecord::LoadRawData(const std::string& path_prefix,
+                                                   std::string* raw_data_buffer) const {
   LoadBinaryFromFile(path_prefix + "/" + this->data_path, raw_data_buffer);
   CHECK_EQ(this->format, "raw-shard") << "ValueError: Only `raw-shard` format is supported";
   CHECK_EQ(this->nbytes, raw_data_buffer->length())
       << "ValueError: Encountered an corrupted parameter shard. It means it is not downloaded "
          "completely or downloading is interrupted. Please try to download again.";
+}
+
+Array<NDArray> NDArrayCacheMetadata::FileRecord::LoadFromRawData(
+    Device device, const std::string* raw_data, Optional<NDArray>* staging_buffer) const {
   Array<NDArray> result;
   result.reserve(this->records.size());
   for (const ParamRecord& nd_rec : this->records) {
-    result.push_back(nd_rec.Load(device, raw_data_buffer, staging_buffer));
+    result.push_back(nd_rec.Load(device, raw_data, staging_buffer));
   }
   return result;
 }
@@ -232,38 +271,216 @@ class NDArrayCache {
   static void Remove(String name) {
     NDArrayCache* pool = Global();
     pool->pool_.erase(name);
+    pool->ReleaseUnusedShared();
+  }
+
+  static void Clear() {
+    NDArrayCache* pool = Global();
+    pool->pool_.clear();
+    pool->shared_.clear();
+    pool->num_shared_ = 0;
   }
 
-  static void Clear() { Global()->pool_.clear(); }
+  /*! \return The number of parameters loaded so far that reused an existing tensor. */
+  static int64_t NumShared() { return Global()->num_shared_; }
 
   /*!
    * \brief Load parameters from path and append them.
    * \param cache_path The cache to path.
    * \param device_type The type of device to be loaded.
    * \param device_id The device id.
+   * \note The shard files are read in a pipelined way: while the parameters
+   * of one shard are copied to the device, the next shard is read into a
+   * second host buffer on a background thread.
    */
   static void Load(const std::string& cache_path, int device_type, int device_id) {
     DLDevice device{static_cast<DLDeviceType>(device_type), device_id};
     NDArrayCacheMetadata metadata = NDArrayCacheMetadata::Load(cache_path);
+    NDArrayCache* pool = Global();
+    pool->ReleaseUnusedShared();
+    // Shards whose parameters are all already shared do not need to be read.
+    size_t num_shards = metadata.records.size();
+    std::vector<bool> needs_read(num_shards, false);
+    for (size_t i = 0; i < num_shards; ++i) {
+      for (const NDArrayCacheMetadata::FileRecord::ParamRecord& rec : metadata.records[i].records) {
+        if (!pool->FindShared(rec, device).defined()) {
+          needs_read[i] = true;
+          break;
+        }
+      }
+    }
     Optional<NDArray> staging_buffer;
-    std::string raw_data;
-    Array<NDArray> params;
-    for (const NDArrayCacheMetadata::FileRecord& shard_rec : metadata.records) {
+    std::string raw_data[2];
+    auto f_read = [&metadata, &cache_path, &raw_data, &needs_read](size_t i) {
+      return std::async(std::launch::async, [&metadata, &cache_path, &raw_data, &needs_read, i]() {
+        if (needs_read[i]) metadata.records[i].LoadRawData(cache_path, &raw_data[i % 2]);
+      });
+    };
+    auto start = std::chrono::steady_clock::now();
+    int64_t total_bytes = 0;
+    int64_t num_shared = pool->num_shared_;
+    std::future<void> next_read = num_shards > 0 ? f_read(0) : std::future<void>();
+    for (size_t i = 0; i < num_shards; ++i) {
+      const NDArrayCacheMetadata::FileRecord& shard_rec = metadata.records[i];
       try {
-        params = shard_rec.Load(device, cache_path, &raw_data, &staging_buffer);
+        next_read.get();
+        // The buffer of the next shard is no longer referenced by the previous shard.
+        if (i + 1 < num_shards) next_read = f_read(i + 1);
+        for (const NDArrayCacheMetadata::FileRecord::ParamRecord& rec : shard_rec.records) {
+          NDArray arr = pool->FindShared(rec, device);
+          if (arr.defined()) {
+            ++pool->num_shared_;
+          } else {
+            arr = rec.Load(device, &raw_data[i % 2], &staging_buffer);
+            pool->AddShared(rec, device, arr);
+          }
+          Update(rec.name, arr, true);
+        }
       } catch (const dmlc::Error& e) {
         LOG(FATAL) << "ValueError: Error when loading parameters from " << shard_rec.data_path
                    << ": " << e.what();
       }
-      int num_params = params.size();
-      for (int i = 0; i < num_params; ++i) {
-        Update(shard_rec.records[i].name, params[i], true);
+      if (needs_read[i]) total_bytes += shard_rec.nbytes;
+    }
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    VLOG(1) << "Loaded " << num_shards << " shards (" << total_bytes << " bytes read, "
+            << pool->num_shared_ - num_shared << " parameters shared) from " << cache_path
+            << " in " << seconds << " s, "
+            << (seconds > 0 ? total_bytes / seconds / (1 << 20) : 0.0) << " MB/s";
+  }
+
+  /*!
+   * \brief Load parameters from path by mapping the shard files into memory.
+   *
+   * The parameters are CPU NDArrays that view into the mapped shard files,
+   * so no copy is made at load time, pages are only read on first use, and
+   * processes that load the same cache share the weights through the page
+   * cache. Parameters that need decoding or do not start at an aligned
+   * offset of the file are copied instead.
+   *
+   * \param cache_path The cache to path.
+   */
+  static void LoadMapped(const std::string& cache_path) {
+    NDArrayCacheMetadata metadata = NDArrayCacheMetadata::Load(cache_path);
+    Device device{kDLCPU, 0};
+    NDArrayCache* pool = Global();
+    pool->ReleaseUnusedShared();
+    int64_t num_mapped = 0;
+    for (const NDArrayCacheMetadata::FileRecord& shard_rec : metadata.records) {
+      bool all_shared = true;
+      for (const NDArrayCacheMetadata::FileRecord::ParamRecord& rec : shard_rec.records) {
+        if (!pool->FindShared(rec, device).defined()) {
+          all_shared = false;
+          break;
+        }
+      }
+      if (all_shared) {
+        for (const NDArrayCacheMetadata::FileRecord::ParamRecord& rec : shard_rec.records) {
+          Update(rec.name, pool->FindShared(rec, device), true);
+          ++pool->num_shared_;
+        }
+        continue;
+      }
+      std::string file_name = cache_path + "/" + shard_rec.data_path;
+      char* data = nullptr;
+      size_t size = 0;
+      std::shared_ptr<void> holder = MapBinaryFile(file_name, &data, &size);
+      if (holder == nullptr) {
+        LOG(WARNING) << "Cannot map " << file_name << " into memory, copying its parameters";
+        Array<NDArray> params;
+        std::string raw_data;
+        try {
+          params = shard_rec.Load(device, cache_path, &raw_data);
+        } catch (const dmlc::Error& e) {
+          LOG(FATAL) << "ValueError: Error when loading parameters from " << shard_rec.data_path
+                     << ": " << e.what();
+        }
+        for (size_t i = 0; i < params.size(); ++i) {
+          pool->AddShared(shard_rec.records[i], device, params[i]);
+          Update(shard_rec.records[i].name, params[i], true);
+        }
+        continue;
+      }
+      CHECK_EQ(shard_rec.format, "raw-shard") << "ValueError: Only `raw-shard` format is supported";
+      CHECK_EQ(shard_rec.nbytes, size)
+          << "ValueError: Encountered an corrupted parameter shard " << shard_rec.data_path
+          << ". It means it is not downloaded completely or downloading is interrupted. Please "
+             "try to download again.";
+      for (const NDArrayCacheMetadata::FileRecord::ParamRecord& rec : shard_rec.records) {
+        CHECK_LE(rec.byte_offset + rec.nbytes, size)
+            << "ValueError: Parameter " << rec.name << " is out of the bounds of its shard";
+        if (NDArray shared = pool->FindShared(rec, device); shared.defined()) {
+          Update(rec.name, shared, true);
+          ++pool->num_shared_;
+          continue;
+        }
+        char* param_data = data + rec.byte_offset;
+        bool needs_decode = rec.dtype == DataType::Float(32) && rec.format == "f32-to-bf16";
+        NDArray arr;
+        if (!needs_decode && reinterpret_cast<uintptr_t>(param_data) % kAllocAlignment == 0) {
+          arr = NDArrayFromMappedData(param_data, {rec.shape.begin(), rec.shape.end()},
+                                      rec.dtype, holder);
+          ++num_mapped;
+        } else {
+          arr = LoadParamFromBytes(rec, device, data, nullptr);
+        }
+        pool->AddShared(rec, device, arr);
+        Update(rec.name, arr, true);
       }
     }
+    VLOG(1) << "Mapped " << num_mapped << " parameters from " << cache_path;
   }
 
  private:
+  /*! \return The key of the shared tensor of a parameter on a device, or empty if unhashed. */
+  static std::string SharedKey(const NDArrayCacheMetadata::FileRecord::ParamRecord& rec,
+                               Device device) {
+    if (rec.hash.empty()) return "";
+    std::ostringstream os;
+    os << rec.hash << ':' << rec.format << ':' << rec.dtype << ':' << rec.nbytes << ':'
+       << device.device_type << ':' << device.device_id;
+    for (int64_t dim : rec.shape) {
+      os << ':' << dim;
+    }
+    return os.str();
+  }
+
+  /*! \return The tensor with the content of a parameter on a device, if loaded already. */
+  NDArray FindShared(const NDArrayCacheMetadata::FileRecord::ParamRecord& rec,
+                     Device device) const {
+    std::string key = SharedKey(rec, device);
+    if (key.empty()) return NDArray();
+    auto it = shared_.find(key);
+    return it == shared_.end() ? NDArray() : it->second;
+  }
+
+  void AddShared(const NDArrayCacheMetadata::FileRecord::ParamRecord& rec, Device device,
+                 NDArray arr) {
+    std::string key = SharedKey(rec, device);
+    if (!key.empty()) shared_.emplace(std::move(key), arr);
+  }
+
+  /*! \brief Free the shared tensors that are no longer used by any name or model. */
+  void ReleaseUnusedShared() {
+    for (auto it = shared_.begin(); it != shared_.end();) {
+      if (it->second.use_count() == 1) {
+        it = shared_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
   Map<String, NDArray> pool_;
+  /*!
+   * \brief The loaded tensors by content, device, dtype and shape. The tensors are shared by the
+   *  names that load the same content, so writing into a parameter in place is visible through
+   *  all of them.
+   */
+  std::unordered_map<std::string, NDArray> shared_;
+  /*! \brief The number of parameters that reused a shared tensor since the last clear. */
+  int64_t num_shared_ = 0;
 };
 
 TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.get").set_body_typed(NDArrayCache::Get);
@@ -292,6 +509,9 @@ TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.update").set_body([](TVMArgs args,
 TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.remove").set_body_typed(NDArrayCache::Remove);
 TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.clear").set_body_typed(NDArrayCache::Clear);
 TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.load").set_body_typed(NDArrayCache::Load);
+TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.load_mapped")
+    .set_body_typed(NDArrayCache::LoadMapped);
+TVM_REGISTER_GLOBAL("vm.builtin.ndarray_cache.num_shared").set_body_typed(NDArrayCache::NumShared);
 
 // This param module node can be useful to get param dict in RPC mode
 // when the remote already have loaded parameters from file.
@@ -25,11 +25,16 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/nvtx.h>
 #include <tvm/runtime/registry.h>
 
 #include <algorithm>
+#include <limits>
+#include <list>
 #include <numeric>
+#include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -63,6 +68,19 @@ constexpr const int kIntAttnWorkspaceByte = 1 * 1024 * 1024;
 constexpr const int kFloatAttnWorkspaceByte = 768 * 1024 * 1024;
 /*! \brief The id of the temporary logical page, which is useful for sliding window. */
 constexpr const int kPagedKVCacheTempPageId = -1;
+/*!
+ * \brief The first id of the internal sequences that retain KV data for the prefix cache.
+ * The ids grow from the minimum int64 value so that they never collide with user sequences.
+ */
+constexpr const int64_t kPrefixCacheSeqIdBegin = std::numeric_limits<int64_t>::min();
+/*! \brief The index of the root node of the prefix tree. */
+constexpr const int32_t kPrefixTreeRootIdx = 0;
+/*! \brief The number of host pages allocated at a time for offloaded KV data. */
+constexpr const int64_t kHostPageChunkSize = 16;
+/*! \brief The number of elements compared at a time when uploading auxiliary data in delta. */
+constexpr const int64_t kAuxDataDeltaChunkSize = 64;
+/*! \brief The maximum number of copies a delta upload of auxiliary data can be split into. */
+constexpr const int kAuxDataMaxDeltaCopies = 16;
 
 /*!
  * \brief The block structure in paged KV cache with common prefix support.
@@ -83,6 +101,12 @@ struct Block {
    * words, different blocks do not share pages).
    */
   std::vector<int32_t> page_ids;
+  /*!
+   * \brief The ids of the host pages holding the KV data of the block when
+   * the block is offloaded to host memory, or empty otherwise.
+   * An offloaded block has released its device pages, so `page_ids` is empty.
+   */
+  std::vector<int32_t> host_page_ids;
   /*! \brief The total sequence length in the block. */
   int32_t seq_length = 0;
   /*!
@@ -120,6 +144,7 @@ struct Block {
   /*! \brief Reset the block data. */
   void Reset() {
     page_ids.clear();
+    host_page_ids.clear();
     seq_length = 0;
     start_pos = 0;
     sink_length = 0;
@@ -177,6 +202,12 @@ struct Sequence {
    * this sequence are committed
    */
   bool accepted_indices_committed = true;
+  /*! \brief The tenant charged for the pages the sequence allocates. */
+  int64_t tenant_id = 0;
+  /*! \brief The priority of the sequence in the eviction candidates. */
+  int64_t priority = 0;
+  /*! \brief The forward step in which the sequence was last used. */
+  int64_t last_use_step = 0;
 
   explicit Sequence(std::vector<Block>* global_block_pool, int32_t last_block_idx) {
     ++global_block_pool->at(last_block_idx).external_ref_cnt;
@@ -207,6 +238,36 @@ struct Sequence {
   }
 };
 
+/*!
+ * \brief The node structure of the prefix tree, which indexes the KV data
+ * retained in the prefix cache by token ids.
+ * Each node stands for one page of tokens that follow the tokens of its
+ * parent node. Only leaf nodes can hold fewer than `page_size` tokens.
+ *
+ * The KV data itself is not owned by the tree. Each cached prefix is kept
+ * alive by an internal sequence, which shares blocks with the sequences
+ * it was inserted from, and the node records the internal sequences
+ * whose tokens go through it.
+ */
+struct PrefixTreeNode {
+  /*! \brief The token ids of the page this node stands for. */
+  std::vector<int32_t> token_ids;
+  /*! \brief The index of the parent node, or -1 for the root. */
+  int32_t parent_idx = -1;
+  /*! \brief The indices of the child nodes. */
+  std::vector<int32_t> child_indices;
+  /*! \brief The ids of the internal sequences whose tokens go through this node. */
+  std::unordered_set<int64_t> seq_ids;
+
+  /*! \brief Reset the node data. */
+  void Reset() {
+    token_ids.clear();
+    parent_idx = -1;
+    child_indices.clear();
+    seq_ids.clear();
+  }
+};
+
 /*!
  * \brief The rotary embedding mode adopted by the paged KV cache
  * when computing attention.
@@ -653,6 +714,9 @@ class PlainPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
  * For each `CopyXXXAsync`, it copies the input data to a local cache on host.
  * In `CommitAttnAuxDataCopy`, it copies all the data in the local cache to the device
  * array for a single time, and thus reduce the number of host-to-device copies needed.
+ * Since consecutive decode steps mostly produce the same auxiliary data, the attention
+ * auxiliary data is uploaded in delta: only the chunks that differ from the last upload
+ * are copied, and it falls back to a full copy when too many chunks have changed.
  */
 class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
  public:
@@ -672,6 +736,8 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
         HostMemoryVector(attn_aux_data_cache_size, dtype_aux, preferred_host_device);
     // - Initialize the device auxiliary data buffer.
     merged_attn_aux_data_device_ = NDArray::Empty({attn_aux_data_cache_size}, dtype_aux, device);
+    // - Initialize the host mirror of the device auxiliary data buffer.
+    uploaded_attn_aux_data_.resize(attn_aux_data_cache_size);
 
     // - Calculate cache size of all the compact KV auxiliary arrays in
     // local cache and the large on-device array.
@@ -749,20 +815,37 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
   }
 
   void CommitAttnAuxDataCopy() final {
-    std::vector<int64_t> copy_shape{attn_aux_data_copy_offset_};
-    DLTensor copy_dst;
-    copy_dst.data = merged_attn_aux_data_device_->data;
-    copy_dst.device = device_;
-    copy_dst.ndim = 1;
-    copy_dst.dtype = dtype_aux_;
-    copy_dst.shape = copy_shape.data();
-    copy_dst.strides = nullptr;
-    copy_dst.byte_offset = 0;
-
-    DLTensor copy_src = copy_dst;
-    copy_src.data = merged_attn_aux_data_host_.data();
-    copy_src.device = Device{kDLCPU, 0};
-    NDArray::CopyFromTo(&copy_src, &copy_dst, copy_stream_);
+    const int32_t* host_data = merged_attn_aux_data_host_.data();
+    int32_t* uploaded_data = uploaded_attn_aux_data_.data();
+    // - Collect the changed ranges since the last upload, chunk by chunk.
+    // Everything beyond the uploaded prefix never reached the device and is always dirty.
+    std::vector<std::pair<int64_t, int64_t>> dirty_ranges;
+    int64_t num_dirty_elem = 0;
+    int64_t compare_end = std::min(attn_aux_data_copy_offset_, num_uploaded_attn_aux_data_);
+    for (int64_t begin = 0; begin < attn_aux_data_copy_offset_; begin += kAuxDataDeltaChunkSize) {
+      int64_t end = std::min(begin + kAuxDataDeltaChunkSize, attn_aux_data_copy_offset_);
+      if (end <= compare_end &&
+          std::memcmp(host_data + begin, uploaded_data + begin, (end - begin) * elem_byte_size_) ==
+              0) {
+        continue;
+      }
+      if (!dirty_ranges.empty() && dirty_ranges.back().second == begin) {
+        dirty_ranges.back().second = end;
+      } else {
+        dirty_ranges.emplace_back(begin, end);
+      }
+      num_dirty_elem += end - begin;
+    }
+    // - Fall back to a single full copy when the delta is large or fragmented.
+    if (static_cast<int>(dirty_ranges.size()) > kAuxDataMaxDeltaCopies ||
+        num_dirty_elem * 2 > attn_aux_data_copy_offset_) {
+      dirty_ranges = {{0, attn_aux_data_copy_offset_}};
+    }
+    for (const auto& [begin, end] : dirty_ranges) {
+      CopyMergedAuxDataRange(merged_attn_aux_data_host_, merged_attn_aux_data_device_, begin, end);
+      std::memcpy(uploaded_data + begin, host_data + begin, (end - begin) * elem_byte_size_);
+    }
+    num_uploaded_attn_aux_data_ = std::max(num_uploaded_attn_aux_data_, attn_aux_data_copy_offset_);
   }
 
   void ResetCompactKVAuxDataCopy() final { compact_kv_aux_data_copy_offset_ = 0; }
@@ -784,23 +867,33 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
   }
 
   void CommitCompactKVAuxDataCopy() final {
-    std::vector<int64_t> copy_shape{compact_kv_aux_data_copy_offset_};
+    CopyMergedAuxDataRange(merged_compact_kv_aux_data_host_, merged_compact_kv_aux_data_device_, 0,
+                           compact_kv_aux_data_copy_offset_);
+  }
+
+ private:
+  /*! \brief Copy the elements in range [begin, end) of the host cache to the device array. */
+  void CopyMergedAuxDataRange(const HostMemoryVector& host, const NDArray& device, int64_t begin,
+                              int64_t end) {
+    if (begin >= end) {
+      return;
+    }
+    std::vector<int64_t> copy_shape{end - begin};
     DLTensor copy_dst;
-    copy_dst.data = merged_compact_kv_aux_data_device_->data;
+    copy_dst.data = device->data;
     copy_dst.device = device_;
     copy_dst.ndim = 1;
     copy_dst.dtype = dtype_aux_;
     copy_dst.shape = copy_shape.data();
     copy_dst.strides = nullptr;
-    copy_dst.byte_offset = 0;
+    copy_dst.byte_offset = begin * elem_byte_size_;
 
     DLTensor copy_src = copy_dst;
-    copy_src.data = merged_compact_kv_aux_data_host_.data();
+    copy_src.data = host.data();
     copy_src.device = Device{kDLCPU, 0};
     NDArray::CopyFromTo(&copy_src, &copy_dst, copy_stream_);
   }
 
- private:
   /*!
    * \brief Calculate the start element offsets of the auxiliary arrays in the local cache.
    * \return Return the local cache size (total number of elements in the local cache).
@@ -903,6 +996,10 @@ class CachedPagedKVCacheAuxDataManager : public PagedKVCacheAuxDataManager {
   HostMemoryVector merged_compact_kv_aux_data_host_;
   NDArray merged_attn_aux_data_device_;
   NDArray merged_compact_kv_aux_data_device_;
+  /*! \brief The host mirror of the content of `merged_attn_aux_data_device_`. */
+  std::vector<int32_t> uploaded_attn_aux_data_;
+  /*! \brief The length of the prefix of `merged_attn_aux_data_device_` ever uploaded. */
+  int64_t num_uploaded_attn_aux_data_ = 0;
 };
 
 /*!
@@ -978,6 +1075,22 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   /*! \brief The mapping from sequence ids to sequences. */
   std::unordered_map<int64_t, Sequence> seq_map_;
 
+  /********************* Tenant Quota Structures *********************/
+
+  /*! \brief The page quota of a tenant and the pages charged to it. */
+  struct TenantQuota {
+    /*! \brief The soft and hard limits in pages, -1 for no limit. */
+    int64_t soft_limit = -1;
+    int64_t hard_limit = -1;
+    int64_t num_pages = 0;
+  };
+  /*! \brief The tenants, created on first use. */
+  std::unordered_map<int64_t, TenantQuota> tenants_;
+  /*! \brief The tenant charged for each page in use. */
+  std::vector<int64_t> page_tenant_ids_;
+  /*! \brief The number of BeginForward so far, as the clock of last use. */
+  int64_t forward_step_ = 0;
+
   /********************* Sequence Block Structures *********************/
 
   /*! \brief The list of all blocks once allocated. */
@@ -985,6 +1098,43 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   /*! \brief The list of free available blocks (in their indices). */
   std::vector<int32_t> free_block_idx_;
 
+  /********************* Prefix Cache Structures *********************/
+
+  /*! \brief The prefix cache entry of an internal sequence retaining KV data. */
+  struct PrefixCacheEntry {
+    /*! \brief The prefix tree node of the last page of the sequence. */
+    int32_t leaf_node_idx;
+    /*! \brief The position of the sequence in the LRU list. */
+    std::list<int64_t>::iterator lru_it;
+  };
+
+  /*! \brief The list of all prefix tree nodes once allocated. Node 0 is the root. */
+  std::vector<PrefixTreeNode> prefix_tree_;
+  /*! \brief The list of free available prefix tree nodes (in their indices). */
+  std::vector<int32_t> free_prefix_tree_node_idx_;
+  /*! \brief The internal sequences of the prefix cache, most recently used first. */
+  std::list<int64_t> prefix_cache_lru_;
+  /*! \brief The mapping from internal sequence ids to their prefix cache entries. */
+  std::unordered_map<int64_t, PrefixCacheEntry> prefix_cache_entries_;
+  /*! \brief The id of the next internal sequence of the prefix cache. */
+  int64_t next_prefix_cache_seq_id_ = kPrefixCacheSeqIdBegin;
+  /*!
+   * \brief The internal sequence that must not be evicted since it is being
+   * forked from, or -1 if there is no such sequence.
+   */
+  int64_t pinned_prefix_cache_seq_id_ = -1;
+
+  /********************* Host Offload Structures *********************/
+
+  /*!
+   * \brief The host memory holding the KV data of offloaded blocks.
+   * It is allocated lazily in chunks of `kHostPageChunkSize` pages. Each chunk
+   * has `num_layers` NDArrays, in the same layout as the device pages.
+   */
+  std::vector<std::vector<NDArray>> host_page_chunks_;
+  /*! \brief The list of ids of free host pages for reuse. */
+  std::vector<int32_t> free_host_page_ids_;
+
   /*********** Current Batch Info & Auxiliary Arrays on Device ***********/
   //-------------------------------------------
   // The following fields are auxiliary arrays on device.
@@ -1013,6 +1163,11 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   std::vector<bool> use_decode_kernel_;
   /*! \brief Whether the attention request is a decode request, set in BeginForwardFunction. */
   bool is_decode_request_;
+  /*!
+   * \brief The number of leading sequences of a mixed prefill/decode batch that run
+   * the decode kernel on the depths using it, or 0 if the batch is not mixed.
+   */
+  int64_t num_mixed_decode_ = 0;
   /*! \brief The KV transfer recver disco group's PE offset in this forward.
              If no KV is transfered, recver is -1.
              Assume that all the KV are transfered to the same recver in the forward.
@@ -1084,6 +1239,15 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   std::vector<NDArray> k_rope_pos_offset_view_;
   std::vector<NDArray> tree_attn_mask_view_;
   std::vector<NDArray> tree_attn_mn_indptr_view_;
+  NDArray commit_copy_length_indptr_view_;
+  NDArray commit_copy_src_dst_pos_in_page_table_view_;
+  /*! \brief The batch size of the forward whose accepted tree nodes are committed. */
+  int64_t commit_copy_batch_size_ = 0;
+  /*!
+   * \brief The layers whose compaction copy of the committed tree nodes is deferred to
+   * their attention in the next forward, and not launched yet.
+   */
+  std::vector<bool> pending_compact_copy_layers_;
 
   PackedFunc f_transpose_append_;
   Optional<PackedFunc> f_transfer_kv_;
@@ -1115,6 +1279,11 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   TVMStreamHandle copy_stream_ = nullptr;
   /*! \brief The device stream for KV transfer */
   TVMStreamHandle kv_transfer_stream_ = nullptr;
+  /*!
+   * \brief Whether the KV transfer stream has work which the compute stream
+   * has not waited for yet.
+   */
+  bool kv_transfer_pending_ = false;
 
  public:
   /*! \brief Constructor. Take the cache configuration and initialize the NDArrays. */
@@ -1123,8 +1292,9 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       int64_t num_qo_heads, int64_t num_kv_heads, int64_t head_dim, int64_t reserved_num_seqs,
       int64_t num_total_pages, int64_t prefill_chunk_size, bool support_sliding_window,
       RoPEMode rope_mode, double rotary_scale, double rotary_theta,
-      Optional<NDArray> rope_ext_factors, bool enable_kv_transfer, DLDataType dtype, Device device,
-      PackedFunc f_transpose_append, PackedFunc f_compact_copy, PackedFunc f_attention_prefill,
+      Optional<NDArray> rope_ext_factors, bool enable_kv_transfer, DLDataType dtype,
+      DLDataType page_dtype, Device device, PackedFunc f_transpose_append,
+      PackedFunc f_compact_copy, PackedFunc f_attention_prefill,
       PackedFunc f_attention_decode, PackedFunc f_attention_prefill_sliding_window,
       PackedFunc f_attention_decode_sliding_window, PackedFunc f_attention_prefill_ragged,
       PackedFunc f_attention_prefill_with_tree_mask,
@@ -1174,6 +1344,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         device_(device) {
     pages_.reserve(num_layers);
     if (enable_kv_transfer) {
+      CHECK(DataType(page_dtype) == DataType(dtype))
+          << "KV transfer does not support quantized KV cache pages.";
       CHECK(Registry::Get("runtime.disco.nvshmem.init_nvshmem") != nullptr)
           << "NVSHMEM is not enabled. Please make sure NVSHMEM is enabled when compiling TVM.";
       const PackedFunc* f_nvshmem_empty = runtime::Registry::Get("runtime.disco.nvshmem.empty");
@@ -1198,7 +1370,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     } else {
       for (int i = 0; i < num_layers; ++i) {
         pages_.push_back(
-            NDArray::Empty({num_total_pages, 2, num_kv_heads, page_size, head_dim}, dtype, device));
+            NDArray::Empty({num_total_pages, 2, num_kv_heads, page_size, head_dim}, page_dtype,
+                           device));
       }
     }
 
@@ -1288,6 +1461,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     for (int64_t page_id = num_total_pages - 1; page_id >= 0; --page_id) {
       free_page_ids_.push_back(page_id);
     }
+    page_tenant_ids_.resize(num_total_pages, 0);
+    prefix_tree_.emplace_back();
 
     // If the device is CUDA/ROCm, we create a standalone copy stream, in
     // purpose to hide the latency of auxiliary stream copy.
@@ -1337,7 +1512,23 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       free_page_ids_.push_back(page_id);
     }
     global_block_pool_.clear();
+    for (auto& it : tenants_) {
+      it.second.num_pages = 0;
+    }
+    forward_step_ = 0;
     free_block_idx_.clear();
+    prefix_tree_.clear();
+    prefix_tree_.emplace_back();
+    free_prefix_tree_node_idx_.clear();
+    prefix_cache_lru_.clear();
+    prefix_cache_entries_.clear();
+    next_prefix_cache_seq_id_ = kPrefixCacheSeqIdBegin;
+    free_host_page_ids_.clear();
+    int64_t num_host_pages = host_page_chunks_.size() * kHostPageChunkSize;
+    for (int64_t host_page_id = num_host_pages - 1; host_page_id >= 0; --host_page_id) {
+      free_host_page_ids_.push_back(host_page_id);
+    }
+    pending_compact_copy_layers_.clear();
     dirty_aux_data_device_ = false;
   }
 
@@ -1352,6 +1543,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   }
 
   void RemoveSequence(int64_t seq_id) final {
+    FlushPendingCompactKVCopy();
     auto it = seq_map_.find(seq_id);
     CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
     int32_t block_idx = it->second.last_block_idx;
@@ -1360,7 +1552,10 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     while (block_idx != -1 && global_block_pool_[block_idx].external_ref_cnt == 1) {
       // - Free pages in the last block.
       for (int32_t page_id : global_block_pool_[block_idx].page_ids) {
-        free_page_ids_.push_back(page_id);
+        FreePage(page_id);
+      }
+      for (int32_t host_page_id : global_block_pool_[block_idx].host_page_ids) {
+        free_host_page_ids_.push_back(host_page_id);
       }
       free_block_idx_.push_back(block_idx);
       block_idx = global_block_pool_[block_idx].parent_idx;
@@ -1375,6 +1570,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   }
 
   void ForkSequence(int64_t parent_seq_id, int64_t child_seq_id, int64_t fork_pos = -1) final {
+    FlushPendingCompactKVCopy();
     auto parent_it = seq_map_.find(parent_seq_id);
     CHECK(parent_it != seq_map_.end())
         << "The parent sequence \"" << parent_seq_id << "\" cannot be found in KV cache.";
@@ -1387,6 +1583,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     CHECK(parent_it->second.accepted_indices_committed)
         << "The parent sequence's token tree computed in the last round of forward has not been "
            "committed with accepted nodes.";
+    PrefetchSequence(parent_seq_id);
 
     if (fork_pos == -1) {
       fork_pos = parent_it->second.seq_length;
@@ -1478,14 +1675,18 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       if (in_page_offset > 0) {
         // Fork within a page and copy common page to child block partially
         int32_t src_page_id = global_block_pool_[forked_block_idx].page_ids[0];
-        int32_t tgt_page_id = GetFreePage();
+        int32_t tgt_page_id = GetFreePage(parent_it->second.tenant_id);
         global_block_pool_[child_block_idx].page_ids.push_back(tgt_page_id);
         CopySinglePage(src_page_id, tgt_page_id, in_page_offset);
       }
       break;
     }
     // Create the child sequence with the child block.
-    seq_map_.insert({child_seq_id, Sequence(&global_block_pool_, child_block_idx)});
+    Sequence child(&global_block_pool_, child_block_idx);
+    child.tenant_id = parent_it->second.tenant_id;
+    child.priority = parent_it->second.priority;
+    child.last_use_step = forward_step_;
+    seq_map_.insert({child_seq_id, std::move(child)});
     dirty_aux_data_device_ = true;
   }
 
@@ -1504,31 +1705,62 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     }
   }
 
-  void CompactKVCopy() {
+  /*!
+   * \brief Copy the auxiliary data of the compaction copy of all layers to GPU.
+   * \return Whether there is any KV data to copy.
+   */
+  bool PrepareCompactKVCopy() {
     int total_copy_length = commit_copy_length_indptr_host_.back();
     ICHECK_GE(total_copy_length, 0);
     if (total_copy_length == 0) {
-      return;
+      return false;
     }
 
     // Copy indptr/src/dst arrays to GPU.
     aux_data_manager_->ResetCompactKVAuxDataCopy();
-    NDArray commit_copy_length_indptr_view =
+    commit_copy_length_indptr_view_ =
         aux_data_manager_->CopyCommitLengthIndptrAsync(&commit_copy_length_indptr_host_);
-    NDArray commit_copy_src_dst_pos_in_page_table_view =
+    commit_copy_src_dst_pos_in_page_table_view_ =
         aux_data_manager_->CopyCommitSrcDstPosInPageTableAsync(
             &commit_copy_src_pos_in_page_table_host_, &commit_copy_dst_pos_in_page_table_host_);
     aux_data_manager_->CommitCompactKVAuxDataCopy();
+    commit_copy_batch_size_ = cur_batch_size_;
+    ICHECK(f_compact_copy_.defined()) << "Function \"f_compact_copy\" is not defined.";
+    pending_compact_copy_layers_.assign(num_layers_, true);
+    return true;
+  }
+
+  /*! \brief Launch the compaction copy of the given layer on the current stream. */
+  void LaunchCompactKVCopy(int64_t local_layer_id) {
+    f_compact_copy_(pages_[local_layer_id], commit_copy_length_indptr_view_,
+                    commit_copy_src_dst_pos_in_page_table_view_, commit_copy_batch_size_);
+    pending_compact_copy_layers_[local_layer_id] = false;
+  }
 
+  void CompactKVCopy() {
+    if (PrepareCompactKVCopy()) {
+      FlushPendingCompactKVCopy();
+    }
+  }
+
+  /*!
+   * \brief Launch the compaction copies that are not launched yet, before the KV data is read
+   * or moved other than by the attention.
+   */
+  void FlushPendingCompactKVCopy() {
+    if (std::none_of(pending_compact_copy_layers_.begin(), pending_compact_copy_layers_.end(),
+                     [](bool pending) { return pending; })) {
+      return;
+    }
     // Invoke the copy kernel on copy stream.
     if (copy_stream_ != compute_stream_) {
       // Set the copy stream for copy.
       DeviceAPI::Get(device_)->SetStream(device_, copy_stream_);
     }
-    ICHECK(f_compact_copy_.defined()) << "Function \"f_compact_copy\" is not defined.";
     for (int layer = 0; layer < num_layers_; ++layer) {
-      f_compact_copy_(pages_[layer], commit_copy_length_indptr_view,
-                      commit_copy_src_dst_pos_in_page_table_view, cur_batch_size_);
+      if (pending_compact_copy_layers_[layer]) {
+        LaunchCompactKVCopy(layer);
+      }
     }
     if (copy_stream_ != compute_stream_) {
       // Set the compute stream back.
@@ -1568,6 +1800,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   }
 
   void PopN(int64_t seq_id, int32_t n) final {
+    FlushPendingCompactKVCopy();
     auto it = seq_map_.find(seq_id);
     CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
 
@@ -1578,6 +1811,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     if (n == 0) {
       return;
     }
+    PrefetchSequence(seq_id);
 
     int32_t block_idx = it->second.last_block_idx;
     // The block should have at least one reference, which comes from the sequence.
@@ -1587,7 +1821,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         n -= global_block_pool_[block_idx].seq_length;
         it->second.seq_length -= global_block_pool_[block_idx].seq_length;
         for (int32_t page_id : global_block_pool_[block_idx].page_ids) {
-          free_page_ids_.push_back(page_id);
+          FreePage(page_id);
         }
         free_block_idx_.push_back(block_idx);
         block_idx = global_block_pool_[block_idx].parent_idx;
@@ -1599,7 +1833,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         int64_t tgt_npage =
             (global_block_pool_[block_idx].seq_length - n + page_size_ - 1) / page_size_;
         while (cur_npage > tgt_npage) {
-          free_page_ids_.push_back(global_block_pool_[block_idx].page_ids.back());
+          FreePage(global_block_pool_[block_idx].page_ids.back());
           global_block_pool_[block_idx].page_ids.pop_back();
           --cur_npage;
         }
@@ -1627,19 +1861,226 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     dirty_aux_data_device_ = true;
   }
 
+  /************** Prefix Cache **************/
+
+  int64_t AddSequenceWithPrefixCache(int64_t seq_id, const IntTuple& token_ids) final {
+    FlushPendingCompactKVCopy();
+    CHECK(seq_map_.find(seq_id) == seq_map_.end())
+        << "The sequence \"" << seq_id << "\" is already in the KV cache.";
+    // Always leave the last token to prefill, so that the model still produces its logits.
+    int64_t max_match_length = std::max(static_cast<int64_t>(token_ids.size()) - 1, int64_t{0});
+    auto [match_length, node_idx] = MatchPrefixTree(token_ids, max_match_length);
+    if (match_length == 0) {
+      AddSequence(seq_id);
+      return 0;
+    }
+    // Any sequence going through the deepest matched node contains the matched prefix.
+    ICHECK(!prefix_tree_[node_idx].seq_ids.empty());
+    int64_t cache_seq_id = *prefix_tree_[node_idx].seq_ids.begin();
+    TouchPrefixCacheEntry(cache_seq_id);
+    // The fork shares the full pages of the prefix and copies the partially
+    // matched trailing page, which the new sequence is going to append to.
+    pinned_prefix_cache_seq_id_ = cache_seq_id;
+    ForkSequence(cache_seq_id, seq_id, match_length);
+    pinned_prefix_cache_seq_id_ = -1;
+    return match_length;
+  }
+
+  void InsertPrefixCache(int64_t seq_id, const IntTuple& token_ids) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    CHECK(prefix_cache_entries_.find(seq_id) == prefix_cache_entries_.end())
+        << "The sequence \"" << seq_id << "\" is an internal sequence of the prefix cache.";
+    CHECK_LE(token_ids.size(), it->second.seq_length)
+        << "The number of token ids " << token_ids.size() << " exceeds the length "
+        << it->second.seq_length << " of sequence \"" << seq_id << "\".";
+    CHECK_EQ(it->second.sliding_window_size, -1)
+        << "The sequence \"" << seq_id
+        << "\" is enabled with sliding window and cannot be inserted into the prefix cache.";
+    int64_t length = token_ids.size();
+    if (length == 0) {
+      return;
+    }
+    auto [match_length, node_idx] = MatchPrefixTree(token_ids, length);
+    if (match_length == length) {
+      // The prefix is already retained by some sequence in the cache.
+      TouchPrefixCacheEntry(*prefix_tree_[node_idx].seq_ids.begin());
+      return;
+    }
+
+    // Retain the KV data with an internal sequence forked from the given one.
+    // The fork shares all the full pages, and only the trailing partial page is copied.
+    int64_t cache_seq_id = next_prefix_cache_seq_id_++;
+    ForkSequence(seq_id, cache_seq_id, length);
+
+    // Add the tokens into the prefix tree, one page per node.
+    node_idx = kPrefixTreeRootIdx;
+    for (int64_t begin = 0; begin < length; begin += page_size_) {
+      int64_t end = std::min(begin + page_size_, length);
+      std::vector<int32_t> page_token_ids;
+      page_token_ids.reserve(end - begin);
+      for (int64_t i = begin; i < end; ++i) {
+        page_token_ids.push_back(token_ids[i]);
+      }
+      int32_t child_idx = -1;
+      for (int32_t idx : prefix_tree_[node_idx].child_indices) {
+        if (prefix_tree_[idx].token_ids == page_token_ids) {
+          child_idx = idx;
+          break;
+        }
+      }
+      if (child_idx == -1) {
+        child_idx = GetFreePrefixTreeNode();
+        prefix_tree_[child_idx].token_ids = std::move(page_token_ids);
+        prefix_tree_[child_idx].parent_idx = node_idx;
+        prefix_tree_[node_idx].child_indices.push_back(child_idx);
+      }
+      prefix_tree_[child_idx].seq_ids.insert(cache_seq_id);
+      node_idx = child_idx;
+    }
+    prefix_cache_lru_.push_front(cache_seq_id);
+    prefix_cache_entries_[cache_seq_id] = PrefixCacheEntry{node_idx, prefix_cache_lru_.begin()};
+  }
+
+  /************** Host Offload **************/
+
+  void OffloadSequence(int64_t seq_id) final {
+    FlushPendingCompactKVCopy();
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    // The pages may still be written by the kernels on the compute stream.
+    if (copy_stream_ != compute_stream_) {
+      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, compute_stream_, copy_stream_);
+    }
+    // Only the blocks owned by this sequence alone are offloaded.
+    // The blocks shared with other sequences stay on device.
+    int32_t block_idx = it->second.last_block_idx;
+    while (block_idx != -1 && global_block_pool_[block_idx].external_ref_cnt == 1) {
+      Block& block = global_block_pool_[block_idx];
+      for (int32_t page_id : block.page_ids) {
+        int32_t host_page_id = GetFreeHostPage();
+        CopyPageBetweenHostAndDevice(page_id, host_page_id, /*to_host=*/true);
+        block.host_page_ids.push_back(host_page_id);
+        FreePage(page_id);
+      }
+      block.page_ids.clear();
+      block_idx = block.parent_idx;
+    }
+    // The released pages can be reused only after the copy finishes, which
+    // the compute stream waits for in the next sync of auxiliary data.
+    dirty_aux_data_device_ = true;
+  }
+
+  void PrefetchSequence(int64_t seq_id) final {
+    FlushPendingCompactKVCopy();
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    int64_t num_pages_required = 0;
+    for (int32_t block_idx = it->second.last_block_idx; block_idx != -1;
+         block_idx = global_block_pool_[block_idx].parent_idx) {
+      num_pages_required += global_block_pool_[block_idx].host_page_ids.size();
+    }
+    if (num_pages_required == 0) {
+      return;
+    }
+    CHECK_LE(num_pages_required, GetNumAvailablePages())
+        << "The KV cache is full. The " << num_pages_required << " offloaded pages of sequence \""
+        << seq_id << "\" cannot be brought back.";
+    for (int32_t block_idx = it->second.last_block_idx; block_idx != -1;
+         block_idx = global_block_pool_[block_idx].parent_idx) {
+      Block& block = global_block_pool_[block_idx];
+      for (int32_t host_page_id : block.host_page_ids) {
+        int32_t page_id = GetFreePage(it->second.tenant_id);
+        CopyPageBetweenHostAndDevice(page_id, host_page_id, /*to_host=*/false);
+        block.page_ids.push_back(page_id);
+        // Later copies into this host page are issued after the copy above on the same stream.
+        free_host_page_ids_.push_back(host_page_id);
+      }
+      block.host_page_ids.clear();
+    }
+    dirty_aux_data_device_ = true;
+  }
+
+  /************** Tenant Quota **************/
+
+  void SetSequenceTenant(int64_t seq_id, int64_t tenant_id, int64_t priority) final {
+    auto it = seq_map_.find(seq_id);
+    CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id << "\" cannot be found in KV cache.";
+    CHECK_GE(tenant_id, 0) << "The tenant id should be non-negative.";
+    it->second.tenant_id = tenant_id;
+    it->second.priority = priority;
+  }
+
+  void SetTenantPageQuota(int64_t tenant_id, int64_t soft_limit, int64_t hard_limit) final {
+    CHECK_GE(tenant_id, 0) << "The tenant id should be non-negative.";
+    CHECK_GE(soft_limit, -1) << "The soft limit should be non-negative, or -1 for no limit.";
+    CHECK_GE(hard_limit, -1) << "The hard limit should be non-negative, or -1 for no limit.";
+    if (soft_limit != -1 && hard_limit != -1) {
+      CHECK_LE(soft_limit, hard_limit) << "The soft limit should not exceed the hard limit.";
+    }
+    TenantQuota& tenant = tenants_[tenant_id];
+    tenant.soft_limit = soft_limit;
+    tenant.hard_limit = hard_limit;
+  }
+
+  int64_t GetTenantNumPages(int64_t tenant_id) const final {
+    auto it = tenants_.find(tenant_id);
+    return it == tenants_.end() ? 0 : it->second.num_pages;
+  }
+
+  IntTuple GetEvictionCandidates(int64_t max_num) const final {
+    // (over soft limit, priority, last use step, seq id) sorts in the order to preempt.
+    std::vector<std::tuple<bool, int64_t, int64_t, int64_t>> candidates;
+    for (const auto& [seq_id, seq] : seq_map_) {
+      if (prefix_cache_entries_.count(seq_id)) {
+        continue;
+      }
+      // Only the pages not shared with other sequences are released by preemption.
+      int64_t num_own_pages = 0;
+      for (int32_t block_idx = seq.last_block_idx;
+           block_idx != -1 && global_block_pool_[block_idx].external_ref_cnt == 1;
+           block_idx = global_block_pool_[block_idx].parent_idx) {
+        num_own_pages += global_block_pool_[block_idx].page_ids.size();
+      }
+      if (num_own_pages == 0) {
+        continue;
+      }
+      auto tenant_it = tenants_.find(seq.tenant_id);
+      bool over_soft_limit = tenant_it != tenants_.end() && tenant_it->second.soft_limit != -1 &&
+                             tenant_it->second.num_pages > tenant_it->second.soft_limit;
+      candidates.emplace_back(!over_soft_limit, seq.priority, seq.last_use_step, seq_id);
+    }
+    std::sort(candidates.begin(), candidates.end());
+    std::vector<int64_t> seq_ids;
+    for (const auto& candidate : candidates) {
+      if (static_cast<int64_t>(seq_ids.size()) >= max_num) {
+        break;
+      }
+      seq_ids.push_back(std::get<3>(candidate));
+    }
+    return IntTuple(seq_ids);
+  }
+
   /************** Raw Info Query **************/
 
   bool Empty() const final {
     return seq_map_.empty() &&                                     //
            free_block_idx_.size() == global_block_pool_.size() &&  //
-           free_page_ids_.size() == static_cast<size_t>(num_total_pages_);
+           free_page_ids_.size() == static_cast<size_t>(num_total_pages_) &&
+           free_host_page_ids_.size() == host_page_chunks_.size() * kHostPageChunkSize;
   }
 
-  int32_t GetNumAvailablePages() const final { return free_page_ids_.size(); }
+  int32_t GetNumAvailablePages() const final {
+    // The pages only retained by the prefix cache are reclaimed on demand.
+    return free_page_ids_.size() + GetNumEvictablePrefixCachePages();
+  }
 
   int32_t GetTotalSequenceLength() const final {
     int32_t total_seq_len = 0;
     for (const auto& it : seq_map_) {
+      if (prefix_cache_entries_.count(it.first)) {
+        continue;
+      }
       total_seq_len += it.second.seq_length;
     }
     return total_seq_len;
@@ -1649,9 +2090,17 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
 
   void BeginForward(const IntTuple& seq_ids, const IntTuple& append_lengths,
                     const Optional<IntTuple>& opt_token_tree_parent_ptr) final {
+    NVTXScopedRange scope("PagedKVCache: BeginForward");
     CHECK_EQ(seq_ids.size(), append_lengths.size())
         << "The seq_ids size (" << seq_ids.size() << ") and append_lengths size ("
         << append_lengths.size() << ") mismatch.";
+    // - Fail before any page is allocated when a tenant would exceed its hard limit.
+    CheckTenantHardLimits(seq_ids, append_lengths);
+    ++forward_step_;
+    // - Bring back the KV data of the offloaded sequences before the batch is planned.
+    for (int i = 0; i < static_cast<int>(seq_ids.size()); ++i) {
+      PrefetchSequence(seq_ids[i]);
+    }
     cur_batch_size_ = seq_ids.size();
     cur_seq_ids_ = seq_ids;
     cur_append_lengths_ = append_lengths;
@@ -1668,6 +2117,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       CHECK(it != seq_map_.end()) << "The sequence \"" << seq_ids[i]
                                   << "\" cannot be found in KV cache.";
       sequences.push_back(&it->second);
+      it->second.last_use_step = forward_step_;
       last_block_length_before_append.push_back(
           global_block_pool_[it->second.last_block_idx].seq_length);
       int k_rope_offset = it->second.seq_length;
@@ -1682,6 +2132,21 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       }
     }
 
+    // - In a mixed batch, the leading sequences appending one token each run
+    // the decode kernel and the others run the prefill kernel. The sub-batches are
+    // views of the auxiliary arrays, which are only laid out in one array on CUDA.
+    num_mixed_decode_ = 0;
+    bool all_committed =
+        std::all_of(sequences.begin(), sequences.end(),
+                    [](const Sequence* sequence) { return sequence->accepted_indices_committed; });
+    if (!is_decode_request_ && !opt_token_tree_parent_ptr.defined() && all_committed &&
+        !support_sliding_window_ && !NeedKernelBeginForward() &&
+        device_.device_type == DLDeviceType::kDLCUDA) {
+      while (num_mixed_decode_ < cur_batch_size_ && append_lengths[num_mixed_decode_] == 1) {
+        ++num_mixed_decode_;
+      }
+    }
+
     auto [block_ids_on_depths, trailing_blocks] = GetBlockIdsOnDepth(sequences);
     num_depths_ =
         std::min(static_cast<int>(block_ids_on_depths.size()), kPagedKVCacheMaxBlockDepth);
@@ -1705,7 +2170,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       CHECK_EQ(chunked_block_ids_arr[num_depths_ - 1].size(), cur_batch_size_);
     }
 
-    append_before_attn_ = !support_sliding_window_ && use_decode_kernel_.back();
+    append_before_attn_ =
+        !support_sliding_window_ && use_decode_kernel_.back() && num_mixed_decode_ == 0;
     if (NeedKernelBeginForward() && num_qo_heads_ / num_kv_heads_ >= 4) {
       // When GQA group size is at least 4 and FlashInfer is enabled,
       // we always use prefill kernel for better performance.
@@ -1913,9 +2379,10 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   }
 
   void EndForward() final {
-    if (kv_transfer_stream_ != nullptr) {
-      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, kv_transfer_stream_, compute_stream_);
-    }
+    NVTXScopedRange scope("PagedKVCache: EndForward");
+    // The layers whose attention is not run in this forward.
+    FlushPendingCompactKVCopy();
+    ComputeStreamWaitForKVTransferStream();
     if (!f_attention_prefill_end_forward_.defined() || !f_attention_decode_end_forward_.defined() ||
         !f_attention_prefill_ragged_end_forward_.defined()) {
       return;
@@ -1979,6 +2446,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     if (begin >= sequence->seq_length) {
       return;
     }
+    PrefetchSequence(seq_id);
     // Need to send existing KV.
     CHECK_GT(static_cast<int>(sequence->kv_transfer_metadata.remote_position_map.size()),
              sequence->seq_length - begin)
@@ -2043,6 +2511,11 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     ComputeStreamWaitForCopyStream();
     // The auxiliary data structure on device must have been synchronized.
     ICHECK(!dirty_aux_data_device_);
+    // Compact the accepted tree nodes of the last forward in this layer, before the
+    // appended k/v data may overwrite the positions of the rejected nodes.
+    if (!pending_compact_copy_layers_.empty() && pending_compact_copy_layers_[local_layer_id]) {
+      LaunchCompactKVCopy(local_layer_id);
+    }
 
     NDArray q_data = temp_attn_q_device_.CreateView({total_seq_length, num_qo_heads_, head_dim_},
                                                     qkv_data->dtype);
@@ -2062,7 +2535,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     // Part 2. Split fused qkv and apply rotary embedding to q/k data.
     if (transfer_kv_) {
       // The the compute stream needs to wait for the KV transfer stream.
-      DeviceAPI::Get(device_)->SyncStreamFromTo(device_, kv_transfer_stream_, compute_stream_);
+      ComputeStreamWaitForKVTransferStream();
     }
     if (!rope_ext_factors_.defined()) {
       f_split_rotary_(qkv_data_view, q_rope_position_map_view_, q_data, k_data, v_data,
@@ -2087,6 +2560,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
                                           kv_transfer_page_to_page_local_position_map_view_,
                                           kv_transfer_page_to_page_recver_id_view_,
                                           kv_transfer_stream_);
+      kv_transfer_pending_ = true;
     }
     if (transfer_kv_) {
       // FIXME: if the sender and recver's PP/TP degree do not match, we will need to first
@@ -2096,6 +2570,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       f_transfer_kv_.value()(pages_[local_layer_id], k_data, v_data,
                              kv_transfer_remote_position_map_view_, kv_transfer_recver_id_view_,
                              kv_transfer_stream_);
+      kv_transfer_pending_ = true;
     }
     // Part 5: perform attention
     AttentionInternal(layer_id, q_data, k_data, v_data, o_data_view, attn_score_scaling_factor);
@@ -2106,6 +2581,17 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   }
 
   void CommitAcceptedTokenTreeNodes(const IntTuple& seq_ids, const IntTuple& leaf_indices) final {
+    CommitAcceptedTokenTreeNodesImpl(seq_ids, leaf_indices, /*defer_compact_copy=*/false);
+  }
+
+  void CommitAcceptedTokenTreeNodesDeferred(const IntTuple& seq_ids,
+                                            const IntTuple& leaf_indices) final {
+    CommitAcceptedTokenTreeNodesImpl(seq_ids, leaf_indices, /*defer_compact_copy=*/true);
+  }
+
+  void CommitAcceptedTokenTreeNodesImpl(const IntTuple& seq_ids, const IntTuple& leaf_indices,
+                                        bool defer_compact_copy) {
+    FlushPendingCompactKVCopy();
     CHECK_EQ(seq_ids.size(), leaf_indices.size())
         << "The given seq_ids and leaf_indices have different size.";
     int num_seq_to_commit = seq_ids.size();
@@ -2176,15 +2662,12 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         commit_copy_length_indptr_host_.push_back(commit_copy_length_indptr_host_.back() +
                                                   path_on_tree.size());
       }
-
-      // Compact the KV data for each sequence by copying KV data.
-      CompactKVCopy();
     }
 
     // - Update the KV cache page data structure.
     //   Note: Function "PopN" only changes the page table structure and does not
-    //         change the KV cache data. Therefore, we can directly use it, since
-    //         we have already launched all copies.
+    //         change the KV cache data. Therefore, we can directly use it before
+    //         launching the copies, whose positions are computed above.
     for (int i = 0; i < num_seq_to_commit; ++i) {
       int64_t length_to_pop =
           cur_append_lengths_[i] -
@@ -2195,6 +2678,18 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       sequences[i]->token_tree_parent_ptr.clear();
       sequences[i]->token_tree_node_depths.clear();
     }
+
+    if (!is_chain) {
+      // Compact the KV data for each sequence by copying KV data.
+      // When deferred, the copy of each layer is launched on the compute stream
+      // right before the attention of the layer in the next forward, so that the
+      // commit does not add a separate pass over the pages of all layers.
+      if (defer_compact_copy) {
+        PrepareCompactKVCopy();
+      } else {
+        CompactKVCopy();
+      }
+    }
   }
 
   NDArray GetQueryPositions() final {
@@ -2211,6 +2706,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
         << "PageAttentionKVCache requires the `f_debug_get_kv` to be explicitly passed in when "
            "initialization. Please construct the KV cache with `f_debug_get_kv`.";
 
+    PrefetchSequence(seq_id);
     const Sequence& seq = seq_map_.at(seq_id);
     CHECK_GE(start_pos, 0) << "DebugGetKV does not accept negative start_pos " << start_pos;
     CHECK_LE(end_pos, seq.seq_length) << "DebugGetKV does not accept out-of-range end_pos";
@@ -2263,15 +2759,70 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
   TVM_DECLARE_FINAL_OBJECT_INFO(PagedAttentionKVCacheObj, AttentionKVCacheObj);
 
  private:
-  /*! \brief Get a new free page and return its id. */
-  int32_t GetFreePage() {
+  /*! \brief Get a new free page charged to the given tenant and return its id. */
+  int32_t GetFreePage(int64_t tenant_id) {
+    TenantQuota& tenant = tenants_[tenant_id];
+    CHECK(tenant.hard_limit == -1 || tenant.num_pages < tenant.hard_limit)
+        << "The tenant \"" << tenant_id << "\" reaches its hard limit of " << tenant.hard_limit
+        << " pages. No page can be allocated.";
+    // Evict the least recently used prefix cache entries until a page is released.
+    while (free_page_ids_.empty() && EvictPrefixCacheEntry()) {
+    }
     // Find a page from the free page pools.
     CHECK(!free_page_ids_.empty()) << "The KV cache is full. No page can be allocated.";
     int32_t page_id = free_page_ids_.back();
     free_page_ids_.pop_back();
+    page_tenant_ids_[page_id] = tenant_id;
+    ++tenant.num_pages;
     return page_id;
   }
 
+  /*!
+   * \brief Check that the pages the given batch is about to allocate, including
+   * the pages of its offloaded sequences, are within the hard limits of the tenants.
+   * The sliding window sequences are not checked, as they release pages while appending.
+   */
+  void CheckTenantHardLimits(const IntTuple& seq_ids, const IntTuple& append_lengths) const {
+    std::unordered_map<int64_t, int64_t> num_new_pages;
+    for (int i = 0; i < static_cast<int>(seq_ids.size()); ++i) {
+      auto it = seq_map_.find(seq_ids[i]);
+      if (it == seq_map_.end()) {
+        continue;
+      }
+      const Sequence& seq = it->second;
+      auto tenant_it = tenants_.find(seq.tenant_id);
+      if (tenant_it == tenants_.end() || tenant_it->second.hard_limit == -1) {
+        continue;
+      }
+      int64_t& num_pages = num_new_pages[seq.tenant_id];
+      for (int32_t block_idx = seq.last_block_idx; block_idx != -1;
+           block_idx = global_block_pool_[block_idx].parent_idx) {
+        num_pages += global_block_pool_[block_idx].host_page_ids.size();
+      }
+      if (seq.sliding_window_size == -1) {
+        const Block& block = global_block_pool_[seq.last_block_idx];
+        int64_t cur_npage = block.page_ids.size() + block.host_page_ids.size();
+        int64_t tgt_npage = (block.seq_length - block.sink_length + block.sliding_window_offset +
+                             append_lengths[i] + page_size_ - 1) /
+                            page_size_;
+        num_pages += std::max(tgt_npage - cur_npage, static_cast<int64_t>(0));
+      }
+    }
+    for (const auto& [tenant_id, num_pages] : num_new_pages) {
+      const TenantQuota& tenant = tenants_.at(tenant_id);
+      CHECK_LE(tenant.num_pages + num_pages, tenant.hard_limit)
+          << "The tenant \"" << tenant_id << "\" would exceed its hard limit of "
+          << tenant.hard_limit << " pages with " << num_pages << " more pages on top of the "
+          << tenant.num_pages << " pages it holds.";
+    }
+  }
+
+  /*! \brief Release the given page and uncharge it from its tenant. */
+  void FreePage(int32_t page_id) {
+    --tenants_[page_tenant_ids_[page_id]].num_pages;
+    free_page_ids_.push_back(page_id);
+  }
+
   /*! \brief Get a new free block and return its index. */
   int32_t GetFreeBlock() {
     if (!free_block_idx_.empty()) {
@@ -2287,6 +2838,177 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     return block_idx;
   }
 
+  /*! \brief Get a new free prefix tree node and return its index. */
+  int32_t GetFreePrefixTreeNode() {
+    if (!free_prefix_tree_node_idx_.empty()) {
+      int32_t node_idx = free_prefix_tree_node_idx_.back();
+      free_prefix_tree_node_idx_.pop_back();
+      prefix_tree_[node_idx].Reset();
+      return node_idx;
+    }
+    prefix_tree_.emplace_back();
+    return prefix_tree_.size() - 1;
+  }
+
+  /*!
+   * \brief Match the given token ids against the prefix tree.
+   * \param token_ids The token ids to match.
+   * \param max_length The maximum number of leading tokens to match.
+   * \return The matched length, and the deepest node the matched tokens reach.
+   * Every sequence recorded in the returned node contains the matched prefix.
+   */
+  std::pair<int64_t, int32_t> MatchPrefixTree(const IntTuple& token_ids,
+                                              int64_t max_length) const {
+    int32_t node_idx = kPrefixTreeRootIdx;
+    int64_t match_length = 0;
+    while (match_length < max_length) {
+      int64_t chunk_length = std::min(page_size_, max_length - match_length);
+      int32_t best_child_idx = -1;
+      int64_t best_common_length = 0;
+      for (int32_t child_idx : prefix_tree_[node_idx].child_indices) {
+        const std::vector<int32_t>& page_token_ids = prefix_tree_[child_idx].token_ids;
+        int64_t n = std::min(chunk_length, static_cast<int64_t>(page_token_ids.size()));
+        int64_t common_length = 0;
+        while (common_length < n &&
+               page_token_ids[common_length] == token_ids[match_length + common_length]) {
+          ++common_length;
+        }
+        if (common_length > best_common_length) {
+          best_child_idx = child_idx;
+          best_common_length = common_length;
+        }
+      }
+      if (best_child_idx == -1) {
+        break;
+      }
+      match_length += best_common_length;
+      node_idx = best_child_idx;
+      if (best_common_length < page_size_) {
+        // Stop at the partially matched page.
+        break;
+      }
+    }
+    return {match_length, node_idx};
+  }
+
+  /*! \brief Mark the given prefix cache entry as the most recently used. */
+  void TouchPrefixCacheEntry(int64_t cache_seq_id) {
+    auto it = prefix_cache_entries_.find(cache_seq_id);
+    ICHECK(it != prefix_cache_entries_.end());
+    prefix_cache_lru_.splice(prefix_cache_lru_.begin(), prefix_cache_lru_, it->second.lru_it);
+  }
+
+  /*!
+   * \brief Evict the least recently used prefix cache entry.
+   * The pages of the entry are released unless they are shared with other sequences.
+   * \return Whether an entry was evicted.
+   */
+  bool EvictPrefixCacheEntry() {
+    for (auto it = prefix_cache_lru_.rbegin(); it != prefix_cache_lru_.rend(); ++it) {
+      if (*it != pinned_prefix_cache_seq_id_) {
+        RemovePrefixCacheEntry(*it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /*! \brief Remove the given entry from the prefix cache and release its sequence. */
+  void RemovePrefixCacheEntry(int64_t cache_seq_id) {
+    auto it = prefix_cache_entries_.find(cache_seq_id);
+    ICHECK(it != prefix_cache_entries_.end());
+    int32_t node_idx = it->second.leaf_node_idx;
+    prefix_cache_lru_.erase(it->second.lru_it);
+    prefix_cache_entries_.erase(it);
+    // Unlink the sequence from the tree, and drop the nodes no sequence goes through.
+    while (node_idx != kPrefixTreeRootIdx) {
+      PrefixTreeNode& node = prefix_tree_[node_idx];
+      int32_t parent_idx = node.parent_idx;
+      node.seq_ids.erase(cache_seq_id);
+      if (node.seq_ids.empty()) {
+        ICHECK(node.child_indices.empty());
+        std::vector<int32_t>& siblings = prefix_tree_[parent_idx].child_indices;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), node_idx));
+        free_prefix_tree_node_idx_.push_back(node_idx);
+      }
+      node_idx = parent_idx;
+    }
+    RemoveSequence(cache_seq_id);
+  }
+
+  /*!
+   * \brief Get the number of pages that are only used by the prefix cache,
+   * all of which are released when every prefix cache entry is evicted.
+   */
+  int32_t GetNumEvictablePrefixCachePages() const {
+    if (prefix_cache_entries_.empty()) {
+      return 0;
+    }
+    std::vector<bool> used_by_seq(global_block_pool_.size(), false);
+    std::vector<bool> used_by_cache(global_block_pool_.size(), false);
+    for (const auto& [seq_id, seq] : seq_map_) {
+      std::vector<bool>& used = prefix_cache_entries_.count(seq_id) ? used_by_cache : used_by_seq;
+      for (int32_t block_idx = seq.last_block_idx; block_idx != -1 && !used[block_idx];
+           block_idx = global_block_pool_[block_idx].parent_idx) {
+        used[block_idx] = true;
+      }
+    }
+    int32_t num_pages = 0;
+    for (const Block& block : global_block_pool_) {
+      if (used_by_cache[block.index] && !used_by_seq[block.index]) {
+        num_pages += block.page_ids.size();
+      }
+    }
+    return num_pages;
+  }
+
+  /*! \brief Get a new free host page and return its id. */
+  int32_t GetFreeHostPage() {
+    if (free_host_page_ids_.empty()) {
+      // Allocate a new chunk of host pages.
+      Device preferred_host_device = GetPreferredHostDevice(device_);
+      std::vector<NDArray> chunk;
+      chunk.reserve(num_layers_);
+      for (int64_t layer = 0; layer < num_layers_; ++layer) {
+        chunk.push_back(NDArray::Empty(
+            {kHostPageChunkSize, 2, num_kv_heads_, page_size_, head_dim_}, pages_[layer]->dtype,
+            preferred_host_device));
+      }
+      int64_t begin = host_page_chunks_.size() * kHostPageChunkSize;
+      host_page_chunks_.push_back(std::move(chunk));
+      for (int64_t host_page_id = begin + kHostPageChunkSize - 1; host_page_id >= begin;
+           --host_page_id) {
+        free_host_page_ids_.push_back(host_page_id);
+      }
+    }
+    int32_t host_page_id = free_host_page_ids_.back();
+    free_host_page_ids_.pop_back();
+    return host_page_id;
+  }
+
+  /*!
+   * \brief Copy the KV data of all layers between a device page and a host page.
+   * The copy is issued on the copy stream.
+   */
+  void CopyPageBetweenHostAndDevice(int32_t page_id, int32_t host_page_id, bool to_host) {
+    const std::vector<NDArray>& chunk = host_page_chunks_[host_page_id / kHostPageChunkSize];
+    ShapeTuple page_shape{1, 2, num_kv_heads_, page_size_, head_dim_};
+    for (int64_t layer = 0; layer < num_layers_; ++layer) {
+      DLDataType dtype = pages_[layer]->dtype;
+      uint64_t page_bytes = 2 * num_kv_heads_ * page_size_ * head_dim_ * DataType(dtype).bytes();
+      NDArray device_page = pages_[layer].CreateView(page_shape, dtype, page_id * page_bytes);
+      NDArray host_page = chunk[layer].CreateView(
+          page_shape, dtype, (host_page_id % kHostPageChunkSize) * page_bytes);
+      DLTensor device_tensor = *device_page.operator->();
+      DLTensor host_tensor = *host_page.operator->();
+      if (to_host) {
+        NDArray::CopyFromTo(&device_tensor, &host_tensor, copy_stream_);
+      } else {
+        NDArray::CopyFromTo(&host_tensor, &device_tensor, copy_stream_);
+      }
+    }
+  }
+
   void ConstructTokenTreeMask(const std::vector<Sequence*>& sequences,
                               const IntTuple& token_tree_parent_ptr,
                               const std::vector<std::vector<int32_t>>& block_ids_on_depths,
@@ -2458,7 +3180,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     // - Free the pages that are fully slidden.
     while (page_idx_after_sliding > num_sink_pages) {
       if (block.page_ids[num_sink_pages] != kPagedKVCacheTempPageId) {
-        free_page_ids_.push_back(block.page_ids[num_sink_pages]);
+        FreePage(block.page_ids[num_sink_pages]);
       }
       block.page_ids.erase(block.page_ids.begin() + num_sink_pages);
       --page_idx_after_sliding;
@@ -2513,7 +3235,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
       if (free_page_ids_.empty() && seq->sliding_window_size != -1) {
         block.page_ids.push_back(kPagedKVCacheTempPageId);
       } else {
-        block.page_ids.push_back(GetFreePage());
+        block.page_ids.push_back(GetFreePage(seq->tenant_id));
       }
     }
     block.seq_length += append_length;
@@ -2524,7 +3246,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     for (int i = 0; i < static_cast<int>(block.page_ids.size()); ++i) {
       if (block.page_ids[i] == kPagedKVCacheTempPageId) {
         // Re-allocate the temporary pages after sliding window release.
-        block.page_ids[i] = GetFreePage();
+        block.page_ids[i] = GetFreePage(seq->tenant_id);
       }
     }
 
@@ -2589,7 +3311,8 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
    * - a vector of block ids together with the prefill/decode lengths
    * that attend to the blocks.
    * - a boolean indicating whether to use decode kernel on for the
-   * input blocks.
+   * input blocks. In a mixed batch, the decode kernel is only used for
+   * the leading decode sequences (see num_mixed_decode_).
    */
   std::pair<std::vector<std::pair<int32_t, int32_t>>, bool> GetChunkedBlockIds(
       const std::vector<int32_t>& block_ids, bool enable_coalesce = true) const {
@@ -2625,7 +3348,7 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     }
     double coalesce_ratio = 1.0 * page_counter_uncoalesced / page_counter_coalesced;
     // Do not coalesce and use batch decode kernel when coalesce ratio is small.
-    bool use_decode_kernel = is_decode_request_ && coalesce_ratio < 32;
+    bool use_decode_kernel = (is_decode_request_ || num_mixed_decode_ > 0) && coalesce_ratio < 32;
     return {use_decode_kernel || !enable_coalesce ? uncoalesced_block_ids : coalesced_block_ids,
             use_decode_kernel};
   }
@@ -2737,6 +3460,9 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
             attn_output, attn_scores,
             /*rotary_mode=*/rope_mode_ == RoPEMode::kInline, rotary_scale_, rotary_theta_,
             attn_score_scaling_factor, tree_attn_mn_indptr_view_[d], tree_attn_mask_view_[d]);
+      } else if (use_decode_kernel_[d] && num_mixed_decode_ > 0) {
+        MixedBatchAttentionOnDepth(d, local_layer_id, q_data, attn_output, attn_scores,
+                                   attn_score_scaling_factor);
       } else if (use_decode_kernel_[d]) {
         // Use decode kernel for depth d
         f_decode(/*depth=*/d, q_data, pages_[local_layer_id], page_indptr_on_depths_view_[d],
@@ -2763,6 +3489,46 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     }
   }
 
+  /*!
+   * \brief Compute the attention on the given depth of a mixed batch. The leading
+   * decode sequences run the decode kernel and the other sequences run the prefill
+   * kernel, each writing the rows of its own sequences in the output.
+   */
+  void MixedBatchAttentionOnDepth(int d, int64_t local_layer_id, NDArray q_data,
+                                  NDArray attn_output, NDArray attn_scores,
+                                  double attn_score_scaling_factor) {
+    int64_t num_decode = num_mixed_decode_;
+    // The decode sequences take one row each, so their rows lead the q/output rows.
+    auto f_leading = [](NDArray array, int64_t n) {
+      std::vector<int64_t> shape(array->shape, array->shape + array->ndim);
+      shape[0] = n;
+      return array.CreateView(shape, array->dtype);
+    };
+    // The indptr of the prefill sequences keeps pointing into the whole q/output.
+    auto f_trailing = [this](NDArray array, int64_t begin) {
+      return array.CreateView({array->shape[0] - begin}, array->dtype,
+                              begin * ((dtype_aux_.bits * dtype_aux_.lanes + 7) / 8));
+    };
+    f_attention_decode_(/*depth=*/d, f_leading(q_data, num_decode), pages_[local_layer_id],
+                        f_leading(page_indptr_on_depths_view_[d], num_decode + 1),
+                        page_indices_on_depths_view_[d],
+                        f_leading(length_info_on_depths_view_[d], num_decode),
+                        f_leading(k_rope_pos_offset_view_[d], num_decode),
+                        f_leading(q_rope_position_map_view_, num_decode),
+                        f_leading(attn_output, num_decode), f_leading(attn_scores, num_decode),
+                        /*rotary_mode=*/rope_mode_ == RoPEMode::kInline, rotary_scale_,
+                        rotary_theta_, attn_score_scaling_factor);
+    f_attention_prefill_(/*depth=*/d, q_data, f_trailing(qo_indptr_on_depths_view_[d], num_decode),
+                         pages_[local_layer_id],
+                         f_trailing(page_indptr_on_depths_view_[d], num_decode),
+                         page_indices_on_depths_view_[d],
+                         f_trailing(length_info_on_depths_view_[d], num_decode),
+                         f_trailing(k_rope_pos_offset_view_[d], num_decode),
+                         q_rope_position_map_view_, attn_output, attn_scores, /*causal=*/0,
+                         /*rotary_mode=*/rope_mode_ == RoPEMode::kInline, rotary_scale_,
+                         rotary_theta_, attn_score_scaling_factor);
+  }
+
   /*! \brief Synchronize the copy stream and the compute stream. */
   void ComputeStreamWaitForCopyStream() {
     if (!dirty_aux_data_device_) {
@@ -2782,6 +3548,18 @@ class PagedAttentionKVCacheObj : public AttentionKVCacheObj {
     DeviceAPI::Get(device_)->SyncStreamFromTo(device_, copy_stream_, compute_stream_);
   }
 
+  /*!
+   * \brief Make the compute stream wait for the KV transfer stream,
+   * when there is KV transfer work enqueued since the last wait.
+   */
+  void ComputeStreamWaitForKVTransferStream() {
+    if (!kv_transfer_pending_) {
+      return;
+    }
+    DeviceAPI::Get(device_)->SyncStreamFromTo(device_, kv_transfer_stream_, compute_stream_);
+    kv_transfer_pending_ = false;
+  }
+
   /*!
    * \brief Synchronize auxiliary arrays to device.
    * \note This method resets the dirty flag to false, and needs to be
@@ -2979,7 +3757,7 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create")
           page_size, num_layers, layer_id_begin_offset, num_qo_heads, num_kv_heads, head_dim,
           reserved_num_seqs, num_total_pages, prefill_chunk_size, support_sliding_window,
           RoPEMode(rope_mode), rotary_scale, rotary_theta, std::move(rope_ext_factors),  //
-          enable_kv_transfer, init->dtype, init->device,                                 //
+          enable_kv_transfer, init->dtype, init->dtype, init->device,                    //
           std::move(f_transpose_append), std::move(f_compact_copy), std::move(f_attention_prefill),
           std::move(f_attention_decode), std::move(f_attention_prefill_sliding_window),
           std::move(f_attention_decode_sliding_window), std::move(f_attention_prefill_ragged),
@@ -2996,7 +3774,7 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create")
 
 TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create_reduced")
     .set_body([](TVMArgs args, TVMRetValue* rv) {
-      CHECK(args.size() == 23 || args.size() == 24)
+      CHECK(args.size() >= 23 && args.size() <= 25)
           << "Invalid number of KV cache constructor args.";
       ShapeTuple cache_config = args[0];
       ShapeTuple layer_indptr_tuple = args[1];
@@ -3039,6 +3817,12 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create_reduced")
       if (args.size() >= 24) {
         enable_kv_transfer = args[23];
       }
+      // The optional page storage dtype, passed as a zero-dim NDArray like `init`.
+      DLDataType page_dtype = init->dtype;
+      if (args.size() >= 25) {
+        NDArray page_init = args[24];
+        page_dtype = page_init->dtype;
+      }
 
       CHECK_EQ(cache_config.size(), 5);
       int64_t reserved_num_seqs = cache_config[0];
@@ -3055,7 +3839,7 @@ TVM_REGISTER_GLOBAL("vm.builtin.paged_attention_kv_cache_create_reduced")
           page_size, num_layers, layer_id_begin_offset, num_qo_heads, num_kv_heads, head_dim,
           reserved_num_seqs, num_total_pages, prefill_chunk_size, support_sliding_window,
           RoPEMode(rope_mode), rotary_scale, rotary_theta, std::move(rope_ext_factors),  //
-          enable_kv_transfer, init->dtype, init->device,                                 //
+          enable_kv_transfer, init->dtype, page_dtype, init->device,                     //
           std::move(f_transpose_append), std::move(f_compact_copy), std::move(f_attention_prefill),
           std::move(f_attention_decode), std::move(f_attention_prefill_sliding_window),
           std::move(f_attention_decode_sliding_window), std::move(f_attention_prefill_ragged),
@@ -95,6 +95,12 @@ class RNNStateImpObj : public RNNStateObj {
   Array<Array<NDArray>> storages_;
   /*! \brief The list of ids of released seq slot for reuse. */
   std::vector<int64_t> free_slot_ids_;
+  /*!
+   * \brief The number of sequences sharing each seq slot.
+   * A forked sequence shares the slot of its parent until either of them is forwarded, when the
+   * forwarded one is moved to a copy of the slot.
+   */
+  std::vector<int64_t> slot_ref_counts_;
   /*! \brief The mapping from sequence ids to sequences. */
   std::unordered_map<int64_t, Sequence> seq_map_;
 
@@ -197,6 +203,7 @@ class RNNStateImpObj : public RNNStateObj {
     seq_map_.clear();
     ICHECK(!storages_.empty());
     free_slot_ids_.clear();
+    slot_ref_counts_.assign(reserved_num_seqs_, 0);
     for (int64_t slot_id = reserved_num_seqs_ - 1; slot_id >= 0; --slot_id) {
       free_slot_ids_.push_back(slot_id);
     }
@@ -227,6 +234,22 @@ class RNNStateImpObj : public RNNStateObj {
     cur_append_lengths_ = append_lengths;
     cur_seq_ids_ = seq_ids;
 
+    // The states of the sequences in the batch are about to be written, so the ones still
+    // sharing their slot with a forked sequence get a copy of their own.
+    for (int64_t seq_id : seq_ids) {
+      auto it = seq_map_.find(seq_id);
+      CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
+                                  << "\" cannot be found in the space state storage.";
+      int64_t slot_id = it->second.seq_slot_id;
+      if (slot_ref_counts_[slot_id] > 1) {
+        int64_t new_slot_id = GetFreeSlot();
+        CopySlot(slot_id, new_slot_id);
+        --slot_ref_counts_[slot_id];
+        it->second.seq_slot_id = new_slot_id;
+        dirty_aux_data_device_ = true;
+      }
+    }
+
     if (dirty_aux_data_device_) {
       SyncAuxArrayToDevice();
     }
@@ -327,7 +350,7 @@ class RNNStateImpObj : public RNNStateObj {
     CHECK(it != seq_map_.end()) << "The sequence \"" << seq_id
                                 << "\" cannot be found in the space state storage.";
 
-    free_slot_ids_.push_back(it->second.seq_slot_id);
+    ReleaseSlot(it->second.seq_slot_id);
     seq_map_.erase(it);
 
     dirty_aux_data_device_ = true;
@@ -340,19 +363,11 @@ class RNNStateImpObj : public RNNStateObj {
     CHECK(seq_map_.find(child_seq_id) == seq_map_.end())
         << "The child sequence \"" << child_seq_id << "\" is already in the space state storage.";
 
-    // Create a child block with the parent block pointer.
-    int64_t child_slot_id = GetFreeSlot();
-    seq_map_.insert({child_seq_id, Sequence::Fork(parent_it->second, child_slot_id)});
-
-    // Copy the parent state data to the child state data.
+    // The child shares the slot of the parent, which is copied only when either of them is
+    // forwarded while the other is alive.
     int64_t parent_slot_id = parent_it->second.seq_slot_id;
-    for (int64_t layer_id = 0; layer_id < num_layers_; ++layer_id) {
-      for (int64_t state_id = 0; state_id < num_states_per_layer_; ++state_id) {
-        DLTensor copy_src = GetStatePtrBySeq(layer_id, state_id, parent_slot_id);
-        DLTensor copy_dst = GetStatePtrBySeq(layer_id, state_id, child_slot_id);
-        NDArray::CopyFromTo(&copy_src, &copy_dst);
-      }
-    }
+    ++slot_ref_counts_[parent_slot_id];
+    seq_map_.insert({child_seq_id, Sequence::Fork(parent_it->second, parent_slot_id)});
     dirty_aux_data_device_ = true;
   }
 
@@ -378,9 +393,29 @@ class RNNStateImpObj : public RNNStateObj {
     CHECK(!free_slot_ids_.empty()) << "The Sequence slot is full, cannot accept new sequence.";
     int32_t seq_slot_id = free_slot_ids_.back();
     free_slot_ids_.pop_back();
+    slot_ref_counts_[seq_slot_id] = 1;
     return seq_slot_id;
   }
 
+  /*! \brief Drop a reference to a slot, which is freed when no sequence uses it anymore. */
+  void ReleaseSlot(int64_t seq_slot_id) {
+    ICHECK_GT(slot_ref_counts_[seq_slot_id], 0);
+    if (--slot_ref_counts_[seq_slot_id] == 0) {
+      free_slot_ids_.push_back(seq_slot_id);
+    }
+  }
+
+  /*! \brief Copy the states of all the layers and their history from a slot to another. */
+  void CopySlot(int64_t src_slot_id, int64_t dst_slot_id) {
+    for (int64_t layer_id = 0; layer_id < num_layers_; ++layer_id) {
+      for (int64_t state_id = 0; state_id < num_states_per_layer_; ++state_id) {
+        DLTensor copy_src = GetStatePtrBySeq(layer_id, state_id, src_slot_id);
+        DLTensor copy_dst = GetStatePtrBySeq(layer_id, state_id, dst_slot_id);
+        NDArray::CopyFromTo(&copy_src, &copy_dst);
+      }
+    }
+  }
+
   DLTensor GetStatePtrBySeqHistory(int64_t layer_id, int64_t state_id, int64_t seq_slot_id,
                                    int64_t history_slot_id) {
     NDArray state = storages_[layer_id][state_id];
@@ -0,0 +1,411 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/serving/engine.cc
+ * \brief A continuous batching engine running the step loop of LLM serving natively.
+ */
+#include "engine.h"
+
+#include <tvm/runtime/container/boxed_primitive.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+namespace serving {
+
+namespace {
+
+int64_t CeilDiv(int64_t a, int64_t b) { return (a + b - 1) / b; }
+
+/*! \brief The number of tokens of the request which are not forwarded yet. */
+int64_t NumRemaining(const Request& request) {
+  return static_cast<int64_t>(request.tokens.size()) - request.num_computed;
+}
+
+}  // namespace
+
+ServingEngineObj::ServingEngineObj(KVState kv_state, PackedFunc fforward, Device device,
+                                   EngineConfig config)
+    : kv_state_(std::move(kv_state)),
+      fforward_(std::move(fforward)),
+      device_(device),
+      config_(config),
+      rng_(static_cast<std::mt19937::result_type>(config.seed)) {
+  CHECK_GT(config_.max_batch_size, 0) << "ValueError: max_batch_size must be positive";
+  CHECK_GT(config_.max_num_batched_tokens, 0)
+      << "ValueError: max_num_batched_tokens must be positive";
+  CHECK_GE(config_.page_size, 0) << "ValueError: page_size must not be negative";
+  const PackedFunc* fsample = Registry::Get("vm.builtin.batch_sample_from_logits");
+  ICHECK(fsample != nullptr) << "vm.builtin.batch_sample_from_logits is not registered";
+  fsample_ = *fsample;
+}
+
+ServingEngineObj::~ServingEngineObj() { Stop(); }
+
+void ServingEngineObj::AddRequest(std::unique_ptr<Request> request) {
+  CHECK(!request->tokens.empty()) << "ValueError: The prompt of request " << request->id
+                                  << " is empty";
+  CHECK_GT(request->max_new_tokens, 0) << "ValueError: max_new_tokens must be positive";
+  request->arrival_time = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queued_.push_back(std::move(request));
+    ++num_pending_;
+  }
+  cv_.notify_one();
+}
+
+void ServingEngineObj::AbortRequest(int64_t request_id) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    aborted_.push_back(request_id);
+  }
+  cv_.notify_one();
+}
+
+void ServingEngineObj::DrainQueue() {
+  std::vector<std::unique_ptr<Request>> queued;
+  std::vector<int64_t> aborted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::swap(queued, queued_);
+    std::swap(aborted, aborted_);
+  }
+  for (std::unique_ptr<Request>& request : queued) {
+    waiting_.push_back(std::move(request));
+  }
+  for (int64_t request_id : aborted) {
+    auto match = [request_id](const std::unique_ptr<Request>& r) { return r->id == request_id; };
+    auto it_waiting = std::find_if(waiting_.begin(), waiting_.end(), match);
+    if (it_waiting != waiting_.end()) {
+      std::unique_ptr<Request> request = std::move(*it_waiting);
+      waiting_.erase(it_waiting);
+      // A waiting request has no sequence in the KV state.
+      request->callback(request->id, IntTuple(std::vector<int64_t>{}), true);
+      --num_pending_;
+      continue;
+    }
+    auto it_running = std::find_if(running_.begin(), running_.end(), match);
+    if (it_running != running_.end()) {
+      std::unique_ptr<Request> request = std::move(*it_running);
+      running_.erase(it_running);
+      request->callback(request->id, IntTuple(std::vector<int64_t>{}), true);
+      Finish(std::move(request));
+    }
+  }
+}
+
+void ServingEngineObj::Finish(std::unique_ptr<Request> request) {
+  kv_state_->RemoveSequence(request->id);
+  --num_pending_;
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++metrics_.num_finished_requests;
+}
+
+int64_t ServingEngineObj::PagesToForward(const Request& request, int64_t n) const {
+  if (config_.page_size == 0) return 0;
+  return CeilDiv(request.num_computed + n, config_.page_size) -
+         CeilDiv(request.num_computed, config_.page_size);
+}
+
+int64_t ServingEngineObj::NumAvailablePages() const {
+  if (config_.page_size == 0) return std::numeric_limits<int64_t>::max();
+  const auto* kv_cache = kv_state_.as<AttentionKVCacheObj>();
+  CHECK(kv_cache != nullptr) << "ValueError: The page size is only known for a KV cache";
+  return kv_cache->GetNumAvailablePages();
+}
+
+bool ServingEngineObj::Step() {
+  auto start = std::chrono::steady_clock::now();
+  DrainQueue();
+
+  // Preempt the latest admitted requests until the decoding ones fit in the KV cache. The
+  // preempted ones recompute their tokens when they are admitted again.
+  int64_t num_available_pages = NumAvailablePages();
+  int64_t num_preemptions = 0;
+  while (running_.size() > 1) {
+    int64_t decode_pages = 0;
+    for (const std::unique_ptr<Request>& request : running_) {
+      if (NumRemaining(*request) == 1) decode_pages += PagesToForward(*request, 1);
+    }
+    if (decode_pages <= num_available_pages) break;
+    std::unique_ptr<Request> request = std::move(running_.back());
+    running_.pop_back();
+    kv_state_->RemoveSequence(request->id);
+    request->num_computed = 0;
+    waiting_.push_front(std::move(request));
+    num_available_pages = NumAvailablePages();
+    ++num_preemptions;
+  }
+
+  std::vector<Request*> batch;
+  std::vector<int64_t> append_lengths;
+  int64_t token_budget = config_.max_num_batched_tokens;
+  int64_t num_decode_tokens = 0;
+  // The number of tokens of the request which fit in the budget and the available pages.
+  auto num_schedulable = [&](const Request& request) {
+    int64_t n = std::min(NumRemaining(request), token_budget);
+    if (config_.page_size != 0) {
+      int64_t capacity =
+          (CeilDiv(request.num_computed, config_.page_size) + num_available_pages) *
+              config_.page_size -
+          request.num_computed;
+      n = std::min(n, capacity);
+    }
+    return n;
+  };
+  auto schedule = [&](Request* request, int64_t n) {
+    batch.push_back(request);
+    append_lengths.push_back(n);
+    token_budget -= n;
+    num_available_pages -= PagesToForward(*request, n);
+  };
+  // Decoding sequences first, so that the KV cache runs them with the decode kernel.
+  for (const std::unique_ptr<Request>& request : running_) {
+    if (NumRemaining(*request) == 1 && num_schedulable(*request) == 1) {
+      schedule(request.get(), 1);
+      ++num_decode_tokens;
+    }
+  }
+  // Then the chunks of the prefills, of the running requests and of the admitted ones.
+  for (const std::unique_ptr<Request>& request : running_) {
+    if (NumRemaining(*request) > 1) {
+      int64_t n = num_schedulable(*request);
+      if (n > 0) schedule(request.get(), n);
+    }
+  }
+  while (!waiting_.empty() && static_cast<int64_t>(running_.size()) < config_.max_batch_size) {
+    int64_t n = num_schedulable(*waiting_.front());
+    if (n <= 0) break;
+    running_.push_back(std::move(waiting_.front()));
+    waiting_.pop_front();
+    kv_state_->AddSequence(running_.back()->id);
+    schedule(running_.back().get(), n);
+  }
+  if (batch.empty()) return false;
+
+  // Forward the batch.
+  int64_t num_tokens = config_.max_num_batched_tokens - token_budget;
+  NDArray input_ids = NDArray::Empty({num_tokens}, DataType::Int(32), Device{kDLCPU, 0});
+  int32_t* p_input_ids = static_cast<int32_t*>(input_ids->data);
+  std::vector<int64_t> seq_ids;
+  for (size_t i = 0; i < batch.size(); ++i) {
+    const Request& request = *batch[i];
+    p_input_ids = std::copy_n(request.tokens.begin() + request.num_computed, append_lengths[i],
+                              p_input_ids);
+    seq_ids.push_back(request.id);
+  }
+  if (device_.device_type != kDLCPU) {
+    input_ids = input_ids.CopyTo(device_);
+  }
+  kv_state_->BeginForward(IntTuple(seq_ids), IntTuple(append_lengths));
+  NDArray logits = fforward_(input_ids, kv_state_);
+  kv_state_->EndForward();
+  CHECK_EQ(logits->ndim, 2) << "ValueError: The forward function must return logits of shape "
+                            << "(num_sequences, vocab_size)";
+  CHECK_EQ(logits->shape[0], static_cast<int64_t>(batch.size()))
+      << "ValueError: The forward function must return the logits of each sequence";
+
+  // Sample the next token of the sequences whose tokens are all forwarded.
+  int64_t batch_size = static_cast<int64_t>(batch.size());
+  Device cpu{kDLCPU, 0};
+  NDArray temperature = NDArray::Empty({batch_size}, DataType::Float(32), cpu);
+  NDArray top_p = NDArray::Empty({batch_size}, DataType::Float(32), cpu);
+  NDArray top_k = NDArray::Empty({batch_size}, DataType::Int(32), cpu);
+  NDArray uniform = NDArray::Empty({batch_size}, DataType::Float(32), cpu);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  for (int64_t i = 0; i < batch_size; ++i) {
+    static_cast<float*>(temperature->data)[i] = batch[i]->temperature;
+    static_cast<float*>(top_p->data)[i] = batch[i]->top_p;
+    static_cast<int32_t*>(top_k->data)[i] = batch[i]->top_k;
+    static_cast<float*>(uniform->data)[i] = dist(rng_);
+  }
+  NDArray sampled = fsample_(logits, temperature, top_p, top_k, uniform);
+  const int32_t* p_sampled = static_cast<const int32_t*>(sampled->data);
+
+  auto now = std::chrono::steady_clock::now();
+  double first_token_ms = 0;
+  std::unordered_set<const Request*> finished;
+  for (int64_t i = 0; i < batch_size; ++i) {
+    Request* request = batch[i];
+    request->num_computed += append_lengths[i];
+    if (NumRemaining(*request) != 0) continue;
+    int32_t token = p_sampled[i];
+    request->tokens.push_back(token);
+    if (request->num_generated++ == 0) {
+      first_token_ms +=
+          std::chrono::duration<double, std::milli>(now - request->arrival_time).count();
+    }
+    bool done = request->num_generated >= request->max_new_tokens ||
+                request->stop_token_ids.count(token);
+    request->callback(request->id, IntTuple(std::vector<int64_t>{token}), done);
+    if (done) finished.insert(request);
+  }
+  for (auto it = running_.begin(); it != running_.end();) {
+    if (finished.count(it->get())) {
+      std::unique_ptr<Request> request = std::move(*it);
+      it = running_.erase(it);
+      Finish(std::move(request));
+    } else {
+      ++it;
+    }
+  }
+
+  double step_ms =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  int64_t num_prefill_tokens = num_tokens - num_decode_tokens;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++metrics_.num_steps;
+    metrics_.num_prefill_tokens += num_prefill_tokens;
+    metrics_.num_decode_tokens += num_decode_tokens;
+    metrics_.num_preemptions += num_preemptions;
+    metrics_.total_step_ms += step_ms;
+    metrics_.total_first_token_ms += first_token_ms;
+    metrics_.last_batch_size = batch_size;
+    metrics_.last_num_prefill_tokens = num_prefill_tokens;
+    metrics_.last_num_decode_tokens = num_decode_tokens;
+    metrics_.last_step_ms = step_ms;
+  }
+  if (step_callback_ != nullptr) {
+    step_callback_(batch_size, num_prefill_tokens, num_decode_tokens, step_ms);
+  }
+  return true;
+}
+
+void ServingEngineObj::Start() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!stopped_) return;
+  }
+  // The thread may have stopped by itself after an error.
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = false;
+  }
+  thread_ = std::thread([this]() {
+    bool progressed = true;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // Without progress, only new requests or aborts can unblock the waiting ones.
+        cv_.wait(lock, [&]() {
+          return stopped_ || !queued_.empty() || !aborted_.empty() ||
+                 (progressed && (!waiting_.empty() || !running_.empty()));
+        });
+        if (stopped_) break;
+      }
+      try {
+        progressed = Step();
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "The serving engine stops after an error in its step: " << e.what();
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        break;
+      }
+    }
+  });
+}
+
+void ServingEngineObj::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+Map<String, ObjectRef> ServingEngineObj::GetMetrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Map<String, ObjectRef> ret;
+  ret.Set("num_steps", Int(metrics_.num_steps));
+  ret.Set("num_prefill_tokens", Int(metrics_.num_prefill_tokens));
+  ret.Set("num_decode_tokens", Int(metrics_.num_decode_tokens));
+  ret.Set("num_finished_requests", Int(metrics_.num_finished_requests));
+  ret.Set("num_preemptions", Int(metrics_.num_preemptions));
+  ret.Set("total_step_ms", Float(metrics_.total_step_ms));
+  ret.Set("total_first_token_ms", Float(metrics_.total_first_token_ms));
+  ret.Set("last_batch_size", Int(metrics_.last_batch_size));
+  ret.Set("last_num_prefill_tokens", Int(metrics_.last_num_prefill_tokens));
+  ret.Set("last_num_decode_tokens", Int(metrics_.last_num_decode_tokens));
+  ret.Set("last_step_ms", Float(metrics_.last_step_ms));
+  return ret;
+}
+
+TVM_REGISTER_OBJECT_TYPE(ServingEngineObj);
+
+TVM_REGISTER_GLOBAL("vm.builtin.serving_engine_create")
+    .set_body_typed([](KVState kv_state, PackedFunc fforward, Device device,
+                       int64_t max_batch_size, int64_t max_num_batched_tokens, int64_t page_size,
+                       int64_t seed) {
+      EngineConfig config;
+      config.max_batch_size = max_batch_size;
+      config.max_num_batched_tokens = max_num_batched_tokens;
+      config.page_size = page_size;
+      config.seed = seed;
+      return ServingEngine(
+          make_object<ServingEngineObj>(std::move(kv_state), std::move(fforward), device, config));
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.serving_engine_add_request")
+    .set_body_typed([](ServingEngine engine, int64_t request_id, IntTuple prompt,
+                       int64_t max_new_tokens, double temperature, double top_p, int64_t top_k,
+                       IntTuple stop_token_ids, PackedFunc callback) {
+      auto request = std::make_unique<Request>();
+      request->id = request_id;
+      request->tokens.assign(prompt.begin(), prompt.end());
+      request->max_new_tokens = max_new_tokens;
+      request->temperature = static_cast<float>(temperature);
+      request->top_p = static_cast<float>(top_p);
+      request->top_k = static_cast<int32_t>(top_k);
+      request->stop_token_ids.insert(stop_token_ids.begin(), stop_token_ids.end());
+      request->callback = std::move(callback);
+      engine->AddRequest(std::move(request));
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.serving_engine_abort_request")
+    .set_body_method<ServingEngine>(&ServingEngineObj::AbortRequest);
+TVM_REGISTER_GLOBAL("vm.builtin.serving_engine_step")
+    .set_body_method<ServingEngine>(&ServingEngineObj::Step);
+TVM_REGISTER_GLOBAL("vm.builtin.serving_engine_start")
+    .set_body_method<ServingEngine>(&ServingEngineObj::Start);
+TVM_REGISTER_GLOBAL("vm.builtin.serving_engine_stop")
+    .set_body_method<ServingEngine>(&ServingEngineObj::Stop);
+TVM_REGISTER_GLOBAL("vm.builtin.serving_engine_set_step_callback")
+    .set_body_method<ServingEngine>(&ServingEngineObj::SetStepCallback);
+TVM_REGISTER_GLOBAL("vm.builtin.serving_engine_metrics")
+    .set_body_method<ServingEngine>(&ServingEngineObj::GetMetrics);
+TVM_REGISTER_GLOBAL("vm.builtin.serving_engine_num_pending_requests")
+    .set_body_method<ServingEngine>(&ServingEngineObj::NumPendingRequests);
+
+}  // namespace serving
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,191 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/serving/engine.h
+ * \brief A continuous batching engine running the step loop of LLM serving natively.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_SERVING_ENGINE_H_
+#define TVM_RUNTIME_RELAX_VM_SERVING_ENGINE_H_
+
+#include <tvm/runtime/container/map.h>
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "../kv_state.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+namespace serving {
+
+/*! \brief The scheduling limits of a serving engine. */
+struct EngineConfig {
+  /*! \brief The maximum number of sequences running in a step. */
+  int64_t max_batch_size = 32;
+  /*! \brief The maximum number of tokens forwarded in a step, which chunks the prefills. */
+  int64_t max_num_batched_tokens = 2048;
+  /*!
+   * \brief The number of tokens of a page of the KV cache, which the engine uses to keep the
+   *  pages of the running sequences within the available ones. 0 disables the accounting.
+   */
+  int64_t page_size = 0;
+  /*! \brief The seed of the random samples of the sampler. */
+  int64_t seed = 0;
+};
+
+/*! \brief A generation request, with its sampling parameters and its output stream. */
+struct Request {
+  /*! \brief The id of the request, which is also the id of its sequence in the KV state. */
+  int64_t id;
+  /*! \brief The prompt followed by the generated tokens. */
+  std::vector<int32_t> tokens;
+  /*! \brief The number of tokens whose K/V are in the KV state. */
+  int64_t num_computed = 0;
+  /*! \brief The number of generated tokens. */
+  int64_t num_generated = 0;
+  int64_t max_new_tokens;
+  float temperature;
+  float top_p;
+  int32_t top_k;
+  std::unordered_set<int32_t> stop_token_ids;
+  /*! \brief Called with (request_id, new token ids, finished) as tokens are generated. */
+  PackedFunc callback;
+  /*! \brief The time the request is added, for the time to the first token. */
+  std::chrono::steady_clock::time_point arrival_time;
+};
+
+/*! \brief The statistics of the steps of an engine. */
+struct EngineMetrics {
+  int64_t num_steps = 0;
+  int64_t num_prefill_tokens = 0;
+  int64_t num_decode_tokens = 0;
+  int64_t num_finished_requests = 0;
+  int64_t num_preemptions = 0;
+  double total_step_ms = 0;
+  double total_first_token_ms = 0;
+  /*! \brief The number of sequences, prefill tokens, decode tokens and latency of the last step */
+  int64_t last_batch_size = 0;
+  int64_t last_num_prefill_tokens = 0;
+  int64_t last_num_decode_tokens = 0;
+  double last_step_ms = 0;
+};
+
+/*!
+ * \brief A continuous batching engine on top of a KV state and a model forward function.
+ *
+ * Each step forwards one token of each decoding sequence, followed by chunks of the prompts of
+ * the prefilling sequences within the token budget, in one call of the forward function:
+ *
+ *   logits = fforward(input_ids, kv_state)
+ *
+ * where input_ids are the int32 tokens of the sequences concatenated, on the device of the
+ * engine, and logits are the float32 logits of the last token of each sequence, of shape
+ * (num_sequences, vocab_size). The engine calls BeginForward and EndForward of the KV state
+ * around the forward. Waiting requests are admitted while the batch has room, and the latest
+ * admitted requests are preempted and recomputed later when the KV cache runs out of pages.
+ *
+ * Requests are added and aborted from any thread. The steps run either in the background
+ * thread of the engine, between Start and Stop, or by calling Step, but not both at once.
+ */
+class ServingEngineObj : public Object {
+ public:
+  ServingEngineObj(KVState kv_state, PackedFunc fforward, Device device, EngineConfig config);
+  ~ServingEngineObj();
+
+  /*! \brief Queue a request, thread-safe. */
+  void AddRequest(std::unique_ptr<Request> request);
+  /*! \brief Abort a request, which is finished with no more tokens, thread-safe. */
+  void AbortRequest(int64_t request_id);
+  /*!
+   * \brief Run a step of the engine.
+   * \return Whether any sequence is forwarded.
+   */
+  bool Step();
+  /*! \brief Start running the steps in the background thread of the engine. */
+  void Start();
+  /*! \brief Stop the background thread after its current step. */
+  void Stop();
+  /*! \brief Set the function called with the metrics after each step. */
+  void SetStepCallback(PackedFunc callback) { step_callback_ = std::move(callback); }
+  /*! \return The metrics of the engine. */
+  Map<String, ObjectRef> GetMetrics() const;
+  /*! \return The number of requests not finished yet, thread-safe. */
+  int64_t NumPendingRequests() const { return num_pending_.load(); }
+
+  static constexpr const char* _type_key = "relax.vm.ServingEngine";
+  TVM_DECLARE_FINAL_OBJECT_INFO(ServingEngineObj, Object);
+
+ private:
+  /*! \brief Move the queued requests and aborts into the engine. */
+  void DrainQueue();
+  /*! \brief Remove the sequence of a request and report it finished. */
+  void Finish(std::unique_ptr<Request> request);
+  /*! \brief The number of new pages of the KV cache to forward n tokens of the request. */
+  int64_t PagesToForward(const Request& request, int64_t n) const;
+  /*! \brief The number of available pages of the KV cache, or a large number if unknown. */
+  int64_t NumAvailablePages() const;
+
+  KVState kv_state_;
+  PackedFunc fforward_;
+  Device device_;
+  EngineConfig config_;
+  PackedFunc fsample_;
+  PackedFunc step_callback_;
+  std::mt19937 rng_;
+
+  /*! \brief The requests added or aborted since the last step, guarded by mutex_. */
+  std::vector<std::unique_ptr<Request>> queued_;
+  std::vector<int64_t> aborted_;
+  /*! \brief The requests waiting to be admitted, in order of arrival. */
+  std::deque<std::unique_ptr<Request>> waiting_;
+  /*! \brief The running requests, in order of admission. */
+  std::vector<std::unique_ptr<Request>> running_;
+  std::atomic<int64_t> num_pending_{0};
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+  bool stopped_ = true;
+  EngineMetrics metrics_;
+};
+
+class ServingEngine : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(ServingEngine, ObjectRef, ServingEngineObj);
+};
+
+}  // namespace serving
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_SERVING_ENGINE_H_
@@ -0,0 +1,332 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/runtime/relax_vm/serving/request_batcher.cc
+ * \brief Coalescing of the concurrent calls of a function with a dynamic batch dimension.
+ */
+#include "request_batcher.h"
+
+#include <tvm/runtime/container/boxed_primitive.h>
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+namespace serving {
+
+namespace {
+
+/*! \brief The number of buckets of the histograms, the last of which counts the larger values. */
+constexpr int64_t kNumHistogramBuckets = 65;
+
+/*! \brief The number of bytes of one row of the batch dimension of a tensor. */
+int64_t RowBytes(const NDArray& tensor) {
+  int64_t bytes = (tensor->dtype.bits * tensor->dtype.lanes + 7) / 8;
+  for (int i = 1; i < tensor->ndim; ++i) {
+    bytes *= tensor->shape[i];
+  }
+  return bytes;
+}
+
+/*! \brief Whether two tensors only differ by the size of the batch dimension. */
+bool SameRowType(const NDArray& a, const NDArray& b) {
+  if (a->ndim != b->ndim || a.DataType() != b.DataType() ||
+      a->device.device_type != b->device.device_type ||
+      a->device.device_id != b->device.device_id) {
+    return false;
+  }
+  return std::equal(a->shape + 1, a->shape + a->ndim, b->shape + 1);
+}
+
+/*! \brief The shape of a tensor with another size of the batch dimension. */
+ShapeTuple WithRows(const NDArray& tensor, int64_t num_rows) {
+  std::vector<int64_t> shape(tensor->shape, tensor->shape + tensor->ndim);
+  shape[0] = num_rows;
+  return ShapeTuple(shape);
+}
+
+void Increment(std::vector<int64_t>* histogram, int64_t value) {
+  (*histogram)[std::min<int64_t>(value, histogram->size() - 1)] += 1;
+}
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+}  // namespace
+
+RequestBatcherObj::RequestBatcherObj(PackedFunc func, BatcherConfig config)
+    : func_(std::move(func)),
+      config_(config),
+      batch_size_histogram_(kNumHistogramBuckets, 0),
+      queue_depth_histogram_(kNumHistogramBuckets, 0) {
+  CHECK(func_ != nullptr) << "ValueError: The function of a request batcher is null";
+  CHECK_GT(config_.max_batch_size, 0) << "ValueError: max_batch_size must be positive";
+  CHECK_GE(config_.max_delay_us, 0) << "ValueError: max_delay_us must not be negative";
+  thread_ = std::thread([this]() {
+    while (true) {
+      std::vector<std::unique_ptr<BatchedRequest>> batch = NextBatch();
+      if (batch.empty()) break;
+      RunBatch(std::move(batch));
+    }
+  });
+}
+
+RequestBatcherObj::~RequestBatcherObj() { Stop(); }
+
+ObjectRef RequestBatcherObj::Call(Array<NDArray> inputs) {
+  CHECK(!inputs.empty()) << "ValueError: A batched call needs at least one input";
+  for (const NDArray& input : inputs) {
+    CHECK_GE(input->ndim, 1) << "ValueError: The inputs of a batched call need a batch dimension";
+    CHECK_EQ(input->shape[0], inputs[0]->shape[0])
+        << "ValueError: The inputs of a batched call have different batch sizes";
+  }
+  auto request = std::make_unique<BatchedRequest>();
+  request->inputs = std::move(inputs);
+  request->num_rows = request->inputs[0]->shape[0];
+  request->arrival = std::chrono::steady_clock::now();
+  std::future<ObjectRef> outputs = request->outputs.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK(!stopped_) << "ValueError: The request batcher is stopped";
+    int64_t depth = static_cast<int64_t>(queue_.size());
+    Increment(&queue_depth_histogram_, depth);
+    max_queue_depth_ = std::max(max_queue_depth_, depth + 1);
+    ++num_requests_;
+    queue_.push_back(std::move(request));
+  }
+  cv_.notify_one();
+  return outputs.get();
+}
+
+bool RequestBatcherObj::Compatible(const BatchedRequest& a, const BatchedRequest& b) {
+  if (a.inputs.size() != b.inputs.size()) return false;
+  for (size_t i = 0; i < a.inputs.size(); ++i) {
+    if (!SameRowType(a.inputs[i], b.inputs[i])) return false;
+  }
+  return true;
+}
+
+std::vector<std::unique_ptr<BatchedRequest>> RequestBatcherObj::NextBatch() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&]() { return stopped_ || !queue_.empty(); });
+  if (stopped_) return {};
+
+  // Wait for the requests batched with the oldest one, until the batch is full or the oldest one
+  // has waited for max_delay_us.
+  auto deadline = queue_.front()->arrival + std::chrono::microseconds(config_.max_delay_us);
+  auto f_num_compatible_rows = [&]() {
+    int64_t num_rows = 0;
+    for (const auto& request : queue_) {
+      if (Compatible(*queue_.front(), *request)) num_rows += request->num_rows;
+    }
+    return num_rows;
+  };
+  while (!stopped_ && f_num_compatible_rows() < config_.max_batch_size &&
+         std::chrono::steady_clock::now() < deadline) {
+    cv_.wait_until(lock, deadline);
+  }
+  if (stopped_) return {};
+
+  // Take the oldest request, and the compatible ones fitting in the batch in order of arrival.
+  std::vector<std::unique_ptr<BatchedRequest>> batch;
+  batch.push_back(std::move(queue_.front()));
+  queue_.pop_front();
+  int64_t num_rows = batch[0]->num_rows;
+  for (auto it = queue_.begin(); it != queue_.end();) {
+    if (Compatible(*batch[0], **it) && num_rows + (*it)->num_rows <= config_.max_batch_size) {
+      num_rows += (*it)->num_rows;
+      batch.push_back(std::move(*it));
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (const auto& request : batch) {
+    total_queue_ms_ += MillisecondsSince(request->arrival);
+  }
+  return batch;
+}
+
+void RequestBatcherObj::RunBatch(std::vector<std::unique_ptr<BatchedRequest>> batch) {
+  auto start = std::chrono::steady_clock::now();
+  int64_t num_rows = 0;
+  for (const auto& request : batch) {
+    num_rows += request->num_rows;
+  }
+  try {
+    // Concatenate the inputs along the batch dimension into the pooled buffers, unless the
+    // request is alone.
+    const Array<NDArray>& first_inputs = batch[0]->inputs;
+    std::vector<NDArray> inputs(first_inputs.begin(), first_inputs.end());
+    if (batch.size() > 1) {
+      pool_.resize(std::max(pool_.size(), inputs.size()));
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        NDArray& buffer = pool_[i];
+        if (!buffer.defined() || !SameRowType(buffer, inputs[i]) ||
+            buffer->shape[0] < num_rows) {
+          buffer = NDArray::Empty(WithRows(inputs[i], config_.max_batch_size),
+                                  inputs[i]->dtype, inputs[i]->device);
+        }
+        NDArray batched = buffer.CreateView(WithRows(inputs[i], num_rows), inputs[i]->dtype);
+        int64_t row_bytes = RowBytes(inputs[i]);
+        int64_t row = 0;
+        for (const auto& request : batch) {
+          const NDArray& input = request->inputs[i];
+          DLTensor rows = *batched.operator->();
+          rows.shape = const_cast<int64_t*>(input->shape);
+          rows.byte_offset += row * row_bytes;
+          NDArray::CopyFromTo(input.operator->(), &rows);
+          row += request->num_rows;
+        }
+        inputs[i] = batched;
+      }
+    }
+
+    std::vector<TVMValue> values(inputs.size());
+    std::vector<int> type_codes(inputs.size());
+    TVMArgsSetter setter(values.data(), type_codes.data());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      setter(i, inputs[i]);
+    }
+    TVMRetValue rv;
+    func_.CallPacked(TVMArgs(values.data(), type_codes.data(), inputs.size()), &rv);
+    ObjectRef outputs = rv;
+
+    // Hand each request the views of its rows of the outputs.
+    if (batch.size() == 1) {
+      batch[0]->outputs.set_value(outputs);
+    } else {
+      auto f_check_output = [&](const ObjectRef& output) {
+        const auto* tensor = output.as<NDArray::ContainerType>();
+        CHECK(tensor != nullptr && tensor->dl_tensor.ndim >= 1 &&
+              tensor->dl_tensor.shape[0] == num_rows)
+            << "ValueError: The outputs of a batched function must be tensors with the batch "
+               "dimension first, of "
+            << num_rows << " rows";
+        return GetRef<NDArray>(tensor);
+      };
+      std::vector<NDArray> tensors;
+      const auto* tuple = outputs.as<ArrayNode>();
+      if (tuple != nullptr) {
+        for (const ObjectRef& output : *tuple) {
+          tensors.push_back(f_check_output(output));
+        }
+      } else {
+        tensors.push_back(f_check_output(outputs));
+      }
+      int64_t row = 0;
+      for (const auto& request : batch) {
+        Array<NDArray> views;
+        for (NDArray& tensor : tensors) {
+          views.push_back(tensor.CreateView(WithRows(tensor, request->num_rows), tensor->dtype,
+                                            row * RowBytes(tensor)));
+        }
+        if (tuple != nullptr) {
+          request->outputs.set_value(views);
+        } else {
+          request->outputs.set_value(views[0]);
+        }
+        row += request->num_rows;
+      }
+    }
+  } catch (...) {
+    for (const auto& request : batch) {
+      request->outputs.set_exception(std::current_exception());
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++num_batches_;
+  num_rows_ += num_rows;
+  total_run_ms_ += MillisecondsSince(start);
+  Increment(&batch_size_histogram_, batch.size());
+}
+
+void RequestBatcherObj::Stop() {
+  std::deque<std::unique_ptr<BatchedRequest>> queue;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+    queue.swap(queue_);
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  for (const auto& request : queue) {
+    request->outputs.set_exception(
+        std::make_exception_ptr(Error("ValueError: The request batcher is stopped")));
+  }
+}
+
+Map<String, ObjectRef> RequestBatcherObj::GetMetrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto f_histogram = [](const std::vector<int64_t>& histogram) {
+    // Drop the empty buckets at the end.
+    size_t size = histogram.size();
+    while (size > 0 && histogram[size - 1] == 0) --size;
+    return IntTuple(histogram.begin(), histogram.begin() + size);
+  };
+  Map<String, ObjectRef> ret;
+  ret.Set("num_requests", Int(num_requests_));
+  ret.Set("num_batches", Int(num_batches_));
+  ret.Set("num_rows", Int(num_rows_));
+  ret.Set("queue_depth", Int(static_cast<int64_t>(queue_.size())));
+  ret.Set("max_queue_depth", Int(max_queue_depth_));
+  ret.Set("total_queue_ms", Float(total_queue_ms_));
+  ret.Set("total_run_ms", Float(total_run_ms_));
+  ret.Set("batch_size_histogram", f_histogram(batch_size_histogram_));
+  ret.Set("queue_depth_histogram", f_histogram(queue_depth_histogram_));
+  return ret;
+}
+
+TVM_REGISTER_OBJECT_TYPE(RequestBatcherObj);
+
+TVM_REGISTER_GLOBAL("vm.builtin.request_batcher_create")
+    .set_body_typed([](PackedFunc func, int64_t max_batch_size, int64_t max_delay_us) {
+      BatcherConfig config;
+      config.max_batch_size = max_batch_size;
+      config.max_delay_us = max_delay_us;
+      return RequestBatcher(make_object<RequestBatcherObj>(std::move(func), config));
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.request_batcher_call")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      RequestBatcher batcher = args[0];
+      Array<NDArray> inputs;
+      for (int i = 1; i < args.size(); ++i) {
+        inputs.push_back(args[i]);
+      }
+      *rv = batcher->Call(std::move(inputs));
+    });
+TVM_REGISTER_GLOBAL("vm.builtin.request_batcher_stop")
+    .set_body_method<RequestBatcher>(&RequestBatcherObj::Stop);
+TVM_REGISTER_GLOBAL("vm.builtin.request_batcher_metrics")
+    .set_body_method<RequestBatcher>(&RequestBatcherObj::GetMetrics);
+
+}  // namespace serving
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
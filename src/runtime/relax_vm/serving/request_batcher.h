@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*!
+ * \file src/runtime/relax_vm/serving/request_batcher.h
+ * \brief Coalescing of the concurrent calls of a function with a dynamic batch dimension.
+ */
+#ifndef TVM_RUNTIME_RELAX_VM_SERVING_REQUEST_BATCHER_H_
+#define TVM_RUNTIME_RELAX_VM_SERVING_REQUEST_BATCHER_H_
+
+#include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/map.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+namespace serving {
+
+/*! \brief The limits of a request batcher. */
+struct BatcherConfig {
+  /*! \brief The maximum number of rows of the batch dimension of a call. */
+  int64_t max_batch_size = 32;
+  /*! \brief The time the first request of a batch waits for the others, in microseconds. */
+  int64_t max_delay_us = 1000;
+};
+
+/*! \brief A call of a request batcher, waiting to be batched. */
+struct BatchedRequest {
+  /*! \brief The inputs, which have the batch dimension first. */
+  Array<NDArray> inputs;
+  /*! \brief The number of rows of the batch dimension. */
+  int64_t num_rows;
+  std::chrono::steady_clock::time_point arrival;
+  /*! \brief Receives the outputs of the request, or the error of its batch. */
+  std::promise<ObjectRef> outputs;
+};
+
+/*!
+ * \brief Coalesce the concurrent calls of a function whose tensors have a dynamic batch
+ *  dimension, e.g. a Relax VM function compiled with a symbolic batch size:
+ *
+ *   outputs = func(*inputs)
+ *
+ * where every input and output is a tensor whose first dimension is the batch, and the outputs
+ * are one tensor or a tuple of tensors.
+ *
+ * Each call queues a request and blocks. The background thread of the batcher waits up to
+ * max_delay_us after the first queued request for more requests with the same dtypes, devices
+ * and non-batch dimensions, up to max_batch_size rows in total. It concatenates their inputs
+ * along the batch dimension into buffers kept for the next batches, calls the function once and
+ * hands each caller the views of its rows of the outputs. A request alone in its batch is passed
+ * through without copies. Calls of the function happen on the background thread only, one at a
+ * time. As the buffers are reused, the outputs must not alias the inputs.
+ */
+class RequestBatcherObj : public Object {
+ public:
+  RequestBatcherObj(PackedFunc func, BatcherConfig config);
+  ~RequestBatcherObj();
+
+  /*! \brief Call the function on the inputs of a request in a batch, thread-safe. */
+  ObjectRef Call(Array<NDArray> inputs);
+  /*! \brief Fail the queued requests and stop the background thread. */
+  void Stop();
+  /*!
+   * \return The metrics of the batcher, including the histogram of the number of requests of
+   *  each batch, and of the queue depth seen by each request on arrival.
+   */
+  Map<String, ObjectRef> GetMetrics() const;
+
+  static constexpr const char* _type_key = "relax.vm.RequestBatcher";
+  TVM_DECLARE_FINAL_OBJECT_INFO(RequestBatcherObj, Object);
+
+ private:
+  /*! \brief Wait for the requests of the next batch, or an empty batch when stopped. */
+  std::vector<std::unique_ptr<BatchedRequest>> NextBatch();
+  /*! \brief Call the function on a batch and deliver the outputs. */
+  void RunBatch(std::vector<std::unique_ptr<BatchedRequest>> batch);
+  /*! \brief Whether two requests can be concatenated. */
+  static bool Compatible(const BatchedRequest& a, const BatchedRequest& b);
+
+  PackedFunc func_;
+  BatcherConfig config_;
+  /*! \brief The buffers the inputs are concatenated into, by input index. */
+  std::vector<NDArray> pool_;
+
+  /*! \brief The queued requests in order of arrival, guarded by mutex_. */
+  std::deque<std::unique_ptr<BatchedRequest>> queue_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+  bool stopped_ = false;
+
+  /*! \brief The metrics, guarded by mutex_. */
+  int64_t num_requests_ = 0;
+  int64_t num_batches_ = 0;
+  int64_t num_rows_ = 0;
+  int64_t max_queue_depth_ = 0;
+  double total_queue_ms_ = 0;
+  double total_run_ms_ = 0;
+  /*! \brief Index i counts the batches of i requests, the last one those of more. */
+  std::vector<int64_t> batch_size_histogram_;
+  /*! \brief Index i counts the requests finding i queued requests, the last one more. */
+  std::vector<int64_t> queue_depth_histogram_;
+};
+
+class RequestBatcher : public ObjectRef {
+ public:
+  TVM_DEFINE_MUTABLE_NOTNULLABLE_OBJECT_REF_METHODS(RequestBatcher, ObjectRef, RequestBatcherObj);
+};
+
+}  // namespace serving
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_RELAX_VM_SERVING_REQUEST_BATCHER_H_
@@ -21,14 +21,23 @@
  * \file src/runtime/relax_vm/vm.cc
  */
 #include <dlpack/dlpack.h>
+#include <tvm/runtime/device_api.h>
 #include <tvm/runtime/memory/memory_manager.h>
 #include <tvm/runtime/nvtx.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/profiling.h>
 #include <tvm/runtime/relax_vm/vm.h>
 
+#include <algorithm>
+#include <future>
+#include <mutex>
 #include <optional>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../library_module.h"
+#include "./memory_timeline.h"
 
 namespace tvm {
 namespace runtime {
@@ -195,6 +204,13 @@ struct VMFrame {
 
 class VirtualMachineImpl : public VirtualMachine {
  public:
+  ~VirtualMachineImpl() {
+    for (size_t i = 0; i < streams_.size(); ++i) {
+      if (streams_[i] != nullptr) {
+        DeviceAPI::Get(devices[i])->FreeStream(devices[i], streams_[i]);
+      }
+    }
+  }
   //---------------------------------------------------
   // Public facing functions overloading
   //---------------------------------------------------
@@ -216,12 +232,20 @@ class VirtualMachineImpl : public VirtualMachine {
   void _InvokeClosure(TVMArgs args, TVMRetValue* rv);
   void _InvokeClosureStateful(std::string func_name);
   void _SetInstrument(TVMArgs args, TVMRetValue* rv);
+  void _SetSampleInterval(int64_t interval);
+  void _SetTrustedInputs(bool trusted);
+  void _SetSpecializeHook(Optional<PackedFunc> hook, int64_t threshold);
+  void _StartMemoryTimeline();
+  std::string _StopMemoryTimeline();
   void _GetOutputArity(TVMArgs args, TVMRetValue* rv);
   void _GetOutput(TVMArgs args, TVMRetValue* rv);
   void _SetInputWithoutParamModule(TVMArgs args, TVMRetValue* rv);
   void _SetInputWithParamModule(TVMArgs args, TVMRetValue* rv);
   int _GetFunctionArity(std::string func_name);
   std::string _GetFunctionParamName(std::string func_name, int index);
+  Module _CreateExecutionContext();
+  void _SetExternalStream(int device_type, int device_id, int64_t stream);
+  void _InvokeAsync(TVMArgs args, TVMRetValue* rv);
   PackedFunc _LookupFunction(const String& name);
 
   TVM_MODULE_VTABLE_BEGIN("relax.VirtualMachine");
@@ -230,6 +254,11 @@ class VirtualMachineImpl : public VirtualMachine {
   TVM_MODULE_VTABLE_ENTRY_PACKED("invoke_closure", &VirtualMachineImpl::_InvokeClosure);
   TVM_MODULE_VTABLE_ENTRY("invoke_stateful", &VirtualMachineImpl::_InvokeClosureStateful);
   TVM_MODULE_VTABLE_ENTRY_PACKED("set_instrument", &VirtualMachineImpl::_SetInstrument);
+  TVM_MODULE_VTABLE_ENTRY("set_sample_interval", &VirtualMachineImpl::_SetSampleInterval);
+  TVM_MODULE_VTABLE_ENTRY("set_trusted_inputs", &VirtualMachineImpl::_SetTrustedInputs);
+  TVM_MODULE_VTABLE_ENTRY("set_specialize_hook", &VirtualMachineImpl::_SetSpecializeHook);
+  TVM_MODULE_VTABLE_ENTRY("start_memory_timeline", &VirtualMachineImpl::_StartMemoryTimeline);
+  TVM_MODULE_VTABLE_ENTRY("stop_memory_timeline", &VirtualMachineImpl::_StopMemoryTimeline);
   TVM_MODULE_VTABLE_ENTRY_PACKED("get_output_arity", &VirtualMachineImpl::_GetOutputArity);
   TVM_MODULE_VTABLE_ENTRY_PACKED("get_output", &VirtualMachineImpl::_GetOutput);
   TVM_MODULE_VTABLE_ENTRY_PACKED("set_input", &VirtualMachineImpl::_SetInputWithoutParamModule);
@@ -237,6 +266,10 @@ class VirtualMachineImpl : public VirtualMachine {
                                  &VirtualMachineImpl::_SetInputWithParamModule);
   TVM_MODULE_VTABLE_ENTRY("get_function_arity", &VirtualMachineImpl::_GetFunctionArity);
   TVM_MODULE_VTABLE_ENTRY("get_function_param_name", &VirtualMachineImpl::_GetFunctionParamName);
+  TVM_MODULE_VTABLE_ENTRY("create_execution_context",
+                          &VirtualMachineImpl::_CreateExecutionContext);
+  TVM_MODULE_VTABLE_ENTRY("set_external_stream", &VirtualMachineImpl::_SetExternalStream);
+  TVM_MODULE_VTABLE_ENTRY_PACKED("invoke_async", &VirtualMachineImpl::_InvokeAsync);
   TVM_MODULE_VTABLE_END_WITH_DEFAULT(&VirtualMachineImpl::_LookupFunction);
 
   //--------------------------------------------------
@@ -306,6 +339,18 @@ class VirtualMachineImpl : public VirtualMachine {
    */
   RegType InvokeBytecode(Index fidx, const std::vector<RegType>& args);
 
+  /*!
+   * \brief Create an execution context of the VM.
+   *
+   * The context is a VM that shares the executable, the constant and function
+   * pools and the allocators with this VM, and owns its call frames and a
+   * stream on each device. Invocations on different contexts of one VM can
+   * run concurrently and overlap on the device.
+   *
+   * \return The context, a VM module itself.
+   */
+  Module CreateExecutionContext();
+
  protected:
   /*!
    * \brief Get function by querying all of the current module's imports.
@@ -324,6 +369,64 @@ class VirtualMachineImpl : public VirtualMachine {
    */
   void InitFuncPool();
 
+  /*!
+   * \brief A RAII wrapper that binds the streams of an execution context to
+   * the calling thread, and restores the previous streams on exit.
+   *
+   * A VM without streams of its own runs on the external stream of a device
+   * when there is one. A context waits for the work submitted to the external
+   * stream so far on entry, and makes the external stream wait for its own work
+   * on exit, with events which do not block the host.
+   */
+  class StreamGuard {
+   public:
+    explicit StreamGuard(VirtualMachineImpl* vm) : vm_(vm) {
+      bound_.resize(vm->devices.size(), false);
+      prev_streams_.resize(vm->devices.size(), nullptr);
+      for (size_t i = 0; i < vm->devices.size(); ++i) {
+        TVMStreamHandle own = i < vm->streams_.size() ? vm->streams_[i] : nullptr;
+        auto it = vm->external_streams_.find(i);
+        if (own == nullptr && it == vm->external_streams_.end()) continue;
+        DeviceAPI* api = DeviceAPI::Get(vm->devices[i]);
+        bound_[i] = true;
+        prev_streams_[i] = api->GetCurrentStream(vm->devices[i]);
+        if (own == nullptr) {
+          api->SetStream(vm->devices[i], it->second);
+          continue;
+        }
+        api->SetStream(vm->devices[i], own);
+        if (it != vm->external_streams_.end()) {
+          api->SyncStreamFromTo(vm->devices[i], it->second, own);
+        }
+      }
+    }
+    ~StreamGuard() {
+      for (size_t i = 0; i < vm_->devices.size(); ++i) {
+        if (!bound_[i]) continue;
+        TVMStreamHandle own = i < vm_->streams_.size() ? vm_->streams_[i] : nullptr;
+        auto it = vm_->external_streams_.find(i);
+        DeviceAPI* api = DeviceAPI::Get(vm_->devices[i]);
+        if (own != nullptr && it != vm_->external_streams_.end()) {
+          api->SyncStreamFromTo(vm_->devices[i], own, it->second);
+        }
+        api->SetStream(vm_->devices[i], prev_streams_[i]);
+      }
+    }
+
+   private:
+    VirtualMachineImpl* vm_;
+    std::vector<bool> bound_;
+    std::vector<TVMStreamHandle> prev_streams_;
+  };
+
+  /*! \brief Wait for the work submitted to the streams of the execution context. */
+  void SyncStreams() {
+    for (size_t i = 0; i < streams_.size(); ++i) {
+      if (streams_[i] == nullptr) continue;
+      DeviceAPI::Get(devices[i])->StreamSync(devices[i], streams_[i]);
+    }
+  }
+
   /*!
    * \brief A RAII wrapper that pushes and pops VM frames.
    */
@@ -403,6 +506,180 @@ class VirtualMachineImpl : public VirtualMachine {
   /*! \brief Run VM dispatch loop. */
   void RunLoop();
 
+  /*! \brief Run VM dispatch loop over the bytecode in the executable. */
+  void RunBytecodeLoop();
+
+  //-------------------------------------------------
+  // Pre-decoded instruction dispatch.
+  //-------------------------------------------------
+  /*!
+   * \brief The pre-decoded form of an instruction.
+   * The dispatch loop reads these fixed-size records instead of decoding the
+   * variable-length bytecode, with the callee of each call already resolved.
+   */
+  struct DecodedInstruction {
+    /*! \brief The instruction opcode. */
+    Opcode op;
+    /*! \brief The dst register of Call, the result register of Ret or the cond register of If. */
+    RegName reg;
+    /*! \brief The jump offset of Goto or the false branch offset of If. */
+    Index pc_offset;
+    /*! \brief The begin index of the call arguments in `decoded_args_`. */
+    Index args_begin;
+    /*! \brief The number of call arguments. */
+    Index num_args;
+    /*! \brief The callee of Call if it is a PackedFunc. */
+    const PackedFuncObj* packed_func;
+    /*! \brief The C function of the callee if it is a compiled function in a library module. */
+    TVMBackendPackedCFunc c_func;
+    /*! \brief The callee of Call if it is a VM closure. */
+    const VMClosureObj* closure;
+    /*! \brief The index of the callee in the function table, naming the profiling ranges. */
+    Index func_idx;
+    /*!
+     * \brief The index of the compiled TIR function called, the callee itself or the
+     *  function called through vm.builtin.call_tir_dyn, or -1 if there is none.
+     */
+    Index tir_func_idx;
+  };
+
+  /*!
+   * \brief A pre-decoded call argument.
+   * Immediates, constants, functions and special registers are bound to their
+   * TVMValue when decoding, only the other registers are read at run time.
+   */
+  struct DecodedArg {
+    /*! \brief The register to read, or -1 if the value is bound when decoding. */
+    RegName reg;
+    /*! \brief The bound value. */
+    TVMValue value;
+    /*! \brief The type code of the bound value. */
+    int type_code;
+  };
+
+  /*!
+   * \brief Decode the instructions of the executable into `decoded_instrs_`.
+   * \note It must be invoked after the constant and function pools are initialized,
+   *  as the decoded arguments point to the values in the pools.
+   */
+  void InitDecodedInstructions();
+
+  /*!
+   * \brief Whether the pre-decoded dispatch loop can be used.
+   * The bytecode loop is used when an instrument is set, so that each call goes
+   * through RunInstrCall.
+   */
+  virtual bool UseDecodedDispatch() const {
+    return instrument_ == nullptr && !sampling_ && !decoded_instrs_.empty();
+  }
+
+  /*!
+   * \brief Invoke a call of a sampled invocation, and record its duration in
+   *  the SampledCallStats of the process.
+   * \param func_idx The index of the function called.
+   * \param args The arguments.
+   * \param rv The return value.
+   */
+  void RunSampledCall(Index func_idx, TVMArgs args, TVMRetValue* rv);
+
+  /*! \brief Run VM dispatch loop over the pre-decoded instructions. */
+  void RunDecodedLoop();
+
+  /*!
+   * \brief The shape prologue of a function: the calls at its entry which allocate the
+   *  shape heap, check the struct info of the params, match their shapes into the heap
+   *  and make shapes from it. Their effects only depend on the shape signature of the
+   *  params, so they are restored from a cache when a call has the signature of the
+   *  previous call of the function.
+   */
+  struct ShapePrologue {
+    /*! \brief The pc of the first instruction of the function. */
+    Index begin_pc;
+    /*! \brief The pc of the first instruction after the prologue. */
+    Index end_pc;
+    /*! \brief The number of params of the function. */
+    Index num_args;
+    /*! \brief The pc of the alloc_shape_heap call, or -1 if there is none. */
+    Index heap_alloc_pc{-1};
+    /*! \brief The register of the shape heap. */
+    RegName heap_reg{-1};
+    /*! \brief The registers written by the calls other than alloc_shape_heap. */
+    std::vector<RegName> result_regs;
+    /*! \brief Whether each call of the prologue is a struct info check. */
+    std::vector<bool> is_check;
+    /*! \brief Whether a call is cached. */
+    bool has_cache{false};
+    /*! \brief The shape signature of the params of the cached call. */
+    std::vector<int64_t> cached_signature;
+    /*! \brief The contents of the shape heap after the prologue of the cached call. */
+    std::vector<int64_t> cached_heap;
+    /*! \brief The values of `result_regs` after the prologue of the cached call. */
+    std::vector<RegType> cached_results;
+  };
+
+  /*!
+   * \brief Find the shape prologues of the functions into `shape_prologues_`.
+   * \note It must be invoked after the instructions are decoded.
+   */
+  void InitShapePrologues();
+
+  /*!
+   * \brief Run the shape prologue of the function of the current frame, or restore its
+   *  effects from the cache when the params have the shape signature of the cached call.
+   * \param curr_frame The current frame.
+   * \param prologue The shape prologue.
+   */
+  void RunShapePrologue(VMFrame* curr_frame, ShapePrologue* prologue);
+
+  /*!
+   * \brief Run pre-decoded call instruction.
+   * \param curr_frame The current frame.
+   * \param instr The call instruction.
+   */
+  TVM_ALWAYS_INLINE void RunDecodedCall(VMFrame* curr_frame, const DecodedInstruction& instr);
+
+  /*! \brief Hash of the argument shapes of a TIR function call. */
+  struct ShapeSignatureHash {
+    size_t operator()(const std::vector<int64_t>& signature) const {
+      size_t hash = signature.size();
+      for (int64_t value : signature) {
+        hash ^= std::hash<int64_t>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      }
+      return hash;
+    }
+  };
+
+  /*! \brief The variants of a TIR function specialized to the shapes of its arguments. */
+  struct SpecializedVariants {
+    /*! \brief The number of calls with each argument signature not specialized yet. */
+    std::unordered_map<std::vector<int64_t>, int64_t, ShapeSignatureHash> num_calls;
+    /*! \brief The specialized variants, null while compiling or when the hook declined. */
+    std::unordered_map<std::vector<int64_t>, PackedFunc, ShapeSignatureHash> variants;
+  };
+
+  /*!
+   * \brief The specialized variants of the TIR functions, indexed by function. It is shared
+   *  with the background threads of the hook, which do not keep the VM alive.
+   */
+  struct SpecializeState {
+    /*! \brief Protects the variants, which are set by the background threads. */
+    std::mutex mutex;
+    /*! \brief The variants of each function. */
+    std::unordered_map<Index, SpecializedVariants> functions;
+  };
+
+  /*!
+   * \brief Get the variant of a TIR function specialized to the shapes of the arguments of
+   *  a call, and request it from the specialize hook in the background once the shapes are
+   *  seen `specialize_threshold_` times.
+   * \param instr The call instruction, of the TIR function or of vm.builtin.call_tir_dyn.
+   * \param values The argument values of the call.
+   * \param tcodes The argument type codes of the call.
+   * \return The variant, or a null function if it is not compiled.
+   */
+  PackedFunc GetSpecializedVariant(const DecodedInstruction& instr, const TVMValue* values,
+                                   const int* tcodes);
+
   /*!
    * \brief Retrieve the name of the function identified by the given index.
    * \param idx The index into the VM executable function table.
@@ -432,6 +709,11 @@ class VirtualMachineImpl : public VirtualMachine {
    * \brief Function pool to cache functions in func_table
    */
   std::vector<TVMRetValue> func_pool_;
+  /*!
+   * \brief The C functions of the compiled functions in func_pool_, nullptr for other
+   * functions. They are invoked directly, skipping the packed function call.
+   */
+  std::vector<TVMBackendPackedCFunc> func_c_pool_;
   //--------------------------------------------------------
   // Executor interface support
   //--------------------------------------------------------
@@ -460,6 +742,45 @@ class VirtualMachineImpl : public VirtualMachine {
   RegType return_value_;
   /*!\ brief instrument function. */
   PackedFunc instrument_ = nullptr;
+  /*! \brief Sample one in this many top-level invocations, or none if 0. */
+  int64_t sample_interval_{0};
+  /*! \brief The number of top-level invocations since the interval was set. */
+  int64_t num_invocations_{0};
+  /*! \brief Whether the current invocation is sampled. */
+  bool sampling_{false};
+  /*! \brief The timeline of the allocations, created when first started. */
+  std::unique_ptr<MemoryTimeline> memory_timeline_;
+  /*! \brief The allocators replaced by the wrappers of the timeline while it records. */
+  std::vector<Allocator*> unwrapped_allocators_;
+  /*! \brief The pre-decoded instructions, indexed by pc. Empty if decoding is not possible. */
+  std::vector<DecodedInstruction> decoded_instrs_;
+  /*! \brief The arguments of the pre-decoded call instructions. */
+  std::vector<DecodedArg> decoded_args_;
+  /*! \brief The shape prologues of the functions, indexed by the pc of their entry. */
+  std::unordered_map<Index, ShapePrologue> shape_prologues_;
+  /*! \brief Whether the struct info checks of the shape prologues are skipped. */
+  bool trusted_inputs_{false};
+  /*! \brief The hook compiling the specialized variants of the TIR functions, if any. */
+  PackedFunc specialize_hook_{nullptr};
+  /*! \brief The number of calls with the same argument shapes before specializing. */
+  int64_t specialize_threshold_{0};
+  /*! \brief The specialized variants of the TIR functions. */
+  std::shared_ptr<SpecializeState> specialize_state_;
+  //------------------------------------------------------------
+  // Execution context.
+  //------------------------------------------------------------
+  /*!
+   * \brief The streams an execution context runs on, indexed like `devices`.
+   * Empty for a VM created from an executable, which runs on the current streams.
+   */
+  std::vector<TVMStreamHandle> streams_;
+  /*!
+   * \brief The streams of the caller, by index in `devices`, which the inputs are
+   * produced on and the outputs consumed on, e.g. the streams of PyTorch.
+   */
+  std::unordered_map<size_t, TVMStreamHandle> external_streams_;
+  /*! \brief Serializes the asynchronous invocations, which share the call frames. */
+  std::mutex invoke_mutex_;
 };
 
 void VirtualMachineImpl::LoadExecutable(ObjectPtr<Executable> exec) {
@@ -489,6 +810,8 @@ void VirtualMachineImpl::Init(const std::vector<Device>& devices,
   }
   // Setup function sections.
   this->InitFuncPool();
+  // Decode the instructions once the pools are ready.
+  this->InitDecodedInstructions();
 }
 
 VMFuncInfo VirtualMachineImpl::LookupVMFuncInfo(const std::string& func_name) {
@@ -554,7 +877,7 @@ void VirtualMachineImpl::InvokeClosurePacked(const ObjectRef& closure_or_packedf
   std::copy(args.values, args.values + args.size(), values.begin() + 1);
   std::copy(args.type_codes, args.type_codes + args.size(), tcodes.begin() + 1);
   {
-    NVTXScopedRange scope("RelaxVM: " + clo->func_name);
+    NVTXScopedRange scope([&]() { return "RelaxVM: " + clo->func_name; });
     clo->impl.CallPacked(TVMArgs(values.data(), tcodes.data(), args.size() + 1), rv);
   }
 }
@@ -638,10 +961,12 @@ Optional<VMClosure> VirtualMachineImpl::GetClosureInternal(const String& func_na
     PackedFunc tir_func = GetFuncFromImports("__vmtir__" + finfo.name);
     ICHECK(tir_func != nullptr) << "Cannot find underlying compiled tir function of VMTIRFunc "
                                 << finfo.name;
-    auto impl = PackedFunc([this, finfo, tir_func](TVMArgs args, TVMRetValue* rv) {
+    // NOTE: the pools are read from the ctx ptr, so that the function pool can be
+    // shared by the execution contexts of the VM.
+    auto impl = PackedFunc([finfo, tir_func](TVMArgs args, TVMRetValue* rv) {
       // Per convention, ctx ptr is a VirtualMachine*
       VirtualMachine* ctx_ptr = static_cast<VirtualMachine*>(args[0].operator void*());
-      ICHECK(ctx_ptr == this);
+      auto* vm = static_cast<VirtualMachineImpl*>(ctx_ptr);
       ICHECK_EQ(args.size() - 1, finfo.num_args)
           << "Function " << finfo.name << " expects " << finfo.num_args << " arguments";
       ICHECK_GE(finfo.register_file_size, finfo.num_args + 1);
@@ -650,8 +975,8 @@ Optional<VMClosure> VirtualMachineImpl::GetClosureInternal(const String& func_na
         reg_file[i] = args[i + 1];
       }
       void* reg_anylist_handle = reg_file.data();
-      void* const_anylist_handle = this->const_pool_.data();
-      void* func_anylist_handle = this->func_pool_.data();
+      void* const_anylist_handle = vm->const_pool_.data();
+      void* func_anylist_handle = vm->func_pool_.data();
       tir_func(static_cast<void*>(ctx_ptr), reg_anylist_handle, const_anylist_handle,
                func_anylist_handle);
       // Return value always stored after inputs.
@@ -668,6 +993,10 @@ RegType VirtualMachineImpl::InvokeBytecode(Index gf_idx, const std::vector<RegTy
   const VMFuncInfo& gfunc = exec_->func_table[gf_idx];
   ICHECK(gfunc.kind == VMFuncInfo::FuncKind::kVMFunc);
 
+  if (frames_.empty()) {
+    sampling_ = sample_interval_ > 0 && num_invocations_++ % sample_interval_ == 0;
+  }
+
   // Get the curr instr which might be a potential caller.
   Instruction curr_instr = exec_->GetInstruction(pc_);
   auto guard = PushFrame(this->pc_, gfunc);
@@ -706,6 +1035,7 @@ RegType VirtualMachineImpl::InvokeBytecode(Index gf_idx, const std::vector<RegTy
 
 void VirtualMachineImpl::InitFuncPool() {
   func_pool_.resize(exec_->func_table.size());
+  func_c_pool_.assign(exec_->func_table.size(), nullptr);
 
   for (size_t func_index = 0; func_index < exec_->func_table.size(); ++func_index) {
     const VMFuncInfo& info = exec_->func_table[func_index];
@@ -721,6 +1051,7 @@ void VirtualMachineImpl::InitFuncPool() {
           << " in either Relax VM kernel library, or in TVM runtime PackedFunc registry, or in "
              "global Relax functions of the VM executable";
       func_pool_[func_index] = func;
+      func_c_pool_[func_index] = GetBackendPackedCFunc(func);
 
     } else {
       ICHECK(info.kind == VMFuncInfo::FuncKind::kVMFunc ||
@@ -777,7 +1108,9 @@ void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
 
   ICHECK_LT(static_cast<size_t>(instr.func_idx), this->func_pool_.size());
 
-  if (instrument_ == nullptr) {
+  if (sampling_ && instrument_ == nullptr) {
+    this->RunSampledCall(instr.func_idx, args, &ret);
+  } else if (instrument_ == nullptr) {
     this->InvokeClosurePacked(func_pool_[instr.func_idx], args, &ret);
   } else {
     // insert light-weight instrument callback
@@ -817,7 +1150,430 @@ void VirtualMachineImpl::RunInstrCall(VMFrame* curr_frame, Instruction instr) {
   pc_++;
 }
 
+void VirtualMachineImpl::RunSampledCall(Index func_idx, TVMArgs args, TVMRetValue* rv) {
+  // Time the call on the device of its last tensor argument, as the profiler does.
+  Device dev{kDLCPU, 0};
+  for (int i = 0; i < args.size(); ++i) {
+    if (args.type_codes[i] == kTVMNDArrayHandle) {
+      NDArray arr = args[i];
+      dev = arr->device;
+    }
+  }
+  if (!profiling::SampledCallStats::HasAsyncTimer(dev)) {
+    this->InvokeClosurePacked(func_pool_[func_idx], args, rv);
+    return;
+  }
+  Timer timer = Timer::Start(dev);
+  this->InvokeClosurePacked(func_pool_[func_idx], args, rv);
+  timer->Stop();
+  profiling::SampledCallStats::Global()->Record(GetFuncName(func_idx), timer);
+}
+
+void VirtualMachineImpl::InitDecodedInstructions() {
+  decoded_instrs_.clear();
+  decoded_args_.clear();
+  shape_prologues_.clear();
+  decoded_instrs_.reserve(exec_->instr_offset.size());
+  for (size_t pc = 0; pc < exec_->instr_offset.size(); ++pc) {
+    Instruction instr = exec_->GetInstruction(pc);
+    DecodedInstruction decoded{instr.op, 0, 0, 0, 0, nullptr, nullptr, nullptr, -1, -1};
+    switch (instr.op) {
+      case Opcode::Call: {
+        ICHECK_LT(static_cast<size_t>(instr.func_idx), this->func_pool_.size());
+        ObjectRef callee = this->func_pool_[instr.func_idx];
+        decoded.reg = instr.dst;
+        decoded.func_idx = instr.func_idx;
+        decoded.args_begin = decoded_args_.size();
+        decoded.num_args = instr.num_args;
+        decoded.packed_func = callee.as<PackedFunc::ContainerType>();
+        decoded.c_func = this->func_c_pool_[instr.func_idx];
+        decoded.closure = callee.as<VMClosureObj>();
+        ICHECK(decoded.packed_func != nullptr || decoded.closure != nullptr)
+            << "Function expects a closure or PackedFunc ";
+        if (decoded.c_func != nullptr) {
+          decoded.tir_func_idx = instr.func_idx;
+        } else if (GetFuncName(instr.func_idx) == "vm.builtin.call_tir_dyn" &&
+                   instr.num_args > 0 &&
+                   instr.args[0].kind() == Instruction::ArgKind::kFuncIdx) {
+          decoded.tir_func_idx = instr.args[0].value();
+        }
+        for (Index i = 0; i < instr.num_args; ++i) {
+          Instruction::Arg arg = instr.args[i];
+          DecodedArg decoded_arg{-1, TVMValue(), kTVMNullptr};
+          runtime::TVMArgsSetter setter(&decoded_arg.value, &decoded_arg.type_code);
+          const TVMRetValue* pool_value = nullptr;
+          switch (arg.kind()) {
+            case Instruction::ArgKind::kRegister: {
+              if (arg.value() < Instruction::kBeginSpecialReg) {
+                decoded_arg.reg = arg.value();
+              } else if (arg.value() == Instruction::kVoidRegister) {
+                setter(0, nullptr);
+              } else {
+                ICHECK_EQ(arg.value(), Instruction::kVMRegister);
+                setter(0, static_cast<void*>(static_cast<VirtualMachine*>(this)));
+              }
+              break;
+            }
+            case Instruction::ArgKind::kImmediate: {
+              setter(0, arg.value());
+              break;
+            }
+            case Instruction::ArgKind::kConstIdx: {
+              pool_value = &this->const_pool_[arg.value()];
+              break;
+            }
+            case Instruction::ArgKind::kFuncIdx: {
+              ICHECK_LT(static_cast<size_t>(arg.value()), this->func_pool_.size());
+              pool_value = &this->func_pool_[arg.value()];
+              break;
+            }
+            default: {
+              LOG(FATAL) << "ValueError: Unknown argument kind: " << int(arg.kind());
+            }
+          }
+          if (pool_value != nullptr) {
+            if (pool_value->type_code() == kTVMBytes) {
+              // Bytes cannot be passed by value, leave the executable to the bytecode loop.
+              decoded_instrs_.clear();
+              decoded_args_.clear();
+              return;
+            }
+            setter(0, *pool_value);
+          }
+          decoded_args_.push_back(decoded_arg);
+        }
+        break;
+      }
+      case Opcode::Ret: {
+        decoded.reg = instr.result;
+        break;
+      }
+      case Opcode::Goto: {
+        decoded.pc_offset = instr.pc_offset;
+        break;
+      }
+      case Opcode::If: {
+        decoded.reg = instr.cond;
+        decoded.pc_offset = instr.false_offset;
+        break;
+      }
+    }
+    decoded_instrs_.push_back(decoded);
+  }
+  InitShapePrologues();
+}
+
+void VirtualMachineImpl::InitShapePrologues() {
+  static const std::unordered_set<std::string> kCheckFuncs = {
+      "vm.builtin.check_tensor_info", "vm.builtin.check_shape_info",
+      "vm.builtin.check_prim_value_info", "vm.builtin.check_tuple_info",
+      "vm.builtin.check_func_info"};
+  static const std::unordered_set<std::string> kShapeFuncs = {
+      "vm.builtin.match_shape", "vm.builtin.match_prim_value", "vm.builtin.make_shape",
+      "vm.builtin.make_prim_value"};
+  for (const VMFuncInfo& finfo : exec_->func_table) {
+    if (finfo.kind != VMFuncInfo::FuncKind::kVMFunc) continue;
+    ShapePrologue prologue;
+    prologue.begin_pc = finfo.start_instr;
+    prologue.num_args = finfo.num_args;
+    // The registers whose values only depend on the shape signature of the params.
+    std::unordered_set<RegName> known_regs;
+    for (Index i = 0; i < finfo.num_args; ++i) {
+      known_regs.insert(i);
+    }
+    bool has_shape_call = false;
+    Index pc = finfo.start_instr;
+    for (; pc < finfo.end_instr; ++pc) {
+      const DecodedInstruction& instr = decoded_instrs_[pc];
+      if (instr.op != Opcode::Call) break;
+      const std::string& name = GetFuncName(instr.func_idx);
+      bool is_check = kCheckFuncs.count(name);
+      bool is_heap_alloc = name == "vm.builtin.alloc_shape_heap";
+      if (!is_check && !is_heap_alloc && !kShapeFuncs.count(name)) break;
+      if (is_heap_alloc && prologue.heap_alloc_pc != -1) break;
+      const DecodedArg* args = decoded_args_.data() + instr.args_begin;
+      bool args_known = std::all_of(args, args + instr.num_args, [&](const DecodedArg& arg) {
+        return arg.reg < 0 || known_regs.count(arg.reg);
+      });
+      if (!args_known) break;
+      if (instr.reg < Instruction::kBeginSpecialReg) {
+        known_regs.insert(instr.reg);
+        if (is_heap_alloc) {
+          prologue.heap_alloc_pc = pc;
+          prologue.heap_reg = instr.reg;
+        } else {
+          prologue.result_regs.push_back(instr.reg);
+        }
+      }
+      prologue.is_check.push_back(is_check);
+      has_shape_call = has_shape_call || !is_heap_alloc;
+    }
+    if (has_shape_call) {
+      prologue.end_pc = pc;
+      shape_prologues_.emplace(prologue.begin_pc, std::move(prologue));
+    }
+  }
+}
+
+/*! \brief Append the shape signature of a param, which decides its struct info checks. */
+static void AppendShapeSignature(const RegType& value, std::vector<int64_t>* signature) {
+  int type_code = value.type_code();
+  signature->push_back(type_code);
+  if (type_code == kDLInt || type_code == kDLUInt || type_code == kDLFloat) {
+    signature->push_back(value.value().v_int64);
+  } else if (type_code == kTVMNDArrayHandle || type_code == kTVMObjectHandle) {
+    ObjectRef obj = value;
+    signature->push_back(obj->type_index());
+    if (const auto* array = obj.as<NDArray::ContainerType>()) {
+      const DLTensor& tensor = array->dl_tensor;
+      signature->push_back(tensor.ndim);
+      signature->push_back((tensor.dtype.code << 24) | (tensor.dtype.bits << 16) |
+                           tensor.dtype.lanes);
+      signature->insert(signature->end(), tensor.shape, tensor.shape + tensor.ndim);
+    } else if (const auto* shape = obj.as<ShapeTupleObj>()) {
+      signature->push_back(shape->size);
+      signature->insert(signature->end(), shape->data, shape->data + shape->size);
+    } else if (const auto* tuple = obj.as<ArrayNode>()) {
+      signature->push_back(tuple->size());
+    }
+  }
+}
+
+void VirtualMachineImpl::RunShapePrologue(VMFrame* curr_frame, ShapePrologue* prologue) {
+  std::vector<int64_t> signature;
+  for (Index i = 0; i < prologue->num_args; ++i) {
+    AppendShapeSignature(curr_frame->register_file[i], &signature);
+  }
+
+  if (prologue->has_cache && signature == prologue->cached_signature) {
+    if (prologue->heap_alloc_pc != -1) {
+      // The heap is written by the shape functions of the body, so each call has its own.
+      pc_ = prologue->heap_alloc_pc;
+      RunDecodedCall(curr_frame, decoded_instrs_[pc_]);
+      NDArray heap = curr_frame->register_file[prologue->heap_reg];
+      std::copy(prologue->cached_heap.begin(), prologue->cached_heap.end(),
+                static_cast<int64_t*>(heap->data));
+    }
+    for (size_t i = 0; i < prologue->result_regs.size(); ++i) {
+      WriteRegister(curr_frame, prologue->result_regs[i], prologue->cached_results[i]);
+    }
+    pc_ = prologue->end_pc;
+    return;
+  }
+
+  for (pc_ = prologue->begin_pc; pc_ < prologue->end_pc;) {
+    if (trusted_inputs_ && prologue->is_check[pc_ - prologue->begin_pc]) {
+      pc_++;
+      continue;
+    }
+    RunDecodedCall(curr_frame, decoded_instrs_[pc_]);
+  }
+  prologue->cached_signature = std::move(signature);
+  prologue->cached_heap.clear();
+  if (prologue->heap_alloc_pc != -1) {
+    NDArray heap = curr_frame->register_file[prologue->heap_reg];
+    const int64_t* heap_data = static_cast<const int64_t*>(heap->data);
+    prologue->cached_heap.assign(heap_data, heap_data + heap->shape[0]);
+  }
+  prologue->cached_results.clear();
+  for (RegName reg : prologue->result_regs) {
+    prologue->cached_results.push_back(curr_frame->register_file[reg]);
+  }
+  prologue->has_cache = true;
+}
+
+void VirtualMachineImpl::RunDecodedCall(VMFrame* curr_frame, const DecodedInstruction& instr) {
+  // The first slot is reserved for the VM context pointer of closure calls.
+  curr_frame->call_arg_values.resize(instr.num_args + 1);
+  curr_frame->call_arg_tcodes.resize(instr.num_args + 1);
+  TVMValue* values = curr_frame->call_arg_values.data();
+  int* tcodes = curr_frame->call_arg_tcodes.data();
+
+  runtime::TVMArgsSetter setter(values, tcodes);
+  const DecodedArg* args = decoded_args_.data() + instr.args_begin;
+  for (Index i = 0; i < instr.num_args; ++i) {
+    if (args[i].reg >= 0) {
+      setter(i + 1, curr_frame->register_file[args[i].reg]);
+    } else {
+      values[i + 1] = args[i].value;
+      tcodes[i + 1] = args[i].type_code;
+    }
+  }
+
+  TVMRetValue ret;
+  PackedFunc variant;
+  if (specialize_hook_ != nullptr && instr.tir_func_idx >= 0) {
+    variant = GetSpecializedVariant(instr, values + 1, tcodes + 1);
+  }
+  if (variant != nullptr) {
+    NVTXScopedRange scope([&]() { return GetFuncName(instr.tir_func_idx); });
+    if (instr.tir_func_idx == instr.func_idx) {
+      variant.CallPacked(TVMArgs(values + 1, tcodes + 1, instr.num_args), &ret);
+    } else {
+      // Call vm.builtin.call_tir_dyn with the variant in place of the generic function.
+      setter(1, variant);
+      instr.packed_func->CallPacked(TVMArgs(values + 1, tcodes + 1, instr.num_args), &ret);
+    }
+  } else if (instr.c_func != nullptr) {
+    NVTXScopedRange scope([&]() { return GetFuncName(instr.func_idx); });
+    TVMValue ret_value;
+    int ret_type_code = kTVMNullptr;
+    if ((*instr.c_func)(values + 1, tcodes + 1, instr.num_args, &ret_value, &ret_type_code,
+                        nullptr) != 0) {
+      TVMThrowLastError();
+    }
+    if (ret_type_code != kTVMNullptr) {
+      ret = TVMRetValue::MoveFromCHost(ret_value, ret_type_code);
+    }
+  } else if (instr.packed_func != nullptr) {
+    NVTXScopedRange scope([&]() { return GetFuncName(instr.func_idx); });
+    instr.packed_func->CallPacked(TVMArgs(values + 1, tcodes + 1, instr.num_args), &ret);
+  } else {
+    setter(0, static_cast<void*>(static_cast<VirtualMachine*>(this)));
+    NVTXScopedRange scope([&]() { return "RelaxVM: " + instr.closure->func_name; });
+    instr.closure->impl.CallPacked(TVMArgs(values, tcodes, instr.num_args + 1), &ret);
+  }
+
+  // save the return value to the register
+  // saving to special register is a NOP
+  if (instr.reg < Instruction::kBeginSpecialReg) {
+    WriteRegister(curr_frame, instr.reg, ret);
+  }
+  // increment pc
+  pc_++;
+}
+
+PackedFunc VirtualMachineImpl::GetSpecializedVariant(const DecodedInstruction& instr,
+                                                     const TVMValue* values, const int* tcodes) {
+  // The tensor args and the scalar args, which are unpacked from the trailing shape for
+  // vm.builtin.call_tir_dyn.
+  Index begin = 0;
+  Index end = instr.num_args;
+  const ShapeTupleObj* scalars = nullptr;
+  if (instr.tir_func_idx != instr.func_idx) {
+    begin = 1;
+    end = instr.num_args - 1;
+    if (end < begin || tcodes[end] != kTVMObjectHandle) return PackedFunc();
+    scalars = static_cast<const Object*>(values[end].v_handle)->as<ShapeTupleObj>();
+    if (scalars == nullptr) return PackedFunc();
+  }
+  std::vector<int64_t> signature;
+  for (Index i = begin; i < end; ++i) {
+    signature.push_back(tcodes[i]);
+    if (tcodes[i] == kTVMNDArrayHandle || tcodes[i] == kTVMDLTensorHandle) {
+      const DLTensor* tensor = static_cast<const DLTensor*>(values[i].v_handle);
+      signature.push_back(tensor->ndim);
+      signature.insert(signature.end(), tensor->shape, tensor->shape + tensor->ndim);
+    } else if (tcodes[i] == kDLInt) {
+      signature.push_back(values[i].v_int64);
+    } else {
+      // Only tensors and integers are specialized on.
+      return PackedFunc();
+    }
+  }
+  if (scalars != nullptr) {
+    signature.insert(signature.end(), scalars->data, scalars->data + scalars->size);
+  }
+
+  std::shared_ptr<SpecializeState> state = specialize_state_;
+  std::lock_guard<std::mutex> lock(state->mutex);
+  SpecializedVariants& entry = state->functions[instr.tir_func_idx];
+  auto it = entry.variants.find(signature);
+  if (it != entry.variants.end()) {
+    return it->second;
+  }
+  if (++entry.num_calls[signature] < specialize_threshold_) {
+    return PackedFunc();
+  }
+  entry.num_calls.erase(signature);
+  entry.variants[signature] = PackedFunc();
+
+  Array<ShapeTuple> tensor_shapes;
+  std::vector<int64_t> scalar_values;
+  for (Index i = begin; i < end; ++i) {
+    if (tcodes[i] == kDLInt) {
+      scalar_values.push_back(values[i].v_int64);
+    } else {
+      const DLTensor* tensor = static_cast<const DLTensor*>(values[i].v_handle);
+      tensor_shapes.push_back(ShapeTuple(tensor->shape, tensor->shape + tensor->ndim));
+    }
+  }
+  if (scalars != nullptr) {
+    scalar_values.insert(scalar_values.end(), scalars->data, scalars->data + scalars->size);
+  }
+  // The hook compiles in the background, the call runs the generic function meanwhile.
+  std::thread([state, hook = specialize_hook_, func_idx = instr.tir_func_idx,
+               name = GetFuncName(instr.tir_func_idx), signature, tensor_shapes,
+               scalars = ShapeTuple(scalar_values)]() {
+    PackedFunc variant;
+    try {
+      TVMRetValue rv = hook(name, tensor_shapes, scalars);
+      if (rv.type_code() == kTVMPackedFuncHandle) {
+        variant = rv;
+      }
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to specialize " << name << ": " << e.what();
+    }
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->functions[func_idx].variants[signature] = variant;
+  }).detach();
+  return PackedFunc();
+}
+
+void VirtualMachineImpl::RunDecodedLoop() {
+  VMFrame* curr_frame = frames_.back().get();
+  const DecodedInstruction* instrs = decoded_instrs_.data();
+  const size_t num_instrs = decoded_instrs_.size();
+
+  auto prologue_it = shape_prologues_.find(pc_);
+  if (prologue_it != shape_prologues_.end()) {
+    RunShapePrologue(curr_frame, &prologue_it->second);
+  }
+
+  while (true) {
+    ICHECK_LT(static_cast<size_t>(pc_), num_instrs) << "run into invalid section";
+    const DecodedInstruction& instr = instrs[pc_];
+    switch (instr.op) {
+      case Opcode::Call: {
+        this->RunDecodedCall(curr_frame, instr);
+        break;
+      }
+      case Opcode::Ret: {
+        return_value_ = ReadRegister(curr_frame, instr.reg);
+        if (frames_.size() > 1) {
+          // return from a local call.
+          VMFrame* parent_frame = frames_.end()[-2].get();
+          WriteRegister(parent_frame, curr_frame->caller_return_register, return_value_);
+        }
+        return;
+      }
+      case Opcode::Goto: {
+        pc_ += instr.pc_offset;
+        break;
+      }
+      case Opcode::If: {
+        int64_t cond_val = ReadRegister(curr_frame, instr.reg);
+        if (cond_val != 0) {
+          pc_++;
+        } else {
+          ICHECK_GT(instr.pc_offset, 1);
+          pc_ += instr.pc_offset;
+        }
+        break;
+      }
+    }
+  }
+}
+
 void VirtualMachineImpl::RunLoop() {
+  if (UseDecodedDispatch()) {
+    RunDecodedLoop();
+  } else {
+    RunBytecodeLoop();
+  }
+}
+
+void VirtualMachineImpl::RunBytecodeLoop() {
   VMFrame* curr_frame = frames_.back().get();
 
   while (true) {
@@ -890,6 +1646,7 @@ void VirtualMachineImpl::_SaveClosure(TVMArgs args, TVMRetValue* rv) {
 }
 
 void VirtualMachineImpl::_InvokeClosure(TVMArgs args, TVMRetValue* rv) {
+  StreamGuard stream_guard(this);
   this->InvokeClosurePacked(args[0], TVMArgs(args.values + 1, args.type_codes + 1, args.size() - 1),
                             rv);
 }
@@ -904,6 +1661,7 @@ void VirtualMachineImpl::_InvokeClosureStateful(std::string func_name) {
                << "; use `set_input` first.";
     return;
   }
+  StreamGuard stream_guard(this);
   outputs_[func_name] =
       this->InvokeClosureInternal(func_pool_[m.at(func_name)], inputs_[func_name]);
 }
@@ -921,6 +1679,85 @@ void VirtualMachineImpl::_SetInstrument(TVMArgs args, TVMRetValue* rv) {
   }
 }
 
+void VirtualMachineImpl::_SetSampleInterval(int64_t interval) {
+  CHECK_GE(interval, 0) << "ValueError: The sample interval must be non-negative, but got "
+                        << interval;
+  sample_interval_ = interval;
+  num_invocations_ = 0;
+}
+
+void VirtualMachineImpl::_SetTrustedInputs(bool trusted) { trusted_inputs_ = trusted; }
+
+void VirtualMachineImpl::_SetSpecializeHook(Optional<PackedFunc> hook, int64_t threshold) {
+  CHECK_GE(threshold, 1) << "ValueError: The specialize threshold must be positive, but got "
+                         << threshold;
+  specialize_hook_ = hook.value_or(nullptr);
+  specialize_threshold_ = threshold;
+  // The threads of the previous hook keep the previous state.
+  specialize_state_ = std::make_shared<SpecializeState>();
+}
+
+void VirtualMachineImpl::_StartMemoryTimeline() {
+  CHECK(unwrapped_allocators_.empty()) << "ValueError: The memory timeline is already recording";
+  if (memory_timeline_ == nullptr) {
+    auto call_site = [this]() -> std::pair<std::string, int64_t> {
+      if (frames_.empty()) return {"", -1};
+      for (const VMFuncInfo& info : exec_->func_table) {
+        if (info.kind == VMFuncInfo::FuncKind::kVMFunc && info.start_instr <= pc_ &&
+            pc_ < info.end_instr) {
+          return {info.name, pc_ - info.start_instr};
+        }
+      }
+      return {"", pc_};
+    };
+    memory_timeline_ = std::make_unique<MemoryTimeline>(call_site);
+  }
+  unwrapped_allocators_ = allocators;
+  for (Allocator*& allocator : allocators) {
+    allocator = memory_timeline_->Wrap(allocator);
+  }
+  memory_timeline_->Start();
+}
+
+std::string VirtualMachineImpl::_StopMemoryTimeline() {
+  CHECK(!unwrapped_allocators_.empty()) << "ValueError: The memory timeline is not recording";
+  allocators = std::move(unwrapped_allocators_);
+  unwrapped_allocators_.clear();
+  std::string events = memory_timeline_->Stop();
+
+  // The allocations of constant size, in the order the memory planner emitted them.
+  std::ostringstream os;
+  os << "{\"events\":" << events << ",\"static_allocs\":[";
+  bool first = true;
+  for (const VMFuncInfo& info : exec_->func_table) {
+    if (info.kind != VMFuncInfo::FuncKind::kVMFunc) continue;
+    int64_t token = 0;
+    for (Index pc = info.start_instr; pc < info.end_instr; ++pc) {
+      Instruction instr = exec_->GetInstruction(pc);
+      if (instr.op != Opcode::Call || instr.num_args < 4 ||
+          GetFuncName(instr.func_idx) != "vm.builtin.alloc_storage" ||
+          instr.args[1].kind() != Instruction::ArgKind::kConstIdx) {
+        continue;
+      }
+      ShapeTuple shape = const_pool_[instr.args[1].value()];
+      int64_t nbytes = 1;
+      for (int64_t dim : shape) {
+        nbytes *= dim;
+      }
+      if (instr.args[3].kind() == Instruction::ArgKind::kConstIdx) {
+        DataType dtype(const_pool_[instr.args[3].value()].operator DLDataType());
+        nbytes *= (dtype.bits() * dtype.lanes() + 7) / 8;
+      }
+      os << (first ? "" : ",") << "{\"function\":\"" << info.name
+         << "\",\"instr\":" << pc - info.start_instr << ",\"token\":" << token++
+         << ",\"nbytes\":" << nbytes << "}";
+      first = false;
+    }
+  }
+  os << "]}";
+  return os.str();
+}
+
 void VirtualMachineImpl::_GetOutputArity(TVMArgs args, TVMRetValue* rv) {
   std::string func_name = args[0];
   RegType out = LookupVMOutput(func_name);
@@ -969,12 +1806,78 @@ std::string VirtualMachineImpl::_GetFunctionParamName(std::string func_name, int
   return vm_func.param_names[index];
 }
 
+Module VirtualMachineImpl::CreateExecutionContext() {
+  ICHECK(exec_) << "The executable is not created yet.";
+  CHECK(!devices.empty()) << "ValueError: The VM must be initialized before creating a context";
+  ObjectPtr<VirtualMachineImpl> ctx = make_object<VirtualMachineImpl>();
+  ctx->exec_ = exec_;
+  ctx->imports_ = imports_;
+  ctx->devices = devices;
+  ctx->allocators = allocators;
+  // The pools hold references, the constants and functions themselves are shared.
+  ctx->const_pool_ = const_pool_;
+  ctx->func_pool_ = func_pool_;
+  ctx->func_c_pool_ = func_c_pool_;
+  // The decoded instructions bind the ctx ptr and the addresses of the pool entries.
+  ctx->InitDecodedInstructions();
+  ctx->trusted_inputs_ = trusted_inputs_;
+  ctx->streams_.resize(devices.size(), nullptr);
+  for (size_t i = 0; i < devices.size(); ++i) {
+    if (devices[i].device_type != kDLCPU) {
+      ctx->streams_[i] = DeviceAPI::Get(devices[i])->CreateStream(devices[i]);
+    }
+  }
+  return Module(ctx);
+}
+
+Module VirtualMachineImpl::_CreateExecutionContext() { return this->CreateExecutionContext(); }
+
+void VirtualMachineImpl::_SetExternalStream(int device_type, int device_id, int64_t stream) {
+  for (size_t i = 0; i < devices.size(); ++i) {
+    if (devices[i].device_type == device_type && devices[i].device_id == device_id) {
+      // -1 stands for no stream, as in the stream argument of __dlpack__.
+      if (stream == -1) {
+        external_streams_.erase(i);
+      } else {
+        external_streams_[i] = reinterpret_cast<TVMStreamHandle>(stream);
+      }
+      return;
+    }
+  }
+  LOG(FATAL) << "ValueError: The VM is not initialized on device " << device_type << ":"
+             << device_id;
+}
+
+void VirtualMachineImpl::_InvokeAsync(TVMArgs args, TVMRetValue* rv) {
+  ICHECK_GE(args.size(), 1);
+  std::string func_name = args[0];
+  VMClosure clo = this->GetClosure(func_name);
+  // Copy the arguments, they must outlive the call frame of the caller.
+  std::vector<RegType> inputs(args.size() - 1);
+  for (int i = 1; i < args.size(); ++i) {
+    inputs[i - 1] = ConvertArgToDevice(args[i], devices[0], allocators[0]);
+  }
+  std::shared_future<RegType> result = std::async(
+      std::launch::async, [self = GetRef<Module>(this), clo, inputs = std::move(inputs)]() {
+        auto* vm = const_cast<VirtualMachineImpl*>(self.as<VirtualMachineImpl>());
+        std::lock_guard<std::mutex> lock(vm->invoke_mutex_);
+        StreamGuard stream_guard(vm);
+        RegType ret = vm->InvokeClosureInternal(clo, inputs);
+        // The results are ready to be used on any stream once the future resolves.
+        vm->SyncStreams();
+        return ret;
+      });
+  // The returned function waits for the invocation and returns its result.
+  *rv = PackedFunc([result](TVMArgs args, TVMRetValue* rv) { *rv = result.get(); });
+}
+
 PackedFunc VirtualMachineImpl::_LookupFunction(const String& name) {
   if (Optional<VMClosure> opt = this->GetClosureInternal(name, true)) {
     return PackedFunc(
         [clo = opt.value(), _self = GetRef<Module>(this)](TVMArgs args, TVMRetValue* rv) -> void {
           auto* self = const_cast<VirtualMachineImpl*>(_self.as<VirtualMachineImpl>());
           ICHECK(self);
+          StreamGuard stream_guard(self);
           self->InvokeClosurePacked(clo, args, rv);
         });
   }
@@ -1043,6 +1946,11 @@ class VirtualMachineProfiler : public VirtualMachineImpl {
   }
 
  protected:
+  bool UseDecodedDispatch() const override {
+    // Calls have to go through RunInstrCall while the profiler is set up.
+    return !prof_.has_value() && VirtualMachineImpl::UseDecodedDispatch();
+  }
+
   void RunInstrCall(VMFrame* curr_frame, Instruction inst) override {
     bool profiling = false;
     if (prof_ && prof_->IsRunning()) {
@@ -299,5 +299,11 @@ TVM_REGISTER_GLOBAL("runtime.get_rocm_stream").set_body_typed([]() {
   return static_cast<void*>(ROCMThreadEntry::ThreadLocal()->stream);
 });
 
+TVM_REGISTER_GLOBAL("runtime.rocm.pci_bus_id").set_body_typed([](int device_id) -> String {
+  char bus_id[32];
+  ROCM_CALL(hipDeviceGetPCIBusId(bus_id, sizeof(bus_id), device_id));
+  return String(bus_id);
+});
+
 }  // namespace runtime
 }  // namespace tvm
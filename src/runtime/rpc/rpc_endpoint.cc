@@ -33,8 +33,13 @@
 #include <array>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -47,6 +52,169 @@
 namespace tvm {
 namespace runtime {
 
+/*!
+ * \brief A deep copy of a packed sequence received from the channel, which outlives the arena of
+ *  the event handler.
+ */
+class RPCEndpoint::PackedSeqCopy {
+ public:
+  explicit PackedSeqCopy(TVMArgs args)
+      : values_(args.values, args.values + args.size()),
+        type_codes_(args.type_codes, args.type_codes + args.size()) {
+    for (size_t i = 0; i < values_.size(); ++i) {
+      switch (type_codes_[i]) {
+        case kTVMStr: {
+          strs_.emplace_back(std::make_unique<std::string>(values_[i].v_str));
+          values_[i].v_str = strs_.back()->c_str();
+          break;
+        }
+        case kTVMBytes: {
+          auto* bytes = static_cast<TVMByteArray*>(values_[i].v_handle);
+          strs_.emplace_back(std::make_unique<std::string>(bytes->data, bytes->size));
+          byte_arrays_.emplace_back(std::make_unique<TVMByteArray>());
+          byte_arrays_.back()->data = strs_.back()->data();
+          byte_arrays_.back()->size = bytes->size;
+          values_[i].v_handle = byte_arrays_.back().get();
+          break;
+        }
+        case kTVMDLTensorHandle: {
+          auto* tensor = static_cast<DLTensor*>(values_[i].v_handle);
+          shapes_.emplace_back(
+              std::make_unique<std::vector<int64_t>>(tensor->shape, tensor->shape + tensor->ndim));
+          tensors_.emplace_back(std::make_unique<DLTensor>(*tensor));
+          tensors_.back()->shape = shapes_.back()->data();
+          values_[i].v_handle = tensors_.back().get();
+          break;
+        }
+        case kTVMObjectHandle: {
+          objects_.push_back(GetRef<ObjectRef>(static_cast<Object*>(values_[i].v_handle)));
+          break;
+        }
+        default:
+          break;
+      }
+    }
+  }
+
+  TVMArgs args() const {
+    return TVMArgs(values_.data(), type_codes_.data(), static_cast<int>(values_.size()));
+  }
+
+ private:
+  std::vector<TVMValue> values_;
+  std::vector<int> type_codes_;
+  std::vector<std::unique_ptr<std::string>> strs_;
+  std::vector<std::unique_ptr<TVMByteArray>> byte_arrays_;
+  std::vector<std::unique_ptr<std::vector<int64_t>>> shapes_;
+  std::vector<std::unique_ptr<DLTensor>> tensors_;
+  std::vector<ObjectRef> objects_;
+};
+
+/*!
+ * \brief Serializes a packet into memory, so another thread than the event loop can send it to
+ *  the channel at once.
+ */
+class RPCPacketBuffer : public dmlc::Stream {
+ public:
+  using Stream::Read;
+  using Stream::ReadArray;
+  using Stream::Write;
+  using Stream::WriteArray;
+
+  void Write(RPCCode code) { this->Write(static_cast<int32_t>(code)); }
+
+  void WriteObject(Object* obj) {
+    ICHECK(obj->IsInstance<RPCObjectRefObj>())
+        << "ValueError: Object type is not supported in RPC calling convention: "
+        << obj->GetTypeKey() << " (type_index = " << obj->type_index() << ")";
+    auto* ref = static_cast<RPCObjectRefObj*>(obj);
+    this->template Write<uint32_t>(kRuntimeRPCObjectRefTypeIndex);
+    this->template Write<int64_t>(reinterpret_cast<uint64_t>(ref->object_handle()));
+  }
+  uint64_t GetObjectBytes(Object* obj) { return sizeof(uint32_t) + sizeof(int64_t); }
+
+  void ThrowError(RPCServerStatus code) {
+    LOG(FATAL) << "RPCServerError:" << RPCServerStatusToString(code);
+  }
+  void MessageStart(uint64_t packet_nbytes) {}
+  void MessageDone() {}
+
+  /*! \return The packet, prefixed with its number of bytes. */
+  std::string Finish() {
+    RPCPacketBuffer header;
+    header.Write(static_cast<uint64_t>(data_.size()));
+    return header.data_ + data_;
+  }
+
+ private:
+  size_t Read(void* data, size_t size) final {
+    LOG(FATAL) << "RPCPacketBuffer is write only";
+    return 0;
+  }
+  size_t Write(const void* data, size_t size) final {
+    data_.append(static_cast<const char*>(data), size);
+    return size;
+  }
+
+  std::string data_;
+};
+
+/*!
+ * \brief A thread of the server which runs the multiplexed calls of one device in order.
+ */
+class RPCDeviceWorker {
+ public:
+  explicit RPCDeviceWorker(Device dev) : thread_([this, dev]() { this->Run(dev); }) {}
+
+  ~RPCDeviceWorker() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+  }
+
+  void Push(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  void Run(Device dev) {
+    if (dev.device_type != kDLCPU) {
+      if (DeviceAPI* api = DeviceAPI::Get(dev, true)) {
+        api->SetDevice(dev);
+      }
+    }
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+        if (tasks_.empty()) return;
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      try {
+        task();
+      } catch (const std::exception& e) {
+        // The connection may have closed before the return is sent.
+        LOG(WARNING) << "RPC device worker: " << e.what();
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool stop_{false};
+  std::thread thread_;
+};
+
 /*!
  * Event-driven state-machine based handlers for RPCEndpoint.
  *
@@ -58,12 +226,16 @@ namespace runtime {
 class RPCEndpoint::EventHandler : public dmlc::Stream {
  public:
   EventHandler(support::RingBuffer* reader, support::RingBuffer* writer, std::string name,
-               std::string* remote_key, std::function<void()> flush_writer)
+               std::string* remote_key, std::function<void()> flush_writer,
+               std::function<void(const std::string&)> send_packet,
+               std::function<void(uint64_t, RPCCode, TVMArgs)> set_mux_return)
       : reader_(reader),
         writer_(writer),
         name_(name),
         remote_key_(remote_key),
-        flush_writer_(flush_writer) {
+        flush_writer_(flush_writer),
+        send_packet_(send_packet),
+        set_mux_return_(set_mux_return) {
     this->Clear();
 
     if (*remote_key == "%toinit") {
@@ -170,7 +342,7 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
    * \param arg_values The argument values.
    * \param type_codes The type codes.
    */
-  void ValidateArguments(const TVMValue* arg_values, const int* type_codes, int num_args) {
+  static void ValidateArguments(const TVMValue* arg_values, const int* type_codes, int num_args) {
     TVMArgs args(arg_values, type_codes, num_args);
     for (int i = 0; i < num_args; ++i) {
       int tcode = type_codes[i];
@@ -286,6 +458,9 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
     this->arena_.RecycleAll();
   }
 
+  /*! \brief Finish the pending multiplexed calls and stop the device workers. */
+  void StopDeviceWorkers() { device_workers_.clear(); }
+
  protected:
   enum State {
     kInitHeader,
@@ -350,7 +525,11 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
     RPCCode code = RPCCode::kNone;
     this->Read(&code);
 
-    if (code >= RPCCode::kSyscallCodeStart) {
+    if (code == RPCCode::kMuxCallFunc) {
+      this->HandleMuxCallFunc();
+    } else if (code == RPCCode::kMuxReturn) {
+      this->HandleMuxReturn();
+    } else if (code >= RPCCode::kSyscallCodeStart) {
       this->HandleSyscall(code);
     } else {
       switch (code) {
@@ -552,6 +731,87 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
         });
   }
 
+  // Handle for a packed call tagged with a request id.
+  void HandleMuxCallFunc() {
+    uint64_t request_id;
+    Device dev;
+    uint64_t call_handle;
+
+    this->Read(&request_id);
+    this->Read(&dev);
+    this->Read(&call_handle);
+    auto args = std::make_shared<RPCEndpoint::PackedSeqCopy>(RecvPackedSeq());
+    this->SwitchToState(kRecvPacketNumBytes);
+
+    std::shared_ptr<RPCSession> sess = serving_session_;
+    ICHECK(sess != nullptr) << "Need to call InitRemoteSession first before any further actions";
+    if (async_server_mode_ || !sess->IsLocalSession()) {
+      // The event driven servers and the proxies run the call in the event loop.
+      std::string packet = RunMuxCall(sess.get(), request_id, call_handle, args->args());
+      this->WriteArray(packet.data(), packet.size());
+      return;
+    }
+    std::pair<int, int> key(static_cast<int>(dev.device_type), dev.device_id);
+    std::unique_ptr<RPCDeviceWorker>& worker = device_workers_[key];
+    if (worker == nullptr) {
+      worker = std::make_unique<RPCDeviceWorker>(dev);
+    }
+    auto send_packet = send_packet_;
+    worker->Push([sess, args, request_id, call_handle, send_packet]() {
+      send_packet(RunMuxCall(sess.get(), request_id, call_handle, args->args()));
+    });
+  }
+
+  // Run a multiplexed call and encode its return packet.
+  static std::string RunMuxCall(RPCSession* sess, uint64_t request_id, uint64_t call_handle,
+                                TVMArgs args) {
+    auto packet_start = [request_id]() {
+      RPCPacketBuffer packet;
+      packet.Write(RPCCode::kMuxReturn);
+      packet.Write(request_id);
+      return packet;
+    };
+    RPCPacketBuffer packet = packet_start();
+    try {
+      bool returned = false;
+      sess->CallFunc(reinterpret_cast<void*>(call_handle), args.values, args.type_codes,
+                     args.size(), [&packet, &returned](TVMArgs encoded_args) {
+                       ValidateArguments(encoded_args.values, encoded_args.type_codes,
+                                         encoded_args.size());
+                       packet.Write(RPCCode::kReturn);
+                       RPCReference::SendPackedSeq(encoded_args.values, encoded_args.type_codes,
+                                                   encoded_args.size(), false, &packet);
+                       returned = true;
+                     });
+      if (!returned) {
+        TVMValue value;
+        int tcode = kTVMNullptr;
+        packet.Write(RPCCode::kReturn);
+        RPCReference::SendPackedSeq(&value, &tcode, 1, false, &packet);
+      }
+    } catch (const std::exception& e) {
+      packet = packet_start();
+      TVMValue value;
+      int tcode = kTVMStr;
+      value.v_str = e.what();
+      packet.Write(RPCCode::kException);
+      RPCReference::SendPackedSeq(&value, &tcode, 1, false, &packet);
+    }
+    return packet.Finish();
+  }
+
+  // Handle for the return of a multiplexed call.
+  void HandleMuxReturn() {
+    uint64_t request_id;
+    RPCCode status;
+
+    this->Read(&request_id);
+    this->Read(&status);
+    TVMArgs args = RecvPackedSeq();
+    set_mux_return_(request_id, status, args);
+    this->SwitchToState(kRecvPacketNumBytes);
+  }
+
   void HandleInitServer() {
     std::string client_protocol_ver;
 
@@ -686,6 +946,12 @@ class RPCEndpoint::EventHandler : public dmlc::Stream {
   std::string* remote_key_;
   // function to flush the writer.
   std::function<void()> flush_writer_;
+  // function to send a packet from the device workers.
+  std::function<void(const std::string&)> send_packet_;
+  // function to receive the return of a multiplexed call.
+  std::function<void(uint64_t, RPCCode, TVMArgs)> set_mux_return_;
+  // The workers running the multiplexed calls, by device.
+  std::map<std::pair<int, int>, std::unique_ptr<RPCDeviceWorker>> device_workers_;
 };
 
 RPCCode RPCEndpoint::HandleUntilReturnEvent(bool client_mode, RPCSession::FEncodeReturn setreturn) {
@@ -694,11 +960,7 @@ RPCCode RPCEndpoint::HandleUntilReturnEvent(bool client_mode, RPCSession::FEncod
   CHECK(channel_) << "Expected connection to server " << name_
                   << " to be active, but the connection was previously closed";
   while (code != RPCCode::kReturn && code != RPCCode::kShutdown && code != RPCCode::kCopyAck) {
-    while (writer_.bytes_available() != 0) {
-      writer_.ReadWithCallback(
-          [this](const void* data, size_t size) { return channel_->Send(data, size); },
-          writer_.bytes_available());
-    }
+    FlushWriter();
     size_t bytes_needed = handler_->BytesNeeded();
     if (bytes_needed != 0) {
       size_t n = reader_.WriteWithCallback(
@@ -716,9 +978,62 @@ RPCCode RPCEndpoint::HandleUntilReturnEvent(bool client_mode, RPCSession::FEncod
   return code;
 }
 
+void RPCEndpoint::FlushWriter() {
+  std::lock_guard<std::mutex> lock(send_mutex_);
+  FlushWriterLocked();
+}
+
+void RPCEndpoint::FlushWriterLocked() {
+  while (writer_.bytes_available() != 0) {
+    writer_.ReadWithCallback(
+        [this](const void* data, size_t size) { return channel_->Send(data, size); },
+        writer_.bytes_available());
+  }
+}
+
+void RPCEndpoint::HandleUntilMuxReturn(uint64_t request_id) {
+  CHECK(channel_) << "Expected connection to server " << name_
+                  << " to be active, but the connection was previously closed";
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(mux_mutex_);
+      if (mux_returns_.count(request_id)) return;
+    }
+    FlushWriter();
+    size_t bytes_needed = handler_->BytesNeeded();
+    if (bytes_needed != 0) {
+      size_t n = reader_.WriteWithCallback(
+          [this](void* data, size_t size) { return channel_->Recv(data, size); }, bytes_needed);
+      ICHECK_NE(n, 0U) << "Channel closes before we get the return of a multiplexed call";
+    }
+    RPCCode code = handler_->HandleNextEvent(true, false, nullptr);
+    ICHECK(code == RPCCode::kNone) << "Unexpected " << RPCCodeToString(code)
+                                   << " while waiting for the return of a multiplexed call";
+  }
+}
+
+void RPCEndpoint::SetMuxReturn(uint64_t request_id, RPCCode status, TVMArgs args) {
+  {
+    std::lock_guard<std::mutex> lock(mux_mutex_);
+    mux_returns_[request_id] = {status, std::make_shared<PackedSeqCopy>(args)};
+  }
+  mux_cv_.notify_all();
+}
+
+void RPCEndpoint::SendPacket(const std::string& packet) {
+  std::lock_guard<std::mutex> lock(send_mutex_);
+  size_t sent_bytes = 0;
+  while (sent_bytes < packet.size()) {
+    size_t n = channel_->Send(packet.data() + sent_bytes, packet.size() - sent_bytes);
+    ICHECK_NE(n, 0U) << "Channel closes before the packet is sent";
+    sent_bytes += n;
+  }
+}
+
 void RPCEndpoint::Init() {
   // callback to flush the writer.
   auto flush_writer = [this]() {
+    std::lock_guard<std::mutex> lock(send_mutex_);
     while (writer_.bytes_available() != 0) {
       size_t n = writer_.ReadWithCallback(
           [this](const void* data, size_t size) { return channel_->Send(data, size); },
@@ -728,7 +1043,12 @@ void RPCEndpoint::Init() {
   };
 
   // Event handler
-  handler_ = std::make_shared<EventHandler>(&reader_, &writer_, name_, &remote_key_, flush_writer);
+  handler_ = std::make_shared<EventHandler>(
+      &reader_, &writer_, name_, &remote_key_, flush_writer,
+      [this](const std::string& packet) { this->SendPacket(packet); },
+      [this](uint64_t request_id, RPCCode status, TVMArgs args) {
+        this->SetMuxReturn(request_id, status, args);
+      });
 
   // Quick function to for syscall remote.
   syscall_remote_ = PackedFunc([this](TVMArgs all_args, TVMRetValue* rv) {
@@ -776,6 +1096,7 @@ std::shared_ptr<RPCEndpoint> RPCEndpoint::Create(std::unique_ptr<RPCChannel> cha
 RPCEndpoint::~RPCEndpoint() { this->Shutdown(); }
 
 void RPCEndpoint::Shutdown() {
+  handler_->StopDeviceWorkers();
   if (channel_ != nullptr) {
     RPCCode code = RPCCode::kShutdown;
     uint64_t packet_nbytes = sizeof(code);
@@ -785,6 +1106,7 @@ void RPCEndpoint::Shutdown() {
 
     // flush all writing buffer to output channel.
     try {
+      std::lock_guard<std::mutex> lock(send_mutex_);
       while (writer_.bytes_available() != 0) {
         size_t n = writer_.ReadWithCallback(
             [this](const void* data, size_t size) { return channel_->Send(data, size); },
@@ -803,6 +1125,7 @@ void RPCEndpoint::ServerLoop() {
   }
   TVMRetValue rv;
   ICHECK(HandleUntilReturnEvent(false, [](TVMArgs) {}) == RPCCode::kShutdown);
+  handler_->StopDeviceWorkers();
   if (const auto* f = Registry::Get("tvm.rpc.server.shutdown")) {
     (*f)();
   }
@@ -871,8 +1194,137 @@ void RPCEndpoint::CallFunc(RPCSession::PackedFuncHandle h, const TVMValue* arg_v
   ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
 }
 
+void RPCEndpoint::CallFuncOnDevice(RPCSession::PackedFuncHandle h, Device dev,
+                                   const TVMValue* arg_values, const int* arg_type_codes,
+                                   int num_args, RPCSession::FEncodeReturn encode_return) {
+  handler_->ValidateArguments(arg_values, arg_type_codes, num_args);
+  uint64_t request_id = next_request_id_++;
+  uint64_t handle = reinterpret_cast<uint64_t>(h);
+
+  // The packet is sent without the read lock, so the calls of other threads can be in flight.
+  RPCPacketBuffer packet;
+  packet.Write(RPCCode::kMuxCallFunc);
+  packet.Write(request_id);
+  packet.Write(dev);
+  packet.Write(handle);
+  RPCReference::SendPackedSeq(arg_values, arg_type_codes, num_args, true, &packet);
+  SendPacket(packet.Finish());
+
+  // Whichever waiting thread holds the read lock receives the returns of all the threads.
+  std::unique_lock<std::mutex> mux_lock(mux_mutex_);
+  while (!mux_returns_.count(request_id)) {
+    if (mutex_.try_lock()) {
+      mux_lock.unlock();
+      try {
+        HandleUntilMuxReturn(request_id);
+      } catch (...) {
+        mutex_.unlock();
+        mux_cv_.notify_all();
+        throw;
+      }
+      mutex_.unlock();
+      mux_cv_.notify_all();
+      mux_lock.lock();
+    } else {
+      // The reader may be a regular call, which does not notify when it releases the lock.
+      mux_cv_.wait_for(mux_lock, std::chrono::milliseconds(1));
+    }
+  }
+  auto ret = std::move(mux_returns_[request_id]);
+  mux_returns_.erase(request_id);
+  mux_lock.unlock();
+
+  TVMArgs args = ret.second->args();
+  if (ret.first == RPCCode::kException) {
+    String msg = args[0];
+    if (!support::StartsWith(msg, "RPCSessionTimeoutError: ")) {
+      msg = "RPCError: Error caught from RPC call:\n" + msg;
+    }
+    LOG(FATAL) << msg;
+  }
+  encode_return(args);
+}
+
+void RPCEndpoint::CallBatch(const std::vector<RPCBatchOp>& ops,
+                            RPCSession::FEncodeReturn encode_return) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  RPCCode code = RPCCode::kBatch;
+  int32_t num_ops = static_cast<int32_t>(ops.size());
+  uint64_t packet_nbytes = sizeof(code) + sizeof(num_ops);
+  for (const RPCBatchOp& op : ops) {
+    int num_args = static_cast<int>(op.arg_values.size());
+    ICHECK_EQ(op.arg_type_codes.size(), op.arg_values.size());
+    if (op.code == RPCCode::kCopyToRemote) {
+      packet_nbytes += RemoteCopyCalculatePacketOverheadSize(op.to, op.code, op.nbytes) + op.nbytes;
+    } else {
+      CHECK(op.code == RPCCode::kCallFunc ||
+            (op.code >= RPCCode::kSyscallCodeStart && op.code < RPCCode::kMuxCallFunc))
+          << "ValueError: Cannot run " << RPCCodeToString(op.code) << " in a batch";
+      handler_->ValidateArguments(op.arg_values.data(), op.arg_type_codes.data(), num_args);
+      packet_nbytes += sizeof(op.code) +
+                       handler_->PackedSeqGetNumBytes(op.arg_values.data(),
+                                                      op.arg_type_codes.data(), num_args, true);
+      if (op.code == RPCCode::kCallFunc) packet_nbytes += sizeof(uint64_t);
+    }
+    packet_nbytes += sizeof(int32_t) + op.refs.size() * 2 * sizeof(int32_t);
+  }
+
+  handler_->Write(packet_nbytes);
+  handler_->Write(code);
+  handler_->Write(num_ops);
+  for (const RPCBatchOp& op : ops) {
+    handler_->Write(op.code);
+    if (op.code == RPCCode::kCopyToRemote) {
+      RPCReference::SendDLTensor(handler_, op.to);
+      handler_->Write(op.nbytes);
+      handler_->WriteArray(static_cast<const char*>(op.from_bytes), op.nbytes);
+    } else {
+      if (op.code == RPCCode::kCallFunc) {
+        handler_->Write(reinterpret_cast<uint64_t>(op.func));
+      }
+      handler_->SendPackedSeq(op.arg_values.data(), op.arg_type_codes.data(),
+                              static_cast<int>(op.arg_values.size()), true);
+    }
+    handler_->Write(static_cast<int32_t>(op.refs.size()));
+    for (const auto& ref : op.refs) {
+      handler_->Write(ref.first);
+      handler_->Write(ref.second);
+    }
+  }
+
+  code = HandleUntilReturnEvent(true, encode_return);
+  ICHECK(code == RPCCode::kReturn) << "code=" << RPCCodeToString(code);
+}
+
 void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
   std::lock_guard<std::mutex> lock(mutex_);
+  SendCopyToRemote(from_bytes, to, nbytes);
+  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+}
+
+void RPCEndpoint::CopyToRemoteWindowed(void* from_bytes, DLTensor* to, uint64_t nbytes,
+                                       uint64_t block_size, int window) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ICHECK_GT(block_size, 0U) << "CopyToRemote: Invalid block size!";
+  ICHECK_GT(window, 0) << "CopyToRemote: Invalid window size!";
+  uint64_t offset = 0;
+  int num_in_flight = 0;
+  // The server handles the packets in order, so the chunks can be sent before the previous
+  // returns arrive. The transfer of a chunk then overlaps with the device copy of the previous.
+  while (offset < nbytes || num_in_flight != 0) {
+    while (offset < nbytes && num_in_flight < window) {
+      uint64_t chunk_bytes = std::min(block_size, nbytes - offset);
+      to->byte_offset = offset;
+      SendCopyToRemote(static_cast<char*>(from_bytes) + offset, to, chunk_bytes);
+      offset += chunk_bytes;
+      ++num_in_flight;
+    }
+    ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+    --num_in_flight;
+  }
+}
+
+void RPCEndpoint::SendCopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes) {
   RPCCode code = RPCCode::kCopyToRemote;
 
   uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*to));
@@ -887,12 +1339,52 @@ void RPCEndpoint::CopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes)
   handler_->Write(code);
   RPCReference::SendDLTensor(handler_, to);
   handler_->Write(nbytes);
-  handler_->WriteArray(reinterpret_cast<char*>(from_bytes), nbytes);
-  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kReturn);
+  // Send the payload straight from the host memory instead of staging it in the writer.
+  std::lock_guard<std::mutex> lock(send_mutex_);
+  FlushWriterLocked();
+  const char* data = static_cast<const char*>(from_bytes);
+  uint64_t sent_bytes = 0;
+  while (sent_bytes < nbytes) {
+    size_t n = channel_->Send(data + sent_bytes, nbytes - sent_bytes);
+    ICHECK_NE(n, 0U) << "Channel closes before the copy payload is sent";
+    sent_bytes += n;
+  }
 }
 
 void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes) {
   std::lock_guard<std::mutex> lock(mutex_);
+  SendCopyFromRemote(from, nbytes);
+  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
+
+  handler_->ReadArray(reinterpret_cast<char*>(to_bytes), nbytes);
+  handler_->FinishCopyAck();
+}
+
+void RPCEndpoint::CopyFromRemoteWindowed(DLTensor* from, void* to_bytes, uint64_t nbytes,
+                                         uint64_t block_size, int window) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ICHECK_GT(block_size, 0U) << "CopyFromRemote: Invalid block size!";
+  ICHECK_GT(window, 0) << "CopyFromRemote: Invalid window size!";
+  uint64_t request_offset = 0;
+  uint64_t recv_offset = 0;
+  // The copy acks come back in the order of the requests.
+  while (recv_offset < nbytes) {
+    while (request_offset < nbytes &&
+           request_offset - recv_offset < block_size * static_cast<uint64_t>(window)) {
+      uint64_t chunk_bytes = std::min(block_size, nbytes - request_offset);
+      from->byte_offset = request_offset;
+      SendCopyFromRemote(from, chunk_bytes);
+      request_offset += chunk_bytes;
+    }
+    uint64_t chunk_bytes = std::min(block_size, nbytes - recv_offset);
+    ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
+    handler_->ReadArray(static_cast<char*>(to_bytes) + recv_offset, chunk_bytes);
+    handler_->FinishCopyAck();
+    recv_offset += chunk_bytes;
+  }
+}
+
+void RPCEndpoint::SendCopyFromRemote(DLTensor* from, uint64_t nbytes) {
   RPCCode code = RPCCode::kCopyFromRemote;
 
   uint64_t tensor_total_size_bytes = static_cast<uint64_t>(GetDataSize(*from));
@@ -907,10 +1399,6 @@ void RPCEndpoint::CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes
   handler_->Write(code);
   RPCReference::SendDLTensor(handler_, from);
   handler_->Write(nbytes);
-  ICHECK(HandleUntilReturnEvent(true, [](TVMArgs) {}) == RPCCode::kCopyAck);
-
-  handler_->ReadArray(reinterpret_cast<char*>(to_bytes), nbytes);
-  handler_->FinishCopyAck();
 }
 
 // SysCallEventHandler functions
@@ -1084,59 +1572,34 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
 
   void CallFunc(PackedFuncHandle func, const TVMValue* arg_values, const int* arg_type_codes,
                 int num_args, const FEncodeReturn& fencode_return) final {
-    endpoint_->CallFunc(func, arg_values, arg_type_codes, num_args, fencode_return);
+    Device dev;
+    if (multiplex_ && FindCallDevice(arg_values, arg_type_codes, num_args, &dev) &&
+        SupportsMultiplex()) {
+      endpoint_->CallFuncOnDevice(func, dev, arg_values, arg_type_codes, num_args,
+                                  fencode_return);
+    } else {
+      endpoint_->CallFunc(func, arg_values, arg_type_codes, num_args, fencode_return);
+    }
   }
 
+  /*!
+   * \brief Set whether the calls which take a device or a tensor are multiplexed, so the calls of
+   *  different devices from several threads run concurrently on the remote.
+   */
+  void SetMultiplex(bool multiplex) { multiplex_ = multiplex; }
+
   void CopyToRemote(void* local_from_bytes, DLTensor* remote_to, uint64_t nbytes) final {
     RPCCode code = RPCCode::kCopyToRemote;
     uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_to, code, nbytes);
-    uint64_t rpc_max_size = GetRPCMaxTransferSize();
-    ICHECK_GT(rpc_max_size, overhead) << "CopyToRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* from_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, block_size);
-    }
-
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_to->byte_offset = block_count * block_size;
-      from_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_from_bytes) + block_count * block_size));
-      endpoint_->CopyToRemote(from_bytes, remote_to, remainder_bytes);
-    }
+    endpoint_->CopyToRemoteWindowed(local_from_bytes, remote_to, nbytes,
+                                    GetCopyBlockSize(overhead), GetCopyWindow());
   }
 
   void CopyFromRemote(DLTensor* remote_from, void* local_to_bytes, uint64_t nbytes) final {
     RPCCode code = RPCCode::kCopyFromRemote;
     uint64_t overhead = RemoteCopyCalculatePacketOverheadSize(remote_from, code, nbytes);
-    uint64_t rpc_max_size = GetRPCMaxTransferSize();
-    ICHECK_GT(rpc_max_size, overhead) << "CopyFromRemote: Invalid block size!";
-    const uint64_t block_size = rpc_max_size - overhead;
-    uint64_t block_count = 0;
-    const uint64_t num_blocks = nbytes / block_size;
-    void* to_bytes;
-
-    for (block_count = 0; block_count < num_blocks; block_count++) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, block_size);
-    }
-
-    const uint64_t remainder_bytes = nbytes % block_size;
-    if (remainder_bytes != 0) {
-      remote_from->byte_offset = block_count * block_size;
-      to_bytes = reinterpret_cast<void*>(
-          (reinterpret_cast<uint8_t*>(local_to_bytes) + block_count * block_size));
-      endpoint_->CopyFromRemote(remote_from, to_bytes, remainder_bytes);
-    }
+    endpoint_->CopyFromRemoteWindowed(remote_from, local_to_bytes, nbytes,
+                                      GetCopyBlockSize(overhead), GetCopyWindow());
   }
 
   void FreeHandle(void* handle, int type_code) final {
@@ -1232,14 +1695,90 @@ class RPCClientSession : public RPCSession, public DeviceAPI {
     return (uint64_t)rpc_chunk_max_size_bytes_;
   }
 
+  /*!
+   * \brief Get the number of payload bytes of a copy chunk.
+   * \param overhead The packet overhead of a copy chunk.
+   */
+  uint64_t GetCopyBlockSize(uint64_t overhead) {
+    uint64_t rpc_max_size = GetRPCMaxTransferSize();
+    if (rpc_max_size != kRPCMaxTransferSizeBytesDefault) {
+      // The remote limits the packet size, e.g. a microTVM device.
+      ICHECK_GT(rpc_max_size, overhead) << "Copy: Invalid block size!";
+      return rpc_max_size - overhead;
+    }
+    return static_cast<uint64_t>(
+        GetEnvInt64("TVM_RPC_COPY_CHUNK_BYTES", kRPCCopyChunkBytesDefault));
+  }
+
+  /*!
+   * \brief Get the maximum number of copy chunks in flight. The remotes which limit the packet
+   *  size may not buffer more than one packet, so they keep one chunk in flight.
+   */
+  int GetCopyWindow() {
+    if (GetRPCMaxTransferSize() != kRPCMaxTransferSizeBytesDefault) {
+      return 1;
+    }
+    return static_cast<int>(GetEnvInt64("TVM_RPC_COPY_WINDOW", kRPCCopyWindowDefault));
+  }
+
+  /*! \brief Read a positive integer from the environment, or return the default value. */
+  static int64_t GetEnvInt64(const char* name, int64_t default_value) {
+    const char* value = std::getenv(name);
+    if (value == nullptr) {
+      return default_value;
+    }
+    int64_t ret = std::atoll(value);
+    ICHECK_GT(ret, 0) << name << " must be positive, got " << value;
+    return ret;
+  }
+
+  /*! \brief Whether the remote handles the multiplexed calls, older remotes do not. */
+  bool SupportsMultiplex() {
+    if (supports_multiplex_ < 0) {
+      PackedFuncHandle handle = GetFunction("tvm.rpc.server.SupportsMultiplex");
+      if (handle != nullptr) {
+        FreeHandle(handle, kTVMPackedFuncHandle);
+      }
+      supports_multiplex_ = handle != nullptr;
+    }
+    return supports_multiplex_ == 1;
+  }
+
+  /*! \brief Find the device a call runs on, from its first device or tensor argument. */
+  static bool FindCallDevice(const TVMValue* arg_values, const int* arg_type_codes, int num_args,
+                             Device* dev) {
+    for (int i = 0; i < num_args; ++i) {
+      if (arg_type_codes[i] == kDLDevice) {
+        *dev = arg_values[i].v_device;
+        return true;
+      }
+      if (arg_type_codes[i] == kTVMDLTensorHandle) {
+        *dev = static_cast<DLTensor*>(arg_values[i].v_handle)->device;
+        return true;
+      }
+    }
+    return false;
+  }
+
   std::shared_ptr<RPCEndpoint> endpoint_;
   int64_t rpc_chunk_max_size_bytes_ = -1;
+  std::atomic<bool> multiplex_{false};
+  std::atomic<int> supports_multiplex_{-1};
 };
 
 std::shared_ptr<RPCSession> CreateClientSession(std::shared_ptr<RPCEndpoint> endpoint) {
   return std::make_shared<RPCClientSession>(endpoint);
 }
 
+TVM_REGISTER_GLOBAL("rpc.SessionSetMultiplex").set_body_typed([](Module mod, bool multiplex) {
+  auto* sess = dynamic_cast<RPCClientSession*>(RPCModuleGetSession(mod).get());
+  ICHECK(sess != nullptr) << "ValueError: Only the sessions connected to a server multiplex calls";
+  sess->SetMultiplex(multiplex);
+});
+
+// Reports to the clients that this server handles RPCCode::kMuxCallFunc.
+TVM_REGISTER_GLOBAL("tvm.rpc.server.SupportsMultiplex").set_body_typed([]() { return true; });
+
 uint64_t RemoteCopyCalculatePacketOverheadSize(DLTensor* tensor, RPCCode code, uint64_t nbytes) {
   uint64_t shape_bytes = tensor->ndim * sizeof(int64_t);
   uint64_t to_data = reinterpret_cast<uint64_t>(static_cast<uint8_t*>(tensor->data));
@@ -26,10 +26,14 @@
 
 #include <tvm/runtime/packed_func.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "../../support/ring_buffer.h"
 #include "../minrpc/rpc_reference.h"
@@ -48,6 +52,10 @@ const int kRPCTrackerMagic = 0x2f271;
 const int kRPCSuccess = kRPCMagic + 0;
 // cannot found matched key in server
 const int kRPCMismatch = kRPCMagic + 2;
+// default payload bytes of a chunk when copying to or from a remote without packet size limit
+const uint64_t kRPCCopyChunkBytesDefault = 4 << 20;
+// default number of copy chunks in flight
+const int kRPCCopyWindowDefault = 4;
 
 /*! \brief Enumeration code for the RPC tracker */
 enum class TrackerCode : int {
@@ -62,6 +70,23 @@ enum class TrackerCode : int {
   kGetPendingMatchKeys = 7
 };
 
+/*! \brief An op of RPCEndpoint::CallBatch. */
+struct RPCBatchOp {
+  /*! \brief RPCCode::kCallFunc, RPCCode::kCopyToRemote or a syscall code. */
+  RPCCode code;
+  /*! \brief The function of kCallFunc. */
+  RPCSession::PackedFuncHandle func{nullptr};
+  /*! \brief The arguments of kCallFunc and of the syscalls. */
+  std::vector<TVMValue> arg_values;
+  std::vector<int> arg_type_codes;
+  /*! \brief The target array, the host data and its size in bytes of kCopyToRemote. */
+  DLTensor* to{nullptr};
+  const void* from_bytes{nullptr};
+  uint64_t nbytes{0};
+  /*! \brief The (argument index, op index) pairs of the returns of the earlier ops it takes. */
+  std::vector<std::pair<int32_t, int32_t>> refs;
+};
+
 /*!
  * \brief Communication endpoints to connect local and remote RPC sessions.
  *        An endpoint can either be a client or a server.
@@ -140,6 +165,23 @@ class RPCEndpoint {
    */
   void CallFunc(RPCSession::PackedFuncHandle handle, const TVMValue* arg_values,
                 const int* arg_type_codes, int num_args, RPCSession::FEncodeReturn encode_return);
+  /*!
+   * \brief Call into remote function on behalf of a device, tagging the request with an id.
+   *
+   *  The server runs the calls of each device in order on a worker thread of the device, so the
+   *  calls of different devices issued from several threads run concurrently over the connection.
+   *  Only use it when the remote reports tvm.rpc.server.SupportsMultiplex.
+   *
+   * \param handle The function handle
+   * \param dev The device which the call runs on.
+   * \param arg_values The argument values.
+   * \param arg_type_codes the type codes of the argument.
+   * \param num_args Number of arguments.
+   * \param fencode_return The function to receive return value encodings.
+   */
+  void CallFuncOnDevice(RPCSession::PackedFuncHandle handle, Device dev, const TVMValue* arg_values,
+                        const int* arg_type_codes, int num_args,
+                        RPCSession::FEncodeReturn encode_return);
   /*!
    * \brief Copy bytes into remote array content.
    * \param from The source host data.
@@ -162,6 +204,36 @@ class RPCEndpoint {
    * \param type_hint Hint of content data type.
    */
   void CopyFromRemote(DLTensor* from, void* to_bytes, uint64_t nbytes);
+  /*!
+   * \brief Copy bytes into remote array content in chunks, keeping up to `window` chunks in
+   *  flight before their acknowledgement is received.
+   * \param from_bytes The source host data.
+   * \param to The target array, its byte_offset is set to the offset of each chunk.
+   * \param nbytes The size of the memory in bytes.
+   * \param block_size The maximum number of bytes of a chunk.
+   * \param window The maximum number of chunks in flight.
+   */
+  void CopyToRemoteWindowed(void* from_bytes, DLTensor* to, uint64_t nbytes, uint64_t block_size,
+                            int window);
+  /*!
+   * \brief Copy bytes from remote array content in chunks, keeping up to `window` chunk requests
+   *  in flight before their data is received.
+   * \param from The source array, its byte_offset is set to the offset of each chunk.
+   * \param to_bytes The target host data.
+   * \param nbytes The size of the memory in bytes.
+   * \param block_size The maximum number of bytes of a chunk.
+   * \param window The maximum number of chunks in flight.
+   */
+  void CopyFromRemoteWindowed(DLTensor* from, void* to_bytes, uint64_t nbytes,
+                              uint64_t block_size, int window);
+
+  /*!
+   * \brief Run a sequence of ops on the remote in one round trip, e.g. the allocations, the copies,
+   *  the timed call and the frees of a measurement. Only minrpc servers handle it.
+   * \param ops The ops, see MinRPCServer::HandleBatch for their arguments and references.
+   * \param encode_return The function to receive the encoded return values of the ops.
+   */
+  void CallBatch(const std::vector<RPCBatchOp>& ops, RPCSession::FEncodeReturn encode_return);
 
   /*!
    * \brief Call a remote defined system function with arguments.
@@ -186,16 +258,40 @@ class RPCEndpoint {
 
  private:
   class EventHandler;
+  class PackedSeqCopy;
   // Handle events until receives a return
   // Also flushes channels so that the function advances.
   RPCCode HandleUntilReturnEvent(bool client_mode, RPCSession::FEncodeReturn setreturn);
+  // Handle events until the return of a multiplexed request is received.
+  void HandleUntilMuxReturn(uint64_t request_id);
+  // Store the return of a multiplexed request for the thread waiting on it.
+  void SetMuxReturn(uint64_t request_id, RPCCode status, TVMArgs args);
+  // Send a complete packet to the channel from any thread.
+  void SendPacket(const std::string& packet);
+  // Send all the pending bytes of the writer to the channel.
+  void FlushWriter();
+  // Send all the pending bytes of the writer, the caller holds send_mutex_.
+  void FlushWriterLocked();
+  // Send a CopyToRemote packet without waiting for the return.
+  void SendCopyToRemote(void* from_bytes, DLTensor* to, uint64_t nbytes);
+  // Send a CopyFromRemote request without waiting for the copy ack.
+  void SendCopyFromRemote(DLTensor* from, uint64_t nbytes);
   // Initalization
   void Init();
   // Internal channel.
   std::unique_ptr<RPCChannel> channel_;
 
-  // Internal mutex
+  // Internal mutex, held by the thread which reads from the channel.
   std::mutex mutex_;
+  // Mutex to send the packets of several threads to the channel one at a time.
+  std::mutex send_mutex_;
+  // Mutex and condition of the returns of the multiplexed requests.
+  std::mutex mux_mutex_;
+  std::condition_variable mux_cv_;
+  // The returns received for the multiplexed requests, by request id.
+  std::unordered_map<uint64_t, std::pair<RPCCode, std::shared_ptr<PackedSeqCopy>>> mux_returns_;
+  // The id of the next multiplexed request.
+  std::atomic<uint64_t> next_request_id_{0};
   // Internal ring buffer.
   support::RingBuffer reader_, writer_;
   // Event handler.
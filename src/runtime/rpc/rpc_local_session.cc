@@ -24,9 +24,14 @@
 #include "rpc_local_session.h"
 
 #include <tvm/runtime/device_api.h>
+#include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/registry.h>
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace tvm {
@@ -158,5 +163,71 @@ TVM_REGISTER_GLOBAL("rpc.LocalSession").set_body_typed([]() {
   return CreateRPCSessionModule(std::make_shared<LocalSession>());
 });
 
+/*!
+ * \brief The argument tensors allocated for measurements on the server, keyed by a string chosen
+ *  by the client. The tensors live as long as the server process, so repeated measurements of
+ *  the modules loaded in a session refer to them instead of allocating and uploading new ones.
+ */
+class RPCArgCache {
+ public:
+  static RPCArgCache* Global() {
+    static RPCArgCache* inst = new RPCArgCache();
+    return inst;
+  }
+  /*!
+   * \brief Get the cached tensor of a key, allocating and randomly filling it when the key is
+   *  missing or the cached tensor does not match.
+   */
+  NDArray GetOrAlloc(const std::string& key, const std::vector<int64_t>& shape, DLDataType dtype,
+                     Device dev) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cache_.find(key);
+    if (it != cache_.end() && Matches(it->second, shape, dtype, dev)) {
+      return it->second;
+    }
+    static const PackedFunc* f_random_fill =
+        Registry::Get("tvm.contrib.random.random_fill_for_measure");
+    ICHECK(f_random_fill != nullptr)
+        << "Please make sure 'USE_RANDOM' is turned ON in the config.cmake on the RPC server.";
+    NDArray arr = NDArray::Empty(ShapeTuple(shape), dtype, dev);
+    (*f_random_fill)(arr);
+    cache_[key] = arr;
+    return arr;
+  }
+  /*! \brief Release all the cached tensors. */
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+  }
+
+ private:
+  static bool Matches(const NDArray& arr, const std::vector<int64_t>& shape, DLDataType dtype,
+                      Device dev) {
+    return arr->device.device_type == dev.device_type && arr->device.device_id == dev.device_id &&
+           DataType(arr->dtype) == DataType(dtype) && static_cast<int>(shape.size()) == arr->ndim &&
+           std::equal(shape.begin(), shape.end(), arr->shape);
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, NDArray> cache_;
+};
+
+TVM_REGISTER_GLOBAL("tvm.rpc.server.arg_cache_get_or_alloc")
+    .set_body([](TVMArgs args, TVMRetValue* rv) {
+      // key, device, dtype, shape...
+      std::string key = args[0];
+      Device dev = args[1];
+      DLDataType dtype = args[2];
+      std::vector<int64_t> shape;
+      for (int i = 3; i < args.size(); ++i) {
+        shape.push_back(args[i]);
+      }
+      *rv = RPCArgCache::Global()->GetOrAlloc(key, shape, dtype, dev);
+    });
+
+TVM_REGISTER_GLOBAL("tvm.rpc.server.arg_cache_clear").set_body_typed([]() {
+  RPCArgCache::Global()->Clear();
+});
+
 }  // namespace runtime
 }  // namespace tvm
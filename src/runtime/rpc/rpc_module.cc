@@ -34,6 +34,7 @@
 #include <immintrin.h>
 #endif
 
+#include "../../support/utils.h"
 #include "rpc_endpoint.h"
 #include "rpc_session.h"
 
@@ -221,6 +222,24 @@ class RPCModuleNode final : public ModuleNode {
     }
   }
 
+  PackedFunc GetBatchTimeEvaluator(const std::string& names, Device dev, int number, int repeat,
+                                   int min_repeat_ms, int limit_zero_time_iterations,
+                                   int cooldown_interval_ms, int repeats_to_cooldown,
+                                   int cache_flush_bytes, const std::string& f_preproc_name) {
+    InitRemoteFunc(&remote_get_batch_time_evaluator_, "runtime.RPCBatchTimeEvaluator");
+    // Remove session mask because we pass dev by parts.
+    ICHECK_EQ(GetRPCSessionIndex(dev), sess_->table_index())
+        << "ValueError: Need to pass the matched remote device to RPCModule.GetTimeEvaluator";
+    dev = RemoveRPCSessionMask(dev);
+
+    Optional<Module> mod = module_handle_ != nullptr ? Optional<Module>(GetRef<Module>(this))
+                                                     : Optional<Module>(nullptr);
+    return remote_get_batch_time_evaluator_(
+        mod, names, static_cast<int>(dev.device_type), dev.device_id, number, repeat,
+        min_repeat_ms, limit_zero_time_iterations, cooldown_interval_ms, repeats_to_cooldown,
+        cache_flush_bytes, f_preproc_name);
+  }
+
   Module LoadModule(std::string name) {
     InitRemoteFunc(&remote_load_module_, "tvm.rpc.server.load_module");
     return remote_load_module_(name);
@@ -258,6 +277,10 @@ class RPCModuleNode final : public ModuleNode {
   TypedPackedFunc<PackedFunc(Optional<Module>, std::string, int, int, int, int, int, int, int, int,
                              int, std::string)>
       remote_get_time_evaluator_;
+  // remote function to get batch time evaluator
+  TypedPackedFunc<PackedFunc(Optional<Module>, std::string, int, int, int, int, int, int, int, int,
+                             int, std::string)>
+      remote_get_batch_time_evaluator_;
   // remote function getter for modules.
   TypedPackedFunc<PackedFunc(Module, std::string, bool)> remote_mod_get_function_;
   // remote function getter for load module
@@ -423,6 +446,46 @@ TVM_REGISTER_GLOBAL("runtime.RPCTimeEvaluator")
       }
     });
 
+// The function names are joined by commas, as an Array cannot be passed through RPC.
+TVM_REGISTER_GLOBAL("runtime.RPCBatchTimeEvaluator")
+    .set_body_typed([](Optional<Module> opt_mod, std::string names, int device_type,
+                       int device_id, int number, int repeat, int min_repeat_ms,
+                       int limit_zero_time_iterations, int cooldown_interval_ms,
+                       int repeats_to_cooldown, int cache_flush_bytes,
+                       std::string f_preproc_name) {
+      Device dev;
+      dev.device_type = static_cast<DLDeviceType>(device_type);
+      dev.device_id = device_id;
+      if (opt_mod.defined() && opt_mod.value()->type_key() == std::string("rpc")) {
+        return static_cast<RPCModuleNode*>(opt_mod.value().operator->())
+            ->GetBatchTimeEvaluator(names, dev, number, repeat, min_repeat_ms,
+                                    limit_zero_time_iterations, cooldown_interval_ms,
+                                    repeats_to_cooldown, cache_flush_bytes, f_preproc_name);
+      }
+      std::vector<PackedFunc> pfs;
+      for (const std::string& name : support::Split(names, ',')) {
+        if (opt_mod.defined()) {
+          PackedFunc pf = opt_mod.value().GetFunction(name, true);
+          CHECK(pf != nullptr) << "Cannot find " << name << " in the module";
+          pfs.push_back(pf);
+        } else {
+          auto* pf = runtime::Registry::Get(name);
+          ICHECK(pf != nullptr) << "Cannot find " << name << " in the global function";
+          pfs.push_back(*pf);
+        }
+      }
+      PackedFunc f_preproc;
+      if (!f_preproc_name.empty()) {
+        auto* pf_preproc = runtime::Registry::Get(f_preproc_name);
+        ICHECK(pf_preproc != nullptr)
+            << "Cannot find " << f_preproc_name << " in the global function";
+        f_preproc = *pf_preproc;
+      }
+      return profiling::WrapBatchTimeEvaluator(pfs, dev, number, repeat, min_repeat_ms,
+                                               limit_zero_time_iterations, cooldown_interval_ms,
+                                               repeats_to_cooldown, cache_flush_bytes, f_preproc);
+    });
+
 TVM_REGISTER_GLOBAL("cache_flush_cpu_non_first_arg").set_body([](TVMArgs args, TVMRetValue* rv) {
   CPUCacheFlush(1, args);
 });
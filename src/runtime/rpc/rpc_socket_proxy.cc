@@ -0,0 +1,488 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file rpc_socket_proxy.cc
+ * \brief Event driven RPC proxy, which pairs the clients and the servers connecting with the same
+ *  key and forwards the bytes between them.
+ *
+ *  It speaks the handshake of python/tvm/rpc/proxy.py over TCP. The connections are served by a
+ *  small pool of threads waiting on one epoll instance, and the bytes of a pair are moved between
+ *  the sockets with splice through a pipe, without copying them to user space.
+ */
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/registry.h>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../../support/socket.h"
+#include "rpc_endpoint.h"
+
+namespace tvm {
+namespace runtime {
+
+#if defined(__linux__)
+
+// the proxy already holds a connection with the same key
+const int kRPCDuplicate = kRPCMagic + 1;
+
+class RPCSocketProxy {
+ public:
+  RPCSocketProxy(const std::string& host, int port, int port_end, int num_threads,
+                 double timeout_sec)
+      : timeout_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(timeout_sec))) {
+    ICHECK_GT(num_threads, 0) << "ValueError: The proxy needs at least one thread";
+    support::SockAddr addr(host.c_str(), port);
+    listen_sock_.Create(addr.ss_family());
+    port_ = listen_sock_.TryBindHost(host, port, port_end);
+    ICHECK_NE(port_, -1) << "Cannot bind the RPC proxy to " << host << ":[" << port << ", "
+                         << port_end << ")";
+    listen_sock_.Listen(1024);
+    listen_sock_.SetNonBlock(true);
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    ICHECK_NE(epoll_fd_, -1) << "epoll_create1: " << strerror(errno);
+    stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    ICHECK_NE(stop_fd_, -1) << "eventfd: " << strerror(errno);
+    Arm(listen_sock_.sockfd, kListenId, EPOLLIN, EPOLL_CTL_ADD);
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = kStopId;
+    ICHECK_EQ(epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, stop_fd_, &ev), 0);
+
+    for (int i = 0; i < num_threads; ++i) {
+      threads_.emplace_back([this, i]() { this->Run(i == 0); });
+    }
+  }
+
+  ~RPCSocketProxy() { Stop(); }
+
+  int port() const { return port_; }
+
+  void Stop() {
+    if (stop_.exchange(true)) return;
+    uint64_t one = 1;
+    ICHECK_EQ(write(stop_fd_, &one, sizeof(one)), sizeof(one));
+    for (std::thread& thread : threads_) {
+      thread.join();
+    }
+    for (auto& kv : conns_) {
+      std::shared_ptr<Conn> conn = kv.second;
+      if (conn->pair != nullptr) {
+        ClosePair(conn->pair.get());
+      } else if (conn->fd != -1) {
+        close(conn->fd);
+        conn->fd = -1;
+      }
+    }
+    conns_.clear();
+    close(stop_fd_);
+    close(epoll_fd_);
+    listen_sock_.Close();
+  }
+
+ private:
+  struct Pair;
+
+  /*! \brief A client or server connection. */
+  struct Conn {
+    uint64_t id;
+    int fd;
+    // The handshake is the magic, the length of the key, then the key.
+    int init_step{0};
+    std::string init_buf;
+    size_t init_nbytes{sizeof(int32_t)};
+    std::string rpc_key;
+    std::string match_key;
+    bool is_server{false};
+    std::chrono::steady_clock::time_point deadline;
+    // Set once the connection is paired.
+    std::shared_ptr<Pair> pair;
+  };
+
+  /*! \brief A client and a server forwarding to each other. */
+  struct Pair {
+    std::mutex mutex;
+    std::shared_ptr<Conn> conns[2];
+    // pipes[i] holds the bytes read from conns[i] and not written to conns[1 - i] yet.
+    int pipes[2][2]{{-1, -1}, {-1, -1}};
+    size_t pending[2]{0, 0};
+    bool eof[2]{false, false};
+    bool closed{false};
+  };
+
+  static constexpr uint64_t kListenId = 0;
+  static constexpr uint64_t kStopId = 1;
+  // The bytes moved by one splice call.
+  static constexpr size_t kSpliceBytes = 1 << 16;
+
+  void Arm(int fd, uint64_t id, uint32_t events, int op = EPOLL_CTL_MOD) {
+    epoll_event ev;
+    ev.events = events | EPOLLONESHOT | EPOLLRDHUP;
+    ev.data.u64 = id;
+    epoll_ctl(epoll_fd_, op, fd, &ev);
+  }
+
+  void Run(bool sweep_timeouts) {
+    std::vector<epoll_event> events(64);
+    while (!stop_) {
+      int n = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), 1000);
+      for (int i = 0; i < n && !stop_; ++i) {
+        uint64_t id = events[i].data.u64;
+        if (id == kListenId) {
+          Accept();
+        } else if (id != kStopId) {
+          HandleEvent(id, events[i].events);
+        }
+      }
+      if (sweep_timeouts) SweepTimeouts();
+    }
+  }
+
+  void Accept() {
+    while (true) {
+      int fd = accept4(listen_sock_.sockfd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (fd == -1) break;
+      int one = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      auto conn = std::make_shared<Conn>();
+      conn->fd = fd;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        conn->id = next_id_++;
+        conns_[conn->id] = conn;
+      }
+      Arm(fd, conn->id, EPOLLIN, EPOLL_CTL_ADD);
+    }
+    Arm(listen_sock_.sockfd, kListenId, EPOLLIN);
+  }
+
+  void HandleEvent(uint64_t id, uint32_t events) {
+    std::shared_ptr<Pair> pair;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = conns_.find(id);
+      if (it == conns_.end()) return;
+      std::shared_ptr<Conn> conn = it->second;
+      if (conn->pair == nullptr) {
+        HandleHandshake(conn);
+        return;
+      }
+      pair = conn->pair;
+    }
+    Forward(pair.get(), pair->conns[0]->id == id ? 0 : 1, events);
+  }
+
+  // Handle the handshake or the events before pairing, holding mutex_.
+  void HandleHandshake(const std::shared_ptr<Conn>& conn) {
+    if (conn->init_step == 3) {
+      // Paired connections wait for the peer without sending anything.
+      char c;
+      ssize_t n = recv(conn->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+      if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        Arm(conn->fd, conn->id, EPOLLIN);
+      } else {
+        if (n > 0) {
+          LOG(INFO) << "RPCProxy: Invalid RPC protocol, too many bytes from " << Name(conn);
+        }
+        RemoveFromPool(conn);
+        CloseConn(conn);
+      }
+      return;
+    }
+    while (conn->init_buf.size() < conn->init_nbytes) {
+      char buf[256];
+      size_t nbytes = std::min(sizeof(buf), conn->init_nbytes - conn->init_buf.size());
+      ssize_t n = recv(conn->fd, buf, nbytes, MSG_DONTWAIT);
+      if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        Arm(conn->fd, conn->id, EPOLLIN);
+        return;
+      }
+      if (n <= 0) {
+        CloseConn(conn);
+        return;
+      }
+      conn->init_buf.append(buf, n);
+      if (conn->init_buf.size() < conn->init_nbytes) continue;
+      if (conn->init_step == 0) {
+        int32_t magic;
+        std::memcpy(&magic, conn->init_buf.data(), sizeof(magic));
+        if (magic != kRPCMagic) {
+          LOG(INFO) << "RPCProxy: Invalid RPC magic from " << Name(conn);
+          CloseConn(conn);
+          return;
+        }
+        conn->init_step = 1;
+        conn->init_nbytes = sizeof(int32_t);
+      } else if (conn->init_step == 1) {
+        int32_t keylen;
+        std::memcpy(&keylen, conn->init_buf.data(), sizeof(keylen));
+        if (keylen <= 7 || keylen > 4096) {
+          LOG(INFO) << "RPCProxy: Invalid RPC key length " << keylen;
+          CloseConn(conn);
+          return;
+        }
+        conn->init_step = 2;
+        conn->init_nbytes = keylen;
+      } else {
+        conn->rpc_key = conn->init_buf;
+        conn->is_server = conn->rpc_key.compare(0, 7, "server:") == 0;
+        // The match key is the first word after "client:" or "server:".
+        std::string rest = conn->rpc_key.substr(7);
+        conn->match_key = rest.substr(0, rest.find(' '));
+        conn->init_step = 3;
+        conn->init_buf.clear();
+        OnReady(conn);
+        return;
+      }
+      conn->init_buf.clear();
+    }
+  }
+
+  // Match a connection which finished the handshake, holding mutex_.
+  void OnReady(const std::shared_ptr<Conn>& conn) {
+    auto& pool_src = conn->is_server ? client_pool_ : server_pool_;
+    auto& pool_dst = conn->is_server ? server_pool_ : client_pool_;
+    auto it = pool_src.find(conn->match_key);
+    if (it != pool_src.end()) {
+      std::shared_ptr<Conn> other = it->second;
+      pool_src.erase(it);
+      PairUp(other, conn);
+    } else if (!pool_dst.count(conn->match_key)) {
+      pool_dst[conn->match_key] = conn;
+      conn->deadline = std::chrono::steady_clock::now() + timeout_;
+      Arm(conn->fd, conn->id, EPOLLIN);
+    } else {
+      LOG(INFO) << "RPCProxy: Duplicate connection with same key=" << conn->match_key;
+      SendCode(conn->fd, kRPCDuplicate);
+      CloseConn(conn);
+    }
+  }
+
+  void PairUp(const std::shared_ptr<Conn>& lhs, const std::shared_ptr<Conn>& rhs) {
+    auto pair = std::make_shared<Pair>();
+    pair->conns[0] = lhs;
+    pair->conns[1] = rhs;
+    for (int i = 0; i < 2; ++i) {
+      ICHECK_EQ(pipe2(pair->pipes[i], O_NONBLOCK | O_CLOEXEC), 0) << "pipe2: " << strerror(errno);
+      const std::string& key = pair->conns[1 - i]->rpc_key;
+      SendCode(pair->conns[i]->fd, kRPCSuccess);
+      SendCode(pair->conns[i]->fd, static_cast<int32_t>(key.length()));
+      SendAll(pair->conns[i]->fd, key.data(), key.length());
+    }
+    lhs->pair = pair;
+    rhs->pair = pair;
+    Arm(lhs->fd, lhs->id, EPOLLIN);
+    Arm(rhs->fd, rhs->id, EPOLLIN);
+  }
+
+  // Move the bytes of a pair, then rearm both of its sockets.
+  void Forward(Pair* pair, int side, uint32_t events) {
+    std::lock_guard<std::mutex> lock(pair->mutex);
+    if (pair->closed) return;
+    if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && pair->pending[side] == 0 &&
+        !pair->eof[side]) {
+      ssize_t n = splice(pair->conns[side]->fd, nullptr, pair->pipes[side][1], nullptr,
+                         kSpliceBytes, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (n > 0) {
+        pair->pending[side] += n;
+      } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+        pair->eof[side] = true;
+      }
+    }
+    for (int i = 0; i < 2; ++i) {
+      while (pair->pending[i] != 0) {
+        ssize_t n = splice(pair->pipes[i][0], nullptr, pair->conns[1 - i]->fd, nullptr,
+                           pair->pending[i], SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (n > 0) {
+          pair->pending[i] -= n;
+        } else if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+          break;
+        } else {
+          // The receiver is gone, the bytes cannot be delivered.
+          pair->eof[i] = true;
+          pair->pending[i] = 0;
+        }
+      }
+    }
+    // A closing side still delivers the bytes it sent before the pair closes.
+    if ((pair->eof[0] && pair->pending[0] == 0) || (pair->eof[1] && pair->pending[1] == 0)) {
+      ClosePair(pair);
+      std::lock_guard<std::mutex> conns_lock(mutex_);
+      conns_.erase(pair->conns[0]->id);
+      conns_.erase(pair->conns[1]->id);
+      return;
+    }
+    for (int i = 0; i < 2; ++i) {
+      uint32_t interest = (pair->pending[i] == 0 ? EPOLLIN : 0) |
+                          (pair->pending[1 - i] != 0 ? EPOLLOUT : 0);
+      Arm(pair->conns[i]->fd, pair->conns[i]->id, interest);
+    }
+  }
+
+  void ClosePair(Pair* pair) {
+    if (pair->closed) return;
+    pair->closed = true;
+    for (int i = 0; i < 2; ++i) {
+      epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, pair->conns[i]->fd, nullptr);
+      close(pair->conns[i]->fd);
+      pair->conns[i]->fd = -1;
+      close(pair->pipes[i][0]);
+      close(pair->pipes[i][1]);
+    }
+  }
+
+  // Close a connection before pairing, holding mutex_.
+  void CloseConn(const std::shared_ptr<Conn>& conn) {
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, conn->fd, nullptr);
+    close(conn->fd);
+    conn->fd = -1;
+    conns_.erase(conn->id);
+  }
+
+  void RemoveFromPool(const std::shared_ptr<Conn>& conn) {
+    auto& pool = conn->is_server ? server_pool_ : client_pool_;
+    auto it = pool.find(conn->match_key);
+    if (it != pool.end() && it->second == conn) pool.erase(it);
+  }
+
+  // Close the connections which did not find a match in time.
+  void SweepTimeouts() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    for (auto* pool : {&client_pool_, &server_pool_}) {
+      for (auto it = pool->begin(); it != pool->end();) {
+        std::shared_ptr<Conn> conn = it->second;
+        if (conn->deadline < now) {
+          LOG(INFO) << "RPCProxy: Timeout connection " << Name(conn)
+                    << ", cannot find match key=" << conn->match_key;
+          it = pool->erase(it);
+          SendCode(conn->fd, kRPCMismatch);
+          CloseConn(conn);
+        } else {
+          ++it;
+        }
+      }
+    }
+  }
+
+  // Send a few bytes on a non-blocking socket.
+  static void SendAll(int fd, const char* data, size_t size) {
+    while (size != 0) {
+      ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+      if (n > 0) {
+        data += n;
+        size -= n;
+      } else if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        pollfd pfd{fd, POLLOUT, 0};
+        poll(&pfd, 1, 100);
+      } else {
+        return;
+      }
+    }
+  }
+
+  static void SendCode(int fd, int32_t code) {
+    SendAll(fd, reinterpret_cast<const char*>(&code), sizeof(code));
+  }
+
+  static std::string Name(const std::shared_ptr<Conn>& conn) {
+    return "TCPSocketProxy:" + conn->rpc_key;
+  }
+
+  support::TCPSocket listen_sock_;
+  int port_{-1};
+  int epoll_fd_{-1};
+  int stop_fd_{-1};
+  std::chrono::steady_clock::duration timeout_;
+  std::atomic<bool> stop_{false};
+  std::vector<std::thread> threads_;
+  // Protects the connections, the pools and the handshakes.
+  std::mutex mutex_;
+  uint64_t next_id_{kStopId + 1};
+  std::unordered_map<uint64_t, std::shared_ptr<Conn>> conns_;
+  // The connections waiting for a match, by match key.
+  std::unordered_map<std::string, std::shared_ptr<Conn>> client_pool_;
+  std::unordered_map<std::string, std::shared_ptr<Conn>> server_pool_;
+};
+
+/*! \brief Module which owns a running proxy. */
+class RPCSocketProxyNode : public ModuleNode {
+ public:
+  explicit RPCSocketProxyNode(std::unique_ptr<RPCSocketProxy> proxy) : proxy_(std::move(proxy)) {}
+
+  const char* type_key() const final { return "rpc_socket_proxy"; }
+
+  PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) final {
+    if (name == "port") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = proxy_->port(); });
+    } else if (name == "stop") {
+      return PackedFunc(
+          [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { proxy_->Stop(); });
+    }
+    return PackedFunc();
+  }
+
+ private:
+  std::unique_ptr<RPCSocketProxy> proxy_;
+};
+
+TVM_REGISTER_GLOBAL("rpc.SocketProxy")
+    .set_body_typed([](std::string host, int port, int port_end, int num_threads,
+                       double timeout_sec) {
+      auto proxy =
+          std::make_unique<RPCSocketProxy>(host, port, port_end, num_threads, timeout_sec);
+      return Module(make_object<RPCSocketProxyNode>(std::move(proxy)));
+    });
+
+#else
+
+TVM_REGISTER_GLOBAL("rpc.SocketProxy")
+    .set_body_typed([](std::string host, int port, int port_end, int num_threads,
+                       double timeout_sec) -> Module {
+      LOG(FATAL) << "The event driven RPC proxy requires Linux epoll, "
+                 << "use python/tvm/rpc/proxy.py instead";
+      return Module();
+    });
+
+#endif  // defined(__linux__)
+
+}  // namespace runtime
+}  // namespace tvm
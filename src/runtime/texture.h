@@ -134,8 +134,13 @@ class TVM_DLL TexturePool {
    *
    * \note Two dimensional texture workspaces will be grown and reused
    * according to the following strategy:
+   *  - Round the width and height up to a multiple of 1/8 of their next
+   *    power of two, so that requests of similar sizes share workspaces.
+   *  - Only consider the workspaces of the same type whose sides are within
+   *    a factor of 5 of the request.
    *  - Choose the workspace which minimizes the amount of memory required to
-   *    grow the workspace to fit the request.
+   *    grow the workspace to fit the request, and grow it if that takes no
+   *    more than the request itself.
    *  - If a set of workspaces exist that fit the current request without
    *    expansion, choose the workspace of that set which most closely
    *    matches the request size, minimizing wasted space.
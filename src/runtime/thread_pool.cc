@@ -25,6 +25,8 @@
 #include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/runtime/container/array.h>
+#include <tvm/runtime/container/map.h>
+#include <tvm/runtime/container/shape_tuple.h>
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
@@ -32,10 +34,17 @@
 #if TVM_THREADPOOL_USE_OPENMP
 #include <omp.h>
 #endif
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 #include <algorithm>
 #include <atomic>
+#include <climits>
 #include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -51,6 +60,15 @@ namespace runtime {
 namespace {
 using support::IsNumber;
 constexpr uint32_t kDefaultSpinCount = 300000;
+// The number of tasks per worker when the work-stealing schedule picks the task count.
+constexpr int kStealTasksPerWorker = 4;
+// The task id which asks a worker to join the work-stealing loop of a launch.
+constexpr int32_t kStealTaskId = -1;
+// The task schedule shared by the thread pools of all threads.
+std::atomic<int> task_schedule{static_cast<int>(threading::TaskSchedule::kStatic)};
+
+// The lower bound of the adaptive spin budget.
+constexpr uint32_t kMinSpinCount = 64;
 
 uint32_t GetSpinCount() {
   const char* val = getenv("TVM_THREAD_POOL_SPIN_COUNT");
@@ -60,6 +78,24 @@ uint32_t GetSpinCount() {
   return atoi(val);
 }
 
+/*!
+ * \brief Whether the workers adapt their spin budget, set by TVM_THREAD_POOL_WAIT_POLICY.
+ *
+ * "fixed" (the default) always spins TVM_THREAD_POOL_SPIN_COUNT iterations
+ * before sleeping. "adaptive" halves the budget every time a worker had to
+ * sleep and grows it back to twice the spin that caught the last task,
+ * bounded by TVM_THREAD_POOL_SPIN_COUNT.
+ */
+bool UseAdaptiveSpin() {
+  const char* val = getenv("TVM_THREAD_POOL_WAIT_POLICY");
+  if (!val || std::string(val) == "fixed") {
+    return false;
+  }
+  ICHECK_EQ(std::string(val), "adaptive")
+      << "TVM_THREAD_POOL_WAIT_POLICY must be \"fixed\" or \"adaptive\", got " << val;
+  return true;
+}
+
 }  // namespace
 
 // stride in the page, fit to cache line.
@@ -164,27 +200,51 @@ class SpscTaskQueue {
       tvm::runtime::threading::Yield();
     }
     if (pending_.fetch_add(1) == -1) {
-      std::unique_lock<std::mutex> lock(mutex_);
-      cv_.notify_one();
+      WakeConsumer(/*wake_all=*/false);
     }
   }
 
+  /*!
+   * \brief Push a task into the queue if it has room, without waiting for the consumer.
+   * \param input The task to be enqueued.
+   * \return Whether the task is enqueued.
+   */
+  bool TryPush(const Task& input) {
+    if (!Enqueue(input)) return false;
+    if (pending_.fetch_add(1) == -1) {
+      WakeConsumer(/*wake_all=*/false);
+    }
+    return true;
+  }
+
   /*!
    * \brief Pop a task out of the queue and condition wait if no tasks.
    * \param output The pointer to the task to be dequeued.
    * \param spin_count The number of iterations to spin before sleep.
    * \return Whether pop is successful (true) or we need to exit now (false).
    */
-  bool Pop(Task* output, uint32_t spin_count) {
+  bool Pop(Task* output, uint32_t spin_count, bool adaptive = false) {
     // Busy wait a bit when the queue is empty.
     // If a new task comes to the queue quickly, this wait avoid the worker from sleeping.
     // The default spin count is set by following the typical omp convention
-    for (uint32_t i = 0; i < spin_count && pending_.load() == 0; ++i) {
+    uint32_t budget = adaptive ? spin_budget_.load(std::memory_order_relaxed) : spin_count;
+    uint32_t spins = 0;
+    for (; spins < budget && pending_.load() == 0; ++spins) {
       tvm::runtime::threading::Yield();
     }
     if (pending_.fetch_sub(1) == 0) {
-      std::unique_lock<std::mutex> lock(mutex_);
-      cv_.wait(lock, [this] { return pending_.load() >= 0 || exit_now_.load(); });
+      num_sleeps_.fetch_add(1, std::memory_order_relaxed);
+      WaitForTask();
+      if (adaptive) {
+        // The gap between tasks outlasted the budget, spinning was wasted.
+        spin_budget_.store(std::max(kMinSpinCount, budget / 2), std::memory_order_relaxed);
+      }
+    } else {
+      num_spin_hits_.fetch_add(1, std::memory_order_relaxed);
+      if (adaptive) {
+        uint32_t target = std::max(budget, std::max(kMinSpinCount, 2 * spins));
+        spin_budget_.store(std::min(spin_count, target), std::memory_order_relaxed);
+      }
     }
     if (exit_now_.load(std::memory_order_relaxed)) {
       return false;
@@ -201,12 +261,82 @@ class SpscTaskQueue {
    * \brief Signal to terminate the worker.
    */
   void SignalForKill() {
-    std::lock_guard<std::mutex> lock(mutex_);
+#if defined(__linux__)
     exit_now_.store(true);
-    cv_.notify_all();
+#else
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      exit_now_.store(true);
+    }
+#endif
+    WakeConsumer(/*wake_all=*/true);
+  }
+
+  /*! \brief The counters of how the consumer waited for its tasks. */
+  struct WaitCounters {
+    /*! \brief The pops that found their task without sleeping. */
+    uint64_t spin_hits;
+    /*! \brief The pops that had to sleep. */
+    uint64_t sleeps;
+    /*! \brief The wake-ups issued by the producer. */
+    uint64_t wakes;
+    /*! \brief The current spin budget of the adaptive policy. */
+    uint32_t spin_budget;
+  };
+
+  WaitCounters GetWaitCounters() const {
+    WaitCounters counters;
+    counters.spin_hits = num_spin_hits_.load(std::memory_order_relaxed);
+    counters.sleeps = num_sleeps_.load(std::memory_order_relaxed);
+    counters.wakes = num_wakes_.load(std::memory_order_relaxed);
+    counters.spin_budget = spin_budget_.load(std::memory_order_relaxed);
+    return counters;
+  }
+
+  /*! \brief Initialize the budget of the adaptive spin policy. */
+  void SetSpinBudget(uint32_t spin_budget) {
+    spin_budget_.store(spin_budget, std::memory_order_relaxed);
   }
 
  protected:
+  /*!
+   * \brief Sleep until a task is pushed or the queue is killed.
+   *
+   * On Linux this waits on a futex keyed by a wake sequence number: the
+   * sequence is read before the condition is checked, so a wake-up between
+   * the check and the wait makes the wait return immediately.
+   */
+  void WaitForTask() {
+#if defined(__linux__)
+    while (true) {
+      int32_t seq = wake_seq_.load(std::memory_order_acquire);
+      if (pending_.load() >= 0 || exit_now_.load()) return;
+      syscall(SYS_futex, reinterpret_cast<int32_t*>(&wake_seq_), FUTEX_WAIT_PRIVATE, seq, nullptr,
+              nullptr, 0);
+    }
+#else
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return pending_.load() >= 0 || exit_now_.load(); });
+#endif
+  }
+
+  /*! \brief Wake up the sleeping consumer. */
+  void WakeConsumer(bool wake_all) {
+    num_wakes_.fetch_add(1, std::memory_order_relaxed);
+#if defined(__linux__)
+    wake_seq_.fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, reinterpret_cast<int32_t*>(&wake_seq_), FUTEX_WAKE_PRIVATE,
+            wake_all ? INT_MAX : 1, nullptr, nullptr, 0);
+#else
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (wake_all) {
+      cv_.notify_all();
+    } else {
+      cv_.notify_one();
+    }
+#endif
+  }
+
   /*!
    * \brief Lock-free enqueue.
    * \param input The task to be enqueued.
@@ -250,10 +380,90 @@ class SpscTaskQueue {
   // signal for exit now
   std::atomic<bool> exit_now_{false};
 
+#if defined(__linux__)
+  cache_line_pad_t pad5_;
+  // futex word bumped by every wake-up
+  std::atomic<int32_t> wake_seq_{0};
+#else
   // internal mutex
   std::mutex mutex_;
   // cv for consumer
   std::condition_variable cv_;
+#endif
+
+  cache_line_pad_t pad6_;
+  // wait statistics, only the wake counter is written by the producer
+  std::atomic<uint64_t> num_spin_hits_{0};
+  std::atomic<uint64_t> num_sleeps_{0};
+  std::atomic<uint32_t> spin_budget_{kDefaultSpinCount};
+  cache_line_pad_t pad7_;
+  std::atomic<uint64_t> num_wakes_{0};
+};
+
+/*!
+ * \brief The range of task ids owned by one worker in the work-stealing schedule.
+ *
+ * The range is packed as (generation:16, begin:24, end:24) into one word, so
+ * that the owner taking tasks from the front and thieves splitting off the
+ * back are serialized by a single compare-and-swap. The generation keeps a
+ * worker that joins late from taking tasks of a newer launch by mistake.
+ */
+class alignas(kL1CacheBytes) StealRange {
+ public:
+  /*! \brief The largest number of tasks a range can describe. */
+  static constexpr int32_t kMaxTasks = 1 << 24;
+
+  void Reset(uint32_t gen, int32_t begin, int32_t end) {
+    word_.store(Pack(gen, begin, end), std::memory_order_release);
+  }
+
+  /*! \brief Take the first task of the range. */
+  bool TakeFront(uint32_t gen, int32_t* task_id) {
+    uint64_t cur = word_.load(std::memory_order_acquire);
+    while (Gen(cur) == (gen & kGenMask) && Begin(cur) < End(cur)) {
+      if (word_.compare_exchange_weak(cur, Pack(gen, Begin(cur) + 1, End(cur)),
+                                      std::memory_order_acq_rel, std::memory_order_acquire)) {
+        *task_id = Begin(cur);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /*! \brief Split off the back half of the range, or the last task. */
+  bool StealBack(uint32_t gen, int32_t* begin, int32_t* end) {
+    uint64_t cur = word_.load(std::memory_order_acquire);
+    while (Gen(cur) == (gen & kGenMask) && Begin(cur) < End(cur)) {
+      int32_t mid = Begin(cur) + (End(cur) - Begin(cur)) / 2;
+      if (word_.compare_exchange_weak(cur, Pack(gen, Begin(cur), mid), std::memory_order_acq_rel,
+                                      std::memory_order_acquire)) {
+        *begin = mid;
+        *end = End(cur);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /*! \brief The number of tasks left in the range. */
+  int32_t Remaining(uint32_t gen) const {
+    uint64_t cur = word_.load(std::memory_order_relaxed);
+    return Gen(cur) == (gen & kGenMask) ? End(cur) - Begin(cur) : 0;
+  }
+
+ private:
+  static constexpr uint64_t kGenMask = (1 << 16) - 1;
+  static constexpr uint64_t kTaskMask = kMaxTasks - 1;
+
+  static uint64_t Pack(uint32_t gen, int32_t begin, int32_t end) {
+    return ((gen & kGenMask) << 48) | (static_cast<uint64_t>(begin) << 24) |
+           static_cast<uint64_t>(end);
+  }
+  static uint64_t Gen(uint64_t word) { return word >> 48; }
+  static int32_t Begin(uint64_t word) { return static_cast<int32_t>((word >> 24) & kTaskMask); }
+  static int32_t End(uint64_t word) { return static_cast<int32_t>(word & kTaskMask); }
+
+  std::atomic<uint64_t> word_{0};
 };
 
 // The thread pool
@@ -288,6 +498,11 @@ class ThreadPool {
     ParallelLauncher* launcher = ParallelLauncher::ThreadLocal();
     ICHECK(!launcher->is_worker)
         << "Cannot launch parallel job inside worker, consider fuse then parallel";
+    if (task_schedule.load(std::memory_order_relaxed) ==
+            static_cast<int>(threading::TaskSchedule::kWorkStealing) &&
+        num_task < StealRange::kMaxTasks) {
+      return LaunchWorkStealing(launcher, flambda, cdata, num_task);
+    }
     if (num_task == 0) {
       num_task = num_workers_used_;
     }
@@ -317,6 +532,41 @@ class ThreadPool {
     return res;
   }
 
+  /*!
+   * \brief Launch the tasks with the work-stealing schedule.
+   *
+   * Every participating worker starts with a contiguous range of task ids.
+   * A worker whose queue is still occupied by an earlier launch is skipped,
+   * its range is taken over by the other workers.
+   */
+  int LaunchWorkStealing(ParallelLauncher* launcher, FTVMParallelLambda flambda, void* cdata,
+                         int num_task) {
+    int num_participants = num_workers_used_;
+    if (num_task == 0) {
+      num_task = num_participants * kStealTasksPerWorker;
+    }
+    launcher->Init(flambda, cdata, num_task, /*need_sync=*/false);
+    uint32_t gen = steal_generation_.load(std::memory_order_relaxed) + 1;
+    for (int i = 0; i < num_workers_; ++i) {
+      int32_t begin = std::min(i, num_participants) * static_cast<int64_t>(num_task) /
+                      num_participants;
+      int32_t end = std::min(i + 1, num_participants) * static_cast<int64_t>(num_task) /
+                    num_participants;
+      steal_ranges_[i].Reset(gen, begin, end);
+    }
+    steal_generation_.store(gen, std::memory_order_release);
+    SpscTaskQueue::Task tsk;
+    tsk.launcher = launcher;
+    tsk.task_id = kStealTaskId;
+    for (int i = exclude_worker0_; i < num_participants; ++i) {
+      queues_[i]->TryPush(tsk);
+    }
+    if (exclude_worker0_) {
+      RunWorkStealing(launcher, 0);
+    }
+    return launcher->WaitForJobs();
+  }
+
   static ThreadPool* ThreadLocal() { return dmlc::ThreadLocalStore<ThreadPool>::Get(); }
 
   void UpdateWorkerConfiguration(threading::ThreadGroup::AffinityMode mode, int nthreads,
@@ -331,6 +581,24 @@ class ThreadPool {
 
   int32_t NumThreads() const { return num_workers_used_; }
 
+  /*! \brief The wait counters of every worker queue, indexed by worker id. */
+  Map<String, ObjectRef> GetWaitCounters() const {
+    std::vector<int64_t> spin_hits, sleeps, wakes, spin_budget;
+    for (const std::unique_ptr<SpscTaskQueue>& q : queues_) {
+      SpscTaskQueue::WaitCounters counters = q->GetWaitCounters();
+      spin_hits.push_back(static_cast<int64_t>(counters.spin_hits));
+      sleeps.push_back(static_cast<int64_t>(counters.sleeps));
+      wakes.push_back(static_cast<int64_t>(counters.wakes));
+      spin_budget.push_back(static_cast<int64_t>(counters.spin_budget));
+    }
+    Map<String, ObjectRef> ret;
+    ret.Set("spin_hits", ShapeTuple(spin_hits));
+    ret.Set("sleeps", ShapeTuple(sleeps));
+    ret.Set("wakes", ShapeTuple(wakes));
+    ret.Set("spin_budget", ShapeTuple(spin_budget));
+    return ret;
+  }
+
  private:
   // Shared initialization code
   void Init() {
@@ -338,6 +606,7 @@ class ThreadPool {
       // The SpscTaskQueue only hosts ONE item at a time
       queues_.emplace_back(std::make_unique<SpscTaskQueue>());
     }
+    steal_ranges_ = std::make_unique<StealRange[]>(num_workers_);
     threads_ = std::make_unique<tvm::runtime::threading::ThreadGroup>(
         num_workers_, [this](int worker_id) { this->RunWorker(worker_id); },
         exclude_worker0_ /* include_main_thread */);
@@ -353,14 +622,59 @@ class ThreadPool {
     // the global first use of the ThreadPool.
     // TODO(tulloch): should we make this configurable via standard APIs?
     static size_t spin_count = GetSpinCount();
-    while (queue->Pop(&task, spin_count)) {
+    static bool adaptive_spin = UseAdaptiveSpin();
+    queue->SetSpinBudget(spin_count);
+    while (queue->Pop(&task, spin_count, adaptive_spin)) {
       ICHECK(task.launcher != nullptr);
-      TVMParallelGroupEnv* penv = &(task.launcher->env);
-      void* cdata = task.launcher->cdata;
-      if ((*task.launcher->flambda)(task.task_id, penv, cdata) == 0) {
-        task.launcher->SignalJobFinish();
+      if (task.task_id == kStealTaskId) {
+        RunWorkStealing(task.launcher, worker_id);
       } else {
-        task.launcher->SignalJobError(task.task_id);
+        RunTask(task.launcher, task.task_id);
+      }
+    }
+  }
+
+  static void RunTask(ParallelLauncher* launcher, int32_t task_id) {
+    TVMParallelGroupEnv* penv = &(launcher->env);
+    if ((*launcher->flambda)(task_id, penv, launcher->cdata) == 0) {
+      launcher->SignalJobFinish();
+    } else {
+      launcher->SignalJobError(task_id);
+    }
+  }
+
+  /*!
+   * \brief Run the tasks of the current work-stealing launch until none is left.
+   *
+   * The worker drains its own range first, then repeatedly steals the back
+   * half of the largest remaining range. A task is only run after it has been
+   * claimed for the current generation, which keeps the launch alive until the
+   * task finishes.
+   */
+  void RunWorkStealing(ParallelLauncher* launcher, int worker_id) {
+    uint32_t gen = steal_generation_.load(std::memory_order_acquire);
+    StealRange* own = &steal_ranges_[worker_id];
+    int32_t task_id;
+    while (true) {
+      if (own->TakeFront(gen, &task_id)) {
+        RunTask(launcher, task_id);
+        continue;
+      }
+      int victim = -1;
+      int32_t most_remaining = 0;
+      for (int i = 0; i < num_workers_; ++i) {
+        int32_t remaining = i == worker_id ? 0 : steal_ranges_[i].Remaining(gen);
+        if (remaining > most_remaining) {
+          victim = i;
+          most_remaining = remaining;
+        }
+      }
+      if (victim < 0) return;
+      int32_t begin, end;
+      if (steal_ranges_[victim].StealBack(gen, &begin, &end)) {
+        // Only the owner refills its empty range, thieves never write to it.
+        own->Reset(gen, begin + 1, end);
+        RunTask(launcher, begin);
       }
     }
   }
@@ -371,11 +685,136 @@ class ThreadPool {
   bool exclude_worker0_{true};
   std::vector<std::unique_ptr<SpscTaskQueue>> queues_;
   std::unique_ptr<tvm::runtime::threading::ThreadGroup> threads_;
+  // the per-worker task ranges of the work-stealing schedule
+  std::unique_ptr<StealRange[]> steal_ranges_;
+  // the generation of the latest work-stealing launch
+  std::atomic<uint32_t> steal_generation_{0};
+};
+
+/*!
+ * \brief The process-wide pool of the shared task schedule.
+ *
+ * Every launch becomes a job in a FIFO of active jobs. An idle worker claims
+ * the next task of the job at the front and rotates the job to the back, so
+ * that concurrent launches from different threads make progress fairly. The
+ * launching thread also runs the unclaimed tasks of its own job, which makes
+ * a launch from inside a task spread onto the idle workers without risking a
+ * deadlock: the launcher only ever waits for tasks that are already running.
+ */
+class SharedThreadPool {
+ public:
+  static SharedThreadPool* Global() {
+    // NOTE: explicitly use new to avoid exit-time destruction of global state
+    static auto* inst = new SharedThreadPool();
+    return inst;
+  }
+
+  int Launch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+    Job job;
+    job.flambda = flambda;
+    job.cdata = cdata;
+    job.num_task = num_task == 0 ? num_workers_ : num_task;
+    job.num_pending.store(job.num_task, std::memory_order_relaxed);
+    job.env.num_task = job.num_task;
+    job.env.sync_handle = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      jobs_.push_back(&job);
+      num_jobs_.fetch_add(1, std::memory_order_release);
+    }
+    cv_.notify_all();
+    // Run the unclaimed tasks of the job on the launching thread.
+    for (int32_t task_id = job.next_task.fetch_add(1); task_id < job.num_task;
+         task_id = job.next_task.fetch_add(1)) {
+      RunTask(&job, task_id);
+    }
+    while (job.num_pending.load(std::memory_order_acquire) != 0) {
+      threading::Yield();
+    }
+    {
+      // Workers only touch a job while holding the lock, and only claimed tasks outlive it.
+      std::lock_guard<std::mutex> lock(mu_);
+      auto it = std::find(jobs_.begin(), jobs_.end(), &job);
+      if (it != jobs_.end()) {
+        jobs_.erase(it);
+        num_jobs_.fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+    if (!job.has_error.load()) return 0;
+    TVMAPISetLastError(job.errors.str().c_str());
+    return -1;
+  }
+
+ private:
+  /*! \brief The state of one launch, owned by the stack of the launching thread. */
+  struct Job {
+    FTVMParallelLambda flambda;
+    void* cdata;
+    TVMParallelGroupEnv env;
+    int32_t num_task;
+    std::atomic<int32_t> next_task{0};
+    std::atomic<int32_t> num_pending{0};
+    std::atomic<bool> has_error{false};
+    std::mutex error_mu;
+    std::ostringstream errors;
+  };
+
+  SharedThreadPool() : num_workers_(threading::MaxConcurrency()) {
+    // The launching thread always takes part, so spawn one worker less.
+    threads_ = std::make_unique<threading::ThreadGroup>(
+        num_workers_, [this](int) { this->RunWorker(); },
+        /*exclude_worker0=*/true);
+  }
+
+  static void RunTask(Job* job, int32_t task_id) {
+    if ((*job->flambda)(task_id, &job->env, job->cdata) != 0) {
+      std::lock_guard<std::mutex> lock(job->error_mu);
+      job->errors << "Task " << task_id << " error: " << TVMGetLastError() << '\n';
+      job->has_error.store(true);
+    }
+    job->num_pending.fetch_sub(1, std::memory_order_release);
+  }
+
+  void RunWorker() {
+    static uint32_t spin_count = GetSpinCount();
+    while (true) {
+      for (uint32_t i = 0; i < spin_count && num_jobs_.load(std::memory_order_acquire) == 0; ++i) {
+        threading::Yield();
+      }
+      Job* job = nullptr;
+      int32_t task_id = 0;
+      {
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock, [this] { return !jobs_.empty(); });
+        job = jobs_.front();
+        jobs_.pop_front();
+        task_id = job->next_task.fetch_add(1);
+        if (task_id + 1 < job->num_task) {
+          jobs_.push_back(job);
+        } else {
+          num_jobs_.fetch_sub(1, std::memory_order_relaxed);
+        }
+      }
+      if (task_id < job->num_task) {
+        RunTask(job, task_id);
+      }
+    }
+  }
+
+  int num_workers_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  // the active jobs, guarded by mu_
+  std::deque<Job*> jobs_;
+  // the size of jobs_, read without the lock while spinning
+  std::atomic<int> num_jobs_{0};
+  std::unique_ptr<threading::ThreadGroup> threads_;
 };
 
 /*!
  * \brief args[0] is the AffinityMode, args[1] is the number of threads.
  *  args2 is a list of CPUs which is used to set the CPU affinity.
+ *  args3 is the task schedule, one of "static", "work_stealing" or "shared".
  */
 TVM_REGISTER_GLOBAL("runtime.config_threadpool").set_body([](TVMArgs args, TVMRetValue* rv) {
   threading::ThreadGroup::AffinityMode mode =
@@ -389,6 +828,19 @@ TVM_REGISTER_GLOBAL("runtime.config_threadpool").set_body([](TVMArgs args, TVMRe
       cpus.push_back(std::stoi(cpu));
     }
   }
+  if (args.num_args >= 4) {
+    std::string schedule = args[3];
+    if (schedule == "static") {
+      threading::SetTaskSchedule(threading::TaskSchedule::kStatic);
+    } else if (schedule == "work_stealing") {
+      threading::SetTaskSchedule(threading::TaskSchedule::kWorkStealing);
+    } else if (schedule == "shared") {
+      threading::SetTaskSchedule(threading::TaskSchedule::kShared);
+    } else {
+      LOG(FATAL) << "Unknown thread pool task schedule '" << schedule
+                 << "', expected \"static\", \"work_stealing\" or \"shared\"";
+    }
+  }
   threading::Configure(mode, nthreads, cpus);
 });
 
@@ -396,6 +848,14 @@ TVM_REGISTER_GLOBAL("runtime.NumThreads").set_body_typed([]() -> int32_t {
   return threading::NumThreads();
 });
 
+/*!
+ * \brief Get the per-worker wait counters of the calling thread's pool: the pops
+ *  served while spinning, the pops that slept, the wake-ups and the spin budget.
+ */
+TVM_REGISTER_GLOBAL("runtime.thread_pool_wait_counters").set_body_typed([]() {
+  return ThreadPool::ThreadLocal()->GetWaitCounters();
+});
+
 namespace threading {
 
 #if TVM_THREADPOOL_USE_OPENMP
@@ -467,11 +927,38 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
 #endif
 }
 int32_t NumThreads() { return tvm::runtime::ThreadPool::ThreadLocal()->NumThreads(); }
+void SetTaskSchedule(TaskSchedule schedule) {
+  tvm::runtime::task_schedule.store(static_cast<int>(schedule), std::memory_order_relaxed);
+}
+TaskSchedule GetTaskSchedule() {
+  return static_cast<TaskSchedule>(tvm::runtime::task_schedule.load(std::memory_order_relaxed));
+}
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
 
+#if defined(__hexagon__)
+namespace tvm {
+namespace runtime {
+namespace hexagon {
+// Defined in hexagon/hexagon_device_api.cc, runs flambda on the HVX threads of the
+// HexagonThreadManager; returns false when the Hexagon runtime resources are not acquired.
+bool HexagonParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task, int sync_stride,
+                           int* ret);
+}  // namespace hexagon
+}  // namespace runtime
+}  // namespace tvm
+#endif
+
 int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
+#if defined(__hexagon__)
+  // Each HVX thread has its own VTCM scratch slice and DMA queues, see HexagonDeviceAPI.
+  int ret = 0;
+  if (tvm::runtime::hexagon::HexagonParallelLaunch(flambda, cdata, num_task,
+                                                   tvm::runtime::kSyncStride, &ret)) {
+    return ret;
+  }
+#endif
   int num_workers = tvm::runtime::threading::MaxConcurrency();
   if (num_workers == 1) {
     std::atomic<int32_t> sync_counter{0};
@@ -482,6 +969,10 @@ int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_ta
     return 0;
   } else {
 #if !TVM_THREADPOOL_USE_OPENMP
+    if (tvm::runtime::threading::GetTaskSchedule() ==
+        tvm::runtime::threading::TaskSchedule::kShared) {
+      return tvm::runtime::SharedThreadPool::Global()->Launch(flambda, cdata, num_task);
+    }
     int res = tvm::runtime::ThreadPool::ThreadLocal()->Launch(flambda, cdata, num_task, 1);
     return res;
 #else
@@ -503,6 +994,8 @@ int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) {
 #pragma omp barrier
 #else
   using tvm::runtime::kSyncStride;
+  ICHECK(penv->sync_handle != nullptr)
+      << "TVMBackendParallelBarrier is not supported by the work-stealing task schedule";
   int num_task = penv->num_task;
   std::atomic<int>* sync_counter = reinterpret_cast<std::atomic<int>*>(penv->sync_handle);
   int old_counter = sync_counter[task_id * kSyncStride].fetch_add(1, std::memory_order_release);
@@ -136,6 +136,13 @@ Instruction::Instruction(const Instruction& instr) {
       return;
     case Opcode::KillRegister:
       return;
+    case Opcode::AllocInvokePacked:
+      this->alloc_invoke_packed = instr.alloc_invoke_packed;
+      this->alloc_invoke_packed.packed_args = Duplicate<RegName>(
+          instr.alloc_invoke_packed.packed_args, instr.alloc_invoke_packed.arity);
+      this->alloc_invoke_packed.allocs = Duplicate<Instruction>(
+          instr.alloc_invoke_packed.allocs, instr.alloc_invoke_packed.num_allocs);
+      return;
     default:
       std::ostringstream out;
       out << "Invalid instruction " << static_cast<int>(instr.op);
@@ -167,7 +174,7 @@ Instruction& Instruction::operator=(const Instruction& instr) {
       this->result = instr.result;
       return *this;
     case Opcode::AllocTensor:
-      this->alloc_tensor.storage = this->alloc_tensor.storage;
+      this->alloc_tensor.storage = instr.alloc_tensor.storage;
       this->alloc_tensor.offset = instr.alloc_tensor.offset;
       this->alloc_tensor.ndim = instr.alloc_tensor.ndim;
       this->alloc_tensor.shape =
@@ -250,6 +257,13 @@ Instruction& Instruction::operator=(const Instruction& instr) {
       return *this;
     case Opcode::KillRegister:
       return *this;
+    case Opcode::AllocInvokePacked:
+      this->alloc_invoke_packed = instr.alloc_invoke_packed;
+      this->alloc_invoke_packed.packed_args = Duplicate<RegName>(
+          instr.alloc_invoke_packed.packed_args, instr.alloc_invoke_packed.arity);
+      this->alloc_invoke_packed.allocs = Duplicate<Instruction>(
+          instr.alloc_invoke_packed.allocs, instr.alloc_invoke_packed.num_allocs);
+      return *this;
     default:
       std::ostringstream out;
       out << "Invalid instruction " << static_cast<int>(instr.op);
@@ -297,6 +311,10 @@ Instruction::~Instruction() {
     case Opcode::Invoke:
       delete[] this->invoke_args_registers;
       return;
+    case Opcode::AllocInvokePacked:
+      delete[] this->alloc_invoke_packed.packed_args;
+      delete[] this->alloc_invoke_packed.allocs;
+      return;
     default:
       std::ostringstream out;
       LOG(FATAL) << "Invalid instruction " << static_cast<int>(this->op);
@@ -330,6 +348,27 @@ Instruction Instruction::InvokePacked(Index packed_index, Index arity, Index out
   return instr;
 }
 
+Instruction Instruction::AllocInvokePacked(Index packed_index, Index arity, Index output_size,
+                                           const std::vector<RegName>& args,
+                                           const std::vector<Instruction>& allocs) {
+  Instruction instr;
+  instr.op = Opcode::AllocInvokePacked;
+  instr.alloc_invoke_packed.packed_index = packed_index;
+  instr.alloc_invoke_packed.arity = arity;
+  instr.alloc_invoke_packed.output_size = output_size;
+  instr.alloc_invoke_packed.packed_args = new RegName[arity];
+  for (Index i = 0; i < arity; ++i) {
+    instr.alloc_invoke_packed.packed_args[i] = args[i];
+  }
+  instr.alloc_invoke_packed.num_allocs = allocs.size();
+  instr.alloc_invoke_packed.allocs = new Instruction[allocs.size()];
+  for (size_t i = 0; i < allocs.size(); ++i) {
+    ICHECK(allocs[i].op == Opcode::AllocTensor);
+    instr.alloc_invoke_packed.allocs[i] = allocs[i];
+  }
+  return instr;
+}
+
 Instruction Instruction::AllocTensor(RegName storage, RegName offset,
                                      const std::vector<int64_t>& shape, DLDataType dtype,
                                      RegName dst) {
@@ -678,6 +717,18 @@ void InstructionPrint(std::ostream& os, const Instruction& instr) {
       os << "kill_register $" << instr.dst;
       break;
     }
+    case Opcode::AllocInvokePacked: {
+      const auto& op = instr.alloc_invoke_packed;
+      os << "alloc_invoke_packed PackedFunc[" << op.packed_index << "] (in: $"
+         << StrJoin<RegName>(op.packed_args, 0, op.arity - op.output_size, ", $") << ", out: $"
+         << StrJoin<RegName>(op.packed_args, op.arity - op.output_size, op.output_size, ", $")
+         << ") {";
+      for (Index i = 0; i < op.num_allocs; ++i) {
+        os << (i ? "; " : "") << op.allocs[i];
+      }
+      os << "}";
+      break;
+    }
     default:
       LOG(FATAL) << "should never hit this case" << static_cast<int>(instr.op);
       break;
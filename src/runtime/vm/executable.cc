@@ -630,6 +630,19 @@ VMInstructionSerializer SerializeInstruction(const Instruction& instr) {
       fields.assign({instr.dst});
       break;
     }
+    case Opcode::AllocInvokePacked: {
+      // Number of fields = 4 + instr.arity + the fields of each allocation, each prefixed with
+      // its number of fields.
+      const auto& op = instr.alloc_invoke_packed;
+      fields.assign({op.packed_index, op.arity, op.output_size, op.num_allocs});
+      fields.insert(fields.end(), op.packed_args, op.packed_args + op.arity);
+      for (Index i = 0; i < op.num_allocs; ++i) {
+        VMInstructionSerializer alloc = SerializeInstruction(op.allocs[i]);
+        fields.push_back(alloc.fields.size());
+        fields.insert(fields.end(), alloc.fields.begin(), alloc.fields.end());
+      }
+      break;
+    }
     default:
       LOG(FATAL) << "Invalid opcode" << static_cast<int>(instr.op);
       break;
@@ -953,6 +966,28 @@ Instruction DeserializeInstruction(const VMInstructionSerializer& instr) {
       DCHECK_EQ(instr.fields.size(), 1U);
       return Instruction::KillRegister(instr.fields[0]);
     }
+    case Opcode::AllocInvokePacked: {
+      // Number of fields = 4 + instr.arity + the fields of each allocation, each prefixed with
+      // its number of fields.
+      DCHECK_GE(instr.fields.size(), 4U);
+      Index packed_index = instr.fields[0];
+      Index arity = instr.fields[1];
+      Index output_size = instr.fields[2];
+      Index num_allocs = instr.fields[3];
+      std::vector<RegName> args = ExtractFields(instr.fields, 4, arity);
+      std::vector<Instruction> allocs;
+      Index pos = 4 + arity;
+      for (Index i = 0; i < num_allocs; ++i) {
+        ICHECK_LT(static_cast<size_t>(pos), instr.fields.size());
+        Index num_fields = instr.fields[pos];
+        VMInstructionSerializer alloc(static_cast<Index>(Opcode::AllocTensor),
+                                      ExtractFields(instr.fields, pos + 1, num_fields));
+        allocs.push_back(DeserializeInstruction(alloc));
+        pos += 1 + num_fields;
+      }
+      DCHECK_EQ(static_cast<size_t>(pos), instr.fields.size());
+      return Instruction::AllocInvokePacked(packed_index, arity, output_size, args, allocs);
+    }
     default:
       LOG(FATAL) << "Invalid opcode" << instr.opcode;
   }
@@ -718,6 +718,23 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
         pc_++;
         goto main_loop;
       }
+      case Opcode::AllocInvokePacked: {
+        const auto& op = instr.alloc_invoke_packed;
+        for (Index i = 0; i < op.num_allocs; ++i) {
+          OpStartHook(op.allocs[i]);
+          WriteAllocatedTensor(op.allocs[i]);
+          OpStopHook();
+        }
+        ICHECK_LE(op.packed_index, packed_funcs_.size());
+        std::vector<ObjectRef> args;
+        for (Index i = 0; i < op.arity; ++i) {
+          args.push_back(ReadRegister(op.packed_args[i]));
+        }
+        InvokePacked(op.packed_index, packed_funcs_[op.packed_index], op.arity, op.output_size,
+                     args);
+        pc_++;
+        goto main_loop;
+      }
       case Opcode::InvokeClosure: {
         auto object = ReadRegister(instr.closure);
         const auto* closure = object.as<VMClosureObj>();
@@ -19,6 +19,7 @@
 
 #include "vulkan_buffer.h"
 
+#include <atomic>
 #include <utility>
 
 #include "vulkan_device_api.h"
@@ -38,12 +39,26 @@ VkBufferCreateInfo MakeBufferCreateInfo(size_t nbytes, VkBufferUsageFlags usage)
 }
 
 VulkanBuffer::VulkanBuffer(const VulkanDevice& device, size_t nbytes, VkBufferUsageFlags usage,
-                           uint32_t mem_type_index)
+                           uint32_t mem_type_index, VulkanMemoryHeap* heap)
     : device_(device) {
   // Create a buffer
   VkBufferCreateInfo buffer_info = MakeBufferCreateInfo(nbytes, usage);
   VULKAN_CALL(vkCreateBuffer(device, &buffer_info, nullptr, &buffer));
 
+  if (heap) {
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(device, buffer, &requirements);
+    VkDeviceSize dedicated_nbytes = requirements.size;
+    if (heap->CanAllocate(requirements) &&
+        !UseDedicatedAllocation(device, buffer, &dedicated_nbytes)) {
+      heap_ = heap;
+      heap_allocation_ = heap->Allocate(requirements);
+      VULKAN_CALL(vkBindBufferMemory(device, buffer, heap_allocation_.memory,
+                                     heap_allocation_.offset));
+      return;
+    }
+  }
+
   // Allocate memory
   VkMemoryAllocateInfo mem_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
   mem_info.allocationSize = buffer_info.size;
@@ -64,26 +79,45 @@ VulkanBuffer::VulkanBuffer(const VulkanDevice& device, size_t nbytes, VkBufferUs
   VULKAN_CALL(vkBindBufferMemory(device, buffer, memory, 0));
 }
 
+namespace {
+std::atomic<uint64_t> num_destroyed_buffers{0};
+}  // namespace
+
 VulkanBuffer::~VulkanBuffer() {
   if (buffer) {
     vkDestroyBuffer(device_, buffer, nullptr);
+    num_destroyed_buffers.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (heap_) {
+    heap_->Free(heap_allocation_);
   }
   if (memory) {
     vkFreeMemory(device_, memory, nullptr);
   }
 }
 
+uint64_t VulkanBuffer::NumDestroyed() {
+  return num_destroyed_buffers.load(std::memory_order_relaxed);
+}
+
 VulkanBuffer::VulkanBuffer(VulkanBuffer&& other)
-    : device_(other.device_), buffer(other.buffer), memory(other.memory) {
+    : device_(other.device_),
+      buffer(other.buffer),
+      memory(other.memory),
+      heap_(other.heap_),
+      heap_allocation_(other.heap_allocation_) {
   other.device_ = VK_NULL_HANDLE;
   other.buffer = VK_NULL_HANDLE;
   other.memory = VK_NULL_HANDLE;
+  other.heap_ = nullptr;
 }
 
 VulkanBuffer& VulkanBuffer::operator=(VulkanBuffer&& other) {
   std::swap(device_, other.device_);
   std::swap(buffer, other.buffer);
   std::swap(memory, other.memory);
+  std::swap(heap_, other.heap_);
+  std::swap(heap_allocation_, other.heap_allocation_);
   return *this;
 }
 
@@ -25,6 +25,8 @@
 #include <memory>
 #include <unordered_map>
 
+#include "vulkan_memory_heap.h"
+
 namespace tvm {
 namespace runtime {
 namespace vulkan {
@@ -46,13 +48,26 @@ class VulkanBuffer {
    * \param mem_type_index The memory type to index.  This should be
    * an index to a compatible memory located in
    * VkPhysicalDeviceMemoryProperties.
+   *
+   * \param heap The heap to sub-allocate the memory from, or nullptr
+   * to allocate a separate VkDeviceMemory.  Buffers that need a
+   * dedicated allocation, or that are too large for the heap, always
+   * get a separate VkDeviceMemory.  The heap should outlive the
+   * VulkanBuffer, and must use the memory type mem_type_index.
    */
   VulkanBuffer(const VulkanDevice& device, size_t nbytes, VkBufferUsageFlags usage,
-               uint32_t mem_type_index);
+               uint32_t mem_type_index, VulkanMemoryHeap* heap = nullptr);
 
   //! \brief Destructor, deallocates the memory and buffer.
   ~VulkanBuffer();
 
+  /*! \brief The number of buffers destroyed so far.
+   *
+   * The handle of a destroyed buffer may be reused by a new buffer,
+   * so caches keyed by buffer handles are invalid once it changes.
+   */
+  static uint64_t NumDestroyed();
+
   // Forbid copy assignment/constructor
   VulkanBuffer(const VulkanBuffer&) = delete;
   VulkanBuffer& operator=(const VulkanBuffer&) = delete;
@@ -100,9 +115,15 @@ class VulkanBuffer {
   //! \brief Handle to the logical buffer on the device
   VkBuffer buffer{VK_NULL_HANDLE};
 
-  //! \brief Handle to the physical device memory
+  //! \brief Handle to the physical device memory, if not sub-allocated from a heap
   VkDeviceMemory memory{VK_NULL_HANDLE};
 
+  //! \brief The heap that the memory is sub-allocated from, if any
+  VulkanMemoryHeap* heap_{nullptr};
+
+  //! \brief The range of the heap bound to the buffer
+  VulkanMemoryHeap::Allocation heap_allocation_;
+
   friend class VulkanHostVisibleBuffer;
 };
 
@@ -20,6 +20,7 @@
 #include "vulkan_device.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <mutex>
 #include <unordered_map>
 #include <utility>
@@ -70,6 +71,8 @@ VulkanDeviceProperties::VulkanDeviceProperties(const VulkanInstance& instance,
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES};
   VkPhysicalDeviceShaderFloat16Int8Features float16_int8 = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES};
+  VkPhysicalDeviceTimelineSemaphoreFeatures timeline_semaphore = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES};
 
   // Set up linked list for feature query
   {
@@ -86,6 +89,10 @@ VulkanDeviceProperties::VulkanDeviceProperties(const VulkanInstance& instance,
       *pp_next = &float16_int8;
       pp_next = &float16_int8.pNext;
     }
+    if (device.HasExtension("VK_KHR_timeline_semaphore")) {
+      *pp_next = &timeline_semaphore;
+      pp_next = &timeline_semaphore.pNext;
+    }
   }
 
   if (instance.HasExtension("VK_KHR_get_physical_device_properties2")) {
@@ -134,6 +141,12 @@ VulkanDeviceProperties::VulkanDeviceProperties(const VulkanInstance& instance,
 
   supports_integer_dot_product = device.HasExtension("VK_KHR_shader_integer_dot_product");
 
+  // Support is available based on this feature, but allow it to be
+  // disabled based on an environment variable.
+  supports_timeline_semaphore =
+      timeline_semaphore.timelineSemaphore &&
+      !support::BoolEnvironmentVar("TVM_VULKAN_DISABLE_TIMELINE_SEMAPHORE");
+
   supports_cooperative_matrix = device.HasExtension("VK_NV_cooperative_matrix");
 
   // The check of VK_SHADER_STAGE_COMPUTE_BIT isn't technically
@@ -228,6 +241,13 @@ VulkanDescriptorTemplateKHRFunctions::VulkanDescriptorTemplateKHRFunctions(VkDev
       vkGetDeviceProcAddr(device, "vkCmdPushDescriptorSetWithTemplateKHR"));
 }
 
+VulkanTimelineSemaphoreKHRFunctions::VulkanTimelineSemaphoreKHRFunctions(VkDevice device) {
+  vkWaitSemaphoresKHR = (PFN_vkWaitSemaphoresKHR)ICHECK_NOTNULL(
+      vkGetDeviceProcAddr(device, "vkWaitSemaphoresKHR"));
+  vkGetSemaphoreCounterValueKHR = (PFN_vkGetSemaphoreCounterValueKHR)ICHECK_NOTNULL(
+      vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValueKHR"));
+}
+
 VulkanGetBufferMemoryRequirements2Functions::VulkanGetBufferMemoryRequirements2Functions(
     VkDevice device) {
   vkGetBufferMemoryRequirements2KHR = (PFN_vkGetBufferMemoryRequirements2KHR)ICHECK_NOTNULL(
@@ -330,11 +350,27 @@ VulkanDevice::VulkanDevice(const VulkanInstance& instance, VkPhysicalDevice phy_
 
   ICHECK_GE(win_rank, 0) << "Cannot find suitable local memory on device.";
 
+  // Sub-allocate the compute buffers from blocks of device memory,
+  // unless the block size is set to 0 by an environment variable.
+  VkDeviceSize heap_block_size = kDefaultHeapBlockSize;
+  if (const char* val = std::getenv("TVM_VULKAN_HEAP_BLOCK_SIZE")) {
+    heap_block_size = std::strtoull(val, nullptr, 10);
+  }
+  if (heap_block_size > 0) {
+    compute_memory_heap =
+        std::make_unique<VulkanMemoryHeap>(device_, compute_mtype_index, heap_block_size);
+  }
+
   if (device_properties.supports_push_descriptor) {
     descriptor_template_khr_functions =
         std::make_unique<VulkanDescriptorTemplateKHRFunctions>(device_);
   }
 
+  if (device_properties.supports_timeline_semaphore) {
+    timeline_semaphore_khr_functions =
+        std::make_unique<VulkanTimelineSemaphoreKHRFunctions>(device_);
+  }
+
   if (device_properties.supports_dedicated_allocation) {
     get_buffer_memory_requirements_2_functions =
         std::make_unique<VulkanGetBufferMemoryRequirements2Functions>(device_);
@@ -354,6 +390,7 @@ VulkanDevice::~VulkanDevice() {
   stream_per_thread.Clear();
   staging_buffer_per_thread.Clear();
   uniform_buffer_per_thread.Clear();
+  compute_memory_heap.reset();
 
   if (device_) {
     vkDestroyDevice(device_, nullptr);
@@ -384,8 +421,10 @@ void VulkanDevice::do_swap(VulkanDevice&& other) {
             other.get_buffer_memory_requirements_2_functions);
   std::swap(queue_insert_debug_utils_label_functions,
             other.queue_insert_debug_utils_label_functions);
+  std::swap(timeline_semaphore_khr_functions, other.timeline_semaphore_khr_functions);
   std::swap(compute_mtype_index, other.compute_mtype_index);
   std::swap(compute_memory_size, other.compute_memory_size);
+  std::swap(compute_memory_heap, other.compute_memory_heap);
   std::swap(queue, other.queue);
   std::swap(queue_family_index, other.queue_family_index);
   std::swap(physical_device_, other.physical_device_);
@@ -445,6 +484,7 @@ std::vector<const char*> VulkanDevice::SelectEnabledExtensions() const {
                                                "VK_KHR_dedicated_allocation",
                                                "VK_KHR_spirv_1_4",
                                                "VK_KHR_shader_integer_dot_product",
+                                               "VK_KHR_timeline_semaphore",
                                                "VK_NV_cooperative_matrix"};
 
   uint32_t device_extension_prop_count;
@@ -471,6 +511,8 @@ void VulkanDevice::CreateVkDevice(const VulkanInstance& instance) {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES};
   VkPhysicalDeviceShaderFloat16Int8Features float16_int8 = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES};
+  VkPhysicalDeviceTimelineSemaphoreFeatures timeline_semaphore = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES};
 
   void** pp_next = &enabled_features.pNext;
   bool needs_float16_int8 = false;
@@ -508,6 +550,12 @@ void VulkanDevice::CreateVkDevice(const VulkanInstance& instance) {
     pp_next = &float16_int8.pNext;
   }
 
+  if (device_properties.supports_timeline_semaphore) {
+    timeline_semaphore.timelineSemaphore = true;
+    *pp_next = &timeline_semaphore;
+    pp_next = &timeline_semaphore.pNext;
+  }
+
   float priority = 1.0f;
 
   struct VkDeviceQueueCreateInfo queue_create_info;
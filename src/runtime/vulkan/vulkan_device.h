@@ -57,6 +57,13 @@ struct VulkanGetBufferMemoryRequirements2Functions {
   PFN_vkGetBufferMemoryRequirements2KHR vkGetBufferMemoryRequirements2KHR{nullptr};
 };
 
+struct VulkanTimelineSemaphoreKHRFunctions {
+  explicit VulkanTimelineSemaphoreKHRFunctions(VkDevice device);
+
+  PFN_vkWaitSemaphoresKHR vkWaitSemaphoresKHR{nullptr};
+  PFN_vkGetSemaphoreCounterValueKHR vkGetSemaphoreCounterValueKHR{nullptr};
+};
+
 struct VulkanQueueInsertDebugUtilsLabelFunctions {
   explicit VulkanQueueInsertDebugUtilsLabelFunctions(VkInstance instance);
 
@@ -87,6 +94,7 @@ struct VulkanDeviceProperties {
   bool supports_storage_buffer_storage_class{false};
   bool supports_push_descriptor{false};
   bool supports_dedicated_allocation{false};
+  bool supports_timeline_semaphore{false};
   bool supports_integer_dot_product{false};
   bool supports_cooperative_matrix{false};
   uint32_t supported_subgroup_operations{0};
@@ -221,10 +229,15 @@ class VulkanDevice {
       get_buffer_memory_requirements_2_functions{nullptr};
   std::unique_ptr<VulkanQueueInsertDebugUtilsLabelFunctions>
       queue_insert_debug_utils_label_functions{nullptr};
+  std::unique_ptr<VulkanTimelineSemaphoreKHRFunctions> timeline_semaphore_khr_functions{nullptr};
   // Memory type index for compute
   uint32_t compute_mtype_index{0};
   // maximum memory size for compute
   int64_t compute_memory_size{0};
+  // The heap that the compute buffers are sub-allocated from, if enabled.
+  std::unique_ptr<VulkanMemoryHeap> compute_memory_heap{nullptr};
+  // The default size of the memory blocks of compute_memory_heap.
+  static constexpr VkDeviceSize kDefaultHeapBlockSize = 64 << 20;
 
   // queue family_index;
   uint32_t queue_family_index{uint32_t(-1)};
@@ -233,6 +246,8 @@ class VulkanDevice {
 
   bool UseDebugUtilsLabel() const { return queue_insert_debug_utils_label_functions != nullptr; }
 
+  bool UseTimelineSemaphore() const { return timeline_semaphore_khr_functions != nullptr; }
+
   VkQueue Queue() const { return queue; }
 
  private:
@@ -216,6 +216,9 @@ void VulkanDeviceAPI::GetTargetProperty(Device dev, const std::string& property,
   if (property == "supports_dedicated_allocation") {
     *rv = prop.supports_dedicated_allocation;
   }
+  if (property == "supports_timeline_semaphore") {
+    *rv = prop.supports_timeline_semaphore;
+  }
   if (property == "supported_subgroup_operations") {
     *rv = int64_t(prop.supported_subgroup_operations);
   }
@@ -287,7 +290,8 @@ void* VulkanDeviceAPI::AllocDataSpace(Device dev, size_t nbytes, size_t alignmen
   const auto& device = this->device(dev.device_id);
   auto usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-  return new VulkanBuffer(device, nbytes, usage, device.compute_mtype_index);
+  return new VulkanBuffer(device, nbytes, usage, device.compute_mtype_index,
+                          device.compute_memory_heap.get());
 }
 
 void VulkanDeviceAPI::FreeDataSpace(Device dev, void* ptr) {
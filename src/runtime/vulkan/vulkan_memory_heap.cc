@@ -0,0 +1,144 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "vulkan_memory_heap.h"
+
+#include <algorithm>
+
+#include "vulkan_common.h"
+
+namespace tvm {
+namespace runtime {
+namespace vulkan {
+
+VulkanMemoryHeap::VulkanMemoryHeap(VkDevice device, uint32_t mem_type_index,
+                                   VkDeviceSize block_size)
+    : device_(device), mem_type_index_(mem_type_index) {
+  max_order_ = OrderOf(std::max(block_size, kMinRangeSize));
+}
+
+VulkanMemoryHeap::~VulkanMemoryHeap() {
+  for (const Block& block : blocks_) {
+    vkFreeMemory(device_, block.memory, nullptr);
+  }
+}
+
+uint32_t VulkanMemoryHeap::OrderOf(VkDeviceSize nbytes) const {
+  uint32_t order = 0;
+  while ((kMinRangeSize << order) < nbytes) {
+    ++order;
+  }
+  return order;
+}
+
+bool VulkanMemoryHeap::CanAllocate(const VkMemoryRequirements& requirements) const {
+  if (!(requirements.memoryTypeBits & (1u << mem_type_index_))) {
+    return false;
+  }
+  // The ranges of order k are aligned to their own size.
+  VkDeviceSize nbytes = std::max(requirements.size, requirements.alignment);
+  return OrderOf(nbytes) + 2 <= max_order_;
+}
+
+bool VulkanMemoryHeap::AllocateFrom(Block* block, uint32_t order, VkDeviceSize* offset) {
+  uint32_t k = order;
+  while (k <= max_order_ && block->free_offsets[k].empty()) {
+    ++k;
+  }
+  if (k > max_order_) {
+    return false;
+  }
+  VkDeviceSize start = *block->free_offsets[k].begin();
+  block->free_offsets[k].erase(block->free_offsets[k].begin());
+  // Split the range down to the requested order, keeping the lower halves.
+  while (k > order) {
+    --k;
+    block->free_offsets[k].insert(start + (kMinRangeSize << k));
+  }
+  *offset = start;
+  return true;
+}
+
+VulkanMemoryHeap::Allocation VulkanMemoryHeap::Allocate(const VkMemoryRequirements& requirements) {
+  ICHECK(CanAllocate(requirements));
+  uint32_t order = OrderOf(std::max(requirements.size, requirements.alignment));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Allocation allocation;
+  allocation.order = order;
+  for (size_t i = 0; i < blocks_.size(); ++i) {
+    if (AllocateFrom(&blocks_[i], order, &allocation.offset)) {
+      allocation.memory = blocks_[i].memory;
+      allocation.block = i;
+      allocated_bytes_ += kMinRangeSize << order;
+      return allocation;
+    }
+  }
+
+  Block block;
+  VkMemoryAllocateInfo mem_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+  mem_info.allocationSize = kMinRangeSize << max_order_;
+  mem_info.memoryTypeIndex = mem_type_index_;
+  VULKAN_CALL(vkAllocateMemory(device_, &mem_info, nullptr, &block.memory));
+  block.free_offsets.resize(max_order_ + 1);
+  block.free_offsets[max_order_].insert(0);
+  blocks_.push_back(std::move(block));
+
+  ICHECK(AllocateFrom(&blocks_.back(), order, &allocation.offset));
+  allocation.memory = blocks_.back().memory;
+  allocation.block = blocks_.size() - 1;
+  allocated_bytes_ += kMinRangeSize << order;
+  return allocation;
+}
+
+void VulkanMemoryHeap::Free(const Allocation& allocation) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ICHECK_LT(allocation.block, blocks_.size());
+  Block& block = blocks_[allocation.block];
+  allocated_bytes_ -= kMinRangeSize << allocation.order;
+
+  VkDeviceSize offset = allocation.offset;
+  uint32_t order = allocation.order;
+  // Merge with the buddy for as long as it is free.
+  while (order < max_order_) {
+    VkDeviceSize buddy = offset ^ (kMinRangeSize << order);
+    auto it = block.free_offsets[order].find(buddy);
+    if (it == block.free_offsets[order].end()) {
+      break;
+    }
+    block.free_offsets[order].erase(it);
+    offset = std::min(offset, buddy);
+    ++order;
+  }
+  block.free_offsets[order].insert(offset);
+}
+
+VkDeviceSize VulkanMemoryHeap::ReservedBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return blocks_.size() * (kMinRangeSize << max_order_);
+}
+
+VkDeviceSize VulkanMemoryHeap::AllocatedBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return allocated_bytes_;
+}
+
+}  // namespace vulkan
+}  // namespace runtime
+}  // namespace tvm
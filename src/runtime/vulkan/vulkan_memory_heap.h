@@ -0,0 +1,120 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef TVM_RUNTIME_VULKAN_VULKAN_MEMORY_HEAP_H_
+#define TVM_RUNTIME_VULKAN_VULKAN_MEMORY_HEAP_H_
+
+#include <vulkan/vulkan_core.h>
+
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace vulkan {
+
+/*! \brief Sub-allocator of device memory for the VulkanBuffers of a device
+ *
+ * Drivers limit the number of live VkDeviceMemory allocations (often
+ * to 4096), and each vkAllocateMemory call is slow.  The heap
+ * allocates device memory in large blocks, and hands out ranges of
+ * the blocks with a buddy allocator.  Each VulkanBuffer still owns
+ * its VkBuffer, bound to its range of a block, so the kernels bind
+ * the buffers exactly as before.
+ *
+ * Requests larger than a quarter of the block size are not
+ * sub-allocated, and should use their own VkDeviceMemory.
+ */
+class VulkanMemoryHeap {
+ public:
+  /*! \brief A range of a memory block */
+  struct Allocation {
+    VkDeviceMemory memory{VK_NULL_HANDLE};
+    VkDeviceSize offset{0};
+    // The index of the memory block
+    size_t block{0};
+    // The buddy order of the range
+    uint32_t order{0};
+  };
+
+  /* \brief Create a heap
+   *
+   * \param device The device to allocate memory from.
+   *
+   * \param mem_type_index The memory type of the blocks.
+   *
+   * \param block_size The size in bytes of each memory block, rounded
+   * up to a power of two.
+   */
+  VulkanMemoryHeap(VkDevice device, uint32_t mem_type_index, VkDeviceSize block_size);
+
+  //! \brief Destructor, frees the memory blocks.
+  ~VulkanMemoryHeap();
+
+  VulkanMemoryHeap(const VulkanMemoryHeap&) = delete;
+  VulkanMemoryHeap& operator=(const VulkanMemoryHeap&) = delete;
+
+  /*! \brief Whether a request can be sub-allocated from the heap. */
+  bool CanAllocate(const VkMemoryRequirements& requirements) const;
+
+  /*! \brief Allocate a range satisfying the size and alignment of the requirements.
+   *
+   * Must only be called if CanAllocate(requirements) is true.
+   */
+  Allocation Allocate(const VkMemoryRequirements& requirements);
+
+  /*! \brief Return a range to the heap. */
+  void Free(const Allocation& allocation);
+
+  /*! \brief The number of bytes of the memory blocks. */
+  VkDeviceSize ReservedBytes() const;
+
+  /*! \brief The number of bytes handed out, after rounding to the buddy sizes. */
+  VkDeviceSize AllocatedBytes() const;
+
+ private:
+  struct Block {
+    VkDeviceMemory memory{VK_NULL_HANDLE};
+    // The offsets of the free ranges of each order, where a range of
+    // order k has kMinRangeSize << k bytes.
+    std::vector<std::set<VkDeviceSize>> free_offsets;
+  };
+
+  // The size of the smallest range, which also bounds the alignment of the ranges.
+  static constexpr VkDeviceSize kMinRangeSize = 256;
+
+  uint32_t OrderOf(VkDeviceSize nbytes) const;
+  // Take a range of the order from the block, or return false if there is none.
+  bool AllocateFrom(Block* block, uint32_t order, VkDeviceSize* offset);
+
+  VkDevice device_;
+  uint32_t mem_type_index_;
+  // The order of a whole block.
+  uint32_t max_order_;
+  std::vector<Block> blocks_;
+  VkDeviceSize allocated_bytes_{0};
+  mutable std::mutex mutex_;
+};
+
+}  // namespace vulkan
+}  // namespace runtime
+}  // namespace tvm
+
+#endif  // TVM_RUNTIME_VULKAN_VULKAN_MEMORY_HEAP_H_
@@ -19,6 +19,8 @@
 
 #include "vulkan_stream.h"
 
+#include <cstdlib>
+
 #include "../../support/utils.h"
 #include "vulkan_device.h"
 
@@ -26,8 +28,13 @@ namespace tvm {
 namespace runtime {
 namespace vulkan {
 
-VulkanStream::VulkanStream(const VulkanDevice* device)
-    : device_(device), state_(new VulkanStreamState()) {
+namespace {
+// The number of submitted command buffers, beyond which the stream
+// waits for the oldest one before recording more commands.
+constexpr size_t kMaxInFlightSubmits = 4;
+}  // namespace
+
+VulkanStream::VulkanStream(const VulkanDevice* device) : device_(device) {
   // create command pool
   VkCommandPoolCreateInfo cmd_pool_cinfo;
   cmd_pool_cinfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -36,26 +43,25 @@ VulkanStream::VulkanStream(const VulkanDevice* device)
   cmd_pool_cinfo.queueFamilyIndex = device_->queue_family_index;
   VULKAN_CALL(vkCreateCommandPool(*device_, &cmd_pool_cinfo, nullptr, &cmd_pool_));
 
-  VkCommandBufferAllocateInfo buffer_alloc_info;
-  buffer_alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-  buffer_alloc_info.pNext = nullptr;
-  buffer_alloc_info.commandPool = cmd_pool_;
-  buffer_alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  buffer_alloc_info.commandBufferCount = 1;
-  VULKAN_CALL(vkAllocateCommandBuffers(*device_, &buffer_alloc_info, &(state_->cmd_buffer_)));
+  if (device_->UseTimelineSemaphore()) {
+    VkSemaphoreTypeCreateInfo type_cinfo;
+    type_cinfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    type_cinfo.pNext = nullptr;
+    type_cinfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    type_cinfo.initialValue = 0;
 
-  VkFenceCreateInfo fence_cinfo;
-  fence_cinfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-  fence_cinfo.pNext = nullptr;
-  fence_cinfo.flags = 0;  // VK_FENCE_CREATE_SIGNALED_BIT;
-  VULKAN_CALL(vkCreateFence(*device_, &fence_cinfo, nullptr, &(state_->fence_)));
+    VkSemaphoreCreateInfo semaphore_cinfo;
+    semaphore_cinfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphore_cinfo.pNext = &type_cinfo;
+    semaphore_cinfo.flags = 0;
+    VULKAN_CALL(vkCreateSemaphore(*device_, &semaphore_cinfo, nullptr, &timeline_semaphore_));
+  }
 
-  VkCommandBufferBeginInfo cb_begin;
-  cb_begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-  cb_begin.pNext = nullptr;
-  cb_begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-  cb_begin.pInheritanceInfo = nullptr;
-  VULKAN_CALL(vkBeginCommandBuffer(state_->cmd_buffer_, &cb_begin));
+  if (const char* val = std::getenv("TVM_VULKAN_MAX_LAUNCHES_PER_SUBMIT")) {
+    max_launches_per_submit_ = std::strtoul(val, nullptr, 10);
+  }
+
+  state_ = AcquireState();
 
   if (support::BoolEnvironmentVar("TVM_USE_AMD_RGP")) {
     profiler_ = new AmdRgpProfiler(device_);
@@ -63,20 +69,94 @@ VulkanStream::VulkanStream(const VulkanDevice* device)
 }
 
 VulkanStream::~VulkanStream() {
-  vkDestroyFence(*device_, state_->fence_, nullptr);
+  std::vector<std::unique_ptr<VulkanStreamState>> states = std::move(free_states_);
+  states.push_back(std::move(state_));
+  for (auto& state : in_flight_states_) {
+    states.push_back(std::move(state));
+  }
+  if (timeline_semaphore_ != VK_NULL_HANDLE) {
+    vkDestroySemaphore(*device_, timeline_semaphore_, nullptr);
+  }
+  for (const auto& state : states) {
+    vkDestroyFence(*device_, state->fence_, nullptr);
+  }
   vkDestroyCommandPool(*device_, cmd_pool_, nullptr);
-
   if (profiler_) {
     delete (profiler_);
   }
 }
 
+std::unique_ptr<VulkanStreamState> VulkanStream::AcquireState() {
+  std::unique_ptr<VulkanStreamState> state;
+  if (!free_states_.empty()) {
+    state = std::move(free_states_.back());
+    free_states_.pop_back();
+  } else if (in_flight_states_.size() >= kMaxInFlightSubmits) {
+    state = std::move(in_flight_states_.front());
+    in_flight_states_.pop_front();
+    WaitState(state.get());
+  } else {
+    state = std::make_unique<VulkanStreamState>();
+
+    VkCommandBufferAllocateInfo buffer_alloc_info;
+    buffer_alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    buffer_alloc_info.pNext = nullptr;
+    buffer_alloc_info.commandPool = cmd_pool_;
+    buffer_alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    buffer_alloc_info.commandBufferCount = 1;
+    VULKAN_CALL(vkAllocateCommandBuffers(*device_, &buffer_alloc_info, &(state->cmd_buffer_)));
+
+    VkFenceCreateInfo fence_cinfo;
+    fence_cinfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fence_cinfo.pNext = nullptr;
+    fence_cinfo.flags = 0;  // VK_FENCE_CREATE_SIGNALED_BIT;
+    VULKAN_CALL(vkCreateFence(*device_, &fence_cinfo, nullptr, &(state->fence_)));
+  }
+
+  VkCommandBufferBeginInfo cb_begin;
+  cb_begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  cb_begin.pNext = nullptr;
+  cb_begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  cb_begin.pInheritanceInfo = nullptr;
+  VULKAN_CALL(vkBeginCommandBuffer(state->cmd_buffer_, &cb_begin));
+  return state;
+}
+
+void VulkanStream::WaitState(VulkanStreamState* state) {
+  uint64_t timeout = 1UL << 30UL;
+  VkResult res;
+  if (timeline_semaphore_ != VK_NULL_HANDLE) {
+    VkSemaphoreWaitInfo wait_info;
+    wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    wait_info.pNext = nullptr;
+    wait_info.flags = 0;
+    wait_info.semaphoreCount = 1;
+    wait_info.pSemaphores = &timeline_semaphore_;
+    wait_info.pValues = &(state->timeline_value_);
+    do {
+      res = device_->timeline_semaphore_khr_functions->vkWaitSemaphoresKHR(*device_, &wait_info,
+                                                                           timeout);
+    } while (res == VK_TIMEOUT);
+    VULKAN_CHECK_ERROR(res);
+  } else {
+    do {
+      res = vkWaitForFences(*device_, 1, &(state->fence_), 0, timeout);
+    } while (res == VK_TIMEOUT);
+    VULKAN_CHECK_ERROR(res);
+    VULKAN_CALL(vkResetFences(*device_, 1, &(state->fence_)));
+  }
+  VULKAN_CALL(vkResetCommandBuffer(state->cmd_buffer_, 0));
+}
+
 void VulkanStream::Launch(const std::function<void(VulkanStreamState*)>& kernel) {
   if (device_->UseImmediate()) {
     kernel(state_.get());
   } else {
     deferred_kernels_.push_back(kernel);
   }
+  if (max_launches_per_submit_ != 0 && ++num_pending_launches_ >= max_launches_per_submit_) {
+    Flush();
+  }
 }
 
 void VulkanStream::LaunchDeferred(const std::function<void()>& deferred_initializer,
@@ -99,10 +179,10 @@ void VulkanStream::LaunchDeferred(const std::function<void()>& deferred_initiali
 
   // If the new kernel uses the same buffers in the same descriptor
   // set as an already-queued kernel, we don't need to initialize it
-  // again.  Since every VulkanWrappedFunc owns a single descriptor
-  // set, unless the same function is called with the same buffer
-  // arguments, deferred_initializer() will always be called.
-  if (!std::any_of(deferred_tokens_[deferred_token.descriptor_set_].begin(),
+  // again.  Descriptor sets are cached per buffer bindings, so the
+  // initializer is empty when the descriptor set was already written.
+  if (deferred_initializer &&
+      !std::any_of(deferred_tokens_[deferred_token.descriptor_set_].begin(),
                    deferred_tokens_[deferred_token.descriptor_set_].end(),
                    [&](const VulkanStreamToken& token) {
                      DCHECK(token.descriptor_set_ == deferred_token.descriptor_set_);
@@ -115,9 +195,13 @@ void VulkanStream::LaunchDeferred(const std::function<void()>& deferred_initiali
   // Save the kernel itself to be called later.
   deferred_kernels_.push_back(deferred_kernel);
   deferred_tokens_[deferred_token.descriptor_set_].push_back(deferred_token);
+
+  if (max_launches_per_submit_ != 0 && ++num_pending_launches_ >= max_launches_per_submit_) {
+    Flush();
+  }
 }
 
-void VulkanStream::Synchronize() {
+void VulkanStream::Flush() {
   if (!device_->UseImmediate()) {
     for (const auto& deferred_kernel : deferred_kernels_) {
       deferred_kernel(state_.get());
@@ -128,8 +212,10 @@ void VulkanStream::Synchronize() {
     DCHECK_EQ(deferred_kernels_.size(), 0);
     DCHECK_EQ(deferred_tokens_.size(), 0);
   }
+  num_pending_launches_ = 0;
 
   VULKAN_CALL(vkEndCommandBuffer(state_->cmd_buffer_));
+
   VkSubmitInfo cb_submit;
   cb_submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
   cb_submit.pNext = nullptr;
@@ -141,28 +227,39 @@ void VulkanStream::Synchronize() {
   cb_submit.signalSemaphoreCount = 0;
   cb_submit.pSignalSemaphores = nullptr;
 
+  VkTimelineSemaphoreSubmitInfo timeline_submit;
+  VkFence fence = state_->fence_;
+  if (timeline_semaphore_ != VK_NULL_HANDLE) {
+    state_->timeline_value_ = ++timeline_value_;
+    timeline_submit.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timeline_submit.pNext = nullptr;
+    timeline_submit.waitSemaphoreValueCount = 0;
+    timeline_submit.pWaitSemaphoreValues = nullptr;
+    timeline_submit.signalSemaphoreValueCount = 1;
+    timeline_submit.pSignalSemaphoreValues = &(state_->timeline_value_);
+    cb_submit.pNext = &timeline_submit;
+    cb_submit.signalSemaphoreCount = 1;
+    cb_submit.pSignalSemaphores = &timeline_semaphore_;
+    fence = VK_NULL_HANDLE;
+  }
+
   if (profiler_) {
     profiler_->capture();
   }
 
-  device_->QueueSubmit(cb_submit, state_->fence_);
+  device_->QueueSubmit(cb_submit, fence);
+  in_flight_states_.push_back(std::move(state_));
+  state_ = AcquireState();
+}
 
-  uint64_t timeout = 1UL << 30UL;
-  VkResult res;
-  do {
-    res = vkWaitForFences(*device_, 1, &(state_->fence_), 0, timeout);
-  } while (res == VK_TIMEOUT);
-  VULKAN_CHECK_ERROR(res);
-  VULKAN_CALL(vkResetCommandBuffer(state_->cmd_buffer_, 0));
-  VULKAN_CALL(vkResetFences(*device_, 1, &(state_->fence_)));
-
-  // Re-initialize the command buffer
-  VkCommandBufferBeginInfo cb_begin;
-  cb_begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-  cb_begin.pNext = nullptr;
-  cb_begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-  cb_begin.pInheritanceInfo = nullptr;
-  VULKAN_CALL(vkBeginCommandBuffer(state_->cmd_buffer_, &cb_begin));
+void VulkanStream::Synchronize() {
+  Flush();
+  while (!in_flight_states_.empty()) {
+    std::unique_ptr<VulkanStreamState> state = std::move(in_flight_states_.back());
+    in_flight_states_.pop_back();
+    WaitState(state.get());
+    free_states_.push_back(std::move(state));
+  }
 }
 
 }  // namespace vulkan
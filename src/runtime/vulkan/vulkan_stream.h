@@ -20,6 +20,7 @@
 #ifndef TVM_RUNTIME_VULKAN_VULKAN_STREAM_H_
 #define TVM_RUNTIME_VULKAN_VULKAN_STREAM_H_
 
+#include <deque>
 #include <functional>
 #include <memory>
 #include <unordered_map>
@@ -38,6 +39,9 @@ class VulkanStreamState {
  public:
   VkCommandBuffer cmd_buffer_;
   VkFence fence_;
+  // The value signaled on the timeline semaphore of the stream when the
+  // command buffer finishes, if the device uses timeline semaphores.
+  uint64_t timeline_value_{0};
 };
 
 // Used to identify state that should only be used once-per-stream.
@@ -61,6 +65,14 @@ struct VulkanStreamToken {
  *  submitted to the VulkanStream associated with the submitting CPU
  *  thread, and associated the thread-specific active device set by
  *  `DeviceAPI::SetDevice`.
+ *
+ *  When the environment variable TVM_VULKAN_MAX_LAUNCHES_PER_SUBMIT
+ *  is set to N > 0, the command buffer is submitted without waiting
+ *  after every N launches, and the following launches are recorded
+ *  into another command buffer, so that the GPU starts on long
+ *  sequences of kernels before the host synchronizes.  The submitted
+ *  command buffers are tracked with a timeline semaphore if the
+ *  device supports it, and with a fence per command buffer otherwise.
  */
 class VulkanStream {
  public:
@@ -87,7 +99,9 @@ class VulkanStream {
    * all kernels are collected.
    *
    * \param deferred_initializer Updates the descriptor set.  Only
-   * called if the deferred_token has differences from
+   * called if the deferred_token has differences from the tokens of
+   * the queued kernels.  May be empty if the descriptor set is
+   * already up to date.
    *
    * \param deferred_kernel Submits updates to the command buffer.
    *
@@ -114,12 +128,35 @@ class VulkanStream {
     }
   }
 
+  /*! \brief Submit the recorded commands without waiting for them.
+   *
+   * The following commands are recorded into another command buffer.
+   */
+  void Flush();
+
   // Synchronize the current stream `state_` with respect to the host.
   void Synchronize();
 
  private:
+  // Get a command buffer which is not in use, and begin recording on it.
+  std::unique_ptr<VulkanStreamState> AcquireState();
+  // Wait for the submitted command buffer to finish, and reset it.
+  void WaitState(VulkanStreamState* state);
+
   const VulkanDevice* device_;
   std::unique_ptr<VulkanStreamState> state_;
+  // The submitted command buffers, from the oldest to the newest.
+  std::deque<std::unique_ptr<VulkanStreamState>> in_flight_states_;
+  // The finished command buffers for reuse.
+  std::vector<std::unique_ptr<VulkanStreamState>> free_states_;
+  // The timeline semaphore signaled by the submitted command buffers.
+  VkSemaphore timeline_semaphore_{VK_NULL_HANDLE};
+  // The last value signaled on the timeline semaphore.
+  uint64_t timeline_value_{0};
+  // The number of launches recorded since the last submission.
+  size_t num_pending_launches_{0};
+  // The number of launches after which the commands are submitted, 0 for no limit.
+  size_t max_launches_per_submit_{0};
   // An index of deferred tokens, allowing us to efficiently detect duplicated
   // deferred_initializer blocks.
   std::unordered_map<VkDescriptorSet, std::vector<VulkanStreamToken>> deferred_tokens_;
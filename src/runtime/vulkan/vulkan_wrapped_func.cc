@@ -30,6 +30,68 @@ namespace tvm {
 namespace runtime {
 namespace vulkan {
 
+namespace {
+// The number of descriptor sets in each descriptor pool of a pipeline.
+constexpr uint32_t kDescriptorSetsPerPool = 64;
+// The number of cached descriptor sets of a pipeline, beyond which the cache is dropped.
+constexpr size_t kMaxCachedDescriptorSets = 1024;
+}  // namespace
+
+VkDescriptorSet VulkanPipeline::GetDescriptorSet(VulkanDevice& device,
+                                                 const std::vector<VkBuffer>& buffers,
+                                                 bool* is_new) {
+  std::lock_guard<std::mutex> lock(descriptor_set_mutex);
+  uint64_t epoch = VulkanBuffer::NumDestroyed();
+  if (epoch != descriptor_set_cache_epoch) {
+    descriptor_set_cache_epoch = epoch;
+    descriptor_set_cache.clear();
+  }
+  auto it = descriptor_set_cache.find(buffers);
+  if (it != descriptor_set_cache.end()) {
+    *is_new = false;
+    return it->second;
+  }
+  if (num_descriptor_sets == kMaxCachedDescriptorSets) {
+    // The queued kernels may still use the descriptor sets.
+    device.ThreadLocalStream().Synchronize();
+    for (VkDescriptorPool pool : descriptor_pools) {
+      VULKAN_CALL(vkResetDescriptorPool(device, pool, 0));
+    }
+    descriptor_set_cache.clear();
+    num_descriptor_sets = 0;
+  }
+  size_t pool_index = num_descriptor_sets / kDescriptorSetsPerPool;
+  if (pool_index == descriptor_pools.size()) {
+    std::vector<VkDescriptorPoolSize> pool_sizes = descriptor_set_pool_sizes;
+    for (auto& pool_size : pool_sizes) {
+      pool_size.descriptorCount *= kDescriptorSetsPerPool;
+    }
+    VkDescriptorPoolCreateInfo descrip_pool_cinfo;
+    descrip_pool_cinfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descrip_pool_cinfo.pNext = nullptr;
+    descrip_pool_cinfo.flags = 0;
+    descrip_pool_cinfo.maxSets = kDescriptorSetsPerPool;
+    descrip_pool_cinfo.poolSizeCount = pool_sizes.size();
+    descrip_pool_cinfo.pPoolSizes = pool_sizes.data();
+    VkDescriptorPool pool;
+    VULKAN_CALL(vkCreateDescriptorPool(device, &descrip_pool_cinfo, nullptr, &pool));
+    descriptor_pools.push_back(pool);
+  }
+
+  VkDescriptorSetAllocateInfo alloc_info;
+  alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  alloc_info.pNext = nullptr;
+  alloc_info.descriptorPool = descriptor_pools[pool_index];
+  alloc_info.descriptorSetCount = 1;
+  alloc_info.pSetLayouts = &descriptor_set_layout;
+  VkDescriptorSet descriptor_set;
+  VULKAN_CALL(vkAllocateDescriptorSets(device, &alloc_info, &descriptor_set));
+  ++num_descriptor_sets;
+  descriptor_set_cache[buffers] = descriptor_set;
+  *is_new = true;
+  return descriptor_set;
+}
+
 void VulkanWrappedFunc::Init(VulkanModuleNode* m, ObjectPtr<Object> sptr,
                              const std::string& func_name, size_t num_buffer_args,
                              size_t num_pack_args,
@@ -112,39 +174,49 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
   }
 
   // Otherwise, the more expensive deferred path.
+  std::vector<VkBuffer> bound_buffers(descriptor_buffers.size());
+  for (size_t i = 0; i < descriptor_buffers.size(); ++i) {
+    bound_buffers[i] = descriptor_buffers[i].buffer;
+  }
+  bool is_new_descriptor_set = false;
+  VkDescriptorSet descriptor_set =
+      pipeline->GetDescriptorSet(device, bound_buffers, &is_new_descriptor_set);
+
   std::vector<ArgUnion64> pack_args_storage(pack_args, pack_args + num_pack_args_);
-  const auto& deferred_initializer = [&device, pipeline, descriptor_buffers]() {
-    std::vector<VkWriteDescriptorSet> write_descriptor_sets;
-    write_descriptor_sets.resize(descriptor_buffers.size());
-    for (size_t i = 0; i < write_descriptor_sets.size(); i++) {
-      write_descriptor_sets[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      write_descriptor_sets[i].pNext = nullptr;
-      write_descriptor_sets[i].dstSet = pipeline->descriptor_set;
-      write_descriptor_sets[i].dstBinding = i;
-      write_descriptor_sets[i].dstArrayElement = 0;
-      write_descriptor_sets[i].descriptorCount = 1;
-      write_descriptor_sets[i].pImageInfo = nullptr;
-      write_descriptor_sets[i].pBufferInfo = &(descriptor_buffers[i]);
-      write_descriptor_sets[i].pTexelBufferView = nullptr;
-
-      if (pipeline->use_ubo && i == write_descriptor_sets.size() - 1) {
-        // The last binding is for UBO
-        write_descriptor_sets[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-      } else {
-        write_descriptor_sets[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  std::function<void()> deferred_initializer;
+  if (is_new_descriptor_set) {
+    deferred_initializer = [&device, pipeline, descriptor_set, descriptor_buffers]() {
+      std::vector<VkWriteDescriptorSet> write_descriptor_sets;
+      write_descriptor_sets.resize(descriptor_buffers.size());
+      for (size_t i = 0; i < write_descriptor_sets.size(); i++) {
+        write_descriptor_sets[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write_descriptor_sets[i].pNext = nullptr;
+        write_descriptor_sets[i].dstSet = descriptor_set;
+        write_descriptor_sets[i].dstBinding = i;
+        write_descriptor_sets[i].dstArrayElement = 0;
+        write_descriptor_sets[i].descriptorCount = 1;
+        write_descriptor_sets[i].pImageInfo = nullptr;
+        write_descriptor_sets[i].pBufferInfo = &(descriptor_buffers[i]);
+        write_descriptor_sets[i].pTexelBufferView = nullptr;
+
+        if (pipeline->use_ubo && i == write_descriptor_sets.size() - 1) {
+          // The last binding is for UBO
+          write_descriptor_sets[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        } else {
+          write_descriptor_sets[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        }
       }
-    }
-    vkUpdateDescriptorSets(device, write_descriptor_sets.size(), write_descriptor_sets.data(), 0,
-                           nullptr);
-  };
-  const auto& deferred_kernel = [this, pipeline, wl, pack_args_storage, nbytes_scalars,
-                                 device_id](VulkanStreamState* state) {
+      vkUpdateDescriptorSets(device, write_descriptor_sets.size(), write_descriptor_sets.data(),
+                             0, nullptr);
+    };
+  }
+  const auto& deferred_kernel = [this, pipeline, descriptor_set, wl, pack_args_storage,
+                                 nbytes_scalars, device_id](VulkanStreamState* state) {
     auto& device = VulkanDeviceAPI::Global()->device(device_id);
 
     vkCmdBindPipeline(state->cmd_buffer_, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->pipeline);
     vkCmdBindDescriptorSets(state->cmd_buffer_, VK_PIPELINE_BIND_POINT_COMPUTE,
-                            pipeline->pipeline_layout, 0, 1, &(pipeline->descriptor_set), 0,
-                            nullptr);
+                            pipeline->pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
 
     if (pipeline->use_ubo) {
       auto& ubo = device.ThreadLocalUniformBuffer(nbytes_scalars);
@@ -167,11 +239,8 @@ void VulkanWrappedFunc::operator()(TVMArgs args, TVMRetValue* rv,
                          1, &barrier_info, 0, nullptr, 0, nullptr);
   };
   VulkanStreamToken deferred_token;
-  deferred_token.descriptor_set_ = pipeline->descriptor_set;
-  deferred_token.buffers_.resize(descriptor_buffers.size());
-  for (size_t i = 0; i < descriptor_buffers.size(); ++i) {
-    deferred_token.buffers_[i] = descriptor_buffers[i].buffer;
-  }
+  deferred_token.descriptor_set_ = descriptor_set;
+  deferred_token.buffers_ = std::move(bound_buffers);
   device.ThreadLocalStream().LaunchDeferred(deferred_initializer, deferred_kernel, deferred_token);
 
   if (device.UseDebugUtilsLabel()) {
@@ -198,7 +267,9 @@ VulkanModuleNode::~VulkanModuleNode() {
       }
       vkDestroyPipeline(device, pe->pipeline, nullptr);
       vkDestroyPipelineLayout(device, pe->pipeline_layout, nullptr);
-      vkDestroyDescriptorPool(device, pe->descriptor_pool, nullptr);
+      for (VkDescriptorPool pool : pe->descriptor_pools) {
+        vkDestroyDescriptorPool(device, pool, nullptr);
+      }
       vkDestroyDescriptorSetLayout(device, pe->descriptor_set_layout, nullptr);
       vkDestroyShaderModule(device, pe->shader, nullptr);
     }
@@ -320,23 +391,8 @@ std::shared_ptr<VulkanPipeline> VulkanModuleNode::GetPipeline(size_t device_id,
   }
 
   if (!device.UseImmediate()) {
-    VkDescriptorPoolCreateInfo descrip_pool_cinfo;
-    descrip_pool_cinfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    descrip_pool_cinfo.pNext = nullptr;
-    descrip_pool_cinfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    descrip_pool_cinfo.maxSets = 1;
-    descrip_pool_cinfo.poolSizeCount = descriptor_set_pool_sizes.size();
-    descrip_pool_cinfo.pPoolSizes = descriptor_set_pool_sizes.data();
-    VULKAN_CALL(
-        vkCreateDescriptorPool(device, &descrip_pool_cinfo, nullptr, &(pe->descriptor_pool)));
-
-    VkDescriptorSetAllocateInfo alloc_info;
-    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    alloc_info.pNext = nullptr;
-    alloc_info.descriptorPool = pe->descriptor_pool;
-    alloc_info.descriptorSetCount = 1;
-    alloc_info.pSetLayouts = &(pe->descriptor_set_layout);
-    VULKAN_CALL(vkAllocateDescriptorSets(device, &alloc_info, &(pe->descriptor_set)));
+    // The descriptor sets are allocated on the first use of each set of buffer bindings.
+    pe->descriptor_set_pool_sizes = descriptor_set_pool_sizes;
   }
 
   VkPushConstantRange crange;
@@ -21,6 +21,7 @@
 #define TVM_RUNTIME_VULKAN_VULKAN_WRAPPED_FUNC_H_
 
 #include <array>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -43,12 +44,41 @@ struct VulkanPipeline {
   VulkanDevice* device{nullptr};
   VkShaderModule shader{VK_NULL_HANDLE};
   VkDescriptorSetLayout descriptor_set_layout{VK_NULL_HANDLE};
-  VkDescriptorPool descriptor_pool{VK_NULL_HANDLE};
-  VkDescriptorSet descriptor_set{VK_NULL_HANDLE};
   VkPipelineLayout pipeline_layout{VK_NULL_HANDLE};
   VkPipeline pipeline{VK_NULL_HANDLE};
   VkDescriptorUpdateTemplateKHR descriptor_update_template{VK_NULL_HANDLE};
   bool use_ubo{false};
+
+  /*! \brief Get the descriptor set bound to the buffers, for the deferred path.
+   *
+   * The descriptor sets are cached by the bound buffers, so that
+   * kernels called with different arguments do not contend for one
+   * descriptor set.  The cache is dropped, after synchronizing the
+   * stream, when it is full or when a buffer was destroyed since the
+   * cached descriptor sets were written.
+   *
+   * \param device The device of the pipeline.
+   *
+   * \param buffers The buffers bound to the descriptor set, in binding order.
+   *
+   * \param[out] is_new Whether the descriptor set is newly allocated
+   * and needs to be written.
+   */
+  VkDescriptorSet GetDescriptorSet(VulkanDevice& device, const std::vector<VkBuffer>& buffers,
+                                   bool* is_new);
+
+  // The number of descriptors of each type in one descriptor set.
+  std::vector<VkDescriptorPoolSize> descriptor_set_pool_sizes;
+  // The descriptor pools of the deferred path.
+  std::vector<VkDescriptorPool> descriptor_pools;
+  // The number of descriptor sets allocated from `descriptor_pools`.
+  size_t num_descriptor_sets{0};
+  // The descriptor sets of the deferred path, keyed by the bound buffers.
+  std::map<std::vector<VkBuffer>, VkDescriptorSet> descriptor_set_cache;
+  // The value of VulkanBuffer::NumDestroyed() when the cache was last valid.
+  uint64_t descriptor_set_cache_epoch{0};
+  // Guards accesses to the descriptor sets.
+  std::mutex descriptor_set_mutex;
 };
 
 class VulkanModuleNode;
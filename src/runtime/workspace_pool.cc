@@ -23,6 +23,7 @@
  */
 #include "workspace_pool.h"
 
+#include <algorithm>
 #include <memory>
 
 namespace tvm {
@@ -30,6 +31,10 @@ namespace runtime {
 
 // page size.
 constexpr size_t kWorkspacePageSize = 4 << 10;
+// size of the first chunk of an arena, each new chunk doubles the size of the last one.
+constexpr size_t kWorkspaceArenaChunkSize = 64 << 10;
+// allocations larger than this go to the pool, which can reuse them across sizes.
+constexpr size_t kWorkspaceArenaMaxAllocSize = 1 << 20;
 
 class WorkspacePool::Pool {
  public:
@@ -133,8 +138,92 @@ class WorkspacePool::Pool {
   std::vector<Entry> allocated_;
 };
 
-WorkspacePool::WorkspacePool(DLDeviceType device_type, DeviceAPI* device)
-    : device_type_(device_type), device_(device) {}
+class WorkspacePool::Arena {
+ public:
+  // allocate from the top of the stack, or return nullptr for the pool to allocate.
+  void* Alloc(Device dev, DeviceAPI* device, size_t nbytes, Stats* stats) {
+    nbytes = (nbytes + (kTempAllocaAlignment - 1)) / kTempAllocaAlignment * kTempAllocaAlignment;
+    if (nbytes == 0) nbytes = kTempAllocaAlignment;
+    if (nbytes > kWorkspaceArenaMaxAllocSize) return nullptr;
+    size_t chunk = chunk_;
+    size_t offset = offset_;
+    while (chunk < chunks_.size() && chunks_[chunk].size - offset < nbytes) {
+      ++chunk;
+      offset = 0;
+    }
+    if (chunk == chunks_.size()) {
+      size_t size = chunks_.empty() ? kWorkspaceArenaChunkSize : chunks_.back().size * 2;
+      size = std::max(size, nbytes);
+      DLDataType type{kDLUInt, 8, 1};
+      void* data = device->AllocDataSpace(dev, size, kTempAllocaAlignment, type);
+      chunks_.push_back({static_cast<char*>(data), size});
+      ++stats->arena_chunks;
+    }
+    void* data = chunks_[chunk].data + offset;
+    stack_.push_back({data, chunk_, offset_, false});
+    chunk_ = chunk;
+    offset_ = offset + nbytes;
+    return data;
+  }
+  // whether the pointer is allocated from the arena
+  bool Owns(void* data) const {
+    const char* ptr = static_cast<const char*>(data);
+    for (const Chunk& chunk : chunks_) {
+      if (ptr >= chunk.data && ptr < chunk.data + chunk.size) return true;
+    }
+    return false;
+  }
+  // pop the allocation if it is the top of the stack, or defer it otherwise
+  void Free(void* data, Stats* stats) {
+    if (stack_.empty() || stack_.back().data != data) {
+      auto it = std::find_if(stack_.rbegin(), stack_.rend(),
+                             [data](const Frame& frame) { return frame.data == data; });
+      ICHECK(it != stack_.rend() && !it->freed)
+          << "trying to free things that has not been allocated";
+      it->freed = true;
+      ++stats->deferred_frees;
+      return;
+    }
+    stack_.back().freed = true;
+    while (!stack_.empty() && stack_.back().freed) {
+      chunk_ = stack_.back().chunk;
+      offset_ = stack_.back().offset;
+      stack_.pop_back();
+    }
+  }
+  // Release all resources
+  void Release(Device dev, DeviceAPI* device) {
+    for (const Chunk& chunk : chunks_) {
+      device->FreeDataSpace(dev, chunk.data);
+    }
+    chunks_.clear();
+  }
+
+ private:
+  /*! \brief a chunk of memory, never freed before the arena is released */
+  struct Chunk {
+    char* data;
+    size_t size;
+  };
+  /*! \brief an allocation, with the top of the stack before it */
+  struct Frame {
+    void* data;
+    size_t chunk;
+    size_t offset;
+    bool freed;
+  };
+  /*! \brief The chunks, each twice the size of the previous one */
+  std::vector<Chunk> chunks_;
+  /*! \brief The allocations, in the order they are made */
+  std::vector<Frame> stack_;
+  /*! \brief The chunk of the top of the stack */
+  size_t chunk_{0};
+  /*! \brief The used bytes of the chunk of the top of the stack */
+  size_t offset_{0};
+};
+
+WorkspacePool::WorkspacePool(DLDeviceType device_type, DeviceAPI* device, bool use_arena)
+    : use_arena_(use_arena), device_type_(device_type), device_(device) {}
 
 WorkspacePool::~WorkspacePool() {
   for (size_t i = 0; i < array_.size(); ++i) {
@@ -146,9 +235,31 @@ WorkspacePool::~WorkspacePool() {
       delete array_[i];
     }
   }
+  for (size_t i = 0; i < arena_array_.size(); ++i) {
+    if (arena_array_[i] != nullptr) {
+      Device dev;
+      dev.device_type = device_type_;
+      dev.device_id = static_cast<int>(i);
+      arena_array_[i]->Release(dev, device_);
+      delete arena_array_[i];
+    }
+  }
 }
 
 void* WorkspacePool::AllocWorkspace(Device dev, size_t size) {
+  if (use_arena_) {
+    if (static_cast<size_t>(dev.device_id) >= arena_array_.size()) {
+      arena_array_.resize(dev.device_id + 1, nullptr);
+    }
+    if (arena_array_[dev.device_id] == nullptr) {
+      arena_array_[dev.device_id] = new Arena();
+    }
+    if (void* data = arena_array_[dev.device_id]->Alloc(dev, device_, size, &stats_)) {
+      ++stats_.arena_allocs;
+      return data;
+    }
+  }
+  ++stats_.pool_allocs;
   if (static_cast<size_t>(dev.device_id) >= array_.size()) {
     array_.resize(dev.device_id + 1, nullptr);
   }
@@ -159,6 +270,11 @@ void* WorkspacePool::AllocWorkspace(Device dev, size_t size) {
 }
 
 void WorkspacePool::FreeWorkspace(Device dev, void* ptr) {
+  if (static_cast<size_t>(dev.device_id) < arena_array_.size() &&
+      arena_array_[dev.device_id] != nullptr && arena_array_[dev.device_id]->Owns(ptr)) {
+    arena_array_[dev.device_id]->Free(ptr, &stats_);
+    return;
+  }
   ICHECK(static_cast<size_t>(dev.device_id) < array_.size() && array_[dev.device_id] != nullptr);
   array_[dev.device_id]->Free(ptr);
 }
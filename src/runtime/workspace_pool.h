@@ -26,6 +26,7 @@
 
 #include <tvm/runtime/device_api.h>
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -41,15 +42,32 @@ namespace runtime {
  *  - Only a few allocation will happen, and space will be released after use.
  *  - The release order is usually in reverse order of allocate
  *  - Repeative pattern of same allocations over different runs.
+ *
+ *  When the pool is created with an arena, which is only safe for a pool used by a single
+ *  thread, the allocations are bumped from a grow-only list of chunks, and freed by popping
+ *  them. A free which is not the last allocation is deferred until the allocations after it
+ *  are freed. Allocations larger than kWorkspaceArenaMaxAllocSize fall back to the pool.
  */
 class TVM_DLL WorkspacePool {
  public:
+  /*! \brief The counters of the allocations of the pool. */
+  struct Stats {
+    /*! \brief The number of allocations bumped from the arena. */
+    uint64_t arena_allocs = 0;
+    /*! \brief The number of allocations done by the pool. */
+    uint64_t pool_allocs = 0;
+    /*! \brief The number of frees of the arena not in the reverse order of allocation. */
+    uint64_t deferred_frees = 0;
+    /*! \brief The number of chunks allocated by the arena. */
+    uint64_t arena_chunks = 0;
+  };
   /*!
    * \brief Create pool with specific device type and device.
    * \param device_type The device type.
    * \param device_api The device API.
+   * \param use_arena Whether to allocate from a stack arena before the pool.
    */
-  WorkspacePool(DLDeviceType device_type, DeviceAPI* device_api);
+  WorkspacePool(DLDeviceType device_type, DeviceAPI* device_api, bool use_arena = false);
   /*! \brief destructor */
   ~WorkspacePool();
   /*!
@@ -65,11 +83,20 @@ class TVM_DLL WorkspacePool {
    * \param ptr The pointer to be freed.
    */
   void FreeWorkspace(Device dev, void* ptr);
+  /*! \return The counters of the allocations of the pool. */
+  const Stats& stats() const { return stats_; }
 
  private:
   class Pool;
+  class Arena;
   /*! \brief pool of device local array */
   std::vector<Pool*> array_;
+  /*! \brief arena of device local array, empty if the pool has no arena */
+  std::vector<Arena*> arena_array_;
+  /*! \brief Whether to allocate from the arena */
+  bool use_arena_;
+  /*! \brief The counters of the allocations */
+  Stats stats_;
   /*! \brief device type this pool support */
   DLDeviceType device_type_;
   /*! \brief The device API */
@@ -17,6 +17,11 @@
  * under the License.
  */
 #include <tvm/ir/tensor_type.h>
+#include <tvm/support/parallel_for.h>
+
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
 
 #include "./utils.h"
 
@@ -55,59 +60,79 @@ struct SortableFunction {
   }
 };
 
+/*! \brief The functions of a module, in the order they are printed */
+std::vector<SortableFunction> SortedFunctions(const IRModule& mod) {
+  std::vector<SortableFunction> functions;
+  for (const auto& kv : mod->functions) {
+    functions.push_back(SortableFunction(kv));
+  }
+  std::sort(functions.begin(), functions.end());
+  return functions;
+}
+
+/*!
+ * \brief Define the module and its GlobalVars in the IRFrame, and add the statements of the
+ * module attributes and global infos to it.
+ * \return The name of the module
+ */
+IdDoc DefineModule(IRModule mod, const ObjectPath& p, const IRDocsifier& d, const IRFrame& f,
+                   const std::vector<SortableFunction>& functions) {
+  IdDoc module_doc = d->Define(mod, f, GetBindingName(d).value_or("Module"));
+  f->global_infos = &mod->global_infos;
+  if (mod->attrs.defined() && !mod->attrs->dict.empty()) {
+    f->stmts.push_back(
+        ExprStmtDoc(IR(d, "module_attrs")  //
+                        ->Call({d->AsDoc<ExprDoc>(mod->attrs, p->Attr("attrs"))})));
+  }
+  if (mod->global_infos.defined() && !mod->global_infos.empty()) {
+    f->stmts.push_back(ExprStmtDoc(
+        IR(d, "module_global_infos")  //
+            ->Call({d->AsDoc<ExprDoc>(mod->global_infos, p->Attr("global_infos"))})));
+  }
+  // Declare GlobalVars first
+  for (const auto& entry : functions) {
+    const GlobalVar& gv = entry.gv;
+    d->Define(gv, f, [=]() {
+      return d->AsDoc<ExprDoc>(mod, p->Attr("global_vars"))->Attr(gv->name_hint);
+    });
+  }
+  return module_doc;
+}
+
+/*! \brief Convert a function of a module into the statement defining it in the module */
+StmtDoc FunctionToStmtDoc(const GlobalVar& gv, const BaseFunc& base_func, const ObjectPath& p,
+                          const IRDocsifier& d) {
+  d->cfg->binding_names.push_back(gv->name_hint);
+  Doc doc = d->AsDoc(base_func, p->Attr("functions")->MapValue(gv));
+  d->cfg->binding_names.pop_back();
+  if (const auto* stmt_block = doc.as<StmtBlockDocNode>()) {
+    StmtDoc stmt = stmt_block->stmts.back();
+    stmt->source_paths = std::move(doc->source_paths);
+    return stmt;
+  } else if (auto stmt = doc.as<StmtDoc>()) {
+    return stmt.value();
+  } else if (auto func = doc.as<FunctionDoc>()) {
+    return func.value();
+  } else if (auto expr = doc.as<ExprDoc>()) {
+    ExprDoc lhs = IdDoc(gv->name_hint);
+    return AssignDoc(lhs, expr.value(), NullOpt);
+  }
+  LOG(FATAL) << "TypeError: "
+             << "Expected IRModule to only contain functions, "
+             << " but mod[" << gv->name_hint << "] with type  " << base_func->GetTypeKey()
+             << " produced Doc type of " << doc->GetTypeKey();
+  throw;
+}
+
 TVM_STATIC_IR_FUNCTOR(IRDocsifier, vtable)
     .set_dispatch<IRModule>("", [](IRModule mod, ObjectPath p, IRDocsifier d) -> Doc {
-      std::vector<SortableFunction> functions;
-      for (const auto& kv : mod->functions) {
-        functions.push_back(SortableFunction(kv));
-      }
-      std::sort(functions.begin(), functions.end());
+      std::vector<SortableFunction> functions = SortedFunctions(mod);
       With<IRFrame> f(d);
       (*f)->AddDispatchToken(d, "ir");
-      IdDoc module_doc = d->Define(mod, f(), GetBindingName(d).value_or("Module"));
-      (*f)->global_infos = &mod->global_infos;
-      if (mod->attrs.defined() && !mod->attrs->dict.empty()) {
-        (*f)->stmts.push_back(
-            ExprStmtDoc(IR(d, "module_attrs")  //
-                            ->Call({d->AsDoc<ExprDoc>(mod->attrs, p->Attr("attrs"))})));
-      }
-      if (mod->global_infos.defined() && !mod->global_infos.empty()) {
-        (*f)->stmts.push_back(ExprStmtDoc(
-            IR(d, "module_global_infos")  //
-                ->Call({d->AsDoc<ExprDoc>(mod->global_infos, p->Attr("global_infos"))})));
-      }
-      // Declare GlobalVars first
-      IdDoc module_alias = d->cfg->module_alias.empty() ? module_doc : IdDoc(d->cfg->module_alias);
-      for (const auto& entry : functions) {
-        const GlobalVar& gv = entry.gv;
-        d->Define(gv, f(), [=]() {
-          return d->AsDoc<ExprDoc>(mod, p->Attr("global_vars"))->Attr(gv->name_hint);
-        });
-      }
+      IdDoc module_doc = DefineModule(mod, p, d, *f, functions);
       // Print functions
       for (const auto& entry : functions) {
-        const GlobalVar& gv = entry.gv;
-        const BaseFunc& base_func = entry.func;
-        d->cfg->binding_names.push_back(gv->name_hint);
-        Doc doc = d->AsDoc(base_func, p->Attr("functions")->MapValue(gv));
-        d->cfg->binding_names.pop_back();
-        if (const auto* stmt_block = doc.as<StmtBlockDocNode>()) {
-          (*f)->stmts.push_back(stmt_block->stmts.back());
-          (*f)->stmts.back()->source_paths = std::move(doc->source_paths);
-        } else if (auto stmt = doc.as<StmtDoc>()) {
-          (*f)->stmts.push_back(stmt.value());
-        } else if (auto func = doc.as<FunctionDoc>()) {
-          (*f)->stmts.push_back(func.value());
-        } else if (auto expr = doc.as<ExprDoc>()) {
-          ExprDoc lhs = IdDoc(gv->name_hint);
-          AssignDoc assignment(lhs, expr.value(), NullOpt);
-          (*f)->stmts.push_back(assignment);
-        } else {
-          LOG(FATAL) << "TypeError: "
-                     << "Expected IRModule to only contain functions, "
-                     << " but mod[" << gv->name_hint << "] with type  " << base_func->GetTypeKey()
-                     << " produced Doc type of " << doc->GetTypeKey();
-        }
+        (*f)->stmts.push_back(FunctionToStmtDoc(entry.gv, entry.func, p, d));
       }
       return HeaderWrapper(d, ClassDoc(module_doc, {IR(d, "ir_module")}, (*f)->stmts));
     });
@@ -202,6 +227,132 @@ std::string ReprPrintIRModule(const ObjectRef& mod, const PrinterConfig& cfg) {
   return ReprPrintIR(mod, cfg);
 }
 
+/*! \brief Write the text into the body of a class, indenting each non-empty line */
+void WriteClassBodyLines(const std::string& text, int indent_spaces, std::ostream& os) {
+  std::string indent(indent_spaces, ' ');
+  size_t begin = 0;
+  while (true) {
+    size_t end = std::min(text.find('\n', begin), text.size());
+    os << '\n';
+    if (end > begin) {
+      os << indent;
+      os.write(text.data() + begin, end - begin);
+    }
+    if (end == text.size()) {
+      break;
+    }
+    begin = end + 1;
+  }
+}
+
+void IRModuleToScript(const IRModule& mod, const PrinterConfig& cfg, std::ostream& os,
+                      int num_threads) {
+  auto print_whole_module = [&]() { os << TVMScriptPrinter::Script(mod, cfg); };
+  // Line numbers and underlines refer to the whole script
+  if (cfg->print_line_numbers || !cfg->path_to_underline.empty() ||
+      !cfg->path_to_annotate.empty() || !cfg->obj_to_underline.empty() ||
+      !cfg->obj_to_annotate.empty()) {
+    return print_whole_module();
+  }
+  if (const auto* f = runtime::Registry::Get("relay.ir.PrintRelayModule")) {
+    if (Optional<String> s = (*f)(mod)) {
+      os << s.value();
+      return;
+    }
+  }
+  // Each function is printed by its own IRDocsifier, which holds the names of the module and
+  // of its GlobalVars, and only the text of the function is kept once it is printed.
+  std::vector<SortableFunction> functions = SortedFunctions(mod);
+  auto make_docsifier = [&]() {
+    return IRDocsifier(PrinterConfig(make_object<PrinterConfigNode>(*cfg.get())));
+  };
+  IRDocsifier d = make_docsifier();
+  With<IRFrame> f(d);
+  (*f)->AddDispatchToken(d, "ir");
+  IdDoc module_doc = DefineModule(mod, ObjectPath::Root(), d, *f, functions);
+  std::vector<std::string> prologue;
+  for (const StmtDoc& stmt : (*f)->stmts) {
+    prologue.push_back(DocToPythonScript(stmt, d->cfg));
+  }
+  std::unordered_set<std::string> ir_usage = d->ir_usage;
+  bool has_metadata = !d->metadata.empty();
+
+  struct PrintedFunction {
+    std::string text;
+    std::unordered_set<std::string> ir_usage;
+    bool is_function_doc{false};
+    bool has_metadata{false};
+  };
+  std::vector<PrintedFunction> printed(functions.size());
+  auto print_function = [&](int thread_id, int i) {
+    IRDocsifier func_d = make_docsifier();
+    With<IRFrame> func_f(func_d);
+    (*func_f)->AddDispatchToken(func_d, "ir");
+    DefineModule(mod, ObjectPath::Root(), func_d, *func_f, functions);
+    StmtDoc stmt =
+        FunctionToStmtDoc(functions[i].gv, functions[i].func, ObjectPath::Root(), func_d);
+    printed[i].text = DocToPythonScript(stmt, func_d->cfg);
+    printed[i].ir_usage = std::move(func_d->ir_usage);
+    printed[i].is_function_doc = stmt->IsInstance<FunctionDocNode>();
+    printed[i].has_metadata = !func_d->metadata.empty();
+  };
+  int num_functions = static_cast<int>(functions.size());
+  if (num_threads > 1 && num_functions > 1) {
+    support::parallel_for_dynamic(0, num_functions, num_threads, print_function);
+  } else {
+    for (int i = 0; i < num_functions; ++i) {
+      print_function(0, i);
+    }
+  }
+  for (const PrintedFunction& func : printed) {
+    ir_usage.insert(func.ir_usage.begin(), func.ir_usage.end());
+    has_metadata = has_metadata || func.has_metadata;
+  }
+  // The metadata of each function is indexed on its own, so it cannot be concatenated
+  if (has_metadata) {
+    return print_whole_module();
+  }
+
+  // The same text as HeaderWrapper over the ClassDoc of the module
+  ir_usage.insert("ir");
+  os << "# from tvm.script import ir as " << cfg->ir_prefix << '\n';
+  if (ir_usage.count("tir")) {
+    os << "# from tvm.script import tir as " << cfg->tir_prefix << '\n';
+  }
+  if (ir_usage.count("relax")) {
+    os << "# from tvm.script import relax as " << cfg->relax_prefix << '\n';
+  }
+  os << "\n@" << cfg->ir_prefix << ".ir_module\nclass " << module_doc->name << ":";
+  for (const std::string& text : prologue) {
+    WriteClassBodyLines(text, cfg->indent_spaces, os);
+  }
+  bool follows_function_doc = false;
+  for (const PrintedFunction& func : printed) {
+    if (follows_function_doc) {
+      os << '\n';
+    }
+    WriteClassBodyLines(func.text, cfg->indent_spaces, os);
+    follows_function_doc = func.is_function_doc;
+  }
+  if (prologue.empty() && printed.empty()) {
+    WriteClassBodyLines("pass", cfg->indent_spaces, os);
+  }
+}
+
+TVM_REGISTER_GLOBAL("script.printer.IRModuleToScript")
+    .set_body_typed([](IRModule mod, PrinterConfig cfg, int num_threads) -> String {
+      std::ostringstream os;
+      IRModuleToScript(mod, cfg, os, num_threads);
+      return os.str();
+    });
+
+TVM_REGISTER_GLOBAL("script.printer.IRModuleToScriptFile")
+    .set_body_typed([](IRModule mod, PrinterConfig cfg, String path, int num_threads) {
+      std::ofstream os(path);
+      CHECK(os) << "ValueError: Cannot open file " << path << " to print the module into";
+      IRModuleToScript(mod, cfg, os, num_threads);
+    });
+
 TVM_SCRIPT_REPR(TypeVarNode, ReprPrintIR);
 TVM_SCRIPT_REPR(GlobalTypeVarNode, ReprPrintIR);
 TVM_SCRIPT_REPR(GlobalVarNode, ReprPrintIR);
@@ -43,6 +43,10 @@
 #define TVM_INFO_USE_NVTX "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_CUPTI
+#define TVM_INFO_USE_CUPTI "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_NCCL
 #define TVM_INFO_USE_NCCL "NOT-FOUND"
 #endif
@@ -127,6 +131,10 @@
 #define TVM_INFO_USE_PROFILER "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_RELAX_SERVING_ENGINE
+#define TVM_INFO_USE_RELAX_SERVING_ENGINE "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_OPENMP
 #define TVM_INFO_USE_OPENMP "NOT-FOUND"
 #endif
@@ -167,6 +175,10 @@
 #define TVM_INFO_USE_FALLBACK_STL_MAP "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_POOLED_OBJECT_ALLOCATOR
+#define TVM_INFO_USE_POOLED_OBJECT_ALLOCATOR "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_BYODT_POSIT
 #define TVM_INFO_USE_BYODT_POSIT "NOT-FOUND"
 #endif
@@ -275,6 +287,10 @@
 #define TVM_INFO_USE_NVSHMEM "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_UCX
+#define TVM_INFO_USE_UCX "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_NNAPI_CODEGEN
 #define TVM_INFO_USE_NNAPI_CODEGEN "NOT-FOUND"
 #endif
@@ -322,6 +338,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_CUBLAS", TVM_INFO_USE_CUBLAS},
       {"USE_CUDA", TVM_INFO_USE_CUDA},
       {"USE_NVTX", TVM_INFO_USE_NVTX},
+      {"USE_CUPTI", TVM_INFO_USE_CUPTI},
       {"USE_NCCL", TVM_INFO_USE_NCCL},
       {"USE_MSCCL", TVM_INFO_USE_MSCCL},
       {"USE_CUDNN", TVM_INFO_USE_CUDNN},
@@ -331,6 +348,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_AMX", TVM_INFO_USE_AMX},
       {"USE_DNNL", TVM_INFO_USE_DNNL},
       {"USE_FALLBACK_STL_MAP", TVM_INFO_USE_FALLBACK_STL_MAP},
+      {"USE_POOLED_OBJECT_ALLOCATOR", TVM_INFO_USE_POOLED_OBJECT_ALLOCATOR},
       {"USE_GRAPH_EXECUTOR_CUDA_GRAPH", TVM_INFO_USE_GRAPH_EXECUTOR_CUDA_GRAPH},
       {"USE_GRAPH_EXECUTOR", TVM_INFO_USE_GRAPH_EXECUTOR},
       {"USE_GTEST", TVM_INFO_USE_GTEST},
@@ -360,6 +378,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_PROFILER", TVM_INFO_USE_PROFILER},
       {"USE_PT_TVMDSOOP", TVM_INFO_USE_PT_TVMDSOOP},
       {"USE_RANDOM", TVM_INFO_USE_RANDOM},
+      {"USE_RELAX_SERVING_ENGINE", TVM_INFO_USE_RELAX_SERVING_ENGINE},
       {"USE_RELAY_DEBUG", TVM_INFO_USE_RELAY_DEBUG},
       {"TVM_DEBUG_WITH_ABI_CHANGE", TVM_INFO_TVM_DEBUG_WITH_ABI_CHANGE},
       {"TVM_LOG_BEFORE_THROW", TVM_INFO_TVM_LOG_BEFORE_THROW},
@@ -392,6 +411,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_MSC", TVM_INFO_USE_MSC},
       {"USE_CCACHE", TVM_INFO_USE_CCACHE},
       {"USE_NVSHMEM", TVM_INFO_USE_NVSHMEM},
+      {"USE_UCX", TVM_INFO_USE_UCX},
       {"USE_NNAPI_CODEGEN", TVM_INFO_USE_NNAPI_CODEGEN},
       {"USE_NNAPI_RUNTIME", TVM_INFO_USE_NNAPI_RUNTIME},
       {"BACKTRACE_ON_SEGFAULT", TVM_INFO_BACKTRACE_ON_SEGFAULT},
@@ -0,0 +1,276 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file shared_memory_ring.h
+ * \brief Single-producer single-consumer ring buffer in shared memory, used for IPC
+ *  between the processes of a machine without a system call per message.
+ */
+#ifndef TVM_SUPPORT_SHARED_MEMORY_RING_H_
+#define TVM_SUPPORT_SHARED_MEMORY_RING_H_
+
+#include <dmlc/io.h>
+#include <tvm/runtime/logging.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <memory>
+#endif
+
+namespace tvm {
+namespace support {
+
+#ifdef __linux__
+
+/*!
+ * \brief The control block of a ring, at the start of its shared memory.
+ *  The positions count the bytes ever written and read, the sequence numbers are
+ *  the futex words the reader and the writer sleep on.
+ */
+struct SharedMemoryRingHeader {
+  alignas(64) std::atomic<uint64_t> write_pos;
+  alignas(64) std::atomic<uint64_t> read_pos;
+  alignas(64) std::atomic<uint32_t> write_seq;
+  std::atomic<uint32_t> reader_waiting;
+  alignas(64) std::atomic<uint32_t> read_seq;
+  std::atomic<uint32_t> writer_waiting;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                  std::atomic<uint64_t>::is_always_lock_free,
+              "The shared memory ring requires lock-free atomics");
+
+/*!
+ * \brief One direction of a shared memory channel, as a stream.
+ *
+ *  The reader and the writer spin for a while when the ring is empty or full, and then
+ *  sleep on a futex, which the other side only wakes when someone sleeps on it.
+ *  Neither side makes a system call as long as the other keeps up.
+ *
+ *  The memory is zero-initialized by the creator of the shared memory, e.g. by
+ *  ftruncate on a memfd.  A pipe between the two processes is used to detect the other
+ *  side exiting: it gets POLLHUP or POLLERR once all the file descriptors of the other
+ *  end are closed.
+ */
+class SharedMemoryRing : public dmlc::Stream {
+ public:
+  /*! \brief The size of the control block, keeping the data page-aligned. */
+  static constexpr size_t kHeaderBytes = 4096;
+
+  /*!
+   * \brief Construct the ring on a region of mapped shared memory.
+   * \param region The start of the region.
+   * \param region_bytes The size of the region, including the control block.
+   * \param peer_fd The file descriptor of the local end of a pipe to the other process.
+   */
+  SharedMemoryRing(void* region, size_t region_bytes, int peer_fd)
+      : header_(static_cast<SharedMemoryRingHeader*>(region)),
+        data_(static_cast<char*>(region) + kHeaderBytes),
+        capacity_(region_bytes - kHeaderBytes),
+        peer_fd_(peer_fd) {
+    static_assert(sizeof(SharedMemoryRingHeader) <= kHeaderBytes);
+    ICHECK_GT(region_bytes, kHeaderBytes);
+  }
+
+  using Stream::Read;
+  using Stream::Write;
+
+  /*!
+   * \brief Read data from the ring, blocking until all is read.
+   * \return The size of data read, which is less than size only if the writer exited.
+   */
+  size_t Read(void* ptr, size_t size) final {
+    size_t nread = 0;
+    while (nread < size) {
+      uint64_t read_pos = header_->read_pos.load(std::memory_order_relaxed);
+      uint64_t write_pos = header_->write_pos.load();
+      if (write_pos == read_pos) {
+        auto readable = [&]() { return header_->write_pos.load() != read_pos; };
+        if (!Wait(&header_->write_seq, &header_->reader_waiting, readable)) break;
+        continue;
+      }
+      size_t chunk = std::min<uint64_t>(size - nread, write_pos - read_pos);
+      CopyFromRing(read_pos, static_cast<char*>(ptr) + nread, chunk);
+      header_->read_pos.store(read_pos + chunk);
+      Notify(&header_->read_seq, &header_->writer_waiting);
+      nread += chunk;
+    }
+    return nread;
+  }
+
+  /*! \brief Write data to the ring, blocking until all is written. */
+  size_t Write(const void* ptr, size_t size) final {
+    size_t nwrite = 0;
+    while (nwrite < size) {
+      uint64_t write_pos = header_->write_pos.load(std::memory_order_relaxed);
+      uint64_t read_pos = header_->read_pos.load();
+      if (write_pos - read_pos == capacity_) {
+        auto writable = [&]() { return write_pos - header_->read_pos.load() < capacity_; };
+        ICHECK(Wait(&header_->read_seq, &header_->writer_waiting, writable))
+            << "Write Error: the reader of the shared memory ring exited";
+        continue;
+      }
+      size_t chunk = std::min<uint64_t>(size - nwrite, capacity_ - (write_pos - read_pos));
+      CopyToRing(write_pos, static_cast<const char*>(ptr) + nwrite, chunk);
+      header_->write_pos.store(write_pos + chunk);
+      Notify(&header_->write_seq, &header_->reader_waiting);
+      nwrite += chunk;
+    }
+    return nwrite;
+  }
+
+ private:
+  /*! \brief The number of checks before sleeping on the futex. */
+  static constexpr int kSpinCount = 1 << 14;
+  /*! \brief The interval of checking whether the other side exited while sleeping. */
+  static constexpr int64_t kPeerCheckIntervalNs = 100 * 1000 * 1000;
+
+  void CopyFromRing(uint64_t pos, char* dst, size_t size) const {
+    size_t offset = pos % capacity_;
+    size_t first = std::min(size, capacity_ - offset);
+    std::memcpy(dst, data_ + offset, first);
+    std::memcpy(dst + first, data_, size - first);
+  }
+
+  void CopyToRing(uint64_t pos, const char* src, size_t size) {
+    size_t offset = pos % capacity_;
+    size_t first = std::min(size, capacity_ - offset);
+    std::memcpy(data_ + offset, src, first);
+    std::memcpy(data_, src + first, size - first);
+  }
+
+  /*!
+   * \brief Wait until ready() holds.
+   * \return Whether ready() holds, which is false only if the other side exited.
+   */
+  template <typename FReady>
+  bool Wait(std::atomic<uint32_t>* seq, std::atomic<uint32_t>* waiting, FReady ready) {
+    for (int i = 0; i < kSpinCount; ++i) {
+      if (ready()) return true;
+    }
+    while (true) {
+      uint32_t cur_seq = seq->load();
+      // The other side checks `waiting` after bumping `seq`, so that either it wakes us up,
+      // or we observe its update below and do not sleep.
+      waiting->store(1);
+      if (ready()) {
+        waiting->store(0);
+        return true;
+      }
+      struct timespec timeout = {0, kPeerCheckIntervalNs};
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(seq), FUTEX_WAIT, cur_seq, &timeout, nullptr,
+              0);
+      waiting->store(0);
+      if (ready()) return true;
+      if (PeerExited()) return ready();
+    }
+  }
+
+  void Notify(std::atomic<uint32_t>* seq, std::atomic<uint32_t>* waiting) {
+    seq->fetch_add(1);
+    if (waiting->load()) {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(seq), FUTEX_WAKE, INT_MAX, nullptr, nullptr,
+              0);
+    }
+  }
+
+  bool PeerExited() const {
+    struct pollfd pfd = {peer_fd_, 0, 0};
+    return poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLHUP | POLLERR));
+  }
+
+  SharedMemoryRingHeader* header_;
+  char* data_;
+  size_t capacity_;
+  int peer_fd_;
+};
+
+/*!
+ * \brief A duplex channel of two shared memory rings in a memory file.
+ *  The first half of the file holds the forward ring, the second half the backward ring.
+ */
+class SharedMemoryChannel {
+ public:
+  /*!
+   * \brief Map the memory file of the channel, and close the file descriptor.
+   * \param shm_fd The file descriptor of the memory file, whose size is even.
+   * \param forward_peer_fd The local end of a pipe to the other process, for the forward ring.
+   * \param backward_peer_fd The local end of a pipe to the other process, for the backward ring.
+   */
+  SharedMemoryChannel(int shm_fd, int forward_peer_fd, int backward_peer_fd) {
+    struct stat st;
+    ICHECK_EQ(fstat(shm_fd, &st), 0) << "Cannot stat the shared memory: " << strerror(errno);
+    nbytes_ = static_cast<size_t>(st.st_size);
+    ICHECK_EQ(nbytes_ % 2, 0) << "The shared memory of a channel should have an even size";
+    base_ = mmap(nullptr, nbytes_, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    ICHECK(base_ != MAP_FAILED) << "Cannot map the shared memory: " << strerror(errno);
+    close(shm_fd);
+    char* region = static_cast<char*>(base_);
+    forward_ = std::make_unique<SharedMemoryRing>(region, nbytes_ / 2, forward_peer_fd);
+    backward_ =
+        std::make_unique<SharedMemoryRing>(region + nbytes_ / 2, nbytes_ / 2, backward_peer_fd);
+  }
+
+  ~SharedMemoryChannel() {
+    forward_.reset();
+    backward_.reset();
+    munmap(base_, nbytes_);
+  }
+
+  dmlc::Stream* forward() { return forward_.get(); }
+  dmlc::Stream* backward() { return backward_.get(); }
+
+ private:
+  void* base_;
+  size_t nbytes_;
+  std::unique_ptr<SharedMemoryRing> forward_;
+  std::unique_ptr<SharedMemoryRing> backward_;
+};
+
+#else
+
+/*! \brief The shared memory channel, which is only supported on Linux. */
+class SharedMemoryChannel {
+ public:
+  SharedMemoryChannel(int shm_fd, int forward_peer_fd, int backward_peer_fd) {
+    LOG(FATAL) << "ValueError: The shared memory channel is only supported on Linux";
+  }
+
+  dmlc::Stream* forward() { return nullptr; }
+  dmlc::Stream* backward() { return nullptr; }
+};
+
+#endif  // __linux__
+
+}  // namespace support
+}  // namespace tvm
+
+#endif  // TVM_SUPPORT_SHARED_MEMORY_RING_H_
@@ -73,6 +73,8 @@ runtime::Module Build(IRModule mod, Target target) {
   return (*bf)(mod, target);
 }
 
+TVM_REGISTER_PASS_CONFIG_OPTION("target.lazy_import_modules", Bool);
+
 /*! \brief Helper class to serialize module */
 class ModuleSerializer {
  public:
@@ -83,8 +85,14 @@ class ModuleSerializer {
     // we will not produce import_tree_.
     bool has_import_tree = true;
 
+    // Only the loader of libraries supports the modules imported lazily.
+    bool lazy_import = false;
+
     if (export_dso) {
       has_import_tree = !mod_->imports().empty();
+      lazy_import = transform::PassContext::Current()
+                        ->GetConfig<Bool>("target.lazy_import_modules", Bool(false))
+                        .value();
     }
 
     uint64_t sz = 0;
@@ -110,8 +118,19 @@ class ModuleSerializer {
         } else if (group[0]->IsBinarySerializable()) {
           ICHECK_EQ(group.size(), 1U) << "Non DSO module is never merged";
           std::string mod_type_key = group[0]->type_key();
-          stream->Write(mod_type_key);
-          group[0]->SaveToBinary(stream);
+          if (lazy_import) {
+            // The binary is prefixed with its size, so that the loader can skip it.
+            std::string lazy_key = "_lazy";
+            std::string mod_bytes;
+            dmlc::MemoryStringStream mod_stream(&mod_bytes);
+            group[0]->SaveToBinary(&mod_stream);
+            stream->Write(lazy_key);
+            stream->Write(mod_type_key);
+            stream->Write(mod_bytes);
+          } else {
+            stream->Write(mod_type_key);
+            group[0]->SaveToBinary(stream);
+          }
         }
       } else {
         ICHECK(group[0]->IsBinarySerializable())
@@ -279,6 +298,7 @@ runtime::Module DeserializeModuleFromBytes(std::string blob) {
     // "_lib" serves as a placeholder in the module import tree to indicate where
     // to place the DSOModule
     ICHECK(tkey != "_lib") << "Should not contain any placeholder for DSOModule.";
+    ICHECK(tkey != "_lazy") << "Should not contain any module imported lazily.";
     if (tkey == "_import_tree") {
       ICHECK(stream->Read(&import_tree_row_ptr));
       ICHECK(stream->Read(&import_tree_child_indices));
@@ -0,0 +1,115 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file compile_cache.cc
+ * \brief A persistent on-disk cache of the code generated by the target backends.
+ */
+#include "compile_cache.h"
+
+#include <dmlc/memory_io.h>
+#include <tvm/ir/transform.h>
+#include <tvm/node/serialization.h>
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+#include "../support/utils.h"
+
+namespace tvm {
+namespace codegen {
+
+TVM_REGISTER_PASS_CONFIG_OPTION("target.compile_cache_dir", String);
+
+std::optional<CompileCache> CompileCache::Current() {
+  Optional<String> dir =
+      transform::PassContext::Current()->GetConfig<String>("target.compile_cache_dir");
+  if (!dir || dir.value().empty()) {
+    return std::nullopt;
+  }
+  return CompileCache(dir.value());
+}
+
+std::string CompileCache::EntryPath(const Optional<IRModule>& mod, const std::string& key) const {
+  uint64_t hash = mod ? StructuralHash()(mod.value()) : 0;
+  hash = support::HashCombine(hash, StructuralHash()(String(key)));
+  std::ostringstream os;
+  os << dir_ << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".tvmcache";
+  return os.str();
+}
+
+std::optional<std::string> CompileCache::Lookup(const Optional<IRModule>& mod,
+                                                const std::string& key) const {
+  std::ifstream fs(EntryPath(mod, key), std::ios::in | std::ios::binary);
+  if (fs.fail()) {
+    return std::nullopt;
+  }
+  std::string blob((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+  dmlc::MemoryStringStream stream(&blob);
+  std::string stored_key, stored_mod, code;
+  if (!stream.Read(&stored_key) || !stream.Read(&stored_mod) || !stream.Read(&code)) {
+    LOG(WARNING) << "Ignoring the corrupted compile cache entry " << EntryPath(mod, key);
+    return std::nullopt;
+  }
+  if (stored_key != key) {
+    return std::nullopt;
+  }
+  if (mod && !StructuralEqual()(LoadJSON(stored_mod), mod.value())) {
+    return std::nullopt;
+  }
+  return code;
+}
+
+void CompileCache::Store(const Optional<IRModule>& mod, const std::string& key,
+                         const std::string& code) const {
+  std::string blob;
+  dmlc::MemoryStringStream stream(&blob);
+  stream.Write(key);
+  stream.Write(mod ? SaveJSON(mod.value()) : std::string());
+  stream.Write(code);
+
+  // Write to a unique temporary file first, so that readers never observe partial entries.
+  static std::atomic<uint64_t> counter{0};
+  static const uint64_t process_token = std::random_device()();
+  std::string path = EntryPath(mod, key);
+  std::ostringstream tmp_path;
+  tmp_path << path << ".tmp." << std::hex << process_token << "." << counter++;
+  {
+    std::ofstream fs(tmp_path.str(), std::ios::out | std::ios::binary);
+    if (fs.fail()) {
+      LOG(WARNING) << "Cannot write the compile cache entry " << tmp_path.str();
+      return;
+    }
+    fs.write(blob.data(), blob.size());
+  }
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Cannot write the compile cache entry " << path;
+    std::remove(tmp_path.str().c_str());
+  }
+}
+
+}  // namespace codegen
+}  // namespace tvm
@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file compile_cache.h
+ * \brief A persistent on-disk cache of the code generated by the target backends.
+ */
+#ifndef TVM_TARGET_COMPILE_CACHE_H_
+#define TVM_TARGET_COMPILE_CACHE_H_
+
+#include <tvm/ir/module.h>
+
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace tvm {
+namespace codegen {
+
+/*!
+ * \brief A content-addressed cache of compiled code, e.g. LLVM bitcode or PTX.
+ *
+ * Each entry is addressed by the structural hash of the compiled IRModule and a key describing
+ * the other inputs of the compilation, such as the target and the compiler version. An entry is
+ * only returned if the stored module is structurally equal to the compiled one and the keys
+ * match, so hash collisions fall back to compilation.
+ *
+ * The cache is enabled by setting the "target.compile_cache_dir" pass config to an existing
+ * directory. Entries are written atomically, so several processes may share the directory, and
+ * failures to write them are only reported as warnings.
+ */
+class CompileCache {
+ public:
+  explicit CompileCache(std::string dir) : dir_(std::move(dir)) {}
+
+  /*! \return The cache of the current PassContext, or std::nullopt if it is disabled. */
+  static std::optional<CompileCache> Current();
+
+  /*!
+   * \brief Look up the compiled code of a module.
+   * \param mod The compiled module, or NullOpt if the key describes the whole input.
+   * \param key The other inputs of the compilation.
+   * \return The cached code, or std::nullopt on a cache miss.
+   */
+  std::optional<std::string> Lookup(const Optional<IRModule>& mod, const std::string& key) const;
+
+  /*!
+   * \brief Store the compiled code of a module.
+   * \param mod The compiled module, or NullOpt if the key describes the whole input.
+   * \param key The other inputs of the compilation.
+   * \param code The compiled code.
+   */
+  void Store(const Optional<IRModule>& mod, const std::string& key, const std::string& code) const;
+
+ private:
+  /*! \brief The path of the entry of the module and key. */
+  std::string EntryPath(const Optional<IRModule>& mod, const std::string& key) const;
+
+  /*! \brief The cache directory. */
+  std::string dir_;
+};
+
+}  // namespace codegen
+}  // namespace tvm
+
+#endif  // TVM_TARGET_COMPILE_CACHE_H_
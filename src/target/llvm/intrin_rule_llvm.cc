@@ -174,6 +174,36 @@ TVM_REGISTER_OP("tir.clz").set_attr<FLegalize>("llvm.FLegalize", [](const PrimEx
   return cast(call->dtype, clz);
 });
 
+/*
+ * The polynomial approximations used instead of libm and the LLVM intrinsics in the functions
+ * with the "tir.fast_math" attribute.  They are plain arithmetic, which LLVM vectorizes for the
+ * vector units of the target, e.g. AVX2, AVX-512, NEON or SVE, where the calls to libm are
+ * scalarized.  The types other than float32 are left to the regular rules.
+ */
+template <PrimExpr (*fapprox)(PrimExpr)>
+PrimExpr DispatchFastMathFloat32(const PrimExpr& e) {
+  const tir::CallNode* call = e.as<tir::CallNode>();
+  ICHECK(call != nullptr);
+  const PrimExpr& x = call->args[0];
+  if (!x.dtype().is_float() || x.dtype().bits() != 32) {
+    return e;
+  }
+  return fapprox(x);
+}
+
+PrimExpr FastExp(PrimExpr x) { return fast_exp_float_expr(x); }
+PrimExpr FastTanh(PrimExpr x) { return fast_tanh_float_expr(x, 32); }
+PrimExpr FastErf(PrimExpr x) { return fast_erf_float_expr(x, 32); }
+
+TVM_REGISTER_OP("tir.exp").set_attr<FLegalize>("llvm.FLegalizeFastMath",
+                                               DispatchFastMathFloat32<FastExp>);
+
+TVM_REGISTER_OP("tir.tanh").set_attr<FLegalize>("llvm.FLegalizeFastMath",
+                                                DispatchFastMathFloat32<FastTanh>);
+
+TVM_REGISTER_OP("tir.erf").set_attr<FLegalize>("llvm.FLegalizeFastMath",
+                                               DispatchFastMathFloat32<FastErf>);
+
 }  // namespace legalize
 }  // namespace llvm
 }  // namespace codegen
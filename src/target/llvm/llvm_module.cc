@@ -29,6 +29,7 @@
 #include <llvm/ADT/SmallString.h>
 #include <llvm/ADT/StringRef.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/MCJIT.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
@@ -44,6 +45,7 @@
 #include <llvm/IR/Metadata.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IRReader/IRReader.h>
+#include <llvm/Linker/Linker.h>
 #include <llvm/Support/FileSystem.h>
 #if TVM_LLVM_VERSION >= 180
 #include <llvm/TargetParser/Host.h>
@@ -65,21 +67,29 @@
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/ir/transform.h>
+#include <tvm/support/parallel_for.h>
 #include <tvm/support/with.h>
 #include <tvm/target/codegen.h>
 #include <tvm/target/target.h>
+#include <tvm/tir/stmt_functor.h>
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <system_error>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "../../runtime/file_utils.h"
 #include "../../runtime/library_module.h"
+#include "../compile_cache.h"
 #include "../func_registry_generator.h"
 #include "codegen_blob.h"
 #include "codegen_cpu.h"
@@ -321,11 +331,144 @@ String LLVMModuleNode::GetSource(const String& format) {
   return "";
 }
 
+namespace {
+
+using FunctionList = std::vector<std::pair<GlobalVar, tir::PrimFunc>>;
+
+/*!
+ * \brief Partition the PrimFuncs of a module into at most num_parts lists.
+ *
+ * Functions calling each other stay in the same part, as internal functions are only visible
+ * inside their own LLVM module. The parts are balanced by the number of IR nodes and only depend
+ * on the module content, which keeps the linked module deterministic.
+ */
+std::vector<FunctionList> PartitionFunctions(const IRModule& mod, int num_parts) {
+  FunctionList funcs;
+  for (const auto& [gvar, base_func] : mod->functions) {
+    if (auto func = base_func.as<tir::PrimFunc>()) {
+      funcs.emplace_back(gvar, func.value());
+    }
+  }
+  std::sort(funcs.begin(), funcs.end(), [](const auto& a, const auto& b) {
+    return a.first->name_hint < b.first->name_hint;
+  });
+
+  std::unordered_map<const GlobalVarNode*, size_t> func_index;
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    func_index[funcs[i].first.get()] = i;
+  }
+  // Union-find over the call graph.
+  std::vector<size_t> parent(funcs.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find_root = [&parent](size_t i) {
+    while (parent[i] != i) {
+      i = parent[i] = parent[parent[i]];
+    }
+    return i;
+  };
+  std::vector<size_t> func_sizes(funcs.size(), 0);
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    tir::PostOrderVisit(funcs[i].second->body, [&](const ObjectRef& obj) {
+      ++func_sizes[i];
+      const auto* call = obj.as<tir::CallNode>();
+      const auto* callee = call ? call->op.as<GlobalVarNode>() : nullptr;
+      if (auto it = func_index.find(callee); callee && it != func_index.end()) {
+        size_t a = find_root(i);
+        size_t b = find_root(it->second);
+        parent[std::max(a, b)] = std::min(a, b);
+      }
+    });
+  }
+
+  std::vector<FunctionList> components;
+  std::vector<size_t> component_sizes;
+  std::unordered_map<size_t, size_t> component_of_root;
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    auto [it, inserted] = component_of_root.emplace(find_root(i), components.size());
+    if (inserted) {
+      components.emplace_back();
+      component_sizes.push_back(0);
+    }
+    components[it->second].push_back(funcs[i]);
+    component_sizes[it->second] += func_sizes[i];
+  }
+
+  // Assign the largest components first, each to the least loaded part.
+  std::vector<size_t> order(components.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&component_sizes](size_t a, size_t b) {
+    return component_sizes[a] > component_sizes[b];
+  });
+  std::vector<FunctionList> parts(std::min<size_t>(num_parts, components.size()));
+  std::vector<size_t> loads(parts.size(), 0);
+  for (size_t c : order) {
+    size_t part = std::min_element(loads.begin(), loads.end()) - loads.begin();
+    loads[part] += component_sizes[c];
+    parts[part].insert(parts[part].end(), components[c].begin(), components[c].end());
+  }
+  return parts;
+}
+
+/*! \brief Whether the part contains the function with the global symbol. */
+bool HasGlobalSymbol(const FunctionList& funcs, const std::string& global_symbol) {
+  return std::any_of(funcs.begin(), funcs.end(), [&](const auto& kv) {
+    return kv.second->template GetAttr<String>(tvm::attr::kGlobalSymbol).value_or("") ==
+           global_symbol;
+  });
+}
+
+/*!
+ * \brief Generate and optimize the LLVM module of a part in its own LLVM context.
+ * \return The bitcode of the module.
+ */
+std::string CodeGenPart(const FunctionList& funcs, const Target& target,
+                        const std::string& entry_func, bool target_c_runtime) {
+  // LLVMTarget saves and restores the global LLVM options when it is created and destroyed.
+  static std::mutex llvm_target_mutex;
+  LLVMInstance llvm_instance;
+  std::unique_ptr<With<LLVMTarget>> llvm_target;
+  {
+    std::lock_guard<std::mutex> lock(llvm_target_mutex);
+    llvm_target = std::make_unique<With<LLVMTarget>>(llvm_instance, target);
+  }
+  std::string bitcode;
+  {
+    std::unique_ptr<CodeGenLLVM> cg = CodeGenLLVM::Create(llvm_target->get());
+    cg->Init("TVMMod", llvm_target->get(), NullOpt, false, target_c_runtime);
+    cg->SetFastMathFlags((*llvm_target)->GetFastMathFlags());
+    cg->AddFunctionsOrdered(funcs.begin(), funcs.end());
+    if (entry_func.length() != 0 && HasGlobalSymbol(funcs, entry_func)) {
+      cg->AddMainFunction(entry_func);
+    }
+    std::unique_ptr<llvm::Module> module = cg->Finish();
+    llvm::raw_string_ostream os(bitcode);
+#if TVM_LLVM_VERSION <= 60
+    llvm::WriteBitcodeToFile(module.get(), os);
+#else
+    llvm::WriteBitcodeToFile(*module, os);
+#endif
+    os.flush();
+  }
+  std::lock_guard<std::mutex> lock(llvm_target_mutex);
+  llvm_target.reset();
+  return bitcode;
+}
+
+}  // namespace
+
 void LLVMModuleNode::Init(const IRModule& mod, const Target& target) {
   llvm_instance_ = std::make_unique<LLVMInstance>();
   With<LLVMTarget> llvm_target(*llvm_instance_, target);
   llvm::TargetMachine* tm = llvm_target->GetOrCreateTargetMachine();
-  std::unique_ptr<CodeGenLLVM> cg = CodeGenLLVM::Create(llvm_target.get());
+
+  int num_parallel_modules =
+      transform::PassContext::Current()
+          ->GetConfig<Integer>("llvm.num_parallel_modules", Integer(1))
+          .value()
+          ->value;
+  CHECK_GE(num_parallel_modules, 1)
+      << "ValueError: llvm.num_parallel_modules must be positive, but got "
+      << num_parallel_modules;
 
   std::string entry_func;
   relay::Runtime runtime =
@@ -361,16 +504,64 @@ void LLVMModuleNode::Init(const IRModule& mod, const Target& target) {
   // ICHECK(funcs.size() > 0);
   // TODO(tqchen): remove the entry function behavior as it does not
   // makes sense when we start to use multiple modules.
-  cg->Init("TVMMod", llvm_target.get(), system_lib_prefix, system_lib_prefix.defined(),
-           target_c_runtime);
-  cg->SetFastMathFlags(llvm_target->GetFastMathFlags());
 
-  cg->AddFunctionsOrdered(mod->functions.begin(), mod->functions.end());
-  if (entry_func.length() != 0) {
-    cg->AddMainFunction(entry_func);
+  // The system library and the C runtime register all functions from a single startup function,
+  // and the LLVM command line options are global state, so these are always built serially.
+  bool can_partition = !system_lib_prefix.defined() && !target_c_runtime &&
+                       llvm_target->GetCommandLineOptions().empty();
+  std::optional<CompileCache> cache = can_partition ? CompileCache::Current() : std::nullopt;
+  std::vector<FunctionList> parts;
+  if (cache) {
+    // Cache every call graph component on its own, so that only the changed ones are compiled.
+    parts = PartitionFunctions(mod, std::numeric_limits<int>::max());
+  } else if (can_partition && num_parallel_modules > 1) {
+    parts = PartitionFunctions(mod, num_parallel_modules);
   }
+  if (parts.size() > 1 || (cache && !parts.empty())) {
+    std::vector<std::string> bitcodes(parts.size());
+    int num_threads = std::min<int>({static_cast<int>(parts.size()), num_parallel_modules,
+                                     static_cast<int>(std::thread::hardware_concurrency())});
+    support::parallel_for_dynamic(0, parts.size(), std::max(num_threads, 1), [&](int, int i) {
+      Optional<IRModule> part_mod;
+      std::ostringstream key;
+      if (cache) {
+        Map<GlobalVar, BaseFunc> part_funcs;
+        for (const auto& [gvar, func] : parts[i]) {
+          part_funcs.Set(gvar, func);
+        }
+        part_mod = IRModule(part_funcs);
+        key << "llvm.bc tvm=" << TVM_VERSION << " llvm=" << LLVM_VERSION_STRING
+            << " target=" << target->str() << " entry="
+            << (HasGlobalSymbol(parts[i], entry_func) ? entry_func : "");
+        if (std::optional<std::string> bitcode = cache->Lookup(part_mod, key.str())) {
+          bitcodes[i] = std::move(bitcode.value());
+          return;
+        }
+      }
+      bitcodes[i] = CodeGenPart(parts[i], target, entry_func, target_c_runtime);
+      if (cache) {
+        cache->Store(part_mod, key.str(), bitcodes[i]);
+      }
+    });
+    // Link in the order of the parts, so that the result does not depend on the scheduling.
+    module_owning_ptr_ = llvm_instance_->ParseIR(bitcodes[0]);
+    for (size_t i = 1; i < bitcodes.size(); ++i) {
+      ICHECK(!llvm::Linker::linkModules(*module_owning_ptr_, llvm_instance_->ParseIR(bitcodes[i])))
+          << "Failed to link modules";
+    }
+  } else {
+    std::unique_ptr<CodeGenLLVM> cg = CodeGenLLVM::Create(llvm_target.get());
+    cg->Init("TVMMod", llvm_target.get(), system_lib_prefix, system_lib_prefix.defined(),
+             target_c_runtime);
+    cg->SetFastMathFlags(llvm_target->GetFastMathFlags());
+
+    cg->AddFunctionsOrdered(mod->functions.begin(), mod->functions.end());
+    if (entry_func.length() != 0) {
+      cg->AddMainFunction(entry_func);
+    }
 
-  module_owning_ptr_ = cg->Finish();
+    module_owning_ptr_ = cg->Finish();
+  }
   module_ = module_owning_ptr_.get();
   jit_engine_ = llvm_target->GetJITEngine();
   llvm_target->SetTargetMetadata(module_);
@@ -627,6 +818,8 @@ void* LLVMModuleNode::GetFunctionAddr(const std::string& name,
   return nullptr;
 }
 
+TVM_REGISTER_PASS_CONFIG_OPTION("llvm.num_parallel_modules", Integer);
+
 TVM_REGISTER_GLOBAL("target.build.llvm")
     .set_body_typed([](IRModule mod, Target target) -> runtime::Module {
       auto n = make_object<LLVMModuleNode>();
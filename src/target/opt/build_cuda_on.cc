@@ -30,10 +30,12 @@
 #include <nvrtc.h>
 
 #include <cstdlib>
+#include <sstream>
 
 #include "../../runtime/cuda/cuda_common.h"
 #include "../../runtime/cuda/cuda_module.h"
 #include "../build_common.h"
+#include "../compile_cache.h"
 #include "../source/codegen_cuda.h"
 
 namespace tvm {
@@ -155,10 +157,31 @@ runtime::Module BuildCUDA(IRModule mod, Target target) {
   }
   std::string fmt = "ptx";
   std::string ptx;
+  const auto* f_compile = Registry::Get("tvm_callback_cuda_compile");
+
+  // The generated code is part of the key, the compilation is what the cache saves.
+  std::optional<CompileCache> cache = CompileCache::Current();
+  std::ostringstream key;
+  if (cache) {
+    int nvrtc_major = 0, nvrtc_minor = 0;
+    NVRTC_CALL(nvrtcVersion(&nvrtc_major, &nvrtc_minor));
+    key << "cuda tvm=" << TVM_VERSION << " cuda=" << CUDART_VERSION << " compiler="
+        << (f_compile ? "tvm_callback_cuda_compile"
+                      : "nvrtc-" + std::to_string(nvrtc_major) + "." + std::to_string(nvrtc_minor))
+        << " target=" << target->str() << "\n"
+        << code;
+    if (std::optional<std::string> entry = cache->Lookup(NullOpt, key.str())) {
+      size_t pos = entry->find('\n');
+      ICHECK(pos != std::string::npos);
+      return CUDAModuleCreate(entry->substr(pos + 1), entry->substr(0, pos), ExtractFuncInfo(mod),
+                              code);
+    }
+  }
+
   const auto* f_enter = Registry::Get("target.TargetEnterScope");
   (*f_enter)(target);
-  if (const auto* f = Registry::Get("tvm_callback_cuda_compile")) {
-    ptx = (*f)(code, target).operator std::string();
+  if (f_compile != nullptr) {
+    ptx = (*f_compile)(code, target).operator std::string();
     // Dirty matching to check PTX vs cubin.
     // TODO(tqchen) more reliable checks
     if (ptx[0] != '/') fmt = "cubin";
@@ -167,6 +190,9 @@ runtime::Module BuildCUDA(IRModule mod, Target target) {
   }
   const auto* f_exit = Registry::Get("target.TargetExitScope");
   (*f_exit)(target);
+  if (cache) {
+    cache->Store(NullOpt, key.str(), fmt + "\n" + ptx);
+  }
   return CUDAModuleCreate(ptx, fmt, ExtractFuncInfo(mod), code);
 }
 
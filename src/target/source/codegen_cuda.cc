@@ -182,6 +182,22 @@ std::string CodeGenCUDA::Finish() {
     decl_stream << "}\n";
   }
 
+  if (need_wgmma_desc_) {
+    // The matrix descriptor of wgmma operands, with the addresses and the offsets in 16 bytes and
+    // the swizzle mode in the top two bits.
+    decl_stream << "__forceinline__ __device__ unsigned long long\n";
+    decl_stream << "make_wgmma_desc(unsigned int smem_addr, int leading_byte_offset, "
+                   "int stride_byte_offset, int swizzle_bytes)\n";
+    decl_stream << "{\n";
+    decl_stream << "  unsigned long long layout = swizzle_bytes == 128 ? 1 : swizzle_bytes == 64 "
+                   "? 2 : swizzle_bytes == 32 ? 3 : 0;\n";
+    decl_stream << "  unsigned long long lbo = (leading_byte_offset & 0x3FFFF) >> 4;\n";
+    decl_stream << "  unsigned long long sbo = (stride_byte_offset & 0x3FFFF) >> 4;\n";
+    decl_stream << "  return ((unsigned long long)((smem_addr & 0x3FFFF) >> 4)) | (lbo << 16) |\n";
+    decl_stream << "         (sbo << 32) | (layout << 62);\n";
+    decl_stream << "}\n";
+  }
+
   decl_stream << "\n#if (((__CUDACC_VER_MAJOR__ == 11) && (__CUDACC_VER_MINOR__ >= 4)) || \\\n";
   decl_stream << "     (__CUDACC_VER_MAJOR__ > 11))\n";
   decl_stream << "#define TVM_ENABLE_L2_PREFETCH 1\n";
@@ -1017,6 +1033,19 @@ void CodeGenCUDA::VisitExpr_(const CallNode* op, std::ostream& os) {
     CHECK(barrier_id < barrier_count_);
     std::string barrier = barrier_name_ + "[" + std::to_string(barrier_id) + "]";
     this->stream << PrintCpAsyncBulkAsm(dst, dst_offset, src, src_offset, size, barrier);
+  } else if (op->op.same_as(builtin::ptx_cp_async_bulk_tensor())) {
+    need_cast_smem_ptr_to_int_ = true;
+    std::string dst = this->PrintExpr(op->args[0]);
+    std::string dst_offset = this->PrintExpr(op->args[1]);
+    std::string tensor_map = this->PrintExpr(op->args[2]);
+    int barrier_id = Downcast<IntImm>(op->args[3])->value;
+    CHECK(barrier_id < barrier_count_);
+    std::string barrier = barrier_name_ + "[" + std::to_string(barrier_id) + "]";
+    std::vector<std::string> coords;
+    for (size_t i = 4; i < op->args.size(); ++i) {
+      coords.push_back(this->PrintExpr(op->args[i]));
+    }
+    this->stream << PrintCpAsyncBulkTensorAsm(dst, dst_offset, tensor_map, coords, barrier);
   } else if (op->op.same_as(builtin::ptx_commit_group())) {
     this->stream << "__asm__ __volatile__(\"cp.async.commit_group;\");\n\n";
   } else if (op->op.same_as(builtin::ptx_wait_group())) {
@@ -1053,7 +1082,55 @@ void CodeGenCUDA::VisitExpr_(const CallNode* op, std::ostream& os) {
     int barrier_id = Downcast<IntImm>(op->args[0])->value;
     CHECK(barrier_id < barrier_count_);
     std::string barrier = barrier_name_ + "[" + std::to_string(barrier_id) + "]";
-    this->stream << PrintWaitBarrierAsm(barrier);
+    std::string phase = op->args.size() > 1 ? this->PrintExpr(op->args[1]) : "0";
+    this->stream << PrintWaitBarrierAsm(barrier, phase);
+  } else if (op->op.same_as(builtin::ptx_wgmma_encode_desc())) {
+    need_cast_smem_ptr_to_int_ = true;
+    need_wgmma_desc_ = true;
+    os << "make_wgmma_desc(cast_smem_ptr_to_int(" << this->PrintExpr(op->args[0]) << " + "
+       << this->PrintExpr(op->args[1]) << "), " << this->PrintExpr(op->args[2]) << ", "
+       << this->PrintExpr(op->args[3]) << ", " << this->PrintExpr(op->args[4]) << ")";
+  } else if (op->op.same_as(builtin::ptx_wgmma())) {
+    // arg 0: shape: m64nNkK
+    // arg 1: A layout: row/col
+    // arg 2: B layout: row/col
+    // arg 3: A precision: fp16, bf16, tf32, int8, uint8
+    // arg 4: B precision: same as A
+    // arg 5: C precision: fp32, fp16, int32
+    // arg 6: A matrix descriptor
+    // arg 7: B matrix descriptor
+    // arg 8: C accumulator
+    // arg 9: C accumulator index
+    // arg 10: scale out, whether C is accumulated into
+    ICHECK_EQ(op->args.size(), 11U);
+    std::string shape = Downcast<StringImm>(op->args[0])->value;
+    std::string A_layout = Downcast<StringImm>(op->args[1])->value;
+    std::string B_layout = Downcast<StringImm>(op->args[2])->value;
+    std::string A_dtype = Downcast<StringImm>(op->args[3])->value;
+    std::string B_dtype = Downcast<StringImm>(op->args[4])->value;
+    std::string C_dtype = Downcast<StringImm>(op->args[5])->value;
+    std::string desc_a = this->PrintExpr(op->args[6]);
+    std::string desc_b = this->PrintExpr(op->args[7]);
+    std::string c_ref = this->PrintExpr(op->args[8]);
+    std::string c_bias = this->PrintExpr(op->args[9]);
+    std::string scale_out = this->PrintExpr(op->args[10]);
+    this->stream << PrintWGMMAAssembly(shape, A_layout, B_layout, A_dtype, B_dtype, C_dtype,
+                                       desc_a, desc_b, c_ref, c_bias, scale_out);
+  } else if (op->op.same_as(builtin::ptx_wgmma_fence())) {
+    this->stream << "__asm__ __volatile__(\"wgmma.fence.sync.aligned;\" ::: \"memory\");\n";
+  } else if (op->op.same_as(builtin::ptx_wgmma_commit_group())) {
+    this->stream << "__asm__ __volatile__(\"wgmma.commit_group.sync.aligned;\" ::: \"memory\");\n";
+  } else if (op->op.same_as(builtin::ptx_wgmma_wait_group())) {
+    int n = Downcast<IntImm>(op->args[0])->value;
+    this->stream << "__asm__ __volatile__(\"wgmma.wait_group.sync.aligned " << n
+                 << ";\" ::: \"memory\");\n";
+  } else if (op->op.same_as(builtin::ptx_setmaxnreg())) {
+    bool is_inc = Downcast<Bool>(op->args[0])->value;
+    int reg_count = Downcast<IntImm>(op->args[1])->value;
+    CHECK(reg_count >= 24 && reg_count <= 256 && reg_count % 8 == 0)
+        << "setmaxnreg requires a multiple of 8 registers in [24, 256], but got " << reg_count;
+    this->stream << "__asm__ __volatile__(\"setmaxnreg." << (is_inc ? "inc" : "dec")
+                 << ".sync.aligned.u32 " << reg_count << ";\");\n";
   } else if (op->op.same_as(builtin::create_barriers())) {
     CHECK_EQ(barrier_count_, -1);
     int barrier_count = Downcast<IntImm>(op->args[0])->value;
@@ -735,6 +735,45 @@ std::string PrintCpAsyncBulkAsm(const std::string& shared_ptr,
   return asm_code;
 }
 
+std::string PrintCpAsyncBulkTensorAsm(const std::string& shared_ptr,
+                                      const std::string& shared_elem_offset,
+                                      const std::string& tensor_map,
+                                      const std::vector<std::string>& coords,
+                                      const std::string& barrier) {
+  CHECK(!coords.empty() && coords.size() <= 5)
+      << "cp.async.bulk.tensor supports tensors of 1 to 5 dimensions, but got " << coords.size();
+  std::string asm_code = R"(
+  {
+    unsigned int smem_addr_int = cast_smem_ptr_to_int({smem_addr});
+    unsigned int barrier_addr_int = cast_smem_ptr_to_int({barrier});
+    __asm__ __volatile__(
+      "cp.async.bulk.tensor.{dim}d.shared::cluster.global.mbarrier::complete_tx::bytes"
+      " [%0], [%1, {{coord_templates}}], [%2];"
+      :: "r"(smem_addr_int), "l"((unsigned long long)({tensor_map})), "r"(barrier_addr_int),
+         {coord_inputs}
+      : "memory"
+    );
+  }
+)";
+  // The coordinates of the PTX instruction start from the innermost dimension.
+  std::stringstream coord_templates, coord_inputs;
+  for (size_t i = 0; i < coords.size(); ++i) {
+    coord_templates << (i == 0 ? "" : ", ") << "%" << i + 3;
+    coord_inputs << (i == 0 ? "" : ", ") << "\"r\"((int)(" << coords[coords.size() - 1 - i]
+                 << "))";
+  }
+
+  Replacer replacer;
+  replacer.register_rule("{smem_addr}", shared_ptr + " + " + shared_elem_offset);
+  replacer.register_rule("{tensor_map}", tensor_map);
+  replacer.register_rule("{barrier}", "&" + barrier);
+  replacer.register_rule("{dim}", std::to_string(coords.size()));
+  replacer.register_rule("{coord_templates}", coord_templates.str());
+  replacer.register_rule("{coord_inputs}", coord_inputs.str());
+  asm_code = replacer.rewrite(asm_code);
+  return asm_code;
+}
+
 std::string PrintCpAsyncBarrierAsm(const std::string& barrier) {
   std::string predicated_asm_code = R"(
   {
@@ -809,11 +848,11 @@ std::string PrintArriveBarrierExpectTxAsm(const std::string& barrier,
   return predicated_asm_code;
 }
 
-std::string PrintWaitBarrierAsm(const std::string& barrier) {
+std::string PrintWaitBarrierAsm(const std::string& barrier, const std::string& phase) {
   std::string predicated_asm_code = R"(
   {
     unsigned int barrier_addr_int = cast_smem_ptr_to_int({barrier});
-    constexpr int phase_bit = 0;
+    int phase_bit = {phase};
     __asm__ __volatile__(
       "{ .reg .pred P; WAIT: mbarrier.try_wait.parity.shared.b64 P, [%0], %1; @P bra.uni DONE; bra.uni WAIT; DONE: }"
       :: "r"(barrier_addr_int), "r"(phase_bit)
@@ -823,9 +862,100 @@ std::string PrintWaitBarrierAsm(const std::string& barrier) {
 
   Replacer replacer;
   replacer.register_rule("{barrier}", "&" + barrier);
+  replacer.register_rule("{phase}", phase);
   predicated_asm_code = replacer.rewrite(predicated_asm_code);
   return predicated_asm_code;
 }
 
+std::string PrintWGMMAAssembly(const std::string& shape, const std::string& A_layout,
+                               const std::string& B_layout, const std::string& A_dtype,
+                               const std::string& B_dtype, const std::string& C_dtype,
+                               const std::string& desc_a, const std::string& desc_b,
+                               const std::string& c_ptr, const std::string& c_elem_offset,
+                               const std::string& scale_out) {
+  ptx::DataType dtype_a = ptx::DTypeFromString(A_dtype), dtype_b = ptx::DTypeFromString(B_dtype),
+                dtype_c = ptx::DTypeFromString(C_dtype);
+  ptx::LayoutType layout_a = ptx::LayoutTypeFromString(A_layout),
+                  layout_b = ptx::LayoutTypeFromString(B_layout);
+  auto [m, n, k] = ptx::ParseMMAShape(shape);
+  CHECK(dtype_a == dtype_b) << "wgmma requires the multiplicands to have the same data type";
+  CHECK(m == 64 && n % 8 == 0 && n >= 8 && n <= 256)
+      << "Invalid wgmma shape " << shape << ", M must be 64 and N a multiple of 8 up to 256";
+  // The transposed layouts, i.e. M-major A and N-major B, are only supported on 16-bit floats.
+  bool half_input = dtype_a == ptx::DataType::kFloat16 || dtype_a == ptx::DataType::kBFloat16;
+  bool int_input = dtype_a == ptx::DataType::kInt8 || dtype_a == ptx::DataType::kUInt8;
+  if (half_input) {
+    CHECK_EQ(k, 16) << "wgmma on " << A_dtype << " requires K to be 16";
+    CHECK(dtype_c == ptx::DataType::kFloat32 ||
+          (dtype_c == ptx::DataType::kFloat16 && dtype_a == ptx::DataType::kFloat16))
+        << "Invalid accumulator type " << C_dtype << " of wgmma on " << A_dtype;
+  } else if (dtype_a == ptx::DataType::kTensorFloat32) {
+    CHECK_EQ(k, 8) << "wgmma on tf32 requires K to be 8";
+    CHECK(dtype_c == ptx::DataType::kFloat32) << "wgmma on tf32 requires fp32 accumulators";
+  } else if (int_input) {
+    CHECK_EQ(k, 32) << "wgmma on " << A_dtype << " requires K to be 32";
+    CHECK(dtype_c == ptx::DataType::kInt32)
+        << "wgmma on " << A_dtype << " requires int32 accumulators";
+  } else {
+    LOG(FATAL) << "wgmma does not support multiplicands of type " << A_dtype;
+  }
+  CHECK(half_input || (layout_a == ptx::LayoutType::kRowMajor &&
+                       layout_b == ptx::LayoutType::kColumnMajor))
+      << "wgmma on " << A_dtype << " requires row major A and column major B";
+
+  // Each of the 128 threads of the warpgroup holds M * N / 128 accumulators, two fp16 per register.
+  constexpr int warpgroup_size = 128;
+  int num_regs = m * n / warpgroup_size / (dtype_c == ptx::DataType::kFloat16 ? 2 : 1);
+  std::string reg_type = dtype_c == ptx::DataType::kFloat32 ? "f" : "r";
+  std::string ptr_type = dtype_c == ptx::DataType::kFloat32 ? "(float*)" : "(unsigned*)";
+  std::stringstream templates, outputs;
+  for (int i = 0; i < num_regs; ++i) {
+    templates << (i == 0 ? "" : ", ") << "%" << i;
+    outputs << (i == 0 ? "" : ", ") << "\"+" << reg_type << "\"((" << ptr_type << "(" << c_ptr
+            << " + " << c_elem_offset << "))[" << i << "])";
+  }
+  std::stringstream immediates;
+  if (!int_input) {
+    // imm-scale-a and imm-scale-b
+    immediates << ", 1, 1";
+  }
+  if (half_input) {
+    // imm-trans-a and imm-trans-b
+    immediates << ", " << (layout_a == ptx::LayoutType::kColumnMajor ? 1 : 0) << ", "
+               << (layout_b == ptx::LayoutType::kRowMajor ? 1 : 0);
+  }
+
+  std::string asm_code = R"(
+  {
+    __asm__ __volatile__(
+      "{\n"
+      ".reg .pred p;\n"
+      "setp.ne.b32 p, %{scale_idx}, 0;\n"
+      "wgmma.mma_async.sync.aligned.{shape}{.dtype}{.atype}{.btype} "
+      "{{templates}}, %{desc_a_idx}, %{desc_b_idx}, p{immediates};\n"
+      "}\n"
+      : {outputs}
+      : "l"((unsigned long long)({desc_a})), "l"((unsigned long long)({desc_b})),
+        "r"((int)({scale_out})));
+  }
+)";
+  Replacer replacer;
+  replacer.register_rule("{scale_idx}", std::to_string(num_regs + 2));
+  replacer.register_rule("{desc_a_idx}", std::to_string(num_regs));
+  replacer.register_rule("{desc_b_idx}", std::to_string(num_regs + 1));
+  replacer.register_rule("{shape}", shape);
+  replacer.register_rule("{.dtype}", ptx::DTypeToString(dtype_c));
+  replacer.register_rule("{.atype}", ptx::DTypeToString(dtype_a));
+  replacer.register_rule("{.btype}", ptx::DTypeToString(dtype_b));
+  replacer.register_rule("{templates}", templates.str());
+  replacer.register_rule("{immediates}", immediates.str());
+  replacer.register_rule("{outputs}", outputs.str());
+  replacer.register_rule("{desc_a}", desc_a);
+  replacer.register_rule("{desc_b}", desc_b);
+  replacer.register_rule("{scale_out}", scale_out);
+  asm_code = replacer.rewrite(asm_code);
+  return asm_code;
+}
+
 }  // namespace codegen
 }  // namespace tvm
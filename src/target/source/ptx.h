@@ -28,6 +28,7 @@
 
 #include <string>
 #include <tuple>
+#include <vector>
 
 namespace tvm {
 namespace codegen {
@@ -123,6 +124,21 @@ std::string PrintCpAsyncBulkAsm(const std::string& shared_ptr,
                                 const std::string& global_elem_offset, const std::string& bytes,
                                 const std::string& barrier);
 
+/*!
+ * \brief Print ptx async copy of a tile of a tensor from global to shared memory using
+ *  cp.async.bulk.tensor
+ * \param shared_ptr: The pointer to the destination shared memory.
+ * \param shared_elem_offset: The offset into the shared memory.
+ * \param tensor_map: The pointer to the CUtensorMap of the tensor.
+ * \param coords: The coordinates of the tile, from the outermost dimension to the innermost one.
+ * \param barrier: The name of the barrier in shared memory.
+ */
+std::string PrintCpAsyncBulkTensorAsm(const std::string& shared_ptr,
+                                      const std::string& shared_elem_offset,
+                                      const std::string& tensor_map,
+                                      const std::vector<std::string>& coords,
+                                      const std::string& barrier);
+
 /*!
  * \brief Print ptx async copy barrier using cp.async.mbarrier.arrive
  * \param barrier: The name of the barrier in shared memory.
@@ -155,8 +171,30 @@ std::string PrintArriveBarrierExpectTxAsm(const std::string& barrier,
 /*!
  * \brief Print ptx barrier wait using mbarrier.try_wait
  * \param barrier: The name of the barrier in shared memory.
+ * \param phase: The parity of the phase to wait for.
+ */
+std::string PrintWaitBarrierAsm(const std::string& barrier, const std::string& phase = "0");
+
+/*!
+ * \brief Print warpgroup level async MMA assembly string given parameters.
+ * \param shape The shape string m64nNkK
+ * \param A_layout The layout of multiplicand A, row (K-major) or col (M-major).
+ * \param B_layout The layout of multiplicand B, col (K-major) or row (N-major).
+ * \param A_dtype The data type of multiplicand A.
+ * \param B_dtype The data type of multiplicand B.
+ * \param C_dtype The data type of accumulator C.
+ * \param desc_a The matrix descriptor of multiplicand A in shared memory.
+ * \param desc_b The matrix descriptor of multiplicand B in shared memory.
+ * \param c_ptr Pointer to buffer containing the accumulators of the thread.
+ * \param c_elem_offset The offset of element in c.
+ * \param scale_out Whether the accumulators are added to, rather than overwritten.
  */
-std::string PrintWaitBarrierAsm(const std::string& barrier);
+std::string PrintWGMMAAssembly(const std::string& shape, const std::string& A_layout,
+                               const std::string& B_layout, const std::string& A_dtype,
+                               const std::string& B_dtype, const std::string& C_dtype,
+                               const std::string& desc_a, const std::string& desc_b,
+                               const std::string& c_ptr, const std::string& c_elem_offset,
+                               const std::string& scale_out);
 
 }  // namespace codegen
 }  // namespace tvm
@@ -429,6 +429,17 @@ TVM_REGISTER_TAG_AWS_C5("aws/cpu/c5.24xlarge", 48, "cascadelake");
 
 #undef TVM_REGISTER_TAG_AWS_C5
 
+// The CPU of the web runtime, with the SIMD128 instructions of wasm, and with the atomics and
+// the bulk memory of wasm threads, which run the parallel loops on Web Workers.
+TVM_REGISTER_TARGET_TAG("wasm/simd128")
+    .set_config({{"kind", String("llvm")},
+                 {"mtriple", String("wasm32-unknown-unknown-wasm")},
+                 {"mattr", Array<String>{"+simd128"}}});
+TVM_REGISTER_TARGET_TAG("wasm/simd128-threads")
+    .set_config({{"kind", String("llvm")},
+                 {"mtriple", String("wasm32-unknown-unknown-wasm")},
+                 {"mattr", Array<String>{"+simd128", "+atomics", "+bulk-memory"}}});
+
 #if TVM_LLVM_VERSION >= 190
 #define TVM_REGISTER_METAL_GPU_TAG(Name, ThreadsPerBlock, SharedMem, WarpSize)   \
   TVM_REGISTER_TARGET_TAG(Name).set_config(                                      \
@@ -394,6 +394,7 @@ TVM_REGISTER_TARGET_KIND("vulkan", kDLVulkan)
     .add_attr_option<runtime::Bool>("supports_storage_buffer_storage_class")
     .add_attr_option<runtime::Bool>("supports_push_descriptor")
     .add_attr_option<runtime::Bool>("supports_dedicated_allocation")
+    .add_attr_option<runtime::Bool>("supports_timeline_semaphore")
     .add_attr_option<runtime::Bool>("supports_integer_dot_product")
     .add_attr_option<runtime::Bool>("supports_cooperative_matrix")
     .add_attr_option<runtime::Int>("supported_subgroup_operations")
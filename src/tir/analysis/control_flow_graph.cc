@@ -821,8 +821,13 @@ BufferTouch ControlFlowGraph::ControlFlowBlock::MakeBufferTouch(ControlFlowGraph
 }
 
 ControlFlowGraph::ControlFlowGraph(const tir::Stmt& stmt, int64_t max_simplification_steps,
-                                   size_t max_revisits)
-    : max_revisits_(max_revisits), max_simplification_steps_(max_simplification_steps) {
+                                   size_t max_revisits, size_t max_constraints_per_buffer,
+                                   size_t widening_threshold, size_t max_regions_per_touch)
+    : max_revisits_(max_revisits),
+      max_simplification_steps_(max_simplification_steps),
+      max_constraints_per_buffer_(max_constraints_per_buffer),
+      widening_threshold_(widening_threshold),
+      max_regions_per_touch_(max_regions_per_touch) {
   ControlFlowGraphBuilder::Build(this, stmt);
   ForwardPropagateKnownValues();
   BackwardPropagateUnusedValues();
@@ -1032,8 +1037,8 @@ class BufferRegionCollector : public ExprVisitor {
   static std::vector<Region> Collect(const Map<Buffer, Array<Var>>& axis_var_lookup,
                                      const std::vector<BufferTouch>& knowns,
                                      const std::vector<Optional<PrimExpr>>& exprs,
-                                     Analyzer* analyzer) {
-    BufferRegionCollector collector(axis_var_lookup, knowns, analyzer);
+                                     Analyzer* analyzer, size_t max_regions = 0) {
+    BufferRegionCollector collector(axis_var_lookup, knowns, analyzer, max_regions);
     for (const auto& expr : exprs) {
       if (expr) {
         collector(expr.value());
@@ -1047,8 +1052,12 @@ class BufferRegionCollector : public ExprVisitor {
   using Parent = ExprVisitor;
 
   BufferRegionCollector(const Map<Buffer, Array<Var>>& axis_var_lookup,
-                        const std::vector<BufferTouch>& knowns, Analyzer* analyzer)
-      : analyzer_(analyzer), axis_var_lookup_(axis_var_lookup), knowns_(knowns) {
+                        const std::vector<BufferTouch>& knowns, Analyzer* analyzer,
+                        size_t max_regions)
+      : analyzer_(analyzer),
+        axis_var_lookup_(axis_var_lookup),
+        knowns_(knowns),
+        max_regions_(max_regions) {
     regions_.push_back(Region{Bool(true), {}});
   }
 
@@ -1106,6 +1115,11 @@ class BufferRegionCollector : public ExprVisitor {
           }
         }
       }
+      if (max_regions_ && updated_regions.size() > max_regions_) {
+        // Splitting on this BufferLoad would make too many regions.
+        // Leaving it out of the known values treats it as unknown.
+        return;
+      }
       regions_ = updated_regions;
     }
   }
@@ -1114,6 +1128,7 @@ class BufferRegionCollector : public ExprVisitor {
   std::vector<Region> regions_;
   const Map<Buffer, Array<Var>>& axis_var_lookup_;
   const std::vector<BufferTouch>& knowns_;
+  size_t max_regions_;
 };
 
 class BufferRegionValueReplacer : public IRMutatorWithAnalyzer {
@@ -1153,7 +1168,8 @@ class BufferRegionValueReplacer : public IRMutatorWithAnalyzer {
 };
 
 void BufferState::ApplyTouches(const Map<Buffer, Array<Var>>& axis_var_lookup,
-                               const std::vector<BufferTouch>& touch_points, Analyzer* analyzer) {
+                               const std::vector<BufferTouch>& touch_points, Analyzer* analyzer,
+                               size_t max_regions_per_touch) {
   std::vector<BufferTouch> new_knowns;
   Map<Buffer, PrimExpr> keep_prior_known_at;
 
@@ -1165,8 +1181,8 @@ void BufferState::ApplyTouches(const Map<Buffer, Array<Var>>& axis_var_lookup,
     PrimExpr known_value = touch.value;
 
     PrimExpr predicate = touch.predicate && touch.AfterLoopIteration();
-    auto regions = BufferRegionCollector::Collect(axis_var_lookup, constraints_,
-                                                  {predicate, touch.value}, analyzer);
+    auto regions = BufferRegionCollector::Collect(
+        axis_var_lookup, constraints_, {predicate, touch.value}, analyzer, max_regions_per_touch);
 
     for (const auto& region : regions) {
       PrimExpr updated_predicate = BufferRegionValueReplacer::Apply(
@@ -1303,6 +1319,21 @@ void BufferState::BackpropUnusedIndices(const Map<Buffer, Array<Var>>& axis_var_
       constraints_.end());
 }
 
+void BufferState::LimitConstraintsPerBuffer(size_t max_constraints) {
+  if (max_constraints == 0) {
+    return;
+  }
+
+  std::unordered_map<const BufferNode*, size_t> num_kept;
+  std::vector<BufferTouch> kept;
+  for (auto it = constraints_.rbegin(); it != constraints_.rend(); it++) {
+    if (num_kept[it->buffer.get()]++ < max_constraints) {
+      kept.push_back(*it);
+    }
+  }
+  constraints_ = std::vector<BufferTouch>(kept.rbegin(), kept.rend());
+}
+
 void BufferState::RemoveFreeParameters(const Map<Var, Range>& free_predicate_parameters,
                                        Analyzer* analyzer) {
   for (auto& known : constraints_) {
@@ -1396,7 +1427,7 @@ void ControlFlowGraph::ForwardPropagateKnownValues(std::optional<size_t> flow_fr
     ControlFlowBlock& block = control_flow_[visiting];
 
     // Step 1: Collect known values provided from each predecessor
-    block.known_at_block_start = [&]() -> BufferState {
+    BufferState known_at_block_start = [&]() -> BufferState {
       if (num_previous_visits >= max_revisits_) {
         return BufferState();
       }
@@ -1463,14 +1494,26 @@ void ControlFlowGraph::ForwardPropagateKnownValues(std::optional<size_t> flow_fr
       }
     }();
 
+    if (widening_threshold_ && num_previous_visits >= widening_threshold_) {
+      // After repeated visits, only keep the knowns that were already
+      // known on the previous visit.  The state can then only lose
+      // constraints, so loops reach a fixed point before exhausting
+      // the maximum number of revisits.
+      known_at_block_start.Intersection(block.known_at_block_start, &analyzer);
+    }
+    known_at_block_start.LimitConstraintsPerBuffer(max_constraints_per_buffer_);
+    block.known_at_block_start = std::move(known_at_block_start);
+
     // Step 2: Collect knowns provided as a result of executing this block
     auto post_state = [&]() {
       if (num_previous_visits >= max_revisits_) {
         return BufferState();
       }
       auto post_state = block.known_at_block_start;
-      post_state.ApplyTouches(axis_var_lookup_, block.touch_points, &analyzer);
+      post_state.ApplyTouches(axis_var_lookup_, block.touch_points, &analyzer,
+                              max_regions_per_touch_);
       post_state.RemoveFreeParameters(free_predicate_parameters_, &analyzer);
+      post_state.LimitConstraintsPerBuffer(max_constraints_per_buffer_);
       return post_state;
     }();
 
@@ -1530,7 +1573,7 @@ void ControlFlowGraph::BackwardPropagateUnusedValues(std::optional<size_t> flow_
     ControlFlowBlock& block = control_flow_[visiting];
 
     // Step 1: Collect known unused indices provided by each successor
-    block.unused_at_block_end = [&]() -> BufferState {
+    BufferState unused_at_block_end = [&]() -> BufferState {
       if (num_previous_visits >= max_revisits_) {
         return BufferState();
       }
@@ -1594,6 +1637,14 @@ void ControlFlowGraph::BackwardPropagateUnusedValues(std::optional<size_t> flow_
       }
     }();
 
+    if (widening_threshold_ && num_previous_visits >= widening_threshold_) {
+      // After repeated visits, only keep the unused indices that were
+      // already unused on the previous visit, as for the known values.
+      unused_at_block_end.Intersection(block.unused_at_block_end, &analyzer);
+    }
+    unused_at_block_end.LimitConstraintsPerBuffer(max_constraints_per_buffer_);
+    block.unused_at_block_end = std::move(unused_at_block_end);
+
     // Step 2: Collect knowns provided as a result of executing this block
     auto unused_at_block_start = [&]() {
       if (num_previous_visits >= max_revisits_) {
@@ -1602,6 +1653,7 @@ void ControlFlowGraph::BackwardPropagateUnusedValues(std::optional<size_t> flow_
       auto prior_state = block.unused_at_block_end;
       prior_state.BackpropUnusedIndices(axis_var_lookup_, block.touch_points, &analyzer);
       prior_state.RemoveFreeParameters(free_predicate_parameters_, &analyzer);
+      prior_state.LimitConstraintsPerBuffer(max_constraints_per_buffer_);
       return prior_state;
     }();
 
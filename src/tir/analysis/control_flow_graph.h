@@ -225,9 +225,15 @@ class BufferState {
    * \param touch_points The buffer touch points to apply
    *
    * \param analyzer The analyzer to use for simplifications
+   *
+   * \param max_regions_per_touch The maximum number of regions into
+   * which the known values read by a touch may split it.  A read
+   * whose known values would exceed this limit is treated as
+   * unknown.  If zero, no limit is applied.
    */
   void ApplyTouches(const Map<Buffer, Array<Var>>& axis_var_lookup,
-                    const std::vector<BufferTouch>& touch_points, arith::Analyzer* analyzer);
+                    const std::vector<BufferTouch>& touch_points, arith::Analyzer* analyzer,
+                    size_t max_regions_per_touch = 0);
 
   /*! \brief Update unused buffer locations based on buffer touches
    *
@@ -284,6 +290,17 @@ class BufferState {
    */
   void Intersection(const BufferState& other, arith::Analyzer* analyzer);
 
+  /* \brief Forget the oldest constraints of any buffer with too many
+   *
+   * Forgetting a constraint only loses information, and is valid for
+   * both known values and unused indices.  The most recently added
+   * constraints of each buffer are kept.
+   *
+   * \param max_constraints The maximum number of constraints kept for
+   * each buffer.  If zero, no limit is applied.
+   */
+  void LimitConstraintsPerBuffer(size_t max_constraints);
+
   friend std::ostream& operator<<(std::ostream& os, const BufferState&);
 
  private:
@@ -398,9 +415,32 @@ class BufferState {
 class ControlFlowGraph {
  public:
   /* \brief Extract the touch pattern from a TIR statement
+   *
+   * The limits bound the cost of propagating constraints through
+   * large functions, at the cost of forgetting some of them.  A
+   * limit of zero applies no limit.
+   *
+   * \param stmt The statement to analyze
+   *
+   * \param max_simplification_steps The maximum number of rewrite
+   * steps of each simplification
+   *
+   * \param max_revisits The number of visits of a block after which
+   * nothing is known at it
+   *
+   * \param max_constraints_per_buffer The maximum number of
+   * constraints tracked for each buffer at each block
+   *
+   * \param widening_threshold The number of visits of a block after
+   * which its state may only lose constraints, so that loops reach a
+   * fixed point without exhausting `max_revisits`
+   *
+   * \param max_regions_per_touch The maximum number of regions into
+   * which the known values read by a write may split it
    */
   explicit ControlFlowGraph(const Stmt& stmt, int64_t max_simplification_steps = 0,
-                            size_t max_revisits = 5);
+                            size_t max_revisits = 5, size_t max_constraints_per_buffer = 0,
+                            size_t widening_threshold = 0, size_t max_regions_per_touch = 0);
 
   /* \brief Check if a write is overwritten without impacting final results
    *
@@ -659,6 +699,15 @@ class ControlFlowGraph {
 
   /*! \brief The maximum number of revisits while flowing constraints */
   int64_t max_simplification_steps_;
+
+  /*! \brief The maximum number of constraints of each buffer in a state */
+  size_t max_constraints_per_buffer_;
+
+  /*! \brief The number of visits after which a block's state may only narrow */
+  size_t widening_threshold_;
+
+  /*! \brief The maximum number of regions into which a write is split */
+  size_t max_regions_per_touch_;
 };
 
 }  // namespace tir
@@ -27,8 +27,10 @@
 #include <tvm/tir/stmt_functor.h>
 
 #include <exception>
+#include <memory>
 #include <optional>
 #include <tuple>
+#include <unordered_set>
 #include <variant>
 
 #include "../ir/functor_common.h"
@@ -368,6 +370,34 @@ bool VerifyWellFormed(const IRModule& mod, bool assert_mode) {
   return true;
 }
 
+runtime::TypedPackedFunc<bool(IRModule)> IncrementalVerifyWellFormed(bool assert_mode) {
+  // The PrimFuncs of the last module found well-formed.
+  auto verified = std::make_shared<std::unordered_set<PrimFunc, ObjectPtrHash, ObjectPtrEqual>>();
+  return [verified, assert_mode](IRModule mod) -> bool {
+    Map<GlobalVar, BaseFunc> changed;
+    for (const auto& [gvar, base_func] : mod->functions) {
+      if (auto prim_func = base_func.as<PrimFunc>()) {
+        if (!verified->count(prim_func.value())) {
+          changed.Set(gvar, prim_func.value());
+        }
+      }
+    }
+    if (!changed.empty() && !VerifyWellFormed(IRModule(changed), assert_mode)) {
+      return false;
+    }
+    verified->clear();
+    for (const auto& [gvar, base_func] : mod->functions) {
+      if (auto prim_func = base_func.as<PrimFunc>()) {
+        verified->insert(prim_func.value());
+      }
+    }
+    return true;
+  };
+}
+
+TVM_REGISTER_GLOBAL("tir.analysis.IncrementalVerifyWellFormed")
+    .set_body_typed(IncrementalVerifyWellFormed);
+
 TVM_REGISTER_GLOBAL("tir.analysis.VerifyWellFormed")
     .set_body_typed([](const ObjectRef& obj, bool assert_mode) {
       if (auto opt = obj.as<PrimFunc>()) {
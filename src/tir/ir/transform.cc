@@ -25,6 +25,9 @@
 #include <tvm/runtime/registry.h>
 #include <tvm/tir/transform.h>
 
+#include <utility>
+#include <vector>
+
 namespace tvm {
 namespace tir {
 namespace transform {
@@ -92,17 +95,43 @@ IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
 
   IRModuleNode* mod_ptr = mod.CopyOnWrite();
   auto* func_dict = mod_ptr->functions.CopyOnWrite();
-  // directly loop over the underlying dict
-  for (auto& kv : *func_dict) {
-    // only picks up tir::PrimFunc
-    if (kv.second->IsInstance<PrimFuncNode>()) {
-      // move out the function so that it is the only copy.
-      PrimFunc func = Downcast<PrimFunc>(std::move(kv.second));
-      func = pass_func(std::move(func), mod, pass_ctx);
-      kv.second = std::move(func);
-
-      if (!kv.second.defined()) {
-        deleted_list.push_back(Downcast<GlobalVar>(kv.first));
+  if (pass_ctx->GetConfig<Integer>("ir.num_pass_threads", Integer(1)).value()->value != 1) {
+    // The module is shared by the threads, keep it intact while the pass runs.
+    std::vector<std::pair<GlobalVar, PrimFunc>> funcs;
+    for (const auto& kv : *func_dict) {
+      if (kv.second->IsInstance<PrimFuncNode>()) {
+        funcs.emplace_back(Downcast<GlobalVar>(kv.first), Downcast<PrimFunc>(kv.second));
+      }
+    }
+    pass_ctx.ParallelFor(funcs.size(), [&](int i) {
+      try {
+        funcs[i].second = pass_func(funcs[i].second, mod, pass_ctx);
+      } catch (const std::exception&) {
+        LOG(WARNING) << "Pass " << pass_info->name << " failed on PrimFunc "
+                     << funcs[i].first->name_hint;
+        throw;
+      }
+    });
+    for (const auto& [gv, func] : funcs) {
+      if (func.defined()) {
+        func_dict->at(gv) = func;
+      } else {
+        deleted_list.push_back(gv);
+      }
+    }
+  } else {
+    // directly loop over the underlying dict
+    for (auto& kv : *func_dict) {
+      // only picks up tir::PrimFunc
+      if (kv.second->IsInstance<PrimFuncNode>()) {
+        // move out the function so that it is the only copy.
+        PrimFunc func = Downcast<PrimFunc>(std::move(kv.second));
+        func = pass_func(std::move(func), mod, pass_ctx);
+        kv.second = std::move(func);
+
+        if (!kv.second.defined()) {
+          deleted_list.push_back(Downcast<GlobalVar>(kv.first));
+        }
       }
     }
   }
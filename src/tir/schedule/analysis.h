@@ -675,6 +675,16 @@ bool NeedsMultiLevelTiling(const ScheduleState& self, const StmtSRef& block_sref
  */
 bool IsSpatialPrimFunc(const PrimFunc& func);
 
+/*!
+ * \brief Get the cumulative extent of the spatial loops and of the reduction loops of a block.
+ * \param self The schedule state.
+ * \param block_sref The block to be checked.
+ * \return The cumulative extents, or (-1, -1) if some loop is dynamic or neither spatial nor
+ * reduction.
+ */
+std::pair<int64_t, int64_t> GetCumulativeSpaceAndReductionLength(const tir::ScheduleState& self,
+                                                                 const tir::StmtSRef& block_sref);
+
 /*!
  * \brief Checks if the rfactor or cross thread reduction is beneficial to the given block.
  * \param self The schedule state.
@@ -43,7 +43,11 @@ Schedule Schedule::Concrete(IRModule mod, support::LinearCongruentialEngine::TRa
 
 /******** Copy ********/
 
-/*! \brief Helper class to perform a deep copy of the sref tree */
+/*!
+ * \brief Helper class to perform a deep copy of the sref tree.
+ * \note The IR is shared by the copies, only the srefs and the dependencies referring to them
+ * are created, once each.
+ */
 class ScheduleCopier {
   using TSymbolTable = ConcreteScheduleNode::TSymbolTable;
   template <class K, class V>
@@ -54,21 +58,20 @@ class ScheduleCopier {
  public:
   static void Copy(const ConcreteScheduleNode* self, ScheduleState* new_state,
                    TSymbolTable* new_symbol_table) {
-    const ScheduleState& src_state = self->state_;
-    ScheduleCopier copier(src_state);
-    ObjectPtr<ScheduleStateNode> n = make_object<ScheduleStateNode>();
-    n->mod = src_state->mod;
-    n->block_info = copier.Copy(src_state->block_info);
-    n->stmt2ref = copier.Copy(src_state->stmt2ref);
-    n->debug_mask = src_state->debug_mask;
-    n->enable_check = src_state->enable_check;
-    *new_state = ScheduleState(std::move(n));
+    ScheduleCopier copier(self->state_);
+    *new_state = copier.CopyState(self->state_);
     *new_symbol_table = copier.Copy(self->symbol_table_);
   }
 
+  static ScheduleState Copy(const ScheduleState& src_state) {
+    ScheduleCopier copier(src_state);
+    return copier.CopyState(src_state);
+  }
+
  private:
   /*! \brief Create the copier and properly set up the `old2new_` table */
   explicit ScheduleCopier(const ScheduleState& state) {
+    old2new_.reserve(state->stmt2ref.size());
     // Create SRef tree without parents
     for (const auto& kv : state->stmt2ref) {
       const StmtSRefNode* sref = kv.second.operator->();
@@ -86,13 +89,25 @@ class ScheduleCopier {
     }
   }
 
+  /*! \brief Copy the ScheduleState */
+  ScheduleState CopyState(const ScheduleState& src_state) {
+    ObjectPtr<ScheduleStateNode> n = make_object<ScheduleStateNode>();
+    n->mod = src_state->mod;
+    n->block_info = Copy(src_state->block_info);
+    n->stmt2ref = Copy(src_state->stmt2ref);
+    n->debug_mask = src_state->debug_mask;
+    n->enable_check = src_state->enable_check;
+    return ScheduleState(std::move(n));
+  }
+
   /*! \brief Copy StmtSRef */
   StmtSRef Copy(const StmtSRef& sref) { return old2new_.at(sref.operator->()); }
 
   /*! \brief Copy StmtSRefNode */
   StmtSRef Copy(const StmtSRefNode* sref) {
-    if (old2new_.count(sref)) {
-      return old2new_.at(sref);
+    auto it = old2new_.find(sref);
+    if (it != old2new_.end()) {
+      return it->second;
     }
     // Handle expired sref
     return old2new_[sref] = StmtSRef(nullptr, nullptr, -1);
@@ -113,7 +128,14 @@ class ScheduleCopier {
     Array<Dependency> result;
     result.reserve(list.size());
     for (const Dependency& elem : list) {
-      result.push_back(Dependency(Copy(elem->src), Copy(elem->dst), elem->kind));
+      // A dependency is in both `src2deps` and `dst2deps`, copy it only once.
+      auto it = dep_old2new_.find(elem.get());
+      if (it == dep_old2new_.end()) {
+        it = dep_old2new_
+                 .emplace(elem.get(), Dependency(Copy(elem->src), Copy(elem->dst), elem->kind))
+                 .first;
+      }
+      result.push_back(it->second);
     }
     return result;
   }
@@ -141,6 +163,7 @@ class ScheduleCopier {
   /*! \brief Copy SMap<StmtSRef, Scope> */
   SMap<StmtSRef, BlockInfo> Copy(const SMap<StmtSRef, BlockInfo>& scopes) {
     SMap<StmtSRef, BlockInfo> result;
+    result.reserve(scopes.size());
     for (const auto& kv : scopes) {
       const StmtSRef& old_sref = kv.first;
       const BlockInfo& old_info = kv.second;
@@ -182,8 +205,13 @@ class ScheduleCopier {
 
  private:
   std::unordered_map<const StmtSRefNode*, StmtSRef> old2new_;
+  std::unordered_map<const DependencyNode*, Dependency> dep_old2new_;
 };
 
+ScheduleState ScheduleStateNode::Copy() const {
+  return ScheduleCopier::Copy(GetRef<ScheduleState>(this));
+}
+
 void ConcreteScheduleNode::WorkOn(const String& func_name) {
   this->func_working_on_ = this->state_->mod->GetGlobalVar(func_name);
 }
@@ -24,8 +24,14 @@ namespace tir {
 Schedule Schedule::Traced(IRModule mod, support::LinearCongruentialEngine::TRandState seed,
                           int debug_mask, ScheduleErrorRenderLevel error_render_level,
                           bool enable_check) {
+  return Schedule::Traced(ScheduleState(mod, debug_mask, enable_check), seed, error_render_level);
+}
+
+Schedule Schedule::Traced(ScheduleState state, support::LinearCongruentialEngine::TRandState seed,
+                          ScheduleErrorRenderLevel error_render_level) {
   ObjectPtr<TracedScheduleNode> n = make_object<TracedScheduleNode>();
-  n->state_ = ScheduleState(mod, debug_mask, enable_check);
+  IRModule mod = state->mod;
+  n->state_ = std::move(state);
   n->error_render_level_ = error_render_level;
   n->symbol_table_ = {};
   n->analyzer_ = std::make_unique<arith::Analyzer>();
@@ -34,6 +34,9 @@
 #include <tvm/tir/stmt_functor.h>  // For the class StmtExprMutator
 #include <tvm/tir/var.h>
 
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>  // For std::pair
 #include <vector>
 
@@ -48,6 +51,12 @@ namespace tir {
  */
 using Context = std::vector<std::pair<Var, MaybeValue>>;
 
+/*!
+ * \brief A hashtable from the normal forms of the values of a context to the first variable bound
+          to them, for finding in constant time a variable holding a computation
+ */
+using ContextIndex = std::unordered_map<PrimExpr, Var, StructuralHash, ExprDeepEqual>;
+
 /*!
  * \brief Mutator that performs Common Subexpression Elimination (CSE) for the body of a
           PrimFunc, mutating both its expressions and statements.
@@ -73,17 +82,19 @@ class CommonSubexpressionEliminator : public StmtExprMutator {
   Stmt VisitStmt_(const ForNode* op) override;
 
  private:
-  Stmt initial_body_;     // Kept for checking if names of new variables already exist
-  Context context_;       // Context associating variables to (maybe) definitions
-  int num_last_try_ = 0;  // Number of the last variable tried
-  int nb_var_ = 0;        // Number of variables introduced by the CSE pass
+  Stmt initial_body_;           // Kept for checking if names of new variables already exist
+  Context context_;             // Context associating variables to (maybe) definitions
+  ContextIndex context_index_;  // Index of the definitions of `context_`
+  int num_last_try_ = 0;        // Number of the last variable tried
+  int nb_var_ = 0;              // Number of variables introduced by the CSE pass
 
   bool identify_equiv_terms_ = false;
+  TermTable terms_;                                    // Memoized normal forms of the terms seen
+  std::unordered_set<std::string> initial_var_names_;  // Names of the vars of `initial_body_`
 
   static bool ForbiddenComputation(const PrimExpr& expr);
   static bool IsEligibleComputation(const PrimExpr& expr);
   static bool CanContainEligibleComputations(const PrimExpr& expr);
-  static bool OrderOnExprAndFrequency(std::pair<PrimExpr, size_t> a, std::pair<PrimExpr, size_t> b);
   Var GenerateNewVar(DataType type_annotation);
 };
 
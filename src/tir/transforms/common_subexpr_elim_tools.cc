@@ -36,7 +36,9 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>  // For the declaration of the pass
 
-#include <algorithm>      // For std::find_if
+#include <algorithm>  // For std::find_if
+#include <sstream>
+#include <string>
 #include <unordered_map>  // For the hashtable datatype
 #include <utility>
 #include <vector>
@@ -926,5 +928,128 @@ void InsertVectorToSortedSemanticComputations(std::vector<std::pair<PrimExpr, si
   }
 }
 
+/* ************************************** Class TermTable ***************************************
+*********************************************************************************************** */
+
+const TermTable::Entry& TermTable::Lookup(const PrimExpr& expr) {
+  auto it = entries_.find(expr);
+  if (it == entries_.end()) {
+    Entry entry;
+    entry.normal_form = NormalizeTerm(expr, identify_equiv_terms_);
+    entry.hash = StructuralHash()(entry.normal_form);
+    it = entries_.emplace(expr, std::move(entry)).first;
+  }
+  return it->second;
+}
+
+const PrimExpr& TermTable::Normalize(const PrimExpr& expr) { return Lookup(expr).normal_form; }
+
+size_t TermTable::Complexity(const PrimExpr& expr) {
+  auto it = complexities_.find(expr);
+  if (it == complexities_.end()) {
+    it = complexities_.emplace(expr, CalculateExprComplexity(expr)).first;
+  }
+  return it->second;
+}
+
+const std::string& TermTable::Repr(const PrimExpr& expr) {
+  auto it = reprs_.find(expr);
+  if (it == reprs_.end()) {
+    std::stringstream stream;
+    stream << AsLegacyRepr(expr);
+    it = reprs_.emplace(expr, stream.str()).first;
+  }
+  return it->second;
+}
+
+bool TermTable::Equivalent(const PrimExpr& a, const PrimExpr& b) {
+  if (a.same_as(b)) {
+    return true;
+  }
+  if (!identify_equiv_terms_) {
+    // The normal forms are the terms themselves, and the deep comparison exits at the first
+    // difference, which is cheaper than hashing both terms.
+    return EqualTerms(a, b);
+  }
+  const Entry& entry_a = Lookup(a);
+  const Entry& entry_b = Lookup(b);
+  return entry_a.hash == entry_b.hash && EqualTerms(entry_a.normal_form, entry_b.normal_form);
+}
+
+/* ******************************* Class SortedSemanticComputations *****************************
+*********************************************************************************************** */
+
+SortedSemanticComputations::SortedSemanticComputations(const ComputationTable& table,
+                                                       TermTable* terms)
+    : terms_(terms) {
+  items_.assign(table.begin(), table.end());
+  if (terms_->identify_equiv_terms()) {
+    // Merge the equivalent computations, choosing as representant of each class the first of its
+    // computations in the textual order, so that the representants are deterministic.
+    std::sort(items_.begin(), items_.end(),
+              [this](const std::pair<PrimExpr, size_t>& a, const std::pair<PrimExpr, size_t>& b) {
+                return terms_->Repr(a.first) < terms_->Repr(b.first);
+              });
+    std::unordered_map<PrimExpr, size_t, ObjectPtrHash, ObjectPtrEqual> counts;
+    std::vector<PrimExpr> order;
+    for (const auto& [expr, count] : items_) {
+      auto [it, inserted] = representants_.emplace(terms_->Normalize(expr), expr);
+      if (inserted) {
+        order.push_back(expr);
+      }
+      counts[it->second] += count;
+    }
+    items_.clear();
+    for (const PrimExpr& expr : order) {
+      items_.push_back({expr, counts[expr]});
+    }
+  } else {
+    for (const auto& [expr, count] : items_) {
+      representants_.emplace(expr, expr);
+    }
+  }
+  std::sort(items_.begin(), items_.end(),
+            [this](const std::pair<PrimExpr, size_t>& a, const std::pair<PrimExpr, size_t>& b) {
+              return Before(a.first, b.first);
+            });
+}
+
+bool SortedSemanticComputations::Before(const PrimExpr& a, const PrimExpr& b) {
+  size_t a_size = terms_->Complexity(a);
+  size_t b_size = terms_->Complexity(b);
+  if (a_size != b_size) {
+    return a_size > b_size;
+  }
+  return terms_->Repr(a) < terms_->Repr(b);
+}
+
+void SortedSemanticComputations::Insert(const std::vector<PrimExpr>& exprs,
+                                        size_t increase_count) {
+  for (const PrimExpr& expr : exprs) {
+    auto [it_rep, inserted] = representants_.emplace(terms_->Normalize(expr), expr);
+    const PrimExpr& representant = it_rep->second;
+    size_t size = terms_->Complexity(representant);
+    if (inserted) {
+      // As before the hashtable, a new computation goes after all the computations at least as
+      // big as it is.
+      auto it = std::partition_point(items_.begin(), items_.end(),
+                                     [&](const std::pair<PrimExpr, size_t>& item) {
+                                       return terms_->Complexity(item.first) >= size;
+                                     });
+      items_.insert(it, {expr, increase_count});
+      continue;
+    }
+    // Look for the representant among the computations as big as it is.
+    auto it = std::partition_point(items_.begin(), items_.end(),
+                                   [&](const std::pair<PrimExpr, size_t>& item) {
+                                     return terms_->Complexity(item.first) > size;
+                                   });
+    while (!it->first.same_as(representant)) {
+      ++it;
+    }
+    it->second += increase_count;
+  }
+}
+
 }  // namespace tir
 }  // namespace tvm
@@ -34,6 +34,7 @@
 #include <tvm/tir/stmt_functor.h>  // For the class StmtExprVisitor
 
 #include <optional>
+#include <string>
 #include <unordered_map>  // For the hashtable datatype
 #include <utility>        // For pairs datatype
 #include <vector>
@@ -215,6 +216,72 @@ void InsertVectorToSortedSemanticComputations(std::vector<std::pair<PrimExpr, si
                                               const std::vector<PrimExpr>& vec_to_add,
                                               bool identify_equiv_terms, size_t increase_count = 1);
 
+/*!
+ * \brief Hash-consing of the terms seen by the CSE pass. The normal form of a term, the hash of
+          this normal form, the complexity of the term and its textual representation are computed
+          once per node and memoized, so that the semantic comparisons of the pass do not normalize
+          the same terms over and over, and are decided by comparing hashes in the common case.
+ */
+class TermTable {
+ public:
+  explicit TermTable(bool identify_equiv_terms) : identify_equiv_terms_(identify_equiv_terms) {}
+
+  /*! \brief The normal form of a term, see NormalizeTerm(). */
+  const PrimExpr& Normalize(const PrimExpr& expr);
+  /*! \brief The complexity of a term, see CalculateExprComplexity(). */
+  size_t Complexity(const PrimExpr& expr);
+  /*! \brief The textual representation of a term, used for ordering terms deterministically. */
+  const std::string& Repr(const PrimExpr& expr);
+  /*! \brief Decides if two terms are equivalent, see EquivalentTerms(). */
+  bool Equivalent(const PrimExpr& a, const PrimExpr& b);
+
+  bool identify_equiv_terms() const { return identify_equiv_terms_; }
+
+ private:
+  struct Entry {
+    PrimExpr normal_form;
+    size_t hash = 0;
+  };
+  const Entry& Lookup(const PrimExpr& expr);
+
+  bool identify_equiv_terms_;
+  std::unordered_map<PrimExpr, Entry, ObjectPtrHash, ObjectPtrEqual> entries_;
+  std::unordered_map<PrimExpr, size_t, ObjectPtrHash, ObjectPtrEqual> complexities_;
+  std::unordered_map<PrimExpr, std::string, ObjectPtrHash, ObjectPtrEqual> reprs_;
+};
+
+/*!
+ * \brief The semantic computations of a statement or an expression, sorted by decreasing
+          complexity, with a hashtable from their normal forms to the representant of their class
+          of equivalence. It replaces the vectors of semantic computations of the CSE pass, in which
+          each insertion searched linearly for an equivalent computation.
+ */
+class SortedSemanticComputations {
+ public:
+  /*!
+   * \brief Merge the equivalent computations of a table and sort them, see
+            SyntacticToSemanticComputations().
+   */
+  SortedSemanticComputations(const ComputationTable& table, TermTable* terms);
+
+  size_t size() const { return items_.size(); }
+  const std::pair<PrimExpr, size_t>& operator[](size_t i) const { return items_[i]; }
+
+  /*!
+   * \brief Add expressions to the computations, increasing the count of the equivalent
+            computation when there is one, and keeping the computations sorted.
+   */
+  void Insert(const std::vector<PrimExpr>& exprs, size_t increase_count = 1);
+
+ private:
+  /*! \brief Whether `a` comes before `b`, i.e. is bigger, or as big and first in textual order. */
+  bool Before(const PrimExpr& a, const PrimExpr& b);
+
+  TermTable* terms_;
+  std::vector<std::pair<PrimExpr, size_t>> items_;
+  std::unordered_map<PrimExpr, PrimExpr, StructuralHash, ExprDeepEqual> representants_;
+};
+
 }  // namespace tir
 }  // namespace tvm
 
@@ -17,6 +17,11 @@
  * under the License.
  */
 
+#include <tvm/tir/stmt_functor.h>
+
+#include <algorithm>
+#include <vector>
+
 #include "../../meta_schedule/utils.h"
 
 namespace tvm {
@@ -80,6 +85,316 @@ void ThreadBind(tir::Schedule sch, const tir::BlockRV& block, int64_t max_thread
   }
 }
 
+/******** Heuristic rules ********/
+
+/*! \brief The number of threads of the thread blocks scheduled by the heuristic rules. */
+constexpr int64_t kHeuristicNumThreads = 256;
+
+/*! \brief Get the constant extent of a loop, or -1 if it is dynamic. */
+int64_t GetConstExtent(const tir::Schedule& sch, const tir::LoopRV& loop) {
+  const auto* extent = sch->Get(loop)->extent.as<IntImmNode>();
+  return extent ? extent->value : -1;
+}
+
+/*! \brief Whether every iter var of the block is spatial. */
+bool IsSpatialBlock(const tir::Schedule& sch, const tir::BlockRV& block) {
+  for (const tir::IterVar& iter : sch->Get(block)->iter_vars) {
+    if (iter->iter_type != tir::IterVarType::kDataPar) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*! \brief Whether the loops of the block are bound one to one to its spatial or reduction iters. */
+bool HasSimpleLoopNest(const tir::Schedule& sch, const tir::BlockRV& block) {
+  tir::StmtSRef block_sref = sch->GetSRef(block);
+  if (!tir::IsTrivialBinding(sch->state(), block_sref)) {
+    return false;
+  }
+  Array<tir::LoopRV> loops = sch->GetLoops(block);
+  if (loops.size() != sch->Get(block)->iter_vars.size()) {
+    return false;
+  }
+  for (const tir::LoopRV& loop : loops) {
+    tir::IterVarType type = tir::GetLoopIterType(sch->GetSRef(loop));
+    if (type != tir::IterVarType::kDataPar && type != tir::IterVarType::kCommReduce) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief Inline the spatial blocks into their consumers, so that the prologues of the reductions
+ * and the chains of elementwise ops do not round trip through global memory.
+ */
+void InlineSpatialBlocks(const tir::Schedule& sch) {
+  for (const tir::BlockRV& block : meta_schedule::BlockCollector::Collect(sch)) {
+    if (!sch->GetChildBlocks(block).empty() || !IsSpatialBlock(sch, block)) {
+      continue;
+    }
+    try {
+      sch->ComputeInline(block);
+    } catch (const tvm::runtime::Error& e) {
+      // The outputs and the blocks with non-injective consumers stay as they are.
+    }
+  }
+}
+
+/*!
+ * \brief Schedule an elementwise block: one element per thread, or a vector of four elements when
+ * the innermost loop allows it.
+ */
+void ScheduleElementwise(const tir::Schedule& sch, const tir::BlockRV& block,
+                         int64_t max_thread_per_block) {
+  Array<tir::LoopRV> loops = sch->GetLoops(block);
+  int64_t vector_len = 4;
+  if (loops.empty() || GetConstExtent(sch, loops.back()) % vector_len != 0) {
+    vector_len = 1;
+  }
+  const tir::BlockNode* block_node = sch->Get(block).get();
+  for (const auto& regions : {block_node->reads, block_node->writes}) {
+    for (const tir::BufferRegion& region : regions) {
+      if (region->buffer->dtype.bits() * vector_len > 128) {
+        vector_len = 1;
+      }
+    }
+  }
+  tir::LoopRV fused = loops.empty() ? sch->AddUnitLoop(block) : sch->Fuse(loops, false);
+  int64_t extent = GetConstExtent(sch, fused);
+  int64_t num_threads = std::min(kHeuristicNumThreads, max_thread_per_block);
+  if (extent != -1) {
+    num_threads = std::max<int64_t>(1, std::min(num_threads, extent / vector_len));
+  }
+  if (extent == -1 || extent % (num_threads * vector_len) != 0) {
+    // A predicated tail would keep the innermost loop from being vectorized.
+    vector_len = 1;
+  }
+  if (vector_len > 1) {
+    Array<tir::LoopRV> splits =
+        sch->Split(fused, {NullOpt, Integer(num_threads), Integer(vector_len)});
+    sch->Bind(splits[0], "blockIdx.x");
+    sch->Bind(splits[1], "threadIdx.x");
+    sch->Vectorize(splits[2]);
+  } else {
+    Array<tir::LoopRV> splits = sch->Split(fused, {NullOpt, Integer(num_threads)});
+    sch->Bind(splits[0], "blockIdx.x");
+    sch->Bind(splits[1], "threadIdx.x");
+  }
+}
+
+/*!
+ * \brief Schedule a transpose, i.e. a spatial block reading a buffer along its second innermost
+ * loop, through a padded 32x32 tile in shared memory, so that both the reads and the writes of
+ * global memory are coalesced.
+ * \return Whether the block is a transpose.
+ */
+bool TryScheduleTranspose(const tir::Schedule& sch, const tir::BlockRV& block,
+                          int64_t max_thread_per_block) {
+  constexpr int64_t tile = 32;
+  Array<tir::LoopRV> loops = sch->GetLoops(block);
+  const tir::BlockNode* block_node = sch->Get(block).get();
+  size_t n = loops.size();
+  if (n < 2 || block_node->writes.size() != 1 || max_thread_per_block < kHeuristicNumThreads ||
+      GetConstExtent(sch, loops[n - 2]) % tile != 0 ||
+      GetConstExtent(sch, loops[n - 1]) % tile != 0) {
+    return false;
+  }
+  const tir::Var& inner = block_node->iter_vars[n - 1]->var;
+  const tir::Var& outer = block_node->iter_vars[n - 2]->var;
+  // Whether the innermost index of the region depends on the var.
+  auto uses = [](const tir::BufferRegion& region, const tir::Var& var) {
+    return !region->region.empty() &&
+           tir::UsesVar(region->region.back()->min,
+                        [&](const VarNode* v) { return v == var.get(); });
+  };
+  if (!uses(block_node->writes[0], inner)) {
+    return false;
+  }
+  int read_index = -1;
+  for (size_t i = 0; i < block_node->reads.size(); ++i) {
+    if (!uses(block_node->reads[i], inner) && uses(block_node->reads[i], outer)) {
+      read_index = static_cast<int>(i);
+      break;
+    }
+  }
+  if (read_index == -1) {
+    return false;
+  }
+  Array<tir::LoopRV> i_splits = sch->Split(loops[n - 2], {NullOpt, Integer(tile)});
+  Array<tir::LoopRV> j_splits = sch->Split(loops[n - 1], {NullOpt, Integer(tile)});
+  sch->Reorder({i_splits[0], j_splits[0], i_splits[1], j_splits[1]});
+  Array<tir::LoopRV> outer_loops(loops.begin(), loops.begin() + n - 2);
+  outer_loops.push_back(i_splits[0]);
+  outer_loops.push_back(j_splits[0]);
+  tir::LoopRV block_loop = sch->Fuse(outer_loops, false);
+  sch->Bind(block_loop, "blockIdx.x");
+  tir::BlockRV shared = sch->CacheRead(block, read_index, "shared");
+  sch->ComputeAt(shared, block_loop, /*preserve_unit_loops=*/true);
+  int ndim = static_cast<int>(sch->Get(shared)->writes[0]->buffer->shape.size());
+  if (ndim >= 2) {
+    // Pad the rows of the tile against the bank conflicts of the transposed accesses.
+    sch->StorageAlign(shared, 0, ndim - 2, tile, 1);
+  }
+  for (const tir::BlockRV& stage : {shared, block}) {
+    Array<tir::LoopRV> stage_loops = sch->GetLoops(stage);
+    tir::LoopRV fused = sch->Fuse(Array<tir::LoopRV>(stage_loops.begin() + 1, stage_loops.end()),
+                                  /*preserve_unit_iters=*/false);
+    Array<tir::LoopRV> splits = sch->Split(fused, {NullOpt, Integer(kHeuristicNumThreads)});
+    sch->Bind(splits[1], "threadIdx.x");
+  }
+  return true;
+}
+
+/*!
+ * \brief Schedule a matmul-like reduction, e.g. a (batched) matmul or the products of attention,
+ * with 64x64 output tiles per thread block, 4x4 per thread, and the operands staged in shared
+ * memory along K tiles of 16.
+ * \return Whether the block is a matmul with the extents divisible by the tiles.
+ */
+bool TryScheduleMatmul(const tir::Schedule& sch, const tir::BlockRV& block,
+                       int64_t max_thread_per_block) {
+  constexpr int64_t thread_tile = 4, num_threads_1d = 16, k_tile = 16;
+  constexpr int64_t block_tile = thread_tile * num_threads_1d;
+  tir::StmtSRef block_sref = sch->GetSRef(block);
+  if (max_thread_per_block < num_threads_1d * num_threads_1d ||
+      sch->Get(block)->writes.size() != 1 ||
+      !tir::NeedsMultiLevelTiling(sch->state(), block_sref)) {
+    return false;
+  }
+  Array<tir::LoopRV> loops = sch->GetLoops(block);
+  std::vector<int64_t> spatial_extents;
+  int64_t reduce_extent = 1;
+  for (const tir::LoopRV& loop : loops) {
+    int64_t extent = GetConstExtent(sch, loop);
+    if (tir::GetLoopIterType(sch->GetSRef(loop)) == tir::IterVarType::kDataPar) {
+      spatial_extents.push_back(extent);
+    } else {
+      reduce_extent = extent == -1 || reduce_extent == -1 ? -1 : reduce_extent * extent;
+    }
+  }
+  size_t n = spatial_extents.size();
+  if (n < 2 || spatial_extents[n - 2] % block_tile != 0 ||
+      spatial_extents[n - 1] % block_tile != 0 || reduce_extent == -1 ||
+      reduce_extent % k_tile != 0) {
+    return false;
+  }
+  tir::LoopRV fused_reduce;
+  size_t num_spatial_loops;
+  tir::ReorderAndFuseReductionLoops(sch, block, &fused_reduce, &num_spatial_loops);
+  loops = sch->GetLoops(block);
+  tir::LoopRV i = loops[num_spatial_loops - 2], j = loops[num_spatial_loops - 1];
+  Array<tir::LoopRV> i_splits =
+      sch->Split(i, {NullOpt, Integer(num_threads_1d), Integer(thread_tile)});
+  Array<tir::LoopRV> j_splits =
+      sch->Split(j, {NullOpt, Integer(num_threads_1d), Integer(thread_tile)});
+  Array<tir::LoopRV> k_splits = sch->Split(fused_reduce, {NullOpt, Integer(k_tile)});
+  sch->Reorder({i_splits[0], j_splits[0], i_splits[1], j_splits[1], k_splits[0], k_splits[1],
+                i_splits[2], j_splits[2]});
+  Array<tir::LoopRV> by_loops(loops.begin(), loops.begin() + num_spatial_loops - 2);
+  by_loops.push_back(i_splits[0]);
+  sch->Bind(sch->Fuse(by_loops, false), "blockIdx.y");
+  sch->Bind(j_splits[0], "blockIdx.x");
+  sch->Bind(i_splits[1], "threadIdx.y");
+  sch->Bind(j_splits[1], "threadIdx.x");
+
+  tir::BlockRV local = sch->CacheWrite(block, 0, "local");
+  sch->ReverseComputeAt(local, j_splits[1], /*preserve_unit_loops=*/true);
+  const Array<tir::BufferRegion> reads = sch->Get(block)->reads;
+  const tir::Buffer& output = sch->Get(block)->writes[0]->buffer;
+  // The index of the loops of the shared stages, which are inside the loop over the K tiles.
+  size_t num_outer_loops = sch->GetLoops(block).size() - 3;
+  for (int index = static_cast<int>(reads.size()) - 1; index >= 0; --index) {
+    if (reads[index]->buffer.same_as(output)) {
+      continue;
+    }
+    tir::BlockRV shared = sch->CacheRead(block, index, "shared");
+    sch->ComputeAt(shared, k_splits[0], /*preserve_unit_loops=*/true);
+    Array<tir::LoopRV> stage_loops = sch->GetLoops(shared);
+    tir::LoopRV fused =
+        sch->Fuse(Array<tir::LoopRV>(stage_loops.begin() + num_outer_loops, stage_loops.end()),
+                  /*preserve_unit_iters=*/false);
+    Array<tir::LoopRV> splits =
+        sch->Split(fused, {NullOpt, Integer(num_threads_1d), Integer(num_threads_1d)});
+    sch->Bind(splits[1], "threadIdx.y");
+    sch->Bind(splits[2], "threadIdx.x");
+  }
+  sch->DecomposeReduction(block, k_splits[0]);
+  sch->Annotate(k_splits[0], tir::attr::pragma_auto_unroll_max_step, Integer(256));
+  sch->Annotate(k_splits[0], tir::attr::pragma_unroll_explicit, Integer(1));
+  return true;
+}
+
+/*!
+ * \brief Schedule a reduction, e.g. the rows of a softmax or a norm, or a GEMV, with one thread
+ * block per output element whose threads reduce in parallel.
+ * \return Whether the reduction is long enough for the threads of a warp.
+ */
+bool TryScheduleReduction(const tir::Schedule& sch, const tir::BlockRV& block,
+                          int64_t max_thread_per_block, int64_t warp_size) {
+  Array<tir::LoopRV> loops = sch->GetLoops(block);
+  int64_t reduce_extent = 1;
+  for (const tir::LoopRV& loop : loops) {
+    if (tir::GetLoopIterType(sch->GetSRef(loop)) == tir::IterVarType::kCommReduce) {
+      int64_t extent = GetConstExtent(sch, loop);
+      // A dynamic reduction is assumed to be long.
+      reduce_extent = extent == -1 || reduce_extent == -1 ? -1 : reduce_extent * extent;
+    }
+  }
+  if (reduce_extent != -1 && reduce_extent < warp_size) {
+    return false;
+  }
+  int64_t num_threads = std::min(kHeuristicNumThreads, max_thread_per_block);
+  if (reduce_extent != -1) {
+    // Round the threads up to whole warps.
+    num_threads = std::min(num_threads, (reduce_extent + warp_size - 1) / warp_size * warp_size);
+  }
+  tir::LoopRV fused_reduce;
+  size_t num_spatial_loops;
+  tir::ReorderAndFuseReductionLoops(sch, block, &fused_reduce, &num_spatial_loops);
+  loops = sch->GetLoops(block);
+  Array<tir::LoopRV> spatial_loops(loops.begin(), loops.begin() + num_spatial_loops);
+  tir::LoopRV block_loop =
+      spatial_loops.empty() ? sch->AddUnitLoop(loops[0]) : sch->Fuse(spatial_loops, false);
+  sch->Bind(block_loop, "blockIdx.x");
+  Array<tir::LoopRV> splits = sch->Split(fused_reduce, {NullOpt, Integer(num_threads)});
+  sch->Bind(splits[1], "threadIdx.x");
+  return true;
+}
+
+/*!
+ * \brief Schedule the blocks of a PrimFunc with the heuristic rules, falling back to ThreadBind
+ * for the blocks no rule matches.
+ * \param sch The schedule working on the PrimFunc.
+ * \param max_thread_per_block The maximum number of threads per block.
+ * \param warp_size The number of threads per warp.
+ */
+void ScheduleWithHeuristics(const tir::Schedule& sch, int64_t max_thread_per_block,
+                            int64_t warp_size) {
+  InlineSpatialBlocks(sch);
+  for (const tir::BlockRV& block : meta_schedule::BlockCollector::Collect(sch)) {
+    if (!sch->GetChildBlocks(block).empty()) {
+      continue;
+    }
+    bool scheduled = false;
+    if (HasSimpleLoopNest(sch, block)) {
+      if (IsSpatialBlock(sch, block)) {
+        if (!TryScheduleTranspose(sch, block, max_thread_per_block)) {
+          ScheduleElementwise(sch, block, max_thread_per_block);
+        }
+        scheduled = true;
+      } else {
+        scheduled = TryScheduleMatmul(sch, block, max_thread_per_block) ||
+                    TryScheduleReduction(sch, block, max_thread_per_block, warp_size);
+      }
+    }
+    if (!scheduled) {
+      ThreadBind(sch, block, max_thread_per_block);
+    }
+  }
+}
+
 IRModule MarkScheduled(const IRModule& mod) {
   Map<GlobalVar, BaseFunc> result;
 
@@ -121,24 +436,64 @@ bool IsScheduledOnGPU(const BaseFunc& func) {
   return true;
 }
 
-Pass DefaultGPUSchedule() {
+/*! \brief Get the target a PrimFunc is scheduled for, i.e. its kTarget attribute or the current. */
+tvm::Target GetScheduleTarget(const BaseFunc& func) {
+  // get the target from context.
+  tvm::Target target = tvm::Target::Current();
+  // get the target from kTarget attribute
+  Optional<tvm::Target> func_target = func->attrs.GetAttr<tvm::Target>(tvm::attr::kTarget);
+  if (func_target.defined()) {
+    target = func_target.value();
+  }
+  ICHECK(target.defined()) << "The target is missing either in the current context or in "
+                              "the prim_func's attribute.";
+  return target;
+}
+
+Pass DefaultGPUSchedule(bool heuristic) {
   runtime::TypedPackedFunc<IRModule(IRModule, PassContext)> pass_func =  //
       [=](IRModule m, PassContext pc) {
+        auto needs_schedule = [](const BaseFunc& func) {
+          return func->IsInstance<tir::PrimFuncNode>() &&
+                 !func->HasNonzeroAttr(attr::kIsScheduled) && IsScheduledOnGPU(func);
+        };
+        if (heuristic) {
+          // Each function is scheduled on its own by the heuristic rules, and left to the
+          // thread binding below when a rule fails on it.
+          Map<GlobalVar, BaseFunc> scheduled;
+          for (const auto& [gv, func] : m->functions) {
+            if (!needs_schedule(func)) {
+              continue;
+            }
+            tvm::Target target = GetScheduleTarget(func);
+            int64_t max_thread_per_block =
+                target->GetAttr<Integer>("max_num_threads").value_or(Integer(1024)).IntValue();
+            int64_t warp_size =
+                target->GetAttr<Integer>("thread_warp_size").value_or(Integer(32)).IntValue();
+            tir::Schedule hsch = tir::Schedule::Concrete(IRModule({{gv, func}}), /*seed=*/-1,
+                                                         /*debug_mask=*/0,
+                                                         tir::ScheduleErrorRenderLevel::kNone);
+            try {
+              hsch->WorkOn(gv->name_hint);
+              ScheduleWithHeuristics(hsch, max_thread_per_block, warp_size);
+            } catch (const tvm::runtime::Error& e) {
+              continue;
+            }
+            scheduled.Set(gv, WithAttr(Downcast<tir::PrimFunc>(hsch->mod()->Lookup(gv)),
+                                       tir::attr::kIsScheduled, Bool(true)));
+          }
+          if (!scheduled.empty()) {
+            IRModuleNode* mod_node = m.CopyOnWrite();
+            for (const auto& [gv, func] : scheduled) {
+              mod_node->Update(gv, func);
+            }
+          }
+        }
         tir::Schedule sch = tir::Schedule::Traced(m, /*seed=*/-1, /*debug_mask=*/0,
                                                   tir::ScheduleErrorRenderLevel::kDetail);
         for (const auto& [gv, func] : m->functions) {
-          if (func->IsInstance<tir::PrimFuncNode>() && !func->HasNonzeroAttr(attr::kIsScheduled) &&
-              IsScheduledOnGPU(func)) {
-            // get the target from context.
-            tvm::Target target = tvm::Target::Current();
-            // get the target from kTarget attribute
-            Optional<tvm::Target> func_target =
-                func->attrs.GetAttr<tvm::Target>(tvm::attr::kTarget);
-            if (func_target.defined()) {
-              target = func_target.value();
-            }
-            ICHECK(target.defined()) << "The target is missing either in the current context or in "
-                                        "the prim_func's attribute.";
+          if (needs_schedule(func)) {
+            tvm::Target target = GetScheduleTarget(func);
             // get the max thread per block from target.
             Optional<Integer> opt_max_thread_per_block =
                 target->GetAttr<Integer>("max_num_threads");
@@ -25,6 +25,7 @@
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
 #include <unordered_set>
 
 #include "../../support/utils.h"
@@ -310,15 +311,19 @@ class PipelineBodyRewriter : public StmtExprMutator {
  */
 class PipelineRewriter : public StmtExprMutator {
  public:
+  /*! \brief The cache line size assumed when prefetching the global memory. */
+  static constexpr int kCacheLineBytes = 64;
+
   static Stmt Rewrite(
       Map<Var, Buffer> buffer_data_to_buffer,
       const std::unordered_set<Buffer, ObjectPtrHash, ObjectPtrEqual>& double_buffers,
       const Array<Buffer> pipeline_allocs, const For& pipeline_loop,
       const PipelineInfo& pipeline_info,
       const std::unordered_map<const VarNode*, FragmentInfo>& fragment_info,
-      const Map<String, ObjectRef> preserved_annotations) {
+      const Map<String, ObjectRef> preserved_annotations, int prefetch_distance) {
     PipelineRewriter rewriter(buffer_data_to_buffer, double_buffers, pipeline_allocs, pipeline_loop,
-                              pipeline_info, fragment_info, preserved_annotations);
+                              pipeline_info, fragment_info, preserved_annotations,
+                              prefetch_distance);
     return rewriter.BuildPipeline();
   }
 
@@ -328,7 +333,7 @@ class PipelineRewriter : public StmtExprMutator {
                    const Array<Buffer>& pipeline_allocs, const For& pipeline_loop,
                    const PipelineInfo& pipeline_info,
                    const std::unordered_map<const VarNode*, FragmentInfo>& fragment_info,
-                   const Map<String, ObjectRef> preserved_annotations)
+                   const Map<String, ObjectRef> preserved_annotations, int prefetch_distance)
 
       : buffer_data_to_buffer_(std::move(buffer_data_to_buffer)),
         double_buffers_(double_buffers),
@@ -336,7 +341,8 @@ class PipelineRewriter : public StmtExprMutator {
         pipeline_loop_(pipeline_loop),
         pipeline_info_(pipeline_info),
         fragment_info_(fragment_info),
-        preserved_annotations_(preserved_annotations) {}
+        preserved_annotations_(preserved_annotations),
+        prefetch_distance_(prefetch_distance) {}
 
   Stmt BuildPipeline() {
     // Step 1: Analyze accesses to the buffers in the pipeline and compute the number of versions
@@ -788,6 +794,67 @@ class PipelineRewriter : public StmtExprMutator {
     return stmts;
   }
 
+  /*!
+   * \brief Make the prefetches of the global memory that a block reads prefetch_distance_
+   * iterations later, one for each cache line.
+   * \param block The block in the pipeline body.
+   * \param access_index The iteration of the pipeline loop the block accesses.
+   * \return The prefetches guarded by the loop bound, or NullOpt if nothing is prefetched.
+   */
+  Optional<Stmt> MakePrefetch(const Block& block, const PrimExpr& access_index) {
+    // The regions of blocks with iter vars are not given in terms of the pipeline loop var.
+    if (!block->iter_vars.empty()) {
+      return NullOpt;
+    }
+    const VarNode* loop_var = pipeline_loop_->loop_var.get();
+    PrimExpr prefetch_index = access_index + prefetch_distance_;
+    Array<Stmt> prefetches;
+    for (const BufferRegion& read : block->reads) {
+      const Buffer& buffer = read->buffer;
+      if (buffer.scope() != "global" || read->region.empty() ||
+          std::any_of(pipeline_allocs_.begin(), pipeline_allocs_.end(),
+                      [&](const Buffer& alloc) { return alloc.same_as(buffer); })) {
+        continue;
+      }
+      // Loop invariant reads are either cached already or cannot be prefetched ahead.
+      bool is_invariant = std::none_of(read->region.begin(), read->region.end(), [&](Range r) {
+        return UsesVar(r->min, [&](const VarNode* v) { return v == loop_var; });
+      });
+      if (is_invariant) {
+        continue;
+      }
+      Array<Range> region =
+          Substitute(read->region, {{pipeline_loop_->loop_var, prefetch_index}});
+      int ndim = static_cast<int>(region.size());
+      int lanes_per_line = std::max(kCacheLineBytes / std::max(buffer->dtype.bytes(), 1), 1);
+      std::vector<Var> vars;
+      Array<PrimExpr> indices;
+      for (int i = 0; i < ndim; ++i) {
+        DataType dtype = region[i]->min.dtype();
+        vars.emplace_back("prefetch_" + buffer->name + "_" + std::to_string(i), dtype);
+        PrimExpr offset =
+            i + 1 == ndim ? vars.back() * make_const(dtype, lanes_per_line) : vars.back();
+        indices.push_back(region[i]->min + offset);
+      }
+      PrimExpr address =
+          Call(DataType::Handle(), builtin::address_of(), {BufferLoad(buffer, indices)});
+      Stmt prefetch = Evaluate(Call(buffer->dtype, builtin::prefetch(), {address, 0, 3, 1}));
+      for (int i = ndim - 1; i >= 0; --i) {
+        PrimExpr extent = region[i]->extent;
+        if (i + 1 == ndim) {
+          extent = ceildiv(extent, make_const(extent.dtype(), lanes_per_line));
+        }
+        prefetch = For(vars[i], 0, analyzer_.Simplify(extent), ForKind::kSerial, prefetch);
+      }
+      prefetches.push_back(prefetch);
+    }
+    if (prefetches.empty()) {
+      return NullOpt;
+    }
+    return IfThenElse(prefetch_index < pipeline_loop_->min + pipeline_loop_->extent,
+                      SeqStmt::Flatten(prefetches));
+  }
+
   /*!
    * \brief Emit the pipeline loop in the given range.
    * \param start The start of the range
@@ -853,6 +920,13 @@ class PipelineRewriter : public StmtExprMutator {
       new_block = Downcast<Block>(
           Substitute(new_block, {{pipeline_loop_->loop_var, normalized_access_index}}));
 
+      if (prefetch_distance_ > 0 && !pipeline_info_[block].async) {
+        if (Optional<Stmt> prefetch = MakePrefetch(block, normalized_access_index)) {
+          BlockNode* n = new_block.CopyOnWrite();
+          n->body = SeqStmt({prefetch.value(), n->body});
+        }
+      }
+
       if (pipeline_info_[block].async) {
         auto& local_state = async_states_local[stage];
 
@@ -957,6 +1031,7 @@ class PipelineRewriter : public StmtExprMutator {
   Array<Block> ordered_stmts_;
   std::map<int, AsyncStateGlobal> async_states;
   Map<String, ObjectRef> preserved_annotations_;
+  int prefetch_distance_;
 };
 
 /*!
@@ -1127,11 +1202,21 @@ class PipelineInjector : private StmtExprMutator {
       }
     }
 
+    int prefetch_distance = 0;
+    if (auto annot = op->annotations.Get(attr::software_pipeline_prefetch_distance)) {
+      prefetch_distance = Downcast<Integer>(annot)->value;
+      CHECK_GE(prefetch_distance, 0)
+          << "ValueError: The prefetch distance of the software pipeline must be non-negative, "
+             "but got "
+          << prefetch_distance;
+    }
+
     Map<String, ObjectRef> preserved_annotations;
     for (const auto& kv : op->annotations) {
       const String& key = kv.first;
       if (kv.first != attr::software_pipeline_stage && kv.first != attr::software_pipeline_order &&
-          kv.first != attr::software_pipeline_async_stages) {
+          kv.first != attr::software_pipeline_async_stages &&
+          kv.first != attr::software_pipeline_prefetch_distance) {
         preserved_annotations.Set(key, kv.second);
       }
     }
@@ -1150,7 +1235,8 @@ class PipelineInjector : private StmtExprMutator {
     // Step 4: Rewrite the pipeline body.
     Stmt pipeline = PipelineRewriter::Rewrite(buffer_data_to_buffer_, double_buffers,
                                               pipeline_allocs, GetRef<For>(op), pipeline_info,
-                                              fragment_info_, preserved_annotations);
+                                              fragment_info_, preserved_annotations,
+                                              prefetch_distance);
 
     if (const auto* realize = op->body.as<BlockRealizeNode>()) {
       const auto& block = realize->block;
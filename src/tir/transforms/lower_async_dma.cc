@@ -54,6 +54,11 @@ class AsyncDMALowerer : public arith::IRMutatorWithAnalyzer {
     std::optional<tvm::tir::MemCpyDetails> mem_copy = IdentifyMemCpy(GetRef<For>(loop), analyzer_);
     if (!mem_copy.has_value() || mem_copy->dest->region.size() != 1 ||
         mem_copy->source->region.size() != 1) {
+      // a loop over the tiles of a non-contiguous region, e.g. the rows of a 2-d block, may still
+      // be a sequence of memcpy, launched as a single chain
+      if (std::optional<Stmt> copy_tiles = LowerTileCopies(loop)) {
+        return copy_tiles.value();
+      }
       return arith::IRMutatorWithAnalyzer::VisitStmt_(loop);
     }
 
@@ -154,6 +159,68 @@ class AsyncDMALowerer : public arith::IRMutatorWithAnalyzer {
   }
 
  private:
+  // Convert this, for example:
+  // for (ax0: int32, 0, 4) {
+  //   for (ax1: int32, 0, 32) {
+  //     A_global[ax0 * 32 + ax1] = A[ax0 * 128 + ax1]
+  //   }
+  // }
+  //
+  // To this:
+  // @tir.dma_copy_tiles(
+  //   0, /* queue id */
+  //   @tir.address_of(A_global[0], dtype=handle),
+  //   @tir.address_of(A[0], dtype=handle),
+  //   128, /* tile size */
+  //   4, /* number of tiles */
+  //   128, /* dst stride */
+  //   512, /* src stride */
+  //   dtype=int32
+  // )
+  std::optional<Stmt> LowerTileCopies(const ForNode* loop) {
+    const auto* tile_loop = loop->body.as<ForNode>();
+    if (!tile_loop) {
+      return std::nullopt;
+    }
+    analyzer_->Bind(loop->loop_var, Range::FromMinExtent(loop->min, loop->extent));
+    std::optional<tvm::tir::MemCpyDetails> tile =
+        IdentifyMemCpy(GetRef<For>(tile_loop), analyzer_);
+    if (!tile.has_value() || tile->dest->region.size() != 1 ||
+        tile->source->region.size() != 1) {
+      return std::nullopt;
+    }
+
+    // the tiles must have the same size, and be evenly spaced
+    Var tile_index = loop->loop_var;
+    auto uses_tile_index = [&](const PrimExpr& expr) {
+      return UsesVar(expr, [&](const VarNode* var) { return var == tile_index.get(); });
+    };
+    PrimExpr src_min = tile->source->region[0]->min;
+    PrimExpr dst_min = tile->dest->region[0]->min;
+    PrimExpr dst_extent = tile->dest->region[0]->extent;
+    Map<Var, PrimExpr> next_tile{{tile_index, tile_index + 1}};
+    PrimExpr src_stride = analyzer_->Simplify(Substitute(src_min, next_tile) - src_min);
+    PrimExpr dst_stride = analyzer_->Simplify(Substitute(dst_min, next_tile) - dst_min);
+    if (uses_tile_index(dst_extent) || uses_tile_index(src_stride) ||
+        uses_tile_index(dst_stride)) {
+      return std::nullopt;
+    }
+
+    queue_ids_.insert(async_queue_id_.value());
+    dmas_in_group_++;
+
+    Map<Var, PrimExpr> first_tile{{tile_index, loop->min}};
+    auto src = BufferLoad(tile->source->buffer, {Substitute(src_min, first_tile)});
+    auto dst = BufferLoad(tile->dest->buffer, {Substitute(dst_min, first_tile)});
+    int src_bytes = src->dtype.bytes();
+    int dst_bytes = dst->dtype.bytes();
+    return Evaluate(
+        Call(DataType::Int(32), builtin::dma_copy_tiles(),
+             {async_queue_id_.value(), Call(DataType::Handle(), builtin::address_of(), {dst}),
+              Call(DataType::Handle(), builtin::address_of(), {src}), dst_extent * src_bytes,
+              loop->extent, dst_stride * dst_bytes, src_stride * src_bytes, dma_bypass_cache_}));
+  }
+
   int dmas_in_group_ = 0;
   std::set<int> queue_ids_;
   std::optional<int> async_queue_id_ = std::nullopt;
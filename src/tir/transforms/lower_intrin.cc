@@ -42,9 +42,13 @@ class IntrinInjecter : public tvm::arith::IRMutatorWithAnalyzer {
   using IRMutatorWithAnalyzer::VisitStmt_;
   using FLowerGeneral = runtime::TypedPackedFunc<PrimExpr(PrimExpr)>;
 
-  IntrinInjecter(arith::Analyzer* analyzer, std::string target, std::string mtriple = "")
+  IntrinInjecter(arith::Analyzer* analyzer, std::string target, std::string mtriple = "",
+                 bool fast_math = false)
       : IRMutatorWithAnalyzer(analyzer) {
     std::vector<std::string> patterns;
+    if (fast_math) {
+      patterns.push_back(target + ".FLegalizeFastMath");
+    }
     patterns.push_back(target + ".FLowerIntrinsic");
     patterns.push_back(target + ".FLegalize");
     bool is_llvm_aarch64 = (mtriple.find("aarch64") != std::string::npos);
@@ -387,8 +391,9 @@ Pass LowerIntrin() {
     ICHECK(target.defined()) << "LowerIntrin: Require the target attribute";
     arith::Analyzer analyzer;
     auto mtriple = target.value()->GetAttr<runtime::String>("mtriple", "");
-    n->body =
-        IntrinInjecter(&analyzer, target.value()->kind->name, mtriple.value())(std::move(n->body));
+    bool fast_math = f->GetAttr<Bool>(tir::attr::kFastMath, Bool(false)).value();
+    n->body = IntrinInjecter(&analyzer, target.value()->kind->name, mtriple.value(),
+                             fast_math)(std::move(n->body));
     return f;
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.LowerIntrin", {});
@@ -29,6 +29,7 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
 #include <unordered_set>
 
 #include "../../runtime/thread_storage_scope.h"
@@ -38,12 +39,28 @@
 namespace tvm {
 namespace tir {
 
+/*! \brief The ways to lower a cross-thread allreduce. */
+enum class AllreduceStrategy : int {
+  /*! \brief Shuffle within each warp, the reduction fits in a warp. */
+  kWarp = 0,
+  /*! \brief Shuffle within each warp, stage the per-warp results in shared memory and
+   * shuffle them again in the first warp. */
+  kTwoLevel = 1,
+  /*! \brief Tree reduction in shared memory. */
+  kSharedMemory = 2,
+};
+
 class ThreadAllreduceBuilder final : public StmtExprMutator {
  public:
-  explicit ThreadAllreduceBuilder(const TargetNode* target)
+  explicit ThreadAllreduceBuilder(const TargetNode* target, String strategy = "auto")
       : target_(target),
         warp_size_(target->GetAttr<Integer>("thread_warp_size", 1).value().IntValue()),
-        max_num_threads_(target->GetAttr<Integer>("max_num_threads", -1).value().IntValue()) {}
+        strategy_(strategy) {
+    CHECK(strategy_ == "auto" || strategy_ == "shuffle" || strategy_ == "shared_memory")
+        << "ValueError: tir.thread_allreduce_strategy must be one of \"auto\", \"shuffle\" or "
+           "\"shared_memory\", but got \""
+        << strategy_ << "\"";
+  }
 
   Stmt VisitStmt_(const AttrStmtNode* op) final {
     if (op->attr_key == attr::thread_extent) {
@@ -288,12 +305,14 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     // the remaining elements, and this reduction can also be optimized by
     // shuffle_down warp-level primitives.
     PrimExpr zero_index = make_const(reduce_index->dtype, 0);
-    if (IsWarpReduction(types, group_extent, reduce_extent, contiguous_reduce_extent)) {
+    AllreduceStrategy strategy =
+        SelectStrategy(types, group_extent, reduce_extent, contiguous_reduce_extent);
+    if (strategy != AllreduceStrategy::kSharedMemory) {
       std::vector<PrimExpr> reduce_results;
       DataType mask_dtype = DataType::UInt(32);
       PrimExpr mask = Call(mask_dtype, builtin::tvm_warp_activemask(), {});
 
-      if (reduce_extent <= warp_size_) {
+      if (strategy == AllreduceStrategy::kWarp) {
         std::tie(reduce_results, new_alloc_bufs) = MakeWarpAllreduce(
             values, types, combiner, reduce_index, reduce_extent, group_index, mask, NullOpt, &seq);
 
@@ -755,9 +774,9 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
         return false;  // no need to warp reduce
       } else {
         bool is_subwarp_reduction = warp_size_ % reduce_extent == 0;
-        bool is_multiwarp_reduction = max_num_threads_ != -1 &&
-                                      max_num_threads_ <= warp_size_ * warp_size_ &&
-                                      reduce_extent % warp_size_ == 0;
+        // The per-warp results are reduced again by the first warp.
+        bool is_multiwarp_reduction =
+            reduce_extent % warp_size_ == 0 && reduce_extent / warp_size_ <= warp_size_;
         if (is_subwarp_reduction || is_multiwarp_reduction) {
           return true;
         } else {
@@ -767,15 +786,73 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
     }
   }
 
+  /*!
+   * \brief Select how to lower an allreduce by its estimated latency.
+   *
+   * The estimates count the dependent steps of each variant, with a shared memory access
+   * costing kSharedAccessCost shuffles and a block-wide barrier kSyncCost shuffles. The
+   * "tir.thread_allreduce_strategy" pass config overrides the choice when the shuffle
+   * variants are applicable, for instance to tune it.
+   */
+  AllreduceStrategy SelectStrategy(const std::vector<DataType>& types, int group_extent,
+                                   int reduce_extent, int contiguous_reduce_extent) {
+    if (!IsWarpReduction(types, group_extent, reduce_extent, contiguous_reduce_extent)) {
+      return AllreduceStrategy::kSharedMemory;
+    }
+    AllreduceStrategy shuffle =
+        reduce_extent <= warp_size_ ? AllreduceStrategy::kWarp : AllreduceStrategy::kTwoLevel;
+    if (strategy_ == "shuffle") {
+      return shuffle;
+    }
+    if (strategy_ == "shared_memory") {
+      return AllreduceStrategy::kSharedMemory;
+    }
+    return SharedMemoryCost(reduce_extent) < ShuffleCost(reduce_extent)
+               ? AllreduceStrategy::kSharedMemory
+               : shuffle;
+  }
+
+  static int CeilLog2(int x) {
+    int log = 0;
+    while ((1 << log) < x) ++log;
+    return log;
+  }
+
+  /*! \brief The estimated latency of the warp and two level shuffle reductions. */
+  int ShuffleCost(int reduce_extent) const {
+    if (reduce_extent <= warp_size_) {
+      // The shuffle rounds and the broadcast from lane 0.
+      return (CeilLog2(reduce_extent) + 1) * kShuffleCost;
+    }
+    int n_warps = reduce_extent / warp_size_;
+    // Both shuffle rounds, each followed by a store to shared memory and a barrier, and the
+    // loads of the staged results.
+    return (CeilLog2(warp_size_) + CeilLog2(n_warps)) * kShuffleCost +
+           2 * (kSharedAccessCost + kSyncCost) + 2 * kSharedAccessCost;
+  }
+
+  /*! \brief The estimated latency of the shared memory tree reduction. */
+  int SharedMemoryCost(int reduce_extent) const {
+    int num_rounds = CeilLog2(reduce_extent);
+    // Rounds across warps need a barrier each, the rounds within a warp do not.
+    int num_sync_rounds = std::max(num_rounds - CeilLog2(warp_size_), 0);
+    return 2 * kSyncCost + kSharedAccessCost + num_rounds * 2 * kSharedAccessCost +
+           num_sync_rounds * kSyncCost;
+  }
+
+  static constexpr int kShuffleCost = 1;
+  static constexpr int kSharedAccessCost = 2;
+  static constexpr int kSyncCost = 8;
+
   // The target.
   const TargetNode* target_ = nullptr;
 
   // The warp size of the device.
   int warp_size_{1};
-  // The maximum number of threads of the device. "-1" denotes unknown.
-  int max_num_threads_{-1};
   // A boolean indicating if the target supports warp-level masking.
   bool need_warp_shuffle_mask_;
+  // The "tir.thread_allreduce_strategy" pass config.
+  String strategy_;
 
   // surrounding scope of thread extent.
   std::vector<const AttrStmtNode*> thread_extents_;
@@ -794,13 +871,16 @@ class ThreadAllreduceBuilder final : public StmtExprMutator {
 
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.thread_allreduce_strategy", String);
+
 Pass LowerThreadAllreduce() {
   auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
     auto* n = f.CopyOnWrite();
     auto target = f->GetAttr<Target>(tvm::attr::kTarget);
     ICHECK(target.defined()) << "LowerThreadAllreduce: Require the target attribute";
     const TargetNode* target_node = target.as<TargetNode>();
-    ThreadAllreduceBuilder thread_all_reduce(target_node);
+    String strategy = ctx->GetConfig<String>("tir.thread_allreduce_strategy", String("auto")).value();
+    ThreadAllreduceBuilder thread_all_reduce(target_node, strategy);
     n->body = thread_all_reduce(n->body);
     return f;
   };
@@ -359,6 +359,8 @@ class BuiltinLower : public StmtExprMutator {
       return make_zero(op->dtype);
     } else if (op->op.same_as(builtin::dma_copy())) {
       return MakeDMACopy(op);
+    } else if (op->op.same_as(builtin::dma_copy_tiles())) {
+      return MakeDMACopyTiles(op);
     } else if (op->op.same_as(builtin::dma_wait())) {
       return MakeDMAWait(op);
     } else if (op->op.same_as(builtin::dma_start_group())) {
@@ -397,6 +399,24 @@ class BuiltinLower : public StmtExprMutator {
     return VisitExpr(call_packed);
   }
 
+  PrimExpr MakeDMACopyTiles(const CallNode* op) {
+    PrimExpr queue_id = op->args[0];
+    PrimExpr dst = op->args[1];
+    PrimExpr src = op->args[2];
+    PrimExpr tile_size = op->args[3];
+    PrimExpr num_tiles = op->args[4];
+    PrimExpr dst_stride = op->args[5];
+    PrimExpr src_stride = op->args[6];
+    PrimExpr bypass_cache = op->args[7];
+
+    auto method_name = GetDeviceMethodName("dma_copy_tiles");
+    Call call_packed =
+        Call(DataType::Int(32), builtin::tvm_call_packed(),
+             {method_name, queue_id, dst, src, tile_size, num_tiles, dst_stride, src_stride,
+              bypass_cache});
+    return VisitExpr(call_packed);
+  }
+
   PrimExpr MakeDMAWait(const CallNode* op) {
     PrimExpr queue_id = op->args[0];
     PrimExpr inflight = op->args[1];
@@ -30,6 +30,8 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <iterator>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -42,6 +44,8 @@ namespace tir {
 
 static constexpr const char* kDeviceContextVar = "device_api_context";
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.emit_trusted_entry", Bool);
+
 namespace {
 class ReturnRewriter : public StmtMutator {
  public:
@@ -192,6 +196,27 @@ inline Stmt MakeAssertNotNull(PrimExpr ptr, std::string msg) {
   return AssertStmt(!isnull, tvm::tir::StringImm(msg), Evaluate(0));
 }
 
+/*! \brief Whether a statement of the argument binding only checks the arguments. */
+bool IsArgCheck(const Stmt& stmt) {
+  if (stmt->IsInstance<AssertStmtNode>()) {
+    return true;
+  } else if (const auto* ite = stmt.as<IfThenElseNode>()) {
+    return !ite->else_case && IsArgCheck(ite->then_case);
+  } else if (const auto* seq = stmt.as<SeqStmtNode>()) {
+    return std::all_of(seq->seq.begin(), seq->seq.end(),
+                       [](const Stmt& s) { return is_no_op(s) || IsArgCheck(s); });
+  }
+  return false;
+}
+
+/*! \brief The statements of a nest, without the checks of the arguments. */
+std::vector<Stmt> RemoveArgChecks(const std::vector<Stmt>& nest) {
+  std::vector<Stmt> result;
+  std::copy_if(nest.begin(), nest.end(), std::back_inserter(result),
+               [](const Stmt& stmt) { return !IsArgCheck(stmt); });
+  return result;
+}
+
 /* \brief Return the global_symbol of the function, if it should be updated
  *
  * \param func The function to be inspected
@@ -217,7 +242,17 @@ Optional<String> RequiresPackedAPI(const PrimFunc& func) {
   return global_symbol;
 }
 
-PrimFunc MakePackedAPI(PrimFunc func) {
+/* \brief Lower the function to the packed API
+ *
+ * \param func The function to be lowered
+ *
+ * \param trusted_entry If not null, set to the trusted entry of the
+ * function: the same packed API, without the checks of the number,
+ * type codes, shapes, strides, dtypes and devices of the arguments.
+ *
+ * \returns The lowered function
+ */
+PrimFunc MakePackedAPI(PrimFunc func, Optional<PrimFunc>* trusted_entry = nullptr) {
   auto global_symbol = RequiresPackedAPI(func);
   if (!global_symbol.defined()) {
     return func;
@@ -412,6 +447,7 @@ PrimFunc MakePackedAPI(PrimFunc func) {
   // Return error code of zero on success
   body = SeqStmt({body, Evaluate(ret(Integer(0)))});
 
+  Stmt compute_body = body;
   body = MergeNest(
       {seq_init, binder.init_nest(), seq_check, binder.asserts(), arg_buffer_declarations}, body);
   func_ptr->body = body;
@@ -425,6 +461,17 @@ PrimFunc MakePackedAPI(PrimFunc func) {
   func_ptr->checked_type_ = func_ptr->func_type_annotation();
   func_ptr->ret_type = PrimType(DataType::Int(32));
 
+  if (trusted_entry) {
+    // The caller validated the arguments, only their values are unpacked.
+    PrimFunc trusted = func;
+    trusted.CopyOnWrite()->body = MergeNest(
+        {RemoveArgChecks(seq_init), RemoveArgChecks(binder.init_nest()), seq_check,
+         RemoveArgChecks(binder.asserts()), arg_buffer_declarations},
+        compute_body);
+    *trusted_entry = WithAttr(std::move(trusted), tvm::attr::kGlobalSymbol,
+                              String(name_hint + transform::kTrustedEntrySuffix));
+  }
+
   // return the function.
   return func;
 }
@@ -433,6 +480,7 @@ namespace transform {
 
 Pass MakePackedAPI() {
   auto pass_func = [](IRModule mod, PassContext ctx) {
+    bool emit_trusted_entry = ctx->GetConfig<Bool>("tir.emit_trusted_entry", Bool(false)).value();
     Map<GlobalVar, String> packed_func_methods;
     for (const auto& [gvar, base_func] : mod->functions) {
       if (auto opt = base_func.as<PrimFunc>()) {
@@ -455,11 +503,19 @@ Pass MakePackedAPI() {
           func.CopyOnWrite()->body = body.value();
         }
 
-        func = MakePackedAPI(std::move(func));
+        Optional<PrimFunc> trusted_entry;
+        func = MakePackedAPI(std::move(func), emit_trusted_entry ? &trusted_entry : nullptr);
 
         if (!func.same_as(orig_func)) {
           updates->Add(gvar, func);
         }
+        if (trusted_entry) {
+          String symbol = trusted_entry.value()->GetAttr<String>(tvm::attr::kGlobalSymbol).value();
+          ICHECK(!mod->ContainGlobalVar(symbol))
+              << "ValueError: The trusted entry of " << gvar->name_hint << " is named " << symbol
+              << ", which is already a function of the module";
+          updates->Add(GlobalVar(symbol), trusted_entry.value());
+        }
       }
     }
 
@@ -472,6 +528,17 @@ Pass MakePackedAPI() {
   return tvm::transform::CreateModulePass(pass_func, 0, "tir.MakePackedAPI", {});
 }
 
+Optional<String> TrustedEntrySymbol(const PrimFunc& func) {
+  PassContext ctx = PassContext::Current();
+  if (!ctx->GetConfig<Bool>("tir.emit_trusted_entry", Bool(false)).value()) {
+    return NullOpt;
+  }
+  if (auto global_symbol = RequiresPackedAPI(func)) {
+    return String(global_symbol.value() + kTrustedEntrySuffix);
+  }
+  return NullOpt;
+}
+
 TVM_REGISTER_GLOBAL("tir.transform.MakePackedAPI").set_body_typed([]() { return MakePackedAPI(); });
 }  // namespace transform
 }  // namespace tir
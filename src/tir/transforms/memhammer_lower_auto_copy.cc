@@ -27,6 +27,7 @@
 
 #include <array>
 #include <stack>
+#include <unordered_set>
 
 #include "../../runtime/thread_storage_scope.h"
 #include "../schedule/utils.h"
@@ -763,14 +764,136 @@ class ThreadExtentCollector : public StmtVisitor {
   Map<String, Integer> thread_extent_;
 };
 
+/*!
+ * \brief Annotate the loops that copy global memory to shared memory through auto_copy blocks
+ * and then consume the copies, so that InjectSoftwarePipeline multi-buffers the shared memory
+ * and overlaps the copies of the next iterations with the compute of the current one.
+ *
+ * Only loops whose body allocates the shared buffers are pipelined, the allocation is what
+ * InjectSoftwarePipeline multi-buffers.
+ */
+class AutoCopyPipeliner : public StmtMutator {
+ public:
+  static Stmt Rewrite(Stmt stmt, int num_stages, bool use_async_copy) {
+    AutoCopyPipeliner pipeliner(num_stages, use_async_copy);
+    return pipeliner(std::move(stmt));
+  }
+
+ private:
+  AutoCopyPipeliner(int num_stages, bool use_async_copy)
+      : num_stages_(num_stages), use_async_copy_(use_async_copy) {}
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    For loop = Downcast<For>(StmtMutator::VisitStmt_(op));
+    if (loop->kind != ForKind::kSerial || loop->thread_binding.defined() ||
+        loop->annotations.count(attr::software_pipeline_stage) || is_one(loop->extent)) {
+      return std::move(loop);
+    }
+    const auto* realize = loop->body.as<BlockRealizeNode>();
+    if (realize == nullptr || !is_one(realize->predicate)) {
+      return std::move(loop);
+    }
+    const auto* seq = realize->block->body.as<SeqStmtNode>();
+    if (seq == nullptr) {
+      return std::move(loop);
+    }
+    std::unordered_set<const BufferNode*> allocs;
+    for (const Buffer& buffer : realize->block->alloc_buffers) {
+      allocs.insert(buffer.get());
+    }
+
+    Array<Integer> stages;
+    Array<Integer> orders;
+    std::unordered_set<const BufferNode*> copy_reads;
+    std::unordered_set<const BufferNode*> compute_writes;
+    int num_copies = 0;
+    for (size_t i = 0; i < seq->seq.size(); ++i) {
+      const Stmt& child = seq->seq[i];
+      if (const BlockNode* copy = AsGlobalToSharedCopy(child, allocs)) {
+        for (const BufferRegion& read : copy->reads) {
+          copy_reads.insert(read->buffer.get());
+        }
+        stages.push_back(Integer(0));
+        ++num_copies;
+      } else {
+        PostOrderVisit(child, [&](const ObjectRef& obj) {
+          if (const auto* store = obj.as<BufferStoreNode>()) {
+            compute_writes.insert(store->buffer.get());
+          }
+        });
+        stages.push_back(Integer(num_stages_ - 1));
+      }
+      orders.push_back(Integer(static_cast<int>(i)));
+    }
+    if (num_copies == 0 || num_copies == static_cast<int>(seq->seq.size())) {
+      return std::move(loop);
+    }
+    // The copies of the next iterations must not depend on the compute of the current one.
+    for (const BufferNode* buffer : copy_reads) {
+      if (compute_writes.count(buffer)) {
+        return std::move(loop);
+      }
+    }
+
+    ForNode* n = loop.CopyOnWrite();
+    n->annotations.Set(attr::software_pipeline_stage, stages);
+    n->annotations.Set(attr::software_pipeline_order, orders);
+    if (use_async_copy_) {
+      n->annotations.Set(attr::software_pipeline_async_stages, Array<Integer>{Integer(0)});
+    }
+    return std::move(loop);
+  }
+
+  /*! \brief Return the auto_copy block of the stmt if it copies global memory into one of the
+   * shared buffers allocated by the loop body. */
+  static const BlockNode* AsGlobalToSharedCopy(
+      const Stmt& stmt, const std::unordered_set<const BufferNode*>& allocs) {
+    const auto* realize = stmt.as<BlockRealizeNode>();
+    if (realize == nullptr || !is_one(realize->predicate)) {
+      return nullptr;
+    }
+    const BlockNode* block = realize->block.get();
+    if (GetAnn<Integer>(block, tir::attr::auto_copy).value_or(0)->value == 0 ||
+        block->writes.size() != 1 || block->reads.empty()) {
+      return nullptr;
+    }
+    const Buffer& dst = block->writes[0]->buffer;
+    runtime::StorageScope dst_scope = runtime::StorageScope::Create(dst.scope());
+    if (dst_scope.rank != runtime::StorageRank::kShared || !allocs.count(dst.get())) {
+      return nullptr;
+    }
+    for (const BufferRegion& read : block->reads) {
+      if (runtime::StorageScope::Create(read->buffer.scope()).rank !=
+          runtime::StorageRank::kGlobal) {
+        return nullptr;
+      }
+    }
+    return block;
+  }
+
+  /*! \brief The number of pipeline stages, 2 for double buffering. */
+  int num_stages_;
+  /*! \brief Whether the copies are asynchronous, i.e. lowered to cp.async. */
+  bool use_async_copy_;
+};
+
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.auto_copy_num_stages", Integer);
+
 Pass LowerAutoCopy() {
   auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
     auto* n = f.CopyOnWrite();
     AutoCopyMutator mutator(ThreadExtentCollector::CollectThreadExtent(n->body));
     n->body = mutator(std::move(n->body));
     n->body = mutator.RewritePaddingBody(n->body);
+    int num_stages = ctx->GetConfig<Integer>("tir.auto_copy_num_stages", Integer(1)).value()->value;
+    CHECK_GE(num_stages, 1) << "ValueError: tir.auto_copy_num_stages must be positive, but got "
+                            << num_stages;
+    if (num_stages > 1) {
+      bool use_async_copy = ctx->GetConfig<Bool>("tir.use_async_copy", Bool(false)).value();
+      n->body = AutoCopyPipeliner::Rewrite(std::move(n->body), num_stages, use_async_copy);
+    }
     return f;
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.LowerAutoCopy", {});
@@ -32,6 +32,7 @@
 #include <tvm/tir/op.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
 #include <optional>
 
 #include "../../arith/ir_mutator_with_analyzer.h"
@@ -49,6 +50,9 @@ struct SimplifyConfigNode : public tvm::AttrsNode<SimplifyConfigNode> {
   bool propagate_knowns_to_simplify_expressions;
   bool convert_boolean_to_and_of_ors;
   bool apply_constraints_to_boolean_branches;
+  int control_flow_max_constraints_per_buffer;
+  int control_flow_widening_threshold;
+  int control_flow_max_regions_per_touch;
 
   TVM_DECLARE_ATTRS(SimplifyConfigNode, "tir.transform.SimplifyConfig") {
     TVM_ATTR_FIELD(transitively_prove_inequalities)
@@ -76,6 +80,24 @@ struct SimplifyConfigNode : public tvm::AttrsNode<SimplifyConfigNode> {
             "If true, simplify each branch of AND/OR "
             "under a constraints provided by the other branch")
         .set_default(false);
+
+    TVM_ATTR_FIELD(control_flow_max_constraints_per_buffer)
+        .describe(
+            "When propagating known buffer values, the maximum number of constraints "
+            "tracked for each buffer, or zero for no limit")
+        .set_default(0);
+
+    TVM_ATTR_FIELD(control_flow_widening_threshold)
+        .describe(
+            "When propagating known buffer values, the number of visits of a block after "
+            "which its known values may only be narrowed, or zero to never narrow them")
+        .set_default(0);
+
+    TVM_ATTR_FIELD(control_flow_max_regions_per_touch)
+        .describe(
+            "When propagating known buffer values, the maximum number of cases into which "
+            "the known values read by a write may split it, or zero for no limit")
+        .set_default(0);
   }
 
   RewriteSimplifier::Extension GetEnabledExtensions() const {
@@ -153,7 +175,11 @@ class StmtSimplifier : public IRMutatorWithAnalyzer {
     std::optional<ControlFlowGraph> touch_pattern = std::nullopt;
     if (config->propagate_knowns_to_prove_conditional ||
         config->propagate_knowns_to_simplify_expressions) {
-      touch_pattern = ControlFlowGraph(func->body);
+      touch_pattern = ControlFlowGraph(
+          func->body, /*max_simplification_steps=*/0, /*max_revisits=*/5,
+          std::max(config->control_flow_max_constraints_per_buffer, 0),
+          std::max(config->control_flow_widening_threshold, 0),
+          std::max(config->control_flow_max_regions_per_touch, 0));
     }
 
     std::unordered_set<const VarNode*> used_in_buffer_def =
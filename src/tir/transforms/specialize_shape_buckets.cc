@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*!
+ * \file specialize_shape_buckets.cc
+ * \brief Multi-version PrimFuncs with symbolic shapes for their common shape buckets.
+ */
+#include <tvm/runtime/registry.h>
+#include <tvm/tir/function.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../../arith/constraint_extract.h"
+#include "../../arith/pattern_match.h"
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+/*!
+ * \brief Specialize the body of a PrimFunc for a shape bucket.
+ *
+ * A bucket is a conjunction of the following conditions on the symbolic shape variables:
+ *  - `n == c`, n is replaced by the constant c.
+ *  - `floormod(n, c) == 0`, n is replaced by `n_div_c * c` with `n_div_c = floordiv(n, c)`,
+ *    which makes the divisibility visible to the simplifier, e.g. for tail predicates.
+ *  - `n < c`, `n <= c`, `n > c` and `n >= c`, which only bound n in the specialized body.
+ */
+class ShapeBucketSpecializer {
+ public:
+  static Stmt Specialize(const Stmt& body, const PrimExpr& bucket,
+                         const std::unordered_set<const VarNode*>& shape_vars) {
+    Map<Var, PrimExpr> vmap;
+    std::vector<std::pair<Var, PrimExpr>> bindings;
+    for (const PrimExpr& cond : arith::ExtractConstraints(bucket, false)) {
+      arith::PVar<Var> var;
+      arith::PVar<IntImm> value, zero;
+      if ((var == value).Match(cond) || (value == var).Match(cond)) {
+        CheckShapeVar(var.Eval(), shape_vars, bucket);
+        if (!vmap.count(var.Eval())) {
+          vmap.Set(var.Eval(), value.Eval());
+        }
+      } else if (((floormod(var, value) == zero).Match(cond) ||
+                  (truncmod(var, value) == zero).Match(cond)) &&
+                 zero.Eval()->value == 0 && value.Eval()->value > 0) {
+        CheckShapeVar(var.Eval(), shape_vars, bucket);
+        if (!vmap.count(var.Eval())) {
+          Var v = var.Eval();
+          int64_t factor = value.Eval()->value;
+          Var quotient(v->name_hint + "_div_" + std::to_string(factor), v.dtype());
+          bindings.emplace_back(quotient, floordiv(v, value.Eval()));
+          vmap.Set(v, quotient * value.Eval());
+        }
+      } else if ((var < value).Match(cond) || (var <= value).Match(cond) ||
+                 (var > value).Match(cond) || (var >= value).Match(cond)) {
+        // Bounds only constrain the specialized body through the dispatch condition.
+        CheckShapeVar(var.Eval(), shape_vars, bucket);
+      } else {
+        LOG(FATAL) << "ValueError: Unsupported condition " << cond << " in the shape bucket "
+                   << bucket;
+      }
+    }
+    Stmt result = Substitute(body, vmap);
+    for (auto it = bindings.rbegin(); it != bindings.rend(); ++it) {
+      result = LetStmt(it->first, it->second, result);
+    }
+    return result;
+  }
+
+ private:
+  static void CheckShapeVar(const Var& var, const std::unordered_set<const VarNode*>& shape_vars,
+                            const PrimExpr& bucket) {
+    CHECK(shape_vars.count(var.get()))
+        << "ValueError: The shape bucket " << bucket << " refers to " << var
+        << ", which is not a parameter or a symbolic shape of the PrimFunc";
+  }
+};
+
+namespace transform {
+
+Pass SpecializeShapeBuckets() {
+  auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
+    Optional<Array<PrimExpr>> buckets = f->GetAttr<Array<PrimExpr>>(attr::kShapeBuckets);
+    if (!buckets || buckets.value().empty()) {
+      return f;
+    }
+    std::unordered_set<const VarNode*> shape_vars;
+    for (const Var& param : f->params) {
+      if (param.dtype().is_int()) {
+        shape_vars.insert(param.get());
+      }
+    }
+    for (const auto& [param, buffer] : f->buffer_map) {
+      for (const PrimExpr& dim : buffer->shape) {
+        if (const auto* var = dim.as<VarNode>()) {
+          shape_vars.insert(var);
+        }
+      }
+    }
+
+    // Dispatch to the first matching bucket, fall back to the generic body.
+    Stmt body = f->body;
+    for (auto it = buckets.value().rbegin(); it != buckets.value().rend(); ++it) {
+      Stmt specialized = ShapeBucketSpecializer::Specialize(f->body, *it, shape_vars);
+      body = IfThenElse(*it, specialized, body);
+    }
+    // The versions redefine the same loop variables and allocations.
+    body = ConvertSSA(body);
+    auto* n = f.CopyOnWrite();
+    n->body = std::move(body);
+    return WithoutAttr(std::move(f), attr::kShapeBuckets);
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.SpecializeShapeBuckets", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.SpecializeShapeBuckets").set_body_typed(SpecializeShapeBuckets);
+
+}  // namespace transform
+}  // namespace tir
+}  // namespace tvm
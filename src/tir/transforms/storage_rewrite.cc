@@ -539,6 +539,8 @@ class StoragePlanRewriter : public StmtExprMutator {
     const Object* attach_scope_{nullptr};
     // The constant size of the buffer in bits, only used if it is constant
     uint64_t const_nbits{0};
+    // The symbolic size of the buffer in bits, only used if it is not constant
+    PrimExpr sym_nbits;
     // The storage scope.
     StorageScope scope;
     // The physical dimensionality of the allocations.  Since
@@ -699,7 +701,7 @@ class StoragePlanRewriter : public StmtExprMutator {
             // transform to bits
             auto sz_nbits = sz * nbits;
             if (combo_size.defined()) {
-              combo_size = max(combo_size, sz_nbits);
+              combo_size = MaxNBits(combo_size, sz_nbits);
             } else {
               combo_size = sz_nbits;
             }
@@ -906,6 +908,30 @@ class StoragePlanRewriter : public StmtExprMutator {
     }
   }
   // Allocate new storage entry.
+  // Whether allocations of the scope are left to the register allocator rather than shared.
+  // Local arrays of symbolic size live on the stack, they can be shared like global ones.
+  static bool IsRegisterCandidate(const StorageScope& scope, bool is_known_size) {
+    if (scope.rank == StorageRank::kLocal && !is_known_size) return false;
+    return scope.rank >= StorageRank::kWarp;
+  }
+  // The size of a flat allocation in bits.
+  static PrimExpr SymbolicNBits(const AllocateNode* op) {
+    ICHECK_EQ(op->extents.size(), 1U);
+    PrimExpr extent = cast(DataType::Int(64), op->extents[0]);
+    return extent * make_const(DataType::Int(64), op->dtype.bits() * op->dtype.lanes());
+  }
+  // Prove a size bound, knowing that the extents of all allocations are non-negative.
+  bool ProveNBits(const PrimExpr& cond) {
+    With<arith::ConstraintContext> ctx(&analyzer_, nonneg_extents_);
+    return analyzer_.CanProve(cond);
+  }
+  // The maximum of two sizes, without a max() term if one provably bounds the other.
+  PrimExpr MaxNBits(const PrimExpr& a, const PrimExpr& b) {
+    if (ProveNBits(a >= b)) return a;
+    if (ProveNBits(a <= b)) return b;
+    return max(a, b);
+  }
+
   StorageEntry* NewAlloc(const AllocateNode* op, const Object* attach_scope,
                          const StorageScope& scope, size_t const_nbits) {
     ICHECK(op != nullptr);
@@ -915,6 +941,9 @@ class StoragePlanRewriter : public StmtExprMutator {
     entry->scope = scope;
     entry->elem_type = op->dtype.element_of();
     entry->const_nbits = const_nbits;
+    if (const_nbits == 0 && op->extents.size() == 1) {
+      entry->sym_nbits = SymbolicNBits(op);
+    }
     StorageEntry* e = entry.get();
     alloc_vec_.emplace_back(std::move(entry));
     return e;
@@ -933,6 +962,11 @@ class StoragePlanRewriter : public StmtExprMutator {
     // If the size of the array isn't known at compile-time, it must
     // have its own allocation with size determined at runtime.
     bool is_known_size = (const_nbits != 0);
+    if (!is_known_size) {
+      for (const PrimExpr& extent : op->extents) {
+        nonneg_extents_ = nonneg_extents_ && extent >= make_zero(extent.dtype());
+      }
+    }
 
     // Currently, only flat memory spaces can be re-used.  Packing
     // into N-d space (e.g. 2-d texture memory on GPUs) will require
@@ -941,9 +975,9 @@ class StoragePlanRewriter : public StmtExprMutator {
 
     // disable reuse of small arrays, they will be lowered to registers in LLVM
     // This rules only apply if we are using non special memory
-    bool is_small_array =
-        (scope.tag.length() == 0) && (scope.rank >= StorageRank::kWarp || op->dtype.is_handle() ||
-                                      (is_known_size && const_nbits <= 32));
+    bool is_small_array = (scope.tag.length() == 0) &&
+                          (IsRegisterCandidate(scope, is_known_size) || op->dtype.is_handle() ||
+                           (is_known_size && const_nbits <= 32));
 
     if (!enable_reuse || is_small_array || !is_flat_memory_space) {
       return NewAlloc(op, attach_scope, scope, const_nbits);
@@ -983,12 +1017,35 @@ class StoragePlanRewriter : public StmtExprMutator {
         return e;
       }
     } else {
-      // Simple strategy: round roubin.
+      // Symbolic allocation. Prefer the smallest free buffer that provably covers the
+      // request, then a buffer that is provably not larger than the request, so that
+      // the merged size stays a single term. Fall back to round robin otherwise.
+      PrimExpr nbits = SymbolicNBits(op);
+      auto best = sym_free_list_.end();
+      auto smaller = sym_free_list_.end();
+      auto first = sym_free_list_.end();
       for (auto it = sym_free_list_.begin(); it != sym_free_list_.end(); ++it) {
         StorageEntry* e = *it;
         if (e->attach_scope_ != attach_scope) continue;
         if (e->scope != scope) continue;
         if (e->elem_type != op->dtype.element_of()) continue;
+        if (first == sym_free_list_.end()) first = it;
+        if (!e->sym_nbits.defined()) continue;
+        if (ProveNBits(e->sym_nbits >= nbits)) {
+          if (best == sym_free_list_.end() || ProveNBits(e->sym_nbits < (*best)->sym_nbits)) {
+            best = it;
+          }
+        } else if (smaller == sym_free_list_.end() && ProveNBits(e->sym_nbits <= nbits)) {
+          smaller = it;
+        }
+      }
+      auto it = best != sym_free_list_.end() ? best : smaller;
+      if (it == sym_free_list_.end()) it = first;
+      if (it != sym_free_list_.end()) {
+        StorageEntry* e = *it;
+        if (e->sym_nbits.defined()) {
+          e->sym_nbits = MaxNBits(e->sym_nbits, nbits);
+        }
         sym_free_list_.erase(it);
         return e;
       }
@@ -1006,7 +1063,9 @@ class StoragePlanRewriter : public StmtExprMutator {
     // This rules only apply if we are using non special memory
     if (e->scope.tag.length() == 0) {
       // Disable sharing of local memory.
-      if (e->scope.rank >= StorageRank::kWarp || e->allocs[0]->dtype.is_handle()) return;
+      if (IsRegisterCandidate(e->scope, e->const_nbits != 0) || e->allocs[0]->dtype.is_handle()) {
+        return;
+      }
       // disable reuse of small arrays
       if (e->const_nbits > 0 && e->const_nbits <= 32) return;
     }
@@ -1027,6 +1086,8 @@ class StoragePlanRewriter : public StmtExprMutator {
   std::multimap<uint64_t, StorageEntry*> const_free_map_;
   // symbolic free list, for non constant items.
   std::list<StorageEntry*> sym_free_list_;
+  // The extents of the symbolic allocations are non-negative.
+  PrimExpr nonneg_extents_ = const_true();
   // The allocation attach map
   std::unordered_map<const Object*, std::vector<StorageEntry*>> attach_map_;
   // The allocation assign map
@@ -24,13 +24,18 @@
 // Unrolls the loop as in Halide pipeline.
 #include <tvm/arith/analyzer.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/analysis.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/op.h>
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "../../runtime/thread_storage_scope.h"
@@ -45,6 +50,7 @@ struct UnrollLoopConfigNode : public tvm::AttrsNode<UnrollLoopConfigNode> {
   int auto_max_extent;
   int explicit_unroll;
   int unroll_local_access;
+  int auto_max_register_pressure;
 
   TVM_DECLARE_ATTRS(UnrollLoopConfigNode, "tir.transform.UnrollLoopConfig") {
     TVM_ATTR_FIELD(auto_max_step)
@@ -62,6 +68,12 @@ struct UnrollLoopConfigNode : public tvm::AttrsNode<UnrollLoopConfigNode> {
     TVM_ATTR_FIELD(unroll_local_access)
         .describe("Whether to always unroll local access")
         .set_default(false);
+    TVM_ATTR_FIELD(auto_max_register_pressure)
+        .describe(
+            "The maximum number of values loaded by a loop to be automatically unrolled, "
+            "which are live at once in the unrolled body. 0 disables the limit, and a negative "
+            "value derives it from the registers per thread of a GPU target.")
+        .set_default(0);
   }
 };
 
@@ -90,12 +102,14 @@ class VarLocalAccessMarker : public ExprVisitor {
 class LoopUnroller : public StmtExprMutator {
  public:
   explicit LoopUnroller(int auto_max_step, int auto_max_depth, int auto_max_extent,
-                        bool explicit_unroll, bool unroll_local_access)
+                        bool explicit_unroll, bool unroll_local_access,
+                        int auto_max_register_pressure = 0)
       : auto_max_step_(auto_max_step),
         auto_max_depth_(auto_max_depth),
         auto_max_extent_(auto_max_extent),
         explicit_unroll_(explicit_unroll),
-        unroll_local_access_(unroll_local_access) {}
+        unroll_local_access_(unroll_local_access),
+        auto_max_register_pressure_(auto_max_register_pressure) {}
 
   Stmt VisitStmt_(const AttrStmtNode* op) final {
     if (op->attr_key == "pragma_auto_unroll_max_step") {
@@ -110,6 +124,14 @@ class LoopUnroller : public StmtExprMutator {
       Stmt ret = this->VisitStmt(op->body);
       std::swap(explicit_unroll, explicit_unroll_);
       return ret;
+    } else if (op->attr_key == attr::pragma_unroll_factor ||
+               op->attr_key == attr::pragma_unroll_and_jam) {
+      // The loop the pragma is attached to is unrolled when it is visited.
+      if (const auto* loop_var = op->node.as<VarNode>()) {
+        partial_unroll_[loop_var] = {static_cast<int>(Downcast<Integer>(op->value)->value),
+                                     op->attr_key == attr::pragma_unroll_and_jam};
+      }
+      return this->VisitStmt(op->body);
     } else {
       return StmtExprMutator::VisitStmt_(op);
     }
@@ -119,6 +141,13 @@ class LoopUnroller : public StmtExprMutator {
     // Post order so we can collect more information
     Stmt stmt = StmtExprMutator::VisitStmt_(op);
     op = stmt.as<ForNode>();
+    auto it_partial = partial_unroll_.find(op->loop_var.get());
+    if (it_partial != partial_unroll_.end() &&
+        (op->kind == ForKind::kSerial || op->kind == ForKind::kParallel)) {
+      auto [factor, jam] = it_partial->second;
+      normal_loop_depth_ += 1;
+      return PartialUnroll(op, factor, jam);
+    }
     int value = GetExtent(op);
     // condition for auto unroll
     bool auto_unroll = (op->kind == ForKind::kSerial && value >= 0 && normal_loop_depth_ == 0 &&
@@ -127,6 +156,12 @@ class LoopUnroller : public StmtExprMutator {
     auto_unroll =
         auto_unroll && (value * step_count_ <= auto_max_step_ || value <= auto_max_extent_);
 
+    // Each load of the unrolled body keeps its value in a register until it is used, so
+    // unrolling past the registers of a thread spills them.
+    if (auto_max_register_pressure_ > 0 && value * load_count_ > auto_max_register_pressure_) {
+      auto_unroll = false;
+    }
+
     if (op->kind == ForKind::kUnrolled) {
       ICHECK_GE(value, 0) << "Cannot unroll non-constant loop";
       auto_unroll = true;
@@ -140,6 +175,7 @@ class LoopUnroller : public StmtExprMutator {
 
     if (auto_unroll) {
       step_count_ *= value;
+      load_count_ *= value;
       unroll_depth_ += 1;
     } else {
       normal_loop_depth_ += 1;
@@ -161,6 +197,7 @@ class LoopUnroller : public StmtExprMutator {
   }
 
   PrimExpr VisitExpr_(const BufferLoadNode* op) final {
+    ++load_count_;
     if (unroll_local_access_) {
       auto storage_scope = runtime::StorageScope::Create(GetPtrStorageScope(op->buffer->data));
       if (storage_scope.rank == runtime::StorageRank::kLocal ||
@@ -197,13 +234,16 @@ class LoopUnroller : public StmtExprMutator {
   Stmt VisitStmt_(const SeqStmtNode* op) final {
     auto fmutate = [this](const Stmt& s) {
       int step_count = step_count_;
+      int load_count = load_count_;
       int unroll_depth = unroll_depth_;
       int normal_loop_depth = normal_loop_depth_;
       step_count_ = 0;
+      load_count_ = 0;
       unroll_depth_ = 0;
       normal_loop_depth_ = 0;
       Stmt ret = this->VisitStmt(s);
       step_count_ += step_count;
+      load_count_ += load_count;
       normal_loop_depth_ = std::max(normal_loop_depth, normal_loop_depth_);
       unroll_depth_ = std::max(unroll_depth_, unroll_depth);
       return ret;
@@ -227,6 +267,55 @@ class LoopUnroller : public StmtExprMutator {
     return SeqStmt::Flatten(unrolled);
   }
 
+  /*!
+   * \brief Unroll the loop partially by the factor, followed by a loop over the remaining
+   *  iterations, which is unrolled too when its extent is constant.
+   * \param jam Whether to jam the copies of the body into its inner loop, so that the inner
+   *  loop runs once for factor iterations of the outer one (unroll-and-jam).
+   */
+  Stmt PartialUnroll(const ForNode* op, int factor, bool jam) {
+    if (factor <= 1) return GetRef<Stmt>(op);
+    auto uses_loop_var = [op](const VarNode* var) { return var == op->loop_var.get(); };
+    const ForNode* inner = jam ? op->body.as<ForNode>() : nullptr;
+    if (inner != nullptr &&
+        (inner->kind != ForKind::kSerial || UsesVar(inner->min, uses_loop_var) ||
+         UsesVar(inner->extent, uses_loop_var))) {
+      // A loop whose bounds depend on the outer var cannot be jammed.
+      inner = nullptr;
+    }
+    DataType dtype = op->loop_var.dtype();
+    PrimExpr main_extent = analyzer_.Simplify(floordiv(op->extent, make_const(dtype, factor)));
+    Var outer = op->loop_var.copy_with_suffix("_outer");
+
+    Stmt body = inner != nullptr ? inner->body : op->body;
+    Array<Stmt> copies;
+    for (int i = 0; i < factor; ++i) {
+      PrimExpr index = op->min + outer * make_const(dtype, factor) + make_const(dtype, i);
+      Map<Var, PrimExpr> vmap{{op->loop_var, index}};
+      copies.push_back(Substitute(body, vmap));
+    }
+    Stmt main_body = SeqStmt::Flatten(copies);
+    if (inner != nullptr) {
+      main_body = For(inner->loop_var, inner->min, inner->extent, inner->kind, main_body,
+                      inner->thread_binding, inner->annotations);
+    }
+
+    Array<Stmt> seq;
+    if (!is_zero(main_extent)) {
+      seq.push_back(For(outer, make_zero(dtype), main_extent, op->kind, main_body, NullOpt,
+                        op->annotations));
+    }
+    PrimExpr remainder = analyzer_.Simplify(op->extent - main_extent * make_const(dtype, factor));
+    if (!is_zero(remainder)) {
+      For tail(op->loop_var, analyzer_.Simplify(op->min + main_extent * make_const(dtype, factor)),
+               remainder, op->kind, op->body, NullOpt, op->annotations);
+      seq.push_back(GetExtent(tail.get()) >= 0 && op->kind == ForKind::kSerial
+                        ? Unroll(tail.get())
+                        : Stmt(tail));
+    }
+    return seq.empty() ? Evaluate(0) : SeqStmt::Flatten(seq);
+  }
+
  private:
   // returns the extent of the loop if it's a constant integer, otherwise return -1
   int GetExtent(const ForNode* op) {
@@ -251,21 +340,52 @@ class LoopUnroller : public StmtExprMutator {
   bool explicit_unroll_;
   // Wether to unroll loops to local access.
   bool unroll_local_access_{false};
+  // The maximum number of loads in an auto unrolled loop, 0 for no limit.
+  int auto_max_register_pressure_{0};
+  // The factor and whether to jam of the loops to be partially unrolled, by their loop var.
+  std::unordered_map<const VarNode*, std::pair<int, bool>> partial_unroll_;
   // Number of normal loops in scope
   int normal_loop_depth_{0};
   // number of unrolled cases in current scope.
   int unroll_depth_{0};
   // Number of total steps unrolled
   int step_count_{0};
+  // Number of total loads unrolled
+  int load_count_{0};
   // set of indices touched during visit local memory
   std::unordered_set<Var> var_touched_local_;
   // analyzer
   arith::Analyzer analyzer_;
 };
 
-Stmt UnrollLoop(Stmt stmt, UnrollLoopConfig cfg) {
+/*!
+ * \brief The number of registers a thread of the kernel can use without limiting the occupancy,
+ *  for a GPU target, or 0 if there is no such limit.
+ */
+int GetRegisterBudget(const Stmt& stmt, const Optional<Target>& target) {
+  if (!target.defined() || target.value()->GetTargetDeviceType() == kDLCPU) {
+    return 0;
+  }
+  int64_t registers_per_block =
+      target.value()->GetAttr<runtime::Int>("registers_per_block").value_or(65536)->value;
+  int64_t threads_per_block = 1;
+  PostOrderVisit(stmt, [&threads_per_block](const ObjectRef& obj) {
+    const auto* attr = obj.as<AttrStmtNode>();
+    if (attr == nullptr || attr->attr_key != attr::thread_extent) return;
+    const auto* iv = attr->node.as<IterVarNode>();
+    const auto* extent = attr->value.as<IntImmNode>();
+    if (iv != nullptr && extent != nullptr &&
+        std::string(iv->thread_tag).compare(0, 10, "threadIdx.") == 0) {
+      threads_per_block *= extent->value;
+    }
+  });
+  // 255 is the most registers a thread can address on CUDA.
+  return static_cast<int>(std::min<int64_t>(255, registers_per_block / threads_per_block));
+}
+
+Stmt UnrollLoop(Stmt stmt, UnrollLoopConfig cfg, int register_budget) {
   Stmt ret = LoopUnroller(cfg->auto_max_step, cfg->auto_max_depth, cfg->auto_max_extent,
-                          cfg->explicit_unroll, cfg->unroll_local_access)(stmt);
+                          cfg->explicit_unroll, cfg->unroll_local_access, register_budget)(stmt);
   if (!ret.same_as(stmt)) {
     return ConvertSSA(ret);
   } else {
@@ -282,7 +402,11 @@ Pass UnrollLoop() {
     if (!cfg.defined()) {
       cfg = AttrsWithDefaultValues<UnrollLoopConfig>();
     }
-    n->body = UnrollLoop(std::move(f->body), cfg.value());
+    int register_budget = cfg.value()->auto_max_register_pressure;
+    if (register_budget < 0) {
+      register_budget = GetRegisterBudget(f->body, f->GetAttr<Target>(tvm::attr::kTarget));
+    }
+    n->body = UnrollLoop(std::move(f->body), cfg.value(), register_budget);
     return f;
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.UnrollLoop", {});
@@ -80,8 +80,22 @@ bool EnableBufferLevelPredication(Target target) {
     return enable_buffer_predication.value();
   }
 
-  // Use buffer-level predication by default for AArch64 SVE targets
-  return arith::TargetHasSVE(target);
+  // Use buffer-level predication by default for targets with native masked vector
+  // loads and stores: AArch64 SVE, x86 AVX-512 and the RISC-V vector extension.
+  if (arith::TargetHasSVE(target)) {
+    return true;
+  }
+  if (!target.defined() || target->kind->name != "llvm") {
+    return false;
+  }
+  static const runtime::PackedFunc* target_has_feature =
+      runtime::Registry::Get("target.target_has_feature");
+  if (target_has_feature == nullptr) {
+    return false;
+  }
+  bool has_avx512f = (*target_has_feature)("avx512f", target);
+  bool has_rvv = (*target_has_feature)("v", target);
+  return has_avx512f || has_rvv;
 }
 
 /*!
@@ -89,8 +103,11 @@ bool EnableBufferLevelPredication(Target target) {
  * predicate expression where possible.
  *
  * \note For now we start with a minimal case targeting block-level predicates
- * produced by the split schedule primitive, with the potential for predicating
- * more complex terms in the future if needed.
+ * produced by the split schedule primitive, i.e. conditions of the form
+ * `base + lane < limit` or `base + lane <= limit`, with the potential for
+ * predicating more complex terms in the future if needed. Since the condition
+ * only depends on the lane, every vectorized access of the same number of lanes
+ * can be predicated with it, whatever its own index pattern.
  *
  * \example
  * Before:
@@ -119,21 +136,39 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
    * stmt if successful.
    */
   std::pair<bool, Stmt> Run(Stmt stmt, PrimExpr condition) {
-    // Check that the condition provided is of the form a < b, for now.
-    if (!condition->IsInstance<LTNode>()) {
-      return {false, stmt};
+    if (const auto* call = condition.as<CallNode>()) {
+      if (call->op.same_as(builtin::likely())) {
+        condition = call->args[0];
+      }
     }
 
-    LT lt = Downcast<LT>(condition);
+    // Check that the condition provided is of the form a < b or a <= b, for now.
+    PrimExpr a, b;
+    bool inclusive = false;
+    if (const auto* lt = condition.as<LTNode>()) {
+      a = lt->a;
+      b = lt->b;
+    } else if (const auto* le = condition.as<LENode>()) {
+      a = le->a;
+      b = le->b;
+      inclusive = true;
+    } else {
+      return {false, stmt};
+    }
 
     // Check the form of the vectorized condition, we're expecting
-    // Ramp(...) < Broadcast(...)
-    if (!lt->a->IsInstance<RampNode>() || !lt->b->IsInstance<BroadcastNode>()) {
+    // Ramp(..., 1, ...) < Broadcast(...)
+    const auto* ramp = a.as<RampNode>();
+    const auto* broadcast = b.as<BroadcastNode>();
+    if (ramp == nullptr || broadcast == nullptr || !is_one(ramp->stride)) {
       return {false, stmt};
     }
 
-    base_ = Downcast<Ramp>(lt->a)->base;
-    limit_ = Downcast<Broadcast>(lt->b)->value;
+    base_ = ramp->base;
+    limit_ = inclusive ? broadcast->value + make_const(broadcast->value.dtype(), 1)
+                       : broadcast->value;
+    lanes_ = ramp->dtype.get_lanes_or_vscale_factor();
+    is_scalable_ = ramp->dtype.is_scalable_vector();
 
     // Now we can try to predicate
     Stmt predicated_stmt = StmtExprMutator::operator()(std::move(stmt));
@@ -165,14 +200,13 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
     }
     Ramp ramp = Downcast<Ramp>(node->indices[0]);
 
-    // The vectorized access pattern must match the base of the predicate
-    if (!tvm::StructuralEqual()(ramp->base, base_)) {
+    // The vectorized access must have the lanes of the predicate
+    if (ramp->dtype.get_lanes_or_vscale_factor() != lanes_ ||
+        ramp->dtype.is_scalable_vector() != is_scalable_) {
       return node;
     }
 
-    DataType buf_predicate_dtype =
-        DataType(DataType::kUInt, 1, ramp->dtype.get_lanes_or_vscale_factor(),
-                 ramp->dtype.is_scalable_vector());
+    DataType buf_predicate_dtype = DataType(DataType::kUInt, 1, lanes_, is_scalable_);
     Call lane_mask = Call(buf_predicate_dtype, builtin::get_active_lane_mask(), {base_, limit_});
 
     num_accesses_rewritten_ += 1;
@@ -186,6 +220,10 @@ class TryPredicateBufferAccesses : public StmtExprMutator {
   /*! \brief The limit of the predicate. The expr specifies the upper bound of the base's
    * evaluated value. */
   PrimExpr limit_;
+  /*! \brief The number of lanes (or the vscale factor) of the predicate. */
+  int lanes_ = 0;
+  /*! \brief Whether the predicate is a scalable vector. */
+  bool is_scalable_ = false;
   /*! \brief The number of buffer accesses in the stmt we will analyze. */
   size_t num_accesses_analyzed_ = 0;
   /*! \brief The number of buffer accesses rewritten with predicates. */
@@ -708,8 +746,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
       else_case = this->VisitStmt(op->else_case.value());
     }
     // Check if we can rewrite the condition with predicated buffers
-    if (EnableBufferLevelPredication(target_) &&
-        condition.dtype().is_scalable_or_fixed_length_vector() && !else_case.defined()) {
+    if (condition.dtype().is_scalable_or_fixed_length_vector() && !else_case.defined() &&
+        EnableBufferLevelPredication(target_)) {
       std::pair<bool, Stmt> success_stmt_pair =
           TryPredicateBufferAccesses().Run(then_case, condition);
       bool can_remove_if_then_else = success_stmt_pair.first;
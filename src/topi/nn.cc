@@ -29,6 +29,7 @@
 #include <tvm/topi/nn/dense.h>
 #include <tvm/topi/nn/dilate.h>
 #include <tvm/topi/nn/flatten.h>
+#include <tvm/topi/nn/fused_norm.h>
 #include <tvm/topi/nn/group_norm.h>
 #include <tvm/topi/nn/instance_norm.h>
 #include <tvm/topi/nn/layer_norm.h>
@@ -78,6 +79,11 @@ TVM_REGISTER_GLOBAL("topi.nn.dense").set_body([](TVMArgs args, TVMRetValue* rv)
   *rv = nn::dense(args[0], args[1], args[2], args[3]);
 });
 
+TVM_REGISTER_GLOBAL("topi.nn.weight_only_dense").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = nn::weight_only_dense(args[0], args[1], args[2], args[3], args[4], args[5], args[6],
+                              args[7]);
+});
+
 /* Ops from nn/bias_add.h */
 TVM_REGISTER_GLOBAL("topi.nn.bias_add").set_body([](TVMArgs args, TVMRetValue* rv) {
   *rv = nn::bias_add(args[0], args[1], args[2]);
@@ -187,5 +193,16 @@ TVM_REGISTER_GLOBAL("topi.nn.rms_norm").set_body([](TVMArgs args, TVMRetValue* r
   *rv = nn::rms_norm(args[0], args[1], args[2], static_cast<double>(args[3]));
 });
 
+/* Ops from nn/fused_norm.h */
+TVM_REGISTER_GLOBAL("topi.nn.add_rms_norm").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = nn::add_rms_norm(args[0], args[1], args[2], args[3], static_cast<double>(args[4]),
+                         static_cast<double>(args[5]), args[6]);
+});
+
+TVM_REGISTER_GLOBAL("topi.nn.add_layer_norm").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = nn::add_layer_norm(args[0], args[1], args[2], args[3], args[4],
+                           static_cast<double>(args[5]), static_cast<double>(args[6]), args[7]);
+});
+
 }  // namespace topi
 }  // namespace tvm
@@ -193,3 +193,33 @@ TEST_F(HexagonDeviceAPITest, vtcm_pool) {
   EXPECT_THROW(hexapi->VtcmPool(), InternalError);
   hexapi->AcquireResources();
 }
+
+// Ensure parallel tasks run on the HVX threads, each with its own VTCM slice and user DMA
+TEST_F(HexagonDeviceAPITest, parallel_launch) {
+  struct Closure {
+    HexagonDeviceAPI* hexapi;
+    void* slices[4];
+    HexagonUserDMA* dmas[4];
+  } closure{hexapi, {}, {}};
+  auto flambda = [](int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+    Closure* c = static_cast<Closure*>(cdata);
+    size_t nbytes = 0;
+    c->slices[task_id] = c->hexapi->ParallelVtcmSlice(&nbytes);
+    c->dmas[task_id] = c->hexapi->UserDMA();
+    return TVMBackendParallelBarrier(task_id, penv);
+  };
+  int ret = -1;
+  CHECK(hexapi->ParallelLaunch(flambda, &closure, 0, 16, &ret));
+  CHECK_EQ(ret, 0);
+  for (int i = 0; i < 4; ++i) {
+    CHECK(closure.slices[i] != nullptr);
+    CHECK(closure.dmas[i] != nullptr);
+    CHECK(closure.dmas[i] != hexapi->UserDMA());
+    for (int j = 0; j < i; ++j) {
+      CHECK(closure.slices[i] != closure.slices[j]);
+      CHECK(closure.dmas[i] != closure.dmas[j]);
+    }
+  }
+  size_t nbytes = 0;
+  CHECK(hexapi->ParallelVtcmSlice(&nbytes) == nullptr);
+}
@@ -19,6 +19,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "../src/runtime/hexagon/hexagon_device_api.h"
 
 using namespace tvm::runtime;
@@ -229,6 +231,39 @@ TEST_F(HexagonUserDMATest, overflow_ring_buffer) {
   }
 }
 
+TEST_F(HexagonUserDMATest, copy_chain) {
+  uint32_t number_of_dmas = 0x40;
+  uint32_t length_of_each_dma = length / number_of_dmas;
+  std::vector<void*> dsts, srcs;
+  std::vector<uint32_t> lengths(number_of_dmas, length_of_each_dma);
+  for (uint32_t i = 0; i < number_of_dmas; ++i) {
+    dsts.push_back(dst_char + i * length_of_each_dma);
+    srcs.push_back(src_char + i * length_of_each_dma);
+  }
+
+  // a chain longer than the ring buffer is rejected
+  std::vector<void*> too_many(MAX_DMA_DESCRIPTORS + 1, dst);
+  std::vector<uint32_t> too_many_lengths(MAX_DMA_DESCRIPTORS + 1, length_of_each_dma);
+  ASSERT_EQ(user_dma->CopyChain(queue_id, MAX_DMA_DESCRIPTORS + 1, too_many.data(),
+                                too_many.data(), too_many_lengths.data(), DISABLE_BYPASS),
+            DMA_FAILURE);
+
+  do {
+    ret = user_dma->CopyChain(queue_id, number_of_dmas, dsts.data(), srcs.data(), lengths.data(),
+                              DISABLE_BYPASS);
+  } while (ret == DMA_RETRY);
+  ASSERT_EQ(ret, DMA_SUCCESS);
+
+  // the chain is a single group
+  ASSERT_LE(user_dma->Poll(queue_id), 1);
+  user_dma->Wait(queue_id, 0);
+
+  // verify
+  for (uint32_t i = 0; i < length; ++i) {
+    ASSERT_EQ(src_char[i], dst_char[i]);
+  }
+}
+
 TEST_F(HexagonUserDMATest, sync_dma_bypass) {
   HexagonBuffer srchb(length, kHexagonAllocAlignment, global_scope);
   HexagonBuffer dsthb(length, kHexagonAllocAlignment, global_scope);
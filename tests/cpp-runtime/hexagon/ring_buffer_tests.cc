@@ -19,6 +19,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "../src/runtime/hexagon/ring_buffer.h"
 
 using namespace tvm::runtime;
@@ -411,3 +413,35 @@ TEST_F(QueuedRingBufferTest, two_queues_two_groups_of_two) {
   ASSERT_EQ(queued_ring_buff->InFlight(0), 0);
   ASSERT_EQ(queued_ring_buff->InFlight(1), 0);
 }
+
+TEST_F(QueuedRingBufferTest, full_then_wrap) {
+  // fill the ring buffer from queue 0
+  std::vector<int*> q0;
+  for (int i = 0; i < size; ++i) {
+    q0.push_back(queued_ring_buff->Next(0));
+    *q0.back() = inflight;
+  }
+  ASSERT_EQ(queued_ring_buff->Free(), 0);
+
+  // a full ring buffer does not track the rejected T
+  ASSERT_EQ(queued_ring_buff->Next(1), nullptr);
+  ASSERT_EQ(queued_ring_buff->InFlight(0), size);
+  ASSERT_EQ(queued_ring_buff->InFlight(1), 0);
+
+  // queue 1 reuses the first T after it is done
+  *q0[0] = finished;
+  ASSERT_EQ(queued_ring_buff->Free(), 1);
+  int* q1 = queued_ring_buff->Next(1);
+  ASSERT_EQ(q1, q0[0]);
+  *q1 = inflight;
+  ASSERT_EQ(queued_ring_buff->InFlight(0), size - 1);
+  ASSERT_EQ(queued_ring_buff->InFlight(1), 1);
+
+  for (int i = 1; i < size; ++i) {
+    *q0[i] = finished;
+  }
+  ASSERT_EQ(queued_ring_buff->InFlight(0), 0);
+  ASSERT_EQ(queued_ring_buff->InFlight(1), 1);
+  *q1 = finished;
+  ASSERT_EQ(queued_ring_buff->InFlight(1), 0);
+}
@@ -22,6 +22,9 @@
 #include <tvm/runtime/memory.h>
 #include <tvm/runtime/object.h>
 
+#include <thread>
+#include <vector>
+
 namespace tvm {
 namespace test {
 
@@ -95,3 +98,28 @@ TEST(ObjectHierachy, Basic) {
   ICHECK(refB.as<ObjAA>() == nullptr);
   ICHECK(refB.as<ObjB>() != nullptr);
 }
+
+TEST(ObjectHierachy, PooledAllocator) {
+  using namespace tvm::runtime;
+  using namespace tvm::test;
+
+  std::vector<ObjectRef> objs;
+  for (int i = 0; i < 1000; ++i) {
+    objs.push_back(ObjectRef(PooledObjAllocator().make_object<ObjAA>()));
+  }
+  ICHECK(objs[0].as<ObjA>() != nullptr);
+  ICHECK_NE(objs[0].get(), objs[1].get());
+  // blocks are reused after the objects are freed
+  const Object* first = objs.back().get();
+  objs.pop_back();
+  ObjectRef reused(PooledObjAllocator().make_object<ObjAA>());
+  ICHECK_EQ(reused.get(), first);
+  objs.clear();
+
+  // the freed blocks can be allocated from other threads
+  std::thread worker([]() {
+    ObjectRef obj(PooledObjAllocator().make_object<ObjB>());
+    ICHECK_EQ(obj->type_index(), ObjB::RuntimeTypeIndex());
+  });
+  worker.join();
+}
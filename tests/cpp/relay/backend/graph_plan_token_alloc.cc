@@ -347,5 +347,30 @@ TEST(Token2DAlloc, SameSizesButDiffMemoryScopes) {
   EXPECT_EQ(alloc.BlockMapSize(), 2);
   EXPECT_EQ(alloc.FreeListSize(), 2);
 }
+
+TEST(ArenaPack, DisjointLiveRangesShareOffsets) {
+  std::vector<ArenaBlock> blocks = {
+      {0, 100, 0, 1},  // storage_id, size, start, end
+      {1, 200, 1, 2},
+      {2, 100, 2, 3},
+      {3, 64, 3, 4},
+  };
+  size_t arena_size = PackBlocksIntoArena(&blocks, 64);
+  // The largest block goes first, the blocks live at a same step as it go after it.
+  EXPECT_EQ(blocks[1].offset, 0);
+  EXPECT_EQ(blocks[0].offset, 256);
+  EXPECT_EQ(blocks[2].offset, 256);
+  EXPECT_EQ(blocks[3].offset, 0);
+  EXPECT_EQ(arena_size, 356);
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    EXPECT_EQ(blocks[i].offset % 64, 0);
+    for (size_t j = i + 1; j < blocks.size(); ++j) {
+      bool live_together = blocks[i].start <= blocks[j].end && blocks[j].start <= blocks[i].end;
+      bool overlap = blocks[i].offset < blocks[j].offset + blocks[j].size &&
+                     blocks[j].offset < blocks[i].offset + blocks[i].size;
+      EXPECT_FALSE(live_together && overlap);
+    }
+  }
+}
 }  // namespace relay
 }  // namespace tvm
@@ -0,0 +1,110 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/packed_func.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../../src/runtime/const_loader_module.h"
+
+namespace tvm {
+namespace runtime {
+
+/*! \brief A module with functions "f<i>" initialized by "__init_f<i>", counting the inits. */
+class CountingInitModuleNode : public ModuleNode {
+ public:
+  explicit CountingInitModuleNode(int num_funcs) : num_inits(num_funcs) {
+    for (auto& n : num_inits) n = 0;
+  }
+
+  PackedFunc GetFunction(const String& name, const ObjectPtr<Object>& sptr_to_self) final {
+    std::string str = name;
+    if (str.rfind("__init_f", 0) == 0) {
+      int i = std::stoi(str.substr(8));
+      return PackedFunc([sptr_to_self, this, i](TVMArgs args, TVMRetValue* rv) {
+        Array<NDArray> consts = args[0];
+        ICHECK_EQ(consts.size(), 1U);
+        ++num_inits[i];
+        std::lock_guard<std::mutex> lock(mutex);
+        const_data.insert(consts[0]->data);
+        *rv = 0;
+      });
+    }
+    if (str.rfind("f", 0) == 0) {
+      return PackedFunc([sptr_to_self](TVMArgs args, TVMRetValue* rv) {});
+    }
+    return PackedFunc(nullptr);
+  }
+
+  const char* type_key() const final { return "counting_init"; }
+
+  std::vector<std::atomic<int>> num_inits;
+  /*! \brief The data of the constants passed to the inits, guarded by mutex. */
+  std::set<void*> const_data;
+  std::mutex mutex;
+};
+
+TEST(ConstLoaderModule, WarmUpInitializesEachSymbolOnce) {
+  constexpr int kNumFuncs = 16;
+  NDArray weight = NDArray::Empty({4}, DataType::Float(32), Device{kDLCPU, 0});
+  std::unordered_map<std::string, NDArray> const_var_ndarray{{"weight", weight}};
+  std::unordered_map<std::string, std::vector<std::string>> const_vars_by_symbol;
+  for (int i = 0; i < kNumFuncs; ++i) {
+    const_vars_by_symbol["f" + std::to_string(i)] = {"weight"};
+  }
+  auto counting = make_object<CountingInitModuleNode>(kNumFuncs);
+  Module const_loader = ConstLoaderModuleCreate(const_var_ndarray, const_vars_by_symbol);
+  const_loader.Import(Module(counting));
+
+  // The first calls race with the warm-up, which must not initialize a symbol twice.
+  std::thread caller([&]() {
+    for (int i = 0; i < kNumFuncs; ++i) {
+      const_loader.GetFunction("f" + std::to_string(i));
+    }
+  });
+  std::mutex mutex;
+  std::vector<int> progress;
+  PackedFunc fprogress([&](TVMArgs args, TVMRetValue* rv) {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(args[2].operator int(), kNumFuncs);
+    progress.push_back(args[1]);
+  });
+  EXPECT_EQ(ConstLoaderModuleWarmUp(const_loader, 4, fprogress), kNumFuncs);
+  caller.join();
+
+  for (int i = 0; i < kNumFuncs; ++i) {
+    EXPECT_EQ(counting->num_inits[i], 1);
+  }
+  ASSERT_EQ(progress.size(), static_cast<size_t>(kNumFuncs));
+  for (int i = 0; i < kNumFuncs; ++i) {
+    EXPECT_EQ(progress[i], i + 1);
+  }
+  // The constant is shared by all the inits, not copied.
+  EXPECT_EQ(counting->const_data, std::set<void*>{weight->data});
+}
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,122 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <string>
+
+#include "../../../src/runtime/contrib/json/json_runtime.h"
+
+namespace tvm {
+namespace runtime {
+namespace json {
+
+// A runtime adding float32 tensors of 4 elements, node by node.
+class AddJSONRuntime : public JSONRuntimeBase {
+ public:
+  AddJSONRuntime(const std::string& symbol_name, const std::string& graph_json,
+                 const Array<String> const_names)
+      : JSONRuntimeBase(symbol_name, graph_json, const_names) {}
+
+  void Init(const Array<NDArray>& consts) override { SetupIntermediates({kDLCPU, 0}); }
+
+  void Run() override {
+    RunNodes(
+        [this](uint32_t nid) {
+          const auto& inputs = nodes_[nid].GetInputs();
+          const float* lhs = static_cast<const float*>(data_entry_[EntryID(inputs[0])]->data);
+          const float* rhs = static_cast<const float*>(data_entry_[EntryID(inputs[1])]->data);
+          float* out = static_cast<float*>(data_entry_[EntryID(nid, 0)]->data);
+          for (int i = 0; i < 4; ++i) {
+            out[i] = lhs[i] + rhs[i];
+          }
+        },
+        /*parallel=*/true);
+  }
+
+  size_t NumIntermediateStorages() const { return intermediate_storages_.size(); }
+  size_t NumLevels() const { return levels_.size(); }
+};
+
+// a = x + x, b = x + x, c = a + b, d = c + x, out = d + c
+const char* kGraphJSON = R"({
+  "nodes": [
+    {"op": "input", "name": "x", "attrs": {"shape": [[[4]]], "dtype": [["float32"]]}},
+    {"op": "kernel", "name": "add", "inputs": [[0, 0, 0], [0, 0, 0]],
+     "attrs": {"num_inputs": "2", "num_outputs": "1", "shape": [[[4]]], "dtype": [["float32"]]}},
+    {"op": "kernel", "name": "add", "inputs": [[0, 0, 0], [0, 0, 0]],
+     "attrs": {"num_inputs": "2", "num_outputs": "1", "shape": [[[4]]], "dtype": [["float32"]]}},
+    {"op": "kernel", "name": "add", "inputs": [[1, 0, 0], [2, 0, 0]],
+     "attrs": {"num_inputs": "2", "num_outputs": "1", "shape": [[[4]]], "dtype": [["float32"]]}},
+    {"op": "kernel", "name": "add", "inputs": [[3, 0, 0], [0, 0, 0]],
+     "attrs": {"num_inputs": "2", "num_outputs": "1", "shape": [[[4]]], "dtype": [["float32"]]}},
+    {"op": "kernel", "name": "add", "inputs": [[4, 0, 0], [3, 0, 0]],
+     "attrs": {"num_inputs": "2", "num_outputs": "1", "shape": [[[4]]], "dtype": [["float32"]]}}
+  ],
+  "arg_nodes": [0],
+  "heads": [[5, 0, 0]],
+  "node_row_ptr": [0, 1, 2, 3, 4, 5, 6]
+})";
+
+TEST(JSONRuntime, IntermediateReuse) {
+  auto n = make_object<AddJSONRuntime>("add_graph", kGraphJSON, Array<String>());
+  AddJSONRuntime* runtime = n.get();
+  Module mod(n);
+  mod.GetFunction("__init_add_graph")(Array<NDArray>());
+
+  // a and b run in parallel, and d reuses the buffer of a or b.
+  EXPECT_EQ(runtime->NumLevels(), 4);
+  EXPECT_EQ(runtime->NumIntermediateStorages(), 3);
+
+  NDArray x = NDArray::Empty({4}, DLDataType{kDLFloat, 32, 1}, {kDLCPU, 0});
+  NDArray out = NDArray::Empty({4}, DLDataType{kDLFloat, 32, 1}, {kDLCPU, 0});
+  for (int i = 0; i < 4; ++i) {
+    static_cast<float*>(x->data)[i] = i;
+  }
+  mod.GetFunction("add_graph")(x, out);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(static_cast<float*>(out->data)[i], 9 * i);
+  }
+}
+
+TEST(JSONRuntime, ZeroCopy) {
+  auto n = make_object<AddJSONRuntime>("add_graph", kGraphJSON, Array<String>());
+  Module mod(n);
+  mod.GetFunction("__init_add_graph")(Array<NDArray>());
+
+  NDArray x = NDArray::Empty({4}, DLDataType{kDLFloat, 32, 1}, {kDLCPU, 0});
+  NDArray out = NDArray::Empty({4}, DLDataType{kDLFloat, 32, 1}, {kDLCPU, 0});
+  mod.GetFunction("set_input_zero_copy")(0, x);
+  mod.GetFunction("set_output_zero_copy")(0, out);
+  for (int step = 1; step <= 2; ++step) {
+    for (int i = 0; i < 4; ++i) {
+      static_cast<float*>(x->data)[i] = step * i;
+    }
+    mod.GetFunction("run")();
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_EQ(static_cast<float*>(out->data)[i], 9 * step * i);
+    }
+  }
+  EXPECT_ANY_THROW(mod.GetFunction("set_input_zero_copy")(1, x));
+}
+
+}  // namespace json
+}  // namespace runtime
+}  // namespace tvm
@@ -22,7 +22,9 @@
 #include <tvm/runtime/memory/memory_manager.h>
 
 #include <exception>
+#include <vector>
 
+#include "../../../../src/runtime/memory/bucketed_allocator.h"
 #include "../../../../src/runtime/memory/pooled_allocator.h"
 
 namespace tvm {
@@ -58,6 +60,21 @@ TEST_F(TvmVMMemoryManagerTest, NaiveAllocBasic) {
   EXPECT_EQ(allocator->UsedMemory(), 0);
 }
 
+TEST_F(TvmVMMemoryManagerTest, StreamOrderedAllocBasic) {
+  // Devices without stream-ordered allocations fall back to the synchronous ones.
+  Device dev = {kDLCPU, 0};
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kStreamOrdered);
+  EXPECT_EQ(allocator->type(), kStreamOrdered);
+  auto buff = allocator->Alloc(dev, 64, 32, DataType::Float(32));
+  EXPECT_EQ(buff.alloc_type, kStreamOrdered);
+  EXPECT_EQ(allocator->UsedMemory(), 64);
+  allocator->Free(buff);
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+  AllocatorStats stats = allocator->GetStats();
+  EXPECT_EQ(stats.device_alloc_count, 1);
+  EXPECT_EQ(stats.device_free_count, 1);
+}
+
 TEST_F(TvmVMMemoryManagerTest, PooledAllocBasic) {
   Device dev = {kDLCPU, 0};
   size_t nbytes = 64;
@@ -71,6 +88,122 @@ TEST_F(TvmVMMemoryManagerTest, PooledAllocBasic) {
   EXPECT_EQ(allocator->UsedMemory(), size);
 }
 
+TEST_F(TvmVMMemoryManagerTest, PooledThreadCache) {
+  Device dev = {kDLCPU, 0};
+  size_t page_size = PooledAllocator::kDefaultPageSize;
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kPooled);
+  auto buff = allocator->Alloc(dev, page_size, 32, DataType::Float(32));
+  allocator->Free(buff);
+  auto reuse = allocator->Alloc(dev, page_size, 32, DataType::Float(32));
+  EXPECT_EQ(reuse.data, buff.data);
+  ThreadCacheCounters counters = MemoryManager::GetThreadCacheCounters(dev, kPooled);
+  EXPECT_EQ(counters.hits, 1);
+  EXPECT_EQ(counters.misses, 1);
+  allocator->Free(reuse);
+
+  // Buffers freed beyond the high-water mark are flushed to the shared pool.
+  size_t num_buffers = PooledAllocator::kDefaultThreadCacheHighWaterMark / page_size + 1;
+  std::vector<Buffer> buffers;
+  for (size_t i = 0; i < num_buffers; ++i) {
+    buffers.push_back(allocator->Alloc(dev, page_size, 32, DataType::Float(32)));
+  }
+  for (const Buffer& buf : buffers) {
+    allocator->Free(buf);
+  }
+  EXPECT_EQ(MemoryManager::GetThreadCacheCounters(dev, kPooled).flushes, 1);
+  EXPECT_EQ(allocator->UsedMemory(), num_buffers * page_size);
+  allocator->Clear();
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, BucketedAllocBestFit) {
+  Device dev = {kDLCPU, 0};
+  size_t page_size = BucketedAllocator::kDefaultPageSize;
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kBucketed);
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+  auto buff = allocator->Alloc(dev, 2 * page_size, 32, DataType::Float(32));
+  EXPECT_EQ(allocator->UsedMemory(), 2 * page_size);
+  allocator->Free(buff);
+  // A slightly smaller request is served by the cached block.
+  auto reuse = allocator->Alloc(dev, 2 * page_size - 1, 32, DataType::Float(32));
+  EXPECT_EQ(reuse.data, buff.data);
+  EXPECT_EQ(allocator->UsedMemory(), 2 * page_size);
+  allocator->Free(reuse);
+  // A much smaller request does not waste the cached block.
+  auto small = allocator->Alloc(dev, 64, 32, DataType::Float(32));
+  EXPECT_NE(small.data, buff.data);
+  EXPECT_EQ(allocator->UsedMemory(), 3 * page_size);
+  allocator->Free(small);
+  allocator->Clear();
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, BucketedAllocSplitCoalesce) {
+  Device dev = {kDLCPU, 0};
+  size_t block_size = BucketedAllocator::kDefaultSplitThreshold;
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kBucketed);
+  auto large = allocator->Alloc(dev, 4 * block_size, 64, DataType::Float(32));
+  EXPECT_EQ(allocator->UsedMemory(), 4 * block_size);
+  allocator->Free(large);
+  // Two smaller requests are carved out of the freed segment.
+  auto first = allocator->Alloc(dev, block_size, 64, DataType::Float(32));
+  auto second = allocator->Alloc(dev, block_size, 64, DataType::Float(32));
+  EXPECT_EQ(first.data, large.data);
+  EXPECT_EQ(second.data, static_cast<char*>(large.data) + block_size);
+  EXPECT_EQ(allocator->UsedMemory(), 4 * block_size);
+  allocator->Free(first);
+  allocator->Free(second);
+  // The blocks are coalesced back into the whole segment.
+  auto whole = allocator->Alloc(dev, 4 * block_size, 64, DataType::Float(32));
+  EXPECT_EQ(whole.data, large.data);
+  EXPECT_EQ(allocator->UsedMemory(), 4 * block_size);
+  allocator->Free(whole);
+  allocator->Clear();
+  EXPECT_EQ(allocator->UsedMemory(), 0);
+}
+
+TEST_F(TvmVMMemoryManagerTest, PooledAllocStats) {
+  Device dev = {kDLCPU, 0};
+  size_t page_size = PooledAllocator::kDefaultPageSize;
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kPooled);
+  auto first = allocator->Alloc(dev, 64, 32, DataType::Float(32));
+  auto second = allocator->Alloc(dev, 64, 32, DataType::Float(32));
+  allocator->Free(first);
+  AllocatorStats stats = MemoryManager::GetStats(dev, kPooled);
+  EXPECT_EQ(stats.alloc_count, 2);
+  EXPECT_EQ(stats.free_count, 1);
+  EXPECT_EQ(stats.device_alloc_count, 2);
+  EXPECT_EQ(stats.reserved_bytes, 2 * page_size);
+  EXPECT_EQ(stats.in_use_bytes, page_size);
+  EXPECT_EQ(stats.cached_bytes, page_size);
+  EXPECT_EQ(stats.peak_in_use_bytes, 2 * page_size);
+  EXPECT_EQ(stats.size_histogram.size(), AllocatorStats::kNumSizeBuckets);
+  EXPECT_EQ(stats.size_histogram[6], 2);
+  allocator->Free(second);
+  allocator->Clear();
+  stats = MemoryManager::GetStats(dev, kPooled);
+  EXPECT_EQ(stats.reserved_bytes, 0);
+  EXPECT_EQ(stats.device_free_count, 2);
+  EXPECT_EQ(stats.peak_reserved_bytes, 2 * page_size);
+}
+
+TEST_F(TvmVMMemoryManagerTest, StorageLastWriteWait) {
+  Device dev = {kDLCPU, 0};
+  Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kNaive);
+  Storage storage(allocator->Alloc(dev, 64, 32, DataType::Float(32)), allocator);
+  TVMStreamHandle stream_a = reinterpret_cast<TVMStreamHandle>(0x1);
+  TVMStreamHandle stream_b = reinterpret_cast<TVMStreamHandle>(0x2);
+  // No write was recorded.
+  EXPECT_FALSE(storage->WaitForLastWrite(stream_a));
+  // Written on the default stream.
+  storage->RecordWrite(nullptr);
+  EXPECT_FALSE(storage->WaitForLastWrite(nullptr));
+  EXPECT_TRUE(storage->WaitForLastWrite(stream_a));
+  storage->RecordWrite(stream_a);
+  EXPECT_FALSE(storage->WaitForLastWrite(stream_a));
+  EXPECT_TRUE(storage->WaitForLastWrite(stream_b));
+}
+
 TEST_F(TvmVMMemoryManagerTest, NaiveEmptyBasic) {
   Device dev = {kDLCPU, 0};
   Allocator* allocator = MemoryManagerWrapper::GetOrCreateAllocator(dev, kNaive);
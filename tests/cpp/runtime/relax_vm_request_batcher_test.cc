@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/container/boxed_primitive.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../../../src/runtime/relax_vm/serving/request_batcher.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+namespace serving {
+
+constexpr int64_t kNumCols = 3;
+
+/*! \brief A function adding one to its input, counting its calls. */
+PackedFunc AddOne(std::atomic<int>* num_calls) {
+  return TypedPackedFunc<NDArray(NDArray)>([num_calls](NDArray x) {
+    ++*num_calls;
+    NDArray y = NDArray::Empty(ShapeTuple(x->shape, x->shape + x->ndim), x->dtype, x->device);
+    const float* p_x = static_cast<const float*>(x->data);
+    float* p_y = static_cast<float*>(y->data);
+    for (int64_t i = 0; i < x->shape[0] * kNumCols; ++i) {
+      p_y[i] = p_x[i] + 1.0f;
+    }
+    return y;
+  });
+}
+
+NDArray Rows(int64_t num_rows, float value) {
+  NDArray x = NDArray::Empty({num_rows, kNumCols}, DataType::Float(32), Device{kDLCPU, 0});
+  std::fill_n(static_cast<float*>(x->data), num_rows * kNumCols, value);
+  return x;
+}
+
+TEST(RelaxVMRequestBatcher, CoalesceConcurrentCalls) {
+  std::atomic<int> num_calls{0};
+  BatcherConfig config;
+  config.max_batch_size = 6;
+  config.max_delay_us = 10 * 1000 * 1000;
+  RequestBatcher batcher(make_object<RequestBatcherObj>(AddOne(&num_calls), config));
+
+  // The batch is full when the three requests of 1, 2 and 3 rows are queued.
+  std::vector<NDArray> outputs(3);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 3; ++i) {
+    threads.emplace_back([&, i]() {
+      outputs[i] = Downcast<NDArray>(batcher->Call({Rows(i + 1, 10.0f * i)}));
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_calls, 1);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(outputs[i]->shape[0], i + 1);
+    const float* p_y = static_cast<const float*>(outputs[i]->data) +
+                       outputs[i]->byte_offset / sizeof(float);
+    for (int64_t j = 0; j < (i + 1) * kNumCols; ++j) {
+      EXPECT_EQ(p_y[j], 10.0f * i + 1.0f);
+    }
+  }
+
+  Map<String, ObjectRef> metrics = batcher->GetMetrics();
+  EXPECT_EQ(Downcast<Int>(metrics["num_requests"])->value, 3);
+  EXPECT_EQ(Downcast<Int>(metrics["num_batches"])->value, 1);
+  EXPECT_EQ(Downcast<Int>(metrics["num_rows"])->value, 6);
+  IntTuple batch_sizes = Downcast<IntTuple>(metrics["batch_size_histogram"]);
+  ASSERT_EQ(batch_sizes.size(), 4);
+  EXPECT_EQ(batch_sizes[3], 1);
+}
+
+TEST(RelaxVMRequestBatcher, SeparateIncompatibleCalls) {
+  std::atomic<int> num_calls{0};
+  BatcherConfig config;
+  config.max_batch_size = 8;
+  config.max_delay_us = 1000;
+  RequestBatcher batcher(make_object<RequestBatcherObj>(AddOne(&num_calls), config));
+
+  // A request alone after the delay is passed through.
+  NDArray y = Downcast<NDArray>(batcher->Call({Rows(2, 1.0f)}));
+  EXPECT_EQ(static_cast<const float*>(y->data)[0], 2.0f);
+
+  // Requests of different non-batch dimensions are never batched together.
+  NDArray z = NDArray::Empty({1, kNumCols, 2}, DataType::Float(32), Device{kDLCPU, 0});
+  std::thread thread([&]() { batcher->Call({z}); });
+  batcher->Call({Rows(1, 0.0f)});
+  thread.join();
+  EXPECT_EQ(num_calls, 3);
+
+  batcher->Stop();
+  EXPECT_ANY_THROW(batcher->Call({Rows(1, 0.0f)}));
+}
+
+}  // namespace serving
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,196 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/container/boxed_primitive.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "../../../src/runtime/relax_vm/serving/engine.h"
+
+namespace tvm {
+namespace runtime {
+namespace relax_vm {
+namespace serving {
+
+/*! \brief A KV state recording the sequences and the forwards. */
+class MockKVStateObj : public KVStateObj {
+ public:
+  void Clear() final { seqs.clear(); }
+  void AddSequence(int64_t seq_id) final { ASSERT_TRUE(seqs.insert(seq_id).second); }
+  void RemoveSequence(int64_t seq_id) final { ASSERT_EQ(seqs.erase(seq_id), 1u); }
+  void ForkSequence(int64_t parent_seq_id, int64_t child_seq_id, int64_t fork_pos) final {}
+  void PopN(int64_t seq_id, int32_t n) final {}
+  void BeginForward(const IntTuple& seq_ids, const IntTuple& append_lengths,
+                    const Optional<IntTuple>& token_tree_parent_ptr) final {
+    this->seq_ids = seq_ids;
+    this->append_lengths = append_lengths;
+  }
+  void EndForward() final {}
+
+  std::set<int64_t> seqs;
+  IntTuple seq_ids;
+  IntTuple append_lengths;
+
+  static constexpr const char* _type_key = "test.MockKVState";
+  TVM_DECLARE_FINAL_OBJECT_INFO(MockKVStateObj, KVStateObj);
+};
+
+TVM_REGISTER_OBJECT_TYPE(MockKVStateObj);
+
+constexpr int64_t kVocabSize = 16;
+
+std::vector<int64_t> ToVector(const IntTuple& tuple) { return {tuple.begin(), tuple.end()}; }
+
+/*! \brief A model whose next token is the last token plus one. */
+PackedFunc MockForward() {
+  return TypedPackedFunc<NDArray(NDArray, KVState)>([](NDArray input_ids, KVState kv_state) {
+    const auto* state = kv_state.as<MockKVStateObj>();
+    int64_t batch_size = state->seq_ids.size();
+    NDArray logits =
+        NDArray::Empty({batch_size, kVocabSize}, DataType::Float(32), Device{kDLCPU, 0});
+    float* p_logits = static_cast<float*>(logits->data);
+    std::fill(p_logits, p_logits + batch_size * kVocabSize, 0.0f);
+    const int32_t* p_input_ids = static_cast<const int32_t*>(input_ids->data);
+    int64_t end = 0;
+    for (int64_t i = 0; i < batch_size; ++i) {
+      end += state->append_lengths[i];
+      p_logits[i * kVocabSize + (p_input_ids[end - 1] + 1) % kVocabSize] = 1.0f;
+    }
+    return logits;
+  });
+}
+
+class ServingEngineTest : public ::testing::Test {
+ protected:
+  void SetUp() final { kv_state_ = make_object<MockKVStateObj>(); }
+
+  ServingEngine CreateEngine(EngineConfig config) {
+    Device device{kDLCPU, 0};
+    return ServingEngine(
+        make_object<ServingEngineObj>(KVState(kv_state_), MockForward(), device, config));
+  }
+
+  void AddRequest(ServingEngine engine, int64_t id, std::vector<int32_t> prompt,
+                  int64_t max_new_tokens, std::unordered_set<int32_t> stop_token_ids = {}) {
+    auto request = std::make_unique<Request>();
+    request->id = id;
+    request->tokens = std::move(prompt);
+    request->max_new_tokens = max_new_tokens;
+    request->temperature = 0.0f;
+    request->top_p = 1.0f;
+    request->top_k = 0;
+    request->stop_token_ids = std::move(stop_token_ids);
+    request->callback =
+        TypedPackedFunc<void(int64_t, IntTuple, bool)>([this](int64_t id, IntTuple tokens,
+                                                              bool finished) {
+          outputs_[id].insert(outputs_[id].end(), tokens.begin(), tokens.end());
+          if (finished) finished_.insert(id);
+        });
+    engine->AddRequest(std::move(request));
+  }
+
+  ObjectPtr<MockKVStateObj> kv_state_;
+  std::map<int64_t, std::vector<int64_t>> outputs_;
+  std::set<int64_t> finished_;
+};
+
+TEST_F(ServingEngineTest, ContinuousBatching) {
+  ServingEngine engine = CreateEngine(EngineConfig());
+  AddRequest(engine, 0, {1, 2, 3}, 3);
+  AddRequest(engine, 1, {5}, 8, {7});
+  EXPECT_EQ(engine->NumPendingRequests(), 2);
+
+  // The prompts are prefilled together.
+  ASSERT_TRUE(engine->Step());
+  EXPECT_EQ(ToVector(kv_state_->append_lengths), std::vector<int64_t>({3, 1}));
+  // A request added in between joins the decoding ones, which come first.
+  AddRequest(engine, 2, {9, 10}, 1);
+  ASSERT_TRUE(engine->Step());
+  EXPECT_EQ(ToVector(kv_state_->seq_ids), std::vector<int64_t>({0, 1, 2}));
+  EXPECT_EQ(ToVector(kv_state_->append_lengths), std::vector<int64_t>({1, 1, 2}));
+  while (engine->Step()) {
+  }
+
+  EXPECT_EQ(outputs_[0], std::vector<int64_t>({4, 5, 6}));
+  EXPECT_EQ(outputs_[1], std::vector<int64_t>({6, 7}));
+  EXPECT_EQ(outputs_[2], std::vector<int64_t>({11}));
+  EXPECT_EQ(finished_, std::set<int64_t>({0, 1, 2}));
+  EXPECT_TRUE(kv_state_->seqs.empty());
+  EXPECT_EQ(engine->NumPendingRequests(), 0);
+
+  Map<String, ObjectRef> metrics = engine->GetMetrics();
+  EXPECT_EQ(Downcast<Int>(metrics["num_steps"])->value, 3);
+  EXPECT_EQ(Downcast<Int>(metrics["num_prefill_tokens"])->value, 6);
+  EXPECT_EQ(Downcast<Int>(metrics["num_decode_tokens"])->value, 3);
+  EXPECT_EQ(Downcast<Int>(metrics["num_finished_requests"])->value, 3);
+}
+
+TEST_F(ServingEngineTest, ChunkedPrefill) {
+  EngineConfig config;
+  config.max_num_batched_tokens = 2;
+  ServingEngine engine = CreateEngine(config);
+  AddRequest(engine, 0, {1, 2, 3, 4, 5}, 2);
+
+  std::vector<int64_t> lengths;
+  while (engine->Step()) {
+    lengths.push_back(kv_state_->append_lengths[0]);
+    if (lengths.size() < 3) EXPECT_TRUE(outputs_[0].empty());
+  }
+  EXPECT_EQ(lengths, std::vector<int64_t>({2, 2, 1, 1}));
+  EXPECT_EQ(outputs_[0], std::vector<int64_t>({6, 7}));
+}
+
+TEST_F(ServingEngineTest, Abort) {
+  EngineConfig config;
+  config.max_batch_size = 1;
+  ServingEngine engine = CreateEngine(config);
+  AddRequest(engine, 0, {1}, 100);
+  AddRequest(engine, 1, {2}, 100);
+  ASSERT_TRUE(engine->Step());
+  // Request 0 is running, and request 1 is waiting for a free slot of the batch.
+  engine->AbortRequest(0);
+  engine->AbortRequest(1);
+  EXPECT_FALSE(engine->Step());
+  EXPECT_EQ(outputs_[0], std::vector<int64_t>({2}));
+  EXPECT_TRUE(outputs_[1].empty());
+  EXPECT_EQ(finished_, std::set<int64_t>({0, 1}));
+  EXPECT_TRUE(kv_state_->seqs.empty());
+}
+
+TEST_F(ServingEngineTest, BackgroundThread) {
+  ServingEngine engine = CreateEngine(EngineConfig());
+  engine->Start();
+  AddRequest(engine, 0, {1, 2}, 4);
+  while (engine->NumPendingRequests() != 0) {
+    std::this_thread::yield();
+  }
+  engine->Stop();
+  EXPECT_EQ(outputs_[0], std::vector<int64_t>({3, 4, 5, 6}));
+}
+
+}  // namespace serving
+}  // namespace relax_vm
+}  // namespace runtime
+}  // namespace tvm
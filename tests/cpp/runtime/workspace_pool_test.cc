@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/device_api.h>
+
+#include <cstdint>
+
+#include "../../../src/runtime/workspace_pool.h"
+
+namespace tvm {
+namespace runtime {
+
+TEST(WorkspacePool, ArenaIsStack) {
+  Device dev{kDLCPU, 0};
+  WorkspacePool pool(kDLCPU, DeviceAPI::Get(dev), /*use_arena=*/true);
+  void* a = pool.AllocWorkspace(dev, 100);
+  void* b = pool.AllocWorkspace(dev, 200);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % kTempAllocaAlignment, 0);
+  EXPECT_EQ(static_cast<char*>(b) - static_cast<char*>(a), 128);
+  pool.FreeWorkspace(dev, b);
+  // The freed top of the stack is reused.
+  EXPECT_EQ(pool.AllocWorkspace(dev, 64), b);
+  EXPECT_EQ(pool.stats().arena_allocs, 3u);
+  EXPECT_EQ(pool.stats().arena_chunks, 1u);
+  EXPECT_EQ(pool.stats().pool_allocs, 0u);
+}
+
+TEST(WorkspacePool, ArenaDefersOutOfOrderFree) {
+  Device dev{kDLCPU, 0};
+  WorkspacePool pool(kDLCPU, DeviceAPI::Get(dev), /*use_arena=*/true);
+  void* a = pool.AllocWorkspace(dev, 64);
+  void* b = pool.AllocWorkspace(dev, 64);
+  pool.FreeWorkspace(dev, a);
+  EXPECT_EQ(pool.stats().deferred_frees, 1u);
+  // a is only reclaimed with b.
+  void* c = pool.AllocWorkspace(dev, 64);
+  EXPECT_NE(c, a);
+  pool.FreeWorkspace(dev, c);
+  pool.FreeWorkspace(dev, b);
+  EXPECT_EQ(pool.AllocWorkspace(dev, 64), a);
+}
+
+TEST(WorkspacePool, ArenaGrowsAndFallsBack) {
+  Device dev{kDLCPU, 0};
+  WorkspacePool pool(kDLCPU, DeviceAPI::Get(dev), /*use_arena=*/true);
+  void* a = pool.AllocWorkspace(dev, 48 << 10);
+  void* b = pool.AllocWorkspace(dev, 48 << 10);
+  EXPECT_EQ(pool.stats().arena_chunks, 2u);
+  void* large = pool.AllocWorkspace(dev, 4 << 20);
+  EXPECT_EQ(pool.stats().pool_allocs, 1u);
+  pool.FreeWorkspace(dev, large);
+  pool.FreeWorkspace(dev, b);
+  pool.FreeWorkspace(dev, a);
+  // The chunks are kept for the next allocations.
+  pool.AllocWorkspace(dev, 48 << 10);
+  pool.AllocWorkspace(dev, 48 << 10);
+  EXPECT_EQ(pool.stats().arena_chunks, 2u);
+}
+
+}  // namespace runtime
+}  // namespace tvm
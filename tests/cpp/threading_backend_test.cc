@@ -20,6 +20,8 @@
 #include <dmlc/logging.h>
 #include <gtest/gtest.h>
 #include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/container/shape_tuple.h>
+#include <tvm/runtime/registry.h>
 #include <tvm/runtime/threading_backend.h>
 
 #include <atomic>
@@ -124,6 +126,65 @@ TEST(ThreadingBackend, TVMBackendParallelLaunch) {
   EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
 }
 
+TEST(ThreadingBackend, TVMBackendThreadPoolWaitCounters) {
+  int max_concurrency = tvm::runtime::threading::MaxConcurrency();
+  if (max_concurrency <= 1) {
+    return;
+  }
+  for (int i = 0; i < 4; ++i) {
+    std::atomic<size_t> acc(0);
+    TVMBackendParallelLaunch(atomic_add_task_id, &acc, 0);
+  }
+  const tvm::runtime::PackedFunc* f =
+      tvm::runtime::Registry::Get("runtime.thread_pool_wait_counters");
+  ASSERT_NE(f, nullptr);
+  tvm::runtime::Map<tvm::runtime::String, tvm::runtime::ObjectRef> counters = (*f)();
+  auto spin_hits = tvm::runtime::Downcast<tvm::runtime::ShapeTuple>(counters["spin_hits"]);
+  auto sleeps = tvm::runtime::Downcast<tvm::runtime::ShapeTuple>(counters["sleeps"]);
+  EXPECT_EQ(spin_hits.size(), max_concurrency);
+  // Every worker that ran a task either caught it while spinning or slept for it.
+  int64_t num_pops = 0;
+  for (size_t i = 1; i < spin_hits.size(); ++i) {
+    num_pops += spin_hits[i] + sleeps[i];
+  }
+  EXPECT_GT(num_pops, 0);
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchWorkStealing) {
+  tvm::runtime::threading::SetTaskSchedule(tvm::runtime::threading::TaskSchedule::kWorkStealing);
+  for (int num_task : {0, 1, 7, 64}) {
+    std::atomic<size_t> acc(0);
+    EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &acc, num_task), 0);
+    EXPECT_EQ(acc.load(std::memory_order_relaxed), N * (N - 1) / 2);
+  }
+  tvm::runtime::threading::SetTaskSchedule(tvm::runtime::threading::TaskSchedule::kStatic);
+}
+
+TEST(ThreadingBackend, TVMBackendParallelLaunchShared) {
+  tvm::runtime::threading::SetTaskSchedule(tvm::runtime::threading::TaskSchedule::kShared);
+  std::vector<std::unique_ptr<std::thread>> ts;
+  for (int i = 0; i < 4; ++i) {
+    ts.emplace_back(new std::thread([]() {
+      for (int j = 0; j < 8; ++j) {
+        // Each task of the outer launch issues a nested launch.
+        std::atomic<size_t> acc(0);
+        tvm::runtime::parallel_for_with_threading_backend(
+            [&acc](int k) {
+              std::atomic<size_t> inner(0);
+              EXPECT_EQ(TVMBackendParallelLaunch(atomic_add_task_id, &inner, 0), 0);
+              acc.fetch_add(inner.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            },
+            0, 4);
+        EXPECT_EQ(acc.load(std::memory_order_relaxed), 4 * N * (N - 1) / 2);
+      }
+    }));
+  }
+  for (auto& t : ts) {
+    t->join();
+  }
+  tvm::runtime::threading::SetTaskSchedule(tvm::runtime::threading::TaskSchedule::kStatic);
+}
+
 TEST(ThreadingBackend, TVMBackendParallelLaunchMultipleThreads) {
   // TODO(tulloch) use parameterised tests when available.
   size_t num_jobs_per_thread = 3;
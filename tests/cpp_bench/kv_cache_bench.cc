@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <vector>
+
+namespace {
+
+using namespace tvm::runtime;
+
+const PackedFunc& GetGlobal(const char* name) {
+  const PackedFunc* f = Registry::Get(name);
+  ICHECK(f != nullptr) << "Cannot find " << name;
+  return *f;
+}
+
+/*!
+ * \brief Create a paged KV cache on CPU whose kernels do nothing, so that only the bookkeeping of
+ * the cache on the host is measured.
+ */
+ObjectRef CreateKVCache(int64_t num_seqs, int64_t history_length, int64_t page_size) {
+  PackedFunc noop([](TVMArgs args, TVMRetValue* rv) {});
+  // A small model keeps the pages affordable, the bookkeeping does not depend on it.
+  int64_t num_layers = 2;
+  int64_t capacity = num_seqs * (history_length + page_size) * 2;
+  NDArray init = NDArray::Empty({}, DLDataType{kDLFloat, 16, 1}, DLDevice{kDLCPU, 0});
+  return GetGlobal("vm.builtin.paged_attention_kv_cache_create_reduced")(
+      ShapeTuple({num_seqs, capacity, /*prefill_chunk_size=*/num_seqs * history_length,
+                  page_size, /*support_sliding_window=*/0}),
+      ShapeTuple({0, num_layers}), /*num_qo_heads=*/4, /*num_kv_heads=*/1, /*head_dim=*/64,
+      /*rope_mode=*/0, /*rotary_scale=*/1.0, /*rotary_theta=*/10000.0, init,
+      /*f_transpose_append=*/noop, /*f_attention_prefill=*/noop, /*f_attention_decode=*/noop,
+      /*f_attention_prefill_sliding_window=*/noop, /*f_attention_decode_sliding_window=*/noop,
+      /*f_attention_prefill_ragged=*/noop, /*f_merge_inplace=*/noop, /*f_split_rotary=*/noop,
+      /*f_copy_single_page=*/noop, /*f_debug_get_kv=*/noop, /*f_compact_copy=*/noop,
+      /*f_attention_prefill_with_tree_mask=*/noop,
+      /*f_attention_prefill_with_tree_mask_paged_kv=*/noop, /*rope_ext_factors=*/nullptr,
+      /*enable_kv_transfer=*/false);
+}
+
+/*! \brief BeginForward and EndForward of a decode step over a batch of sequences. */
+void BM_PagedKVCacheDecodeForward(benchmark::State& state) {
+  int64_t num_seqs = state.range(0);
+  int64_t history_length = 500;
+  ObjectRef kv_cache = CreateKVCache(num_seqs, history_length, /*page_size=*/16);
+  const PackedFunc& add_sequence = GetGlobal("vm.builtin.kv_state_add_sequence");
+  const PackedFunc& begin_forward = GetGlobal("vm.builtin.kv_state_begin_forward");
+  const PackedFunc& end_forward = GetGlobal("vm.builtin.kv_state_end_forward");
+  const PackedFunc& popn = GetGlobal("vm.builtin.kv_state_popn");
+
+  std::vector<int64_t> seq_ids(num_seqs);
+  for (int64_t i = 0; i < num_seqs; ++i) {
+    seq_ids[i] = i;
+    add_sequence(kv_cache, i);
+  }
+  // Give each sequence a history spanning several pages.
+  begin_forward(kv_cache, ShapeTuple(seq_ids),
+                ShapeTuple(std::vector<int64_t>(num_seqs, history_length)));
+  end_forward(kv_cache);
+
+  ShapeTuple seq_id_tuple(seq_ids);
+  ShapeTuple append_lengths(std::vector<int64_t>(num_seqs, 1));
+  for (auto _ : state) {
+    begin_forward(kv_cache, seq_id_tuple, append_lengths);
+    end_forward(kv_cache);
+    state.PauseTiming();
+    for (int64_t seq_id : seq_ids) {
+      popn(kv_cache, seq_id, 1);
+    }
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_PagedKVCacheDecodeForward)->Arg(1)->Arg(32)->Arg(256);
+
+}  // namespace
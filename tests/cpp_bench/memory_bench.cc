@@ -0,0 +1,89 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/memory/memory_manager.h>
+#include <tvm/runtime/ndarray.h>
+
+#include <vector>
+
+namespace {
+
+using namespace tvm::runtime;
+using namespace tvm::runtime::memory;
+
+constexpr DLDevice kCPU{kDLCPU, 0};
+constexpr DLDataType kFloat32{kDLFloat, 32, 1};
+
+void BM_PooledAllocatorAllocFree(benchmark::State& state) {
+  Allocator* allocator = MemoryManager::GetOrCreateAllocator(kCPU, kPooled);
+  size_t nbytes = state.range(0);
+  for (auto _ : state) {
+    Buffer buffer = allocator->Alloc(kCPU, nbytes, kAllocAlignment, kFloat32);
+    benchmark::DoNotOptimize(buffer.data);
+    allocator->Free(buffer);
+  }
+}
+BENCHMARK(BM_PooledAllocatorAllocFree)->Arg(256)->Arg(64 << 10)->Arg(16 << 20);
+
+/*! \brief Allocate a batch of buffers of distinct sizes before freeing them, as a VM frame does. */
+void BM_PooledAllocatorBatch(benchmark::State& state) {
+  Allocator* allocator = MemoryManager::GetOrCreateAllocator(kCPU, kPooled);
+  std::vector<Buffer> buffers(state.range(0));
+  for (auto _ : state) {
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      buffers[i] = allocator->Alloc(kCPU, (i + 1) * 1024, kAllocAlignment, kFloat32);
+    }
+    for (const Buffer& buffer : buffers) {
+      allocator->Free(buffer);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * buffers.size());
+}
+BENCHMARK(BM_PooledAllocatorBatch)->Arg(64);
+
+void BM_NDArrayEmpty(benchmark::State& state) {
+  ShapeTuple shape{state.range(0)};
+  for (auto _ : state) {
+    NDArray array = NDArray::Empty(shape, kFloat32, kCPU);
+    benchmark::DoNotOptimize(array->data);
+  }
+}
+BENCHMARK(BM_NDArrayEmpty)->Arg(16)->Arg(1 << 20);
+
+void BM_NDArrayEmptyPooled(benchmark::State& state) {
+  Allocator* allocator = MemoryManager::GetOrCreateAllocator(kCPU, kPooled);
+  ShapeTuple shape{state.range(0)};
+  for (auto _ : state) {
+    NDArray array = allocator->Empty(shape, kFloat32, kCPU);
+    benchmark::DoNotOptimize(array->data);
+  }
+}
+BENCHMARK(BM_NDArrayEmptyPooled)->Arg(16)->Arg(1 << 20);
+
+void BM_NDArrayCreateView(benchmark::State& state) {
+  NDArray array = NDArray::Empty({1 << 20}, kFloat32, kCPU);
+  for (auto _ : state) {
+    NDArray view = array.CreateView({1024, 1024}, kFloat32);
+    benchmark::DoNotOptimize(view->data);
+  }
+}
+BENCHMARK(BM_NDArrayCreateView);
+
+}  // namespace
@@ -0,0 +1,79 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/packed_func.h>
+#include <tvm/runtime/registry.h>
+
+namespace {
+
+using namespace tvm::runtime;
+
+void BM_PackedFuncCallInt(benchmark::State& state) {
+  PackedFunc f([](TVMArgs args, TVMRetValue* rv) { *rv = args[0].operator int64_t() + 1; });
+  int64_t x = 0;
+  for (auto _ : state) {
+    x = f(x);
+  }
+  benchmark::DoNotOptimize(x);
+}
+BENCHMARK(BM_PackedFuncCallInt);
+
+void BM_TypedPackedFuncCallInt(benchmark::State& state) {
+  TypedPackedFunc<int64_t(int64_t)> f([](int64_t x) { return x + 1; });
+  int64_t x = 0;
+  for (auto _ : state) {
+    x = f(x);
+  }
+  benchmark::DoNotOptimize(x);
+}
+BENCHMARK(BM_TypedPackedFuncCallInt);
+
+void BM_PackedFuncCallNDArray(benchmark::State& state) {
+  PackedFunc f([](TVMArgs args, TVMRetValue* rv) { *rv = args[0].operator NDArray(); });
+  NDArray x = NDArray::Empty({16}, DLDataType{kDLFloat, 32, 1}, DLDevice{kDLCPU, 0});
+  for (auto _ : state) {
+    NDArray y = f(x);
+    benchmark::DoNotOptimize(y);
+  }
+}
+BENCHMARK(BM_PackedFuncCallNDArray);
+
+/*! \brief The call of a global function through the C API, as done by the language bindings. */
+void BM_PackedFuncCallCAPI(benchmark::State& state) {
+  Registry::Register("runtime_bench.add_one", /*override=*/true)
+      .set_body_typed([](int64_t x) { return x + 1; });
+  TVMFunctionHandle handle;
+  TVMFuncGetGlobal("runtime_bench.add_one", &handle);
+  TVMValue value;
+  value.v_int64 = 0;
+  int type_code = kDLInt;
+  for (auto _ : state) {
+    TVMValue ret_value;
+    int ret_type_code;
+    TVMFuncCall(handle, &value, &type_code, 1, &ret_value, &ret_type_code);
+    value = ret_value;
+  }
+  benchmark::DoNotOptimize(value.v_int64);
+}
+BENCHMARK(BM_PackedFuncCallCAPI);
+
+}  // namespace
@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <tvm/relax/exec_builder.h>
+#include <tvm/runtime/memory/memory_manager.h>
+#include <tvm/runtime/module.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/runtime/relax_vm/executable.h>
+
+namespace {
+
+using namespace tvm::runtime;
+namespace vm = tvm::runtime::relax_vm;
+
+TVM_REGISTER_GLOBAL("runtime_bench.identity").set_body([](TVMArgs args, TVMRetValue* rv) {
+  *rv = args[0];
+});
+
+/*!
+ * \brief Build a VM whose function "main" chains `num_calls` calls of a no-op packed function.
+ */
+Module BuildChainVM(int num_calls) {
+  tvm::relax::ExecBuilder builder = tvm::relax::ExecBuilderNode::Create();
+  builder->EmitFunction("main", /*num_inputs=*/1, tvm::Array<tvm::String>{"x"});
+  for (int i = 0; i < num_calls; ++i) {
+    builder->EmitCall("runtime_bench.identity", {vm::Instruction::Arg::Register(i)}, i + 1);
+  }
+  builder->EmitRet(vm::Instruction::Arg::Register(num_calls));
+  builder->EndFunction("main");
+
+  Module exec(builder->Get());
+  Module vm_mod = exec.GetFunction("vm_load_executable")();
+  vm_mod.GetFunction("vm_initialization")(static_cast<int>(kDLCPU), 0,
+                                          static_cast<int>(memory::kPooled));
+  return vm_mod;
+}
+
+/*! \brief The dispatch cost of the VM per call instruction. */
+void BM_RelaxVMDispatch(benchmark::State& state) {
+  int num_calls = static_cast<int>(state.range(0));
+  Module vm_mod = BuildChainVM(num_calls);
+  PackedFunc main = vm_mod.GetFunction("main");
+  int64_t x = 0;
+  for (auto _ : state) {
+    x = main(x);
+  }
+  benchmark::DoNotOptimize(x);
+  state.SetItemsProcessed(state.iterations() * num_calls);
+}
+BENCHMARK(BM_RelaxVMDispatch)->Arg(1)->Arg(64);
+
+}  // namespace
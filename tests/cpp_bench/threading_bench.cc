@@ -0,0 +1,52 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/threading_backend.h>
+
+#include <atomic>
+
+namespace {
+
+int NoopTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) { return 0; }
+
+int BarrierTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+  TVMBackendParallelBarrier(task_id, penv);
+  return 0;
+}
+
+/*! \brief The latency of launching empty tasks, with 0 tasks using all the worker threads. */
+void BM_ParallelLaunch(benchmark::State& state) {
+  int num_task = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    TVMBackendParallelLaunch(NoopTask, nullptr, num_task);
+  }
+}
+BENCHMARK(BM_ParallelLaunch)->Arg(0)->Arg(1)->Arg(2)->Arg(4);
+
+void BM_ParallelLaunchBarrier(benchmark::State& state) {
+  int num_task = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    TVMBackendParallelLaunch(BarrierTask, nullptr, num_task);
+  }
+}
+BENCHMARK(BM_ParallelLaunchBarrier)->Arg(0)->Arg(2)->Arg(4);
+
+}  // namespace
@@ -18,6 +18,7 @@
 import gc
 
 import numpy as np
+import pytest
 
 import tvm
 from tvm import te
@@ -177,7 +178,42 @@ def test_dict_function_value_type():
     tvm.ir.assert_structural_equal(f(a, b), tir.Add(a, b))
 
 
+def test_get_global_cache():
+    @tvm.register_func("testing.cached_func", override=True)
+    def _first():
+        return 1
+
+    assert tvm.get_global_func("testing.cached_func")() == 1
+    assert tvm.get_global_func("testing.cached_func") is tvm.get_global_func("testing.cached_func")
+
+    @tvm.register_func("testing.cached_func", override=True)
+    def _second():
+        return 2
+
+    assert tvm.get_global_func("testing.cached_func")() == 2
+    tvm._ffi.registry.remove_global_func("testing.cached_func")
+    assert tvm.get_global_func("testing.cached_func", allow_missing=True) is None
+
+
+def test_call_batch():
+    def add(a, b):
+        return a + b
+
+    def fail():
+        raise ValueError("failed in batch")
+
+    fadd = tvm.runtime.convert(add)
+    results = tvm.runtime.call_batch([(fadd, (1, 2)), (fadd, [3.0, 4.0]), (fadd, ("a", "b"))])
+    assert results == [3, 7.0, "ab"]
+    assert tvm.runtime.call_batch([]) == []
+
+    with pytest.raises(ValueError, match="failed in batch"):
+        tvm.runtime.call_batch([(fadd, (1, 2)), (tvm.runtime.convert(fail), ())])
+
+
 if __name__ == "__main__":
+    test_get_global_cache()
+    test_call_batch()
     test_ndarray_args()
     test_numpy_scalar()
     test_rvalue_ref()
@@ -1370,5 +1370,39 @@ def test_detect_iter_map_with_bufferload_recursion():
     assert len(result.indices) == 0
 
 
+def test_detect_iter_map_non_affine():
+    x = tvm.tir.Var("x", "int32")
+    y = tvm.tir.Var("y", "int32")
+    n = tvm.tir.Var("n", "int32")
+    dom_map = var_dom([(x, 8), (y, 8)])
+
+    for index in [
+        x * y,
+        floordiv(x, y),
+        floormod(x * 8 + y, x + 1),
+        tvm.tir.max(x, 1) + y,
+        tvm.tir.Cast("int64", x),
+    ]:
+        res = tvm.arith.detect_iter_map([y + n, index], dom_map)
+        assert len(res.indices) == 0
+        assert "is not affine in the iterators" in res.errors[0], res.errors
+
+    # The expressions without iterators may be any expression.
+    assert_iter_sum_pattern({x * 8 + y + tvm.tir.max(n, 1): (64, tvm.tir.max(n, 1))}, dom_map)
+
+
+def test_shared_fused_iter():
+    x = tvm.tir.Var("x", "int32")
+    y = tvm.tir.Var("y", "int32")
+    fused = x * 4 + y
+
+    # The splits of the same fused expression reuse its rewriting.
+    assert_iter_sum_pattern(
+        {floordiv(fused, 2): (6, 0), floormod(fused, 2): (2, 0)},
+        var_dom([(x, 3), (y, 4)]),
+        check_level="bijective",
+    )
+
+
 if __name__ == "__main__":
     tvm.testing.main()
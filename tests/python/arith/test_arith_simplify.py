@@ -144,5 +144,42 @@ def test_simplify_floor_mod_with_linear_offset():
     assert ana.can_prove_equal(tvm.tir.floormod(expr1, divisor2), 0)
 
 
+def test_simplify_cache():
+    ana = tvm.arith.Analyzer()
+    i, j = tir.Var("i", "int32"), tir.Var("j", "int32")
+    ana.bind(j, tvm.ir.Range(0, 16))
+
+    def index():
+        return tvm.tir.floordiv(i * 16 + j, 4)
+
+    expected = ana.simplify(index())
+    # a structurally equal expression hits the cache
+    hits = ana.cache_stats["hits"]
+    tvm.ir.assert_structural_equal(ana.simplify(index()), expected)
+    assert ana.cache_stats["hits"] == hits + 1
+
+    # the result under a constraint is not reused outside of it
+    with ana.constraint_scope(j < 4):
+        tvm.ir.assert_structural_equal(ana.simplify(index()), i * 4)
+    hits = ana.cache_stats["hits"]
+    tvm.ir.assert_structural_equal(ana.simplify(index()), expected)
+    with ana.constraint_scope(j < 4):
+        tvm.ir.assert_structural_equal(ana.simplify(index()), i * 4)
+    assert ana.cache_stats["hits"] == hits + 2
+
+    # binding a variable changes the known facts
+    assert not ana.can_prove(i < 4)
+    ana.bind(i, tvm.ir.Range(0, 4))
+    assert ana.can_prove(i < 4)
+
+    # loads of different buffers are not the same value
+    a = tir.decl_buffer((16,), "int32", name="A")
+    b = tir.decl_buffer((16,), "int32", name="B")
+    load_a = ana.simplify(tir.BufferLoad(a, [j]) + 0)
+    load_b = ana.simplify(tir.BufferLoad(b, [j]) + 0)
+    assert load_a.buffer.same_as(a)
+    assert load_b.buffer.same_as(b)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -79,6 +79,20 @@ def test_xgb_model():
     model.load(tmpfile)
 
 
+def test_xgb_model_incremental_training():
+    task, inputs, results = get_sample_records(50)
+
+    model = auto_scheduler.XGBModel(num_warmup_sample=-1, incremental_training=True)
+    model.update(inputs[:25], results[:25])
+    num_rounds = model.bst.num_boosted_rounds()
+    model.update(inputs[25:], results[25:])
+    # The second update continues boosting from the first model.
+    assert model.bst.num_boosted_rounds() > num_rounds
+    preds = model.predict(task, [x.state for x in inputs])
+    assert len(preds) == len(inputs)
+
+
 if __name__ == "__main__":
     test_random_model()
     test_xgb_model()
+    test_xgb_model_incremental_training()
@@ -202,6 +202,27 @@ def test_gpu_feature():
 
 
 @T.prim_func
+def test_feature_cache():
+    target = tvm.target.Target("llvm")
+    features = []
+    for n in [128, 256]:
+        dag = auto_scheduler.ComputeDAG(matmul_auto_scheduler_test(n, n, n))
+        s = dag.get_init_state()
+        C = s.stage_ops[2]
+        s.parallel(C, s[C].iters[0])
+        # The workload key is shared, so the cache must tell the two DAGs apart.
+        task = auto_scheduler.SearchTask(compute_dag=dag, workload_key="test", target=target)
+        first = auto_scheduler.feature.get_per_store_features_from_states([s], task)[0]
+        cached = auto_scheduler.feature.get_per_store_features_from_states([s], task)[0]
+        assert (first == cached).all()
+        features.append(first)
+    assert not (features[0] == features[1]).all()
+
+    auto_scheduler.feature.clear_per_store_feature_cache()
+    fea = auto_scheduler.feature.get_per_store_features_from_states([s], task)[0]
+    assert (fea == features[1]).all()
+
+
 def tir_matmul(
     A: T.Buffer((256, 256), "float32"),
     B: T.Buffer((256, 256), "float32"),
@@ -303,3 +324,4 @@ if __name__ == "__main__":
     test_cpu_matmul()
     test_cpu_fusion()
     test_gpu_feature()
+    test_feature_cache()
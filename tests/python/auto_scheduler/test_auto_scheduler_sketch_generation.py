@@ -137,6 +137,21 @@ def test_cpu_matmul_sketch():
     assert_is_tiled(sketches[8].stages[5])
 
 
+def test_cpu_matmul_sketch_replay():
+    sketches = generate_sketches(matmul_auto_scheduler_test, (512, 512, 512), "llvm")
+    # The same structure with other shapes replays the cached sketches on its own loops.
+    replayed = generate_sketches(matmul_auto_scheduler_test, (256, 1024, 512), "llvm")
+    assert len(replayed) == len(sketches)
+    for sketch, replay in zip(sketches, replayed):
+        assert len(replay.stages) == len(sketch.stages)
+        assert [type(step) for step in replay.transform_steps] == [
+            type(step) for step in sketch.transform_steps
+        ]
+        assert str(replay) != str(sketch)
+    assert_is_tiled(replayed[0].stages[2])
+    assert_has_cache_write(replayed[1], 2)
+
+
 def test_cpu_conv2d_bn_relu_sketch():
     sketches = generate_sketches(
         conv2d_nchw_bn_relu_auto_scheduler_test, (1, 56, 56, 512, 512, 3, 1, 1), "llvm"
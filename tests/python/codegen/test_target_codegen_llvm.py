@@ -1049,6 +1049,101 @@ def test_subroutine_call():
     assert arr.numpy()[0] == 42.0
 
 
+@tvm.testing.requires_llvm
+def test_parallel_modules():
+    @I.ir_module
+    class mod:
+        @T.prim_func
+        def add_one(A: T.Buffer(16, "float32"), B: T.Buffer(16, "float32")):
+            T.func_attr({"global_symbol": "add_one"})
+            for i in range(16):
+                B[i] = A[i] + T.float32(1)
+
+        @T.prim_func
+        def mul_two(A: T.Buffer(16, "float32"), B: T.Buffer(16, "float32")):
+            T.func_attr({"global_symbol": "mul_two"})
+            for i in range(16):
+                B[i] = A[i] * T.float32(2)
+
+        @T.prim_func
+        def main(A: T.Buffer(1, dtype="float32")):
+            T.func_attr({"global_symbol": "main"})
+            mod.subroutine(A.data)
+
+        @T.prim_func
+        def subroutine(A_data: T.handle("float32")):
+            T.func_attr({"global_symbol": "subroutine", "calling_conv": -1})
+            A = T.decl_buffer(1, dtype="float32", data=A_data)
+            A[0] = 42.0
+
+    def build():
+        with tvm.transform.PassContext(config={"llvm.num_parallel_modules": 3}):
+            return tvm.build(mod, target="llvm")
+
+    built = build()
+    # The partitioning and linking order do not depend on the thread scheduling.
+    assert built.get_source() == build().get_source()
+
+    temp = utils.tempdir()
+    path = temp.relpath("lib.so")
+    built.export_library(path)
+    for lib in [built, tvm.runtime.load_module(path)]:
+        a = tvm.nd.array(np.arange(16, dtype="float32"))
+        b = tvm.nd.empty([16], "float32")
+        lib["add_one"](a, b)
+        tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1)
+        lib["mul_two"](a, b)
+        tvm.testing.assert_allclose(b.numpy(), a.numpy() * 2)
+        arr = tvm.nd.array(np.zeros([1], "float32"))
+        lib["main"](arr)
+        assert arr.numpy()[0] == 42.0
+
+
+@tvm.testing.requires_llvm
+def test_compile_cache():
+    def make_mod(scale):
+        @I.ir_module
+        class mod:
+            @T.prim_func
+            def add_one(A: T.Buffer(16, "float32"), B: T.Buffer(16, "float32")):
+                T.func_attr({"global_symbol": "add_one"})
+                for i in range(16):
+                    B[i] = A[i] + T.float32(1)
+
+            @T.prim_func
+            def scale(A: T.Buffer(16, "float32"), B: T.Buffer(16, "float32")):
+                T.func_attr({"global_symbol": "scale"})
+                for i in range(16):
+                    B[i] = A[i] * T.float32(scale)
+
+        return mod
+
+    temp = utils.tempdir()
+
+    def build(mod):
+        with tvm.transform.PassContext(config={"target.compile_cache_dir": temp.temp_dir}):
+            return tvm.build(mod, target="llvm")
+
+    def num_entries():
+        return len([f for f in temp.listdir() if f.endswith(".tvmcache")])
+
+    first = build(make_mod(2.0))
+    assert num_entries() == 2
+    # A rebuild is served from the cache.
+    assert build(make_mod(2.0)).get_source() == first.get_source()
+    assert num_entries() == 2
+    # Only the changed function is compiled again.
+    built = build(make_mod(3.0))
+    assert num_entries() == 3
+
+    a = tvm.nd.array(np.arange(16, dtype="float32"))
+    b = tvm.nd.empty([16], "float32")
+    built["add_one"](a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1)
+    built["scale"](a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() * 3)
+
+
 @tvm.testing.requires_llvm
 def test_call_packed_returning_void():
     """Allow codegen of PackedFunc calls returning void
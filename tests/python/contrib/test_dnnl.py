@@ -761,6 +761,27 @@ def test_conv2d_weights_const(run_module, dtype="float32"):
     run_and_verify_func(config, run_module=run_module, dtype=dtype)
 
 
+def test_conv2d_weights_const_shared(run_module, dtype="float32"):
+    # The modules built for several batch sizes share the reordered weights.
+    set_capacity = tvm.get_global_func("runtime.dnnl.set_weight_cache_capacity", True)
+    if set_capacity is None:
+        print("skip because DNNL runtime is not available")
+        return
+    k_shape = (16, 32, 3, 3)
+    weights = np.random.uniform(-1, 1, k_shape).astype(dtype)
+    for batch in [1, 4, 1]:
+        x = relay.var("x", shape=(batch, 32, 8, 8), dtype=dtype)
+        conv2d = relay.nn.conv2d(x, relay.const(weights), kernel_size=(3, 3), channels=16)
+        config = tvm.IRModule.from_expr(conv2d), {"x": (batch, 32, 8, 8)}, []
+        run_and_verify_func(config, run_module=run_module, dtype=dtype, test_bf16=False)
+
+    # Above the capacity, the reordered weights are not kept, and a zero capacity empties it.
+    set_capacity(0)
+    run_and_verify_func(config, run_module=run_module, dtype=dtype, test_bf16=False)
+    set_capacity(256 << 20)
+    tvm.get_global_func("runtime.dnnl.set_primitive_cache_capacity")(1024)
+
+
 def test_conv2d_pattern(run_module, dtype="float32"):
     x_shape = (1, 32, 8, 8)
     k_shape = (16, 32, 3, 3)
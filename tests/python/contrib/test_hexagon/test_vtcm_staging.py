@@ -0,0 +1,88 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the automatic VTCM staging of TIR blocks"""
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import tir
+from tvm.contrib.hexagon import stage_to_vtcm
+from tvm.script import tir as T
+from tvm.topi.hexagon.utils import get_vtcm_allocation_sizes
+
+
+@T.prim_func
+def add(
+    A: T.Buffer((64, 8, 128), "int8"),
+    B: T.Buffer((64, 8, 128), "int8"),
+    C: T.Buffer((64, 8, 128), "int8"),
+):
+    for i, j, k in T.grid(64, 8, 128):
+        with T.block("compute"):
+            vi, vj, vk = T.axis.remap("SSS", [i, j, k])
+            C[vi, vj, vk] = A[vi, vj, vk] + B[vi, vj, vk]
+
+
+def _stage(capacity, **kwargs):
+    sch = tir.Schedule(add)
+    loop = stage_to_vtcm(sch, sch.get_block("compute"), vtcm_capacity=capacity, **kwargs)
+    return sch, loop
+
+
+def test_stage_outermost_loop_within_capacity():
+    # Double-buffered tiles of A and B of one iteration of i need 2 * 2 * 1024 bytes.
+    sch, loop = _stage(4096)
+    assert loop is not None
+    i, _, _ = sch.get_loops(sch.get_block("compute"))
+    assert sch.get(loop).same_as(sch.get(i))
+    annotations = sch.get(loop).annotations
+    assert list(annotations["software_pipeline_stage"]) == [0, 0, 1]
+    assert list(annotations["software_pipeline_async_stages"]) == [0]
+    for name in ["A_global.vtcm", "B_global.vtcm"]:
+        assert sch.get(sch.get_block(name)).writes[0].buffer.scope() == "global.vtcm"
+    assert max(get_vtcm_allocation_sizes(sch.mod).values()) <= 4096
+
+
+def test_stage_inner_loop_for_small_capacity():
+    sch, loop = _stage(1024)
+    assert loop is not None
+    _, j, _ = sch.get_loops(sch.get_block("compute"))
+    assert sch.get(loop).same_as(sch.get(j))
+    assert max(get_vtcm_allocation_sizes(sch.mod).values()) <= 1024
+
+
+def test_stage_output():
+    sch, loop = _stage(8192, stage_output=True)
+    annotations = sch.get(loop).annotations
+    assert list(annotations["software_pipeline_stage"]) == [0, 0, 1, 2]
+    assert list(annotations["software_pipeline_async_stages"]) == [0, 2]
+
+
+def test_no_loop_fits():
+    sch, loop = _stage(2)
+    assert loop is None
+    tvm.ir.assert_structural_equal(sch.mod["main"], add)
+
+
+def test_unknown_capacity():
+    sch = tir.Schedule(add)
+    with pytest.raises(ValueError, match="VTCM capacity"):
+        stage_to_vtcm(sch, sch.get_block("compute"))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
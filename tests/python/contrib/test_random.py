@@ -187,9 +187,45 @@ def test_random_fill_mt():
     assert no_exception_happened
 
 
+def test_random_fill_reproducible():
+    """The fills of a seed do not depend on the number of threads."""
+    if not tvm.get_global_func("tvm.contrib.random.seed", True):
+        print("skip because extern function is not available")
+        return
+    results = {}
+
+    def test_body(num_threads):
+        configure_threads = tvm.get_global_func("runtime.config_threadpool")
+        configure_threads(1, num_threads)
+        random_fill = tvm.get_global_func("tvm.contrib.random.random_fill_for_measure")
+        values = []
+        random.seed(42)
+        for dtype in ["int8", "float16", "float32", "float32"]:
+            value = tvm.nd.empty((37, 41), dtype)
+            random_fill(value)
+            values.append(value.numpy())
+        for sample, args in [("uniform", (0.0, 1.0)), ("normal", (3.0, 4.0))]:
+            value = tvm.nd.empty((37, 41), "float32")
+            tvm.get_global_func("tvm.contrib.random." + sample)(*args, value)
+            values.append(value.numpy())
+        results[num_threads] = values
+
+    # ThreadPool object is thread local. To eliminate effect on other test cases put it into thread
+    for num_threads in [1, 4]:
+        x = threading.Thread(target=test_body, args=(num_threads,))
+        x.start()
+        x.join()
+    for single, multi in zip(results[1], results[4]):
+        tvm.testing.assert_allclose(single, multi)
+    # Successive fills differ.
+    assert not np.array_equal(results[1][2], results[1][3])
+    assert np.count_nonzero(results[1][0]) == 37 * 41
+
+
 if __name__ == "__main__":
     test_randint()
     test_uniform()
     test_normal()
     test_random_fill()
     test_random_fill_mt()
+    test_random_fill_reproducible()
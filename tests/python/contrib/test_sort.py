@@ -95,6 +95,45 @@ def test_sort_np():
     tvm.testing.assert_allclose(c.numpy(), np_out, rtol=1e-5)
 
 
+def test_topk_np():
+    """Tests topk function using numpy, on rows long enough to run in parallel"""
+    ftopk = tvm.get_global_func("tvm.contrib.sort.topk")
+    k = 5
+    for shape, axis, is_ascend in [((8, 20000), 1, False), ((3, 1000, 4), 1, True)]:
+        # Integer values with many ties, the selection must be stable.
+        np_data = np.random.randint(0, 100, size=shape).astype("float32")
+        np_indices = np.argsort(-np_data if not is_ascend else np_data, axis=axis, kind="stable")
+        np_indices = np.take(np_indices, np.arange(k), axis=axis)
+        np_values = np.take_along_axis(np_data, np_indices, axis=axis)
+
+        out_shape = list(shape)
+        out_shape[axis] = k
+        values = tvm.nd.empty(out_shape, "float32")
+        indices = tvm.nd.empty(out_shape, "int32")
+        ftopk(tvm.nd.array(np_data), values, indices, k, axis, "both", is_ascend)
+        tvm.testing.assert_allclose(values.numpy(), np_values)
+        tvm.testing.assert_allclose(indices.numpy(), np_indices)
+
+
+def test_argsort_radix_np():
+    """Tests argsort and sort on rows long enough for the radix sort backend"""
+    fargsort = tvm.get_global_func("tvm.contrib.sort.argsort")
+    fsort = tvm.get_global_func("tvm.contrib.sort.sort")
+    for dtype in ["float32", "int32", "float64"]:
+        for shape, axis, is_ascend in [((4, 3000), 1, True), ((2, 500, 3), 1, False)]:
+            # Values with many ties and mixed signs, the order must be stable.
+            np_data = np.random.randint(-50, 50, size=shape).astype(dtype)
+            np_indices = np.argsort(np_data if is_ascend else -np_data, axis=axis, kind="stable")
+            np_values = np.take_along_axis(np_data, np_indices, axis=axis)
+
+            indices = tvm.nd.empty(shape, "int32")
+            values = tvm.nd.empty(shape, dtype)
+            fargsort(tvm.nd.array(np_data), indices, axis, is_ascend)
+            fsort(tvm.nd.array(np_data), values, axis, is_ascend)
+            tvm.testing.assert_allclose(indices.numpy(), np_indices)
+            tvm.testing.assert_allclose(values.numpy(), np_values)
+
+
 def test_sort_by_key_gpu():
     """Tests sort function using gpu"""
     size = 6
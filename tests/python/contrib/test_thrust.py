@@ -19,7 +19,7 @@ import numpy as np
 import tvm
 import tvm.testing
 from tvm import te
-from tvm.topi.cuda import stable_sort_by_key_thrust
+from tvm.topi.cuda import radix_topk_thrust, stable_sort_by_key_thrust
 from tvm.topi.cuda.scan import exclusive_scan, scan_thrust, schedule_scan
 from tvm.contrib.thrust import can_use_thrust, can_use_rocthrust
 
@@ -140,7 +140,49 @@ def test_inclusive_scan():
                 tvm.testing.assert_allclose(values_out.numpy(), ref_values_out, rtol=1e-5)
 
 
+def test_radix_topk():
+    """Tests function test_radix_topk"""
+    target = "cuda"
+    if not tvm.testing.device_enabled(target):
+        print("Skip because %s is not enabled" % target)
+        return
+
+    with tvm.target.Target(target + " -libs=thrust") as tgt:
+        if not can_use_thrust(tgt, "tvm.contrib.thrust.radix_topk"):
+            print("skip because thrust is not enabled...")
+            return
+
+        dev = tvm.device(target, 0)
+        for dtype, ishape, k, is_ascend in [
+            ("float32", (4, 32000), 8, False),
+            ("float32", (3, 1000), 100, True),
+            ("float16", (2, 4096), 1, False),
+            ("int32", (5, 777), 64, False),
+            ("int64", (1, 300), 300, True),
+        ]:
+            data = te.placeholder(ishape, name="data", dtype=dtype)
+            values, indices = radix_topk_thrust(data, k, is_ascend=is_ascend, dtype="int32")
+            s = te.create_schedule([values.op, indices.op])
+            f = tvm.build(s, [data, values, indices], target)
+
+            if dtype.startswith("int"):
+                # Many ties, which are ranked by their indices.
+                data_np = np.random.randint(-50, 50, size=ishape).astype(dtype)
+            else:
+                data_np = np.random.uniform(-10, 10, size=ishape).astype(dtype)
+            values_nd = tvm.nd.empty(values.shape, dtype, dev)
+            indices_nd = tvm.nd.empty(indices.shape, "int32", dev)
+            f(tvm.nd.array(data_np, dev), values_nd, indices_nd)
+
+            order = np.argsort(data_np if is_ascend else -data_np, axis=-1, kind="stable")
+            ref_indices = order[:, :k]
+            ref_values = np.take_along_axis(data_np, ref_indices, axis=-1)
+            tvm.testing.assert_allclose(values_nd.numpy(), ref_values)
+            tvm.testing.assert_allclose(indices_nd.numpy(), ref_indices)
+
+
 if __name__ == "__main__":
     test_stable_sort_by_key()
     test_exclusive_scan()
     test_inclusive_scan()
+    test_radix_topk()
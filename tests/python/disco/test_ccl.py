@@ -174,6 +174,61 @@ def test_group_allgather(session_kind, ccl):
     )
 
 
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+@pytest.mark.parametrize("ccl", _ccl)
+def test_alltoall(session_kind, ccl):
+    devices = [0, 1]
+    sess = session_kind(num_workers=len(devices))
+    sess.init_ccl(ccl, *devices)
+
+    array = np.arange(24, dtype="float32").reshape(2, 4, 3)
+    d_src = sess.empty((4, 3), "float32")
+    d_dst = sess.empty((4, 3), "float32")
+    d_src.debug_copy_from(0, array[0])
+    d_src.debug_copy_from(1, array[1])
+    sess.alltoall(d_src, d_dst)
+    # Worker `i` receives the chunk `i` of every worker.
+    for i in range(2):
+        np.testing.assert_equal(
+            d_dst.debug_get_from_remote(i).numpy(),
+            np.concatenate([array[0][i * 2 : i * 2 + 2], array[1][i * 2 : i * 2 + 2]]),
+        )
+
+
+@tvm.register_func("tests.disco.alltoallv_uneven")
+def _alltoallv_uneven(src, dst):
+    # Worker 0 sends 1 row to itself and 3 rows to worker 1, and worker 1 sends 2 rows to each.
+    worker_id = get_global_func("runtime.disco.worker_rank")()
+    send_counts = [[1, 3], [2, 2]][worker_id]
+    recv_counts = [[1, 2], [3, 2]][worker_id]
+    get_global_func("runtime.disco.alltoallv")(
+        src, tvm.runtime.ShapeTuple(send_counts), tvm.runtime.ShapeTuple(recv_counts), True, dst
+    )
+
+
+@pytest.mark.parametrize("ccl", _ccl)
+def test_alltoallv(ccl):
+    # The counts differ on each worker, so they are chosen by a function in this process.
+    devices = [0, 1]
+    sess = di.ThreadedSession(num_workers=len(devices))
+    sess.init_ccl(ccl, *devices)
+
+    array = np.arange(24, dtype="float32").reshape(2, 4, 3)
+    d_src = sess.empty((4, 3), "float32")
+    d_dst = sess.empty((5, 3), "float32")
+    d_src.debug_copy_from(0, array[0])
+    d_src.debug_copy_from(1, array[1])
+    sess.get_global_func("tests.disco.alltoallv_uneven")(d_src, d_dst)
+    np.testing.assert_equal(
+        d_dst.debug_get_from_remote(0).numpy()[:3],
+        np.concatenate([array[0][:1], array[1][:2]]),
+    )
+    np.testing.assert_equal(
+        d_dst.debug_get_from_remote(1).numpy(),
+        np.concatenate([array[0][1:], array[1][2:]]),
+    )
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 @pytest.mark.parametrize("ccl", _ccl)
 @pytest.mark.parametrize("use_explicit_output", [True, False])
@@ -413,6 +468,41 @@ def test_send_to_next_group_receive_from_prev_group(session_kind, ccl):
     np.testing.assert_equal(result_2, array_2)
 
 
+@tvm.register_func("tests.disco.pipeline_add_one", override=True)
+def _pipeline_add_one(x):
+    return tvm.nd.array(x.numpy() + 1, device=x.device)
+
+
+@pytest.mark.parametrize("ccl", _ccl)
+@pytest.mark.parametrize("num_chunks", [1, 2])
+def test_run_pipeline(ccl, num_chunks):
+    devices = [0, 1, 2, 3]
+    # The stages are python functions, which are only visible to threaded workers.
+    sess = di.ThreadedSession(num_workers=len(devices), num_groups=2)
+    sess.init_ccl(ccl, *devices)
+
+    num_micro_batches = 4
+    arrays = [np.full((3, 4), m, dtype="float32") for m in range(num_micro_batches)]
+    inputs = []
+    for array in arrays:
+        d_array = sess.empty((3, 4), "float32")
+        d_array.debug_copy_from(0, array)
+        d_array.debug_copy_from(1, array)
+        inputs.append(d_array)
+    stage = sess.get_global_func("tests.disco.pipeline_add_one")
+    result = sess.run_pipeline([stage] * num_chunks, inputs, (3, 4), "float32", profile=True)
+
+    for worker_id in [0, 1]:
+        outputs, elapsed_nanos = result.debug_get_from_remote(worker_id)
+        assert len(outputs) == 0
+        assert len(elapsed_nanos) == num_chunks * num_micro_batches
+    for worker_id in [2, 3]:
+        outputs, elapsed_nanos = result.debug_get_from_remote(worker_id)
+        assert len(elapsed_nanos) == num_chunks * num_micro_batches
+        for array, output in zip(arrays, outputs):
+            np.testing.assert_equal(output.numpy(), array + 2 * num_chunks)
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 @pytest.mark.parametrize("ccl", _ccl)
 def test_worker2_send_to_worker0(session_kind, ccl):
@@ -346,6 +346,36 @@ def test_load_shard_all():
         np.testing.assert_equal(param_dict["param_1"][16:32, :], p_1[1].numpy())
 
 
+def test_load_all_sharded():
+    devices = [0, 1]
+    num_shards = len(devices)
+    param_dict = {
+        "param_0": np.random.uniform(size=[64, 128]).astype("float16"),
+        "param_1": np.random.uniform(size=[32, 128]).astype("float32"),
+    }
+    shard_info = {
+        "param_0": [
+            [
+                "tests.disco.shard_dim_1",
+                [(num_shards, 64, 64), "float16"],
+                num_shards,
+            ],
+        ],
+    }
+    with tempfile.TemporaryDirectory() as path:
+        sess = di.ThreadedSession(num_workers=len(devices))
+        sess.init_ccl("nccl", *devices)
+        loader = _create_loader(sess, path, param_dict, shard_info)
+        loader_load = sess.get_global_func("runtime.disco.ShardLoaderLoadAllSharded")
+        params = loader_load(loader)
+        p_0 = params.debug_get_from_remote(0)
+        p_1 = params.debug_get_from_remote(1)
+        np.testing.assert_equal(param_dict["param_0"][:, 0:64], p_0[0].numpy())
+        np.testing.assert_equal(param_dict["param_0"][:, 64:128], p_1[0].numpy())
+        np.testing.assert_equal(param_dict["param_1"], p_0[1].numpy())
+        np.testing.assert_equal(param_dict["param_1"], p_1[1].numpy())
+
+
 def test_load_all_presharded():
     devices = [0, 1]
     num_shards = len(devices)
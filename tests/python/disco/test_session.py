@@ -117,7 +117,13 @@ def create_socket_session(num_workers):
     return _SOCKET_SESSION_TESTER.sess
 
 
+def create_shared_memory_process_session(num_workers):
+    return di.ProcessSession(num_workers=num_workers, channel="shm")
+
+
 _all_session_kinds = [di.ThreadedSession, di.ProcessSession, create_socket_session]
+if sys.platform.startswith("linux"):
+    _all_session_kinds.append(create_shared_memory_process_session)
 
 
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
@@ -190,6 +196,34 @@ def test_shape_tuple(session_kind):
         assert list(value) == [1, 2, 3, 4, 5]
 
 
+@pytest.mark.parametrize("session_kind", _all_session_kinds)
+def test_command_graph(session_kind):
+    num_workers = 4
+    sess = session_kind(num_workers=num_workers)
+    device = tvm.cpu(0)
+    x_np = np.arange(6).astype("float32").reshape([2, 3])
+    x_disc = _numpy_to_worker_0(sess, x_np, device=device)
+    func = sess.get_global_func("tests.disco.add_one_ndarray")
+    sess.begin_command_graph()
+    y_disc = func(x_disc)
+    z_disc = func(y_disc)
+    graph = sess.end_command_graph()
+    for scale in [1, 2, 3]:
+        sess.copy_to_worker_0(tvm.nd.array(x_np * scale, device=device), x_disc)
+        sess.replay_command_graph(graph)
+        z_nd = _numpy_from_worker_0(sess, z_disc, shape=x_np.shape, dtype=x_np.dtype)
+        np.testing.assert_equal(z_nd, x_np * scale + 2)
+
+
+def test_command_graph_rejects_copies():
+    sess = di.ThreadedSession(num_workers=2)
+    x_disc = sess.empty((2, 3), "float32")
+    sess.begin_command_graph()
+    with pytest.raises(ValueError):
+        sess.copy_to_worker_0(tvm.nd.array(np.zeros((2, 3), "float32")), x_disc)
+    sess.end_command_graph()
+
+
 @pytest.mark.parametrize("session_kind", _all_session_kinds)
 def test_vm_module(session_kind):
     num_workers = 4
@@ -311,5 +345,34 @@ def test_num_workers(session_kind, num_workers):
     assert sess.num_workers == num_workers
 
 
+
+@pytest.mark.parametrize("session_kind", [di.ThreadedSession, di.ProcessSession])
+def test_worker_stats(session_kind):
+    num_workers = 2
+    sess = session_kind(num_workers=num_workers)
+    func: di.DPackedFunc = sess.get_global_func("tests.disco.add_one")
+    for _ in range(3):
+        func(1)
+    sess.set_sync_watchdog(60000)
+    stats = sess.worker_stats()
+    assert len(stats) == num_workers
+    for worker in stats:
+        assert worker["num_commands_in_flight"] > 0
+        assert worker["num_commands"] >= 4
+        assert worker["busy_nanos"] > 0
+        # The histogram is read by a command before the sync, which is not counted in it.
+        assert sum(worker["latency_histogram"]) < worker["num_commands"]
+    for before, after in zip(stats, sess.worker_stats()):
+        assert after["num_commands"] > before["num_commands"]
+
+@pytest.mark.parametrize("session_kind", [di.ThreadedSession, di.ProcessSession])
+def test_bind_workers_to_numa_nodes(session_kind):
+    num_workers = 2
+    sess = session_kind(num_workers=num_workers)
+    # The workers on the CPU have no nearest NUMA node, and are left as is.
+    assert sess.bind_workers_to_numa_nodes() == [-1] * num_workers
+    assert tvm.get_global_func("runtime.disco.device_numa_node")(tvm.cpu()) == -1
+
+
 if __name__ == "__main__":
     tvm.testing.main()
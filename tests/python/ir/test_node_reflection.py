@@ -14,6 +14,8 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import pickle
+
 import tvm
 import tvm.testing
 import sys
@@ -195,5 +197,29 @@ def test_alloc_const():
     np.testing.assert_array_equal(np_data, alloc_const2.data.numpy())
 
 
+def test_binary_roundtrip():
+    dtype = "float32"
+    shape = (16,)
+    buf = tvm.tir.decl_buffer(shape, dtype)
+    np_data = np.random.rand(*shape).astype(dtype)
+    data = tvm.nd.array(np_data, device=tvm.cpu(0))
+    body = tvm.tir.Evaluate(tvm.tir.Cast("int32", tvm.tir.FloatImm(dtype, 1.5)))
+    alloc_const = tvm.tir.AllocateConst(buf.data, dtype, shape, data, body)
+    func = tvm.tir.PrimFunc([], alloc_const).with_attr({"global_symbol": "main", "flag": True})
+    mod = tvm.IRModule({"main": func})
+
+    blob = tvm.ir.save_binary(mod)
+    assert isinstance(blob, bytes)
+    mod2 = tvm.ir.load_binary(blob)
+    tvm.ir.assert_structural_equal(mod, mod2)
+    np.testing.assert_array_equal(np_data, mod2["main"].body.data.numpy())
+
+    mod3 = pickle.loads(pickle.dumps(mod))
+    tvm.ir.assert_structural_equal(mod, mod3)
+
+    with pytest.raises(tvm.TVMError):
+        tvm.ir.load_binary(blob[: len(blob) // 2])
+
+
 if __name__ == "__main__":
     tvm.testing.main()
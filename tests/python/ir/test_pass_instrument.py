@@ -17,9 +17,16 @@
 """ Instrument test cases.
 """
 
+import json
+
 import tvm
 from tvm import relax
-from tvm.ir.instrument import PrintAfterAll, PrintBeforeAll
+from tvm.ir.instrument import (
+    ObjectAllocationInstrument,
+    PassTimingInstrument,
+    PrintAfterAll,
+    PrintBeforeAll,
+)
 from tvm.script import ir as I
 from tvm.script import relax as R
 from tvm.script import tir as T
@@ -61,3 +68,43 @@ def test_relax_print_all_passes(capsys):
     assert "Before Running Pass:" in all_passes_output
     assert "After Running Pass:" in all_passes_output
     assert "pass name: _pipeline" in all_passes_output
+
+
+def test_object_allocation_instrument():
+    @T.prim_func
+    def func(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+        for i in range(16):
+            B[i] = A[i] * 2.0
+
+    alloc_inst = ObjectAllocationInstrument()
+    with tvm.transform.PassContext(opt_level=3, instruments=[alloc_inst]):
+        tvm.lower(func)
+    names = [name for name, _, _, _ in alloc_inst.profiles]
+    assert "tir.Simplify" in names
+    assert all(allocated >= 0 for _, _, allocated, _ in alloc_inst.profiles)
+    assert "tir.Simplify: allocated=" in alloc_inst.render()
+
+
+def test_pass_timing_export():
+    @T.prim_func
+    def func(A: T.Buffer((16,), "float32"), B: T.Buffer((16,), "float32")):
+        for i in range(16):
+            B[i] = A[i] * 2.0
+
+    timing_inst = PassTimingInstrument(count_ir_nodes=True)
+    with tvm.transform.PassContext(opt_level=3, instruments=[timing_inst]):
+        tvm.lower(func)
+        trace = json.loads(timing_inst.export_chrome_trace())
+        stacks = timing_inst.export_folded_stacks()
+
+    events = {event["name"]: event for event in trace["traceEvents"]}
+    simplify = events["tir.Simplify"]
+    assert simplify["ph"] == "X" and simplify["dur"] >= 0
+    assert simplify["args"]["ir_nodes_before"] > 0
+    assert simplify["args"]["ir_nodes_after"] > 0
+    assert "peak_rss_delta_bytes" in simplify["args"]
+
+    for line in stacks.splitlines():
+        path, self_time = line.rsplit(" ", 1)
+        assert path and int(self_time) >= 0
+    assert any(line.split(" ")[0].endswith("tir.Simplify") for line in stacks.splitlines())
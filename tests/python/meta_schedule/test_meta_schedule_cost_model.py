@@ -26,7 +26,14 @@ from typing import List
 import numpy as np
 import tvm
 import tvm.testing
-from tvm.meta_schedule.cost_model import PyCostModel, RandomModel, XGBModel
+from tvm import meta_schedule as ms
+from tvm.meta_schedule.cost_model import (
+    PyCostModel,
+    RandomModel,
+    XGBModel,
+    ranking_accuracy,
+    warm_start,
+)
 from tvm.meta_schedule.cost_model.xgb_model import PackSum, _get_custom_call_back
 from tvm.meta_schedule.feature_extractor import RandomFeatureExtractor
 from tvm.meta_schedule.runner import RunnerResult
@@ -342,5 +349,51 @@ def test_meta_schedule_xgb_model_callback_as_function():
     assert np.allclose(pred1, pred2, rtol=1e-3, atol=1e-3)
 
 
+def test_meta_schedule_cost_model_warm_start():
+    @derived_object
+    class LookupCostModel(PyCostModel):
+        def __init__(self):
+            self.run_secs = {}
+
+        def load(self, path: str) -> None:
+            pass
+
+        def save(self, path: str) -> None:
+            pass
+
+        def update(
+            self,
+            context: TuneContext,
+            candidates: List[MeasureCandidate],
+            results: List[RunnerResult],
+        ) -> None:
+            for candidate, result in zip(candidates, results):
+                self.run_secs[str(candidate.sch.trace)] = float(result.run_secs[0])
+
+        def predict(self, context: TuneContext, candidates: List[MeasureCandidate]) -> np.ndarray:
+            return np.array([1.0 / self.run_secs[str(c.sch.trace)] for c in candidates])
+
+    database = ms.database.MemoryDatabase()
+    workload = database.commit_workload(Matmul)
+    for factor, run_secs in [(4, 3.0), (8, 1.0), (16, 2.0)]:
+        sch = Schedule(Matmul)
+        i, _, _ = sch.get_loops(sch.get_block("matmul"))
+        sch.split(i, factors=[None, factor])
+        database.commit_tuning_record(
+            ms.database.TuningRecord(
+                sch.trace,
+                workload,
+                [tvm.tir.FloatImm("float64", run_secs)],
+                tvm.target.Target("llvm"),
+                ms.arg_info.ArgInfo.from_prim_func(func=Matmul["main"]),
+            )
+        )
+    model = LookupCostModel()
+    assert warm_start(model, database, max_records_per_workload=2) == 2
+    assert len(model.run_secs) == 2
+    assert warm_start(model, [database]) == 3
+    assert ranking_accuracy(model, database) == 1.0
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -243,6 +243,31 @@ def test_meta_schedule_tuning_record_round_trip():
         _equal_record(record, new_record)
 
 
+def test_meta_schedule_tuning_record_metrics_round_trip():
+    mod: IRModule = Matmul
+    with tempfile.TemporaryDirectory() as tmpdir:
+        database = _create_tmp_database(tmpdir)
+        workload = database.commit_workload(mod)
+        record = ms.database.TuningRecord(
+            _create_schedule(mod, _schedule_matmul).trace,
+            workload,
+            [1.5, 2.5, 1.8],
+            tvm.target.Target("llvm"),
+            ms.arg_info.ArgInfo.from_prim_func(func=mod["main"]),
+            metrics={"PAPI_L2_TCM": 123456789, "PAPI_TOT_CYC": 1.5e9},
+        )
+        database.commit_tuning_record(record)
+        new_database = ms.database.JSONDatabase(
+            path_workload=database.path_workload,
+            path_tuning_record=database.path_tuning_record,
+        )
+        (new_record,) = new_database.get_all_tuning_records()
+        _equal_record(record, new_record)
+        assert float(new_record.metrics["PAPI_L2_TCM"]) == 123456789
+        assert float(new_record.metrics["PAPI_TOT_CYC"]) == 1.5e9
+        # Records without metrics keep the original JSON layout
+        assert len(ms.database.TuningRecord(record.trace, workload).as_json()) == 4
+
 def test_meta_schedule_database_create():
     with tempfile.TemporaryDirectory() as tmpdir:
         database = _create_tmp_database(tmpdir)
@@ -584,6 +609,72 @@ def test_json_database_get_top_k(k, expected):
     assert result == expected
 
 
+def test_indexed_json_database_reload_and_compact():
+    mod: IRModule = Matmul
+    run_secs_list = [[7.0], [1.0], [4.0], [3.0], [9.0], [2.0]]
+    with tempfile.TemporaryDirectory() as tmpdir:
+        path_workload = osp.join(tmpdir, "workloads.json")
+        path_tuning_record = osp.join(tmpdir, "tuning_records.json")
+        # Records written by JSONDatabase are indexed on first open.
+        database = ms.database.JSONDatabase(path_workload, path_tuning_record)
+        call_get_top_k(run_secs_list[:3], database, 1)
+        del database
+        database = ms.database.IndexedJSONDatabase(
+            path_workload, path_tuning_record, top_k_per_workload=3, compact_threshold=2
+        )
+        assert osp.exists(path_tuning_record + ".index")
+        result = call_get_top_k(run_secs_list[3:], database, 5)
+        assert result == [[1.0], [2.0], [3.0]]
+        assert len(database) == 3
+        del database
+        # Two records dropped from the retention triggered a compaction.
+        with open(path_tuning_record) as f:
+            assert len(f.readlines()) <= 4
+        database = ms.database.IndexedJSONDatabase(path_workload, path_tuning_record)
+        workload = database.commit_workload(mod)
+        result = [[v.value for v in r.run_secs] for r in database.get_top_k(workload, 5)]
+        assert result == [[1.0], [2.0], [3.0]]
+        database.compact()
+        # The compacted files stay readable by JSONDatabase.
+        database = ms.database.JSONDatabase(path_workload, path_tuning_record)
+        workload = database.commit_workload(mod)
+        result = [[v.value for v in r.run_secs] for r in database.get_top_k(workload, 5)]
+        assert result == [[1.0], [2.0], [3.0]]
+
+
+def test_json_database_concurrent_writers():
+    mod: IRModule = Matmul
+    trace = _create_schedule(mod, _schedule_matmul).trace
+    with tempfile.TemporaryDirectory() as tmpdir:
+        path_workload = osp.join(tmpdir, "workloads.json")
+        path_tuning_record = osp.join(tmpdir, "tuning_records.json")
+        writer = ms.database.JSONDatabase(path_workload, path_tuning_record, concurrent=True)
+        reader = ms.database.JSONDatabase(path_workload, path_tuning_record, concurrent=True)
+
+        def _record(database, run_secs, target="llvm"):
+            return ms.database.TuningRecord(
+                trace,
+                database.commit_workload(mod),
+                run_secs,
+                tvm.target.Target(target),
+                ms.arg_info.ArgInfo.from_prim_func(func=mod["main"]),
+            )
+
+        writer.commit_tuning_record(_record(writer, [1.0]))
+        # The reader tails the record without reloading.
+        assert len(reader) == 1
+        # The same candidate measured again by the reader is dropped.
+        reader.commit_tuning_record(_record(reader, [2.0]))
+        assert len(reader) == 1
+        reader.commit_tuning_record(_record(reader, [3.0], target="llvm -num-cores=4"))
+        writer.refresh()
+        assert len(writer) == 2
+        with open(path_workload) as f:
+            assert len(f.readlines()) == 1
+        with open(path_tuning_record) as f:
+            assert len(f.readlines()) == 2
+
+
 def MatmulFunc() -> IRModule:
     a = relay.var("a", relay.TensorType((1024, 1024), "float32"))
     b = relay.var("b", relay.TensorType((1024, 1024), "float32"))
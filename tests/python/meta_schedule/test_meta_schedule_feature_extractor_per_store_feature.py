@@ -1632,5 +1632,46 @@ def test_negative_extent():
     assert named_features["B0.unique_bytes"] == 0
 
 
+@T.prim_func
+def two_stages(A: T.Buffer((64, 64), "float32"), C: T.Buffer((64, 64), "float32")):
+    B = T.alloc_buffer((64, 64), "float32")
+    for i, j in T.grid(64, 64):
+        with T.block("B"):
+            vi, vj = T.axis.remap("SS", [i, j])
+            B[vi, vj] = A[vi, vj] * T.float32(2)
+    for i, j in T.grid(64, 64):
+        with T.block("C"):
+            vi, vj = T.axis.remap("SS", [i, j])
+            C[vi, vj] = B[vi, vj] + T.float32(1)
+
+
+def test_cached_loop_nests():
+    def _create_schedule(factor):
+        def f_sch():
+            sch = tir.Schedule(two_stages, debug_mask="all")
+            _, j = sch.get_loops(sch.get_block("C"))
+            sch.split(j, factors=[None, factor])
+            return sch
+
+        return f_sch
+
+    context = _make_context(tvm.target.Target("llvm"))
+    factors = [4, 8, 4, 16]
+    expected = [
+        ms.feature_extractor.PerStoreFeature()
+        .extract_from(context, candidates=[_make_candidate(_create_schedule(factor))])[0]
+        .numpy()
+        for factor in factors
+    ]
+    # The loop nest of "B" and the repeated candidate are served from the cache
+    extractor = ms.feature_extractor.PerStoreFeature()
+    for _ in range(2):
+        features = extractor.extract_from(
+            context, candidates=[_make_candidate(_create_schedule(factor)) for factor in factors]
+        )
+        for feature, expected_feature in zip(features, expected):
+            assert_allclose(feature.numpy(), expected_feature, rtol=1e-5)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -66,14 +66,28 @@ def _sch(decisions: List[List[int]]) -> Schedule:
     return sch
 
 
-def _make_mutator(target: Target) -> ms.Mutator:
+def _sch_shared(decision: List[int]) -> Schedule:
+    sch = Schedule(matmul, debug_mask="all")
+    # pylint: disable=invalid-name
+    b0 = sch.get_block(name="C", func_name="main")
+    l1, _, _ = sch.get_loops(block=b0)
+    v2, v3 = sch.sample_perfect_tile(loop=l1, n=2, max_innermost_factor=512, decision=decision)
+    l4, _ = sch.split(loop=l1, factors=[v2, v3])
+    sch.bind(loop=l4, thread_axis="blockIdx.x")
+    b5 = sch.cache_read(block=b0, read_buffer_index="A", storage_scope="shared")
+    sch.compute_at(block=b5, loop=l4, preserve_unit_loops=True)
+    # pylint: enable=invalid-name
+    return sch
+
+
+def _make_mutator(target: Target, prune_by_footprint: bool = False) -> ms.Mutator:
     ctx = ms.TuneContext(
         mod=matmul,
         target=target,
         space_generator=ms.space_generator.PostOrderApply(
             sch_rules=[],
             postprocs=[],
-            mutator_probs={ms.mutator.MutateTileSize(): 1.0},
+            mutator_probs={ms.mutator.MutateTileSize(prune_by_footprint): 1.0},
         ),
     )
     return list(ctx.space_generator.mutator_probs.keys())[0]
@@ -107,6 +121,27 @@ def test_mutate_sample_categorical_single_candidate():
     assert trace is None
 
 
+def test_mutate_tile_size_prune_by_footprint():
+    # A_shared holds `inner x 512` floats, so at most 8 rows fit into 16KB
+    target = Target("cuda -max_shared_memory_per_block=16384 -max_threads_per_block=1024")
+    sch = _sch_shared(decision=[128, 4])
+    unpruned = set()
+    mutator = _make_mutator(target=target)
+    for _ in range(200):
+        trace = mutator.apply(sch.trace)
+        if trace is not None:
+            unpruned.add(int(trace.decisions[trace.insts[2]][1]))
+    assert max(unpruned) > 8
+    mutator = _make_mutator(target=target, prune_by_footprint=True)
+    for _ in range(200):
+        trace = mutator.apply(sch.trace)
+        if trace is not None:
+            decision = [int(x) for x in trace.decisions[trace.insts[2]]]
+            assert reduce(operator.mul, decision, 1) == 512
+            assert decision[1] <= 8
+
+
 if __name__ == "__main__":
     test_mutate_tile_size_matmul()
     test_mutate_sample_categorical_single_candidate()
+    test_mutate_tile_size_prune_by_footprint()
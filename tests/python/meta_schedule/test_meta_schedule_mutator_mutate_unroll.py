@@ -116,5 +116,26 @@ def test_mutate_unroll_matmul():
     assert results == {1, 2, 3}
 
 
+def test_mutate_unroll_factor():
+    mutator = _make_mutator(target=Target("llvm --num-cores=16"))
+    sch = Schedule(matmul, debug_mask="all")
+    _, _, k = sch.get_loops(sch.get_block("C"))
+    factor = sch.sample_categorical(
+        candidates=[1, 2, 4, 8],
+        probs=[0.25, 0.25, 0.25, 0.25],
+        decision=0,
+    )
+    sch.annotate(block_or_loop=k, ann_key="pragma_unroll_factor", ann_val=factor)
+    results = set()
+    for _ in range(100):
+        trace = mutator.apply(sch.trace)
+        decision = trace.decisions[trace.insts[-2]]
+        results.add(decision)
+        if len(results) == 3:
+            break
+    assert results == {1, 2, 3}
+
+
 if __name__ == """__main__""":
     test_mutate_unroll_matmul()
+    test_mutate_unroll_factor()
@@ -243,6 +243,35 @@ def test_meta_schedule_local_single_run():
     _clean_build(builder_result.artifact_path)
 
 
+def test_meta_schedule_local_runner_adaptive_evaluation():
+    """Test meta schedule local runner stopping early on slow candidates"""
+    mod = MatmulModule
+    builder = LocalBuilder()
+    (builder_result,) = builder.build([BuilderInput(mod, Target("llvm"))])
+    assert builder_result.error_msg is None
+    args_info = [TensorInfo("float32", (MATMUL_N, MATMUL_N)) for _ in range(3)]
+    evaluator_config = EvaluatorConfig(
+        number=1,
+        repeat=3,
+        min_repeat_ms=0,
+        early_stop_ratio=2.0,
+        max_repeat=6,
+        close_ratio=1e9,
+    )
+    runner = LocalRunner(timeout_sec=100, evaluator_config=evaluator_config)
+    # Way slower than the best known candidate: only the pilot run is measured
+    slow_input = RunnerInput(builder_result.artifact_path, "llvm", args_info, best_run_secs=1e-12)
+    # Close to the best known candidate: repeated up to `max_repeat`
+    close_input = RunnerInput(builder_result.artifact_path, "llvm", args_info, best_run_secs=1e3)
+    # Without a best known candidate: the regular `repeat`
+    new_input = RunnerInput(builder_result.artifact_path, "llvm", args_info)
+    futures = runner.run([slow_input, close_input, new_input])
+    slow, close, new = [future.result() for future in futures]
+    assert slow.error_msg is None and len(slow.run_secs) == 1
+    assert close.error_msg is None and len(close.run_secs) == 6
+    assert new.error_msg is None and len(new.run_secs) == 3
+    _clean_build(builder_result.artifact_path)
+
 def test_meta_schedule_rpc_multiple_runs():
     """Test meta schedule rpc runner for multiple runs"""
     # Build the module
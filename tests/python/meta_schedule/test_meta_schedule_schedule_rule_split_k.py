@@ -0,0 +1,74 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-module-docstring,missing-function-docstring,missing-class-docstring
+import tvm
+import tvm.testing
+from tvm import meta_schedule as ms
+from tvm import tir
+from tvm.meta_schedule.testing import te_workload
+from tvm.meta_schedule.testing.space_generation import generate_design_space
+from tvm.target import Target
+from tvm.te import create_prim_func
+
+
+def _bound_threads(sch: tir.Schedule, block_name: str):
+    return {
+        sch.get(loop).thread_binding.thread_tag
+        for loop in sch.get_loops(sch.get_block(block_name))
+        if sch.get(loop).thread_binding is not None
+    }
+
+
+def _instructions(sch: tir.Schedule):
+    return [inst.kind.name for inst in sch.trace.insts]
+
+
+def test_split_k_skinny_matmul():
+    mod = create_prim_func(te_workload.matmul(n=4, m=1024, k=4096))
+    actual = generate_design_space(
+        kind="cuda",
+        mod=mod,
+        target=Target("nvidia/geforce-rtx-3090", host="llvm"),
+        types=None,
+        sch_rules=[ms.schedule_rule.SplitK()],
+    )
+    assert len(actual) == 2
+    split, unsplit = sorted(actual, key=lambda sch: "RFactor" not in _instructions(sch))
+    # The partial sums are computed across blockIdx.y into a workspace with the K partitions as
+    # the outermost dimension, and the original block reduces them.
+    assert _bound_threads(split, "C_rf") == {"blockIdx.x", "blockIdx.y", "threadIdx.x"}
+    workspace = split.get(split.get_block("C")).reads[0].buffer
+    assert len(workspace.shape) == 3
+    assert _instructions(split).count("SampleCategorical") == 2
+    assert "RFactor" not in _instructions(unsplit)
+
+
+def test_split_k_not_applied():
+    # The reduction is short for the output, which already occupies the device.
+    mod = create_prim_func(te_workload.matmul(n=512, m=512, k=512))
+    actual = generate_design_space(
+        kind="cuda",
+        mod=mod,
+        target=Target("nvidia/geforce-rtx-3090", host="llvm"),
+        types=None,
+        sch_rules=[ms.schedule_rule.SplitK()],
+    )
+    assert len(actual) == 1
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
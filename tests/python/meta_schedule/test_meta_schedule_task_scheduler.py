@@ -231,6 +231,86 @@ def test_meta_schedule_task_scheduler_multiple():
         )
 
 
+@pytest.mark.parametrize("kind", ["round-robin", "gradient"])
+def test_meta_schedule_task_scheduler_pipelined(kind):
+    num_trials_per_iter = 6
+    max_trials_per_task = 31
+    tasks = [
+        ms.TuneContext(
+            mod,
+            target=tvm.target.Target("llvm"),
+            space_generator=sch_fn,
+            search_strategy=ms.search_strategy.ReplayTrace(),
+            task_name=name,
+            rand_state=42,
+        )
+        for mod, sch_fn, name in [
+            (MatmulModule, _schedule_matmul, "Matmul"),
+            (MatmulReluModule, _schedule_matmul, "MatmulRelu"),
+            (BatchMatmulModule, _schedule_batch_matmul, "BatchMatmul"),
+        ]
+    ]
+    database = ms.database.MemoryDatabase()
+    scheduler = ms.task_scheduler.create(kind, pipelined=True)
+    assert scheduler.pipelined
+    scheduler.tune(
+        tasks,
+        [1.0, 1.0, 1.0],
+        builder=DummyBuilder(),
+        runner=DummyRunner(),
+        database=database,
+        measure_callbacks=[ms.measure_callback.AddToDatabase()],
+        max_trials_global=max_trials_per_task * len(tasks),
+        max_trials_per_task=max_trials_per_task,
+        num_trials_per_iter=num_trials_per_iter,
+        cost_model=None,
+    )
+    # Every batch built in the background was run and accounted to its task.
+    for task in scheduler.tasks_:
+        assert task.is_terminated
+        assert task.measure_candidates is None
+    assert len(database) == max_trials_per_task * len(tasks)
+
+
+def test_meta_schedule_task_scheduler_measure_cache():
+    num_built = []
+
+    @ms.derived_object
+    class CountingBuilder(ms.builder.PyBuilder):
+        def build(self, build_inputs):
+            num_built.append(len(build_inputs))
+            return [ms.builder.BuilderResult("test_path", None) for _ in build_inputs]
+
+    database = ms.database.MemoryDatabase()
+    round_robin = ms.task_scheduler.RoundRobin()
+    round_robin.tune(
+        [
+            ms.TuneContext(
+                MatmulModule,
+                target=tvm.target.Target("llvm"),
+                space_generator=_schedule_matmul,
+                search_strategy=ms.search_strategy.ReplayTrace(),
+                task_name="Test",
+                rand_state=42,
+            )
+        ],
+        [1.0],
+        max_trials_global=12,
+        max_trials_per_task=12,
+        num_trials_per_iter=4,
+        builder=CountingBuilder(),
+        runner=DummyRunner(),
+        database=database,
+        measure_callbacks=[ms.measure_callback.AddToDatabase()],
+        cost_model=None,
+    )
+    # The design space is fixed, all the traces lower to the same module, which is built once
+    # per candidate of the first batch only.
+    assert sum(num_built) == 4
+    assert round_robin.tasks_[0].cache_hit_count == 8
+    assert len(database) == 12
+
+
 def test_meta_schedule_task_scheduler_NIE():  # pylint: disable=invalid-name
     @ms.derived_object
     class NIETaskScheduler(ms.task_scheduler.PyTaskScheduler):
@@ -0,0 +1,107 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-docstring,no-member,invalid-name,unused-variable
+import tempfile
+from typing import List
+
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import meta_schedule as ms
+from tvm.meta_schedule.runner import PyRunner, RunnerFuture, RunnerInput
+from tvm.meta_schedule.utils import derived_object
+from tvm.script import tir as T
+from tvm.target import Target
+
+
+@T.prim_func
+def matmul(a: T.handle, b: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, [32, 32])
+    B = T.match_buffer(b, [32, 32])
+    C = T.match_buffer(c, [32, 32])
+    for i, j, k in T.grid(32, 32, 32):
+        with T.block("update"):
+            vi, vj, vk = T.axis.remap("SSR", [i, j, k])
+            with T.init():
+                C[vi, vj] = 0.0
+            C[vi, vj] = C[vi, vj] + A[vi, vk] * B[vj, vk]
+
+
+@derived_object
+class OfflineRunner(PyRunner):
+    def __init__(self) -> None:
+        super().__init__()
+        self.num_calls = 0
+
+    def run(self, runner_inputs: List[RunnerInput]) -> List[RunnerFuture]:
+        self.num_calls += 1
+        raise ConnectionError("the tracker is unreachable")
+
+
+def _task(target: Target) -> ms.TuneContext:
+    return ms.TuneContext(
+        mod=matmul,
+        target=target,
+        space_generator="post-order-apply",
+        search_strategy="evolutionary",
+        task_name="matmul",
+        num_threads=1,
+    ).clone()
+
+
+@tvm.testing.requires_llvm
+def test_tune_distributed_pool_drops_out():
+    target = Target("llvm --num-cores=1")
+    offline = OfflineRunner()
+    pools = [
+        ms.DevicePool("healthy", target, runner=ms.runner.LocalRunner()),
+        ms.DevicePool("offline", target, runner=offline),
+    ]
+    with tempfile.TemporaryDirectory() as work_dir:
+        database = ms.tune_distributed(
+            tasks=[_task(target)],
+            task_weights=[1.0],
+            pools=pools,
+            work_dir=work_dir,
+            max_trials_per_target=8,
+            num_trials_per_iter=4,
+            max_failures=1,
+        )
+        assert not pools[1].online
+        assert offline.num_calls == 1
+        assert pools[0].online
+        assert 0 < pools[0].num_trials <= 8
+        assert 0 < len(database.get_all_tuning_records()) <= 8
+        assert database.query_schedule(matmul, target, "main") is not None
+
+
+def test_tune_distributed_missing_pool():
+    target = Target("llvm --num-cores=1")
+    with tempfile.TemporaryDirectory() as work_dir:
+        with pytest.raises(ValueError, match="No device pool"):
+            ms.tune_distributed(
+                tasks=[_task(target)],
+                task_weights=[1.0],
+                pools=[ms.DevicePool("cuda", "cuda", runner="local")],
+                work_dir=work_dir,
+                max_trials_per_target=8,
+            )
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -392,5 +392,32 @@ def test_mlp_with_tuple():
     tvm.ir.assert_structural_equal(mod, LoweredMLPWithTuple)
 
 
+def test_ring_attention():
+    @I.ir_module
+    class Attention:
+        I.module_attrs({"device_num": 10})
+        I.module_global_infos({"mesh": [R.device_mesh((4,), I.Range(0, 4))]})
+
+        @R.function
+        def foo(
+            q: R.DTensor((1, 256, 8, 64), "float16", "mesh[0]", "S[1]"),
+            k: R.DTensor((1, 256, 2, 64), "float16", "mesh[0]", "S[1]"),
+            v: R.DTensor((1, 256, 2, 64), "float16", "mesh[0]", "S[1]"),
+        ) -> R.DTensor((1, 256, 8, 64), "float16", "mesh[0]", "S[1]"):
+            gv: R.DTensor((1, 256, 8, 64), "float16", "mesh[0]", "S[1]") = R.dist.ring_attention(
+                q, k, v
+            )
+            return gv
+
+    mod = relax.distributed.transform.LowerDistIR()(Attention)
+    script = mod.script()
+    assert "ring_attention" not in script
+    # The blocks of key and value are passed on in all the steps but the last one.
+    assert script.count('"runtime.disco.ring_exchange"') == 2 * 3
+    assert_structural_equal(
+        mod["foo"].ret_struct_info, relax.TensorStructInfo((1, 64, 8, 64), "float16")
+    )
+
+
 if __name__ == "__main__":
     tvm.testing.main()
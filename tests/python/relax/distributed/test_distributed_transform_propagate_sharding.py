@@ -2017,5 +2017,43 @@ def test_decoder_layer_dynamic_shape():
     assert_structural_equal(after, ShardedLlamaAttentionLayerDynamicShape)
 
 
+def test_sequence_parallel_attention():
+    @I.ir_module
+    class Attention:
+        I.module_attrs({"device_num": 10})
+        I.module_global_infos({"mesh": [R.device_mesh((2,), I.Range(0, 2))]})
+
+        @R.function
+        def foo(
+            q: R.Tensor((1, 256, 8, 64), "float32"),
+            k: R.Tensor((1, 256, 8, 64), "float32"),
+            v: R.Tensor((1, 256, 8, 64), "float32"),
+        ) -> R.Tensor((1, 256, 8, 64), "float32"):
+            lv0 = R.dist.annotate_sharding(q, device_mesh="mesh[0]", placement="S[1]")
+            lv1 = R.dist.annotate_sharding(k, device_mesh="mesh[0]", placement="S[1]")
+            lv2 = R.dist.annotate_sharding(v, device_mesh="mesh[0]", placement="S[1]")
+            lv3 = R.nn.attention(lv0, lv1, lv2)
+            return lv3
+
+    @I.ir_module
+    class ShardedAttention:
+        I.module_attrs({"device_num": 10})
+        I.module_global_infos({"mesh": [R.device_mesh((2,), I.Range(0, 2))]})
+
+        @R.function
+        def foo(
+            q: R.DTensor((1, 256, 8, 64), "float32", "mesh[0]", "S[1]"),
+            k: R.DTensor((1, 256, 8, 64), "float32", "mesh[0]", "S[1]"),
+            v: R.DTensor((1, 256, 8, 64), "float32", "mesh[0]", "S[1]"),
+        ) -> R.DTensor((1, 256, 8, 64), "float32", "mesh[0]", "S[1]"):
+            lv3: R.DTensor((1, 256, 8, 64), "float32", "mesh[0]", "S[1]") = R.dist.ring_attention(
+                q, k, v
+            )
+            return lv3
+
+    after = relax.distributed.transform.PropagateSharding()(Attention)
+    assert_structural_equal(after, ShardedAttention)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -1380,5 +1380,37 @@ def test_incomplete_struct_info_must_be_consistent():
     assert not rx.analysis.well_formed(Module)
 
 
+def test_incremental_well_formed():
+    """The incremental checker re-checks the changed functions and their callers"""
+
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(A: R.Tensor([16], "float32")):
+            B = Module.helper(A)
+            return B
+
+        @R.function
+        def helper(A: R.Tensor([16], "float32")):
+            B = R.add(A, A)
+            return B
+
+    check = rx.analysis.incremental_well_formed()
+    assert check(Module)
+    assert check(Module)
+
+    # A changed function is re-checked.
+    func = build_function([rx.BindingBlock([rx.VarBinding(x, rx.op.add(x, x))])])
+    mod = Module.clone()
+    mod["foo"] = func
+    assert not check(mod)
+    assert not rx.analysis.well_formed(mod, check_struct_info=False)
+
+    # Removing a GlobalVar re-checks its callers, even though they did not change.
+    mod = tvm.IRModule({Module.get_global_var("main"): Module["main"]})
+    assert not check(mod)
+    assert not rx.analysis.well_formed(mod)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -0,0 +1,80 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the ahead-of-time build of Relax functions, which run without the VM."""
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import relax as R
+
+
+@tvm.script.ir_module
+class MLP:
+    @R.function
+    def main(
+        x: R.Tensor((4, 8), "float32"),
+        w0: R.Tensor((8, 16), "float32"),
+        w1: R.Tensor((16, 2), "float32"),
+    ):
+        with R.dataflow():
+            lv0 = R.matmul(x, w0)
+            lv1 = R.nn.relu(lv0)
+            lv2 = R.add(lv1, R.const(1.0, "float32"))
+            lv3 = R.matmul(lv2, w1)
+            gv = (lv3, lv1)
+            R.output(gv)
+        return gv
+
+
+def test_aot_build_mlp():
+    lib = relax.build_aot(MLP, "llvm")
+    x = np.random.rand(4, 8).astype("float32")
+    w0 = np.random.rand(8, 16).astype("float32") - 0.5
+    w1 = np.random.rand(16, 2).astype("float32")
+    out0 = tvm.nd.empty((4, 2), "float32")
+    out1 = tvm.nd.empty((4, 16), "float32")
+    lib["main"](tvm.nd.array(x), tvm.nd.array(w0), tvm.nd.array(w1), out0, out1)
+
+    hidden = np.maximum(x @ w0, 0)
+    tvm.testing.assert_allclose(out0.numpy(), (hidden + 1) @ w1, rtol=1e-5, atol=1e-5)
+    tvm.testing.assert_allclose(out1.numpy(), hidden, rtol=1e-5, atol=1e-5)
+
+    # The intermediate tensors live in a static arena, and the kernels are called by symbol.
+    codegen_mod = relax.get_pipeline("aot_build")(MLP)
+    main = relax._ffi_api.AOTTIRCodeGen(codegen_mod)["main"]  # type: ignore
+    script = main.script()
+    assert "aot_arena" in script
+    assert "tvm_call_cpacked" in script
+    assert "tvm_call_packed" not in script
+
+
+def test_aot_build_dynamic_shape():
+    @tvm.script.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor(("n",), "float32")):
+            y = R.add(x, x)
+            return y
+
+    with pytest.raises(ValueError, match="static shapes"):
+        relax.build_aot(Module, "llvm")
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
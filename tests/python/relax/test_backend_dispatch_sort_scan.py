@@ -370,6 +370,44 @@ def test_dispatch_topk_cuda():
     assert_structural_equal(mod, expected_mod)
 
 
+def test_dispatch_topk_cuda_radix():
+    target = tvm.target.Target("cuda -libs=thrust", host="llvm")
+    if not can_use_thrust(target, "tvm.contrib.thrust.radix_topk"):
+        pytest.skip("thrust is not enabled")
+
+    @I.ir_module
+    class Before:
+        I.module_global_infos({"vdevice": [I.vdevice("cuda")]})
+
+        @R.function
+        def foo(x: R.Tensor((2, 32000), "float32", "cuda")):
+            with R.dataflow():
+                lv = R.topk(x, k=8, axis=1, largest=True)
+                gv = lv
+                R.output(gv)
+            return gv
+
+    vdevices = [I.vdevice("cuda", 0)]
+    x = relax.Var("x", R.Tensor((2, 32000), "float32", vdevices[0]))
+    bb = relax.BlockBuilder()
+    with target:
+        with bb.function("foo", (x,), {"global_symbol": "foo"}):
+            with bb.dataflow():
+                out = bb.emit_te(
+                    topi.cuda.radix_topk_thrust, x, k=8, axis=1, is_ascend=False, dtype="int32"
+                )
+                out = bb.emit_output(out)
+            bb.emit_func_output(out)
+    expected_mod = bb.finalize()
+    expected_mod.update_global_info("vdevice", vdevices)
+
+    with target:
+        mod = DispatchSortScan()(Before)
+        expected_mod = dlight.ApplyDefaultSchedule(dlight.gpu.Fallback())(expected_mod)
+
+    assert_structural_equal(mod, expected_mod)
+
+
 def test_dispatch_topk_gpu():
     @I.ir_module
     class Before:
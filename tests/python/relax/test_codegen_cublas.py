@@ -21,6 +21,7 @@ import tvm
 import tvm.testing
 import tvm.topi.testing
 from tvm import relax
+from tvm.contrib import cublaslt
 from tvm.relax.backend.contrib.cublas import partition_for_cublas
 from tvm.relax.testing import get_relax_matmul_module
 from tvm.script import relax as R
@@ -512,5 +513,28 @@ def test_cublas_matmul_cuda_graph():
     tvm.testing.assert_allclose(out, ref, rtol=1e-2, atol=1e-2)
 
 
+def test_cublas_matmul_autotune(tmp_path):
+    path = str(tmp_path / "cublaslt_algos.txt")
+    # Shapes not used by the other tests, as the algorithm of a matmul is chosen on its first call.
+    x = np.random.randn(24, 40).astype("float16")
+    y = np.random.randn(40, 56).astype("float16")
+    mod = get_relax_matmul_module((24, 40), (40, 56), "float16", "float16")
+
+    cublaslt.autotune(top_n=4, path=path)
+    try:
+        out = get_result_with_relax_cublas_offload(mod, (x, y))
+        out_again = get_result_with_relax_cublas_offload(mod, (x, y))
+    finally:
+        cublaslt.autotune(top_n=0)
+    ref = build_and_run(mod, (x, y), "llvm", legalize=True)
+    tvm.testing.assert_allclose(out, ref, rtol=1e-2, atol=1e-2)
+    tvm.testing.assert_allclose(out_again, ref, rtol=1e-2, atol=1e-2)
+
+    with open(path) as f:
+        records = f.read().splitlines()
+    assert len(records) == 1
+    assert len(records[0].split()) == 9
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -452,6 +452,25 @@ def test_matmul_with_3d_bias_offload():
     tvm.testing.assert_allclose(out, ref, rtol=1e-2, atol=1e-2)
 
 
+def test_matmul_dynamic_m_buckets():
+    m = tvm.tir.Var("m", "int64")
+    mod = get_relax_matmul_module((m, 64), (64, 128), "float16", transposed_y=False)
+    mod = partition_for_cutlass(mod)
+    options = {"sm": 80, "find_first_valid": True, "dynamic_m_buckets": [16, 256]}
+    mod = relax.transform.RunCodegen({"cutlass": options})(mod)
+    with tvm.transform.PassContext(config={"relax.transform.apply_legalize_ops": True}):
+        ex = relax.build(mod, "cuda")
+    vm = relax.VirtualMachine(ex, tvm.cuda(0))
+
+    # One M in each bucket, and one above the largest bucket.
+    for m_value in [4, 100, 300]:
+        x = np.random.randn(m_value, 64).astype("float16")
+        y = np.random.randn(64, 128).astype("float16")
+        out = vm["main"](tvm.nd.array(x, tvm.cuda(0)), tvm.nd.array(y, tvm.cuda(0))).numpy()
+        ref = x.astype("float32") @ y.astype("float32")
+        tvm.testing.assert_allclose(out, ref, rtol=1e-2, atol=1e-2)
+
+
 @pytest.mark.parametrize(
     "x_shape, y_shape, expected",
     [
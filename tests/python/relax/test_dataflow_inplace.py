@@ -640,5 +640,115 @@ def test_dynamic_mismatch():
     tvm.ir.assert_structural_equal(new_mod, DynamicMistmatchTestCase)
 
 
+def test_donated_param():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor((2, 3), dtype="float32"), y: R.Tensor((1, 3), dtype="float32")
+        ) -> R.Tensor((2, 3), dtype="float32"):
+            R.func_attr({"relax.donated_params": [0]})
+            with R.dataflow():
+                # x is donated and not used after this call, y is still used later
+                z = R.add(x, y)
+                R.output(z)
+            return z
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func(private=True)
+        def add_inplace(
+            A: T.Buffer((T.int64(2), T.int64(3)), "float32"),
+            B: T.Buffer((T.int64(1), T.int64(3)), "float32"),
+        ):
+            T.func_attr({"tir.noalias": T.bool(True)})
+            for ax0, ax1 in T.grid(T.int64(2), T.int64(3)):
+                with T.block("T_add"):
+                    v_ax0, v_ax1 = T.axis.remap("SS", [ax0, ax1])
+                    T.reads(A[v_ax0, v_ax1], B[T.int64(0), v_ax1])
+                    T.writes(A[v_ax0, v_ax1])
+                    A[v_ax0, v_ax1] = A[v_ax0, v_ax1] + B[T.int64(0), v_ax1]
+
+        @R.function
+        def main(
+            x: R.Tensor((2, 3), dtype="float32"), y: R.Tensor((1, 3), dtype="float32")
+        ) -> R.Tensor((2, 3), dtype="float32"):
+            R.func_attr({"relax.donated_params": [0]})
+            cls = Expected
+            with R.dataflow():
+                z = R.call_tir_inplace(
+                    cls.add_inplace,
+                    (x, y),
+                    inplace_indices=[0],
+                    out_sinfo=R.Tensor((2, 3), dtype="float32"),
+                )
+                R.output(z)
+            return z
+
+    after = DataflowUseInplaceCalls()(Before)
+    tvm.ir.assert_structural_equal(after, Expected)
+
+
+def test_donated_param_used_after_block():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor((2, 3), dtype="float32"),
+            y: R.Tensor((2, 3), dtype="float32"),
+            cond: R.Tensor((), dtype="bool"),
+        ) -> R.Tensor((2, 3), dtype="float32"):
+            R.func_attr({"relax.donated_params": [0, 1]})
+            with R.dataflow():
+                z = R.add(x, y)
+                R.output(z)
+            if cond:
+                # x is read in a branch, so it must be kept
+                w = R.multiply(z, x)
+            else:
+                w = z
+            return w
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func(private=True)
+        def add_inplace(
+            A: T.Buffer((T.int64(2), T.int64(3)), "float32"),
+            B: T.Buffer((T.int64(2), T.int64(3)), "float32"),
+        ):
+            T.func_attr({"tir.noalias": T.bool(True)})
+            for ax0, ax1 in T.grid(T.int64(2), T.int64(3)):
+                with T.block("T_add"):
+                    v_ax0, v_ax1 = T.axis.remap("SS", [ax0, ax1])
+                    T.reads(A[v_ax0, v_ax1], B[v_ax0, v_ax1])
+                    T.writes(B[v_ax0, v_ax1])
+                    B[v_ax0, v_ax1] = A[v_ax0, v_ax1] + B[v_ax0, v_ax1]
+
+        @R.function
+        def main(
+            x: R.Tensor((2, 3), dtype="float32"),
+            y: R.Tensor((2, 3), dtype="float32"),
+            cond: R.Tensor((), dtype="bool"),
+        ) -> R.Tensor((2, 3), dtype="float32"):
+            R.func_attr({"relax.donated_params": [0, 1]})
+            cls = Expected
+            with R.dataflow():
+                z = R.call_tir_inplace(
+                    cls.add_inplace,
+                    (x, y),
+                    inplace_indices=[1],
+                    out_sinfo=R.Tensor((2, 3), dtype="float32"),
+                )
+                R.output(z)
+            if cond:
+                w = R.multiply(z, x)
+            else:
+                w = z
+            return w
+
+    after = DataflowUseInplaceCalls()(Before)
+    tvm.ir.assert_structural_equal(after, Expected)
+
+
 if __name__ == "__main__":
     testing.main()
@@ -1207,5 +1207,51 @@ def test_sort_argsort_topk():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+def test_moe_dispatch_combine():
+    from tvm.relax.frontend.nn.llm import moe  # pylint: disable=import-outside-toplevel
+
+    num_tokens, top_k, num_experts, capacity, hidden, out_features = 6, 2, 4, 2, 8, 5
+
+    class Model(Module):
+        def test(self, x: Tensor, indices: Tensor, weights: Tensor, w: Tensor):
+            slots = moe.moe_dispatch_slots(indices, num_experts, capacity)
+            dispatched = moe.moe_dispatch(x, indices, slots, num_experts, capacity)
+            results = moe.moe_expert_gemm(dispatched, w)
+            return moe.moe_combine(results, indices, weights, slots), slots
+
+    mod, _ = Model().export_tvm(
+        spec={
+            "test": {
+                "x": spec.Tensor([num_tokens, hidden], "float32"),
+                "indices": spec.Tensor([num_tokens, top_k], "int32"),
+                "weights": spec.Tensor([num_tokens, top_k], "float32"),
+                "w": spec.Tensor([num_experts, out_features, hidden], "float32"),
+            }
+        }
+    )
+    ex = relax.build(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    x = np.random.rand(num_tokens, hidden).astype("float32")
+    indices = np.array([[0, 1], [0, 2], [0, 1], [3, 0], [1, 2], [2, 3]], dtype="int32")
+    weights = np.random.rand(num_tokens, top_k).astype("float32")
+    w = np.random.rand(num_experts, out_features, hidden).astype("float32")
+    out, slots = vm["test"](*[tvm.nd.array(a) for a in [x, indices, weights, w]])
+
+    # The first choices take the slots before the second ones.
+    expected_slots = np.full((num_tokens, top_k), -1, dtype="int32")
+    expected_out = np.zeros((num_tokens, out_features), dtype="float32")
+    counts = [0] * num_experts
+    for k in range(top_k):
+        for t in range(num_tokens):
+            e = indices[t, k]
+            if counts[e] < capacity:
+                expected_slots[t, k] = counts[e]
+                expected_out[t] += weights[t, k] * (w[e] @ x[t])
+            counts[e] += 1
+    tvm.testing.assert_allclose(slots.numpy(), expected_slots)
+    tvm.testing.assert_allclose(out.numpy(), expected_out, rtol=1e-5, atol=1e-5)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -103,5 +103,69 @@ def test_track_usage_across_trivial_rebindings_in_match_cast():
     tvm.ir.assert_structural_equal(Expected, After)
 
 
+def test_kill_unused_tensor():
+    """A tensor which is never used is killed right after its binding"""
+
+    @I.ir_module
+    class Before:
+        @R.function(pure=False)
+        def main(w: R.Tensor([16], "float32")):
+            x = R.add(w, R.const(1, "float32"))
+            unused = R.call_packed("make_tensor", x, sinfo_args=R.Tensor([16], "float32"))
+            z = R.add(x, R.const(1, "float32"))
+            return z
+
+    @I.ir_module
+    class Expected:
+        @R.function(pure=False)
+        def main(w: R.Tensor([16], "float32")):
+            x = R.add(w, R.const(1, "float32"))
+            unused = R.call_packed("make_tensor", x, sinfo_args=R.Tensor([16], "float32"))
+            _ = R.memory.kill_tensor(unused)
+            z = R.add(x, R.const(1, "float32"))
+            _ = R.memory.kill_tensor(x)
+            return z
+
+    After = KillAfterLastUse()(Before)
+    tvm.ir.assert_structural_equal(Expected, After)
+
+
+def test_kill_after_branch():
+    """A tensor last used in a branch is killed after the If, and the
+    bindings after the If are still killed after their last usage"""
+
+    @I.ir_module
+    class Before:
+        @R.function(pure=False)
+        def main(w: R.Tensor([16], "float32"), cond: R.Prim("bool")):
+            x = R.add(w, R.const(1, "float32"))
+            if cond:
+                y = R.add(x, x)
+            else:
+                y = R.multiply(x, x)
+            z = R.add(y, y)
+            out = R.add(z, z)
+            return out
+
+    @I.ir_module
+    class Expected:
+        @R.function(pure=False)
+        def main(w: R.Tensor([16], "float32"), cond: R.Prim("bool")):
+            x = R.add(w, R.const(1, "float32"))
+            if cond:
+                y = R.add(x, x)
+            else:
+                y = R.multiply(x, x)
+            _ = R.memory.kill_tensor(x)
+            z = R.add(y, y)
+            _ = R.memory.kill_tensor(y)
+            out = R.add(z, z)
+            _ = R.memory.kill_tensor(z)
+            return out
+
+    After = KillAfterLastUse()(Before)
+    tvm.ir.assert_structural_equal(Expected, After)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -28,6 +28,7 @@ def test_op_correctness():
     assert relax.op.ccl.allreduce(x).op == Op.get("relax.ccl.allreduce")
     assert relax.op.ccl.broadcast_from_worker0(x).op == Op.get("relax.ccl.broadcast_from_worker0")
     assert relax.op.ccl.allgather(x, 2).op == Op.get("relax.ccl.allgather")
+    assert relax.op.ccl.alltoall(x, 2).op == Op.get("relax.ccl.alltoall")
 
 
 def _check_inference(bb: relax.BlockBuilder, call: relax.Call, expected_sinfo: relax.StructInfo):
@@ -141,6 +142,29 @@ def test_allgather_infer_struct_info_more_input_dtype():
     _check_inference(bb, relax.op.ccl.allgather(x2, 2), relax.TensorStructInfo((4, 3), "int64"))
 
 
+def test_alltoall_infer_struct_info():
+    bb = relax.BlockBuilder()
+    m = tir.Var("m", "int64")
+    x0 = relax.Var("x", R.Tensor((4, 3), "float32"))
+    x1 = relax.Var("x", R.Tensor((m, 3), "float16"))
+    x2 = relax.Var("x", R.Tensor("float32", ndim=-1))
+
+    _check_inference(bb, relax.op.ccl.alltoall(x0, 2), relax.TensorStructInfo((4, 3), "float32"))
+    _check_inference(bb, relax.op.ccl.alltoall(x1, 2), relax.TensorStructInfo((m, 3), "float16"))
+    _check_inference(bb, relax.op.ccl.alltoall(x2, 2), relax.TensorStructInfo(dtype="float32"))
+
+
+def test_alltoall_infer_struct_info_indivisible():
+    bb = relax.BlockBuilder()
+    x0 = relax.Var("x", R.Tensor((3, 4), "float32"))
+    x1 = relax.Var("x", R.Tensor((), "float32"))
+
+    with pytest.raises(TVMError):
+        bb.normalize(relax.op.ccl.alltoall(x0, 2))
+    with pytest.raises(TVMError):
+        bb.normalize(relax.op.ccl.alltoall(x1, 2))
+
+
 def test_broadcast_from_worker0_infer_struct_info():
     bb = relax.BlockBuilder()
     x0 = relax.Var("x", R.Tensor((2, 3), "float32"))
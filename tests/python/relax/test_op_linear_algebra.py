@@ -337,5 +337,42 @@ def test_einsum_infer_struct_info_wrong_inputs():
         bb.normalize(relax.op.einsum(x1, subscripts="ijk"))
 
 
+def test_bsr_matmul_infer_struct_info():
+    bb = relax.BlockBuilder()
+    x = relax.Var("x", R.Tensor((8, 32), "float16"))
+    data = relax.Var("data", R.Tensor((5, 16, 1), "float16"))
+    indices = relax.Var("indices", R.Tensor((5,), "int32"))
+    indptr = relax.Var("indptr", R.Tensor((5,), "int32"))
+    findices = relax.Var("indices", R.Tensor((5,), "float32"))
+
+    _check_inference(
+        bb,
+        relax.op.bsr_matmul(x, data, indices, indptr),
+        relax.TensorStructInfo((8, 64), "float16"),
+    )
+    with pytest.raises(TVMError):
+        bb.normalize(relax.op.bsr_matmul(x, data, findices, indptr))
+    with pytest.raises(TVMError):
+        bb.normalize(relax.op.bsr_matmul(x, indices, indices, indptr))
+
+
+def test_structured_sparse_matmul_infer_struct_info():
+    bb = relax.BlockBuilder()
+    x0 = relax.Var("x", R.Tensor((2, 8, 32), "float16"))
+    x1 = relax.Var("x", R.Tensor((8, 30), "float16"))
+    values = relax.Var("values", R.Tensor((64, 16), "float16"))
+    indices = relax.Var("indices", R.Tensor((64, 16), "uint8"))
+
+    _check_inference(
+        bb,
+        relax.op.structured_sparse_matmul(x0, values, indices),
+        relax.TensorStructInfo((2, 8, 64), "float16"),
+    )
+    with pytest.raises(TVMError):
+        bb.normalize(relax.op.structured_sparse_matmul(x1, values, indices))
+    with pytest.raises(TVMError):
+        bb.normalize(relax.op.structured_sparse_matmul(x0, values, values))
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -213,6 +213,90 @@ def test_ndarray_cache_update():
         np.testing.assert_allclose(v.numpy(), v_np, atol=1e-6, rtol=1e-6)
 
 
+def test_ndarray_cache_load_mapped():
+    fload = tvm.get_global_func("vm.builtin.ndarray_cache.load_mapped")
+    fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
+
+    param_dict = {
+        "x_0": np.array([1, 2, 3], dtype="int32"),
+        "x_1": np.random.uniform(size=[10, 20]).astype("float32"),
+        "x_2": np.random.uniform(size=[7]).astype("float16"),
+    }
+
+    temp = utils.tempdir()
+    tvmjs.dump_ndarray_cache(param_dict, temp.path, encode_format="raw")
+    fload(str(temp.path))
+    res = fget_params("x", -1)
+    assert len(res) == len(param_dict)
+    for i, v in enumerate(res):
+        assert v.device == tvm.cpu()
+        np.testing.assert_equal(v.numpy(), param_dict[f"x_{i}"])
+
+
+def test_ndarray_cache_shared():
+    fload = tvm.get_global_func("vm.builtin.ndarray_cache.load")
+    fclear = tvm.get_global_func("vm.builtin.ndarray_cache.clear")
+    fnum_shared = tvm.get_global_func("vm.builtin.ndarray_cache.num_shared")
+    fget_params = tvm.get_global_func("vm.builtin.param_array_from_cache")
+
+    base = np.random.uniform(size=[10, 20]).astype("float32")
+    variant_a = {"a_0": base, "a_1": np.random.uniform(size=[4]).astype("float32")}
+    variant_b = {"b_0": base.copy(), "b_1": np.random.uniform(size=[4]).astype("float32")}
+
+    fclear()
+    temp = utils.tempdir()
+    tvmjs.dump_ndarray_cache(variant_a, temp.relpath("a"), encode_format="raw")
+    tvmjs.dump_ndarray_cache(variant_b, temp.relpath("b"), encode_format="raw")
+    fload(temp.relpath("a"), tvm.cpu().device_type, 0)
+    assert fnum_shared() == 0
+    fload(temp.relpath("b"), tvm.cpu().device_type, 0)
+    # Only the identical base tensor is shared.
+    assert fnum_shared() == 1
+    for prefix, params in [("a", variant_a), ("b", variant_b)]:
+        res = fget_params(prefix, -1)
+        for i, v in enumerate(res):
+            np.testing.assert_equal(v.numpy(), params[f"{prefix}_{i}"])
+    fclear()
+
+
+def test_batch_sample_from_logits():
+    fsample = tvm.get_global_func("vm.builtin.batch_sample_from_logits")
+    batch_size, vocab_size = 4, 1000
+    logits_np = np.random.uniform(-5, 5, size=(batch_size, vocab_size)).astype("float32")
+    # Make the second largest logit of each row clearly smaller than the largest one.
+    argmax = np.argmax(logits_np, axis=1)
+    logits_np[np.arange(batch_size), argmax] = 20.0
+    temperature = np.array([0.0, 1.0, 1.0, 1.0], dtype="float32")
+    top_p = np.array([1.0, 1.0, 0.5, 1.0], dtype="float32")
+    top_k = np.array([0, 1, 0, 2], dtype="int32")
+    uniform = np.array([0.5, 0.5, 0.99, 0.0], dtype="float32")
+
+    res = fsample(
+        tvm.nd.array(logits_np),
+        tvm.nd.array(temperature),
+        tvm.nd.array(top_p),
+        tvm.nd.array(top_k),
+        tvm.nd.array(uniform),
+    ).numpy()
+    # Greedy, top-k of 1, and a top-p covered by the max token all pick the argmax.
+    np.testing.assert_equal(res[:3], argmax[:3])
+    # A zero uniform sample picks the most likely candidate.
+    assert res[3] == argmax[3]
+
+    # With top-k of 2 and a large uniform sample, the second most likely token is picked.
+    logits_np[3] = -10.0
+    logits_np[3, [7, 11]] = [1.0, 0.5]
+    uniform[3] = 0.99
+    res = fsample(
+        tvm.nd.array(logits_np),
+        tvm.nd.array(temperature),
+        tvm.nd.array(top_p),
+        tvm.nd.array(top_k),
+        tvm.nd.array(uniform),
+    ).numpy()
+    assert res[3] == 11
+
+
 def test_attention_kv_cache_window_override():
     fcreate = tvm.get_global_func("vm.builtin.attention_kv_cache_create")
     foverride = tvm.get_global_func("vm.builtin.attention_kv_cache_window_override")
@@ -283,5 +367,35 @@ def test_attention_kv_cache_window_override_with_sinks():
     ).all()
 
 
+def test_attention_kv_cache_ring():
+    fcreate = tvm.get_global_func("vm.builtin.attention_kv_cache_create_ring")
+    fappend = tvm.get_global_func("vm.builtin.attention_kv_cache_append")
+    fview = tvm.get_global_func("vm.builtin.attention_kv_cache_view")
+    fsegments = tvm.get_global_func("vm.builtin.attention_kv_cache_view_segments")
+
+    num_attention_sinks = 2
+    cache = fcreate(
+        tvm.nd.array(np.zeros((0, 2)).astype("int32")),
+        tvm.runtime.ShapeTuple([16, 2]),
+        -1,
+        num_attention_sinks,
+    )
+    np_all_arrays = np.zeros((0, 2)).astype("int32")
+    for i, num in enumerate([3, 1, 5, 4, 7, 2, 9, 14, 1]):
+        np_array = np.arange(i * 100, i * 100 + num * 2).reshape((num, 2)).astype("int32")
+        np_all_arrays = np.concatenate((np_all_arrays, np_array), axis=0)
+        cache = fappend(cache, tvm.nd.array(np_array))
+
+        expected = np_all_arrays
+        if len(expected) > 16:
+            expected = np.concatenate(
+                (expected[:num_attention_sinks], expected[-16 + num_attention_sinks :])
+            )
+        segments = [segment.numpy() for segment in fsegments(cache)]
+        np.testing.assert_equal(np.concatenate(segments), expected)
+        # The whole cache is the rotated ring, whatever the number of segments.
+        assert fview(cache).numpy().shape == (len(expected), 2)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -63,9 +63,19 @@ fpopn = None
 fbegin_forward = None
 fend_forward = None
 fcommit_accepted_token_tree_nodes = None
+fcommit_accepted_token_tree_nodes_deferred = None
 fattention_with_fuse_qkv = None
 fis_empty = None
 fdebug_get_kv = None
+fadd_sequence_with_prefix_cache = None
+finsert_prefix_cache = None
+foffload_sequence = None
+fprefetch_sequence = None
+fget_num_available_pages = None
+fset_sequence_tenant = None
+fset_tenant_page_quota = None
+fget_tenant_num_pages = None
+fget_eviction_candidates = None
 
 ftranspose_append = None
 fcopy_cache = None
@@ -86,7 +96,12 @@ fcompact_copy = None
 def set_global_func(head_dim, dtype):
     global fclear, fadd_sequence, fremove_sequence, ffork_sequence, fenable_sliding_window_for_seq
     global fpopn, fbegin_forward, fend_forward, fcommit_accepted_token_tree_nodes
+    global fcommit_accepted_token_tree_nodes_deferred
     global fattention_with_fuse_qkv, fis_empty, fdebug_get_kv
+    global fadd_sequence_with_prefix_cache, finsert_prefix_cache
+    global foffload_sequence, fprefetch_sequence, fget_num_available_pages
+    global fset_sequence_tenant, fset_tenant_page_quota, fget_tenant_num_pages
+    global fget_eviction_candidates
     global ftranspose_append, fcopy_cache, fattn_prefill, fattn_decode
     global fattn_prefill_ragged, fattn_prefill_with_tree_mask, fattn_prefill_with_tree_mask_paged_kv_cache
     global fattn_prefill_sliding_window, fattn_decode_sliding_window
@@ -105,11 +120,33 @@ def set_global_func(head_dim, dtype):
     fcommit_accepted_token_tree_nodes = tvm.get_global_func(
         "vm.builtin.attention_kv_cache_commit_accepted_token_tree_nodes"
     )
+    fcommit_accepted_token_tree_nodes_deferred = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_commit_accepted_token_tree_nodes_deferred"
+    )
     fattention_with_fuse_qkv = tvm.get_global_func(
         "vm.builtin.attention_kv_cache_attention_with_fused_qkv"
     )
     fis_empty = tvm.get_global_func("vm.builtin.attention_kv_cache_empty")
     fdebug_get_kv = tvm.get_global_func("vm.builtin.attention_kv_cache_debug_get_kv")
+    fadd_sequence_with_prefix_cache = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_add_sequence_with_prefix_cache"
+    )
+    finsert_prefix_cache = tvm.get_global_func("vm.builtin.attention_kv_cache_insert_prefix_cache")
+    foffload_sequence = tvm.get_global_func("vm.builtin.attention_kv_cache_offload_sequence")
+    fprefetch_sequence = tvm.get_global_func("vm.builtin.attention_kv_cache_prefetch_sequence")
+    fget_num_available_pages = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_get_num_available_pages"
+    )
+    fset_sequence_tenant = tvm.get_global_func("vm.builtin.attention_kv_cache_set_sequence_tenant")
+    fset_tenant_page_quota = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_set_tenant_page_quota"
+    )
+    fget_tenant_num_pages = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_get_tenant_num_pages"
+    )
+    fget_eviction_candidates = tvm.get_global_func(
+        "vm.builtin.attention_kv_cache_get_eviction_candidates"
+    )
 
     target = tvm.target.Target.from_device(device)
     builts = []
@@ -278,6 +315,7 @@ def apply_attention(
     attn_sink_sizes: Optional[List[int]] = None,
     token_tree_parent_ptr_list: Optional[List[List[int]]] = None,
     accepted_leaf_indices: Optional[List[int]] = None,
+    defer_commit: bool = False,
 ) -> None:
     seq_ids = []
     append_lengths = []
@@ -477,9 +515,12 @@ def apply_attention(
 
     if accepted_leaf_indices is not None:
         seq_ids = [seq_id for seq_id, _ in batch]
-        fcommit_accepted_token_tree_nodes(
-            kv_cache, ShapeTuple(seq_ids), ShapeTuple(accepted_leaf_indices)
+        fcommit = (
+            fcommit_accepted_token_tree_nodes_deferred
+            if defer_commit
+            else fcommit_accepted_token_tree_nodes
         )
+        fcommit(kv_cache, ShapeTuple(seq_ids), ShapeTuple(accepted_leaf_indices))
         for i, (accepted_leaf_idx, (seq_id, append_length)) in enumerate(
             zip(accepted_leaf_indices, batch)
         ):
@@ -530,8 +571,10 @@ def apply_attention(
                 )
                 assert cached_k[seq_id].shape[1] == sliding_window_size
 
-    # Verify
-    verify_cached_kv(kv_cache, seq_ids, cached_k, cached_v)
+    # Verify. Reading the KV data would launch the deferred compaction copies,
+    # which are checked by the attention of the next forward instead.
+    if not defer_commit:
+        verify_cached_kv(kv_cache, seq_ids, cached_k, cached_v)
 
 
 @tvm.testing.requires_gpu
@@ -552,6 +595,9 @@ def test_paged_attention_kv_cache_prefill_and_decode(kv_cache_and_config):
     operation_seq += [[(0, 1), (1, 1), (2, 1), (3, 1), (4, 1), (5, 1), (6, 1), (7, 1), (8, 1)]]
     operation_seq += [[(0, 1), (2, 1), (4, 1), (6, 1), (8, 1)]]
     operation_seq += [[(4, 1), (5, 1), (6, 1), (7, 1), (8, 1)]]
+    # Mixed decode and chunked prefill, with the decode sequences first
+    operation_seq += [[(0, 1), (1, 1), (2, 17)], [(3, 1), (4, 1), (5, 1), (9, 40), (6, 3)]]
+    operation_seq += [[((10, 0, -1), 1), (1, 1), (9, 9)], [(10, 1), (0, 1), (4, 1), (2, 1)]]
 
     cached_k = {}
     cached_v = {}
@@ -664,6 +710,164 @@ def test_paged_attention_kv_cache_fork_sequence(kv_cache_and_config):
     apply_attention(kv_cache, rope_mode, [(10, 1), (12, 1)], cached_k, cached_v)
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_prefix_cache(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    rng = np.random.default_rng(0)
+    prompt = [int(token) for token in rng.integers(0, 32000, size=40)]
+    apply_attention(kv_cache, rope_mode, [(0, 40)], cached_k, cached_v)
+    finsert_prefix_cache(kv_cache, 0, ShapeTuple(prompt))
+    # The retained KV data outlives the sequence it was inserted from.
+    fremove_sequence(kv_cache, 0)
+    assert not fis_empty(kv_cache)
+
+    # Match a page-aligned prefix, a prefix ending inside a page, the full prompt and nothing.
+    prompts = [prompt[:32] + [7] * 10, prompt[:21] + [7] * 10, prompt, [7] * 10]
+    expected_match_lengths = [32, 21, 39, 0]
+    for seq_id, (token_ids, expected) in enumerate(zip(prompts, expected_match_lengths), 1):
+        match_length = fadd_sequence_with_prefix_cache(kv_cache, seq_id, ShapeTuple(token_ids))
+        assert match_length == expected
+        cached_k[seq_id] = cached_k[0][:, :match_length]
+        cached_v[seq_id] = cached_v[0][:, :match_length]
+    apply_attention(kv_cache, rope_mode, [(1, 10), (2, 10), (3, 1), (4, 10)], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, [(1, 1), (2, 1), (3, 1), (4, 1)], cached_k, cached_v)
+    verify_cached_kv(kv_cache, [1, 2, 3, 4], cached_k, cached_v)
+
+    for seq_id in range(1, 5):
+        fremove_sequence(kv_cache, seq_id)
+    fclear(kv_cache)
+    assert fis_empty(kv_cache)
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_offload(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    apply_attention(kv_cache, rope_mode, [(0, 40), (1, 27)], cached_k, cached_v)
+    apply_attention(kv_cache, rope_mode, [((2, 0, 32), 5)], cached_k, cached_v)
+    # 0 and 2 share the first two pages, which stay resident.
+    num_available_pages = fget_num_available_pages(kv_cache)
+    foffload_sequence(kv_cache, 0)
+    foffload_sequence(kv_cache, 1)
+    assert fget_num_available_pages(kv_cache) == num_available_pages + 3
+    apply_attention(kv_cache, rope_mode, [(2, 1)], cached_k, cached_v)
+
+    # Offloaded sequences are brought back on use.
+    fprefetch_sequence(kv_cache, 1)
+    apply_attention(kv_cache, rope_mode, [(0, 1), (1, 1), (2, 1)], cached_k, cached_v)
+    verify_cached_kv(kv_cache, [0, 1, 2], cached_k, cached_v)
+    foffload_sequence(kv_cache, 2)
+    verify_cached_kv(kv_cache, [0, 1, 2], cached_k, cached_v)
+
+    for seq_id in range(3):
+        fremove_sequence(kv_cache, seq_id)
+    assert fis_empty(kv_cache), "The KV cache is not empty after removing all sequences"
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_tenant_quota(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window and rope_mode == RopeMode.NORMAL:
+        # Normal RoPE mode under sliding window settings is not supported.
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    for seq_id, tenant_id in [(0, 1), (1, 2), (2, 2)]:
+        fadd_sequence(kv_cache, seq_id)
+        fset_sequence_tenant(kv_cache, seq_id, tenant_id, 0)
+        cached_k[seq_id] = np.zeros((num_layers, 0, num_kv_heads, head_dim), dtype)
+        cached_v[seq_id] = np.zeros((num_layers, 0, num_kv_heads, head_dim), dtype)
+    fset_tenant_page_quota(kv_cache, 1, 2, 3)
+    apply_attention(kv_cache, rope_mode, [(0, 40), (1, 20), (2, 5)], cached_k, cached_v)
+    assert fget_tenant_num_pages(kv_cache, 1) == 3
+    assert fget_tenant_num_pages(kv_cache, 2) == 3
+
+    # Tenant 1 is over its soft limit, then the least recently used sequences come first.
+    assert list(fget_eviction_candidates(kv_cache, 3)) == [0, 1, 2]
+    apply_attention(kv_cache, rope_mode, [(1, 1)], cached_k, cached_v)
+    assert list(fget_eviction_candidates(kv_cache, 3)) == [0, 2, 1]
+    fset_sequence_tenant(kv_cache, 2, 2, 1)
+    assert list(fget_eviction_candidates(kv_cache, 2)) == [0, 1]
+
+    # The batch exceeding the hard limit fails before any page is allocated.
+    with pytest.raises(tvm.TVMError):
+        fbegin_forward(kv_cache, ShapeTuple([0]), ShapeTuple([10]), None)
+    assert fget_tenant_num_pages(kv_cache, 1) == 3
+
+    # Preempting a sequence releases the pages of its tenant.
+    foffload_sequence(kv_cache, 1)
+    assert fget_tenant_num_pages(kv_cache, 2) == 1
+    apply_attention(kv_cache, rope_mode, [(1, 1), (2, 1)], cached_k, cached_v)
+    assert fget_tenant_num_pages(kv_cache, 2) == 3
+    fremove_sequence(kv_cache, 0)
+    assert fget_tenant_num_pages(kv_cache, 1) == 0
+    apply_attention(kv_cache, rope_mode, [(3, 10)], cached_k, cached_v)
+    verify_cached_kv(kv_cache, [1, 2, 3], cached_k, cached_v)
+
+    for seq_id in range(1, 4):
+        fremove_sequence(kv_cache, seq_id)
+    fset_tenant_page_quota(kv_cache, 1, -1, -1)
+    assert fis_empty(kv_cache), "The KV cache is not empty after removing all sequences"
+
+
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+@pytest.mark.parametrize("kv_dtype", ["int8", "e4m3_float8"])
+def test_paged_attention_kv_cache_quantized_pages(kv_dtype):
+    qkv_dtype = "float16"
+    d = 64
+    kv_scales = (0.05, 0.02)
+    target = tvm.target.Target.from_device(device)
+    builts = []
+    for tir_func in [
+        _kv_cache_transpose_append(num_kv_heads, d, qkv_dtype, kv_dtype, kv_scales),
+        _kv_cache_debug_get_kv(num_layers, num_kv_heads, d, qkv_dtype, kv_dtype, kv_scales),
+    ]:
+        mod = tvm.IRModule({"main": tir_func})
+        with target:
+            mod = dl.ApplyDefaultSchedule(dl.gpu.Fallback())(mod)
+        builts.append(tvm.build(mod["main"], target=target).entry_func)
+    ftranspose_append_q, fdebug_get_kv_q = builts
+
+    num_tokens = 40
+    num_pages = (num_tokens + page_size - 1) // page_size
+    position_map = np.random.permutation(num_pages * page_size)[:num_tokens].astype("int32")
+    k_np = np.random.uniform(-4, 4, (num_tokens, num_kv_heads, d)).astype(qkv_dtype)
+    v_np = np.random.uniform(-2, 2, (num_tokens, num_kv_heads, d)).astype(qkv_dtype)
+    pages = tvm.nd.empty((num_pages, 2, num_kv_heads, page_size, d), kv_dtype, device=device)
+    position_map_nd = tvm.nd.array(position_map, device)
+    ftranspose_append_q(
+        pages, tvm.nd.array(k_np, device), tvm.nd.array(v_np, device), position_map_nd
+    )
+
+    k_out = tvm.nd.empty((num_layers, num_tokens, num_kv_heads, d), qkv_dtype, device=device)
+    v_out = tvm.nd.empty((num_layers, num_tokens, num_kv_heads, d), qkv_dtype, device=device)
+    fdebug_get_kv_q(pages, position_map_nd, k_out, v_out, 0)
+    # The quantization error is at most half a step for int8, and 1/16 relative for fp8.
+    for ref, out, scale in [(k_np, k_out, kv_scales[0]), (v_np, v_out, kv_scales[1])]:
+        tvm.testing.assert_allclose(
+            out.numpy()[0].astype("float32"), ref.astype("float32"), rtol=0.07, atol=scale
+        )
+
+
 @tvm.testing.requires_gpu
 @tvm.testing.requires_cuda
 def test_paged_attention_kv_cache_unlimited_depth(kv_cache_and_config):
@@ -951,6 +1155,37 @@ def test_paged_attention_kv_cache_tree_attn(kv_cache_and_config):
         )
 
 
+@tvm.testing.requires_gpu
+@tvm.testing.requires_cuda
+def test_paged_attention_kv_cache_tree_attn_deferred_commit(kv_cache_and_config):
+    kv_cache, rope_mode, support_sliding_window = kv_cache_and_config
+    if support_sliding_window or rope_mode == RopeMode.INLINE:
+        return
+    fclear(kv_cache)
+
+    cached_k = {}
+    cached_v = {}
+    # Prefill 4 sequences
+    apply_attention(kv_cache, rope_mode, [(0, 10), (1, 20), (2, 30), (3, 40)], cached_k, cached_v)
+    # Rounds of tree decode, each compacting the accepted nodes of the last round
+    # in the attention of its layers.
+    num_seq = 4
+    parent_ptr = [-1, 0, 0, 1, 1, 2, 2]
+    for accepted_leaf_indices in [[6, 4, -1, 3], [3, 5, 6, 0], [5, 6, 4, 2]]:
+        apply_attention(
+            kv_cache,
+            rope_mode,
+            [(seq_id, len(parent_ptr)) for seq_id in range(num_seq)],
+            cached_k,
+            cached_v,
+            token_tree_parent_ptr_list=[parent_ptr for _ in range(num_seq)],
+            accepted_leaf_indices=accepted_leaf_indices,
+            defer_commit=True,
+        )
+    # The decode checks the compacted KV data of the last commit.
+    apply_attention(kv_cache, rope_mode, [(0, 1), (1, 1), (2, 1), (3, 1)], cached_k, cached_v)
+
+
 if __name__ == "__main__":
     HEAD_DIMS = [64, 128]
     DTYPES = ["float16", "float32"]
@@ -965,7 +1200,13 @@ if __name__ == "__main__":
         test_paged_attention_kv_cache_prefill_and_decode(cache_and_config)
         test_paged_attention_kv_cache_remove_sequence(cache_and_config)
         test_paged_attention_kv_cache_fork_sequence(cache_and_config)
+        test_paged_attention_kv_cache_prefix_cache(cache_and_config)
+        test_paged_attention_kv_cache_offload(cache_and_config)
+        test_paged_attention_kv_cache_tenant_quota(cache_and_config)
         test_paged_attention_kv_cache_popn(cache_and_config)
         test_paged_attention_kv_cache_sliding_window(cache_and_config)
         test_paged_attention_kv_cache_tree_attn(cache_and_config)
+        test_paged_attention_kv_cache_tree_attn_deferred_commit(cache_and_config)
         test_paged_attention_kv_cache_unlimited_depth(cache_and_config)
+    for kv_dtype in ["int8", "e4m3_float8"]:
+        test_paged_attention_kv_cache_quantized_pages(kv_dtype)
@@ -179,6 +179,32 @@ def test_rnn_state_fork_sequence(rnn_state):  # pylint: disable=redefined-outer-
     verify_state(state, [0, 1], [[np_two, np_three], [np_zero, np_one]])
 
 
+@tvm.testing.requires_cuda
+def test_rnn_state_fork_copy_on_write(rnn_state):  # pylint: disable=redefined-outer-name
+    state = rnn_state
+    f_clear(state)
+
+    f_add_sequence(state, 0)
+    f_fork_sequence(state, 0, 1, -1)
+    f_fork_sequence(state, 0, 2, -1)
+    # Forward one child: it moves to a copy of the shared slot, the others keep the initial state.
+    f_begin_forward(state, ShapeTuple([1]), ShapeTuple([1]))
+    f_set(state, 0, 0, tvm.nd.array(np_two.reshape(1, 16, 16), device=device))
+    f_set(state, 0, 1, tvm.nd.array(np_three.reshape(1, 32, 32), device=device))
+    f_end_forward(state)
+    verify_state(state, [0, 1, 2], [[np_zero, np_one], [np_two, np_three], [np_zero, np_one]])
+
+    # Once the parent is removed, the last sequence on the slot is forwarded in place.
+    f_remove_sequence(state, 0)
+    f_begin_forward(state, ShapeTuple([2, 1]), ShapeTuple([1, 1]))
+    f_set(state, 0, 0, tvm.nd.array(np.stack([np_two, np_zero]), device=device))
+    f_set(state, 0, 1, tvm.nd.array(np.stack([np_three, np_one]), device=device))
+    f_end_forward(state)
+    verify_state(state, [1, 2], {1: [np_zero, np_one], 2: [np_two, np_three]})
+    f_popn(state, 2, 1)
+    verify_state(state, [2], {2: [np_zero, np_one]})
+
+
 def rnn_state_get(
     shape: Sequence[int],
     dtype: str,
@@ -260,3 +286,4 @@ if __name__ == "__main__":
     test_rnn_state_set(rnn_state)
     test_rnn_state_popn(rnn_state)
     test_rnn_state_fork_sequence(rnn_state)
+    test_rnn_state_fork_copy_on_write(rnn_state)
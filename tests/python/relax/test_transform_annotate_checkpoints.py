@@ -0,0 +1,131 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Unit tests for choosing the checkpoints of the backward pass."""
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.ir.base import assert_structural_equal
+from tvm.script.parser import ir as I, relax as R
+
+
+# fmt: off
+@I.ir_module
+class MLP:
+    @R.function
+    def main(x: R.Tensor((4, 4), "float32"), w: R.Tensor((4, 4), "float32")):
+        with R.dataflow():
+            lv0 = R.matmul(x, w)
+            lv1 = R.nn.relu(lv0)
+            lv2 = R.matmul(lv1, w)
+            lv3 = R.nn.relu(lv2)
+            gv = R.sum(lv3)
+            R.output(gv)
+        return gv
+# fmt: on
+
+
+def test_sqrt():
+    # fmt: off
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((4, 4), "float32"), w: R.Tensor((4, 4), "float32")):
+            with R.dataflow():
+                x_scp = R.grad.start_checkpoint(x)
+                w_scp = R.grad.start_checkpoint(w)
+                lv0 = R.matmul(x_scp, w_scp)
+                lv0_ecp = R.grad.end_checkpoint(lv0)
+                lv1 = R.nn.relu(lv0_ecp)
+                lv1_scp = R.grad.start_checkpoint(lv1)
+                lv2 = R.matmul(lv1_scp, w_scp)
+                lv2_ecp = R.grad.end_checkpoint(lv2)
+                lv3 = R.nn.relu(lv2_ecp)
+                gv = R.sum(lv3)
+                R.output(gv)
+            return gv
+    # fmt: on
+
+    after = relax.transform.AnnotateCheckpoints("sqrt")(MLP)
+    assert_structural_equal(after, Expected)
+
+
+def test_budget_keeps_expensive_activations():
+    # fmt: off
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((4, 4), "float32"), w: R.Tensor((4, 4), "float32")):
+            with R.dataflow():
+                lv0 = R.matmul(x, w)
+                lv0_scp = R.grad.start_checkpoint(lv0)
+                lv1 = R.nn.relu(lv0_scp)
+                lv1_ecp = R.grad.end_checkpoint(lv1)
+                lv2 = R.matmul(lv1_ecp, w)
+                lv2_scp = R.grad.start_checkpoint(lv2)
+                lv3 = R.nn.relu(lv2_scp)
+                lv3_ecp = R.grad.end_checkpoint(lv3)
+                gv = R.sum(lv3_ecp)
+                R.output(gv)
+            return gv
+    # fmt: on
+
+    # The output takes 4 bytes, leaving room for two of the 64-byte activations. The matmuls
+    # are more expensive to recompute than the relus.
+    after = relax.transform.AnnotateCheckpoints("budget", memory_budget=132)(MLP)
+    assert_structural_equal(after, Expected)
+
+
+def test_gradient_recomputes_activations():
+    after = relax.transform.AnnotateCheckpoints("sqrt")(MLP)
+    after = relax.transform.Gradient("main")(after)
+    recomputed = [
+        binding.var.name_hint
+        for binding in after["main_adjoint"].body.blocks[0].bindings
+        if binding.var.name_hint.endswith("_cp")
+    ]
+    assert sorted(recomputed) == ["lv0_cp", "lv2_cp"]
+
+
+def test_user_checkpoints_are_kept():
+    # fmt: off
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor((4, 4), "float32")):
+            with R.dataflow():
+                x_scp = R.grad.start_checkpoint(x)
+                lv0 = R.nn.relu(x_scp)
+                lv1 = R.nn.relu(lv0)
+                lv1_ecp = R.grad.end_checkpoint(lv1)
+                gv = R.sum(lv1_ecp)
+                R.output(gv)
+            return gv
+    # fmt: on
+
+    after = relax.transform.AnnotateCheckpoints("sqrt")(Before)
+    assert_structural_equal(after, Before)
+
+
+def test_budget_is_required():
+    with pytest.raises(ValueError):
+        relax.transform.AnnotateCheckpoints("budget")
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
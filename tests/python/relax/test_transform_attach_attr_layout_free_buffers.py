@@ -307,5 +307,78 @@ def test_multiple_same_func_with_different_free_buffers():
     tvm.ir.assert_structural_equal(after, Expected)
 
 
+def test_weight_derived_value():
+    @I.ir_module
+    class Before:
+        @T.prim_func(private=True)
+        def transpose(
+            A: T.Buffer((T.int64(32), T.int64(32)), "float32"),
+            B: T.Buffer((T.int64(32), T.int64(32)), "float32"),
+        ):
+            for i, j in T.grid(T.int64(32), T.int64(32)):
+                with T.block("B"):
+                    B[i, j] = A[j, i]
+
+        @T.prim_func(private=True)
+        def matmul(
+            A: T.Buffer((T.int64(32), T.int64(32)), "float32"),
+            B: T.Buffer((T.int64(32), T.int64(32)), "float32"),
+            C: T.Buffer((T.int64(32), T.int64(32)), "float32"),
+        ):
+            for i, j, k in T.grid(T.int64(32), T.int64(32), T.int64(32)):
+                with T.block("C"):
+                    with T.init():
+                        C[i, j] = T.float32(0)
+                    C[i, j] = C[i, j] + A[i, k] * B[k, j]
+
+        @R.function
+        def main(x: R.Tensor((32, 32), "float32"), w: R.Tensor((32, 32), "float32")):
+            R.func_attr({"num_input": 1})
+            cls = Before
+            with R.dataflow():
+                w_t = R.call_tir(cls.transpose, (w,), out_sinfo=R.Tensor((32, 32), "float32"))
+                gv = R.call_tir(cls.matmul, (x, w_t), out_sinfo=R.Tensor((32, 32), "float32"))
+                R.output(gv)
+            return gv
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func(private=True)
+        def transpose1(
+            A: T.Buffer((T.int64(32), T.int64(32)), "float32"),
+            B: T.Buffer((T.int64(32), T.int64(32)), "float32"),
+        ):
+            T.func_attr({"layout_free_buffers": [0]})
+            for i, j in T.grid(T.int64(32), T.int64(32)):
+                with T.block("B"):
+                    B[i, j] = A[j, i]
+
+        @T.prim_func(private=True)
+        def matmul1(
+            A: T.Buffer((T.int64(32), T.int64(32)), "float32"),
+            B: T.Buffer((T.int64(32), T.int64(32)), "float32"),
+            C: T.Buffer((T.int64(32), T.int64(32)), "float32"),
+        ):
+            T.func_attr({"layout_free_buffers": [1]})
+            for i, j, k in T.grid(T.int64(32), T.int64(32), T.int64(32)):
+                with T.block("C"):
+                    with T.init():
+                        C[i, j] = T.float32(0)
+                    C[i, j] = C[i, j] + A[i, k] * B[k, j]
+
+        @R.function
+        def main(x: R.Tensor((32, 32), "float32"), w: R.Tensor((32, 32), "float32")):
+            R.func_attr({"num_input": 1})
+            cls = Expected
+            with R.dataflow():
+                w_t = R.call_tir(cls.transpose1, (w,), out_sinfo=R.Tensor((32, 32), "float32"))
+                gv = R.call_tir(cls.matmul1, (x, w_t), out_sinfo=R.Tensor((32, 32), "float32"))
+                R.output(gv)
+            return gv
+
+    after = relax.transform.AttachAttrLayoutFreeBuffers()(Before)
+    tvm.ir.assert_structural_equal(after, Expected)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
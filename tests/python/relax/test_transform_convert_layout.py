@@ -17,7 +17,7 @@
 
 import tvm
 import tvm.testing
-from tvm.relax.transform import ConvertLayout, Normalize
+from tvm.relax.transform import ConvertLayout, ConvertLayoutByCost, Normalize
 from tvm.script.parser import ir as I, relax as R, tir as T
 
 
@@ -1501,5 +1501,54 @@ def test_binary_ewise_scalar():
     verify(Input, Expected)
 
 
+def test_convert_layout_by_cost():
+    @I.ir_module
+    class Input:
+        @R.function
+        def main(
+            x: R.Tensor((2, 3, 28, 28), "float32"), w: R.Tensor((4, 3, 3, 3), "float32")
+        ) -> R.Tensor(None, "float32", ndim=4):
+            with R.dataflow():
+                lv0 = R.nn.conv2d(x, w, out_dtype="float32")
+                gv = R.nn.relu(lv0)
+                R.output(gv)
+            return gv
+
+    desired_layouts = {"relax.nn.conv2d": ["NHWC", "OHWI"]}
+    # Free layout transforms, the conv2d is converted as by ConvertLayout.
+    mod = ConvertLayoutByCost(desired_layouts, layout_speedup=2.0, transform_gbps=1e9)(Input)
+    tvm.ir.assert_structural_equal(mod, ConvertLayout(desired_layouts)(Input))
+    # Costly layout transforms, the conv2d keeps its layout.
+    mod = ConvertLayoutByCost(desired_layouts, layout_speedup=1.01, transform_gbps=1e-3)(Input)
+    tvm.ir.assert_structural_equal(mod, Input)
+
+
+def test_convert_layout_by_cost_per_region():
+    @I.ir_module
+    class Input:
+        @R.function
+        def main(
+            x: R.Tensor((1, 64, 56, 56), "float32"),
+            w0: R.Tensor((64, 64, 3, 3), "float32"),
+            y: R.Tensor((1, 4, 4, 4), "float32"),
+            w1: R.Tensor((4, 4, 1, 1), "float32"),
+        ):
+            with R.dataflow():
+                # Large, converted as the kernel saves more time than the transforms take.
+                lv0 = R.nn.conv2d(x, w0, out_dtype="float32")
+                lv1 = R.nn.relu(lv0)
+                # Small, in another region, which keeps the initial layout.
+                lv2 = R.nn.conv2d(y, w1, out_dtype="float32")
+                gv = (lv1, lv2)
+                R.output(gv)
+            return gv
+
+    desired_layouts = {"relax.nn.conv2d": ["NHWC", "OHWI"]}
+    mod = ConvertLayoutByCost(desired_layouts, layout_speedup=1.5, transform_gbps=10.0)(Input)
+    # The transforms of x and w0 to NHWC and OHWI, and of lv1 back to NCHW.
+    assert mod.script().count("R.permute_dims") == 3
+    assert mod.script().count("R.permute_dims(y") == 0
+
+
 if __name__ == "__main__":
     tvm.testing.main()
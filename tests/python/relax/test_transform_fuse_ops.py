@@ -1690,5 +1690,107 @@ def test_packed_params():
     _check(Before, Expected)
 
 
+def test_cost_model_rejects_recompute():
+    # fmt: off
+    @I.ir_module
+    class Before:
+        @T.prim_func(private=True)
+        def scale(A: T.Buffer((256,), "float32"), B: T.Buffer((256,), "float32")):
+            T.func_attr({"op_pattern": 0})
+            for i in range(256):
+                with T.block("B"):
+                    vi = T.axis.spatial(256, i)
+                    B[vi] = A[vi] * T.float32(2) + T.float32(1)
+
+        @T.prim_func(private=True)
+        def total(A: T.Buffer((256,), "float32"), B: T.Buffer((1024,), "float32")):
+            # Every output element reads all of A, so A is recomputed 1024 times once inlined.
+            T.func_attr({"op_pattern": 3})
+            for i, k in T.grid(1024, 256):
+                with T.block("B"):
+                    vi, vk = T.axis.remap("SR", [i, k])
+                    with T.init():
+                        B[vi] = T.float32(0)
+                    B[vi] = B[vi] + A[vk]
+
+        @R.function
+        def main(x: R.Tensor((256,), "float32")) -> R.Tensor((1024,), "float32"):
+            cls = Before
+            with R.dataflow():
+                lv = R.call_tir(cls.scale, (x,), out_sinfo=R.Tensor((256,), "float32"))
+                gv = R.call_tir(cls.total, (lv,), out_sinfo=R.Tensor((1024,), "float32"))
+                R.output(gv)
+            return gv
+    # fmt: on
+
+    after = relax.transform.FuseOps()(Before)
+    # Without the cost model, the elementwise producer is fused into the reduction.
+    assert len([gv for gv in after.get_global_vars() if gv.name_hint.startswith("fused")]) == 1
+
+    with tvm.transform.PassContext(config={"relax.FuseOps.cost_model": True}):
+        after = relax.transform.FuseOps()(Before)
+    decisions = [str(d) for d in after.attrs["relax.FuseOps.decisions"]]
+    assert len(decisions) == 1 and decisions[0].startswith("reject lv into gv")
+    assert not any(gv.name_hint.startswith("fused") for gv in after.get_global_vars())
+
+    # With a much lower memory bandwidth, saving the traffic pays off the recompute.
+    config = {"relax.FuseOps.cost_model": True, "relax.FuseOps.memory_bandwidth": 1}
+    with tvm.transform.PassContext(config=config):
+        after = relax.transform.FuseOps()(Before)
+    assert str(after.attrs["relax.FuseOps.decisions"][0]).startswith("fuse lv into gv")
+
+
+def test_cost_model_horizontal_fusion():
+    # fmt: off
+    @I.ir_module
+    class Before:
+        @T.prim_func(private=True)
+        def add(A: T.Buffer((256,), "float32"), B: T.Buffer((256,), "float32")):
+            T.func_attr({"op_pattern": 0})
+            for i in range(256):
+                with T.block("B"):
+                    vi = T.axis.spatial(256, i)
+                    B[vi] = A[vi] + T.float32(1)
+
+        @T.prim_func(private=True)
+        def mul(A: T.Buffer((256,), "float32"), B: T.Buffer((256,), "float32")):
+            T.func_attr({"op_pattern": 0})
+            for i in range(256):
+                with T.block("B"):
+                    vi = T.axis.spatial(256, i)
+                    B[vi] = A[vi] * T.float32(2)
+
+        @T.prim_func(private=True)
+        def opaque(A: T.Buffer((256,), "float32"), B: T.Buffer((256,), "float32"), C: T.Buffer((256,), "float32")):
+            T.func_attr({"op_pattern": 8})
+            for i in range(256):
+                with T.block("C"):
+                    vi = T.axis.spatial(256, i)
+                    C[vi] = A[vi] - B[vi]
+
+        @R.function
+        def main(x: R.Tensor((256,), "float32")) -> R.Tensor((256,), "float32"):
+            cls = Before
+            with R.dataflow():
+                lv = R.call_tir(cls.add, (x,), out_sinfo=R.Tensor((256,), "float32"))
+                lv1 = R.call_tir(cls.mul, (x,), out_sinfo=R.Tensor((256,), "float32"))
+                gv = R.call_tir(cls.opaque, (lv, lv1), out_sinfo=R.Tensor((256,), "float32"))
+                R.output(gv)
+            return gv
+    # fmt: on
+
+    after = relax.transform.FuseOps()(Before)
+    assert not any(gv.name_hint.startswith("fused") for gv in after.get_global_vars())
+
+    with tvm.transform.PassContext(config={"relax.FuseOps.cost_model": True}):
+        after = relax.transform.FuseOps()(Before)
+    decisions = [str(d) for d in after.attrs["relax.FuseOps.decisions"]]
+    assert decisions == ["horizontally fuse lv1 into lv on x: saved_bytes=1024"]
+    fused = [gv for gv in after.get_global_vars() if gv.name_hint.startswith("fused")]
+    assert len(fused) == 1
+    assert isinstance(after[fused[0]].ret_struct_info, relax.TupleStructInfo)
+    after = relax.transform.FuseTIR()(after)
+    tvm.ir.assert_structural_equal(after["main"].ret_struct_info, Before["main"].ret_struct_info)
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -1100,6 +1100,30 @@ def test_intermediate_var_to_var_binding():
     assert "fused_relax_permute_dims_relax_matmul_cublas" in func_names  # add is not fused
 
 
+def test_pattern_with_alternative_root_ops():
+    """The calls of each operator an OrPattern can match at its root are partitioned"""
+
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor((32, 8), dtype="float32")) -> R.Tensor((32, 8), dtype="float32"):
+            with R.dataflow():
+                lv0 = R.nn.relu(x)
+                lv1 = R.add(lv0, x)
+                out = R.nn.gelu(lv1)
+                R.output(out)
+            return out
+
+    act_pat = is_op("relax.nn.relu")(wildcard()) | is_op("relax.nn.gelu")(wildcard())
+    mod = relax.transform.FuseOpsByPattern([("test.act", act_pat)])(Module)
+    composites = [
+        func.attrs["Composite"]
+        for func in mod.functions.values()
+        if func.attrs is not None and "Composite" in func.attrs
+    ]
+    assert composites == ["test.act", "test.act"]
+
+
 def test_multple_runs():
     check(
         Conv2dReLU_composite_annotated,
@@ -75,6 +75,29 @@ def test_allgather():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+def test_alltoall():
+    # fmt: off
+    @tvm.script.ir_module
+    class AllToAll:
+        @R.function
+        def main(x: R.Tensor((8, 10), "float32"))  -> R.Tensor((8, 10), "float32"):
+            gv0: R.Tensor((8, 10), "float32") = R.ccl.alltoall(x, 2)
+            gv1: R.Tensor((8, 10), "float32") = R.ccl.alltoall(gv0, 4, in_group=False)
+            return gv1
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((8, 10), dtype="float32")) -> R.Tensor((8, 10), dtype="float32"):
+            gv0: R.Tensor((8, 10), dtype="float32") = R.call_dps_packed("runtime.disco.alltoall", [x, True], out_sinfo=R.Tensor((8, 10), dtype="float32"))
+            gv1: R.Tensor((8, 10), dtype="float32") = R.call_dps_packed("runtime.disco.alltoall", [gv0, False], out_sinfo=R.Tensor((8, 10), dtype="float32"))
+            return gv1
+    # fmt: on
+
+    mod = LegalizeOps()(AllToAll)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
 def test_broadcast_from_zero():
     # fmt: off
     @tvm.script.ir_module
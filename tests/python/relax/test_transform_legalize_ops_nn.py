@@ -3340,6 +3340,48 @@ def test_dynamic_attention():
     LegalizeOps()(Attention)
 
 
+@pytest.mark.parametrize("causal_mask", [None, "TopLeft", "BottomRight"])
+@pytest.mark.parametrize("num_kv_heads", [4, 2])
+def test_attention_llvm_flash(causal_mask, num_kv_heads):
+    import numpy as np  # pylint: disable=import-outside-toplevel
+    from tvm import relax  # pylint: disable=import-outside-toplevel
+
+    batch, seq_len, seq_len_kv, num_heads, head_dim = 2, 20, 70, 4, 8
+    q = relax.Var("q", R.Tensor((batch, seq_len, num_heads, head_dim), "float32"))
+    k = relax.Var("k", R.Tensor((batch, seq_len_kv, num_kv_heads, head_dim), "float32"))
+    v = relax.Var("v", R.Tensor((batch, seq_len_kv, num_kv_heads, head_dim), "float32"))
+    bb = relax.BlockBuilder()
+    with bb.function("main", [q, k, v]):
+        gv = bb.emit(relax.op.nn.attention(q, k, v, causal_mask=causal_mask))
+        bb.emit_func_output(gv)
+    mod = bb.get()
+
+    # The CPU legalization computes the attention without the scores of all the queries and keys.
+    with tvm.target.Target("llvm"):
+        legalized = LegalizeOps()(mod)
+    assert "flash_attention_cpu" in legalized.script()
+
+    q_np = np.random.uniform(-1, 1, (batch, seq_len, num_heads, head_dim)).astype("float32")
+    k_np = np.random.uniform(-1, 1, (batch, seq_len_kv, num_kv_heads, head_dim)).astype("float32")
+    v_np = np.random.uniform(-1, 1, (batch, seq_len_kv, num_kv_heads, head_dim)).astype("float32")
+    group = num_heads // num_kv_heads
+    k_ref = np.repeat(k_np, group, axis=2).transpose(0, 2, 3, 1)
+    v_ref = np.repeat(v_np, group, axis=2).transpose(0, 2, 1, 3)
+    scores = q_np.transpose(0, 2, 1, 3) @ k_ref / np.sqrt(head_dim)
+    if causal_mask is not None:
+        offset = 0 if causal_mask == "TopLeft" else seq_len_kv - seq_len
+        mask = np.tril(np.ones((seq_len, seq_len_kv)), k=offset)
+        scores = np.where(mask == 1, scores, -np.inf)
+    probs = np.exp(scores - scores.max(axis=-1, keepdims=True))
+    probs /= probs.sum(axis=-1, keepdims=True)
+    ref = (probs @ v_ref).transpose(0, 2, 1, 3)
+
+    ex = relax.build(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    out = vm["main"](*[tvm.nd.array(arr) for arr in [q_np, k_np, v_np]])
+    tvm.testing.assert_allclose(out.numpy(), ref, rtol=1e-5, atol=1e-5)
+
+
 def test_nll_loss():
     # fmt: off
     @tvm.script.ir_module
@@ -0,0 +1,138 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I, relax as R, tir as T
+
+
+@I.ir_module
+class BatchedLoRA:
+    @R.function
+    def main(
+        x: R.Tensor(["batch_size", "seq_len", 16], "float32"),
+        weight_table: R.Tensor([4, 16, 32], "float32"),
+        routing_table: R.Tensor(["batch_size"], "int64"),
+    ) -> R.Tensor(["batch_size", "seq_len", 32], "float32"):
+        batch_size = T.int64()
+        seq_len = T.int64()
+        with R.dataflow():
+            weight: R.Tensor([batch_size, 16, 32], "float32") = R.take(
+                weight_table, routing_table, axis=0
+            )
+            out: R.Tensor([batch_size, seq_len, 32], "float32") = R.matmul(x, weight)
+            R.output(out)
+        return out
+
+
+def test_lower_to_prim_func():
+    after = relax.transform.LowerBatchedLoRAMatmul()(BatchedLoRA)
+
+    prim_funcs = [func for func in after.functions.values() if isinstance(func, tvm.tir.PrimFunc)]
+    assert len(prim_funcs) == 1
+    assert "global_symbol" not in prim_funcs[0].attrs
+
+    bindings = after["main"].body.blocks[0].bindings
+    assert len(bindings) == 1
+    assert bindings[0].value.op.same_as(tvm.ir.Op.get("relax.call_tir"))
+
+
+def test_numerical_correctness():
+    after = relax.transform.LowerBatchedLoRAMatmul()(BatchedLoRA)
+    ex = relax.build(after, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    x_np = np.random.uniform(size=(3, 5, 16)).astype("float32")
+    weight_table_np = np.random.uniform(size=(4, 16, 32)).astype("float32")
+    routing_table_np = np.array([2, 0, 2], dtype="int64")
+    expected = np.matmul(x_np, weight_table_np[routing_table_np])
+
+    out = vm["main"](
+        tvm.nd.array(x_np), tvm.nd.array(weight_table_np), tvm.nd.array(routing_table_np)
+    )
+    tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-5, atol=1e-5)
+
+
+def test_lower_to_segment_gemm():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor(["batch_size", "seq_len", 16], "float16"),
+            weight_table: R.Tensor([4, 32, 16], "float16"),
+            routing_table: R.Tensor(["batch_size"], "int32"),
+        ) -> R.Tensor(["batch_size", "seq_len", 32], "float16"):
+            batch_size = T.int64()
+            seq_len = T.int64()
+            with R.dataflow():
+                weight: R.Tensor([batch_size, 32, 16], "float16") = R.take(
+                    weight_table, routing_table, axis=0
+                )
+                weight_t: R.Tensor([batch_size, 16, 32], "float16") = R.permute_dims(
+                    weight, [0, 2, 1]
+                )
+                out: R.Tensor([batch_size, seq_len, 32], "float16") = R.matmul(x, weight_t)
+                R.output(out)
+            return out
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(
+            x: R.Tensor(["batch_size", "seq_len", 16], "float16"),
+            weight_table: R.Tensor([4, 32, 16], "float16"),
+            routing_table: R.Tensor(["batch_size"], "int32"),
+        ) -> R.Tensor(["batch_size", "seq_len", 32], "float16"):
+            batch_size = T.int64()
+            seq_len = T.int64()
+            with R.dataflow():
+                indices = R.astype(routing_table, "int64")
+                workspace = R.builtin.alloc_tensor(R.shape([4194304]), "uint8", R.prim_value(0))
+                out = R.call_dps_packed(
+                    "cutlass.segment_gemm_fp16_sm90",
+                    (x, weight_table, indices, workspace),
+                    out_sinfo=R.Tensor([batch_size, seq_len, 32], "float16"),
+                )
+                R.output(out)
+            return out
+
+    after = relax.transform.LowerBatchedLoRAMatmul("cutlass.segment_gemm_fp16_sm90")(Before)
+    tvm.ir.assert_structural_equal(Expected, after)
+
+
+def test_no_op_for_shared_weights():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor([2, 5, 16], "float32"),
+            weight: R.Tensor([2, 16, 32], "float32"),
+        ) -> R.Tensor([2, 5, 32], "float32"):
+            with R.dataflow():
+                out = R.matmul(x, weight)
+                R.output(out)
+            return out
+
+    after = relax.transform.LowerBatchedLoRAMatmul()(Before)
+    tvm.ir.assert_structural_equal(Before, after)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
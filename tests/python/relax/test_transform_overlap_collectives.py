@@ -0,0 +1,74 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I, relax as R
+
+
+def test_independent_bindings_overlap_allreduce():
+    # fmt: off
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor((4, 4), "float32"), y: R.Tensor((4, 4), "float32")):
+            with R.dataflow():
+                lv0 = R.call_dps_packed("runtime.disco.allreduce", [x, R.shape([0]), True], out_sinfo=R.Tensor((4, 4), "float32"))
+                lv1 = R.add(lv0, x)
+                lv2 = R.multiply(y, y)
+                gv = R.add(lv1, lv2)
+                R.output(gv)
+            return gv
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(x: R.Tensor((4, 4), "float32"), y: R.Tensor((4, 4), "float32")):
+            with R.dataflow():
+                lv0_async = R.call_dps_packed("runtime.disco.allreduce_async", [x, R.shape([0]), True], out_sinfo=R.Tensor((4, 4), "float32"))
+                lv2 = R.multiply(y, y)
+                lv0 = R.call_pure_packed("runtime.disco.wait_collective", lv0_async, x, sinfo_args=R.Tensor((4, 4), "float32"))
+                lv1 = R.add(lv0, x)
+                gv = R.add(lv1, lv2)
+                R.output(gv)
+            return gv
+    # fmt: on
+
+    after = relax.transform.OverlapCollectives()(Before)
+    tvm.ir.assert_structural_equal(after, Expected)
+
+
+def test_dependent_bindings_keep_allgather():
+    # fmt: off
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor((2, 4), "float32")):
+            with R.dataflow():
+                lv0 = R.call_dps_packed("runtime.disco.allgather", [x, True], out_sinfo=R.Tensor((4, 4), "float32"))
+                gv = R.multiply(lv0, lv0)
+                R.output(gv)
+            return gv
+    # fmt: on
+
+    after = relax.transform.OverlapCollectives()(Before)
+    tvm.ir.assert_structural_equal(after, Before)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
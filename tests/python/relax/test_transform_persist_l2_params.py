@@ -0,0 +1,122 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I, relax as R, tir as T
+
+
+def test_window_around_uses():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor((16, 16), "float32"),
+            w0: R.Tensor((16, 16), "float32"),
+            w1: R.Tensor((16, 16), "float32"),
+        ) -> R.Tensor((16, 16), "float32"):
+            R.func_attr({"relax.l2_persisting_params": {"w0": 0.5}})
+            lv0 = R.matmul(x, w0)
+            lv1 = R.matmul(lv0, w0)
+            lv2 = R.matmul(lv1, w1)
+            return lv2
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(
+            x: R.Tensor((16, 16), "float32"),
+            w0: R.Tensor((16, 16), "float32"),
+            w1: R.Tensor((16, 16), "float32"),
+        ) -> R.Tensor((16, 16), "float32"):
+            R.func_attr({"relax.force_pure": True})
+            w0_persisting = R.call_builtin_with_ctx(
+                "vm.builtin.cuda.set_l2_persisting_window",
+                (w0, R.prim_value(T.float64(0.5))),
+                sinfo_args=[R.Tensor((16, 16), "float32")],
+            )
+            lv0 = R.matmul(x, w0_persisting)
+            lv1 = R.matmul(lv0, w0_persisting)
+            _ = R.call_builtin_with_ctx(
+                "vm.builtin.cuda.reset_l2_persisting_window", (w0,), sinfo_args=[R.Tuple()]
+            )
+            lv2 = R.matmul(lv1, w1)
+            return lv2
+
+    after = relax.transform.PersistL2Params()(Before)
+    tvm.ir.assert_structural_equal(Expected, after)
+
+
+def test_overlapping_window_is_skipped():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor((16, 16), "float32"),
+            w0: R.Tensor((16, 16), "float32"),
+            w1: R.Tensor((16, 16), "float32"),
+        ) -> R.Tensor((16, 16), "float32"):
+            R.func_attr({"relax.l2_persisting_params": {"w0": 1.0, "w1": 1.0}})
+            lv0 = R.matmul(x, w0)
+            lv1 = R.matmul(lv0, w1)
+            lv2 = R.matmul(lv1, w0)
+            return lv2
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(
+            x: R.Tensor((16, 16), "float32"),
+            w0: R.Tensor((16, 16), "float32"),
+            w1: R.Tensor((16, 16), "float32"),
+        ) -> R.Tensor((16, 16), "float32"):
+            R.func_attr({"relax.force_pure": True})
+            w0_persisting = R.call_builtin_with_ctx(
+                "vm.builtin.cuda.set_l2_persisting_window",
+                (w0, R.prim_value(T.float64(1.0))),
+                sinfo_args=[R.Tensor((16, 16), "float32")],
+            )
+            lv0 = R.matmul(x, w0_persisting)
+            lv1 = R.matmul(lv0, w1)
+            lv2 = R.matmul(lv1, w0_persisting)
+            _ = R.call_builtin_with_ctx(
+                "vm.builtin.cuda.reset_l2_persisting_window", (w0,), sinfo_args=[R.Tuple()]
+            )
+            return lv2
+
+    after = relax.transform.PersistL2Params()(Before)
+    tvm.ir.assert_structural_equal(Expected, after)
+
+
+def test_unknown_param_is_rejected():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(x: R.Tensor((16, 16), "float32")) -> R.Tensor((16, 16), "float32"):
+            R.func_attr({"relax.l2_persisting_params": {"w": 1.0}})
+            lv0 = R.add(x, x)
+            return lv0
+
+    with pytest.raises(ValueError):
+        relax.transform.PersistL2Params()(Before)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -0,0 +1,133 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test the cost-based placement of the operators on the CPU or the GPU"""
+
+import tvm
+import tvm.testing
+from tvm.relax.transform import PlaceVDeviceByCost
+from tvm.script.parser import ir as I, relax as R
+
+
+def test_place_by_cost():
+    @I.ir_module
+    class Before:
+        I.module_global_infos({"vdevice": [I.vdevice("cuda", 0), I.vdevice("llvm")]})
+
+        @R.function
+        def main(
+            x: R.Tensor((256, 256), "float32"),
+            y: R.Tensor((4,), "int64"),
+            n: R.Tensor((4,), "int64", "llvm"),
+        ) -> R.Tuple(R.Tensor((256, 256), "float32"), R.Tensor((4,), "int64", "llvm")):
+            with R.dataflow():
+                # Large, on the GPU where its input is.
+                lv0 = R.matmul(x, x)
+                lv1 = R.sum(lv0)
+                # Small, on the CPU, where one of its inputs is copied to.
+                lv2 = R.add(n, n)
+                lv3 = R.multiply(lv2, y)
+                # Small without inputs, on the CPU.
+                lv4 = R.add(R.const(1, "int64"), R.const(2, "int64"))
+                lv5 = R.multiply(lv3, lv4)
+                lv6 = R.add(lv0, lv1)
+                gv = (lv6, lv5)
+                R.output(gv)
+            return gv
+
+    @I.ir_module
+    class Expected:
+        I.module_global_infos({"vdevice": [I.vdevice("cuda", 0), I.vdevice("llvm")]})
+
+        @R.function
+        def main(
+            x: R.Tensor((256, 256), "float32"),
+            y: R.Tensor((4,), "int64"),
+            n: R.Tensor((4,), "int64", "llvm"),
+        ) -> R.Tuple(R.Tensor((256, 256), "float32"), R.Tensor((4,), "int64", "llvm")):
+            with R.dataflow():
+                y_copy: R.Tensor((4,), "int64", "llvm") = R.to_vdevice(y, "llvm")
+                lv0: R.Tensor((256, 256), "float32", "cuda") = R.matmul(x, x)
+                lv1: R.Tensor((), "float32", "cuda") = R.sum(lv0)
+                lv2: R.Tensor((4,), "int64", "llvm") = R.add(n, n)
+                lv3: R.Tensor((4,), "int64", "llvm") = R.multiply(lv2, y_copy)
+                lv4: R.Tensor((), "int64", "llvm") = R.add(R.const(1, "int64"), R.const(2, "int64"))
+                lv5: R.Tensor((4,), "int64", "llvm") = R.multiply(lv3, lv4)
+                lv6: R.Tensor((256, 256), "float32", "cuda") = R.add(lv0, lv1)
+                gv = (lv6, lv5)
+                R.output(gv)
+            return gv
+
+    tvm.ir.assert_structural_equal(PlaceVDeviceByCost()(Before), Expected)
+
+
+def test_copy_after_producer():
+    @I.ir_module
+    class Before:
+        I.module_global_infos({"vdevice": [I.vdevice("cuda", 0), I.vdevice("llvm")]})
+
+        @R.function
+        def main(
+            x: R.Tensor((256, 256), "float32"), n: R.Tensor((), "float32", "llvm")
+        ) -> R.Tensor((256, 256), "float32"):
+            with R.dataflow():
+                lv0 = R.matmul(x, x)
+                lv1 = R.max(lv0)
+                lv2 = R.nn.relu(lv0)
+                # The copy of lv1 is issued before lv2, to overlap with it.
+                lv3 = R.add(lv1, n)
+                lv4 = R.multiply(lv2, R.const(2, "float32"))
+                R.output(lv4, lv3)
+            return lv4
+
+    @I.ir_module
+    class Expected:
+        I.module_global_infos({"vdevice": [I.vdevice("cuda", 0), I.vdevice("llvm")]})
+
+        @R.function
+        def main(
+            x: R.Tensor((256, 256), "float32"), n: R.Tensor((), "float32", "llvm")
+        ) -> R.Tensor((256, 256), "float32"):
+            with R.dataflow():
+                lv0: R.Tensor((256, 256), "float32", "cuda") = R.matmul(x, x)
+                lv1: R.Tensor((), "float32", "cuda") = R.max(lv0)
+                lv1_copy: R.Tensor((), "float32", "llvm") = R.to_vdevice(lv1, "llvm")
+                lv2: R.Tensor((256, 256), "float32", "cuda") = R.nn.relu(lv0)
+                lv3: R.Tensor((), "float32", "llvm") = R.add(lv1_copy, n)
+                lv4: R.Tensor((256, 256), "float32", "cuda") = R.multiply(
+                    lv2, R.const(2, "float32")
+                )
+                R.output(lv4, lv3)
+            return lv4
+
+    tvm.ir.assert_structural_equal(PlaceVDeviceByCost()(Before), Expected)
+
+
+def test_no_cpu_and_gpu():
+    @I.ir_module
+    class Before:
+        I.module_global_infos({"vdevice": [I.vdevice("cuda", 0)]})
+
+        @R.function
+        def main(x: R.Tensor((4,), "float32")) -> R.Tensor((4,), "float32"):
+            y = R.add(x, x)
+            return y
+
+    tvm.ir.assert_structural_equal(PlaceVDeviceByCost()(Before), Before)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -1013,6 +1013,46 @@ class TestMergeAllocFuncs(BaseCompare):
             return R.tuple()
 
 
+def test_merge_alloc_funcs_by_exclusive_group():
+    @I.ir_module
+    class Before:
+        @R.function
+        def prefill():
+            R.func_attr({"relax.force_pure": True, "relax.memory_plan_exclusive_group": "llm"})
+            storage = R.memory.alloc_storage(R.shape([256]), 0, "global", "float32")
+            alloc = R.memory.alloc_tensor(storage, 0, R.shape([256]), "float32")
+            R.call_packed("dummy", alloc, sinfo_args=(R.Tuple,))
+            return R.tuple()
+
+        @R.function
+        def decode():
+            R.func_attr({"relax.force_pure": True, "relax.memory_plan_exclusive_group": "llm"})
+            storage = R.memory.alloc_storage(R.shape([128]), 0, "global", "float32")
+            alloc = R.memory.alloc_tensor(storage, 0, R.shape([128]), "float32")
+            R.call_packed("dummy", alloc, sinfo_args=(R.Tuple,))
+            return R.tuple()
+
+        @R.function
+        def embed():
+            R.func_attr({"relax.force_pure": True})
+            storage = R.memory.alloc_storage(R.shape([64]), 0, "global", "float32")
+            alloc = R.memory.alloc_tensor(storage, 0, R.shape([64]), "float32")
+            R.call_packed("dummy", alloc, sinfo_args=(R.Tuple,))
+            return R.tuple()
+
+    after = relax.transform.RewriteCUDAGraph()(Before)
+    # prefill and decode share one storage, which is not shared with the function outside
+    # of their exclusive group.
+    alloc_func = after["cuda_graph_alloc"]
+    sizes = [
+        int(binding.value.args[0].values[0])
+        for block in alloc_func.body.blocks
+        for binding in block.bindings
+        if isinstance(binding.value, relax.Call)
+    ]
+    assert sizes == [64, 256]
+
+
 class TestDisableCaptureOutput(BaseCompare):
     @I.ir_module
     class Before:
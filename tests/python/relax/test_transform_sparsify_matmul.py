@@ -0,0 +1,105 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+# pylint: disable=missing-docstring,invalid-name
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I, relax as R
+
+
+def _ops(func: relax.Function):
+    ops = []
+
+    def fvisit(expr):
+        if isinstance(expr, relax.Call) and isinstance(expr.op, tvm.ir.Op):
+            ops.append(expr.op.name)
+
+    relax.analysis.post_order_visit(func.body, fvisit)
+    return ops
+
+
+@I.ir_module
+class Linear:
+    @R.function
+    def main(
+        x: R.Tensor((8, 32), "float32"), w: R.Tensor((64, 32), "float32")
+    ) -> R.Tensor((8, 64), "float32"):
+        R.func_attr({"num_input": 1})
+        with R.dataflow():
+            wt = R.permute_dims(w)
+            gv = R.matmul(x, wt)
+            R.output(gv)
+        return gv
+
+
+def test_2_4():
+    mod = relax.transform.SparsifyMatmul("2:4")(Linear)
+    ops = _ops(mod["main"])
+    assert "relax.structured_sparse_matmul" in ops
+    assert "relax.matmul" not in ops and "relax.permute_dims" not in ops
+
+    # The compression of the weight is lifted out of the main function.
+    lifted = relax.transform.LiftTransformParams()(mod)
+    assert "relax.topk" in _ops(lifted["main_transform_params"])
+    assert _ops(lifted["main"]) == ["relax.structured_sparse_matmul"]
+
+
+def test_2_4_numerics():
+    mod = relax.transform.SparsifyMatmul("2:4")(Linear)
+    mod = relax.transform.LegalizeOps()(mod)
+    ex = relax.build(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    x = np.random.uniform(size=(8, 32)).astype("float32")
+    w = np.random.uniform(-1, 1, size=(64, 32)).astype("float32")
+    # Zero the 2 smallest magnitudes of each group of 4.
+    groups = w.reshape(64, 8, 4)
+    smallest = np.argsort(np.abs(groups), axis=-1)[..., :2]
+    np.put_along_axis(groups, smallest, 0, axis=-1)
+    pruned = groups.reshape(64, 32)
+
+    out = vm["main"](tvm.nd.array(x), tvm.nd.array(w)).numpy()
+    tvm.testing.assert_allclose(out, x @ pruned.T, rtol=1e-5, atol=1e-5)
+
+
+def test_bsr():
+    w = np.zeros((64, 32), "float32")
+    w[16:32] = np.random.uniform(size=(16, 32))
+    mod = relax.transform.BindParams("main", {"w": w})(Linear)
+    mod = relax.transform.SparsifyMatmul("bsr", block_size=(16, 1))(mod)
+    ops = _ops(mod["main"])
+    assert ops == ["relax.bsr_matmul"]
+
+    mod = relax.transform.LegalizeOps()(mod)
+    ex = relax.build(mod, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    x = np.random.uniform(size=(8, 32)).astype("float32")
+    out = vm["main"](tvm.nd.array(x)).numpy()
+    tvm.testing.assert_allclose(out, x @ w.T, rtol=1e-5, atol=1e-5)
+
+
+def test_bsr_dense_weight_is_kept():
+    w = np.random.uniform(size=(64, 32)).astype("float32")
+    mod = relax.transform.BindParams("main", {"w": w})(Linear)
+    mod = relax.transform.SparsifyMatmul("bsr")(mod)
+    assert "relax.matmul" in _ops(mod["main"])
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -1545,5 +1545,202 @@ def test_with_dataflow():
     tvm.ir.assert_structural_equal(after, Expected)
 
 
+def test_arena():
+    # fmt: off
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def exp(A: T.Buffer(T.int64(1024), "float32"), B: T.Buffer(T.int64(1024), "float32")):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor((1024,), dtype="float32")) -> R.Tensor((1024,), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Module
+            alloc: R.Tensor((1024,), dtype="float32") = R.builtin.alloc_tensor(R.shape([1024]), dtype="float32", runtime_device_index=0)
+            _: R.Tuple() = cls.exp(x, alloc)
+            alloc1: R.Tensor((1024,), dtype="float32") = R.builtin.alloc_tensor(R.shape([1024]), dtype="float32", runtime_device_index=0)
+            _1: R.Tuple() = cls.exp(alloc, alloc1)
+            alloc2: R.Tensor((1024,), dtype="float32") = R.builtin.alloc_tensor(R.shape([1024]), dtype="float32", runtime_device_index=0)
+            _2: R.Tuple() = cls.exp(alloc1, alloc2)
+            alloc3: R.Tensor((1024,), dtype="float32") = R.builtin.alloc_tensor(R.shape([1024]), dtype="float32", runtime_device_index=0)
+            _3: R.Tuple() = cls.exp(alloc2, alloc3)
+            return alloc3
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func
+        def exp(A: T.Buffer(T.int64(1024), "float32"), B: T.Buffer(T.int64(1024), "float32")):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor((1024,), dtype="float32")) -> R.Tensor((1024,), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Expected
+            arena: R.Object = R.memory.alloc_storage(R.shape([8192]), virtual_device_index=0, storage_scope="global", dtype="uint8")
+            alloc: R.Tensor((1024,), dtype="float32") = R.memory.alloc_tensor(arena, 0, R.shape([1024]), dtype="float32")
+            _: R.Tuple() = cls.exp(x, alloc)
+            alloc1: R.Tensor((1024,), dtype="float32") = R.memory.alloc_tensor(arena, 4096, R.shape([1024]), dtype="float32")
+            _1: R.Tuple() = cls.exp(alloc, alloc1)
+            alloc2: R.Tensor((1024,), dtype="float32") = R.memory.alloc_tensor(arena, 0, R.shape([1024]), dtype="float32")
+            _2: R.Tuple() = cls.exp(alloc1, alloc2)
+            alloc3: R.Tensor((1024,), dtype="float32") = R.builtin.alloc_tensor(R.shape([1024]), dtype="float32", runtime_device_index=0)
+            _3: R.Tuple() = cls.exp(alloc2, alloc3)
+            return alloc3
+    # fmt: on
+
+    with tvm.transform.PassContext(config={"relax.memory_plan_arena": True}):
+        mod = relax.transform.StaticPlanBlockMemory()(Module)
+    main = mod["main"]
+    assert int(main.attrs["relax.memory_plan_arena_bytes"]) == 8192
+    assert int(main.attrs["relax.memory_plan_live_bytes"]) == 8192
+    mod["main"] = main.without_attr("relax.memory_plan_arena_bytes").without_attr(
+        "relax.memory_plan_live_bytes"
+    )
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
+def test_texture():
+    # fmt: off
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def exp(A: T.Buffer((T.int64(1), T.int64(4), T.int64(8), T.int64(4)), "float32"), B: T.Buffer((T.int64(1), T.int64(4), T.int64(8), T.int64(4)), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def pad(A: T.Buffer((T.int64(1), T.int64(4), T.int64(8), T.int64(4)), "float32"), B: T.Buffer((T.int64(1), T.int64(4), T.int64(16), T.int64(4)), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def relu(A: T.Buffer((T.int64(1), T.int64(4), T.int64(16), T.int64(4)), "float32"), B: T.Buffer((T.int64(1), T.int64(4), T.int64(16), T.int64(4)), "float32")):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor((1, 4, 8, 4), dtype="float32")) -> R.Tensor((1, 4, 16, 4), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Module
+            alloc: R.Tensor((1, 4, 8, 4), dtype="float32") = R.builtin.alloc_tensor(R.shape([1, 4, 8, 4]), dtype="float32", runtime_device_index=0, storage_scope="global.texture")
+            _: R.Tuple() = cls.exp(x, alloc)
+            alloc1: R.Tensor((1, 4, 8, 4), dtype="float32") = R.builtin.alloc_tensor(R.shape([1, 4, 8, 4]), dtype="float32", runtime_device_index=0, storage_scope="global.texture")
+            _1: R.Tuple() = cls.exp(alloc, alloc1)
+            alloc2: R.Tensor((1, 4, 16, 4), dtype="float32") = R.builtin.alloc_tensor(R.shape([1, 4, 16, 4]), dtype="float32", runtime_device_index=0, storage_scope="global.texture")
+            _2: R.Tuple() = cls.pad(alloc1, alloc2)
+            alloc3: R.Tensor((1, 4, 16, 4), dtype="float32") = R.builtin.alloc_tensor(R.shape([1, 4, 16, 4]), dtype="float32", runtime_device_index=0)
+            _3: R.Tuple() = cls.relu(alloc2, alloc3)
+            return alloc3
+
+    @I.ir_module
+    class Expected:
+        @T.prim_func
+        def exp(A: T.Buffer((T.int64(1), T.int64(4), T.int64(8), T.int64(4)), "float32"), B: T.Buffer((T.int64(1), T.int64(4), T.int64(8), T.int64(4)), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def pad(A: T.Buffer((T.int64(1), T.int64(4), T.int64(8), T.int64(4)), "float32"), B: T.Buffer((T.int64(1), T.int64(4), T.int64(16), T.int64(4)), "float32")):
+            T.evaluate(0)
+
+        @T.prim_func
+        def relu(A: T.Buffer((T.int64(1), T.int64(4), T.int64(16), T.int64(4)), "float32"), B: T.Buffer((T.int64(1), T.int64(4), T.int64(16), T.int64(4)), "float32")):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor((1, 4, 8, 4), dtype="float32")) -> R.Tensor((1, 4, 16, 4), dtype="float32"):
+            R.func_attr({"relax.force_pure": True})
+            cls = Expected
+            storage: R.Object = R.memory.alloc_storage(R.shape([4, 16, 4]), virtual_device_index=0, storage_scope="global.texture", dtype="float32")
+            alloc: R.Tensor((1, 4, 8, 4), dtype="float32") = R.memory.alloc_tensor(storage, 0, R.shape([1, 4, 8, 4]), dtype="float32")
+            _: R.Tuple() = cls.exp(x, alloc)
+            storage1: R.Object = R.memory.alloc_storage(R.shape([4, 8, 4]), virtual_device_index=0, storage_scope="global.texture", dtype="float32")
+            alloc1: R.Tensor((1, 4, 8, 4), dtype="float32") = R.memory.alloc_tensor(storage1, 0, R.shape([1, 4, 8, 4]), dtype="float32")
+            _1: R.Tuple() = cls.exp(alloc, alloc1)
+            # The first image is grown to the extent of the padded tensor.
+            alloc2: R.Tensor((1, 4, 16, 4), dtype="float32") = R.memory.alloc_tensor(storage, 0, R.shape([1, 4, 16, 4]), dtype="float32")
+            _2: R.Tuple() = cls.pad(alloc1, alloc2)
+            alloc3: R.Tensor((1, 4, 16, 4), dtype="float32") = R.builtin.alloc_tensor(R.shape([1, 4, 16, 4]), dtype="float32", runtime_device_index=0)
+            _3: R.Tuple() = cls.relu(alloc2, alloc3)
+            return alloc3
+    # fmt: on
+
+    mod = relax.transform.StaticPlanBlockMemory()(Module)
+    tvm.ir.assert_structural_equal(mod, Expected)
+
+
+def test_exclusive_group():
+    # fmt: off
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def exp(A: T.handle, B: T.handle):
+            T.evaluate(0)
+
+        @R.function
+        def prefill(x: R.Tensor((4096,), dtype="float32")) -> R.Tensor((4096,), dtype="float32"):
+            R.func_attr({"relax.memory_plan_exclusive_group": "llm", "relax.force_pure": True})
+            cls = Module
+            alloc: R.Tensor((4096,), dtype="float32") = R.builtin.alloc_tensor(R.shape([4096]), dtype="float32", runtime_device_index=0)
+            _: R.Tuple() = cls.exp(x, alloc)
+            alloc1: R.Tensor((4096,), dtype="float32") = R.builtin.alloc_tensor(R.shape([4096]), dtype="float32", runtime_device_index=0)
+            _1: R.Tuple() = cls.exp(alloc, alloc1)
+            return alloc1
+
+        @R.function
+        def decode(x: R.Tensor((1024,), dtype="float32")) -> R.Tensor((1024,), dtype="float32"):
+            R.func_attr({"relax.memory_plan_exclusive_group": "llm", "relax.force_pure": True})
+            cls = Module
+            alloc: R.Tensor((1024,), dtype="float32") = R.builtin.alloc_tensor(R.shape([1024]), dtype="float32", runtime_device_index=0)
+            _: R.Tuple() = cls.exp(x, alloc)
+            alloc1: R.Tensor((1024,), dtype="float32") = R.builtin.alloc_tensor(R.shape([1024]), dtype="float32", runtime_device_index=0)
+            _1: R.Tuple() = cls.exp(alloc, alloc1)
+            return alloc1
+    # fmt: on
+
+    mod = relax.transform.StaticPlanBlockMemory()(Module)
+    # The arena of decode is padded to the one of prefill, so both share the same workspace.
+    for name in ["prefill", "decode"]:
+        assert int(mod[name].attrs["relax.memory_plan_arena_bytes"]) == 16384
+    assert int(mod["decode"].attrs["relax.memory_plan_live_bytes"]) == 4096
+
+
+def test_tir_var_upper_bound_buckets():
+    # fmt: off
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def exp(A: T.handle, B: T.handle):
+            T.evaluate(0)
+
+        @R.function
+        def main(x: R.Tensor(("n",), dtype="float32")) -> R.Tensor(("n",), dtype="float32"):
+            R.func_attr({"tir_var_upper_bound": {"n": 4096}, "tir_var_upper_bound_buckets": {"n": [128]}, "relax.force_pure": True})
+            n = T.int64()
+            cls = Module
+            alloc: R.Tensor((n,), dtype="float32") = R.builtin.alloc_tensor(R.shape([n]), dtype="float32", runtime_device_index=0)
+            _: R.Tuple() = cls.exp(x, alloc)
+            alloc1: R.Tensor((n,), dtype="float32") = R.builtin.alloc_tensor(R.shape([n]), dtype="float32", runtime_device_index=0)
+            _1: R.Tuple() = cls.exp(alloc, alloc1)
+            return alloc1
+    # fmt: on
+
+    def storage_sizes(func):
+        alloc_storage = tvm.ir.Op.get("relax.memory.alloc_storage")
+        return [
+            int(binding.value.args[0].values[0])
+            for block in func.body.blocks
+            for binding in block.bindings
+            if isinstance(binding.value, relax.Call) and binding.value.op.same_as(alloc_storage)
+        ]
+
+    mod = relax.transform.StaticPlanBlockMemory()(Module)
+    assert storage_sizes(mod["main_bucket0"]) == [512]
+    assert storage_sizes(mod["main_bucket1"]) == [16384]
+    assert "global_symbol" not in mod["main_bucket0"].attrs
+    assert int(mod["main_bucket0"].attrs["tir_var_upper_bound"]["n"]) == 128
+    main = mod["main"]
+    assert "tir_var_upper_bound_buckets" not in main.attrs
+    bindings = [binding for block in main.body.blocks for binding in block.bindings]
+    assert any(isinstance(binding.value, relax.If) for binding in bindings)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
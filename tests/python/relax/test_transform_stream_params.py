@@ -0,0 +1,138 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.script import ir as I, relax as R
+
+
+def test_stream_in_order_of_use():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor((16, 16), "float32"),
+            w0: R.Tensor((16, 16), "float32"),
+            w1: R.Tensor((16, 16), "float32"),
+            w2: R.Tensor((16, 16), "float32"),
+        ) -> R.Tensor((16, 16), "float32"):
+            R.func_attr({"num_input": 1})
+            lv0 = R.matmul(x, w0)
+            lv1 = R.matmul(lv0, w1)
+            lv2 = R.matmul(lv1, w2)
+            return lv2
+
+    @I.ir_module
+    class Expected:
+        @R.function
+        def main(
+            x: R.Tensor((16, 16), "float32"),
+            w0: R.Tensor((16, 16), "float32"),
+            w1: R.Tensor((16, 16), "float32"),
+            w2: R.Tensor((16, 16), "float32"),
+        ) -> R.Tensor((16, 16), "float32"):
+            R.func_attr(
+                {"num_input": 1, "relax.force_pure": True, "relax.streamed_params": [1, 2, 3]}
+            )
+            w0_prefetch = R.call_builtin_with_ctx(
+                "vm.builtin.weight_streaming.prefetch",
+                (w0, R.prim_value(0), R.prim_value(2), R.prim_value(1024), R.prim_value(0)),
+                sinfo_args=[R.Tensor((16, 16), "float32")],
+            )
+            w1_prefetch = R.call_builtin_with_ctx(
+                "vm.builtin.weight_streaming.prefetch",
+                (w1, R.prim_value(1), R.prim_value(2), R.prim_value(1024), R.prim_value(0)),
+                sinfo_args=[R.Tensor((16, 16), "float32")],
+            )
+            w0_device = R.call_builtin_with_ctx(
+                "vm.builtin.weight_streaming.wait",
+                (w0_prefetch, R.prim_value(0)),
+                sinfo_args=[R.Tensor((16, 16), "float32")],
+            )
+            lv0 = R.matmul(x, w0_device)
+            _ = R.call_builtin_with_ctx(
+                "vm.builtin.weight_streaming.release", (R.prim_value(0),), sinfo_args=[R.Tuple()]
+            )
+            # Slot 0 is free again once the matmul reading w0 has been issued.
+            w2_prefetch = R.call_builtin_with_ctx(
+                "vm.builtin.weight_streaming.prefetch",
+                (w2, R.prim_value(0), R.prim_value(2), R.prim_value(1024), R.prim_value(0)),
+                sinfo_args=[R.Tensor((16, 16), "float32")],
+            )
+            w1_device = R.call_builtin_with_ctx(
+                "vm.builtin.weight_streaming.wait",
+                (w1_prefetch, R.prim_value(1)),
+                sinfo_args=[R.Tensor((16, 16), "float32")],
+            )
+            lv1 = R.matmul(lv0, w1_device)
+            _ = R.call_builtin_with_ctx(
+                "vm.builtin.weight_streaming.release", (R.prim_value(1),), sinfo_args=[R.Tuple()]
+            )
+            w2_device = R.call_builtin_with_ctx(
+                "vm.builtin.weight_streaming.wait",
+                (w2_prefetch, R.prim_value(0)),
+                sinfo_args=[R.Tensor((16, 16), "float32")],
+            )
+            lv2 = R.matmul(lv1, w2_device)
+            _ = R.call_builtin_with_ctx(
+                "vm.builtin.weight_streaming.release", (R.prim_value(0),), sinfo_args=[R.Tuple()]
+            )
+            return lv2
+
+    after = relax.transform.StreamParams(lookahead=1, num_slots=2)(Before)
+    tvm.ir.assert_structural_equal(Expected, after)
+
+
+def test_returned_weight_is_not_streamed():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor((16, 16), "float32"),
+            w0: R.Tensor((16, 16), "float32"),
+        ):
+            R.func_attr({"num_input": 1})
+            lv0 = R.matmul(x, w0)
+            return (lv0, w0)
+
+    after = relax.transform.StreamParams()(Before)
+    tvm.ir.assert_structural_equal(Before, after)
+
+
+def test_dataflow_block_is_rejected():
+    @I.ir_module
+    class Before:
+        @R.function
+        def main(
+            x: R.Tensor((16, 16), "float32"),
+            w0: R.Tensor((16, 16), "float32"),
+        ) -> R.Tensor((16, 16), "float32"):
+            R.func_attr({"num_input": 1})
+            with R.dataflow():
+                lv0 = R.matmul(x, w0)
+                R.output(lv0)
+            return lv0
+
+    with pytest.raises(ValueError):
+        relax.transform.StreamParams()(Before)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -1064,5 +1064,50 @@ def test_call_tir_with_float16_args():
     tvm.ir.assert_structural_equal(Expected, After)
 
 
+def test_fp8_matmul():
+    @I.ir_module
+    class Input:
+        @R.function
+        def main(
+            x: R.Tensor((4, 32), "float32"), w: R.Tensor((16, 32), "float32")
+        ) -> R.Tensor((4, 16), "float32"):
+            with R.dataflow():
+                wt = R.permute_dims(w)
+                gv = R.matmul(x, wt)
+                R.output(gv)
+            return gv
+
+    mod = ToMixedPrecision(fp8_matmul=True)(Input)
+    bindings = mod["main"].body.blocks[0].bindings
+    calls = [b.value for b in bindings if isinstance(b.value, relax.Call)]
+    matmuls = [call for call in calls if call.op.name == "relax.matmul"]
+    assert len(matmuls) == 1
+    matmul = matmuls[0]
+    assert matmul.attrs.out_dtype == "float32"
+    assert [arg.struct_info.dtype for arg in matmul.args] == ["e4m3_float8", "e4m3_float8"]
+    # The result is scaled and cast back, which is the pattern offloaded to cuBLASLt.
+    assert calls[-1].op.name == "relax.astype"
+    assert calls[-1].attrs.dtype == "float32"
+    assert calls[-2].op.name == "relax.multiply"
+
+    # Matmuls whose rhs is not transposed keep the fp16 path.
+    @I.ir_module
+    class NotTransposed:
+        @R.function
+        def main(
+            x: R.Tensor((4, 32), "float32"), w: R.Tensor((32, 16), "float32")
+        ) -> R.Tensor((4, 16), "float32"):
+            with R.dataflow():
+                gv = R.matmul(x, w)
+                R.output(gv)
+            return gv
+
+    mod = ToMixedPrecision(fp8_matmul=True)(NotTransposed)
+    for binding in mod["main"].body.blocks[0].bindings:
+        if isinstance(binding.value, relax.Call) and binding.value.op.name == "relax.matmul":
+            assert binding.value.attrs.out_dtype == "float32"
+            assert all(arg.struct_info.dtype == "float16" for arg in binding.value.args)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
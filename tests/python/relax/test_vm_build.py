@@ -1309,5 +1309,33 @@ def test_relax_module_with_multiple_targets(exec_mode):
     tvm.testing.assert_allclose(cuda_output.numpy(), np_C)
 
 
+
+def test_shape_prologue_cache():
+    @I.ir_module
+    class Module:
+        @R.function
+        def main(x: R.Tensor(("n", "m"), "float32")) -> R.Shape(("m", "n")):
+            n = T.int64()
+            m = T.int64()
+            return R.shape([m, n])
+
+    ex = relax.build(Module, "llvm")
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+
+    for shape in [(2, 3), (2, 3), (4, 5), (4, 5), (2, 3)]:
+        x = tvm.nd.array(np.zeros(shape, "float32"))
+        assert tuple(vm["main"](x)) == (shape[1], shape[0])
+
+    # The checks of the cached prologue still run when the signature differs.
+    with pytest.raises(ValueError):
+        vm["main"](tvm.nd.array(np.zeros((2, 3), "int32")))
+    with pytest.raises(ValueError):
+        vm["main"](tvm.nd.array(np.zeros((2, 3, 4), "float32")))
+
+    vm.set_trusted_inputs(True)
+    for shape in [(3, 2), (6, 7), (3, 2)]:
+        x = tvm.nd.array(np.zeros(shape, "float32"))
+        assert tuple(vm["main"](x)) == (shape[1], shape[0])
+
 if __name__ == "__main__":
     tvm.testing.main()
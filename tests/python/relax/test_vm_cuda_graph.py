@@ -107,6 +107,33 @@ def test_vm_run():
     tvm.testing.assert_allclose(y.asnumpy(), y_np, rtol=1e-5, atol=1e-5)
 
 
+@tvm.testing.requires_cuda
+def test_vm_run_with_cache_config():
+    fset_config = tvm.get_global_func("vm.builtin.cuda_graph.set_cache_config")
+    fround = tvm.get_global_func("vm.builtin.cuda_graph.round_to_bucket")
+    fstats = tvm.get_global_func("vm.builtin.cuda_graph.stats")
+
+    fset_config(1, tvm.runtime.ShapeTuple([32, 8, 16]))
+    try:
+        assert fround(5) == 8
+        assert fround(16) == 16
+        assert fround(33) == 33
+
+        captures = int(fstats()["captures"])
+        ex = codegen(Module, tvm.target.Target("cuda", host="llvm"))
+        dev = tvm.cuda(0)
+        vm = relax.VirtualMachine(ex, dev)
+        x_np = np.random.uniform(size=(16, 16)).astype("float32")
+        for _ in range(3):
+            y = vm["main"](tvm.nd.array(x_np, dev))
+            tvm.testing.assert_allclose(y.numpy(), x_np + 4.0, rtol=1e-5, atol=1e-5)
+        # The graph without symbolic variables is captured once and replayed afterwards.
+        assert int(fstats()["captures"]) == captures + 1
+        assert int(fstats()["cached_alloc_bytes"]) >= 2048
+    finally:
+        fset_config(0, tvm.runtime.ShapeTuple([]))
+
+
 @tvm.testing.requires_cudagraph
 def test_capture_error_is_recoverable():
     """Function calls while capturing cudagraph may throw exceptions
@@ -20,6 +20,7 @@ import pytest
 
 import tvm
 from tvm import TVMError, relax
+from tvm.contrib import utils
 from tvm.relax.testing.vm import check_saved_func
 from tvm.script import relax as R
 
@@ -72,6 +73,48 @@ def test_vm_multiple_func():
     tvm.testing.assert_allclose(mul_res.numpy(), a.numpy() * b.numpy(), rtol=1e-7, atol=1e-7)
 
 
+def test_vm_execution_context():
+    ib = relax.ExecBuilder()
+    with ib.function("func0", num_inputs=2):
+        ib.emit_call("test.vm.add", args=[ib.r(0), ib.r(1)], dst=ib.r(2))
+        ib.emit_ret(ib.r(2))
+    ex = ib.get()
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    contexts = [vm.create_execution_context() for _ in range(4)]
+    inputs = [(np.random.rand(4), np.random.rand(4)) for _ in contexts]
+
+    waits = [
+        ctx.invoke_async("func0", tvm.nd.array(a), tvm.nd.array(b))
+        for ctx, (a, b) in zip(contexts, inputs)
+    ]
+    for wait, (a, b) in zip(waits, inputs):
+        tvm.testing.assert_allclose(wait().numpy(), a + b, rtol=1e-7, atol=1e-7)
+
+    # The context can also be invoked synchronously, like the VM itself.
+    a, b = inputs[0]
+    res = contexts[0]["func0"](tvm.nd.array(a), tvm.nd.array(b))
+    tvm.testing.assert_allclose(res.numpy(), a + b, rtol=1e-7, atol=1e-7)
+
+
+def test_vm_external_stream():
+    ib = relax.ExecBuilder()
+    with ib.function("func0", num_inputs=2):
+        ib.emit_call("test.vm.add", args=[ib.r(0), ib.r(1)], dst=ib.r(2))
+        ib.emit_ret(ib.r(2))
+    ex = ib.get()
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    ctx = vm.create_execution_context()
+    a, b = np.random.rand(4), np.random.rand(4)
+    for m in [vm, ctx]:
+        m.set_external_stream(tvm.cpu(), 0)
+        res = m["func0"](tvm.nd.array(a), tvm.nd.array(b))
+        tvm.testing.assert_allclose(res.numpy(), a + b, rtol=1e-7, atol=1e-7)
+        m.set_external_stream(tvm.cpu(), None)
+
+    with pytest.raises(ValueError, match="not initialized on device"):
+        vm.set_external_stream(tvm.cpu(1), 0)
+
+
 def test_vm_checker():
     ib = relax.ExecBuilder()
     with pytest.raises(TVMError):
@@ -266,6 +309,28 @@ def test_vm_invoke_closure():
     )
 
 
+def test_vm_save_load_file_with_constants():
+    ib = relax.ExecBuilder()
+    a = tvm.nd.array(np.random.rand(1000, 3).astype("float32"))
+    b = tvm.nd.array(np.random.rand(7))
+    with ib.function("main", num_inputs=0):
+        ib.emit_call("test.vm.add", args=[a, a], dst=ib.r(0))
+        ib.emit_call("test.vm.add", args=[b, b], dst=ib.r(1))
+        ib.emit_call("vm.builtin.make_tuple", args=[ib.r(0), ib.r(1)], dst=ib.r(2))
+        ib.emit_ret(ib.r(2))
+    ex = ib.get()
+
+    temp = utils.tempdir()
+    path = temp.relpath("exec.bin")
+    ex.mod.save(path)
+    # The constants of the loaded executable alias the mapped file where supported.
+    loaded = tvm.get_global_func("runtime.module.loadfile_relax.Executable")(path)
+    vm = relax.VirtualMachine(loaded, tvm.cpu())
+    res = vm["main"]()
+    tvm.testing.assert_allclose(res[0].numpy(), a.numpy() * 2, rtol=1e-7, atol=1e-7)
+    tvm.testing.assert_allclose(res[1].numpy(), b.numpy() * 2, rtol=1e-7, atol=1e-7)
+
+
 def test_vm_stack_restore_after_failure():
     @tvm.script.ir_module
     class Module:
@@ -98,5 +98,34 @@ def test_lib_comparator():
     vm["main"](tvm.nd.array(data_np))
 
 
+def test_memory_stats_instrument():
+    data_np = np.random.randn(1, 64).astype("float32")
+    ex = get_exec(data_np.shape)
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    dev = tvm.cpu()
+    records = []
+
+    def callback(name, stats):
+        records.append((name, int(stats["in_use_bytes"]), int(stats["alloc_count"])))
+
+    vm.set_instrument(
+        "vm.builtin.memory_manager.stats_instrument",
+        dev.device_type,
+        dev.device_id,
+        relax.VirtualMachine.POOLED_ALLOCATOR,
+        callback,
+    )
+    vm["main"](tvm.nd.array(data_np))
+    assert [name for name, _, _ in records].count("matmul") == 2
+    assert all(alloc_count > 0 for _, _, alloc_count in records)
+
+    stats = tvm.get_global_func("vm.builtin.memory_manager.stats")(
+        dev.device_type, dev.device_id, relax.VirtualMachine.POOLED_ALLOCATOR
+    )
+    assert stats["peak_reserved_bytes"] >= stats["reserved_bytes"]
+    assert stats["reserved_bytes"] == stats["in_use_bytes"] + stats["cached_bytes"]
+    assert len(stats["size_histogram"]) == 64
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -0,0 +1,104 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import time
+
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm import relax
+from tvm.runtime import ShapeTuple
+from tvm.script import ir as I
+from tvm.script import relax as R
+
+
+@I.ir_module
+class DynamicModule:
+    @R.function
+    def main(
+        x: R.Tensor(("n", "m"), "float32"), y: R.Tensor(("n", "m"), "float32")
+    ) -> R.Tensor(("n", "m"), "float32"):
+        z = R.add(x, y)
+        w = R.multiply(z, x)
+        return w
+
+
+def test_hot_signature_is_specialized():
+    vm = relax.TracingVirtualMachine(DynamicModule, "llvm", tvm.cpu(), hot_threshold=2)
+    for _ in range(4):
+        x_np = np.random.rand(4, 8).astype("float32")
+        y_np = np.random.rand(4, 8).astype("float32")
+        res = vm["main"](tvm.nd.array(x_np), tvm.nd.array(y_np))
+        tvm.testing.assert_allclose(res.numpy(), (x_np + y_np) * x_np, rtol=1e-6)
+    assert vm.num_specializations("main") == 1
+
+    # Other signatures fall back to the interpreter until they are hot themselves.
+    x_np = np.random.rand(3, 5).astype("float32")
+    y_np = np.random.rand(3, 5).astype("float32")
+    res = vm["main"](tvm.nd.array(x_np), tvm.nd.array(y_np))
+    tvm.testing.assert_allclose(res.numpy(), (x_np + y_np) * x_np, rtol=1e-6)
+    assert vm.num_specializations("main") == 1
+
+
+def test_max_specializations():
+    vm = relax.TracingVirtualMachine(
+        DynamicModule, "llvm", tvm.cpu(), hot_threshold=1, max_specializations=2
+    )
+    for n in range(1, 5):
+        x_np = np.random.rand(n, 2).astype("float32")
+        y_np = np.random.rand(n, 2).astype("float32")
+        res = vm["main"](tvm.nd.array(x_np), tvm.nd.array(y_np))
+        tvm.testing.assert_allclose(res.numpy(), (x_np + y_np) * x_np, rtol=1e-6)
+    assert vm.num_specializations("main") == 2
+
+
+
+def test_prim_func_specialize_hook():
+    mod = relax.transform.LegalizeOps()(DynamicModule)
+    vm = relax.VirtualMachine(relax.build(mod, "llvm"), tvm.cpu())
+    specializer = relax.PrimFuncSpecializer(mod, "llvm")
+    specialized = []
+
+    def hook(name, tensor_shapes, scalars):
+        func = specializer(name, tensor_shapes, scalars)
+        specialized.append((name, [tuple(shape) for shape in tensor_shapes]))
+        return func
+
+    vm.set_specialize_hook(hook, threshold=2)
+    x_np = np.random.rand(4, 8).astype("float32")
+    y_np = np.random.rand(4, 8).astype("float32")
+    for _ in range(50):
+        res = vm["main"](tvm.nd.array(x_np), tvm.nd.array(y_np))
+        tvm.testing.assert_allclose(res.numpy(), (x_np + y_np) * x_np, rtol=1e-6)
+        if len(specialized) == 2:
+            break
+        time.sleep(0.1)
+    assert sorted(specialized) == [
+        ("add", [(4, 8), (4, 8), (4, 8)]),
+        ("multiply", [(4, 8), (4, 8), (4, 8)]),
+    ]
+    # The variants are called once they are compiled.
+    res = vm["main"](tvm.nd.array(x_np), tvm.nd.array(y_np))
+    tvm.testing.assert_allclose(res.numpy(), (x_np + y_np) * x_np, rtol=1e-6)
+
+    func = specializer.specialize(mod["add"], [(2, 3), (2, 3), (2, 3)], ShapeTuple([]))
+    assert len(func.params) == len(mod["add"].params)
+    assert [int(dim) for dim in func.buffer_map[func.params[0]].shape] == [2, 3]
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -14,6 +14,8 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import json
+
 import numpy as np
 import tvm
 import tvm.testing
@@ -22,6 +24,7 @@ from tvm import relax, rpc
 from tvm.contrib import utils
 from tvm.relax.testing import nn
 from tvm.script import relax as R
+from tvm.utils.roofline import relax_roofline_from_existing, to_chrome_trace
 
 
 def get_exec(data_shape):
@@ -62,6 +65,85 @@ def test_conv2d_cpu():
     assert "matmul" in str(report)
 
 
+def test_roofline():
+    @tvm.script.ir_module
+    class Matmul:
+        @R.function
+        def main(x: R.Tensor(("n", 64), "float32"), w: R.Tensor((64, 64), "float32")):
+            return R.matmul(x, w)
+
+    target = tvm.target.Target("llvm -peak_gflops=100 -peak_bandwidth_gbps=10")
+    mod = relax.get_pipeline("zero")(Matmul)
+    ex = relax.build(mod, target, pipeline=relax.get_pipeline("default_build"))
+    vm = relax.VirtualMachine(ex, tvm.cpu(), profile=True)
+    x = tvm.nd.array(np.random.randn(16, 64).astype("float32"))
+    w = tvm.nd.array(np.random.randn(64, 64).astype("float32"))
+    report = relax_roofline_from_existing(vm.profile("main", x, w), mod, target)
+
+    calls = [call for call in report.calls if "Estimated FLOPs" in call]
+    assert len(calls) == 1
+    call = calls[0]
+    # The symbolic n is bound to 16 from the argument shapes.
+    assert call["Estimated FLOPs"].value == 2 * 16 * 64 * 64
+    assert call["Moved Bytes"].value == (16 * 64 + 64 * 64 + 16 * 64) * 4
+    expected_bound = "compute" if call["Arithmetic Intensity"].ratio > 100 / 10 else "memory"
+    assert str(call["Bound"]) == expected_bound
+    assert "Percent of Peak" in call
+
+    trace = json.loads(to_chrome_trace(report))
+    kernels = [event for event in trace["traceEvents"] if event["ph"] == "X"]
+    assert any("Estimated FLOPs" in event["args"] for event in kernels)
+
+
+def test_sampled_call_stats():
+    data_np = np.random.randn(1, 64).astype("float32")
+    ex = get_exec(data_np.shape)
+
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    tvm.runtime.profiling.reset_sampled_call_stats()
+    vm.set_sample_interval(3)
+    for _ in range(7):
+        vm["main"](tvm.nd.array(data_np))
+    vm.set_sample_interval(0)
+    vm["main"](tvm.nd.array(data_np))
+
+    stats = tvm.runtime.profiling.sampled_call_stats()
+    assert stats["dropped"] == 0
+    matmuls = [name for name in stats["functions"] if "matmul" in name]
+    assert matmuls
+    for name in matmuls:
+        hist = stats["functions"][name]
+        # The invocations 0, 3 and 6 are sampled.
+        assert hist["count"] == 3
+        assert sum(hist["buckets"]) == hist["count"]
+        assert hist["max_ns"] <= hist["total_ns"]
+
+
+def test_memory_timeline():
+    data_np = np.random.randn(1, 64).astype("float32")
+    ex = get_exec(data_np.shape)
+
+    vm = relax.VirtualMachine(ex, tvm.cpu())
+    vm.start_memory_timeline()
+    vm["main"](tvm.nd.array(data_np))
+    timeline = vm.stop_memory_timeline()
+
+    planned = [event for event in timeline.events if event["token"] >= 0]
+    assert planned
+    assert all(event["function"] == "main" and event["instr"] >= 0 for event in planned)
+    # The intermediate tensors are freed in the invocation, and the output is still live.
+    assert any(event["free_ns"] >= event["alloc_ns"] for event in planned)
+
+    (row,) = [row for row in timeline.compare_with_plan() if row["function"] == "main"]
+    assert 0 < row["static_peak_bytes"] <= row["planned_bytes"]
+    peak_bytes, live = timeline.peak()[str(planned[0]["device"])]
+    assert peak_bytes == sum(event["nbytes"] for event in live)
+    assert "main" in timeline.table()
+
+    trace = json.loads(timeline.to_chrome_trace())
+    assert any(event["ph"] == "C" for event in trace["traceEvents"])
+
+
 def with_rpc(ex, f, data_np):
     temp = utils.tempdir()
     path = temp.relpath("vm_library.so")
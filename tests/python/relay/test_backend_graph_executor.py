@@ -324,6 +324,58 @@ def test_reshape_nop():
     tvm.testing.assert_allclose(gmod.get_output(2).numpy(), z2_np)
 
 
+def test_graph_memory_arena():
+    x = relay.var("x", shape=(1, 64))
+    y = relay.exp(x)
+    y = relay.nn.relu(relay.concatenate([y, y, y, y], axis=1))
+    y = relay.sqrt(relay.abs(y))
+    y = relay.strided_slice(y, begin=[0, 0], end=[1, 32])
+    y = relay.exp(y)
+    z = relay.tanh(y)
+    func = relay.Function([x], z)
+    mod = tvm.IRModule.from_expr(func)
+    x_data = np.random.rand(1, 64).astype("float32")
+
+    def run(use_arena):
+        with tvm.transform.PassContext(
+            opt_level=0, config={"relay.backend.graph_memory_arena": use_arena}
+        ):
+            lib = relay.build(mod, "llvm")
+        gmod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+        gmod.set_input(x=x_data)
+        gmod.run()
+        return json.loads(lib.get_graph_json()), gmod.get_output(0).numpy()
+
+    graph, arena_out = run(True)
+    _, ref_out = run(False)
+    tvm.testing.assert_allclose(arena_out, ref_out)
+
+    attrs = graph["attrs"]
+    offsets = attrs["storage_offset"][1]
+    assert len(attrs["arena_size"][1]) == 1
+    # The input and the output are not packed.
+    storage_ids = attrs["storage_id"][1]
+    node_row_ptr = graph["node_row_ptr"]
+    assert offsets[storage_ids[node_row_ptr[graph["arg_nodes"][0]]]] == -1
+    head = graph["heads"][0]
+    assert offsets[storage_ids[node_row_ptr[head[0]] + head[1]]] == -1
+
+    packed_sizes = {}
+    for eid, sid in enumerate(storage_ids):
+        if offsets[sid] < 0:
+            continue
+        nbytes = 4 * int(np.prod(attrs["shape"][1][eid]))
+        packed_sizes[sid] = max(packed_sizes.get(sid, 0), nbytes)
+    assert len(packed_sizes) > 1
+    assert all(offsets[sid] % 64 == 0 for sid in packed_sizes)
+    assert attrs["arena_size"][1][0] < sum(packed_sizes.values())
+
+    # Without the config, the graph has no arena.
+    with tvm.transform.PassContext(opt_level=0):
+        lib = relay.build(mod, "llvm")
+    assert "storage_offset" not in json.loads(lib.get_graph_json())["attrs"]
+
+
 @tvm.testing.uses_gpu
 def test_gru_like():
     def unit(rnn_dim):
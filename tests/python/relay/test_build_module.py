@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import numpy as np
 import pytest
 
 import tvm
@@ -99,5 +100,31 @@ def test_schedule_record():
     check_schedule(graph_executor_factory)
 
 
+@tvm.testing.requires_llvm
+def test_aot_multi_stream():
+    """Test that an AOT entrypoint distributed over several streams gives the same results"""
+    x = relay.var("x", shape=(4, 8), dtype="float32")
+    left = relay.nn.relu(relay.add(x, relay.const(1.0)))
+    right = relay.nn.relu(relay.multiply(x, relay.const(2.0)))
+    func = relay.Function([x], relay.add(left, right))
+    mod = tvm.IRModule.from_expr(func)
+
+    with tvm.transform.PassContext(opt_level=3, disabled_pass=["FuseOps"]):
+        lib = relay.build(
+            mod,
+            tvm.target.Target("llvm"),
+            runtime=Runtime("cpp"),
+            executor=Executor("aot", {"num-streams": 2}),
+        )
+
+    dev = tvm.cpu(0)
+    aot_mod = tvm.runtime.executor.AotModule(lib["default"](dev))
+    data = np.random.uniform(-1, 1, size=(4, 8)).astype("float32")
+    aot_mod.set_input("x", data)
+    aot_mod.run()
+    expected = np.maximum(data + 1.0, 0) + np.maximum(data * 2.0, 0)
+    tvm.testing.assert_allclose(aot_mod.get_output(0).numpy(), expected, rtol=1e-5)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -39,6 +39,27 @@ def test_save_load():
     np.testing.assert_equal(param2["y"].numpy(), y)
 
 
+def test_save_load_aligned():
+    x = np.arange(20).astype("float32").reshape(10, 2)
+    y = np.ones((1, 2, 3)).astype("int8")
+    params = {"x": x, "y": y}
+    param_bytes = runtime.save_param_dict(params, alignment=64)
+    param2 = runtime.load_param_dict(param_bytes)
+    np.testing.assert_equal(param2["x"].numpy(), x)
+    np.testing.assert_equal(param2["y"].numpy(), y)
+
+    # The data of each parameter starts at a multiple of the alignment.
+    offset = bytes(param_bytes).find(x.tobytes())
+    assert offset > 0 and offset % 64 == 0
+
+    param_bytes[offset] ^= 0xFF
+    try:
+        runtime.load_param_dict(param_bytes)
+        assert False, "the corrupted parameters should not be loaded"
+    except tvm.TVMError as err:
+        assert "Checksum mismatch of parameter x" in str(err)
+
+
 def test_ndarray_reflection():
     # Make two `NDArrayWrapper`s that point to the same underlying array.
     np_array = np.random.uniform(size=(10, 2)).astype("float32")
@@ -91,5 +112,6 @@ def test_bigendian_rpc_param():
 
 if __name__ == "__main__":
     test_save_load()
+    test_save_load_aligned()
     test_ndarray_reflection()
     test_bigendian_rpc_param()
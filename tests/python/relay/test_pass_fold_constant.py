@@ -572,5 +572,26 @@ def test_pass_link_params():
     mod = tvm.relay.transform.FoldConstant()(mod)
 
 
+def test_fold_same_kernel():
+    """The calls of an operator on arguments of the same types share a kernel"""
+    weights = [np.random.rand(4, 8).astype("float32") for _ in range(4)]
+    x = relay.var("x", shape=(4, 8), dtype="float32")
+    outputs = []
+    for i, weight in enumerate(weights):
+        w = relay.multiply(relay.const(weight), relay.const(float(i + 1)))
+        outputs.append(relay.add(x, relay.cast(w, "float16").astype("float32")))
+    func = relay.Function([x], relay.Tuple(outputs))
+
+    # Apply the same pass object twice, so that its kernels are reused across modules.
+    fold = transform.FoldConstant()
+    for _ in range(2):
+        folded = run_opt_pass(func, fold)
+        for i, weight in enumerate(weights):
+            const = folded.body.fields[i].args[1]
+            assert isinstance(const, relay.Constant)
+            expected = (weight * (i + 1)).astype("float16").astype("float32")
+            tvm.testing.assert_allclose(const.data.numpy(), expected)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
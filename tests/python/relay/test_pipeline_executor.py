@@ -265,6 +265,7 @@ def get_manual_conf(mods, target):
     pipe_config1 = {
         "mod_idx": 0,
         "cpu_affinity": "0",
+        "forward_slots": 4,
         "output": [
             {"output_idx": 0, "dependencies": [{"mod_idx": 1, "input_name": "data_n_0"}]},
             {"output_idx": 1, "dependencies": [{"mod_idx": 2, "input_name": "data_n_2"}]},
@@ -284,6 +285,7 @@ def get_manual_conf(mods, target):
     pipe_config2 = {
         "mod_idx": 1,
         "cpu_affinity": "0",
+        "forward_slots": 4,
         "output": [
             {"output_idx": 0, "dependencies": [{"mod_idx": 2, "input_name": "data_n_1"}]},
         ],
@@ -302,6 +304,7 @@ def get_manual_conf(mods, target):
     pipe_config3 = {
         "mod_idx": 2,
         "cpu_affinity": "0",
+        "forward_slots": 4,
         "output": [{"output_idx": 0, "dependencies": [{"global_output_index": 0}]}],
     }
     mod_config[mods[2]] = {
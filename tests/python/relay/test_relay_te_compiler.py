@@ -21,6 +21,7 @@ import tvm.testing
 from tvm import relay
 from tvm import autotvm
 from tvm import topi
+from tvm.contrib import graph_executor
 from tvm.relay.backend import te_compiler
 from tvm.relay.testing import run_infer_type
 from tvm.relay.testing.temp_op_attr import TempOpAttr
@@ -284,6 +285,39 @@ def test_compile_propogate_hash():
         assert "hash" in f.attrs.keys()
 
 
+def test_compile_parallel_and_process_cache():
+    def get_mod():
+        x = relay.var("x", shape=(4, 16))
+        w = relay.var("w", shape=(16, 16))
+        y = relay.nn.relu(relay.nn.dense(x, w))
+        y = relay.exp(y) + relay.const(1.0)
+        y = relay.nn.softmax(relay.nn.dense(y, w))
+        return tvm.IRModule.from_expr(relay.Function([x, w], y))
+
+    def build(config):
+        with tvm.transform.PassContext(opt_level=3, config=config):
+            lib = relay.build(get_mod(), target="llvm")
+        dev = tvm.cpu()
+        module = graph_executor.GraphModule(lib["default"](dev))
+        module.set_input("x", x_np)
+        module.set_input("w", w_np)
+        module.run()
+        return sorted(lib.function_metadata.keys()), module.get_output(0).numpy()
+
+    x_np = np.random.uniform(size=(4, 16)).astype("float32")
+    w_np = np.random.uniform(size=(16, 16)).astype("float32")
+    names, expected = build({})
+    # The names of the functions do not depend on the threads lowering them, nor on the cache.
+    parallel = {"relay.backend.te_compiler_num_threads": 4}
+    cached = {"relay.backend.te_compiler_process_cache": True}
+    te_compiler.clear_process_cache()
+    for config in [parallel, cached, cached, {**parallel, **cached}]:
+        config_names, output = build(config)
+        assert config_names == names
+        tvm.testing.assert_allclose(output, expected, rtol=1e-5)
+    te_compiler.clear_process_cache()
+
+
 if __name__ == "__main__":
     test_get_valid_implementations()
     test_select_implementation()
@@ -293,3 +327,4 @@ if __name__ == "__main__":
     test_compile_tuple_dup()
     test_compile_full()
     test_compile_nhwc_pack()
+    test_compile_parallel_and_process_cache()
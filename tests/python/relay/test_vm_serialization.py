@@ -315,5 +315,30 @@ def test_dynamic_bcast():
         tvm.testing.assert_allclose(res.numpy(), res_np)
 
 
+def test_optimize_bytecode():
+    x = relay.var("x", shape=(10, 10))
+    y = relay.var("y", shape=(10, 10))
+    z = relay.exp(relay.add(x, y))
+    z = relay.If(relay.op.min(relay.op.greater(x, y)), relay.sqrt(z), relay.log(z))
+    mod = tvm.IRModule.from_expr(relay.Function([x, y], relay.add(z, x)))
+    x_data = np.random.rand(10, 10).astype("float32")
+    y_data = np.random.rand(10, 10).astype("float32")
+
+    exe = rly_vm.compile(mod, target="llvm")
+    with tvm.transform.PassContext(
+        opt_level=3, config={"relay.backend.vm_optimize_bytecode": True}
+    ):
+        opt_exe = rly_vm.compile(mod, target="llvm")
+    assert "alloc_invoke_packed" in opt_exe.bytecode
+    assert opt_exe.bytecode.count("move") <= exe.bytecode.count("move")
+    assert len(opt_exe.bytecode) < len(exe.bytecode)
+
+    expected = _vm.VirtualMachine(exe, tvm.cpu()).run(x_data, y_data)
+    code, lib = opt_exe.save()
+    des_exec = _vm.Executable.load_exec(code, lib)
+    res = _vm.VirtualMachine(des_exec, tvm.cpu()).run(x_data, y_data)
+    tvm.testing.assert_allclose(res.numpy(), expected.numpy())
+
+
 if __name__ == "__main__":
     tvm.testing.main()
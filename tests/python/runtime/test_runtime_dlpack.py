@@ -61,5 +61,22 @@ def test_from_dlpack_strided():
     np.testing.assert_equal(inp.numpy().reshape(2, 8), view.numpy())
 
 
+@tvm.testing.requires_package("torch")
+@tvm.testing.requires_cuda
+def test_dlpack_stream_handoff():
+    import torch
+
+    # The work of TVM on its current stream waits for the producer stream, and the consumer
+    # stream for the work of TVM, without synchronizing with the host.
+    stream = torch.cuda.Stream()
+    with torch.cuda.stream(stream):
+        x = torch.arange(1 << 20, device="cuda", dtype=torch.float32) * 2
+        a = tvm.nd.from_dlpack(x)
+    b = a.copyto(tvm.cuda(0))
+    with torch.cuda.stream(stream):
+        y = torch.from_dlpack(b) + 1
+    np.testing.assert_equal(y.cpu().numpy(), np.arange(1 << 20, dtype="float32") * 2 + 1)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
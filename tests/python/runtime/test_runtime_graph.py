@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 import tempfile
+import threading
 import tvm
 import tvm.testing
 from tvm import te, runtime
@@ -119,6 +120,71 @@ def test_graph_simple():
     check_sharing()
 
 
+@tvm.testing.requires_llvm
+def test_inter_op_parallelism():
+    # Independent towers, whose intermediate results share storage in the memory plan.
+    x = relay.var("x", shape=(16, 32))
+    w = relay.var("w", shape=(32, 32))
+    towers = []
+    for i in range(4):
+        y = relay.nn.dense(x, w)
+        y = relay.nn.relu(y + relay.const(float(i)))
+        y = relay.nn.dense(y, w)
+        towers.append(relay.tanh(y))
+    func = relay.Function([x, w], relay.concatenate(towers, axis=1))
+    lib = relay.build(func, target="llvm")
+
+    x_np = np.random.uniform(size=(16, 32)).astype("float32")
+    w_np = np.random.uniform(size=(32, 32)).astype("float32")
+    mod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    mod.run(x=x_np, w=w_np)
+    expected = mod.get_output(0).numpy()
+
+    mod.set_inter_op_parallelism(4, 1)
+    for _ in range(10):
+        mod.run(x=x_np, w=w_np)
+        tvm.testing.assert_allclose(mod.get_output(0).numpy(), expected, rtol=1e-5)
+    mod.set_inter_op_parallelism(1)
+    mod.run(x=x_np, w=w_np)
+    tvm.testing.assert_allclose(mod.get_output(0).numpy(), expected, rtol=1e-5)
+
+
+@tvm.testing.requires_llvm
+def test_graph_executor_pool():
+    batch_size = 4
+    x = relay.var("x", shape=(batch_size, 8))
+    w = relay.var("w", shape=(6, 8))
+    func = relay.Function([x, w], relay.nn.relu(relay.nn.dense(x, w)))
+    w_np = np.random.uniform(-1, 1, size=(6, 8)).astype("float32")
+    lib = relay.build(func, target="llvm", params={"w": w_np})
+
+    pool = graph_executor.create_pool(lib.get_graph_json(), lib.get_lib(), tvm.cpu(0), 2)
+    pool.load_params(runtime.save_param_dict(lib.get_params()))
+    assert pool.num_contexts == 2
+
+    def reference(x_np):
+        return np.maximum(x_np @ w_np.T, 0)
+
+    samples = [np.random.uniform(-1, 1, size=(1, 8)).astype("float32") for _ in range(10)]
+    results = [None] * len(samples)
+
+    def serve(i, batched):
+        if batched:
+            results[i] = pool.run_batched(x=samples[i])[0].numpy()
+        else:
+            x_np = np.repeat(samples[i], batch_size, axis=0)
+            results[i] = pool.run(x=x_np)[0].numpy()[:1]
+
+    for batched in [False, True]:
+        threads = [threading.Thread(target=serve, args=(i, batched)) for i in range(len(samples))]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        for sample, result in zip(samples, results):
+            tvm.testing.assert_allclose(result, reference(sample), rtol=1e-5, atol=1e-5)
+
+
 def test_load_unexpected_params():
     # Test whether graph_executor.load_params works if parameters
     # are provided that are not an expected input.
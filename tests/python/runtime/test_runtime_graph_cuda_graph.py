@@ -93,6 +93,15 @@ def test_graph_simple():
         out = mod.get_output(0, tvm.nd.empty((n,)))
         np.testing.assert_equal(out.numpy(), a + 1)
 
+        # rebind the input and output of the captured CUDA graph with zero copy
+        for i in range(3):
+            a = tvm.nd.array(np.random.uniform(size=(n,)).astype(A.dtype), dev)
+            b = tvm.nd.empty((n,), A.dtype, dev)
+            mod.set_input_zero_copy("x", a)
+            mod.set_output_zero_copy(0, b)
+            mod.run_cuda_graph()
+            np.testing.assert_equal(b.numpy(), a.numpy() + 1)
+
     check_verify()
 
 
@@ -21,6 +21,7 @@ import tvm
 from tvm import te
 from tvm.contrib.utils import tempdir
 from tvm.runtime.module import BenchmarkResult
+from tvm.script import ir as I, tir as T
 
 
 def test_min_repeat_ms():
@@ -57,6 +58,40 @@ def test_min_repeat_ms():
     assert ct > 10 + 2
 
 
+def test_batch_time_evaluator():
+    calls = []
+
+    @tvm.register_func("testing.batch_eval_f0", override=True)
+    def f0(x):
+        calls.append(0)
+
+    @tvm.register_func("testing.batch_eval_f1", override=True)
+    def f1(x):
+        time.sleep(0.01)
+        calls.append(1)
+
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def f0(x: T.Buffer((), "int32")):
+            T.evaluate(T.call_packed("testing.batch_eval_f0", x.data))
+
+        @T.prim_func
+        def f1(x: T.Buffer((), "int32")):
+            T.evaluate(T.call_packed("testing.batch_eval_f1", x.data))
+
+    func = tvm.build(Module, target="llvm")
+    x = tvm.nd.empty((), dtype="int32")
+    ftimer = func.batch_time_evaluator(["f0", "f1"], tvm.cpu(), number=1, repeat=3)
+    res = ftimer(x)
+
+    assert len(res) == 2
+    assert len(res[0].results) == 3 and len(res[1].results) == 3
+    assert res[0].max < res[1].min
+    # one warm up call each, then the order rotates in each repeat
+    assert calls == [0, 1, 0, 1, 1, 0, 0, 1]
+
+
 def test_benchmark_result():
     r = BenchmarkResult([1, 2, 2, 5])
     assert r.mean == 2.5
@@ -68,4 +103,5 @@ def test_benchmark_result():
 
 if __name__ == "__main__":
     test_min_repeat_ms()
+    test_batch_time_evaluator()
     test_benchmark_result()
@@ -22,6 +22,7 @@ import numpy as np
 import subprocess
 import tvm.testing
 from tvm.relay.backend import Runtime
+from tvm.script import tir as T
 import pytest
 
 runtime_py = """
@@ -168,6 +169,31 @@ def test_device_module_dump():
         check_stackvm(device)
 
 
+@tvm.testing.requires_cuda
+def test_lazy_import_module():
+    @T.prim_func
+    def add_one(A: T.Buffer((1024,), "float32"), B: T.Buffer((1024,), "float32")):
+        for bx in T.thread_binding(128, thread="blockIdx.x"):
+            for tx in T.thread_binding(8, thread="threadIdx.x"):
+                with T.block("B"):
+                    vi = T.axis.spatial(1024, bx * 8 + tx)
+                    B[vi] = A[vi] + T.float32(1)
+
+    temp = utils.tempdir()
+    path_dso = temp.relpath("lazy_lib.so")
+    lib = tvm.build(add_one, target="cuda")
+    with tvm.transform.PassContext(config={"target.lazy_import_modules": True}):
+        lib.export_library(path_dso)
+
+    loaded = tvm.runtime.load_module(path_dso)
+    assert loaded.imported_modules[0].type_key == "cuda"
+    dev = tvm.cuda(0)
+    a = tvm.nd.array(np.random.uniform(size=1024).astype("float32"), dev)
+    b = tvm.nd.array(np.zeros(1024, dtype="float32"), dev)
+    loaded["add_one"](a, b)
+    np.testing.assert_equal(b.numpy(), a.numpy() + 1)
+
+
 @tvm.testing.requires_llvm
 def test_combine_module_llvm():
     """Test combine multiple module into one shared lib."""
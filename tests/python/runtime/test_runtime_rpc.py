@@ -20,6 +20,7 @@ import os
 import stat
 import sys
 import tempfile
+import threading
 import time
 
 import pytest
@@ -34,6 +35,7 @@ from tvm.relay.backend import Runtime
 from tvm.contrib import utils, cc
 from tvm.rpc.tracker import Tracker
 from tvm.rpc.proxy import Proxy
+from tvm.rpc.socket_proxy import SocketProxy
 from tvm.script import ir as I, tir as T
 
 
@@ -181,6 +183,65 @@ def test_rpc_large_array():
     check_remote()
 
 
+@tvm.testing.requires_rpc
+@pytest.mark.parametrize("window", [1, 3])
+def test_rpc_windowed_copy(monkeypatch, window):
+    # copies split into many chunks which are kept in flight
+    monkeypatch.setenv("TVM_RPC_COPY_CHUNK_BYTES", "1000")
+    monkeypatch.setenv("TVM_RPC_COPY_WINDOW", str(window))
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+
+    dev = remote.cpu(0)
+    a_np = np.random.uniform(size=(37, 129)).astype("float32")
+    a = tvm.nd.array(a_np, dev)
+    np.testing.assert_equal(a.numpy(), a_np)
+
+
+@tvm.testing.requires_rpc
+def test_rpc_arg_cache():
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+    dev = remote.cpu(0)
+    f_get_or_alloc = remote.get_function("tvm.rpc.server.arg_cache_get_or_alloc")
+    a = f_get_or_alloc("a", dev, "float32", 4, 5)
+    assert a.shape == (4, 5)
+    a_np = a.numpy()
+    # the same key returns the same contents, other keys and shapes get new tensors
+    np.testing.assert_equal(f_get_or_alloc("a", dev, "float32", 4, 5).numpy(), a_np)
+    assert f_get_or_alloc("b", dev, "float32", 4, 5).shape == (4, 5)
+    assert f_get_or_alloc("a", dev, "float32", 20).shape == (20,)
+    remote.get_function("tvm.rpc.server.arg_cache_clear")()
+
+
+@tvm.testing.requires_rpc
+def test_rpc_multiplex():
+    server = rpc.Server()
+    remote = rpc.connect("127.0.0.1", server.port)
+    remote.set_multiplex(True)
+    fsleep = remote.get_function("rpc.test.sleep_on_device")
+    fexcept = remote.get_function("rpc.test.except")
+    results = {}
+
+    def run(dev_id):
+        results[dev_id] = fsleep(remote.cpu(dev_id), 0.5)
+
+    # the calls on different devices overlap on the server
+    start = time.time()
+    threads = [threading.Thread(target=run, args=(dev_id,)) for dev_id in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    assert results == {dev_id: dev_id for dev_id in range(4)}
+    assert time.time() - start < 1.5
+
+    # calls without a device and errors keep working
+    with pytest.raises(tvm.error.RPCError):
+        fexcept("abc")
+    assert fsleep(remote.cpu(1), 0) == 1
+
+
 @tvm.testing.skip_if_32bit(reason="skipping test for i386.")
 @tvm.testing.requires_rpc
 def test_rpc_echo():
@@ -692,6 +753,26 @@ def test_rpc_session_timeout_error(with_proxy):
     tracker.terminate()
 
 
+@tvm.testing.requires_rpc
+@pytest.mark.skipif(sys.platform != "linux", reason="the native proxy requires epoll")
+def test_rpc_socket_proxy():
+    proxy = SocketProxy(host="127.0.0.1", port=9000, port_end=10000, timeout=5)
+    server = rpc.Server(host=proxy.host, port=proxy.port, is_proxy=True, key="x1")
+    time.sleep(0.5)
+
+    for _ in range(2):
+        remote = rpc.connect(proxy.host, proxy.port, key="x1")
+        assert remote.get_function("rpc.test.addone")(10) == 11
+        dev = remote.cpu(0)
+        a_np = np.random.uniform(size=(1 << 20,)).astype("float32")
+        np.testing.assert_equal(tvm.nd.array(a_np, dev).numpy(), a_np)
+        del remote
+        time.sleep(0.5)
+
+    server.terminate()
+    proxy.terminate()
+
+
 @pytest.mark.parametrize("call_with_unused_argument", [True, False])
 def test_compiled_function_with_zero_arguments(call_with_unused_argument):
     """RPC functions do not require an argument
@@ -348,5 +348,26 @@ def test_buffer_realize_is_allocation():
     tvm.tir.analysis.verify_well_formed(mod)
 
 
+def test_incremental_verify_well_formed():
+    @T.prim_func
+    def func(A: T.Buffer((128,), "float32")):
+        for i in range(128):
+            A[i] = 0.0
+
+    @T.prim_func(check_well_formed=False)
+    def ill_formed():
+        i = T.int32()
+        with T.LetStmt(42, var=i):
+            T.evaluate(i)
+        T.evaluate(i)
+
+    verify = tvm.tir.analysis.incremental_verify_well_formed(assert_mode=False)
+    mod = tvm.IRModule({"func": func})
+    assert verify(mod)
+    assert verify(mod)
+    mod["ill_formed"] = ill_formed
+    assert not verify(mod)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
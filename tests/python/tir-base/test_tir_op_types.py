@@ -241,6 +241,14 @@ def test_op_ptx_cp_async_bulk():
     assert expr.op.name == "tir.ptx_cp_async_bulk"
 
 
+def test_op_ptx_cp_async_bulk_tensor():
+    buffer_shared = tir.decl_buffer([64, 64], "float16", scope="shared")
+    tensor_map = tir.Var("tensor_map", "handle")
+    expr = tir.ptx_cp_async_bulk_tensor("float16", buffer_shared.data, 0, tensor_map, 0, 64, 0)
+    assert expr.op.name == "tir.ptx_cp_async_bulk_tensor"
+    assert len(expr.args) == 6
+
+
 def test_op_ptx_commit_group():
     expr = tir.ptx_commit_group()
     assert expr.op.name == "tir.ptx_commit_group"
@@ -274,6 +282,38 @@ def test_op_ptx_arrive_barrier_expect_tx():
 def test_op_ptx_wait_barrier():
     expr = tir.ptx_wait_barrier(0)
     assert expr.op.name == "tir.ptx_wait_barrier"
+    expr = tir.ptx_wait_barrier(0, 1)
+    assert len(expr.args) == 2
+
+
+def test_op_ptx_wgmma():
+    buffer_shared = tir.decl_buffer([64, 64], "float16", scope="shared")
+    buffer_local = tir.decl_buffer([64], "float32", scope="local")
+    desc = tir.ptx_wgmma_encode_desc(buffer_shared.data, 0, 16, 1024, 128)
+    assert desc.op.name == "tir.ptx_wgmma_encode_desc"
+    assert desc.dtype == "uint64"
+    expr = tir.ptx_wgmma(
+        "float32",
+        "m64n128k16",
+        "row",
+        "col",
+        "fp16",
+        "fp16",
+        "fp32",
+        desc,
+        desc,
+        buffer_local.data,
+        0,
+        1,
+    )
+    assert expr.op.name == "tir.ptx_wgmma"
+
+
+def test_op_ptx_wgmma_sync():
+    assert tir.ptx_wgmma_fence().op.name == "tir.ptx_wgmma_fence"
+    assert tir.ptx_wgmma_commit_group().op.name == "tir.ptx_wgmma_commit_group"
+    assert tir.ptx_wgmma_wait_group(0).op.name == "tir.ptx_wgmma_wait_group"
+    assert tir.ptx_setmaxnreg(True, 232).op.name == "tir.ptx_setmaxnreg"
 
 
 def test_op_create_barriers():
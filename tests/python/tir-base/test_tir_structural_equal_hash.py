@@ -462,5 +462,32 @@ def test_all_nan_values_are_equivalent():
     assert tvm.ir.structural_hash(float_1) == tvm.ir.structural_hash(float_2)
 
 
+
+def test_structural_hash_cache():
+    x = te.var("x")
+    y = te.var("y")
+    closed = (tvm.tir.const(1, "int32") + 2) * 3
+    roots = [
+        closed,
+        closed + x,
+        x + closed,
+        tvm.tir.Let(y, closed, y + x),
+        tvm.tir.PrimFunc([x], tvm.tir.Evaluate(closed + x)),
+        tvm.runtime.convert([closed, closed + x, x]),
+    ]
+    expected = [
+        (tvm.ir.structural_hash(root, False), tvm.ir.structural_hash(root, True))
+        for root in roots
+    ]
+    with tvm.ir.StructuralHashCache():
+        for _ in range(2):
+            for root, (h0, h1) in zip(roots, expected):
+                assert tvm.ir.structural_hash(root, False) == h0
+                assert tvm.ir.structural_hash(root, True) == h1
+        # Cached subtrees are shared between roots.
+        with tvm.ir.StructuralHashCache():
+            other = tvm.tir.PrimFunc([y], tvm.tir.Evaluate(closed + y))
+            assert tvm.ir.structural_hash(other, True) == expected[4][1]
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -34,7 +34,12 @@ from tvm.tir.tensor_intrin.arm_cpu import (
     ARM_DOT_4x4_i8_SDOT_INTRIN,
 )
 from tvm.tir.tensor_intrin.rocm import AMDGPU_SDOT4_INTRIN
-from tvm.tir.tensor_intrin.x86 import VNNI_DOT_16x4_INTRIN, AVX512_DOT_16x4_INTRIN
+from tvm.tir.tensor_intrin.x86 import (
+    VNNI_DOT_16x4_INTRIN,
+    AVX512_DOT_16x4_INTRIN,
+    AMX_DOT_16x16x64_U8I8I32_INTRIN,
+    AMX_DOT_16x16x32_BF16BF16F32_INTRIN,
+)
 from tvm.tir.tensor_intrin.hexagon import VRMPY_u8u8i32_INTRIN, VDMPY_i16i16i32_INTRIN
 
 # fmt: off
@@ -629,6 +634,43 @@ def test_tensorize_avx512():
     tensorize_16x4_test(AVX512_DOT_16x4_INTRIN)
 
 
+@pytest.mark.parametrize(
+    "in_dtype,intrin",
+    [
+        ("uint8", AMX_DOT_16x16x64_U8I8I32_INTRIN),
+        ("bfloat16", AMX_DOT_16x16x32_BF16BF16F32_INTRIN),
+    ],
+)
+def test_tensorize_amx(in_dtype, intrin):
+    m, n, k = 128, 128, 128
+    lanes = 4 if in_dtype == "uint8" else 2
+    out_dtype = "int32" if in_dtype == "uint8" else "float32"
+    X = te.placeholder((m, k), name="X", dtype=in_dtype)
+    W = te.placeholder((n, k), name="W", dtype="int8" if in_dtype == "uint8" else in_dtype)
+    ak = te.reduce_axis((0, k), name="k")
+    matmul = te.compute(
+        (m, n),
+        lambda i, j: te.sum(X[i, ak].astype(out_dtype) * W[j, ak].astype(out_dtype), axis=ak),
+        name="compute",
+    )
+    func = te.create_prim_func([X, W, matmul])
+
+    sch = tir.Schedule(func, debug_mask="all")
+    block = sch.get_block("compute")
+    sch.transform_layout(block, "W", lambda j, k: [k // lanes, j, k % lanes])
+    i, j, k = sch.get_loops(block)
+
+    io, ii = sch.split(i, factors=[None, 16])
+    jo, ji = sch.split(j, factors=[None, 16])
+    ko, kio, kii = sch.split(k, factors=[None, 16, lanes])
+    sch.reorder(io, jo, ko, ii, ji, kio, kii)
+
+    sch.decompose_reduction(block, ko)
+    sch.tensorize(ii, intrin)
+
+    verify_trace_roundtrip(sch=sch, mod=func)
+
+
 def test_tensorize_arm_dot():
     m, n, k = 128, 128, 128
 
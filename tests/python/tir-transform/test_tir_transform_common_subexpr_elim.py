@@ -398,6 +398,27 @@ def test_semantic_equiv_associativity():
     _check(func_associativity, func_associativity_expected)
 
 
+# A long unrolled body, in which each store shares a computation with all the others
+def test_cse_long_unrolled_body():
+    x = te.var("x")
+    y = te.var("y")
+    buf = tvm.tir.decl_buffer((1024,), name="B")
+    stores = [tvm.tir.BufferStore(buf, (x + y) * (x - y) + k, [k]) for k in range(512)]
+    mod = tvm.IRModule.from_expr(
+        tvm.tir.PrimFunc([x, y, buf.data], tvm.tir.SeqStmt(stores)).with_attr(
+            "global_symbol", "main"
+        )
+    )
+    for identify_equiv_terms in [False, True]:
+        body = tvm.tir.transform.CommonSubexprElimTIR(identify_equiv_terms=identify_equiv_terms)(
+            mod
+        )["main"].body
+        assert isinstance(body, tvm.tir.LetStmt)
+        tvm.ir.assert_structural_equal(body.value, (x + y) * (x - y))
+        assert isinstance(body.body, tvm.tir.SeqStmt)
+        assert len(body.body) == 512
+
+
 # -----------------------------------------------------
 # Tests that verify the determinism of the pass
 # -----------------------------------------------------
@@ -503,6 +524,8 @@ if __name__ == "__main__":
     # Tests that turn on the equivalence of terms and verify the commoning with equivalences:
     test_semantic_equiv_distributivity()
     test_semantic_equiv_associativity()
+    # Test on a long unrolled body:
+    test_cse_long_unrolled_body()
     # Tests that verify the determinism of the pass:
     test_deterministic_cse()
     test_deterministic_cse_2()
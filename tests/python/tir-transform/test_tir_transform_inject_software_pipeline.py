@@ -1633,5 +1633,71 @@ def test_async_nested_pipeline_mma_gemm_ideal_annotation():
     build_and_run(sch)
 
 
+@T.prim_func
+def cpu_pipeline_with_prefetch(A: T.Buffer((64, 32), "float32"), C: T.Buffer((64,), "float32")):
+    for i in T.serial(
+        0,
+        64,
+        annotations={
+            "software_pipeline_stage": [0, 1],
+            "software_pipeline_order": [0, 1],
+            "software_pipeline_prefetch_distance": 4,
+        },
+    ):
+        with T.block():
+            T.reads(A[i, 0:32])
+            T.writes(C[i])
+            B = T.alloc_buffer((32,), dtype="float32")
+            for j in T.serial(32):
+                with T.block():
+                    T.reads(A[i, j])
+                    T.writes(B[j])
+                    B[j] = A[i, j] * T.float32(2)
+            with T.block():
+                T.reads(B[0:32])
+                T.writes(C[i])
+                C[i] = T.float32(0)
+                for j in T.serial(32):
+                    C[i] = C[i] + B[j]
+
+
+def test_cpu_pipeline_prefetch():
+    mod = tvm.IRModule.from_expr(cpu_pipeline_with_prefetch.with_attr("global_symbol", "main"))
+    mod = tvm.tir.transform.InjectSoftwarePipeline()(mod)
+
+    prefetches = []
+
+    def _visit(node):
+        if isinstance(node, tir.Call) and node.op.same_as(tvm.ir.Op.get("tir.prefetch")):
+            prefetches.append(node)
+
+    tvm.tir.stmt_functor.post_order_visit(mod["main"].body, _visit)
+    # The load stage is emitted in the prologue and in the body, B is never prefetched
+    assert len(prefetches) == 2
+    A = cpu_pipeline_with_prefetch.buffer_map[cpu_pipeline_with_prefetch.params[0]]
+    for prefetch in prefetches:
+        assert prefetch.args[0].args[0].buffer.same_as(A)
+
+
+@tvm.testing.requires_llvm
+def test_cpu_pipeline_prefetch_correctness():
+    func = cpu_pipeline_with_prefetch.with_attr("global_symbol", "main")
+    rt_mod = tvm.build(func, target="llvm")
+    a_np = np.random.uniform(size=(64, 32)).astype("float32")
+    a = tvm.nd.array(a_np)
+    c = tvm.nd.empty((64,), "float32")
+    rt_mod(a, c)
+    tvm.testing.assert_allclose(c.numpy(), (a_np * 2).sum(axis=1), rtol=1e-5)
+
+
+def test_error_negative_prefetch_distance():
+    func = cpu_pipeline_with_prefetch.with_attr("global_symbol", "main")
+    loop = func.body
+    annotations = dict(loop.annotations)
+    annotations["software_pipeline_prefetch_distance"] = -1
+    loop = tir.For(loop.loop_var, loop.min, loop.extent, loop.kind, loop.body, None, annotations)
+    _check_error(func.with_body(loop))
+
+
 if __name__ == "__main__":
     tvm.testing.main()
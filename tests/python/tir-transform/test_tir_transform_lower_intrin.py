@@ -14,6 +14,8 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import math
+
 import tvm
 import tvm.testing
 from tvm import te
@@ -119,6 +121,38 @@ def test_lower_floormod():
         check_value(res, x, y, [(a, b) for a, b in data if b == 8], lambda a, b: a % b)
 
 
+@tvm.testing.requires_llvm
+def test_lower_fast_math():
+    n = 64
+    for op, fref in [
+        (tvm.tir.exp, np.exp),
+        (tvm.tir.tanh, np.tanh),
+        (tvm.tir.erf, lambda x: np.array([math.erf(v) for v in x])),
+    ]:
+        A = te.placeholder((n,), name="A")
+        B = te.compute((n,), lambda i: op(A[i]), name="B")
+        func = te.create_prim_func([A, B]).with_attr("tir.fast_math", True)
+        mod = tvm.IRModule({"main": func.with_attr("target", tvm.target.Target("llvm"))})
+        lowered = tvm.tir.transform.LowerIntrin()(mod)
+
+        calls = []
+        tvm.tir.stmt_functor.post_order_visit(
+            lowered["main"].body,
+            lambda node: calls.append(node.op.name)
+            if isinstance(node, tvm.tir.Call) and isinstance(node.op, tvm.ir.Op)
+            else None,
+        )
+        assert op(A[0]).op.name not in calls
+
+        f = tvm.build(func, target="llvm")
+        a_np = np.random.uniform(-4, 4, size=n).astype("float32")
+        a = tvm.nd.array(a_np)
+        b = tvm.nd.array(np.zeros(n, dtype="float32"))
+        f(a, b)
+        tvm.testing.assert_allclose(b.numpy(), fref(a_np), rtol=1e-5, atol=1e-5)
+
+
 if __name__ == "__main__":
     test_lower_floordiv()
     test_lower_floormod()
+    test_lower_fast_math()
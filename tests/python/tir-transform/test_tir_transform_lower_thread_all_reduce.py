@@ -15,6 +15,8 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import pytest
+
 import tvm
 import tvm.testing
 from tvm.script import tir as T
@@ -767,5 +769,43 @@ class TestMetalNoMask(BaseCompare):
             B_1[threadIdx_y] = red_result_1[threadIdx_y]
 
 
+def _lower_with_strategy(strategy):
+    mod = tvm.IRModule.from_expr(TestBasic.before.with_attr("global_symbol", "main"))
+    with tvm.transform.PassContext(config={"tir.thread_allreduce_strategy": strategy}):
+        mod = tvm.tir.transform.LowerThreadAllreduce()(mod)
+
+    shuffles = []
+    shared_allocs = []
+
+    def _visit(node):
+        if isinstance(node, tvm.tir.Call) and node.op.name == "tir.tvm_warp_shuffle_down":
+            shuffles.append(node)
+        if isinstance(node, tvm.tir.Allocate):
+            if node.buffer_var.type_annotation.storage_scope == "shared":
+                shared_allocs.append(node)
+
+    tvm.tir.stmt_functor.post_order_visit(mod["main"].body, _visit)
+    return mod, shuffles, shared_allocs
+
+
+def test_allreduce_strategy_auto_selects_shuffle():
+    mod, shuffles, shared_allocs = _lower_with_strategy("auto")
+    assert len(shuffles) == 5
+    assert len(shared_allocs) == 0
+    forced, _, _ = _lower_with_strategy("shuffle")
+    tvm.ir.assert_structural_equal(mod, forced)
+
+
+def test_allreduce_strategy_forced_shared_memory():
+    _, shuffles, shared_allocs = _lower_with_strategy("shared_memory")
+    assert len(shuffles) == 0
+    assert len(shared_allocs) == 1
+
+
+def test_allreduce_strategy_invalid():
+    with pytest.raises(ValueError, match="tir.thread_allreduce_strategy"):
+        _lower_with_strategy("cluster")
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import numpy as np
 import pytest
 
 import tvm
@@ -353,6 +354,46 @@ def test_function_call_with_wrong_dimensionality():
         built(A, B)
 
 
+def test_trusted_entry():
+    """The trusted entry unpacks the arguments without checking them"""
+
+    @I.ir_module
+    class Module:
+        @T.prim_func
+        def main(A: T.Buffer([16], "float32"), B: T.Buffer([16], "float32")):
+            T.func_attr({"target": T.target("llvm", host="llvm"), "global_symbol": "main"})
+            for i in range(16):
+                B[i] = A[i]
+
+    def _num_asserts(func):
+        num_asserts = 0
+
+        def _visitor(stmt):
+            nonlocal num_asserts
+            if isinstance(stmt, tvm.tir.AssertStmt):
+                num_asserts += 1
+
+        tvm.tir.stmt_functor.post_order_visit(func.body, _visitor)
+        return num_asserts
+
+    assert "main_trusted" not in [gv.name_hint for gv in tvm.tir.transform.MakePackedAPI()(Module)]
+    with tvm.transform.PassContext(config={"tir.emit_trusted_entry": True}):
+        after = tvm.tir.transform.MakePackedAPI()(Module)
+
+    main, trusted = after["main"], after["main_trusted"]
+    assert trusted.attrs["global_symbol"] == "main_trusted"
+    assert len(trusted.params) == len(main.params)
+    assert _num_asserts(main) > 0
+    assert _num_asserts(trusted) == 0
+
+    with tvm.transform.PassContext(config={"tir.emit_trusted_entry": True}):
+        built = tvm.build(Module, target="llvm")
+    A = tvm.nd.array(np.arange(16, dtype="float32"))
+    B = tvm.nd.empty([16], "float32")
+    built["main_trusted"](A, B)
+    np.testing.assert_array_equal(B.numpy(), A.numpy())
+
+
 def test_zero_arg_function():
     """Only check non-null args when num_args>0"""
 
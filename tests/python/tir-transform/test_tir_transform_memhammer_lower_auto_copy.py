@@ -91,6 +91,32 @@ class SharedToGlobal:
                                     B[bx * 128 + ax0, by * 128 + ax1] = A_shared_dyn[ax1, ax0]
 
 
+@tvm.script.ir_module
+class GlobalToSharedInLoop:
+    @T.prim_func
+    def main(a: T.handle, b: T.handle) -> None:
+        A = T.match_buffer(a, [1024, 1024])
+        B = T.match_buffer(b, [1024, 128])
+        with T.block("root"):
+            T.block_attr({"warp_execution": True})
+            for bx in T.thread_binding(8, thread="blockIdx.x"):
+                for ty in T.thread_binding(8, thread="threadIdx.y"):
+                    for k in range(8):
+                        with T.block():
+                            A_shared_dyn = T.alloc_buffer(
+                                [128, 128], dtype="float32", scope="shared.dyn"
+                            )
+                            with T.block("A_shared"):
+                                T.block_attr({"auto_copy": 1, "vector_bytes": 16})
+                                for ax0, ax1 in T.grid(128, 128):
+                                    A_shared_dyn[ax0, ax1] = A[bx * 128 + ax0, k * 128 + ax1]
+                            with T.block("B"):
+                                for ax0, ax1 in T.grid(128, 128):
+                                    B[bx * 128 + ax0, ax1] = (
+                                        B[bx * 128 + ax0, ax1] + A_shared_dyn[ax0, ax1]
+                                    )
+
+
 @tvm.script.ir_module
 class GlobalToSharedWithLocalStage:
     @T.prim_func
@@ -1161,6 +1187,38 @@ def test_auto_padding():
     verify_single_allocation(mod["main"].body, 16 * 130)
 
 
+def _find_loop(stmt, loop_var):
+    loops = []
+
+    def visit(n):
+        if isinstance(n, tvm.tir.For) and n.loop_var.name == loop_var:
+            loops.append(n)
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, visit)
+    assert len(loops) == 1
+    return loops[0]
+
+
+@pytest.mark.parametrize("use_async_copy", [False, True])
+def test_multi_buffer_global_to_shared(use_async_copy):
+    config = {"tir.auto_copy_num_stages": 2, "tir.use_async_copy": use_async_copy}
+    with tvm.transform.PassContext(config=config):
+        mod = tvm.tir.transform.LowerAutoCopy()(GlobalToSharedInLoop)
+    loop = _find_loop(mod["main"].body, "k")
+    assert list(loop.annotations["software_pipeline_stage"]) == [0, 1]
+    assert list(loop.annotations["software_pipeline_order"]) == [0, 1]
+    if use_async_copy:
+        assert list(loop.annotations["software_pipeline_async_stages"]) == [0]
+    else:
+        assert "software_pipeline_async_stages" not in loop.annotations
+
+
+def test_no_multi_buffer_by_default():
+    mod = tvm.tir.transform.LowerAutoCopy()(GlobalToSharedInLoop)
+    loop = _find_loop(mod["main"].body, "k")
+    assert "software_pipeline_stage" not in loop.annotations
+
+
 def test_rewrite_wmma_to_global_fusion():
     _check(WmmaToGlobalWithFusion, TransformedWmmaToGlobalWithFusion)
 
@@ -1177,5 +1235,8 @@ if __name__ == "__main__":
     test_rewrite_wmma_to_shared()
     test_rewrite_wmma_to_global()
     test_auto_padding()
+    test_multi_buffer_global_to_shared(False)
+    test_multi_buffer_global_to_shared(True)
+    test_no_multi_buffer_by_default()
     test_rewrite_wmma_to_global_fusion()
     test_rewrite_mma_to_global()
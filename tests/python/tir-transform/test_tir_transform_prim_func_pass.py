@@ -63,6 +63,32 @@ def test_cow_pass():
     assert func_hash == mod["main"].__hash__()
 
 
+def test_parallel_prim_func_pass():
+    funcs = {}
+    for i in range(1, 9):
+        x = te.var("x")
+        funcs["func%d" % i] = tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x + i))
+    mod = tvm.IRModule(funcs)
+
+    def fadd_one(func, mod, ctx):
+        return func.with_body(tvm.tir.Evaluate(func.body.value + 1))
+
+    def fremove_odd(func, mod, ctx):
+        return None if func.body.value.a.b.value % 2 else func
+
+    passes = [
+        tvm.tir.transform.prim_func_pass(fadd_one, opt_level=0),
+        tvm.tir.transform.prim_func_pass(fremove_odd, opt_level=0),
+        tvm.tir.transform.Simplify(),
+    ]
+    with tvm.transform.PassContext(config={"ir.num_pass_threads": 4}):
+        parallel_mod = tvm.transform.Sequential(passes)(mod)
+    serial_mod = tvm.transform.Sequential(passes)(mod)
+    tvm.ir.assert_structural_equal(parallel_mod, serial_mod)
+    assert len(parallel_mod.functions) == 4
+
+
 if __name__ == "__main__":
+    test_parallel_prim_func_pass()
     test_cow_pass()
     test_prim_func_pass()
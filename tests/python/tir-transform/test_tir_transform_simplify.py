@@ -142,6 +142,9 @@ class BaseBeforeAfter(tvm.testing.CompareBeforeAfter):
     apply_constraints_to_boolean_branches = False
     propagate_knowns_to_prove_conditional = False
     propagate_knowns_to_simplify_expressions = False
+    control_flow_max_constraints_per_buffer = 0
+    control_flow_widening_threshold = 0
+    control_flow_max_regions_per_touch = 0
     # from base class
     check_well_formed = False
 
@@ -154,6 +157,9 @@ class BaseBeforeAfter(tvm.testing.CompareBeforeAfter):
                     "apply_constraints_to_boolean_branches": self.apply_constraints_to_boolean_branches,
                     "propagate_knowns_to_prove_conditional": self.propagate_knowns_to_prove_conditional,
                     "propagate_knowns_to_simplify_expressions": self.propagate_knowns_to_simplify_expressions,
+                    "control_flow_max_constraints_per_buffer": self.control_flow_max_constraints_per_buffer,
+                    "control_flow_widening_threshold": self.control_flow_widening_threshold,
+                    "control_flow_max_regions_per_touch": self.control_flow_max_regions_per_touch,
                 }
             }
             with tvm.transform.PassContext(config=config):
@@ -1255,6 +1261,19 @@ class TestSimplifyConditionalInLoopUsingBufferValue(BaseBeforeAfter):
             B[j] = 42
 
 
+class TestBoundedSimplifyConditionalInLoop(TestSimplifyConditionalInLoopUsingBufferValue):
+    """Like TestSimplifyConditionalInLoopUsingBufferValue, but with the
+    propagation of known values bounded.
+
+    A single constraint for each buffer is enough to prove the
+    conditional, so the limits do not lose the simplification.
+    """
+
+    control_flow_max_constraints_per_buffer = 1
+    control_flow_widening_threshold = 1
+    control_flow_max_regions_per_touch = 2
+
+
 class TestSimplifyUsingBufferAssumption(BaseBeforeAfter):
     """A T.assume may apply to a buffer's contents"""
 
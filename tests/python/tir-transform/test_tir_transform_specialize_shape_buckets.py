@@ -0,0 +1,134 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+@T.prim_func
+def tiled_scale(a: T.handle, b: T.handle):
+    n = T.int32()
+    A = T.match_buffer(a, (n,))
+    B = T.match_buffer(b, (n,))
+    for io in range(T.ceildiv(n, 32)):
+        for ii in range(32):
+            if io * 32 + ii < n:
+                B[io * 32 + ii] = A[io * 32 + ii] * T.float32(2)
+
+
+def _get_n(func):
+    return func.buffer_map[func.params[0]].shape[0]
+
+
+def _specialize(buckets):
+    func = tiled_scale.with_attr("tir.shape_buckets", buckets)
+    mod = tvm.IRModule.from_expr(func.with_attr("global_symbol", "main"))
+    mod = tvm.tir.transform.SpecializeShapeBuckets()(mod)
+    return tvm.tir.transform.Simplify()(mod)["main"]
+
+
+def _count_if(stmt):
+    num_if = [0]
+
+    def visit(node):
+        if isinstance(node, tvm.tir.IfThenElse):
+            num_if[0] += 1
+
+    tvm.tir.stmt_functor.post_order_visit(stmt, visit)
+    return num_if[0]
+
+
+def test_specialize_static_shape():
+    n = _get_n(tiled_scale)
+    func = _specialize([n == 64])
+    assert "tir.shape_buckets" not in func.attrs
+    dispatch = func.body
+    assert isinstance(dispatch, tvm.tir.IfThenElse)
+    # The static version has a constant trip count and no tail predicate.
+    assert isinstance(dispatch.then_case, tvm.tir.For)
+    assert int(dispatch.then_case.extent) == 2
+    assert _count_if(dispatch.then_case) == 0
+    assert _count_if(dispatch.else_case) == 1
+
+
+def test_specialize_divisible_shape():
+    n = _get_n(tiled_scale)
+    func = _specialize([tvm.tir.floormod(n, 32) == 0])
+    dispatch = func.body
+    assert isinstance(dispatch, tvm.tir.IfThenElse)
+    let = dispatch.then_case
+    assert isinstance(let, tvm.tir.LetStmt)
+    assert let.var.name == "n_div_32"
+    assert isinstance(let.body, tvm.tir.For)
+    assert let.body.extent.same_as(let.var)
+
+
+def test_dispatch_order():
+    n = _get_n(tiled_scale)
+    func = _specialize([n == 64, tvm.tir.floormod(n, 32) == 0])
+    assert isinstance(func.body, tvm.tir.IfThenElse)
+    assert isinstance(func.body.else_case, tvm.tir.IfThenElse)
+    assert isinstance(func.body.else_case.then_case, tvm.tir.LetStmt)
+
+
+def test_invalid_bucket():
+    with pytest.raises(tvm.TVMError, match="ValueError"):
+        _specialize([tvm.tir.Var("m", "int32") == 64])
+    n = _get_n(tiled_scale)
+    with pytest.raises(tvm.TVMError, match="ValueError"):
+        _specialize([n * 2 == 64])
+
+
+def test_shape_profile(tmp_path):
+    profile = tvm.tir.ShapeProfile()
+    for _ in range(6):
+        profile.record("main", {"n": 128})
+    for value in [96, 160, 50]:
+        profile.record("main", {"n": value})
+    buckets = profile.buckets("main", max_exact=1, min_coverage=0.2)
+    assert buckets == [{"n": ("eq", 128)}, {"n": ("mod", 32)}]
+
+    path = str(tmp_path / "profile.json")
+    profile.save(path)
+    loaded = tvm.tir.ShapeProfile.load(path)
+    assert loaded.buckets("main", max_exact=1, min_coverage=0.2) == buckets
+
+    mod = tvm.IRModule({"main": tiled_scale})
+    mod = profile.annotate(mod, max_exact=1, min_coverage=0.2)
+    assert len(mod["main"].attrs["tir.shape_buckets"]) == 2
+
+
+@tvm.testing.requires_llvm
+def test_build_and_run():
+    profile = tvm.tir.ShapeProfile()
+    func = tiled_scale.with_attr("global_symbol", "main")
+    for size in [64, 64, 96]:
+        profile.record_args("main", func, [tvm.nd.empty([size], "float32")] * 2)
+    mod = profile.annotate(tvm.IRModule({"main": func}))
+    built = tvm.build(mod, target="llvm")
+    for size in [64, 96, 50]:
+        a = tvm.nd.array(np.random.rand(size).astype("float32"))
+        b = tvm.nd.empty([size], "float32")
+        built(a, b)
+        tvm.testing.assert_allclose(b.numpy(), a.numpy() * 2)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
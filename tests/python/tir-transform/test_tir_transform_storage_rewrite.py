@@ -730,6 +730,45 @@ def test_access_in_let_value():
     tvm.ir.assert_structural_equal(mod["main"], func_rewritten.with_attr("global_symbol", "main"))
 
 
+def _symbolic_reuse_func(scope):
+    @T.prim_func
+    def func(a: T.handle, b: T.handle):
+        n = T.int32()
+        A = T.match_buffer(a, (n * 4,), "float32")
+        B = T.match_buffer(b, (n * 4,), "float32")
+        X_data = T.allocate([n], "float32", scope)
+        X = T.Buffer([n], "float32", data=X_data, scope=scope)
+        for i in range(n):
+            X[i] = A[i]
+        for i in range(n):
+            B[i] = X[i]
+        Y_data = T.allocate([n * 4], "float32", scope)
+        Y = T.Buffer([n * 4], "float32", data=Y_data, scope=scope)
+        for i in range(n * 4):
+            Y[i] = A[i] * T.float32(2)
+        for i in range(n * 4):
+            B[i] = Y[i] + B[i]
+
+    return func
+
+
+@pytest.mark.parametrize("scope", ["global", "local"])
+def test_reuse_symbolic_allocation(scope):
+    func = _symbolic_reuse_func(scope)
+    mod = tvm.IRModule.from_expr(func.with_attr("global_symbol", "main"))
+    mod = tvm.tir.transform.StorageRewrite()(mod)
+
+    allocs = []
+    tvm.tir.stmt_functor.post_order_visit(
+        mod["main"].body,
+        lambda n: allocs.append(n) if isinstance(n, tvm.tir.Allocate) else None,
+    )
+    # X is dead before Y is allocated, the larger Y provably covers it
+    assert len(allocs) == 1
+    n = func.buffer_map[func.params[0]].shape[0].a
+    tvm.ir.assert_structural_equal(allocs[0].extents[0], n * 4, map_free_vars=True)
+
+
 class BaseCompare(tvm.testing.CompareBeforeAfter):
     transform = tvm.tir.transform.StorageRewrite()
 
@@ -175,9 +175,79 @@ def test_unroll_local_access():
     tvm.ir.assert_structural_equal(after, Expected)
 
 
+def test_unroll_factor():
+    @tvm.script.ir_module
+    class Before:
+        @T.prim_func
+        def main(A: T.Buffer((10,), "float32")):
+            for i in T.serial(10, annotations={"pragma_unroll_factor": 4}):
+                A[i] = T.float32(0)
+
+    @tvm.script.ir_module
+    class Expected:
+        @T.prim_func
+        def main(A: T.Buffer((10,), "float32")):
+            for i_outer in range(2):
+                A[i_outer * 4] = T.float32(0)
+                A[i_outer * 4 + 1] = T.float32(0)
+                A[i_outer * 4 + 2] = T.float32(0)
+                A[i_outer * 4 + 3] = T.float32(0)
+            A[8] = T.float32(0)
+            A[9] = T.float32(0)
+
+    after = tvm.tir.transform.LowerOpaqueBlock()(Before)
+    after = tvm.tir.transform.UnrollLoop()(after)
+    after = tvm.tir.transform.Simplify()(after)
+    tvm.ir.assert_structural_equal(after, Expected)
+
+
+def test_unroll_and_jam():
+    @tvm.script.ir_module
+    class Before:
+        @T.prim_func
+        def main(A: T.Buffer((4, 16), "float32"), B: T.Buffer((4,), "float32")):
+            for i in T.serial(4, annotations={"pragma_unroll_and_jam": 2}):
+                for k in range(16):
+                    B[i] = B[i] + A[i, k]
+
+    @tvm.script.ir_module
+    class Expected:
+        @T.prim_func
+        def main(A: T.Buffer((4, 16), "float32"), B: T.Buffer((4,), "float32")):
+            for i_outer, k in T.grid(2, 16):
+                B[i_outer * 2] = B[i_outer * 2] + A[i_outer * 2, k]
+                B[i_outer * 2 + 1] = B[i_outer * 2 + 1] + A[i_outer * 2 + 1, k]
+
+    after = tvm.tir.transform.LowerOpaqueBlock()(Before)
+    after = tvm.tir.transform.UnrollLoop()(after)
+    after = tvm.tir.transform.Simplify()(after)
+    tvm.ir.assert_structural_equal(after, Expected)
+
+
+def test_unroll_register_pressure():
+    @tvm.script.ir_module
+    class Before:
+        @T.prim_func
+        def main(A: T.Buffer((64,), "float32"), B: T.Buffer((64,), "float32")):
+            for i in range(8):
+                B[i] = A[i] * A[i + 8]
+
+    def unrolled(config):
+        with tvm.transform.PassContext(config={"tir.UnrollLoop": config}):
+            body = tvm.tir.transform.UnrollLoop()(Before)["main"].body
+        return not isinstance(body, tvm.tir.For)
+
+    assert unrolled({"auto_max_step": 16})
+    assert unrolled({"auto_max_step": 16, "auto_max_register_pressure": 16})
+    assert not unrolled({"auto_max_step": 16, "auto_max_register_pressure": 15})
+
+
 if __name__ == "__main__":
     test_unroll_local_access()
     test_unroll_loop()
     test_unroll_fake_loop()
     test_unroll_single_count_loops()
     test_unroll_allocations()
+    test_unroll_factor()
+    test_unroll_and_jam()
+    test_unroll_register_pressure()
@@ -790,6 +790,46 @@ def test_vectorize_and_predicate_buffer_load_stores_with_sve_attr_scope_target()
     tvm.ir.assert_structural_equal(after, expected)
 
 
+@tvm.testing.requires_llvm
+def test_vectorize_and_predicate_offset_accesses_with_avx512_target():
+    avx512_target = tvm.target.Target("llvm -mtriple=x86_64-linux-gnu -mcpu=skylake-avx512")
+
+    @T.prim_func
+    def before(a: T.handle, b: T.handle):
+        A = T.match_buffer(a, (18,), "float32")
+        B = T.match_buffer(b, (16,), "float32")
+        T.func_attr({"global_symbol": "main", "tir.noalias": True, "target": avx512_target})
+        for i_0 in T.serial(T.ceildiv(14, 4)):
+            for i_1 in T.vectorized(4):
+                if i_0 * 4 + i_1 <= 13:
+                    B[i_0 * 4 + i_1] = A[i_0 * 4 + i_1 + 2] + 1.0
+
+    @T.prim_func
+    def expected(a: T.handle, b: T.handle):
+        A = T.match_buffer(a, (18,), "float32")
+        B = T.match_buffer(b, (16,), "float32")
+        T.func_attr(
+            {"global_symbol": "main", "tir.noalias": T.bool(True), "target": avx512_target}
+        )
+        for i_0 in range(4):
+            load_a = T.meta_var(
+                A.vload(
+                    [T.Ramp(i_0 * 4 + 2, 1, 4)],
+                    predicate=T.get_active_lane_mask("uint1x4", i_0 * 4, 14),
+                )
+            )
+            add_1 = T.meta_var(load_a + T.Broadcast(T.float32(1), 4))
+            B.vstore(
+                [T.Ramp(i_0 * 4, 1, 4)],
+                add_1,
+                predicate=T.get_active_lane_mask("uint1x4", i_0 * 4, 14),
+            )
+
+    mod = tvm.IRModule.from_expr(before)
+    after = tvm.tir.transform.VectorizeLoop()(mod)["main"]
+    tvm.ir.assert_structural_equal(after, expected)
+
+
 @pytest.mark.parametrize(
     "extent, vec_str, target",
     [(4, "float32x4", simple_target)],
@@ -566,5 +566,97 @@ def test_sum():
     tvm.ir.assert_structural_equal(mod, Expected)
 
 
+def _thread_tags(func):
+    tags = set()
+
+    def fvisit(node):
+        if isinstance(node, tvm.tir.For) and node.thread_binding is not None:
+            tags.add(node.thread_binding.thread_tag)
+        if isinstance(node, tvm.tir.For) and node.kind == tvm.tir.ForKind.VECTORIZED:
+            tags.add("vectorized")
+        if isinstance(node, tvm.tir.Block) and node.alloc_buffers:
+            tags.update(buf.scope() for buf in node.alloc_buffers)
+
+    tvm.tir.stmt_functor.post_order_visit(func.body, fvisit)
+    return tags
+
+
+def test_heuristic_schedule():
+    # pylint: disable=no-self-argument,missing-class-docstring
+    @tvm.script.ir_module
+    class Before:
+        @T.prim_func
+        def add(A: T.Buffer((1024, 1024), "float32"), B: T.Buffer((1024, 1024), "float32")):
+            for i, j in T.grid(1024, 1024):
+                with T.block("add"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vi, vj] + T.float32(1)
+
+        @T.prim_func
+        def transpose(A: T.Buffer((512, 256), "float32"), B: T.Buffer((256, 512), "float32")):
+            for i, j in T.grid(256, 512):
+                with T.block("transpose"):
+                    vi, vj = T.axis.remap("SS", [i, j])
+                    B[vi, vj] = A[vj, vi]
+
+        @T.prim_func
+        def gemv(
+            A: T.Buffer((4096, 4096), "float16"),
+            x: T.Buffer((4096,), "float16"),
+            y: T.Buffer((4096,), "float16"),
+        ):
+            for i, k in T.grid(4096, 4096):
+                with T.block("gemv"):
+                    vi, vk = T.axis.remap("SR", [i, k])
+                    with T.init():
+                        y[vi] = T.float16(0)
+                    y[vi] = y[vi] + A[vi, vk] * x[vk]
+
+        @T.prim_func
+        def batch_matmul(
+            A: T.Buffer((8, 128, 64), "float16"),
+            B: T.Buffer((8, 64, 128), "float16"),
+            C: T.Buffer((8, 128, 128), "float16"),
+        ):
+            for b, i, j, k in T.grid(8, 128, 128, 64):
+                with T.block("matmul"):
+                    vb, vi, vj, vk = T.axis.remap("SSSR", [b, i, j, k])
+                    with T.init():
+                        C[vb, vi, vj] = T.float16(0)
+                    C[vb, vi, vj] = C[vb, vi, vj] + A[vb, vi, vk] * B[vb, vk, vj]
+
+        @T.prim_func
+        def sum_symbolic(var_A: T.handle, var_B: T.handle):
+            n = T.int64()
+            A = T.match_buffer(var_A, (n, T.int64(7)), "float32")
+            B = T.match_buffer(var_B, (n,), "float32")
+            for i, k in T.grid(n, T.int64(7)):
+                with T.block("sum"):
+                    vi, vk = T.axis.remap("SR", [i, k])
+                    with T.init():
+                        B[vi] = T.float32(0)
+                    B[vi] = B[vi] + A[vi, vk]
+
+    # pylint: enable=no-self-argument,missing-class-docstring
+    target = tvm.target.Target("nvidia/geforce-rtx-3070")
+    with target, tvm.transform.PassContext(opt_level=0):
+        mod = DefaultGPUSchedule(heuristic=True)(Before)
+    for _, func in mod.functions.items():
+        assert func.attrs["tir.is_scheduled"]
+    assert _thread_tags(mod["add"]) == {"blockIdx.x", "threadIdx.x", "vectorized"}
+    assert _thread_tags(mod["transpose"]) == {"blockIdx.x", "threadIdx.x", "shared"}
+    assert _thread_tags(mod["gemv"]) == {"blockIdx.x", "threadIdx.x"}
+    assert _thread_tags(mod["batch_matmul"]) == {
+        "blockIdx.x",
+        "blockIdx.y",
+        "threadIdx.x",
+        "threadIdx.y",
+        "shared",
+        "local",
+    }
+    # The reduction is too short for the threads of a block, so it gets the default bindings.
+    assert _thread_tags(mod["sum_symbolic"]) == {"blockIdx.x", "threadIdx.x"}
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -183,5 +183,46 @@ def test_dense_cuda_int8(
         )
 
 
+@tvm.testing.parametrize_targets("llvm")
+@pytest.mark.parametrize("bits", [4, 8])
+@pytest.mark.parametrize("has_zero_point", [True, False])
+@pytest.mark.parametrize("num_tokens", [1, 5])
+def test_weight_only_dense(target, dev, bits, has_zero_point, num_tokens):
+    in_dim, out_dim, group_size = 96, 24, 32
+    num_groups = in_dim // group_size
+    np.random.seed(0)
+    a_np = np.random.uniform(-1, 1, (num_tokens, in_dim)).astype("float32")
+    scale_np = np.random.uniform(0.01, 0.1, (out_dim, num_groups)).astype("float32")
+    if bits == 4:
+        q_np = np.random.randint(0, 16, (out_dim, in_dim))
+        w_np = (q_np[:, 0::2] | (q_np[:, 1::2] << 4)).astype("uint8")
+        zero_np = np.random.randint(0, 16, (out_dim, num_groups)).astype("float32")
+        default_zero = 8
+    else:
+        q_np = np.random.randint(-128, 128, (out_dim, in_dim))
+        w_np = q_np.astype("int8")
+        zero_np = np.random.randint(-8, 8, (out_dim, num_groups)).astype("float32")
+        default_zero = 0
+    zero = zero_np if has_zero_point else np.full_like(zero_np, default_zero)
+    dequantized = (q_np - np.repeat(zero, group_size, axis=1)) * np.repeat(
+        scale_np, group_size, axis=1
+    )
+    ref = a_np @ dequantized.T.astype("float32")
+
+    A = te.placeholder((num_tokens, in_dim), name="A")
+    W = te.placeholder(w_np.shape, w_np.dtype, name="W")
+    S = te.placeholder(scale_np.shape, name="S")
+    Z = te.placeholder(zero_np.shape, name="Z") if has_zero_point else None
+    C = topi.nn.weight_only_dense(A, W, S, Z, bits=bits, group_size=group_size)
+    args = [A, W, S] + ([Z] if has_zero_point else []) + [C]
+    func = tvm.build(te.create_prim_func(args), target=target)
+
+    arrays = [a_np, w_np, scale_np] + ([zero_np] if has_zero_point else [])
+    arrays = [tvm.nd.array(arr, dev) for arr in arrays]
+    c = tvm.nd.empty((num_tokens, out_dim), "float32", dev)
+    func(*arrays, c)
+    tvm.testing.assert_allclose(c.numpy(), ref, rtol=1e-4, atol=1e-4)
+
+
 if __name__ == "__main__":
     tvm.testing.main()
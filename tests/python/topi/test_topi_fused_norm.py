@@ -0,0 +1,128 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Test code for the normalizations fused with the residual add and the quantization."""
+import numpy as np
+import pytest
+import tvm
+from tvm import dlight as dl
+from tvm import te
+from tvm import topi
+import tvm.topi.testing
+
+import tvm.testing
+
+
+def _build(outs, args, target):
+    mod = tvm.IRModule({"main": te.create_prim_func(args + outs)})
+    target = tvm.target.Target(target)
+    if target.kind.name != "llvm":
+        with target:
+            mod = dl.ApplyDefaultSchedule(  # pylint: disable=not-callable
+                dl.gpu.GeneralReduction(), dl.gpu.Fallback()
+            )(mod)
+    return tvm.build(mod, target=target)
+
+
+def _quantize(x, quant_scale):
+    return np.clip(np.round(x / quant_scale), -128, 127).astype("int8")
+
+
+@tvm.testing.parametrize_targets("llvm", "cuda")
+@pytest.mark.parametrize("shape,axis", [([4, 16], (1,)), ([4, 16, 16], (1, 2)), ([2, 4096], (1,))])
+@pytest.mark.parametrize("dtype", ["float32", "float16"])
+@pytest.mark.parametrize("quant_scale", [None, 0.05])
+def test_add_rms_norm(target, dev, shape, axis, dtype, quant_scale, epsilon=1e-5):
+    scale_shape = [shape[dim] for dim in axis]
+    data = te.placeholder(shape, dtype=dtype, name="data")
+    residual = te.placeholder(shape, dtype=dtype, name="residual")
+    weight = te.placeholder(scale_shape, dtype=dtype, name="weight")
+    out, residual_sum = topi.nn.add_rms_norm(data, residual, weight, axis, epsilon, quant_scale)
+    f = _build([out, residual_sum], [data, residual, weight], target)
+
+    data_np = np.random.uniform(-1, 1, size=shape).astype(dtype)
+    residual_np = np.random.uniform(-1, 1, size=shape).astype(dtype)
+    weight_np = np.random.uniform(size=scale_shape).astype(dtype)
+    sum_np = data_np + residual_np
+    out_np = tvm.topi.testing.rms_norm_python(sum_np.astype("float32"), weight_np, axis, epsilon)
+
+    out_tvm = tvm.nd.empty(shape, out.dtype, dev)
+    sum_tvm = tvm.nd.empty(shape, dtype, dev)
+    f(
+        tvm.nd.array(data_np, dev),
+        tvm.nd.array(residual_np, dev),
+        tvm.nd.array(weight_np, dev),
+        out_tvm,
+        sum_tvm,
+    )
+    tvm.testing.assert_allclose(sum_tvm.numpy(), sum_np)
+    if quant_scale is None:
+        tvm.testing.assert_allclose(out_tvm.numpy(), out_np.astype(dtype), rtol=5e-3, atol=5e-3)
+    else:
+        # Values close to a rounding boundary may round either way.
+        diff = out_tvm.numpy().astype("int32") - _quantize(out_np, quant_scale).astype("int32")
+        assert np.abs(diff).max() <= 1
+
+
+@tvm.testing.parametrize_targets("llvm", "cuda")
+@pytest.mark.parametrize("shape,axis", [([4, 16], (1,)), ([4, 16, 16], (1, 2)), ([2, 4096], (1,))])
+@pytest.mark.parametrize("dtype", ["float32", "float16"])
+@pytest.mark.parametrize("quant_scale", [None, 0.05])
+def test_add_layer_norm(target, dev, shape, axis, dtype, quant_scale, epsilon=1e-5):
+    scale_shape = [shape[dim] for dim in axis]
+    data = te.placeholder(shape, dtype=dtype, name="data")
+    residual = te.placeholder(shape, dtype=dtype, name="residual")
+    gamma = te.placeholder(scale_shape, dtype=dtype, name="gamma")
+    beta = te.placeholder(scale_shape, dtype=dtype, name="beta")
+    out, residual_sum = topi.nn.add_layer_norm(
+        data, residual, gamma, beta, axis, epsilon, quant_scale
+    )
+    f = _build([out, residual_sum], [data, residual, gamma, beta], target)
+
+    # An offset mean, on which E[x^2] - E[x]^2 would lose the variance.
+    data_np = np.random.uniform(99, 101, size=shape).astype(dtype)
+    residual_np = np.random.uniform(-1, 1, size=shape).astype(dtype)
+    gamma_np = np.random.uniform(size=scale_shape).astype(dtype)
+    beta_np = np.random.uniform(size=scale_shape).astype(dtype)
+    sum_np = data_np + residual_np
+    out_np = tvm.topi.testing.layer_norm_python(
+        sum_np.astype("float32"),
+        gamma_np.astype("float32"),
+        beta_np.astype("float32"),
+        axis,
+        epsilon,
+    )
+
+    out_tvm = tvm.nd.empty(shape, out.dtype, dev)
+    sum_tvm = tvm.nd.empty(shape, dtype, dev)
+    f(
+        tvm.nd.array(data_np, dev),
+        tvm.nd.array(residual_np, dev),
+        tvm.nd.array(gamma_np, dev),
+        tvm.nd.array(beta_np, dev),
+        out_tvm,
+        sum_tvm,
+    )
+    tvm.testing.assert_allclose(sum_tvm.numpy(), sum_np)
+    if quant_scale is None:
+        tvm.testing.assert_allclose(out_tvm.numpy(), out_np.astype(dtype), rtol=5e-3, atol=5e-3)
+    else:
+        diff = out_tvm.numpy().astype("int32") - _quantize(out_np, quant_scale).astype("int32")
+        assert np.abs(diff).max() <= 1
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
@@ -62,6 +62,22 @@ def test_failed_invalid_prefix():
         mod.script(ir_prefix="2I")
 
 
+def test_write_script(tmp_path):
+    with IRBuilder() as ib:  # pylint: disable=invalid-name
+        with I.ir_module():
+            for name in ["main", "foo", "bar"]:
+                with T.prim_func():
+                    T.func_name(name)
+    mod = ib.get()
+    expected = mod.script()
+    assert mod.write_script() == expected
+    assert mod.write_script(num_threads=4) == expected
+    assert mod.write_script(tir_prefix="tir") == mod.script(tir_prefix="tir")
+    path = tmp_path / "module.py"
+    mod.write_script(str(path), num_threads=2)
+    assert path.read_text() == expected
+
+
 if __name__ == "__main__":
     test_ir_module()
     test_failed_invalid_prefix()
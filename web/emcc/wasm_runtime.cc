@@ -67,6 +67,12 @@
 
 // --- Implementations of backend and wasm runtime API. ---
 
+#if defined(__EMSCRIPTEN_PTHREADS__)
+// With wasm threads, the parallel launches run on the thread pool, whose threads are Web Workers
+// sharing the memory of the instance through a SharedArrayBuffer.
+#include "src/runtime/thread_pool.cc"
+#include "src/runtime/threading_backend.cc"
+#else
 int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_task) {
   TVMParallelGroupEnv env;
   env.num_task = 1;
@@ -75,6 +81,7 @@ int TVMBackendParallelLaunch(FTVMParallelLambda flambda, void* cdata, int num_ta
 }
 
 int TVMBackendParallelBarrier(int task_id, TVMParallelGroupEnv* penv) { return 0; }
+#endif
 
 // --- Environment PackedFuncs for testing ---
 namespace tvm {
@@ -389,10 +389,27 @@ export class WebGPUContext {
   // internal data
   private bufferTable: Array<GPUBuffer | undefined> = [undefined];
   private bufferTableFreeId: Array<number> = [];
-  private podArgStagingBuffers: Array<GPUBuffer> = [];
+  // version of each buffer table entry, bumped when the entry is freed,
+  // so that the cached bind groups never refer to a freed buffer.
+  private bufferTableVersion: Array<number> = [0];
   private canvasRenderManager?: CanvasRenderManager = undefined;
-  // number of pod arg staging buffers
-  private maxNumPodArgsStagingBuffers = 2;
+  // the dispatches are encoded into one compute pass,
+  // which is submitted once it holds maxDispatchesPerSubmit dispatches,
+  // or before any other queue operation.
+  maxDispatchesPerSubmit = 64;
+  private pendingEncoder?: GPUCommandEncoder = undefined;
+  private pendingComputePass?: GPUComputePassEncoder = undefined;
+  private numPendingDispatches = 0;
+  // the pod arguments of the pending dispatches, written to the pod arg buffer on submit.
+  private podArgsBuffer?: GPUBuffer = undefined;
+  private podArgsHostData: ArrayBuffer = new ArrayBuffer(64 * 256);
+  private podArgsOffset = 0;
+  private podArgsGeneration = 0;
+  // the maximum number of cached bind groups per shader
+  private maxCachedBindGroups = 256;
+  // staging buffers reused by the reads from the GPU, at most two at a time.
+  private readStagingBuffers: Array<GPUBuffer> = [];
+  private maxNumReadStagingBuffers = 2;
   // flags for debugging
   // stats of the runtime.
   // peak allocation
@@ -403,6 +420,10 @@ export class WebGPUContext {
   private allAllocatedBytes = 0;
   // shader submit counter
   private shaderSubmitCounter = 0;
+  // queue submit counter
+  private queueSubmitCounter = 0;
+  // bind group cache hit counter
+  private bindGroupCacheHitCounter = 0;
   // limite number of shaders to be submitted, useful for debugging, default to -1
   protected debugShaderSubmitLimit = -1;
   // log and sync each step
@@ -417,13 +438,16 @@ export class WebGPUContext {
    * Dispose context.
    */
   dispose() {
+    this.flushPendingCommands();
     this.canvasRenderManager?.dispose();
     this.bufferTableFreeId = [];
     while (this.bufferTable.length != 0) {
       this.bufferTable.pop()?.destroy();
     }
-    while (this.podArgStagingBuffers.length != 0) {
-      this.podArgStagingBuffers.pop()?.destroy();
+    this.podArgsBuffer?.destroy();
+    this.podArgsBuffer = undefined;
+    while (this.readStagingBuffers.length != 0) {
+      this.readStagingBuffers.pop()?.destroy();
     }
     this.device.destroy();
   }
@@ -432,6 +456,7 @@ export class WebGPUContext {
    * Wait for all pending GPU tasks to complete
    */
   async sync(): Promise<void> {
+    this.flushPendingCommands();
     await this.device.queue.onSubmittedWorkDone();
   }
 
@@ -442,6 +467,8 @@ export class WebGPUContext {
     let info = "peak-memory=" + Math.ceil(this.peakAllocatedBytes / (1 << 20)) + " MB";
     info += ", all-memory=" + Math.ceil(this.allAllocatedBytes / (1 << 20)) + " MB";
     info += ", shader-submissions=" + this.shaderSubmitCounter;
+    info += ", queue-submissions=" + this.queueSubmitCounter;
+    info += ", bind-group-cache-hits=" + this.bindGroupCacheHitCounter;
     return info;
   }
 
@@ -455,6 +482,7 @@ export class WebGPUContext {
     if (this.canvasRenderManager == undefined) {
       throw Error("Do not have a canvas context, call bindCanvas first");
     }
+    this.flushPendingCommands();
     this.canvasRenderManager.draw(this.gpuBufferFromPtr(ptr), height, width);
   }
 
@@ -472,6 +500,8 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
+    // keep the write ordered after the pending dispatches.
+    this.flushPendingCommands();
     // Perhaps it would be more useful to use a staging buffer?
     this.device.queue.writeBuffer(
       this.gpuBufferFromPtr(toPtr),
@@ -485,6 +515,7 @@ export class WebGPUContext {
    * Clear canvas
    */
   clearCanvas() {
+    this.flushPendingCommands();
     this.canvasRenderManager?.clear();
   }
 
@@ -521,37 +552,83 @@ export class WebGPUContext {
   }
 
   /**
-   * Get the pod arg staging buffer
-   * \param nbytes The minimum size.
-   * \return The allocated buffer
+   * Get the compute pass of the pending command encoder, creating both if needed.
+   * @returns The pending compute pass.
    */
-  private getPodArgsBuffer(nbytes: number): GPUBuffer {
-    let buffer: GPUBuffer | undefined = undefined;
-    if (this.podArgStagingBuffers.length >= this.maxNumPodArgsStagingBuffers) {
-      buffer = this.podArgStagingBuffers.shift();
+  private getPendingComputePass(): GPUComputePassEncoder {
+    if (this.pendingEncoder === undefined) {
+      this.pendingEncoder = this.device.createCommandEncoder();
     }
-    // minimum of 16 bytes
-    let allocSize = 16;
-    if (buffer !== undefined) {
-      allocSize = buffer.size;
-      if (buffer.size < nbytes) {
-        buffer.destroy();
-        buffer = undefined;
-      }
+    if (this.pendingComputePass === undefined) {
+      this.pendingComputePass = this.pendingEncoder.beginComputePass();
     }
-    while (allocSize < nbytes) {
-      allocSize *= 2;
+    return this.pendingComputePass;
+  }
+
+  /**
+   * Get the pending command encoder with its compute pass ended,
+   * so that copies can be encoded after the pending dispatches.
+   * @returns The pending command encoder.
+   */
+  private getPendingCopyEncoder(): GPUCommandEncoder {
+    this.pendingComputePass?.end();
+    this.pendingComputePass = undefined;
+    if (this.pendingEncoder === undefined) {
+      this.pendingEncoder = this.device.createCommandEncoder();
     }
+    return this.pendingEncoder;
+  }
 
-    if (buffer == undefined) {
-      // create uniform buffer
-      buffer = tryCreateBuffer(this.device, {
+  /**
+   * Reserve the pod arguments of a dispatch in the pending batch.
+   * Flushes the pending commands first when the pod arg buffer is full.
+   *
+   * @param nbytes The number of bytes of the pod arguments.
+   * @returns The offset of the pod arguments in the pod arg buffer.
+   */
+  private reservePodArgs(nbytes: number): number {
+    const alignment = this.device.limits.minUniformBufferOffsetAlignment;
+    let offset = Math.ceil(this.podArgsOffset / alignment) * alignment;
+    if (offset + nbytes > this.podArgsHostData.byteLength) {
+      this.flushPendingCommands();
+      offset = 0;
+    }
+    if (this.podArgsBuffer === undefined || nbytes > this.podArgsHostData.byteLength) {
+      // The buffer only changes between batches, as the pending bind groups refer to it.
+      let allocSize = Math.max(this.podArgsHostData.byteLength, 16);
+      while (allocSize < nbytes) {
+        allocSize *= 2;
+      }
+      this.podArgsBuffer?.destroy();
+      this.podArgsBuffer = tryCreateBuffer(this.device, {
         size: allocSize,
         usage: GPUBufferUsage.UNIFORM | GPUBufferUsage.COPY_DST,
       });
+      this.podArgsHostData = new ArrayBuffer(allocSize);
+      this.podArgsGeneration += 1;
     }
-    assert(nbytes <= buffer.size);
-    return buffer;
+    this.podArgsOffset = offset + nbytes;
+    return offset;
+  }
+
+  /**
+   * Submit the pending command encoder, along with the pod arguments of its dispatches.
+   */
+  private flushPendingCommands(): void {
+    if (this.pendingEncoder === undefined) {
+      return;
+    }
+    this.pendingComputePass?.end();
+    if (this.podArgsBuffer !== undefined && this.podArgsOffset != 0) {
+      this.device.queue.writeBuffer(
+        this.podArgsBuffer, 0, this.podArgsHostData, 0, this.podArgsOffset);
+    }
+    this.device.queue.submit([this.pendingEncoder.finish()]);
+    this.pendingEncoder = undefined;
+    this.pendingComputePass = undefined;
+    this.numPendingDispatches = 0;
+    this.podArgsOffset = 0;
+    this.queueSubmitCounter += 1;
   }
 
   /**
@@ -611,12 +688,14 @@ export class WebGPUContext {
     }
 
     assert(paramWriteAccess.length == bufferArgIndices.length);
-    // POD arguments are pass in the end
+    // POD arguments are pass in the end,
+    // at a dynamic offset of the pod arg buffer of the batch.
     layoutEntries.push({
       binding: bufferArgIndices.length,
       visibility: GPUShaderStage.COMPUTE,
       buffer: {
-        type: "uniform"
+        type: "uniform",
+        hasDynamicOffset: true
       }
     });
 
@@ -629,6 +708,8 @@ export class WebGPUContext {
 
     // Function to create the pipeline.
     const createShaderFunc = (pipeline: GPUComputePipeline): Function => {
+      // bind groups keyed by the buffer arguments and the pod arg buffer
+      const bindGroupCache = new Map<string, GPUBindGroup>();
       const submitShader = (...args: Array<GPUPointer | number>): void => {
         if (this.debugShaderSubmitLimit != -1 &&
           this.shaderSubmitCounter >= this.debugShaderSubmitLimit) {
@@ -636,10 +717,6 @@ export class WebGPUContext {
           return;
         }
 
-        const commandEncoder = this.device.createCommandEncoder();
-        const compute = commandEncoder.beginComputePass();
-        compute.setPipeline(pipeline);
-        const bindGroupEntries: Array<GPUBindGroupEntry> = [];
         const numBufferOrPodArgs = bufferArgIndices.length + podArgIndices.length;
 
         assert(args.length == numBufferOrPodArgs + dispatchToDim.length);
@@ -673,21 +750,14 @@ export class WebGPUContext {
           assert(wl_x * wl_z >= packDimX);
         }
 
-        for (let i = 0; i < bufferArgIndices.length; ++i) {
-          bindGroupEntries.push({
-            binding: i,
-            resource: {
-              buffer: this.gpuBufferFromPtr(args[bufferArgIndices[i]])
-            }
-          });
-        }
-
-        // push pod buffer
+        // push pod args, reserving them first as it may flush the pending commands.
         const sizeOfI32 = 4;
-        const podArgBuffer = this.getPodArgsBuffer((podArgIndices.length + 1) * sizeOfI32);
-        const i32View = new Int32Array(podArgIndices.length + 1);
-        const u32View = new Uint32Array(i32View.buffer);
-        const f32View = new Float32Array(i32View.buffer);
+        const numPodArgs = podArgIndices.length + 1;
+        const podArgsBytes = numPodArgs * sizeOfI32;
+        const podArgsOffset = this.reservePodArgs(podArgsBytes);
+        const i32View = new Int32Array(this.podArgsHostData, podArgsOffset, numPodArgs);
+        const u32View = new Uint32Array(this.podArgsHostData, podArgsOffset, numPodArgs);
+        const f32View = new Float32Array(this.podArgsHostData, podArgsOffset, numPodArgs);
 
         for (let i = 0; i < podArgIndices.length; ++i) {
           const value = args[podArgIndices[i]];
@@ -704,25 +774,50 @@ export class WebGPUContext {
         }
         // always pass in dim z launching grid size in
         u32View[podArgIndices.length] = packDimX;
-        this.device.queue.writeBuffer(podArgBuffer, 0, i32View.buffer);
 
-        bindGroupEntries.push({
-          binding: bufferArgIndices.length,
-          resource: {
-            buffer: podArgBuffer,
-            size: i32View.buffer.byteLength
+        let bindGroupKey = this.podArgsGeneration.toString();
+        for (let i = 0; i < bufferArgIndices.length; ++i) {
+          const ptr = args[bufferArgIndices[i]];
+          bindGroupKey += "," + ptr + ":" + this.bufferTableVersion[ptr];
+        }
+        let bindGroup = bindGroupCache.get(bindGroupKey);
+        if (bindGroup === undefined) {
+          const bindGroupEntries: Array<GPUBindGroupEntry> = [];
+          for (let i = 0; i < bufferArgIndices.length; ++i) {
+            bindGroupEntries.push({
+              binding: i,
+              resource: {
+                buffer: this.gpuBufferFromPtr(args[bufferArgIndices[i]])
+              }
+            });
           }
-        });
-
-        compute.setBindGroup(0, this.device.createBindGroup({
-          layout: bindGroupLayout,
-          entries: bindGroupEntries
-        }));
+          bindGroupEntries.push({
+            binding: bufferArgIndices.length,
+            resource: {
+              buffer: this.podArgsBuffer as GPUBuffer,
+              size: podArgsBytes
+            }
+          });
+          bindGroup = this.device.createBindGroup({
+            layout: bindGroupLayout,
+            entries: bindGroupEntries
+          });
+          if (bindGroupCache.size >= this.maxCachedBindGroups) {
+            bindGroupCache.clear();
+          }
+          bindGroupCache.set(bindGroupKey, bindGroup);
+        } else {
+          this.bindGroupCacheHitCounter += 1;
+        }
 
-        compute.dispatchWorkgroups(workDim[0], workDim[1], workDim[2])
-        compute.end()
-        const command = commandEncoder.finish();
-        this.device.queue.submit([command]);
+        const compute = this.getPendingComputePass();
+        compute.setPipeline(pipeline);
+        compute.setBindGroup(0, bindGroup, [podArgsOffset]);
+        compute.dispatchWorkgroups(workDim[0], workDim[1], workDim[2]);
+        this.numPendingDispatches += 1;
+        if (this.debugLogFinish || this.numPendingDispatches >= this.maxDispatchesPerSubmit) {
+          this.flushPendingCommands();
+        }
 
         if (this.debugLogFinish) {
           const currCounter = this.shaderSubmitCounter;
@@ -834,9 +929,12 @@ export class WebGPUContext {
   }
 
   private deviceFreeDataSpace(ptr: GPUPointer): void {
+    // the pending dispatches may still use the buffer.
+    this.flushPendingCommands();
     const idx = ptr;
     const buffer = this.bufferTable[idx];
     this.bufferTable[idx] = undefined;
+    this.bufferTableVersion[idx] += 1;
     assert(buffer !== undefined);
     this.bufferTableFreeId.push(idx);
     this.currAllocatedBytes -= buffer.size;
@@ -849,6 +947,7 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
+    this.flushPendingCommands();
     // Perhaps it would be more useful to use a staging buffer?
     let rawBytes = this.memory.loadRawBytes(from, nbytes);
     if (rawBytes.length % 4 !== 0) {
@@ -873,13 +972,9 @@ export class WebGPUContext {
     to: Pointer,
     nbytes: number
   ): void {
-    // Perhaps it would be more useful to resuse a staging buffer?
-    const gpuTemp = tryCreateBuffer(this.device, {
-      size: nbytes,
-      usage: GPUBufferUsage.MAP_READ | GPUBufferUsage.COPY_DST,
-    });
-
-    const copyEncoder = this.device.createCommandEncoder();
+    // the copy is appended to the pending dispatches in the same submission.
+    const gpuTemp = this.getReadStagingBuffer(nbytes);
+    const copyEncoder = this.getPendingCopyEncoder();
     copyEncoder.copyBufferToBuffer(
       this.gpuBufferFromPtr(from),
       fromOffset,
@@ -887,16 +982,53 @@ export class WebGPUContext {
       0,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.queue.submit([copyCommands]);
+    this.flushPendingCommands();
 
     gpuTemp.mapAsync(GPUMapMode.READ).then(() => {
       const data = gpuTemp.getMappedRange();
-      this.memory.storeRawBytes(to, new Uint8Array(data));
-      gpuTemp.destroy();
+      this.memory.storeRawBytes(to, new Uint8Array(data, 0, nbytes));
+      gpuTemp.unmap();
+      this.releaseReadStagingBuffer(gpuTemp);
     });
   }
 
+  /**
+   * Get a staging buffer for a read from the GPU.
+   * The staging buffers are reused, so that repeated reads such as
+   * the logits of each decode step do not allocate new buffers.
+   *
+   * @param nbytes The minimum size.
+   * @returns The staging buffer, not in use by any other read.
+   */
+  private getReadStagingBuffer(nbytes: number): GPUBuffer {
+    const index = this.readStagingBuffers.findIndex((buffer) => buffer.size >= nbytes);
+    if (index != -1) {
+      return this.readStagingBuffers.splice(index, 1)[0];
+    }
+    // round the size up to reuse the buffer for reads of similar sizes.
+    let allocSize = 256;
+    while (allocSize < nbytes) {
+      allocSize *= 2;
+    }
+    return tryCreateBuffer(this.device, {
+      size: allocSize,
+      usage: GPUBufferUsage.MAP_READ | GPUBufferUsage.COPY_DST,
+    });
+  }
+
+  /**
+   * Return a read staging buffer once its data is consumed.
+   * @param buffer The staging buffer.
+   */
+  private releaseReadStagingBuffer(buffer: GPUBuffer): void {
+    this.readStagingBuffers.push(buffer);
+    if (this.readStagingBuffers.length > this.maxNumReadStagingBuffers) {
+      // keep the largest ones
+      this.readStagingBuffers.sort((a, b) => b.size - a.size);
+      this.readStagingBuffers.pop()?.destroy();
+    }
+  }
+
   private deviceCopyWithinGPU(
     from: GPUPointer,
     fromOffset: number,
@@ -904,7 +1036,8 @@ export class WebGPUContext {
     toOffset: number,
     nbytes: number
   ): void {
-    const copyEncoder = this.device.createCommandEncoder();
+    // encode the copy after the pending dispatches, which keeps the order of the stream.
+    const copyEncoder = this.getPendingCopyEncoder();
     copyEncoder.copyBufferToBuffer(
       this.gpuBufferFromPtr(from),
       fromOffset,
@@ -912,8 +1045,6 @@ export class WebGPUContext {
       toOffset,
       nbytes
     );
-    const copyCommands = copyEncoder.finish();
-    this.device.queue.submit([copyCommands]);
   }
 
   private gpuBufferFromPtr(ptr: GPUPointer): GPUBuffer {
@@ -930,6 +1061,7 @@ export class WebGPUContext {
     } else {
       const idx = this.bufferTable.length;
       this.bufferTable.push(buffer);
+      this.bufferTableVersion.push(0);
       return idx;
     }
   }